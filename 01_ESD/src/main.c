@@ -12,8 +12,16 @@
 #include <lcd/lcd.h>
 #include <esd/esd.h>
 #include <utils/utils.h>
+#include <irq/irq.h>
 #include "stm32f4xx.h"
 
+/**
+ * @brief 1: Multiplexbetrieb per DMA (TIM8, keine Interrupts), 0: per TIM7-Interrupt
+ */
+#ifndef ESD_REFRESH_DMA
+#define ESD_REFRESH_DMA 0
+#endif
+
 
 	/**
 	 * @brief Startet einen einfachen Countdown auf jeder Position einzeln.
@@ -43,12 +51,14 @@
 	 * `split_number_4(1234, digits)` ergibt `digits = {1, 2, 3, 4}`
 	 */
 	void split_number_4(int value, esd_digit_t out[4]) { //ZB 1234
+	    uint16_t bcd;
+
 	    if (value < 0) value = 0;
-	    if (value > 9999) value = 9999;
-	    out[0] = (esd_digit_t)((value / 1000) % 10);
-	    out[1] = (esd_digit_t)((value / 100)  % 10);
-	    out[2] = (esd_digit_t)((value / 10)   % 10);
-	    out[3] = (esd_digit_t)( value         % 10);
+	    bcd = esd_to_bcd((value > 9999) ? 9999U : (uint16_t)value); // ohne Division
+	    out[0] = (esd_digit_t)((bcd >> 12) & 0x0FU);
+	    out[1] = (esd_digit_t)((bcd >> 8)  & 0x0FU);
+	    out[2] = (esd_digit_t)((bcd >> 4)  & 0x0FU);
+	    out[3] = (esd_digit_t)( bcd        & 0x0FU);
 	}
 
 	/**
@@ -57,57 +67,60 @@
 	 * @param value     Zahl (0–9999), die angezeigt werden soll
 	 * @param duration  Gesamtdauer in Millisekunden, wie lange die Zahl sichtbar sein soll
 	 *
-	 * Diese Funktion nutzt Multiplexing, um alle vier Ziffern scheinbar gleichzeitig
-	 * anzuzeigen. Jede Position wird kurz nacheinander aktiviert und wieder ausgeschaltet.
+	 * Das Multiplexing läuft im Refresh-Interrupt des ESD-Moduls
+	 * (esd_refresh_start()), hier wird nur der Anzeigepuffer beschrieben.
+	 * Die Wartezeit steht der Anwendung für andere Aufgaben zur Verfügung.
 	 */
 
 	void showNumbersInESD(int value, uint32_t duration) {
-	    esd_digit_t esdDigits[4];
-	    split_number_4(value, esdDigits);
-
-	    uint32_t durationPerPos = 2;
-
-	    uint32_t elapsed = 0;
-	    while (elapsed < duration) {
-	        esd_show_digit(esdDigits[0], ESD_POSITION_1);
-	        utils_delay_ms(durationPerPos);
-	        turnAllPositionsOff();
-
-	        esd_show_digit(esdDigits[1], ESD_POSITION_2);
-	        utils_delay_ms(durationPerPos);
-	        turnAllPositionsOff();
-
-	        esd_show_digit(esdDigits[2], ESD_POSITION_3);
-	        utils_delay_ms(durationPerPos);
-	        turnAllPositionsOff();
+	    if (value < 0) value = 0;
+	    esd_set_number((uint16_t)value);
+	    utils_delay_ms(duration);
+	}
 
-	        esd_show_digit(esdDigits[3], ESD_POSITION_4);
-	        utils_delay_ms(durationPerPos);
-	        turnAllPositionsOff();
+	/** @brief Wird am Ende des großen Countdowns gesetzt (Timer-Interrupt) */
+	static volatile uint8_t big_countdown_done;
 
-	        elapsed += (durationPerPos * 4);
-	    }
+	/**
+	 * @brief Abschluss-Callback des großen Countdowns.
+	 */
+	static void bigCountdownDone(void *context){
+		(void)context;
+		big_countdown_done = 1;
 	}
 
 	/**
 	 * @brief Startet einen Countdown von 9999 bis 0000.
 	 *
 	 * Jeder Wert wird für 1 Sekunde angezeigt, wobei das Display über Multiplexing
-	 * betrieben wird. Diese Funktion demonstriert die gleichzeitige Anzeige
-	 * mehrerer Ziffern im schnellen Wechsel.
+	 * betrieben wird. Zählen (esd_counter_start()) und Umschalten der
+	 * Positionen laufen im Hintergrund per Timer; die CPU schläft bis zum
+	 * Ende und stünde sonst anderen Aufgaben zur Verfügung.
 	 */
 
 	void startBigNumberCountdown(void){
-		for (int v = 9999; v >= 0; --v) {
-			showNumbersInESD(v, 1000);  // 1 Sekunde
+#if ESD_REFRESH_DMA
+		esd_refresh_start_dma(ESD_REFRESH_RATE_HZ);
+#else
+		esd_refresh_start(ESD_REFRESH_RATE_HZ);
+#endif
+
+		big_countdown_done = 0;
+		if (esd_counter_start(9999, 0, 1000, bigCountdownDone, NULL) == HAL_OK) {
+			while (!big_countdown_done) {
+				__WFI();  // HAL-Tick und Zähler-Timer wecken
+			}
+			utils_delay_ms(1000);  // 0000 eine Sekunde stehen lassen
 		}
 
+		esd_refresh_stop();
 	}
 
 
 int main(void)
 {
 	HAL_Init(); // HAL-System initialisieren
+	irq_init(); // Interrupt-Prioritäten nach Plan setzen
 
 	esd_init(); // 7-Segment-Display vorbereiten
 
@@ -11,78 +11,117 @@
 #include <joystick/joystick.h>
 #include <esd/esd.h>
 #include <utils/utils.h>
+#include <irq/irq.h>
 #include "stm32f4xx.h"
 
 
 /**
  * @brief Hauptprogramm: kombiniert Joystick- und 7-Segment-Steuerung.
  *
- * Initialisiert das HAL-System, den Joystick und das ESD-Modul.
- * In der Endlosschleife werden die Joystickeingaben ausgewertet und
- * die entsprechende Zahl bzw. Position auf dem 7-Segment-Display angezeigt.
+ * Initialisiert das HAL-System, den Joystick im Ereignisbetrieb und das
+ * ESD-Modul. Die Hauptschleife schläft mit __WFI(), bis ein entprelltes
+ * Joystick-Ereignis in der Warteschlange liegt, und zeigt danach die
+ * entsprechende Zahl bzw. Position auf dem 7-Segment-Display an.
  *
  * Steuerung:
- * - **UP:**    Ziffer um +1 erhöhen (9 → 0)
- * - **DOWN:**  Ziffer um -1 verringern (0 → 9)
+ * - **UP:**    Ziffer um +1 erhöhen (9 → 0), gehalten mit Wiederholung
+ * - **DOWN:**  Ziffer um -1 verringern (0 → 9), gehalten mit Wiederholung
  * - **RIGHT:** Position nach rechts wechseln (4 → 1)
  * - **LEFT:**  Position nach links wechseln (1 → 4)
  * - **PRESS:** Countdown von aktueller Zahl bis 0 an aktueller Position
+ *              (beim Loslassen)
+ * - **PRESS lang:** Ziffer auf 0 zurücksetzen
  *
  * @return int Gibt keinen Wert zurück (Endlosschleife)
  */
 int main(void)
 {
 	HAL_Init();
+	irq_init();
 
-	initJoyStick();
+	joystick_init_events();
 
 	esd_init();
 
 	esd_digit_t currentNumber = ESD_DIGIT_0; //startwert 0
 	esd_position_t currentPosition = ESD_POSITION_1; // Startposition: 1
+	joystick_event_t event;
+	uint8_t longPress = 0; // PRESS wurde lang gehalten
+
+	esd_show_digit(currentNumber, currentPosition);
 
 	while(1) {
-		utils_delay_ms(150); // Kurze Entprell- und Reaktionsverzögerung
+		// Schlafen bis zum nächsten Interrupt (SysTick, EXTI, Abtast-Timer)
+		if(!joystick_get_event(&event)){
+			__WFI();
+			continue;
+		}
+
+		if((event.type == JOYSTICK_EVENT_RELEASE) && (event.key != JOYSTICK_KEY_PRESS)){
+			continue;
+		}
+
+		switch(event.key){
 		// Nach oben drücken → Zahl erhöhen
-		if(readUP() == GPIO_PIN_RESET){ //Taste gedrückt
+		case JOYSTICK_KEY_UP:
+			if(event.type == JOYSTICK_EVENT_LONG){
+				break;
+			}
 			if(currentNumber == ESD_DIGIT_9){
 				currentNumber = ESD_DIGIT_0;// Von 9 auf 0 springen
 			}else{
 				currentNumber = currentNumber + 1; //Zahl inkrementieren
 			}
-		}
+			break;
 		// Nach unten drücken → Zahl verringern
-		if(readDOWN() == GPIO_PIN_RESET){
+		case JOYSTICK_KEY_DOWN:
+			if(event.type == JOYSTICK_EVENT_LONG){
+				break;
+			}
 			if(currentNumber == ESD_DIGIT_0){
 				currentNumber = ESD_DIGIT_9; // Von 0 auf 9 springen
-
 			}else{
 				currentNumber = currentNumber - 1;//Zahl verringern
 			}
-		}
+			break;
 		// Nach rechts drücken → Position nach rechts wechseln
-		if(readRIGHT() == GPIO_PIN_RESET){
+		case JOYSTICK_KEY_RIGHT:
+			if(event.type != JOYSTICK_EVENT_PRESS){
+				break;
+			}
 			if(currentPosition == ESD_POSITION_4){
 				currentPosition = ESD_POSITION_1;
 			}else{
 				currentPosition = currentPosition + 1;//Pos rechts schieben
 			}
-		}
+			break;
 		// Nach links drücken → Position nach links wechseln
-
-		if(readLEFT() == GPIO_PIN_RESET){
+		case JOYSTICK_KEY_LEFT:
+			if(event.type != JOYSTICK_EVENT_PRESS){
+				break;
+			}
 			if(currentPosition == ESD_POSITION_1){
 				currentPosition = ESD_POSITION_4; // Von links wieder ganz rechts
 			}else{
 				currentPosition = currentPosition - 1;
 			}
-		}
-		// Drücken (PRESS) → Countdown von aktueller Zahl
-		if(readPRESS() == GPIO_PIN_RESET){
-			for(int i = currentNumber; i >= 0; i--){
-				esd_show_digit(i, currentPosition);// Countdown anzeigen
-				utils_delay_ms(1000); // 1 Sekunde pro Zahl
+			break;
+		// Kurz drücken (PRESS) → beim Loslassen Countdown, lang → Zahl auf 0
+		case JOYSTICK_KEY_PRESS:
+			if(event.type == JOYSTICK_EVENT_LONG){
+				currentNumber = ESD_DIGIT_0;
+				longPress = 1;
+			}else if(event.type == JOYSTICK_EVENT_PRESS){
+				longPress = 0;
+			}else if((event.type == JOYSTICK_EVENT_RELEASE) && !longPress){
+				for(int i = currentNumber; i >= 0; i--){
+					esd_show_digit(i, currentPosition);// Countdown anzeigen
+					utils_delay_ms(1000); // 1 Sekunde pro Zahl
+				}
 			}
+			break;
+		default:
+			break;
 		}
 		// Display aktualisieren
 		turnAllPositionsOff();  // Vorher alle Positionen löschen
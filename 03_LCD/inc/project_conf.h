@@ -0,0 +1,25 @@
+/**
+ ******************************************************************************
+ * @file        project_conf.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Module configuration of 03_LCD.
+ *
+ * @details
+ * Read by every module before its own defaults (through
+ * stm32f4xx_hal_conf.h, the BME280 library through bme280_defs.h).
+ * Parts of the modules this project does not use are compiled out here;
+ * the feature switches (SHELL_ENABLE, TRACE_ENABLE, ...) may be set here
+ * as well instead of -D in the build settings.
+ *
+ ******************************************************************************
+ */
+
+#ifndef PROJECT_CONF_H_
+#define PROJECT_CONF_H_
+
+/* lcd: SPI backend only, framebuffer, SDRAM and LTDC code is not linked */
+#define LCD_FRAMEBUFFER_ENABLE      0
+
+#endif /* PROJECT_CONF_H_ */
@@ -14,11 +14,13 @@
 #include <stdio.h>
 #include <utils/utils.h>
 #include <my_lcd/my_lcd.h>
+#include <irq/irq.h>
 
 
 int main(void)
 {
     HAL_Init();
+    irq_init();
     lcd_init();
 
     /* LCD-Demo-Funktionen */
@@ -18,8 +18,9 @@
     	- Initialize the HAL
     	- Initialize the potentiometer module (ADC & GPIO)
     	- Initialize the LCD
-    	- Continuously read two potentiometers and
-      	  display their values in mV and as bargraphs.
+    	- Every MAIN_REFRESH_MS read two potentiometers and
+      	  display their values in mV and as bargraphs,
+      	  sleeping without SysTick in between (idle module).
 ==================================================
 @endverbatim
 **************************************************
@@ -29,19 +30,14 @@
 
 #include <lcd/lcd.h>
 #include "stm32f4xx.h"
-#include <stdio.h>
+#include <fmt/fmt.h>
 #include <my_lcd/my_lcd.h>
 #include <potis/potis.h>
+#include <adc_cal/adc_cal.h>
+#include <idle/idle.h>
+#include <irq/irq.h>
 
 /* Preprocessor defines */
-/**
- * @brief Converts an ADC raw value to millivolts.
- * @param adc_value               Measured ADC raw value.
- * @param board_millievoltage     Supply/reference voltage in millivolts.
- * @param adc_resolution_in_decimal Maximum ADC raw value (e.g. 4095 for 12-bit).
- */
-#define CONVERT_VALUE_TO_MILLIEVOLT(adc_value, board_millievoltage, adc_resolution_in_decimal) ((adc_value * board_millievoltage) / adc_resolution_in_decimal)
-
 /**
  * @brief Converts an ADC raw value to a bargraph value.
  * @param adc_value               Measured ADC raw value.
@@ -50,6 +46,11 @@
  */
 #define CONVERT_VALUE_TO_BARAGRAPH_VALUE(adc_value, baargraph_max, adc_resolution_in_decimal) ((adc_value * baargraph_max) / adc_resolution_in_decimal)
 
+/**
+ * @brief Display refresh period in ms, the CPU sleeps (tickless) in between.
+ */
+#define MAIN_REFRESH_MS 50U
+
 /* Preprocessor macros */
 
 /* Module intern type definitions */
@@ -62,8 +63,8 @@
 
 /**
  * @brief  Main program entry point.
- *         Initializes HAL, potentiometers and LCD, then continuously
- *         reads two potentiometers and displays their values.
+ *         Initializes HAL, potentiometers and LCD, then reads two
+ *         potentiometers every MAIN_REFRESH_MS and displays their values.
  * @param  None
  * @return int Program never returns in normal operation.
  */
@@ -72,48 +73,66 @@ int main(void)
     /* Initialize the HAL library (configures the system clock, SysTick, etc.) */
     HAL_Init();
 
+    /* Interrupt priorities of the system plan */
+    irq_init();
+
     /* Initialize potentiometers (GPIO + ADC configuration) */
     potis_init();
 
     /* Initialization of the LCD */
     lcd_init();
 
+    /* Tickless sleep between two refreshes */
+    idle_init();
+
+    /* Bargraphs only redraw the strip between the old and the new width */
+    my_lcd_bargraph_t bar_poti_1;
+    my_lcd_bargraph_t bar_poti_2;
+    my_lcd_bargraph_init(&bar_poti_1, 50, 50, 150, 50, GREEN, DARKGREY);
+    my_lcd_bargraph_init(&bar_poti_2, 50, 150, 150, 50, RED, DARKGREY);
+
     char buffer[64];
+    fmt_t fmt;
+    uint32_t u32_next_refresh = HAL_GetTick();
 
     while(1) {
 
-        /* Read ADC values from the two potentiometers */
-        uint32_t u32_poti_1_value = potis_get_val(POTI_1);
-        uint32_t u32_poti_2_value = potis_get_val(POTI_2);
+        /* Sleep until the next refresh (other interrupts wake earlier) */
+        while ((int32_t)(HAL_GetTick() - u32_next_refresh) < 0) {
+            idle_sleep(u32_next_refresh - HAL_GetTick());
+        }
+        u32_next_refresh += MAIN_REFRESH_MS;
+
+        /* Read ADC values from the two potentiometers (same scan) */
+        uint32_t u32_poti_values[POTIS_CHANNEL_COUNT];
+        potis_get_all(u32_poti_values);
+        uint32_t u32_poti_1_value = u32_poti_values[0];
+        uint32_t u32_poti_2_value = u32_poti_values[1];
 
         /* Display Poti1 value in millivolts */
-        sprintf(buffer,
-                "     Poti1: %-4lu",
-                CONVERT_VALUE_TO_MILLIEVOLT(u32_poti_1_value,
-                                            TEST_BOARD_MILLIEVOLTAGE,
-                                            ADC_12_BIT_RESOLUTION));
-        lcd_draw_text_at_line(buffer, 6, BLACK, 2, WHITE);
+        fmt_init(&fmt, buffer, sizeof(buffer));
+        fmt_str(&fmt, "     Poti1: ");
+        fmt_u32(&fmt, adc_cal_to_mv(0, u32_poti_1_value), 0u, ' ');
+        fmt_pad(&fmt, 16u);
+        lcd_draw_text_at_line(fmt_get(&fmt), 6, BLACK, 2, WHITE);
 
         /* Draw bargraph for Poti1 */
-        my_lcd_draw_baargraph(50, 50, 150, 50,
-                              CONVERT_VALUE_TO_BARAGRAPH_VALUE(u32_poti_1_value,
-                                                               MAX_BAARGRAPH_VALUE,
-                                                               ADC_12_BIT_RESOLUTION),
-                              GREEN, DARKGREY);
+        my_lcd_bargraph_update(&bar_poti_1,
+                               CONVERT_VALUE_TO_BARAGRAPH_VALUE(u32_poti_1_value,
+                                                                MAX_BAARGRAPH_VALUE,
+                                                                ADC_12_BIT_RESOLUTION));
 
         /* Display Poti2 value in millivolts */
-        sprintf(buffer,
-                "     Poti2: %-4lu",
-                CONVERT_VALUE_TO_MILLIEVOLT(u32_poti_2_value,
-                                            TEST_BOARD_MILLIEVOLTAGE,
-                                            ADC_12_BIT_RESOLUTION));
-        lcd_draw_text_at_line(buffer, 12, BLACK, 2, WHITE);
+        fmt_init(&fmt, buffer, sizeof(buffer));
+        fmt_str(&fmt, "     Poti2: ");
+        fmt_u32(&fmt, adc_cal_to_mv(1, u32_poti_2_value), 0u, ' ');
+        fmt_pad(&fmt, 16u);
+        lcd_draw_text_at_line(fmt_get(&fmt), 12, BLACK, 2, WHITE);
 
         /* Draw bargraph for Poti2 */
-        my_lcd_draw_baargraph(50, 150, 150, 50,
-                              CONVERT_VALUE_TO_BARAGRAPH_VALUE(u32_poti_2_value,
-                                                               MAX_BAARGRAPH_VALUE,
-                                                               ADC_12_BIT_RESOLUTION),
-                              RED, DARKGREY);
+        my_lcd_bargraph_update(&bar_poti_2,
+                               CONVERT_VALUE_TO_BARAGRAPH_VALUE(u32_poti_2_value,
+                                                                MAX_BAARGRAPH_VALUE,
+                                                                ADC_12_BIT_RESOLUTION));
     }
 }
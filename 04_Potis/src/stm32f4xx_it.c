@@ -34,9 +34,11 @@
   */
 void SysTick_Handler(void)
 {
-	HAL_IncTick();
-	HAL_SYSTICK_IRQHandler();
 #ifdef USE_RTOS_SYSTICK
+	/* RTOS build: SysTick belongs to the kernel, the HAL tick runs on TIM14 (osal) */
 	osSystickHandler();
+#else
+	HAL_IncTick();
+	HAL_SYSTICK_IRQHandler();
 #endif
 }
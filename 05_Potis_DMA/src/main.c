@@ -31,18 +31,11 @@
 #include <lcd/lcd.h>
 #include <my_lcd/my_lcd.h>
 #include <potis_dma/potis_dma.h>
+#include <irq/irq.h>
 #include "stm32f4xx.h"
 #include <stdio.h>   /* for sprintf */
 
 /* Preprocessor defines */
-/**
- * @brief Converts an ADC raw value to millivolts.
- * @param adc_value                  Measured ADC raw value.
- * @param board_millievoltage        Supply/reference voltage in millivolts.
- * @param adc_resolution_in_decimal  Maximum ADC raw value (e.g. 4095 for 12-bit).
- */
-#define CONVERT_VALUE_TO_MILLIEVOLT(adc_value, board_millievoltage, adc_resolution_in_decimal) ((adc_value * board_millievoltage) / adc_resolution_in_decimal)
-
 /**
  * @brief Converts an ADC raw value to a bargraph value.
  * @param adc_value                  Measured ADC raw value.
@@ -69,6 +62,9 @@ int main(void)
     /* Initialize the HAL library (configures system clock, SysTick, etc.) */
     HAL_Init();
 
+    /* Interrupt priorities of the system plan */
+    irq_init();
+
     /* Initialization of the LCD */
     lcd_init();
 
@@ -76,38 +72,38 @@ int main(void)
     potis_dma_init();
     potis_dma_start();
 
+    /* Bargraphs only redraw the strip between the old and the new width */
+    my_lcd_bargraph_t bar_poti_1;
+    my_lcd_bargraph_t bar_poti_2;
+    my_lcd_bargraph_init(&bar_poti_1, 50, 50, 150, 50, GREEN, DARKGREY);
+    my_lcd_bargraph_init(&bar_poti_2, 50, 150, 150, 50, RED, DARKGREY);
+
     char buffer[64];
 
     while(1) {
 
         /* Display Poti1 value in millivolts */
         sprintf(buffer, "     Poti1: %-4lu",
-                CONVERT_VALUE_TO_MILLIEVOLT(potis_dma_get_val(POTI_1),
-                                            TEST_BOARD_MILLIEVOLTAGE,
-                                            ADC_12_BIT_RESOLUTION));
+                potis_dma_get_mv(POTI_1));
         lcd_draw_text_at_line(buffer, 6, BLACK, 2, WHITE);
 
         /* Draw bargraph for Poti1 */
-        my_lcd_draw_baargraph(50, 50, 150, 50,
-                              CONVERT_VALUE_TO_BARAGRAPH_VALUE(
-                                  potis_dma_get_val(POTI_1),
-                                  MAX_BAARGRAPH_VALUE,
-                                  ADC_12_BIT_RESOLUTION),
-                              GREEN, DARKGREY);
+        my_lcd_bargraph_update(&bar_poti_1,
+                               CONVERT_VALUE_TO_BARAGRAPH_VALUE(
+                                   potis_dma_get_val(POTI_1),
+                                   MAX_BAARGRAPH_VALUE,
+                                   ADC_12_BIT_RESOLUTION));
 
         /* Display Poti2 value in millivolts */
         sprintf(buffer, "     Poti2: %-4lu",
-                CONVERT_VALUE_TO_MILLIEVOLT(potis_dma_get_val(POTI_2),
-                                            TEST_BOARD_MILLIEVOLTAGE,
-                                            ADC_12_BIT_RESOLUTION));
+                potis_dma_get_mv(POTI_2));
         lcd_draw_text_at_line(buffer, 12, BLACK, 2, WHITE);
 
         /* Draw bargraph for Poti2 */
-        my_lcd_draw_baargraph(50, 150, 150, 50,
-                              CONVERT_VALUE_TO_BARAGRAPH_VALUE(
-                                  potis_dma_get_val(POTI_2),
-                                  MAX_BAARGRAPH_VALUE,
-                                  ADC_12_BIT_RESOLUTION),
-                              RED, DARKGREY);
+        my_lcd_bargraph_update(&bar_poti_2,
+                               CONVERT_VALUE_TO_BARAGRAPH_VALUE(
+                                   potis_dma_get_val(POTI_2),
+                                   MAX_BAARGRAPH_VALUE,
+                                   ADC_12_BIT_RESOLUTION));
     }
 }
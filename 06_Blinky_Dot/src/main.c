@@ -36,6 +36,7 @@
 #include <stdio.h>
 #include <dot/dot.h>
 #include <potis_dma/potis_dma.h>
+#include <irq/irq.h>
 
 /* Preprocessor defines */
 /**
@@ -64,6 +65,9 @@ int main(void)
     /* Initialize the HAL library */
     HAL_Init();
 
+    /* Interrupt priorities of the system plan */
+    irq_init();
+
     /* Initialize dot-LED hardware (GPIO + PWM timer) */
     dot_esd_init();
     dot_timer_init(DOT_BLINKING_MODE);
@@ -10,7 +10,7 @@
 ==================================================
 				### Resources used ###
 	GPIO:    as configured by DOT and POTIS_DMA modules
-	TIMER:   TIM1 (PWM mode, used for brightness control)
+	TIMER:   TIM1 (PWM carrier, brightness), TIM4 (blink gate)
 	ADC:     ADC1 with DMA (via potis_dma)
 	LCD:     TFT display (via lcd library)
 ==================================================
@@ -23,7 +23,9 @@
     	- In the infinite loop:
         	* Read potentiometer 1 value via DMA
         	* Convert it into a PWM duty-cycle value
-        	* Update LED brightness via 'dot_change_brightness()'
+        	* Update LED brightness via 'dot_set_brightness()'
+        	* Potentiometer 2 sets the blink period via 'dot_set_blink()'
+        	  (left stop = steady), brightness and blinking act together
         	* Display timer counter value and ADC reading on LCD
 ==================================================
 @endverbatim
@@ -36,6 +38,7 @@
 #include <stdio.h>
 #include <dot/dot.h>
 #include <potis_dma/potis_dma.h>
+#include <irq/irq.h>
 
 /* Preprocessor defines */
 /**
@@ -51,6 +54,22 @@
 #define CONVERT_VALUE_TO_TIMER_VALUE(adc_value, timer_min_max, adc_resolution_in_decimal) \
     ((adc_value * (timer_min_max)) / (adc_resolution_in_decimal))
 
+/**
+ * @brief Blink period range set with potentiometer 2; below the minimum the
+ *        dot is steady.
+ */
+#define BLINK_MAX_PERIOD_MS 2000U
+#define BLINK_MIN_PERIOD_MS 100U
+
+/**
+ * @brief Duration of one breath in ms; 0 = brightness from potentiometer 1,
+ *        otherwise the fade DMA breathes the dot and potentiometer 1 is
+ *        only displayed.
+ */
+#ifndef DOT_BREATHE_MS
+#define DOT_BREATHE_MS 0
+#endif
+
 /**
  * @brief Main application entry point.
  * @return int Never returns in normal operation.
@@ -60,9 +79,15 @@ int main(void)
     /* Initialize HAL library */
     HAL_Init();
 
+    /* Interrupt priorities of the system plan */
+    irq_init();
+
     /* Initialize dot-LED hardware */
     dot_esd_init();
-    dot_timer_init(DOT_DIMMING_MODE);
+    dot_init();
+#if DOT_BREATHE_MS
+    dot_fade_breathe(DOT_BREATHE_MS);
+#endif
 
     /* Initialize ADC+DMA potentiometer module */
     potis_dma_init();
@@ -92,6 +117,20 @@ int main(void)
                                              ADC_12_BIT_RESOLUTION);
 
         /* Apply brightness to dot-LED */
-        dot_change_brightness(brightness);
+#if DOT_BREATHE_MS
+        (void)brightness;
+#else
+        dot_set_brightness((uint8_t)brightness);
+#endif
+
+        /* Potentiometer 2: blink period 0 (steady) .. 2 s, on for half of it */
+        uint32_t blink_period_ms =
+                CONVERT_VALUE_TO_TIMER_VALUE(potis_dma_get_val(POTI_2),
+                                             BLINK_MAX_PERIOD_MS,
+                                             ADC_12_BIT_RESOLUTION);
+        if (blink_period_ms < BLINK_MIN_PERIOD_MS) {
+            blink_period_ms = 0;
+        }
+        dot_set_blink((uint16_t)blink_period_ms, (uint16_t)(blink_period_ms / 2U));
     }
 }
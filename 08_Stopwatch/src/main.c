@@ -8,9 +8,12 @@
 @verbatim
 ==================================================
 				### Resources used ###
-	TIMER:   TIM1 (used inside stopwatch module)
-	GPIO:    PA0 as EXTI0 (start/lap button, inside stopwatch module)
+	TIMER:   TIM5 (used inside stopwatch module)
+	GPIO:    PA0 as EXTI0 or TIM5 CH1 capture (start/lap button, inside
+	         stopwatch module)
 	LCD:     TFT display (via lcd library)
+	ESD:     7-segment display, live time mm,ss (TIM7 refresh, timer
+	         claimed by capability for the mirror, STOPWATCH_ESD_MIRROR)
 ==================================================
 					### Usage ###
 	(#) Call 'main()' on startup. It will:
@@ -18,9 +21,11 @@
     	- Initialize LCD
     	- Initialize stopwatch timer, GPIO and interrupts
     	- In the main loop:
-        	* Continuously display the current stopwatch time
+        	* Continuously display the current stopwatch time (on the
+        	  7-segment display in the background, or on the LCD)
         	* Whenever a new lap is added (button press),
-          	  display the lap time on the LCD including lap index.
+          	  display the lap time on the LCD including lap index
+          	  and the best / mean lap of the lap store.
 ==================================================
 @endverbatim
 **************************************************
@@ -30,7 +35,60 @@
 #include <lcd/lcd.h>
 #include "stm32f4xx.h"
 #include <stopwatch/stopwatch.h>
-#include <stdio.h>
+#include <fmt/fmt.h>
+#include <irq/irq.h>
+#include <esd/esd.h>
+
+/**
+ * @brief 1: button edges latched by TIM5 input capture (exact lap times),
+ *        0: button via EXTI0 interrupt.
+ */
+#ifndef STOPWATCH_USE_CAPTURE
+#define STOPWATCH_USE_CAPTURE 0
+#endif
+
+/**
+ * @brief 1: live time on the 7-segment display (background mirror, no SPI
+ *        per update), the LCD only shows laps and statistics;
+ *        0: live time on the LCD.
+ */
+#ifndef STOPWATCH_ESD_MIRROR
+#define STOPWATCH_ESD_MIRROR 1
+#endif
+
+#if STOPWATCH_ESD_MIRROR
+/**
+ * @brief Poll interval of the mirror in ms (second changes without a
+ *        visible lag).
+ */
+#define MAIN_ESD_INTERVAL_MS    20U
+
+/**
+ * @brief Largest minutes shown as mm,ss (99,59 from 100 minutes).
+ */
+#define MAIN_ESD_MINUTES_MAX    99U
+
+/**
+ * @brief Mirror source: stopwatch time as minutes * 100 + seconds
+ *        (ESD_FORMAT_TIME). Runs in the refresh timer interrupt,
+ *        stopwatch_get_time() reads all parts from one time stamp.
+ *
+ * @param context Not used
+ * @return Time, at most 9959
+ */
+static int32_t main_esd_mmss(void *context)
+{
+    stopwatch_time_t time;
+
+    (void)context;
+
+    stopwatch_get_time(&time);
+    if (time.u32_minutes > MAIN_ESD_MINUTES_MAX) {
+        return (int32_t)(MAIN_ESD_MINUTES_MAX * 100U + 59U);
+    }
+    return (int32_t)(time.u32_minutes * 100U + time.u8_seconds);
+}
+#endif
 
 /**
  * @brief  Main application entry point.
@@ -41,46 +99,81 @@ int main(void)
     /* Initialize HAL library */
     HAL_Init();
 
+    /* Interrupt priorities of the system plan */
+    irq_init();
+
     /* Initialization of the LCD */
     lcd_init();
 
     /* Initialize stopwatch (timer, GPIO, interrupts) */
     stopwatch_init_timer();
+#if STOPWATCH_USE_CAPTURE
+    stopwatch_init_capture();
+#else
     stopwatch_init_gpio();
     stopwatch_init_interrupt();
+#endif
+
+#if STOPWATCH_ESD_MIRROR
+    /* Live time mm,ss on the 7-segment display, written by a timer */
+    esd_init();
+    esd_refresh_start(ESD_REFRESH_RATE_HZ);
+    esd_mirror_start(main_esd_mmss, NULL, ESD_FORMAT_TIME, MAIN_ESD_INTERVAL_MS);
+#endif
 
     char ch_buffer[64];
+    fmt_t fmt;
+#if !STOPWATCH_ESD_MIRROR
+    stopwatch_time_t time;
+#endif
 
     while (1) {
-        /* Show current stopwatch time (mm:ss.cs) */
-        sprintf(ch_buffer,
-                "time: %02u:%02u.%02u",
-                (unsigned)stopwatch_get_current_minutes(),
-                (unsigned)stopwatch_get_current_seconds(),
-                (unsigned)(stopwatch_get_current_milliseconds() % 100U));
-        lcd_draw_text_at_line(ch_buffer, 1, BLACK, 2, WHITE);
-
-        /* Check if a new lap has been added (flag set in ISR) */
-        if (bool_stopwatch_lap_added_flag) {
-            bool_stopwatch_lap_added_flag = false;
-
-            /* Get pointers to lap time buffers */
-            uint16_t* u16_laps_in_milliseconds = (uint16_t*)stopwatch_get_lap_milliseconds();
-            uint16_t* u16_laps_in_seconds      = (uint16_t*)stopwatch_get_lap_seconds();
-            uint16_t* u16_laps_in_minutes      = (uint16_t*)stopwatch_get_lap_minutes();
-
-            /* Index of the last added lap (set in ISR) */
-            uint8_t i = u8_stopwatch_lap_added_index;
-
-            /* Display lap N: mm:ss.cs on line (i+3) */
-            sprintf(ch_buffer,
-                    "lap %u: %02u:%02u.%02u",
-                    (unsigned)stopwatch_get_lap_counts(),
-                    (unsigned)u16_laps_in_minutes[i],
-                    (unsigned)u16_laps_in_seconds[i],
-                    (unsigned)(u16_laps_in_milliseconds[i] % 100U));
-
-            lcd_draw_text_at_line(ch_buffer, (uint8_t)(i + 3U), BLACK, 2, WHITE);
+#if STOPWATCH_USE_CAPTURE
+        /* Evaluate the captured button edges (start / laps) */
+        stopwatch_process_captures();
+#endif
+
+#if !STOPWATCH_ESD_MIRROR
+        /* Show current stopwatch time (mm:ss.cs), all parts from one read */
+        stopwatch_get_time(&time);
+
+        fmt_init(&fmt, ch_buffer, sizeof(ch_buffer));
+        fmt_str(&fmt, "time: ");
+        fmt_u32(&fmt, time.u32_minutes, 2u, '0');
+        fmt_char(&fmt, ':');
+        fmt_u32(&fmt, time.u8_seconds, 2u, '0');
+        fmt_char(&fmt, '.');
+        fmt_u32(&fmt, time.u16_milliseconds / 10U, 2u, '0');
+        lcd_draw_text_at_line(fmt_get(&fmt), 1, BLACK, 2, WHITE);
+#endif
+
+        /* Show every lap added since the last pass (queued in the ISR) */
+        stopwatch_lap_event_t lap;
+        while (stopwatch_get_lap_event(&lap)) {
+            /* Display lap N: mm:ss.cs on line (index+3) */
+            fmt_init(&fmt, ch_buffer, sizeof(ch_buffer));
+            fmt_str(&fmt, "lap ");
+            fmt_u32(&fmt, lap.u32_lap + 1U, 0u, ' ');
+            fmt_str(&fmt, ": ");
+            fmt_u32(&fmt, lap.time.u32_minutes, 2u, '0');
+            fmt_char(&fmt, ':');
+            fmt_u32(&fmt, lap.time.u8_seconds, 2u, '0');
+            fmt_char(&fmt, '.');
+            fmt_u32(&fmt, lap.time.u16_milliseconds / 10U, 2u, '0');
+
+            lcd_draw_text_at_line(fmt_get(&fmt), (uint8_t)(lap.u8_index + 3U), BLACK, 2, WHITE);
+
+            /* Lap statistics over all laps: best and mean in s.mmm */
+            stopwatch_lap_stats_t stats;
+            if (stopwatch_get_lap_stats(&stats) == HAL_OK) {
+                fmt_init(&fmt, ch_buffer, sizeof(ch_buffer));
+                fmt_str(&fmt, "best ");
+                fmt_fixed(&fmt, (int32_t)(stats.u32_best_us / 1000U), 3u, 0u);
+                fmt_str(&fmt, " mean ");
+                fmt_fixed(&fmt, (int32_t)(stats.u32_mean_us / 1000U), 3u, 0u);
+                fmt_pad(&fmt, 22u);
+                lcd_draw_text_at_line(fmt_get(&fmt), 14, BLACK, 2, WHITE);
+            }
         }
     }
 }
@@ -0,0 +1,1030 @@
+/**
+ ******************************************************************************
+ * @file        main.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       On-target micro-benchmarks of the shared modules.
+ *
+ * @details
+ * Runs a fixed set of benchmarks once after reset and prints one line per
+ * benchmark: best and mean core cycles per operation, operations per
+ * second and items (pixels, samples, ...) per second. The report goes to
+ * USART1 (ST-LINK virtual COM port, 115200 8N1) and to ITM port 0 (SWO),
+ * so results of two builds can be compared with a diff to catch
+ * regressions in the hot paths.
+ *
+ * Every operation is timed on its own with the DWT cycle counter; the
+ * best value is the repeatable one, the mean shows interrupt load.
+ * Operations that leave work to a DMA (lcd) include the wait for it.
+ *
+ * Benchmarks:
+ *  - lcd, for the SPI and the framebuffer backend: fill, text line,
+ *    retained text update, bargraph
+ *  - median: global filter, instance filter with 9 and 31 values,
+ *    sorting network of 9
+ *  - bme280: compensation of one sample (variant of the build:
+ *    BME280_64BIT_ENABLE, BME280_32BIT_ENABLE or double)
+ *  - fan: one PI controller step
+ *  - potis_dma: processing of one DMA half buffer in the interrupt
+ *    (profile zone, the only one enabled in this project) and reading
+ *    the averages
+ *  - irq latency: core cycles from an edge to the first instruction of
+ *    the handler, with LCD fills on SPI + DMA as background load.
+ *    TIM10 runs on the core clock (APB2 timer clock, 180 MHz profile)
+ *    and toggles PB8 by output compare, so the counter value at the
+ *    edge is CCR1; the handler reads the counter on entry. Sources: the
+ *    TIM10 update interrupt itself (tim_alloc dispatch, no wiring),
+ *    EXTI0_IRQHandler (PA0) and EXTI9_5_IRQHandler (PE6, takes the line
+ *    from the fan tacho) through the exti dispatch, both edges. The EXTI
+ *    pins need a wire from PB8; a source without edges times out and
+ *    prints no samples. One line with min, mean, max and jitter
+ *    (max - min) per source, then the histogram.
+ *  - hil (SIGINJECT_ENABLE, modules/siginject): recorded or synthetic
+ *    signals from the DAC into the real inputs, same stimulus in every
+ *    run. poti_t50 / poti_t90: microseconds from a step on PA4 (wired
+ *    to PA6, wiper of POTI_1 disconnected) until potis_dma_get_val()
+ *    has covered 50 % / 90 % of it, both directions. rpm_<n>: tacho
+ *    pulse train of n rpm on PA5 (wired to PE6, fan tacho disconnected;
+ *    with FAN_TACHO_CAPTURE no wire) against fan_get_rpm(), min, mean,
+ *    max and the error of the mean in permille.
+ *
+ * @resources
+ *  - USART1 (PA9 TX, AF7), ITM / SWO (PB3)
+ *  - DWT cycle counter
+ *  - TIM10 (claimed from tim_alloc, CH1 on PB8, AF3), EXTI lines 0
+ *    (PA0) and 6 (PE6)
+ *  - SIGINJECT_ENABLE: DAC channels 1 (PA4) and 2 (PA5), TIM5, TIM7,
+ *    DMA1 streams 5 and 6
+ *  - All resources of lcd, framebuffer, fan and potis_dma
+ ******************************************************************************
+ */
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+
+#include "clock/clock.h"
+#include "lcd/lcd.h"
+#include "my_lcd/my_lcd.h"
+#include "framebuffer/framebuffer.h"
+#include "fmt/fmt.h"
+#include "median/median.h"
+#include "bme280/bme280.h"
+#include "fan/fan.h"
+#include "potis_dma/potis_dma.h"
+#include "profile/profile.h"
+#include "trace/trace.h"
+#include "utils/utils.h"
+#include "irq/irq.h"
+#include "exti/exti.h"
+#include "tim_alloc/tim_alloc.h"
+#include "siginject/siginject.h"
+#include "timebase/timebase.h"
+
+/* Preprocessor Defines ---------------------------------------------------- */
+/**
+ * @brief Baud rate of the report on USART1.
+ */
+#define MAIN_UART_BAUD          115200u
+
+/**
+ * @brief Run time of the potis_dma acquisition benchmark in ms.
+ */
+#define MAIN_ADC_TIME_MS        1000u
+
+/**
+ * @brief Latency harness: TIM10 period (one edge per period, 10 kHz at
+ *        180 MHz), samples per source and the time limit per source.
+ */
+#define MAIN_LATENCY_PERIOD     18000u
+#define MAIN_LATENCY_SAMPLES    10000u
+#define MAIN_LATENCY_TIMEOUT_MS 3000u
+
+/**
+ * @brief Latency histogram: bins of MAIN_LATENCY_BIN_CYCLES, the last one
+ *        collects everything above.
+ */
+#define MAIN_LATENCY_BINS       24u
+#define MAIN_LATENCY_BIN_CYCLES 4u
+
+/**
+ * @brief Hardware in the loop: tick rate of the waveforms (ticks are
+ *        microseconds), half period of the poti step, steps measured,
+ *        settling time, tacho pulses per loop and the sampling time and
+ *        interval of one speed.
+ */
+#define MAIN_INJECT_TICK_HZ     1000000u
+#define MAIN_INJECT_STEP_US     100000u
+#define MAIN_INJECT_STEPS       16u
+#define MAIN_INJECT_SETTLE_MS   500u
+#define MAIN_INJECT_PULSES      8u
+#define MAIN_INJECT_RPM_MS      1000u
+#define MAIN_INJECT_RPM_POLL_MS 10u
+
+/**
+ * @brief Name of the compiled BME280 compensation variant.
+ */
+#if defined(BME280_64BIT_ENABLE)
+#define MAIN_BME280_NAME        "bme280_comp_64"
+#elif defined(BME280_32BIT_ENABLE)
+#define MAIN_BME280_NAME        "bme280_comp_32"
+#else
+#define MAIN_BME280_NAME        "bme280_comp_dbl"
+#endif
+
+/* Type Definitions -------------------------------------------------------- */
+/**
+ * @brief One benchmark.
+ */
+typedef struct {
+    const char *pch_name;
+    void      (*run)(void);     /**< One operation                     */
+    void      (*wait)(void);    /**< Completion (DMA), NULL if none    */
+    uint32_t    u32_reps;       /**< Timed operations                  */
+    uint32_t    u32_items;      /**< Items per operation               */
+} main_bench_t;
+
+/**
+ * @brief Interrupt sources of the latency harness.
+ */
+typedef enum {
+    MAIN_LATENCY_TIMER = 0,     /**< TIM10 through the tim_alloc dispatch */
+    MAIN_LATENCY_EXTI0,         /**< EXTI0_IRQHandler, PA0                */
+    MAIN_LATENCY_EXTI9_5,       /**< EXTI9_5_IRQHandler, PE6              */
+    MAIN_LATENCY_COUNT,
+    MAIN_LATENCY_OFF = MAIN_LATENCY_COUNT
+} main_latency_source_t;
+
+/**
+ * @brief Latency of one source in core cycles.
+ */
+typedef struct {
+    uint32_t u32_samples;
+    uint32_t u32_min;
+    uint32_t u32_max;
+    uint64_t u64_total;
+    uint32_t au32_bins[MAIN_LATENCY_BINS];
+} main_latency_t;
+
+/**
+ * @brief Minimum, mean and maximum of a hardware in the loop result.
+ */
+typedef struct {
+    uint32_t u32_samples;
+    uint32_t u32_min;
+    uint32_t u32_max;
+    uint64_t u64_total;
+} main_inject_stats_t;
+
+/* Static Module Variables ------------------------------------------------- */
+static UART_HandleTypeDef g_main_uart;
+static uint32_t g_u32_main_seed = 12345u;
+static uint32_t g_u32_main_toggle = 0u;
+static volatile uint32_t g_u32_main_sink;
+
+static median_filter_t g_main_median_9;
+static median_filter_t g_main_median_31;
+static uint32_t g_u32_main_network[9];
+
+static volatile main_latency_source_t g_main_latency_source = MAIN_LATENCY_OFF;
+static main_latency_t g_main_latency;
+static uint32_t g_u32_main_latency_scale = 1u;
+
+/**
+ * @brief Latency sources: name, EXTI port and pin (NULL: timer source).
+ */
+static const struct {
+    const char   *pch_name;
+    GPIO_TypeDef *port;
+    uint16_t      u16_pin;
+} g_main_latency_sources[MAIN_LATENCY_COUNT] = {
+    [MAIN_LATENCY_TIMER]   = { "lat_tim10_up",  NULL,  0u         },
+    [MAIN_LATENCY_EXTI0]   = { "lat_exti0",     GPIOA, GPIO_PIN_0 },
+    [MAIN_LATENCY_EXTI9_5] = { "lat_exti9_5",   GPIOE, GPIO_PIN_6 },
+};
+
+#if SIGINJECT_ENABLE
+/**
+ * @brief Poti step (high, low) and the tacho train of the current speed.
+ */
+static const uint16_t g_au16_main_inject_step[2] = { SIGINJECT_LEVEL_HIGH, SIGINJECT_LEVEL_LOW };
+static uint16_t g_au16_main_inject_levels[2u * MAIN_INJECT_PULSES];
+static uint32_t g_au32_main_inject_reloads[2u * MAIN_INJECT_PULSES];
+
+/**
+ * @brief Next step edge on PA4: time and sample (set by the callback).
+ */
+static volatile uint32_t g_u32_main_inject_edge_us;
+static volatile uint8_t g_u8_main_inject_edge_index;
+static volatile uint8_t g_u8_main_inject_edge_new;
+#endif
+
+/**
+ * @brief Calibration and raw values of the BME280 datasheet example.
+ */
+static struct bme280_calib_data g_main_calib = {
+    .dig_t1 = 27504, .dig_t2 = 26435, .dig_t3 = -1000,
+    .dig_p1 = 36477, .dig_p2 = -10685, .dig_p3 = 3024, .dig_p4 = 2855,
+    .dig_p5 = 140, .dig_p6 = -7, .dig_p7 = 15500, .dig_p8 = -14600, .dig_p9 = 6000,
+    .dig_h1 = 75, .dig_h2 = 362, .dig_h3 = 0, .dig_h4 = 313, .dig_h5 = 50, .dig_h6 = 30
+};
+static const struct bme280_uncomp_data g_main_uncomp = {
+    .pressure = 415148u, .temperature = 519888u, .humidity = 30000u
+};
+
+/* Function Prototypes ----------------------------------------------------- */
+int __io_putchar(int ch);
+
+static void main_uart_init(void);
+static void main_puts(const char *pch_text);
+static void main_report(const char *pch_name, uint32_t u32_min, uint32_t u32_mean, uint32_t u32_items);
+static void main_run(const main_bench_t *bench);
+static uint32_t main_random(void);
+
+static void main_lcd_wait(void);
+static void main_lcd_fill(void);
+static void main_lcd_text(void);
+static void main_lcd_update(void);
+static void main_lcd_bargraph(void);
+static void main_median_global(void);
+static void main_median_9(void);
+static void main_median_31(void);
+static void main_median_network(void);
+static void main_bme280(void);
+static void main_fan_pi(void);
+static void main_potis_read(void);
+static void main_latency_init(void);
+static void main_latency_run(main_latency_source_t source);
+static void main_latency_report(const char *pch_name);
+static void main_latency_record(uint32_t u32_ticks);
+static void main_latency_edge(void *context);
+static void main_latency_timer(TIM_TypeDef *tim, uint32_t u32_flags, void *context);
+#if SIGINJECT_ENABLE
+static void main_inject_poti(void);
+static void main_inject_rpm(void);
+static void main_inject_edge(siginject_out_t out, uint16_t u16_index, uint32_t u32_stamp);
+static void main_inject_add(main_inject_stats_t *stats, uint32_t u32_value);
+static void main_inject_report(const char *pch_name, const main_inject_stats_t *stats, uint32_t u32_extra);
+#endif
+
+/**
+ * @brief LCD benchmarks, run once per backend.
+ */
+static const main_bench_t g_main_lcd_benches[] = {
+    { "lcd_fill",      main_lcd_fill,     main_lcd_wait, 10u,   76800u },
+    { "lcd_text",      main_lcd_text,     main_lcd_wait, 100u,  16u    },
+    { "lcd_update",    main_lcd_update,   main_lcd_wait, 100u,  1u     },
+    { "lcd_bargraph",  main_lcd_bargraph, main_lcd_wait, 100u,  1u     },
+};
+
+/**
+ * @brief Computation benchmarks.
+ */
+static const main_bench_t g_main_benches[] = {
+    { "median_global", main_median_global,  NULL, 1000u, 1u },
+    { "median_9",      main_median_9,       NULL, 1000u, 1u },
+    { "median_31",     main_median_31,      NULL, 1000u, 1u },
+    { "median_net_9",  main_median_network, NULL, 1000u, 1u },
+    { MAIN_BME280_NAME, main_bme280,        NULL, 1000u, 1u },
+    { "fan_pi_step",   main_fan_pi,         NULL, 1000u, 1u },
+};
+
+/* Public Functions -------------------------------------------------------- */
+/**
+ * @brief Main program entry point.
+ *
+ * @details
+ * Initializes clock, report outputs and the modules under test, runs all
+ * benchmarks once and prints the profile table of the acquisition run.
+ *
+ * @return int Program should never return.
+ */
+int main(void)
+{
+    HAL_Init();
+    irq_init();
+    clock_init(CLOCK_PROFILE_180MHZ);
+
+    main_uart_init();
+    trace_init(TRACE_SWO_BAUD);
+    profile_init();
+
+    main_puts("\r\nB0_Benchmarks, cycles at ");
+    {
+        char buffer[16];
+        fmt_t fmt;
+
+        fmt_init(&fmt, buffer, sizeof(buffer));
+        fmt_u32(&fmt, SystemCoreClock / 1000000u, 0u, ' ');
+        fmt_str(&fmt, " MHz\r\n");
+        main_puts(fmt_get(&fmt));
+    }
+    main_puts("bench              min_cyc  mean_cyc     ops/s   items/s\r\n");
+
+    /* lcd, SPI first, then framebuffer (falls back to SPI if it fails) */
+    lcd_init_backend(LCD_BACKEND_SPI);
+    main_puts("-- lcd spi\r\n");
+    for (uint8_t i = 0u; i < sizeof(g_main_lcd_benches) / sizeof(g_main_lcd_benches[0]); i++) {
+        main_run(&g_main_lcd_benches[i]);
+    }
+
+    lcd_init_backend(LCD_BACKEND_FRAMEBUFFER);
+    if (lcd_get_backend() == LCD_BACKEND_FRAMEBUFFER) {
+        main_puts("-- lcd framebuffer\r\n");
+        for (uint8_t i = 0u; i < sizeof(g_main_lcd_benches) / sizeof(g_main_lcd_benches[0]); i++) {
+            main_run(&g_main_lcd_benches[i]);
+        }
+    }
+
+    /* Filters, compensation, controller */
+    median_filter_init(&g_main_median_9, 9u, 0u);
+    median_filter_init(&g_main_median_31, 31u, 0u);
+    fan_control_init();
+    fan_change_target_rpm(FAN_MAX_RPM / 2u);
+
+    main_puts("-- compute\r\n");
+    for (uint8_t i = 0u; i < sizeof(g_main_benches) / sizeof(g_main_benches[0]); i++) {
+        main_run(&g_main_benches[i]);
+    }
+
+    /* Acquisition: the filter runs in the DMA interrupt, timed by its zone */
+    main_puts("-- potis_dma\r\n");
+    profile_reset();
+    potis_dma_init_mode(POTIS_DMA_MODE_TIMER, POTIS_DMA_DEFAULT_SAMPLE_RATE_HZ);
+    potis_dma_start();
+    HAL_Delay(MAIN_ADC_TIME_MS);
+    {
+        profile_stats_t stats = *profile_get(PROFILE_ZONE_POTIS_BLOCK);
+
+        if (stats.u32_calls > 0u) {
+            main_report("potis_block", stats.u32_min,
+                        (uint32_t)(stats.u64_total / stats.u32_calls),
+                        NON_FILTERED_DATA_ARRAY_LENGTH / 2u);
+        }
+    }
+    {
+        const main_bench_t read = { "potis_read", main_potis_read, NULL, 1000u, FILTERED_DATA_ARRAY_LENGTH };
+
+        main_run(&read);
+    }
+
+#if SIGINJECT_ENABLE
+    /* Hardware in the loop, before the latency harness takes PE6 from the fan */
+    main_puts("-- hil (us / rpm)\r\n");
+    main_puts("bench                  min      mean       max    jitter / err_pm\r\n");
+    main_inject_poti();
+    main_inject_rpm();
+#endif
+
+    /* Interrupt latency under display load, fan tacho line taken over */
+    main_puts("-- irq latency (cycles, lcd load)\r\n");
+    main_puts("bench              min_cyc  mean_cyc   max_cyc    jitter\r\n");
+    lcd_init_backend(LCD_BACKEND_SPI);
+    main_latency_init();
+    for (uint8_t i = 0u; i < (uint8_t)MAIN_LATENCY_COUNT; i++) {
+        main_latency_run((main_latency_source_t)i);
+        main_latency_report(g_main_latency_sources[i].pch_name);
+    }
+
+    main_puts("-- profile\r\n");
+    profile_dump(__io_putchar);
+    main_puts("done\r\n");
+
+    while (1) {
+        __WFI();
+    }
+}
+
+/**
+ * @brief Character output of the report, also used by printf (syscalls).
+ *
+ * @param ch Character
+ * @return ch
+ */
+int __io_putchar(int ch)
+{
+    while ((g_main_uart.Instance->SR & USART_SR_TXE) == 0u) {
+    }
+    g_main_uart.Instance->DR = (uint8_t)ch;
+
+    return trace_putc(ch);
+}
+
+/* Static Functions -------------------------------------------------------- */
+/**
+ * @brief Configures USART1 TX on PA9 (ST-LINK virtual COM port).
+ */
+static void main_uart_init(void)
+{
+    GPIO_InitTypeDef gpio_init_struct;
+
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+    __HAL_RCC_USART1_CLK_ENABLE();
+
+    gpio_init_struct.Pin       = GPIO_PIN_9;
+    gpio_init_struct.Mode      = GPIO_MODE_AF_PP;
+    gpio_init_struct.Pull      = GPIO_PULLUP;
+    gpio_init_struct.Speed     = GPIO_SPEED_FREQ_HIGH;
+    gpio_init_struct.Alternate = GPIO_AF7_USART1;
+    HAL_GPIO_Init(GPIOA, &gpio_init_struct);
+
+    g_main_uart.Instance          = USART1;
+    g_main_uart.Init.BaudRate     = MAIN_UART_BAUD;
+    g_main_uart.Init.WordLength   = UART_WORDLENGTH_8B;
+    g_main_uart.Init.StopBits     = UART_STOPBITS_1;
+    g_main_uart.Init.Parity       = UART_PARITY_NONE;
+    g_main_uart.Init.Mode         = UART_MODE_TX;
+    g_main_uart.Init.HwFlowCtl    = UART_HWCONTROL_NONE;
+    g_main_uart.Init.OverSampling = UART_OVERSAMPLING_16;
+    HAL_UART_Init(&g_main_uart);
+}
+
+/**
+ * @brief Writes a string to the report outputs.
+ *
+ * @param pch_text NUL terminated string
+ */
+static void main_puts(const char *pch_text)
+{
+    while (*pch_text != '\0') {
+        __io_putchar(*pch_text++);
+    }
+}
+
+/**
+ * @brief Prints one result line.
+ *
+ * @param pch_name  Benchmark name
+ * @param u32_min   Best cycles per operation
+ * @param u32_mean  Mean cycles per operation
+ * @param u32_items Items per operation
+ */
+static void main_report(const char *pch_name, uint32_t u32_min, uint32_t u32_mean, uint32_t u32_items)
+{
+    char buffer[80];
+    fmt_t fmt;
+    uint32_t u32_ops = (u32_mean > 0u) ? (SystemCoreClock / u32_mean) : 0u;
+    uint64_t u64_items = (u32_mean > 0u) ?
+        ((uint64_t)SystemCoreClock * u32_items) / u32_mean : 0u;
+
+    fmt_init(&fmt, buffer, sizeof(buffer));
+    fmt_str(&fmt, pch_name);
+    fmt_pad(&fmt, 16u);
+    fmt_u32(&fmt, u32_min, 10u, ' ');
+    fmt_u32(&fmt, u32_mean, 10u, ' ');
+    fmt_u32(&fmt, u32_ops, 10u, ' ');
+    fmt_u32(&fmt, (u64_items > UINT32_MAX) ? UINT32_MAX : (uint32_t)u64_items, 10u, ' ');
+    fmt_str(&fmt, "\r\n");
+    main_puts(fmt_get(&fmt));
+}
+
+/**
+ * @brief Runs a benchmark: one untimed warm-up, then u32_reps timed
+ *        operations including the completion wait.
+ *
+ * @param bench Benchmark
+ */
+static void main_run(const main_bench_t *bench)
+{
+    uint32_t u32_min = UINT32_MAX;
+    uint64_t u64_total = 0u;
+
+    bench->run();
+    if (bench->wait != NULL) {
+        bench->wait();
+    }
+
+    for (uint32_t i = 0u; i < bench->u32_reps; i++) {
+        uint32_t u32_start = utils_now_cycles();
+        uint32_t u32_cycles;
+
+        bench->run();
+        if (bench->wait != NULL) {
+            bench->wait();
+        }
+        u32_cycles = utils_elapsed_cycles(u32_start);
+
+        u64_total += u32_cycles;
+        if (u32_cycles < u32_min) {
+            u32_min = u32_cycles;
+        }
+    }
+
+    main_report(bench->pch_name, u32_min, (uint32_t)(u64_total / bench->u32_reps), bench->u32_items);
+}
+
+/**
+ * @brief Pseudo random 12 bit value (LCG), same sequence every run.
+ *
+ * @return 0 .. 4095
+ */
+static uint32_t main_random(void)
+{
+    g_u32_main_seed = g_u32_main_seed * 1664525u + 1013904223u;
+
+    return g_u32_main_seed >> 20;
+}
+
+/**
+ * @brief Waits until the active lcd backend has finished drawing.
+ */
+static void main_lcd_wait(void)
+{
+    if (lcd_get_backend() == LCD_BACKEND_FRAMEBUFFER) {
+        framebuffer_wait();
+    } else {
+        ILI9341_DMA_Wait();
+    }
+}
+
+/**
+ * @brief Full screen fill, alternating colour.
+ */
+static void main_lcd_fill(void)
+{
+    lcd_fill_screen((g_u32_main_toggle++ & 1u) ? BLACK : WHITE);
+}
+
+/**
+ * @brief One line of 16 characters, size 2.
+ */
+static void main_lcd_text(void)
+{
+    lcd_draw_text_at_line("0123456789ABCDEF", 5u, BLACK, 2u, WHITE);
+}
+
+/**
+ * @brief Retained text update with one changed glyph.
+ */
+static void main_lcd_update(void)
+{
+    lcd_update_text_at_line((g_u32_main_toggle++ & 1u) ? "Count: 1" : "Count: 0", 7u, BLACK, 2u, WHITE);
+}
+
+/**
+ * @brief Bargraph toggling between 25 % and 75 %.
+ */
+static void main_lcd_bargraph(void)
+{
+    my_lcd_draw_baargraph(20, 200, 200, 30, (g_u32_main_toggle++ & 1u) ? 750 : 250, GREEN, WHITE);
+}
+
+/**
+ * @brief Global median filter (median_get_median()).
+ */
+static void main_median_global(void)
+{
+    g_u32_main_sink = median_get_median(main_random());
+}
+
+/**
+ * @brief Instance median filter, 9 values.
+ */
+static void main_median_9(void)
+{
+    g_u32_main_sink = median_filter_update(&g_main_median_9, main_random());
+}
+
+/**
+ * @brief Instance median filter, 31 values.
+ */
+static void main_median_31(void)
+{
+    g_u32_main_sink = median_filter_update(&g_main_median_31, main_random());
+}
+
+/**
+ * @brief Sorting network of 9 values, one value replaced per call.
+ */
+static void main_median_network(void)
+{
+    g_u32_main_network[g_u32_main_toggle++ % 9u] = main_random();
+    g_u32_main_sink = median_network_9(g_u32_main_network);
+}
+
+/**
+ * @brief Temperature, pressure and humidity compensation of one sample.
+ */
+static void main_bme280(void)
+{
+    struct bme280_data data;
+
+    bme280_compensate_data(BME280_ALL, &g_main_uncomp, &data, &g_main_calib);
+    g_u32_main_sink = (uint32_t)data.pressure;
+}
+
+/**
+ * @brief One PI controller step of the default fan (TIM6 not started).
+ */
+static void main_fan_pi(void)
+{
+    fan_update_pi_controller();
+}
+
+/**
+ * @brief Reads the averages of both potentiometers.
+ */
+static void main_potis_read(void)
+{
+    potis_dma_filter_data();
+}
+
+/**
+ * @brief Sets up TIM10 (core clock, output compare toggle on PB8) and
+ *        the tick to cycle factor. The timer is started per source.
+ */
+static void main_latency_init(void)
+{
+    GPIO_InitTypeDef gpio_init_struct;
+    uint32_t u32_timer_hz = HAL_RCC_GetPCLK2Freq();
+
+    /* APB2 prescaler > 1: the timers run at twice PCLK2 */
+    if ((RCC->CFGR & RCC_CFGR_PPRE2) != RCC_CFGR_PPRE2_DIV1) {
+        u32_timer_hz *= 2u;
+    }
+    g_u32_main_latency_scale = (u32_timer_hz > 0u) ? (SystemCoreClock / u32_timer_hz) : 1u;
+
+    __HAL_RCC_GPIOB_CLK_ENABLE();
+    __HAL_RCC_GPIOE_CLK_ENABLE();
+    if (tim_alloc_claim(TIM10, TIM_ALLOC_OWNER_APP) != HAL_OK) {
+        return;
+    }
+
+    gpio_init_struct.Pin       = GPIO_PIN_8;
+    gpio_init_struct.Mode      = GPIO_MODE_AF_PP;
+    gpio_init_struct.Pull      = GPIO_NOPULL;
+    gpio_init_struct.Speed     = GPIO_SPEED_FREQ_VERY_HIGH;
+    gpio_init_struct.Alternate = GPIO_AF3_TIM10;
+    HAL_GPIO_Init(GPIOB, &gpio_init_struct);
+
+    TIM10->CR1   = 0u;
+    TIM10->PSC   = 0u;
+    TIM10->ARR   = MAIN_LATENCY_PERIOD - 1u;
+    TIM10->CCR1  = MAIN_LATENCY_PERIOD / 2u;
+    TIM10->CCMR1 = TIM_CCMR1_OC1M_0 | TIM_CCMR1_OC1M_1;     /* toggle on match */
+    TIM10->CCER  = TIM_CCER_CC1E;
+    TIM10->EGR   = TIM_EGR_UG;
+    TIM10->SR    = 0u;
+
+    (void)tim_alloc_set_handler(TIM10, main_latency_timer, NULL, IRQ_CLASS_CAPTURE);
+}
+
+/**
+ * @brief Collects the latencies of one source while the LCD is filled
+ *        in the background.
+ *
+ * @param source Interrupt source
+ */
+static void main_latency_run(main_latency_source_t source)
+{
+    uint32_t u32_start;
+    GPIO_TypeDef *port = g_main_latency_sources[source].port;
+    uint16_t u16_pin = g_main_latency_sources[source].u16_pin;
+    uint8_t u8_line = exti_pin_to_line(u16_pin);
+
+    g_main_latency.u32_samples = 0u;
+    g_main_latency.u32_min     = UINT32_MAX;
+    g_main_latency.u32_max     = 0u;
+    g_main_latency.u64_total   = 0u;
+    for (uint32_t i = 0u; i < MAIN_LATENCY_BINS; i++) {
+        g_main_latency.au32_bins[i] = 0u;
+    }
+
+    if (port != NULL) {
+        GPIO_InitTypeDef gpio_init_struct;
+
+        /* The line may belong to a module (PE6: fan tacho) */
+        exti_unregister(u8_line);
+        if (exti_register(u8_line, main_latency_edge, NULL) != HAL_OK) {
+            return;
+        }
+        gpio_init_struct.Pin   = u16_pin;
+        gpio_init_struct.Mode  = GPIO_MODE_IT_RISING_FALLING;
+        gpio_init_struct.Pull  = GPIO_NOPULL;
+        gpio_init_struct.Speed = GPIO_SPEED_FREQ_LOW;
+        HAL_GPIO_Init(port, &gpio_init_struct);
+        exti_enable_irq(u8_line, IRQ_CLASS_CAPTURE, 0u);
+        TIM10->DIER = 0u;
+    } else {
+        TIM10->DIER = TIM_DIER_UIE;
+    }
+
+    g_main_latency_source = source;
+    TIM10->CNT = 0u;
+    TIM10->SR  = 0u;
+    TIM10->CR1 = TIM_CR1_CEN;
+
+    u32_start = HAL_GetTick();
+    while ((g_main_latency.u32_samples < MAIN_LATENCY_SAMPLES) &&
+           ((HAL_GetTick() - u32_start) < MAIN_LATENCY_TIMEOUT_MS)) {
+        main_lcd_fill();
+        main_lcd_wait();
+    }
+
+    TIM10->CR1  = 0u;
+    TIM10->DIER = 0u;
+    g_main_latency_source = MAIN_LATENCY_OFF;
+    if (port != NULL) {
+        exti_unregister(u8_line);
+    }
+}
+
+/**
+ * @brief Prints the latency summary and the non-empty histogram bins.
+ *
+ * @param pch_name Source name
+ */
+static void main_latency_report(const char *pch_name)
+{
+    char buffer[80];
+    fmt_t fmt;
+    const main_latency_t *lat = &g_main_latency;
+
+    fmt_init(&fmt, buffer, sizeof(buffer));
+    fmt_str(&fmt, pch_name);
+    fmt_pad(&fmt, 16u);
+    if (lat->u32_samples == 0u) {
+        fmt_str(&fmt, "  no samples\r\n");
+        main_puts(fmt_get(&fmt));
+        return;
+    }
+    fmt_u32(&fmt, lat->u32_min, 10u, ' ');
+    fmt_u32(&fmt, (uint32_t)(lat->u64_total / lat->u32_samples), 10u, ' ');
+    fmt_u32(&fmt, lat->u32_max, 10u, ' ');
+    fmt_u32(&fmt, lat->u32_max - lat->u32_min, 10u, ' ');
+    fmt_str(&fmt, "\r\n");
+    main_puts(fmt_get(&fmt));
+
+    for (uint32_t i = 0u; i < MAIN_LATENCY_BINS; i++) {
+        if (lat->au32_bins[i] == 0u) {
+            continue;
+        }
+        fmt_init(&fmt, buffer, sizeof(buffer));
+        fmt_str(&fmt, (i == (MAIN_LATENCY_BINS - 1u)) ? "  >=" : "    ");
+        fmt_u32(&fmt, i * MAIN_LATENCY_BIN_CYCLES, 5u, ' ');
+        fmt_u32(&fmt, lat->au32_bins[i], 10u, ' ');
+        fmt_str(&fmt, "\r\n");
+        main_puts(fmt_get(&fmt));
+    }
+}
+
+/**
+ * @brief Adds one latency (interrupt context).
+ *
+ * @param u32_ticks TIM10 ticks from the event to the handler
+ */
+static void main_latency_record(uint32_t u32_ticks)
+{
+    main_latency_t *lat = &g_main_latency;
+    uint32_t u32_cycles = u32_ticks * g_u32_main_latency_scale;
+    uint32_t u32_bin = u32_cycles / MAIN_LATENCY_BIN_CYCLES;
+
+    if (lat->u32_samples >= MAIN_LATENCY_SAMPLES) {
+        return;
+    }
+    lat->u32_samples++;
+    lat->u64_total += u32_cycles;
+    if (u32_cycles < lat->u32_min) {
+        lat->u32_min = u32_cycles;
+    }
+    if (u32_cycles > lat->u32_max) {
+        lat->u32_max = u32_cycles;
+    }
+    lat->au32_bins[(u32_bin < MAIN_LATENCY_BINS) ? u32_bin : (MAIN_LATENCY_BINS - 1u)]++;
+}
+
+/**
+ * @brief EXTI handler of the latency harness: counter now minus the
+ *        compare value of the edge.
+ *
+ * @param context Unused
+ */
+static void main_latency_edge(void *context)
+{
+    uint32_t u32_now = TIM10->CNT;
+
+    (void)context;
+    if (g_main_latency_source != MAIN_LATENCY_OFF) {
+        main_latency_record((u32_now + MAIN_LATENCY_PERIOD - TIM10->CCR1) % MAIN_LATENCY_PERIOD);
+    }
+}
+
+/**
+ * @brief TIM10 update: the counter restarted at 0 with the event, its
+ *        value is the latency (including the tim_alloc dispatch).
+ *
+ * @param tim       TIM10
+ * @param u32_flags Pending flags, cleared by the dispatch
+ * @param context   Unused
+ */
+static void main_latency_timer(TIM_TypeDef *tim, uint32_t u32_flags, void *context)
+{
+    uint32_t u32_now = tim->CNT;
+
+    (void)context;
+    if ((g_main_latency_source == MAIN_LATENCY_TIMER) && ((u32_flags & TIM_SR_UIF) != 0u)) {
+        main_latency_record(u32_now);
+    }
+}
+
+#if SIGINJECT_ENABLE
+/**
+ * @brief Steps PA4 between the DAC limits and measures how long the
+ *        filtered POTI_1 value needs to cover 50 % and 90 % of a step.
+ *        The settled ends of the path are the reference.
+ */
+static void main_inject_poti(void)
+{
+    const siginject_wave_t wave = {
+        g_au16_main_inject_step, NULL, 2u, MAIN_INJECT_TICK_HZ, MAIN_INJECT_STEP_US, 1u
+    };
+    main_inject_stats_t t50 = { 0u, UINT32_MAX, 0u, 0u };
+    main_inject_stats_t t90 = { 0u, UINT32_MAX, 0u, 0u };
+    uint32_t u32_low;
+    uint32_t u32_high;
+
+    if (siginject_init(SIGINJECT_OUT1) != HAL_OK) {
+        main_puts("poti_step         no output\r\n");
+        return;
+    }
+
+    (void)siginject_set_level(SIGINJECT_OUT1, SIGINJECT_LEVEL_HIGH);
+    HAL_Delay(MAIN_INJECT_SETTLE_MS);
+    potis_dma_filter_data();
+    u32_high = potis_dma_get_val(POTI_1);
+    (void)siginject_set_level(SIGINJECT_OUT1, SIGINJECT_LEVEL_LOW);
+    HAL_Delay(MAIN_INJECT_SETTLE_MS);
+    potis_dma_filter_data();
+    u32_low = potis_dma_get_val(POTI_1);
+    if (u32_high < u32_low + 1000u) {
+        main_puts("poti_step         no wire PA4 - PA6\r\n");
+        return;
+    }
+
+    g_u8_main_inject_edge_new = 0u;
+    if (siginject_start(SIGINJECT_OUT1, &wave, main_inject_edge) != HAL_OK) {
+        main_puts("poti_step         dma busy\r\n");
+        return;
+    }
+
+    for (uint32_t u32_step = 0u; u32_step < MAIN_INJECT_STEPS; u32_step++) {
+        uint32_t u32_start = HAL_GetTick();
+        uint32_t u32_span = u32_high - u32_low;
+        uint8_t u8_crossed = 0u;
+
+        while (!g_u8_main_inject_edge_new && ((HAL_GetTick() - u32_start) < MAIN_LATENCY_TIMEOUT_MS)) {
+        }
+        if (!g_u8_main_inject_edge_new) {
+            break;
+        }
+        /* The callback of the next edge comes when this one is output */
+        uint32_t u32_edge = g_u32_main_inject_edge_us;
+        uint8_t u8_rising = (g_u8_main_inject_edge_index == 0u);
+        g_u8_main_inject_edge_new = 0u;
+
+        int32_t s32_elapsed;
+        do {
+            s32_elapsed = (int32_t)(timebase_now32() - u32_edge);
+            if (s32_elapsed < 0) {
+                continue;
+            }
+            potis_dma_filter_data();
+            uint32_t u32_value = potis_dma_get_val(POTI_1);
+            uint32_t u32_covered = u8_rising ? ((u32_value > u32_low) ? (u32_value - u32_low) : 0u)
+                                             : ((u32_value < u32_high) ? (u32_high - u32_value) : 0u);
+
+            if (!(u8_crossed & 1u) && ((2u * u32_covered) >= u32_span)) {
+                main_inject_add(&t50, (uint32_t)s32_elapsed);
+                u8_crossed |= 1u;
+            }
+            if (!(u8_crossed & 2u) && ((10u * u32_covered) >= (9u * u32_span))) {
+                main_inject_add(&t90, (uint32_t)s32_elapsed);
+                u8_crossed |= 2u;
+            }
+        } while (s32_elapsed < (int32_t)MAIN_INJECT_STEP_US);
+    }
+
+    siginject_stop(SIGINJECT_OUT1);
+    (void)siginject_set_level(SIGINJECT_OUT1, SIGINJECT_LEVEL_LOW);
+
+    main_inject_report("poti_t50", &t50, t50.u32_max - t50.u32_min);
+    main_inject_report("poti_t90", &t90, t90.u32_max - t90.u32_min);
+}
+
+/**
+ * @brief Injects tacho pulse trains of fixed speeds on PA5 and compares
+ *        the speed the fan module measures.
+ */
+static void main_inject_rpm(void)
+{
+    static const uint32_t au32_rpm[] = { 600u, 1200u, 2500u, 5000u };
+    char buffer[16];
+    fmt_t fmt;
+    fan_t *fan = fan_get_default();
+
+    if (siginject_init(SIGINJECT_OUT2) != HAL_OK) {
+        main_puts("rpm               no output\r\n");
+        return;
+    }
+
+    for (uint8_t i = 0u; i < sizeof(au32_rpm) / sizeof(au32_rpm[0]); i++) {
+        const siginject_wave_t wave = {
+            g_au16_main_inject_levels, g_au32_main_inject_reloads, 2u * MAIN_INJECT_PULSES,
+            MAIN_INJECT_TICK_HZ, 0u, 1u
+        };
+        main_inject_stats_t rpm = { 0u, UINT32_MAX, 0u, 0u };
+        uint32_t u32_error = 0u;
+
+        fmt_init(&fmt, buffer, sizeof(buffer));
+        fmt_str(&fmt, "rpm_");
+        fmt_u32(&fmt, au32_rpm[i], 0u, ' ');
+
+        if ((siginject_tacho(g_au16_main_inject_levels, g_au32_main_inject_reloads, MAIN_INJECT_PULSES,
+                             au32_rpm[i], MAIN_INJECT_TICK_HZ) != HAL_OK) ||
+            (siginject_start(SIGINJECT_OUT2, &wave, NULL) != HAL_OK)) {
+            fmt_str(&fmt, "  failed\r\n");
+            main_puts(fmt_get(&fmt));
+            continue;
+        }
+
+        /* Filter of the fan module settled, then sample it */
+        HAL_Delay(MAIN_INJECT_SETTLE_MS);
+        uint32_t u32_start = HAL_GetTick();
+        while ((HAL_GetTick() - u32_start) < MAIN_INJECT_RPM_MS) {
+            main_inject_add(&rpm, fan_get_rpm(fan));
+            HAL_Delay(MAIN_INJECT_RPM_POLL_MS);
+        }
+        siginject_stop(SIGINJECT_OUT2);
+
+        if (rpm.u32_samples > 0u) {
+            uint32_t u32_mean = (uint32_t)(rpm.u64_total / rpm.u32_samples);
+            uint32_t u32_diff = (u32_mean > au32_rpm[i]) ? (u32_mean - au32_rpm[i]) : (au32_rpm[i] - u32_mean);
+
+            u32_error = (u32_diff * 1000u) / au32_rpm[i];
+        }
+        main_inject_report(fmt_get(&fmt), &rpm, u32_error);
+    }
+}
+
+/**
+ * @brief Waveform callback of the poti step (interrupt context): the
+ *        sample just loaded appears one half period later.
+ *
+ * @param out       Output
+ * @param u16_index 0: rising edge next, 1: falling edge next
+ * @param u32_stamp Time of the callback
+ */
+static void main_inject_edge(siginject_out_t out, uint16_t u16_index, uint32_t u32_stamp)
+{
+    (void)out;
+    g_u32_main_inject_edge_us   = u32_stamp + MAIN_INJECT_STEP_US;
+    g_u8_main_inject_edge_index = (uint8_t)u16_index;
+    g_u8_main_inject_edge_new   = 1u;
+}
+
+/**
+ * @brief Adds one value to a result.
+ *
+ * @param stats     Result
+ * @param u32_value Value
+ */
+static void main_inject_add(main_inject_stats_t *stats, uint32_t u32_value)
+{
+    stats->u32_samples++;
+    stats->u64_total += u32_value;
+    if (u32_value < stats->u32_min) {
+        stats->u32_min = u32_value;
+    }
+    if (u32_value > stats->u32_max) {
+        stats->u32_max = u32_value;
+    }
+}
+
+/**
+ * @brief Prints min, mean, max and one further column of a result.
+ *
+ * @param pch_name  Benchmark name
+ * @param stats     Result
+ * @param u32_extra Jitter or error
+ */
+static void main_inject_report(const char *pch_name, const main_inject_stats_t *stats, uint32_t u32_extra)
+{
+    char buffer[80];
+    fmt_t fmt;
+
+    fmt_init(&fmt, buffer, sizeof(buffer));
+    fmt_str(&fmt, pch_name);
+    fmt_pad(&fmt, 16u);
+    if (stats->u32_samples == 0u) {
+        fmt_str(&fmt, "  no samples\r\n");
+        main_puts(fmt_get(&fmt));
+        return;
+    }
+    fmt_u32(&fmt, stats->u32_min, 10u, ' ');
+    fmt_u32(&fmt, (uint32_t)(stats->u64_total / stats->u32_samples), 10u, ' ');
+    fmt_u32(&fmt, stats->u32_max, 10u, ' ');
+    fmt_u32(&fmt, u32_extra, 10u, ' ');
+    fmt_str(&fmt, "\r\n");
+    main_puts(fmt_get(&fmt));
+}
+#endif
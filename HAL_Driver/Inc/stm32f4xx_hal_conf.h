@@ -26,6 +26,13 @@
  extern "C" {
 #endif
 
+/* ########################## Project Configuration ######################### */
+/**
+  * @brief Module configuration of the project (inc/project_conf.h), read
+  *        before the defaults of the modules
+  */
+#include "project_conf.h"
+
 /* Exported types ------------------------------------------------------------*/
 /* Exported constants --------------------------------------------------------*/
 
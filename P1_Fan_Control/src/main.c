@@ -9,95 +9,1553 @@
  *
  * @details
  * This application initializes the HAL, LCD, fan control and
- * potentiometer DMA module. The potentiometer value is read
- * continuously and mapped to a target fan RPM. The current
- * and target RPM are displayed on the LCD.
+ * potentiometer DMA module. LCD and control path start as overlapped
+ * boot steps (modules/boot): the fan spins up and the controller runs
+ * while the panel waits after reset and sleep out. Both producers publish on the data bus
+ * (modules/databus): the poti averages per DMA half buffer, target
+ * and filtered RPM per control step. A subscriber maps POTI_1 changes
+ * beyond the hysteresis band to a target fan RPM; display, telemetry
+ * and SD log read the published values instead of the modules.
  *
  * @resources
- *  - ADC (DMA based potentiometer input)
- *  - Timer (fan RPM measurement)
+ *  - ADC (DMA based potentiometer input, TIM8 triggered)
+ *  - Timer (TIM2 system timebase and fan RPM measurement, TIM6
+ *    fixed-rate PI control task, TIM13 tickless idle wakeup)
  *  - GPIO (LCD, fan)
+ *  - USART1, DMA2 Stream7/Stream2 (telemetry, UART_TELEMETRY_ENABLE only)
+ *  - OTG_HS on CN6 (raw ADC and tacho stream, USB_CDC_ENABLE only,
+ *    168 MHz for the 48 MHz USB clock)
+ *  - FMC / SDRAM (triggered capture ring, DATALOG_ENABLE only, dumped
+ *    over USB_CDC_ENABLE)
+ *  - Flash sectors 22/23 (parameter store: PI gains, maximum RPM, ADC
+ *    trims)
+ *  - Command shell on the telemetry UART (SHELL_ENABLE and
+ *    UART_TELEMETRY_ENABLE, replies as text frames)
+ *  - Other flash bank, option byte BFB2 (firmware update over the shell
+ *    UART, FW_UPDATE_ENABLE only)
+ *  - Backup SRAM (event trace of the last boots, BKPTRACE_ENABLE only,
+ *    shell command pm)
+ *  - Host clock sync over the telemetry UART (TELEMETRY_SYNC_ENABLE
+ *    with the shell, pings answered by uart_telemetry_decode.py --sync,
+ *    disciplines the RTC if running)
+ *  - SDIO, DMA2 Stream6 (long-term RPM log on the SD card, SDLOG_ENABLE
+ *    only, 168 MHz for the 48 MHz SDIO clock)
+ *  - Joystick on GPIOG, TIM3 key sampling (menu for target RPM and PI
+ *    gains below the readouts, MENU_ENABLE only)
  ******************************************************************************
  */
 
 /* Includes ---------------------------------------------------------------- */
 #include "stm32f4xx.h"
-#include <stdio.h>
+#include "bkptrace/bkptrace.h"
 
+#include "clock/clock.h"
 #include "lcd/lcd.h"
+#include "lcd/lcd_text_field.h"
+#include "fmt/fmt.h"
 #include "fan/fan.h"
+#include "fan/fan_step.h"
 #include "potis_dma/potis_dma.h"
+#include "adc_cal/adc_cal.h"
+#include "databus/databus.h"
+#include "sched/sched.h"
+#include "idle/idle.h"
+#include "trace/trace.h"
+#include "health/health.h"
+#include "uart_telemetry/uart_telemetry.h"
+#include "uart_telemetry/telemetry_batch.h"
+#include "uart_telemetry/telemetry_sync.h"
+#include "usb_cdc/usb_cdc.h"
+#include "sdram/sdram.h"
+#include "datalog/datalog.h"
+#include "params/params.h"
+#include "shell/shell.h"
+#include "profile/profile.h"
+#include "sdlog/sdlog.h"
+#include "boot/boot.h"
+#include "menu/menu.h"
+#include "screenshot/screenshot.h"
+#include "irq/irq.h"
+#include "dlog/dlog.h"
+#include "timebase/timebase.h"
+#include "deadline/deadline.h"
+#include "dvfs/dvfs.h"
+#include "fw_update/fw_update.h"
 
 /* Preprocessor Defines ---------------------------------------------------- */
 /**
- * @brief Converts an ADC value to a fan RPM value.
+ * @brief Converts an ADC value to a fan RPM value (multiply-shift).
  *
  * @param adc_value Raw ADC value
- * @param fan_max   Maximum fan RPM
- * @param adc_max   ADC resolution (e.g. 4095 for 12 bit)
  */
-#define MAIN_CONVERT_ADC_TO_RPM(adc_value, fan_max, adc_max) \
-    (((adc_value) * (fan_max)) / (adc_max))
+#define MAIN_CONVERT_ADC_TO_RPM(adc_value) \
+    (((adc_value) * g_u32_adc_to_rpm_q16) >> 16)
+
+/**
+ * @brief Period of the parameter store task in ms (flash writes, erase
+ *        polling).
+ */
+#define MAIN_PARAMS_PERIOD_MS   10u
+
+/**
+ * @brief Period of the display task in ms.
+ */
+#define MAIN_DISPLAY_PERIOD_MS  100u
+
+/**
+ * @brief Priority of the display task (lowest, runs when nothing else does).
+ */
+#define MAIN_DISPLAY_PRIORITY   SCHED_PRIORITY_LOWEST
+
+/**
+ * @brief Text size and lines of the RPM readouts, the values start behind
+ *        the 5 character labels ("TAR: ").
+ */
+#define MAIN_TEXT_SIZE          3u
+#define MAIN_LINE_TARGET        4u
+#define MAIN_LINE_CURRENT       6u
+#define MAIN_VALUE_X            (10u + 5u * 6u * MAIN_TEXT_SIZE)
+#define MAIN_LINE_Y(line)       ((line) * 8u * MAIN_TEXT_SIZE + 10u)
+
+/**
+ * @brief Measurement window of the health monitor in ms.
+ */
+#define MAIN_HEALTH_PERIOD_MS   1000u
+
+/**
+ * @brief Period of the telemetry task in ms, one fast sample per run
+ *        (TELEMETRY_BATCH_SAMPLES per frame).
+ */
+#define MAIN_TELEMETRY_PERIOD_MS 1u
+
+/**
+ * @brief Period of the tacho stream task in ms and timestamps per block
+ *        (more than FAN_EDGE_HISTORY edges per period are lost anyway).
+ */
+#define MAIN_USB_TACHO_PERIOD_MS 1u
+#define MAIN_USB_TACHO_EDGES     16u
+
+/**
+ * @brief Capture trigger: magnitude of the PI error in rpm, windows in
+ *        records and the period of the dump task in ms.
+ */
+#define MAIN_DATALOG_ERROR_RPM      500
+#define MAIN_DATALOG_PRE_RECORDS    100000u
+#define MAIN_DATALOG_POST_RECORDS   400000u
+#define MAIN_DATALOG_PERIOD_MS      10u
+#define MAIN_DATALOG_CHUNKS         4u
+
+/**
+ * @brief Period of the shell task in ms and decimals of the gains.
+ */
+#define MAIN_SHELL_PERIOD_MS    20u
+#define MAIN_GAIN_DECIMALS      5u
+
+/**
+ * @brief Periods of the SD log: samples and write polling in ms.
+ */
+#define MAIN_SDLOG_SAMPLE_PERIOD_MS 1000u
+#define MAIN_SDLOG_WRITE_PERIOD_MS  10u
+
+/**
+ * @brief Menu: task period, position below the readouts, visible rows and
+ *        rows drawn per run (MENU_ENABLE).
+ */
+#define MAIN_MENU_PERIOD_MS     20u
+#define MAIN_MENU_Y             200u
+#define MAIN_MENU_ROWS          4u
+#define MAIN_MENU_SIZE          2u
+#define MAIN_MENU_ROWS_PER_RUN  2u
+
+/**
+ * @brief Deadline supervisor (DEADLINE_ENABLE): poll period of the window
+ *        and period of the miss statistics on the telemetry port in ms.
+ */
+#define MAIN_DEADLINE_PERIOD_MS     10u
+#define MAIN_DEADLINE_REPORT_MS     1000u
+
+/**
+ * @brief Overspeed limit of the fan guard in percent of the maximum RPM:
+ *        full duty from the tacho interrupt, latched.
+ */
+#define MAIN_GUARD_OVERSPEED_PERCENT 125u
+
+/**
+ * @brief Display modes (shell command disp).
+ */
+#define MAIN_DISPLAY_RPM        0u
+#define MAIN_DISPLAY_OFF        1u
+
+#if SHELL_ENABLE && UART_TELEMETRY_ENABLE
+/**
+ * @brief Commands: length, first and last character (hash slot), name,
+ *        handler, usage.
+ */
+#define MAIN_SHELL_COMMANDS(X) \
+    X(4, 'h', 'p', "help",  main_cmd_help,  "help") \
+    X(2, 'k', 'p', "kp",    main_cmd_kp,    "kp [gain]") \
+    X(2, 'k', 'i', "ki",    main_cmd_ki,    "ki [gain 1/s]") \
+    X(3, 'r', 'm', "rpm",   main_cmd_rpm,   "rpm [target]") \
+    X(3, 'o', 'r', "osr",   main_cmd_osr,   "osr [t p h filter] (BME280, next start)") \
+    X(4, 'd', 'p', "disp",  main_cmd_disp,  "disp [0 rpm | 1 off]") \
+    X(4, 'p', 'f', "prof",  main_cmd_prof,  "prof [zone]") \
+    X(5, 's', 'd', "sched", main_cmd_sched, "sched [task]") \
+    X(5, 's', 's', "stats", main_cmd_stats, "stats") \
+    X(4, 's', 'e', "save",  main_cmd_save,  "save (gains to flash)") \
+    X(4, 'b', 't', "boot",  main_cmd_boot,  "boot (init times)") \
+    X(4, 's', 'p', "step",  main_cmd_step,  "step [0 stop | 1 run]") \
+    X(4, 'd', 't', "dist",  main_cmd_dist,  "dist [1 reset]") \
+    X(4, 's', 't', "shot",  main_cmd_shot,  "shot (screen to USB)") \
+    X(3, 'b', 's', "bus",   main_cmd_bus,   "bus (clocks and planned rates in Hz)") \
+    X(5, 'l', 'h', "latch", main_cmd_latch, "latch [1 clear] (fan guard faults)") \
+    MAIN_SHELL_FW_COMMAND(X) \
+    MAIN_SHELL_PM_COMMAND(X) \
+    MAIN_SHELL_TS_COMMAND(X)
+
+#if FW_UPDATE_ENABLE
+#define MAIN_SHELL_FW_COMMAND(X) \
+    X(2, 'f', 'w', "fw",    main_cmd_fw,    "fw [0 abort | 1 update | 2 swap]")
+#else
+#define MAIN_SHELL_FW_COMMAND(X)
+#endif
+
+#if BKPTRACE_ENABLE
+#define MAIN_SHELL_PM_COMMAND(X) \
+    X(2, 'p', 'm', "pm",    main_cmd_pm,    "pm [n] (trace entry n before the last start)")
+#else
+#define MAIN_SHELL_PM_COMMAND(X)
+#endif
+
+#if TELEMETRY_SYNC_ENABLE
+#define MAIN_SHELL_TS_COMMAND(X) \
+    X(2, 't', 'm', "tm",    main_cmd_tm,    "tm [ping host_us hold_us] (time sync reply)")
+#else
+#define MAIN_SHELL_TS_COMMAND(X)
+#endif
+
+#if (0 MAIN_SHELL_COMMANDS(SHELL_SLOT_SUM)) != (0 MAIN_SHELL_COMMANDS(SHELL_SLOT_OR))
+#error "Two shell commands share a hash slot, rename one"
+#endif
+#endif
 
 /* Static Module Variables ------------------------------------------------- */
+/**
+ * @brief Q16 factor from ADC counts to fan RPM, from the maximum RPM of
+ *        the parameter store.
+ */
+static uint32_t g_u32_adc_to_rpm_q16;
+
+/**
+ * @brief MAIN_DISPLAY_RPM or MAIN_DISPLAY_OFF (no LCD traffic, the last
+ *        values stay on the screen).
+ */
+static volatile uint8_t g_u8_display_mode = MAIN_DISPLAY_RPM;
+
 /**
  * @brief Character buffer for LCD output.
  */
 static char g_ch_lcd_buffer[64];
 
+/**
+ * @brief Dead-band quantiser of POTI_1: ADC noise does not reach the
+ *        target RPM (controller, TAR: field).
+ */
+static potis_dma_quant_t g_poti_quant;
+
+/**
+ * @brief Publication count of the fan state the display showed last.
+ */
+static uint32_t g_u32_display_sequence;
+
+/**
+ * @brief RPM readouts, only changed digits are redrawn.
+ */
+static lcd_text_field_t g_field_target;
+static lcd_text_field_t g_field_current;
+
+#if MENU_ENABLE
+/**
+ * @brief Values edited in the menu: target RPM, gains scaled by 10^5
+ *        (MAIN_GAIN_DECIMALS). The menu task reloads them from the fan, so
+ *        poti and shell changes show up.
+ */
+static int32_t g_i32_menu_target;
+static int32_t g_i32_menu_kp;
+static int32_t g_i32_menu_ki;
+
+static void main_menu_set_target(int32_t i32_value, void *context);
+static void main_menu_set_gain(int32_t i32_value, void *context);
+static void main_menu_save(int32_t i32_value, void *context);
+
+/**
+ * @brief Menu pages: root with the target, a gains page and save.
+ */
+static const menu_item_t g_menu_gain_items[] = {
+    MENU_VALUE("Kp", &g_i32_menu_kp, 0, 1000000, 10, MAIN_GAIN_DECIMALS, main_menu_set_gain, NULL),
+    MENU_VALUE("Ki", &g_i32_menu_ki, 0, 1000000, 1, MAIN_GAIN_DECIMALS, main_menu_set_gain, NULL)
+};
+static const menu_page_t g_menu_gains = MENU_PAGE("Gains", g_menu_gain_items);
+
+static const menu_item_t g_menu_root_items[] = {
+    MENU_VALUE("Target", &g_i32_menu_target, 0, FAN_MAX_RPM, 50, 0u, main_menu_set_target, NULL),
+    MENU_LINK("Gains", &g_menu_gains),
+    MENU_ACTION("Save", main_menu_save, NULL)
+};
+static const menu_page_t g_menu_root = MENU_PAGE("Fan", g_menu_root_items);
+
+/**
+ * @brief Menu state.
+ */
+static menu_t g_menu;
+#endif
+
+#if UART_TELEMETRY_ENABLE
+/**
+ * @brief Samples of the next telemetry frame.
+ */
+static telemetry_batch_t g_telemetry_batch;
+#endif
+
+#if USB_CDC_ENABLE
+/**
+ * @brief Read position of the tacho stream (edges read, ring position in
+ *        capture mode).
+ */
+static uint32_t g_u32_usb_tacho_cursor;
+#endif
+
+#if DATALOG_ENABLE && USB_CDC_ENABLE
+/**
+ * @brief 1 while a capture is being dumped.
+ */
+static uint8_t g_u8_datalog_dumping;
+#endif
+
+#if SHELL_ENABLE && UART_TELEMETRY_ENABLE
+/**
+ * @brief Step-response script of the shell command step: up, down, large
+ *        step up, down to the low end, 4 s each (200 samples at 50 Hz).
+ */
+static const fan_step_point_t g_step_script[] = {
+    { 1000u, 4000u }, { 3000u, 4000u }, { 1500u, 4000u }, { 4000u, 4000u }, { 500u, 4000u }
+};
+
+/**
+ * @brief Step-response rig, polled by the shell task.
+ */
+static fan_step_rig_t g_step_rig;
+#endif
+
+#if DEADLINE_ENABLE && UART_TELEMETRY_ENABLE
+/**
+ * @brief Runs of the deadline task since the last statistics frame.
+ */
+static uint32_t g_u32_deadline_runs;
+#endif
+
+/* Static Function Prototypes ---------------------------------------------- */
+static pt_state_t main_boot_lcd(pt_t *pt, void *context);
+static pt_state_t main_boot_control(pt_t *pt, void *context);
+static void main_potis_published(databus_topic_t topic, const void *data, void *context);
+static void main_display_task(void *context);
+static void main_params_task(void *context);
+static void main_apply_adc_trims(void);
+#if MENU_ENABLE || (SHELL_ENABLE && UART_TELEMETRY_ENABLE)
+static void main_save_gains(void);
+#endif
+#if SHELL_ENABLE && UART_TELEMETRY_ENABLE
+static void main_shell_task(void *context);
+static void main_step_report(uint8_t u8_step, const fan_step_metrics_t *metrics, void *context);
+#define MAIN_SHELL_PROTOTYPE(len, first, last, name, handler, help) \
+    static void handler(uint8_t u8_argc, char *argv[], fmt_t *reply);
+static void main_reply_gain(fmt_t *reply, float f_gain);
+static void main_cmd_gain(uint8_t u8_integral, uint8_t u8_argc, char *argv[], fmt_t *reply);
+MAIN_SHELL_COMMANDS(MAIN_SHELL_PROTOTYPE)
+
+/**
+ * @brief Command table, one slot per SHELL_HASH() value.
+ */
+static const shell_command_t g_shell_commands[SHELL_TABLE_SIZE] = {
+    MAIN_SHELL_COMMANDS(SHELL_TABLE_ENTRY)
+};
+#endif
+#if HEALTH_ENABLE
+static void main_health_task(void *context);
+#endif
+#if MENU_ENABLE
+static void main_menu_sync(void);
+static void main_menu_task(void *context);
+#endif
+#if UART_TELEMETRY_ENABLE
+static void main_telemetry_task(void *context);
+#endif
+#if USB_CDC_ENABLE
+static void main_usb_adc_block(const potis_dma_sample_t *p_samples, uint32_t count);
+static void main_usb_tacho_task(void *context);
+#endif
+#if DATALOG_ENABLE && USB_CDC_ENABLE
+static HAL_StatusTypeDef main_datalog_sink(const void *data, uint16_t u16_length);
+static void main_datalog_task(void *context);
+#endif
+#if SDLOG_ENABLE
+static void main_sdlog_sample_task(void *context);
+static void main_sdlog_write_task(void *context);
+#endif
+#if DEADLINE_ENABLE
+static void main_deadline_init(void);
+static void main_deadline_task(void *context);
+#endif
+
 /* Public Functions -------------------------------------------------------- */
 /**
  * @brief Main program entry point.
  *
  * @details
  * Initializes all peripherals and runs the main control loop.
- * The potentiometer value is read via DMA, converted to a
- * target RPM and passed to the fan PI controller. Target and
- * current RPM values are displayed on the LCD.
+ * Potentiometer changes set the target RPM of the fan PI
+ * controller from the DMA interrupt, the controller itself runs
+ * from TIM6. The main loop runs the scheduler, whose only task
+ * displays target and current RPM ten times per second.
  *
  * @return int Program should never return.
  */
 int main(void)
 {
-    uint32_t u32_poti_value;
-
     /* Initialize HAL */
     HAL_Init();
 
-    /* Initialize modules */
-    lcd_init();
+    /* Interrupt priorities of the system plan: tacho before control before transfers */
+    irq_init();
+
+#if USB_CDC_ENABLE || SDLOG_ENABLE
+    /* USB core and SDIO need 48 MHz from the PLL, only the 168 MHz profile has it */
+    clock_init(CLOCK_PROFILE_168MHZ);
+#else
+    /* Run from HSE + PLL at 180 MHz before any bus-clock dependent init */
+    clock_init(CLOCK_PROFILE_180MHZ);
+#endif
+
+    /* Microsecond timebase of all stamps (tacho, log messages), from here on */
+    (void)timebase_init();
+
+#if BKPTRACE_ENABLE
+    /* Events up to the last reset stay in the backup SRAM until the ring wraps, see "pm" */
+    (void)bkptrace_init();
+#endif
+
+#if TRACE_ENABLE
+    /* Controller and poti values as SWO packets, see trace_decode.py */
+    trace_init(TRACE_SWO_BAUD);
+#endif
+
+#if UART_TELEMETRY_ENABLE
+    /* Batched fan and poti frames on the ST-LINK virtual COM port, see uart_telemetry_decode.py --batch */
+    uart_telemetry_init(UART_TELEMETRY_BAUD);
+    telemetry_batch_init(&g_telemetry_batch, MAIN_TELEMETRY_PERIOD_MS * 1000u);
+#endif
+#if TELEMETRY_SYNC_ENABLE && SHELL_ENABLE && UART_TELEMETRY_ENABLE
+    telemetry_sync_init();
+#endif
+
+    /* Initialize modules: LCD and control path overlapped, see main_boot_lcd() */
+    boot_begin();
+    boot_add("lcd", main_boot_lcd, NULL);
+    boot_add("control", main_boot_control, NULL);
+    boot_run();
+
+    /* Main loop: display task, sleeps in between without SysTick */
+    idle_init();
+    sched_init();
+    sched_add(main_display_task, NULL, MAIN_DISPLAY_PERIOD_MS, MAIN_DISPLAY_PRIORITY, NULL);
+    sched_add(main_params_task, NULL, MAIN_PARAMS_PERIOD_MS, MAIN_DISPLAY_PRIORITY, NULL);
+#if HEALTH_ENABLE
+    /* CPU load, interrupt shares and stack headroom once per second */
+    health_init();
+    sched_add(main_health_task, NULL, MAIN_HEALTH_PERIOD_MS, MAIN_DISPLAY_PRIORITY, NULL);
+#endif
+#if UART_TELEMETRY_ENABLE
+    sched_add(main_telemetry_task, NULL, MAIN_TELEMETRY_PERIOD_MS, MAIN_DISPLAY_PRIORITY, NULL);
+#endif
+#if MENU_ENABLE
+    /* Joystick events from the debounce interrupt, only dirty menu rows are drawn */
+    if ((joystick_init_events() == HAL_OK) &&
+        (menu_init(&g_menu, &g_menu_root, 10u, MAIN_MENU_Y, MAIN_MENU_ROWS, MAIN_MENU_SIZE, BLACK, WHITE) == HAL_OK)) {
+        main_menu_sync();
+        sched_add(main_menu_task, NULL, MAIN_MENU_PERIOD_MS, MAIN_DISPLAY_PRIORITY, NULL);
+    }
+#endif
+#if SHELL_ENABLE && UART_TELEMETRY_ENABLE
+    /* Commands from the UART RX ring, replies as text frames (uart_telemetry_decode.py --batch) */
+    shell_init(g_shell_commands, uart_telemetry_read, telemetry_batch_send_text);
+    sched_add(main_shell_task, NULL, MAIN_SHELL_PERIOD_MS, MAIN_DISPLAY_PRIORITY, NULL);
+#endif
+#if USB_CDC_ENABLE
+    sched_add(main_usb_tacho_task, NULL, MAIN_USB_TACHO_PERIOD_MS, MAIN_DISPLAY_PRIORITY, NULL);
+#endif
+#if DATALOG_ENABLE && USB_CDC_ENABLE
+    sched_add(main_datalog_task, NULL, MAIN_DATALOG_PERIOD_MS, MAIN_DISPLAY_PRIORITY, NULL);
+#endif
+#if SDLOG_ENABLE
+    /* RPM and control error once per second into SDLOG.BIN, see sdlog_tool.py */
+    if (sdlog_init() == HAL_OK) {
+        sched_add(main_sdlog_sample_task, NULL, MAIN_SDLOG_SAMPLE_PERIOD_MS, MAIN_DISPLAY_PRIORITY, NULL);
+        sched_add(main_sdlog_write_task, NULL, MAIN_SDLOG_WRITE_PERIOD_MS, MAIN_DISPLAY_PRIORITY, NULL);
+    }
+#endif
+#if DEADLINE_ENABLE
+    /* Control step on time under display and logging load, else no watchdog refresh */
+    main_deadline_init();
+#endif
+#if DVFS_ENABLE
+    /* Half clock between the display bursts, after all timers are set up */
+    (void)dvfs_init();
+#endif
+    sched_run();
+}
+
+/* Static Functions -------------------------------------------------------- */
+/**
+ * @brief Boot step LCD: panel init (returns at the reset and sleep out
+ *        waits), then labels and RPM fields.
+ *
+ * @param pt      Thread state
+ * @param context Unused
+ * @return PT_ENDED when the display is ready
+ */
+static pt_state_t main_boot_lcd(pt_t *pt, void *context)
+{
+    static pt_t s_lcd_pt;
+
+    (void)context;
+
+    PT_BEGIN(pt);
+
+    PT_SPAWN(pt, &s_lcd_pt, lcd_init_thread(&s_lcd_pt));
+
+    lcd_draw_text_at_line("TAR: ", MAIN_LINE_TARGET, BLACK, MAIN_TEXT_SIZE, WHITE);
+    lcd_draw_text_at_line("CUR: ", MAIN_LINE_CURRENT, BLACK, MAIN_TEXT_SIZE, WHITE);
+    lcd_text_field_init(&g_field_target, MAIN_VALUE_X, MAIN_LINE_Y(MAIN_LINE_TARGET), NULL,
+                        MAIN_TEXT_SIZE, BLACK, WHITE);
+    lcd_text_field_init(&g_field_current, MAIN_VALUE_X, MAIN_LINE_Y(MAIN_LINE_CURRENT), NULL,
+                        MAIN_TEXT_SIZE, BLACK, WHITE);
+
+    PT_END(pt);
+}
+
+/**
+ * @brief Boot step control path: parameters, fan, potis and capture, then
+ *        the PI controller; ends at its first step (boot_mark_control()).
+ *        Runs during the panel waits, the fan spins up meanwhile.
+ *
+ * @param pt      Thread state
+ * @param context Unused
+ * @return PT_ENDED after the first control step
+ */
+static pt_state_t main_boot_control(pt_t *pt, void *context)
+{
+    fan_control_stats_t stats;
+
+    (void)context;
+
+    PT_BEGIN(pt);
+
+    /* Tuned gains, maximum RPM and ADC trims from flash, defaults otherwise */
+    params_init();
+    main_apply_adc_trims();
+    g_u32_adc_to_rpm_q16 = ADC_CAL_Q16_RATIO(params_get_u32(PARAMS_KEY_FAN_MAX_RPM, FAN_MAX_RPM),
+                                             ADC_12_BIT_RESOLUTION);
     fan_control_init();
-    potis_dma_init();
+    /* Overspeed trips full duty in the tacho interrupt, latched until "latch 1" */
+    (void)fan_guard_overspeed(fan_get_default(), params_get_u32(PARAMS_KEY_FAN_MAX_RPM, FAN_MAX_RPM) *
+                                                 MAIN_GUARD_OVERSPEED_PERCENT / 100u);
+    potis_dma_init_mode(POTIS_DMA_MODE_TIMER, POTIS_DMA_DEFAULT_SAMPLE_RATE_HZ);
+    potis_dma_quant_init(&g_poti_quant, POTIS_DMA_QUANT_DEFAULT_STEP, POTIS_DMA_QUANT_DEFAULT_HYSTERESIS);
+    databus_subscribe(DATABUS_TOPIC_POTIS, main_potis_published, NULL);
+#if USB_CDC_ENABLE
+    /* Raw ADC halves and tacho edges on the USB virtual COM port, see usb_cdc_decode.py */
+    usb_cdc_init();
+    potis_dma_set_block_callback(main_usb_adc_block);
+#endif
+#if DATALOG_ENABLE
+    /* Capture around the first large control error, frozen for the debugger without USB */
+    if ((sdram_init() == HAL_OK) &&
+        (datalog_init((void *)(SDRAM_BANK_ADDR + DATALOG_SDRAM_OFFSET), DATALOG_SDRAM_SIZE) == HAL_OK)) {
+        datalog_set_trigger(DATALOG_CH_FAN_ERROR, DATALOG_TRIGGER_MAGNITUDE, MAIN_DATALOG_ERROR_RPM);
+        datalog_arm(MAIN_DATALOG_PRE_RECORDS, MAIN_DATALOG_POST_RECORDS);
+    }
+#endif
     potis_dma_start();
 
-    /* Main application loop */
-    while (1)
-    {
-        /* Read potentiometer value */
-        u32_poti_value = potis_dma_get_val(POTI_1);
-
-        /* Set fan target RPM */
-        fan_change_target_rpm(
-            MAIN_CONVERT_ADC_TO_RPM(
-                u32_poti_value,
-                FAN_MAX_RPM,
-                ADC_12_BIT_RESOLUTION
-            )
-        );
-
-        /* Update PI controller */
-        fan_update_pi_controller();
-
-        /* Display target RPM */
-        sprintf(g_ch_lcd_buffer,
-                "TAR: %-4lu",
-                fan_get_target_rpm());
-        lcd_draw_text_at_line(g_ch_lcd_buffer, 4, BLACK, 3, WHITE);
-
-        /* Display current RPM */
-        sprintf(g_ch_lcd_buffer,
-                "CUR: %-4lu",
-                fan_get_filtered_rpm());
-        lcd_draw_text_at_line(g_ch_lcd_buffer, 6, BLACK, 3, WHITE);
+    /* PI controller runs from TIM6 at a fixed rate */
+    fan_control_start(FAN_CONTROL_DEFAULT_RATE_HZ);
+
+    /* A copy blocked by two steps (HAL_BUSY) also proves a step ran */
+    PT_WAIT_UNTIL(pt, (fan_get_control_stats(&stats) != HAL_OK) || (stats.u32_runs != 0u));
+    boot_mark_control();
+
+    PT_END(pt);
+}
+
+/**
+ * @brief New poti averages on the data bus (DMA interrupt context): a new
+ *        level of the POTI_1 quantiser sets the target RPM.
+ *
+ * @param topic   DATABUS_TOPIC_POTIS
+ * @param data    databus_potis_t
+ * @param context Unused
+ */
+static void main_potis_published(databus_topic_t topic, const void *data, void *context)
+{
+    uint32_t u32_value;
+
+    (void)topic;
+    (void)context;
+
+    if (potis_dma_quant_update(&g_poti_quant, ((const databus_potis_t *)data)->u32_poti_1, &u32_value)) {
+        fan_change_target_rpm(MAIN_CONVERT_ADC_TO_RPM(u32_value));
     }
 }
+
+/**
+ * @brief Display task: target and current RPM.
+ *
+ * @param context Unused
+ */
+static void main_display_task(void *context)
+{
+    databus_fan_t fan;
+    fmt_t fmt;
+
+    (void)context;
+
+    /* Nothing to format without a new control step */
+    if ((g_u8_display_mode == MAIN_DISPLAY_OFF) ||
+        !databus_read_new(DATABUS_TOPIC_FAN, &g_u32_display_sequence, &fan)) {
+        return;
+    }
+
+    /* Rendering at the full clock */
+    dvfs_boost();
+
+    /* Display target RPM (left aligned, the field clears shorter values) */
+    fmt_init(&fmt, g_ch_lcd_buffer, sizeof(g_ch_lcd_buffer));
+    fmt_u32(&fmt, fan.u32_target_rpm, 0u, ' ');
+    lcd_text_field_update(&g_field_target, g_ch_lcd_buffer);
+
+    /* Display current RPM */
+    fmt_init(&fmt, g_ch_lcd_buffer, sizeof(g_ch_lcd_buffer));
+    fmt_u32(&fmt, fan.u32_rpm, 0u, ' ');
+    lcd_text_field_update(&g_field_current, g_ch_lcd_buffer);
+
+    dvfs_release();
+}
+
+/**
+ * @brief Parameter store task: writes set values to flash, never waits
+ *        for an erase.
+ *
+ * @param context Unused
+ */
+static void main_params_task(void *context)
+{
+    (void)context;
+
+    params_task();
+}
+
+/**
+ * @brief Applies the stored two-point trims of the ADC channels.
+ */
+static void main_apply_adc_trims(void)
+{
+    for (uint8_t u8_channel = 0u; u8_channel < ADC_CAL_MAX_CHANNELS; u8_channel++) {
+        params_key_t key_low  = (params_key_t)(PARAMS_KEY_ADC_CAL_LOW_0 + u8_channel);
+        params_key_t key_high = (params_key_t)(PARAMS_KEY_ADC_CAL_HIGH_0 + u8_channel);
+
+        if (params_has(key_low) && params_has(key_high)) {
+            adc_cal_set_two_point(u8_channel, params_get_u32(key_low, 0u), params_get_u32(key_high, 0u));
+        }
+    }
+}
+
+#if MENU_ENABLE || (SHELL_ENABLE && UART_TELEMETRY_ENABLE)
+/**
+ * @brief Stores the current gains of the default fan in the parameter
+ *        store (shell save, menu).
+ */
+static void main_save_gains(void)
+{
+    float f_kp;
+    float f_ki;
+
+    fan_get_gains(fan_get_default(), &f_kp, &f_ki);
+    params_set_float(PARAMS_KEY_FAN_KP, f_kp);
+    params_set_float(PARAMS_KEY_FAN_KI, f_ki);
+}
+#endif
+
+#if MENU_ENABLE
+/**
+ * @brief Reloads the menu values from the fan (poti, shell).
+ */
+static void main_menu_sync(void)
+{
+    float f_kp;
+    float f_ki;
+
+    fan_get_gains(fan_get_default(), &f_kp, &f_ki);
+    g_i32_menu_target = (int32_t)fan_get_target_rpm();
+    g_i32_menu_kp     = (int32_t)(f_kp * 100000.0f + 0.5f);
+    g_i32_menu_ki     = (int32_t)(f_ki * 100000.0f + 0.5f);
+}
+
+/**
+ * @brief Menu value Target: new target RPM (until the poti moves).
+ */
+static void main_menu_set_target(int32_t i32_value, void *context)
+{
+    (void)context;
+
+    fan_change_target_rpm((uint32_t)i32_value);
+}
+
+/**
+ * @brief Menu values Kp / Ki: both gains from the menu values (RAM, see
+ *        Save).
+ */
+static void main_menu_set_gain(int32_t i32_value, void *context)
+{
+    (void)i32_value;
+    (void)context;
+
+    fan_set_gains(fan_get_default(), (float)g_i32_menu_kp / 100000.0f, (float)g_i32_menu_ki / 100000.0f);
+}
+
+/**
+ * @brief Menu action Save: gains into the parameter store.
+ */
+static void main_menu_save(int32_t i32_value, void *context)
+{
+    (void)i32_value;
+    (void)context;
+
+    main_save_gains();
+}
+
+/**
+ * @brief Menu task: joystick events, values changed elsewhere, at most
+ *        MAIN_MENU_ROWS_PER_RUN rows drawn per run.
+ *
+ * @param context Unused
+ */
+static void main_menu_task(void *context)
+{
+    joystick_event_t event;
+
+    (void)context;
+
+    if (g_u8_display_mode == MAIN_DISPLAY_OFF) {
+        return;
+    }
+
+    while (joystick_get_event(&event)) {
+        (void)menu_handle_event(&g_menu, &event);
+    }
+    if (!g_menu.u8_editing) {
+        main_menu_sync();
+        menu_refresh(&g_menu);
+    }
+    (void)menu_render(&g_menu, MAIN_MENU_ROWS_PER_RUN);
+}
+#endif
+
+#if HEALTH_ENABLE
+/**
+ * @brief Health task: closes the measurement window and shows load and
+ *        stack use (values also go to the trace channels).
+ *
+ * @param context Unused
+ */
+static void main_health_task(void *context)
+{
+    (void)context;
+
+    health_update();
+    health_lcd_line(9, DARKGREY, 2, WHITE);
+}
+#endif
+
+#if UART_TELEMETRY_ENABLE
+/**
+ * @brief Telemetry task: filtered RPM and averaged poti values into the
+ *        batch, a full batch is sent as one frame.
+ *
+ * @param context Unused
+ */
+static void main_telemetry_task(void *context)
+{
+    databus_potis_t potis;
+    databus_fan_t fan;
+
+    (void)context;
+
+    /* Values of the last half buffer and controller step */
+    if ((databus_read(DATABUS_TOPIC_POTIS, &potis) != HAL_OK) ||
+        (databus_read(DATABUS_TOPIC_FAN, &fan) != HAL_OK)) {
+        return;
+    }
+    telemetry_batch_add_sample(&g_telemetry_batch, (uint16_t)fan.u32_rpm,
+                               (uint16_t)potis.u32_poti_1, (uint16_t)potis.u32_poti_2);
+
+    if (telemetry_batch_is_full(&g_telemetry_batch)) {
+        telemetry_batch_set_target(&g_telemetry_batch, (uint16_t)fan.u32_target_rpm);
+        telemetry_batch_send(&g_telemetry_batch);
+    }
+#if TELEMETRY_SYNC_ENABLE && SHELL_ENABLE
+    /* Host clock pings between the batches, the replies arrive as shell commands */
+    telemetry_sync_poll();
+#endif
+#if DLOG_ENABLE
+    /* Messages of the ISRs as dlog frames, see dlog_decode.py */
+    (void)dlog_drain(telemetry_batch_send_dlog, TELEMETRY_BATCH_TEXT_MAX);
+#endif
+}
+#endif
+
+#if USB_CDC_ENABLE
+/**
+ * @brief Raw ADC half buffer (DMA interrupt context): copied into the
+ *        USB transmit buffer as it is.
+ *
+ * @param p_samples Interleaved POTI_1 / POTI_2 samples
+ * @param count     Number of samples
+ */
+static void main_usb_adc_block(const potis_dma_sample_t *p_samples, uint32_t count)
+{
+    usb_cdc_send_block((sizeof(potis_dma_sample_t) == 2u) ? USB_CDC_BLOCK_ADC_U16 : USB_CDC_BLOCK_ADC_U32,
+                       p_samples, (uint16_t)(count * sizeof(potis_dma_sample_t)));
+}
+
+/**
+ * @brief Tacho stream task: the edges since the last run as one block.
+ *
+ * @param context Unused
+ */
+static void main_usb_tacho_task(void *context)
+{
+    uint32_t u32_edges[MAIN_USB_TACHO_EDGES];
+    uint32_t u32_count;
+
+    (void)context;
+
+    u32_count = fan_read_edges(fan_get_default(), &g_u32_usb_tacho_cursor, u32_edges, MAIN_USB_TACHO_EDGES);
+    if (u32_count != 0u) {
+        usb_cdc_send_block(USB_CDC_BLOCK_TACHO, u32_edges, (uint16_t)(u32_count * sizeof(uint32_t)));
+    }
+}
+#endif
+
+#if DATALOG_ENABLE && USB_CDC_ENABLE
+/**
+ * @brief Dump sink: every chunk as one USB block, see datalog_decode.py.
+ *
+ * @param data       Bytes
+ * @param u16_length Length
+ * @return HAL_OK, HAL_BUSY while the port is full or closed (retried)
+ */
+static HAL_StatusTypeDef main_datalog_sink(const void *data, uint16_t u16_length)
+{
+    return (usb_cdc_send_block(USB_CDC_BLOCK_DATALOG, data, u16_length) == HAL_OK) ? HAL_OK : HAL_BUSY;
+}
+
+/**
+ * @brief Dump task: sends a complete capture a few chunks per run and
+ *        arms the next one afterwards.
+ *
+ * @param context Unused
+ */
+static void main_datalog_task(void *context)
+{
+    (void)context;
+
+    if ((datalog_get_state() != DATALOG_STATE_DONE) || !usb_cdc_is_open()) {
+        return;
+    }
+    if (!g_u8_datalog_dumping) {
+        datalog_dump_start();
+        g_u8_datalog_dumping = 1u;
+    }
+    if (datalog_dump_step(main_datalog_sink, MAIN_DATALOG_CHUNKS) == 0u) {
+        g_u8_datalog_dumping = 0u;
+        datalog_arm(MAIN_DATALOG_PRE_RECORDS, MAIN_DATALOG_POST_RECORDS);
+    }
+}
+#endif
+
+#if SDLOG_ENABLE
+/**
+ * @brief SD log sample task: filtered RPM and control error of the last
+ *        controller step, channel numbers of datalog.h.
+ *
+ * @param context Unused
+ */
+static void main_sdlog_sample_task(void *context)
+{
+    databus_fan_t fan;
+
+    (void)context;
+
+    if (databus_read(DATABUS_TOPIC_FAN, &fan) != HAL_OK) {
+        return;
+    }
+    sdlog_add(DATALOG_CH_FAN_RPM, (int32_t)fan.u32_rpm);
+    sdlog_add(DATALOG_CH_FAN_ERROR, (int32_t)fan.u32_target_rpm - (int32_t)fan.u32_rpm);
+}
+
+/**
+ * @brief SD log write task: starts the DMA write of a full sector, never
+ *        waits for the card.
+ *
+ * @param context Unused
+ */
+static void main_sdlog_write_task(void *context)
+{
+    (void)context;
+
+    sdlog_task();
+}
+#endif
+
+#if DEADLINE_ENABLE
+/**
+ * @brief Supervises the control step (ends within its period, half of it
+ *        as budget) and starts the watchdog.
+ */
+static void main_deadline_init(void)
+{
+    uint32_t u32_control_us = 1000000u / FAN_CONTROL_DEFAULT_RATE_HZ;
+    uint8_t u8_id;
+
+    deadline_init();
+    if (deadline_add(u32_control_us, u32_control_us, u32_control_us / 2u, &u8_id) == HAL_OK) {
+        fan_control_set_deadline(u8_id);
+    }
+    sched_add(main_deadline_task, NULL, MAIN_DEADLINE_PERIOD_MS, SCHED_PRIORITY_HIGHEST, NULL);
+    (void)deadline_watchdog_start();
+}
+
+/**
+ * @brief Deadline task: closes the supervision window (watchdog refresh)
+ *        and sends the miss statistics once per MAIN_DEADLINE_REPORT_MS.
+ *
+ * @param context Unused
+ */
+static void main_deadline_task(void *context)
+{
+    (void)context;
+
+    (void)deadline_poll();
+#if UART_TELEMETRY_ENABLE
+    if (++g_u32_deadline_runs >= MAIN_DEADLINE_REPORT_MS / MAIN_DEADLINE_PERIOD_MS) {
+        g_u32_deadline_runs = 0u;
+        (void)telemetry_batch_send_deadline();
+    }
+#endif
+}
+#endif
+
+#if SHELL_ENABLE && UART_TELEMETRY_ENABLE
+/**
+ * @brief Shell task: at most one command per run, after the display at
+ *        the lowest priority.
+ *
+ * @param context Unused
+ */
+static void main_shell_task(void *context)
+{
+    (void)context;
+
+#if FW_UPDATE_ENABLE
+    /* During an update the UART carries the image, not commands */
+    if (!fw_update_poll(uart_telemetry_read, telemetry_batch_send_text)) {
+        shell_poll();
+    }
+#else
+    shell_poll();
+#endif
+    screenshot_poll();
+    (void)fan_step_rig_poll(&g_step_rig);
+}
+
+/**
+ * @brief Sends the metrics of one step as a text line over the telemetry
+ *        UART.
+ *
+ * @param u8_step Step index in the script
+ * @param metrics Result
+ * @param context Unused
+ */
+static void main_step_report(uint8_t u8_step, const fan_step_metrics_t *metrics, void *context)
+{
+    char ch_line[128];
+    fmt_t line;
+
+    (void)context;
+
+    fmt_init(&line, ch_line, sizeof(ch_line));
+    fmt_str(&line, "step ");
+    fmt_u32(&line, u8_step, 0u, ' ');
+    fmt_str(&line, " from ");
+    fmt_u32(&line, metrics->u32_from_rpm, 0u, ' ');
+    fmt_str(&line, " to ");
+    fmt_u32(&line, metrics->u32_to_rpm, 0u, ' ');
+    fmt_str(&line, " rise_ms ");
+    fmt_u32(&line, metrics->u32_rise_ms, 0u, ' ');
+    fmt_str(&line, " over_pm ");
+    fmt_u32(&line, metrics->u32_overshoot_permille, 0u, ' ');
+    fmt_str(&line, " settle_ms ");
+    fmt_u32(&line, metrics->u32_settle_ms, 0u, ' ');
+    fmt_str(&line, metrics->u8_settled ? " iae " : " unsettled iae ");
+    fmt_u32(&line, metrics->u32_iae, 0u, ' ');
+
+    (void)telemetry_batch_send_text(fmt_get(&line), line.u16_length);
+}
+
+/**
+ * @brief Appends a gain as fixed-point text.
+ *
+ * @param reply Reply text
+ * @param f_gain Gain
+ */
+static void main_reply_gain(fmt_t *reply, float f_gain)
+{
+    float f_scaled = f_gain * 100000.0f;
+
+    fmt_fixed(reply, (int32_t)((f_scaled < 0.0f) ? (f_scaled - 0.5f) : (f_scaled + 0.5f)), MAIN_GAIN_DECIMALS, 0u);
+}
+
+/**
+ * @brief help: lists the commands.
+ */
+static void main_cmd_help(uint8_t u8_argc, char *argv[], fmt_t *reply)
+{
+    (void)u8_argc;
+    (void)argv;
+
+    shell_list(reply);
+}
+
+/**
+ * @brief kp / ki: shows or sets one gain of the default fan (RAM, see
+ *        save).
+ *
+ * @param u8_integral 0 Kp, 1 Ki
+ */
+static void main_cmd_gain(uint8_t u8_integral, uint8_t u8_argc, char *argv[], fmt_t *reply)
+{
+    float f_kp;
+    float f_ki;
+    int32_t i32_value;
+
+    fan_get_gains(fan_get_default(), &f_kp, &f_ki);
+
+    if (u8_argc > 1u) {
+        if ((shell_parse_fixed(argv[1], MAIN_GAIN_DECIMALS, &i32_value) != HAL_OK) || (i32_value < 0)) {
+            shell_usage(argv[0], reply);
+            return;
+        }
+        if (u8_integral) {
+            f_ki = (float)i32_value / 100000.0f;
+        } else {
+            f_kp = (float)i32_value / 100000.0f;
+        }
+        fan_set_gains(fan_get_default(), f_kp, f_ki);
+    }
+
+    fmt_str(reply, "kp ");
+    main_reply_gain(reply, f_kp);
+    fmt_str(reply, " ki ");
+    main_reply_gain(reply, f_ki);
+}
+
+static void main_cmd_kp(uint8_t u8_argc, char *argv[], fmt_t *reply)
+{
+    main_cmd_gain(0u, u8_argc, argv, reply);
+}
+
+static void main_cmd_ki(uint8_t u8_argc, char *argv[], fmt_t *reply)
+{
+    main_cmd_gain(1u, u8_argc, argv, reply);
+}
+
+/**
+ * @brief rpm: shows target and measured RPM or sets the target (until
+ *        the poti moves again).
+ */
+static void main_cmd_rpm(uint8_t u8_argc, char *argv[], fmt_t *reply)
+{
+    uint32_t u32_target;
+
+    if (u8_argc > 1u) {
+        if ((shell_parse_u32(argv[1], &u32_target) != HAL_OK) ||
+            (u32_target > params_get_u32(PARAMS_KEY_FAN_MAX_RPM, FAN_MAX_RPM))) {
+            shell_usage(argv[0], reply);
+            return;
+        }
+        fan_change_target_rpm(u32_target);
+    }
+
+    fmt_str(reply, "target ");
+    fmt_u32(reply, fan_get_target_rpm(), 0u, ' ');
+    fmt_str(reply, " rpm ");
+    fmt_u32(reply, fan_get_last_rpm(), 0u, ' ');
+}
+
+/**
+ * @brief osr: shows or stores the BME280 oversampling (register codes)
+ *        and filter, used by env_sensor at its next start.
+ */
+static void main_cmd_osr(uint8_t u8_argc, char *argv[], fmt_t *reply)
+{
+    static const params_key_t keys[4] = {
+        PARAMS_KEY_ENV_OSR_T, PARAMS_KEY_ENV_OSR_P, PARAMS_KEY_ENV_OSR_H, PARAMS_KEY_ENV_FILTER
+    };
+    static const uint32_t defaults[4] = { 2u, 5u, 1u, 4u };     /* 2x, 16x, 1x, filter 16 */
+    uint32_t u32_value[4];
+
+    if (u8_argc > 1u) {
+        if (u8_argc != 5u) {
+            shell_usage(argv[0], reply);
+            return;
+        }
+        for (uint8_t i = 0u; i < 4u; i++) {
+            if ((shell_parse_u32(argv[i + 1u], &u32_value[i]) != HAL_OK) || (u32_value[i] > 5u)) {
+                shell_usage(argv[0], reply);
+                return;
+            }
+        }
+        for (uint8_t i = 0u; i < 4u; i++) {
+            params_set_u32(keys[i], u32_value[i]);
+        }
+    }
+
+    fmt_str(reply, "osr t p h filter");
+    for (uint8_t i = 0u; i < 4u; i++) {
+        fmt_char(reply, ' ');
+        fmt_u32(reply, params_get_u32(keys[i], defaults[i]), 0u, ' ');
+    }
+}
+
+/**
+ * @brief disp: shows or sets the display mode.
+ */
+static void main_cmd_disp(uint8_t u8_argc, char *argv[], fmt_t *reply)
+{
+    uint32_t u32_mode;
+
+    if (u8_argc > 1u) {
+        if ((shell_parse_u32(argv[1], &u32_mode) != HAL_OK) || (u32_mode > MAIN_DISPLAY_OFF)) {
+            shell_usage(argv[0], reply);
+            return;
+        }
+        g_u8_display_mode = (uint8_t)u32_mode;
+    }
+
+    fmt_str(reply, "disp ");
+    fmt_u32(reply, g_u8_display_mode, 0u, ' ');
+}
+
+/**
+ * @brief prof: counters of one profiling zone (default the PI step) in
+ *        core cycles.
+ */
+static void main_cmd_prof(uint8_t u8_argc, char *argv[], fmt_t *reply)
+{
+    uint32_t u32_zone = PROFILE_ZONE_FAN_PI;
+    const profile_stats_t *stats;
+
+    if ((u8_argc > 1u) &&
+        ((shell_parse_u32(argv[1], &u32_zone) != HAL_OK) || (u32_zone >= PROFILE_ZONE_COUNT))) {
+        shell_usage(argv[0], reply);
+        return;
+    }
+
+    stats = profile_get((profile_zone_t)u32_zone);
+    fmt_str(reply, profile_get_name((profile_zone_t)u32_zone));
+    fmt_str(reply, " calls ");
+    fmt_u32(reply, stats->u32_calls, 0u, ' ');
+    if (stats->u32_calls != 0u) {
+        fmt_str(reply, " min ");
+        fmt_u32(reply, stats->u32_min, 0u, ' ');
+        fmt_str(reply, " mean ");
+        fmt_u32(reply, (uint32_t)(stats->u64_total / stats->u32_calls), 0u, ' ');
+        fmt_str(reply, " max ");
+        fmt_u32(reply, stats->u32_max, 0u, ' ');
+    }
+}
+
+/**
+ * @brief sched: statistics of one scheduler task in us.
+ */
+static void main_cmd_sched(uint8_t u8_argc, char *argv[], fmt_t *reply)
+{
+    uint32_t u32_id = 0u;
+    sched_stats_t stats;
+
+    if (((u8_argc > 1u) && (shell_parse_u32(argv[1], &u32_id) != HAL_OK)) ||
+        (u32_id > 0xFFu) || (sched_get_stats((uint8_t)u32_id, &stats) != HAL_OK)) {
+        shell_usage(argv[0], reply);
+        return;
+    }
+
+    fmt_str(reply, "task ");
+    fmt_u32(reply, u32_id, 0u, ' ');
+    fmt_str(reply, " runs ");
+    fmt_u32(reply, stats.u32_runs, 0u, ' ');
+    fmt_str(reply, " last ");
+    fmt_u32(reply, stats.u32_last_us, 0u, ' ');
+    fmt_str(reply, " wcet ");
+    fmt_u32(reply, stats.u32_wcet_us, 0u, ' ');
+    fmt_str(reply, " jitter ");
+    fmt_u32(reply, stats.u32_jitter_us, 0u, ' ');
+    fmt_str(reply, " overruns ");
+    fmt_u32(reply, stats.u32_overruns, 0u, ' ');
+}
+
+/**
+ * @brief stats: counters of the telemetry UART.
+ */
+static void main_cmd_stats(uint8_t u8_argc, char *argv[], fmt_t *reply)
+{
+    uart_telemetry_stats_t stats;
+
+    (void)u8_argc;
+    (void)argv;
+
+    uart_telemetry_get_stats(&stats);
+    fmt_str(reply, "frames ");
+    fmt_u32(reply, stats.u32_frames, 0u, ' ');
+    fmt_str(reply, " dropped ");
+    fmt_u32(reply, stats.u32_dropped, 0u, ' ');
+    fmt_str(reply, " rx ");
+    fmt_u32(reply, stats.u32_rx_bytes, 0u, ' ');
+    fmt_str(reply, " overruns ");
+    fmt_u32(reply, stats.u32_rx_overruns, 0u, ' ');
+    fmt_str(reply, " errors ");
+    fmt_u32(reply, stats.u32_errors, 0u, ' ');
+}
+
+/**
+ * @brief boot: time from reset to main(), then from boot_begin() to the
+ *        end of every init step, of the boot and to the first control
+ *        step in us.
+ */
+static void main_cmd_boot(uint8_t u8_argc, char *argv[], fmt_t *reply)
+{
+    const boot_stats_t *stats = boot_get_stats();
+
+    (void)u8_argc;
+    (void)argv;
+
+    fmt_str(reply, "main ");
+    fmt_u32(reply, boot_get_phase_us(BOOT_PHASE_MAIN), 0u, ' ');
+    fmt_str(reply, " ");
+    for (uint8_t i = 0u; i < stats->u8_steps; i++) {
+        const boot_step_stats_t *step = boot_get_step(i);
+
+        fmt_str(reply, step->p_name);
+        fmt_str(reply, " ");
+        fmt_u32(reply, step->u32_done_us, 0u, ' ');
+        fmt_str(reply, " ");
+    }
+    fmt_str(reply, "init ");
+    fmt_u32(reply, stats->u32_init_us, 0u, ' ');
+    fmt_str(reply, " control ");
+    fmt_u32(reply, stats->u32_control_us, 0u, ' ');
+}
+
+/**
+ * @brief bus: core and bus clocks, rates of the planned peripherals.
+ */
+static void main_cmd_bus(uint8_t u8_argc, char *argv[], fmt_t *reply)
+{
+    (void)u8_argc;
+    (void)argv;
+
+    fmt_str(reply, "hclk ");
+    fmt_u32(reply, HAL_RCC_GetHCLKFreq(), 0u, ' ');
+    fmt_str(reply, " pclk1 ");
+    fmt_u32(reply, HAL_RCC_GetPCLK1Freq(), 0u, ' ');
+    fmt_str(reply, " pclk2 ");
+    fmt_u32(reply, HAL_RCC_GetPCLK2Freq(), 0u, ' ');
+    fmt_str(reply, " lcd_spi ");
+    fmt_u32(reply, clock_get_rate(CLOCK_RATE_LCD_SPI), 0u, ' ');
+    fmt_str(reply, " adc ");
+    fmt_u32(reply, clock_get_rate(CLOCK_RATE_ADC), 0u, ' ');
+    fmt_str(reply, " i2c ");
+    fmt_u32(reply, clock_get_rate(CLOCK_RATE_I2C), 0u, ' ');
+}
+
+/**
+ * @brief latch: faults of the fan guard since the last clear and the
+ *        age of the first trip; 1 clears them.
+ */
+static void main_cmd_latch(uint8_t u8_argc, char *argv[], fmt_t *reply)
+{
+    fan_t *fan = fan_get_default();
+    uint32_t u32_clear = 0u;
+    uint32_t u32_stamp;
+    uint8_t u8_fault;
+
+    if ((u8_argc > 1u) && ((shell_parse_u32(argv[1], &u32_clear) != HAL_OK) || (u32_clear != 1u))) {
+        shell_usage(argv[0], reply);
+        return;
+    }
+    if (u32_clear) {
+        fan_guard_clear(fan);
+        fmt_str(reply, "cleared");
+        return;
+    }
+
+    u8_fault = fan_guard_get_fault(fan, &u32_stamp);
+    if (u8_fault == 0u) {
+        fmt_str(reply, "none");
+        return;
+    }
+    fmt_str(reply, (u8_fault & FAN_GUARD_ADC) ? "adc " : "");
+    fmt_str(reply, (u8_fault & FAN_GUARD_OVERSPEED) ? "overspeed " : "");
+    fmt_str(reply, (u8_fault & FAN_GUARD_EXTERNAL) ? "external " : "");
+    fmt_str(reply, "since_ms ");
+    fmt_u32(reply, (timebase_now32() - u32_stamp) / 1000u, 0u, ' ');
+    fmt_str(reply, " trips ");
+    fmt_u32(reply, fan->guard.u32_trips, 0u, ' ');
+}
+
+/**
+ * @brief save: stores the current gains in the parameter store.
+ */
+static void main_cmd_save(uint8_t u8_argc, char *argv[], fmt_t *reply)
+{
+    (void)u8_argc;
+    (void)argv;
+
+    main_save_gains();
+
+    fmt_str(reply, "saved");
+}
+
+/**
+ * @brief step: starts or stops the step-response script on the default
+ *        fan, one result line per step follows.
+ */
+static void main_cmd_step(uint8_t u8_argc, char *argv[], fmt_t *reply)
+{
+    uint32_t u32_run = 1u;
+
+    if ((u8_argc > 1u) && ((shell_parse_u32(argv[1], &u32_run) != HAL_OK) || (u32_run > 1u))) {
+        shell_usage(argv[0], reply);
+        return;
+    }
+
+    if (u32_run == 0u) {
+        fan_step_rig_stop(&g_step_rig);
+    } else if (fan_step_rig_start(&g_step_rig, fan_get_default(), g_step_script,
+                                  (uint8_t)(sizeof(g_step_script) / sizeof(g_step_script[0])),
+                                  FAN_CONTROL_DEFAULT_RATE_HZ, main_step_report, NULL) != HAL_OK) {
+        fmt_str(reply, "busy");
+        return;
+    }
+
+    fmt_str(reply, "step ");
+    fmt_u32(reply, fan_step_rig_poll(&g_step_rig), 0u, ' ');
+}
+
+/**
+ * @brief dist: RPM error and control step time distribution since the
+ *        last reset, noise of POTI_1 in the last ADC block.
+ */
+static void main_cmd_dist(uint8_t u8_argc, char *argv[], fmt_t *reply)
+{
+    fan_signal_stats_t stats;
+    stats_welford_t noise;
+    uint32_t u32_reset = 0u;
+
+    if ((u8_argc > 1u) && ((shell_parse_u32(argv[1], &u32_reset) != HAL_OK) || (u32_reset != 1u))) {
+        shell_usage(argv[0], reply);
+        return;
+    }
+    if (u32_reset) {
+        fan_reset_signal_stats();
+        fmt_str(reply, "reset");
+        return;
+    }
+    if (fan_get_signal_stats(&stats) != HAL_OK) {
+        fmt_str(reply, "busy");
+        return;
+    }
+
+    fmt_str(reply, "err mean ");
+    fmt_i32(reply, (int32_t)stats.error.f_mean, 0u, ' ');
+    fmt_str(reply, " sd ");
+    fmt_u32(reply, (uint32_t)stats_welford_get_stddev(&stats.error), 0u, ' ');
+    fmt_str(reply, " cyc mean ");
+    fmt_u32(reply, (uint32_t)stats.cycles.f_mean, 0u, ' ');
+    fmt_str(reply, " p99 ");
+    fmt_u32(reply, (uint32_t)stats_p2_get(&stats.cycles_quantile), 0u, ' ');
+    fmt_str(reply, " max ");
+    fmt_u32(reply, (uint32_t)stats.cycles.f_max, 0u, ' ');
+    if (potis_dma_get_noise(POTI_1, &noise) == HAL_OK) {
+        fmt_str(reply, " adc sd_uv ");
+        fmt_u32(reply, (uint32_t)(stats_welford_get_stddev(&noise) * 1000.0f), 0u, ' ');
+    }
+}
+
+/**
+ * @brief shot: starts a screenshot over USB CDC (modules/mirror/mirror_view.py
+ *        writes it as an image), reports the counters of the last ones.
+ */
+static void main_cmd_shot(uint8_t u8_argc, char *argv[], fmt_t *reply)
+{
+    screenshot_stats_t stats;
+    HAL_StatusTypeDef status;
+
+    if (u8_argc > 1u) {
+        shell_usage(argv[0], reply);
+        return;
+    }
+
+    status = screenshot_start();
+    screenshot_get_stats(&stats);
+    fmt_str(reply, (status == HAL_OK) ? "started" : (status == HAL_BUSY) ? "busy" : "error");
+    fmt_str(reply, " shots ");
+    fmt_u32(reply, stats.u32_shots, 0u, ' ');
+    fmt_str(reply, " kb ");
+    fmt_u32(reply, stats.u32_bytes / 1024u, 0u, ' ');
+    fmt_str(reply, " hold_us ");
+    fmt_u32(reply, stats.u32_max_hold_us, 0u, ' ');
+}
+#if FW_UPDATE_ENABLE
+/**
+ * @brief fw: running bank and update state; 1 waits for an image
+ *        (modules/fw_update/fw_update_send.py), 2 boots the verified one.
+ */
+static void main_cmd_fw(uint8_t u8_argc, char *argv[], fmt_t *reply)
+{
+    static const char *const pch_state[] = {
+        "idle", "header", "erasing", "receiving", "verified", "swapping", "failed"
+    };
+    fw_update_status_t status;
+    HAL_StatusTypeDef result = HAL_OK;
+    uint32_t u32_action;
+
+    if ((u8_argc > 2u) ||
+        ((u8_argc == 2u) && ((shell_parse_u32(argv[1], &u32_action) != HAL_OK) || (u32_action > 2u)))) {
+        shell_usage(argv[0], reply);
+        return;
+    }
+
+    if (u8_argc == 2u) {
+        if (u32_action == 0u) {
+            fw_update_abort();
+        } else if (u32_action == 1u) {
+            result = fw_update_begin();
+        } else {
+            result = fw_update_swap();
+        }
+    }
+
+    fw_update_get_status(&status);
+    fmt_str(reply, (result == HAL_OK) ? "bank " : (result == HAL_BUSY) ? "busy bank " : "error bank ");
+    fmt_u32(reply, status.u8_bank, 0u, ' ');
+    fmt_str(reply, " ");
+    fmt_str(reply, pch_state[status.state]);
+    fmt_str(reply, " ");
+    fmt_u32(reply, status.u32_written, 0u, ' ');
+    fmt_str(reply, "/");
+    fmt_u32(reply, status.u32_size, 0u, ' ');
+}
+#endif
+#if BKPTRACE_ENABLE
+/**
+ * @brief pm: starts, reset flags and readable entries of the ring; with n
+ *        the n-th entry before the last start (0 = the last one).
+ */
+static void main_cmd_pm(uint8_t u8_argc, char *argv[], fmt_t *reply)
+{
+    bkptrace_info_t info;
+    uint32_t u32_index;
+
+    if ((u8_argc > 2u) || ((u8_argc == 2u) && ((shell_parse_u32(argv[1], &u32_index) != HAL_OK) ||
+                                               (u32_index >= BKPTRACE_ENTRIES)))) {
+        shell_usage(argv[0], reply);
+        return;
+    }
+
+    if (u8_argc == 2u) {
+        if (bkptrace_format((uint16_t)u32_index, reply) != HAL_OK) {
+            fmt_str(reply, "no entry");
+        }
+        return;
+    }
+
+    bkptrace_get_info(&info);
+    fmt_str(reply, "boots ");
+    fmt_u32(reply, info.u32_boots, 0u, ' ');
+    fmt_str(reply, " csr ");
+    fmt_u32(reply, info.u32_reset_flags >> 24, 0u, ' ');
+    fmt_str(reply, " entries ");
+    fmt_u32(reply, info.u16_history, 0u, ' ');
+    fmt_str(reply, info.u8_restored ? "" : " (new ring)");
+}
+#endif
+#if TELEMETRY_SYNC_ENABLE
+/**
+ * @brief tm: reply of the host to a sync ping (t2 and hold time in us);
+ *        without arguments the sync state.
+ */
+static void main_cmd_tm(uint8_t u8_argc, char *argv[], fmt_t *reply)
+{
+    telemetry_sync_stats_t stats;
+    uint64_t u64_host_us;
+    uint32_t u32_seq;
+    uint32_t u32_hold_us;
+
+    if (u8_argc == 4u) {
+        /* No reply: the host sends four per second */
+        if ((shell_parse_u32(argv[1], &u32_seq) != HAL_OK) || (u32_seq > UINT16_MAX) ||
+            (shell_parse_u64(argv[2], &u64_host_us) != HAL_OK) ||
+            (shell_parse_u32(argv[3], &u32_hold_us) != HAL_OK)) {
+            shell_usage(argv[0], reply);
+            return;
+        }
+        (void)telemetry_sync_reply((uint16_t)u32_seq, u64_host_us, u32_hold_us);
+        return;
+    }
+    if (u8_argc != 1u) {
+        shell_usage(argv[0], reply);
+        return;
+    }
+
+    telemetry_sync_get_stats(&stats);
+    fmt_str(reply, stats.u8_locked ? "locked" : "unlocked");
+    fmt_str(reply, " drift ");
+    fmt_i32(reply, stats.i32_drift_ppb, 0u, ' ');
+    fmt_str(reply, " ppb delay ");
+    fmt_u32(reply, stats.u32_delay_us, 0u, ' ');
+    fmt_str(reply, " us pings ");
+    fmt_u32(reply, stats.u32_pings, 0u, ' ');
+    fmt_str(reply, " used ");
+    fmt_u32(reply, stats.u32_replies, 0u, ' ');
+    fmt_str(reply, " rejected ");
+    fmt_u32(reply, stats.u32_rejected, 0u, ' ');
+    fmt_str(reply, " steps ");
+    fmt_u32(reply, stats.u32_steps, 0u, ' ');
+    fmt_str(reply, " rtc ");
+    fmt_i32(reply, stats.i32_rtc_error_us, 0u, ' ');
+    fmt_str(reply, " us sets ");
+    fmt_u32(reply, stats.u32_rtc_sets, 0u, ' ');
+    fmt_str(reply, " shifts ");
+    fmt_u32(reply, stats.u32_rtc_shifts, 0u, ' ');
+}
+#endif
+#endif
@@ -0,0 +1,33 @@
+/**
+ ******************************************************************************
+ * @file        project_conf.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Modulkonfiguration von P2_Weatherstation.
+ *
+ * @details
+ * Wird von jedem Modul vor seinen eigenen Voreinstellungen gelesen (über
+ * stm32f4xx_hal_conf.h, die BME280 Library über bme280_defs.h). Teile
+ * der Module, die dieses Projekt nicht nutzt, werden hier
+ * ausgeschaltet; die Feature-Schalter (SHELL_ENABLE, TRACE_ENABLE, ...)
+ * können statt -D in den Build-Einstellungen ebenfalls hier stehen.
+ *
+ ******************************************************************************
+ */
+
+#ifndef PROJECT_CONF_H_
+#define PROJECT_CONF_H_
+
+/* lcd: nur das SPI-Backend, Framebuffer-, SDRAM- und LTDC-Code entfällt */
+#define LCD_FRAMEBUFFER_ENABLE      0
+
+/* BME280: Integer-Kompensation (Druck in 64 Bit), kein Software-double */
+#ifndef BME280_64BIT_ENABLE
+#define BME280_64BIT_ENABLE
+#endif
+
+/* env_sensor: BME280 nur an I2C, kein SPI-Bus-Code */
+#define ENV_SENSOR_SPI_ENABLE       0
+
+#endif /* PROJECT_CONF_H_ */
@@ -14,25 +14,173 @@
  * Verwendete Module:
  *  - lcd
  *  - env_sensor
+ *  - env_history
+ *  - env_derived
+ *  - lowpower (nur mit WEATHER_DUTY_CYCLE_MS)
+ *  - sdlog (Langzeitaufzeichnung auf SD-Karte, nur mit SDLOG_ENABLE)
  *
  * Verwendete Peripherie:
  *  - LCD
  *  - Umweltsensor (z. B. Temperatur-, Druck- und Feuchtigkeitssensor)
+ *  - RTC-Wakeup-Timer, STOP-Mode (nur mit WEATHER_DUTY_CYCLE_MS)
+ *  - USART1, DMA2 Stream7/Stream2 (Telemetrie, nur mit UART_TELEMETRY_ENABLE)
+ *  - SDIO, DMA2 Stream6 (SD-Karte, nur mit SDLOG_ENABLE, 168 MHz für den
+ *    48-MHz-SDIO-Takt)
  *
  ******************************************************************************
  */
 
+#include <clock/clock.h>
 #include <lcd/lcd.h>
+#include <fmt/fmt.h>
 #include "stm32f4xx.h"
 #include <env_sensor/env_sensor.h>
+#include <env_history/env_history.h>
+#include <env_derived/env_derived.h>
+#include <lowpower/lowpower.h>
+#include <uart_telemetry/uart_telemetry.h>
+#include <sdlog/sdlog.h>
+#include <datalog/datalog.h>
+#include <irq/irq.h>
+
+/**
+ * @brief Messabstand im Batteriebetrieb in Millisekunden
+ *
+ * @details
+ * 0: Normal-Mode, die Hauptschleife liest laufend. Sonst je Periode eine
+ * Forced-Mode-Messung, dazwischen STOP-Mode mit RTC-Wakeup.
+ */
+#ifndef WEATHER_DUTY_CYCLE_MS
+#define WEATHER_DUTY_CYCLE_MS 0
+#endif
+
+/**
+ * @brief 1: Display während des STOP-Mode im Sleep-In (nur mit
+ *        WEATHER_DUTY_CYCLE_MS)
+ *
+ * @details
+ * Das Panel ist dann dunkel und behält seinen Bildspeicher; nach dem
+ * Wakeup zeigt lcd_resume() nach ca. 5 ms wieder das letzte Bild, ohne
+ * Reset, Init-Sequenz und Löschen.
+ */
+#ifndef WEATHER_LCD_SLEEP
+#define WEATHER_LCD_SLEEP 0
+#endif
+
+/* Zeitreihen: Temperatur (0,01 Grad C), Luftdruck (Pa), Feuchte (0,001 %) */
+static env_history_series_t temp_history;
+static env_history_series_t press_history;
+static env_history_series_t hum_history;
+static uint32_t history_tick;
+
+/* Drucktendenz, Höhe und Taupunkt */
+static env_derived_t derived;
+
+/**
+ * @brief   Gibt einen Festkommawert mit Beschriftung und Einheit aus
+ *
+ * @param   line     Zeile auf dem LCD
+ * @param   label    Beschriftung
+ * @param   value    Wert in 10^-decimals
+ * @param   decimals Nachkommastellen
+ * @param   unit     Einheit
+ * @return  None
+ */
+static void show_fixed(uint8_t line, const char *label, int32_t value, uint8_t decimals, const char *unit)
+{
+    char buffer[32];
+    fmt_t fmt;
+
+    fmt_init(&fmt, buffer, sizeof(buffer));
+    fmt_str(&fmt, label);
+    fmt_fixed(&fmt, value, decimals, 0);
+    fmt_str(&fmt, unit);
+    fmt_lcd_line(&fmt, line, BLACK, 2, WHITE);
+}
+
+/**
+ * @brief   Wertet einen Messwert aus und gibt ihn auf dem LCD aus
+ *
+ * @details
+ * Taupunkt und Drucktendenz werden bei jedem Messwert fortgeschrieben.
+ * Die Zeitreihen erhalten je ENV_HISTORY_SAMPLE_MS einen Wert; bei
+ * längeren Messabständen wird der Messwert entsprechend oft übernommen,
+ * damit die Fensterlängen stimmen. Angezeigt werden Minimum und Maximum
+ * der Temperatur der letzten Stunde sowie der mittlere Luftdruck der
+ * letzten 24 Stunden.
+ *
+ * @param   temp  Temperatur in 0,01 Grad C
+ * @param   press Luftdruck in Pa
+ * @param   hum   Relative Luftfeuchtigkeit in 0,001 %
+ * @return  None
+ */
+static void show_sample(int32_t temp, uint32_t press, uint32_t hum)
+{
+    int32_t trend;
+    env_history_stats_t stats;
+    uint8_t history_changed = 0;
+
+    /* Festkommawerte: 0,01 Grad C, Pa (= 0,01 hPa), 0,001 % */
+    show_fixed(2, "Temp: ", temp, 2, " C");
+    show_fixed(3, "Pres: ", (int32_t)press, 2, " hPa");
+    show_fixed(4, "Hum: ", (int32_t)(hum / 10), 2, " %");
+
+    env_derived_update(&derived, temp, press, hum);
+
+#if UART_TELEMETRY_ENABLE
+    uart_telemetry_send_env(temp, press, hum);
+#endif
+
+#if SDLOG_ENABLE
+    /* Kanalnummern wie beim datalog, siehe sdlog_tool.py */
+    sdlog_add(DATALOG_CH_ENV_TEMP, temp);
+    sdlog_add(DATALOG_CH_ENV_PRESS, (int32_t)press);
+    sdlog_add(DATALOG_CH_ENV_HUM, (int32_t)hum);
+#endif
+
+    show_fixed(10, "Taup: ", env_derived_get_dew_point(&derived), 2, " C");
+
+    if (env_derived_get_trend(&derived, &trend) == HAL_OK) {
+        show_fixed(11, (trend < 0) ? "Tend: " : "Tend: +", trend, 2, " hPa/3h");
+    }
+
+    while ((HAL_GetTick() - history_tick) >= ENV_HISTORY_SAMPLE_MS) {
+        history_tick += ENV_HISTORY_SAMPLE_MS;
+
+        env_history_add(&temp_history, temp);
+        env_history_add(&press_history, (int32_t)press);
+        env_history_add(&hum_history, (int32_t)hum);
+        history_changed = 1;
+    }
+
+    if (!history_changed) {
+        return;
+    }
+
+    if (env_history_get_stats(&temp_history, ENV_HISTORY_WINDOW_1H, &stats) == HAL_OK) {
+        show_fixed(6, "Min 1h: ", stats.min, 2, " C");
+        show_fixed(7, "Max 1h: ", stats.max, 2, " C");
+    }
+
+    if (env_history_get_stats(&press_history, ENV_HISTORY_WINDOW_24H, &stats) == HAL_OK) {
+        show_fixed(8, "P 24h: ", stats.mean, 2, " hPa");
+    }
+}
 
 /**
  * @brief   Einstiegspunkt des Programms
  *
  * @details
  * Initialisiert das HAL-System, das LCD und den Umweltsensor.
- * In der Endlosschleife werden Temperatur, Luftdruck und Luftfeuchtigkeit
- * ausgelesen, formatiert und auf dem LCD ausgegeben.
+ * Ohne WEATHER_DUTY_CYCLE_MS werden Temperatur, Luftdruck und
+ * Luftfeuchtigkeit im Normal-Mode des Sensors gemessen und nicht
+ * blockierend gelesen; sobald neue Werte vorliegen, wird der nächste
+ * Lesezugriff gestartet und die Werte auf dem LCD ausgegeben.
+ *
+ * Mit WEATHER_DUTY_CYCLE_MS startet jede Periode eine Forced-Mode-
+ * Messung, danach geht der Controller bis zum nächsten RTC-Wakeup in
+ * den STOP-Mode. Angezeigt wird die Latenz vom Wakeup bis zum
+ * Messwert: Zeit für das Wiederherstellen der Takte plus Messzeit.
  *
  * @param   None
  * @return  None
@@ -40,23 +188,122 @@
 int main(void)
 {
     HAL_Init();
-    lcd_init();
+    irq_init();
+#if SDLOG_ENABLE
+    /* SDIO braucht 48 MHz aus der PLL, die liefert nur das 168-MHz-Profil */
+    clock_init(CLOCK_PROFILE_168MHZ);
+#else
+    clock_init(CLOCK_PROFILE_180MHZ);
+#endif
+    /* Display und Sensor überlappt: das Display kehrt bei der Wartezeit nach
+     * Reset und Sleep Out zurück, in der Zeit wird der Sensor initialisiert */
+    pt_t lcd_pt;
+
+    PT_INIT(&lcd_pt);
+    (void)lcd_init_thread(&lcd_pt);
     env_sensor_init();
+    while (lcd_init_thread(&lcd_pt) < PT_EXITED) {
+    }
+
+#if SDLOG_ENABLE
+    /* Messwerte an SDLOG.BIN anhängen; ohne Karte oder Datei läuft alles andere weiter */
+    sdlog_init();
+#endif
+
+#if UART_TELEMETRY_ENABLE
+    /* Jeder Messwert als Frame am virtuellen COM-Port, siehe uart_telemetry_decode.py */
+    uart_telemetry_init(UART_TELEMETRY_BAUD);
+#endif
+
+    int32_t  temp;
+    uint32_t press, hum;
 
-    float temp, press, hum;
+    env_history_init(&temp_history);
+    env_history_init(&press_history);
+    env_history_init(&hum_history);
+    env_derived_init(&derived, ENV_DERIVED_SEA_LEVEL_PA);
+    history_tick = HAL_GetTick();
+
+#if WEATHER_DUTY_CYCLE_MS
     char buffer[32];
+    fmt_t fmt;
+
+    lowpower_init();
+
+    /* Ruhige Messwerte: weniger Oversampling, kürzere Wachphase */
+    env_sensor_set_adaptive(env_sensor_get_default(), 1);
+
+    while (1)
+    {
+        /* Forced-Mode: eine Messung, danach wieder Sleep-Mode */
+        if (env_sensor_start_measurement() == HAL_OK) {
+            /* Während der Messung Sleep-Mode, SysTick und I2C wecken */
+            while (env_sensor_poll() == ENV_SENSOR_BUSY) {
+                __WFI();
+            }
+
+            if (env_sensor_get_data_fixed(&temp, &press, &hum) == HAL_OK) {
+                const lowpower_stats_t *stats = lowpower_get_stats();
+                uint32_t latency_ms = HAL_GetTick() - stats->u32_wake_tick;
+
+                show_sample(temp, press, hum);
+
+                fmt_init(&fmt, buffer, sizeof(buffer));
+                fmt_str(&fmt, "Wake: ");
+                fmt_u32(&fmt, stats->u32_restore_us, 0u, ' ');
+                fmt_str(&fmt, " us+");
+                fmt_u32(&fmt, latency_ms, 0u, ' ');
+                fmt_str(&fmt, " ms");
+                fmt_lcd_line(&fmt, 12, BLACK, 2, WHITE);
+            }
+        }
+
+        /* LCD-DMA muss vor dem STOP-Mode fertig sein */
+        ILI9341_DMA_Wait();
+#if WEATHER_LCD_SLEEP
+        /* Sleep-In wartet selbst auf die DMA; HAL_BUSY bis 120 ms nach
+         * dem letzten Sleep Out, das Display bleibt dann an */
+        (void)lcd_sleep();
+#endif
+#if UART_TELEMETRY_ENABLE
+        /* Ebenso die Telemetrie, im STOP-Mode steht der UART-Takt */
+        uart_telemetry_flush(100u);
+#endif
+#if SDLOG_ENABLE
+        /* Volle Sektoren noch schreiben, im STOP-Mode steht der SDIO-Takt */
+        while (sdlog_pending()) {
+            sdlog_task();
+        }
+#endif
+        lowpower_stop(WEATHER_DUTY_CYCLE_MS);
+#if WEATHER_LCD_SLEEP
+        lcd_resume();
+#endif
+    }
+#else
+    /* Sensor misst selbst alle ca. 170 ms, gelesen wird bei Bedarf */
+    env_sensor_start_normal(BME280_STANDBY_TIME_125_MS);
+    env_sensor_start_measurement();
 
     while (1)
     {
-        env_sensor_read_data(&temp, &press, &hum);
+#if SDLOG_ENABLE
+        /* Schreibt volle Puffer per DMA, wartet nie auf die Karte */
+        sdlog_task();
+#endif
 
-        sprintf(buffer, "Temp: %.2f C", temp);
-        lcd_draw_text_at_line(buffer, 2, BLACK, 2, WHITE);
+        /* Burst-Read läuft per DMA, die Schleife wartet nicht darauf */
+        if (env_sensor_poll() == ENV_SENSOR_BUSY) {
+            continue;
+        }
 
-        sprintf(buffer, "Pres: %.2f hPa", press);
-        lcd_draw_text_at_line(buffer, 3, BLACK, 2, WHITE);
+        if (env_sensor_get_data_fixed(&temp, &press, &hum) != HAL_OK) {
+            env_sensor_start_measurement();
+            continue;
+        }
+        env_sensor_start_measurement();
 
-        sprintf(buffer, "Hum: %.2f %%", hum);
-        lcd_draw_text_at_line(buffer, 4, BLACK, 2, WHITE);
+        show_sample(temp, press, hum);
     }
+#endif
 }
@@ -62,6 +62,20 @@ defined in linker script */
 .word  _ebss
 /* stack used for SystemInit_ExtMemCtl; always internal RAM used */
 
+/* Stores the cycle counter in entry <phase> of the boot phase table
+   (boot_phase_t in modules/boot/boot.h) */
+.equ  BOOT_PHASE_DATA, 0
+.equ  BOOT_PHASE_BSS, 1
+.equ  BOOT_PHASE_CCM, 2
+.equ  BOOT_PHASE_PAINT, 3
+.equ  BOOT_PHASE_SYSTEM_INIT, 4
+.equ  BOOT_PHASE_MAIN, 5
+
+.macro BOOT_STAMP phase
+  ldr  r3, [r11, #4]
+  str  r3, [r10, #(\phase * 4)]
+.endm
+
 /**
  * @brief  This is the code that gets called when the processor first
  *          starts execution following a reset event. Only the absolutely
@@ -75,45 +89,122 @@ defined in linker script */
   .weak  Reset_Handler
   .type  Reset_Handler, %function
 Reset_Handler: 
-   ldr   sp, =_estack       /* set stack pointer */
- 
+  ldr   sp, =_estack       /* set stack pointer */
+
+/* Start the DWT cycle counter from 0 for the boot phase timestamps
+   (modules/boot, .noinit): r10 = timestamp table, r11 = DWT, both kept
+   by the called functions */
+  ldr  r0, =0xE000EDFC     /* CoreDebug->DEMCR */
+  ldr  r1, [r0]
+  orr  r1, r1, #0x01000000 /* TRCENA */
+  str  r1, [r0]
+  ldr  r11, =0xE0001000    /* DWT->CTRL, CYCCNT at offset 4 */
+  movs r1, #0
+  str  r1, [r11, #4]
+  ldr  r1, [r11]
+  orr  r1, r1, #1          /* CYCCNTENA */
+  str  r1, [r11]
+  ldr  r10, =g_u32_boot_phase_cycles
+
 /* Copy the data segment initializers from flash to SRAM */  
-  movs  r1, #0
-  b  LoopCopyDataInit
-
-CopyDataInit:
-  ldr  r3, =_sidata
-  ldr  r3, [r3, r1]
-  str  r3, [r0, r1]
-  adds  r1, r1, #4
-    
-LoopCopyDataInit:
   ldr  r0, =_sdata
-  ldr  r3, =_edata
-  adds  r2, r0, r1
-  cmp  r2, r3
-  bcc  CopyDataInit
-  ldr  r2, =_sbss
-  b  LoopFillZerobss
+  ldr  r1, =_edata
+  ldr  r2, =_sidata
+  bl  BootCopy
+  BOOT_STAMP BOOT_PHASE_DATA
+
 /* Zero fill the bss segment. */  
-FillZerobss:
-  movs  r3, #0
-  str  r3, [r2], #4
-    
-LoopFillZerobss:
-  ldr  r3, = _ebss
-  cmp  r2, r3
-  bcc  FillZerobss
+  ldr  r0, =_sbss
+  ldr  r1, =_ebss
+  movs  r4, #0
+  bl  BootFill
+  BOOT_STAMP BOOT_PHASE_BSS
+
+/* Copy the CCM-RAM data initializers and zero fill the CCM-RAM bss */
+  ldr  r0, =_sccmram
+  ldr  r1, =_eccmram
+  ldr  r2, =_siccmram
+  bl  BootCopy
+  ldr  r0, =_sccmbss
+  ldr  r1, =_eccmbss
+  movs  r4, #0
+  bl  BootFill
+  BOOT_STAMP BOOT_PHASE_CCM
+
+/* Paint the free RAM from the heap start up to the stack top (stack
+   high water mark, HEALTH_STACK_PAINT in modules/health/health.h).
+   .noinit lies below _end and is neither zeroed nor painted */
+  ldr  r0, =_end
+  ldr  r1, =_estack
+  ldr  r4, =0xA5A5A5A5
+  bl  BootFill
+  BOOT_STAMP BOOT_PHASE_PAINT
 
 /* Call the clock system intitialization function.*/
   bl  SystemInit   
+  BOOT_STAMP BOOT_PHASE_SYSTEM_INIT
 /* Call static constructors */
     bl __libc_init_array
+  BOOT_STAMP BOOT_PHASE_MAIN
 /* Call the application's entry point.*/
   bl  main
   bx  lr    
 .size  Reset_Handler, .-Reset_Handler
 
+/**
+ * @brief  Copies words from r2 to r0 up to r1: four words per LDM/STM,
+ *         the rest (0..3 words) singly. Start and end are word aligned
+ *         (ALIGN(4) in the linker script).
+ * @param  r0 destination, r1 destination end, r2 source
+ * @retval : None, changes r0, r2..r7
+*/
+  .type  BootCopy, %function
+BootCopy:
+  b  LoopCopyBlock
+CopyBlock:
+  ldmia  r2!, {r4-r7}
+  stmia  r0!, {r4-r7}
+LoopCopyBlock:
+  sub  r3, r1, r0
+  cmp  r3, #16
+  bhs  CopyBlock
+  b  LoopCopyWord
+CopyWord:
+  ldr  r4, [r2], #4
+  str  r4, [r0], #4
+LoopCopyWord:
+  cmp  r0, r1
+  bcc  CopyWord
+  bx  lr
+.size  BootCopy, .-BootCopy
+
+/**
+ * @brief  Fills words from r0 up to r1 with r4: four words per STM, the
+ *         rest (0..3 words) singly. Start and end are word aligned.
+ * @param  r0 start, r1 end, r4 pattern
+ * @retval : None, changes r0, r3, r5..r7
+*/
+  .type  BootFill, %function
+BootFill:
+  mov  r5, r4
+  mov  r6, r4
+  mov  r7, r4
+  b  LoopFillBlock
+FillBlock:
+  stmia  r0!, {r4-r7}
+LoopFillBlock:
+  sub  r3, r1, r0
+  cmp  r3, #16
+  bhs  FillBlock
+  b  LoopFillWord
+FillWord:
+  str  r4, [r0], #4
+LoopFillWord:
+  cmp  r0, r1
+  bcc  FillWord
+  bx  lr
+.size  BootFill, .-BootFill
+
 /**
  * @brief  This is the code that gets called when the processor receives an 
  *         unexpected interrupt.  This simply enters an infinite loop, preserving
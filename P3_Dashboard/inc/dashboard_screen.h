@@ -0,0 +1,19 @@
+/* Generated by template_convert.py from dashboard_screen.tpl, do not edit */
+#ifndef DASHBOARD_SCREEN_H_
+#define DASHBOARD_SCREEN_H_
+
+#include "lcd/lcd_template.h"
+
+#define DASHBOARD_SCREEN_FIELD_TEMP 0u
+#define DASHBOARD_SCREEN_FIELD_HUM 1u
+#define DASHBOARD_SCREEN_FIELD_PRESS 2u
+#define DASHBOARD_SCREEN_FIELD_DEW 3u
+#define DASHBOARD_SCREEN_FIELD_MAX_1H 4u
+#define DASHBOARD_SCREEN_FIELD_START 5u
+#define DASHBOARD_SCREEN_FIELD_TARGET 6u
+#define DASHBOARD_SCREEN_FIELD_CURRENT 7u
+#define DASHBOARD_SCREEN_FIELDS 8u
+
+extern const lcd_template_t dashboard_screen;
+
+#endif /* DASHBOARD_SCREEN_H_ */
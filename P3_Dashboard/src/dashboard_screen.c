@@ -0,0 +1,235 @@
+/* Generated by template_convert.py from dashboard_screen.tpl: 2 colours, RLE8, 3332 bytes (RGB565: 153600) */
+#include "dashboard_screen.h"
+
+#include <lcd/ILI9341_Fonts.h>
+
+static const uint16_t dashboard_screen_palette[2] = {
+	0x0000, 0xFFFF,
+};
+
+static const uint8_t dashboard_screen_data[3328] = {
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0x89, 0x01, 0x89, 0x00, 0x81, 0x01, 0x89, 0x00,
+	0x81, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x87, 0x00, 0x83, 0x01, 0x81, 0x00,
+	0xFF, 0x01, 0xB3, 0x01, 0x89, 0x01, 0x89, 0x00, 0x81, 0x01, 0x89, 0x00, 0x81, 0x01, 0x81, 0x00,
+	0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x87, 0x00, 0x83, 0x01, 0x81, 0x00, 0xFF, 0x01, 0xB3, 0x01,
+	0x8D, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x89, 0x01, 0x83, 0x00, 0x81, 0x01, 0x83, 0x00,
+	0x81, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0xFF, 0x01, 0xB7, 0x01, 0x8D, 0x01, 0x81, 0x00,
+	0x85, 0x01, 0x81, 0x00, 0x89, 0x01, 0x83, 0x00, 0x81, 0x01, 0x83, 0x00, 0x81, 0x01, 0x81, 0x00,
+	0x85, 0x01, 0x81, 0x00, 0xFF, 0x01, 0xB7, 0x01, 0x8D, 0x01, 0x81, 0x00, 0x85, 0x01, 0x87, 0x00,
+	0x83, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0x81, 0x01, 0x87, 0x00,
+	0xFF, 0x01, 0xB9, 0x01, 0x8D, 0x01, 0x81, 0x00, 0x85, 0x01, 0x87, 0x00, 0x83, 0x01, 0x81, 0x00,
+	0x81, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0x81, 0x01, 0x87, 0x00, 0xFF, 0x01, 0xB9, 0x01,
+	0x8D, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x89, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00,
+	0x81, 0x01, 0x81, 0x00, 0xFF, 0x01, 0xBF, 0x01, 0x8D, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00,
+	0x89, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0xFF, 0x01, 0xBF, 0x01,
+	0x8D, 0x01, 0x81, 0x00, 0x85, 0x01, 0x89, 0x00, 0x81, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00,
+	0x81, 0x01, 0x81, 0x00, 0x89, 0x01, 0x81, 0x00, 0xFF, 0x01, 0xB3, 0x01, 0x8D, 0x01, 0x81, 0x00,
+	0x85, 0x01, 0x89, 0x00, 0x81, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00,
+	0x89, 0x01, 0x81, 0x00, 0xFF, 0x01, 0xB3, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0x89, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00,
+	0x81, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0xFF, 0x01, 0xBF, 0x01,
+	0x89, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00,
+	0x81, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0xFF, 0x01, 0xBF, 0x01,
+	0x89, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00,
+	0x81, 0x01, 0x83, 0x00, 0x81, 0x01, 0x83, 0x00, 0xFF, 0x01, 0xC3, 0x01, 0x89, 0x01, 0x81, 0x00,
+	0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x83, 0x00,
+	0x81, 0x01, 0x83, 0x00, 0xFF, 0x01, 0xC3, 0x01, 0x89, 0x01, 0x89, 0x00, 0x81, 0x01, 0x81, 0x00,
+	0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00,
+	0xFF, 0x01, 0xC3, 0x01, 0x89, 0x01, 0x89, 0x00, 0x81, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00,
+	0x81, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0xFF, 0x01, 0xC3, 0x01,
+	0x89, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00,
+	0x81, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0xFF, 0x01, 0xC3, 0x01, 0x89, 0x01, 0x81, 0x00,
+	0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00,
+	0x85, 0x01, 0x81, 0x00, 0xFF, 0x01, 0xC3, 0x01, 0x89, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00,
+	0x81, 0x01, 0x89, 0x00, 0x81, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00,
+	0xFF, 0x01, 0xBF, 0x01, 0x89, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x89, 0x00,
+	0x81, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0xFF, 0x01, 0xBF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0x89, 0x01, 0x87, 0x00, 0x83, 0x01, 0x87, 0x00,
+	0x83, 0x01, 0x89, 0x00, 0x81, 0x01, 0x89, 0x00, 0x81, 0x01, 0x81, 0x00, 0xFF, 0x01, 0xB3, 0x01,
+	0x89, 0x01, 0x87, 0x00, 0x83, 0x01, 0x87, 0x00, 0x83, 0x01, 0x89, 0x00, 0x81, 0x01, 0x89, 0x00,
+	0x81, 0x01, 0x81, 0x00, 0xFF, 0x01, 0xB3, 0x01, 0x89, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00,
+	0x81, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0x89, 0x01, 0x81, 0x00,
+	0xFF, 0x01, 0xBF, 0x01, 0x89, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00,
+	0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0x89, 0x01, 0x81, 0x00, 0xFF, 0x01, 0xBF, 0x01,
+	0x89, 0x01, 0x87, 0x00, 0x83, 0x01, 0x87, 0x00, 0x83, 0x01, 0x87, 0x00, 0x83, 0x01, 0x89, 0x00,
+	0xFF, 0x01, 0xB7, 0x01, 0x89, 0x01, 0x87, 0x00, 0x83, 0x01, 0x87, 0x00, 0x83, 0x01, 0x87, 0x00,
+	0x83, 0x01, 0x89, 0x00, 0xFF, 0x01, 0xB7, 0x01, 0x89, 0x01, 0x81, 0x00, 0x89, 0x01, 0x81, 0x00,
+	0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0x91, 0x01, 0x81, 0x00, 0xFF, 0x01, 0xB7, 0x01,
+	0x89, 0x01, 0x81, 0x00, 0x89, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00,
+	0x91, 0x01, 0x81, 0x00, 0xFF, 0x01, 0xB7, 0x01, 0x89, 0x01, 0x81, 0x00, 0x89, 0x01, 0x81, 0x00,
+	0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x89, 0x00, 0x81, 0x01, 0x89, 0x00, 0x81, 0x01, 0x81, 0x00,
+	0xFF, 0x01, 0xB3, 0x01, 0x89, 0x01, 0x81, 0x00, 0x89, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00,
+	0x81, 0x01, 0x89, 0x00, 0x81, 0x01, 0x89, 0x00, 0x81, 0x01, 0x81, 0x00, 0xFF, 0x01, 0xB3, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0x89, 0x01, 0x87, 0x00, 0x83, 0x01, 0x89, 0x00,
+	0x81, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0xFF, 0x01, 0xBF, 0x01,
+	0x89, 0x01, 0x87, 0x00, 0x83, 0x01, 0x89, 0x00, 0x81, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00,
+	0x81, 0x01, 0x81, 0x00, 0xFF, 0x01, 0xBF, 0x01, 0x89, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00,
+	0x81, 0x01, 0x81, 0x00, 0x89, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0xFF, 0x01, 0xC3, 0x01,
+	0x89, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0x89, 0x01, 0x81, 0x00,
+	0x85, 0x01, 0x81, 0x00, 0xFF, 0x01, 0xC3, 0x01, 0x89, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00,
+	0x81, 0x01, 0x87, 0x00, 0x83, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00,
+	0xFF, 0x01, 0xC3, 0x01, 0x89, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x87, 0x00,
+	0x83, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0xFF, 0x01, 0xC3, 0x01,
+	0x89, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0x89, 0x01, 0x81, 0x00,
+	0x81, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0xFF, 0x01, 0xC3, 0x01, 0x89, 0x01, 0x81, 0x00,
+	0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0x89, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00,
+	0x81, 0x01, 0x81, 0x00, 0xFF, 0x01, 0xC3, 0x01, 0x89, 0x01, 0x87, 0x00, 0x83, 0x01, 0x89, 0x00,
+	0x83, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0x83, 0x01, 0x81, 0x00, 0xFF, 0x01, 0xBF, 0x01,
+	0x89, 0x01, 0x87, 0x00, 0x83, 0x01, 0x89, 0x00, 0x83, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00,
+	0x83, 0x01, 0x81, 0x00, 0xFF, 0x01, 0xBF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0x89, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x89, 0x00, 0x81, 0x01, 0x81, 0x00,
+	0x85, 0x01, 0x81, 0x00, 0x8F, 0x01, 0x81, 0x00, 0x87, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00,
+	0x81, 0x01, 0x81, 0x00, 0xFF, 0x01, 0x9B, 0x01, 0x89, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00,
+	0x81, 0x01, 0x89, 0x00, 0x81, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x8F, 0x01, 0x81, 0x00,
+	0x87, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0xFF, 0x01, 0x9B, 0x01,
+	0x89, 0x01, 0x83, 0x00, 0x81, 0x01, 0x83, 0x00, 0x81, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00,
+	0x83, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0x8F, 0x01, 0x83, 0x00, 0x87, 0x01, 0x81, 0x00,
+	0x85, 0x01, 0x81, 0x00, 0xFF, 0x01, 0x9F, 0x01, 0x89, 0x01, 0x83, 0x00, 0x81, 0x01, 0x83, 0x00,
+	0x81, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x83, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00,
+	0x8F, 0x01, 0x83, 0x00, 0x87, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0xFF, 0x01, 0x9F, 0x01,
+	0x89, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00,
+	0x85, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x93, 0x01, 0x81, 0x00, 0x87, 0x01, 0x89, 0x00,
+	0xFF, 0x01, 0x9F, 0x01, 0x89, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00,
+	0x81, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x93, 0x01, 0x81, 0x00,
+	0x87, 0x01, 0x89, 0x00, 0xFF, 0x01, 0x9F, 0x01, 0x89, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00,
+	0x81, 0x01, 0x89, 0x00, 0x83, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0x91, 0x01, 0x81, 0x00,
+	0x87, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0xFF, 0x01, 0x9F, 0x01, 0x89, 0x01, 0x81, 0x00,
+	0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x89, 0x00, 0x83, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00,
+	0x91, 0x01, 0x81, 0x00, 0x87, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0xFF, 0x01, 0x9F, 0x01,
+	0x89, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00,
+	0x81, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x8D, 0x01, 0x85, 0x00, 0x85, 0x01, 0x81, 0x00,
+	0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0xFF, 0x01, 0x9B, 0x01, 0x89, 0x01, 0x81, 0x00,
+	0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00,
+	0x85, 0x01, 0x81, 0x00, 0x8D, 0x01, 0x85, 0x00, 0x85, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00,
+	0x81, 0x01, 0x81, 0x00, 0xFF, 0x01, 0x9B, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0x89, 0x01, 0x89, 0x00, 0x81, 0x01, 0x89, 0x00, 0x81, 0x01, 0x89, 0x00, 0x81, 0x01, 0x87, 0x00,
+	0x83, 0x01, 0x89, 0x00, 0x81, 0x01, 0x81, 0x00, 0xFF, 0x01, 0xA7, 0x01, 0x89, 0x01, 0x89, 0x00,
+	0x81, 0x01, 0x89, 0x00, 0x81, 0x01, 0x89, 0x00, 0x81, 0x01, 0x87, 0x00, 0x83, 0x01, 0x89, 0x00,
+	0x81, 0x01, 0x81, 0x00, 0xFF, 0x01, 0xA7, 0x01, 0x89, 0x01, 0x81, 0x00, 0x8D, 0x01, 0x81, 0x00,
+	0x85, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00,
+	0x85, 0x01, 0x81, 0x00, 0xFF, 0x01, 0xAF, 0x01, 0x89, 0x01, 0x81, 0x00, 0x8D, 0x01, 0x81, 0x00,
+	0x85, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00,
+	0x85, 0x01, 0x81, 0x00, 0xFF, 0x01, 0xAF, 0x01, 0x89, 0x01, 0x89, 0x00, 0x85, 0x01, 0x81, 0x00,
+	0x85, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x87, 0x00, 0x87, 0x01, 0x81, 0x00,
+	0xFF, 0x01, 0xAF, 0x01, 0x89, 0x01, 0x89, 0x00, 0x85, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00,
+	0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x87, 0x00, 0x87, 0x01, 0x81, 0x00, 0xFF, 0x01, 0xAF, 0x01,
+	0x91, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x85, 0x01, 0x89, 0x00, 0x81, 0x01, 0x81, 0x00,
+	0x85, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0xFF, 0x01, 0xAF, 0x01, 0x91, 0x01, 0x81, 0x00,
+	0x85, 0x01, 0x81, 0x00, 0x85, 0x01, 0x89, 0x00, 0x81, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00,
+	0x85, 0x01, 0x81, 0x00, 0xFF, 0x01, 0xAF, 0x01, 0x89, 0x01, 0x89, 0x00, 0x85, 0x01, 0x81, 0x00,
+	0x85, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00,
+	0x85, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0xFF, 0x01, 0xA7, 0x01, 0x89, 0x01, 0x89, 0x00,
+	0x85, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00,
+	0x85, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0xFF, 0x01, 0xA7, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0x89, 0x01, 0x89, 0x00, 0x81, 0x01, 0x89, 0x00,
+	0x81, 0x01, 0x87, 0x00, 0x83, 0x01, 0x89, 0x00, 0x81, 0x01, 0x89, 0x00, 0x81, 0x01, 0x89, 0x00,
+	0x81, 0x01, 0x81, 0x00, 0xFF, 0x01, 0x9B, 0x01, 0x89, 0x01, 0x89, 0x00, 0x81, 0x01, 0x89, 0x00,
+	0x81, 0x01, 0x87, 0x00, 0x83, 0x01, 0x89, 0x00, 0x81, 0x01, 0x89, 0x00, 0x81, 0x01, 0x89, 0x00,
+	0x81, 0x01, 0x81, 0x00, 0xFF, 0x01, 0x9B, 0x01, 0x8D, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00,
+	0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00,
+	0x89, 0x01, 0x81, 0x00, 0x8D, 0x01, 0x81, 0x00, 0xFF, 0x01, 0xA3, 0x01, 0x8D, 0x01, 0x81, 0x00,
+	0x85, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00,
+	0x81, 0x01, 0x81, 0x00, 0x89, 0x01, 0x81, 0x00, 0x8D, 0x01, 0x81, 0x00, 0xFF, 0x01, 0xA3, 0x01,
+	0x8D, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x87, 0x00,
+	0x83, 0x01, 0x81, 0x00, 0x83, 0x01, 0x83, 0x00, 0x81, 0x01, 0x87, 0x00, 0x87, 0x01, 0x81, 0x00,
+	0xFF, 0x01, 0xA3, 0x01, 0x8D, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00,
+	0x81, 0x01, 0x87, 0x00, 0x83, 0x01, 0x81, 0x00, 0x83, 0x01, 0x83, 0x00, 0x81, 0x01, 0x87, 0x00,
+	0x87, 0x01, 0x81, 0x00, 0xFF, 0x01, 0xA3, 0x01, 0x8D, 0x01, 0x81, 0x00, 0x85, 0x01, 0x89, 0x00,
+	0x81, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00,
+	0x81, 0x01, 0x81, 0x00, 0x8D, 0x01, 0x81, 0x00, 0xFF, 0x01, 0xA3, 0x01, 0x8D, 0x01, 0x81, 0x00,
+	0x85, 0x01, 0x89, 0x00, 0x81, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00,
+	0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0x8D, 0x01, 0x81, 0x00, 0xFF, 0x01, 0xA3, 0x01,
+	0x8D, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00,
+	0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x89, 0x00, 0x81, 0x01, 0x89, 0x00, 0x85, 0x01, 0x81, 0x00,
+	0x85, 0x01, 0x81, 0x00, 0xFF, 0x01, 0x9B, 0x01, 0x8D, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00,
+	0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x89, 0x00,
+	0x81, 0x01, 0x89, 0x00, 0x85, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0xFF, 0x01, 0x9B, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0x89, 0x01, 0x89, 0x00, 0x81, 0x01, 0x89, 0x00,
+	0x81, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0xFF, 0x01, 0xBF, 0x01,
+	0x89, 0x01, 0x89, 0x00, 0x81, 0x01, 0x89, 0x00, 0x81, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00,
+	0x81, 0x01, 0x81, 0x00, 0xFF, 0x01, 0xBF, 0x01, 0x89, 0x01, 0x81, 0x00, 0x89, 0x01, 0x81, 0x00,
+	0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x83, 0x00, 0x83, 0x01, 0x81, 0x00, 0xFF, 0x01, 0xC3, 0x01,
+	0x89, 0x01, 0x81, 0x00, 0x89, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x83, 0x00,
+	0x83, 0x01, 0x81, 0x00, 0xFF, 0x01, 0xC3, 0x01, 0x89, 0x01, 0x87, 0x00, 0x83, 0x01, 0x81, 0x00,
+	0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00,
+	0xFF, 0x01, 0xC3, 0x01, 0x89, 0x01, 0x87, 0x00, 0x83, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00,
+	0x81, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0xFF, 0x01, 0xC3, 0x01,
+	0x89, 0x01, 0x81, 0x00, 0x89, 0x01, 0x89, 0x00, 0x81, 0x01, 0x81, 0x00, 0x83, 0x01, 0x83, 0x00,
+	0xFF, 0x01, 0xC3, 0x01, 0x89, 0x01, 0x81, 0x00, 0x89, 0x01, 0x89, 0x00, 0x81, 0x01, 0x81, 0x00,
+	0x83, 0x01, 0x83, 0x00, 0xFF, 0x01, 0xC3, 0x01, 0x89, 0x01, 0x81, 0x00, 0x89, 0x01, 0x81, 0x00,
+	0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00,
+	0xFF, 0x01, 0xBF, 0x01, 0x89, 0x01, 0x81, 0x00, 0x89, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00,
+	0x81, 0x01, 0x81, 0x00, 0x85, 0x01, 0x81, 0x00, 0x81, 0x01, 0x81, 0x00, 0xFF, 0x01, 0xBF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+	0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01, 0xFF, 0x01, 0xEF, 0x01,
+};
+
+static const lcd_template_field_t dashboard_screen_fields[8] = {
+	{ 106, 26, NULL, 2, 0x0000, 0xFFFF },  /* temp */
+	{ 106, 42, NULL, 2, 0x0000, 0xFFFF },  /* hum */
+	{ 106, 58, NULL, 2, 0x0000, 0xFFFF },  /* press */
+	{ 106, 74, NULL, 2, 0x0000, 0xFFFF },  /* dew */
+	{ 106, 90, NULL, 2, 0x0000, 0xFFFF },  /* max_1h */
+	{ 106, 122, NULL, 2, 0x0000, 0xFFFF },  /* start */
+	{ 106, 138, NULL, 2, 0x0000, 0xFFFF },  /* target */
+	{ 106, 154, NULL, 2, 0x0000, 0xFFFF },  /* current */
+};
+
+const lcd_template_t dashboard_screen = {
+	{ 240, 320, SPRITE_RLE8, dashboard_screen_palette, dashboard_screen_data },
+	dashboard_screen_fields, 8
+};
@@ -0,0 +1,22 @@
+# Static screen of P3_Dashboard, see modules/lcd/lcd_template.h
+# Regenerate: modules/lcd/template_convert.py src/dashboard_screen.tpl -o src/dashboard_screen.c --header inc/dashboard_screen.h
+background WHITE
+
+label 1 2 BLACK WHITE "Temp:"
+label 2 2 BLACK WHITE "Hum:"
+label 3 2 BLACK WHITE "Pres:"
+label 4 2 BLACK WHITE "Dew:"
+label 5 2 BLACK WHITE "Max 1h:"
+label 7 2 BLACK WHITE "Start:"
+label 8 2 BLACK WHITE "Target:"
+label 9 2 BLACK WHITE "Fan:"
+
+# Values behind the 8 character labels: x = 10 + 8 * 6 * 2, y = line * 16 + 10
+field temp    106  26 2 BLACK WHITE
+field hum     106  42 2 BLACK WHITE
+field press   106  58 2 BLACK WHITE
+field dew     106  74 2 BLACK WHITE
+field max_1h  106  90 2 BLACK WHITE
+field start   106 122 2 BLACK WHITE
+field target  106 138 2 BLACK WHITE
+field current 106 154 2 BLACK WHITE
@@ -0,0 +1,641 @@
+/**
+ ******************************************************************************
+ * @file        main.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Dashboard application: temperature controlled fan and
+ *              weather station on one board.
+ *
+ * @details
+ * Combines P1_Fan_Control and P2_Weatherstation. The BME280 temperature
+ * sets the fan target RPM over a fan curve (fan_curve): off below the
+ * start temperature, MAIN_CURVE_MIN_RPM at the start, the maximum RPM of
+ * the parameter store MAIN_CURVE_SPAN_CENTI above it, with hysteresis
+ * and rate limit. Poti 1 moves the start temperature between
+ * MAIN_CURVE_START_MIN_CENTI and MAIN_CURVE_START_MAX_CENTI.
+ *
+ * Every path is asynchronous: the PI controller runs from TIM6, the
+ * potentiometers in ADC bursts by DMA, the sensor measures by itself in
+ * normal mode and its burst read runs by DMA, the LCD writes by DMA. The
+ * scheduler only polls the sensor, starts the potentiometer bursts,
+ * recomputes the fan curve and redraws changed digits, so the project
+ * also serves as reference for all modules running side by side.
+ *
+ * @resources
+ *  - ADC1, DMA2 Stream0 (potentiometers, powered per burst only)
+ *  - TIM2 (system timebase, tacho stamps)
+ *  - TIM9, TIM6 (fan PWM, PI control task)
+ *  - I2C1, DMA1 Stream0 (BME280)
+ *  - SPI5, DMA2 Stream4 (LCD)
+ *  - TIM13 (tickless idle wakeup)
+ *  - Flash sectors 22/23 (parameter store: PI gains, maximum RPM)
+ *  - USART1, DMA2 Stream7/Stream2 (env frames, UART_TELEMETRY_ENABLE only)
+ *  - SDIO, DMA2 Stream6 (long-term log, SDLOG_ENABLE only, 168 MHz for
+ *    the 48 MHz SDIO clock)
+ ******************************************************************************
+ */
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+
+#include "clock/clock.h"
+#include "lcd/lcd.h"
+#include "lcd/lcd_text_field.h"
+#include "lcd/lcd_template.h"
+#include "lcd/lcd_governor.h"
+#include "fmt/fmt.h"
+#include "fan/fan.h"
+#include "fan/fan_curve.h"
+#include "potis_dma/potis_dma.h"
+#include "env_sensor/env_sensor.h"
+#include "env_history/env_history.h"
+#include "env_derived/env_derived.h"
+#include "sched/sched.h"
+#include "idle/idle.h"
+#include "health/health.h"
+#include "params/params.h"
+#include "uart_telemetry/uart_telemetry.h"
+#include "datalog/datalog.h"
+#include "sdlog/sdlog.h"
+#include "irq/irq.h"
+#include "timebase/timebase.h"
+#include "deadline/deadline.h"
+#include "dvfs/dvfs.h"
+
+#include "dashboard_screen.h"
+
+/* Preprocessor Defines ---------------------------------------------------- */
+/**
+ * @brief Fan curve in 0.01 C: range of the start temperature (poti 1),
+ *        span from the start to the maximum RPM and hysteresis of
+ *        falling temperatures.
+ */
+#define MAIN_CURVE_START_MIN_CENTI  1500
+#define MAIN_CURVE_START_MAX_CENTI  3500
+#define MAIN_CURVE_SPAN_CENTI       1000
+#define MAIN_CURVE_HYST_CENTI       50
+
+/**
+ * @brief Target RPM at the start temperature (well above
+ *        FAN_STALL_MIN_RPM, the fan starts reliably).
+ */
+#define MAIN_CURVE_MIN_RPM          1000u
+
+/**
+ * @brief Rate limit of the fan target in RPM per second.
+ */
+#define MAIN_CURVE_RATE_RPM_S       500u
+
+/**
+ * @brief Period of the sensor task in ms (the sensor measures every
+ *        ~170 ms, the task only polls).
+ */
+#define MAIN_ENV_PERIOD_MS          20u
+
+/**
+ * @brief Period of the potentiometer bursts in ms: the knob only moves the
+ *        start temperature, ADC1 is powered ~1 ms of every period.
+ */
+#define MAIN_POTIS_PERIOD_MS        50u
+
+/**
+ * @brief Period of the parameter store task in ms.
+ */
+#define MAIN_PARAMS_PERIOD_MS       10u
+
+/**
+ * @brief Poll period of the display task in ms, the frame rate is set by
+ *        the governor (modules/lcd/lcd_governor.h).
+ */
+#define MAIN_DISPLAY_PERIOD_MS      5u
+
+/**
+ * @brief Width of a readout in pixels for the dirty area before it was
+ *        drawn once.
+ */
+#define MAIN_FIELD_DIRTY_WIDTH      96u
+
+/**
+ * @brief Height of the 5x5 library font per size step.
+ */
+#define MAIN_CHAR_HEIGHT            8u
+
+/**
+ * @brief Measurement window of the health monitor in ms.
+ */
+#define MAIN_HEALTH_PERIOD_MS       1000u
+
+/**
+ * @brief Period of the SD log write polling in ms.
+ */
+#define MAIN_SDLOG_WRITE_PERIOD_MS  10u
+
+/**
+ * @brief Deadline supervisor (DEADLINE_ENABLE): poll period of the window
+ *        in ms and execution budget of the sensor task in us.
+ */
+#define MAIN_DEADLINE_PERIOD_MS     10u
+#define MAIN_ENV_BUDGET_US          5000u
+
+/**
+ * @brief Priorities: the sensor path before the display, which runs when
+ *        nothing else does.
+ */
+#define MAIN_ENV_PRIORITY           SCHED_PRIORITY_HIGHEST
+#define MAIN_DISPLAY_PRIORITY       SCHED_PRIORITY_LOWEST
+
+/**
+ * @brief Text size and line of the health readout; labels and values are
+ *        placed by the screen template (src/dashboard_screen.tpl).
+ */
+#define MAIN_TEXT_SIZE              2u
+#define MAIN_LINE_HEALTH            11u
+
+/* Static Module Variables ------------------------------------------------- */
+/**
+ * @brief Start temperature of the fan curve in 0.01 C, set from the DMA
+ *        interrupt.
+ */
+static volatile int32_t g_i32_curve_start_centi = MAIN_CURVE_START_MIN_CENTI;
+
+/**
+ * @brief Fan curve relative to the start temperature; the target RPM is
+ *        left alone while g_u8_curve_valid is 0.
+ */
+static fan_curve_t g_fan_curve;
+static uint8_t     g_u8_curve_valid;
+
+/**
+ * @brief Last sample: 0.01 C, Pa, 0.001 %; valid once g_u8_sample_valid.
+ */
+static int32_t  g_i32_temp;
+static uint32_t g_u32_press;
+static uint32_t g_u32_hum;
+static uint8_t  g_u8_sample_valid;
+
+/**
+ * @brief Temperature series (1 h maximum) and its next sample time.
+ */
+static env_history_series_t g_temp_history;
+static uint32_t g_u32_history_tick;
+
+/**
+ * @brief Dew point and pressure trend.
+ */
+static env_derived_t g_derived;
+
+/**
+ * @brief Character buffer for LCD output.
+ */
+static char g_ch_lcd_buffer[32];
+
+/**
+ * @brief Readouts of the screen template, only changed digits are
+ *        redrawn.
+ */
+static lcd_text_field_t g_fields[DASHBOARD_SCREEN_FIELDS];
+
+/**
+ * @brief Values marked dirty for the governor, to mark each change once.
+ */
+static uint32_t g_u32_marked_target;
+static uint32_t g_u32_marked_rpm;
+static int32_t  g_i32_marked_start;
+
+/* Static Function Prototypes ---------------------------------------------- */
+static void main_poti_changed(uint8_t poti_num, uint32_t value);
+static void main_fan_curve_init(void);
+static HAL_StatusTypeDef main_fan_curve_build(uint32_t u32_max_rpm);
+static void main_env_sample(int32_t i32_temp, uint32_t u32_press, uint32_t u32_hum);
+static void main_show_fixed(uint8_t u8_field, int32_t i32_value, uint8_t u8_decimals, const char *unit);
+static void main_mark_field(uint8_t u8_field);
+static void main_env_task(void *context);
+static void main_display_task(void *context);
+static void main_params_task(void *context);
+static void main_potis_task(void *context);
+#if HEALTH_ENABLE
+static void main_health_task(void *context);
+#endif
+#if SDLOG_ENABLE
+static void main_sdlog_write_task(void *context);
+#endif
+#if DEADLINE_ENABLE
+static void main_deadline_init(uint8_t u8_env_task);
+static void main_deadline_task(void *context);
+#endif
+
+/* Public Functions -------------------------------------------------------- */
+/**
+ * @brief Main program entry point.
+ *
+ * @details
+ * Initializes all modules, starts the PI controller, the potentiometer
+ * sampling and the sensor in normal mode, then runs the scheduler: the
+ * sensor task sets the fan target from every new sample, the display
+ * task redraws changed readouts at the rate of the frame governor.
+ *
+ * @return int Program should never return.
+ */
+int main(void)
+{
+    uint8_t u8_env_task = 0u;
+
+    /* Initialize HAL */
+    HAL_Init();
+
+    /* Interrupt priorities of the system plan */
+    irq_init();
+
+#if SDLOG_ENABLE
+    /* SDIO needs 48 MHz from the PLL, only the 168 MHz profile has it */
+    clock_init(CLOCK_PROFILE_168MHZ);
+#else
+    /* Run from HSE + PLL at 180 MHz before any bus-clock dependent init */
+    clock_init(CLOCK_PROFILE_180MHZ);
+#endif
+
+    /* Microsecond timebase of all stamps, from here on */
+    (void)timebase_init();
+
+#if UART_TELEMETRY_ENABLE
+    /* Every sample as env frame on the ST-LINK virtual COM port, see uart_telemetry_decode.py */
+    uart_telemetry_init(UART_TELEMETRY_BAUD);
+#endif
+
+    /* Display: static labels from the flash template (src/dashboard_screen.tpl), the values as text fields */
+    lcd_init();
+    (void)lcd_template_show(&dashboard_screen, g_fields);
+
+    /* Frame rate from the CPU load and the changed readouts, all of them in the first frame */
+    lcd_governor_init();
+    for (uint8_t i = 0u; i < DASHBOARD_SCREEN_FIELDS; i++) {
+        main_mark_field(i);
+    }
+
+    /* Tuned gains and maximum RPM from flash, defaults otherwise */
+    params_init();
+    main_fan_curve_init();
+    fan_control_init();
+    potis_dma_init_mode(POTIS_DMA_MODE_BURST, 0);
+    potis_dma_set_change_callback(main_poti_changed, POTIS_DMA_DEFAULT_HYSTERESIS);
+    potis_dma_start();
+
+    /* PI controller runs from TIM6 at a fixed rate, fan off until the first sample */
+    fan_control_start(FAN_CONTROL_DEFAULT_RATE_HZ);
+
+    env_history_init(&g_temp_history);
+    env_derived_init(&g_derived, ENV_DERIVED_SEA_LEVEL_PA);
+    g_u32_history_tick = HAL_GetTick();
+
+    /* Sensor measures by itself every ~170 ms, the task reads on demand */
+    env_sensor_init();
+    env_sensor_start_normal(BME280_STANDBY_TIME_125_MS);
+    env_sensor_start_measurement();
+
+    /* Main loop: tasks only, sleeps in between without SysTick */
+    idle_init();
+    sched_init();
+    sched_add(main_env_task, NULL, MAIN_ENV_PERIOD_MS, MAIN_ENV_PRIORITY, &u8_env_task);
+    sched_add(main_display_task, NULL, MAIN_DISPLAY_PERIOD_MS, MAIN_DISPLAY_PRIORITY, NULL);
+    sched_add(main_params_task, NULL, MAIN_PARAMS_PERIOD_MS, MAIN_DISPLAY_PRIORITY, NULL);
+    sched_add(main_potis_task, NULL, MAIN_POTIS_PERIOD_MS, MAIN_DISPLAY_PRIORITY, NULL);
+#if HEALTH_ENABLE
+    /* CPU load, interrupt shares and stack headroom once per second */
+    health_init();
+    sched_add(main_health_task, NULL, MAIN_HEALTH_PERIOD_MS, MAIN_DISPLAY_PRIORITY, NULL);
+#endif
+#if SDLOG_ENABLE
+    /* Samples and fan RPM into SDLOG.BIN, see sdlog_tool.py */
+    if (sdlog_init() == HAL_OK) {
+        sched_add(main_sdlog_write_task, NULL, MAIN_SDLOG_WRITE_PERIOD_MS, MAIN_DISPLAY_PRIORITY, NULL);
+    }
+#endif
+#if DEADLINE_ENABLE
+    /* Control step and sensor task on time under the display load, else no watchdog refresh */
+    main_deadline_init(u8_env_task);
+#endif
+#if DVFS_ENABLE
+    /* Half clock between the display bursts, after all timers are set up */
+    (void)dvfs_init();
+#endif
+    sched_run();
+}
+
+/* Static Functions -------------------------------------------------------- */
+/**
+ * @brief Potentiometer change notification (DMA interrupt context): poti
+ *        1 moves the start temperature of the fan curve, applied with the
+ *        next sample.
+ *
+ * @param poti_num POTI_1 or POTI_2
+ * @param value    New filtered ADC value
+ */
+static void main_poti_changed(uint8_t poti_num, uint32_t value)
+{
+    if (poti_num == POTI_1) {
+        g_i32_curve_start_centi = MAIN_CURVE_START_MIN_CENTI +
+            (int32_t)((value * (uint32_t)(MAIN_CURVE_START_MAX_CENTI - MAIN_CURVE_START_MIN_CENTI)) /
+                      ADC_12_BIT_RESOLUTION);
+    }
+}
+
+/**
+ * @brief Fan curve up to the stored maximum RPM. A maximum the curve
+ *        rejects (above FAN_CURVE_MAX_RPM) falls back to FAN_MAX_RPM; if
+ *        that fails as well, curve control stays off.
+ */
+static void main_fan_curve_init(void)
+{
+    uint32_t u32_max_rpm = params_get_u32(PARAMS_KEY_FAN_MAX_RPM, FAN_MAX_RPM);
+
+    g_u8_curve_valid = 0u;
+    if ((main_fan_curve_build(u32_max_rpm) == HAL_OK) || (main_fan_curve_build(FAN_MAX_RPM) == HAL_OK)) {
+        g_u8_curve_valid = 1u;
+    }
+}
+
+/**
+ * @brief Fan curve relative to the start temperature: 0 RPM up to the
+ *        start, MAIN_CURVE_MIN_RPM just above it, the maximum RPM
+ *        MAIN_CURVE_SPAN_CENTI above it.
+ *
+ * @param u32_max_rpm RPM at the end of the curve
+ * @return Status of fan_curve_init()
+ */
+static HAL_StatusTypeDef main_fan_curve_build(uint32_t u32_max_rpm)
+{
+    fan_curve_point_t points[3] = {
+        { 0,                     0u                 },
+        { 1,                     MAIN_CURVE_MIN_RPM },
+        { MAIN_CURVE_SPAN_CENTI, u32_max_rpm        },
+    };
+
+    if (u32_max_rpm < MAIN_CURVE_MIN_RPM) {
+        points[1].u32_rpm = u32_max_rpm;
+    }
+    return fan_curve_init(&g_fan_curve, points, 3u, MAIN_CURVE_HYST_CENTI, MAIN_CURVE_RATE_RPM_S);
+}
+
+/**
+ * @brief Evaluates a new sample: fan target, derived values, history and
+ *        the optional logs.
+ *
+ * @param i32_temp  Temperature in 0.01 C
+ * @param u32_press Pressure in Pa
+ * @param u32_hum   Relative humidity in 0.001 %
+ */
+static void main_env_sample(int32_t i32_temp, uint32_t u32_press, uint32_t u32_hum)
+{
+    g_i32_temp  = i32_temp;
+    g_u32_press = u32_press;
+    g_u32_hum   = u32_hum;
+    g_u8_sample_valid = 1u;
+
+    main_mark_field(DASHBOARD_SCREEN_FIELD_TEMP);
+    main_mark_field(DASHBOARD_SCREEN_FIELD_HUM);
+    main_mark_field(DASHBOARD_SCREEN_FIELD_PRESS);
+    main_mark_field(DASHBOARD_SCREEN_FIELD_DEW);
+    main_mark_field(DASHBOARD_SCREEN_FIELD_MAX_1H);
+
+    if (g_u8_curve_valid) {
+        fan_curve_set_offset(&g_fan_curve, g_i32_curve_start_centi);
+        fan_change_target_rpm(fan_curve_evaluate(&g_fan_curve, i32_temp, HAL_GetTick()));
+    }
+    env_derived_update(&g_derived, i32_temp, u32_press, u32_hum);
+
+    /* One history value per ENV_HISTORY_SAMPLE_MS, the window lengths rely on it */
+    while ((HAL_GetTick() - g_u32_history_tick) >= ENV_HISTORY_SAMPLE_MS) {
+        g_u32_history_tick += ENV_HISTORY_SAMPLE_MS;
+        env_history_add(&g_temp_history, i32_temp);
+    }
+
+#if UART_TELEMETRY_ENABLE
+    uart_telemetry_send_env(i32_temp, u32_press, u32_hum);
+#endif
+
+#if SDLOG_ENABLE
+    /* Channel numbers of datalog.h, see sdlog_tool.py */
+    sdlog_add(DATALOG_CH_ENV_TEMP, i32_temp);
+    sdlog_add(DATALOG_CH_ENV_PRESS, (int32_t)u32_press);
+    sdlog_add(DATALOG_CH_ENV_HUM, (int32_t)u32_hum);
+    sdlog_add(DATALOG_CH_FAN_RPM, (int32_t)fan_get_last_rpm());
+#endif
+}
+
+/**
+ * @brief Shows a fixed-point value with unit in a text field.
+ *
+ * @param u8_field    Index into g_fields
+ * @param i32_value   Value in 10^-decimals
+ * @param u8_decimals Decimals
+ * @param unit        Unit text
+ */
+static void main_show_fixed(uint8_t u8_field, int32_t i32_value, uint8_t u8_decimals, const char *unit)
+{
+    fmt_t fmt;
+
+    fmt_init(&fmt, g_ch_lcd_buffer, sizeof(g_ch_lcd_buffer));
+    fmt_fixed(&fmt, i32_value, u8_decimals, 0u);
+    fmt_str(&fmt, unit);
+    lcd_text_field_update(&g_fields[u8_field], g_ch_lcd_buffer);
+}
+
+/**
+ * @brief Marks a readout dirty for the frame governor, its area from the
+ *        drawn string (MAIN_FIELD_DIRTY_WIDTH before the first draw).
+ *
+ * @param u8_field Index into g_fields
+ */
+static void main_mark_field(uint8_t u8_field)
+{
+    const lcd_text_field_t *field = &g_fields[u8_field];
+    uint16_t u16_width  = (field->u16_width > 0u) ? field->u16_width : MAIN_FIELD_DIRTY_WIDTH;
+    uint16_t u16_height = (field->font != NULL) ? field->font->Height : MAIN_CHAR_HEIGHT * field->u16_size;
+
+    lcd_governor_mark_dirty(u16_width, u16_height);
+}
+
+/**
+ * @brief Sensor task: reads a finished measurement and starts the next
+ *        burst read, never waits for the I2C DMA.
+ *
+ * @param context Unused
+ */
+static void main_env_task(void *context)
+{
+    int32_t  i32_temp;
+    uint32_t u32_press;
+    uint32_t u32_hum;
+
+    (void)context;
+
+    if (env_sensor_poll() == ENV_SENSOR_BUSY) {
+        return;
+    }
+
+    if (env_sensor_get_data_fixed(&i32_temp, &u32_press, &u32_hum) == HAL_OK) {
+        env_sensor_start_measurement();
+        main_env_sample(i32_temp, u32_press, u32_hum);
+    } else {
+        env_sensor_start_measurement();
+    }
+}
+
+/**
+ * @brief Display task: marks changed fan readouts, then draws sample,
+ *        derived values, fan curve and RPM when the governor has a frame
+ *        due.
+ *
+ * @param context Unused
+ */
+static void main_display_task(void *context)
+{
+    env_history_stats_t stats;
+    fmt_t fmt;
+
+    (void)context;
+
+    if (fan_get_target_rpm() != g_u32_marked_target) {
+        g_u32_marked_target = fan_get_target_rpm();
+        main_mark_field(DASHBOARD_SCREEN_FIELD_TARGET);
+    }
+    if (fan_get_last_rpm() != g_u32_marked_rpm) {
+        g_u32_marked_rpm = fan_get_last_rpm();
+        main_mark_field(DASHBOARD_SCREEN_FIELD_CURRENT);
+    }
+    if (g_i32_curve_start_centi != g_i32_marked_start) {
+        g_i32_marked_start = g_i32_curve_start_centi;
+        main_mark_field(DASHBOARD_SCREEN_FIELD_START);
+    }
+    if (!lcd_governor_begin()) {
+        return;
+    }
+
+    /* Rendering at the full clock */
+    dvfs_boost();
+
+    if (g_u8_sample_valid) {
+        /* Fixed point: 0.01 C, Pa (= 0.01 hPa), 0.001 % */
+        main_show_fixed(DASHBOARD_SCREEN_FIELD_TEMP, g_i32_temp, 2u, " C");
+        main_show_fixed(DASHBOARD_SCREEN_FIELD_HUM, (int32_t)(g_u32_hum / 10u), 2u, " %");
+        main_show_fixed(DASHBOARD_SCREEN_FIELD_PRESS, (int32_t)g_u32_press, 2u, " hPa");
+        main_show_fixed(DASHBOARD_SCREEN_FIELD_DEW, env_derived_get_dew_point(&g_derived), 2u, " C");
+
+        if (env_history_get_stats(&g_temp_history, ENV_HISTORY_WINDOW_1H, &stats) == HAL_OK) {
+            main_show_fixed(DASHBOARD_SCREEN_FIELD_MAX_1H, stats.max, 2u, " C");
+        }
+    }
+
+    main_show_fixed(DASHBOARD_SCREEN_FIELD_START, g_i32_curve_start_centi, 2u, " C");
+
+    fmt_init(&fmt, g_ch_lcd_buffer, sizeof(g_ch_lcd_buffer));
+    fmt_u32(&fmt, fan_get_target_rpm(), 0u, ' ');
+    lcd_text_field_update(&g_fields[DASHBOARD_SCREEN_FIELD_TARGET], g_ch_lcd_buffer);
+
+    fmt_init(&fmt, g_ch_lcd_buffer, sizeof(g_ch_lcd_buffer));
+    fmt_u32(&fmt, fan_get_last_rpm(), 0u, ' ');
+    lcd_text_field_update(&g_fields[DASHBOARD_SCREEN_FIELD_CURRENT], g_ch_lcd_buffer);
+
+    dvfs_release();
+    lcd_governor_end();
+}
+
+/**
+ * @brief Parameter store task: writes set values to flash, never waits
+ *        for an erase.
+ *
+ * @param context Unused
+ */
+static void main_params_task(void *context)
+{
+    (void)context;
+
+    params_task();
+}
+
+/**
+ * @brief Potentiometer task: starts the next burst, the change callback
+ *        follows from the DMA interrupt at its end.
+ *
+ * @param context Unused
+ */
+static void main_potis_task(void *context)
+{
+    (void)context;
+
+    (void)potis_dma_burst_trigger();
+}
+
+#if HEALTH_ENABLE
+/**
+ * @brief Health task: closes the measurement window, passes the load to
+ *        the frame governor and shows load and stack use.
+ *
+ * @param context Unused
+ */
+static void main_health_task(void *context)
+{
+    health_stats_t stats;
+
+    (void)context;
+
+    health_update();
+    health_get(&stats);
+    lcd_governor_set_load(stats.u16_load_permille);
+    health_lcd_line(MAIN_LINE_HEALTH, DARKGREY, MAIN_TEXT_SIZE, WHITE);
+}
+#endif
+
+#if SDLOG_ENABLE
+/**
+ * @brief SD log write task: starts the DMA write of a full buffer, never
+ *        waits for the card.
+ *
+ * @param context Unused
+ */
+static void main_sdlog_write_task(void *context)
+{
+    (void)context;
+
+    sdlog_task();
+}
+#endif
+
+#if DEADLINE_ENABLE
+/**
+ * @brief Supervises the control step (ends within its period, half of it
+ *        as budget) and the sensor task (ends within its period, at most
+ *        MAIN_ENV_BUDGET_US), then starts the watchdog.
+ *
+ * @param u8_env_task Scheduler id of the sensor task
+ */
+static void main_deadline_init(uint8_t u8_env_task)
+{
+    uint32_t u32_control_us = 1000000u / FAN_CONTROL_DEFAULT_RATE_HZ;
+    uint8_t u8_id;
+
+    deadline_init();
+    if (deadline_add(u32_control_us, u32_control_us, u32_control_us / 2u, &u8_id) == HAL_OK) {
+        fan_control_set_deadline(u8_id);
+    }
+    if (deadline_add(MAIN_ENV_PERIOD_MS * 1000u, MAIN_ENV_PERIOD_MS * 1000u, MAIN_ENV_BUDGET_US,
+                     &u8_id) == HAL_OK) {
+        (void)sched_set_deadline(u8_env_task, u8_id);
+    }
+    sched_add(main_deadline_task, NULL, MAIN_DEADLINE_PERIOD_MS, SCHED_PRIORITY_HIGHEST, NULL);
+    (void)deadline_watchdog_start();
+}
+
+/**
+ * @brief Deadline task: closes the supervision window (watchdog refresh).
+ *
+ * @param context Unused
+ */
+static void main_deadline_task(void *context)
+{
+    (void)context;
+
+    (void)deadline_poll();
+}
+#endif
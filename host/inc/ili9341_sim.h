@@ -0,0 +1,58 @@
+/**
+ ******************************************************************************
+ * @file        ili9341_sim.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Host simulation of the ILI9341 pixel path.
+ *
+ * @details
+ * Implements the driver functions used by the band renderer
+ * (ILI9341_Set_Address(), ILI9341_DMA_Transmit_Pixels(),
+ * ILI9341_DMA_Pending(), ILI9341_Get/Set_Rotation()) on a framebuffer in
+ * host memory. Pixels are
+ * written into the address window like the controller does: row by row,
+ * wrapping to the window start. The "DMA" completes immediately.
+ *
+ ******************************************************************************
+ */
+
+#ifndef HOST_ILI9341_SIM_H_
+#define HOST_ILI9341_SIM_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "lcd/ILI9341_STM32_Driver.h"
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Sets the simulated screen size (rotation) and clears the memory.
+ *
+ * @param u16_width  LCD_WIDTH, at most ILI9341_SCREEN_WIDTH
+ * @param u16_height LCD_HEIGHT, at most ILI9341_SCREEN_WIDTH
+ * @return None
+ */
+void ili9341_sim_init(uint16_t u16_width, uint16_t u16_height);
+
+/**
+ * @brief Returns the simulated display memory, LCD_WIDTH pixels per row.
+ *
+ * @return RGB565 pixels
+ */
+const uint16_t *ili9341_sim_get_buffer(void);
+
+/**
+ * @brief Returns the number of pixels written since ili9341_sim_init().
+ *
+ * @return Pixels
+ */
+uint32_t ili9341_sim_get_pixels(void);
+
+/**
+ * @brief Writes the display memory as binary PPM (P6) image.
+ *
+ * @param pch_path File name
+ * @return 0 on success, -1 if the file cannot be written
+ */
+int ili9341_sim_write_ppm(const char *pch_path);
+
+#endif /* HOST_ILI9341_SIM_H_ */
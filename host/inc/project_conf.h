@@ -0,0 +1,21 @@
+/**
+ ******************************************************************************
+ * @file        project_conf.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Module configuration of the host build.
+ *
+ * @details
+ * Counterpart of inc/project_conf.h of the projects, read through the
+ * stm32f4xx.h replacement and bme280_defs.h. Empty: the host build sets
+ * its variants on the command line (host/Makefile, e.g. BME280=32BIT), so
+ * every variant stays selectable without editing this file.
+ *
+ ******************************************************************************
+ */
+
+#ifndef PROJECT_CONF_H_
+#define PROJECT_CONF_H_
+
+#endif /* PROJECT_CONF_H_ */
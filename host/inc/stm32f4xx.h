@@ -0,0 +1,130 @@
+/**
+ ******************************************************************************
+ * @file        stm32f4xx.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Host replacement of the CMSIS device header.
+ *
+ * @details
+ * Found before the real device header by the host build (host/Makefile),
+ * so the pure-logic modules compile unchanged with the native compiler.
+ * Provides only what these modules use: the fixed width types, the HAL
+ * status and handle types that appear in their headers, and portable C
+ * versions of the Cortex-M4 intrinsics with the same results as the DSP
+ * instructions.
+ *
+ * Nothing that touches a peripheral is declared here: a module that needs
+ * more than this header does not belong to the host build.
+ *
+ ******************************************************************************
+ */
+
+#ifndef HOST_STM32F4XX_H_
+#define HOST_STM32F4XX_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "project_conf.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+#define __ALIGNED(x)    __attribute__((aligned(x)))
+#define __DMB()         __sync_synchronize()
+
+/**
+ * @brief Pin masks, only referenced by module header defines.
+ */
+#define GPIO_PIN_2      ((uint16_t)0x0004)
+#define GPIO_PIN_5      ((uint16_t)0x0020)
+#define GPIO_PIN_6      ((uint16_t)0x0040)
+#define GPIO_PIN_7      ((uint16_t)0x0080)
+#define GPIO_PIN_13     ((uint16_t)0x2000)
+
+/* Public Type Definitions ------------------------------------------------- */
+typedef enum {
+    HAL_OK      = 0x00U,
+    HAL_ERROR   = 0x01U,
+    HAL_BUSY    = 0x02U,
+    HAL_TIMEOUT = 0x03U
+} HAL_StatusTypeDef;
+
+/**
+ * @brief Opaque stand-ins for types named in module headers.
+ */
+typedef struct { volatile uint32_t BSRR; } GPIO_TypeDef;
+typedef struct { uint32_t u32_unused; } SPI_TypeDef;
+typedef struct { uint32_t u32_unused; } SPI_HandleTypeDef;
+typedef struct { uint32_t u32_unused; } DMA_HandleTypeDef;
+typedef int32_t IRQn_Type;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Saturating signed 32 bit addition (QADD).
+ */
+static inline int32_t __QADD(int32_t op1, int32_t op2)
+{
+    int64_t i64_sum = (int64_t)op1 + op2;
+
+    if (i64_sum > INT32_MAX) {
+        return INT32_MAX;
+    }
+    if (i64_sum < INT32_MIN) {
+        return INT32_MIN;
+    }
+    return (int32_t)i64_sum;
+}
+
+/**
+ * @brief Saturating signed 32 bit subtraction (QSUB).
+ */
+static inline int32_t __QSUB(int32_t op1, int32_t op2)
+{
+    int64_t i64_difference = (int64_t)op1 - op2;
+
+    if (i64_difference > INT32_MAX) {
+        return INT32_MAX;
+    }
+    if (i64_difference < INT32_MIN) {
+        return INT32_MIN;
+    }
+    return (int32_t)i64_difference;
+}
+
+/**
+ * @brief Two unsigned 16 bit additions, each lane wraps (UADD16).
+ */
+static inline uint32_t __UADD16(uint32_t op1, uint32_t op2)
+{
+    uint32_t u32_lo = (op1 + op2) & 0xFFFFu;
+    uint32_t u32_hi = ((op1 >> 16) + (op2 >> 16)) & 0xFFFFu;
+
+    return (u32_hi << 16) | u32_lo;
+}
+
+/**
+ * @brief Dual signed 16 x 16 multiply with 32 bit accumulate (SMLAD).
+ */
+static inline uint32_t __SMLAD(uint32_t op1, uint32_t op2, uint32_t op3)
+{
+    int32_t i32_lo = (int32_t)(int16_t)op1 * (int16_t)op2;
+    int32_t i32_hi = (int32_t)(int16_t)(op1 >> 16) * (int16_t)(op2 >> 16);
+
+    return op3 + (uint32_t)i32_lo + (uint32_t)i32_hi;
+}
+
+/**
+ * @brief Unaligned 32 bit load.
+ */
+static inline uint32_t host_unaligned_read32(const void *addr)
+{
+    uint32_t u32_value;
+
+    memcpy(&u32_value, addr, sizeof(u32_value));
+    return u32_value;
+}
+
+#define __UNALIGNED_UINT32_READ(addr)   host_unaligned_read32(addr)
+
+#endif /* HOST_STM32F4XX_H_ */
@@ -0,0 +1,22 @@
+/**
+ ******************************************************************************
+ * @file        stm32f4xx_hal.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Host replacement of the HAL umbrella header.
+ *
+ * @details
+ * The ILI9341 driver header includes the HAL; on the host everything it
+ * needs comes from the device header replacement.
+ *
+ ******************************************************************************
+ */
+
+#ifndef HOST_STM32F4XX_HAL_H_
+#define HOST_STM32F4XX_HAL_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+
+#endif /* HOST_STM32F4XX_HAL_H_ */
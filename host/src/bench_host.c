@@ -0,0 +1,791 @@
+/**
+ ******************************************************************************
+ * @file        bench_host.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Host regression benchmark of the pure-logic modules.
+ *
+ * @details
+ * Feeds a recorded trace through the modules that do not touch a
+ * peripheral and prints one line per benchmark: items, best time per
+ * item and a checksum over all outputs. The checksum changes when the
+ * behaviour changes, the time when the cost changes; compare the output
+ * of two commits with a diff.
+ *
+ * The trace is the CSV written by modules/trace/trace_decode.py
+ * (time_us,channel,field,value); the fan_rpm and potis channels are used.
+ * Without a file a synthetic trace is generated (fan step response with
+ * tacho glitches, potentiometer ramps with noise).
+ *
+ * Benchmarks:
+ *  - median: global filter, instance filter with 9 and 31 values and the
+ *    sorting network of 9 on the recorded RPM values
+ *  - fan_pi: Q16 and float controller step on recorded target / RPM
+ *  - potis_filter: decimation and FIR of one DMA half buffer per
+ *    recorded potentiometer pair (ADC noise added)
+ *  - bme280: compensation of a raw value sweep
+ *  - lcd_band: rendering of a status screen per recorded sample into the
+ *    simulated ILI9341 memory; --ppm writes the last frame
+ *
+ * Times are from the host CPU: they show relative changes, not target
+ * cycles (see B0_Benchmarks for those).
+ *
+ * Usage: bench_host [--reps n] [--ppm file] [trace.csv]
+ ******************************************************************************
+ */
+
+/* Includes ---------------------------------------------------------------- */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "median/median.h"
+#include "stats/stats.h"
+#include "fan/fan_pi.h"
+#include "potis_dma/potis_filter.h"
+#include "biquad/biquad.h"
+#include "bme280/bme280.h"
+#include "lcd/lcd_band.h"
+#include "colour/colour.h"
+#include "tscomp/tscomp.h"
+#include "ili9341_sim.h"
+
+/* Preprocessor Defines ---------------------------------------------------- */
+/**
+ * @brief Default number of timed passes over the trace, the best counts.
+ */
+#define HOST_DEFAULT_REPS       20u
+
+/**
+ * @brief Samples of the synthetic trace per channel (50 Hz control rate).
+ */
+#define HOST_SYNTH_SAMPLES      4000u
+
+/**
+ * @brief Fan control step as configured on the target.
+ */
+#define HOST_FAN_TA_S           0.02f
+#define HOST_FAN_KP             0.04f
+#define HOST_FAN_KI             0.03f
+#define HOST_FAN_FULL_COUNTS    1000
+#define HOST_FAN_KT_TA          1.0f    /* FAN_PI_TRACKING_TIME_S = Ta  */
+#define HOST_FAN_SLEW_PERCENT   8.0f    /* per step, 400 %/s            */
+
+/**
+ * @brief Peak to peak ADC noise added to the potentiometer samples.
+ */
+#define HOST_ADC_NOISE          24u
+
+/**
+ * @brief Raw values of the BME280 compensation sweep.
+ */
+#define HOST_BME280_SWEEP       4096u
+
+/**
+ * @brief Rendered frames at most, evenly spread over the trace.
+ */
+#define HOST_LCD_FRAMES         200u
+
+/**
+ * @brief Blended rows of 240 pixels per pass (ten screens).
+ */
+#define HOST_COLOUR_ROWS        3200u
+
+/**
+ * @brief Compressed block size (payload of an sdlog sector), control step
+ *        of the trace in ms.
+ */
+#define HOST_TSCOMP_BLOCK       504u
+#define HOST_TSCOMP_STEP_MS     20u
+
+/* Type Definitions -------------------------------------------------------- */
+typedef struct {
+    uint16_t u16_target;
+    uint16_t u16_rpm;
+} host_rpm_t;
+
+typedef struct {
+    uint16_t u16_poti_1;
+    uint16_t u16_poti_2;
+} host_poti_t;
+
+/**
+ * @brief One benchmark: one pass over the trace, returns the checksum.
+ */
+typedef struct {
+    const char *pch_name;
+    uint32_t  (*run)(void);
+    uint32_t  (*items)(void);
+} host_bench_t;
+
+/* Static Module Variables ------------------------------------------------- */
+static host_rpm_t  *g_host_rpm;
+static uint32_t     g_u32_host_rpm_count;
+static host_poti_t *g_host_poti;
+static uint32_t     g_u32_host_poti_count;
+
+/**
+ * @brief DMA half buffers built from the potentiometer trace.
+ */
+static potis_dma_sample_t *g_host_halves;
+
+static uint32_t g_u32_host_seed = 12345u;
+
+/**
+ * @brief Failed round trip checks, main returns 1 if any.
+ */
+static uint32_t g_u32_host_failures;
+
+/**
+ * @brief Calibration of the BME280 datasheet example (as B0_Benchmarks).
+ */
+static struct bme280_calib_data g_host_calib = {
+    .dig_t1 = 27504, .dig_t2 = 26435, .dig_t3 = -1000,
+    .dig_p1 = 36477, .dig_p2 = -10685, .dig_p3 = 3024, .dig_p4 = 2855,
+    .dig_p5 = 140, .dig_p6 = -7, .dig_p7 = 15500, .dig_p8 = -14600, .dig_p9 = 6000,
+    .dig_h1 = 75, .dig_h2 = 362, .dig_h3 = 0, .dig_h4 = 313, .dig_h5 = 50, .dig_h6 = 30
+};
+
+/* Function Prototypes ----------------------------------------------------- */
+static int host_load_csv(const char *pch_path);
+static void host_synthesize(void);
+static void host_build_halves(void);
+static uint32_t host_random(void);
+static uint32_t host_fnv(uint32_t u32_hash, uint32_t u32_value);
+static double host_now_ns(void);
+
+static uint32_t host_rpm_items(void);
+static uint32_t host_poti_items(void);
+static uint32_t host_bme280_items(void);
+static uint32_t host_lcd_items(void);
+static uint32_t host_colour_items(void);
+static uint32_t host_tscomp_items(void);
+
+static uint32_t host_median_global(void);
+static uint32_t host_median_9(void);
+static uint32_t host_median_31(void);
+static uint32_t host_median_network(void);
+static uint32_t host_stats(void);
+static uint32_t host_fan_pi_q16(void);
+static uint32_t host_fan_pi_float(void);
+static uint32_t host_potis_filter(void);
+static uint32_t host_biquad(void);
+static uint32_t host_bme280(void);
+static uint32_t host_lcd_band(void);
+static uint32_t host_colour_blend(void);
+static uint32_t host_colour_pair(void);
+static uint32_t host_tscomp(void);
+
+static const host_bench_t g_host_benches[] = {
+    { "median_global",  host_median_global,  host_rpm_items    },
+    { "median_9",       host_median_9,       host_rpm_items    },
+    { "median_31",      host_median_31,      host_rpm_items    },
+    { "median_net9",    host_median_network, host_rpm_items    },
+    { "stats_error",    host_stats,          host_rpm_items    },
+    { "fan_pi_q16",     host_fan_pi_q16,     host_rpm_items    },
+    { "fan_pi_float",   host_fan_pi_float,   host_rpm_items    },
+    { "potis_filter",   host_potis_filter,   host_poti_items   },
+    { "biquad_q31",     host_biquad,         host_poti_items   },
+    { "bme280_comp",    host_bme280,         host_bme280_items },
+    { "lcd_band",       host_lcd_band,       host_lcd_items    },
+    { "colour_blend",   host_colour_blend,   host_colour_items },
+    { "colour_pair",    host_colour_pair,    host_colour_items },
+    { "tscomp_rpm",     host_tscomp,         host_tscomp_items },
+};
+
+/* Main -------------------------------------------------------------------- */
+int main(int argc, char *argv[])
+{
+    const char *pch_trace = NULL;
+    const char *pch_ppm   = NULL;
+    uint32_t u32_reps     = HOST_DEFAULT_REPS;
+
+    for (int i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "--reps") == 0) && (i + 1 < argc)) {
+            u32_reps = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if ((strcmp(argv[i], "--ppm") == 0) && (i + 1 < argc)) {
+            pch_ppm = argv[++i];
+        } else if (argv[i][0] == '-') {
+            fprintf(stderr, "usage: %s [--reps n] [--ppm file] [trace.csv]\n", argv[0]);
+            return 2;
+        } else {
+            pch_trace = argv[i];
+        }
+    }
+    if (u32_reps == 0u) {
+        u32_reps = 1u;
+    }
+
+    if (pch_trace != NULL) {
+        if (host_load_csv(pch_trace) != 0) {
+            fprintf(stderr, "%s: cannot read %s\n", argv[0], pch_trace);
+            return 1;
+        }
+    }
+    if ((g_u32_host_rpm_count == 0u) || (g_u32_host_poti_count == 0u)) {
+        host_synthesize();
+    }
+    host_build_halves();
+
+    printf("trace: %s, %lu rpm, %lu potis samples\n",
+           (pch_trace != NULL) ? pch_trace : "synthetic",
+           (unsigned long)g_u32_host_rpm_count, (unsigned long)g_u32_host_poti_count);
+    printf("%-16s %8s %12s %10s\n", "bench", "items", "ns/item", "checksum");
+
+    for (size_t b = 0u; b < sizeof(g_host_benches) / sizeof(g_host_benches[0]); b++) {
+        const host_bench_t *bench = &g_host_benches[b];
+        uint32_t u32_items = bench->items();
+        uint32_t u32_checksum = 0u;
+        double   d_best = 0.0;
+
+        for (uint32_t rep = 0u; rep < u32_reps; rep++) {
+            double   d_start = host_now_ns();
+            uint32_t u32_sum = bench->run();
+            double   d_time  = host_now_ns() - d_start;
+
+            /* First pass only: global filter state carries over */
+            if (rep == 0u) {
+                u32_checksum = u32_sum;
+            }
+            if ((rep == 0u) || (d_time < d_best)) {
+                d_best = d_time;
+            }
+        }
+
+        printf("%-16s %8lu %12.1f 0x%08lx\n", bench->pch_name, (unsigned long)u32_items,
+               (u32_items > 0u) ? d_best / u32_items : 0.0, (unsigned long)u32_checksum);
+    }
+
+    if ((pch_ppm != NULL) && (ili9341_sim_write_ppm(pch_ppm) != 0)) {
+        fprintf(stderr, "%s: cannot write %s\n", argv[0], pch_ppm);
+        return 1;
+    }
+
+    free(g_host_rpm);
+    free(g_host_poti);
+    free(g_host_halves);
+
+    if (g_u32_host_failures != 0u) {
+        fprintf(stderr, "%s: %lu round trip mismatches\n", argv[0], (unsigned long)g_u32_host_failures);
+        return 1;
+    }
+    return 0;
+}
+
+/* Trace ------------------------------------------------------------------- */
+/**
+ * @brief Reads the fan_rpm and potis channels of a trace_decode.py CSV.
+ *        A packet is complete with its last field (rpm, poti_2).
+ *
+ * @param pch_path File name
+ * @return 0, -1 if the file cannot be opened
+ */
+static int host_load_csv(const char *pch_path)
+{
+    FILE *file = fopen(pch_path, "r");
+    char  line[128];
+    uint32_t u32_rpm_size = 0u, u32_poti_size = 0u;
+    host_rpm_t  rpm  = { 0u, 0u };
+    host_poti_t poti = { 0u, 0u };
+
+    if (file == NULL) {
+        return -1;
+    }
+
+    while (fgets(line, sizeof(line), file) != NULL) {
+        char channel[32], field[32];
+        unsigned long value;
+
+        if (sscanf(line, "%*[^,],%31[^,],%31[^,],%lu", channel, field, &value) != 3) {
+            continue;
+        }
+
+        if (strcmp(channel, "fan_rpm") == 0) {
+            if (strcmp(field, "target") == 0) {
+                rpm.u16_target = (uint16_t)value;
+                continue;
+            }
+            rpm.u16_rpm = (uint16_t)value;
+            if (g_u32_host_rpm_count == u32_rpm_size) {
+                u32_rpm_size = (u32_rpm_size == 0u) ? 1024u : 2u * u32_rpm_size;
+                g_host_rpm = realloc(g_host_rpm, u32_rpm_size * sizeof(*g_host_rpm));
+            }
+            g_host_rpm[g_u32_host_rpm_count++] = rpm;
+        } else if (strcmp(channel, "potis") == 0) {
+            if (strcmp(field, "poti_1") == 0) {
+                poti.u16_poti_1 = (uint16_t)value;
+                continue;
+            }
+            poti.u16_poti_2 = (uint16_t)value;
+            if (g_u32_host_poti_count == u32_poti_size) {
+                u32_poti_size = (u32_poti_size == 0u) ? 1024u : 2u * u32_poti_size;
+                g_host_poti = realloc(g_host_poti, u32_poti_size * sizeof(*g_host_poti));
+            }
+            g_host_poti[g_u32_host_poti_count++] = poti;
+        }
+    }
+
+    fclose(file);
+    return 0;
+}
+
+/**
+ * @brief Generates the channels missing in the trace.
+ */
+static void host_synthesize(void)
+{
+    if (g_u32_host_rpm_count == 0u) {
+        static const uint16_t u16_steps[] = { 1000u, 3000u, 2000u, 4500u, 0u, 2500u };
+        float f_rpm = 0.0f;
+
+        g_host_rpm = malloc(HOST_SYNTH_SAMPLES * sizeof(*g_host_rpm));
+        for (uint32_t i = 0u; i < HOST_SYNTH_SAMPLES; i++) {
+            uint16_t u16_target = u16_steps[(i * 6u) / HOST_SYNTH_SAMPLES];
+            int32_t  i32_rpm;
+
+            /* First order fan response, tacho jitter and single glitches */
+            f_rpm  += (u16_target - f_rpm) * 0.05f;
+            i32_rpm = (int32_t)f_rpm + (int32_t)(host_random() % 41u) - 20;
+            if ((host_random() % 50u) == 0u) {
+                i32_rpm *= 2;
+            }
+            g_host_rpm[i].u16_target = u16_target;
+            g_host_rpm[i].u16_rpm    = (uint16_t)((i32_rpm < 0) ? 0 : i32_rpm);
+        }
+        g_u32_host_rpm_count = HOST_SYNTH_SAMPLES;
+    }
+
+    if (g_u32_host_poti_count == 0u) {
+        g_host_poti = malloc(HOST_SYNTH_SAMPLES * sizeof(*g_host_poti));
+        for (uint32_t i = 0u; i < HOST_SYNTH_SAMPLES; i++) {
+            uint32_t u32_phase = (i * 8u) % 8192u;
+
+            /* Triangle on POTI_1, slower saw on POTI_2 */
+            g_host_poti[i].u16_poti_1 = (uint16_t)((u32_phase < 4096u) ? u32_phase : 8191u - u32_phase);
+            g_host_poti[i].u16_poti_2 = (uint16_t)((i * 3u) % 4096u);
+        }
+        g_u32_host_poti_count = HOST_SYNTH_SAMPLES;
+    }
+}
+
+/**
+ * @brief Expands every potentiometer pair to one interleaved DMA half
+ *        buffer with ADC noise, built once outside the timing.
+ */
+static void host_build_halves(void)
+{
+    g_host_halves = malloc((size_t)g_u32_host_poti_count * POTIS_DMA_SCANS_PER_HALF * 2u *
+                           sizeof(*g_host_halves));
+
+    for (uint32_t n = 0u; n < g_u32_host_poti_count; n++) {
+        potis_dma_sample_t *p_half = &g_host_halves[(size_t)n * POTIS_DMA_SCANS_PER_HALF * 2u];
+
+        for (uint32_t i = 0u; i < POTIS_DMA_SCANS_PER_HALF; i++) {
+            int32_t i32_p1 = g_host_poti[n].u16_poti_1 + (int32_t)(host_random() % HOST_ADC_NOISE) -
+                             (int32_t)(HOST_ADC_NOISE / 2u);
+            int32_t i32_p2 = g_host_poti[n].u16_poti_2 + (int32_t)(host_random() % HOST_ADC_NOISE) -
+                             (int32_t)(HOST_ADC_NOISE / 2u);
+
+            i32_p1 = (i32_p1 < 0) ? 0 : ((i32_p1 > ADC_12_BIT_RESOLUTION) ? ADC_12_BIT_RESOLUTION : i32_p1);
+            i32_p2 = (i32_p2 < 0) ? 0 : ((i32_p2 > ADC_12_BIT_RESOLUTION) ? ADC_12_BIT_RESOLUTION : i32_p2);
+            p_half[2u * i + POTI_1] = (potis_dma_sample_t)i32_p1;
+            p_half[2u * i + POTI_2] = (potis_dma_sample_t)i32_p2;
+        }
+    }
+}
+
+/* Benchmarks -------------------------------------------------------------- */
+static uint32_t host_rpm_items(void)
+{
+    return g_u32_host_rpm_count;
+}
+
+static uint32_t host_poti_items(void)
+{
+    return g_u32_host_poti_count;
+}
+
+static uint32_t host_bme280_items(void)
+{
+    return HOST_BME280_SWEEP;
+}
+
+static uint32_t host_lcd_items(void)
+{
+    return (g_u32_host_rpm_count < HOST_LCD_FRAMES) ? g_u32_host_rpm_count : HOST_LCD_FRAMES;
+}
+
+static uint32_t host_colour_items(void)
+{
+    return HOST_COLOUR_ROWS * ILI9341_SCREEN_WIDTH;
+}
+
+static uint32_t host_tscomp_items(void)
+{
+    return 2u * g_u32_host_rpm_count;
+}
+
+static uint32_t host_median_global(void)
+{
+    uint32_t u32_hash = 2166136261u;
+
+    for (uint32_t i = 0u; i < g_u32_host_rpm_count; i++) {
+        u32_hash = host_fnv(u32_hash, median_get_median(g_host_rpm[i].u16_rpm));
+    }
+    return u32_hash;
+}
+
+static uint32_t host_median_9(void)
+{
+    median_filter_t filter;
+    uint32_t u32_hash = 2166136261u;
+
+    median_filter_init(&filter, 9u, 0u);
+    for (uint32_t i = 0u; i < g_u32_host_rpm_count; i++) {
+        u32_hash = host_fnv(u32_hash, median_filter_update(&filter, g_host_rpm[i].u16_rpm));
+    }
+    return u32_hash;
+}
+
+static uint32_t host_median_31(void)
+{
+    median_filter_t filter;
+    uint32_t u32_hash = 2166136261u;
+
+    median_filter_init(&filter, 31u, 0u);
+    for (uint32_t i = 0u; i < g_u32_host_rpm_count; i++) {
+        u32_hash = host_fnv(u32_hash, median_filter_update(&filter, g_host_rpm[i].u16_rpm));
+    }
+    return u32_hash;
+}
+
+static uint32_t host_median_network(void)
+{
+    uint32_t u32_window[9] = { 0u };
+    uint32_t u32_hash = 2166136261u;
+
+    for (uint32_t i = 0u; i < g_u32_host_rpm_count; i++) {
+        u32_window[i % 9u] = g_host_rpm[i].u16_rpm;
+        u32_hash = host_fnv(u32_hash, median_network_9(u32_window));
+    }
+    return u32_hash;
+}
+
+static uint32_t host_stats(void)
+{
+    stats_welford_t error;
+    stats_p2_t p99;
+    stats_hist_t hist;
+    uint32_t u32_hash = 2166136261u;
+
+    stats_welford_reset(&error);
+    stats_p2_init(&p99, 0.99f);
+    (void)stats_hist_init(&hist, -400, 25u, 32u);
+    for (uint32_t i = 0u; i < g_u32_host_rpm_count; i++) {
+        int32_t i32_error = (int32_t)g_host_rpm[i].u16_target - (int32_t)g_host_rpm[i].u16_rpm;
+
+        stats_welford_add(&error, (float)i32_error);
+        stats_p2_add(&p99, (float)i32_error);
+        stats_hist_add(&hist, i32_error);
+        /* Whole RPM, exact float bits differ between compilers */
+        u32_hash = host_fnv(u32_hash, (uint32_t)(int32_t)stats_p2_get(&p99));
+    }
+    u32_hash = host_fnv(u32_hash, (uint32_t)(int32_t)stats_welford_get_stddev(&error));
+    u32_hash = host_fnv(u32_hash, (uint32_t)stats_hist_get_quantile(&hist, 500u));
+    return u32_hash;
+}
+
+static uint32_t host_fan_pi_q16(void)
+{
+    const float f_counts_per_percent = (float)HOST_FAN_FULL_COUNTS / 100.0f;
+    fan_pi_q16_t pi = {
+        .i32_kp_q16    = (int32_t)(HOST_FAN_KP * f_counts_per_percent * 65536.0f + 0.5f),
+        .i32_ki_ta_q16 = (int32_t)(HOST_FAN_KI * HOST_FAN_TA_S * f_counts_per_percent * 65536.0f + 0.5f),
+        .i32_kd_ta_q16 = 0,
+        .i32_kt_ta_q16 = (int32_t)(HOST_FAN_KT_TA * 65536.0f + 0.5f),
+        .i32_slew      = (int32_t)(HOST_FAN_SLEW_PERCENT * f_counts_per_percent + 0.5f),
+        .i32_full      = HOST_FAN_FULL_COUNTS
+    };
+    fan_pi_q16_state_t state = { 0 };
+    uint32_t u32_hash = 2166136261u;
+
+    for (uint32_t i = 0u; i < g_u32_host_rpm_count; i++) {
+        int32_t i32_output = fan_pi_step_q16(&state, &pi, (int32_t)g_host_rpm[i].u16_target,
+                                             (int32_t)g_host_rpm[i].u16_rpm, 0);
+        u32_hash = host_fnv(u32_hash, (uint32_t)i32_output);
+    }
+    return u32_hash;
+}
+
+static uint32_t host_fan_pi_float(void)
+{
+    const fan_pi_float_t pi = {
+        .f_kp    = HOST_FAN_KP,
+        .f_ki_ta = HOST_FAN_KI * HOST_FAN_TA_S,
+        .f_kd_ta = 0.0f,
+        .f_kt_ta = HOST_FAN_KT_TA,
+        .f_slew  = HOST_FAN_SLEW_PERCENT
+    };
+    fan_pi_float_state_t state = { 0 };
+    uint32_t u32_hash = 2166136261u;
+
+    for (uint32_t i = 0u; i < g_u32_host_rpm_count; i++) {
+        float f_output = fan_pi_step_float(&state, &pi, (float)g_host_rpm[i].u16_target,
+                                           (float)g_host_rpm[i].u16_rpm, 0.0f);
+        /* Compare in 0.01 % steps, exact float bits differ between compilers */
+        u32_hash = host_fnv(u32_hash, (uint32_t)(f_output * 100.0f + 0.5f));
+    }
+    return u32_hash;
+}
+
+static uint32_t host_potis_filter(void)
+{
+    potis_filter_t filter;
+    uint32_t u32_output[FILTERED_DATA_ARRAY_LENGTH];
+    uint32_t u32_hash = 2166136261u;
+
+    potis_filter_init(&filter);
+    for (uint32_t n = 0u; n < g_u32_host_poti_count; n++) {
+        potis_filter_half(&filter, &g_host_halves[(size_t)n * POTIS_DMA_SCANS_PER_HALF * 2u], u32_output);
+        u32_hash = host_fnv(u32_hash, u32_output[POTI_1]);
+        u32_hash = host_fnv(u32_hash, u32_output[POTI_2]);
+    }
+    return u32_hash;
+}
+
+static uint32_t host_biquad(void)
+{
+    biquad_coeffs_t coeffs[2];
+    biquad_q31_t filter;
+    int32_t i32_block[POTIS_DMA_SCANS_PER_HALF];
+    uint32_t u32_hash = 2166136261u;
+
+    /* Fourth order Butterworth, corner at one cycle per half buffer */
+    (void)biquad_design_butterworth(coeffs, 2u, 1.0f, (float)POTIS_DMA_SCANS_PER_HALF);
+    (void)biquad_q31_init(&filter, 2u, coeffs, 1u);
+    for (uint32_t n = 0u; n < g_u32_host_poti_count; n++) {
+        const potis_dma_sample_t *p_half = &g_host_halves[(size_t)n * POTIS_DMA_SCANS_PER_HALF * 2u];
+
+        /* Same scaling as potis_dma_set_biquad() */
+        for (uint32_t i = 0u; i < POTIS_DMA_SCANS_PER_HALF; i++) {
+            i32_block[i] = (int32_t)((uint32_t)p_half[2u * i + POTI_1] << POTIS_DMA_BIQUAD_SHIFT);
+        }
+        biquad_q31_process(&filter, i32_block, i32_block, POTIS_DMA_SCANS_PER_HALF);
+        u32_hash = host_fnv(u32_hash, (uint32_t)(i32_block[POTIS_DMA_SCANS_PER_HALF - 1u] >> POTIS_DMA_BIQUAD_SHIFT));
+    }
+    return u32_hash;
+}
+
+static uint32_t host_bme280(void)
+{
+    struct bme280_uncomp_data uncomp;
+    struct bme280_data data;
+    uint32_t u32_hash = 2166136261u;
+
+    for (uint32_t i = 0u; i < HOST_BME280_SWEEP; i++) {
+        /* Raw ranges around the datasheet example (about 0 .. 50 °C) */
+        uncomp.temperature = 480000u + i * 20u;
+        uncomp.pressure    = 380000u + i * 17u;
+        uncomp.humidity    = 20000u + i * 5u;
+
+        bme280_compensate_data(BME280_ALL, &uncomp, &data, &g_host_calib);
+        u32_hash = host_fnv(u32_hash, (uint32_t)data.temperature);
+        u32_hash = host_fnv(u32_hash, (uint32_t)data.pressure);
+        u32_hash = host_fnv(u32_hash, (uint32_t)data.humidity);
+    }
+    return u32_hash;
+}
+
+/**
+ * @brief Status screen of the fan application per frame: two text
+ *        lines with target and measured RPM, one bargraph per poti.
+ */
+static uint32_t host_lcd_band(void)
+{
+    uint32_t u32_frames = host_lcd_items();
+    uint32_t u32_hash = 2166136261u;
+
+    ili9341_sim_init(ILI9341_SCREEN_WIDTH, ILI9341_SCREEN_HEIGHT);
+
+    for (uint32_t f = 0u; f < u32_frames; f++) {
+        const host_rpm_t  *rpm  = &g_host_rpm[(f * g_u32_host_rpm_count) / u32_frames];
+        const host_poti_t *poti = &g_host_poti[(f * g_u32_host_poti_count) / u32_frames];
+        const uint16_t *pu16_memory;
+        char text[LCD_BAND_TEXT_LENGTH];
+
+        lcd_band_clear(WHITE);
+        lcd_band_add_rect(0u, 0u, ILI9341_SCREEN_WIDTH, 40u, NAVY);
+        lcd_band_add_text("FAN CONTROL", 10u, 10u, WHITE, 4u, NAVY);
+        snprintf(text, sizeof(text), "TAR: %-4u", (unsigned)rpm->u16_target);
+        lcd_band_add_text(text, 10u, 60u, BLACK, 3u, WHITE);
+        snprintf(text, sizeof(text), "IST: %-4u", (unsigned)rpm->u16_rpm);
+        lcd_band_add_text(text, 10u, 90u, BLACK, 3u, WHITE);
+        lcd_band_add_bargraph(10u, 150u, 300u, 20u,
+                              (uint16_t)(poti->u16_poti_1 * LCD_BAND_BARGRAPH_MAX / ADC_12_BIT_RESOLUTION),
+                              GREEN, LIGHTGREY);
+        lcd_band_add_bargraph(10u, 190u, 300u, 20u,
+                              (uint16_t)(poti->u16_poti_2 * LCD_BAND_BARGRAPH_MAX / ADC_12_BIT_RESOLUTION),
+                              ORANGE, LIGHTGREY);
+        lcd_band_render();
+
+        pu16_memory = ili9341_sim_get_buffer();
+        for (uint32_t i = 0u; i < (uint32_t)ILI9341_SCREEN_WIDTH * ILI9341_SCREEN_HEIGHT; i += 2u) {
+            u32_hash = host_fnv(u32_hash, pu16_memory[i] | ((uint32_t)pu16_memory[i + 1u] << 16));
+        }
+    }
+    return u32_hash;
+}
+
+/**
+ * @brief Gradient rows blended over a background row, alpha cycling
+ *        through all levels, one pixel per operation.
+ */
+static uint32_t host_colour_blend(void)
+{
+    uint16_t u16_src[ILI9341_SCREEN_WIDTH];
+    uint16_t u16_dst[ILI9341_SCREEN_WIDTH];
+    uint32_t u32_hash = 2166136261u;
+
+    colour_gradient(u16_src, NAVY, ORANGE, ILI9341_SCREEN_WIDTH);
+    colour_gradient(u16_dst, WHITE, DARKGREEN, ILI9341_SCREEN_WIDTH);
+    for (uint32_t r = 0u; r < HOST_COLOUR_ROWS; r++) {
+        for (uint32_t i = 0u; i < ILI9341_SCREEN_WIDTH; i++) {
+            u16_dst[i] = colour_blend(u16_src[(i + r) % ILI9341_SCREEN_WIDTH], u16_dst[i], r % (COLOUR_ALPHA_MAX + 1u));
+        }
+    }
+    for (uint32_t i = 0u; i < ILI9341_SCREEN_WIDTH; i += 2u) {
+        u32_hash = host_fnv(u32_hash, u16_dst[i] | ((uint32_t)u16_dst[i + 1u] << 16));
+    }
+    return u32_hash;
+}
+
+/**
+ * @brief The rows of host_colour_blend() two pixels per operation
+ *        (colour_blend_row()), same checksum.
+ */
+static uint32_t host_colour_pair(void)
+{
+    uint16_t u16_src[2u * ILI9341_SCREEN_WIDTH] __attribute__((aligned(4)));
+    uint16_t u16_dst[ILI9341_SCREEN_WIDTH] __attribute__((aligned(4)));
+    uint32_t u32_hash = 2166136261u;
+
+    colour_gradient(u16_src, NAVY, ORANGE, ILI9341_SCREEN_WIDTH);
+    memcpy(&u16_src[ILI9341_SCREEN_WIDTH], u16_src, sizeof(u16_dst));
+    colour_gradient(u16_dst, WHITE, DARKGREEN, ILI9341_SCREEN_WIDTH);
+    for (uint32_t r = 0u; r < HOST_COLOUR_ROWS; r++) {
+        uint32_t u32_shift = r % ILI9341_SCREEN_WIDTH;
+        uint32_t u32_alpha = r % (COLOUR_ALPHA_MAX + 1u);
+
+        /* Odd shifts: the first pixel alone, then aligned pairs */
+        if ((u32_shift & 1u) != 0u) {
+            u16_dst[0] = colour_blend(u16_src[u32_shift], u16_dst[0], u32_alpha);
+            colour_blend_row(&u16_dst[1], &u16_src[u32_shift + 1u], ILI9341_SCREEN_WIDTH - 1u, u32_alpha);
+        } else {
+            colour_blend_row(u16_dst, &u16_src[u32_shift], ILI9341_SCREEN_WIDTH, u32_alpha);
+        }
+    }
+    for (uint32_t i = 0u; i < ILI9341_SCREEN_WIDTH; i += 2u) {
+        u32_hash = host_fnv(u32_hash, u16_dst[i] | ((uint32_t)u16_dst[i + 1u] << 16));
+    }
+    return u32_hash;
+}
+
+/**
+ * @brief Packs target and speed of the trace into blocks like sdlog with
+ *        SDLOG_COMPRESS and decodes each block again; the hash covers the
+ *        decoded records and the block sizes. Every decoded record must
+ *        match its input, a mismatch counts as a failure.
+ */
+static uint32_t host_tscomp(void)
+{
+    uint8_t u8_block[HOST_TSCOMP_BLOCK];
+    uint32_t u32_hash = 2166136261u;
+    uint32_t u32_time = 0u;
+    uint32_t i = 0u;
+    tscomp_t enc;
+    tscomp_t dec;
+
+    while (i < g_u32_host_rpm_count) {
+        uint32_t u32_first = i;
+        uint32_t u32_first_time = u32_time;
+        uint32_t u32_record = 0u;
+        uint32_t u32_record_time;
+        uint16_t u16_channel;
+        int32_t i32_value;
+
+        (void)tscomp_encoder_init(&enc, u8_block, sizeof(u8_block));
+        for (; i < g_u32_host_rpm_count; i++, u32_time += HOST_TSCOMP_STEP_MS) {
+            /* Both records of a step go into the same block */
+            if (((uint32_t)enc.u16_size - enc.u16_pos < 2u * TSCOMP_RECORD_MAX) ||
+                (tscomp_encode(&enc, u32_time, 1u, g_host_rpm[i].u16_target) != HAL_OK) ||
+                (tscomp_encode(&enc, u32_time, 4u, g_host_rpm[i].u16_rpm) != HAL_OK)) {
+                break;
+            }
+        }
+        u32_hash = host_fnv(u32_hash, tscomp_encoder_finish(&enc));
+
+        (void)tscomp_decoder_init(&dec, u8_block, sizeof(u8_block));
+        while (tscomp_decode(&dec, &u32_record_time, &u16_channel, &i32_value) == HAL_OK) {
+            u32_hash = host_fnv(u32_hash, u32_record_time);
+            u32_hash = host_fnv(u32_hash, ((uint32_t)u16_channel << 16) ^ (uint32_t)i32_value);
+
+            /* Records alternate target (channel 1) and speed (channel 4) */
+            uint32_t u32_step = u32_first + u32_record / 2u;
+            uint32_t u32_expected_time = u32_first_time + (u32_record / 2u) * HOST_TSCOMP_STEP_MS;
+            uint16_t u16_expected_channel = ((u32_record & 1u) == 0u) ? 1u : 4u;
+            int32_t i32_expected = -1;
+
+            if (u32_step < i) {
+                i32_expected = (u16_expected_channel == 1u) ? g_host_rpm[u32_step].u16_target
+                                                            : g_host_rpm[u32_step].u16_rpm;
+            }
+            if ((u32_record_time != u32_expected_time) || (u16_channel != u16_expected_channel) ||
+                (i32_value != i32_expected)) {
+                fprintf(stderr, "tscomp: record %lu: %lu ms ch %u = %ld, expected %lu ms ch %u = %ld\n",
+                        (unsigned long)u32_record, (unsigned long)u32_record_time, (unsigned)u16_channel,
+                        (long)i32_value, (unsigned long)u32_expected_time, (unsigned)u16_expected_channel,
+                        (long)i32_expected);
+                g_u32_host_failures++;
+            }
+            u32_record++;
+        }
+        if (u32_record != 2u * (i - u32_first)) {
+            fprintf(stderr, "tscomp: block of steps %lu..%lu decoded %lu records, expected %lu\n",
+                    (unsigned long)u32_first, (unsigned long)i, (unsigned long)u32_record,
+                    (unsigned long)(2u * (i - u32_first)));
+            g_u32_host_failures++;
+        }
+    }
+    return u32_hash;
+}
+
+/* Helpers ----------------------------------------------------------------- */
+/**
+ * @brief Linear congruential generator, same sequence on every host.
+ */
+static uint32_t host_random(void)
+{
+    g_u32_host_seed = g_u32_host_seed * 1664525u + 1013904223u;
+    return g_u32_host_seed >> 8;
+}
+
+/**
+ * @brief FNV-1a over the four bytes of a value.
+ */
+static uint32_t host_fnv(uint32_t u32_hash, uint32_t u32_value)
+{
+    for (uint8_t i = 0u; i < 4u; i++) {
+        u32_hash = (u32_hash ^ ((u32_value >> (8u * i)) & 0xFFu)) * 16777619u;
+    }
+    return u32_hash;
+}
+
+static double host_now_ns(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec * 1e9 + (double)now.tv_nsec;
+}
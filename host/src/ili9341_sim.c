@@ -0,0 +1,120 @@
+/**
+ ******************************************************************************
+ * @file        ili9341_sim.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Host simulation of the ILI9341 pixel path
+ *
+ * Functionality:
+ * - Address window and write pointer as in the controller (RAMWR)
+ * - Repeated pixel blocks as sent by ILI9341_DMA_Transmit_Pixels()
+ *
+ * Resources:
+ * - Framebuffer in host memory
+ ******************************************************************************
+ */
+
+#include "ili9341_sim.h"
+#include <stdio.h>
+
+/* Static module variables -------------------------------------------------- */
+volatile uint16_t LCD_HEIGHT = ILI9341_SCREEN_HEIGHT;
+volatile uint16_t LCD_WIDTH  = ILI9341_SCREEN_WIDTH;
+
+static uint16_t g_u16_sim_memory[ILI9341_SCREEN_WIDTH * ILI9341_SCREEN_WIDTH];
+static uint16_t g_u16_sim_x1, g_u16_sim_y1, g_u16_sim_x2, g_u16_sim_y2;
+static uint16_t g_u16_sim_x, g_u16_sim_y;
+static uint32_t g_u32_sim_pixels;
+static uint8_t  g_u8_sim_rotation = SCREEN_HORIZONTAL_1;
+
+/* Public functions --------------------------------------------------------- */
+void ili9341_sim_init(uint16_t u16_width, uint16_t u16_height)
+{
+    LCD_WIDTH  = u16_width;
+    LCD_HEIGHT = u16_height;
+    g_u8_sim_rotation = (u16_width > u16_height) ? SCREEN_HORIZONTAL_1 : SCREEN_VERTICAL_1;
+    memset(g_u16_sim_memory, 0, sizeof(g_u16_sim_memory));
+    g_u32_sim_pixels = 0u;
+    ILI9341_Set_Address(0u, 0u, u16_width - 1u, u16_height - 1u);
+}
+
+const uint16_t *ili9341_sim_get_buffer(void)
+{
+    return g_u16_sim_memory;
+}
+
+uint32_t ili9341_sim_get_pixels(void)
+{
+    return g_u32_sim_pixels;
+}
+
+int ili9341_sim_write_ppm(const char *pch_path)
+{
+    FILE *file = fopen(pch_path, "wb");
+
+    if (file == NULL) {
+        return -1;
+    }
+
+    fprintf(file, "P6\n%u %u\n255\n", (unsigned)LCD_WIDTH, (unsigned)LCD_HEIGHT);
+    for (uint32_t i = 0u; i < (uint32_t)LCD_WIDTH * LCD_HEIGHT; i++) {
+        uint16_t u16_colour = g_u16_sim_memory[i];
+        uint8_t  u8_rgb[3];
+
+        u8_rgb[0] = (uint8_t)(((u16_colour >> 11) & 0x1Fu) << 3);
+        u8_rgb[1] = (uint8_t)(((u16_colour >> 5) & 0x3Fu) << 2);
+        u8_rgb[2] = (uint8_t)((u16_colour & 0x1Fu) << 3);
+        fwrite(u8_rgb, 1u, sizeof(u8_rgb), file);
+    }
+
+    return (fclose(file) == 0) ? 0 : -1;
+}
+
+/* Driver functions used by the modules ------------------------------------- */
+void ILI9341_Set_Address(uint16_t X1, uint16_t Y1, uint16_t X2, uint16_t Y2)
+{
+    g_u16_sim_x1 = X1;
+    g_u16_sim_y1 = Y1;
+    g_u16_sim_x2 = X2;
+    g_u16_sim_y2 = Y2;
+    g_u16_sim_x  = X1;
+    g_u16_sim_y  = Y1;
+}
+
+void ILI9341_DMA_Transmit_Pixels(const uint16_t *Pixels, uint16_t Count, uint16_t Repeat)
+{
+    for (uint16_t r = 0u; r < Repeat; r++) {
+        for (uint16_t i = 0u; i < Count; i++) {
+            if ((g_u16_sim_x < LCD_WIDTH) && (g_u16_sim_y < LCD_HEIGHT)) {
+                g_u16_sim_memory[(uint32_t)g_u16_sim_y * LCD_WIDTH + g_u16_sim_x] = Pixels[i];
+            }
+            g_u32_sim_pixels++;
+
+            if (g_u16_sim_x++ >= g_u16_sim_x2) {
+                g_u16_sim_x = g_u16_sim_x1;
+                if (g_u16_sim_y++ >= g_u16_sim_y2) {
+                    g_u16_sim_y = g_u16_sim_y1;
+                }
+            }
+        }
+    }
+}
+
+uint8_t ILI9341_DMA_Pending(void)
+{
+    return 0u;
+}
+
+uint8_t ILI9341_Get_Rotation(void)
+{
+    return g_u8_sim_rotation;
+}
+
+/* Only the screen size follows, the memory is kept in screen coordinates */
+void ILI9341_Set_Rotation(uint8_t Rotation)
+{
+    g_u8_sim_rotation = Rotation;
+    LCD_WIDTH  = (Rotation & 1u) ? ILI9341_SCREEN_WIDTH : ILI9341_SCREEN_HEIGHT;
+    LCD_HEIGHT = (Rotation & 1u) ? ILI9341_SCREEN_HEIGHT : ILI9341_SCREEN_WIDTH;
+}
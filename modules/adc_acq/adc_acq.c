@@ -0,0 +1,706 @@
+/**
+ ******************************************************************************
+ * @file        adc_acq.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Table driven multi-channel ADC acquisition engine.
+ *
+ * Functionality:
+ * - Builds the regular sequences of ADC1/2/3 from a channel table
+ * - Single, triple regular simultaneous and triple interleaved mode
+ * - Circular DMA into one buffer, de-interleaved by following NDTR
+ * - VREFINT, temperature sensor and VBAT as injected group of ADC1,
+ *   started once per period from adc_acq_process()
+ *
+ * Peripherals:
+ * - ADC1, ADC2, ADC3 (common CCR in triple modes)
+ * - ADC1 request of dma_alloc (DMA2 Stream0 Channel 0, ADC1 / common
+ *   data register)
+ ******************************************************************************
+ */
+
+#include "adc_acq.h"
+#include "adc_cal/adc_cal.h"
+#include "clock/clock.h"
+#include "dma_alloc/dma_alloc.h"
+#include "utils/utils.h"
+#include <string.h>
+
+/* Preprocessor Defines ----------------------------------------------------- */
+/**
+ * @brief Number of ADC instances.
+ */
+#define ADC_ACQ_ADC_COUNT       3U
+
+/**
+ * @brief Longest frame: 16 ranks on each of the three ADCs.
+ */
+#define ADC_ACQ_MAX_FRAME       (16U * ADC_ACQ_ADC_COUNT)
+
+/**
+ * @brief ADC1 channels of VREFINT and of the temperature sensor / VBAT.
+ */
+#define ADC_ACQ_VREFINT_CHANNEL 17U
+#define ADC_ACQ_TEMP_CHANNEL    18U
+
+/**
+ * @brief Factory temperature sensor values at 30 degC and 110 degC,
+ *        VDDA = 3.3 V.
+ */
+#define ADC_ACQ_TS_CAL1_ADDR    ((const uint16_t *)0x1FFF7A2CU)
+#define ADC_ACQ_TS_CAL2_ADDR    ((const uint16_t *)0x1FFF7A2EU)
+
+/**
+ * @brief Typical sensor without calibration values: 760 mV at 25 degC,
+ *        2.5 mV/degC (datasheet).
+ */
+#define ADC_ACQ_TS_V25_MV       760
+#define ADC_ACQ_TS_SLOPE_UV     2500
+
+/**
+ * @brief VBAT bridge divider of the STM32F42x.
+ */
+#define ADC_ACQ_VBAT_DIVIDER    4U
+
+/**
+ * @brief Filter of VREFINT and temperature: 1/2^shift of the new value,
+ *        kept in Q(shift).
+ */
+#define ADC_ACQ_INTERNAL_SHIFT  3U
+
+#if (ADC_ACQ_RING_LENGTH & (ADC_ACQ_RING_LENGTH - 1U)) != 0
+#error "ADC_ACQ_RING_LENGTH must be a power of two"
+#endif
+
+#if (ADC_ACQ_DMA_LENGTH % 6U) != 0
+#error "ADC_ACQ_DMA_LENGTH must be a multiple of 6 (word pairs of three ADCs)"
+#endif
+
+/* Static module variables -------------------------------------------------- */
+/**
+ * @brief ADC handles, index 0 = ADC1.
+ */
+static ADC_HandleTypeDef g_adc_acq_adc_handle_struct[ADC_ACQ_ADC_COUNT];
+
+/**
+ * @brief Handle of the ADC1 DMA stream.
+ */
+static DMA_HandleTypeDef g_adc_acq_dma_handle_struct;
+
+/**
+ * @brief Active configuration.
+ */
+static const adc_acq_channel_t *g_p_adc_acq_table = NULL;
+static uint8_t        g_u8_adc_acq_count = 0u;
+static adc_acq_mode_t g_adc_acq_mode     = ADC_ACQ_MODE_SINGLE;
+
+/**
+ * @brief Table index of every sample position within one frame.
+ */
+static uint8_t  g_u8_adc_acq_slot[ADC_ACQ_MAX_FRAME];
+static uint8_t  g_u8_adc_acq_frame_length = 0u;
+static uint8_t  g_u8_adc_acq_frame_pos    = 0u;
+
+/**
+ * @brief Circular DMA buffer, read as halfwords in every mode (not
+ *        cleared at startup, only read behind the DMA).
+ */
+static __ALIGNED(4) uint16_t g_u16_adc_acq_dma[ADC_ACQ_DMA_LENGTH] UTILS_NOINIT;
+
+/**
+ * @brief Next halfword of the DMA buffer to process.
+ */
+static uint32_t g_u32_adc_acq_read_pos = 0u;
+
+/**
+ * @brief Per-channel ring buffers with free running write/read counters
+ *        (not cleared at startup, only read between the counters).
+ */
+static uint16_t g_u16_adc_acq_ring[ADC_ACQ_MAX_CHANNELS][ADC_ACQ_RING_LENGTH] UTILS_NOINIT;
+static uint32_t g_u32_adc_acq_ring_head[ADC_ACQ_MAX_CHANNELS];
+static uint32_t g_u32_adc_acq_ring_tail[ADC_ACQ_MAX_CHANNELS];
+
+/**
+ * @brief Internal channel rounds: period and VBAT cadence (0: off), start
+ *        of the last round, round in flight (1: temperature, 2: VBAT).
+ */
+static uint16_t g_u16_adc_acq_internal_period = 0u;
+static uint8_t  g_u8_adc_acq_internal_vbat_every = 0u;
+static uint32_t g_u32_adc_acq_internal_tick = 0u;
+static uint8_t  g_u8_adc_acq_internal_round = 0u;
+
+/**
+ * @brief Filtered VREFINT and temperature in Q(ADC_ACQ_INTERNAL_SHIFT),
+ *        values of the last round.
+ */
+static uint32_t g_u32_adc_acq_vrefint_filt = 0u;
+static uint32_t g_u32_adc_acq_temp_filt    = 0u;
+static adc_acq_internal_t g_adc_acq_internal;
+
+/* Static function prototypes ----------------------------------------------- */
+static int8_t adc_acq_adc_index(const ADC_TypeDef *instance);
+static HAL_StatusTypeDef adc_acq_build_slots(void);
+static void adc_acq_gpio_init(void);
+static HAL_StatusTypeDef adc_acq_dma_init(uint8_t word_transfers);
+static HAL_StatusTypeDef adc_acq_adc_init(uint8_t adc, uint8_t ranks);
+static void adc_acq_internal_poll(void);
+static void adc_acq_internal_update(uint16_t u16_vrefint, uint16_t u16_ch18, uint8_t u8_vbat);
+
+/* Public functions --------------------------------------------------------- */
+HAL_StatusTypeDef adc_acq_init(const adc_acq_channel_t *table, uint8_t count,
+                               adc_acq_mode_t mode)
+{
+    uint8_t u8_ranks[ADC_ACQ_ADC_COUNT] = {0u, 0u, 0u};
+
+    if ((table == NULL) || (count == 0u) || (count > ADC_ACQ_MAX_CHANNELS)) {
+        return HAL_ERROR;
+    }
+
+    g_p_adc_acq_table  = table;
+    g_u8_adc_acq_count = count;
+    g_adc_acq_mode     = mode;
+
+    if (adc_acq_build_slots() != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    for (uint8_t i = 0u; i < count; i++) {
+        u8_ranks[adc_acq_adc_index(table[i].instance)]++;
+    }
+
+    adc_acq_gpio_init();
+    if (adc_acq_dma_init(mode == ADC_ACQ_MODE_INTERLEAVED) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    __HAL_RCC_ADC1_CLK_ENABLE();
+    if (mode != ADC_ACQ_MODE_SINGLE) {
+        __HAL_RCC_ADC2_CLK_ENABLE();
+        __HAL_RCC_ADC3_CLK_ENABLE();
+    }
+
+    if (mode == ADC_ACQ_MODE_INTERLEAVED) {
+        /* All three ADCs convert the single table channel */
+        u8_ranks[0] = u8_ranks[1] = u8_ranks[2] = 1u;
+    }
+
+    for (uint8_t adc = 0u; adc < ((mode == ADC_ACQ_MODE_SINGLE) ? 1u : ADC_ACQ_ADC_COUNT); adc++) {
+        if (adc_acq_adc_init(adc, u8_ranks[adc]) != HAL_OK) {
+            return HAL_ERROR;
+        }
+    }
+
+    if (mode != ADC_ACQ_MODE_SINGLE) {
+        ADC_MultiModeTypeDef multimode_struct;
+
+        multimode_struct.Mode             = (mode == ADC_ACQ_MODE_SIMULTANEOUS) ? ADC_TRIPLEMODE_REGSIMULT
+                                                                                : ADC_TRIPLEMODE_INTERL;
+        /* Mode 1: one halfword per ADC in order 1, 2, 3.
+         * Mode 2: halfword pairs 2&1, 1&3, 3&2, which is chronological in
+         * memory for interleaved conversions. */
+        multimode_struct.DMAAccessMode    = (mode == ADC_ACQ_MODE_SIMULTANEOUS) ? ADC_DMAACCESSMODE_1
+                                                                                : ADC_DMAACCESSMODE_2;
+        multimode_struct.TwoSamplingDelay = ADC_TWOSAMPLINGDELAY_5CYCLES;
+
+        if (HAL_ADCEx_MultiModeConfigChannel(&g_adc_acq_adc_handle_struct[0], &multimode_struct) != HAL_OK) {
+            return HAL_ERROR;
+        }
+    }
+
+    for (uint8_t i = 0u; i < ADC_ACQ_MAX_CHANNELS; i++) {
+        g_u32_adc_acq_ring_head[i] = 0u;
+        g_u32_adc_acq_ring_tail[i] = 0u;
+    }
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef adc_acq_start(void)
+{
+    g_u32_adc_acq_read_pos  = 0u;
+    g_u8_adc_acq_frame_pos  = 0u;
+
+    if (g_adc_acq_mode == ADC_ACQ_MODE_SINGLE) {
+        return HAL_ADC_Start_DMA(&g_adc_acq_adc_handle_struct[0],
+                                 (uint32_t *)g_u16_adc_acq_dma, ADC_ACQ_DMA_LENGTH);
+    }
+
+    /* Slaves first, the master start triggers all three */
+    HAL_ADC_Start(&g_adc_acq_adc_handle_struct[2]);
+    HAL_ADC_Start(&g_adc_acq_adc_handle_struct[1]);
+
+    return HAL_ADCEx_MultiModeStart_DMA(&g_adc_acq_adc_handle_struct[0], (uint32_t *)g_u16_adc_acq_dma,
+                                        (g_adc_acq_mode == ADC_ACQ_MODE_INTERLEAVED) ? ADC_ACQ_DMA_LENGTH / 2u
+                                                                                     : ADC_ACQ_DMA_LENGTH);
+}
+
+void adc_acq_stop(void)
+{
+    /* A round in flight is lost with the ADC */
+    if (g_u8_adc_acq_internal_round != 0u) {
+        g_u8_adc_acq_internal_round = 0u;
+        ADC->CCR &= ~ADC_CCR_VBATE;
+    }
+
+    if (g_adc_acq_mode == ADC_ACQ_MODE_SINGLE) {
+        HAL_ADC_Stop_DMA(&g_adc_acq_adc_handle_struct[0]);
+        return;
+    }
+
+    HAL_ADCEx_MultiModeStop_DMA(&g_adc_acq_adc_handle_struct[0]);
+    HAL_ADC_Stop(&g_adc_acq_adc_handle_struct[1]);
+    HAL_ADC_Stop(&g_adc_acq_adc_handle_struct[2]);
+}
+
+uint32_t adc_acq_process(void)
+{
+    uint32_t u32_remaining = __HAL_DMA_GET_COUNTER(&g_adc_acq_dma_handle_struct);
+    uint32_t u32_write_pos;
+    uint32_t u32_count = 0u;
+
+    /* NDTR counts words in interleaved mode */
+    if (g_adc_acq_mode == ADC_ACQ_MODE_INTERLEAVED) {
+        u32_remaining *= 2u;
+    }
+    u32_write_pos = (ADC_ACQ_DMA_LENGTH - u32_remaining) % ADC_ACQ_DMA_LENGTH;
+
+    while (g_u32_adc_acq_read_pos != u32_write_pos) {
+        uint8_t  u8_index = g_u8_adc_acq_slot[g_u8_adc_acq_frame_pos];
+        uint32_t u32_head = g_u32_adc_acq_ring_head[u8_index];
+
+        g_u16_adc_acq_ring[u8_index][u32_head & (ADC_ACQ_RING_LENGTH - 1u)] =
+            g_u16_adc_acq_dma[g_u32_adc_acq_read_pos];
+        g_u32_adc_acq_ring_head[u8_index] = u32_head + 1u;
+
+        if (++g_u8_adc_acq_frame_pos >= g_u8_adc_acq_frame_length) {
+            g_u8_adc_acq_frame_pos = 0u;
+        }
+        if (++g_u32_adc_acq_read_pos >= ADC_ACQ_DMA_LENGTH) {
+            g_u32_adc_acq_read_pos = 0u;
+        }
+        u32_count++;
+    }
+
+    if (g_u16_adc_acq_internal_period != 0u) {
+        adc_acq_internal_poll();
+    }
+
+    return u32_count;
+}
+
+uint16_t adc_acq_latest(uint8_t index)
+{
+    if ((index >= g_u8_adc_acq_count) || (g_u32_adc_acq_ring_head[index] == 0u)) {
+        return 0u;
+    }
+
+    return g_u16_adc_acq_ring[index][(g_u32_adc_acq_ring_head[index] - 1u) & (ADC_ACQ_RING_LENGTH - 1u)];
+}
+
+uint16_t adc_acq_available(uint8_t index)
+{
+    uint32_t u32_count;
+
+    if (index >= g_u8_adc_acq_count) {
+        return 0u;
+    }
+
+    u32_count = g_u32_adc_acq_ring_head[index] - g_u32_adc_acq_ring_tail[index];
+    return (u32_count > ADC_ACQ_RING_LENGTH) ? ADC_ACQ_RING_LENGTH : (uint16_t)u32_count;
+}
+
+uint16_t adc_acq_read(uint8_t index, uint16_t *dst, uint16_t max)
+{
+    uint16_t u16_count = adc_acq_available(index);
+    uint32_t u32_tail;
+
+    if (u16_count == 0u) {
+        return 0u;
+    }
+
+    /* Skip samples that were already overwritten */
+    u32_tail = g_u32_adc_acq_ring_head[index] - u16_count;
+    if (u16_count > max) {
+        u16_count = max;
+    }
+
+    for (uint16_t i = 0u; i < u16_count; i++) {
+        dst[i] = g_u16_adc_acq_ring[index][(u32_tail + i) & (ADC_ACQ_RING_LENGTH - 1u)];
+    }
+    g_u32_adc_acq_ring_tail[index] = u32_tail + u16_count;
+
+    return u16_count;
+}
+
+HAL_StatusTypeDef adc_acq_internal_init(uint16_t u16_period_ms, uint8_t u8_vbat_every)
+{
+    ADC_TypeDef *adc = ADC1;
+
+    if ((g_p_adc_acq_table == NULL) || (g_adc_acq_mode != ADC_ACQ_MODE_SINGLE)) {
+        return HAL_ERROR;
+    }
+
+    /* Both channels >= 10 us sampling (480 cycles). JL = 1: the two
+     * conversions are taken from JSQ3 and JSQ4 into JDR1 and JDR2, which
+     * needs the scan mode (no effect on a one rank regular sequence). */
+    ADC->CCR   = (ADC->CCR & ~ADC_CCR_VBATE) | ADC_CCR_TSVREFE;
+    adc->SMPR1 |= ADC_SMPR1_SMP17 | ADC_SMPR1_SMP18;
+    adc->JSQR   = (1u << ADC_JSQR_JL_Pos) |
+                  (ADC_ACQ_VREFINT_CHANNEL << ADC_JSQR_JSQ3_Pos) |
+                  (ADC_ACQ_TEMP_CHANNEL << ADC_JSQR_JSQ4_Pos);
+    adc->CR1   |= ADC_CR1_SCAN;
+    adc->SR     = ~(uint32_t)ADC_SR_JEOC;
+
+    memset(&g_adc_acq_internal, 0, sizeof(g_adc_acq_internal));
+    g_u32_adc_acq_vrefint_filt = 0u;
+    g_u32_adc_acq_temp_filt    = 0u;
+    g_u8_adc_acq_internal_round      = 0u;
+    g_u8_adc_acq_internal_vbat_every = u8_vbat_every;
+    /* First round one period later: sensor start-up (10 us) long over */
+    g_u32_adc_acq_internal_tick   = HAL_GetTick();
+    g_u16_adc_acq_internal_period = (u16_period_ms != 0u) ? u16_period_ms
+                                                          : (uint16_t)ADC_ACQ_INTERNAL_PERIOD_MS;
+
+    return HAL_OK;
+}
+
+void adc_acq_internal_deinit(void)
+{
+    g_u16_adc_acq_internal_period = 0u;
+    g_u8_adc_acq_internal_round   = 0u;
+    ADC->CCR &= ~ADC_CCR_VBATE;
+}
+
+HAL_StatusTypeDef adc_acq_internal_get(adc_acq_internal_t *internal)
+{
+    if (g_adc_acq_internal.u32_rounds == 0u) {
+        return HAL_BUSY;
+    }
+
+    *internal = g_adc_acq_internal;
+    return HAL_OK;
+}
+
+/* Static functions --------------------------------------------------------- */
+/**
+ * @brief Collects a finished internal round and starts the next one once
+ *        the period has passed (software trigger of the injected group,
+ *        the regular scan continues).
+ */
+static void adc_acq_internal_poll(void)
+{
+    ADC_TypeDef *adc = ADC1;
+
+    if (g_u8_adc_acq_internal_round != 0u) {
+        if ((adc->SR & ADC_SR_JEOC) == 0u) {
+            return;
+        }
+        adc->SR = ~(uint32_t)ADC_SR_JEOC;
+        ADC->CCR &= ~ADC_CCR_VBATE;
+        adc_acq_internal_update((uint16_t)adc->JDR1, (uint16_t)adc->JDR2, g_u8_adc_acq_internal_round == 2u);
+        g_u8_adc_acq_internal_round = 0u;
+    }
+
+    if (((adc->CR2 & ADC_CR2_ADON) == 0u) ||
+        ((HAL_GetTick() - g_u32_adc_acq_internal_tick) < g_u16_adc_acq_internal_period)) {
+        return;
+    }
+    g_u32_adc_acq_internal_tick += g_u16_adc_acq_internal_period;
+    if ((HAL_GetTick() - g_u32_adc_acq_internal_tick) >= g_u16_adc_acq_internal_period) {
+        /* Stopped or not polled for a while: no burst of late rounds */
+        g_u32_adc_acq_internal_tick = HAL_GetTick();
+    }
+
+    /* Channel 18 converts VBAT instead of the temperature sensor while
+     * VBATE is set, VREFINT comes first and gives the bridge time */
+    g_u8_adc_acq_internal_round = 1u;
+    if ((g_u8_adc_acq_internal_vbat_every != 0u) &&
+        ((g_adc_acq_internal.u32_rounds % g_u8_adc_acq_internal_vbat_every) ==
+         (uint32_t)(g_u8_adc_acq_internal_vbat_every - 1u))) {
+        ADC->CCR |= ADC_CCR_VBATE;
+        g_u8_adc_acq_internal_round = 2u;
+    }
+    adc->CR2 |= ADC_CR2_JSWSTART;
+}
+
+/**
+ * @brief Converts one internal round: VDDA from VREFINT (also handed to
+ *        adc_cal), temperature from the factory points scaled to the real
+ *        VDDA, VBAT through the bridge divider.
+ *
+ * @param u16_vrefint Raw VREFINT
+ * @param u16_ch18    Raw temperature sensor or VBAT
+ * @param u8_vbat     1 if u16_ch18 is VBAT
+ */
+static void adc_acq_internal_update(uint16_t u16_vrefint, uint16_t u16_ch18, uint8_t u8_vbat)
+{
+    adc_acq_internal_t *internal = &g_adc_acq_internal;
+    uint32_t u32_cal  = *ADC_CAL_VREFINT_CAL_ADDR;
+    int32_t  i32_cal1 = (int32_t)*ADC_ACQ_TS_CAL1_ADDR;
+    int32_t  i32_cal2 = (int32_t)*ADC_ACQ_TS_CAL2_ADDR;
+    uint32_t u32_vref;
+
+    if (u16_vrefint == 0u) {
+        return;
+    }
+
+    /* Seeded by the first round, then 1/8 of every new value */
+    if (internal->u32_rounds == 0u) {
+        g_u32_adc_acq_vrefint_filt = (uint32_t)u16_vrefint << ADC_ACQ_INTERNAL_SHIFT;
+    } else {
+        g_u32_adc_acq_vrefint_filt -= g_u32_adc_acq_vrefint_filt >> ADC_ACQ_INTERNAL_SHIFT;
+        g_u32_adc_acq_vrefint_filt += u16_vrefint;
+    }
+    internal->u16_vrefint_raw = u16_vrefint;
+    u32_vref = g_u32_adc_acq_vrefint_filt;
+
+    if ((u32_cal != 0u) && (u32_cal != 0xFFFFu)) {
+        /* VDDA = 3300 mV * CAL / VREFINT, rounded */
+        internal->u32_vdda_mv = ((ADC_CAL_VREFINT_CAL_MV * u32_cal << ADC_ACQ_INTERNAL_SHIFT) + u32_vref / 2u) /
+                                u32_vref;
+        adc_cal_set_vdda_mv(internal->u32_vdda_mv);
+    } else {
+        internal->u32_vdda_mv = ADC_CAL_VREFINT_CAL_MV;
+    }
+
+    if (u8_vbat) {
+        internal->u16_vbat_raw = u16_ch18;
+        internal->u32_vbat_mv  = ((uint32_t)u16_ch18 * internal->u32_vdda_mv * ADC_ACQ_VBAT_DIVIDER +
+                                  ADC_CAL_FULL_SCALE / 2u) / ADC_CAL_FULL_SCALE;
+    } else {
+        int64_t i64_raw;
+
+        if (g_u32_adc_acq_temp_filt == 0u) {
+            g_u32_adc_acq_temp_filt = (uint32_t)u16_ch18 << ADC_ACQ_INTERNAL_SHIFT;
+        } else {
+            g_u32_adc_acq_temp_filt -= g_u32_adc_acq_temp_filt >> ADC_ACQ_INTERNAL_SHIFT;
+            g_u32_adc_acq_temp_filt += u16_ch18;
+        }
+        internal->u16_temp_raw = u16_ch18;
+
+        /* Raw value as it would read at VDDA = 3.3 V, Q(shift) */
+        i64_raw = ((int64_t)g_u32_adc_acq_temp_filt * internal->u32_vdda_mv) / ADC_CAL_VREFINT_CAL_MV;
+
+        if ((i32_cal2 > i32_cal1) && (i32_cal2 != 0xFFFF)) {
+            /* 30 degC + (raw - CAL1) * 80 degC / (CAL2 - CAL1) */
+            internal->i32_centi_celsius =
+                3000 + (int32_t)(((i64_raw - ((int64_t)i32_cal1 << ADC_ACQ_INTERNAL_SHIFT)) * 8000) /
+                                 ((int64_t)(i32_cal2 - i32_cal1) << ADC_ACQ_INTERNAL_SHIFT));
+        } else {
+            /* 25 degC + (V - V25) / slope */
+            int64_t i64_uv = (i64_raw * ADC_CAL_VREFINT_CAL_MV * 1000) /
+                             ((int64_t)ADC_CAL_FULL_SCALE << ADC_ACQ_INTERNAL_SHIFT);
+
+            internal->i32_centi_celsius =
+                2500 + (int32_t)(((i64_uv - ADC_ACQ_TS_V25_MV * 1000) * 100) / ADC_ACQ_TS_SLOPE_UV);
+        }
+    }
+
+    internal->u32_rounds++;
+}
+
+/**
+ * @brief Maps an ADC instance to 0..2.
+ *
+ * @return Index, or -1 for an unknown instance.
+ */
+static int8_t adc_acq_adc_index(const ADC_TypeDef *instance)
+{
+    if (instance == ADC1) {
+        return 0;
+    }
+    if (instance == ADC2) {
+        return 1;
+    }
+    if (instance == ADC3) {
+        return 2;
+    }
+    return -1;
+}
+
+/**
+ * @brief Checks the table against the mode and builds the slot map that
+ *        assigns every halfword of a DMA frame to a table entry.
+ *
+ * @return HAL_OK, or HAL_ERROR for an invalid table.
+ */
+static HAL_StatusTypeDef adc_acq_build_slots(void)
+{
+    uint8_t u8_ranks[ADC_ACQ_ADC_COUNT] = {0u, 0u, 0u};
+
+    memset(g_u8_adc_acq_slot, 0xFF, sizeof(g_u8_adc_acq_slot));
+
+    for (uint8_t i = 0u; i < g_u8_adc_acq_count; i++) {
+        int8_t i8_adc = adc_acq_adc_index(g_p_adc_acq_table[i].instance);
+
+        if ((i8_adc < 0) || (g_p_adc_acq_table[i].rank == 0u) || (g_p_adc_acq_table[i].rank > 16u)) {
+            return HAL_ERROR;
+        }
+        u8_ranks[i8_adc]++;
+    }
+
+    switch (g_adc_acq_mode) {
+    case ADC_ACQ_MODE_SINGLE:
+        if (u8_ranks[0] != g_u8_adc_acq_count) {
+            return HAL_ERROR;
+        }
+        g_u8_adc_acq_frame_length = g_u8_adc_acq_count;
+        for (uint8_t i = 0u; i < g_u8_adc_acq_count; i++) {
+            g_u8_adc_acq_slot[g_p_adc_acq_table[i].rank - 1u] = i;
+        }
+        break;
+
+    case ADC_ACQ_MODE_SIMULTANEOUS:
+        if ((u8_ranks[0] == 0u) || (u8_ranks[0] != u8_ranks[1]) || (u8_ranks[0] != u8_ranks[2])) {
+            return HAL_ERROR;
+        }
+        /* Per rank step: ADC1, ADC2, ADC3 */
+        g_u8_adc_acq_frame_length = u8_ranks[0] * ADC_ACQ_ADC_COUNT;
+        for (uint8_t i = 0u; i < g_u8_adc_acq_count; i++) {
+            uint8_t u8_slot = (g_p_adc_acq_table[i].rank - 1u) * ADC_ACQ_ADC_COUNT +
+                              (uint8_t)adc_acq_adc_index(g_p_adc_acq_table[i].instance);
+
+            if (u8_slot >= g_u8_adc_acq_frame_length) {
+                return HAL_ERROR;
+            }
+            g_u8_adc_acq_slot[u8_slot] = i;
+        }
+        break;
+
+    case ADC_ACQ_MODE_INTERLEAVED:
+        if (g_u8_adc_acq_count != 1u) {
+            return HAL_ERROR;
+        }
+        g_u8_adc_acq_frame_length = 1u;
+        g_u8_adc_acq_slot[0] = 0u;
+        break;
+
+    default:
+        return HAL_ERROR;
+    }
+
+    /* Every slot of the frame needs an owner (ranks without gaps) */
+    for (uint8_t i = 0u; i < g_u8_adc_acq_frame_length; i++) {
+        if (g_u8_adc_acq_slot[i] >= g_u8_adc_acq_count) {
+            return HAL_ERROR;
+        }
+    }
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Configures the analog pins of all table entries.
+ */
+static void adc_acq_gpio_init(void)
+{
+    GPIO_InitTypeDef gpio_init_struct;
+
+    gpio_init_struct.Mode  = GPIO_MODE_ANALOG;
+    gpio_init_struct.Pull  = GPIO_NOPULL;
+    gpio_init_struct.Speed = GPIO_SPEED_FREQ_LOW;
+
+    for (uint8_t i = 0u; i < g_u8_adc_acq_count; i++) {
+        GPIO_TypeDef *port = g_p_adc_acq_table[i].port;
+
+        if (port == NULL) {
+            continue;
+        }
+
+        if (port == GPIOA) {
+            __HAL_RCC_GPIOA_CLK_ENABLE();
+        } else if (port == GPIOB) {
+            __HAL_RCC_GPIOB_CLK_ENABLE();
+        } else if (port == GPIOC) {
+            __HAL_RCC_GPIOC_CLK_ENABLE();
+        } else if (port == GPIOF) {
+            __HAL_RCC_GPIOF_CLK_ENABLE();
+        }
+
+        gpio_init_struct.Pin = g_p_adc_acq_table[i].pin;
+        HAL_GPIO_Init(port, &gpio_init_struct);
+    }
+}
+
+/**
+ * @brief Claims the ADC1 stream and configures it in circular mode.
+ *
+ * @param word_transfers 1 for packed halfword pairs (interleaved mode).
+ * @return HAL_OK, HAL_BUSY if the stream is taken (e.g. by potis_dma).
+ */
+static HAL_StatusTypeDef adc_acq_dma_init(uint8_t word_transfers)
+{
+    /* Polled through NDTR, no interrupt */
+    if (dma_alloc_claim(&g_adc_acq_dma_handle_struct, DMA_ALLOC_REQ_ADC1,
+                        DMA_ALLOC_LATENCY_SAMPLED, HEALTH_ISR_COUNT) != HAL_OK) {
+        return HAL_BUSY;
+    }
+
+    g_adc_acq_dma_handle_struct.Init.Direction           = DMA_PERIPH_TO_MEMORY;
+    g_adc_acq_dma_handle_struct.Init.PeriphInc           = DMA_PINC_DISABLE;
+    g_adc_acq_dma_handle_struct.Init.MemInc              = DMA_MINC_ENABLE;
+    g_adc_acq_dma_handle_struct.Init.PeriphDataAlignment = word_transfers ? DMA_PDATAALIGN_WORD
+                                                                          : DMA_PDATAALIGN_HALFWORD;
+    g_adc_acq_dma_handle_struct.Init.MemDataAlignment    = word_transfers ? DMA_MDATAALIGN_WORD
+                                                                          : DMA_MDATAALIGN_HALFWORD;
+    g_adc_acq_dma_handle_struct.Init.Mode                = DMA_CIRCULAR;
+    g_adc_acq_dma_handle_struct.Init.FIFOMode            = DMA_FIFOMODE_DISABLE;
+
+    return HAL_DMA_Init(&g_adc_acq_dma_handle_struct);
+}
+
+/**
+ * @brief Configures one ADC and its regular sequence.
+ *
+ * @param adc   0 = ADC1, 1 = ADC2, 2 = ADC3.
+ * @param ranks Length of the sequence.
+ * @return HAL status.
+ */
+static HAL_StatusTypeDef adc_acq_adc_init(uint8_t adc, uint8_t ranks)
+{
+    static ADC_TypeDef * const instances[ADC_ACQ_ADC_COUNT] = {ADC1, ADC2, ADC3};
+    ADC_HandleTypeDef *handle = &g_adc_acq_adc_handle_struct[adc];
+    ADC_ChannelConfTypeDef channel_struct;
+
+    handle->Instance                   = instances[adc];
+    handle->Init.ClockPrescaler        = clock_plan_adc();
+    handle->Init.Resolution            = ADC_RESOLUTION_12B;
+    handle->Init.DataAlign             = ADC_DATAALIGN_RIGHT;
+    handle->Init.ScanConvMode          = (ranks > 1u) ? ENABLE : DISABLE;
+    handle->Init.EOCSelection          = ADC_EOC_SEQ_CONV;
+    handle->Init.ContinuousConvMode    = ENABLE;
+    handle->Init.NbrOfConversion       = ranks;
+    handle->Init.DiscontinuousConvMode = DISABLE;
+    handle->Init.ExternalTrigConv      = ADC_SOFTWARE_START;
+    handle->Init.ExternalTrigConvEdge  = ADC_EXTERNALTRIGCONVEDGE_NONE;
+    handle->Init.DMAContinuousRequests = ENABLE;
+
+    if (adc == 0u) {
+        handle->DMA_Handle = &g_adc_acq_dma_handle_struct;
+        g_adc_acq_dma_handle_struct.Parent = handle;
+    }
+
+    if (HAL_ADC_Init(handle) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    for (uint8_t i = 0u; i < g_u8_adc_acq_count; i++) {
+        const adc_acq_channel_t *entry = &g_p_adc_acq_table[i];
+
+        if ((g_adc_acq_mode != ADC_ACQ_MODE_INTERLEAVED) && (entry->instance != instances[adc])) {
+            continue;
+        }
+
+        channel_struct.Channel      = entry->channel;
+        channel_struct.Rank         = (g_adc_acq_mode == ADC_ACQ_MODE_INTERLEAVED) ? 1u : entry->rank;
+        channel_struct.SamplingTime = entry->sampling_time;
+        channel_struct.Offset       = 0u;
+
+        if (HAL_ADC_ConfigChannel(handle, &channel_struct) != HAL_OK) {
+            return HAL_ERROR;
+        }
+    }
+
+    return HAL_OK;
+}
@@ -0,0 +1,211 @@
+/**
+ ******************************************************************************
+ * @file        adc_acq.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Table driven multi-channel ADC acquisition engine.
+ *
+ * @details
+ * The channels to sample are passed as a table (ADC instance, channel,
+ * sampling time, rank, analog pin). The engine configures the ADCs, runs
+ * them continuously into one circular DMA buffer and de-interleaves the
+ * samples into one ring buffer per table entry.
+ *
+ * Modes:
+ *  - ADC_ACQ_MODE_SINGLE:       ADC1 only, one scan sequence
+ *  - ADC_ACQ_MODE_SIMULTANEOUS: ADC1/2/3 convert their own sequences in
+ *                               lock step (triple regular simultaneous),
+ *                               every ADC needs the same number of ranks
+ *  - ADC_ACQ_MODE_INTERLEAVED:  ADC1/2/3 convert the same channel one
+ *                               after the other (triple interleaved),
+ *                               exactly one table entry, 3x sample rate
+ *
+ * No interrupt is used: adc_acq_process() follows the DMA write position
+ * and must be called at least once per ADC_ACQ_DMA_LENGTH samples.
+ *
+ * ADC1 claims the ADC1 request of dma_alloc (DMA2 Stream0 Channel 0),
+ * the engine can therefore not run together with the potis_dma module.
+ *
+ * Internal channels (adc_acq_internal_init(), single mode): VREFINT and
+ * the temperature sensor / VBAT (both on channel 18, VBAT wins while
+ * VBATE is set) are converted as injected group of ADC1 once per period,
+ * started from adc_acq_process(). The injected group interrupts the
+ * running scan and the scan resumes at the interrupted rank, so the DMA
+ * frame of the table channels is unchanged and no ADC start/stop is
+ * needed. Every VREFINT result updates the VDDA of adc_cal: all
+ * adc_cal_to_mv() conversions follow the supply ratiometrically. The
+ * injected group then belongs to the engine, adc_cal_measure_vdda() must
+ * not be called on ADC1 while it runs.
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - Up to ADC_ACQ_MAX_CHANNELS channels from a configuration table
+ *  - Single, triple simultaneous and triple interleaved operation
+ *  - Per-channel ring buffers with latest value access
+ *  - VDDA, die temperature and VBAT at a low rate for supply correction
+ *    and thermal decisions (DVFS, fan curve)
+ *
+ ******************************************************************************
+ */
+
+#ifndef ADC_ACQ_ADC_ACQ_H_
+#define ADC_ACQ_ADC_ACQ_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief Maximum number of table entries.
+ */
+#define ADC_ACQ_MAX_CHANNELS    16U
+
+/**
+ * @brief Samples kept per channel ring buffer (power of two).
+ */
+#define ADC_ACQ_RING_LENGTH     64U
+
+/**
+ * @brief Length of the circular DMA buffer in samples (multiple of 6).
+ */
+#define ADC_ACQ_DMA_LENGTH      384U
+
+/**
+ * @brief Default period of the internal channel rounds in ms.
+ */
+#ifndef ADC_ACQ_INTERNAL_PERIOD_MS
+#define ADC_ACQ_INTERNAL_PERIOD_MS  100U
+#endif
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Acquisition modes.
+ */
+typedef enum {
+    ADC_ACQ_MODE_SINGLE = 0,
+    ADC_ACQ_MODE_SIMULTANEOUS,
+    ADC_ACQ_MODE_INTERLEAVED
+} adc_acq_mode_t;
+
+/**
+ * @brief One entry of the channel table.
+ */
+typedef struct {
+    ADC_TypeDef  *instance;       /**< ADC1, ADC2 or ADC3                     */
+    uint32_t      channel;        /**< ADC_CHANNEL_x                          */
+    uint32_t      sampling_time;  /**< ADC_SAMPLETIME_x                       */
+    uint8_t       rank;           /**< 1 .. 16 within the sequence of its ADC */
+    GPIO_TypeDef *port;           /**< Analog pin port, NULL for internal     */
+    uint16_t      pin;            /**< Analog pin                             */
+} adc_acq_channel_t;
+
+/**
+ * @brief Internal channels, filtered over about 8 rounds (VBAT: latest).
+ */
+typedef struct {
+    uint32_t u32_vdda_mv;         /**< From VREFINT and its factory value    */
+    int32_t  i32_centi_celsius;   /**< Die temperature in 0.01 degC          */
+    uint32_t u32_vbat_mv;         /**< 0 before the first VBAT round         */
+    uint16_t u16_vrefint_raw;     /**< Latest raw values                     */
+    uint16_t u16_temp_raw;
+    uint16_t u16_vbat_raw;
+    uint32_t u32_rounds;          /**< Completed rounds, 0: no values yet    */
+} adc_acq_internal_t;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Configures GPIOs, ADCs and DMA from a channel table.
+ *
+ * The table is referenced, not copied, and must stay valid.
+ *
+ * @param table Channel table, index = channel number of the engine.
+ * @param count Number of table entries.
+ * @param mode  Acquisition mode.
+ * @return HAL_OK, or HAL_ERROR if the table does not fit the mode or the
+ *         ADC1 DMA stream is taken.
+ */
+HAL_StatusTypeDef adc_acq_init(const adc_acq_channel_t *table, uint8_t count,
+                               adc_acq_mode_t mode);
+
+/**
+ * @brief Starts continuous conversion into the DMA buffer.
+ *
+ * @return HAL status of the ADC start.
+ */
+HAL_StatusTypeDef adc_acq_start(void);
+
+/**
+ * @brief Stops all ADCs and the DMA.
+ *
+ * @return None
+ */
+void adc_acq_stop(void);
+
+/**
+ * @brief Moves all samples written by the DMA since the last call into the
+ *        per-channel ring buffers.
+ *
+ * @return Number of samples processed.
+ */
+uint32_t adc_acq_process(void);
+
+/**
+ * @brief Returns the newest sample of a channel.
+ *
+ * @param index Table index.
+ * @return Raw 12 bit value, 0 for an invalid index.
+ */
+uint16_t adc_acq_latest(uint8_t index);
+
+/**
+ * @brief Returns the number of unread samples in a channel ring buffer.
+ *
+ * @param index Table index.
+ * @return Number of samples, at most ADC_ACQ_RING_LENGTH.
+ */
+uint16_t adc_acq_available(uint8_t index);
+
+/**
+ * @brief Reads unread samples of a channel, oldest first.
+ *
+ * If more than ADC_ACQ_RING_LENGTH samples arrived since the last read,
+ * the oldest ones are lost.
+ *
+ * @param index Table index.
+ * @param dst   Destination buffer.
+ * @param max   Capacity of dst.
+ * @return Number of samples copied.
+ */
+uint16_t adc_acq_read(uint8_t index, uint16_t *dst, uint16_t max);
+
+/**
+ * @brief Adds VREFINT and the temperature sensor (and every u8_vbat_every
+ *        rounds VBAT instead) as injected group of ADC1, converted once
+ *        per period by adc_acq_process(). Call after adc_acq_init().
+ *
+ * VBATE is only set for the VBAT rounds (the bridge loads the battery).
+ *
+ * @param u16_period_ms Period of the rounds, 0: ADC_ACQ_INTERNAL_PERIOD_MS
+ * @param u8_vbat_every Rounds per VBAT conversion, 0: no VBAT
+ * @return HAL_OK, HAL_ERROR without a single mode configuration (in the
+ *         triple modes ADC1 would leave the lock step of ADC2/3)
+ */
+HAL_StatusTypeDef adc_acq_internal_init(uint16_t u16_period_ms, uint8_t u8_vbat_every);
+
+/**
+ * @brief Stops the internal channel rounds, clears VBATE.
+ *
+ * @return None
+ */
+void adc_acq_internal_deinit(void);
+
+/**
+ * @brief Copies the internal channel values.
+ *
+ * @param internal Destination
+ * @return HAL_OK, HAL_BUSY before the first completed round
+ */
+HAL_StatusTypeDef adc_acq_internal_get(adc_acq_internal_t *internal);
+
+#endif /* ADC_ACQ_ADC_ACQ_H_ */
@@ -0,0 +1,214 @@
+/**
+ ******************************************************************************
+ * @file        adc_cal.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       ADC calibration (VREFINT based VDDA, Q16 gain/offset)
+ *
+ * Functionality:
+ * - VDDA = ADC_CAL_VREFINT_CAL_MV * VREFINT_CAL / VREFINT_raw
+ * - mV   = (raw * gain_q16 + offset_q16) >> 16 per channel
+ *
+ * Peripherals:
+ * - ADC1 injected channel 17 (VREFINT), ADC common CCR.TSVREFE
+ ******************************************************************************
+ */
+
+#include "adc_cal.h"
+#include <utils/utils.h>
+
+/* Preprocessor Defines ----------------------------------------------------- */
+/**
+ * @brief ADC channel of VREFINT.
+ */
+#define ADC_CAL_VREFINT_CHANNEL     17U
+
+/**
+ * @brief Timeout of one injected conversion in ms.
+ */
+#define ADC_CAL_TIMEOUT_MS          2U
+
+/**
+ * @brief Start-up time of ADC and VREFINT in us (datasheet: tSTAB 3 us,
+ *        TS_vrefint 10 us).
+ */
+#define ADC_CAL_STARTUP_US          10U
+
+/**
+ * @brief Plausible VDDA range in mV (datasheet 1.8 V .. 3.6 V).
+ */
+#define ADC_CAL_VDDA_MIN_MV         1800U
+#define ADC_CAL_VDDA_MAX_MV         3600U
+
+/* Static module variables -------------------------------------------------- */
+/**
+ * @brief Measured VDDA in millivolts.
+ */
+static uint32_t g_u32_adc_cal_vdda_mv = ADC_CAL_VREFINT_CAL_MV;
+
+/**
+ * @brief Two-point trim per channel (raw values at 0 V and at VDDA).
+ */
+static uint16_t g_u16_adc_cal_raw_low[ADC_CAL_MAX_CHANNELS]  = {0};
+static uint16_t g_u16_adc_cal_raw_high[ADC_CAL_MAX_CHANNELS] = {
+    ADC_CAL_FULL_SCALE, ADC_CAL_FULL_SCALE, ADC_CAL_FULL_SCALE, ADC_CAL_FULL_SCALE
+};
+
+/**
+ * @brief Precomputed Q16 gain (mV per count) and offset per channel.
+ */
+static uint32_t g_u32_adc_cal_gain_q16[ADC_CAL_MAX_CHANNELS] = {
+    ADC_CAL_Q16_RATIO(ADC_CAL_VREFINT_CAL_MV, ADC_CAL_FULL_SCALE),
+    ADC_CAL_Q16_RATIO(ADC_CAL_VREFINT_CAL_MV, ADC_CAL_FULL_SCALE),
+    ADC_CAL_Q16_RATIO(ADC_CAL_VREFINT_CAL_MV, ADC_CAL_FULL_SCALE),
+    ADC_CAL_Q16_RATIO(ADC_CAL_VREFINT_CAL_MV, ADC_CAL_FULL_SCALE)
+};
+static int32_t g_i32_adc_cal_offset_q16[ADC_CAL_MAX_CHANNELS] = {
+    0x8000, 0x8000, 0x8000, 0x8000
+};
+
+#if ADC_CAL_MAX_CHANNELS != 4U
+#error "Adapt the channel table initializers to ADC_CAL_MAX_CHANNELS"
+#endif
+
+/* Static function prototypes ----------------------------------------------- */
+static void adc_cal_update_channel(uint8_t channel);
+
+/* Public functions --------------------------------------------------------- */
+uint32_t adc_cal_measure_vdda(ADC_TypeDef *adc)
+{
+    uint32_t u32_sum = 0;
+    uint32_t u32_cal = *ADC_CAL_VREFINT_CAL_ADDR;
+
+    if (adc != ADC1) {
+        return g_u32_adc_cal_vdda_mv;
+    }
+
+    /* VREFINT on, >= 10 us sampling (480 cycles), one injected rank.
+     * With JL = 0 the single conversion is taken from JSQ4. */
+    ADC->CCR   |= ADC_CCR_TSVREFE;
+    adc->SMPR1 |= ADC_SMPR1_SMP17;
+    adc->JSQR   = ADC_CAL_VREFINT_CHANNEL << ADC_JSQR_JSQ4_Pos;
+
+    if ((adc->CR2 & ADC_CR2_ADON) == 0u) {
+        adc->CR2 |= ADC_CR2_ADON;
+        /* ADC (3 us) and VREFINT (10 us) start-up time */
+        utils_delay_us(ADC_CAL_STARTUP_US);
+    }
+
+    for (uint32_t i = 0; i < ADC_CAL_VREFINT_SAMPLES; i++) {
+        uint32_t u32_start = HAL_GetTick();
+
+        adc->SR   = ~(uint32_t)ADC_SR_JEOC;
+        adc->CR2 |= ADC_CR2_JSWSTART;
+
+        while ((adc->SR & ADC_SR_JEOC) == 0u) {
+            if ((HAL_GetTick() - u32_start) > ADC_CAL_TIMEOUT_MS) {
+                return g_u32_adc_cal_vdda_mv;
+            }
+        }
+
+        u32_sum += adc->JDR1;
+    }
+    adc->SR = ~(uint32_t)ADC_SR_JEOC;
+
+    if ((u32_sum == 0u) || (u32_cal == 0u) || (u32_cal == 0xFFFFu)) {
+        return g_u32_adc_cal_vdda_mv;
+    }
+
+    /* VDDA = 3300 mV * CAL / average, rounded */
+    g_u32_adc_cal_vdda_mv =
+        (ADC_CAL_VREFINT_CAL_MV * u32_cal * ADC_CAL_VREFINT_SAMPLES + u32_sum / 2u) / u32_sum;
+
+    for (uint8_t i = 0; i < ADC_CAL_MAX_CHANNELS; i++) {
+        adc_cal_update_channel(i);
+    }
+
+    return g_u32_adc_cal_vdda_mv;
+}
+
+void adc_cal_set_vdda_mv(uint32_t u32_vdda_mv)
+{
+    if ((u32_vdda_mv < ADC_CAL_VDDA_MIN_MV) || (u32_vdda_mv > ADC_CAL_VDDA_MAX_MV) ||
+        (u32_vdda_mv == g_u32_adc_cal_vdda_mv)) {
+        return;
+    }
+
+    g_u32_adc_cal_vdda_mv = u32_vdda_mv;
+    for (uint8_t i = 0; i < ADC_CAL_MAX_CHANNELS; i++) {
+        adc_cal_update_channel(i);
+    }
+}
+
+uint32_t adc_cal_get_vdda_mv(void)
+{
+    return g_u32_adc_cal_vdda_mv;
+}
+
+HAL_StatusTypeDef adc_cal_set_two_point(uint8_t channel, uint32_t raw_low, uint32_t raw_high)
+{
+    if ((channel >= ADC_CAL_MAX_CHANNELS) || (raw_high <= raw_low) || (raw_high > ADC_CAL_FULL_SCALE)) {
+        return HAL_ERROR;
+    }
+
+    g_u16_adc_cal_raw_low[channel]  = (uint16_t)raw_low;
+    g_u16_adc_cal_raw_high[channel] = (uint16_t)raw_high;
+    adc_cal_update_channel(channel);
+
+    return HAL_OK;
+}
+
+uint32_t adc_cal_to_mv(uint8_t channel, uint32_t raw)
+{
+    int32_t i32_mv;
+
+    if (channel >= ADC_CAL_MAX_CHANNELS) {
+        return 0;
+    }
+
+    i32_mv = ((int32_t)(raw * g_u32_adc_cal_gain_q16[channel]) + g_i32_adc_cal_offset_q16[channel]) >> 16;
+
+    return (i32_mv < 0) ? 0u : (uint32_t)i32_mv;
+}
+
+void adc_cal_to_mv_block(uint8_t channel, const uint16_t *raw, uint32_t stride,
+                         uint16_t *mv, uint32_t count)
+{
+    int32_t i32_gain;
+    int32_t i32_offset;
+
+    if (channel >= ADC_CAL_MAX_CHANNELS) {
+        return;
+    }
+
+    i32_gain   = (int32_t)g_u32_adc_cal_gain_q16[channel];
+    i32_offset = g_i32_adc_cal_offset_q16[channel];
+
+    for (uint32_t i = 0; i < count; i++) {
+        int32_t i32_mv = ((int32_t)*raw * i32_gain + i32_offset) >> 16;
+
+        mv[i] = (i32_mv < 0) ? 0u : (uint16_t)i32_mv;
+        raw  += stride;
+    }
+}
+
+/* Static functions --------------------------------------------------------- */
+/**
+ * @brief Recomputes gain and offset of one channel from VDDA and its trim.
+ *
+ * gain   = VDDA / (raw_high - raw_low)   (Q16)
+ * offset = 0.5 - raw_low * gain          (Q16, includes rounding)
+ *
+ * The product raw * gain stays below 2^31 for VDDA < 3.6 V.
+ *
+ * @param channel Channel index
+ */
+static void adc_cal_update_channel(uint8_t channel)
+{
+    uint32_t u32_span = (uint32_t)g_u16_adc_cal_raw_high[channel] - g_u16_adc_cal_raw_low[channel];
+    uint32_t u32_gain = ADC_CAL_Q16_RATIO(g_u32_adc_cal_vdda_mv, u32_span);
+
+    g_u32_adc_cal_gain_q16[channel]   = u32_gain;
+    g_i32_adc_cal_offset_q16[channel] = 0x8000 - (int32_t)(g_u16_adc_cal_raw_low[channel] * u32_gain);
+}
@@ -0,0 +1,131 @@
+/**
+ ******************************************************************************
+ * @file        adc_cal.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the ADC calibration module.
+ *
+ * @details
+ * Measures the internal reference (VREFINT) against its factory
+ * calibration value to determine the real VDDA. From VDDA and an
+ * optional two-point trim per channel a Q16 gain and offset are
+ * precomputed, so converting a raw value to millivolts is one
+ * multiply, one add and one shift.
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - VDDA measurement via VREFINT (injected conversion, ADC1 channel 17)
+ *  - VDDA update from a running measurement (adc_acq internal channels)
+ *  - Per-channel Q16 gain/offset
+ *  - Single value and block conversion (interleaved buffers via stride)
+ *
+ ******************************************************************************
+ */
+
+#ifndef ADC_CAL_ADC_CAL_H_
+#define ADC_CAL_ADC_CAL_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief Number of calibrated channels (indices used by the ADC modules).
+ */
+#define ADC_CAL_MAX_CHANNELS        4U
+
+/**
+ * @brief Factory VREFINT conversion result at VDDA = 3.3 V, 30 degC.
+ */
+#define ADC_CAL_VREFINT_CAL_ADDR    ((const uint16_t *)0x1FFF7A2AU)
+
+/**
+ * @brief VDDA in millivolts at which VREFINT_CAL was measured.
+ */
+#define ADC_CAL_VREFINT_CAL_MV      3300U
+
+/**
+ * @brief Full scale raw value of the 12 bit ADC.
+ */
+#define ADC_CAL_FULL_SCALE          4095U
+
+/**
+ * @brief Number of VREFINT conversions averaged per measurement.
+ */
+#define ADC_CAL_VREFINT_SAMPLES     8U
+
+/* Public Preprocessor Macros ---------------------------------------------- */
+/**
+ * @brief Q16 factor of num / den, rounded (compile time constant for
+ *        constant arguments). Use as (value * factor) >> 16.
+ */
+#define ADC_CAL_Q16_RATIO(num, den) \
+    ((uint32_t)((((uint64_t)(num) << 16) + ((den) / 2U)) / (den)))
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Measures VDDA via VREFINT on the given ADC and recomputes the
+ *        gain/offset of all channels.
+ *
+ * Uses an injected conversion, so the regular sequence of the ADC is not
+ * changed. Call after the ADC has been initialized and before regular
+ * conversions are started. The ADC is left enabled.
+ *
+ * @param adc ADC instance, must be ADC1 (VREFINT is only connected there)
+ * @return Measured VDDA in millivolts, ADC_CAL_VREFINT_CAL_MV on failure
+ */
+uint32_t adc_cal_measure_vdda(ADC_TypeDef *adc);
+
+/**
+ * @brief Sets VDDA from a VREFINT conversion made elsewhere (e.g. the
+ *        internal channel rounds of adc_acq) and recomputes the gain/offset
+ *        of all channels.
+ *
+ * @param u32_vdda_mv VDDA in millivolts, ignored outside 1800 .. 3600
+ * @return None
+ */
+void adc_cal_set_vdda_mv(uint32_t u32_vdda_mv);
+
+/**
+ * @brief Returns the VDDA used for the conversions in millivolts.
+ *
+ * @return VDDA in mV
+ */
+uint32_t adc_cal_get_vdda_mv(void);
+
+/**
+ * @brief Sets a two-point trim for a channel: raw_low is mapped to 0 mV,
+ *        raw_high to VDDA. Use 0 and ADC_CAL_FULL_SCALE for no trim.
+ *
+ * @param channel  Channel index (< ADC_CAL_MAX_CHANNELS)
+ * @param raw_low  Raw value at 0 V
+ * @param raw_high Raw value at VDDA (> raw_low)
+ * @return HAL_OK, HAL_ERROR for invalid arguments
+ */
+HAL_StatusTypeDef adc_cal_set_two_point(uint8_t channel, uint32_t raw_low, uint32_t raw_high);
+
+/**
+ * @brief Converts one raw value to millivolts.
+ *
+ * @param channel Channel index (< ADC_CAL_MAX_CHANNELS)
+ * @param raw     Raw 12 bit value
+ * @return Millivolts, 0 for an invalid channel
+ */
+uint32_t adc_cal_to_mv(uint8_t channel, uint32_t raw);
+
+/**
+ * @brief Converts a block of raw samples to millivolts.
+ *
+ * @param channel Channel index (< ADC_CAL_MAX_CHANNELS)
+ * @param raw     First raw sample
+ * @param stride  Distance between two samples of the channel (2 for the
+ *                interleaved potis_dma buffer)
+ * @param mv      Output, count consecutive values
+ * @param count   Number of samples
+ * @return None
+ */
+void adc_cal_to_mv_block(uint8_t channel, const uint16_t *raw, uint32_t stride,
+                         uint16_t *mv, uint32_t count);
+
+#endif /* ADC_CAL_ADC_CAL_H_ */
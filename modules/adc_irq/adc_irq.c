@@ -0,0 +1,77 @@
+/**
+ ******************************************************************************
+ * @file        adc_irq.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Shared ADC interrupt dispatch implementation
+ *
+ * Functionality:
+ * - Handler table indexed by client
+ * - ADC_IRQHandler calls the set handlers, they check their own flags
+ *
+ * Peripherals:
+ * - ADC_IRQn (ADC1, ADC2, ADC3)
+ ******************************************************************************
+ */
+
+#include "adc_irq.h"
+#include <stddef.h>
+
+/* Static module variables -------------------------------------------------- */
+/**
+ * @brief Handler of one client.
+ */
+typedef struct {
+    adc_irq_handler_t handler;
+    void             *context;
+} adc_irq_entry_t;
+
+/**
+ * @brief Handler table, NULL handler = client not present.
+ */
+static adc_irq_entry_t g_adc_irq_entries[ADC_IRQ_CLIENT_COUNT];
+
+/* Public functions --------------------------------------------------------- */
+void adc_irq_set_handler(adc_irq_client_t client, adc_irq_handler_t handler, void *context)
+{
+    if (client >= ADC_IRQ_CLIENT_COUNT) {
+        return;
+    }
+
+    /* Context first: the IRQ may fire as soon as the handler is visible */
+    g_adc_irq_entries[client].handler = NULL;
+    __DMB();
+    g_adc_irq_entries[client].context = context;
+    __DMB();
+    g_adc_irq_entries[client].handler = handler;
+}
+
+void adc_irq_enable(uint32_t u32_preempt)
+{
+    uint32_t u32_preempt_set;
+    uint32_t u32_sub_set;
+
+    /* Vector already in use: never make it less urgent for the other clients */
+    if (NVIC_GetEnableIRQ(ADC_IRQn)) {
+        NVIC_DecodePriority(NVIC_GetPriority(ADC_IRQn), NVIC_GetPriorityGrouping(), &u32_preempt_set, &u32_sub_set);
+        if (u32_preempt_set < u32_preempt) {
+            return;
+        }
+    }
+
+    HAL_NVIC_SetPriority(ADC_IRQn, u32_preempt, 0);
+    HAL_NVIC_EnableIRQ(ADC_IRQn);
+}
+
+/* Interrupt / callback section -------------------------------------------- */
+void ADC_IRQHandler(void)
+{
+    for (uint8_t i = 0u; i < ADC_IRQ_CLIENT_COUNT; i++) {
+        adc_irq_handler_t handler = g_adc_irq_entries[i].handler;
+
+        if (handler != NULL) {
+            handler(g_adc_irq_entries[i].context);
+        }
+    }
+}
@@ -0,0 +1,69 @@
+/**
+ ******************************************************************************
+ * @file        adc_irq.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the shared ADC interrupt dispatch module.
+ *
+ * @details
+ * Owns ADC_IRQHandler, the one vector of ADC1..3, so every project links
+ * it no matter which ADC drivers it excludes. Each user of the vector
+ * has a fixed client slot with a handler and a context pointer; the IRQ
+ * handler calls every set handler in slot order, each one checks and
+ * clears its own flags (status register and interrupt enables of its
+ * ADC). A module that is not linked leaves its slot empty.
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - Per-client handler + context (adc_sched, potis, potis_dma)
+ *  - ADC_IRQHandler
+ *  - NVIC setup, a more urgent priority of an earlier client is kept
+ *
+ ******************************************************************************
+ */
+
+#ifndef ADC_IRQ_ADC_IRQ_H_
+#define ADC_IRQ_ADC_IRQ_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Users of ADC_IRQn, in the order they are served.
+ */
+typedef enum {
+    ADC_IRQ_CLIENT_ADC_SCHED = 0,   /**< ADC1..3 JEOC (end of injected rounds)  */
+    ADC_IRQ_CLIENT_POTIS,           /**< ADC1 EOC / OVR (interrupt driven scan) */
+    ADC_IRQ_CLIENT_POTIS_DMA,       /**< ADC1 analog watchdog                   */
+    ADC_IRQ_CLIENT_COUNT
+} adc_irq_client_t;
+
+/**
+ * @brief Handler of one client, called in interrupt context.
+ */
+typedef void (*adc_irq_handler_t)(void *context);
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Sets (or replaces) the handler of a client.
+ *
+ * @param client  Slot of the calling module
+ * @param handler Function called on every ADC interrupt, NULL to remove
+ * @param context Passed to the handler
+ * @return None
+ */
+void adc_irq_set_handler(adc_irq_client_t client, adc_irq_handler_t handler, void *context);
+
+/**
+ * @brief Sets the priority of ADC_IRQn and enables it. An enabled vector
+ *        keeps a more urgent priority of an earlier call, so it serves
+ *        its most urgent client (see modules/irq).
+ *
+ * @param u32_preempt Preemption priority
+ * @return None
+ */
+void adc_irq_enable(uint32_t u32_preempt);
+
+#endif /* ADC_IRQ_ADC_IRQ_H_ */
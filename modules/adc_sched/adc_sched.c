@@ -0,0 +1,921 @@
+/**
+ ******************************************************************************
+ * @file        adc_sched.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Multi-rate ADC acquisition with regular and injected groups.
+ *
+ * Functionality:
+ * - Plans regular groups (top rate) and injected rounds (slower rates)
+ *   from a channel table with one rate per entry
+ * - Regular scans on a timer TRGO, circular DMA per ADC, de-interleaved
+ *   by following NDTR
+ * - Injected rounds of the due entries started from a timer interrupt,
+ *   results stored in the ADC interrupt
+ *
+ * Peripherals:
+ * - ADC1, ADC2, ADC3 (as named by the table)
+ * - Regular trigger TIM2, TIM3 or TIM8 (TRGO), round timer claimed by
+ *   capability (tim_alloc)
+ * - ADC1/ADC2/ADC3 requests of dma_alloc for the ADCs with regular
+ *   entries (DMA2 Stream0/4 Ch0, Stream2/3 Ch1, Stream0/1 Ch2)
+ * - ADC_IRQn (JEOC, dispatched by adc_irq)
+ ******************************************************************************
+ */
+
+#include "adc_sched.h"
+#include "adc_irq/adc_irq.h"
+#include "clock/clock.h"
+#include "dma_alloc/dma_alloc.h"
+#include "tim_alloc/tim_alloc.h"
+#include "utils/utils.h"
+#include <stddef.h>
+
+/* Preprocessor Defines ----------------------------------------------------- */
+/**
+ * @brief Number of ADC instances.
+ */
+#define ADC_SCHED_ADC_COUNT     3U
+
+/**
+ * @brief Ranks of a regular sequence.
+ */
+#define ADC_SCHED_MAX_RANKS     16U
+
+/**
+ * @brief Channel number bits of ADC_CHANNEL_x (ADC_CHANNEL_TEMPSENSOR
+ *        carries a flag above them), first internal channel.
+ */
+#define ADC_SCHED_CHANNEL_MASK  0x1FU
+#define ADC_SCHED_INTERNAL      16U
+
+#if (ADC_SCHED_RING_LENGTH & (ADC_SCHED_RING_LENGTH - 1U)) != 0
+#error "ADC_SCHED_RING_LENGTH must be a power of two"
+#endif
+
+/* Private Type Definitions ------------------------------------------------- */
+/**
+ * @brief Plan and state of one ADC.
+ */
+typedef struct {
+    ADC_HandleTypeDef hadc;
+    DMA_HandleTypeDef hdma;
+    uint8_t  au8_slot[ADC_SCHED_MAX_RANKS];        /**< Table index per regular rank   */
+    uint8_t  u8_ranks;                             /**< 0: no regular entries          */
+    uint8_t  u8_frame_pos;                         /**< Rank of the next DMA sample    */
+    uint32_t u32_read_pos;                         /**< Next DMA sample to process     */
+    uint8_t  au8_injected[ADC_SCHED_MAX_CHANNELS]; /**< Injected entries, fastest first */
+    uint8_t  u8_injected;
+    uint8_t  au8_round[ADC_SCHED_INJECTED_RANKS];  /**< Entries of the round in flight */
+    uint8_t  u8_round_length;
+    volatile uint8_t u8_busy;                      /**< Round started, JEOC outstanding */
+    uint8_t  u8_used;
+} adc_sched_adc_t;
+
+/* Static module variables -------------------------------------------------- */
+static ADC_TypeDef *const g_adc_sched_instances[ADC_SCHED_ADC_COUNT] = {ADC1, ADC2, ADC3};
+
+static const dma_alloc_request_t g_adc_sched_dma_requests[ADC_SCHED_ADC_COUNT] = {
+    DMA_ALLOC_REQ_ADC1, DMA_ALLOC_REQ_ADC2, DMA_ALLOC_REQ_ADC3
+};
+
+static adc_sched_adc_t g_adc_sched_adc[ADC_SCHED_ADC_COUNT];
+
+/**
+ * @brief Circular DMA buffers (not cleared at startup, only read behind
+ *        the DMA).
+ */
+static __ALIGNED(4) uint16_t g_u16_adc_sched_dma[ADC_SCHED_ADC_COUNT][ADC_SCHED_DMA_LENGTH] UTILS_NOINIT;
+
+/**
+ * @brief Active configuration and the plan of every entry: group, rounds
+ *        per sample and round of the cycle it is converted in.
+ */
+static const adc_sched_channel_t *g_p_adc_sched_table = NULL;
+static uint8_t  g_u8_adc_sched_count = 0u;
+static uint8_t  g_u8_adc_sched_group[ADC_SCHED_MAX_CHANNELS];
+static uint16_t g_u16_adc_sched_divider[ADC_SCHED_MAX_CHANNELS];
+static uint16_t g_u16_adc_sched_phase[ADC_SCHED_MAX_CHANNELS];
+
+/**
+ * @brief Per-entry ring buffers with free running write/read counters
+ *        (not cleared at startup, only read between the counters).
+ */
+static uint16_t g_u16_adc_sched_ring[ADC_SCHED_MAX_CHANNELS][ADC_SCHED_RING_LENGTH] UTILS_NOINIT;
+static volatile uint32_t g_u32_adc_sched_ring_head[ADC_SCHED_MAX_CHANNELS];
+static uint32_t g_u32_adc_sched_ring_tail[ADC_SCHED_MAX_CHANNELS];
+
+/**
+ * @brief Timers, rates, rounds per cycle (largest divider) and the next
+ *        round of the cycle.
+ */
+static TIM_TypeDef *g_p_adc_sched_regular_tim = NULL;
+static TIM_TypeDef *g_p_adc_sched_round_tim   = NULL;
+static uint32_t g_u32_adc_sched_regular_hz = 0u;
+static uint32_t g_u32_adc_sched_round_hz   = 0u;
+static uint16_t g_u16_adc_sched_cycle = 1u;
+static uint16_t g_u16_adc_sched_round = 0u;
+
+static adc_sched_stats_t g_adc_sched_stats;
+
+/* Static function prototypes ----------------------------------------------- */
+static int8_t adc_sched_adc_index(const ADC_TypeDef *instance);
+static HAL_StatusTypeDef adc_sched_plan(void);
+static HAL_StatusTypeDef adc_sched_plan_phases(adc_sched_adc_t *adc);
+static void adc_sched_gpio_init(void);
+static HAL_StatusTypeDef adc_sched_dma_init(uint8_t u8_adc);
+static HAL_StatusTypeDef adc_sched_adc_init(uint8_t u8_adc, uint32_t u32_trigger);
+static void adc_sched_sampling_time(ADC_TypeDef *instance, uint32_t u32_channel, uint32_t u32_sampling_time);
+static HAL_StatusTypeDef adc_sched_timer_setup(TIM_TypeDef *tim, uint32_t u32_rate_hz);
+static void adc_sched_dma_restart(uint8_t u8_adc);
+static void adc_sched_round_load(adc_sched_adc_t *adc, ADC_TypeDef *instance);
+static void adc_sched_round_start(TIM_TypeDef *tim, uint32_t u32_flags, void *context);
+static void adc_sched_round_end(void *context);
+static void adc_sched_store(uint8_t u8_index, uint16_t u16_value);
+
+/* Public functions --------------------------------------------------------- */
+HAL_StatusTypeDef adc_sched_init(const adc_sched_channel_t *table, uint8_t count,
+                                 TIM_TypeDef *regular_tim)
+{
+    uint32_t u32_trigger;
+
+    if ((table == NULL) || (count == 0u) || (count > ADC_SCHED_MAX_CHANNELS)) {
+        return HAL_ERROR;
+    }
+
+    if (regular_tim == TIM2) {
+        u32_trigger = ADC_EXTERNALTRIGCONV_T2_TRGO;
+    } else if (regular_tim == TIM3) {
+        u32_trigger = ADC_EXTERNALTRIGCONV_T3_TRGO;
+    } else if (regular_tim == TIM8) {
+        u32_trigger = ADC_EXTERNALTRIGCONV_T8_TRGO;
+    } else {
+        return HAL_ERROR;
+    }
+
+    g_p_adc_sched_table  = table;
+    g_u8_adc_sched_count = count;
+
+    if (adc_sched_plan() != HAL_OK) {
+        g_p_adc_sched_table = NULL;
+        return HAL_ERROR;
+    }
+
+    /* Timers first: a taken trigger shows before any ADC is touched */
+    if (tim_alloc_claim(regular_tim, TIM_ALLOC_OWNER_ADC_SCHED) != HAL_OK) {
+        g_p_adc_sched_table = NULL;
+        return HAL_BUSY;
+    }
+    g_p_adc_sched_regular_tim = regular_tim;
+
+    if ((g_u32_adc_sched_round_hz != 0u) && (g_p_adc_sched_round_tim == NULL)) {
+        g_p_adc_sched_round_tim = tim_alloc_claim_caps(TIM_ALLOC_CAP_IRQ, TIM_ALLOC_OWNER_ADC_SCHED);
+        if (g_p_adc_sched_round_tim == NULL) {
+            g_p_adc_sched_table = NULL;
+            return HAL_BUSY;
+        }
+    }
+
+    if (adc_sched_timer_setup(regular_tim, g_u32_adc_sched_regular_hz) != HAL_OK) {
+        g_p_adc_sched_table = NULL;
+        return HAL_ERROR;
+    }
+    /* Update event as TRGO, one regular scan per period */
+    regular_tim->CR2 = TIM_TRGO_UPDATE;
+
+    if (g_u32_adc_sched_round_hz != 0u) {
+        if (adc_sched_timer_setup(g_p_adc_sched_round_tim, g_u32_adc_sched_round_hz) != HAL_OK) {
+            g_p_adc_sched_table = NULL;
+            return HAL_ERROR;
+        }
+        g_p_adc_sched_round_tim->DIER = TIM_DIER_UIE;
+        (void)tim_alloc_set_handler(g_p_adc_sched_round_tim, adc_sched_round_start, NULL,
+                                    ADC_SCHED_IRQ_PRIORITY);
+    }
+
+    adc_sched_gpio_init();
+
+    for (uint8_t u8_adc = 0u; u8_adc < ADC_SCHED_ADC_COUNT; u8_adc++) {
+        if (!g_adc_sched_adc[u8_adc].u8_used) {
+            continue;
+        }
+        if ((g_adc_sched_adc[u8_adc].u8_ranks != 0u) && (adc_sched_dma_init(u8_adc) != HAL_OK)) {
+            g_p_adc_sched_table = NULL;
+            return HAL_BUSY;
+        }
+        if (adc_sched_adc_init(u8_adc, u32_trigger) != HAL_OK) {
+            g_p_adc_sched_table = NULL;
+            return HAL_ERROR;
+        }
+    }
+
+    for (uint8_t i = 0u; i < ADC_SCHED_MAX_CHANNELS; i++) {
+        g_u32_adc_sched_ring_head[i] = 0u;
+        g_u32_adc_sched_ring_tail[i] = 0u;
+    }
+
+    adc_irq_set_handler(ADC_IRQ_CLIENT_ADC_SCHED, adc_sched_round_end, NULL);
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef adc_sched_start(void)
+{
+    if (g_p_adc_sched_table == NULL) {
+        return HAL_ERROR;
+    }
+
+    g_adc_sched_stats.u32_rounds   = 0u;
+    g_adc_sched_stats.u32_late     = 0u;
+    g_adc_sched_stats.u32_overruns = 0u;
+    g_u16_adc_sched_round = 0u;
+
+    for (uint8_t u8_adc = 0u; u8_adc < ADC_SCHED_ADC_COUNT; u8_adc++) {
+        adc_sched_adc_t *adc = &g_adc_sched_adc[u8_adc];
+        ADC_TypeDef *instance = g_adc_sched_instances[u8_adc];
+
+        if (!adc->u8_used) {
+            continue;
+        }
+
+        instance->SR = 0u;
+        if (adc->u8_ranks != 0u) {
+            adc->u32_read_pos = 0u;
+            adc->u8_frame_pos = 0u;
+            if (HAL_DMA_Start(&adc->hdma, (uint32_t)(uintptr_t)&instance->DR,
+                              (uint32_t)(uintptr_t)g_u16_adc_sched_dma[u8_adc],
+                              ADC_SCHED_DMA_LENGTH) != HAL_OK) {
+                return HAL_ERROR;
+            }
+            instance->CR2 |= ADC_CR2_DMA | ADC_CR2_DDS;
+        }
+        if (adc->u8_injected != 0u) {
+            adc->u8_busy = 0u;
+            instance->CR1 |= ADC_CR1_JEOCIE;
+        }
+        instance->CR2 |= ADC_CR2_ADON;
+    }
+
+    if (g_u32_adc_sched_round_hz != 0u) {
+        adc_irq_enable(ADC_SCHED_IRQ_PRIORITY);
+
+        g_p_adc_sched_round_tim->CNT = 0u;
+        g_p_adc_sched_round_tim->SR  = 0u;
+        g_p_adc_sched_round_tim->CR1 = TIM_CR1_URS | TIM_CR1_CEN;
+    }
+
+    g_p_adc_sched_regular_tim->CNT = 0u;
+    g_p_adc_sched_regular_tim->CR1 = TIM_CR1_CEN;
+
+    return HAL_OK;
+}
+
+void adc_sched_stop(void)
+{
+    if (g_p_adc_sched_table == NULL) {
+        return;
+    }
+
+    g_p_adc_sched_regular_tim->CR1 = 0u;
+    if (g_p_adc_sched_round_tim != NULL) {
+        g_p_adc_sched_round_tim->CR1 = 0u;
+    }
+
+    for (uint8_t u8_adc = 0u; u8_adc < ADC_SCHED_ADC_COUNT; u8_adc++) {
+        adc_sched_adc_t *adc = &g_adc_sched_adc[u8_adc];
+        ADC_TypeDef *instance = g_adc_sched_instances[u8_adc];
+
+        if (!adc->u8_used) {
+            continue;
+        }
+
+        /* A round in flight is lost with the ADC */
+        instance->CR1 &= ~ADC_CR1_JEOCIE;
+        instance->CR2 &= ~(ADC_CR2_ADON | ADC_CR2_DMA);
+        adc->u8_busy = 0u;
+        if (adc->u8_ranks != 0u) {
+            (void)HAL_DMA_Abort(&adc->hdma);
+        }
+    }
+}
+
+uint32_t adc_sched_process(void)
+{
+    uint32_t u32_count = 0u;
+
+    for (uint8_t u8_adc = 0u; u8_adc < ADC_SCHED_ADC_COUNT; u8_adc++) {
+        adc_sched_adc_t *adc = &g_adc_sched_adc[u8_adc];
+        uint32_t u32_write_pos;
+
+        if (adc->u8_ranks == 0u) {
+            continue;
+        }
+
+        /* Overrun stops the DMA requests: the samples in the buffer are
+         * processed, the next scan starts at rank 1 again */
+        if (g_adc_sched_instances[u8_adc]->SR & ADC_SR_OVR) {
+            g_adc_sched_stats.u32_overruns++;
+            adc_sched_dma_restart(u8_adc);
+            continue;
+        }
+
+        u32_write_pos = (ADC_SCHED_DMA_LENGTH - __HAL_DMA_GET_COUNTER(&adc->hdma)) % ADC_SCHED_DMA_LENGTH;
+
+        while (adc->u32_read_pos != u32_write_pos) {
+            adc_sched_store(adc->au8_slot[adc->u8_frame_pos], g_u16_adc_sched_dma[u8_adc][adc->u32_read_pos]);
+
+            if (++adc->u8_frame_pos >= adc->u8_ranks) {
+                adc->u8_frame_pos = 0u;
+            }
+            if (++adc->u32_read_pos >= ADC_SCHED_DMA_LENGTH) {
+                adc->u32_read_pos = 0u;
+            }
+            u32_count++;
+        }
+    }
+
+    return u32_count;
+}
+
+adc_sched_group_t adc_sched_get_group(uint8_t index)
+{
+    if (index >= g_u8_adc_sched_count) {
+        return ADC_SCHED_GROUP_REGULAR;
+    }
+
+    return (adc_sched_group_t)g_u8_adc_sched_group[index];
+}
+
+uint16_t adc_sched_latest(uint8_t index)
+{
+    uint32_t u32_head;
+
+    if (index >= g_u8_adc_sched_count) {
+        return 0u;
+    }
+
+    u32_head = g_u32_adc_sched_ring_head[index];
+    if (u32_head == 0u) {
+        return 0u;
+    }
+
+    return g_u16_adc_sched_ring[index][(u32_head - 1u) & (ADC_SCHED_RING_LENGTH - 1u)];
+}
+
+uint16_t adc_sched_available(uint8_t index)
+{
+    uint32_t u32_count;
+
+    if (index >= g_u8_adc_sched_count) {
+        return 0u;
+    }
+
+    u32_count = g_u32_adc_sched_ring_head[index] - g_u32_adc_sched_ring_tail[index];
+    return (u32_count > ADC_SCHED_RING_LENGTH) ? ADC_SCHED_RING_LENGTH : (uint16_t)u32_count;
+}
+
+uint16_t adc_sched_read(uint8_t index, uint16_t *dst, uint16_t max)
+{
+    uint16_t u16_count = adc_sched_available(index);
+    uint32_t u32_tail;
+
+    if (u16_count == 0u) {
+        return 0u;
+    }
+
+    /* Skip samples that were already overwritten */
+    u32_tail = g_u32_adc_sched_ring_head[index] - u16_count;
+    if (u16_count > max) {
+        u16_count = max;
+    }
+
+    for (uint16_t i = 0u; i < u16_count; i++) {
+        dst[i] = g_u16_adc_sched_ring[index][(u32_tail + i) & (ADC_SCHED_RING_LENGTH - 1u)];
+    }
+    g_u32_adc_sched_ring_tail[index] = u32_tail + u16_count;
+
+    return u16_count;
+}
+
+void adc_sched_get_stats(adc_sched_stats_t *stats)
+{
+    uint32_t u32_primask = __get_PRIMASK();
+
+    __disable_irq();
+    *stats = g_adc_sched_stats;
+    __set_PRIMASK(u32_primask);
+}
+
+/* Static functions --------------------------------------------------------- */
+/**
+ * @brief Maps an ADC instance to its index.
+ *
+ * @param instance ADC1, ADC2 or ADC3.
+ * @return 0..2, -1 for anything else.
+ */
+static int8_t adc_sched_adc_index(const ADC_TypeDef *instance)
+{
+    for (uint8_t i = 0u; i < ADC_SCHED_ADC_COUNT; i++) {
+        if (instance == g_adc_sched_instances[i]) {
+            return (int8_t)i;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Splits the table into regular and injected entries and plans
+ *        the rates, dividers and phases.
+ *
+ * @return HAL_OK, HAL_ERROR if the table can not be scheduled.
+ */
+static HAL_StatusTypeDef adc_sched_plan(void)
+{
+    const adc_sched_channel_t *table = g_p_adc_sched_table;
+    uint32_t u32_regular_hz = 0u;
+    uint32_t u32_round_hz = 0u;
+    uint32_t u32_conversions = 0u;
+    uint16_t u16_cycle = 1u;
+
+    for (uint8_t u8_adc = 0u; u8_adc < ADC_SCHED_ADC_COUNT; u8_adc++) {
+        g_adc_sched_adc[u8_adc].u8_used     = 0u;
+        g_adc_sched_adc[u8_adc].u8_ranks    = 0u;
+        g_adc_sched_adc[u8_adc].u8_injected = 0u;
+    }
+
+    for (uint8_t i = 0u; i < g_u8_adc_sched_count; i++) {
+        uint32_t u32_channel = table[i].channel & ADC_SCHED_CHANNEL_MASK;
+
+        if ((table[i].rate_hz == 0u) || (adc_sched_adc_index(table[i].instance) < 0) ||
+            ((u32_channel >= ADC_SCHED_INTERNAL) && (table[i].instance != ADC1))) {
+            return HAL_ERROR;
+        }
+        for (uint8_t j = 0u; j < i; j++) {
+            if ((table[j].instance == table[i].instance) &&
+                ((table[j].channel & ADC_SCHED_CHANNEL_MASK) == u32_channel)) {
+                return HAL_ERROR;
+            }
+        }
+        if (table[i].rate_hz > u32_regular_hz) {
+            u32_regular_hz = table[i].rate_hz;
+        }
+    }
+
+    for (uint8_t i = 0u; i < g_u8_adc_sched_count; i++) {
+        if ((table[i].rate_hz < u32_regular_hz) && (table[i].rate_hz > u32_round_hz)) {
+            u32_round_hz = table[i].rate_hz;
+        }
+    }
+    if (u32_round_hz > ADC_SCHED_MAX_ROUND_HZ) {
+        return HAL_ERROR;
+    }
+
+    for (uint8_t i = 0u; i < g_u8_adc_sched_count; i++) {
+        adc_sched_adc_t *adc = &g_adc_sched_adc[adc_sched_adc_index(table[i].instance)];
+
+        adc->u8_used = 1u;
+        if (table[i].rate_hz == u32_regular_hz) {
+            if (adc->u8_ranks >= ADC_SCHED_MAX_RANKS) {
+                return HAL_ERROR;
+            }
+            g_u8_adc_sched_group[i] = ADC_SCHED_GROUP_REGULAR;
+            g_u16_adc_sched_divider[i] = 1u;
+            adc->au8_slot[adc->u8_ranks++] = i;
+            u32_conversions += u32_regular_hz;
+            continue;
+        }
+
+        if (((u32_round_hz % table[i].rate_hz) != 0u) ||
+            ((u32_round_hz / table[i].rate_hz) > ADC_SCHED_MAX_DIVIDER)) {
+            return HAL_ERROR;
+        }
+        g_u8_adc_sched_group[i] = ADC_SCHED_GROUP_INJECTED;
+        g_u16_adc_sched_divider[i] = (uint16_t)(u32_round_hz / table[i].rate_hz);
+        u32_conversions += table[i].rate_hz;
+
+        /* Sorted in, fastest first */
+        {
+            uint8_t u8_pos = adc->u8_injected++;
+
+            while ((u8_pos > 0u) &&
+                   (g_u16_adc_sched_divider[adc->au8_injected[u8_pos - 1u]] > g_u16_adc_sched_divider[i])) {
+                adc->au8_injected[u8_pos] = adc->au8_injected[u8_pos - 1u];
+                u8_pos--;
+            }
+            adc->au8_injected[u8_pos] = i;
+        }
+    }
+
+    /* Chain of divisors over all ADCs: the cycle of the slowest entry is a
+     * multiple of every other one */
+    for (uint8_t i = 0u; i < g_u8_adc_sched_count; i++) {
+        for (uint8_t j = 0u; j < g_u8_adc_sched_count; j++) {
+            uint16_t u16_a = g_u16_adc_sched_divider[i];
+            uint16_t u16_b = g_u16_adc_sched_divider[j];
+
+            if ((g_u8_adc_sched_group[i] != ADC_SCHED_GROUP_INJECTED) ||
+                (g_u8_adc_sched_group[j] != ADC_SCHED_GROUP_INJECTED) || (u16_a > u16_b)) {
+                continue;
+            }
+            if ((u16_b % u16_a) != 0u) {
+                return HAL_ERROR;
+            }
+            if (u16_b > u16_cycle) {
+                u16_cycle = u16_b;
+            }
+        }
+    }
+
+    for (uint8_t u8_adc = 0u; u8_adc < ADC_SCHED_ADC_COUNT; u8_adc++) {
+        if (adc_sched_plan_phases(&g_adc_sched_adc[u8_adc]) != HAL_OK) {
+            return HAL_ERROR;
+        }
+    }
+
+    g_u32_adc_sched_regular_hz = u32_regular_hz;
+    g_u32_adc_sched_round_hz   = u32_round_hz;
+    g_u16_adc_sched_cycle      = u16_cycle;
+
+    g_adc_sched_stats.u32_regular_hz        = u32_regular_hz;
+    g_adc_sched_stats.u32_injected_hz       = u32_round_hz;
+    g_adc_sched_stats.u32_conversions_per_s = u32_conversions;
+    g_adc_sched_stats.u32_dma_per_s         = 0u;
+    for (uint8_t u8_adc = 0u; u8_adc < ADC_SCHED_ADC_COUNT; u8_adc++) {
+        g_adc_sched_stats.u32_dma_per_s += g_adc_sched_adc[u8_adc].u8_ranks * u32_regular_hz;
+    }
+    g_adc_sched_stats.u32_single_rate_per_s = g_u8_adc_sched_count * u32_regular_hz;
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Spreads the injected entries of one ADC over the rounds.
+ *
+ * Fastest first: the entries placed before have dividers that divide the
+ * one of the current entry, so in all rounds of one of its phases the
+ * same number of them is due. The phase with the fewest wins; if even
+ * that one is full, the entries do not fit.
+ *
+ * @param adc ADC with its injected entries sorted.
+ * @return HAL_OK, HAL_ERROR if a round would need more than 4 ranks.
+ */
+static HAL_StatusTypeDef adc_sched_plan_phases(adc_sched_adc_t *adc)
+{
+    for (uint8_t k = 0u; k < adc->u8_injected; k++) {
+        uint8_t  u8_index = adc->au8_injected[k];
+        uint16_t u16_best = 0u;
+        uint8_t  u8_best_load = 0xFFu;
+
+        for (uint32_t u32_phase = 0u; u32_phase < g_u16_adc_sched_divider[u8_index]; u32_phase++) {
+            uint8_t u8_load = 0u;
+
+            for (uint8_t m = 0u; m < k; m++) {
+                uint8_t u8_other = adc->au8_injected[m];
+
+                if ((u32_phase % g_u16_adc_sched_divider[u8_other]) == g_u16_adc_sched_phase[u8_other]) {
+                    u8_load++;
+                }
+            }
+            if (u8_load < u8_best_load) {
+                u8_best_load = u8_load;
+                u16_best = (uint16_t)u32_phase;
+                if (u8_load == 0u) {
+                    break;
+                }
+            }
+        }
+
+        if (u8_best_load >= ADC_SCHED_INJECTED_RANKS) {
+            return HAL_ERROR;
+        }
+        g_u16_adc_sched_phase[u8_index] = u16_best;
+    }
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Configures the analog pins of all table entries.
+ */
+static void adc_sched_gpio_init(void)
+{
+    GPIO_InitTypeDef gpio_init_struct;
+
+    gpio_init_struct.Mode  = GPIO_MODE_ANALOG;
+    gpio_init_struct.Pull  = GPIO_NOPULL;
+    gpio_init_struct.Speed = GPIO_SPEED_FREQ_LOW;
+
+    for (uint8_t i = 0u; i < g_u8_adc_sched_count; i++) {
+        GPIO_TypeDef *port = g_p_adc_sched_table[i].port;
+
+        if (port == NULL) {
+            continue;
+        }
+
+        if (port == GPIOA) {
+            __HAL_RCC_GPIOA_CLK_ENABLE();
+        } else if (port == GPIOB) {
+            __HAL_RCC_GPIOB_CLK_ENABLE();
+        } else if (port == GPIOC) {
+            __HAL_RCC_GPIOC_CLK_ENABLE();
+        } else if (port == GPIOF) {
+            __HAL_RCC_GPIOF_CLK_ENABLE();
+        }
+
+        gpio_init_struct.Pin = g_p_adc_sched_table[i].pin;
+        HAL_GPIO_Init(port, &gpio_init_struct);
+    }
+}
+
+/**
+ * @brief Claims the stream of an ADC and configures it in circular mode.
+ *
+ * @param u8_adc 0 = ADC1, 1 = ADC2, 2 = ADC3.
+ * @return HAL_OK, HAL_BUSY if the stream is taken.
+ */
+static HAL_StatusTypeDef adc_sched_dma_init(uint8_t u8_adc)
+{
+    DMA_HandleTypeDef *hdma = &g_adc_sched_adc[u8_adc].hdma;
+
+    /* Polled through NDTR, no interrupt */
+    if (dma_alloc_claim(hdma, g_adc_sched_dma_requests[u8_adc],
+                        DMA_ALLOC_LATENCY_SAMPLED, HEALTH_ISR_COUNT) != HAL_OK) {
+        return HAL_BUSY;
+    }
+
+    hdma->Init.Direction           = DMA_PERIPH_TO_MEMORY;
+    hdma->Init.PeriphInc           = DMA_PINC_DISABLE;
+    hdma->Init.MemInc              = DMA_MINC_ENABLE;
+    hdma->Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+    hdma->Init.MemDataAlignment    = DMA_MDATAALIGN_HALFWORD;
+    hdma->Init.Mode                = DMA_CIRCULAR;
+    hdma->Init.FIFOMode            = DMA_FIFOMODE_DISABLE;
+
+    return HAL_DMA_Init(hdma);
+}
+
+/**
+ * @brief Configures one ADC: regular sequence on the timer trigger,
+ *        sampling times of the injected entries.
+ *
+ * @param u8_adc      0 = ADC1, 1 = ADC2, 2 = ADC3.
+ * @param u32_trigger ADC_EXTERNALTRIGCONV_Tx_TRGO of the regular timer.
+ * @return HAL status.
+ */
+static HAL_StatusTypeDef adc_sched_adc_init(uint8_t u8_adc, uint32_t u32_trigger)
+{
+    adc_sched_adc_t *adc = &g_adc_sched_adc[u8_adc];
+    ADC_HandleTypeDef *handle = &adc->hadc;
+    ADC_ChannelConfTypeDef channel_struct;
+
+    if (u8_adc == 0u) {
+        __HAL_RCC_ADC1_CLK_ENABLE();
+    } else if (u8_adc == 1u) {
+        __HAL_RCC_ADC2_CLK_ENABLE();
+    } else {
+        __HAL_RCC_ADC3_CLK_ENABLE();
+    }
+
+    /* Scan mode for the injected rounds as well; without regular entries
+     * the regular group is never started */
+    handle->Instance                   = g_adc_sched_instances[u8_adc];
+    handle->Init.ClockPrescaler        = clock_plan_adc();
+    handle->Init.Resolution            = ADC_RESOLUTION_12B;
+    handle->Init.DataAlign             = ADC_DATAALIGN_RIGHT;
+    handle->Init.ScanConvMode          = ENABLE;
+    handle->Init.EOCSelection          = ADC_EOC_SEQ_CONV;
+    handle->Init.ContinuousConvMode    = DISABLE;
+    handle->Init.NbrOfConversion       = (adc->u8_ranks != 0u) ? adc->u8_ranks : 1u;
+    handle->Init.DiscontinuousConvMode = DISABLE;
+    handle->Init.ExternalTrigConv      = (adc->u8_ranks != 0u) ? u32_trigger : ADC_SOFTWARE_START;
+    handle->Init.ExternalTrigConvEdge  = (adc->u8_ranks != 0u) ? ADC_EXTERNALTRIGCONVEDGE_RISING
+                                                               : ADC_EXTERNALTRIGCONVEDGE_NONE;
+    handle->Init.DMAContinuousRequests = ENABLE;
+
+    if (HAL_ADC_Init(handle) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    for (uint8_t u8_rank = 0u; u8_rank < adc->u8_ranks; u8_rank++) {
+        const adc_sched_channel_t *entry = &g_p_adc_sched_table[adc->au8_slot[u8_rank]];
+
+        channel_struct.Channel      = entry->channel;
+        channel_struct.Rank         = u8_rank + 1u;
+        channel_struct.SamplingTime = entry->sampling_time;
+        channel_struct.Offset       = 0u;
+
+        if (HAL_ADC_ConfigChannel(handle, &channel_struct) != HAL_OK) {
+            return HAL_ERROR;
+        }
+    }
+
+    for (uint8_t k = 0u; k < adc->u8_injected; k++) {
+        const adc_sched_channel_t *entry = &g_p_adc_sched_table[adc->au8_injected[k]];
+        uint32_t u32_channel = entry->channel & ADC_SCHED_CHANNEL_MASK;
+
+        adc_sched_sampling_time(handle->Instance, u32_channel, entry->sampling_time);
+        if (u32_channel >= ADC_SCHED_INTERNAL) {
+            ADC->CCR |= ADC_CCR_TSVREFE;
+        }
+    }
+
+    /* HAL_ADC_Init() leaves ADON set, the ADC starts in adc_sched_start() */
+    handle->Instance->CR2 &= ~ADC_CR2_ADON;
+    handle->Instance->JSQR = 0u;
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Sets the sampling time of a channel (SMPR1 for 10..18, SMPR2 for
+ *        0..9).
+ *
+ * @param instance          ADC
+ * @param u32_channel       Channel number 0..18
+ * @param u32_sampling_time ADC_SAMPLETIME_x
+ * @return None
+ */
+static void adc_sched_sampling_time(ADC_TypeDef *instance, uint32_t u32_channel, uint32_t u32_sampling_time)
+{
+    if (u32_channel >= 10u) {
+        MODIFY_REG(instance->SMPR1, 7u << ((u32_channel - 10u) * 3u),
+                   u32_sampling_time << ((u32_channel - 10u) * 3u));
+    } else {
+        MODIFY_REG(instance->SMPR2, 7u << (u32_channel * 3u), u32_sampling_time << (u32_channel * 3u));
+    }
+}
+
+/**
+ * @brief Programs a claimed timer for an update rate, stopped.
+ *
+ * @param tim         Timer
+ * @param u32_rate_hz Updates per second
+ * @return HAL_OK, HAL_ERROR for a rate above half the timer clock
+ */
+static HAL_StatusTypeDef adc_sched_timer_setup(TIM_TypeDef *tim, uint32_t u32_rate_hz)
+{
+    /* Timer clock / rate split into prescaler and a 16 bit reload */
+    uint32_t u32_ticks = tim_alloc_get_clock(tim) / u32_rate_hz;
+    uint32_t u32_prescaler;
+
+    if (u32_ticks < 2u) {
+        return HAL_ERROR;
+    }
+    u32_prescaler = (u32_ticks - 1u) / 65536u;
+
+    tim->CR1  = 0u;
+    tim->DIER = 0u;
+    tim->PSC  = u32_prescaler;
+    tim->ARR  = (u32_ticks / (u32_prescaler + 1u)) - 1u;
+    tim->CNT  = 0u;
+    tim->EGR  = TIM_EGR_UG;
+    tim->SR   = 0u;
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Recovers the regular group of an ADC after an overrun: DMA from
+ *        the start of the buffer, OVR cleared.
+ *
+ * @param u8_adc 0 = ADC1, 1 = ADC2, 2 = ADC3.
+ * @return None
+ */
+static void adc_sched_dma_restart(uint8_t u8_adc)
+{
+    adc_sched_adc_t *adc = &g_adc_sched_adc[u8_adc];
+    ADC_TypeDef *instance = g_adc_sched_instances[u8_adc];
+
+    instance->CR2 &= ~ADC_CR2_DMA;
+    (void)HAL_DMA_Abort(&adc->hdma);
+    instance->SR = ~(uint32_t)(ADC_SR_OVR | ADC_SR_EOC | ADC_SR_STRT);
+
+    adc->u32_read_pos = 0u;
+    adc->u8_frame_pos = 0u;
+    (void)HAL_DMA_Start(&adc->hdma, (uint32_t)(uintptr_t)&instance->DR,
+                        (uint32_t)(uintptr_t)g_u16_adc_sched_dma[u8_adc], ADC_SCHED_DMA_LENGTH);
+    instance->CR2 |= ADC_CR2_DMA;
+}
+
+/**
+ * @brief Writes the entries due in the next round into JSQR. With JL =
+ *        n - 1 the ADC converts JSQ(5-n)..JSQ4 into JDR1..JDRn.
+ *
+ * @param adc      ADC plan
+ * @param instance ADC
+ * @return None
+ */
+static void adc_sched_round_load(adc_sched_adc_t *adc, ADC_TypeDef *instance)
+{
+    uint32_t u32_jsqr = 0u;
+    uint8_t  u8_length = 0u;
+
+    for (uint8_t k = 0u; (k < adc->u8_injected) && (u8_length < ADC_SCHED_INJECTED_RANKS); k++) {
+        uint8_t u8_index = adc->au8_injected[k];
+
+        if ((g_u16_adc_sched_round % g_u16_adc_sched_divider[u8_index]) == g_u16_adc_sched_phase[u8_index]) {
+            adc->au8_round[u8_length++] = u8_index;
+        }
+    }
+
+    for (uint8_t i = 0u; i < u8_length; i++) {
+        uint32_t u32_channel = g_p_adc_sched_table[adc->au8_round[i]].channel & ADC_SCHED_CHANNEL_MASK;
+
+        u32_jsqr |= u32_channel << ((ADC_SCHED_INJECTED_RANKS - u8_length + i) * ADC_JSQR_JSQ2_Pos);
+    }
+    if (u8_length != 0u) {
+        instance->JSQR = u32_jsqr | ((uint32_t)(u8_length - 1u) << ADC_JSQR_JL_Pos);
+    }
+    adc->u8_round_length = u8_length;
+}
+
+/**
+ * @brief Update interrupt of the round timer: starts the injected group
+ *        of every ADC with entries due in this round.
+ *
+ * @param tim       Round timer
+ * @param u32_flags Pending flags
+ * @param context   Unused
+ * @return None
+ */
+static void adc_sched_round_start(TIM_TypeDef *tim, uint32_t u32_flags, void *context)
+{
+    (void)tim;
+    (void)context;
+
+    if ((u32_flags & TIM_SR_UIF) == 0u) {
+        return;
+    }
+
+    for (uint8_t u8_adc = 0u; u8_adc < ADC_SCHED_ADC_COUNT; u8_adc++) {
+        adc_sched_adc_t *adc = &g_adc_sched_adc[u8_adc];
+
+        if (adc->u8_injected == 0u) {
+            continue;
+        }
+        /* Previous round not stored yet: its JSQR stays, this round is lost */
+        if (adc->u8_busy) {
+            g_adc_sched_stats.u32_late++;
+            continue;
+        }
+
+        adc_sched_round_load(adc, g_adc_sched_instances[u8_adc]);
+        if (adc->u8_round_length != 0u) {
+            adc->u8_busy = 1u;
+            g_adc_sched_instances[u8_adc]->CR2 |= ADC_CR2_JSWSTART;
+        }
+    }
+
+    if (++g_u16_adc_sched_round >= g_u16_adc_sched_cycle) {
+        g_u16_adc_sched_round = 0u;
+    }
+}
+
+/**
+ * @brief ADC interrupt (adc_irq client): stores the results of the
+ *        finished rounds.
+ *
+ * @param context Unused
+ * @return None
+ */
+static void adc_sched_round_end(void *context)
+{
+    (void)context;
+
+    for (uint8_t u8_adc = 0u; u8_adc < ADC_SCHED_ADC_COUNT; u8_adc++) {
+        adc_sched_adc_t *adc = &g_adc_sched_adc[u8_adc];
+        ADC_TypeDef *instance = g_adc_sched_instances[u8_adc];
+        const volatile uint32_t *pu32_jdr = &instance->JDR1;
+
+        if ((adc->u8_injected == 0u) || ((instance->CR1 & ADC_CR1_JEOCIE) == 0u) ||
+            ((instance->SR & ADC_SR_JEOC) == 0u)) {
+            continue;
+        }
+        instance->SR = ~(uint32_t)(ADC_SR_JEOC | ADC_SR_JSTRT);
+
+        /* JDR1..JDRn in the order of the round */
+        for (uint8_t i = 0u; i < adc->u8_round_length; i++) {
+            adc_sched_store(adc->au8_round[i], (uint16_t)pu32_jdr[i]);
+        }
+        adc->u8_busy = 0u;
+        g_adc_sched_stats.u32_rounds++;
+    }
+}
+
+/**
+ * @brief Appends a sample to the ring of an entry (single writer: the DMA
+ *        processing or the ADC interrupt, depending on the group).
+ *
+ * @param u8_index  Table index
+ * @param u16_value Raw sample
+ * @return None
+ */
+static void adc_sched_store(uint8_t u8_index, uint16_t u16_value)
+{
+    uint32_t u32_head = g_u32_adc_sched_ring_head[u8_index];
+
+    g_u16_adc_sched_ring[u8_index][u32_head & (ADC_SCHED_RING_LENGTH - 1u)] = u16_value;
+    g_u32_adc_sched_ring_head[u8_index] = u32_head + 1u;
+}
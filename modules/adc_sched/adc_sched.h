@@ -0,0 +1,225 @@
+/**
+ ******************************************************************************
+ * @file        adc_sched.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Multi-rate ADC acquisition with regular and injected groups.
+ *
+ * @details
+ * potis_dma and adc_acq convert every channel in one sequence at one
+ * rate, so a 1 Hz die temperature costs as many conversions and DMA
+ * transfers as a fan current at PWM rate. Here every table entry has its
+ * own rate and the scheduler plans the groups from them:
+ *
+ *   regular group   the entries at the highest rate of the table, one
+ *                   scan per update of the regular timer (TRGO), circular
+ *                   DMA per ADC, de-interleaved by adc_sched_process()
+ *   injected group  all slower entries, one round per update interrupt
+ *                   of the round timer, at the highest of their rates
+ *                   (base, at most ADC_SCHED_MAX_ROUND_HZ)
+ *
+ * An injected round converts only the entries due in it: an entry at
+ * base / n is due every n-th round. The round interrupt writes the
+ * channels due on each ADC into its JSQR and starts the group (JSWSTART),
+ * an ADC without due entries converts nothing in that round; the ADC
+ * interrupt at the end of the round stores the results. The start jitter
+ * of the slow entries is the interrupt latency.
+ *
+ * The rates of the injected entries must form a chain of divisors (each
+ * one divides the next faster one, e.g. 100, 10 and 1 Hz) so the phases
+ * can be spread: every entry starts in the round with the fewest entries
+ * of its cycle, at most 4 entries (JSQ1..4) per round and ADC. The
+ * conversions per second are then the sum over the entries of their
+ * rates.
+ *
+ * The entries name their ADC (the pin decides: channels 0..3 on all
+ * three, 4..7 and 14..15 on ADC1/2, the internal channels on ADC1 only).
+ * All ADCs share the regular timer (TRGO, chosen by the application) and
+ * the round timer (any free timer with a vector dispatched by tim_alloc,
+ * claimed by capability); an ADC with regular entries claims its
+ * DMA request (ADC1, ADC2 or ADC3 of dma_alloc), one with only slower
+ * entries needs none. An ADC used here must not be used by potis,
+ * potis_dma or adc_acq at the same time.
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - Up to ADC_SCHED_MAX_CHANNELS entries with their own rates on ADC1..3
+ *  - Regular group at the top rate, injected rounds of the due entries,
+ *    timers claimed through tim_alloc, DMA streams through dma_alloc
+ *  - Per-entry ring buffers with latest value access, as in adc_acq
+ *  - Planned load against one sequence of all entries at the top rate
+ *
+ * adc_sched_process() must run at least once per ADC_SCHED_DMA_LENGTH
+ * regular samples of an ADC; the injected results are stored in the ADC
+ * interrupt (dispatched by modules/adc_irq).
+ *
+ ******************************************************************************
+ */
+
+#ifndef ADC_SCHED_ADC_SCHED_H_
+#define ADC_SCHED_ADC_SCHED_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+#include "irq/irq.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief Maximum number of table entries.
+ */
+#define ADC_SCHED_MAX_CHANNELS      16U
+
+/**
+ * @brief Samples kept per entry ring buffer (power of two).
+ */
+#define ADC_SCHED_RING_LENGTH       64U
+
+/**
+ * @brief Circular DMA buffer per ADC in samples.
+ */
+#define ADC_SCHED_DMA_LENGTH        256U
+
+/**
+ * @brief Injected ranks per round (JSQ1..JSQ4).
+ */
+#define ADC_SCHED_INJECTED_RANKS    4U
+
+/**
+ * @brief Longest injected cycle in rounds (base rate / slowest rate).
+ */
+#define ADC_SCHED_MAX_DIVIDER       65535U
+
+/**
+ * @brief Highest rate of the injected rounds (4 conversions of 480
+ *        cycles fit well into one round).
+ */
+#define ADC_SCHED_MAX_ROUND_HZ      2000U
+
+/**
+ * @brief NVIC priority of the round timer and of the end of a round
+ *        (ADC_IRQn).
+ */
+#define ADC_SCHED_IRQ_PRIORITY      IRQ_CLASS_TRANSFER
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief One entry of the channel table.
+ */
+typedef struct {
+    ADC_TypeDef  *instance;       /**< ADC1, ADC2 or ADC3                 */
+    uint32_t      channel;        /**< ADC_CHANNEL_x                      */
+    uint32_t      sampling_time;  /**< ADC_SAMPLETIME_x                   */
+    uint32_t      rate_hz;        /**< Samples per second, at least 1     */
+    GPIO_TypeDef *port;           /**< Analog pin port, NULL for internal */
+    uint16_t      pin;            /**< Analog pin                         */
+} adc_sched_channel_t;
+
+/**
+ * @brief Group an entry was planned into.
+ */
+typedef enum {
+    ADC_SCHED_GROUP_REGULAR = 0,
+    ADC_SCHED_GROUP_INJECTED
+} adc_sched_group_t;
+
+/**
+ * @brief Plan and counters since adc_sched_start().
+ */
+typedef struct {
+    uint32_t u32_regular_hz;          /**< Scan rate of the regular groups    */
+    uint32_t u32_injected_hz;         /**< Round rate, 0: no injected entries */
+    uint32_t u32_conversions_per_s;   /**< Planned conversions of all ADCs    */
+    uint32_t u32_dma_per_s;           /**< Of those through DMA (regular)     */
+    uint32_t u32_single_rate_per_s;   /**< All entries at the regular rate    */
+    uint32_t u32_rounds;              /**< Injected rounds completed          */
+    uint32_t u32_late;                /**< Rounds skipped, previous one busy  */
+    uint32_t u32_overruns;            /**< Regular samples lost (ADC OVR)     */
+} adc_sched_stats_t;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Plans the groups and configures GPIOs, ADCs, timers and DMA.
+ *
+ * The table is referenced, not copied, and must stay valid.
+ *
+ * @param table        Channel table, index = channel number of the module
+ * @param count        Number of table entries
+ * @param regular_tim  Trigger of the regular groups: TIM2, TIM3 or TIM8
+ * @return HAL_OK, HAL_ERROR if the table can not be planned (rates without
+ *         a divisor chain, more than 4 entries due in a round, a channel
+ *         twice on one ADC, an internal channel off ADC1), HAL_BUSY if a
+ *         timer or DMA stream is taken
+ */
+HAL_StatusTypeDef adc_sched_init(const adc_sched_channel_t *table, uint8_t count,
+                                 TIM_TypeDef *regular_tim);
+
+/**
+ * @brief Starts the DMA streams, the ADCs and the timers.
+ *
+ * @return HAL_OK, HAL_ERROR without adc_sched_init()
+ */
+HAL_StatusTypeDef adc_sched_start(void);
+
+/**
+ * @brief Stops the timers, the ADCs and the DMA streams.
+ *
+ * @return None
+ */
+void adc_sched_stop(void);
+
+/**
+ * @brief Moves the regular samples written by the DMA since the last call
+ *        into the ring buffers of their entries.
+ *
+ * @return Number of samples processed.
+ */
+uint32_t adc_sched_process(void);
+
+/**
+ * @brief Returns the group an entry was planned into.
+ *
+ * @param index Table index
+ * @return Group
+ */
+adc_sched_group_t adc_sched_get_group(uint8_t index);
+
+/**
+ * @brief Returns the newest sample of an entry.
+ *
+ * @param index Table index
+ * @return Raw 12 bit value, 0 before the first sample or for an invalid
+ *         index
+ */
+uint16_t adc_sched_latest(uint8_t index);
+
+/**
+ * @brief Returns the number of unread samples of an entry.
+ *
+ * @param index Table index
+ * @return Number of samples, at most ADC_SCHED_RING_LENGTH
+ */
+uint16_t adc_sched_available(uint8_t index);
+
+/**
+ * @brief Reads unread samples of an entry, oldest first.
+ *
+ * If more than ADC_SCHED_RING_LENGTH samples arrived since the last read,
+ * the oldest ones are lost.
+ *
+ * @param index Table index
+ * @param dst   Destination buffer
+ * @param max   Capacity of dst
+ * @return Number of samples copied
+ */
+uint16_t adc_sched_read(uint8_t index, uint16_t *dst, uint16_t max);
+
+/**
+ * @brief Copies the plan and the counters.
+ *
+ * @param stats Destination
+ * @return None
+ */
+void adc_sched_get_stats(adc_sched_stats_t *stats);
+
+#endif /* ADC_SCHED_ADC_SCHED_H_ */
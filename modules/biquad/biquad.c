@@ -0,0 +1,262 @@
+/**
+ ******************************************************************************
+ * @file        biquad.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Biquad filter cascades
+ *
+ * Functionality:
+ * - Float transposed direct form II, Q31 direct form I with post shift
+ * - Steady state preload
+ * - RBJ low-pass and Butterworth design
+ *
+ * Resources:
+ * - None (pure computation, also built on the host)
+ ******************************************************************************
+ */
+
+#include "biquad.h"
+
+#include <math.h>
+#include <stddef.h>
+
+/* Preprocessor defines ---------------------------------------------------- */
+/**
+ * @brief Largest post shift (coefficient range +-128).
+ */
+#define BIQUAD_MAX_POST_SHIFT   7U
+
+/**
+ * @brief Saturates a 64 bit value to int32.
+ */
+#define BIQUAD_SAT32(value) \
+    (((value) > INT32_MAX) ? INT32_MAX : (((value) < INT32_MIN) ? INT32_MIN : (int32_t)(value)))
+
+/* Static function prototypes ----------------------------------------------- */
+static float biquad_gain(const float *pf_coeffs);
+
+/* Public functions --------------------------------------------------------- */
+HAL_StatusTypeDef biquad_f32_init(biquad_f32_t *filter, uint8_t u8_stages, const biquad_coeffs_t *coeffs)
+{
+    if ((u8_stages == 0u) || (u8_stages > BIQUAD_MAX_STAGES) || (coeffs == NULL)) {
+        return HAL_ERROR;
+    }
+
+    filter->u8_stages = u8_stages;
+    for (uint8_t s = 0u; s < u8_stages; s++) {
+        float *pf_c = &filter->f_coeffs[5u * s];
+
+        pf_c[0] = coeffs[s].f_b0;
+        pf_c[1] = coeffs[s].f_b1;
+        pf_c[2] = coeffs[s].f_b2;
+        pf_c[3] = coeffs[s].f_a1;
+        pf_c[4] = coeffs[s].f_a2;
+        filter->f_state[2u * s]      = 0.0f;
+        filter->f_state[2u * s + 1u] = 0.0f;
+    }
+
+    return HAL_OK;
+}
+
+void biquad_f32_process(biquad_f32_t *filter, const float *pf_in, float *pf_out, uint32_t u32_count)
+{
+    const float *pf_src = pf_in;
+
+    /* Section by section over the whole block, coefficients in registers */
+    for (uint8_t s = 0u; s < filter->u8_stages; s++) {
+        const float *pf_c = &filter->f_coeffs[5u * s];
+        float f_b0 = pf_c[0];
+        float f_b1 = pf_c[1];
+        float f_b2 = pf_c[2];
+        float f_a1 = pf_c[3];
+        float f_a2 = pf_c[4];
+        float f_d1 = filter->f_state[2u * s];
+        float f_d2 = filter->f_state[2u * s + 1u];
+
+        for (uint32_t i = 0u; i < u32_count; i++) {
+            float f_x = pf_src[i];
+            float f_y = f_b0 * f_x + f_d1;
+
+            f_d1 = f_b1 * f_x + f_a1 * f_y + f_d2;
+            f_d2 = f_b2 * f_x + f_a2 * f_y;
+            pf_out[i] = f_y;
+        }
+
+        filter->f_state[2u * s]      = f_d1;
+        filter->f_state[2u * s + 1u] = f_d2;
+        pf_src = pf_out;
+    }
+}
+
+void biquad_f32_settle(biquad_f32_t *filter, float f_x)
+{
+    for (uint8_t s = 0u; s < filter->u8_stages; s++) {
+        const float *pf_c = &filter->f_coeffs[5u * s];
+        float f_y = biquad_gain(pf_c) * f_x;
+        float f_d2 = pf_c[2] * f_x + pf_c[4] * f_y;
+
+        filter->f_state[2u * s]      = f_y - pf_c[0] * f_x;
+        filter->f_state[2u * s + 1u] = f_d2;
+        f_x = f_y;
+    }
+}
+
+HAL_StatusTypeDef biquad_q31_init(biquad_q31_t *filter, uint8_t u8_stages, const biquad_coeffs_t *coeffs,
+                                  uint8_t u8_post_shift)
+{
+    float f_scale;
+
+    if ((u8_stages == 0u) || (u8_stages > BIQUAD_MAX_STAGES) || (coeffs == NULL) ||
+        (u8_post_shift > BIQUAD_MAX_POST_SHIFT)) {
+        return HAL_ERROR;
+    }
+
+    f_scale = 2147483648.0f / (float)(1UL << u8_post_shift);
+    for (uint8_t s = 0u; s < u8_stages; s++) {
+        const float f_c[5] = { coeffs[s].f_b0, coeffs[s].f_b1, coeffs[s].f_b2, coeffs[s].f_a1, coeffs[s].f_a2 };
+
+        for (uint8_t i = 0u; i < 5u; i++) {
+            float f_q = f_c[i] * f_scale;
+
+            /* 2^31 itself is not representable */
+            if ((f_q >= 2147483648.0f) || (f_q < -2147483648.0f)) {
+                return HAL_ERROR;
+            }
+            filter->i32_coeffs[5u * s + i] = (int32_t)((f_q < 0.0f) ? (f_q - 0.5f) : (f_q + 0.5f));
+        }
+    }
+    for (uint8_t i = 0u; i < 4u * BIQUAD_MAX_STAGES; i++) {
+        filter->i32_state[i] = 0;
+    }
+    filter->u8_stages     = u8_stages;
+    filter->u8_post_shift = u8_post_shift;
+
+    return HAL_OK;
+}
+
+void biquad_q31_process(biquad_q31_t *filter, const int32_t *pi32_in, int32_t *pi32_out, uint32_t u32_count)
+{
+    const int32_t *pi32_src = pi32_in;
+    uint8_t u8_shift = (uint8_t)(31u - filter->u8_post_shift);
+
+    for (uint8_t s = 0u; s < filter->u8_stages; s++) {
+        const int32_t *pi32_c = &filter->i32_coeffs[5u * s];
+        int32_t *pi32_state = &filter->i32_state[4u * s];
+        int32_t i32_x1 = pi32_state[0];
+        int32_t i32_x2 = pi32_state[1];
+        int32_t i32_y1 = pi32_state[2];
+        int32_t i32_y2 = pi32_state[3];
+
+        for (uint32_t i = 0u; i < u32_count; i++) {
+            int32_t i32_x = pi32_src[i];
+            int64_t i64_acc = (int64_t)pi32_c[0] * i32_x;
+            int32_t i32_y;
+
+            i64_acc += (int64_t)pi32_c[1] * i32_x1;
+            i64_acc += (int64_t)pi32_c[2] * i32_x2;
+            i64_acc += (int64_t)pi32_c[3] * i32_y1;
+            i64_acc += (int64_t)pi32_c[4] * i32_y2;
+            i64_acc >>= u8_shift;
+            i32_y = BIQUAD_SAT32(i64_acc);
+
+            i32_x2 = i32_x1;
+            i32_x1 = i32_x;
+            i32_y2 = i32_y1;
+            i32_y1 = i32_y;
+            pi32_out[i] = i32_y;
+        }
+
+        pi32_state[0] = i32_x1;
+        pi32_state[1] = i32_x2;
+        pi32_state[2] = i32_y1;
+        pi32_state[3] = i32_y2;
+        pi32_src = pi32_out;
+    }
+}
+
+void biquad_q31_settle(biquad_q31_t *filter, int32_t i32_x)
+{
+    float f_scale = (float)(1UL << filter->u8_post_shift) / 2147483648.0f;
+
+    for (uint8_t s = 0u; s < filter->u8_stages; s++) {
+        int32_t *pi32_state = &filter->i32_state[4u * s];
+        float f_c[5];
+        float f_y;
+
+        for (uint8_t i = 0u; i < 5u; i++) {
+            f_c[i] = (float)filter->i32_coeffs[5u * s + i] * f_scale;
+        }
+        f_y = biquad_gain(f_c) * (float)i32_x;
+        if (f_y > 2147483520.0f) {
+            f_y = 2147483520.0f;
+        } else if (f_y < -2147483648.0f) {
+            f_y = -2147483648.0f;
+        }
+
+        pi32_state[0] = i32_x;
+        pi32_state[1] = i32_x;
+        pi32_state[2] = (int32_t)f_y;
+        pi32_state[3] = (int32_t)f_y;
+        i32_x = (int32_t)f_y;
+    }
+}
+
+HAL_StatusTypeDef biquad_design_lowpass(biquad_coeffs_t *coeffs, float f_cutoff_hz, float f_rate_hz, float f_q)
+{
+    float f_w0;
+    float f_cos;
+    float f_alpha;
+    float f_a0;
+
+    if ((f_rate_hz <= 0.0f) || (f_cutoff_hz <= 0.0f) || (f_cutoff_hz >= 0.5f * f_rate_hz) || (f_q <= 0.0f)) {
+        return HAL_ERROR;
+    }
+
+    f_w0    = 2.0f * 3.14159265f * f_cutoff_hz / f_rate_hz;
+    f_cos   = cosf(f_w0);
+    f_alpha = sinf(f_w0) / (2.0f * f_q);
+    f_a0    = 1.0f + f_alpha;
+
+    coeffs->f_b0 = 0.5f * (1.0f - f_cos) / f_a0;
+    coeffs->f_b1 = (1.0f - f_cos) / f_a0;
+    coeffs->f_b2 = coeffs->f_b0;
+    /* CMSIS sign: y += a1 y[n-1] + a2 y[n-2] */
+    coeffs->f_a1 = 2.0f * f_cos / f_a0;
+    coeffs->f_a2 = -(1.0f - f_alpha) / f_a0;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef biquad_design_butterworth(biquad_coeffs_t *coeffs, uint8_t u8_stages, float f_cutoff_hz,
+                                            float f_rate_hz)
+{
+    float f_order = 2.0f * (float)u8_stages;
+
+    if ((u8_stages == 0u) || (u8_stages > BIQUAD_MAX_STAGES)) {
+        return HAL_ERROR;
+    }
+
+    /* Pole pairs of the analog prototype: Q = 1 / (2 sin((2k + 1) pi / 2n)) */
+    for (uint8_t k = 0u; k < u8_stages; k++) {
+        float f_q = 1.0f / (2.0f * sinf((2.0f * (float)k + 1.0f) * 3.14159265f / (2.0f * f_order)));
+
+        if (biquad_design_lowpass(&coeffs[k], f_cutoff_hz, f_rate_hz, f_q) != HAL_OK) {
+            return HAL_ERROR;
+        }
+    }
+
+    return HAL_OK;
+}
+
+/* Static functions --------------------------------------------------------- */
+/**
+ * @brief DC gain of one section.
+ *
+ * @param pf_coeffs b0 b1 b2 a1 a2
+ * @return (b0 + b1 + b2) / (1 - a1 - a2)
+ */
+static float biquad_gain(const float *pf_coeffs)
+{
+    return (pf_coeffs[0] + pf_coeffs[1] + pf_coeffs[2]) / (1.0f - pf_coeffs[3] - pf_coeffs[4]);
+}
@@ -0,0 +1,178 @@
+/**
+ ******************************************************************************
+ * @file        biquad.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the biquad filter cascades.
+ *
+ * @details
+ * Second order IIR sections in series for sharp low-pass responses at a
+ * few multiply-accumulates per sample, instead of long moving averages:
+ * a fourth order Butterworth (two sections) costs 10 MACs per sample
+ * where a boxcar of comparable stop band needs dozens of taps.
+ *
+ * Two implementations with the coefficient and state layout of the
+ * CMSIS-DSP functions arm_biquad_cascade_df2T_f32() and
+ * arm_biquad_cascade_df1_q31(), so they can be swapped for the library
+ * once it is part of the build:
+ *
+ *  - biquad_f32_t: transposed direct form II in float (FPU), two state
+ *    values per section,
+ *  - biquad_q31_t: direct form I in Q31 with a 64 bit accumulator and a
+ *    post shift (coefficients scaled by 2^-post_shift, so |b1| up to 2
+ *    fits with shift 1), four state values per section; the result is
+ *    saturated.
+ *
+ * Per section: y = b0 x[n] + b1 x[n-1] + b2 x[n-2] + a1 y[n-1] + a2 y[n-2],
+ * i.e. a1 / a2 carry the opposite sign of the usual transfer function
+ * denominator (CMSIS convention). biquad_design_lowpass() and
+ * biquad_design_butterworth() compute the sections.
+ *
+ * The process functions work on blocks (e.g. one DMA half buffer) and
+ * keep the state between calls; input and output may be the same array.
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - Float DF2T and Q31 DF1 cascades of up to BIQUAD_MAX_STAGES sections
+ *  - Block processing, in place
+ *  - Low-pass design (RBJ) and Butterworth cascades of even order
+ *
+ ******************************************************************************
+ */
+
+#ifndef BIQUAD_BIQUAD_H_
+#define BIQUAD_BIQUAD_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief Maximum sections of one cascade (order 2 * BIQUAD_MAX_STAGES).
+ */
+#define BIQUAD_MAX_STAGES       4U
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Coefficients of one section, CMSIS order and sign.
+ */
+typedef struct {
+    float f_b0;
+    float f_b1;
+    float f_b2;
+    float f_a1;
+    float f_a2;
+} biquad_coeffs_t;
+
+/**
+ * @brief Float cascade, transposed direct form II.
+ */
+typedef struct {
+    uint8_t u8_stages;
+    float   f_coeffs[5U * BIQUAD_MAX_STAGES];  /**< b0 b1 b2 a1 a2 per section */
+    float   f_state[2U * BIQUAD_MAX_STAGES];   /**< d1 d2 per section          */
+} biquad_f32_t;
+
+/**
+ * @brief Q31 cascade, direct form I.
+ */
+typedef struct {
+    uint8_t u8_stages;
+    uint8_t u8_post_shift;
+    int32_t i32_coeffs[5U * BIQUAD_MAX_STAGES];  /**< Q31 * 2^-post_shift    */
+    int32_t i32_state[4U * BIQUAD_MAX_STAGES];   /**< x1 x2 y1 y2 per section */
+} biquad_q31_t;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Sets up a float cascade and clears its state.
+ *
+ * @param filter    Cascade
+ * @param u8_stages 1 .. BIQUAD_MAX_STAGES
+ * @param coeffs    u8_stages sections
+ * @return HAL_OK, HAL_ERROR for an invalid number of sections
+ */
+HAL_StatusTypeDef biquad_f32_init(biquad_f32_t *filter, uint8_t u8_stages, const biquad_coeffs_t *coeffs);
+
+/**
+ * @brief Filters a block.
+ *
+ * @param filter    Cascade
+ * @param pf_in     Input samples
+ * @param pf_out    Output samples (may be pf_in)
+ * @param u32_count Number of samples
+ * @return None
+ */
+void biquad_f32_process(biquad_f32_t *filter, const float *pf_in, float *pf_out, uint32_t u32_count);
+
+/**
+ * @brief Sets the state to the steady state of a constant input, e.g.
+ *        the first sample, so the output does not start at 0.
+ *
+ * @param filter Cascade
+ * @param f_x    Constant input
+ * @return None
+ */
+void biquad_f32_settle(biquad_f32_t *filter, float f_x);
+
+/**
+ * @brief Sets up a Q31 cascade from float sections and clears its state.
+ *
+ * @param filter        Cascade
+ * @param u8_stages     1 .. BIQUAD_MAX_STAGES
+ * @param coeffs        u8_stages sections
+ * @param u8_post_shift Coefficient range 2^post_shift (1 for low-pass
+ *                      sections, |b1|, |a1| < 2)
+ * @return HAL_OK, HAL_ERROR for an invalid number of sections, a shift
+ *         above 7 or a coefficient outside the range
+ */
+HAL_StatusTypeDef biquad_q31_init(biquad_q31_t *filter, uint8_t u8_stages, const biquad_coeffs_t *coeffs,
+                                  uint8_t u8_post_shift);
+
+/**
+ * @brief Filters a block.
+ *
+ * @param filter    Cascade
+ * @param pi32_in   Input samples (Q31 or any integer scale with headroom
+ *                  for the overshoot of the response)
+ * @param pi32_out  Output samples (may be pi32_in)
+ * @param u32_count Number of samples
+ * @return None
+ */
+void biquad_q31_process(biquad_q31_t *filter, const int32_t *pi32_in, int32_t *pi32_out, uint32_t u32_count);
+
+/**
+ * @brief Sets the state to the steady state of a constant input.
+ *
+ * @param filter Cascade
+ * @param i32_x  Constant input
+ * @return None
+ */
+void biquad_q31_settle(biquad_q31_t *filter, int32_t i32_x);
+
+/**
+ * @brief Designs a second order low-pass (RBJ cookbook, bilinear
+ *        transform with prewarping).
+ *
+ * @param coeffs      Result
+ * @param f_cutoff_hz Corner frequency, below f_rate_hz / 2
+ * @param f_rate_hz   Sample rate
+ * @param f_q         Quality factor (0.7071 Butterworth)
+ * @return HAL_OK, HAL_ERROR for a corner outside (0, rate / 2) or Q <= 0
+ */
+HAL_StatusTypeDef biquad_design_lowpass(biquad_coeffs_t *coeffs, float f_cutoff_hz, float f_rate_hz, float f_q);
+
+/**
+ * @brief Designs a Butterworth low-pass of order 2 * u8_stages.
+ *
+ * @param coeffs      u8_stages sections
+ * @param u8_stages   1 .. BIQUAD_MAX_STAGES
+ * @param f_cutoff_hz -3 dB frequency
+ * @param f_rate_hz   Sample rate
+ * @return HAL_OK, HAL_ERROR for invalid arguments
+ */
+HAL_StatusTypeDef biquad_design_butterworth(biquad_coeffs_t *coeffs, uint8_t u8_stages, float f_cutoff_hz,
+                                            float f_rate_hz);
+
+#endif /* BIQUAD_BIQUAD_H_ */
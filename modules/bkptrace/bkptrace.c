@@ -0,0 +1,214 @@
+/**
+ ******************************************************************************
+ * @file        bkptrace.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Crash-persistent event trace in the backup SRAM.
+ *
+ * Functionality:
+ * - Ring header and entries in the backup SRAM, only the write index of
+ *   this boot is kept in RAM
+ * - Entries of the previous boots: from the oldest one not overwritten
+ *   (head - BKPTRACE_ENTRIES) up to the head at bkptrace_init(), counted
+ *   back from there so an index keeps its entry while the boot goes on
+ *
+ * Resources:
+ * - BKPSRAM (top BKPTRACE_ENTRIES * 12 + 16 bytes), PWR backup access
+ *   (DBP) and backup regulator (BRE) stay enabled
+ ******************************************************************************
+ */
+
+#include "bkptrace.h"
+
+/* Preprocessor Defines ----------------------------------------------------- */
+/**
+ * @brief Identifies a set up ring ("BTR1").
+ */
+#define BKPTRACE_MAGIC          0x31525442UL
+
+/* Static module variables -------------------------------------------------- */
+/**
+ * @brief Head of the ring at bkptrace_init(): end of the previous boots.
+ */
+static uint32_t g_u32_bkptrace_boot_head;
+
+/**
+ * @brief State of this start.
+ */
+static bkptrace_info_t g_bkptrace_info;
+
+/**
+ * @brief Event names, index bkptrace_event_t.
+ */
+static const char * const g_pch_bkptrace_names[BKPTRACE_EV_COUNT] = {
+    "?",
+    "boot",
+    "sched_begin",
+    "sched_end",
+    "fan_step",
+    "fan_stall",
+    "lcd_band",
+    "lcd_frame",
+    "env_error",
+    "env_hang",
+    "env_recover",
+    "fan_guard"
+};
+
+/* Static function prototypes ----------------------------------------------- */
+static uint32_t bkptrace_first(void);
+static uint16_t bkptrace_history(void);
+static void bkptrace_hex(fmt_t *fmt, uint32_t u32_value);
+
+/* Public functions --------------------------------------------------------- */
+HAL_StatusTypeDef bkptrace_init(void)
+{
+    bkptrace_ring_t *ring = BKPTRACE_RING;
+    HAL_StatusTypeDef status;
+
+    __HAL_RCC_PWR_CLK_ENABLE();
+    HAL_PWR_EnableBkUpAccess();
+    __HAL_RCC_BKPSRAM_CLK_ENABLE();
+    status = HAL_PWREx_EnableBkUpReg();
+
+    g_bkptrace_info.u8_restored = (ring->u32_magic == BKPTRACE_MAGIC) && (ring->u32_entries == BKPTRACE_ENTRIES);
+    if (!g_bkptrace_info.u8_restored) {
+        ring->u32_head    = 0u;
+        ring->u32_boots   = 0u;
+        ring->u32_entries = BKPTRACE_ENTRIES;
+        ring->u32_magic   = BKPTRACE_MAGIC;
+    }
+
+    ring->u32_boots++;
+    g_u32_bkptrace_boot_head       = ring->u32_head;
+    g_bkptrace_info.u32_boots       = ring->u32_boots;
+    g_bkptrace_info.u32_reset_flags = RCC->CSR;
+
+    BKPTRACE_EVENT(BKPTRACE_EV_BOOT, g_bkptrace_info.u32_reset_flags);
+
+    return status;
+}
+
+void bkptrace_get_info(bkptrace_info_t *info)
+{
+    *info = g_bkptrace_info;
+    info->u16_history = bkptrace_history();
+}
+
+HAL_StatusTypeDef bkptrace_format(uint16_t u16_index, fmt_t *fmt)
+{
+    const bkptrace_ring_t *ring = BKPTRACE_RING;
+    uint32_t u32_first;
+    uint32_t u32_index = g_u32_bkptrace_boot_head - 1u - u16_index;
+
+    if (u16_index >= bkptrace_history()) {
+        return HAL_ERROR;
+    }
+
+    /* Copy first, then check that the new boot did not overwrite it meanwhile */
+    bkptrace_entry_t entry = ring->entries[u32_index & (BKPTRACE_ENTRIES - 1u)];
+    uint32_t u32_before = ring->entries[(u32_index - 1u) & (BKPTRACE_ENTRIES - 1u)].u32_stamp;
+    uint32_t u32_delta = 0u;
+
+    u32_first = bkptrace_first();
+    if (u32_first > u32_index) {
+        return HAL_ERROR;
+    }
+    /* The timebase restarts with every boot */
+    if ((u32_index > u32_first) && (entry.u16_id != BKPTRACE_EV_BOOT)) {
+        u32_delta = entry.u32_stamp - u32_before;
+    }
+
+    fmt_u32(fmt, u16_index, 3u, ' ');
+    fmt_u32(fmt, entry.u32_stamp, 11u, ' ');
+    fmt_str(fmt, " +");
+    fmt_u32(fmt, u32_delta, 0u, ' ');
+    fmt_pad(fmt, 25u);
+    fmt_u32(fmt, entry.u16_exception, 3u, ' ');
+    fmt_char(fmt, ' ');
+    if (entry.u16_id < BKPTRACE_EV_COUNT) {
+        fmt_str(fmt, g_pch_bkptrace_names[entry.u16_id]);
+    } else {
+        fmt_str(fmt, "user ");
+        fmt_u32(fmt, entry.u16_id, 0u, ' ');
+    }
+    fmt_pad(fmt, 42u);
+    bkptrace_hex(fmt, entry.u32_arg);
+    fmt_char(fmt, ' ');
+    fmt_u32(fmt, entry.u32_arg, 0u, ' ');
+
+    return HAL_OK;
+}
+
+void bkptrace_dump(bkptrace_putc_t putc)
+{
+    char buffer[80];
+    fmt_t fmt;
+
+    if (putc == NULL) {
+        return;
+    }
+
+    fmt_init(&fmt, buffer, sizeof(buffer));
+    fmt_str(&fmt, "bkptrace boot ");
+    fmt_u32(&fmt, g_bkptrace_info.u32_boots, 0u, ' ');
+    fmt_str(&fmt, g_bkptrace_info.u8_restored ? "  reset " : "  new ring  reset ");
+    bkptrace_hex(&fmt, g_bkptrace_info.u32_reset_flags);
+    fmt_str(&fmt, "\r\n  #   stamp_us +delta_us exc event        arg\r\n");
+    for (const char *pch = fmt_get(&fmt); *pch != '\0'; pch++) {
+        putc(*pch);
+    }
+
+    for (uint16_t i = bkptrace_history(); i-- > 0u; ) {
+        fmt_init(&fmt, buffer, sizeof(buffer));
+        if (bkptrace_format(i, &fmt) != HAL_OK) {
+            continue;
+        }
+        fmt_str(&fmt, "\r\n");
+        for (const char *pch = fmt_get(&fmt); *pch != '\0'; pch++) {
+            putc(*pch);
+        }
+    }
+}
+
+/* Static functions --------------------------------------------------------- */
+/**
+ * @brief Returns the number of the oldest entry still in the ring.
+ *
+ * @return Entry number (head - BKPTRACE_ENTRIES, 0 before the first wrap)
+ */
+static uint32_t bkptrace_first(void)
+{
+    uint32_t u32_head = BKPTRACE_RING->u32_head;
+
+    return (u32_head > BKPTRACE_ENTRIES) ? (u32_head - BKPTRACE_ENTRIES) : 0u;
+}
+
+/**
+ * @brief Returns the number of entries of the previous boots that are
+ *        still in the ring.
+ *
+ * @return 0 .. BKPTRACE_ENTRIES
+ */
+static uint16_t bkptrace_history(void)
+{
+    uint32_t u32_first = bkptrace_first();
+
+    return (u32_first < g_u32_bkptrace_boot_head) ? (uint16_t)(g_u32_bkptrace_boot_head - u32_first) : 0u;
+}
+
+/**
+ * @brief Appends a value as 0x and eight hex digits.
+ *
+ * @param fmt       Text output
+ * @param u32_value Value
+ * @return None
+ */
+static void bkptrace_hex(fmt_t *fmt, uint32_t u32_value)
+{
+    fmt_str(fmt, "0x");
+    for (int8_t i = 28; i >= 0; i -= 4) {
+        fmt_char(fmt, "0123456789abcdef"[(u32_value >> i) & 0xFu]);
+    }
+}
@@ -0,0 +1,234 @@
+/**
+ ******************************************************************************
+ * @file        bkptrace.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the crash-persistent event trace in the
+ *              backup SRAM.
+ *
+ * @details
+ * The SWO trace (modules/trace) needs a debugger on the board while the
+ * failure happens. This ring keeps the last BKPTRACE_ENTRIES events in
+ * the 4 KB backup SRAM instead: a reset (watchdog, hard fault handler,
+ * NRST, brown-out reset) leaves its contents alone, the next start reads
+ * what the firmware did up to the failure.
+ *
+ * An event is a timestamp (timebase_now32(), microseconds), an event
+ * number, the active exception (IPSR, 0 in thread mode) and a 32 bit
+ * argument. BKPTRACE_EVENT() writes it inline with interrupts masked for
+ * about a dozen cycles, from any context; with BKPTRACE_ENABLE 0 the
+ * trace points are removed.
+ *
+ * bkptrace_init() opens a new boot: the entries already in the ring are
+ * the history up to this start, separated by BKPTRACE_EV_BOOT entries
+ * (argument RCC->CSR: the reset flags, nobody clears them, so they add
+ * up until the next power-on reset). The entries the new boot has not
+ * overwritten yet stay readable (bkptrace_format(), bkptrace_dump());
+ * read them early, the ring wraps after BKPTRACE_ENTRIES events.
+ *
+ * The ring sits at the top of the backup SRAM, modules/env_sensor keeps
+ * its warm start entries at the bottom. The backup regulator is switched
+ * on: with a battery at VBAT the ring also survives losing VDD, on the
+ * discovery board (VBAT tied to VDD) it survives every reset but not a
+ * power cycle.
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - BKPTRACE_ENTRIES entries of 12 bytes, oldest overwritten first
+ *  - Preinstrumented: scheduler task begin / end, fan control step and
+ *    stall, lcd band and governor frames, env_sensor bus errors, hangs
+ *    and recoveries
+ *  - Ring validated by magic and size, set up empty otherwise (first
+ *    start, backup domain lost)
+ *  - One text line per entry of the previous boots: timestamp, distance
+ *    to the entry before, exception, event name, argument
+ *
+ * Event arguments:
+ *  - BKPTRACE_EV_BOOT:         RCC->CSR at bkptrace_init()
+ *  - BKPTRACE_EV_SCHED_BEGIN:  task id
+ *  - BKPTRACE_EV_SCHED_END:    task id [31:24], run time in us [23:0]
+ *  - BKPTRACE_EV_FAN_STEP:     setpoint rpm [31:16], measured rpm [15:0]
+ *  - BKPTRACE_EV_FAN_STALL:    stalls in a row so far, target rpm [31:8]
+ *  - BKPTRACE_EV_LCD_BAND:     lcd_band_render() time in us
+ *  - BKPTRACE_EV_LCD_FRAME:    lcd_governor frame CPU time in us
+ *  - BKPTRACE_EV_ENV_BUS_*:    address of the I2C peripheral or SPI handle
+ *  - BKPTRACE_EV_FAN_GUARD:    fault bits [7:0] (FAN_GUARD_*), RPM [31:8]
+ *
+ * Stamps need the timebase (timebase_init()), without it they are 0 and
+ * only the order of the entries is known.
+ *
+ ******************************************************************************
+ */
+
+#ifndef BKPTRACE_BKPTRACE_H_
+#define BKPTRACE_BKPTRACE_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+#include "fmt/fmt.h"
+#if BKPTRACE_ENABLE
+#include "timebase/timebase.h"
+#endif
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief 1 to compile the trace points in, 0 removes them.
+ */
+#ifndef BKPTRACE_ENABLE
+#define BKPTRACE_ENABLE         0
+#endif
+
+/**
+ * @brief Entries of the ring, a power of two.
+ */
+#ifndef BKPTRACE_ENTRIES
+#define BKPTRACE_ENTRIES        256U
+#endif
+
+/**
+ * @brief Size of the backup SRAM.
+ */
+#define BKPTRACE_BKPSRAM_SIZE   0x1000U
+
+/**
+ * @brief Offset of the ring in the backup SRAM (header and entries up to
+ *        its end); everything below is free for other modules.
+ */
+#define BKPTRACE_BKPSRAM_OFFSET (BKPTRACE_BKPSRAM_SIZE - 16U - 12U * BKPTRACE_ENTRIES)
+
+/**
+ * @brief The ring.
+ */
+#define BKPTRACE_RING           ((bkptrace_ring_t *)(BKPSRAM_BASE + BKPTRACE_BKPSRAM_OFFSET))
+
+#if ((BKPTRACE_ENTRIES & (BKPTRACE_ENTRIES - 1U)) != 0U) || (BKPTRACE_ENTRIES < 16U) || (BKPTRACE_ENTRIES > 256U)
+#error "BKPTRACE_ENTRIES must be a power of two from 16 to 256"
+#endif
+
+#if BKPTRACE_ENABLE
+#define BKPTRACE_EVENT(id, arg) bkptrace_write((id), (uint32_t)(arg))
+#else
+#define BKPTRACE_EVENT(id, arg) do { } while (0)
+#endif
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Event numbers.
+ */
+typedef enum {
+    BKPTRACE_EV_BOOT = 1,           /**< bkptrace_init(), reset flags      */
+    BKPTRACE_EV_SCHED_BEGIN,        /**< Scheduler starts a task           */
+    BKPTRACE_EV_SCHED_END,          /**< Task returned                     */
+    BKPTRACE_EV_FAN_STEP,           /**< Fan PI controller step            */
+    BKPTRACE_EV_FAN_STALL,          /**< Fan stall or failed kick          */
+    BKPTRACE_EV_LCD_BAND,           /**< Band renderer frame               */
+    BKPTRACE_EV_LCD_FRAME,          /**< Frame of the lcd governor         */
+    BKPTRACE_EV_ENV_BUS_ERROR,      /**< env_sensor transfer failed        */
+    BKPTRACE_EV_ENV_BUS_HANG,       /**< env_sensor transfer timed out     */
+    BKPTRACE_EV_ENV_BUS_RECOVER,    /**< env_sensor bus reinitialised      */
+    BKPTRACE_EV_FAN_GUARD,          /**< Fan guard tripped (full duty)     */
+    BKPTRACE_EV_COUNT,
+    BKPTRACE_EV_USER = 0x100        /**< First number for the application  */
+} bkptrace_event_t;
+
+/**
+ * @brief One event (backup SRAM).
+ */
+typedef struct {
+    uint32_t u32_stamp;             /**< timebase_now32()                  */
+    uint16_t u16_id;                /**< bkptrace_event_t                  */
+    uint16_t u16_exception;         /**< IPSR, 0 in thread mode            */
+    uint32_t u32_arg;               /**< Argument of the event             */
+} bkptrace_entry_t;
+
+/**
+ * @brief Header and entries at BKPTRACE_RING.
+ */
+typedef struct {
+    uint32_t u32_magic;
+    uint32_t u32_entries;           /**< BKPTRACE_ENTRIES of the layout    */
+    uint32_t u32_head;              /**< Entries written, next one at head modulo size */
+    uint32_t u32_boots;             /**< bkptrace_init() calls             */
+    bkptrace_entry_t entries[BKPTRACE_ENTRIES];
+} bkptrace_ring_t;
+
+/**
+ * @brief State of the ring.
+ */
+typedef struct {
+    uint32_t u32_boots;             /**< Starts since the ring was set up  */
+    uint32_t u32_reset_flags;       /**< RCC->CSR of this start            */
+    uint16_t u16_history;           /**< Entries of the previous boots still readable */
+    uint8_t  u8_restored;           /**< 1: ring found valid, 0: set up empty */
+} bkptrace_info_t;
+
+/**
+ * @brief Character output function (same signature as __io_putchar()).
+ */
+typedef int (*bkptrace_putc_t)(int ch);
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Enables the backup SRAM and the backup regulator, checks the
+ *        ring (set up empty if invalid) and writes the BKPTRACE_EV_BOOT
+ *        entry. Once per start, before the first trace point.
+ *
+ * @return HAL_OK, HAL_TIMEOUT if the backup regulator did not get ready
+ *         (the ring is used anyway, it survives resets)
+ */
+HAL_StatusTypeDef bkptrace_init(void);
+
+/**
+ * @brief Returns the state of the ring.
+ *
+ * @param info Destination
+ * @return None
+ */
+void bkptrace_get_info(bkptrace_info_t *info);
+
+/**
+ * @brief Formats an entry of the previous boots as text (no line end).
+ *
+ * @param u16_index 0 = last entry before this start, counting back
+ * @param fmt       Text output, at least 64 characters
+ * @return HAL_OK, HAL_ERROR if the entry does not exist (any more)
+ */
+HAL_StatusTypeDef bkptrace_format(uint16_t u16_index, fmt_t *fmt);
+
+/**
+ * @brief Prints all readable entries of the previous boots, oldest
+ *        first, one line each.
+ *
+ * @param putc Character output (UART, ITM, ...)
+ * @return None
+ */
+void bkptrace_dump(bkptrace_putc_t putc);
+
+#if BKPTRACE_ENABLE
+/**
+ * @brief Writes an event (BKPTRACE_EVENT()). Any context.
+ *
+ * @param u16_id  Event number
+ * @param u32_arg Argument
+ * @return None
+ */
+static inline void bkptrace_write(uint16_t u16_id, uint32_t u32_arg)
+{
+    bkptrace_ring_t *ring = BKPTRACE_RING;
+    uint32_t u32_primask = __get_PRIMASK();
+
+    __disable_irq();
+    uint32_t u32_head = ring->u32_head;
+    bkptrace_entry_t *entry = &ring->entries[u32_head & (BKPTRACE_ENTRIES - 1U)];
+
+    entry->u32_stamp     = timebase_now32();
+    entry->u16_id        = u16_id;
+    entry->u16_exception = (uint16_t)__get_IPSR();
+    entry->u32_arg       = u32_arg;
+    ring->u32_head       = u32_head + 1U;
+    __set_PRIMASK(u32_primask);
+}
+#endif
+
+#endif /* BKPTRACE_BKPTRACE_H_ */
@@ -49,9 +49,15 @@
 #define FILTER_STANDBY_SETTINGS  UINT8_C(0x18)
 
 /*!
- * @brief This internal API puts the device to sleep mode.
+ * @brief This internal API writes the selected settings and the power mode
+ * in one burst, based on the register shadow.
  *
- * @param[in] dev : Structure instance of bme280_dev.
+ * @param[in] desired_settings : Variable used to select the settings which
+ * are to be set.
+ * @param[in] settings         : Pointer variable which contains the settings to
+ * be set in the sensor, may be NULL without desired settings.
+ * @param[in] sensor_mode      : Power mode after the write.
+ * @param[in,out] dev          : Structure instance of bme280_dev.
  *
  * @return Result of API execution status.
  *
@@ -60,22 +66,21 @@
  * @retval < 0 -> Fail.
  *
  */
-static int8_t put_device_to_sleep(struct bme280_dev *dev);
+static int8_t write_sensor_config(uint8_t desired_settings,
+                                  const struct bme280_settings *settings,
+                                  uint8_t sensor_mode,
+                                  struct bme280_dev *dev);
 
 /*!
- * @brief This internal API writes the power mode in the sensor.
- *
- * @param[in] dev         : Structure instance of bme280_dev.
- * @param[in] sensor_mode : Variable which contains the power mode to be set.
- *
- * @return Result of API execution status.
+ * @brief This internal API updates the register shadow after a register
+ * of the sensor has been read or written.
  *
- * @retval   0 -> Success.
- * @retval > 0 -> Warning.
- * @retval < 0 -> Fail.
+ * @param[in] reg_addr : Register address (with or without the SPI bit).
+ * @param[in] reg_data : Register value.
+ * @param[in,out] dev  : Structure instance of bme280_dev.
  *
  */
-static int8_t write_power_mode(uint8_t sensor_mode, struct bme280_dev *dev);
+static void update_shadow(uint8_t reg_addr, uint8_t reg_data, struct bme280_dev *dev);
 
 /*!
  * @brief This internal API is used to validate the device pointer for
@@ -157,63 +162,6 @@ static void parse_humidity_calib_data(const uint8_t *reg_data, struct bme280_dev
  */
 static uint8_t are_settings_changed(uint8_t sub_settings, uint8_t desired_settings);
 
-/*!
- * @brief This API sets the humidity over sampling settings of the sensor.
- *
- * @param[in] dev      : Structure instance of bme280_dev.
- * @param[in] settings : Pointer variable which contains the settings to
- * be set in the sensor.
- *
- * @return Result of API execution status
- *
- * @retval   0 -> Success.
- * @retval > 0 -> Warning.
- * @retval < 0 -> Fail.
- *
- */
-static int8_t set_osr_humidity_settings(const struct bme280_settings *settings, struct bme280_dev *dev);
-
-/*!
- * @brief This internal API sets the oversampling settings for pressure,
- * temperature and humidity in the sensor.
- *
- * @param[in] desired_settings : Variable used to select the settings which
- * are to be set.
- * @param[in] settings         : Pointer variable which contains the settings to
- * be set in the sensor.
- * @param[in] dev              : Structure instance of bme280_dev.
- *
- * @return Result of API execution status
- *
- * @retval   0 -> Success.
- * @retval > 0 -> Warning.
- * @retval < 0 -> Fail.
- *
- */
-static int8_t set_osr_settings(uint8_t desired_settings, const struct bme280_settings *settings,
-                               struct bme280_dev *dev);
-
-/*!
- * @brief This API sets the pressure and/or temperature oversampling settings
- * in the sensor according to the settings selected by the user.
- *
- * @param[in] dev : Structure instance of bme280_dev.
- * @param[in] desired_settings: variable to select the pressure and/or
- * temperature oversampling settings.
- * @param[in] settings : Pointer variable which contains the settings to
- * be set in the sensor.
- *
- * @return Result of API execution status
- *
- * @retval   0 -> Success.
- * @retval > 0 -> Warning.
- * @retval < 0 -> Fail.
- *
- */
-static int8_t set_osr_press_temp_settings(uint8_t desired_settings,
-                                          const struct bme280_settings *settings,
-                                          struct bme280_dev *dev);
-
 /*!
  * @brief This internal API fills the pressure oversampling settings provided by
  * the user in the data buffer so as to write in the sensor.
@@ -238,26 +186,6 @@ static void fill_osr_press_settings(uint8_t *reg_data, const struct bme280_setti
  */
 static void fill_osr_temp_settings(uint8_t *reg_data, const struct bme280_settings *settings);
 
-/*!
- * @brief This internal API sets the filter and/or standby duration settings
- * in the sensor according to the settings selected by the user.
- *
- * @param[in] dev : Structure instance of bme280_dev.
- * @param[in] settings : Pointer variable which contains the settings to
- * be set in the sensor.
- * @param[in] settings : Structure instance of bme280_settings.
- *
- * @return Result of API execution status
- *
- * @retval   0 -> Success.
- * @retval > 0 -> Warning.
- * @retval < 0 -> Fail.
- *
- */
-static int8_t set_filter_standby_settings(uint8_t desired_settings,
-                                          const struct bme280_settings *settings,
-                                          struct bme280_dev *dev);
-
 /*!
  * @brief This internal API fills the filter settings provided by the user
  * in the data buffer so as to write in the sensor.
@@ -303,23 +231,6 @@ static void parse_device_settings(const uint8_t *reg_data, struct bme280_setting
  */
 static void parse_sensor_data(const uint8_t *reg_data, struct bme280_uncomp_data *uncomp_data);
 
-/*!
- * @brief This internal API reloads the already existing device settings in the
- * sensor after soft reset.
- *
- * @param[in] dev : Structure instance of bme280_dev.
- * @param[in] settings : Pointer variable which contains the settings to
- * be set in the sensor.
- *
- * @return Result of API execution status
- *
- * @retval   0 -> Success.
- * @retval > 0 -> Warning.
- * @retval < 0 -> Fail.
- *
- */
-static int8_t reload_device_settings(const struct bme280_settings *settings, struct bme280_dev *dev);
-
 #ifdef BME280_DOUBLE_ENABLE
 
 /*!
@@ -449,6 +360,7 @@ int8_t bme280_init(struct bme280_dev *dev)
 int8_t bme280_get_regs(uint8_t reg_addr, uint8_t *reg_data, uint32_t len, struct bme280_dev *dev)
 {
     int8_t rslt;
+    uint32_t reg_addr_cnt;
 
     /* Check for null pointer in the device structure */
     rslt = null_ptr_check(dev);
@@ -469,6 +381,14 @@ int8_t bme280_get_regs(uint8_t reg_addr, uint8_t *reg_data, uint32_t len, struct
         {
             rslt = BME280_E_COMM_FAIL;
         }
+        else
+        {
+            /* Keep the shadow of ctrl_hum, ctrl_meas and config in step */
+            for (reg_addr_cnt = 0; (reg_addr_cnt < len) && (reg_addr + reg_addr_cnt <= 0xFF); reg_addr_cnt++)
+            {
+                update_shadow((uint8_t)(reg_addr + reg_addr_cnt), reg_data[reg_addr_cnt], dev);
+            }
+        }
     }
     else
     {
@@ -529,11 +449,21 @@ int8_t bme280_set_regs(uint8_t *reg_addr, const uint8_t *reg_data, uint32_t len,
 
             dev->intf_rslt = dev->write(reg_addr[0], temp_buff, temp_len, dev->intf_ptr);
 
-            /* Check for communication error */
+            /* Check for communication error, the register state is
+             * unknown after a failed write
+             */
             if (dev->intf_rslt != BME280_INTF_RET_SUCCESS)
             {
+                dev->shadow_valid = 0;
                 rslt = BME280_E_COMM_FAIL;
             }
+            else
+            {
+                for (reg_addr_cnt = 0; reg_addr_cnt < len; reg_addr_cnt++)
+                {
+                    update_shadow(reg_addr[reg_addr_cnt], reg_data[reg_addr_cnt], dev);
+                }
+            }
         }
         else
         {
@@ -557,35 +487,34 @@ int8_t bme280_set_sensor_settings(uint8_t desired_settings,
                                   struct bme280_dev *dev)
 {
     int8_t rslt;
-    uint8_t sensor_mode;
 
     if (settings != NULL)
     {
-        rslt = bme280_get_sensor_mode(&sensor_mode, dev);
+        /* Configuration is only taken over in sleep mode */
+        rslt = write_sensor_config(desired_settings, settings, BME280_POWERMODE_SLEEP, dev);
+    }
+    else
+    {
+        rslt = BME280_E_NULL_PTR;
+    }
 
-        if ((rslt == BME280_OK) && (sensor_mode != BME280_POWERMODE_SLEEP))
-        {
-            rslt = put_device_to_sleep(dev);
-        }
+    return rslt;
+}
 
-        if (rslt == BME280_OK)
-        {
-            /* Check if user wants to change oversampling
-             * settings
-             */
-            if (are_settings_changed(OVERSAMPLING_SETTINGS, desired_settings))
-            {
-                rslt = set_osr_settings(desired_settings, settings, dev);
-            }
+/*!
+ * @brief This API sets the oversampling, filter and standby duration
+ * settings and the power mode in one burst write.
+ */
+int8_t bme280_set_sensor_config(uint8_t desired_settings,
+                                const struct bme280_settings *settings,
+                                uint8_t sensor_mode,
+                                struct bme280_dev *dev)
+{
+    int8_t rslt;
 
-            /* Check if user wants to change filter and/or
-             * standby settings
-             */
-            if ((rslt == BME280_OK) && are_settings_changed(FILTER_STANDBY_SETTINGS, desired_settings))
-            {
-                rslt = set_filter_standby_settings(desired_settings, settings, dev);
-            }
-        }
+    if (settings != NULL)
+    {
+        rslt = write_sensor_config(desired_settings, settings, sensor_mode, dev);
     }
     else
     {
@@ -626,26 +555,7 @@ int8_t bme280_get_sensor_settings(struct bme280_settings *settings, struct bme28
  */
 int8_t bme280_set_sensor_mode(uint8_t sensor_mode, struct bme280_dev *dev)
 {
-    int8_t rslt;
-    uint8_t last_set_mode;
-
-    rslt = bme280_get_sensor_mode(&last_set_mode, dev);
-
-    /* If the sensor is not in sleep mode put the device to sleep
-     * mode
-     */
-    if ((rslt == BME280_OK) && (last_set_mode != BME280_POWERMODE_SLEEP))
-    {
-        rslt = put_device_to_sleep(dev);
-    }
-
-    /* Set the power mode */
-    if (rslt == BME280_OK)
-    {
-        rslt = write_power_mode(sensor_mode, dev);
-    }
-
-    return rslt;
+    return write_sensor_config(0, NULL, sensor_mode, dev);
 }
 
 /*!
@@ -704,6 +614,12 @@ int8_t bme280_soft_reset(struct bme280_dev *dev)
         }
     }
 
+    /* All control registers hold their reset value 0x00 now */
+    dev->shadow_regs[BME280_SHADOW_CTRL_HUM] = 0;
+    dev->shadow_regs[BME280_SHADOW_CTRL_MEAS] = 0;
+    dev->shadow_regs[BME280_SHADOW_CONFIG] = 0;
+    dev->shadow_valid = (rslt == BME280_OK) ? BME280_SHADOW_ALL : 0;
+
     return rslt;
 }
 
@@ -853,122 +769,144 @@ int8_t bme280_cal_meas_delay(uint32_t *max_delay, const struct bme280_settings *
 /**\name                        INTERNAL APIs                               */
 
 /*!
- * @brief This internal API sets the oversampling settings for pressure,
- * temperature and humidity in the sensor.
+ * @brief This internal API writes the selected settings and the power mode
+ * in one burst, based on the register shadow.
  */
-static int8_t set_osr_settings(uint8_t desired_settings, const struct bme280_settings *settings, struct bme280_dev *dev)
+static int8_t write_sensor_config(uint8_t desired_settings,
+                                  const struct bme280_settings *settings,
+                                  uint8_t sensor_mode,
+                                  struct bme280_dev *dev)
 {
-    int8_t rslt = BME280_W_INVALID_OSR_MACRO;
+    int8_t rslt = BME280_OK;
+    uint8_t reg_addr[4];
+    uint8_t reg_data[4];
+    uint8_t len = 0;
+    uint8_t ctrl_hum;
+    uint8_t ctrl_meas;
+    uint8_t config;
+    uint8_t last_ctrl_meas;
 
-    if (desired_settings & BME280_SEL_OSR_HUM)
+    /* Unknown register state: a single read of ctrl_hum .. config fills
+     * the shadow
+     */
+    if (dev->shadow_valid != BME280_SHADOW_ALL)
     {
-        rslt = set_osr_humidity_settings(settings, dev);
+        rslt = bme280_get_regs(BME280_REG_CTRL_HUM, reg_data, 4, dev);
     }
 
-    if (desired_settings & (BME280_SEL_OSR_PRESS | BME280_SEL_OSR_TEMP))
+    if (rslt == BME280_OK)
     {
-        rslt = set_osr_press_temp_settings(desired_settings, settings, dev);
-    }
+        ctrl_hum = dev->shadow_regs[BME280_SHADOW_CTRL_HUM];
+        ctrl_meas = dev->shadow_regs[BME280_SHADOW_CTRL_MEAS];
+        config = dev->shadow_regs[BME280_SHADOW_CONFIG];
+        last_ctrl_meas = ctrl_meas;
 
-    return rslt;
-}
-
-/*!
- * @brief This API sets the humidity oversampling settings of the sensor.
- */
-static int8_t set_osr_humidity_settings(const struct bme280_settings *settings, struct bme280_dev *dev)
-{
-    int8_t rslt;
-    uint8_t ctrl_hum;
-    uint8_t ctrl_meas;
-    uint8_t reg_addr = BME280_REG_CTRL_HUM;
-
-    ctrl_hum = settings->osr_h & BME280_CTRL_HUM_MSK;
+        if (are_settings_changed(OVERSAMPLING_SETTINGS, desired_settings))
+        {
+            if (desired_settings & BME280_SEL_OSR_HUM)
+            {
+                ctrl_hum = settings->osr_h & BME280_CTRL_HUM_MSK;
+            }
 
-    /* Write the humidity control value in the register */
-    rslt = bme280_set_regs(&reg_addr, &ctrl_hum, 1, dev);
+            if (desired_settings & BME280_SEL_OSR_PRESS)
+            {
+                fill_osr_press_settings(&ctrl_meas, settings);
+            }
 
-    /* Humidity related changes will be only effective after a
-     * write operation to ctrl_meas register
-     */
-    if (rslt == BME280_OK)
-    {
-        reg_addr = BME280_REG_CTRL_MEAS;
-        rslt = bme280_get_regs(reg_addr, &ctrl_meas, 1, dev);
+            if (desired_settings & BME280_SEL_OSR_TEMP)
+            {
+                fill_osr_temp_settings(&ctrl_meas, settings);
+            }
+        }
 
-        if (rslt == BME280_OK)
+        if (are_settings_changed(FILTER_STANDBY_SETTINGS, desired_settings))
         {
-            rslt = bme280_set_regs(&reg_addr, &ctrl_meas, 1, dev);
+            if (desired_settings & BME280_SEL_FILTER)
+            {
+                fill_filter_settings(&config, settings);
+            }
+
+            if (desired_settings & BME280_SEL_STANDBY)
+            {
+                fill_standby_settings(&config, settings);
+            }
         }
-    }
 
-    return rslt;
-}
+        ctrl_meas = BME280_SET_BITS_POS_0(ctrl_meas, BME280_SENSOR_MODE, sensor_mode);
 
-/*!
- * @brief This API sets the pressure and/or temperature oversampling settings
- * in the sensor according to the settings selected by the user.
- */
-static int8_t set_osr_press_temp_settings(uint8_t desired_settings,
-                                          const struct bme280_settings *settings,
-                                          struct bme280_dev *dev)
-{
-    int8_t rslt;
-    uint8_t reg_addr = BME280_REG_CTRL_MEAS;
-    uint8_t reg_data;
+        /* Writes to config are ignored outside the sleep mode, the sensor
+         * is put to sleep first within the same burst
+         */
+        if ((config != dev->shadow_regs[BME280_SHADOW_CONFIG] || ctrl_meas != last_ctrl_meas) &&
+            (BME280_GET_BITS_POS_0(last_ctrl_meas, BME280_SENSOR_MODE) != BME280_POWERMODE_SLEEP))
+        {
+            last_ctrl_meas = BME280_SET_BITS_POS_0(last_ctrl_meas, BME280_SENSOR_MODE, BME280_POWERMODE_SLEEP);
+            reg_addr[len] = BME280_REG_CTRL_MEAS;
+            reg_data[len++] = last_ctrl_meas;
+        }
 
-    rslt = bme280_get_regs(reg_addr, &reg_data, 1, dev);
+        if (ctrl_hum != dev->shadow_regs[BME280_SHADOW_CTRL_HUM])
+        {
+            reg_addr[len] = BME280_REG_CTRL_HUM;
+            reg_data[len++] = ctrl_hum;
+        }
 
-    if (rslt == BME280_OK)
-    {
-        if (desired_settings & BME280_SEL_OSR_PRESS)
+        if (config != dev->shadow_regs[BME280_SHADOW_CONFIG])
         {
-            fill_osr_press_settings(&reg_data, settings);
+            reg_addr[len] = BME280_REG_CONFIG;
+            reg_data[len++] = config;
         }
 
-        if (desired_settings & BME280_SEL_OSR_TEMP)
+        /* ctrl_meas last: it takes over ctrl_hum and starts the mode, a
+         * forced measurement is started on each call
+         */
+        if ((ctrl_meas != last_ctrl_meas) || (ctrl_hum != dev->shadow_regs[BME280_SHADOW_CTRL_HUM]) ||
+            (sensor_mode == BME280_POWERMODE_FORCED))
         {
-            fill_osr_temp_settings(&reg_data, settings);
+            reg_addr[len] = BME280_REG_CTRL_MEAS;
+            reg_data[len++] = ctrl_meas;
         }
 
-        /* Write the oversampling settings in the register */
-        rslt = bme280_set_regs(&reg_addr, &reg_data, 1, dev);
+        if (len != 0)
+        {
+            rslt = bme280_set_regs(reg_addr, reg_data, len, dev);
+        }
     }
 
     return rslt;
 }
 
 /*!
- * @brief This internal API sets the filter and/or standby duration settings
- * in the sensor according to the settings selected by the user.
+ * @brief This internal API updates the register shadow after a register
+ * of the sensor has been read or written.
  */
-static int8_t set_filter_standby_settings(uint8_t desired_settings,
-                                          const struct bme280_settings *settings,
-                                          struct bme280_dev *dev)
+static void update_shadow(uint8_t reg_addr, uint8_t reg_data, struct bme280_dev *dev)
 {
-    int8_t rslt;
-    uint8_t reg_addr = BME280_REG_CONFIG;
-    uint8_t reg_data;
-
-    rslt = bme280_get_regs(reg_addr, &reg_data, 1, dev);
+    uint8_t index;
 
-    if (rslt == BME280_OK)
+    switch (reg_addr | 0x80)
     {
-        if (desired_settings & BME280_SEL_FILTER)
-        {
-            fill_filter_settings(&reg_data, settings);
-        }
-
-        if (desired_settings & BME280_SEL_STANDBY)
-        {
-            fill_standby_settings(&reg_data, settings);
-        }
-
-        /* Write the oversampling settings in the register */
-        rslt = bme280_set_regs(&reg_addr, &reg_data, 1, dev);
+        case BME280_REG_CTRL_HUM:
+            index = BME280_SHADOW_CTRL_HUM;
+            break;
+        case BME280_REG_CTRL_MEAS:
+            index = BME280_SHADOW_CTRL_MEAS;
+            break;
+        case BME280_REG_CONFIG:
+            index = BME280_SHADOW_CONFIG;
+            break;
+        case BME280_REG_RESET:
+
+            /* Valid again once the reset is complete */
+            dev->shadow_valid = 0;
+
+            return;
+        default:
+            return;
     }
 
-    return rslt;
+    dev->shadow_regs[index] = reg_data;
+    dev->shadow_valid |= (uint8_t)(1u << index);
 }
 
 /*!
@@ -1050,75 +988,6 @@ static void parse_sensor_data(const uint8_t *reg_data, struct bme280_uncomp_data
     uncomp_data->humidity = data_msb | data_lsb;
 }
 
-/*!
- * @brief This internal API writes the power mode in the sensor.
- */
-static int8_t write_power_mode(uint8_t sensor_mode, struct bme280_dev *dev)
-{
-    int8_t rslt;
-    uint8_t reg_addr = BME280_REG_PWR_CTRL;
-
-    /* Variable to store the value read from power mode register */
-    uint8_t sensor_mode_reg_val;
-
-    /* Read the power mode register */
-    rslt = bme280_get_regs(reg_addr, &sensor_mode_reg_val, 1, dev);
-
-    /* Set the power mode */
-    if (rslt == BME280_OK)
-    {
-        sensor_mode_reg_val = BME280_SET_BITS_POS_0(sensor_mode_reg_val, BME280_SENSOR_MODE, sensor_mode);
-
-        /* Write the power mode in the register */
-        rslt = bme280_set_regs(&reg_addr, &sensor_mode_reg_val, 1, dev);
-    }
-
-    return rslt;
-}
-
-/*!
- * @brief This internal API puts the device to sleep mode.
- */
-static int8_t put_device_to_sleep(struct bme280_dev *dev)
-{
-    int8_t rslt;
-    uint8_t reg_data[4];
-    struct bme280_settings settings;
-
-    rslt = bme280_get_regs(BME280_REG_CTRL_HUM, reg_data, 4, dev);
-
-    if (rslt == BME280_OK)
-    {
-        parse_device_settings(reg_data, &settings);
-        rslt = bme280_soft_reset(dev);
-
-        if (rslt == BME280_OK)
-        {
-            rslt = reload_device_settings(&settings, dev);
-        }
-    }
-
-    return rslt;
-}
-
-/*!
- * @brief This internal API reloads the already existing device settings in
- * the sensor after soft reset.
- */
-static int8_t reload_device_settings(const struct bme280_settings *settings, struct bme280_dev *dev)
-{
-    int8_t rslt;
-
-    rslt = set_osr_settings(BME280_SEL_ALL_SETTINGS, settings, dev);
-
-    if (rslt == BME280_OK)
-    {
-        rslt = set_filter_standby_settings(BME280_SEL_ALL_SETTINGS, settings, dev);
-    }
-
-    return rslt;
-}
-
 #ifdef BME280_DOUBLE_ENABLE
 
 /*!
@@ -148,7 +148,8 @@ int8_t bme280_get_regs(uint8_t reg_addr, uint8_t *reg_data, uint32_t len, struct
  * int8_t bme280_set_sensor_settings(uint8_t desired_settings, const struct bme280_settings *settings, struct bme280_dev *dev);
  * \endcode
  * @details This API sets the oversampling, filter and standby duration
- * (normal mode) settings in the sensor.
+ * (normal mode) settings in the sensor. The sensor is in sleep mode
+ * afterwards, see bme280_set_sensor_config().
  *
  * @param[in] desired_settings  : Variable used to select the settings which
  *                                are to be set in the sensor.
@@ -180,6 +181,38 @@ int8_t bme280_set_sensor_settings(uint8_t desired_settings,
                                   const struct bme280_settings *settings,
                                   struct bme280_dev *dev);
 
+/*!
+ * \ingroup bme280ApiSensorSettings
+ * \page bme280_api_bme280_set_sensor_config bme280_set_sensor_config
+ * \code
+ * int8_t bme280_set_sensor_config(uint8_t desired_settings, const struct bme280_settings *settings, uint8_t sensor_mode, struct bme280_dev *dev);
+ * \endcode
+ * @details This API sets the selected settings and the power mode in one
+ * burst write of ctrl_hum, config and ctrl_meas. The current register
+ * values come from the shadow in the device structure (one read of all
+ * three if it is not valid), registers that do not change are left out
+ * and nothing is written if the sensor already runs with the request.
+ * A sensor outside the sleep mode is put to sleep within the same burst,
+ * config is ignored otherwise.
+ *
+ * @param[in] desired_settings  : BME280_SEL_* macros as for
+ *                                bme280_set_sensor_settings().
+ * @param[in] settings          : Structure instance of bme280_settings.
+ * @param[in] sensor_mode       : Power mode after the write.
+ * @param[in,out] dev           : Structure instance of bme280_dev.
+ *
+ * @return Result of API execution status
+ *
+ * @retval   0 -> Success.
+ * @retval > 0 -> Warning.
+ * @retval < 0 -> Fail.
+ *
+ */
+int8_t bme280_set_sensor_config(uint8_t desired_settings,
+                                const struct bme280_settings *settings,
+                                uint8_t sensor_mode,
+                                struct bme280_dev *dev);
+
 /*!
  * \ingroup bme280ApiSensorSettings
  * \page bme280_api_bme280_get_sensor_settings bme280_get_sensor_settings
@@ -213,7 +246,8 @@ int8_t bme280_get_sensor_settings(struct bme280_settings *settings, struct bme28
  * \code
  * int8_t bme280_set_sensor_mode(uint8_t sensor_mode, const struct bme280_dev *dev);
  * \endcode
- * @details This API sets the power mode of the sensor.
+ * @details This API sets the power mode of the sensor, without a read back
+ * while the register shadow is valid.
  *
  * @param[in] sensor_mode : Variable which contains the power mode to be set.
  * @param[in] dev         : Structure instance of bme280_dev.
@@ -47,6 +47,9 @@
 #else
 #include <stdint.h>
 #include <stddef.h>
+
+/* Compiler switches of the project (inc/project_conf.h) */
+#include "project_conf.h"
 #endif
 
 /********************************************************/
@@ -156,6 +159,13 @@
 #define BME280_LEN_HUMIDITY_CALIB_DATA            UINT8_C(7)
 #define BME280_LEN_P_T_H_DATA                     UINT8_C(8)
 
+/*! @name Register shadow (ctrl_hum, ctrl_meas, config) */
+#define BME280_SHADOW_CTRL_HUM                    UINT8_C(0x00)
+#define BME280_SHADOW_CTRL_MEAS                   UINT8_C(0x01)
+#define BME280_SHADOW_CONFIG                      UINT8_C(0x02)
+#define BME280_SHADOW_LEN                         UINT8_C(3)
+#define BME280_SHADOW_ALL                         UINT8_C(0x07)
+
 /*! @name Sensor power modes */
 #define BME280_POWERMODE_SLEEP                    UINT8_C(0x00)
 #define BME280_POWERMODE_FORCED                   UINT8_C(0x01)
@@ -489,6 +499,18 @@ struct bme280_dev
 
     /*! Trim data */
     struct bme280_calib_data calib_data;
+
+    /*! Last value written to or read from ctrl_hum, ctrl_meas and config,
+     * indexed by BME280_SHADOW_CTRL_HUM .. BME280_SHADOW_CONFIG
+     */
+    uint8_t shadow_regs[BME280_SHADOW_LEN];
+
+    /*! One bit per valid shadow entry, BME280_SHADOW_ALL when the whole
+     * register state is known. Has to be 0 before bme280_init(). Writes
+     * past the API must leave the registers as the shadow holds them
+     * (e.g. a forced measurement that has finished).
+     */
+    uint8_t shadow_valid;
 };
 
 #endif /* _BME280_DEFS_H */
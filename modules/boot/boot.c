@@ -0,0 +1,134 @@
+/**
+ ******************************************************************************
+ * @file        boot.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Overlapped boot sequencer
+ *
+ * Functionality:
+ * - Static step table, round-robin polling of the step protothreads
+ * - End times from the DWT cycle counter (utils), relative to boot_begin()
+ * - Startup phase table in .noinit, written by the reset handler before
+ *   .bss is cleared
+ *
+ * Resources:
+ * - DWT cycle counter (read only, through utils)
+ ******************************************************************************
+ */
+
+#include "boot.h"
+#include <utils/utils.h>
+
+#include <stddef.h>
+
+/* Private Type Definitions ------------------------------------------------ */
+/**
+ * @brief One step with its thread state.
+ */
+typedef struct {
+    boot_step_fn_t    fn;
+    void             *p_context;
+    pt_t              pt;
+    uint8_t           u8_done;
+    boot_step_stats_t stats;
+} boot_step_t;
+
+/* Public Variables --------------------------------------------------------- */
+/**
+ * @brief Cycle counter at the end of every startup phase, written by the
+ *        reset handler (referenced by name, hence not static).
+ */
+uint32_t g_u32_boot_phase_cycles[BOOT_PHASE_COUNT] UTILS_NOINIT;
+
+/* Static Module Variables ------------------------------------------------- */
+static boot_step_t g_boot_steps[BOOT_MAX_STEPS];
+static boot_stats_t g_boot_stats;
+static uint32_t g_u32_boot_start;
+static volatile uint8_t g_u8_boot_control_marked;
+
+/* Public functions --------------------------------------------------------- */
+void boot_begin(void)
+{
+    g_u32_boot_start = utils_now_cycles();
+    g_boot_stats.u8_steps       = 0U;
+    g_boot_stats.u32_init_us    = 0U;
+    g_boot_stats.u32_control_us = 0U;
+    g_u8_boot_control_marked    = 0U;
+}
+
+HAL_StatusTypeDef boot_add(const char *p_name, boot_step_fn_t fn, void *context)
+{
+    boot_step_t *step;
+
+    if ((fn == NULL) || (g_boot_stats.u8_steps >= BOOT_MAX_STEPS)) {
+        return HAL_ERROR;
+    }
+
+    step = &g_boot_steps[g_boot_stats.u8_steps++];
+    step->fn                = fn;
+    step->p_context         = context;
+    step->u8_done           = 0U;
+    step->stats.p_name      = p_name;
+    step->stats.u32_done_us = 0U;
+    step->stats.u32_polls   = 0U;
+    PT_INIT(&step->pt);
+
+    return HAL_OK;
+}
+
+void boot_run(void)
+{
+    uint8_t u8_running;
+
+    do {
+        u8_running = 0U;
+        for (uint8_t i = 0U; i < g_boot_stats.u8_steps; i++) {
+            boot_step_t *step = &g_boot_steps[i];
+
+            if (step->u8_done) {
+                continue;
+            }
+            step->stats.u32_polls++;
+            if (step->fn(&step->pt, step->p_context) >= PT_EXITED) {
+                step->u8_done           = 1U;
+                step->stats.u32_done_us = utils_elapsed_us(g_u32_boot_start);
+            } else {
+                u8_running = 1U;
+            }
+        }
+    } while (u8_running);
+
+    g_boot_stats.u32_init_us = utils_elapsed_us(g_u32_boot_start);
+}
+
+uint8_t boot_is_done(uint8_t u8_step)
+{
+    return (u8_step < g_boot_stats.u8_steps) ? g_boot_steps[u8_step].u8_done : 0U;
+}
+
+void boot_mark_control(void)
+{
+    if (!g_u8_boot_control_marked) {
+        g_boot_stats.u32_control_us = utils_elapsed_us(g_u32_boot_start);
+        g_u8_boot_control_marked    = 1U;
+    }
+}
+
+uint32_t boot_get_phase_us(boot_phase_t phase)
+{
+    if (phase >= BOOT_PHASE_COUNT) {
+        return 0U;
+    }
+    return g_u32_boot_phase_cycles[phase] / (BOOT_RESET_CLOCK_HZ / 1000000U);
+}
+
+const boot_stats_t *boot_get_stats(void)
+{
+    return &g_boot_stats;
+}
+
+const boot_step_stats_t *boot_get_step(uint8_t u8_step)
+{
+    return (u8_step < g_boot_stats.u8_steps) ? &g_boot_steps[u8_step].stats : NULL;
+}
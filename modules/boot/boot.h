@@ -0,0 +1,164 @@
+/**
+ ******************************************************************************
+ * @file        boot.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the overlapped boot sequencer.
+ *
+ * @details
+ * The slow parts of a start are waits for hardware: the panel after
+ * reset and sleep out, a sensor after power-up, a fan spinning up. Run
+ * one after the other they add up; the CPU idles in every one of them.
+ * Here every init step is a protothread (modules/pt) that returns at
+ * its waits, boot_run() polls all steps round-robin until each one has
+ * ended. A step that depends on another one waits for it with
+ * boot_is_done() inside its thread.
+ *
+ * The elapsed time is measured from boot_begin() (after clock_init(),
+ * the cycle counter is converted with the final SystemCoreClock) to the
+ * end of every step and to boot_mark_control(), the first control step
+ * of the application: the time a watchdog reset takes the control loop
+ * out of service.
+ *
+ * Before that the reset handler (startup_stm32f429xx.s) starts the
+ * cycle counter from 0 and stamps the end of every startup phase into
+ * a table in .noinit: .data copy, .bss clear, CCM RAM, stack paint,
+ * SystemInit() and the static constructors. The startup runs on the
+ * 16 MHz HSI, boot_get_phase_us() converts at that clock.
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - Up to BOOT_MAX_STEPS steps, polled in the order they were added
+ *  - Per step: end time in us since boot_begin(), number of polls
+ *  - Time to the end of boot_run() and to the first control step
+ *  - Startup phase timestamps from the reset handler
+ *
+ ******************************************************************************
+ */
+
+#ifndef BOOT_BOOT_H_
+#define BOOT_BOOT_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+#include "pt/pt.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief Maximum number of init steps.
+ */
+#ifndef BOOT_MAX_STEPS
+#define BOOT_MAX_STEPS          8U
+#endif
+
+/**
+ * @brief Core clock of the startup code (reset default: HSI).
+ */
+#define BOOT_RESET_CLOCK_HZ     HSI_VALUE
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Startup phases, in order; the reset handler stamps the end of
+ *        each (same numbers as BOOT_PHASE_* in the startup code).
+ */
+typedef enum {
+    BOOT_PHASE_DATA = 0,        /**< .data copied from flash             */
+    BOOT_PHASE_BSS,             /**< .bss cleared                        */
+    BOOT_PHASE_CCM,             /**< CCM RAM copied and cleared          */
+    BOOT_PHASE_PAINT,           /**< Free RAM painted (stack watermark)  */
+    BOOT_PHASE_SYSTEM_INIT,     /**< SystemInit() returned               */
+    BOOT_PHASE_MAIN,            /**< Static constructors run, main()     */
+    BOOT_PHASE_COUNT
+} boot_phase_t;
+
+/**
+ * @brief Init step: protothread, PT_ENDED or PT_EXITED when done.
+ */
+typedef pt_state_t (*boot_step_fn_t)(pt_t *pt, void *context);
+
+/**
+ * @brief Result of one step.
+ */
+typedef struct {
+    const char *p_name;         /**< Name given to boot_add()            */
+    uint32_t    u32_done_us;    /**< End since boot_begin(), 0 running   */
+    uint32_t    u32_polls;      /**< Calls of the thread                 */
+} boot_step_stats_t;
+
+/**
+ * @brief Result of the whole boot.
+ */
+typedef struct {
+    uint8_t  u8_steps;          /**< Steps added                         */
+    uint32_t u32_init_us;       /**< End of boot_run() since boot_begin() */
+    uint32_t u32_control_us;    /**< First control step, 0 not yet       */
+} boot_stats_t;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Starts the time measurement and clears the step table.
+ *
+ * @return None
+ */
+void boot_begin(void);
+
+/**
+ * @brief Adds an init step.
+ *
+ * @param p_name  Name for the report (kept as pointer)
+ * @param fn      Protothread of the step
+ * @param context Passed to fn
+ * @return HAL_OK, HAL_ERROR if the table is full or fn is NULL
+ */
+HAL_StatusTypeDef boot_add(const char *p_name, boot_step_fn_t fn, void *context);
+
+/**
+ * @brief Polls all steps round-robin until every one has ended.
+ *
+ * @return None
+ */
+void boot_run(void);
+
+/**
+ * @brief Returns whether a step has ended, for dependencies between
+ *        steps (PT_WAIT_UNTIL(pt, boot_is_done(0U))).
+ *
+ * @param u8_step Index in the order of boot_add()
+ * @return 1 ended, 0 running or no such step
+ */
+uint8_t boot_is_done(uint8_t u8_step);
+
+/**
+ * @brief Records the time of the first control step; later calls are
+ *        ignored. Call at the first controller run (also from an
+ *        interrupt).
+ *
+ * @return None
+ */
+void boot_mark_control(void);
+
+/**
+ * @brief Returns the time from reset to the end of a startup phase.
+ *
+ * @param phase Startup phase
+ * @return Microseconds at BOOT_RESET_CLOCK_HZ, 0 for an invalid phase
+ */
+uint32_t boot_get_phase_us(boot_phase_t phase);
+
+/**
+ * @brief Returns the result of the boot.
+ *
+ * @return Result
+ */
+const boot_stats_t *boot_get_stats(void);
+
+/**
+ * @brief Returns the result of one step.
+ *
+ * @param u8_step Index in the order of boot_add()
+ * @return Result, NULL for no such step
+ */
+const boot_step_stats_t *boot_get_step(uint8_t u8_step);
+
+#endif /* BOOT_BOOT_H_ */
@@ -0,0 +1,545 @@
+/**
+ ******************************************************************************
+ * @file        can_node.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       CAN node: periodic state frames, setpoint commands
+ *
+ * Functionality:
+ * - HAL for the controller init and the filter banks, register level in
+ *   the interrupts (mailboxes, FIFO release)
+ * - TX slots in identifier order: command, fans, environment; the TX
+ *   interrupt is the only writer of the mailboxes, can_node_poll() pends
+ *   it after filling slots
+ * - RX FIFO 0 (commands) and FIFO 1 (states of other nodes) drained in
+ *   their interrupts, frames published on the data bus
+ *
+ * Resources:
+ * - CAN1 or CAN2 (CAN2 uses the filter banks of CAN1 from bank 14)
+ * - CANx_TX / RX0 / RX1 interrupts
+ ******************************************************************************
+ */
+
+#include "can_node.h"
+#include "databus/databus.h"
+#include "utils/utils.h"
+
+#include <string.h>
+
+/* Preprocessor Defines ---------------------------------------------------- */
+/**
+ * @brief First filter bank of CAN2 (CAN1 keeps 0..13).
+ */
+#define CAN_NODE_CAN2_FIRST_BANK    14U
+
+/**
+ * @brief 16 bit filter image of a standard identifier (RTR = IDE = 0).
+ */
+#define CAN_NODE_FILTER_ID(id)      ((uint32_t)(id) << 5)
+
+/**
+ * @brief 16 bit filter mask: frame type, RTR and IDE.
+ */
+#define CAN_NODE_FILTER_TYPE_MASK   ((0x1FU << 11) | 0x18U)
+
+/**
+ * @brief TX slots.
+ */
+#define CAN_NODE_SLOT_COMMAND       0U
+#define CAN_NODE_SLOT_FAN           1U
+#define CAN_NODE_SLOT_ENV           (CAN_NODE_SLOT_FAN + CAN_NODE_MAX_FANS)
+#define CAN_NODE_SLOTS              (CAN_NODE_SLOT_ENV + 1U)
+
+/* Private Type Definitions ------------------------------------------------- */
+/**
+ * @brief Latest frame of one kind, mailbox register images.
+ */
+typedef struct {
+    uint32_t         u32_tir;       /**< Identifier, TXRQ clear          */
+    uint32_t         u32_tdtr;      /**< DLC                             */
+    uint32_t         u32_tdlr;      /**< Bytes 0..3                      */
+    uint32_t         u32_tdhr;      /**< Bytes 4..7                      */
+    volatile uint8_t u8_pending;    /**< Written by the poll, cleared by the TX interrupt */
+} can_node_slot_t;
+
+/* Static module variables -------------------------------------------------- */
+static CAN_HandleTypeDef g_can_node_handle;
+static can_node_config_t g_can_node_config;
+static uint8_t g_u8_can_node_ready = 0u;
+
+/**
+ * @brief Attached fans.
+ */
+typedef struct {
+    const can_node_fan_ops_t *ops;
+    void                     *context;
+} can_node_fan_t;
+
+static can_node_fan_t g_can_node_fans[CAN_NODE_MAX_FANS];
+static volatile uint8_t g_u8_can_node_fan_count = 0u;
+
+/**
+ * @brief Environment values for the next period (main loop only).
+ */
+static int32_t  g_i32_can_node_centi_celsius;
+static uint32_t g_u32_can_node_pascal;
+static uint32_t g_u32_can_node_milli_rh;
+static uint8_t  g_u8_can_node_env_valid = 0u;
+
+static can_node_slot_t g_can_node_slots[CAN_NODE_SLOTS];
+static uint32_t g_u32_can_node_last_ms = 0u;
+static can_node_stats_t g_can_node_stats;
+
+/* Static function prototypes ----------------------------------------------- */
+static HAL_StatusTypeDef can_node_timing(uint32_t u32_clock, uint32_t u32_bitrate, CAN_InitTypeDef *init);
+static HAL_StatusTypeDef can_node_filters(void);
+static void can_node_slot_write(uint32_t u32_slot, can_node_frame_t type, uint8_t u8_node,
+                                uint32_t u32_low, uint32_t u32_high, uint8_t u8_dlc);
+static IRQn_Type can_node_tx_irqn(void);
+static void can_node_tx(CAN_TypeDef *can);
+static void can_node_rx(CAN_TypeDef *can, uint32_t u32_fifo);
+static void can_node_dispatch(uint32_t u32_id, uint32_t u32_dlc, uint32_t u32_low, uint32_t u32_high);
+
+/* Public functions --------------------------------------------------------- */
+HAL_StatusTypeDef can_node_init(const can_node_config_t *config)
+{
+    GPIO_InitTypeDef gpio_init_struct;
+    CAN_TypeDef *can = config->instance;
+    uint32_t u32_bitrate = (config->u32_bitrate != 0u) ? config->u32_bitrate : CAN_NODE_BITRATE;
+    IRQn_Type rx0_irqn = (can == CAN2) ? CAN2_RX0_IRQn : CAN1_RX0_IRQn;
+    IRQn_Type rx1_irqn = (can == CAN2) ? CAN2_RX1_IRQn : CAN1_RX1_IRQn;
+
+    if (((can != CAN1) && (can != CAN2)) || (config->port == NULL) ||
+        (config->u8_node >= CAN_NODE_BROADCAST)) {
+        return HAL_ERROR;
+    }
+
+    g_u8_can_node_ready = 0u;
+    g_can_node_config   = *config;
+
+    /* CAN2 is a slave: its filters live in CAN1 */
+    __HAL_RCC_CAN1_CLK_ENABLE();
+    if (can == CAN2) {
+        __HAL_RCC_CAN2_CLK_ENABLE();
+    }
+
+    utils_gpio_clock_enable(config->port);
+    gpio_init_struct.Pin       = config->rx_pin | config->tx_pin;
+    gpio_init_struct.Mode      = GPIO_MODE_AF_PP;
+    gpio_init_struct.Pull      = GPIO_PULLUP;
+    gpio_init_struct.Speed     = GPIO_SPEED_FREQ_HIGH;
+    gpio_init_struct.Alternate = (can == CAN2) ? GPIO_AF9_CAN2 : GPIO_AF9_CAN1;
+    HAL_GPIO_Init(config->port, &gpio_init_struct);
+
+    /* Mailboxes by identifier, newest frame kept in a full FIFO */
+    g_can_node_handle.Instance                  = can;
+    g_can_node_handle.Init.Mode                 = CAN_MODE_NORMAL;
+    g_can_node_handle.Init.TimeTriggeredMode    = DISABLE;
+    g_can_node_handle.Init.AutoBusOff           = ENABLE;
+    g_can_node_handle.Init.AutoWakeUp           = DISABLE;
+    g_can_node_handle.Init.AutoRetransmission   = ENABLE;
+    g_can_node_handle.Init.ReceiveFifoLocked    = DISABLE;
+    g_can_node_handle.Init.TransmitFifoPriority = DISABLE;
+    if (can_node_timing(HAL_RCC_GetPCLK1Freq(), u32_bitrate, &g_can_node_handle.Init) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    if ((HAL_CAN_Init(&g_can_node_handle) != HAL_OK) ||
+        (can_node_filters() != HAL_OK) ||
+        (HAL_CAN_Start(&g_can_node_handle) != HAL_OK)) {
+        return HAL_ERROR;
+    }
+
+    memset(g_can_node_slots, 0, sizeof(g_can_node_slots));
+    memset(&g_can_node_stats, 0, sizeof(g_can_node_stats));
+    g_u32_can_node_last_ms = HAL_GetTick();
+    g_u8_can_node_ready    = 1u;
+
+    HAL_NVIC_SetPriority(can_node_tx_irqn(), CAN_NODE_IRQ_PRIORITY, 0u);
+    HAL_NVIC_SetPriority(rx0_irqn, CAN_NODE_IRQ_PRIORITY, 0u);
+    HAL_NVIC_SetPriority(rx1_irqn, CAN_NODE_IRQ_PRIORITY, 0u);
+    HAL_NVIC_EnableIRQ(can_node_tx_irqn());
+    HAL_NVIC_EnableIRQ(rx0_irqn);
+    HAL_NVIC_EnableIRQ(rx1_irqn);
+
+    can->IER |= CAN_IER_TMEIE | CAN_IER_FMPIE0 | (config->u8_supervisor ? CAN_IER_FMPIE1 : 0u);
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef can_node_add_fan(const can_node_fan_ops_t *ops, void *context, uint8_t *pu8_index)
+{
+    uint8_t u8_index = g_u8_can_node_fan_count;
+
+    if ((ops == NULL) || (ops->get_state == NULL) || (u8_index >= CAN_NODE_MAX_FANS)) {
+        return HAL_ERROR;
+    }
+
+    /* The RX interrupt sees the entry before the count */
+    g_can_node_fans[u8_index].ops     = ops;
+    g_can_node_fans[u8_index].context = context;
+    __DMB();
+    g_u8_can_node_fan_count = (uint8_t)(u8_index + 1u);
+    *pu8_index = u8_index;
+
+    return HAL_OK;
+}
+
+void can_node_set_env(int32_t i32_centi_celsius, uint32_t u32_pascal, uint32_t u32_milli_rh)
+{
+    g_i32_can_node_centi_celsius = i32_centi_celsius;
+    g_u32_can_node_pascal        = u32_pascal;
+    g_u32_can_node_milli_rh      = u32_milli_rh;
+    g_u8_can_node_env_valid      = 1u;
+}
+
+uint8_t can_node_poll(void)
+{
+    uint8_t u8_node = g_can_node_config.u8_node;
+    uint8_t u8_count = 0u;
+    uint32_t u32_now = HAL_GetTick();
+
+    if (!g_u8_can_node_ready || ((u32_now - g_u32_can_node_last_ms) < CAN_NODE_PERIOD_MS)) {
+        return 0u;
+    }
+    g_u32_can_node_last_ms = u32_now;
+
+    for (uint8_t i = 0u; i < g_u8_can_node_fan_count; i++) {
+        const can_node_fan_t *fan = &g_can_node_fans[i];
+        can_node_fan_state_t state;
+        uint32_t u32_rpm;
+        uint32_t u32_setpoint;
+
+        if (g_can_node_slots[CAN_NODE_SLOT_FAN + i].u8_pending) {
+            g_can_node_stats.u32_tx_late++;
+            continue;
+        }
+
+        fan->ops->get_state(fan->context, &state);
+        u32_rpm      = (state.u32_rpm > 0xFFFFu) ? 0xFFFFu : state.u32_rpm;
+        u32_setpoint = (state.u32_setpoint_rpm > 0xFFFFu) ? 0xFFFFu : state.u32_setpoint_rpm;
+        can_node_slot_write(CAN_NODE_SLOT_FAN + i, CAN_NODE_FRAME_FAN, u8_node,
+                            (uint32_t)i | ((uint32_t)state.u8_health << 8) | (u32_rpm << 16),
+                            u32_setpoint | ((uint32_t)state.u16_duty_permille << 16), 8u);
+        u8_count++;
+    }
+
+    if (g_u8_can_node_env_valid) {
+        if (g_can_node_slots[CAN_NODE_SLOT_ENV].u8_pending) {
+            g_can_node_stats.u32_tx_late++;
+        } else {
+            uint32_t u32_rh = (g_u32_can_node_milli_rh + 5u) / 10u;
+
+            can_node_slot_write(CAN_NODE_SLOT_ENV, CAN_NODE_FRAME_ENV, u8_node,
+                                ((uint32_t)g_i32_can_node_centi_celsius & 0xFFFFu) | (u32_rh << 16),
+                                g_u32_can_node_pascal, 8u);
+            u8_count++;
+        }
+    }
+
+    if (u8_count > 0u) {
+        NVIC_SetPendingIRQ(can_node_tx_irqn());
+    }
+
+    return u8_count;
+}
+
+HAL_StatusTypeDef can_node_send_command(uint8_t u8_node, uint8_t u8_fan, uint16_t u16_rpm)
+{
+    if (!g_u8_can_node_ready || g_can_node_slots[CAN_NODE_SLOT_COMMAND].u8_pending) {
+        return HAL_BUSY;
+    }
+
+    can_node_slot_write(CAN_NODE_SLOT_COMMAND, CAN_NODE_FRAME_COMMAND, u8_node,
+                        (uint32_t)u8_fan | ((uint32_t)u16_rpm << 16), 0u, 4u);
+    NVIC_SetPendingIRQ(can_node_tx_irqn());
+
+    return HAL_OK;
+}
+
+void can_node_get_stats(can_node_stats_t *stats)
+{
+    *stats = g_can_node_stats;
+}
+
+/* Interrupt handlers -------------------------------------------------------- */
+void CAN1_TX_IRQHandler(void)
+{
+    can_node_tx(CAN1);
+}
+
+void CAN1_RX0_IRQHandler(void)
+{
+    can_node_rx(CAN1, 0u);
+}
+
+void CAN1_RX1_IRQHandler(void)
+{
+    can_node_rx(CAN1, 1u);
+}
+
+void CAN2_TX_IRQHandler(void)
+{
+    can_node_tx(CAN2);
+}
+
+void CAN2_RX0_IRQHandler(void)
+{
+    can_node_rx(CAN2, 0u);
+}
+
+void CAN2_RX1_IRQHandler(void)
+{
+    can_node_rx(CAN2, 1u);
+}
+
+/* Static functions --------------------------------------------------------- */
+/**
+ * @brief Bit timing with the most time quanta (8..25) that divide the
+ *        clock exactly, phase 2 about 12.5 % of the bit.
+ *
+ * @param u32_clock   APB1 clock
+ * @param u32_bitrate Bit rate
+ * @param init        Prescaler, SJW, BS1, BS2 written
+ * @return HAL_OK, HAL_ERROR if no exact divider exists
+ */
+static HAL_StatusTypeDef can_node_timing(uint32_t u32_clock, uint32_t u32_bitrate, CAN_InitTypeDef *init)
+{
+    for (uint32_t u32_tq = 25u; u32_tq >= 8u; u32_tq--) {
+        uint32_t u32_bs2 = (u32_tq + 4u) / 8u;
+        uint32_t u32_bs1 = u32_tq - 1u - u32_bs2;
+        uint32_t u32_prescaler;
+
+        if ((u32_clock % (u32_bitrate * u32_tq)) != 0u) {
+            continue;
+        }
+        u32_prescaler = u32_clock / (u32_bitrate * u32_tq);
+        if ((u32_prescaler > 1024u) || (u32_bs1 > 16u)) {
+            continue;
+        }
+
+        init->Prescaler     = u32_prescaler;
+        init->SyncJumpWidth = CAN_SJW_1TQ;
+        init->TimeSeg1      = (u32_bs1 - 1u) << CAN_BTR_TS1_Pos;
+        init->TimeSeg2      = (u32_bs2 - 1u) << CAN_BTR_TS2_Pos;
+        return HAL_OK;
+    }
+
+    return HAL_ERROR;
+}
+
+/**
+ * @brief Commands to the node and to all nodes into FIFO 0; on a
+ *        supervisor fan and environment frames of any node into FIFO 1.
+ *
+ * @return HAL_OK, HAL_ERROR if the HAL rejects a bank
+ */
+static HAL_StatusTypeDef can_node_filters(void)
+{
+    CAN_FilterTypeDef filter;
+    uint32_t u32_bank = (g_can_node_config.instance == CAN2) ? CAN_NODE_CAN2_FIRST_BANK : 0u;
+    uint32_t u32_own = CAN_NODE_FILTER_ID(CAN_NODE_ID(CAN_NODE_FRAME_COMMAND, g_can_node_config.u8_node));
+    uint32_t u32_all = CAN_NODE_FILTER_ID(CAN_NODE_ID(CAN_NODE_FRAME_COMMAND, CAN_NODE_BROADCAST));
+
+    filter.FilterBank           = u32_bank;
+    filter.FilterMode           = CAN_FILTERMODE_IDLIST;
+    filter.FilterScale          = CAN_FILTERSCALE_16BIT;
+    filter.FilterIdHigh         = u32_own;
+    filter.FilterIdLow          = u32_all;
+    filter.FilterMaskIdHigh     = u32_own;
+    filter.FilterMaskIdLow      = u32_all;
+    filter.FilterFIFOAssignment = CAN_FILTER_FIFO0;
+    filter.FilterActivation     = CAN_FILTER_ENABLE;
+    filter.SlaveStartFilterBank = CAN_NODE_CAN2_FIRST_BANK;
+    if (HAL_CAN_ConfigFilter(&g_can_node_handle, &filter) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    filter.FilterBank           = u32_bank + 1u;
+    filter.FilterMode           = CAN_FILTERMODE_IDMASK;
+    filter.FilterIdHigh         = CAN_NODE_FILTER_ID(CAN_NODE_ID(CAN_NODE_FRAME_FAN, 0u));
+    filter.FilterMaskIdHigh     = CAN_NODE_FILTER_TYPE_MASK;
+    filter.FilterIdLow          = CAN_NODE_FILTER_ID(CAN_NODE_ID(CAN_NODE_FRAME_ENV, 0u));
+    filter.FilterMaskIdLow      = CAN_NODE_FILTER_TYPE_MASK;
+    filter.FilterFIFOAssignment = CAN_FILTER_FIFO1;
+    filter.FilterActivation     = g_can_node_config.u8_supervisor ? CAN_FILTER_ENABLE : CAN_FILTER_DISABLE;
+
+    return HAL_CAN_ConfigFilter(&g_can_node_handle, &filter);
+}
+
+/**
+ * @brief Fills a free slot and marks it pending (main loop).
+ *
+ * @param u32_slot Slot
+ * @param type     Frame type
+ * @param u8_node  Node of the identifier
+ * @param u32_low  Bytes 0..3
+ * @param u32_high Bytes 4..7
+ * @param u8_dlc   Length
+ */
+static void can_node_slot_write(uint32_t u32_slot, can_node_frame_t type, uint8_t u8_node,
+                                uint32_t u32_low, uint32_t u32_high, uint8_t u8_dlc)
+{
+    can_node_slot_t *slot = &g_can_node_slots[u32_slot];
+
+    slot->u32_tir  = CAN_NODE_ID(type, u8_node) << CAN_TI0R_STID_Pos;
+    slot->u32_tdtr = u8_dlc;
+    slot->u32_tdlr = u32_low;
+    slot->u32_tdhr = u32_high;
+    __DMB();
+    slot->u8_pending = 1u;
+}
+
+/**
+ * @brief TX vector of the configured controller.
+ *
+ * @return IRQ number
+ */
+static IRQn_Type can_node_tx_irqn(void)
+{
+    return (g_can_node_config.instance == CAN2) ? CAN2_TX_IRQn : CAN1_TX_IRQn;
+}
+
+/**
+ * @brief TX interrupt (mailbox empty or pended by the poll): moves the
+ *        pending slots, lowest identifier first, into free mailboxes.
+ *
+ * @param can Controller of the vector
+ */
+static void can_node_tx(CAN_TypeDef *can)
+{
+    uint32_t u32_slot = 0u;
+
+    if (can != g_can_node_config.instance) {
+        return;
+    }
+
+    /* Acknowledge the completed requests, else the vector stays pending */
+    can->TSR = can->TSR & (CAN_TSR_RQCP0 | CAN_TSR_RQCP1 | CAN_TSR_RQCP2);
+
+    while ((can->TSR & (CAN_TSR_TME0 | CAN_TSR_TME1 | CAN_TSR_TME2)) != 0u) {
+        CAN_TxMailBox_TypeDef *box;
+        can_node_slot_t *slot;
+
+        while ((u32_slot < CAN_NODE_SLOTS) && !g_can_node_slots[u32_slot].u8_pending) {
+            u32_slot++;
+        }
+        if (u32_slot >= CAN_NODE_SLOTS) {
+            return;
+        }
+
+        slot = &g_can_node_slots[u32_slot];
+        box  = &can->sTxMailBox[(can->TSR & CAN_TSR_CODE) >> CAN_TSR_CODE_Pos];
+        box->TDTR = slot->u32_tdtr;
+        box->TDLR = slot->u32_tdlr;
+        box->TDHR = slot->u32_tdhr;
+        box->TIR  = slot->u32_tir | CAN_TI0R_TXRQ;
+        slot->u8_pending = 0u;
+        g_can_node_stats.u32_tx_frames++;
+    }
+}
+
+/**
+ * @brief RX interrupt: drains one FIFO.
+ *
+ * @param can      Controller of the vector
+ * @param u32_fifo 0 or 1
+ */
+static void can_node_rx(CAN_TypeDef *can, uint32_t u32_fifo)
+{
+    volatile uint32_t *p_rfr = (u32_fifo == 0u) ? &can->RF0R : &can->RF1R;
+    CAN_FIFOMailBox_TypeDef *box = &can->sFIFOMailBox[u32_fifo];
+
+    /* RF0R and RF1R share the bit layout */
+    while ((*p_rfr & CAN_RF0R_FMP0) != 0u) {
+        uint32_t u32_id   = (box->RIR & CAN_RI0R_STID) >> CAN_RI0R_STID_Pos;
+        uint32_t u32_dlc  = box->RDTR & CAN_RDT0R_DLC;
+        uint32_t u32_low  = box->RDLR;
+        uint32_t u32_high = box->RDHR;
+
+        *p_rfr = CAN_RF0R_RFOM0;
+        g_can_node_stats.u32_rx_frames++;
+        can_node_dispatch(u32_id, u32_dlc, u32_low, u32_high);
+    }
+
+    if ((*p_rfr & CAN_RF0R_FOVR0) != 0u) {
+        *p_rfr = CAN_RF0R_FOVR0;
+        g_can_node_stats.u32_rx_overruns++;
+    }
+}
+
+/**
+ * @brief Applies a command or publishes a remote state.
+ *
+ * @param u32_id   Standard identifier
+ * @param u32_dlc  Length
+ * @param u32_low  Bytes 0..3
+ * @param u32_high Bytes 4..7
+ */
+static void can_node_dispatch(uint32_t u32_id, uint32_t u32_dlc, uint32_t u32_low, uint32_t u32_high)
+{
+    uint8_t u8_node = (uint8_t)(u32_id & 0x3Fu);
+
+    switch ((can_node_frame_t)(u32_id >> 6)) {
+    case CAN_NODE_FRAME_COMMAND: {
+        databus_can_command_t command;
+        uint8_t u8_count = g_u8_can_node_fan_count;
+
+        if (u32_dlc < 4u) {
+            break;
+        }
+        memset(&command, 0, sizeof(command));
+        command.u8_node = u8_node;
+        command.u8_fan  = (uint8_t)u32_low;
+        command.u16_rpm = (uint16_t)(u32_low >> 16);
+
+        for (uint8_t i = 0u; i < u8_count; i++) {
+            const can_node_fan_t *fan = &g_can_node_fans[i];
+
+            if (((command.u8_fan == CAN_NODE_ALL_FANS) || (command.u8_fan == i)) &&
+                (fan->ops->set_target != NULL)) {
+                fan->ops->set_target(fan->context, command.u16_rpm);
+                g_can_node_stats.u32_commands++;
+            }
+        }
+        databus_publish(DATABUS_TOPIC_CAN_COMMAND, &command);
+        break;
+    }
+
+    case CAN_NODE_FRAME_FAN: {
+        databus_can_fan_t state;
+
+        if (u32_dlc < 8u) {
+            break;
+        }
+        memset(&state, 0, sizeof(state));
+        state.u8_node           = u8_node;
+        state.u8_fan            = (uint8_t)u32_low;
+        state.u8_health         = (uint8_t)(u32_low >> 8);
+        state.u16_rpm           = (uint16_t)(u32_low >> 16);
+        state.u16_setpoint_rpm  = (uint16_t)u32_high;
+        state.u16_duty_permille = (uint16_t)(u32_high >> 16);
+        databus_publish(DATABUS_TOPIC_CAN_FAN, &state);
+        break;
+    }
+
+    case CAN_NODE_FRAME_ENV: {
+        databus_can_env_t env;
+
+        if (u32_dlc < 8u) {
+            break;
+        }
+        memset(&env, 0, sizeof(env));
+        env.u8_node           = u8_node;
+        env.i32_centi_celsius = (int16_t)(u32_low & 0xFFFFu);
+        env.u32_milli_rh      = (u32_low >> 16) * 10u;
+        env.u32_pascal        = u32_high;
+        databus_publish(DATABUS_TOPIC_CAN_ENV, &env);
+        break;
+    }
+
+    default:
+        break;
+    }
+}
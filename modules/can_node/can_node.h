@@ -0,0 +1,232 @@
+/**
+ ******************************************************************************
+ * @file        can_node.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the CAN node for distributed fan and
+ *              sensor boards.
+ *
+ * @details
+ * One bxCAN controller (CAN1 or CAN2, both on APB1) connects the board
+ * to a bus of up to 63 nodes. The node publishes the state of its fans
+ * and the BME280 values as compact periodic frames and accepts setpoint
+ * commands; a supervisor board additionally receives the frames of all
+ * nodes. Standard identifiers carry the frame type and the node:
+ *
+ *      ID = type << 6 | node      (type 0..31, node 0..62, 63 = all)
+ *
+ * so a lower type wins the arbitration: commands before fan states
+ * before environment values, at equal type the lower node number.
+ *
+ * Frames (little endian):
+ *  - CAN_NODE_FRAME_COMMAND, to a node: fan index (0xFF = all), 0,
+ *    target RPM (u16)
+ *  - CAN_NODE_FRAME_FAN, from a node: fan index, health state, RPM,
+ *    setpoint RPM, duty in per mille (u16 each)
+ *  - CAN_NODE_FRAME_ENV, from a node: temperature in 0.01 degC (i16),
+ *    humidity in 0.01 %RH (u16), pressure in Pa (u32)
+ *
+ * The hardware filters do the addressing: bank 0 (CAN2: bank 14) lists
+ * the commands to the node and to all nodes in 16 bit list mode and
+ * routes them to FIFO 0, bank 1 (15) masks the fan and environment
+ * types of any node into FIFO 1 on a supervisor. Nothing else reaches
+ * the CPU. Both FIFOs are drained by their interrupt, register level,
+ * into the data bus: commands (DATABUS_TOPIC_CAN_COMMAND) are applied to
+ * the fans of the node right there, remote states go to
+ * DATABUS_TOPIC_CAN_FAN / DATABUS_TOPIC_CAN_ENV.
+ *
+ * The node does not link the fan module (P2 builds without it): the
+ * application attaches each fan with two callbacks, one reading its
+ * state for the periodic frame (e.g. fan_get_cached_rpm(),
+ * fan_get_setpoint_rpm(), fan_get_duty_permille(), fan_get_health())
+ * and one applying a commanded target (fan_set_target_rpm()).
+ *
+ * Transmission: every frame has a latest-value slot; can_node_poll()
+ * fills the slots once per period and the TX interrupt moves pending
+ * slots into free mailboxes, lowest identifier first. The mailboxes
+ * themselves send by identifier (TXFP = 0), so a command never waits
+ * behind a queued state frame. A slot that is still pending at the next
+ * period is not overwritten but counted (bus too slow for the period).
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - Bit timing from the APB1 clock, sample point near 87.5 %, automatic
+ *    bus-off recovery and retransmission
+ *  - Up to CAN_NODE_MAX_FANS fans per node, environment values set by
+ *    the application
+ *  - Supervisor mode: states of all nodes on the data bus, commands to
+ *    any node
+ *  - Counters for sent frames, received frames, FIFO overruns and late
+ *    slots
+ *
+ * The board routes no CAN transceiver; the pins (AF9) are wired to an
+ * external one, e.g. CAN2 on PB12 / PB13 with USB CDC unused.
+ *
+ ******************************************************************************
+ */
+
+#ifndef CAN_NODE_CAN_NODE_H_
+#define CAN_NODE_CAN_NODE_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+#include "irq/irq.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief Default bit rate in bit/s.
+ */
+#ifndef CAN_NODE_BITRATE
+#define CAN_NODE_BITRATE        500000U
+#endif
+
+/**
+ * @brief Period of the state frames in ms.
+ */
+#ifndef CAN_NODE_PERIOD_MS
+#define CAN_NODE_PERIOD_MS      100U
+#endif
+
+/**
+ * @brief Fans per node (fan index 0..CAN_NODE_MAX_FANS - 1 on the bus).
+ */
+#define CAN_NODE_MAX_FANS       4U
+
+/**
+ * @brief Node number addressing all nodes (commands only).
+ */
+#define CAN_NODE_BROADCAST      0x3FU
+
+/**
+ * @brief Fan index of a command for all fans of the node.
+ */
+#define CAN_NODE_ALL_FANS       0xFFU
+
+/**
+ * @brief Standard identifier of a frame.
+ */
+#define CAN_NODE_ID(type, node) ((((uint32_t)(type)) << 6) | ((uint32_t)(node) & 0x3FU))
+
+/**
+ * @brief NVIC preemption priority of the RX and TX interrupts.
+ */
+#define CAN_NODE_IRQ_PRIORITY   IRQ_CLASS_TRANSFER
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Frame types, lower = higher bus priority.
+ */
+typedef enum {
+    CAN_NODE_FRAME_COMMAND = 0,
+    CAN_NODE_FRAME_FAN,
+    CAN_NODE_FRAME_ENV
+} can_node_frame_t;
+
+/**
+ * @brief Wiring and role of the node.
+ */
+typedef struct {
+    CAN_TypeDef  *instance;         /**< CAN1 or CAN2                      */
+    GPIO_TypeDef *port;             /**< Port of RX and TX                 */
+    uint16_t      rx_pin;           /**< GPIO_PIN_x, AF9                   */
+    uint16_t      tx_pin;
+    uint8_t       u8_node;          /**< 0..62                             */
+    uint8_t       u8_supervisor;    /**< Receive the frames of all nodes   */
+    uint32_t      u32_bitrate;      /**< bit/s, 0: CAN_NODE_BITRATE        */
+} can_node_config_t;
+
+/**
+ * @brief State of an attached fan for its periodic frame, values above
+ *        0xFFFF are sent as 0xFFFF.
+ */
+typedef struct {
+    uint32_t u32_rpm;               /**< Measured RPM                      */
+    uint32_t u32_setpoint_rpm;      /**< Current setpoint                  */
+    uint16_t u16_duty_permille;     /**< PWM duty in per mille             */
+    uint8_t  u8_health;             /**< fan_health_state_t                */
+} can_node_fan_state_t;
+
+/**
+ * @brief Callbacks of an attached fan.
+ */
+typedef struct {
+    /** Reads the state, main loop (can_node_poll()) */
+    void (*get_state)(void *context, can_node_fan_state_t *state);
+    /** Applies a commanded target RPM, RX interrupt (CAN_NODE_IRQ_PRIORITY) */
+    void (*set_target)(void *context, uint16_t u16_rpm);
+} can_node_fan_ops_t;
+
+/**
+ * @brief Counters.
+ */
+typedef struct {
+    uint32_t u32_tx_frames;         /**< Frames put into a mailbox         */
+    uint32_t u32_tx_late;           /**< Periods with the slot still pending */
+    uint32_t u32_rx_frames;
+    uint32_t u32_rx_overruns;       /**< Frames lost to a full FIFO        */
+    uint32_t u32_commands;          /**< Commands applied                  */
+} can_node_stats_t;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Sets up the controller, the filters and the interrupts and
+ *        joins the bus.
+ *
+ * @param config Wiring and role, copied
+ * @return HAL_OK, HAL_ERROR for an invalid setup, a bit rate the APB1
+ *         clock cannot divide or a controller that does not start
+ */
+HAL_StatusTypeDef can_node_init(const can_node_config_t *config);
+
+/**
+ * @brief Publishes a fan under the next fan index and applies commands
+ *        to it.
+ *
+ * @param ops       Callbacks, kept (static storage); set_target may be
+ *                  NULL for a fan that is only reported
+ * @param context   Passed to the callbacks, e.g. the fan_t instance
+ * @param pu8_index Fan index on the bus
+ * @return HAL_OK, HAL_ERROR without get_state or if CAN_NODE_MAX_FANS
+ *         are attached
+ */
+HAL_StatusTypeDef can_node_add_fan(const can_node_fan_ops_t *ops, void *context, uint8_t *pu8_index);
+
+/**
+ * @brief Sets the environment values of the next period (e.g. from
+ *        env_sensor_get_data_fixed()); no environment frame before the
+ *        first call.
+ *
+ * @param i32_centi_celsius Temperature in 0.01 degC
+ * @param u32_pascal        Pressure in Pa
+ * @param u32_milli_rh      Humidity in 0.001 %RH
+ * @return None
+ */
+void can_node_set_env(int32_t i32_centi_celsius, uint32_t u32_pascal, uint32_t u32_milli_rh);
+
+/**
+ * @brief Sends the state frames once per CAN_NODE_PERIOD_MS. Main loop.
+ *
+ * @return Frames handed to the TX interrupt
+ */
+uint8_t can_node_poll(void);
+
+/**
+ * @brief Sends a setpoint command (supervisor).
+ *
+ * @param u8_node Node, CAN_NODE_BROADCAST for all
+ * @param u8_fan  Fan index, CAN_NODE_ALL_FANS for all
+ * @param u16_rpm Target RPM
+ * @return HAL_OK, HAL_BUSY if the previous command is still pending
+ */
+HAL_StatusTypeDef can_node_send_command(uint8_t u8_node, uint8_t u8_fan, uint16_t u16_rpm);
+
+/**
+ * @brief Copies the counters.
+ *
+ * @param stats Destination
+ * @return None
+ */
+void can_node_get_stats(can_node_stats_t *stats);
+
+#endif /* CAN_NODE_CAN_NODE_H_ */
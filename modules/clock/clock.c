@@ -0,0 +1,308 @@
+/**
+ ******************************************************************************
+ * @file        clock.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       System clock configuration (PLL profiles, flash, ART)
+ *
+ * Functionality:
+ * - Switches SYSCLK to the HSI before touching the PLL
+ * - Configures regulator scale, over-drive and the main PLL
+ * - Sets flash wait states and enables prefetch, I- and D-cache
+ * - Configures AHB = SYSCLK, APB1 = SYSCLK / 4, APB2 = SYSCLK / 2
+ *   (16 MHz profile: all prescalers 1)
+ *
+ * Clock tree (HSE = 8 MHz, PLLM = 8 -> 1 MHz PLL input):
+ * - 180 MHz: PLLN = 360, PLLP = 2, APB1 = 45 MHz, APB2 = 90 MHz
+ * - 168 MHz: PLLN = 336, PLLP = 2, APB1 = 42 MHz, APB2 = 84 MHz
+ *
+ * Rate planner:
+ * - SPI: BR = 2 .. 256 in powers of two, the first at or below the limit
+ * - ADC: ADCPRE = 2, 4, 6, 8 on PCLK2, the first within 36 MHz
+ * - I2C fast mode: CCR as the HAL computes it for both duty cycles, the
+ *   faster one whose low and high phase meet the fast mode minimum
+ *
+ * Peripherals:
+ * - RCC, PWR, FLASH
+ ******************************************************************************
+ */
+
+#include "clock.h"
+
+/* Static module variables -------------------------------------------------- */
+/**
+ * @brief Currently active clock profile (reset state: HSI).
+ */
+static clock_profile_t g_clock_profile = CLOCK_PROFILE_16MHZ_HSI;
+
+/**
+ * @brief Effective rates of the plans, cleared by clock_init().
+ */
+static uint32_t g_u32_clock_rates[CLOCK_RATE_COUNT];
+
+/**
+ * @brief ADC prescaler settings, divider 2, 4, 6, 8.
+ */
+static const uint32_t g_u32_clock_adc_prescalers[] = {
+    ADC_CLOCK_SYNC_PCLK_DIV2, ADC_CLOCK_SYNC_PCLK_DIV4,
+    ADC_CLOCK_SYNC_PCLK_DIV6, ADC_CLOCK_SYNC_PCLK_DIV8
+};
+
+/* Static function prototypes ---------------------------------------------- */
+static HAL_StatusTypeDef clock_switch_to_hsi(void);
+static HAL_StatusTypeDef clock_config_pll(uint32_t u32_plln, uint8_t u8_overdrive);
+static uint32_t clock_i2c_fast_rate(uint32_t u32_pclk, uint32_t u32_max_hz, uint32_t u32_duty);
+static void clock_keep_rate(clock_rate_t rate, uint32_t u32_hz);
+
+/* Public functions --------------------------------------------------------- */
+clock_profile_t clock_init(clock_profile_t profile)
+{
+    HAL_StatusTypeDef status;
+
+    __HAL_FLASH_PREFETCH_BUFFER_ENABLE();
+    __HAL_FLASH_INSTRUCTION_CACHE_ENABLE();
+    __HAL_FLASH_DATA_CACHE_ENABLE();
+
+    status = clock_switch_to_hsi();
+
+    if (status == HAL_OK) {
+        switch (profile) {
+        case CLOCK_PROFILE_180MHZ:
+            status = clock_config_pll(360u, 1u);
+            break;
+        case CLOCK_PROFILE_168MHZ:
+            status = clock_config_pll(336u, 0u);
+            break;
+        default:
+            break;
+        }
+    }
+
+    if ((status != HAL_OK) || (profile == CLOCK_PROFILE_16MHZ_HSI)) {
+        /* PLL not wanted or failed: stay on HSI and release the PLL/HSE */
+        RCC_OscInitTypeDef osc_init_struct = {0};
+
+        __HAL_RCC_PWR_CLK_ENABLE();
+        clock_switch_to_hsi();
+
+        osc_init_struct.OscillatorType = RCC_OSCILLATORTYPE_HSE;
+        osc_init_struct.HSEState       = RCC_HSE_OFF;
+        osc_init_struct.PLL.PLLState   = RCC_PLL_OFF;
+        HAL_RCC_OscConfig(&osc_init_struct);
+
+        HAL_PWREx_DisableOverDrive();
+
+        g_clock_profile = CLOCK_PROFILE_16MHZ_HSI;
+    } else {
+        g_clock_profile = profile;
+    }
+
+    /* Plans of the previous clock are void */
+    for (uint32_t i = 0u; i < CLOCK_RATE_COUNT; i++) {
+        g_u32_clock_rates[i] = 0u;
+    }
+
+    return g_clock_profile;
+}
+
+clock_profile_t clock_get_profile(void)
+{
+    return g_clock_profile;
+}
+
+uint32_t clock_get_apb1_timer_clock(void)
+{
+    uint32_t u32_pclk1 = HAL_RCC_GetPCLK1Freq();
+
+    if ((RCC->CFGR & RCC_CFGR_PPRE1) == RCC_HCLK_DIV1) {
+        return u32_pclk1;
+    }
+
+    return 2u * u32_pclk1;
+}
+
+uint32_t clock_get_apb2_timer_clock(void)
+{
+    uint32_t u32_pclk2 = HAL_RCC_GetPCLK2Freq();
+
+    if ((RCC->CFGR & RCC_CFGR_PPRE2) == (RCC_HCLK_DIV1 << 3u)) {
+        return u32_pclk2;
+    }
+
+    return 2u * u32_pclk2;
+}
+
+uint32_t clock_plan_spi(clock_rate_t rate, SPI_TypeDef *spi, uint32_t u32_max_hz)
+{
+    uint32_t u32_pclk = ((spi == SPI2) || (spi == SPI3)) ? HAL_RCC_GetPCLK1Freq() : HAL_RCC_GetPCLK2Freq();
+    uint32_t u32_prescaler = SPI_BAUDRATEPRESCALER_2;
+    uint32_t u32_divider = 2u;
+
+    while (((u32_pclk / u32_divider) > u32_max_hz) && (u32_prescaler != SPI_BAUDRATEPRESCALER_256)) {
+        u32_prescaler += SPI_CR1_BR_0;
+        u32_divider <<= 1;
+    }
+
+    clock_keep_rate(rate, u32_pclk / u32_divider);
+
+    return u32_prescaler;
+}
+
+uint32_t clock_plan_adc(void)
+{
+    uint32_t u32_pclk = HAL_RCC_GetPCLK2Freq();
+    uint32_t i = 0u;
+
+    while (((u32_pclk / (2u * (i + 1u))) > CLOCK_ADC_MAX_HZ) &&
+           (i < (sizeof(g_u32_clock_adc_prescalers) / sizeof(g_u32_clock_adc_prescalers[0]) - 1u))) {
+        i++;
+    }
+
+    clock_keep_rate(CLOCK_RATE_ADC, u32_pclk / (2u * (i + 1u)));
+
+    return g_u32_clock_adc_prescalers[i];
+}
+
+uint32_t clock_plan_i2c(uint32_t u32_max_hz)
+{
+    uint32_t u32_pclk = HAL_RCC_GetPCLK1Freq();
+    uint32_t u32_rate_2;
+    uint32_t u32_rate_16_9;
+    uint32_t u32_ccr;
+
+    if ((u32_max_hz <= 100000u) || (u32_pclk < CLOCK_I2C_FAST_MIN_PCLK_HZ)) {
+        /* Standard mode: symmetric, CCR at least 4 */
+        u32_ccr = (u32_pclk - 1u) / (2u * u32_max_hz) + 1u;
+        if (u32_ccr < 4u) {
+            u32_ccr = 4u;
+        }
+        clock_keep_rate(CLOCK_RATE_I2C, (u32_max_hz <= 100000u) ? (u32_pclk / (2u * u32_ccr)) : 0u);
+        return I2C_DUTYCYCLE_2;
+    }
+
+    u32_rate_2    = clock_i2c_fast_rate(u32_pclk, u32_max_hz, I2C_DUTYCYCLE_2);
+    u32_rate_16_9 = clock_i2c_fast_rate(u32_pclk, u32_max_hz, I2C_DUTYCYCLE_16_9);
+
+    if (u32_rate_16_9 > u32_rate_2) {
+        clock_keep_rate(CLOCK_RATE_I2C, u32_rate_16_9);
+        return I2C_DUTYCYCLE_16_9;
+    }
+
+    clock_keep_rate(CLOCK_RATE_I2C, u32_rate_2);
+
+    return I2C_DUTYCYCLE_2;
+}
+
+uint32_t clock_get_rate(clock_rate_t rate)
+{
+    return (rate < CLOCK_RATE_COUNT) ? g_u32_clock_rates[rate] : 0u;
+}
+
+/* Static module functions -------------------------------------------------- */
+/**
+ * @brief Selects the HSI as SYSCLK with all bus prescalers at 1.
+ *
+ * The PLL can only be reconfigured while it is not the system clock.
+ * The flash latency is kept at the current value here and lowered by the
+ * HAL only once the clock has actually dropped.
+ *
+ * @return HAL status of the clock switch.
+ */
+static HAL_StatusTypeDef clock_switch_to_hsi(void)
+{
+    RCC_ClkInitTypeDef clk_init_struct;
+
+    clk_init_struct.ClockType      = RCC_CLOCKTYPE_SYSCLK | RCC_CLOCKTYPE_HCLK |
+                                     RCC_CLOCKTYPE_PCLK1  | RCC_CLOCKTYPE_PCLK2;
+    clk_init_struct.SYSCLKSource   = RCC_SYSCLKSOURCE_HSI;
+    clk_init_struct.AHBCLKDivider  = RCC_SYSCLK_DIV1;
+    clk_init_struct.APB1CLKDivider = RCC_HCLK_DIV1;
+    clk_init_struct.APB2CLKDivider = RCC_HCLK_DIV1;
+
+    return HAL_RCC_ClockConfig(&clk_init_struct, FLASH_LATENCY_0);
+}
+
+/**
+ * @brief Starts HSE + PLL and switches SYSCLK to the PLL output.
+ *
+ * @param u32_plln     PLL multiplier (VCO = 1 MHz * PLLN, SYSCLK = VCO / 2).
+ * @param u8_overdrive 1 to enable the regulator over-drive (> 168 MHz).
+ * @return HAL status of the configuration.
+ */
+static HAL_StatusTypeDef clock_config_pll(uint32_t u32_plln, uint8_t u8_overdrive)
+{
+    RCC_OscInitTypeDef osc_init_struct = {0};
+    RCC_ClkInitTypeDef clk_init_struct;
+
+    __HAL_RCC_PWR_CLK_ENABLE();
+    __HAL_PWR_VOLTAGESCALING_CONFIG(PWR_REGULATOR_VOLTAGE_SCALE1);
+
+    osc_init_struct.OscillatorType = RCC_OSCILLATORTYPE_HSE;
+    osc_init_struct.HSEState       = RCC_HSE_ON;
+    osc_init_struct.PLL.PLLState   = RCC_PLL_ON;
+    osc_init_struct.PLL.PLLSource  = RCC_PLLSOURCE_HSE;
+    osc_init_struct.PLL.PLLM       = HSE_VALUE / 1000000u;
+    osc_init_struct.PLL.PLLN       = u32_plln;
+    osc_init_struct.PLL.PLLP       = RCC_PLLP_DIV2;
+    osc_init_struct.PLL.PLLQ       = 7u;
+
+    if (HAL_RCC_OscConfig(&osc_init_struct) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    if (u8_overdrive) {
+        if (HAL_PWREx_EnableOverDrive() != HAL_OK) {
+            return HAL_ERROR;
+        }
+    } else {
+        HAL_PWREx_DisableOverDrive();
+    }
+
+    clk_init_struct.ClockType      = RCC_CLOCKTYPE_SYSCLK | RCC_CLOCKTYPE_HCLK |
+                                     RCC_CLOCKTYPE_PCLK1  | RCC_CLOCKTYPE_PCLK2;
+    clk_init_struct.SYSCLKSource   = RCC_SYSCLKSOURCE_PLLCLK;
+    clk_init_struct.AHBCLKDivider  = RCC_SYSCLK_DIV1;
+    clk_init_struct.APB1CLKDivider = RCC_HCLK_DIV4;
+    clk_init_struct.APB2CLKDivider = RCC_HCLK_DIV2;
+
+    return HAL_RCC_ClockConfig(&clk_init_struct, FLASH_LATENCY_5);
+}
+
+/**
+ * @brief SCL of a fast mode duty cycle with the CCR of the HAL (rounded
+ *        up, never above the limit).
+ *
+ * @param u32_pclk   PCLK1
+ * @param u32_max_hz SCL limit
+ * @param u32_duty   I2C_DUTYCYCLE_2 (low:high 2:1) or _16_9
+ * @return SCL in Hz, 0 if a phase is below the fast mode minimum
+ */
+static uint32_t clock_i2c_fast_rate(uint32_t u32_pclk, uint32_t u32_max_hz, uint32_t u32_duty)
+{
+    uint32_t u32_low  = (u32_duty == I2C_DUTYCYCLE_2) ? 2u : 16u;
+    uint32_t u32_high = (u32_duty == I2C_DUTYCYCLE_2) ? 1u : 9u;
+    uint32_t u32_ccr  = (u32_pclk - 1u) / (u32_max_hz * (u32_low + u32_high)) + 1u;
+    uint32_t u32_mhz  = u32_pclk / 1000000u;
+
+    /* Phases in ns: cycles * 1000 / MHz */
+    if ((u32_low * u32_ccr * 1000u < CLOCK_I2C_FAST_TLOW_NS * u32_mhz) ||
+        (u32_high * u32_ccr * 1000u < CLOCK_I2C_FAST_THIGH_NS * u32_mhz)) {
+        return 0u;
+    }
+
+    return u32_pclk / ((u32_low + u32_high) * u32_ccr);
+}
+
+/**
+ * @brief Keeps the effective rate of a plan.
+ *
+ * @param rate   Planned rate, CLOCK_RATE_NONE is not kept
+ * @param u32_hz Effective rate
+ */
+static void clock_keep_rate(clock_rate_t rate, uint32_t u32_hz)
+{
+    if (rate < CLOCK_RATE_COUNT) {
+        g_u32_clock_rates[rate] = u32_hz;
+    }
+}
@@ -0,0 +1,155 @@
+/**
+ ******************************************************************************
+ * @file        clock.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the system clock configuration module.
+ *
+ * @details
+ * This module brings the STM32F429 from the 16 MHz HSI reset clock up
+ * to one of several selectable clock profiles. It configures the PLL,
+ * the voltage regulator (incl. over-drive), flash wait states, the ART
+ * accelerator (prefetch, instruction and data cache) and the AHB/APB
+ * prescalers.
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - HSE (8 MHz) + PLL @ 180 MHz with over-drive
+ *  - HSE (8 MHz) + PLL @ 168 MHz
+ *  - HSI @ 16 MHz low-power fallback (PLL off)
+ *  - Timer clock helpers for APB1/APB2 timers
+ *  - Rate planner: fastest compliant SPI, ADC and I2C settings for the
+ *    active bus clocks, effective rates kept for a report
+ *
+ * Timer kernel clocks follow the APB prescalers: with an APB prescaler
+ * other than 1, the timers run at twice the APB clock. Modules should
+ * derive prescalers from clock_get_apb1_timer_clock() or
+ * clock_get_apb2_timer_clock() instead of SystemCoreClock.
+ *
+ * Bus peripherals take their prescalers from the planner instead of
+ * constants picked for one clock: clock_plan_spi() (limit of the slave,
+ * e.g. the ILI9341 write cycle), clock_plan_adc() (CLOCK_ADC_MAX_HZ) and
+ * clock_plan_i2c() (fast mode duty cycle). Each plan reads the bus clock
+ * at the call, so it belongs into the init after clock_init().
+ *
+ ******************************************************************************
+ */
+
+#ifndef CLOCK_CLOCK_H_
+#define CLOCK_CLOCK_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief ADC clock limit (datasheet, VDDA 2.4 .. 3.6 V).
+ */
+#define CLOCK_ADC_MAX_HZ            36000000U
+
+/**
+ * @brief I2C fast mode: SCL limit, shortest low and high phase, lowest
+ *        PCLK1.
+ */
+#define CLOCK_I2C_FAST_HZ           400000U
+#define CLOCK_I2C_FAST_TLOW_NS      1300U
+#define CLOCK_I2C_FAST_THIGH_NS     600U
+#define CLOCK_I2C_FAST_MIN_PCLK_HZ  4000000U
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Selectable system clock profiles.
+ */
+typedef enum {
+    CLOCK_PROFILE_180MHZ = 0,   /**< HSE + PLL, over-drive, 5 wait states */
+    CLOCK_PROFILE_168MHZ,       /**< HSE + PLL, 5 wait states             */
+    CLOCK_PROFILE_16MHZ_HSI     /**< HSI only, 0 wait states              */
+} clock_profile_t;
+
+/**
+ * @brief Planned rates kept for the report.
+ */
+typedef enum {
+    CLOCK_RATE_LCD_SPI = 0,     /**< SPI5 SCK of the display writes       */
+    CLOCK_RATE_ADC,             /**< ADC clock (common to all ADCs)       */
+    CLOCK_RATE_I2C,             /**< SCL of the sensor bus                */
+    CLOCK_RATE_COUNT,
+    CLOCK_RATE_NONE = CLOCK_RATE_COUNT  /**< Plan only, not kept          */
+} clock_rate_t;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Switches the system clock to the requested profile.
+ *
+ * Must be called after HAL_Init(). SystemCoreClock and the SysTick
+ * are updated by the HAL. If the HSE or the PLL fails to start, the
+ * system stays on the 16 MHz HSI fallback profile.
+ *
+ * Peripherals whose timing depends on the bus clocks (timers, SPI,
+ * I2C, ADC) should be initialized after this call.
+ *
+ * @param profile Requested clock profile.
+ * @return The profile that is active after the call.
+ */
+clock_profile_t clock_init(clock_profile_t profile);
+
+/**
+ * @brief Returns the currently active clock profile.
+ *
+ * @return Active clock profile.
+ */
+clock_profile_t clock_get_profile(void);
+
+/**
+ * @brief Returns the kernel clock of the timers on APB1 (TIM2..TIM7, TIM12..TIM14).
+ *
+ * @return Timer clock in Hz.
+ */
+uint32_t clock_get_apb1_timer_clock(void);
+
+/**
+ * @brief Returns the kernel clock of the timers on APB2 (TIM1, TIM8..TIM11).
+ *
+ * @return Timer clock in Hz.
+ */
+uint32_t clock_get_apb2_timer_clock(void);
+
+/**
+ * @brief Smallest SPI baud rate prescaler that keeps SCK at or below a
+ *        limit on the bus clock of the instance.
+ *
+ * @param rate       Rate to keep, CLOCK_RATE_NONE for none
+ * @param spi        SPI instance (SPI2/3 on APB1, others on APB2)
+ * @param u32_max_hz SCK limit of the slave
+ * @return SPI_BAUDRATEPRESCALER_x (256 if even that is above the limit)
+ */
+uint32_t clock_plan_spi(clock_rate_t rate, SPI_TypeDef *spi, uint32_t u32_max_hz);
+
+/**
+ * @brief Smallest common ADC prescaler within CLOCK_ADC_MAX_HZ, kept as
+ *        CLOCK_RATE_ADC.
+ *
+ * @return ADC_CLOCK_SYNC_PCLK_DIVx
+ */
+uint32_t clock_plan_adc(void);
+
+/**
+ * @brief Duty cycle with the fastest SCL at or below a limit that keeps
+ *        the fast mode low and high phases, kept as CLOCK_RATE_I2C. The
+ *        limit goes to Init.ClockSpeed, the duty to Init.DutyCycle.
+ *
+ * @param u32_max_hz SCL limit (up to 100 kHz: standard mode)
+ * @return I2C_DUTYCYCLE_2 or I2C_DUTYCYCLE_16_9
+ */
+uint32_t clock_plan_i2c(uint32_t u32_max_hz);
+
+/**
+ * @brief Returns a rate planned since clock_init().
+ *
+ * @param rate Planned rate
+ * @return Effective rate in Hz, 0 if not planned (or the plan failed)
+ */
+uint32_t clock_get_rate(clock_rate_t rate);
+
+#endif /* CLOCK_CLOCK_H_ */
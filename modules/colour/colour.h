@@ -0,0 +1,242 @@
+/**
+ ******************************************************************************
+ * @file        colour.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Header-only RGB565 colour utilities: conversion, SWAR
+ *              blending, gradients.
+ *
+ * @details
+ * The conversion macros are constant expressions, so palettes written in
+ * RGB888 are converted by the compiler and end up in flash as RGB565:
+ *
+ *     static const uint16_t g_u16_palette[] = {
+ *         COLOUR_HEX(0x1E90FF), COLOUR_HEX(0xFFA500), COLOUR_RGB(40, 40, 40)
+ *     };
+ *
+ * Blending works on the 565 fields in place (SIMD within a register):
+ * the fields of a pixel are spread over a 32 bit word with at least 5
+ * free bits above each, so one multiplication scales all channels at
+ * once. colour_blend_pair() handles two pixels packed into one word (the
+ * layout of two neighbouring pixels in memory) with two such words and
+ * no unpacking, about the cost of one colour_blend() for both. The alpha
+ * has COLOUR_ALPHA_MAX + 1 levels (0 = background, 32 = foreground), the
+ * result of colour_blend_pair() equals colour_blend() for each pixel.
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - RGB888 / channel to RGB565 at compile time, RGB565 to RGB888
+ *  - Blending of one pixel, of a packed pixel pair and of rows
+ *  - Gradients of any length from two colours, channel exact ends
+ *
+ ******************************************************************************
+ */
+
+#ifndef COLOUR_COLOUR_H_
+#define COLOUR_COLOUR_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief RGB565 from 8 bit channels, a constant expression.
+ */
+#define COLOUR_RGB(r, g, b) \
+    ((uint16_t)((((uint32_t)(r) & 0xF8U) << 8) | (((uint32_t)(g) & 0xFCU) << 3) | (((uint32_t)(b) & 0xFFU) >> 3)))
+
+/**
+ * @brief RGB565 from a 0xRRGGBB value, a constant expression.
+ */
+#define COLOUR_HEX(rgb) \
+    COLOUR_RGB(((uint32_t)(rgb) >> 16) & 0xFFU, ((uint32_t)(rgb) >> 8) & 0xFFU, (uint32_t)(rgb) & 0xFFU)
+
+/**
+ * @brief Channels of an RGB565 colour: 5, 6 and 5 bits.
+ */
+#define COLOUR_R5(c)                (((uint32_t)(c) >> 11) & 0x1FU)
+#define COLOUR_G6(c)                (((uint32_t)(c) >> 5) & 0x3FU)
+#define COLOUR_B5(c)                ((uint32_t)(c) & 0x1FU)
+
+/**
+ * @brief Full alpha: the foreground alone.
+ */
+#define COLOUR_ALPHA_MAX            32U
+
+/**
+ * @brief Alpha 0..COLOUR_ALPHA_MAX from 0..255 (e.g. an A8 glyph).
+ */
+#define COLOUR_ALPHA8(a)            (((uint32_t)(a) + 4U) >> 3)
+
+/**
+ * @brief Two copies of a colour in one word, for fills two pixels at a
+ *        time.
+ */
+#define COLOUR_PAIR(c)              (((uint32_t)(c) << 16) | (uint16_t)(c))
+
+/**
+ * @brief Spread fields: G at 21..26, R at 11..15, B at 0..4 (one pixel);
+ *        the same mask holds B0, R0 and G1 of a pixel pair, the odd mask
+ *        G0, B1 and R1 after a shift right by 5.
+ */
+#define COLOUR_SPREAD_MASK          0x07E0F81FU
+#define COLOUR_PAIR_ODD_MASK        0x07C0F83FU
+
+/* Public Functions -------------------------------------------------------- */
+/**
+ * @brief Expands RGB565 to 0x00RRGGBB, the low bits repeat the high ones
+ *        (white stays 0xFFFFFF).
+ *
+ * @param colour RGB565 colour
+ * @return RGB888 colour
+ */
+static inline uint32_t colour_to_rgb888(uint16_t colour)
+{
+    uint32_t u32_r = COLOUR_R5(colour);
+    uint32_t u32_g = COLOUR_G6(colour);
+    uint32_t u32_b = COLOUR_B5(colour);
+
+    u32_r = (u32_r << 3) | (u32_r >> 2);
+    u32_g = (u32_g << 2) | (u32_g >> 4);
+    u32_b = (u32_b << 3) | (u32_b >> 2);
+
+    return (u32_r << 16) | (u32_g << 8) | u32_b;
+}
+
+/**
+ * @brief Reduces 0x00RRGGBB to RGB565 at run time (COLOUR_HEX()).
+ *
+ * @param u32_rgb RGB888 colour
+ * @return RGB565 colour
+ */
+static inline uint16_t colour_from_rgb888(uint32_t u32_rgb)
+{
+    return (uint16_t)(((u32_rgb >> 8) & 0xF800U) | ((u32_rgb >> 5) & 0x07E0U) | ((u32_rgb >> 3) & 0x001FU));
+}
+
+/**
+ * @brief Mixes two colours: (fg * alpha + bg * (32 - alpha)) / 32 per
+ *        channel.
+ *
+ * @param fg       Foreground colour
+ * @param bg       Background colour
+ * @param u32_alpha 0..COLOUR_ALPHA_MAX
+ * @return Mixed colour
+ */
+static inline uint16_t colour_blend(uint16_t fg, uint16_t bg, uint32_t u32_alpha)
+{
+    uint32_t u32_fg = (fg | ((uint32_t)fg << 16)) & COLOUR_SPREAD_MASK;
+    uint32_t u32_bg = (bg | ((uint32_t)bg << 16)) & COLOUR_SPREAD_MASK;
+    uint32_t u32_mix = ((u32_fg * u32_alpha + u32_bg * (COLOUR_ALPHA_MAX - u32_alpha)) >> 5) & COLOUR_SPREAD_MASK;
+
+    return (uint16_t)(u32_mix | (u32_mix >> 16));
+}
+
+/**
+ * @brief Mixes two pixel pairs, each word holds two RGB565 pixels (low
+ *        half: first pixel in memory).
+ *
+ * @param u32_fg    Foreground pair
+ * @param u32_bg    Background pair
+ * @param u32_alpha 0..COLOUR_ALPHA_MAX, the same for both pixels
+ * @return Mixed pair
+ */
+static inline uint32_t colour_blend_pair(uint32_t u32_fg, uint32_t u32_bg, uint32_t u32_alpha)
+{
+    uint32_t u32_inv  = COLOUR_ALPHA_MAX - u32_alpha;
+    uint32_t u32_even = ((u32_fg & COLOUR_SPREAD_MASK) * u32_alpha +
+                         (u32_bg & COLOUR_SPREAD_MASK) * u32_inv) >> 5;
+    uint32_t u32_odd  = (((u32_fg >> 5) & COLOUR_PAIR_ODD_MASK) * u32_alpha +
+                         ((u32_bg >> 5) & COLOUR_PAIR_ODD_MASK) * u32_inv) >> 5;
+
+    return (u32_even & COLOUR_SPREAD_MASK) | ((u32_odd & COLOUR_PAIR_ODD_MASK) << 5);
+}
+
+/**
+ * @brief Mixes a row of foreground pixels into a row of background
+ *        pixels, two pixels per operation when dst and src share their
+ *        word alignment.
+ *
+ * @param dst       Background, receives the result
+ * @param src       Foreground
+ * @param u32_count Pixels
+ * @param u32_alpha 0..COLOUR_ALPHA_MAX
+ * @return None
+ */
+static inline void colour_blend_row(uint16_t *dst, const uint16_t *src, uint32_t u32_count, uint32_t u32_alpha)
+{
+    uint32_t i = 0u;
+
+    if ((((uintptr_t)dst ^ (uintptr_t)src) & 2u) == 0u) {
+        if ((((uintptr_t)dst & 2u) != 0u) && (u32_count > 0u)) {
+            dst[0] = colour_blend(src[0], dst[0], u32_alpha);
+            i = 1u;
+        }
+        for (; i + 2u <= u32_count; i += 2u) {
+            uint32_t *pu32_dst = (uint32_t *)(void *)&dst[i];
+
+            *pu32_dst = colour_blend_pair(*(const uint32_t *)(const void *)&src[i], *pu32_dst, u32_alpha);
+        }
+    }
+    for (; i < u32_count; i++) {
+        dst[i] = colour_blend(src[i], dst[i], u32_alpha);
+    }
+}
+
+/**
+ * @brief Fills a row with a colour, two pixels per store.
+ *
+ * @param dst       Destination
+ * @param colour    Colour
+ * @param u32_count Pixels
+ * @return None
+ */
+static inline void colour_fill_row(uint16_t *dst, uint16_t colour, uint32_t u32_count)
+{
+    uint32_t i = 0u;
+
+    if ((((uintptr_t)dst & 2u) != 0u) && (u32_count > 0u)) {
+        dst[0] = colour;
+        i = 1u;
+    }
+    for (; i + 2u <= u32_count; i += 2u) {
+        *(uint32_t *)(void *)&dst[i] = COLOUR_PAIR(colour);
+    }
+    if (i < u32_count) {
+        dst[i] = colour;
+    }
+}
+
+/**
+ * @brief Linear gradient from one colour to another, per channel in
+ *        Q16 steps: the first entry is 'from', the last 'to'.
+ *
+ * @param dst       u32_count colours
+ * @param from      First colour
+ * @param to        Last colour
+ * @param u32_count Entries
+ * @return None
+ */
+static inline void colour_gradient(uint16_t *dst, uint16_t from, uint16_t to, uint32_t u32_count)
+{
+    int32_t i32_steps = (u32_count > 1u) ? (int32_t)u32_count - 1 : 1;
+    int32_t i32_r  = (int32_t)(COLOUR_R5(from) << 16) + 0x8000;
+    int32_t i32_g  = (int32_t)(COLOUR_G6(from) << 16) + 0x8000;
+    int32_t i32_b  = (int32_t)(COLOUR_B5(from) << 16) + 0x8000;
+    int32_t i32_dr = ((int32_t)COLOUR_R5(to) - (int32_t)COLOUR_R5(from)) * 65536 / i32_steps;
+    int32_t i32_dg = ((int32_t)COLOUR_G6(to) - (int32_t)COLOUR_G6(from)) * 65536 / i32_steps;
+    int32_t i32_db = ((int32_t)COLOUR_B5(to) - (int32_t)COLOUR_B5(from)) * 65536 / i32_steps;
+
+    for (uint32_t i = 0u; i < u32_count; i++) {
+        dst[i] = (uint16_t)(((uint32_t)(i32_r >> 16) << 11) | ((uint32_t)(i32_g >> 16) << 5) | (uint32_t)(i32_b >> 16));
+        i32_r += i32_dr;
+        i32_g += i32_dg;
+        i32_b += i32_db;
+    }
+    if (u32_count > 1u) {
+        dst[u32_count - 1u] = to;
+    }
+}
+
+#endif /* COLOUR_COLOUR_H_ */
@@ -0,0 +1,127 @@
+/**
+ ******************************************************************************
+ * @file        databus.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Publish/subscribe data bus with latest-value slots
+ *
+ * Functionality:
+ * - One sync_snapshot_t per topic over two slots of the payload union
+ * - Change test against the slot the publication does not overwrite
+ * - Subscriber table per topic, filled before the count is raised, so a
+ *   publishing interrupt never calls a half written entry
+ *
+ * Resources:
+ * - None (RAM only)
+ ******************************************************************************
+ */
+
+#include "databus.h"
+#include "sync/sync.h"
+
+#include <stddef.h>
+#include <string.h>
+
+/* Private Type Definitions ------------------------------------------------- */
+/**
+ * @brief Room for the payload of every topic.
+ */
+typedef union {
+    databus_potis_t       potis;
+    databus_fan_t         fan;
+    databus_can_command_t can_command;
+    databus_can_fan_t     can_fan;
+    databus_can_env_t     can_env;
+} databus_slot_t;
+
+/**
+ * @brief One change callback.
+ */
+typedef struct {
+    databus_callback_t callback;
+    void              *context;
+} databus_subscriber_t;
+
+/* Static module variables -------------------------------------------------- */
+/**
+ * @brief Two slots per topic, the snapshots use the payload size as stride.
+ */
+static databus_slot_t g_databus_slots[DATABUS_TOPIC_COUNT][2];
+
+static sync_snapshot_t g_databus_topics[DATABUS_TOPIC_COUNT] = {
+    {0U, (uint8_t *)g_databus_slots[DATABUS_TOPIC_POTIS], (uint16_t)sizeof(databus_potis_t)},
+    {0U, (uint8_t *)g_databus_slots[DATABUS_TOPIC_FAN],   (uint16_t)sizeof(databus_fan_t)},
+    {0U, (uint8_t *)g_databus_slots[DATABUS_TOPIC_CAN_COMMAND], (uint16_t)sizeof(databus_can_command_t)},
+    {0U, (uint8_t *)g_databus_slots[DATABUS_TOPIC_CAN_FAN],     (uint16_t)sizeof(databus_can_fan_t)},
+    {0U, (uint8_t *)g_databus_slots[DATABUS_TOPIC_CAN_ENV],     (uint16_t)sizeof(databus_can_env_t)},
+};
+
+static databus_subscriber_t g_databus_subscribers[DATABUS_TOPIC_COUNT][DATABUS_SUBSCRIBERS];
+static volatile uint8_t g_u8_databus_subscribers[DATABUS_TOPIC_COUNT];
+
+/* Public functions --------------------------------------------------------- */
+void databus_publish(databus_topic_t topic, const void *data)
+{
+    sync_snapshot_t *snapshot = &g_databus_topics[topic];
+    uint32_t u32_sequence = snapshot->u32_sequence;
+    uint8_t u8_count;
+
+    /* The current slot stays untouched by this publication */
+    uint8_t u8_changed = (u32_sequence == 0U) ||
+                         (memcmp(data, &snapshot->pu8_buffers[(u32_sequence & 1U) * snapshot->u16_size],
+                                 snapshot->u16_size) != 0);
+
+    sync_snapshot_publish(snapshot, data);
+    if (!u8_changed) {
+        return;
+    }
+
+    u8_count = g_u8_databus_subscribers[topic];
+    for (uint8_t i = 0U; i < u8_count; i++) {
+        g_databus_subscribers[topic][i].callback(topic, data, g_databus_subscribers[topic][i].context);
+    }
+}
+
+HAL_StatusTypeDef databus_read(databus_topic_t topic, void *data)
+{
+    if (sync_snapshot_get_sequence(&g_databus_topics[topic]) == 0U) {
+        return HAL_ERROR;
+    }
+
+    return sync_snapshot_read(&g_databus_topics[topic], data);
+}
+
+uint8_t databus_read_new(databus_topic_t topic, uint32_t *pu32_sequence, void *data)
+{
+    uint32_t u32_sequence = sync_snapshot_get_sequence(&g_databus_topics[topic]);
+
+    if ((u32_sequence == *pu32_sequence) || (sync_snapshot_read(&g_databus_topics[topic], data) != HAL_OK)) {
+        return 0U;
+    }
+
+    /* A publication during the read is picked up by the next call */
+    *pu32_sequence = u32_sequence;
+    return 1U;
+}
+
+HAL_StatusTypeDef databus_subscribe(databus_topic_t topic, databus_callback_t callback, void *context)
+{
+    uint8_t u8_count = g_u8_databus_subscribers[topic];
+
+    if ((callback == NULL) || (u8_count >= DATABUS_SUBSCRIBERS)) {
+        return HAL_ERROR;
+    }
+
+    g_databus_subscribers[topic][u8_count].callback = callback;
+    g_databus_subscribers[topic][u8_count].context  = context;
+    __DMB();
+    g_u8_databus_subscribers[topic] = (uint8_t)(u8_count + 1U);
+
+    return HAL_OK;
+}
+
+uint32_t databus_get_sequence(databus_topic_t topic)
+{
+    return sync_snapshot_get_sequence(&g_databus_topics[topic]);
+}
@@ -0,0 +1,176 @@
+/**
+ ******************************************************************************
+ * @file        databus.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the publish/subscribe data bus.
+ *
+ * @details
+ * A producer publishes every new sample once under its topic; consumers
+ * (control loop, display, telemetry, logger) read the latest value of
+ * the topic instead of asking the producer, which would filter or
+ * compute again. Every topic is one latest-value slot, a double buffer
+ * (sync_snapshot_t): publishing copies the value once, any context may
+ * read it without locks and always gets one complete sample.
+ *
+ * Subscribers are called in the context of the publisher right after the
+ * value is in the slot and get a pointer to it, no copy (valid during
+ * the call only). Only values that differ from the previous one are
+ * notified, so a subscriber sees changes, not publications.
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - Fixed topics with one payload type each (below)
+ *  - databus_read(): latest value, databus_read_new(): only if newer
+ *    than the caller's last read
+ *  - Up to DATABUS_SUBSCRIBERS change callbacks per topic
+ *
+ * Topics and producers:
+ *  - DATABUS_TOPIC_POTIS: databus_potis_t, potis_dma per half buffer
+ *  - DATABUS_TOPIC_FAN:   databus_fan_t, fan control step (TIM6) of the
+ *                         default fan
+ *  - DATABUS_TOPIC_CAN_COMMAND / _CAN_FAN / _CAN_ENV: frames received by
+ *                         can_node (RX FIFO interrupts); one slot for
+ *                         all nodes, subscribers see every frame that
+ *                         differs from the one before
+ *
+ ******************************************************************************
+ */
+
+#ifndef DATABUS_DATABUS_H_
+#define DATABUS_DATABUS_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief Change callbacks per topic.
+ */
+#define DATABUS_SUBSCRIBERS     4U
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Topics.
+ */
+typedef enum {
+    DATABUS_TOPIC_POTIS = 0,
+    DATABUS_TOPIC_FAN,
+    DATABUS_TOPIC_CAN_COMMAND,
+    DATABUS_TOPIC_CAN_FAN,
+    DATABUS_TOPIC_CAN_ENV,
+    DATABUS_TOPIC_COUNT
+} databus_topic_t;
+
+/**
+ * @brief DATABUS_TOPIC_POTIS: averaged ADC values (12 bit).
+ */
+typedef struct {
+    uint32_t u32_poti_1;
+    uint32_t u32_poti_2;
+} databus_potis_t;
+
+/**
+ * @brief DATABUS_TOPIC_FAN: state after a control step.
+ */
+typedef struct {
+    uint32_t u32_target_rpm;
+    uint32_t u32_rpm;           /**< Filtered RPM                        */
+} databus_fan_t;
+
+/**
+ * @brief DATABUS_TOPIC_CAN_COMMAND: setpoint command to this node.
+ *        Publishers clear the padding (change test by memcmp).
+ */
+typedef struct {
+    uint8_t  u8_node;           /**< Own node or CAN_NODE_BROADCAST     */
+    uint8_t  u8_fan;            /**< Fan index, CAN_NODE_ALL_FANS: all   */
+    uint16_t u16_rpm;           /**< Target RPM                          */
+} databus_can_command_t;
+
+/**
+ * @brief DATABUS_TOPIC_CAN_FAN: fan state of a remote node.
+ */
+typedef struct {
+    uint8_t  u8_node;
+    uint8_t  u8_fan;
+    uint8_t  u8_health;         /**< fan_health_state_t                  */
+    uint8_t  u8_reserved;
+    uint16_t u16_rpm;
+    uint16_t u16_setpoint_rpm;
+    uint16_t u16_duty_permille;
+} databus_can_fan_t;
+
+/**
+ * @brief DATABUS_TOPIC_CAN_ENV: environment values of a remote node.
+ */
+typedef struct {
+    int32_t  i32_centi_celsius;
+    uint32_t u32_pascal;
+    uint32_t u32_milli_rh;
+    uint8_t  u8_node;
+} databus_can_env_t;
+
+/**
+ * @brief Change notification (context of the publisher).
+ *
+ * @param topic   Topic
+ * @param data    New value in the slot, valid during the call only
+ * @param context Pointer given to databus_subscribe()
+ */
+typedef void (*databus_callback_t)(databus_topic_t topic, const void *data, void *context);
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Stores a new value and notifies the subscribers if it changed.
+ *
+ * One producer per topic.
+ *
+ * @param topic Topic
+ * @param data  Value of the payload type of the topic
+ * @return None
+ */
+void databus_publish(databus_topic_t topic, const void *data);
+
+/**
+ * @brief Copies the latest value (any context).
+ *
+ * @param topic Topic
+ * @param data  Destination of the payload type of the topic
+ * @return HAL_OK, HAL_ERROR if nothing was published yet, HAL_BUSY if
+ *         the producer overtook the read twice (data not written)
+ */
+HAL_StatusTypeDef databus_read(databus_topic_t topic, void *data);
+
+/**
+ * @brief Copies the latest value if it was published after the last
+ *        read of the caller.
+ *
+ * @param topic         Topic
+ * @param pu32_sequence Publication count of the caller's last read,
+ *                      start with 0; updated on a read
+ * @param data          Destination of the payload type of the topic
+ * @return 1 if data holds a newer value, otherwise 0
+ */
+uint8_t databus_read_new(databus_topic_t topic, uint32_t *pu32_sequence, void *data);
+
+/**
+ * @brief Installs a change callback.
+ *
+ * @param topic    Topic
+ * @param callback Function, called from the publishing context
+ * @param context  Passed to the callback
+ * @return HAL_OK, HAL_ERROR if the topic has DATABUS_SUBSCRIBERS already
+ */
+HAL_StatusTypeDef databus_subscribe(databus_topic_t topic, databus_callback_t callback, void *context);
+
+/**
+ * @brief Returns how often a topic has been published.
+ *
+ * @param topic Topic
+ * @return Publications
+ */
+uint32_t databus_get_sequence(databus_topic_t topic);
+
+#endif /* DATABUS_DATABUS_H_ */
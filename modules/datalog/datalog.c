@@ -0,0 +1,302 @@
+/**
+ ******************************************************************************
+ * @file        datalog.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Triggered high rate data logger (ring of records, dump)
+ *
+ * Functionality:
+ * - One ring of records; writing, the trigger check and the window
+ *   counting happen together with interrupts masked, so every context
+ *   may log and a record is either complete or not there
+ * - Armed: the ring overwrites its oldest records, the pre-trigger
+ *   window is whatever of them is still there at the trigger
+ * - Triggered: the post-trigger window is counted down, then the ring is
+ *   frozen until the next datalog_arm()
+ * - The dump hands the sink pointers into the ring, chunk by chunk and
+ *   never across its end; a sink that is full is asked again later
+ * - With a dump filter the chunk is copied and filtered once, a full
+ *   sink gets the same copy again
+ *
+ * Resources:
+ * - Ring memory of the application (normally SDRAM), DWT cycle counter
+ ******************************************************************************
+ */
+
+#include "datalog.h"
+#include "utils/utils.h"
+#include <string.h>
+
+/* Static module variables -------------------------------------------------- */
+/**
+ * @brief Ring, its capacity in records and the next write position.
+ */
+static datalog_record_t *g_p_datalog_ring = NULL;
+static uint32_t g_u32_datalog_capacity = 0u;
+static uint32_t g_u32_datalog_head = 0u;
+
+/**
+ * @brief Records written since the arm (saturating at the capacity).
+ */
+static uint32_t g_u32_datalog_count = 0u;
+
+/**
+ * @brief Windows, position of the trigger record and the records kept
+ *        in front of it.
+ */
+static uint32_t g_u32_datalog_pre = 0u;
+static uint32_t g_u32_datalog_post = 0u;
+static uint32_t g_u32_datalog_post_remaining = 0u;
+static uint32_t g_u32_datalog_trigger_index = 0u;
+static uint32_t g_u32_datalog_pre_kept = 0u;
+
+/**
+ * @brief Trigger condition and manual trigger request.
+ */
+static uint16_t g_u16_datalog_trigger_channel = 0u;
+static datalog_trigger_t g_datalog_trigger_condition = DATALOG_TRIGGER_MANUAL;
+static int32_t g_i32_datalog_threshold = 0;
+static volatile uint8_t g_u8_datalog_trigger_request = 0u;
+
+static volatile datalog_state_t g_datalog_state = DATALOG_STATE_IDLE;
+
+/**
+ * @brief Dump position, records left and header still to be sent.
+ */
+static uint32_t g_u32_datalog_dump_pos = 0u;
+static uint32_t g_u32_datalog_dump_remaining = 0u;
+static uint8_t g_u8_datalog_dump_header = 0u;
+
+/**
+ * @brief Dump filter, its copy of the current chunk and the records in
+ *        the copy (0: none filtered yet).
+ */
+static datalog_filter_t g_datalog_dump_filter = NULL;
+static datalog_record_t g_datalog_dump_chunk[DATALOG_DUMP_CHUNK];
+static uint32_t g_u32_datalog_dump_chunk_len = 0u;
+
+/* Static function prototypes ---------------------------------------------- */
+static uint8_t datalog_condition(uint16_t u16_channel, int32_t i32_value);
+
+/* Public functions --------------------------------------------------------- */
+HAL_StatusTypeDef datalog_init(void *buffer, uint32_t u32_size)
+{
+    if ((buffer == NULL) || ((u32_size / sizeof(datalog_record_t)) < 2u * DATALOG_DUMP_CHUNK)) {
+        return HAL_ERROR;
+    }
+
+    utils_timebase_init();
+
+    datalog_stop();
+    g_p_datalog_ring       = (datalog_record_t *)buffer;
+    g_u32_datalog_capacity = u32_size / sizeof(datalog_record_t);
+
+    return HAL_OK;
+}
+
+void datalog_set_trigger(uint16_t u16_channel, datalog_trigger_t condition, int32_t i32_threshold)
+{
+    g_u16_datalog_trigger_channel = u16_channel;
+    g_datalog_trigger_condition   = condition;
+    g_i32_datalog_threshold       = i32_threshold;
+}
+
+HAL_StatusTypeDef datalog_arm(uint32_t u32_pre_records, uint32_t u32_post_records)
+{
+    uint32_t u32_primask;
+
+    /* The post-trigger records must not overwrite the pre-trigger window */
+    if ((g_p_datalog_ring == NULL) ||
+        (u32_pre_records >= g_u32_datalog_capacity) ||
+        (u32_post_records >= g_u32_datalog_capacity - u32_pre_records)) {
+        return HAL_ERROR;
+    }
+
+    u32_primask = __get_PRIMASK();
+    __disable_irq();
+    g_u32_datalog_head           = 0u;
+    g_u32_datalog_count          = 0u;
+    g_u32_datalog_pre            = u32_pre_records;
+    g_u32_datalog_post           = u32_post_records;
+    g_u8_datalog_trigger_request = 0u;
+    g_u32_datalog_dump_remaining = 0u;
+    g_u8_datalog_dump_header     = 0u;
+    g_datalog_state              = DATALOG_STATE_ARMED;
+    __set_PRIMASK(u32_primask);
+
+    return HAL_OK;
+}
+
+void datalog_trigger(void)
+{
+    g_u8_datalog_trigger_request = 1u;
+}
+
+void datalog_stop(void)
+{
+    g_datalog_state              = DATALOG_STATE_IDLE;
+    g_u32_datalog_dump_remaining = 0u;
+    g_u8_datalog_dump_header     = 0u;
+}
+
+datalog_state_t datalog_get_state(void)
+{
+    return g_datalog_state;
+}
+
+void datalog_log(uint16_t u16_channel, int32_t i32_value)
+{
+    datalog_log_at(u16_channel, i32_value, utils_now_cycles());
+}
+
+void datalog_log_at(uint16_t u16_channel, int32_t i32_value, uint32_t u32_time)
+{
+    datalog_record_t *p_record;
+    uint32_t u32_primask;
+    uint16_t u16_flags = 0u;
+
+    /* Cheap exit while idle or frozen, the state is checked again below */
+    if ((g_datalog_state != DATALOG_STATE_ARMED) && (g_datalog_state != DATALOG_STATE_TRIGGERED)) {
+        return;
+    }
+
+    u32_primask = __get_PRIMASK();
+    __disable_irq();
+
+    if (g_datalog_state == DATALOG_STATE_ARMED) {
+        if (g_u8_datalog_trigger_request || datalog_condition(u16_channel, i32_value)) {
+            g_u8_datalog_trigger_request = 0u;
+            g_u32_datalog_trigger_index  = g_u32_datalog_head;
+            g_u32_datalog_pre_kept       = (g_u32_datalog_count < g_u32_datalog_pre) ?
+                                           g_u32_datalog_count : g_u32_datalog_pre;
+            g_u32_datalog_post_remaining = g_u32_datalog_post;
+            g_datalog_state              = DATALOG_STATE_TRIGGERED;
+            u16_flags                    = DATALOG_FLAG_TRIGGER;
+        }
+    } else if (g_datalog_state != DATALOG_STATE_TRIGGERED) {
+        __set_PRIMASK(u32_primask);
+        return;
+    } else {
+        g_u32_datalog_post_remaining--;
+    }
+
+    p_record = &g_p_datalog_ring[g_u32_datalog_head];
+    p_record->u32_time    = u32_time;
+    p_record->i32_value   = i32_value;
+    p_record->u16_channel = u16_channel;
+    p_record->u16_flags   = u16_flags;
+
+    g_u32_datalog_head = (g_u32_datalog_head + 1u == g_u32_datalog_capacity) ? 0u : g_u32_datalog_head + 1u;
+    if (g_u32_datalog_count < g_u32_datalog_capacity) {
+        g_u32_datalog_count++;
+    }
+    if ((g_datalog_state == DATALOG_STATE_TRIGGERED) && (g_u32_datalog_post_remaining == 0u)) {
+        g_datalog_state = DATALOG_STATE_DONE;
+    }
+
+    __set_PRIMASK(u32_primask);
+}
+
+HAL_StatusTypeDef datalog_dump_start(void)
+{
+    if (g_datalog_state != DATALOG_STATE_DONE) {
+        return HAL_BUSY;
+    }
+
+    /* Oldest kept record up to the last post-trigger record */
+    g_u32_datalog_dump_pos = (g_u32_datalog_trigger_index + g_u32_datalog_capacity - g_u32_datalog_pre_kept) %
+                             g_u32_datalog_capacity;
+    g_u32_datalog_dump_remaining = g_u32_datalog_pre_kept + 1u + g_u32_datalog_post;
+    g_u8_datalog_dump_header     = 1u;
+    g_u32_datalog_dump_chunk_len = 0u;
+
+    return HAL_OK;
+}
+
+void datalog_set_dump_filter(datalog_filter_t filter)
+{
+    g_datalog_dump_filter        = filter;
+    g_u32_datalog_dump_chunk_len = 0u;
+}
+
+uint32_t datalog_dump_step(datalog_sink_t sink, uint32_t u32_max_chunks)
+{
+    datalog_header_t header;
+    const datalog_record_t *p_chunk;
+    uint32_t u32_records;
+
+    if (g_u8_datalog_dump_header) {
+        header.u32_magic           = DATALOG_MAGIC;
+        header.u16_record_size     = (uint16_t)sizeof(datalog_record_t);
+        header.u16_trigger_channel = g_u16_datalog_trigger_channel;
+        header.u32_records         = g_u32_datalog_dump_remaining;
+        header.u32_trigger_index   = g_u32_datalog_pre_kept;
+        header.u32_clock_hz        = SystemCoreClock;
+        if (sink(&header, (uint16_t)sizeof(header)) != HAL_OK) {
+            return g_u32_datalog_dump_remaining;
+        }
+        g_u8_datalog_dump_header = 0u;
+    }
+
+    while ((g_u32_datalog_dump_remaining != 0u) && (u32_max_chunks-- != 0u)) {
+        u32_records = g_u32_datalog_dump_remaining;
+        if (u32_records > DATALOG_DUMP_CHUNK) {
+            u32_records = DATALOG_DUMP_CHUNK;
+        }
+        if (u32_records > g_u32_datalog_capacity - g_u32_datalog_dump_pos) {
+            u32_records = g_u32_datalog_capacity - g_u32_datalog_dump_pos;
+        }
+
+        p_chunk = &g_p_datalog_ring[g_u32_datalog_dump_pos];
+        if (g_datalog_dump_filter != NULL) {
+            if (g_u32_datalog_dump_chunk_len == 0u) {
+                memcpy(g_datalog_dump_chunk, p_chunk, u32_records * sizeof(datalog_record_t));
+                g_datalog_dump_filter(g_datalog_dump_chunk, u32_records,
+                                      g_u32_datalog_pre_kept + 1u + g_u32_datalog_post -
+                                      g_u32_datalog_dump_remaining);
+                g_u32_datalog_dump_chunk_len = u32_records;
+            }
+            p_chunk = g_datalog_dump_chunk;
+        }
+
+        if (sink(p_chunk, (uint16_t)(u32_records * sizeof(datalog_record_t))) != HAL_OK) {
+            break;
+        }
+        g_u32_datalog_dump_chunk_len = 0u;
+
+        g_u32_datalog_dump_pos += u32_records;
+        if (g_u32_datalog_dump_pos == g_u32_datalog_capacity) {
+            g_u32_datalog_dump_pos = 0u;
+        }
+        g_u32_datalog_dump_remaining -= u32_records;
+    }
+
+    return g_u32_datalog_dump_remaining;
+}
+
+/* Static module functions -------------------------------------------------- */
+/**
+ * @brief Evaluates the trigger condition for one value.
+ *
+ * @param u16_channel Channel of the value
+ * @param i32_value   Value
+ * @return 1 if the capture triggers
+ */
+static uint8_t datalog_condition(uint16_t u16_channel, int32_t i32_value)
+{
+    if (u16_channel != g_u16_datalog_trigger_channel) {
+        return 0u;
+    }
+
+    switch (g_datalog_trigger_condition) {
+        case DATALOG_TRIGGER_ABOVE:
+            return (i32_value > g_i32_datalog_threshold) ? 1u : 0u;
+        case DATALOG_TRIGGER_BELOW:
+            return (i32_value < g_i32_datalog_threshold) ? 1u : 0u;
+        case DATALOG_TRIGGER_MAGNITUDE:
+            return ((i32_value > g_i32_datalog_threshold) || (i32_value < -g_i32_datalog_threshold)) ? 1u : 0u;
+        default:
+            return 0u;
+    }
+}
@@ -0,0 +1,265 @@
+/**
+ ******************************************************************************
+ * @file        datalog.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the triggered high rate data logger.
+ *
+ * @details
+ * Records time stamped values of many channels into one large ring of
+ * fixed size records, normally the external SDRAM (about 600000 records
+ * in 7 MB). Like a storage oscilloscope it waits for a trigger condition
+ * on one channel, keeps a pre-trigger window of records before it and
+ * stops after the post-trigger window; the frozen capture is then dumped
+ * in chunks over any byte sink (usb_cdc_write(), a uart_telemetry
+ * wrapper) while the application keeps running.
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - Record: DWT cycle timestamp, i32 value, channel, flags (12 bytes)
+ *  - Logging is interrupt safe and never waits: a few cycles with
+ *    interrupts masked per record, nothing is written once the capture
+ *    is complete
+ *  - Trigger: value above / below a threshold, magnitude above a
+ *    threshold (e.g. the RPM error) or datalog_trigger() by hand
+ *  - Windows in records: pre + post must fit into the ring
+ *  - Preinstrumented: potis_dma raw scans, fan tacho periods and PI
+ *    step, env_sensor samples; compiled out unless DATALOG_ENABLE is 1
+ *  - modules/datalog/datalog_decode.py turns a dump into CSV
+ *
+ * Channel values:
+ *  - DATALOG_CH_POTI_1/2:       raw 12 bit ADC samples, back dated to
+ *                               their scan with the TIM8 rate
+ *  - DATALOG_CH_TACHO_PERIOD:   us between two tacho edges (EXTI mode)
+ *  - DATALOG_CH_FAN_RPM:        filtered rpm of a PI step
+ *  - DATALOG_CH_FAN_ERROR:      target - rpm of a PI step
+ *  - DATALOG_CH_FAN_OUTPUT:     PWM compare value after the step
+ *  - DATALOG_CH_ENV_TEMP/PRESS/HUM: 0.01 C, Pa, 0.001 %
+ *  - DATALOG_CH_ENV_RAW_TEMP/PRESS/HUM: uncompensated ADC values
+ *                               (ENV_SENSOR_DEFERRED), compensated in
+ *                               the dump by env_sensor_datalog_filter()
+ *
+ * Dump: one datalog_header_t, then the records oldest first, all little
+ * endian. A dump filter (datalog_set_dump_filter()) rewrites each chunk
+ * in a copy before it goes to the sink, the capture stays as recorded. The SDRAM shares pins with esd, dot and env_sensor (see
+ * sdram.h); with one of them the ring has to live in internal RAM.
+ *
+ ******************************************************************************
+ */
+
+#ifndef DATALOG_DATALOG_H_
+#define DATALOG_DATALOG_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief 1 to compile the log points in, 0 removes them.
+ */
+#ifndef DATALOG_ENABLE
+#define DATALOG_ENABLE          0
+#endif
+
+/**
+ * @brief Ring in the SDRAM behind the first MB (LTDC framebuffers).
+ */
+#define DATALOG_SDRAM_OFFSET    0x00100000UL
+#define DATALOG_SDRAM_SIZE      (0x00800000UL - DATALOG_SDRAM_OFFSET)
+
+/**
+ * @brief Records per sink call of datalog_dump_step().
+ */
+#define DATALOG_DUMP_CHUNK      64U
+
+/**
+ * @brief First word of the dump ("DLOG"), record flag of the trigger.
+ */
+#define DATALOG_MAGIC           0x474F4C44UL
+#define DATALOG_FLAG_TRIGGER    0x0001U
+
+#if DATALOG_ENABLE
+#define DATALOG_LOG(ch, value)          datalog_log((ch), (int32_t)(value))
+#define DATALOG_LOG_AT(ch, value, time) datalog_log_at((ch), (int32_t)(value), (time))
+#else
+#define DATALOG_LOG(ch, value)          do { } while (0)
+#define DATALOG_LOG_AT(ch, value, time) do { } while (0)
+#endif
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Channels of the instrumented modules.
+ */
+typedef enum {
+    DATALOG_CH_POTI_1       = 1,    /**< Raw ADC sample POTI_1                */
+    DATALOG_CH_POTI_2       = 2,    /**< Raw ADC sample POTI_2                */
+    DATALOG_CH_TACHO_PERIOD = 3,    /**< Tacho edge interval in us            */
+    DATALOG_CH_FAN_RPM      = 4,    /**< Filtered rpm of the PI step          */
+    DATALOG_CH_FAN_ERROR    = 5,    /**< PI error in rpm                      */
+    DATALOG_CH_FAN_OUTPUT   = 6,    /**< PWM compare value                    */
+    DATALOG_CH_ENV_TEMP     = 7,    /**< Temperature in 0.01 C                */
+    DATALOG_CH_ENV_PRESS    = 8,    /**< Pressure in Pa                       */
+    DATALOG_CH_ENV_HUM      = 9,    /**< Humidity in 0.001 %                  */
+    DATALOG_CH_ENV_RAW_TEMP = 10,   /**< Uncompensated temperature (20 bit)   */
+    DATALOG_CH_ENV_RAW_PRESS = 11,  /**< Uncompensated pressure (20 bit)      */
+    DATALOG_CH_ENV_RAW_HUM  = 12,   /**< Uncompensated humidity (16 bit)      */
+    DATALOG_CH_USER         = 32    /**< First channel for the application    */
+} datalog_channel_t;
+
+/**
+ * @brief Trigger conditions on the trigger channel.
+ */
+typedef enum {
+    DATALOG_TRIGGER_MANUAL = 0,     /**< datalog_trigger() only               */
+    DATALOG_TRIGGER_ABOVE,          /**< value > threshold                    */
+    DATALOG_TRIGGER_BELOW,          /**< value < threshold                    */
+    DATALOG_TRIGGER_MAGNITUDE       /**< |value| > threshold                  */
+} datalog_trigger_t;
+
+/**
+ * @brief Capture states.
+ */
+typedef enum {
+    DATALOG_STATE_IDLE = 0,         /**< Not recording                        */
+    DATALOG_STATE_ARMED,            /**< Recording, waiting for the trigger   */
+    DATALOG_STATE_TRIGGERED,        /**< Recording the post-trigger window    */
+    DATALOG_STATE_DONE              /**< Capture frozen, ready for the dump   */
+} datalog_state_t;
+
+/**
+ * @brief One record.
+ */
+typedef struct {
+    uint32_t u32_time;              /**< DWT cycles                           */
+    int32_t  i32_value;
+    uint16_t u16_channel;
+    uint16_t u16_flags;             /**< DATALOG_FLAG_TRIGGER                 */
+} datalog_record_t;
+
+/**
+ * @brief Start of every dump.
+ */
+typedef struct {
+    uint32_t u32_magic;             /**< DATALOG_MAGIC                        */
+    uint16_t u16_record_size;       /**< sizeof(datalog_record_t)             */
+    uint16_t u16_trigger_channel;
+    uint32_t u32_records;           /**< Records following the header         */
+    uint32_t u32_trigger_index;     /**< Position of the trigger record       */
+    uint32_t u32_clock_hz;          /**< Core clock of the timestamps         */
+} datalog_header_t;
+
+/**
+ * @brief Byte sink of the dump, e.g. usb_cdc_write().
+ *
+ * @return HAL_OK if taken, HAL_BUSY to retry the same bytes later
+ */
+typedef HAL_StatusTypeDef (*datalog_sink_t)(const void *data, uint16_t u16_length);
+
+/**
+ * @brief Rewrites a chunk of the dump in place, e.g. raw samples into
+ *        values (env_sensor_datalog_filter()).
+ *
+ * @param records   Copy of the chunk
+ * @param u32_count Records in the chunk
+ * @param u32_index Position of the first record in the dump, 0 at the
+ *                  start of a dump
+ */
+typedef void (*datalog_filter_t)(datalog_record_t *records, uint32_t u32_count, uint32_t u32_index);
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Sets the ring and starts the cycle counter; the logger is idle.
+ *
+ * @param buffer   Word aligned memory, e.g. SDRAM_BANK_ADDR +
+ *                 DATALOG_SDRAM_OFFSET after sdram_init()
+ * @param u32_size Size in bytes
+ * @return HAL_OK, HAL_ERROR if the memory holds fewer than two chunks
+ */
+HAL_StatusTypeDef datalog_init(void *buffer, uint32_t u32_size);
+
+/**
+ * @brief Sets the trigger condition, takes effect with the next arm.
+ *
+ * @param u16_channel    Trigger channel
+ * @param condition      Condition
+ * @param i32_threshold  Threshold in the unit of the channel
+ * @return None
+ */
+void datalog_set_trigger(uint16_t u16_channel, datalog_trigger_t condition, int32_t i32_threshold);
+
+/**
+ * @brief Starts recording and waits for the trigger.
+ *
+ * @param u32_pre_records  Records kept before the trigger
+ * @param u32_post_records Records recorded after the trigger
+ * @return HAL_OK, HAL_ERROR if both windows together exceed the ring
+ */
+HAL_StatusTypeDef datalog_arm(uint32_t u32_pre_records, uint32_t u32_post_records);
+
+/**
+ * @brief Triggers an armed capture at the next record.
+ *
+ * @return None
+ */
+void datalog_trigger(void);
+
+/**
+ * @brief Stops recording, the capture is discarded.
+ *
+ * @return None
+ */
+void datalog_stop(void);
+
+/**
+ * @brief Returns the state of the capture.
+ *
+ * @return State
+ */
+datalog_state_t datalog_get_state(void);
+
+/**
+ * @brief Records one value with the current time (any context).
+ *
+ * @param u16_channel Channel
+ * @param i32_value   Value
+ * @return None
+ */
+void datalog_log(uint16_t u16_channel, int32_t i32_value);
+
+/**
+ * @brief Records one value with an earlier time from utils_now_cycles().
+ *
+ * @param u16_channel Channel
+ * @param i32_value   Value
+ * @param u32_time    DWT cycles
+ * @return None
+ */
+void datalog_log_at(uint16_t u16_channel, int32_t i32_value, uint32_t u32_time);
+
+/**
+ * @brief Sets the filter applied to every chunk of the following dumps.
+ *
+ * @param filter Filter, NULL sends the ring as it is
+ * @return None
+ */
+void datalog_set_dump_filter(datalog_filter_t filter);
+
+/**
+ * @brief Starts the dump of a complete capture.
+ *
+ * @return HAL_OK, HAL_BUSY if the capture is not complete
+ */
+HAL_StatusTypeDef datalog_dump_start(void);
+
+/**
+ * @brief Hands the next chunks of the dump to the sink, returns when the
+ *        sink is full or after u32_max_chunks chunks (one task run).
+ *
+ * @param sink           Byte sink
+ * @param u32_max_chunks Chunks per call
+ * @return Records still to be sent, 0 once the dump is complete
+ */
+uint32_t datalog_dump_step(datalog_sink_t sink, uint32_t u32_max_chunks);
+
+#endif /* DATALOG_DATALOG_H_ */
@@ -0,0 +1,92 @@
+#!/usr/bin/env python3
+"""Decoder for the dumps of modules/datalog.
+
+Reads a dump (e.g. PREFIX_datalog.bin of usb_cdc_decode.py) and writes
+one CSV line per record: time in seconds relative to the trigger, channel
+name, value, and a mark on the trigger record. Several dumps in one file
+are written one after the other.
+
+Only the standard library is needed; ``--plot`` uses matplotlib.
+
+Usage:
+    datalog_decode.py dump.bin [--csv out.csv] [--plot]
+"""
+
+import argparse
+import csv
+import struct
+import sys
+
+MAGIC = 0x474F4C44
+HEADER = struct.Struct("<IHHIII")   # magic, record size, trigger channel, records, trigger index, clock
+RECORD = struct.Struct("<iiHH")     # time (cycles), value, channel, flags
+FLAG_TRIGGER = 0x0001
+
+# Channels, see datalog.h
+CHANNELS = {
+    1: "poti_1", 2: "poti_2", 3: "tacho_period_us", 4: "fan_rpm",
+    5: "fan_error_rpm", 6: "fan_output", 7: "env_temp_0.01C",
+    8: "env_press_pa", 9: "env_hum_0.001%", 10: "env_raw_temp",
+    11: "env_raw_press", 12: "env_raw_hum",
+}
+
+
+def dumps(data):
+    """Yields (header, records) for every dump in the data."""
+    pos = 0
+    while len(data) - pos >= HEADER.size:
+        magic, record_size, trigger_channel, count, trigger_index, clock_hz = HEADER.unpack_from(data, pos)
+        if magic != MAGIC or record_size != RECORD.size:
+            pos += 1
+            continue
+        pos += HEADER.size
+        count = min(count, (len(data) - pos) // RECORD.size)
+        records = [RECORD.unpack_from(data, pos + i * RECORD.size) for i in range(count)]
+        pos += count * RECORD.size
+        yield (trigger_channel, trigger_index, clock_hz), records
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("source", help="dump file")
+    parser.add_argument("--csv", help="CSV file, default: stdout")
+    parser.add_argument("--plot", action="store_true", help="plot the channels of the last dump")
+    args = parser.parse_args()
+
+    with open(args.source, "rb") as stream:
+        data = stream.read()
+
+    out = open(args.csv, "w", newline="") if args.csv else sys.stdout
+    writer = csv.writer(out)
+    writer.writerow(["dump", "time_s", "channel", "value", "trigger"])
+
+    series = {}
+    for number, ((trigger_channel, trigger_index, clock_hz), records) in enumerate(dumps(data)):
+        series = {}
+        trigger_time = records[trigger_index][0] if trigger_index < len(records) else records[0][0]
+        for time, value, channel, flags in records:
+            # Signed difference to the trigger: correct across the 2^32 wrap
+            time_s = ((time - trigger_time + 2**31) % 2**32 - 2**31) / float(clock_hz)
+            name = CHANNELS.get(channel, "ch_%d" % channel)
+            writer.writerow([number, "%.7f" % time_s, name, value, 1 if flags & FLAG_TRIGGER else ""])
+            series.setdefault(name, []).append((time_s, value))
+        sys.stderr.write("dump %d: %d records, trigger on %s at record %d\n" %
+                         (number, len(records), CHANNELS.get(trigger_channel, trigger_channel), trigger_index))
+
+    if out is not sys.stdout:
+        out.close()
+
+    if args.plot and series:
+        import matplotlib.pyplot as plt
+
+        fig, axes = plt.subplots(len(series), 1, sharex=True, squeeze=False)
+        for axis, (label, points) in zip(axes[:, 0], sorted(series.items())):
+            axis.step([p[0] for p in points], [p[1] for p in points], where="post")
+            axis.axvline(0.0, color="red", linewidth=0.8)
+            axis.set_ylabel(label)
+        axes[-1, 0].set_xlabel("time after trigger [s]")
+        plt.show()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,245 @@
+/**
+ ******************************************************************************
+ * @file        deadline.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Deadline supervisor: response and execution time of the
+ *              critical steps, watchdog refresh per good window.
+ *
+ * Functionality:
+ * - Release, start and end stamps of the system timebase per step; the
+ *   counters are written only by the context of the step
+ * - The window compares the counters with their values at the last
+ *   close (single words, read without locks) and checks the time since
+ *   the last end of every periodic step
+ *
+ * Resources:
+ * - IWDG (LSI / 32, 1 ms per count), DBGMCU APB1 freeze of the IWDG
+ ******************************************************************************
+ */
+
+#include "deadline.h"
+#include "dlog/dlog.h"
+#include "timebase/timebase.h"
+
+/* Preprocessor Defines ----------------------------------------------------- */
+/**
+ * @brief IWDG prescaler for 1 ms per count at the nominal LSI of 32 kHz.
+ */
+#define DEADLINE_IWDG_PRESCALER     IWDG_PRESCALER_32
+
+/* Private Type Definitions ------------------------------------------------- */
+/**
+ * @brief One supervised step.
+ */
+typedef struct {
+    uint32_t         u32_period_us;
+    uint32_t         u32_deadline_us;
+    uint32_t         u32_budget_us;
+    uint32_t         u32_release;       /**< Release of the current run   */
+    uint32_t         u32_start;         /**< Start of the current run     */
+    volatile uint32_t u32_end;          /**< End of the last run          */
+    deadline_stats_t stats;
+    uint32_t         u32_window_faults; /**< Misses + overruns at the last close */
+} deadline_entry_t;
+
+/* Static module variables -------------------------------------------------- */
+static deadline_entry_t g_deadline_tasks[DEADLINE_MAX_TASKS];
+static volatile uint8_t g_u8_deadline_count = 0u;
+
+/**
+ * @brief Open window and its result counter.
+ */
+static uint32_t g_u32_deadline_window_start = 0u;
+static uint32_t g_u32_deadline_failed = 0u;
+
+#if DEADLINE_ENABLE
+static IWDG_HandleTypeDef g_deadline_iwdg_handle;
+static uint8_t g_u8_deadline_iwdg_on = 0u;
+#endif
+
+/* Static function prototypes ----------------------------------------------- */
+static uint8_t deadline_check(deadline_entry_t *entry, uint32_t u32_now);
+
+/* Public functions --------------------------------------------------------- */
+void deadline_init(void)
+{
+    g_u8_deadline_count = 0u;
+    g_u32_deadline_failed = 0u;
+    g_u32_deadline_window_start = timebase_now32();
+}
+
+HAL_StatusTypeDef deadline_add(uint32_t u32_period_us, uint32_t u32_deadline_us,
+                               uint32_t u32_budget_us, uint8_t *pu8_id)
+{
+    deadline_entry_t *entry;
+
+    if ((g_u8_deadline_count >= DEADLINE_MAX_TASKS) || (u32_deadline_us == 0u) ||
+        (u32_budget_us == 0u) || (pu8_id == NULL)) {
+        return HAL_ERROR;
+    }
+
+    entry = &g_deadline_tasks[g_u8_deadline_count];
+    entry->u32_period_us     = u32_period_us;
+    entry->u32_deadline_us   = u32_deadline_us;
+    entry->u32_budget_us     = u32_budget_us;
+    entry->u32_release       = 0u;
+    entry->u32_start         = 0u;
+    entry->u32_end           = timebase_now32();    /* First run due from now */
+    entry->stats             = (deadline_stats_t){0};
+    entry->u32_window_faults = 0u;
+
+    *pu8_id = g_u8_deadline_count;
+
+    /* Visible to deadline_begin() only when complete */
+    __DMB();
+    g_u8_deadline_count++;
+
+    return HAL_OK;
+}
+
+void deadline_begin(uint8_t u8_id, uint32_t u32_late_us)
+{
+    deadline_entry_t *entry;
+
+    if (u8_id >= g_u8_deadline_count) {
+        return;
+    }
+
+    entry = &g_deadline_tasks[u8_id];
+    entry->u32_start   = timebase_now32();
+    entry->u32_release = entry->u32_start - u32_late_us;
+}
+
+void deadline_end(uint8_t u8_id)
+{
+    deadline_entry_t *entry;
+    uint32_t u32_end;
+    uint32_t u32_response;
+    uint32_t u32_exec;
+
+    if (u8_id >= g_u8_deadline_count) {
+        return;
+    }
+
+    entry = &g_deadline_tasks[u8_id];
+    u32_end      = timebase_now32();
+    u32_response = u32_end - entry->u32_release;
+    u32_exec     = u32_end - entry->u32_start;
+
+    if (u32_response > entry->u32_deadline_us) {
+        entry->stats.u32_misses++;
+    }
+    if (u32_exec > entry->u32_budget_us) {
+        entry->stats.u32_overruns++;
+    }
+    if (u32_response > entry->stats.u32_response_us) {
+        entry->stats.u32_response_us = u32_response;
+    }
+    if (u32_exec > entry->stats.u32_exec_us) {
+        entry->stats.u32_exec_us = u32_exec;
+    }
+    entry->stats.u32_runs++;
+    entry->u32_end = u32_end;
+}
+
+HAL_StatusTypeDef deadline_watchdog_start(void)
+{
+#if DEADLINE_ENABLE
+    if (g_u8_deadline_iwdg_on) {
+        return HAL_OK;
+    }
+
+    /* A halted core (breakpoint) must not bite */
+    DBGMCU->APB1FZ |= DBGMCU_APB1_FZ_DBG_IWDG_STOP;
+
+    g_deadline_iwdg_handle.Instance       = IWDG;
+    g_deadline_iwdg_handle.Init.Prescaler = DEADLINE_IWDG_PRESCALER;
+    g_deadline_iwdg_handle.Init.Reload    = DEADLINE_IWDG_TIMEOUT_MS;
+    if (HAL_IWDG_Init(&g_deadline_iwdg_handle) != HAL_OK) {
+        return HAL_ERROR;
+    }
+    g_u8_deadline_iwdg_on = 1u;
+    g_u32_deadline_window_start = timebase_now32();
+#endif
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef deadline_poll(void)
+{
+    uint32_t u32_now = timebase_now32();
+    uint8_t u8_count = g_u8_deadline_count;
+    uint8_t u8_good = 1u;
+
+    if ((u32_now - g_u32_deadline_window_start) < DEADLINE_WINDOW_MS * 1000u) {
+        return HAL_OK;
+    }
+    g_u32_deadline_window_start = u32_now;
+
+    for (uint8_t i = 0u; i < u8_count; i++) {
+        if (!deadline_check(&g_deadline_tasks[i], u32_now)) {
+            DLOG("deadline: window failed, step %u", i);
+            u8_good = 0u;
+        }
+    }
+
+    if (!u8_good) {
+        g_u32_deadline_failed++;
+        return HAL_ERROR;
+    }
+
+#if DEADLINE_ENABLE
+    if (g_u8_deadline_iwdg_on) {
+        (void)HAL_IWDG_Refresh(&g_deadline_iwdg_handle);
+    }
+#endif
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef deadline_get_stats(uint8_t u8_id, deadline_stats_t *stats)
+{
+    if (u8_id >= g_u8_deadline_count) {
+        return HAL_ERROR;
+    }
+
+    *stats = g_deadline_tasks[u8_id].stats;
+
+    return HAL_OK;
+}
+
+uint8_t deadline_get_count(void)
+{
+    return g_u8_deadline_count;
+}
+
+uint32_t deadline_get_failed_windows(void)
+{
+    return g_u32_deadline_failed;
+}
+
+/* Static functions --------------------------------------------------------- */
+/**
+ * @brief Checks one step for the window just closed.
+ *
+ * @param entry   Step
+ * @param u32_now Close of the window
+ * @return 1 good, 0 missed, overran or did not complete in time
+ */
+static uint8_t deadline_check(deadline_entry_t *entry, uint32_t u32_now)
+{
+    uint32_t u32_faults = entry->stats.u32_misses + entry->stats.u32_overruns;
+    uint8_t u8_good = (u32_faults == entry->u32_window_faults);
+
+    entry->u32_window_faults = u32_faults;
+
+    /* The run of the latest release is overdue */
+    if ((entry->u32_period_us != 0u) &&
+        ((u32_now - entry->u32_end) > entry->u32_period_us + entry->u32_deadline_us)) {
+        u8_good = 0u;
+    }
+
+    return u8_good;
+}
@@ -0,0 +1,177 @@
+/**
+ ******************************************************************************
+ * @file        deadline.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the deadline supervisor.
+ *
+ * @details
+ * Proves that the critical steps of a project are on time under any
+ * display, logging or telemetry load. Each critical step (the fan
+ * control interrupt, a sensor task of the scheduler) is registered with
+ * its period, its relative deadline (release to end) and its execution
+ * budget and brackets every run with deadline_begin() / deadline_end():
+ *
+ *  - miss:    end - release > deadline (the result came too late)
+ *  - overrun: end - start > budget (the step itself took too long)
+ *
+ * deadline_poll() closes a window of DEADLINE_WINDOW_MS in the main loop.
+ * A window is good if no step missed or overran and every periodic step
+ * completed one run within period + deadline; only a good window
+ * refreshes the independent watchdog (IWDG). A main loop that stops
+ * polling is caught as well, the watchdog has no other refresh.
+ *
+ * The scheduler brackets the tasks given to sched_set_deadline(), the fan
+ * module its control step after fan_control_set_deadline(); the stamps
+ * are those of the system timebase.
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - Up to DEADLINE_MAX_TASKS steps, each bracketed from one context
+ *    (its interrupt or the main loop), no locks
+ *  - Per step: runs, misses, overruns, worst response and execution time
+ *  - Failed windows counted (and logged with DLOG) for telemetry
+ *  - Watchdog only with DEADLINE_ENABLE 1: the IWDG cannot be stopped
+ *    once started, it is frozen while the core is halted by the debugger
+ *
+ * The IWDG runs on in the STOP mode, projects with the lowpower module
+ * must not start it.
+ *
+ ******************************************************************************
+ */
+
+#ifndef DEADLINE_DEADLINE_H_
+#define DEADLINE_DEADLINE_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief 1 to supervise the critical steps and start the watchdog.
+ */
+#ifndef DEADLINE_ENABLE
+#define DEADLINE_ENABLE         0
+#endif
+
+/**
+ * @brief Maximum number of supervised steps.
+ */
+#define DEADLINE_MAX_TASKS      8U
+
+/**
+ * @brief Id of "not supervised".
+ */
+#define DEADLINE_NONE           0xFFU
+
+/**
+ * @brief Length of one supervision window.
+ */
+#ifndef DEADLINE_WINDOW_MS
+#define DEADLINE_WINDOW_MS      100U
+#endif
+
+/**
+ * @brief Watchdog timeout (IWDG at 1 ms per count, up to 4095 ms). Two
+ *        windows and a half: the second failed window in a row resets.
+ */
+#ifndef DEADLINE_IWDG_TIMEOUT_MS
+#define DEADLINE_IWDG_TIMEOUT_MS    (DEADLINE_WINDOW_MS * 5U / 2U)
+#endif
+
+#if (DEADLINE_IWDG_TIMEOUT_MS <= DEADLINE_WINDOW_MS) || (DEADLINE_IWDG_TIMEOUT_MS > 4095U)
+#error "DEADLINE_IWDG_TIMEOUT_MS must exceed DEADLINE_WINDOW_MS and fit the IWDG"
+#endif
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Statistics of one step since deadline_add(), times in us.
+ */
+typedef struct {
+    uint32_t u32_runs;          /**< Completed runs                        */
+    uint32_t u32_misses;        /**< Runs ended after the deadline         */
+    uint32_t u32_overruns;      /**< Runs longer than the budget           */
+    uint32_t u32_response_us;   /**< Worst release to end                  */
+    uint32_t u32_exec_us;       /**< Worst start to end                    */
+} deadline_stats_t;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Removes all steps and opens the first window.
+ *
+ * @return None
+ */
+void deadline_init(void);
+
+/**
+ * @brief Adds a supervised step.
+ *
+ * @param u32_period_us   Release period, 0 = event step (no run expected)
+ * @param u32_deadline_us Release to end, at most
+ * @param u32_budget_us   Start to end, at most
+ * @param pu8_id          Receives the id
+ * @return HAL_OK, HAL_ERROR if the table is full or a time is 0
+ */
+HAL_StatusTypeDef deadline_add(uint32_t u32_period_us, uint32_t u32_deadline_us,
+                               uint32_t u32_budget_us, uint8_t *pu8_id);
+
+/**
+ * @brief Marks the start of a run (context of the step).
+ *
+ * @param u8_id       Step id, DEADLINE_NONE is ignored
+ * @param u32_late_us Start - release as seen by the caller (e.g. the
+ *                    counter of the timer that released the step)
+ * @return None
+ */
+void deadline_begin(uint8_t u8_id, uint32_t u32_late_us);
+
+/**
+ * @brief Marks the end of the run begun last (context of the step).
+ *
+ * @param u8_id Step id, DEADLINE_NONE is ignored
+ * @return None
+ */
+void deadline_end(uint8_t u8_id);
+
+/**
+ * @brief Starts the IWDG with DEADLINE_IWDG_TIMEOUT_MS (DEADLINE_ENABLE 1
+ *        only, otherwise nothing happens). Irreversible until reset.
+ *
+ * @return HAL_OK, HAL_ERROR if the IWDG did not start
+ */
+HAL_StatusTypeDef deadline_watchdog_start(void);
+
+/**
+ * @brief Closes the window once DEADLINE_WINDOW_MS have passed and
+ *        refreshes the watchdog if it was good. Main loop only, call at
+ *        least once per window.
+ *
+ * @return HAL_OK, HAL_ERROR if the window just closed failed
+ */
+HAL_StatusTypeDef deadline_poll(void);
+
+/**
+ * @brief Copies the statistics of a step.
+ *
+ * @param u8_id Step id
+ * @param stats Destination
+ * @return HAL_OK, HAL_ERROR if the id is invalid
+ */
+HAL_StatusTypeDef deadline_get_stats(uint8_t u8_id, deadline_stats_t *stats);
+
+/**
+ * @brief Returns the number of steps.
+ *
+ * @return Steps added since deadline_init()
+ */
+uint8_t deadline_get_count(void);
+
+/**
+ * @brief Returns the number of failed windows.
+ *
+ * @return Windows since deadline_init() that did not refresh the watchdog
+ */
+uint32_t deadline_get_failed_windows(void);
+
+#endif /* DEADLINE_DEADLINE_H_ */
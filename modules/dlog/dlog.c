@@ -0,0 +1,136 @@
+/**
+ ******************************************************************************
+ * @file        dlog.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Deferred format binary log: a word ring of ID, time and
+ *              arguments.
+ *
+ * Functionality:
+ * - The writer reserves and fills a whole record with interrupts masked
+ *   and publishes it with the write index, so the reader never sees a
+ *   partial one
+ * - The reader copies whole records into a chunk buffer (the ring may
+ *   wrap within a record) and frees them once the sink has taken it
+ *
+ * Resources:
+ * - DLOG_BUFFER_WORDS words of CCM RAM, nothing of the DMA reads it
+ ******************************************************************************
+ */
+
+#include "dlog.h"
+#include "timebase/timebase.h"
+#include "utils/utils.h"
+
+/* Preprocessor Defines ----------------------------------------------------- */
+/**
+ * @brief Words of the chunk buffer: one TLV record of 255 bytes.
+ */
+#define DLOG_CHUNK_WORDS        63U
+
+/**
+ * @brief Fields of record word 0.
+ */
+#define DLOG_ID_MASK            0x00FFFFFFUL
+#define DLOG_COUNT_SHIFT        24U
+#define DLOG_COUNT_MASK         0x7UL
+
+/* Static module variables -------------------------------------------------- */
+/**
+ * @brief Ring and free running word indices: written (head), read (tail).
+ */
+static uint32_t g_u32_dlog_ring[DLOG_BUFFER_WORDS] UTILS_CCM_BSS;
+static volatile uint32_t g_u32_dlog_head = 0u;
+static volatile uint32_t g_u32_dlog_tail = 0u;
+static volatile uint32_t g_u32_dlog_dropped = 0u;
+
+/**
+ * @brief Records of the chunk being offered, kept until the sink takes it.
+ */
+static uint32_t g_u32_dlog_chunk[DLOG_CHUNK_WORDS];
+static uint32_t g_u32_dlog_chunk_words = 0u;
+
+/* Public functions --------------------------------------------------------- */
+void dlog_write(uint32_t u32_id, const uint32_t *pu32_args, uint32_t u32_count)
+{
+    uint32_t u32_primask;
+    uint32_t u32_head;
+    uint32_t u32_words;
+
+    if (u32_count > DLOG_MAX_ARGS) {
+        u32_count = DLOG_MAX_ARGS;
+    }
+    u32_words = 2u + u32_count;
+
+    u32_primask = __get_PRIMASK();
+    __disable_irq();
+
+    u32_head = g_u32_dlog_head;
+    if (DLOG_BUFFER_WORDS - (u32_head - g_u32_dlog_tail) < u32_words) {
+        g_u32_dlog_dropped++;
+        __set_PRIMASK(u32_primask);
+        return;
+    }
+
+    g_u32_dlog_ring[u32_head++ & (DLOG_BUFFER_WORDS - 1u)] =
+        (u32_id & DLOG_ID_MASK) | (u32_count << DLOG_COUNT_SHIFT);
+    g_u32_dlog_ring[u32_head++ & (DLOG_BUFFER_WORDS - 1u)] = timebase_now32();
+    for (uint32_t i = 0u; i < u32_count; i++) {
+        g_u32_dlog_ring[u32_head++ & (DLOG_BUFFER_WORDS - 1u)] = pu32_args[i];
+    }
+    g_u32_dlog_head = u32_head;
+
+    __set_PRIMASK(u32_primask);
+}
+
+uint32_t dlog_drain(dlog_sink_t sink, uint16_t u16_max_size)
+{
+    uint32_t u32_max_words = u16_max_size / 4u;
+    uint32_t u32_sent = 0u;
+
+    if (u32_max_words > DLOG_CHUNK_WORDS) {
+        u32_max_words = DLOG_CHUNK_WORDS;
+    }
+    if (u32_max_words < DLOG_RECORD_MAX_WORDS) {
+        return 0u;
+    }
+
+    for (;;) {
+        /* A refused chunk is offered again as it is */
+        if (g_u32_dlog_chunk_words == 0u) {
+            uint32_t u32_tail = g_u32_dlog_tail;
+            uint32_t u32_head = g_u32_dlog_head;
+
+            while (u32_tail != u32_head) {
+                uint32_t u32_words = 2u + ((g_u32_dlog_ring[u32_tail & (DLOG_BUFFER_WORDS - 1u)] >> DLOG_COUNT_SHIFT) &
+                                           DLOG_COUNT_MASK);
+
+                if (g_u32_dlog_chunk_words + u32_words > u32_max_words) {
+                    break;
+                }
+                for (uint32_t i = 0u; i < u32_words; i++) {
+                    g_u32_dlog_chunk[g_u32_dlog_chunk_words++] = g_u32_dlog_ring[u32_tail++ & (DLOG_BUFFER_WORDS - 1u)];
+                }
+            }
+            /* The writers may use the space from now on */
+            g_u32_dlog_tail = u32_tail;
+        }
+        if (g_u32_dlog_chunk_words == 0u) {
+            break;
+        }
+
+        if (sink(g_u32_dlog_chunk, (uint16_t)(g_u32_dlog_chunk_words * 4u)) != HAL_OK) {
+            break;
+        }
+        u32_sent += g_u32_dlog_chunk_words * 4u;
+        g_u32_dlog_chunk_words = 0u;
+    }
+
+    return u32_sent;
+}
+
+uint32_t dlog_get_dropped(void)
+{
+    return g_u32_dlog_dropped;
+}
@@ -0,0 +1,136 @@
+/**
+ ******************************************************************************
+ * @file        dlog.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the deferred format binary log.
+ *
+ * @details
+ * DLOG("fan stall at %u rpm, duty %d", u16_rpm, i32_duty) stores no text
+ * on the target: the format string goes into the section .dlog, which
+ * the linker scripts keep in the ELF file only (INFO, no flash, no RAM),
+ * and its offset in that section is the ID of the message. A call writes
+ * the ID, the time and the arguments as 32 bit words into a RAM ring,
+ * some 20 to 40 cycles instead of the thousands of a sprintf(), so the
+ * macros may be used in HAL_GPIO_EXTI_Callback() and any other ISR.
+ * The main loop passes the ring in chunks to a transport (dlog_drain()),
+ * modules/dlog/dlog_decode.py reads the strings from the ELF file and
+ * formats the messages on the PC.
+ *
+ * Record, little endian words:
+ *   word 0: bits 23..0 format ID, bits 26..24 number of arguments
+ *   word 1: timebase_now32(), us of the system timebase
+ *   then DLOG_MAX_ARGS arguments at most, each converted to 32 bits
+ *
+ * Arguments are integers (%d %i %u %x %X %o %c, length modifiers are
+ * ignored) or %s of another string literal with DLOG_STR("text"). Floats
+ * are logged scaled, e.g. DLOG("T %d.%02d C", t / 100, t % 100).
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - Interrupt safe writer, a whole record or nothing: if the ring is
+ *    full the message is dropped and counted
+ *  - dlog_drain() from one context only (main loop), chunks end on
+ *    record boundaries
+ *  - Compiled out unless DLOG_ENABLE is 1 (arguments not evaluated)
+ *
+ ******************************************************************************
+ */
+
+#ifndef DLOG_DLOG_H_
+#define DLOG_DLOG_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief 1 to compile the log calls in, 0 removes them.
+ */
+#ifndef DLOG_ENABLE
+#define DLOG_ENABLE             0
+#endif
+
+/**
+ * @brief Ring size in 32 bit words, power of two.
+ */
+#ifndef DLOG_BUFFER_WORDS
+#define DLOG_BUFFER_WORDS       256U
+#endif
+
+/**
+ * @brief Arguments per message at most, words of the longest record.
+ */
+#define DLOG_MAX_ARGS           4U
+#define DLOG_RECORD_MAX_WORDS   (2U + DLOG_MAX_ARGS)
+
+#if (DLOG_BUFFER_WORDS & (DLOG_BUFFER_WORDS - 1U)) != 0
+#error "DLOG_BUFFER_WORDS must be a power of two"
+#endif
+
+#if DLOG_ENABLE
+/**
+ * @brief Logs a message, e.g. DLOG("retry %u of %u", n, max).
+ */
+#define DLOG(fmt, ...)                                                                     \
+    do {                                                                                   \
+        static const char dlog_fmt_[] __attribute__((section(".dlog"))) = fmt;             \
+        const uint32_t dlog_args_[] = { 0u, ##__VA_ARGS__ };                               \
+        (void)sizeof(char[(sizeof(dlog_args_) / 4u <= DLOG_MAX_ARGS + 1u) ? 1 : -1]);     \
+        dlog_write((uint32_t)(uintptr_t)dlog_fmt_, &dlog_args_[1],                         \
+                   (uint32_t)(sizeof(dlog_args_) / 4u - 1u));                              \
+    } while (0)
+
+/**
+ * @brief A string literal as %s argument: its ID, the text stays in the ELF.
+ */
+#define DLOG_STR(text)                                                                     \
+    __extension__({                                                                        \
+        static const char dlog_str_[] __attribute__((section(".dlog"))) = text;            \
+        (uint32_t)(uintptr_t)dlog_str_;                                                    \
+    })
+#else
+#define DLOG(fmt, ...)          do { } while (0)
+#define DLOG_STR(text)          0u
+#endif
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Transport of dlog_drain(), e.g. telemetry_batch_send_dlog().
+ *
+ * @param data       Whole records
+ * @param u16_length Bytes
+ * @return HAL_OK if taken, otherwise the chunk is offered again
+ */
+typedef HAL_StatusTypeDef (*dlog_sink_t)(const void *data, uint16_t u16_length);
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Appends a record, called by DLOG() (any context, never waits).
+ *
+ * @param u32_id      Offset of the format string in .dlog
+ * @param pu32_args   Arguments
+ * @param u32_count   Number of arguments, at most DLOG_MAX_ARGS
+ * @return None
+ */
+void dlog_write(uint32_t u32_id, const uint32_t *pu32_args, uint32_t u32_count);
+
+/**
+ * @brief Passes the ring to a transport in chunks of whole records until
+ *        it is empty or the sink refuses a chunk (main loop).
+ *
+ * @param sink         Transport
+ * @param u16_max_size Bytes per chunk, at least DLOG_RECORD_MAX_WORDS * 4
+ * @return Bytes taken by the sink
+ */
+uint32_t dlog_drain(dlog_sink_t sink, uint16_t u16_max_size);
+
+/**
+ * @brief Returns the number of messages dropped (ring full).
+ *
+ * @return Dropped messages since the start
+ */
+uint32_t dlog_get_dropped(void);
+
+#endif /* DLOG_DLOG_H_ */
@@ -0,0 +1,123 @@
+#!/usr/bin/env python3
+"""Formats the binary messages of modules/dlog on the PC.
+
+The format strings are read from the .dlog section of the firmware ELF
+file (the build of the capture, the IDs are offsets in it). Records come
+from a raw capture of the record words or, through
+uart_telemetry_decode.py --batch --elf firmware.elf, from the dlog
+records of the telemetry frames. One line per message: time of the
+system timebase in us (modules/timebase, 32 bits, wraps after 71 min),
+text.
+
+Only the standard library is needed.
+
+Usage:
+    dlog_decode.py firmware.elf capture.bin
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+ID_MASK = 0xFFFFFF
+COUNT_SHIFT = 24
+COUNT_MASK = 0x7
+
+# printf conversion: flags, width, precision, length modifiers, type
+CONVERSION = re.compile(r"%([-+ #0]*\d*(?:\.\d+)?)(?:hh|h|ll|l|z|j|t)?([diuxXoscp%])")
+
+
+def read_strings(path):
+    """Returns (address, bytes) of the .dlog section of an ELF file."""
+    with open(path, "rb") as stream:
+        elf = stream.read()
+    if elf[:4] != b"\x7fELF" or elf[5] != 1:
+        sys.exit("%s: no little endian ELF file" % path)
+    if elf[4] == 1:
+        shoff, = struct.unpack_from("<I", elf, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from("<HHH", elf, 0x2E)
+        section = struct.Struct("<IIIIIIIIII")
+    else:
+        shoff, = struct.unpack_from("<Q", elf, 0x28)
+        shentsize, shnum, shstrndx = struct.unpack_from("<HHH", elf, 0x3A)
+        section = struct.Struct("<IIQQQQIIQQ")
+    headers = [section.unpack_from(elf, shoff + i * shentsize) for i in range(shnum)]
+    names = headers[shstrndx]
+    for name, _, _, addr, offset, size, *_ in headers:
+        start = names[4] + name
+        if elf[start:elf.index(b"\0", start)] == b".dlog":
+            return addr, elf[offset:offset + size]
+    sys.exit("%s: no .dlog section (DLOG_ENABLE 0 or an old linker script?)" % path)
+
+
+class Strings:
+    """Format strings by ID."""
+
+    def __init__(self, path):
+        self.address, self.data = read_strings(path)
+
+    def get(self, ident):
+        pos = (ident - self.address) & ID_MASK
+        if pos >= len(self.data):
+            return None
+        end = self.data.find(b"\0", pos)
+        return self.data[pos:end if end >= 0 else len(self.data)].decode("utf-8", "replace")
+
+    def format(self, ident, args):
+        fmt = self.get(ident)
+        if fmt is None:
+            return "<unknown id 0x%06x> %s" % (ident, " ".join("0x%08x" % a for a in args))
+        args = list(args)
+
+        def convert(match):
+            spec, kind = match.groups()
+            if kind == "%":
+                return "%"
+            if not args:
+                return "<missing>"
+            value = args.pop(0)
+            if kind in "di":
+                value = value - (1 << 32) if value & 0x80000000 else value
+                kind = "d"
+            elif kind == "u":
+                kind = "d"
+            elif kind == "c":
+                value = chr(value & 0xFF)
+            elif kind == "s":
+                value = self.get(value) or "<unknown string 0x%06x>" % value
+            elif kind == "p":
+                spec, kind = "#010", "x"
+            return ("%" + spec + kind) % value
+
+        return CONVERSION.sub(convert, fmt)
+
+
+def records(data):
+    """Yields (time_us, id, args) of a stream of whole records."""
+    pos = 0
+    while pos + 8 <= len(data):
+        head, time_us = struct.unpack_from("<II", data, pos)
+        count = (head >> COUNT_SHIFT) & COUNT_MASK
+        if pos + 8 + 4 * count > len(data):
+            return
+        args = struct.unpack_from("<%dI" % count, data, pos + 8)
+        yield time_us, head & ID_MASK, args
+        pos += 8 + 4 * count
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("elf", help="firmware ELF file of the capture")
+    parser.add_argument("source", help="raw record capture")
+    args = parser.parse_args()
+
+    strings = Strings(args.elf)
+    with open(args.source, "rb") as stream:
+        data = stream.read()
+    for time_us, ident, values in records(data):
+        print("%10d  %s" % (time_us, strings.format(ident, values)))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,282 @@
+/**
+ ******************************************************************************
+ * @file        dma_alloc.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       DMA stream allocator (request mapping, priorities,
+ *              interrupt dispatch)
+ *
+ * Functionality:
+ * - Candidate streams and channels per request, first free one wins
+ * - Latency class to DMA_PRIORITY_*
+ * - One table entry per stream: handle, request, health counter
+ *
+ * Resources:
+ * - DMA1_Stream0..7_IRQHandler, DMA2_Stream0..7_IRQHandler
+ ******************************************************************************
+ */
+
+#include "dma_alloc.h"
+#include <stddef.h>
+
+/* Preprocessor defines ---------------------------------------------------- */
+/**
+ * @brief Candidates per request.
+ */
+#define DMA_ALLOC_CANDIDATES    2U
+
+/**
+ * @brief Marks an unused candidate.
+ */
+#define DMA_ALLOC_NO_STREAM     0xFFU
+
+/* Module intern type definitions ------------------------------------------ */
+/**
+ * @brief One candidate: stream index (0..15) and channel.
+ */
+typedef struct {
+    uint8_t  u8_stream;
+    uint32_t u32_channel;
+} dma_alloc_candidate_t;
+
+/**
+ * @brief One stream.
+ */
+typedef struct {
+    DMA_HandleTypeDef  *hdma;
+    dma_alloc_request_t request;
+    health_isr_t        isr;
+} dma_alloc_slot_t;
+
+/* Static module variables -------------------------------------------------- */
+/**
+ * @brief Request mapping, the stream used before the allocator first.
+ */
+static const dma_alloc_candidate_t g_dma_alloc_map[DMA_ALLOC_REQ_COUNT][DMA_ALLOC_CANDIDATES] = {
+    [DMA_ALLOC_REQ_ADC1]      = { {  8U, DMA_CHANNEL_0 }, { 12U, DMA_CHANNEL_0 } },
+    [DMA_ALLOC_REQ_SPI5_TX]   = { { 12U, DMA_CHANNEL_2 }, { 14U, DMA_CHANNEL_7 } },
+    [DMA_ALLOC_REQ_I2C1_RX]   = { {  0U, DMA_CHANNEL_1 }, {  5U, DMA_CHANNEL_1 } },
+    [DMA_ALLOC_REQ_I2C3_RX]   = { {  2U, DMA_CHANNEL_3 }, { DMA_ALLOC_NO_STREAM, 0U } },
+    [DMA_ALLOC_REQ_USART1_TX] = { { 15U, DMA_CHANNEL_4 }, { DMA_ALLOC_NO_STREAM, 0U } },
+    [DMA_ALLOC_REQ_USART1_RX] = { { 10U, DMA_CHANNEL_4 }, { 13U, DMA_CHANNEL_4 } },
+    [DMA_ALLOC_REQ_SDIO]      = { { 14U, DMA_CHANNEL_4 }, { 11U, DMA_CHANNEL_4 } },
+    [DMA_ALLOC_REQ_TIM1_UP]   = { { 13U, DMA_CHANNEL_6 }, { DMA_ALLOC_NO_STREAM, 0U } },
+    [DMA_ALLOC_REQ_TIM2_CH1]  = { {  5U, DMA_CHANNEL_3 }, { DMA_ALLOC_NO_STREAM, 0U } },
+    [DMA_ALLOC_REQ_TIM5_CH1]  = { {  2U, DMA_CHANNEL_6 }, { DMA_ALLOC_NO_STREAM, 0U } },
+    [DMA_ALLOC_REQ_TIM8_UP]   = { {  9U, DMA_CHANNEL_7 }, { DMA_ALLOC_NO_STREAM, 0U } },
+    [DMA_ALLOC_REQ_TIM8_CH1]  = { { 10U, DMA_CHANNEL_7 }, { DMA_ALLOC_NO_STREAM, 0U } },
+    [DMA_ALLOC_REQ_TIM8_CH2]  = { { 11U, DMA_CHANNEL_7 }, { DMA_ALLOC_NO_STREAM, 0U } },
+    [DMA_ALLOC_REQ_TIM8_CH4]  = { { 15U, DMA_CHANNEL_7 }, { DMA_ALLOC_NO_STREAM, 0U } },
+    [DMA_ALLOC_REQ_SPI5_RX]   = { { 11U, DMA_CHANNEL_2 }, { 13U, DMA_CHANNEL_7 } },
+    [DMA_ALLOC_REQ_TIM2_CH2]  = { {  6U, DMA_CHANNEL_3 }, { DMA_ALLOC_NO_STREAM, 0U } },
+    [DMA_ALLOC_REQ_TIM2_CH3]  = { {  1U, DMA_CHANNEL_3 }, { DMA_ALLOC_NO_STREAM, 0U } },
+    [DMA_ALLOC_REQ_TIM2_CH4]  = { {  7U, DMA_CHANNEL_3 }, {  6U, DMA_CHANNEL_3 } },
+    [DMA_ALLOC_REQ_TIM5_CH2]  = { {  4U, DMA_CHANNEL_6 }, { DMA_ALLOC_NO_STREAM, 0U } },
+    [DMA_ALLOC_REQ_TIM5_CH3]  = { {  0U, DMA_CHANNEL_6 }, { DMA_ALLOC_NO_STREAM, 0U } },
+    [DMA_ALLOC_REQ_TIM5_CH4]  = { {  1U, DMA_CHANNEL_6 }, {  3U, DMA_CHANNEL_6 } },
+    [DMA_ALLOC_REQ_DAC1]      = { {  5U, DMA_CHANNEL_7 }, { DMA_ALLOC_NO_STREAM, 0U } },
+    [DMA_ALLOC_REQ_DAC2]      = { {  6U, DMA_CHANNEL_7 }, { DMA_ALLOC_NO_STREAM, 0U } },
+    [DMA_ALLOC_REQ_TIM5_UP]   = { {  0U, DMA_CHANNEL_6 }, {  6U, DMA_CHANNEL_6 } },
+    [DMA_ALLOC_REQ_TIM7_UP]   = { {  4U, DMA_CHANNEL_1 }, {  2U, DMA_CHANNEL_1 } },
+    [DMA_ALLOC_REQ_ADC2]      = { { 10U, DMA_CHANNEL_1 }, { 11U, DMA_CHANNEL_1 } },
+    [DMA_ALLOC_REQ_ADC3]      = { {  8U, DMA_CHANNEL_2 }, {  9U, DMA_CHANNEL_2 } },
+};
+
+/**
+ * @brief Registers and interrupts of the streams.
+ */
+static DMA_Stream_TypeDef *const g_dma_alloc_instances[DMA_ALLOC_STREAMS] = {
+    DMA1_Stream0, DMA1_Stream1, DMA1_Stream2, DMA1_Stream3,
+    DMA1_Stream4, DMA1_Stream5, DMA1_Stream6, DMA1_Stream7,
+    DMA2_Stream0, DMA2_Stream1, DMA2_Stream2, DMA2_Stream3,
+    DMA2_Stream4, DMA2_Stream5, DMA2_Stream6, DMA2_Stream7
+};
+
+static const IRQn_Type g_dma_alloc_irqn[DMA_ALLOC_STREAMS] = {
+    DMA1_Stream0_IRQn, DMA1_Stream1_IRQn, DMA1_Stream2_IRQn, DMA1_Stream3_IRQn,
+    DMA1_Stream4_IRQn, DMA1_Stream5_IRQn, DMA1_Stream6_IRQn, DMA1_Stream7_IRQn,
+    DMA2_Stream0_IRQn, DMA2_Stream1_IRQn, DMA2_Stream2_IRQn, DMA2_Stream3_IRQn,
+    DMA2_Stream4_IRQn, DMA2_Stream5_IRQn, DMA2_Stream6_IRQn, DMA2_Stream7_IRQn
+};
+
+/**
+ * @brief DMA_PRIORITY_* per latency class.
+ */
+static const uint32_t g_dma_alloc_priority[] = {
+    [DMA_ALLOC_LATENCY_BULK]     = DMA_PRIORITY_LOW,
+    [DMA_ALLOC_LATENCY_EVENT]    = DMA_PRIORITY_MEDIUM,
+    [DMA_ALLOC_LATENCY_SAMPLED]  = DMA_PRIORITY_HIGH,
+    [DMA_ALLOC_LATENCY_CRITICAL] = DMA_PRIORITY_VERY_HIGH,
+};
+
+static dma_alloc_slot_t g_dma_alloc_slots[DMA_ALLOC_STREAMS];
+
+static dma_alloc_stats_t g_dma_alloc_stats = {
+    .last_denied = DMA_ALLOC_REQ_NONE,
+    .last_holder = DMA_ALLOC_REQ_NONE
+};
+
+/* Static function prototypes ---------------------------------------------- */
+static uint8_t dma_alloc_find(const DMA_HandleTypeDef *hdma);
+static void dma_alloc_dispatch(uint8_t u8_stream);
+
+/* Public functions --------------------------------------------------------- */
+HAL_StatusTypeDef dma_alloc_claim(DMA_HandleTypeDef *hdma, dma_alloc_request_t request,
+                                  dma_alloc_latency_t latency, health_isr_t isr)
+{
+    const dma_alloc_candidate_t *candidates;
+    const dma_alloc_candidate_t *chosen = NULL;
+    uint8_t u8_held;
+
+    if ((hdma == NULL) || (request >= DMA_ALLOC_REQ_COUNT) || (latency > DMA_ALLOC_LATENCY_CRITICAL)) {
+        return HAL_ERROR;
+    }
+    candidates = g_dma_alloc_map[request];
+
+    /* Re-init: keep the stream if it serves the request, free it otherwise */
+    u8_held = dma_alloc_find(hdma);
+    if (u8_held != DMA_ALLOC_NO_STREAM) {
+        if (g_dma_alloc_slots[u8_held].request != request) {
+            dma_alloc_release(hdma);
+        }
+    }
+
+    for (uint8_t i = 0U; (i < DMA_ALLOC_CANDIDATES) && (chosen == NULL); i++) {
+        uint8_t u8_stream = candidates[i].u8_stream;
+
+        if ((u8_stream != DMA_ALLOC_NO_STREAM) &&
+            ((g_dma_alloc_slots[u8_stream].hdma == NULL) || (g_dma_alloc_slots[u8_stream].hdma == hdma))) {
+            chosen = &candidates[i];
+        }
+    }
+
+    if (chosen == NULL) {
+        if (g_dma_alloc_stats.u8_conflicts < 0xFFU) {
+            g_dma_alloc_stats.u8_conflicts++;
+        }
+        g_dma_alloc_stats.last_denied = request;
+        g_dma_alloc_stats.last_holder = g_dma_alloc_slots[candidates[0].u8_stream].request;
+        return HAL_BUSY;
+    }
+
+    if (g_dma_alloc_slots[chosen->u8_stream].hdma == NULL) {
+        g_dma_alloc_stats.u8_used++;
+    }
+    g_dma_alloc_slots[chosen->u8_stream].hdma    = hdma;
+    g_dma_alloc_slots[chosen->u8_stream].request = request;
+    g_dma_alloc_slots[chosen->u8_stream].isr     = isr;
+
+    if (chosen->u8_stream < 8U) {
+        __HAL_RCC_DMA1_CLK_ENABLE();
+    } else {
+        __HAL_RCC_DMA2_CLK_ENABLE();
+    }
+
+    hdma->Instance      = g_dma_alloc_instances[chosen->u8_stream];
+    hdma->Init.Channel  = chosen->u32_channel;
+    hdma->Init.Priority = g_dma_alloc_priority[latency];
+
+    return HAL_OK;
+}
+
+void dma_alloc_release(DMA_HandleTypeDef *hdma)
+{
+    uint8_t u8_stream = dma_alloc_find(hdma);
+
+    if (u8_stream == DMA_ALLOC_NO_STREAM) {
+        return;
+    }
+
+    HAL_NVIC_DisableIRQ(g_dma_alloc_irqn[u8_stream]);
+    g_dma_alloc_slots[u8_stream].hdma    = NULL;
+    g_dma_alloc_slots[u8_stream].request = DMA_ALLOC_REQ_NONE;
+    g_dma_alloc_stats.u8_used--;
+}
+
+IRQn_Type dma_alloc_get_irqn(const DMA_HandleTypeDef *hdma)
+{
+    for (uint8_t i = 0U; i < DMA_ALLOC_STREAMS; i++) {
+        if (g_dma_alloc_instances[i] == hdma->Instance) {
+            return g_dma_alloc_irqn[i];
+        }
+    }
+
+    /* Never claimed: the first stream, as with a zeroed handle */
+    return DMA1_Stream0_IRQn;
+}
+
+dma_alloc_request_t dma_alloc_get_owner(uint8_t u8_stream)
+{
+    if ((u8_stream >= DMA_ALLOC_STREAMS) || (g_dma_alloc_slots[u8_stream].hdma == NULL)) {
+        return DMA_ALLOC_REQ_NONE;
+    }
+
+    return g_dma_alloc_slots[u8_stream].request;
+}
+
+const dma_alloc_stats_t *dma_alloc_get_stats(void)
+{
+    return &g_dma_alloc_stats;
+}
+
+/* Static module functions -------------------------------------------------- */
+/**
+ * @brief Finds the stream of a handle.
+ *
+ * @param hdma Handle
+ * @return Stream index, DMA_ALLOC_NO_STREAM if the handle holds none
+ */
+static uint8_t dma_alloc_find(const DMA_HandleTypeDef *hdma)
+{
+    for (uint8_t i = 0U; i < DMA_ALLOC_STREAMS; i++) {
+        if (g_dma_alloc_slots[i].hdma == hdma) {
+            return i;
+        }
+    }
+
+    return DMA_ALLOC_NO_STREAM;
+}
+
+/**
+ * @brief Stream interrupt: HAL handler of the owner, measured by health
+ *        if a counter was given.
+ *
+ * @param u8_stream Stream index
+ * @return None
+ */
+static void dma_alloc_dispatch(uint8_t u8_stream)
+{
+    DMA_HandleTypeDef *hdma = g_dma_alloc_slots[u8_stream].hdma;
+    health_isr_t isr = g_dma_alloc_slots[u8_stream].isr;
+
+    if (hdma == NULL) {
+        return;
+    }
+
+    if (isr >= HEALTH_ISR_COUNT) {
+        HAL_DMA_IRQHandler(hdma);
+        return;
+    }
+
+    HEALTH_ISR_BEGIN(isr);
+    HAL_DMA_IRQHandler(hdma);
+    HEALTH_ISR_END(isr);
+}
+
+void DMA1_Stream0_IRQHandler(void) { dma_alloc_dispatch(0U); }
+void DMA1_Stream1_IRQHandler(void) { dma_alloc_dispatch(1U); }
+void DMA1_Stream2_IRQHandler(void) { dma_alloc_dispatch(2U); }
+void DMA1_Stream3_IRQHandler(void) { dma_alloc_dispatch(3U); }
+void DMA1_Stream4_IRQHandler(void) { dma_alloc_dispatch(4U); }
+void DMA1_Stream5_IRQHandler(void) { dma_alloc_dispatch(5U); }
+void DMA1_Stream6_IRQHandler(void) { dma_alloc_dispatch(6U); }
+void DMA1_Stream7_IRQHandler(void) { dma_alloc_dispatch(7U); }
+void DMA2_Stream0_IRQHandler(void) { dma_alloc_dispatch(8U); }
+void DMA2_Stream1_IRQHandler(void) { dma_alloc_dispatch(9U); }
+void DMA2_Stream2_IRQHandler(void) { dma_alloc_dispatch(10U); }
+void DMA2_Stream3_IRQHandler(void) { dma_alloc_dispatch(11U); }
+void DMA2_Stream4_IRQHandler(void) { dma_alloc_dispatch(12U); }
+void DMA2_Stream5_IRQHandler(void) { dma_alloc_dispatch(13U); }
+void DMA2_Stream6_IRQHandler(void) { dma_alloc_dispatch(14U); }
+void DMA2_Stream7_IRQHandler(void) { dma_alloc_dispatch(15U); }
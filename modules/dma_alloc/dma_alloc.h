@@ -0,0 +1,155 @@
+/**
+ ******************************************************************************
+ * @file        dma_alloc.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the DMA stream allocator.
+ *
+ * @details
+ * The modules no longer name a DMA stream: they claim the request of
+ * their peripheral (e.g. DMA_ALLOC_REQ_ADC1) with a latency class. The
+ * allocator picks the first free stream of the request mapping
+ * (RM0090 tables 42/43), sets Instance, Channel and Priority of the
+ * handle and dispatches the stream interrupt to it. Two modules that
+ * need the same stream no longer overwrite each other's configuration
+ * silently: the second claim fails with HAL_BUSY and is counted with
+ * the request holding the stream, so conflicts show at init.
+ *
+ * The first candidate of every request is the stream the modules used
+ * before, the layout without conflicts stays as it was. DMA2D has its
+ * own bus master and no stream, it is not managed here.
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - Request mapping with up to two candidate streams per request
+ *  - Stream priority from the latency class; between streams of the same
+ *    class the lower stream number wins (hardware arbitration)
+ *  - All 16 DMAx_StreamY_IRQHandler, optionally measured by health
+ *  - Owner of every stream and the last denied claim for the debugger
+ *    or a shell command
+ *
+ ******************************************************************************
+ */
+
+#ifndef DMA_ALLOC_DMA_ALLOC_H_
+#define DMA_ALLOC_DMA_ALLOC_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+#include "health/health.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief Streams of both controllers: 0..7 DMA1, 8..15 DMA2.
+ */
+#define DMA_ALLOC_STREAMS       16U
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Peripheral requests in use by the modules.
+ */
+typedef enum {
+    DMA_ALLOC_REQ_ADC1 = 0,     /**< DMA2 S0 / S4, ch 0 (potis_dma, adc_acq, adc_sched) */
+    DMA_ALLOC_REQ_SPI5_TX,      /**< DMA2 S4 ch 2 / S6 ch 7 (lcd)             */
+    DMA_ALLOC_REQ_I2C1_RX,      /**< DMA1 S0 / S5, ch 1 (env_sensor)          */
+    DMA_ALLOC_REQ_I2C3_RX,      /**< DMA1 S2 ch 3 (env_sensor)                */
+    DMA_ALLOC_REQ_USART1_TX,    /**< DMA2 S7 ch 4 (uart_telemetry)            */
+    DMA_ALLOC_REQ_USART1_RX,    /**< DMA2 S2 / S5, ch 4 (uart_telemetry)      */
+    DMA_ALLOC_REQ_SDIO,         /**< DMA2 S6 / S3, ch 4 (sdcard)              */
+    DMA_ALLOC_REQ_TIM1_UP,      /**< DMA2 S5 ch 6 (dot)                       */
+    DMA_ALLOC_REQ_TIM2_CH1,     /**< DMA1 S5 ch 3 (freqmeter: fan)            */
+    DMA_ALLOC_REQ_TIM5_CH1,     /**< DMA1 S2 ch 6 (stopwatch, laptimer)       */
+    DMA_ALLOC_REQ_TIM8_UP,      /**< DMA2 S1 ch 7 (esd)                       */
+    DMA_ALLOC_REQ_TIM8_CH1,     /**< DMA2 S2 ch 7 (esd)                       */
+    DMA_ALLOC_REQ_TIM8_CH2,     /**< DMA2 S3 ch 7 (esd)                       */
+    DMA_ALLOC_REQ_TIM8_CH4,     /**< DMA2 S7 ch 7 (esd)                       */
+    DMA_ALLOC_REQ_SPI5_RX,      /**< DMA2 S3 ch 2 / S5 ch 7 (lcd bus clients) */
+    DMA_ALLOC_REQ_TIM2_CH2,     /**< DMA1 S6 ch 3 (freqmeter)                 */
+    DMA_ALLOC_REQ_TIM2_CH3,     /**< DMA1 S1 ch 3 (freqmeter)                 */
+    DMA_ALLOC_REQ_TIM2_CH4,     /**< DMA1 S7 / S6, ch 3 (freqmeter)           */
+    DMA_ALLOC_REQ_TIM5_CH2,     /**< DMA1 S4 ch 6 (laptimer)                  */
+    DMA_ALLOC_REQ_TIM5_CH3,     /**< DMA1 S0 ch 6 (laptimer)                  */
+    DMA_ALLOC_REQ_TIM5_CH4,     /**< DMA1 S1 / S3, ch 6 (laptimer)            */
+    DMA_ALLOC_REQ_DAC1,         /**< DMA1 S5 ch 7 (siginject)                 */
+    DMA_ALLOC_REQ_DAC2,         /**< DMA1 S6 ch 7 (siginject)                 */
+    DMA_ALLOC_REQ_TIM5_UP,      /**< DMA1 S0 / S6, ch 6 (siginject)           */
+    DMA_ALLOC_REQ_TIM7_UP,      /**< DMA1 S2 / S4, ch 1 (siginject)           */
+    DMA_ALLOC_REQ_ADC2,         /**< DMA2 S2 / S3, ch 1 (adc_sched)           */
+    DMA_ALLOC_REQ_ADC3,         /**< DMA2 S0 / S1, ch 2 (adc_sched)           */
+    DMA_ALLOC_REQ_COUNT,
+    DMA_ALLOC_REQ_NONE = DMA_ALLOC_REQ_COUNT  /**< Free stream            */
+} dma_alloc_request_t;
+
+/**
+ * @brief Latency classes, in rising stream priority.
+ */
+typedef enum {
+    DMA_ALLOC_LATENCY_BULK = 0, /**< Low: display, sensor reads, waveforms  */
+    DMA_ALLOC_LATENCY_EVENT,    /**< Medium: poti blocks, command RX        */
+    DMA_ALLOC_LATENCY_SAMPLED,  /**< High: fast sampling, edge captures     */
+    DMA_ALLOC_LATENCY_CRITICAL  /**< Very high: FIFO overrun (SDIO)         */
+} dma_alloc_latency_t;
+
+/**
+ * @brief Allocation state.
+ */
+typedef struct {
+    uint8_t             u8_used;        /**< Claimed streams                   */
+    uint8_t             u8_conflicts;   /**< Denied claims                     */
+    dma_alloc_request_t last_denied;    /**< Request of the last denied claim  */
+    dma_alloc_request_t last_holder;    /**< Holder of its first candidate     */
+} dma_alloc_stats_t;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Claims a stream for a request and prepares the handle.
+ *
+ * Sets Instance, Init.Channel and Init.Priority and enables the clock of
+ * the controller; the caller sets the rest of Init, calls HAL_DMA_Init()
+ * and enables dma_alloc_get_irqn() if it uses interrupts. A handle that
+ * already holds a stream of the request keeps it (re-init).
+ *
+ * @param hdma    Handle, stays registered until dma_alloc_release()
+ * @param request Peripheral request
+ * @param latency Latency class
+ * @param isr     Health counter of the stream interrupt, HEALTH_ISR_COUNT
+ *                for none
+ * @return HAL_OK, HAL_BUSY if every candidate stream is taken (counted
+ *         as conflict), HAL_ERROR for invalid arguments
+ */
+HAL_StatusTypeDef dma_alloc_claim(DMA_HandleTypeDef *hdma, dma_alloc_request_t request,
+                                  dma_alloc_latency_t latency, health_isr_t isr);
+
+/**
+ * @brief Frees the stream of a handle (after HAL_DMA_DeInit()).
+ *
+ * @param hdma Handle
+ * @return None
+ */
+void dma_alloc_release(DMA_HandleTypeDef *hdma);
+
+/**
+ * @brief Returns the interrupt of the stream of a claimed handle.
+ *
+ * @param hdma Handle
+ * @return Stream interrupt
+ */
+IRQn_Type dma_alloc_get_irqn(const DMA_HandleTypeDef *hdma);
+
+/**
+ * @brief Returns the request holding a stream.
+ *
+ * @param u8_stream 0..7 DMA1, 8..15 DMA2
+ * @return Request, DMA_ALLOC_REQ_NONE for a free stream
+ */
+dma_alloc_request_t dma_alloc_get_owner(uint8_t u8_stream);
+
+/**
+ * @brief Returns the allocation state.
+ *
+ * @return State
+ */
+const dma_alloc_stats_t *dma_alloc_get_stats(void);
+
+#endif /* DMA_ALLOC_DMA_ALLOC_H_ */
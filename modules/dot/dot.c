@@ -14,7 +14,12 @@
   	  - GPIOE: DOT_GPIO_PIN (AF1 -> TIM1 CH2)
 
 	TIMER:
-  	  - TIM1 CH2 for PWM-based blinking/dimming
+  	  - TIM1 CH2 for PWM-based blinking/dimming (pwm service)
+  	  - TIM4 (interrupt only) as blink gate of the unified driver
+
+	DMA:
+  	  - TIM1_UP request of dma_alloc (DMA2 stream 5, channel 6): fade
+  	    waveform -> TIM1 CCR2
 ==================================================
 					### Usage ###
 	(#) Call 'dot_esd_init()' once to configure GPIOs for the dot-LED.
@@ -28,6 +33,13 @@
       	  (valid only in blinking mode, but prescaler still changes).
     	- Use 'dot_change_brightness(brightness)' to control LED intensity
       	  via PWM duty cycle.
+
+	(#) Unified driver, blinking and dimming at the same time:
+    	- 'dot_init()' instead of 'dot_timer_init(mode)'
+    	- 'dot_set_brightness(brightness)' for the PWM carrier
+    	- 'dot_set_blink(period_ms, on_ms)' for the blink gate
+    	- 'dot_fade_breathe(period_ms)' or 'dot_fade_start(...)' to play
+    	  gamma corrected fades via DMA, 'dot_fade_stop()' to end them
 ==================================================
 @endverbatim
 **************************************************
@@ -35,6 +47,11 @@
 
 /* Includes */
 #include "dot.h"
+#include "clock/clock.h"
+#include "dvfs/dvfs.h"
+#include "health/health.h"
+#include "pwm/pwm.h"
+#include "tim_alloc/tim_alloc.h"
 
 /* Static / global variables */
 
@@ -43,6 +60,47 @@
  */
 TIM_HandleTypeDef tim_handle_struct;
 
+/**
+ * @brief PWM service of TIM1 (handle: tim_handle_struct).
+ */
+static pwm_timer_t g_dot_pwm;
+
+/**
+ * @brief Gamma 2.2 table: brightness 0..255 -> compare value 0..DOT_PWM_STEPS.
+ *        Every level > 0 gives at least one step.
+ */
+static const uint16_t g_u16_dot_gamma[DOT_MAX_BRIGHTNESS + 1] = {
+       0,    1,    1,    1,    1,    1,    1,    1,    1,    1,    1,    1,    1,    1,    2,    2,
+       2,    3,    3,    3,    4,    4,    5,    5,    6,    6,    7,    7,    8,    9,    9,   10,
+      11,   11,   12,   13,   14,   15,   16,   16,   17,   18,   19,   20,   21,   23,   24,   25,
+      26,   27,   28,   30,   31,   32,   34,   35,   36,   38,   39,   41,   42,   44,   46,   47,
+      49,   51,   52,   54,   56,   58,   60,   61,   63,   65,   67,   69,   71,   73,   76,   78,
+      80,   82,   84,   87,   89,   91,   94,   96,   99,  101,  104,  106,  109,  111,  114,  117,
+     119,  122,  125,  128,  131,  133,  136,  139,  142,  145,  148,  152,  155,  158,  161,  164,
+     168,  171,  174,  178,  181,  184,  188,  191,  195,  199,  202,  206,  210,  213,  217,  221,
+     225,  229,  233,  237,  241,  245,  249,  253,  257,  261,  265,  269,  274,  278,  282,  287,
+     291,  296,  300,  305,  309,  314,  319,  323,  328,  333,  338,  342,  347,  352,  357,  362,
+     367,  372,  377,  383,  388,  393,  398,  404,  409,  414,  420,  425,  431,  436,  442,  447,
+     453,  459,  464,  470,  476,  482,  488,  494,  499,  505,  511,  518,  524,  530,  536,  542,
+     548,  555,  561,  568,  574,  580,  587,  593,  600,  607,  613,  620,  627,  634,  640,  647,
+     654,  661,  668,  675,  682,  689,  696,  704,  711,  718,  725,  733,  740,  747,  755,  762,
+     770,  778,  785,  793,  801,  808,  816,  824,  832,  840,  848,  856,  864,  872,  880,  888,
+     896,  904,  913,  921,  929,  938,  946,  955,  963,  972,  980,  989,  998, 1006, 1015, 1024
+};
+
+/**
+ * @brief Breathing waveform, played by the fade DMA.
+ */
+static uint16_t g_u16_dot_breathe[DOT_FADE_BREATHE_STEPS];
+
+/**
+ * @brief Fade DMA handle (TIM1_UP -> CCR2).
+ */
+static DMA_HandleTypeDef g_dot_fade_dma;
+
+/* Static function prototypes */
+static void dot_gate(uint8_t u8_on);
+
 /* Public functions */
 
 /**
@@ -85,41 +143,32 @@ void dot_timer_init(uint8_t mode)
         mode = DOT_MODES_MAX;
     }
 
-    __HAL_RCC_TIM1_CLK_ENABLE();
-
-    TIM_OC_InitTypeDef tim_oc_handle_struct;
-
-    tim_handle_struct.Instance = TIM1;
+    uint32_t u32_prescaler;
+    uint32_t u32_period;
+    pwm_channel_config_t pwm_channel_struct;
 
     /* Base configuration depends on mode */
     if (mode == DOT_BLINKING_MODE) {
         /* Slow blinking: lower base frequency, higher period */
-        tim_handle_struct.Init.Prescaler = (SystemCoreClock / 10000U) - 1U;
-        tim_handle_struct.Init.Period    = 10000U - 1U;
+        u32_prescaler = (clock_get_apb2_timer_clock() / 10000U) - 1U;
+        u32_period    = 10000U - 1U;
     } else {
         /* Dimming: higher base frequency, 8-bit resolution period */
-        tim_handle_struct.Init.Prescaler = (SystemCoreClock / 100000U) - 1U;
-        tim_handle_struct.Init.Period    = 255U - 1U;
+        u32_prescaler = (clock_get_apb2_timer_clock() / 100000U) - 1U;
+        u32_period    = 255U - 1U;
     }
 
-    tim_handle_struct.Init.CounterMode         = TIM_COUNTERMODE_UP;
-    tim_handle_struct.Init.ClockDivision       = TIM_CLOCKDIVISION_DIV1;
-    tim_handle_struct.Init.AutoReloadPreload   = TIM_AUTORELOAD_PRELOAD_DISABLE;
-    tim_handle_struct.Init.RepetitionCounter   = 0;
-
-    /* Configure PWM output on TIM1 CH2 */
-    tim_oc_handle_struct.OCMode       = TIM_OCMODE_PWM1;
-    tim_oc_handle_struct.Pulse        = 5000;                 /* Initial duty / compare value */
-    tim_oc_handle_struct.OCIdleState  = TIM_OCIDLESTATE_SET;
-    tim_oc_handle_struct.OCPolarity   = TIM_OCPOLARITY_LOW;
-    tim_oc_handle_struct.OCNIdleState = TIM_OCNIDLESTATE_RESET;
-    tim_oc_handle_struct.OCNPolarity  = TIM_OCNPOLARITY_LOW;
-    tim_oc_handle_struct.OCFastMode   = TIM_OCFAST_DISABLE;
-
-    HAL_TIM_Base_Init(&tim_handle_struct);
-    HAL_TIM_OC_ConfigChannel(&tim_handle_struct, &tim_oc_handle_struct, TIM_CHANNEL_2);
+    if (pwm_timer_init(&g_dot_pwm, &tim_handle_struct, TIM1, TIM_ALLOC_OWNER_DOT,
+                       u32_prescaler, u32_period) != HAL_OK) {
+        return;
+    }
 
-    HAL_TIM_OC_Start(&tim_handle_struct, TIM_CHANNEL_2);
+    /* PWM output on TIM1 CH2, active low */
+    pwm_channel_struct.u32_polarity = TIM_OCPOLARITY_LOW;
+    pwm_channel_struct.u32_idle     = TIM_OCIDLESTATE_SET;
+    pwm_channel_struct.align        = PWM_ALIGN_LEADING;
+    pwm_channel_struct.u32_duty     = 5000U;              /* Initial duty / compare value */
+    (void)pwm_channel_init(&g_dot_pwm, TIM_CHANNEL_2, &pwm_channel_struct);
 }
 
 /**
@@ -136,7 +185,8 @@ void dot_change_blink_speed(uint32_t frequency)
         frequency = DOT_MIN_BLINKSPEED;
     }
 
-    __HAL_TIM_SET_PRESCALER(&tim_handle_struct, (SystemCoreClock / frequency) - 1U);
+    __HAL_TIM_SET_PRESCALER(&tim_handle_struct,
+                            DVFS_EVEN_DIVIDER(clock_get_apb2_timer_clock() / frequency) - 1U);
 }
 
 /**
@@ -151,3 +201,241 @@ void dot_change_brightness(uint32_t brightness)
     }
     __HAL_TIM_SET_COMPARE(&tim_handle_struct, TIM_CHANNEL_2, brightness);
 }
+
+/**
+ * @brief  Initializes the unified dot driver (TIM1 CH2 carrier, blink gate).
+ * @param  None
+ * @return None
+ */
+void dot_init(void)
+{
+    pwm_channel_config_t pwm_channel_struct;
+
+    /* Carrier: DOT_PWM_STEPS steps per period, compare = period = 100 % */
+    if (pwm_timer_init(&g_dot_pwm, &tim_handle_struct, TIM1, TIM_ALLOC_OWNER_DOT,
+                       DVFS_EVEN_DIVIDER(clock_get_apb2_timer_clock() /
+                                         (DOT_PWM_FREQUENCY_HZ * DOT_PWM_STEPS)) - 1U,
+                       DOT_PWM_STEPS - 1U) != HAL_OK) {
+        return;
+    }
+
+    pwm_channel_struct.u32_polarity = TIM_OCPOLARITY_LOW;
+    pwm_channel_struct.u32_idle     = TIM_OCIDLESTATE_SET;
+    pwm_channel_struct.align        = PWM_ALIGN_LEADING;
+    pwm_channel_struct.u32_duty     = DOT_PWM_STEPS;
+    (void)pwm_channel_init(&g_dot_pwm, TIM_CHANNEL_2, &pwm_channel_struct);
+
+    /* No blinking until dot_set_blink() */
+    dot_set_blink(0U, 0U);
+}
+
+/**
+ * @brief  Sets the carrier brightness (preloaded CCR2).
+ * @param  u8_brightness 0 .. DOT_MAX_BRIGHTNESS.
+ * @return None
+ */
+void dot_set_brightness(uint8_t u8_brightness)
+{
+    dot_fade_stop();
+
+    __HAL_TIM_SET_COMPARE(&tim_handle_struct, TIM_CHANNEL_2,
+                          ((uint32_t)u8_brightness * DOT_PWM_STEPS) / DOT_MAX_BRIGHTNESS);
+}
+
+/**
+ * @brief  Sets the blink pattern of the gate timer.
+ *         Update event = dot on, CC1 match = dot off. ARR and CCR1 are
+ *         preloaded, a running gate takes the new pattern at its next
+ *         update event.
+ * @param  u16_period_ms Blink period, 0 = no blinking.
+ * @param  u16_on_ms     On-time per period.
+ * @return None
+ */
+void dot_set_blink(uint16_t u16_period_ms, uint16_t u16_on_ms)
+{
+    uint32_t u32_ticks_per_ms = DOT_BLINK_COUNTER_HZ / 1000U;
+
+    if ((u16_period_ms == 0U) || (u16_on_ms >= u16_period_ms)) {
+        /* Steady: stop the gate, carrier always passed */
+        DOT_BLINK_TIM->CR1  = 0;
+        DOT_BLINK_TIM->DIER = 0;
+        HAL_NVIC_DisableIRQ(DOT_BLINK_IRQn);
+        dot_gate(1U);
+        return;
+    }
+
+    if (u16_period_ms > DOT_MAX_BLINK_PERIOD_MS) {
+        u16_period_ms = DOT_MAX_BLINK_PERIOD_MS;
+    }
+
+    if (DOT_BLINK_TIM->CR1 & TIM_CR1_CEN) {
+        /* Running: new pattern from the next period on */
+        DOT_BLINK_TIM->ARR  = (uint32_t)u16_period_ms * u32_ticks_per_ms - 1U;
+        DOT_BLINK_TIM->CCR1 = (uint32_t)u16_on_ms * u32_ticks_per_ms;
+        return;
+    }
+
+    if (tim_alloc_claim(DOT_BLINK_TIM, TIM_ALLOC_OWNER_DOT_BLINK) != HAL_OK) {
+        return;
+    }
+
+    DOT_BLINK_TIM->CR1   = TIM_CR1_ARPE;
+    DOT_BLINK_TIM->PSC   = (clock_get_apb1_timer_clock() / DOT_BLINK_COUNTER_HZ) - 1U;
+    DOT_BLINK_TIM->ARR   = (uint32_t)u16_period_ms * u32_ticks_per_ms - 1U;
+    DOT_BLINK_TIM->CCMR1 = TIM_CCMR1_OC1PE;        /* CH1 frozen, compare preloaded */
+    DOT_BLINK_TIM->CCR1  = (uint32_t)u16_on_ms * u32_ticks_per_ms;
+    DOT_BLINK_TIM->CNT   = 0;
+    DOT_BLINK_TIM->EGR   = TIM_EGR_UG;             /* Load prescaler, ARR and CCR1 */
+    DOT_BLINK_TIM->SR    = 0;
+    DOT_BLINK_TIM->DIER  = TIM_DIER_UIE | TIM_DIER_CC1IE;
+
+    HAL_NVIC_SetPriority(DOT_BLINK_IRQn, DOT_BLINK_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(DOT_BLINK_IRQn);
+
+    dot_gate(u16_on_ms > 0U);
+    DOT_BLINK_TIM->CR1 = TIM_CR1_ARPE | TIM_CR1_CEN;
+}
+
+/**
+ * @brief  Returns the gamma corrected compare value of a brightness.
+ * @param  u8_level 0 .. DOT_MAX_BRIGHTNESS.
+ * @return Compare value 0 .. DOT_PWM_STEPS.
+ */
+uint16_t dot_gamma(uint8_t u8_level)
+{
+    return g_u16_dot_gamma[u8_level];
+}
+
+/**
+ * @brief  Starts the fade DMA on the TIM1 update request.
+ *         CCR2 is preloaded, each value becomes active one update event
+ *         after the DMA has written it, i.e. always at a period boundary.
+ * @param  pu16_ccr   Compare values.
+ * @param  u16_length Number of values.
+ * @param  u8_periods Carrier periods per value (0 = 256).
+ * @return HAL_OK or HAL_ERROR.
+ */
+HAL_StatusTypeDef dot_fade_start(const uint16_t *pu16_ccr, uint16_t u16_length, uint8_t u8_periods)
+{
+    if ((pu16_ccr == NULL) || (u16_length == 0U)) {
+        return HAL_ERROR;
+    }
+
+    dot_fade_stop();
+
+    /* No interrupt, the waveform repeats until dot_fade_stop() */
+    if (dma_alloc_claim(&g_dot_fade_dma, DOT_FADE_DMA_REQUEST, DMA_ALLOC_LATENCY_BULK,
+                        HEALTH_ISR_COUNT) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    g_dot_fade_dma.Init.Direction           = DMA_MEMORY_TO_PERIPH;
+    g_dot_fade_dma.Init.PeriphInc           = DMA_PINC_DISABLE;
+    g_dot_fade_dma.Init.MemInc              = DMA_MINC_ENABLE;
+    g_dot_fade_dma.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+    g_dot_fade_dma.Init.MemDataAlignment    = DMA_MDATAALIGN_HALFWORD;
+    g_dot_fade_dma.Init.Mode                = DMA_CIRCULAR;
+    g_dot_fade_dma.Init.FIFOMode            = DMA_FIFOMODE_DISABLE;
+
+    if (HAL_DMA_Init(&g_dot_fade_dma) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    /* Repetition counter: one update event every u8_periods carrier periods */
+    TIM1->RCR = (uint8_t)(u8_periods - 1U);
+
+    if (HAL_DMA_Start(&g_dot_fade_dma, (uint32_t)(uintptr_t)pu16_ccr,
+                      (uint32_t)(uintptr_t)&TIM1->CCR2, u16_length) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    __HAL_TIM_ENABLE_DMA(&tim_handle_struct, TIM_DMA_UPDATE);
+
+    return HAL_OK;
+}
+
+/**
+ * @brief  Builds the breathing waveform and plays it.
+ *         Up 0, 2, .. 254 and down 255, 253, .. 1 through the gamma table.
+ * @param  u32_period_ms Duration of one breath.
+ * @return HAL_OK or HAL_ERROR.
+ */
+HAL_StatusTypeDef dot_fade_breathe(uint32_t u32_period_ms)
+{
+    uint32_t u32_periods = (u32_period_ms * DOT_PWM_FREQUENCY_HZ) / (1000U * DOT_FADE_BREATHE_STEPS);
+
+    if (u32_periods < 1U) {
+        u32_periods = 1U;
+    }
+    if (u32_periods > 256U) {
+        u32_periods = 256U;
+    }
+
+    dot_fade_stop();
+
+    for (uint16_t i = 0; i < DOT_FADE_BREATHE_STEPS; i++) {
+        uint16_t u16_half = DOT_FADE_BREATHE_STEPS / 2U;
+        uint8_t u8_level = (i < u16_half) ? (uint8_t)(2U * i) : (uint8_t)(2U * (DOT_FADE_BREATHE_STEPS - 1U - i) + 1U);
+
+        g_u16_dot_breathe[i] = g_u16_dot_gamma[u8_level];
+    }
+
+    return dot_fade_start(g_u16_dot_breathe, DOT_FADE_BREATHE_STEPS, (uint8_t)u32_periods);
+}
+
+/**
+ * @brief  Stops the fade DMA; the carrier keeps the last compare value.
+ * @param  None
+ * @return None
+ */
+void dot_fade_stop(void)
+{
+    if (!(TIM1->DIER & TIM_DIER_UDE)) {
+        return;
+    }
+
+    __HAL_TIM_DISABLE_DMA(&tim_handle_struct, TIM_DMA_UPDATE);
+    HAL_DMA_Abort(&g_dot_fade_dma);
+    dma_alloc_release(&g_dot_fade_dma);
+    TIM1->RCR = 0;
+}
+
+/* Static functions */
+
+/**
+ * @brief  Passes or blocks the carrier on TIM1 CH2.
+ *         Switches the output compare mode between PWM1 and forced inactive;
+ *         counter and compare value stay untouched, so the carrier phase and
+ *         brightness are kept.
+ * @param  u8_on 1 = carrier passed, 0 = dot off.
+ * @return None
+ */
+static void dot_gate(uint8_t u8_on)
+{
+    uint32_t u32_mode = u8_on ? TIM_OCMODE_PWM1 : TIM_OCMODE_FORCED_INACTIVE;
+
+    TIM1->CCMR1 = (TIM1->CCMR1 & ~TIM_CCMR1_OC2M) | (u32_mode << 8U);
+}
+
+/* Interrupt section */
+
+/**
+ * @brief  Blink gate interrupt: update = dot on, CC1 = dot off.
+ * @param  None
+ * @return None
+ */
+void TIM4_IRQHandler(void)
+{
+    HEALTH_ISR_BEGIN(HEALTH_ISR_DOT);
+    uint32_t u32_status = DOT_BLINK_TIM->SR & DOT_BLINK_TIM->DIER;
+
+    DOT_BLINK_TIM->SR = ~u32_status;
+
+    if (u32_status & TIM_SR_UIF) {
+        dot_gate(DOT_BLINK_TIM->CCR1 > 0U);
+    }
+    if (u32_status & TIM_SR_CC1IF) {
+        dot_gate(0U);
+    }
+    HEALTH_ISR_END(HEALTH_ISR_DOT);
+}
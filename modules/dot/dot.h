@@ -12,6 +12,8 @@
 
 /* Includes */
 #include "stm32f4xx.h"
+#include "dma_alloc/dma_alloc.h"
+#include "irq/irq.h"
 
 /* Public Preprocessor defines */
 
@@ -64,6 +66,49 @@
  */
 #define DOT_MAX_BRIGHTNESS  255
 
+/**
+ * @brief PWM carrier frequency of the unified driver (TIM1 CH2) in Hz.
+ */
+#define DOT_PWM_FREQUENCY_HZ    1000U
+
+/**
+ * @brief Counter steps per carrier period (10 bit). A compare value of
+ *        DOT_PWM_STEPS is always on; the 8 bit brightness is scaled to it,
+ *        the gamma table uses the full resolution for the dark end.
+ */
+#define DOT_PWM_STEPS           1024U
+
+/**
+ * @brief Entries of the breathing waveform (fade up and down).
+ */
+#define DOT_FADE_BREATHE_STEPS  256U
+
+/**
+ * @brief Fade DMA: TIM1_UP request of dma_alloc (DMA2 stream 5, channel 6).
+ */
+#define DOT_FADE_DMA_REQUEST    DMA_ALLOC_REQ_TIM1_UP
+
+/**
+ * @brief Counter clock of the blink gate timer in Hz (0.1 ms steps).
+ */
+#define DOT_BLINK_COUNTER_HZ    10000U
+
+/**
+ * @brief Longest blink period of the unified driver in ms (16 bit counter).
+ */
+#define DOT_MAX_BLINK_PERIOD_MS 6553U
+
+/**
+ * @brief Blink gate timer (APB1, interrupt only, no pin).
+ */
+#define DOT_BLINK_TIM           TIM4
+#define DOT_BLINK_IRQn          TIM4_IRQn
+
+/**
+ * @brief NVIC priority of the blink gate interrupt.
+ */
+#define DOT_BLINK_IRQ_PRIORITY  IRQ_CLASS_GATE
+
 /* Public variables */
 /**
  * @brief Global timer handle used by the dot module (TIM1).
@@ -110,4 +155,75 @@ void dot_change_blink_speed(uint32_t frequency);
  */
 void dot_change_brightness(uint32_t brightness);
 
+/**
+ * @brief  Initializes the unified dot driver: PWM carrier plus blink gate.
+ *         - TIM1 CH2 runs permanently as PWM carrier at DOT_PWM_FREQUENCY_HZ
+ *           (preloaded compare, brightness changes take effect at the next
+ *           carrier period)
+ *         - DOT_BLINK_TIM gates the carrier: its interrupts switch CH2 between
+ *           PWM and "forced inactive", the carrier itself is never touched
+ *         Starts with full brightness and no blinking (steady on).
+ *         Replaces dot_timer_init().
+ * @param  None
+ * @return None
+ */
+void dot_init(void);
+
+/**
+ * @brief  Sets the brightness of the carrier (unified driver).
+ *         Linear to the duty cycle. Can be called at any time, also while
+ *         blinking; stops a running fade.
+ * @param  u8_brightness 0 (off) .. DOT_MAX_BRIGHTNESS (always on)
+ * @return None
+ */
+void dot_set_brightness(uint8_t u8_brightness);
+
+/**
+ * @brief  Sets the blink pattern (unified driver).
+ *         The dot is lit for u16_on_ms at the start of each period and
+ *         dark for the rest. A running pattern is changed at the end of the
+ *         current period (preloaded registers), so there is no glitch.
+ * @param  u16_period_ms Blink period (1 .. DOT_MAX_BLINK_PERIOD_MS), 0 = no blinking
+ * @param  u16_on_ms     On-time per period; >= period = no blinking
+ * @return None
+ */
+void dot_set_blink(uint16_t u16_period_ms, uint16_t u16_on_ms);
+
+/**
+ * @brief  Returns the gamma corrected (2.2) compare value of a brightness.
+ *         Use it to build waveforms for dot_fade_start().
+ * @param  u8_level Perceived brightness 0 .. DOT_MAX_BRIGHTNESS
+ * @return Compare value 0 .. DOT_PWM_STEPS
+ */
+uint16_t dot_gamma(uint8_t u8_level);
+
+/**
+ * @brief  Plays a waveform of compare values on the dot without CPU.
+ *         DMA2 copies one value per TIM1 update event into CCR2 and starts
+ *         over at the end (circular); the repetition counter stretches one
+ *         step to several carrier periods. The waveform must stay valid
+ *         (static or global, not in CCM RAM) while it is played.
+ *         Works together with dot_set_blink().
+ * @param  pu16_ccr      Compare values (0 .. DOT_PWM_STEPS), e.g. from dot_gamma()
+ * @param  u16_length    Number of values (>= 1)
+ * @param  u8_periods    Carrier periods per value (1 .. 256, 0 = 256)
+ * @return HAL_OK, HAL_ERROR if the DMA stream is taken or does not start
+ */
+HAL_StatusTypeDef dot_fade_start(const uint16_t *pu16_ccr, uint16_t u16_length, uint8_t u8_periods);
+
+/**
+ * @brief  Starts a gamma corrected breathing effect (fade up and down).
+ * @param  u32_period_ms Duration of one breath, DOT_FADE_BREATHE_STEPS ms
+ *                       (one carrier period per step) .. 256 times that
+ * @return HAL_OK, HAL_ERROR if the DMA does not start
+ */
+HAL_StatusTypeDef dot_fade_breathe(uint32_t u32_period_ms);
+
+/**
+ * @brief  Stops a running fade, the last compare value stays active.
+ * @param  None
+ * @return None
+ */
+void dot_fade_stop(void);
+
 #endif /* DOT_DOT_H_ */
@@ -0,0 +1,299 @@
+/**
+ ******************************************************************************
+ * @file        dvfs.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Runtime frequency and voltage scaling: AHB prescaler,
+ *              over-drive and flash latency per level.
+ *
+ * Functionality:
+ * - Boost: over-drive on and 5 wait states first, then AHB / 1,
+ *   APB1 / 4, APB2 / 2 in one CFGR write
+ * - Idle: AHB / 2, APB1 / 2, APB2 / 1 in one CFGR write, then 2 wait
+ *   states and over-drive off
+ * - In the same masked section: SystemCoreClock, SysTick (rest of the
+ *   running millisecond as a one-off reload), prescalers of the claimed
+ *   APB2 timers, SDRAM refresh count, SWO prescaler
+ *
+ * Resources:
+ * - RCC, PWR, FLASH, SysTick, FMC SDRTR, TPIU ACPR (all shared with the
+ *   clock, sdram and trace modules)
+ ******************************************************************************
+ */
+
+#include "dvfs.h"
+#include "clock/clock.h"
+#include "tim_alloc/tim_alloc.h"
+#include "timebase/timebase.h"
+
+/* Preprocessor Defines ----------------------------------------------------- */
+/**
+ * @brief Flash wait states: up to 90 MHz and up to 180 MHz at 2.7..3.6 V.
+ */
+#define DVFS_IDLE_LATENCY       FLASH_LATENCY_2
+#define DVFS_BOOST_LATENCY      FLASH_LATENCY_5
+
+/**
+ * @brief Bus prescalers of the levels, the APB clocks are the same.
+ */
+#define DVFS_CFGR_MASK          (RCC_CFGR_HPRE | RCC_CFGR_PPRE1 | RCC_CFGR_PPRE2)
+#define DVFS_CFGR_BOOST         (RCC_SYSCLK_DIV1 | RCC_HCLK_DIV4 | (RCC_HCLK_DIV2 << 3U))
+#define DVFS_CFGR_IDLE          (RCC_SYSCLK_DIV2 | RCC_HCLK_DIV2 | (RCC_HCLK_DIV1 << 3U))
+
+/**
+ * @brief Shortest SysTick rest carried over, some cycles of the switch.
+ */
+#define DVFS_SYSTICK_MIN_REST   16U
+
+/**
+ * @brief SDRAM refresh: interval = (COUNT + 20) SDCLK cycles, COUNT at
+ *        least 41.
+ */
+#define DVFS_SDRTR_OFFSET       20U
+#define DVFS_SDRTR_MIN          41U
+
+/* Static module variables -------------------------------------------------- */
+/**
+ * @brief Timers on APB2, their kernel clock follows HCLK.
+ */
+static TIM_TypeDef *const g_dvfs_apb2_timers[] = { TIM1, TIM8, TIM9, TIM10, TIM11 };
+
+static uint8_t g_u8_dvfs_ready = 0u;
+static uint8_t g_u8_dvfs_overdrive = 0u;
+static uint8_t g_u8_dvfs_holders = 0u;
+static dvfs_level_t g_dvfs_level = DVFS_LEVEL_BOOST;
+static uint32_t g_u32_dvfs_boost_hz = 0u;
+static uint32_t g_u32_dvfs_boost_start = 0u;
+static dvfs_stats_t g_dvfs_stats;
+
+/* Static function prototypes ----------------------------------------------- */
+static HAL_StatusTypeDef dvfs_switch(dvfs_level_t level);
+static uint8_t dvfs_dividers_even(void);
+static void dvfs_apply(uint32_t u32_cfgr, uint8_t u8_boost);
+static uint32_t dvfs_scale(uint32_t u32_value, uint8_t u8_boost, uint32_t u32_max);
+static void dvfs_sdram_refresh(uint32_t u32_count);
+
+/* Public functions --------------------------------------------------------- */
+HAL_StatusTypeDef dvfs_init(void)
+{
+#if DVFS_ENABLE
+    clock_profile_t profile = clock_get_profile();
+
+    if ((profile != CLOCK_PROFILE_180MHZ) && (profile != CLOCK_PROFILE_168MHZ)) {
+        return HAL_ERROR;
+    }
+
+    g_u8_dvfs_overdrive    = (profile == CLOCK_PROFILE_180MHZ);
+    g_u32_dvfs_boost_hz    = SystemCoreClock;
+    g_u32_dvfs_boost_start = timebase_now32();
+    g_dvfs_level           = DVFS_LEVEL_BOOST;
+    g_dvfs_stats           = (dvfs_stats_t){0};
+    g_u8_dvfs_ready        = 1u;
+
+    return (g_u8_dvfs_holders == 0u) ? dvfs_switch(DVFS_LEVEL_IDLE) : HAL_OK;
+#else
+    return HAL_ERROR;
+#endif
+}
+
+void dvfs_boost(void)
+{
+    if (g_u8_dvfs_holders++ == 0u) {
+        (void)dvfs_switch(DVFS_LEVEL_BOOST);
+    }
+}
+
+void dvfs_release(void)
+{
+    if ((g_u8_dvfs_holders != 0u) && (--g_u8_dvfs_holders == 0u)) {
+        (void)dvfs_switch(DVFS_LEVEL_IDLE);
+    }
+}
+
+dvfs_level_t dvfs_get_level(void)
+{
+    return g_dvfs_level;
+}
+
+void dvfs_get_stats(dvfs_stats_t *stats)
+{
+    *stats = g_dvfs_stats;
+    if (g_u8_dvfs_ready && (g_dvfs_level == DVFS_LEVEL_BOOST)) {
+        stats->u64_boost_us += timebase_now32() - g_u32_dvfs_boost_start;
+    }
+}
+
+/* Static functions --------------------------------------------------------- */
+/**
+ * @brief Changes the level.
+ *
+ * @param level Requested level
+ * @return HAL_OK, HAL_BUSY if a drop was refused, HAL_ERROR if the
+ *         over-drive did not start (stays at the idle level)
+ */
+static HAL_StatusTypeDef dvfs_switch(dvfs_level_t level)
+{
+    uint32_t u32_primask;
+
+    if (!g_u8_dvfs_ready || (level == g_dvfs_level)) {
+        return HAL_OK;
+    }
+
+    if (level == DVFS_LEVEL_BOOST) {
+        /* Voltage and wait states first, the clock rises last */
+        if (g_u8_dvfs_overdrive && (HAL_PWREx_EnableOverDrive() != HAL_OK)) {
+            return HAL_ERROR;
+        }
+        __HAL_FLASH_SET_LATENCY(DVFS_BOOST_LATENCY);
+        while (__HAL_FLASH_GET_LATENCY() != DVFS_BOOST_LATENCY) {
+        }
+
+        u32_primask = __get_PRIMASK();
+        __disable_irq();
+        dvfs_apply(DVFS_CFGR_BOOST, 1u);
+        __set_PRIMASK(u32_primask);
+
+        g_u32_dvfs_boost_start = timebase_now32();
+    } else {
+        if (!dvfs_dividers_even()) {
+            g_dvfs_stats.u32_refused++;
+            return HAL_BUSY;
+        }
+
+        u32_primask = __get_PRIMASK();
+        __disable_irq();
+        dvfs_apply(DVFS_CFGR_IDLE, 0u);
+        __set_PRIMASK(u32_primask);
+
+        /* The clock has dropped: fewer wait states, no over-drive */
+        __HAL_FLASH_SET_LATENCY(DVFS_IDLE_LATENCY);
+        if (g_u8_dvfs_overdrive) {
+            (void)HAL_PWREx_DisableOverDrive();
+        }
+
+        g_dvfs_stats.u64_boost_us += timebase_now32() - g_u32_dvfs_boost_start;
+    }
+
+    g_dvfs_level = level;
+    g_dvfs_stats.u32_switches++;
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Checks that every divider following HCLK can be halved.
+ *
+ * @return 1 all even, 0 an odd one (claimed APB2 timer or active SWO)
+ */
+static uint8_t dvfs_dividers_even(void)
+{
+    for (uint32_t i = 0u; i < sizeof(g_dvfs_apb2_timers) / sizeof(g_dvfs_apb2_timers[0]); i++) {
+        TIM_TypeDef *tim = g_dvfs_apb2_timers[i];
+
+        if ((tim_alloc_get_owner(tim) != TIM_ALLOC_OWNER_NONE) && ((tim->PSC & 1u) == 0u)) {
+            return 0u;
+        }
+    }
+
+    if (((ITM->TCR & ITM_TCR_ITMENA_Msk) != 0u) && ((TPI->ACPR & 1u) == 0u)) {
+        return 0u;
+    }
+
+    return 1u;
+}
+
+/**
+ * @brief Switches the bus prescalers and everything that follows HCLK.
+ *        Interrupts masked.
+ *
+ * @param u32_cfgr CFGR prescaler bits of the level
+ * @param u8_boost 1 HCLK doubles, 0 HCLK halves
+ */
+static void dvfs_apply(uint32_t u32_cfgr, uint8_t u8_boost)
+{
+    uint32_t u32_refresh = (FMC_Bank5_6->SDRTR & FMC_SDRTR_COUNT) >> FMC_SDRTR_COUNT_Pos;
+    uint8_t u8_sdram = ((RCC->AHB3ENR & RCC_AHB3ENR_FMCEN) != 0u) && (u32_refresh != 0u);
+    uint32_t u32_load = dvfs_scale(SysTick->LOAD, u8_boost, SysTick_LOAD_RELOAD_Msk);
+
+    /* SDCLK halves: the shorter count already before, the interval of
+       (COUNT / 2 - 10 + 20) slow cycles is not longer */
+    if (u8_sdram && !u8_boost) {
+        dvfs_sdram_refresh(u32_refresh / 2u - DVFS_SDRTR_OFFSET / 2u);
+    }
+
+    RCC->CFGR = (RCC->CFGR & ~DVFS_CFGR_MASK) | u32_cfgr;
+    SystemCoreClock = u8_boost ? g_u32_dvfs_boost_hz : (g_u32_dvfs_boost_hz / 2u);
+
+    /* The rest of the running millisecond at the new rate as a one-off
+       reload (a write to VAL reloads on the next clock without a tick),
+       then the full period again */
+    if ((SysTick->CTRL & SysTick_CTRL_ENABLE_Msk) != 0u) {
+        uint32_t u32_rest = u8_boost ? (SysTick->VAL * 2u) : (SysTick->VAL / 2u);
+
+        if (u32_rest < DVFS_SYSTICK_MIN_REST) {
+            u32_rest = DVFS_SYSTICK_MIN_REST;
+        }
+        SysTick->LOAD = u32_rest;
+        SysTick->VAL  = 0u;
+        while (SysTick->VAL == 0u) {
+        }
+    }
+    SysTick->LOAD = u32_load;
+
+    /* Kernel clock of the APB2 timers follows: same counter rate from the
+       next update event on */
+    for (uint32_t i = 0u; i < sizeof(g_dvfs_apb2_timers) / sizeof(g_dvfs_apb2_timers[0]); i++) {
+        TIM_TypeDef *tim = g_dvfs_apb2_timers[i];
+
+        if (tim_alloc_get_owner(tim) != TIM_ALLOC_OWNER_NONE) {
+            tim->PSC = dvfs_scale(tim->PSC, u8_boost, 0xFFFFu);
+        }
+    }
+
+    if (u8_sdram && u8_boost) {
+        dvfs_sdram_refresh(u32_refresh * 2u + DVFS_SDRTR_OFFSET);
+    }
+
+    if ((ITM->TCR & ITM_TCR_ITMENA_Msk) != 0u) {
+        TPI->ACPR = dvfs_scale(TPI->ACPR, u8_boost, TPI_ACPR_PRESCALER_Msk);
+    }
+}
+
+/**
+ * @brief Scales a "divider - 1" register value by two.
+ *
+ * @param u32_value Register value
+ * @param u8_boost  1 doubles the divider, 0 halves it
+ * @param u32_max   Largest register value
+ * @return New register value
+ */
+static uint32_t dvfs_scale(uint32_t u32_value, uint8_t u8_boost, uint32_t u32_max)
+{
+    uint32_t u32_divider = u8_boost ? ((u32_value + 1u) * 2u) : ((u32_value + 1u) / 2u);
+
+    if (u32_divider == 0u) {
+        return 0u;
+    }
+
+    return ((u32_divider - 1u) > u32_max) ? u32_max : (u32_divider - 1u);
+}
+
+/**
+ * @brief Sets the SDRAM refresh count.
+ *
+ * @param u32_count COUNT, limited to 41 .. 8191
+ */
+static void dvfs_sdram_refresh(uint32_t u32_count)
+{
+    uint32_t u32_max = FMC_SDRTR_COUNT >> FMC_SDRTR_COUNT_Pos;
+
+    if (u32_count < DVFS_SDRTR_MIN) {
+        u32_count = DVFS_SDRTR_MIN;
+    }
+    if (u32_count > u32_max) {
+        u32_count = u32_max;
+    }
+
+    FMC_Bank5_6->SDRTR = (FMC_Bank5_6->SDRTR & ~FMC_SDRTR_COUNT) | (u32_count << FMC_SDRTR_COUNT_Pos);
+}
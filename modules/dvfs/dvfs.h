@@ -0,0 +1,132 @@
+/**
+ ******************************************************************************
+ * @file        dvfs.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the runtime frequency and voltage
+ *              scaling between idle and render bursts.
+ *
+ * @details
+ * On top of a PLL profile of the clock module the core runs at half the
+ * clock (PLL / 2 through the AHB prescaler, over-drive off, 2 flash wait
+ * states) unless a burst holds the boost level: the full profile clock,
+ * with over-drive at 180 MHz. Display rendering or an FFT slice brackets
+ * its work with dvfs_boost() / dvfs_release(); between the bursts, and so
+ * whenever the scheduler sleeps, the core stays at the idle level.
+ *
+ * The PLL stays locked, so the 48 MHz of USB and SDIO are untouched, and
+ * the APB prescalers change together with the AHB prescaler so that both
+ * bus clocks stay the same. SPI, I2C, USART and ADC settings and all
+ * APB1 timers (timebase, control task, stopwatch, idle wakeup) keep
+ * running unchanged. What follows HCLK is corrected in the switch:
+ *
+ *  - SysTick: the running millisecond is carried over, the HAL tick and
+ *    sched_now_us() do not jump
+ *  - APB2 timers (TIM1, TIM8..TIM11: fan PWM, dot, ADC trigger): their
+ *    kernel clock halves, the prescalers of all claimed ones are halved
+ *    (doubled) through the preload; counts and compares are kept, only
+ *    the period running at the switch is stretched (shortened)
+ *  - SDRAM refresh count (FMC), SWO prescaler (trace)
+ *
+ * The regulator scale (VOS) can only be changed with the PLL off; the
+ * voltage side of the idle level is the over-drive, switched off.
+ *
+ * The idle level needs even prescaler dividers on the APB2 timers (and
+ * the SWO): a drop with an odd one is refused and the core stays at the
+ * boost level. Modules round their dividers with DVFS_EVEN_DIVIDER().
+ * Cycle counts (DWT) follow HCLK, conversions with SystemCoreClock are
+ * only right within one level.
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - Two levels, nested bursts (counted holders), main loop only
+ *  - Switch with interrupts masked for some 50 cycles, over-drive and
+ *    flash latency are changed before (boost) or after (idle) it
+ *  - Compiled out unless DVFS_ENABLE is 1 (dvfs_init() fails)
+ *
+ ******************************************************************************
+ */
+
+#ifndef DVFS_DVFS_H_
+#define DVFS_DVFS_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief 1 to scale the clock at runtime.
+ */
+#ifndef DVFS_ENABLE
+#define DVFS_ENABLE             0
+#endif
+
+/**
+ * @brief Rounds a timer prescaler divider (PSC + 1) up to an even value
+ *        with DVFS_ENABLE, so that the idle level can halve it.
+ */
+#if DVFS_ENABLE
+#define DVFS_EVEN_DIVIDER(divider)  (((divider) + 1U) & ~1UL)
+#else
+#define DVFS_EVEN_DIVIDER(divider)  (divider)
+#endif
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Clock levels.
+ */
+typedef enum {
+    DVFS_LEVEL_IDLE = 0,        /**< Profile clock / 2, no over-drive      */
+    DVFS_LEVEL_BOOST            /**< Profile clock (180 MHz: over-drive)   */
+} dvfs_level_t;
+
+/**
+ * @brief Counters since dvfs_init().
+ */
+typedef struct {
+    uint32_t u32_switches;      /**< Level changes                         */
+    uint32_t u32_refused;       /**< Drops refused (odd divider)           */
+    uint64_t u64_boost_us;      /**< Time at the boost level (timebase)    */
+} dvfs_stats_t;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Starts the policy on the active PLL profile and drops to the
+ *        idle level. Call after the modules set up their timers.
+ *
+ * @return HAL_OK, HAL_ERROR without a PLL profile or DVFS_ENABLE 0,
+ *         HAL_BUSY if the drop was refused (stays at the boost level)
+ */
+HAL_StatusTypeDef dvfs_init(void);
+
+/**
+ * @brief Begins a burst: the boost level until the matching release.
+ *
+ * @return None
+ */
+void dvfs_boost(void);
+
+/**
+ * @brief Ends a burst; the last one drops to the idle level.
+ *
+ * @return None
+ */
+void dvfs_release(void);
+
+/**
+ * @brief Returns the active level.
+ *
+ * @return Level (DVFS_LEVEL_BOOST before dvfs_init())
+ */
+dvfs_level_t dvfs_get_level(void);
+
+/**
+ * @brief Copies the counters.
+ *
+ * @param stats Destination
+ * @return None
+ */
+void dvfs_get_stats(dvfs_stats_t *stats);
+
+#endif /* DVFS_DVFS_H_ */
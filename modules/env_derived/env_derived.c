@@ -0,0 +1,333 @@
+/**
+ ******************************************************************************
+ * @file        env_derived.c
+ * @author      Mahmoud Mahmoud, Judy Abou Rmeh
+ * @version     V1.0
+ * @date        14.10.2026
+ * @brief       Implementierung der abgeleiteten Wetterdaten
+ *
+ * @details
+ * Drucktendenz: beim Verschieben des Fensters um einen Stützwert sinkt
+ * jedes x um 1, also Σx·y' = Σx·y - (Σy - y_alt) + (n - 1)·y_neu.
+ * Die Steigung je Stützwert ist (n·Σx·y - Σx·Σy) / (n²·(n² - 1) / 12).
+ *
+ * Tabellen (Q16 bzw. cm) mit Python erzeugt:
+ *  - altitude_table[i] = 4433000 · (1 - (0,5 + i · 320 / 65536)^(1/5,255))
+ *  - ln_table[i]       = 65536 · ln(1 + i / 64)
+ *
+ ******************************************************************************
+ */
+
+/* Includes */
+#include "env_derived.h"
+
+/* Private defines */
+
+/* Verhältnis p / p0 in Q16: Tabellenanfang 0,5, Schrittweite 320 */
+#define ALTITUDE_RATIO_MIN     32768
+#define ALTITUDE_RATIO_STEP    320
+#define ALTITUDE_TABLE_LEN     129
+
+/* Logarithmus-Tabelle: 64 Abschnitte über [1, 2) */
+#define LN_TABLE_BITS          6
+#define LN_TABLE_LEN           ((1 << LN_TABLE_BITS) + 1)
+
+/* ln(2) und ln(100000) in Q16 (RH in 0,001 % -> Anteil) */
+#define LN2_Q16                45426
+#define LN_100000_Q16          754511
+
+/* Magnus-Konstanten: b = 17,62 in Q16, c = 243,12 Grad C in 0,01 Grad C */
+#define MAGNUS_B_Q16           1154744
+#define MAGNUS_B_CENTI         1762
+#define MAGNUS_C_CENTI         24312
+
+/* Stützwerte der Drucktendenz je 3 h */
+#define TREND_SAMPLES_PER_3H   ((3UL * 3600UL * 1000UL) / ENV_DERIVED_TREND_PERIOD_MS)
+
+/* Static module variables */
+
+/**
+ * @brief Höhe in cm über p / p0
+ */
+static const int32_t altitude_table[ALTITUDE_TABLE_LEN] = {
+    547801, 540610, 533474, 526394, 519367, 512394, 505474, 498605,
+    491786, 485017, 478298, 471626, 465003, 458425, 451894, 445408,
+    438967, 432569, 426215, 419904, 413634, 407406, 401218, 395070,
+    388963, 382894, 376863, 370871, 364916, 358997, 353115, 347269,
+    341459, 335683, 329942, 324234, 318560, 312920, 307312, 301736,
+    296192, 290679, 285198, 279747, 274326, 268936, 263574, 258243,
+    252939, 247665, 242418, 237199, 232008, 226844, 221707, 216596,
+    211511, 206453, 201420, 196412, 191430, 186472, 181539, 176630,
+    171745, 166883, 162045, 157231, 152439, 147670, 142923, 138199,
+    133497, 128816, 124157, 119520, 114903, 110308, 105733, 101178,
+    96644, 92130, 87636, 83161, 78706, 74271, 69854, 65457,
+    61078, 56718, 52376, 48052, 43747, 39459, 35189, 30937,
+    26702, 22484, 18283, 14100, 9933, 5783, 1649, -2468,
+    -6570, -10655, -14724, -18778, -22815, -26838, -30845, -34836,
+    -38813, -42774, -46721, -50653, -54570, -58473, -62362, -66236,
+    -70096, -73942, -77774, -81593, -85397, -89188, -92966, -96730,
+    -100481,
+};
+
+/**
+ * @brief ln(1 + i / 64) in Q16
+ */
+static const int32_t ln_table[LN_TABLE_LEN] = {
+    0, 1016, 2017, 3002, 3973, 4930, 5873, 6802,
+    7719, 8623, 9515, 10394, 11262, 12119, 12965, 13800,
+    14624, 15438, 16242, 17037, 17821, 18597, 19364, 20121,
+    20870, 21611, 22343, 23067, 23783, 24492, 25193, 25886,
+    26573, 27252, 27924, 28589, 29248, 29900, 30546, 31185,
+    31818, 32445, 33067, 33682, 34292, 34896, 35494, 36087,
+    36675, 37258, 37835, 38407, 38975, 39537, 40095, 40648,
+    41196, 41740, 42280, 42815, 43345, 43872, 44394, 44912,
+    45426,
+};
+
+/* Static module functions (prototypes) */
+static int32_t env_derived_ln_q16(uint32_t value);
+static void env_derived_trend_add(env_derived_t *derived, int32_t pascal);
+
+/* Public functions */
+
+/**
+ * @brief   Initialisiert die abgeleiteten Werte
+ *
+ * @param   derived      Instanz
+ * @param   reference_pa Referenzdruck der Höhe (z. B. QNH), 0 = Normaldruck
+ * @return  None
+ */
+void env_derived_init(env_derived_t *derived, uint32_t reference_pa)
+{
+    derived->trend_head  = 0;
+    derived->trend_count = 0;
+    derived->sum_y       = 0;
+    derived->sum_xy      = 0;
+    derived->period_sum  = 0;
+    derived->period_n    = 0;
+    derived->period_tick = HAL_GetTick();
+    derived->trend       = 0;
+    derived->altitude_cm = 0;
+    derived->dew_point   = 0;
+
+    env_derived_set_reference(derived, reference_pa);
+}
+
+/**
+ * @brief   Setzt den Referenzdruck der Höhe
+ *
+ * @param   derived      Instanz
+ * @param   reference_pa Referenzdruck in Pa, 0 = Normaldruck
+ * @return  None
+ */
+void env_derived_set_reference(env_derived_t *derived, uint32_t reference_pa)
+{
+    derived->reference_pa = (reference_pa != 0) ? reference_pa : ENV_DERIVED_SEA_LEVEL_PA;
+}
+
+/**
+ * @brief   Übernimmt einen Messwert und schreibt alle Werte fort
+ *
+ * @details
+ * Die Drucktendenz erhält je ENV_DERIVED_TREND_PERIOD_MS einen Stützwert
+ * (Mittelwert der Messwerte der Periode).
+ *
+ * @param   derived       Instanz
+ * @param   centi_celsius Temperatur in 0,01 Grad C
+ * @param   pascal        Luftdruck in Pa
+ * @param   milli_rh      Relative Luftfeuchtigkeit in 0,001 %
+ * @return  None
+ */
+void env_derived_update(env_derived_t *derived, int32_t centi_celsius, uint32_t pascal, uint32_t milli_rh)
+{
+    derived->altitude_cm = env_derived_altitude_cm(pascal, derived->reference_pa);
+    derived->dew_point   = env_derived_dew_point(centi_celsius, milli_rh);
+
+    derived->period_sum += pascal;
+    derived->period_n++;
+
+    if ((HAL_GetTick() - derived->period_tick) >= ENV_DERIVED_TREND_PERIOD_MS) {
+        derived->period_tick += ENV_DERIVED_TREND_PERIOD_MS;
+        env_derived_trend_add(derived, (int32_t)((derived->period_sum + derived->period_n / 2) / derived->period_n));
+        derived->period_sum = 0;
+        derived->period_n   = 0;
+    }
+}
+
+/**
+ * @brief   Liefert die Drucktendenz
+ *
+ * @param   derived Instanz
+ * @param   trend   Tendenz in Pa je 3 h
+ * @return  HAL_OK oder HAL_BUSY
+ */
+HAL_StatusTypeDef env_derived_get_trend(const env_derived_t *derived, int32_t *trend)
+{
+    if (derived->trend_count < ENV_DERIVED_TREND_MIN_SAMPLES) {
+        return HAL_BUSY;
+    }
+
+    *trend = derived->trend;
+
+    return HAL_OK;
+}
+
+/**
+ * @brief   Liefert die Höhe zum letzten Messwert
+ *
+ * @param   derived Instanz
+ * @return  Höhe in cm
+ */
+int32_t env_derived_get_altitude_cm(const env_derived_t *derived)
+{
+    return derived->altitude_cm;
+}
+
+/**
+ * @brief   Liefert den Taupunkt zum letzten Messwert
+ *
+ * @param   derived Instanz
+ * @return  Taupunkt in 0,01 Grad C
+ */
+int32_t env_derived_get_dew_point(const env_derived_t *derived)
+{
+    return derived->dew_point;
+}
+
+/**
+ * @brief   Höhe aus Luft- und Referenzdruck
+ *
+ * @param   pascal       Luftdruck in Pa
+ * @param   reference_pa Referenzdruck in Pa
+ * @return  Höhe in cm
+ */
+int32_t env_derived_altitude_cm(uint32_t pascal, uint32_t reference_pa)
+{
+    uint32_t ratio;
+    uint32_t index;
+    int32_t  frac;
+
+    if (reference_pa == 0) {
+        return 0;
+    }
+
+    ratio = (uint32_t)(((uint64_t)pascal << 16) / reference_pa);
+
+    if (ratio <= ALTITUDE_RATIO_MIN) {
+        return altitude_table[0];
+    }
+
+    index = (ratio - ALTITUDE_RATIO_MIN) / ALTITUDE_RATIO_STEP;
+    if (index >= (ALTITUDE_TABLE_LEN - 1)) {
+        return altitude_table[ALTITUDE_TABLE_LEN - 1];
+    }
+
+    frac = (int32_t)((ratio - ALTITUDE_RATIO_MIN) % ALTITUDE_RATIO_STEP);
+
+    return altitude_table[index] +
+           ((altitude_table[index + 1] - altitude_table[index]) * frac) / ALTITUDE_RATIO_STEP;
+}
+
+/**
+ * @brief   Taupunkt aus Temperatur und relativer Feuchte
+ *
+ * @param   centi_celsius Temperatur in 0,01 Grad C
+ * @param   milli_rh      Relative Luftfeuchtigkeit in 0,001 % (> 0)
+ * @return  Taupunkt in 0,01 Grad C
+ */
+int32_t env_derived_dew_point(int32_t centi_celsius, uint32_t milli_rh)
+{
+    int64_t gamma;
+    int64_t denominator;
+
+    if (milli_rh == 0) {
+        milli_rh = 1;
+    }
+
+    /* g = ln(RH / 100 %) + b·T / (c + T), alles in Q16 */
+    gamma = (int64_t)env_derived_ln_q16(milli_rh) - LN_100000_Q16;
+    gamma += ((int64_t)MAGNUS_B_CENTI * centi_celsius * 65536) /
+             ((int64_t)100 * (MAGNUS_C_CENTI + centi_celsius));
+
+    denominator = MAGNUS_B_Q16 - gamma;
+    if (denominator <= 0) {
+        return centi_celsius;
+    }
+
+    return (int32_t)((MAGNUS_C_CENTI * gamma) / denominator);
+}
+
+/* Static module functions (implementation) */
+
+/**
+ * @brief   Natürlicher Logarithmus in Q16
+ *
+ * @details
+ * value = m · 2^e mit m in [1, 2): ln(value) = e · ln(2) + ln(m),
+ * ln(m) aus ln_table, linear interpoliert.
+ *
+ * @param   value Argument (> 0)
+ * @return  ln(value) in Q16
+ */
+static int32_t env_derived_ln_q16(uint32_t value)
+{
+    uint32_t exponent = 31U - __CLZ(value);
+    uint32_t mantissa;
+    uint32_t index;
+    int32_t  frac;
+
+    /* Mantisse auf 16 Nachkommabits normieren */
+    if (exponent >= 16U) {
+        mantissa = (value >> (exponent - 16U)) & 0xFFFFU;
+    } else {
+        mantissa = (value << (16U - exponent)) & 0xFFFFU;
+    }
+
+    index = mantissa >> (16 - LN_TABLE_BITS);
+    frac  = (int32_t)(mantissa & ((1U << (16 - LN_TABLE_BITS)) - 1U));
+
+    return (int32_t)exponent * LN2_Q16 + ln_table[index] +
+           (((ln_table[index + 1] - ln_table[index]) * frac) >> (16 - LN_TABLE_BITS));
+}
+
+/**
+ * @brief   Fügt einen Stützwert der Drucktendenz hinzu
+ *
+ * @param   derived Instanz
+ * @param   pascal  Mittlerer Luftdruck der Periode in Pa
+ * @return  None
+ */
+static void env_derived_trend_add(env_derived_t *derived, int32_t pascal)
+{
+    int64_t n;
+    int64_t sum_x;
+    int64_t denominator;
+
+    if (derived->trend_count < ENV_DERIVED_TREND_SAMPLES) {
+        derived->sum_xy += (int64_t)derived->trend_count * pascal;
+        derived->sum_y  += pascal;
+        derived->trend_count++;
+    } else {
+        /* Ältester Wert liegt auf trend_head */
+        int32_t oldest = derived->trend_ring[derived->trend_head];
+
+        derived->sum_xy += -(derived->sum_y - oldest) +
+                           (int64_t)(ENV_DERIVED_TREND_SAMPLES - 1) * pascal;
+        derived->sum_y  += pascal - oldest;
+    }
+
+    derived->trend_ring[derived->trend_head] = pascal;
+    derived->trend_head = (uint16_t)((derived->trend_head + 1) % ENV_DERIVED_TREND_SAMPLES);
+
+    n = derived->trend_count;
+    if (n < 2) {
+        derived->trend = 0;
+        return;
+    }
+
+    sum_x       = n * (n - 1) / 2;
+    denominator = n * n * (n * n - 1) / 12;
+
+    derived->trend = (int32_t)(((n * derived->sum_xy - sum_x * derived->sum_y) *
+                                (int64_t)TREND_SAMPLES_PER_3H) / denominator);
+}
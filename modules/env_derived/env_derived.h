@@ -0,0 +1,156 @@
+/**
+ ******************************************************************************
+ * @file        env_derived.h
+ * @author      Mahmoud Mahmoud, Judy Abou Rmeh
+ * @version     V1.0
+ * @date        14.10.2026
+ * @brief       Abgeleitete Wetterdaten: Drucktendenz, Höhe, Taupunkt
+ *
+ * @details
+ * Rechnet aus den Festkommawerten von env_sensor (0,01 Grad C, Pa,
+ * 0,001 %) bei jedem neuen Messwert:
+ *
+ *  - Drucktendenz in Pa je 3 h (= 0,01 hPa/3h): Steigung der
+ *    Ausgleichsgeraden über die letzten 3 h, aus den laufend
+ *    fortgeschriebenen Summen Σy und Σx·y in O(1) je Wert
+ *  - Höhe in cm aus dem Referenzdruck (internationale Höhenformel)
+ *  - Taupunkt in 0,01 Grad C (Magnus-Formel)
+ *
+ * Potenz und Logarithmus kommen aus Tabellen im Flash mit linearer
+ * Interpolation, gerechnet wird nur mit Ganzzahlen.
+ *
+ ******************************************************************************
+ */
+
+#ifndef ENV_DERIVED_ENV_DERIVED_H_
+#define ENV_DERIVED_ENV_DERIVED_H_
+
+#include "stm32f4xx.h"
+
+/* Public Preprocessor defines */
+
+/**
+ * @brief Abstand der Stützwerte der Drucktendenz in Millisekunden; die
+ *        Messwerte dazwischen werden gemittelt
+ */
+#define ENV_DERIVED_TREND_PERIOD_MS    60000UL
+
+/**
+ * @brief Anzahl Stützwerte der Drucktendenz (3 h)
+ */
+#define ENV_DERIVED_TREND_SAMPLES      ((3UL * 3600UL * 1000UL) / ENV_DERIVED_TREND_PERIOD_MS)
+
+/**
+ * @brief Mindestanzahl Stützwerte für eine gültige Tendenz
+ */
+#define ENV_DERIVED_TREND_MIN_SAMPLES  10
+
+/**
+ * @brief Normaldruck auf Meereshöhe in Pa
+ */
+#define ENV_DERIVED_SEA_LEVEL_PA       101325UL
+
+/* Public type definitions */
+
+/**
+ * @brief Zustand der abgeleiteten Werte
+ */
+typedef struct {
+    int32_t  trend_ring[ENV_DERIVED_TREND_SAMPLES];  /**< Stützwerte in Pa */
+    uint16_t trend_head;
+    uint16_t trend_count;
+    int64_t  sum_y;         /**< Σ y                    */
+    int64_t  sum_xy;        /**< Σ x·y, x = 0 am ältesten */
+    int64_t  period_sum;    /**< Laufende Periode       */
+    uint32_t period_n;
+    uint32_t period_tick;
+    uint32_t reference_pa;
+    int32_t  trend;         /**< Pa je 3 h              */
+    int32_t  altitude_cm;
+    int32_t  dew_point;     /**< 0,01 Grad C            */
+} env_derived_t;
+
+/* Public functions (prototypes) */
+
+/**
+ * @brief   Initialisiert die abgeleiteten Werte
+ *
+ * @param   derived      Instanz
+ * @param   reference_pa Referenzdruck der Höhe (z. B. QNH), 0 = Normaldruck
+ * @return  None
+ */
+void env_derived_init(env_derived_t *derived, uint32_t reference_pa);
+
+/**
+ * @brief   Setzt den Referenzdruck der Höhe
+ *
+ * @param   derived      Instanz
+ * @param   reference_pa Referenzdruck in Pa, 0 = Normaldruck
+ * @return  None
+ */
+void env_derived_set_reference(env_derived_t *derived, uint32_t reference_pa);
+
+/**
+ * @brief   Übernimmt einen Messwert und schreibt alle Werte fort
+ *
+ * @param   derived       Instanz
+ * @param   centi_celsius Temperatur in 0,01 Grad C
+ * @param   pascal        Luftdruck in Pa
+ * @param   milli_rh      Relative Luftfeuchtigkeit in 0,001 %
+ * @return  None
+ */
+void env_derived_update(env_derived_t *derived, int32_t centi_celsius, uint32_t pascal, uint32_t milli_rh);
+
+/**
+ * @brief   Liefert die Drucktendenz
+ *
+ * @param   derived Instanz
+ * @param   trend   Tendenz in Pa je 3 h
+ * @return  HAL_OK, HAL_BUSY solange weniger als
+ *          ENV_DERIVED_TREND_MIN_SAMPLES Stützwerte vorliegen
+ */
+HAL_StatusTypeDef env_derived_get_trend(const env_derived_t *derived, int32_t *trend);
+
+/**
+ * @brief   Liefert die Höhe zum letzten Messwert
+ *
+ * @param   derived Instanz
+ * @return  Höhe in cm
+ */
+int32_t env_derived_get_altitude_cm(const env_derived_t *derived);
+
+/**
+ * @brief   Liefert den Taupunkt zum letzten Messwert
+ *
+ * @param   derived Instanz
+ * @return  Taupunkt in 0,01 Grad C
+ */
+int32_t env_derived_get_dew_point(const env_derived_t *derived);
+
+/**
+ * @brief   Höhe aus Luft- und Referenzdruck
+ *
+ * @details
+ * h = 44330 m · (1 - (p / p0)^(1 / 5,255)), Tabelle für p / p0 von 0,5
+ * bis 1,125 (ca. -1000 m bis 5500 m), außerhalb begrenzt.
+ *
+ * @param   pascal       Luftdruck in Pa
+ * @param   reference_pa Referenzdruck in Pa
+ * @return  Höhe in cm
+ */
+int32_t env_derived_altitude_cm(uint32_t pascal, uint32_t reference_pa);
+
+/**
+ * @brief   Taupunkt aus Temperatur und relativer Feuchte
+ *
+ * @details
+ * Magnus-Formel mit b = 17,62 und c = 243,12 Grad C:
+ * g = ln(RH) + b·T / (c + T), Td = c·g / (b - g).
+ *
+ * @param   centi_celsius Temperatur in 0,01 Grad C
+ * @param   milli_rh      Relative Luftfeuchtigkeit in 0,001 % (> 0)
+ * @return  Taupunkt in 0,01 Grad C
+ */
+int32_t env_derived_dew_point(int32_t centi_celsius, uint32_t milli_rh);
+
+#endif /* ENV_DERIVED_ENV_DERIVED_H_ */
@@ -0,0 +1,302 @@
+/**
+ ******************************************************************************
+ * @file        env_history.c
+ * @author      Mahmoud Mahmoud, Judy Abou Rmeh
+ * @version     V1.0
+ * @date        14.10.2026
+ * @brief       Implementierung des Zeitreihen-Speichers
+ *
+ * @details
+ * Verlauf: delta[i] ist die Differenz zum Vorgänger, oldest der Wert
+ * des ältesten Eintrags. Beim Überschreiben wird oldest um das Delta des
+ * nächstälteren Eintrags fortgeschrieben.
+ *
+ * Fenster: die Deques enthalten Ringpositionen abgeschlossener Buckets,
+ * älteste vorne. Der überschriebene Bucket ist immer der älteste, steht
+ * er vorne in einer Deque, wird er dort entfernt.
+ *
+ ******************************************************************************
+ */
+
+/* Includes */
+#include "env_history.h"
+
+/* Static module variables */
+
+/**
+ * @brief Bucket-Größe und -Anzahl je Fenster (bei ENV_HISTORY_SAMPLE_MS)
+ */
+static const struct {
+    uint16_t bucket_samples;
+    uint8_t  bucket_count;
+} window_config[ENV_HISTORY_WINDOW_COUNT] = {
+    [ENV_HISTORY_WINDOW_1MIN] = { 1,                                   60 },
+    [ENV_HISTORY_WINDOW_1H]   = { 60000 / ENV_HISTORY_SAMPLE_MS,       60 },
+    [ENV_HISTORY_WINDOW_24H]  = { (15 * 60000) / ENV_HISTORY_SAMPLE_MS, 96 },
+};
+
+/* Static module functions (prototypes) */
+static void env_history_window_init(env_history_window_t *window, uint16_t bucket_samples, uint8_t bucket_count);
+static void env_history_window_add(env_history_window_t *window, int32_t value);
+static void env_history_window_close(env_history_window_t *window);
+
+/* Public functions */
+
+/**
+ * @brief   Initialisiert eine Zeitreihe (leer)
+ *
+ * @param   series Instanz
+ * @return  None
+ */
+void env_history_init(env_history_series_t *series)
+{
+    series->oldest = 0;
+    series->newest = 0;
+    series->head   = 0;
+    series->count  = 0;
+
+    for (uint8_t i = 0; i < ENV_HISTORY_WINDOW_COUNT; i++) {
+        env_history_window_init(&series->window[i],
+                                window_config[i].bucket_samples,
+                                window_config[i].bucket_count);
+    }
+}
+
+/**
+ * @brief   Fügt einen Wert hinzu und schreibt alle Fenster fort
+ *
+ * @param   series Instanz
+ * @param   value  Messwert (Festkomma)
+ * @return  None
+ */
+void env_history_add(env_history_series_t *series, int32_t value)
+{
+    int32_t delta;
+
+    if (series->count == 0) {
+        series->oldest = value;
+        series->newest = value;
+        delta = 0;
+    } else {
+        delta = value - series->newest;
+        if (delta > INT16_MAX) {
+            delta = INT16_MAX;
+        } else if (delta < -INT16_MAX) {
+            delta = -INT16_MAX;
+        }
+        series->newest += delta;
+    }
+
+    /* Ring voll: ältester Eintrag liegt auf head */
+    if (series->count == ENV_HISTORY_LENGTH) {
+        series->oldest += series->delta[(series->head + 1) % ENV_HISTORY_LENGTH];
+    } else {
+        series->count++;
+    }
+
+    series->delta[series->head] = (int16_t)delta;
+    series->head = (uint16_t)((series->head + 1) % ENV_HISTORY_LENGTH);
+
+    for (uint8_t i = 0; i < ENV_HISTORY_WINDOW_COUNT; i++) {
+        env_history_window_add(&series->window[i], series->newest);
+    }
+}
+
+/**
+ * @brief   Liefert Minimum, Maximum und Mittelwert eines Fensters
+ *
+ * @param   series Instanz
+ * @param   window Fenster
+ * @param   stats  Auswertung
+ * @return  HAL_OK, HAL_ERROR ohne Werte oder bei ungültigem Fenster
+ */
+HAL_StatusTypeDef env_history_get_stats(const env_history_series_t *series,
+                                        env_history_window_id_t window,
+                                        env_history_stats_t *stats)
+{
+    const env_history_window_t *w;
+    int64_t sum;
+
+    if ((window >= ENV_HISTORY_WINDOW_COUNT) || (stats == NULL)) {
+        return HAL_ERROR;
+    }
+
+    w = &series->window[window];
+    stats->count = (uint32_t)w->filled * w->bucket_samples + w->cur_n;
+
+    if (stats->count == 0) {
+        return HAL_ERROR;
+    }
+
+    if (w->cur_n > 0) {
+        stats->min = w->cur_min;
+        stats->max = w->cur_max;
+    } else {
+        stats->min = INT32_MAX;
+        stats->max = INT32_MIN;
+    }
+
+    if ((w->min_len > 0) && (w->bucket_min[w->min_queue[w->min_head]] < stats->min)) {
+        stats->min = w->bucket_min[w->min_queue[w->min_head]];
+    }
+    if ((w->max_len > 0) && (w->bucket_max[w->max_queue[w->max_head]] > stats->max)) {
+        stats->max = w->bucket_max[w->max_queue[w->max_head]];
+    }
+
+    /* Gerundeter Mittelwert, auch für negative Summen */
+    sum = w->total + w->cur_sum;
+    if (sum >= 0) {
+        stats->mean = (int32_t)((sum + stats->count / 2) / stats->count);
+    } else {
+        stats->mean = (int32_t)((sum - stats->count / 2) / stats->count);
+    }
+
+    return HAL_OK;
+}
+
+/**
+ * @brief   Dekodiert den Verlauf, neuester Wert zuerst
+ *
+ * @param   series Instanz
+ * @param   values Zielpuffer
+ * @param   max    Größe des Zielpuffers
+ * @return  Anzahl geschriebener Werte
+ */
+uint16_t env_history_read(const env_history_series_t *series, int32_t *values, uint16_t max)
+{
+    uint16_t n = (max < series->count) ? max : series->count;
+    uint16_t index = series->head;
+    int32_t value = series->newest;
+
+    for (uint16_t i = 0; i < n; i++) {
+        index = (uint16_t)((index + ENV_HISTORY_LENGTH - 1) % ENV_HISTORY_LENGTH);
+        values[i] = value;
+        value -= series->delta[index];
+    }
+
+    return n;
+}
+
+/**
+ * @brief   Liefert den neuesten Wert
+ *
+ * @param   series Instanz
+ * @return  Neuester Wert, 0 ohne Werte
+ */
+int32_t env_history_get_latest(const env_history_series_t *series)
+{
+    return (series->count > 0) ? series->newest : 0;
+}
+
+/* Static module functions (implementation) */
+
+/**
+ * @brief   Initialisiert ein Fenster (leer)
+ *
+ * @param   window         Fenster
+ * @param   bucket_samples Werte je Bucket
+ * @param   bucket_count   Anzahl Buckets (höchstens ENV_HISTORY_MAX_BUCKETS)
+ * @return  None
+ */
+static void env_history_window_init(env_history_window_t *window, uint16_t bucket_samples, uint8_t bucket_count)
+{
+    window->bucket_samples = (bucket_samples > 0) ? bucket_samples : 1;
+    window->bucket_count   = (bucket_count <= ENV_HISTORY_MAX_BUCKETS) ? bucket_count : ENV_HISTORY_MAX_BUCKETS;
+    window->min_head = 0;
+    window->min_len  = 0;
+    window->max_head = 0;
+    window->max_len  = 0;
+    window->pos      = 0;
+    window->filled   = 0;
+    window->total    = 0;
+    window->cur_min  = 0;
+    window->cur_max  = 0;
+    window->cur_sum  = 0;
+    window->cur_n    = 0;
+}
+
+/**
+ * @brief   Fügt einen Wert in den laufenden Bucket ein
+ *
+ * @param   window Fenster
+ * @param   value  Messwert
+ * @return  None
+ */
+static void env_history_window_add(env_history_window_t *window, int32_t value)
+{
+    if (window->cur_n == 0) {
+        window->cur_min = value;
+        window->cur_max = value;
+        window->cur_sum = 0;
+    } else {
+        if (value < window->cur_min) {
+            window->cur_min = value;
+        }
+        if (value > window->cur_max) {
+            window->cur_max = value;
+        }
+    }
+
+    window->cur_sum += value;
+    window->cur_n++;
+
+    if (window->cur_n >= window->bucket_samples) {
+        env_history_window_close(window);
+    }
+}
+
+/**
+ * @brief   Schließt den laufenden Bucket ab
+ *
+ * @details
+ * Überschreibt bei vollem Ring den ältesten Bucket: Summe korrigieren,
+ * Position vorne aus den Deques entfernen. Danach wird die neue Position
+ * hinten eingereiht, größere Minima bzw. kleinere Maxima davor fallen
+ * weg, da sie nie mehr Extremwert werden.
+ *
+ * @param   window Fenster
+ * @return  None
+ */
+static void env_history_window_close(env_history_window_t *window)
+{
+    uint8_t count = window->bucket_count;
+    uint8_t pos = window->pos;
+
+    if (window->filled == count) {
+        window->total -= window->bucket_sum[pos];
+
+        if ((window->min_len > 0) && (window->min_queue[window->min_head] == pos)) {
+            window->min_head = (uint8_t)((window->min_head + 1) % count);
+            window->min_len--;
+        }
+        if ((window->max_len > 0) && (window->max_queue[window->max_head] == pos)) {
+            window->max_head = (uint8_t)((window->max_head + 1) % count);
+            window->max_len--;
+        }
+    } else {
+        window->filled++;
+    }
+
+    window->bucket_min[pos] = window->cur_min;
+    window->bucket_max[pos] = window->cur_max;
+    window->bucket_sum[pos] = window->cur_sum;
+    window->total += window->cur_sum;
+
+    while ((window->min_len > 0) &&
+           (window->bucket_min[window->min_queue[(window->min_head + window->min_len - 1) % count]] >= window->cur_min)) {
+        window->min_len--;
+    }
+    window->min_queue[(window->min_head + window->min_len) % count] = pos;
+    window->min_len++;
+
+    while ((window->max_len > 0) &&
+           (window->bucket_max[window->max_queue[(window->max_head + window->max_len - 1) % count]] <= window->cur_max)) {
+        window->max_len--;
+    }
+    window->max_queue[(window->max_head + window->max_len) % count] = pos;
+    window->max_len++;
+
+    window->pos     = (uint8_t)((pos + 1) % count);
+    window->cur_sum = 0;
+    window->cur_n   = 0;
+}
@@ -0,0 +1,163 @@
+/**
+ ******************************************************************************
+ * @file        env_history.h
+ * @author      Mahmoud Mahmoud, Judy Abou Rmeh
+ * @version     V1.0
+ * @date        14.10.2026
+ * @brief       Zeitreihen-Speicher für Umweltmesswerte
+ *
+ * @details
+ * Eine env_history_series_t Instanz speichert eine Messgröße (z. B.
+ * Temperatur in 0,01 Grad C aus env_sensor_get_data_fixed()):
+ *
+ *  - Verlauf: die letzten ENV_HISTORY_LENGTH Werte, delta-kodiert als
+ *    int16 in einem Ring (älteste und neueste Werte als int32)
+ *  - Fenster 1 min, 1 h, 24 h: Minimum, Maximum und Mittelwert, bei jedem
+ *    neuen Wert in O(1) fortgeschrieben
+ *
+ * Je Fenster werden die Werte in Buckets zusammengefasst (min/max/Summe);
+ * Minimum und Maximum der abgeschlossenen Buckets liefern monotone
+ * Deques, die Summe wird beim Überschreiben des ältesten Buckets
+ * korrigiert. Ein Fenster umfasst alle abgeschlossenen Buckets plus den
+ * laufenden, also bis zu einem Bucket mehr als die Fensterlänge.
+ *
+ * Die Fensterlängen setzen voraus, dass env_history_add() alle
+ * ENV_HISTORY_SAMPLE_MS aufgerufen wird.
+ *
+ ******************************************************************************
+ */
+
+#ifndef ENV_HISTORY_ENV_HISTORY_H_
+#define ENV_HISTORY_ENV_HISTORY_H_
+
+#include "stm32f4xx.h"
+
+/* Public Preprocessor defines */
+
+/**
+ * @brief Abstand der Werte in Millisekunden (Grundlage der Fenster)
+ */
+#define ENV_HISTORY_SAMPLE_MS        1000
+
+/**
+ * @brief Länge des Verlaufs (ein Wert je Pixelspalte des LCD)
+ */
+#define ENV_HISTORY_LENGTH           240
+
+/**
+ * @brief Maximale Anzahl Buckets eines Fensters (höchstens 255)
+ */
+#define ENV_HISTORY_MAX_BUCKETS      96
+
+/* Public type definitions */
+
+/**
+ * @brief Auswertefenster
+ */
+typedef enum {
+    ENV_HISTORY_WINDOW_1MIN = 0,  /**< 60 Buckets zu 1 Wert     */
+    ENV_HISTORY_WINDOW_1H,        /**< 60 Buckets zu 1 min      */
+    ENV_HISTORY_WINDOW_24H,       /**< 96 Buckets zu 15 min     */
+    ENV_HISTORY_WINDOW_COUNT
+} env_history_window_id_t;
+
+/**
+ * @brief Auswertung eines Fensters
+ */
+typedef struct {
+    int32_t  min;
+    int32_t  max;
+    int32_t  mean;
+    uint32_t count;  /**< Anzahl Werte im Fenster */
+} env_history_stats_t;
+
+/**
+ * @brief Fenster mit Buckets und monotonen Deques (Ringpositionen)
+ */
+typedef struct {
+    int32_t  bucket_min[ENV_HISTORY_MAX_BUCKETS];
+    int32_t  bucket_max[ENV_HISTORY_MAX_BUCKETS];
+    int32_t  bucket_sum[ENV_HISTORY_MAX_BUCKETS];
+    uint8_t  min_queue[ENV_HISTORY_MAX_BUCKETS];  /**< Minima aufsteigend  */
+    uint8_t  max_queue[ENV_HISTORY_MAX_BUCKETS];  /**< Maxima absteigend   */
+    uint8_t  min_head;
+    uint8_t  min_len;
+    uint8_t  max_head;
+    uint8_t  max_len;
+    uint8_t  pos;             /**< Nächster Bucket im Ring */
+    uint8_t  filled;          /**< Abgeschlossene Buckets  */
+    uint8_t  bucket_count;
+    uint16_t bucket_samples;
+    int64_t  total;           /**< Summe der abgeschlossenen Buckets */
+    int32_t  cur_min;         /**< Laufender Bucket                  */
+    int32_t  cur_max;
+    int32_t  cur_sum;
+    uint16_t cur_n;
+} env_history_window_t;
+
+/**
+ * @brief Zeitreihe einer Messgröße
+ */
+typedef struct {
+    int16_t  delta[ENV_HISTORY_LENGTH];  /**< Wert minus Vorgänger */
+    int32_t  oldest;
+    int32_t  newest;
+    uint16_t head;                       /**< Nächster Ringplatz   */
+    uint16_t count;
+    env_history_window_t window[ENV_HISTORY_WINDOW_COUNT];
+} env_history_series_t;
+
+/* Public functions (prototypes) */
+
+/**
+ * @brief   Initialisiert eine Zeitreihe (leer)
+ *
+ * @param   series Instanz
+ * @return  None
+ */
+void env_history_init(env_history_series_t *series);
+
+/**
+ * @brief   Fügt einen Wert hinzu und schreibt alle Fenster fort
+ *
+ * @details
+ * Sprünge größer als int16 werden auf ±32767 begrenzt; Verlauf und
+ * Fenster verwenden den so gespeicherten Wert.
+ *
+ * @param   series Instanz
+ * @param   value  Messwert (Festkomma)
+ * @return  None
+ */
+void env_history_add(env_history_series_t *series, int32_t value);
+
+/**
+ * @brief   Liefert Minimum, Maximum und Mittelwert eines Fensters
+ *
+ * @param   series Instanz
+ * @param   window Fenster
+ * @param   stats  Auswertung
+ * @return  HAL_OK, HAL_ERROR ohne Werte oder bei ungültigem Fenster
+ */
+HAL_StatusTypeDef env_history_get_stats(const env_history_series_t *series,
+                                        env_history_window_id_t window,
+                                        env_history_stats_t *stats);
+
+/**
+ * @brief   Dekodiert den Verlauf, neuester Wert zuerst
+ *
+ * @param   series Instanz
+ * @param   values Zielpuffer
+ * @param   max    Größe des Zielpuffers
+ * @return  Anzahl geschriebener Werte
+ */
+uint16_t env_history_read(const env_history_series_t *series, int32_t *values, uint16_t max);
+
+/**
+ * @brief   Liefert den neuesten Wert
+ *
+ * @param   series Instanz
+ * @return  Neuester Wert, 0 ohne Werte
+ */
+int32_t env_history_get_latest(const env_history_series_t *series);
+
+#endif /* ENV_HISTORY_ENV_HISTORY_H_ */
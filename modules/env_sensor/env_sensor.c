@@ -4,42 +4,232 @@
  * @author      Mahmoud Mahmoud, Judy Abou Rmeh
  * @version     V1.0
  * @date        14.03.2019
- * @brief       Implementierung des Umweltsensor-Moduls (BME280 über I2C)
+ * @brief       Implementierung des Umweltsensor-Moduls (BME280 über I2C/SPI)
  *
  * @details
- * Dieses Modul initialisiert die I2C-Schnittstelle (GPIO + I2C1) sowie den
- * Umweltsensor (BME280) und stellt Funktionen zum Auslesen von Temperatur,
- * Luftdruck und Luftfeuchtigkeit bereit.
+ * Dieses Modul initialisiert die I2C-Schnittstellen (GPIO + I2C1/I2C3)
+ * sowie die Umweltsensoren (BME280) und stellt Funktionen zum Auslesen
+ * von Temperatur, Luftdruck und Luftfeuchtigkeit bereit.
  *
  * Verwendete Module:
  *  - bme280
+ *  - osal (Warten auf das Transferende, im RTOS-Build blockierend)
  *
  * Verwendete Peripherie / Ressourcen:
- *  - I2C1
+ *  - I2C1 (Fast-Mode 400 kHz, Event-/Error-Interrupt)
+ *  - DMA1 Stream 0 Channel 1 (I2C1_RX, über dma_alloc) für den Burst-Read
+ *    der Messdaten
  *  - GPIOB Pin 6 (SCL), GPIOB Pin 7 (SDA) im Alternate Function Mode (AF4)
+ *  - Optional I2C3 mit DMA1 Stream 2 Channel 3 (I2C3_RX),
+ *    GPIOA Pin 8 (SCL), GPIOC Pin 9 (SDA) (AF4)
+ *  - Optional SPI-Busse der Anwendung (DMA-Transfers, wenn beide
+ *    DMA-Handles verknüpft sind, sonst Interrupt-Transfers)
+ *  - Optional SPI5 gemeinsam mit dem LCD (Arbiter von
+ *    ILI9341_STM32_Driver, SPI5 RX/TX DMA des LCD-Treibers)
+ *  - Backup-SRAM (BKPSRAM) für den Warmstart, ENV_SENSOR_MAX_SENSORS
+ *    Einträge ab BKPSRAM_BASE (darüber der Trace-Ring von modules/bkptrace)
+ *
+ * Alle Buszugriffe laufen über Interrupt bzw. DMA. Die Zugriffe der
+ * BME280 Library (Init, Einstellungen) warten auf das Transferende,
+ * der Burst-Read der Messdaten läuft im Hintergrund.
+ *
+ * Je Bus läuft höchstens ein Transfer. Sensoren, die den Bus brauchen,
+ * setzen ein Anforderungsbit; am Transferende startet der Interrupt
+ * direkt den nächsten angeforderten Transfer desselben Busses. Weitere
+ * Bausteine an einem I2C-Bus (env_sensor_i2c_attach(), z. B. der
+ * Touch-Controller an I2C3) reihen sich mit ihren Registerzugriffen
+ * dort ebenfalls ein, vor den Sensoren.
+ *
+ * Fehler eines I2C-Busses begrenzen die Wartezeit statt sie zu
+ * wiederholen: vor jedem Start wird höchstens ENV_SENSOR_BUSY_WAIT_US auf
+ * das Ende des vorigen STOP gewartet (die HAL wartet 25 ms), ein Transfer
+ * ohne Ende wird nach ENV_SENSOR_XFER_TIMEOUT_MS aus env_sensor_step()
+ * abgebrochen. Danach startet bis zum Ende der Wartezeit (exponentiell,
+ * ENV_SENSOR_BACKOFF_MIN_MS .. ENV_SENSOR_BACKOFF_MAX_MS) kein Transfer
+ * auf dem Bus; ein hängender Bus wird vor dem nächsten Versuch per GPIO
+ * freigetaktet (9 SCL-Takte, STOP) und die Peripherie zurückgesetzt.
  *
  ******************************************************************************
  */
 
 /* Includes */
+#include <stddef.h>
+#include <string.h>
 #include "env_sensor.h"
+#include <utils/utils.h>
+#include <profile/profile.h>
+#include <health/health.h>
+#include <dma_alloc/dma_alloc.h>
+#include <datalog/datalog.h>
+#include <params/params.h>
+#include <clock/clock.h>
+#include <bkptrace/bkptrace.h>
+#if ENV_SENSOR_SPI_ENABLE
+#include <lcd/ILI9341_STM32_Driver.h>
+#endif
+
+#if (ENV_SENSOR_I2C_IRQ_PRIORITY < OSAL_IRQ_PRIORITY_MIN)
+#error "ENV_SENSOR_I2C_IRQ_PRIORITY must allow kernel calls (OSAL_IRQ_PRIORITY_MIN)"
+#endif
+
+/* Private defines */
+
+/* Anforderungen an den Bus (env_sensor_t.pending) */
+#define ENV_SENSOR_REQ_START   0x01  /* ctrl_meas mit Forced-Mode schreiben */
+#define ENV_SENSOR_REQ_BURST   0x02  /* Status + Daten lesen                */
+
+/* Zustand des Burst-Reads (env_sensor_t.meas_reading) */
+#define ENV_SENSOR_BURST_NONE    0
+#define ENV_SENSOR_BURST_PENDING 1
+#define ENV_SENSOR_BURST_ACTIVE  2
+#define ENV_SENSOR_BURST_DONE    3
+
+/* Maximale Länge eines Library-Zugriffs über SPI (Kalibrierdaten) */
+#if ENV_SENSOR_SPI_ENABLE
+#define ENV_SENSOR_SPI_MAX_LEN   32
+#else
+#define ENV_SENSOR_SPI_MAX_LEN   0
+#endif
+
+/* Kennung gültiger Warmstart-Einträge ("B280") */
+#define ENV_SENSOR_CACHE_MAGIC   0x42323830UL
+
+/* Warmstart-Einträge im Backup-SRAM */
+#define ENV_SENSOR_CACHE         ((env_sensor_cache_t *)BKPSRAM_BASE)
+
+/* Private type definitions */
+
+/**
+ * @brief Ein Bus (I2C-Peripherie oder SPI-Handle der Anwendung)
+ */
+typedef struct env_sensor_bus_s {
+    I2C_HandleTypeDef     i2c_handle;
+    DMA_HandleTypeDef     dma_rx_handle;
+    SPI_HandleTypeDef    *spi;
+    env_sensor_t *volatile owner;  /* Sensor des laufenden Transfers */
+    env_sensor_i2c_client_t *volatile client;  /* Bzw. weiterer Teilnehmer */
+    osal_event_t          free_event;  /* Bus wieder frei (owner = NULL) */
+    uint8_t               ready;
+    uint32_t              xfer_tick;     /* Start des laufenden Transfers  */
+    uint32_t              backoff_tick;  /* Beginn der Wartezeit           */
+    uint16_t              backoff_ms;    /* 0 = kein Transfer gesperrt     */
+    uint8_t               failures;      /* Fehler in Folge                */
+    uint32_t              errors;
+    uint32_t              timeouts;
+    uint32_t              recoveries;
+#if ENV_SENSOR_SPI_ENABLE
+    ILI9341_Bus_Client_t  lcd_client;    /* SPI5: Teilnehmer am LCD-Arbiter */
+    uint8_t              *spi_data;      /* SPI5: Transfer bis zum Grant    */
+    uint16_t              spi_len;
+    uint8_t               shared;        /* 1: SPI5 gemeinsam mit dem LCD   */
+    volatile uint8_t      granted;       /* 1: in Grant/Done des Arbiters   */
+#endif
+} env_sensor_bus_t;
+
+/**
+ * @brief Warmstart-Eintrag eines Sensors (Backup-SRAM)
+ */
+typedef struct {
+    uint32_t                 magic;
+    uint32_t                 key;       /* Anschluss des Sensors   */
+    uint8_t                  chip_id;
+    struct bme280_settings   settings;  /* Einstellungen der Init  */
+    struct bme280_calib_data calib;
+    uint32_t                 checksum;  /* FNV-1a über alle Felder */
+} env_sensor_cache_t;
+
+/* Die Warmstart-Einträge liegen unter dem Trace-Ring von modules/bkptrace */
+_Static_assert(sizeof(env_sensor_cache_t) * ENV_SENSOR_MAX_SENSORS <= BKPTRACE_BKPSRAM_OFFSET,
+               "Warmstart-Einträge überlappen den Trace-Ring im Backup-SRAM");
 
 /* Static module variables */
-static I2C_HandleTypeDef i2c_handle;
+static env_sensor_bus_t i2c1_bus;
+static env_sensor_bus_t i2c3_bus;
+#if ENV_SENSOR_SPI_ENABLE
+static env_sensor_bus_t spi_buses[ENV_SENSOR_MAX_SPI_BUSES];
+static uint8_t spi_bus_count = 0;
+#endif
+
+/* Angemeldete Sensoren */
+static env_sensor_t *sensors[ENV_SENSOR_MAX_SENSORS];
+static volatile uint8_t sensor_count = 0;
+
+/* Weitere Teilnehmer der I2C-Busse */
+static env_sensor_i2c_client_t *i2c_clients[ENV_SENSOR_MAX_I2C_CLIENTS];
+static volatile uint8_t i2c_client_count = 0;
+
+/* Eingebauter Sensor der Funktionen ohne Instanz */
+static env_sensor_t default_sensor;
+
+static const env_sensor_config_t default_config = {
+    .i2c      = I2C1,
+    .i2c_addr = BME280_I2C_ADDR_SEC,
+    .spi      = NULL,
+    .cs_port  = NULL,
+    .cs_pin   = 0,
+};
+
+/* Puffer der synchronen SPI-Zugriffe (nur aus der Hauptschleife) */
+static uint8_t spi_buffer[ENV_SENSOR_SPI_MAX_LEN + 1];
+
+/* Backup-SRAM freigeschaltet */
+static uint8_t cache_ready = 0;
 
-static struct bme280_dev dev;
-static struct bme280_data sensor_data;
-static struct bme280_settings settings;
+/* env_sensor_datalog_filter(): Kalibrierung und letzte Roh-Temperatur des laufenden Dumps */
+static struct bme280_calib_data filter_calib;
+static uint32_t filter_raw_temperature;
+static uint8_t filter_has_temperature = 0;
 
 /* Static module functions (prototypes) */
-static void env_sensor_init_gpio(void);
-static void env_sensor_init_i2c(void);
-static void env_sensor_bme280_init(void);
+static env_sensor_bus_t *env_sensor_get_bus(const env_sensor_config_t *config);
+static void env_sensor_init_gpio(I2C_TypeDef *instance);
+static void env_sensor_init_i2c(env_sensor_bus_t *bus, I2C_TypeDef *instance);
+static HAL_StatusTypeDef env_sensor_bme280_init(env_sensor_t *sensor);
+static void env_sensor_default_settings(struct bme280_settings *settings);
+static HAL_StatusTypeDef env_sensor_cold_init(env_sensor_t *sensor);
+static uint8_t env_sensor_warm_init(env_sensor_t *sensor);
+static void env_sensor_cache_enable(void);
+#if ENV_SENSOR_WARM_START
+static uint32_t env_sensor_cache_key(const env_sensor_config_t *config);
+static uint32_t env_sensor_cache_sum(const env_sensor_cache_t *record);
+static const env_sensor_cache_t *env_sensor_cache_find(uint32_t key);
+#endif
+static void env_sensor_cache_store(const env_sensor_t *sensor);
 
 static void env_sensor_delay_us(uint32_t period, void *intf_ptr);
+static int8_t env_sensor_wait(env_sensor_t *sensor);
+static int8_t env_sensor_claim(env_sensor_t *sensor);
+static void env_sensor_request(env_sensor_t *sensor, uint8_t request);
+static void env_sensor_bus_next(env_sensor_bus_t *bus);
+static HAL_StatusTypeDef env_sensor_bus_start(env_sensor_bus_t *bus, env_sensor_t *sensor, uint8_t request);
+static HAL_StatusTypeDef env_sensor_i2c_start(env_sensor_bus_t *bus, env_sensor_i2c_client_t *client);
+static void env_sensor_bus_done(env_sensor_bus_t *bus, uint8_t error);
+static HAL_StatusTypeDef env_sensor_spi_transfer(env_sensor_bus_t *bus, uint8_t *tx, uint8_t *rx, uint16_t len);
+static uint8_t env_sensor_bus_idle(const env_sensor_bus_t *bus);
+static void env_sensor_bus_failed(env_sensor_bus_t *bus);
+static void env_sensor_bus_service(env_sensor_bus_t *bus);
+static void env_sensor_bus_hang(env_sensor_bus_t *bus);
+static void env_sensor_bus_irq(const env_sensor_bus_t *bus, uint8_t enable);
+static void env_sensor_bus_recover(env_sensor_bus_t *bus);
+#if ENV_SENSOR_SPI_ENABLE
+static void env_sensor_spi_done(SPI_HandleTypeDef *hspi, uint8_t error);
+static void env_sensor_lcd_grant(ILI9341_Bus_Client_t *client);
+static void env_sensor_lcd_done(ILI9341_Bus_Client_t *client);
+#endif
+static HAL_StatusTypeDef env_sensor_take(env_sensor_t *sensor);
+static void env_sensor_copy_float(const env_sensor_t *sensor, float *temperature, float *pressure, float *humidity);
+static void env_sensor_copy_fixed(const env_sensor_t *sensor, int32_t *centi_celsius, uint32_t *pascal, uint32_t *milli_rh);
+static void env_sensor_data_fixed(const struct bme280_data *data, int32_t *centi_celsius, uint32_t *pascal,
+                                  uint32_t *milli_rh);
+static void env_sensor_unpack(const uint8_t *raw, struct bme280_uncomp_data *uncomp_data);
+static void env_sensor_parse_burst(env_sensor_t *sensor);
+static void env_sensor_compensate(env_sensor_t *sensor);
+static void env_sensor_osr_settings(const env_sensor_t *sensor, struct bme280_settings *settings);
+static void env_sensor_osr_plan(env_sensor_t *sensor);
+static void env_sensor_osr_adapt(env_sensor_t *sensor);
 
-static int8_t env_sensor_i2c_read(uint8_t reg_addr, uint8_t *data, uint32_t len, void *intf_ptr);
-static int8_t env_sensor_i2c_write(uint8_t reg_addr, const uint8_t *data, uint32_t len, void *intf_ptr);
+static int8_t env_sensor_bus_read(uint8_t reg_addr, uint8_t *data, uint32_t len, void *intf_ptr);
+static int8_t env_sensor_bus_write(uint8_t reg_addr, const uint8_t *data, uint32_t len, void *intf_ptr);
 
 /* Public functions */
 
@@ -55,16 +245,14 @@ static int8_t env_sensor_i2c_write(uint8_t reg_addr, const uint8_t *data, uint32
  */
 void env_sensor_init(void)
 {
-    env_sensor_init_gpio();
-    env_sensor_init_i2c();
-    env_sensor_bme280_init();
+    env_sensor_add(&default_sensor, &default_config);
 }
 
 /**
  * @brief   Liest Messwerte des Umweltsensors aus
  *
  * @details
- * Setzt den BME280 in den Forced-Mode, wartet bis die Messung abgeschlossen ist
+ * Setzt den BME280 in den Forced-Mode, wartet die berechnete Messzeit ab
  * und liest anschließend Temperatur, Luftdruck und Luftfeuchtigkeit aus.
  *
  * @param   temperature Zeiger auf die Temperatur in Grad Celsius
@@ -75,173 +263,2377 @@ void env_sensor_init(void)
  */
 void env_sensor_read_data(float *temperature, float *pressure, float *humidity)
 {
-    bme280_set_sensor_mode(BME280_POWERMODE_FORCED, &dev);
-    dev.delay_us(50000, dev.intf_ptr);
+    env_sensor_t *sensor = &default_sensor;
 
-    bme280_get_sensor_data(BME280_ALL, &sensor_data, &dev);
+    PROFILE_BEGIN(PROFILE_ZONE_ENV_READ);
 
-    *temperature = sensor_data.temperature;
-    *pressure    = sensor_data.pressure;
-    *humidity    = sensor_data.humidity;
-}
+    if (env_sensor_measure(sensor) == HAL_OK) {
+        if (!sensor->normal_mode) {
+            sensor->dev.delay_us(sensor->meas_delay_ms * 1000, sensor->dev.intf_ptr);
+        }
 
-/* Static module functions (implementation) */
+        while (env_sensor_step(sensor) == ENV_SENSOR_BUSY) {
+            /* Transferende oder nächste Millisekunde */
+            osal_event_wait(&sensor->done_event, 1);
+        }
+    }
+
+    /* Bei Fehlern werden die Werte der letzten Messung geliefert */
+    if (env_sensor_fetch(sensor, temperature, pressure, humidity) != HAL_OK) {
+        env_sensor_copy_float(sensor, temperature, pressure, humidity);
+    }
+
+    PROFILE_END(PROFILE_ZONE_ENV_READ);
+}
 
 /**
- * @brief   Initialisiert die GPIOs für I2C (SCL/SDA)
+ * @brief   Startet eine Messung im Forced-Mode, ohne zu warten
  *
- * @details
- * Aktiviert den GPIOB-Clock und konfiguriert PB6/PB7 als Alternate Function
- * Open-Drain mit Pull-Up für I2C1 (AF4).
+ * @param   None
+ * @return  HAL_OK, HAL_BUSY oder HAL_ERROR
+ */
+HAL_StatusTypeDef env_sensor_start_measurement(void)
+{
+    return env_sensor_measure(&default_sensor);
+}
+
+/**
+ * @brief   Schreitet die laufende Messung fort
  *
  * @param   None
+ * @return  Aktueller Zustand
+ */
+env_sensor_state_t env_sensor_poll(void)
+{
+    return env_sensor_step(&default_sensor);
+}
+
+/**
+ * @brief   Holt die Messwerte der letzten abgeschlossenen Messung ab
+ *
+ * @param   temperature Zeiger auf die Temperatur in Grad Celsius
+ * @param   pressure    Zeiger auf den Luftdruck in hPa
+ * @param   humidity    Zeiger auf die relative Luftfeuchtigkeit in Prozent
+ *
+ * @return  HAL_OK, HAL_BUSY oder HAL_ERROR
+ */
+HAL_StatusTypeDef env_sensor_get_data(float *temperature, float *pressure, float *humidity)
+{
+    return env_sensor_fetch(&default_sensor, temperature, pressure, humidity);
+}
+
+/**
+ * @brief   Holt die Messwerte der letzten Messung als Festkommawerte ab
+ *
+ * @param   centi_celsius Temperatur in 0,01 Grad Celsius
+ * @param   pascal        Luftdruck in Pa
+ * @param   milli_rh      Relative Luftfeuchtigkeit in 0,001 %
+ *
+ * @return  HAL_OK, HAL_BUSY oder HAL_ERROR
+ */
+HAL_StatusTypeDef env_sensor_get_data_fixed(int32_t *centi_celsius, uint32_t *pascal, uint32_t *milli_rh)
+{
+    return env_sensor_fetch_fixed(&default_sensor, centi_celsius, pascal, milli_rh);
+}
+
+/**
+ * @brief   Setzt den Callback für abgeschlossene Messungen
+ *
+ * @param   cb Funktion oder NULL
  * @return  None
  */
-static void env_sensor_init_gpio(void)
+void env_sensor_set_callback(env_sensor_callback_t cb)
 {
-    __HAL_RCC_GPIOB_CLK_ENABLE();
+    default_sensor.callback = cb;
+}
 
-    GPIO_InitTypeDef gpio_i2c_init;
+/**
+ * @brief   Startet die kontinuierliche Messung im Normal-Mode
+ *
+ * @param   standby_time BME280_STANDBY_TIME_0_5_MS .. BME280_STANDBY_TIME_20_MS
+ * @return  HAL_OK oder HAL_ERROR
+ */
+HAL_StatusTypeDef env_sensor_start_normal(uint8_t standby_time)
+{
+    return env_sensor_set_normal(&default_sensor, standby_time);
+}
 
-    gpio_i2c_init.Pin       = GPIO_PIN_6 | GPIO_PIN_7;
-    gpio_i2c_init.Mode      = GPIO_MODE_AF_OD;
-    gpio_i2c_init.Pull      = GPIO_PULLUP;
-    gpio_i2c_init.Speed     = GPIO_SPEED_FREQ_MEDIUM;
-    gpio_i2c_init.Alternate = GPIO_AF4_I2C1;
+/**
+ * @brief   Beendet den Normal-Mode (Sleep-Mode, weiter mit Forced-Mode)
+ *
+ * @param   None
+ * @return  HAL_OK oder HAL_ERROR
+ */
+HAL_StatusTypeDef env_sensor_stop_normal(void)
+{
+    return env_sensor_set_forced(&default_sensor);
+}
+
+/**
+ * @brief   Liefert die Messzeit für das eingestellte Oversampling
+ *
+ * @param   None
+ * @return  Messzeit in Millisekunden
+ */
+uint32_t env_sensor_get_meas_delay_ms(void)
+{
+    return default_sensor.meas_delay_ms;
+}
+
+/**
+ * @brief   Initialisiert einen Sensor und meldet ihn beim Scheduler an
+ *
+ * @param   sensor Instanz
+ * @param   config Anschluss
+ * @return  HAL_OK oder HAL_ERROR
+ */
+HAL_StatusTypeDef env_sensor_add(env_sensor_t *sensor, const env_sensor_config_t *config)
+{
+    if ((sensor == NULL) || (config == NULL) || (sensor_count >= ENV_SENSOR_MAX_SENSORS)) {
+        return HAL_ERROR;
+    }
+
+    for (uint8_t i = 0; i < sensor_count; i++) {
+        if (sensors[i] == sensor) {
+            return HAL_ERROR;
+        }
+    }
+
+    sensor->config        = *config;
+    sensor->bus           = env_sensor_get_bus(config);
+    osal_event_init(&sensor->done_event);
+    sensor->state         = ENV_SENSOR_IDLE;
+    sensor->callback      = NULL;
+    sensor->meas_delay_ms = 50;
+    sensor->meas_reading  = ENV_SENSOR_BURST_NONE;
+    sensor->pending       = 0;
+    sensor->normal_mode   = 0;
+    sensor->raw_pending   = 0;
+    sensor->has_good      = 0;
+    sensor->degraded      = 0;
+    memset(&sensor->osr, 0, sizeof(sensor->osr));
+    env_sensor_reset_stats(sensor);
+
+    if (sensor->bus == NULL) {
+        return HAL_ERROR;
+    }
 
-    HAL_GPIO_Init(GPIOB, &gpio_i2c_init);
+    if (config->i2c == NULL) {
+        /* Chip-Select, inaktiv high */
+        GPIO_InitTypeDef gpio_cs_init;
+
+        gpio_cs_init.Pin   = config->cs_pin;
+        gpio_cs_init.Mode  = GPIO_MODE_OUTPUT_PP;
+        gpio_cs_init.Pull  = GPIO_NOPULL;
+        gpio_cs_init.Speed = GPIO_SPEED_FREQ_HIGH;
+        HAL_GPIO_WritePin(config->cs_port, config->cs_pin, GPIO_PIN_SET);
+        HAL_GPIO_Init(config->cs_port, &gpio_cs_init);
+    }
+
+    if (env_sensor_bme280_init(sensor) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    sensors[sensor_count] = sensor;
+    __DMB();
+    sensor_count++;
+
+    return HAL_OK;
 }
 
 /**
- * @brief   Initialisiert I2C1
+ * @brief   Startet eine Messung eines Sensors
  *
  * @details
- * Aktiviert den I2C1-Clock und konfiguriert I2C mit 100 kHz, 7-bit Addressing
- * und Standard-Einstellungen (kein Dual-Address, kein General Call).
+ * Forced-Mode: ctrl_meas wird angefordert und geschrieben, sobald der
+ * Bus frei ist. Normal-Mode: nur der Burst-Read wird angefordert.
  *
- * @param   None
+ * @param   sensor Instanz
+ * @return  HAL_OK, HAL_BUSY oder HAL_ERROR
+ */
+HAL_StatusTypeDef env_sensor_measure(env_sensor_t *sensor)
+{
+    if (sensor->state == ENV_SENSOR_BUSY) {
+        return HAL_BUSY;
+    }
+
+    sensor->error = 0;
+    sensor->meas_start_tick = HAL_GetTick();
+    sensor->state = ENV_SENSOR_BUSY;
+
+    /* Normal-Mode: der Sensor misst selbst, nur den letzten Wert lesen */
+    if (sensor->normal_mode) {
+        sensor->meas_reading = ENV_SENSOR_BURST_PENDING;
+        env_sensor_request(sensor, ENV_SENSOR_REQ_BURST);
+        return HAL_OK;
+    }
+
+    /* ctrl_meas mit Forced-Mode, ctrl_hum ist seit der Init gesetzt.
+     * Nach der Messung steht der Sensor wieder so, wie der
+     * Register-Schatten der Library ihn kennt (Sleep-Mode). */
+    struct bme280_settings settings;
+
+    env_sensor_osr_settings(sensor, &settings);
+    sensor->ctrl_meas[0] = BME280_REG_CTRL_MEAS & 0x7F;
+    sensor->ctrl_meas[1] = (uint8_t)((settings.osr_t << 5) |
+                                     (settings.osr_p << 2) |
+                                     BME280_POWERMODE_FORCED);
+    sensor->dev.shadow_regs[BME280_SHADOW_CTRL_MEAS] =
+        BME280_SET_BITS_POS_0(sensor->ctrl_meas[1], BME280_SENSOR_MODE, BME280_POWERMODE_SLEEP);
+    sensor->done         = 0;
+    sensor->meas_reading = ENV_SENSOR_BURST_NONE;
+    env_sensor_request(sensor, ENV_SENSOR_REQ_START);
+
+    return HAL_OK;
+}
+
+/**
+ * @brief   Schreitet die Messung eines Sensors fort
+ *
+ * @details
+ * Vor Ablauf der Messzeit wird nicht auf den Bus zugegriffen. Danach
+ * wird der Burst-Read angefordert; im Forced-Mode wird das
+ * Measuring-Bit im Statusregister geprüft, damit eine langsamere
+ * Messung nicht zu alten Daten führt.
+ *
+ * @param   sensor Instanz
+ * @return  Aktueller Zustand
+ */
+env_sensor_state_t env_sensor_step(env_sensor_t *sensor)
+{
+    /* Abgebrochene Transfers, Ende der Wartezeit (beide I2C-Busse, auch
+     * für die weiteren Teilnehmer) */
+    env_sensor_bus_service(&i2c1_bus);
+    env_sensor_bus_service(&i2c3_bus);
+
+    if (sensor->state != ENV_SENSOR_BUSY) {
+        return sensor->state;
+    }
+
+    /* Bus in der Wartezeit: Fehler sofort statt erst nach dem nächsten
+     * Versuch (env_sensor_read_data() u. a. blockieren nicht) */
+    if (sensor->pending && (sensor->bus->backoff_ms != 0)) {
+        sensor->error = 1;
+    }
+
+    if (sensor->error) {
+        sensor->pending      = 0;
+        sensor->meas_reading = ENV_SENSOR_BURST_NONE;
+        sensor->state        = ENV_SENSOR_ERROR;
+        return sensor->state;
+    }
+
+    switch (sensor->meas_reading) {
+    case ENV_SENSOR_BURST_NONE:
+        if (((HAL_GetTick() - sensor->meas_start_tick) < sensor->meas_delay_ms) ||
+            !sensor->done) {
+            return sensor->state;
+        }
+        sensor->meas_reading = ENV_SENSOR_BURST_PENDING;
+        env_sensor_request(sensor, ENV_SENSOR_REQ_BURST);
+        return sensor->state;
+
+    case ENV_SENSOR_BURST_DONE:
+        break;
+
+    default:
+        return sensor->state;
+    }
+
+    /* Forced-Mode, Messung noch nicht fertig: Burst wiederholen. Im
+     * Normal-Mode sind die Datenregister immer gültig (Shadowing). */
+    if (!sensor->normal_mode &&
+        (sensor->burst[(sensor->config.i2c == NULL) ? 1 : 0] & BME280_STATUS_MEAS_DONE)) {
+        sensor->meas_reading = ENV_SENSOR_BURST_PENDING;
+        env_sensor_request(sensor, ENV_SENSOR_REQ_BURST);
+        return sensor->state;
+    }
+
+    env_sensor_parse_burst(sensor);
+    if (!sensor->normal_mode && sensor->osr.enabled) {
+        env_sensor_osr_adapt(sensor);
+    }
+    sensor->meas_reading = ENV_SENSOR_BURST_NONE;
+    sensor->good_tick    = HAL_GetTick();
+    sensor->has_good     = 1;
+    sensor->state        = ENV_SENSOR_READY;
+
+    if (sensor->callback != NULL) {
+        sensor->callback(sensor);
+    }
+
+    return sensor->state;
+}
+
+/**
+ * @brief   Holt die Messwerte eines Sensors ab
+ *
+ * @param   sensor      Instanz
+ * @param   temperature Temperatur in Grad Celsius
+ * @param   pressure    Luftdruck in hPa
+ * @param   humidity    Relative Luftfeuchtigkeit in Prozent
+ * @return  HAL_OK, HAL_BUSY oder HAL_ERROR
+ */
+HAL_StatusTypeDef env_sensor_fetch(env_sensor_t *sensor, float *temperature, float *pressure, float *humidity)
+{
+    HAL_StatusTypeDef status = env_sensor_take(sensor);
+
+    if (status == HAL_OK) {
+        env_sensor_copy_float(sensor, temperature, pressure, humidity);
+    }
+
+    return status;
+}
+
+/**
+ * @brief   Holt die Messwerte eines Sensors als Festkommawerte ab
+ *
+ * @param   sensor        Instanz
+ * @param   centi_celsius Temperatur in 0,01 Grad Celsius
+ * @param   pascal        Luftdruck in Pa
+ * @param   milli_rh      Relative Luftfeuchtigkeit in 0,001 %
+ * @return  HAL_OK, HAL_BUSY oder HAL_ERROR
+ */
+HAL_StatusTypeDef env_sensor_fetch_fixed(env_sensor_t *sensor, int32_t *centi_celsius,
+                                         uint32_t *pascal, uint32_t *milli_rh)
+{
+    HAL_StatusTypeDef status = env_sensor_take(sensor);
+
+    if (status == HAL_OK) {
+        env_sensor_copy_fixed(sensor, centi_celsius, pascal, milli_rh);
+    }
+
+    return status;
+}
+
+/**
+ * @brief   Setzt den Callback eines Sensors
+ *
+ * @param   sensor Instanz
+ * @param   cb     Funktion oder NULL
  * @return  None
  */
-static void env_sensor_init_i2c(void)
+void env_sensor_set_sensor_callback(env_sensor_t *sensor, env_sensor_callback_t cb)
+{
+    sensor->callback = cb;
+}
+
+/**
+ * @brief   Schaltet einen Sensor in den Normal-Mode
+ *
+ * @details
+ * Standby-Zeit (config), Oversampling der Init und Normal-Mode
+ * (ctrl_meas) gehen in einem Burst-Write über die Library, die
+ * aktuellen Registerwerte kommen aus ihrem Register-Schatten. Eine
+ * laufende Messung wird zu Ende geführt.
+ *
+ * @param   sensor       Instanz
+ * @param   standby_time BME280_STANDBY_TIME_0_5_MS .. BME280_STANDBY_TIME_20_MS
+ * @return  HAL_OK oder HAL_ERROR
+ */
+HAL_StatusTypeDef env_sensor_set_normal(env_sensor_t *sensor, uint8_t standby_time)
 {
-    __HAL_RCC_I2C1_CLK_ENABLE();
+    while (env_sensor_step(sensor) == ENV_SENSOR_BUSY) {
+        osal_event_wait(&sensor->done_event, 1);
+    }
 
-    i2c_handle.Instance             = I2C1;
-    i2c_handle.Init.ClockSpeed      = 100000;
-    i2c_handle.Init.DutyCycle       = I2C_DUTYCYCLE_2;
-    i2c_handle.Init.OwnAddress1     = 0;
-    i2c_handle.Init.AddressingMode  = I2C_ADDRESSINGMODE_7BIT;
-    i2c_handle.Init.DualAddressMode = I2C_DUALADDRESS_DISABLE;
-    i2c_handle.Init.OwnAddress2     = 0;
-    i2c_handle.Init.GeneralCallMode = I2C_GENERALCALL_DISABLE;
-    i2c_handle.Init.NoStretchMode   = I2C_NOSTRETCH_DISABLE;
+    sensor->settings.standby_time = standby_time;
 
-    HAL_I2C_Init(&i2c_handle);
+    if (bme280_set_sensor_config(BME280_SEL_STANDBY | BME280_SEL_OSR_PRESS | BME280_SEL_OSR_TEMP,
+                                 &sensor->settings, BME280_POWERMODE_NORMAL, &sensor->dev) != BME280_OK) {
+        sensor->state = ENV_SENSOR_ERROR;
+        return HAL_ERROR;
+    }
+
+    sensor->normal_mode = 1;
+    sensor->state = ENV_SENSOR_IDLE;
+
+    return HAL_OK;
 }
 
 /**
- * @brief   Initialisiert den BME280 und setzt Sensor-Einstellungen
+ * @brief   Schaltet einen Sensor zurück in Sleep- / Forced-Mode
+ *
+ * @details
+ * Ein einzelner Schreibzugriff auf ctrl_meas, ohne Rücklesen.
+ *
+ * @param   sensor Instanz
+ * @return  HAL_OK oder HAL_ERROR
+ */
+HAL_StatusTypeDef env_sensor_set_forced(env_sensor_t *sensor)
+{
+    while (env_sensor_step(sensor) == ENV_SENSOR_BUSY) {
+        osal_event_wait(&sensor->done_event, 1);
+    }
+
+    sensor->normal_mode = 0;
+    sensor->state = ENV_SENSOR_IDLE;
+
+    if (bme280_set_sensor_mode(BME280_POWERMODE_SLEEP, &sensor->dev) != BME280_OK) {
+        sensor->state = ENV_SENSOR_ERROR;
+        return HAL_ERROR;
+    }
+
+    return HAL_OK;
+}
+
+/**
+ * @brief   Schaltet das adaptive Oversampling eines Sensors ein oder aus
+ *
+ * @param   sensor Instanz
+ * @param   enable 1 = an, 0 = aus
+ * @return  None
+ */
+void env_sensor_set_adaptive(env_sensor_t *sensor, uint8_t enable)
+{
+    sensor->osr.enabled = (enable != 0);
+    sensor->osr.level   = 0;
+    sensor->osr.steady  = 0;
+    sensor->osr.valid   = 0;
+    env_sensor_osr_plan(sensor);
+}
+
+/**
+ * @brief   Startet alle angemeldeten Sensoren, die nicht messen
  *
  * @details
- * Bindet die I2C Read/Write/Delay Callbacks in die bme280_dev Struktur ein,
- * initialisiert den Sensor und setzt Oversampling- sowie Filterparameter.
+ * Die ctrl_meas-Zugriffe eines Busses laufen direkt hintereinander aus
+ * dem Interrupt, die Wandlungen der Sensoren überlappen sich also.
  *
  * @param   None
  * @return  None
  */
-static void env_sensor_bme280_init(void)
+void env_sensor_measure_all(void)
 {
-    dev.intf_ptr = &i2c_handle;
-    dev.intf     = BME280_I2C_INTF;
-    dev.read     = env_sensor_i2c_read;
-    dev.write    = env_sensor_i2c_write;
-    dev.delay_us = env_sensor_delay_us;
+    uint8_t count = sensor_count;
 
-    bme280_init(&dev);
+    for (uint8_t i = 0; i < count; i++) {
+        (void)env_sensor_measure(sensors[i]);
+    }
+}
 
-    settings.osr_h  = BME280_OVERSAMPLING_1X;
-    settings.osr_p  = BME280_OVERSAMPLING_16X;
-    settings.osr_t  = BME280_OVERSAMPLING_2X;
-    settings.filter = BME280_FILTER_COEFF_16;
+/**
+ * @brief   Schreitet alle angemeldeten Sensoren fort
+ *
+ * @param   None
+ * @return  Anzahl Sensoren mit neuen Daten
+ */
+uint8_t env_sensor_process(void)
+{
+    uint8_t count = sensor_count;
+    uint8_t ready = 0;
 
-    uint8_t settings_sel = (uint8_t)(BME280_SEL_OSR_PRESS |
-                                     BME280_SEL_OSR_TEMP  |
-                                     BME280_SEL_OSR_HUM   |
-                                     BME280_SEL_FILTER);
+    for (uint8_t i = 0; i < count; i++) {
+        if (env_sensor_step(sensors[i]) == ENV_SENSOR_READY) {
+            ready++;
+        }
+    }
 
-    bme280_set_sensor_settings(settings_sel, &settings, &dev);
+    return ready;
 }
 
 /**
- * @brief   I2C-Read Callback für die BME280 Library
+ * @brief   Liefert den eingebauten Sensor
  *
- * @param   reg_addr Registeradresse
- * @param   data     Zielpuffer
- * @param   len      Anzahl Bytes
- * @param   intf_ptr Zeiger auf das I2C-Handle
+ * @param   None
+ * @return  Instanz
+ */
+env_sensor_t *env_sensor_get_default(void)
+{
+    return &default_sensor;
+}
+
+/**
+ * @brief   Verwirft die Kalibrierdaten im Backup-SRAM
  *
- * @return  0 bei Erfolg, -1 bei Fehler
+ * @param   None
+ * @return  None
  */
-static int8_t env_sensor_i2c_read(uint8_t reg_addr, uint8_t *data, uint32_t len, void *intf_ptr)
+void env_sensor_cache_invalidate(void)
 {
-    I2C_HandleTypeDef *hi2c = (I2C_HandleTypeDef *)intf_ptr;
+    env_sensor_cache_enable();
 
-    if (HAL_I2C_Mem_Read(hi2c,
-                        (uint16_t)(BME280_I2C_ADDR_SEC << 1),
-                        reg_addr,
-                        I2C_MEMADD_SIZE_8BIT,
-                        data,
-                        (uint16_t)len,
-                        TIMEOUT) == HAL_OK)
-    {
-        return 0;
+    for (uint8_t i = 0; i < ENV_SENSOR_MAX_SENSORS; i++) {
+        ENV_SENSOR_CACHE[i].magic = 0;
+    }
+}
+
+/**
+ * @brief   Kopiert die laufende Statistik der Messwerte eines Sensors
+ *
+ * @details
+ * Die Statistik wird in env_sensor_step() bzw. env_sensor_process()
+ * fortgeschrieben (Task-Kontext), die Kopie braucht keine Sperre.
+ *
+ * @param   sensor Instanz
+ * @param   stats  Ziel, Index env_sensor_stats_t
+ * @return  None
+ */
+void env_sensor_get_stats(const env_sensor_t *sensor, stats_welford_t stats[ENV_SENSOR_STATS_COUNT])
+{
+    for (uint8_t i = 0; i < ENV_SENSOR_STATS_COUNT; i++) {
+        stats[i] = sensor->stats[i];
     }
+}
 
-    return -1;
+/**
+ * @brief   Startet die Statistik der Messwerte eines Sensors neu
+ *
+ * @param   sensor Instanz
+ * @return  None
+ */
+void env_sensor_reset_stats(env_sensor_t *sensor)
+{
+    for (uint8_t i = 0; i < ENV_SENSOR_STATS_COUNT; i++) {
+        stats_welford_reset(&sensor->stats[i]);
+    }
 }
 
 /**
- * @brief   I2C-Write Callback für die BME280 Library
+ * @brief   Meldet den Ersatzbetrieb der zuletzt abgeholten Messwerte
  *
- * @param   reg_addr Registeradresse
- * @param   data     Quelldaten
- * @param   len      Anzahl Bytes
- * @param   intf_ptr Zeiger auf das I2C-Handle
+ * @param   sensor Instanz
+ * @return  1 wenn der letzte gültige Wert geliefert wurde, 0 sonst
+ */
+uint8_t env_sensor_is_degraded(const env_sensor_t *sensor)
+{
+    return sensor->degraded;
+}
+
+/**
+ * @brief   Kopiert die Fehlerzähler des Busses eines Sensors
  *
- * @return  0 bei Erfolg, -1 bei Fehler
+ * @param   sensor Instanz
+ * @param   health Ziel
+ * @return  HAL_OK, HAL_ERROR ohne Bus
  */
-static int8_t env_sensor_i2c_write(uint8_t reg_addr, const uint8_t *data, uint32_t len, void *intf_ptr)
+HAL_StatusTypeDef env_sensor_get_bus_health(const env_sensor_t *sensor, env_sensor_bus_health_t *health)
 {
-    I2C_HandleTypeDef *hi2c = (I2C_HandleTypeDef *)intf_ptr;
+    const env_sensor_bus_t *bus = sensor->bus;
 
-    if (HAL_I2C_Mem_Write(hi2c,
-                         (uint16_t)(BME280_I2C_ADDR_SEC << 1),
-                         reg_addr,
-                         I2C_MEMADD_SIZE_8BIT,
-                         (uint8_t *)data,
-                         (uint16_t)len,
-                         TIMEOUT) == HAL_OK)
-    {
-        return 0;
+    if (bus == NULL) {
+        return HAL_ERROR;
     }
 
-    return -1;
+    health->u32_errors     = bus->errors;
+    health->u32_timeouts   = bus->timeouts;
+    health->u32_recoveries = bus->recoveries;
+    health->u16_backoff_ms = bus->backoff_ms;
+    health->u8_failures    = bus->failures;
+
+    return HAL_OK;
 }
 
 /**
- * @brief   Delay-Funktion für die BME280 Library
+ * @brief   Kompensiert die Rohwerte eines Dump-Blocks des Datenloggers
  *
  * @details
- * Die BME280 Library erwartet eine Delay-Funktion in Mikrosekunden.
- * Hier wird vereinfacht auf HAL_Delay (Millisekunden) abgebildet.
- *
- * @param   period   Zeitdauer in Mikrosekunden (laut Library)
- * @param   intf_ptr Unbenutzt (Kompatibilität zur Library)
+ * Ersetzt DATALOG_CH_ENV_RAW_* durch DATALOG_CH_ENV_TEMP/PRESS/HUM in
+ * 0,01 Grad Celsius, Pa und 0,001 %, mit der Kalibrierung des ersten
+ * angemeldeten Sensors. Druck und Feuchte werden mit der letzten
+ * Roh-Temperatur davor kompensiert, auch über Blockgrenzen; beginnt der
+ * Dump mitten in einer Messung, bleiben die Werte davor roh.
  *
+ * @param   records   Block
+ * @param   u32_count Records im Block
+ * @param   u32_index Position im Dump, 0 am Anfang
  * @return  None
  */
-static void env_sensor_delay_us(uint32_t period, void *intf_ptr)
+void env_sensor_datalog_filter(datalog_record_t *records, uint32_t u32_count, uint32_t u32_index)
 {
-    (void)intf_ptr;
-    HAL_Delay(period / 1000);
+    struct bme280_uncomp_data uncomp_data;
+    struct bme280_data data;
+    int32_t centi_celsius;
+    uint32_t pascal;
+    uint32_t milli_rh;
+    uint8_t sensor_comp;
+
+    if (sensor_count == 0) {
+        return;
+    }
+
+    if (u32_index == 0) {
+        filter_calib           = sensors[0]->dev.calib_data;
+        filter_has_temperature = 0;
+    }
+
+    for (uint32_t i = 0; i < u32_count; i++) {
+        datalog_record_t *record = &records[i];
+
+        switch (record->u16_channel) {
+        case DATALOG_CH_ENV_RAW_TEMP:
+            filter_raw_temperature = (uint32_t)record->i32_value;
+            filter_has_temperature = 1;
+            sensor_comp = BME280_TEMP;
+            break;
+        case DATALOG_CH_ENV_RAW_PRESS:
+            sensor_comp = BME280_PRESS;
+            break;
+        case DATALOG_CH_ENV_RAW_HUM:
+            sensor_comp = BME280_HUM;
+            break;
+        default:
+            continue;
+        }
+
+        if (!filter_has_temperature) {
+            continue;
+        }
+
+        uncomp_data.temperature = filter_raw_temperature;
+        uncomp_data.pressure    = (uint32_t)record->i32_value;
+        uncomp_data.humidity    = (uint32_t)record->i32_value;
+        bme280_compensate_data(sensor_comp, &uncomp_data, &data, &filter_calib);
+        env_sensor_data_fixed(&data, &centi_celsius, &pascal, &milli_rh);
+
+        if (sensor_comp == BME280_TEMP) {
+            record->u16_channel = DATALOG_CH_ENV_TEMP;
+            record->i32_value   = centi_celsius;
+        } else if (sensor_comp == BME280_PRESS) {
+            record->u16_channel = DATALOG_CH_ENV_PRESS;
+            record->i32_value   = (int32_t)pascal;
+        } else {
+            record->u16_channel = DATALOG_CH_ENV_HUM;
+            record->i32_value   = (int32_t)milli_rh;
+        }
+    }
+}
+
+/**
+ * @brief   Meldet einen weiteren Teilnehmer an einem I2C-Bus an
+ *
+ * @param   client Teilnehmer mit i2c, i2c_addr und done
+ * @return  HAL_OK, HAL_ERROR bei ungültigem Bus oder ohne freien Platz
+ */
+HAL_StatusTypeDef env_sensor_i2c_attach(env_sensor_i2c_client_t *client)
+{
+    env_sensor_config_t config = { 0 };
+
+    if ((client->i2c == NULL) || (client->done == NULL) || (i2c_client_count >= ENV_SENSOR_MAX_I2C_CLIENTS)) {
+        return HAL_ERROR;
+    }
+
+    config.i2c  = client->i2c;
+    client->bus = env_sensor_get_bus(&config);
+    if (client->bus == NULL) {
+        return HAL_ERROR;
+    }
+
+    client->pending = 0;
+    client->busy    = 0;
+    i2c_clients[i2c_client_count] = client;
+    i2c_client_count++;
+
+    return HAL_OK;
+}
+
+/**
+ * @brief   Fordert einen Registerzugriff eines Teilnehmers an
+ *
+ * @param   client Teilnehmer
+ * @param   reg    Registeradresse
+ * @param   data   Quelle bzw. Ziel, gültig bis zum Transferende
+ * @param   len    Anzahl Bytes
+ * @param   write  1 = Schreiben, 0 = Lesen
+ * @return  HAL_OK, HAL_BUSY solange ein Zugriff aussteht, HAL_ERROR ohne
+ *          Anmeldung
+ */
+HAL_StatusTypeDef env_sensor_i2c_submit(env_sensor_i2c_client_t *client, uint8_t reg, uint8_t *data,
+                                        uint16_t len, uint8_t write)
+{
+    env_sensor_bus_t *bus = client->bus;
+    uint32_t primask;
+
+    if (bus == NULL) {
+        return HAL_ERROR;
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    if (client->busy) {
+        __set_PRIMASK(primask);
+        return HAL_BUSY;
+    }
+    client->busy    = 1;
+    client->reg     = reg;
+    client->data    = data;
+    client->len     = len;
+    client->write   = write;
+    client->pending = 1;
+    if ((bus->owner == NULL) && (bus->client == NULL)) {
+        env_sensor_bus_next(bus);
+    }
+    __set_PRIMASK(primask);
+
+    return HAL_OK;
+}
+
+/* Static module functions (implementation) */
+
+/**
+ * @brief   Liefert den Bus eines Anschlusses, initialisiert ihn beim
+ *          ersten Sensor
+ *
+ * @param   config Anschluss
+ * @return  Bus, NULL bei ungültigem Anschluss
+ */
+static env_sensor_bus_t *env_sensor_get_bus(const env_sensor_config_t *config)
+{
+    env_sensor_bus_t *bus;
+
+    if (config->i2c == I2C1) {
+        bus = &i2c1_bus;
+    } else if (config->i2c == I2C3) {
+        bus = &i2c3_bus;
+#if ENV_SENSOR_SPI_ENABLE
+    } else if ((config->i2c == NULL) && (config->spi != NULL) && (config->cs_port != NULL)) {
+        for (uint8_t i = 0; i < spi_bus_count; i++) {
+            if (spi_buses[i].spi == config->spi) {
+                return &spi_buses[i];
+            }
+        }
+        if (spi_bus_count >= ENV_SENSOR_MAX_SPI_BUSES) {
+            return NULL;
+        }
+        bus = &spi_buses[spi_bus_count];
+        bus->spi     = config->spi;
+        bus->owner   = NULL;
+        bus->client  = NULL;
+        bus->shared  = (config->spi == &hspi5) ? 1 : 0;
+        bus->granted = 0;
+        if (bus->shared) {
+            /* SPI5 gehört dem LCD-Treiber: Transfers nur über dessen Arbiter */
+            bus->lcd_client.Grant     = env_sensor_lcd_grant;
+            bus->lcd_client.Done      = env_sensor_lcd_done;
+            bus->lcd_client.Max_Clock = ENV_SENSOR_SPI_MAX_CLOCK;
+            bus->lcd_client.Context   = bus;
+            if (ILI9341_Bus_Attach(&bus->lcd_client) != HAL_OK) {
+                return NULL;
+            }
+        }
+        spi_bus_count++;
+        bus->ready = 1;
+        return bus;
+#endif
+    } else {
+        return NULL;
+    }
+
+    if (!bus->ready) {
+        bus->spi    = NULL;
+        bus->owner  = NULL;
+        bus->client = NULL;
+        env_sensor_init_gpio(config->i2c);
+        env_sensor_init_i2c(bus, config->i2c);
+        bus->ready = 1;
+    }
+
+    return bus;
+}
+
+/**
+ * @brief   Initialisiert die GPIOs für I2C (SCL/SDA)
+ *
+ * @details
+ * I2C1: PB6/PB7, I2C3: PA8/PC9, jeweils Alternate Function Open-Drain
+ * mit Pull-Up (AF4).
+ *
+ * @param   instance I2C1 oder I2C3
+ * @return  None
+ */
+static void env_sensor_init_gpio(I2C_TypeDef *instance)
+{
+    GPIO_InitTypeDef gpio_i2c_init;
+
+    gpio_i2c_init.Mode      = GPIO_MODE_AF_OD;
+    gpio_i2c_init.Pull      = GPIO_PULLUP;
+    gpio_i2c_init.Speed     = GPIO_SPEED_FREQ_MEDIUM;
+
+    if (instance == I2C1) {
+        __HAL_RCC_GPIOB_CLK_ENABLE();
+
+        gpio_i2c_init.Pin       = GPIO_PIN_6 | GPIO_PIN_7;
+        gpio_i2c_init.Alternate = GPIO_AF4_I2C1;
+        HAL_GPIO_Init(GPIOB, &gpio_i2c_init);
+    } else {
+        __HAL_RCC_GPIOA_CLK_ENABLE();
+        __HAL_RCC_GPIOC_CLK_ENABLE();
+
+        gpio_i2c_init.Pin       = GPIO_PIN_8;
+        gpio_i2c_init.Alternate = GPIO_AF4_I2C3;
+        HAL_GPIO_Init(GPIOA, &gpio_i2c_init);
+
+        gpio_i2c_init.Pin       = GPIO_PIN_9;
+        HAL_GPIO_Init(GPIOC, &gpio_i2c_init);
+    }
+}
+
+/**
+ * @brief   Initialisiert I2C1 bzw. I2C3 mit RX-DMA und Interrupts
+ *
+ * @details
+ * Fast-Mode mit ENV_SENSOR_I2C_CLOCK_HZ, Duty-Cycle aus clock_plan_i2c()
+ * (schnellster SCL für PCLK1), 7-bit Addressing, Standard-
+ * Einstellungen (kein Dual-Address, kein General Call).
+ * RX-DMA: Anforderung I2C1_RX bzw. I2C3_RX bei dma_alloc (DMA1 Stream 0
+ * Channel 1 bzw. DMA1 Stream 2 Channel 3), der Stream-Interrupt läuft
+ * über dma_alloc.
+ *
+ * @param   bus      Bus
+ * @param   instance I2C1 oder I2C3
+ * @return  None
+ */
+static void env_sensor_init_i2c(env_sensor_bus_t *bus, I2C_TypeDef *instance)
+{
+    IRQn_Type ev_irq;
+    IRQn_Type er_irq;
+    dma_alloc_request_t dma_request;
+
+    if (instance == I2C1) {
+        __HAL_RCC_I2C1_CLK_ENABLE();
+        dma_request = DMA_ALLOC_REQ_I2C1_RX;
+        ev_irq  = I2C1_EV_IRQn;
+        er_irq  = I2C1_ER_IRQn;
+    } else {
+        __HAL_RCC_I2C3_CLK_ENABLE();
+        dma_request = DMA_ALLOC_REQ_I2C3_RX;
+        ev_irq  = I2C3_EV_IRQn;
+        er_irq  = I2C3_ER_IRQn;
+    }
+
+    bus->i2c_handle.Instance             = instance;
+    bus->i2c_handle.Init.ClockSpeed      = ENV_SENSOR_I2C_CLOCK_HZ;
+    bus->i2c_handle.Init.DutyCycle       = clock_plan_i2c(ENV_SENSOR_I2C_CLOCK_HZ);
+    bus->i2c_handle.Init.OwnAddress1     = 0;
+    bus->i2c_handle.Init.AddressingMode  = I2C_ADDRESSINGMODE_7BIT;
+    bus->i2c_handle.Init.DualAddressMode = I2C_DUALADDRESS_DISABLE;
+    bus->i2c_handle.Init.OwnAddress2     = 0;
+    bus->i2c_handle.Init.GeneralCallMode = I2C_GENERALCALL_DISABLE;
+    bus->i2c_handle.Init.NoStretchMode   = I2C_NOSTRETCH_DISABLE;
+
+    HAL_I2C_Init(&bus->i2c_handle);
+
+    /* Zyklenzähler für env_sensor_bus_idle() */
+    utils_timebase_init();
+
+    HAL_NVIC_SetPriority(ev_irq, ENV_SENSOR_I2C_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(ev_irq);
+    HAL_NVIC_SetPriority(er_irq, ENV_SENSOR_I2C_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(er_irq);
+
+    /* Ohne freien Stream bleibt hdmarx leer, die Burst-Reads schlagen dann fehl */
+    if (dma_alloc_claim(&bus->dma_rx_handle, dma_request, DMA_ALLOC_LATENCY_BULK,
+                        HEALTH_ISR_ENV_DMA) != HAL_OK) {
+        return;
+    }
+
+    bus->dma_rx_handle.Init.Direction           = DMA_PERIPH_TO_MEMORY;
+    bus->dma_rx_handle.Init.PeriphInc           = DMA_PINC_DISABLE;
+    bus->dma_rx_handle.Init.MemInc              = DMA_MINC_ENABLE;
+    bus->dma_rx_handle.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    bus->dma_rx_handle.Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
+    bus->dma_rx_handle.Init.Mode                = DMA_NORMAL;
+    bus->dma_rx_handle.Init.FIFOMode            = DMA_FIFOMODE_DISABLE;
+
+    HAL_DMA_Init(&bus->dma_rx_handle);
+    __HAL_LINKDMA(&bus->i2c_handle, hdmarx, bus->dma_rx_handle);
+
+    HAL_NVIC_SetPriority(dma_alloc_get_irqn(&bus->dma_rx_handle), ENV_SENSOR_I2C_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(dma_alloc_get_irqn(&bus->dma_rx_handle));
+}
+
+/**
+ * @brief   Initialisiert den BME280 und setzt Sensor-Einstellungen
+ *
+ * @details
+ * Bindet die Read/Write/Delay Callbacks in die bme280_dev Struktur ein.
+ * Mit gültigem Warmstart-Eintrag werden Kalibrierung und Einstellungen
+ * übernommen, sonst wird der Sensor über die Library initialisiert.
+ *
+ * @param   sensor Instanz
+ * @return  HAL_OK, HAL_ERROR wenn der Sensor nicht antwortet
+ */
+static HAL_StatusTypeDef env_sensor_bme280_init(env_sensor_t *sensor)
+{
+    sensor->dev.intf_ptr = sensor;
+    sensor->dev.intf     = (sensor->config.i2c != NULL) ? BME280_I2C_INTF : BME280_SPI_INTF;
+    sensor->dev.read     = env_sensor_bus_read;
+    sensor->dev.write    = env_sensor_bus_write;
+    sensor->dev.delay_us = env_sensor_delay_us;
+
+    /* Register-Schatten der Library: Zustand des Sensors noch unbekannt */
+    sensor->dev.shadow_valid = 0;
+
+    sensor->warm_start = env_sensor_warm_init(sensor);
+
+    if (!sensor->warm_start && (env_sensor_cold_init(sensor) != HAL_OK)) {
+        return HAL_ERROR;
+    }
+
+    /* Maximale Messzeit in us, auf ganze Millisekunden aufgerundet */
+    uint32_t max_delay_us;
+
+    if (bme280_cal_meas_delay(&max_delay_us, &sensor->settings) == BME280_OK) {
+        sensor->meas_delay_ms = (max_delay_us + 999) / 1000;
+    }
+
+    return HAL_OK;
+}
+
+/**
+ * @brief   Oversampling und Filter der Init
+ *
+ * @details
+ * Aus dem Parameterspeicher (params), ohne Eintrag die Vorgabewerte
+ * T 2x, P 16x, H 1x, Filter 16.
+ *
+ * @param   settings Ziel
+ * @return  None
+ */
+static void env_sensor_default_settings(struct bme280_settings *settings)
+{
+    settings->osr_h        = (uint8_t)params_get_u32(PARAMS_KEY_ENV_OSR_H, BME280_OVERSAMPLING_1X);
+    settings->osr_p        = (uint8_t)params_get_u32(PARAMS_KEY_ENV_OSR_P, BME280_OVERSAMPLING_16X);
+    settings->osr_t        = (uint8_t)params_get_u32(PARAMS_KEY_ENV_OSR_T, BME280_OVERSAMPLING_2X);
+    settings->filter       = (uint8_t)params_get_u32(PARAMS_KEY_ENV_FILTER, BME280_FILTER_COEFF_16);
+    settings->standby_time = BME280_STANDBY_TIME_0_5_MS;  /* Reset-Wert */
+}
+
+/**
+ * @brief   Initialisiert den BME280 über die Library
+ *
+ * @details
+ * Chip-ID, Soft-Reset und Kalibrierdaten (bme280_init), danach
+ * Oversampling- und Filterparameter. Das Ergebnis wird für den
+ * nächsten Warmstart abgelegt.
+ *
+ * @param   sensor Instanz
+ * @return  HAL_OK oder HAL_ERROR
+ */
+static HAL_StatusTypeDef env_sensor_cold_init(env_sensor_t *sensor)
+{
+    if (bme280_init(&sensor->dev) != BME280_OK) {
+        return HAL_ERROR;
+    }
+
+    env_sensor_default_settings(&sensor->settings);
+
+    uint8_t settings_sel = (uint8_t)(BME280_SEL_OSR_PRESS |
+                                     BME280_SEL_OSR_TEMP  |
+                                     BME280_SEL_OSR_HUM   |
+                                     BME280_SEL_FILTER);
+
+    if (bme280_set_sensor_settings(settings_sel, &sensor->settings, &sensor->dev) != BME280_OK) {
+        return HAL_ERROR;
+    }
+
+    env_sensor_cache_store(sensor);
+
+    return HAL_OK;
+}
+
+/**
+ * @brief   Warmstart aus dem Backup-SRAM
+ *
+ * @details
+ * Der Eintrag gilt, wenn Chip-ID und dig_T1 des Sensors sowie Oversampling
+ * und Filter des Parameterspeichers übereinstimmen.
+ * ctrl_hum, ctrl_meas und config werden in einem Zugriff gelesen und
+ * nur bei Abweichung (z. B. nach Power-On des Sensors) in einem
+ * Burst-Write neu geschrieben, ctrl_hum vor ctrl_meas (Sleep-Mode) vor
+ * config. Beide Zugriffe füllen den Register-Schatten der Library.
+ *
+ * @param   sensor Instanz
+ * @return  1 bei erfolgreichem Warmstart, sonst 0
+ */
+static uint8_t env_sensor_warm_init(env_sensor_t *sensor)
+{
+#if ENV_SENSOR_WARM_START
+    const env_sensor_cache_t *record;
+    struct bme280_settings settings;
+    uint8_t chip_id = 0;
+    uint8_t dig_t1[2];
+    uint8_t regs[4];  /* ctrl_hum, status, ctrl_meas, config */
+    uint8_t expected[3];
+
+    record = env_sensor_cache_find(env_sensor_cache_key(&sensor->config));
+    if (record == NULL) {
+        return 0;
+    }
+
+    /* Geänderte Parameter: Kaltstart mit den neuen Einstellungen */
+    env_sensor_default_settings(&settings);
+    if ((settings.osr_h != record->settings.osr_h) || (settings.osr_p != record->settings.osr_p) ||
+        (settings.osr_t != record->settings.osr_t) || (settings.filter != record->settings.filter)) {
+        return 0;
+    }
+
+    if ((bme280_get_regs(BME280_REG_CHIP_ID, &chip_id, 1, &sensor->dev) != BME280_OK) ||
+        (chip_id != record->chip_id)) {
+        return 0;
+    }
+
+    if ((bme280_get_regs(BME280_REG_TEMP_PRESS_CALIB_DATA, dig_t1, 2, &sensor->dev) != BME280_OK) ||
+        ((uint16_t)((dig_t1[1] << 8) | dig_t1[0]) != record->calib.dig_t1)) {
+        return 0;
+    }
+
+    sensor->dev.chip_id    = chip_id;
+    sensor->dev.calib_data = record->calib;
+    sensor->settings       = record->settings;
+
+    expected[0] = (uint8_t)(sensor->settings.osr_h & 0x07);
+    expected[1] = (uint8_t)((sensor->settings.osr_t << 5) |
+                            (sensor->settings.osr_p << 2) |
+                            BME280_POWERMODE_SLEEP);
+    expected[2] = (uint8_t)((sensor->settings.standby_time << 5) |
+                            (sensor->settings.filter << 2));
+
+    if (bme280_get_regs(BME280_REG_CTRL_HUM, regs, sizeof(regs), &sensor->dev) != BME280_OK) {
+        return 0;
+    }
+
+    if (((regs[0] & 0x07) != expected[0]) || (regs[2] != expected[1]) ||
+        ((regs[3] & 0xFC) != expected[2])) {
+        uint8_t reg_addr[3] = { BME280_REG_CTRL_HUM, BME280_REG_CTRL_MEAS, BME280_REG_CONFIG };
+
+        if (bme280_set_regs(reg_addr, expected, 3, &sensor->dev) != BME280_OK) {
+            return 0;
+        }
+    }
+
+    return 1;
+#else
+    (void)sensor;
+    return 0;
+#endif
+}
+
+/**
+ * @brief   Schaltet Backup-SRAM und Backup-Regler ein (einmalig)
+ *
+ * @details
+ * Mit Backup-Regler bleibt der Inhalt auch bei VBAT-Versorgung erhalten,
+ * über einen Reset bei anliegender VDD in jedem Fall.
+ *
+ * @param   None
+ * @return  None
+ */
+static void env_sensor_cache_enable(void)
+{
+    if (cache_ready) {
+        return;
+    }
+
+    __HAL_RCC_PWR_CLK_ENABLE();
+    HAL_PWR_EnableBkUpAccess();
+    __HAL_RCC_BKPSRAM_CLK_ENABLE();
+    (void)HAL_PWREx_EnableBkUpReg();
+
+    cache_ready = 1;
+}
+
+#if ENV_SENSOR_WARM_START
+/**
+ * @brief   Schlüssel eines Anschlusses (Bus und Adresse bzw. CS-Pin)
+ *
+ * @param   config Anschluss
+ * @return  Schlüssel
+ */
+static uint32_t env_sensor_cache_key(const env_sensor_config_t *config)
+{
+    if (config->i2c != NULL) {
+        return (uint32_t)(uintptr_t)config->i2c ^ config->i2c_addr;
+    }
+
+    return (uint32_t)(uintptr_t)config->cs_port ^ config->cs_pin;
+}
+
+/**
+ * @brief   Prüfsumme eines Eintrags (FNV-1a, ohne das Feld checksum)
+ *
+ * @param   record Eintrag
+ * @return  Prüfsumme
+ */
+static uint32_t env_sensor_cache_sum(const env_sensor_cache_t *record)
+{
+    const uint8_t *bytes = (const uint8_t *)record;
+    uint32_t hash = 2166136261UL;
+
+    for (uint32_t i = 0; i < offsetof(env_sensor_cache_t, checksum); i++) {
+        hash = (hash ^ bytes[i]) * 16777619UL;
+    }
+
+    return hash;
+}
+
+/**
+ * @brief   Sucht den gültigen Eintrag eines Anschlusses
+ *
+ * @param   key Schlüssel
+ * @return  Eintrag oder NULL
+ */
+static const env_sensor_cache_t *env_sensor_cache_find(uint32_t key)
+{
+    env_sensor_cache_enable();
+
+    for (uint8_t i = 0; i < ENV_SENSOR_MAX_SENSORS; i++) {
+        const env_sensor_cache_t *record = &ENV_SENSOR_CACHE[i];
+
+        if ((record->magic == ENV_SENSOR_CACHE_MAGIC) && (record->key == key) &&
+            (record->chip_id == BME280_CHIP_ID) &&
+            (record->checksum == env_sensor_cache_sum(record))) {
+            return record;
+        }
+    }
+
+    return NULL;
+}
+#endif /* ENV_SENSOR_WARM_START */
+
+/**
+ * @brief   Legt Kalibrierung und Einstellungen eines Sensors ab
+ *
+ * @details
+ * Überschreibt den Eintrag desselben Anschlusses, sonst den ersten
+ * ungültigen. Der Eintrag wird lokal aufgebaut (Füllbytes = 0) und
+ * erst danach kopiert.
+ *
+ * @param   sensor Instanz
+ * @return  None
+ */
+static void env_sensor_cache_store(const env_sensor_t *sensor)
+{
+#if ENV_SENSOR_WARM_START
+    env_sensor_cache_t record;
+    env_sensor_cache_t *slot = NULL;
+    uint32_t key = env_sensor_cache_key(&sensor->config);
+
+    env_sensor_cache_enable();
+
+    for (uint8_t i = 0; i < ENV_SENSOR_MAX_SENSORS; i++) {
+        env_sensor_cache_t *entry = &ENV_SENSOR_CACHE[i];
+        uint8_t valid = (entry->magic == ENV_SENSOR_CACHE_MAGIC) &&
+                        (entry->checksum == env_sensor_cache_sum(entry));
+
+        if (valid && (entry->key == key)) {
+            slot = entry;
+            break;
+        }
+        if (!valid && (slot == NULL)) {
+            slot = entry;
+        }
+    }
+
+    if (slot == NULL) {
+        return;
+    }
+
+    memset(&record, 0, sizeof(record));
+    record.magic    = ENV_SENSOR_CACHE_MAGIC;
+    record.key      = key;
+    record.chip_id  = sensor->dev.chip_id;
+    record.settings = sensor->settings;
+    record.calib    = sensor->dev.calib_data;
+    record.checksum = env_sensor_cache_sum(&record);
+
+    memcpy(slot, &record, sizeof(record));
+#else
+    (void)sensor;
+#endif
+}
+
+/**
+ * @brief   Read Callback für die BME280 Library (I2C oder SPI)
+ *
+ * @param   reg_addr Registeradresse (SPI: mit Lesebit von der Library)
+ * @param   data     Zielpuffer
+ * @param   len      Anzahl Bytes
+ * @param   intf_ptr Zeiger auf die Sensor-Instanz
+ *
+ * @return  0 bei Erfolg, -1 bei Fehler
+ */
+static int8_t env_sensor_bus_read(uint8_t reg_addr, uint8_t *data, uint32_t len, void *intf_ptr)
+{
+    env_sensor_t *sensor = (env_sensor_t *)intf_ptr;
+    env_sensor_bus_t *bus = sensor->bus;
+    HAL_StatusTypeDef status;
+
+    if ((sensor->config.i2c == NULL) && (len > ENV_SENSOR_SPI_MAX_LEN)) {
+        return -1;
+    }
+
+    /* Gesperrter I2C-Bus: sofort zurück statt auf den Timeout zu warten */
+    env_sensor_bus_service(bus);
+    if (bus->backoff_ms != 0) {
+        return -1;
+    }
+
+    if (env_sensor_claim(sensor) != 0) {
+        return -1;
+    }
+
+    bus->xfer_tick = HAL_GetTick();
+    if ((sensor->config.i2c != NULL) && !env_sensor_bus_idle(bus)) {
+        status = HAL_BUSY;
+    } else if (sensor->config.i2c != NULL) {
+        status = HAL_I2C_Mem_Read_IT(&bus->i2c_handle,
+                                     (uint16_t)(sensor->config.i2c_addr << 1),
+                                     reg_addr,
+                                     I2C_MEMADD_SIZE_8BIT,
+                                     data,
+                                     (uint16_t)len);
+    } else {
+        spi_buffer[0] = reg_addr;
+        for (uint32_t i = 1; i <= len; i++) {
+            spi_buffer[i] = 0;
+        }
+        status = env_sensor_spi_transfer(bus, spi_buffer, spi_buffer, (uint16_t)(len + 1));
+    }
+
+    if (status != HAL_OK) {
+        env_sensor_bus_done(bus, 1);
+        return -1;
+    }
+
+    if (env_sensor_wait(sensor) != 0) {
+        return -1;
+    }
+
+    if (sensor->config.i2c == NULL) {
+        for (uint32_t i = 0; i < len; i++) {
+            data[i] = spi_buffer[i + 1];
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief   Write Callback für die BME280 Library (I2C oder SPI)
+ *
+ * @details
+ * Bei SPI übergibt die Library für mehrere Register abwechselnd Wert und
+ * Adresse in data; sie werden hinter der ersten Adresse gesendet.
+ *
+ * @param   reg_addr Registeradresse
+ * @param   data     Quelldaten
+ * @param   len      Anzahl Bytes
+ * @param   intf_ptr Zeiger auf die Sensor-Instanz
+ *
+ * @return  0 bei Erfolg, -1 bei Fehler
+ */
+static int8_t env_sensor_bus_write(uint8_t reg_addr, const uint8_t *data, uint32_t len, void *intf_ptr)
+{
+    env_sensor_t *sensor = (env_sensor_t *)intf_ptr;
+    env_sensor_bus_t *bus = sensor->bus;
+    HAL_StatusTypeDef status;
+
+    if ((sensor->config.i2c == NULL) && (len > ENV_SENSOR_SPI_MAX_LEN)) {
+        return -1;
+    }
+
+    /* Gesperrter I2C-Bus: sofort zurück statt auf den Timeout zu warten */
+    env_sensor_bus_service(bus);
+    if (bus->backoff_ms != 0) {
+        return -1;
+    }
+
+    if (env_sensor_claim(sensor) != 0) {
+        return -1;
+    }
+
+    bus->xfer_tick = HAL_GetTick();
+    if ((sensor->config.i2c != NULL) && !env_sensor_bus_idle(bus)) {
+        status = HAL_BUSY;
+    } else if (sensor->config.i2c != NULL) {
+        status = HAL_I2C_Mem_Write_IT(&bus->i2c_handle,
+                                      (uint16_t)(sensor->config.i2c_addr << 1),
+                                      reg_addr,
+                                      I2C_MEMADD_SIZE_8BIT,
+                                      (uint8_t *)data,
+                                      (uint16_t)len);
+    } else {
+        spi_buffer[0] = reg_addr;
+        for (uint32_t i = 0; i < len; i++) {
+            spi_buffer[i + 1] = data[i];
+        }
+        status = env_sensor_spi_transfer(bus, spi_buffer, spi_buffer, (uint16_t)(len + 1));
+    }
+
+    if (status != HAL_OK) {
+        env_sensor_bus_done(bus, 1);
+        return -1;
+    }
+
+    return env_sensor_wait(sensor);
+}
+
+/**
+ * @brief   Delay-Funktion für die BME280 Library
+ *
+ * @details
+ * Die BME280 Library erwartet eine Delay-Funktion in Mikrosekunden.
+ * Ganze Millisekunden werden geschlafen (im RTOS-Build blockiert nur die
+ * aufrufende Task, osal_delay_ms), der Rest wird mit dem Zyklenzähler
+ * genau abgewartet (utils_delay_us).
+ *
+ * @param   period   Zeitdauer in Mikrosekunden (laut Library)
+ * @param   intf_ptr Unbenutzt (Kompatibilität zur Library)
+ *
+ * @return  None
+ */
+static void env_sensor_delay_us(uint32_t period, void *intf_ptr)
+{
+    (void)intf_ptr;
+
+    if (period >= 1000) {
+        osal_delay_ms(period / 1000);
+    }
+    utils_delay_us(period % 1000);
+}
+
+/**
+ * @brief   Belegt den Bus für einen Library-Zugriff
+ *
+ * @details
+ * Wartet, bis angeforderte Transfers anderer Sensoren abgeschlossen
+ * sind (höchstens TIMEOUT Millisekunden).
+ *
+ * @param   sensor Instanz
+ * @return  0 bei Erfolg, -1 bei Timeout
+ */
+static int8_t env_sensor_claim(env_sensor_t *sensor)
+{
+    env_sensor_bus_t *bus = sensor->bus;
+    uint32_t start = HAL_GetTick();
+
+    while (1) {
+        uint32_t primask = __get_PRIMASK();
+
+        __disable_irq();
+        if ((bus->owner == NULL) && (bus->client == NULL)) {
+            bus->owner    = sensor;
+            sensor->done  = 0;
+            sensor->error = 0;
+            __set_PRIMASK(primask);
+            return 0;
+        }
+        __set_PRIMASK(primask);
+
+        if ((HAL_GetTick() - start) > TIMEOUT) {
+            return -1;
+        }
+
+        /* Schlafen bis zum Ende des laufenden Transfers */
+        osal_event_wait(&bus->free_event, TIMEOUT);
+    }
+}
+
+/**
+ * @brief   Wartet auf das Ende eines Library-Transfers
+ *
+ * @param   sensor Instanz
+ * @return  0 bei Erfolg, -1 bei Fehler oder Timeout
+ */
+static int8_t env_sensor_wait(env_sensor_t *sensor)
+{
+    uint32_t start = HAL_GetTick();
+
+    /* Schlafen bis zum Transferende (Interrupt bzw. DMA) */
+    while (!sensor->done) {
+        uint32_t elapsed = HAL_GetTick() - start;
+
+        if ((elapsed > TIMEOUT) ||
+            (osal_event_wait(&sensor->done_event, TIMEOUT + 1 - elapsed) != HAL_OK && !sensor->done)) {
+            /* Ohne Transferende bliebe der Bus belegt */
+            if (sensor->bus->owner == sensor) {
+                env_sensor_bus_hang(sensor->bus);
+            }
+            return -1;
+        }
+    }
+
+    return sensor->error ? -1 : 0;
+}
+
+/**
+ * @brief   Fordert einen Hintergrund-Transfer an und startet ihn, wenn
+ *          der Bus frei ist
+ *
+ * @param   sensor  Instanz
+ * @param   request ENV_SENSOR_REQ_START oder ENV_SENSOR_REQ_BURST
+ * @return  None
+ */
+static void env_sensor_request(env_sensor_t *sensor, uint8_t request)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    sensor->pending |= request;
+    if ((sensor->bus->owner == NULL) && (sensor->bus->client == NULL)) {
+        env_sensor_bus_next(sensor->bus);
+    }
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief   Startet den nächsten angeforderten Transfer eines freien Busses
+ *
+ * @details
+ * Aufruf mit gesperrten Interrupts oder aus dem Transferende-Interrupt.
+ * Weitere Teilnehmer (kurze Registerzugriffe, z. B. Touch) kommen zuerst,
+ * danach ctrl_meas-Zugriffe, damit alle Wandlungen früh starten.
+ *
+ * @param   bus Bus
+ * @return  None
+ */
+static void env_sensor_bus_next(env_sensor_bus_t *bus)
+{
+    uint8_t count = sensor_count;
+
+    /* Wartezeit nach einem Fehler: Anforderungen bleiben stehen,
+     * env_sensor_bus_service() startet sie danach */
+    if (bus->backoff_ms != 0) {
+        return;
+    }
+
+    for (uint8_t i = 0; i < i2c_client_count; i++) {
+        env_sensor_i2c_client_t *client = i2c_clients[i];
+
+        if ((client->bus != bus) || !client->pending) {
+            continue;
+        }
+
+        client->pending = 0;
+        if (env_sensor_i2c_start(bus, client) == HAL_OK) {
+            return;
+        }
+        /* Der Fehler-Callback kann schon den nächsten Transfer gestartet haben */
+        if ((bus->owner != NULL) || (bus->client != NULL) || (bus->backoff_ms != 0)) {
+            return;
+        }
+    }
+
+    for (uint8_t request = ENV_SENSOR_REQ_START; request <= ENV_SENSOR_REQ_BURST; request <<= 1) {
+        for (uint8_t i = 0; i < count; i++) {
+            env_sensor_t *sensor = sensors[i];
+
+            if ((sensor->bus != bus) || !(sensor->pending & request)) {
+                continue;
+            }
+
+            sensor->pending &= (uint8_t)~request;
+            if ((env_sensor_bus_start(bus, sensor, request) == HAL_OK) || (bus->backoff_ms != 0)) {
+                return;
+            }
+        }
+    }
+}
+
+/**
+ * @brief   Startet einen Hintergrund-Transfer
+ *
+ * @param   bus     Bus (frei)
+ * @param   sensor  Instanz
+ * @param   request ENV_SENSOR_REQ_START oder ENV_SENSOR_REQ_BURST
+ * @return  HAL_OK, sonst ist der Fehler im Sensor vermerkt
+ */
+static HAL_StatusTypeDef env_sensor_bus_start(env_sensor_bus_t *bus, env_sensor_t *sensor, uint8_t request)
+{
+    HAL_StatusTypeDef status;
+
+    bus->owner     = sensor;
+    bus->xfer_tick = HAL_GetTick();
+    sensor->done   = 0;
+
+    if (request == ENV_SENSOR_REQ_BURST) {
+        sensor->meas_reading = ENV_SENSOR_BURST_ACTIVE;
+    }
+
+    if (sensor->config.i2c != NULL) {
+        if (!env_sensor_bus_idle(bus)) {
+            status = HAL_BUSY;
+        } else if (request == ENV_SENSOR_REQ_START) {
+            status = HAL_I2C_Mem_Write_IT(&bus->i2c_handle,
+                                          (uint16_t)(sensor->config.i2c_addr << 1),
+                                          BME280_REG_CTRL_MEAS,
+                                          I2C_MEMADD_SIZE_8BIT,
+                                          &sensor->ctrl_meas[1],
+                                          1);
+        } else {
+            /* Status und alle 8 Datenregister per DMA */
+            status = HAL_I2C_Mem_Read_DMA(&bus->i2c_handle,
+                                          (uint16_t)(sensor->config.i2c_addr << 1),
+                                          BME280_REG_STATUS,
+                                          I2C_MEMADD_SIZE_8BIT,
+                                          sensor->burst,
+                                          ENV_SENSOR_BURST_LEN);
+        }
+    } else {
+        if (request == ENV_SENSOR_REQ_START) {
+            status = env_sensor_spi_transfer(bus, sensor->ctrl_meas, sensor->burst, 2);
+        } else {
+            /* Adressbyte mit Lesebit, danach Status und Daten */
+            sensor->burst[0] = BME280_REG_STATUS | 0x80;
+            for (uint8_t i = 1; i <= ENV_SENSOR_BURST_LEN; i++) {
+                sensor->burst[i] = 0;
+            }
+            status = env_sensor_spi_transfer(bus, sensor->burst, sensor->burst,
+                                             ENV_SENSOR_BURST_LEN + 1);
+        }
+    }
+
+    if (status != HAL_OK) {
+        if (sensor->config.i2c == NULL) {
+            HAL_GPIO_WritePin(sensor->config.cs_port, sensor->config.cs_pin, GPIO_PIN_SET);
+        }
+        if (sensor->config.i2c != NULL) {
+            env_sensor_bus_failed(bus);
+        }
+        sensor->error = 1;
+        sensor->done  = 1;
+        bus->owner    = NULL;
+        osal_event_signal(&sensor->done_event);
+        osal_event_signal(&bus->free_event);
+    }
+
+    return status;
+}
+
+/**
+ * @brief   Startet den Registerzugriff eines weiteren Teilnehmers
+ *
+ * @details
+ * Lesezugriffe ab ENV_SENSOR_I2C_DMA_MIN_LEN Bytes per DMA (falls der
+ * Bus einen Stream hat), alle anderen per Interrupt. Schlägt der Start
+ * fehl, meldet der Callback den Fehler sofort.
+ *
+ * @param   bus    Bus (frei)
+ * @param   client Teilnehmer
+ * @return  HAL_OK oder Fehler des Starts
+ */
+static HAL_StatusTypeDef env_sensor_i2c_start(env_sensor_bus_t *bus, env_sensor_i2c_client_t *client)
+{
+    HAL_StatusTypeDef status;
+    uint16_t address = (uint16_t)(client->i2c_addr << 1);
+
+    bus->client    = client;
+    bus->xfer_tick = HAL_GetTick();
+
+    if (!env_sensor_bus_idle(bus)) {
+        status = HAL_BUSY;
+    } else if (client->write) {
+        status = HAL_I2C_Mem_Write_IT(&bus->i2c_handle, address, client->reg, I2C_MEMADD_SIZE_8BIT,
+                                      client->data, client->len);
+    } else if ((client->len >= ENV_SENSOR_I2C_DMA_MIN_LEN) && (bus->i2c_handle.hdmarx != NULL)) {
+        status = HAL_I2C_Mem_Read_DMA(&bus->i2c_handle, address, client->reg, I2C_MEMADD_SIZE_8BIT,
+                                      client->data, client->len);
+    } else {
+        status = HAL_I2C_Mem_Read_IT(&bus->i2c_handle, address, client->reg, I2C_MEMADD_SIZE_8BIT,
+                                     client->data, client->len);
+    }
+
+    if (status != HAL_OK) {
+        env_sensor_bus_failed(bus);
+        bus->client  = NULL;
+        client->busy = 0;
+        client->done(client, 1);
+        osal_event_signal(&bus->free_event);
+    }
+
+    return status;
+}
+
+/**
+ * @brief   Transferende eines Busses (aus den HAL Callbacks)
+ *
+ * @details
+ * Meldet das Ende an den Sensor und startet den nächsten angeforderten
+ * Transfer desselben Busses.
+ *
+ * @param   bus   Bus
+ * @param   error 1 bei Busfehler
+ * @return  None
+ */
+static void env_sensor_bus_done(env_sensor_bus_t *bus, uint8_t error)
+{
+    env_sensor_t *sensor = bus->owner;
+    env_sensor_i2c_client_t *client = bus->client;
+
+    if (bus->spi == NULL) {
+        if (error) {
+            env_sensor_bus_failed(bus);
+        } else {
+            bus->failures = 0;
+        }
+    }
+
+    if (client != NULL) {
+        bus->client  = NULL;
+        client->busy = 0;
+        client->done(client, error);
+        osal_event_signal(&bus->free_event);
+        if ((bus->owner == NULL) && (bus->client == NULL)) {
+            env_sensor_bus_next(bus);
+        }
+        return;
+    }
+
+    if (sensor == NULL) {
+        return;
+    }
+
+    if (sensor->config.i2c == NULL) {
+        HAL_GPIO_WritePin(sensor->config.cs_port, sensor->config.cs_pin, GPIO_PIN_SET);
+    }
+
+    if (error) {
+        sensor->error = 1;
+    }
+    if (sensor->meas_reading == ENV_SENSOR_BURST_ACTIVE) {
+        sensor->meas_reading = ENV_SENSOR_BURST_DONE;
+    }
+    sensor->done = 1;
+    osal_event_signal(&sensor->done_event);
+
+    bus->owner = NULL;
+    osal_event_signal(&bus->free_event);
+    env_sensor_bus_next(bus);
+}
+
+/**
+ * @brief   Wartet kurz auf das Ende des vorigen STOP eines I2C-Busses
+ *
+ * @details
+ * BUSY fällt einige µs nach dem Transferende-Interrupt. Bleibt es länger
+ * als ENV_SENSOR_BUSY_WAIT_US, hält ein Teilnehmer SDA bzw. SCL low.
+ *
+ * @param   bus I2C-Bus
+ * @return  1 wenn der Bus frei ist, 0 sonst
+ */
+static uint8_t env_sensor_bus_idle(const env_sensor_bus_t *bus)
+{
+    uint32_t start = utils_now_cycles();
+
+    while ((bus->i2c_handle.Instance->SR2 & I2C_SR2_BUSY) != 0u) {
+        if (utils_elapsed_us(start) > ENV_SENSOR_BUSY_WAIT_US) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/**
+ * @brief   Zählt einen Fehler eines I2C-Busses und sperrt ihn für die
+ *          nächste Wartezeit (ab ENV_SENSOR_BACKOFF_MIN_MS je Fehler in
+ *          Folge verdoppelt)
+ *
+ * @param   bus I2C-Bus
+ * @return  None
+ */
+static void env_sensor_bus_failed(env_sensor_bus_t *bus)
+{
+    uint32_t backoff = ENV_SENSOR_BACKOFF_MIN_MS;
+
+    bus->errors++;
+    BKPTRACE_EVENT(BKPTRACE_EV_ENV_BUS_ERROR, (uintptr_t)bus->i2c_handle.Instance);
+    if (bus->failures < 0xFF) {
+        bus->failures++;
+    }
+    for (uint8_t i = 1; (i < bus->failures) && (backoff < ENV_SENSOR_BACKOFF_MAX_MS); i++) {
+        backoff <<= 1;
+    }
+
+    bus->backoff_tick = HAL_GetTick();
+    bus->backoff_ms   = (uint16_t)((backoff < ENV_SENSOR_BACKOFF_MAX_MS) ? backoff : ENV_SENSOR_BACKOFF_MAX_MS);
+}
+
+/**
+ * @brief   Überwacht einen I2C-Bus (Hauptschleife)
+ *
+ * @details
+ * Bricht einen Transfer ohne Ende nach ENV_SENSOR_XFER_TIMEOUT_MS ab.
+ * Nach Ablauf der Wartezeit wird ein hängender Bus freigetaktet und die
+ * stehengebliebenen Anforderungen werden gestartet.
+ *
+ * @param   bus I2C-Bus
+ * @return  None
+ */
+static void env_sensor_bus_service(env_sensor_bus_t *bus)
+{
+    uint32_t primask;
+
+    if (!bus->ready || (bus->spi != NULL)) {
+        return;
+    }
+
+    if (((bus->owner != NULL) || (bus->client != NULL)) &&
+        ((HAL_GetTick() - bus->xfer_tick) > ENV_SENSOR_XFER_TIMEOUT_MS)) {
+        env_sensor_bus_hang(bus);
+    }
+
+    if ((bus->backoff_ms == 0) || ((HAL_GetTick() - bus->backoff_tick) < bus->backoff_ms)) {
+        return;
+    }
+
+    if (!env_sensor_bus_idle(bus)) {
+        env_sensor_bus_irq(bus, 0);
+        env_sensor_bus_recover(bus);
+        env_sensor_bus_irq(bus, 1);
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    bus->backoff_ms = 0;
+    if ((bus->owner == NULL) && (bus->client == NULL)) {
+        env_sensor_bus_next(bus);
+    }
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief   Bricht den Transfer eines Busses ohne Transferende ab
+ *
+ * @details
+ * I2C: Interrupts und RX-DMA gestoppt, Bus freigetaktet und Peripherie
+ * neu initialisiert. Der Besitzer bekommt das Transferende mit Fehler,
+ * der Bus eine Wartezeit.
+ *
+ * @param   bus Bus
+ * @return  None
+ */
+static void env_sensor_bus_hang(env_sensor_bus_t *bus)
+{
+    uint32_t primask;
+
+    if (bus->spi == NULL) {
+        env_sensor_bus_irq(bus, 0);
+        if ((bus->owner == NULL) && (bus->client == NULL)) {
+            /* Inzwischen doch fertig geworden */
+            env_sensor_bus_irq(bus, 1);
+            return;
+        }
+        if (bus->i2c_handle.hdmarx != NULL) {
+            (void)HAL_DMA_Abort(bus->i2c_handle.hdmarx);
+        }
+        env_sensor_bus_recover(bus);
+    }
+    bus->timeouts++;
+    BKPTRACE_EVENT(BKPTRACE_EV_ENV_BUS_HANG,
+                   (bus->spi != NULL) ? (uintptr_t)bus->spi : (uintptr_t)bus->i2c_handle.Instance);
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    env_sensor_bus_done(bus, 1);
+    __set_PRIMASK(primask);
+
+    if (bus->spi == NULL) {
+        env_sensor_bus_irq(bus, 1);
+    }
+}
+
+/**
+ * @brief   Sperrt bzw. erlaubt die Interrupts eines I2C-Busses (Event,
+ *          Error, RX-DMA)
+ *
+ * @param   bus    I2C-Bus
+ * @param   enable 1 = erlauben (anstehende werden verworfen), 0 = sperren
+ * @return  None
+ */
+static void env_sensor_bus_irq(const env_sensor_bus_t *bus, uint8_t enable)
+{
+    IRQn_Type irqs[3];
+    uint8_t count = 2;
+
+    irqs[0] = (bus->i2c_handle.Instance == I2C1) ? I2C1_EV_IRQn : I2C3_EV_IRQn;
+    irqs[1] = (bus->i2c_handle.Instance == I2C1) ? I2C1_ER_IRQn : I2C3_ER_IRQn;
+    if (bus->i2c_handle.hdmarx != NULL) {
+        irqs[count++] = dma_alloc_get_irqn(bus->i2c_handle.hdmarx);
+    }
+
+    for (uint8_t i = 0; i < count; i++) {
+        if (enable) {
+            HAL_NVIC_ClearPendingIRQ(irqs[i]);
+            HAL_NVIC_EnableIRQ(irqs[i]);
+        } else {
+            HAL_NVIC_DisableIRQ(irqs[i]);
+        }
+    }
+}
+
+/**
+ * @brief   Taktet einen hängenden I2C-Bus frei und setzt die Peripherie
+ *          zurück (Interrupts des Busses gesperrt)
+ *
+ * @details
+ * Ein Teilnehmer, der mitten in einem Lesezugriff stehen geblieben ist,
+ * hält SDA low, bis er sein Byte fertig ausgegeben hat: bis zu 9
+ * SCL-Takte (100 kHz) per GPIO, bis SDA high ist, danach ein STOP. Der
+ * Reset über RCC löscht ein durch die Flanken gesetztes BUSY, die
+ * Peripherie wird mit den Einstellungen des Handles neu initialisiert.
+ *
+ * @param   bus I2C-Bus
+ * @return  None
+ */
+static void env_sensor_bus_recover(env_sensor_bus_t *bus)
+{
+    I2C_TypeDef *instance = bus->i2c_handle.Instance;
+    GPIO_TypeDef *scl_port = (instance == I2C1) ? GPIOB : GPIOA;
+    GPIO_TypeDef *sda_port = (instance == I2C1) ? GPIOB : GPIOC;
+    uint16_t scl_pin = (instance == I2C1) ? GPIO_PIN_6 : GPIO_PIN_8;
+    uint16_t sda_pin = (instance == I2C1) ? GPIO_PIN_7 : GPIO_PIN_9;
+    GPIO_InitTypeDef gpio_init;
+
+    __HAL_I2C_DISABLE(&bus->i2c_handle);
+
+    /* SCL und SDA als Open-Drain-Ausgänge, losgelassen */
+    HAL_GPIO_WritePin(scl_port, scl_pin, GPIO_PIN_SET);
+    HAL_GPIO_WritePin(sda_port, sda_pin, GPIO_PIN_SET);
+    gpio_init.Mode      = GPIO_MODE_OUTPUT_OD;
+    gpio_init.Pull      = GPIO_PULLUP;
+    gpio_init.Speed     = GPIO_SPEED_FREQ_MEDIUM;
+    gpio_init.Alternate = 0;
+    gpio_init.Pin       = scl_pin;
+    HAL_GPIO_Init(scl_port, &gpio_init);
+    gpio_init.Pin       = sda_pin;
+    HAL_GPIO_Init(sda_port, &gpio_init);
+    utils_delay_us(5);
+
+    for (uint8_t i = 0; (i < 9) && (HAL_GPIO_ReadPin(sda_port, sda_pin) == GPIO_PIN_RESET); i++) {
+        HAL_GPIO_WritePin(scl_port, scl_pin, GPIO_PIN_RESET);
+        utils_delay_us(5);
+        HAL_GPIO_WritePin(scl_port, scl_pin, GPIO_PIN_SET);
+        utils_delay_us(5);
+    }
+
+    /* STOP: SDA steigt bei SCL high */
+    HAL_GPIO_WritePin(scl_port, scl_pin, GPIO_PIN_RESET);
+    utils_delay_us(5);
+    HAL_GPIO_WritePin(sda_port, sda_pin, GPIO_PIN_RESET);
+    utils_delay_us(5);
+    HAL_GPIO_WritePin(scl_port, scl_pin, GPIO_PIN_SET);
+    utils_delay_us(5);
+    HAL_GPIO_WritePin(sda_port, sda_pin, GPIO_PIN_SET);
+    utils_delay_us(5);
+
+    env_sensor_init_gpio(instance);
+
+    if (instance == I2C1) {
+        __HAL_RCC_I2C1_FORCE_RESET();
+        __HAL_RCC_I2C1_RELEASE_RESET();
+    } else {
+        __HAL_RCC_I2C3_FORCE_RESET();
+        __HAL_RCC_I2C3_RELEASE_RESET();
+    }
+    HAL_I2C_Init(&bus->i2c_handle);
+
+    bus->recoveries++;
+    BKPTRACE_EVENT(BKPTRACE_EV_ENV_BUS_RECOVER, (uintptr_t)instance);
+}
+
+#if ENV_SENSOR_SPI_ENABLE
+/**
+ * @brief   Transferende eines SPI-Busses
+ *
+ * @param   hspi  SPI-Handle
+ * @param   error 1 bei Busfehler
+ * @return  None
+ */
+static void env_sensor_spi_done(SPI_HandleTypeDef *hspi, uint8_t error)
+{
+    for (uint8_t i = 0; i < spi_bus_count; i++) {
+        /* SPI5 meldet das Ende über env_sensor_lcd_done(), Fehler dort
+         * gehören zu Transfers des LCD */
+        if ((spi_buses[i].spi == hspi) && !spi_buses[i].shared) {
+            env_sensor_bus_done(&spi_buses[i], error);
+            return;
+        }
+    }
+}
+
+/**
+ * @brief   SPI5 vom Arbiter zugeteilt: Chip-Select und Transfer des
+ *          wartenden Zugriffs (Interrupt-Kontext)
+ *
+ * @param   client Teilnehmer des Busses
+ * @return  None
+ */
+static void env_sensor_lcd_grant(ILI9341_Bus_Client_t *client)
+{
+    env_sensor_bus_t *bus = (env_sensor_bus_t *)client->Context;
+    env_sensor_t *sensor = bus->owner;
+
+    if ((sensor == NULL) || (bus->spi_data == NULL)) {
+        return;
+    }
+
+    bus->granted = 1;
+    HAL_GPIO_WritePin(sensor->config.cs_port, sensor->config.cs_pin, GPIO_PIN_RESET);
+    if (ILI9341_Bus_Transfer(bus->spi_data, bus->spi_len) != HAL_OK) {
+        bus->spi_data = NULL;
+        env_sensor_bus_done(bus, 1);
+    }
+    bus->granted = 0;
+}
+
+/**
+ * @brief   Transferende auf SPI5 (SPI5 RX DMA Interrupt); der nächste
+ *          angeforderte Zugriff läuft noch mit derselben Zuteilung
+ *
+ * @param   client Teilnehmer des Busses
+ * @return  None
+ */
+static void env_sensor_lcd_done(ILI9341_Bus_Client_t *client)
+{
+    env_sensor_bus_t *bus = (env_sensor_bus_t *)client->Context;
+
+    bus->granted  = 1;
+    bus->spi_data = NULL;
+    env_sensor_bus_done(bus, 0);
+    bus->granted  = 0;
+}
+#endif
+
+/**
+ * @brief   Startet einen SPI-Transfer des Sensors bus->owner, Chip-Select
+ *          bis zum Transferende (env_sensor_bus_done())
+ *
+ * @details
+ * Handles der Anwendung übertragen per DMA, wenn hdmatx und hdmarx
+ * verknüpft sind, sonst per Interrupt. Auf SPI5 läuft der Transfer
+ * im Puffer rx über den Arbiter des LCD: sofort, wenn der Bus gerade
+ * zugeteilt ist (Aufruf aus env_sensor_lcd_done()), sonst beim Grant;
+ * Chip-Select erst dann, das LCD taktet bis dahin weiter.
+ *
+ * @param   bus SPI-Bus
+ * @param   tx  Sendedaten
+ * @param   rx  Empfangsdaten, len Bytes
+ * @param   len Bytes mit Adressbyte
+ * @return  HAL-Status des Starts, HAL_ERROR ohne SPI-Unterstützung
+ */
+static HAL_StatusTypeDef env_sensor_spi_transfer(env_sensor_bus_t *bus, uint8_t *tx, uint8_t *rx, uint16_t len)
+{
+#if ENV_SENSOR_SPI_ENABLE
+    const env_sensor_t *sensor = bus->owner;
+    HAL_StatusTypeDef status;
+
+    if (bus->shared) {
+        if (tx != rx) {
+            memcpy(rx, tx, len);
+        }
+        bus->spi_data = rx;
+        bus->spi_len  = len;
+        if (!bus->granted) {
+            ILI9341_Bus_Request(&bus->lcd_client);
+            return HAL_OK;
+        }
+        HAL_GPIO_WritePin(sensor->config.cs_port, sensor->config.cs_pin, GPIO_PIN_RESET);
+        status = ILI9341_Bus_Transfer(rx, len);
+        if (status != HAL_OK) {
+            bus->spi_data = NULL;
+        }
+        return status;
+    }
+
+    HAL_GPIO_WritePin(sensor->config.cs_port, sensor->config.cs_pin, GPIO_PIN_RESET);
+    if ((bus->spi->hdmatx != NULL) && (bus->spi->hdmarx != NULL)) {
+        return HAL_SPI_TransmitReceive_DMA(bus->spi, tx, rx, len);
+    }
+    return HAL_SPI_TransmitReceive_IT(bus->spi, tx, rx, len);
+#else
+    (void)bus;
+    (void)tx;
+    (void)rx;
+    (void)len;
+    return HAL_ERROR;
+#endif
+}
+
+/**
+ * @brief   Übernimmt neue Messwerte (Zustand READY -> IDLE)
+ *
+ * @param   sensor Instanz
+ * @return  HAL_OK bei neuen Daten bzw. im Ersatzbetrieb, HAL_BUSY
+ *          während der Messung, HAL_ERROR sonst
+ */
+static HAL_StatusTypeDef env_sensor_take(env_sensor_t *sensor)
+{
+    if (sensor->state == ENV_SENSOR_BUSY) {
+        return HAL_BUSY;
+    }
+
+    sensor->degraded = 0;
+    if (sensor->state == ENV_SENSOR_ERROR) {
+        /* Ersatzbetrieb: data bzw. raw enthalten noch die letzte gültige
+         * Messung (nur ein erfolgreicher Burst überschreibt sie) */
+        if (!sensor->has_good || (ENV_SENSOR_DEGRADED_MAX_MS == 0) ||
+            ((HAL_GetTick() - sensor->good_tick) > ENV_SENSOR_DEGRADED_MAX_MS)) {
+            return HAL_ERROR;
+        }
+        sensor->degraded = 1;
+    } else if (sensor->state != ENV_SENSOR_READY) {
+        return HAL_ERROR;
+    }
+
+    sensor->state = ENV_SENSOR_IDLE;
+
+    /* ENV_SENSOR_DEFERRED: erst jetzt kompensieren */
+    if (sensor->raw_pending) {
+        env_sensor_compensate(sensor);
+    }
+
+    return HAL_OK;
+}
+
+/**
+ * @brief   Rechnet die kompensierten Werte in Gleitkomma um
+ *
+ * @details
+ * Mit Integer-Kompensation (BME280_32BIT_ENABLE / BME280_64BIT_ENABLE)
+ * nur in float, ohne die Software-double-Bibliothek.
+ *
+ * @param   sensor      Instanz
+ * @param   temperature Temperatur in Grad Celsius
+ * @param   pressure    Luftdruck in hPa
+ * @param   humidity    Relative Luftfeuchtigkeit in Prozent
+ * @return  None
+ */
+static void env_sensor_copy_float(const env_sensor_t *sensor, float *temperature, float *pressure, float *humidity)
+{
+#ifdef BME280_DOUBLE_ENABLE
+    *temperature = (float)sensor->data.temperature;
+    *pressure    = (float)(sensor->data.pressure / 100.0);
+    *humidity    = (float)sensor->data.humidity;
+#else
+    int32_t  centi_celsius;
+    uint32_t pascal;
+    uint32_t milli_rh;
+
+    env_sensor_copy_fixed(sensor, &centi_celsius, &pascal, &milli_rh);
+
+    *temperature = (float)centi_celsius / 100.0f;
+    *pressure    = (float)pascal / 100.0f;
+    *humidity    = (float)milli_rh / 1000.0f;
+#endif
+}
+
+/**
+ * @brief   Rechnet die kompensierten Werte in Festkomma um
+ *
+ * @param   sensor        Instanz
+ * @param   centi_celsius Temperatur in 0,01 Grad Celsius
+ * @param   pascal        Luftdruck in Pa
+ * @param   milli_rh      Relative Luftfeuchtigkeit in 0,001 %
+ * @return  None
+ */
+static void env_sensor_copy_fixed(const env_sensor_t *sensor, int32_t *centi_celsius, uint32_t *pascal, uint32_t *milli_rh)
+{
+    env_sensor_data_fixed(&sensor->data, centi_celsius, pascal, milli_rh);
+}
+
+/**
+ * @brief   Rechnet Werte der Library-Kompensation in Festkomma um
+ *
+ * @details
+ * Integer-Kompensation der Library: Temperatur in 0,01 Grad Celsius,
+ * Luftdruck in 0,01 Pa (64 Bit) bzw. Pa (32 Bit), Feuchte in 1/1024 %.
+ *
+ * @param   data          Kompensierte Werte
+ * @param   centi_celsius Temperatur in 0,01 Grad Celsius
+ * @param   pascal        Luftdruck in Pa
+ * @param   milli_rh      Relative Luftfeuchtigkeit in 0,001 %
+ * @return  None
+ */
+static void env_sensor_data_fixed(const struct bme280_data *data, int32_t *centi_celsius, uint32_t *pascal,
+                                  uint32_t *milli_rh)
+{
+#ifdef BME280_DOUBLE_ENABLE
+    *centi_celsius = (int32_t)(data->temperature * 100.0);
+    *pascal        = (uint32_t)(data->pressure + 0.5);
+    *milli_rh      = (uint32_t)(data->humidity * 1000.0 + 0.5);
+#else
+    *centi_celsius = data->temperature;
+#ifdef BME280_32BIT_ENABLE
+    *pascal        = data->pressure;
+#else
+    *pascal        = (data->pressure + 50) / 100;
+#endif
+    *milli_rh      = (data->humidity * 1000 + 512) / 1024;
+#endif
+}
+
+/**
+ * @brief   Zerlegt die 8 Datenbytes eines Bursts in die Rohwerte
+ *
+ * @details
+ * Ab 0xF7: Druck und Temperatur je 20 Bit (MSB, LSB, XLSB[7:4]),
+ * Feuchte 16 Bit.
+ *
+ * @param   raw         BME280_LEN_P_T_H_DATA Bytes
+ * @param   uncomp_data Ziel
+ * @return  None
+ */
+static void env_sensor_unpack(const uint8_t *raw, struct bme280_uncomp_data *uncomp_data)
+{
+    uncomp_data->pressure    = ((uint32_t)raw[0] << 12) | ((uint32_t)raw[1] << 4) | ((uint32_t)raw[2] >> 4);
+    uncomp_data->temperature = ((uint32_t)raw[3] << 12) | ((uint32_t)raw[4] << 4) | ((uint32_t)raw[5] >> 4);
+    uncomp_data->humidity    = ((uint32_t)raw[6] << 8)  | (uint32_t)raw[7];
+}
+
+/**
+ * @brief   Übernimmt den Burst-Read eines Sensors
+ *
+ * @details
+ * Erstes Byte ist das Statusregister (0xF3, bei SPI nach dem
+ * Adressbyte), die Daten beginnen bei 0xF7. Die 8 Datenbytes werden
+ * kopiert; ohne ENV_SENSOR_DEFERRED wird sofort kompensiert, sonst erst
+ * beim Abholen, und der Datenlogger bekommt die Rohwerte.
+ *
+ * @param   sensor Instanz
+ * @return  None
+ */
+static void env_sensor_parse_burst(env_sensor_t *sensor)
+{
+    memcpy(sensor->raw, &sensor->burst[((sensor->config.i2c == NULL) ? 1 : 0) +
+                                       (BME280_REG_DATA - BME280_REG_STATUS)], sizeof(sensor->raw));
+
+#if ENV_SENSOR_DEFERRED
+    sensor->raw_pending = 1;
+
+#if DATALOG_ENABLE
+    {
+        uint32_t u32_now = utils_now_cycles();
+        struct bme280_uncomp_data uncomp_data;
+
+        /* Temperatur zuerst, env_sensor_datalog_filter() braucht sie für die beiden anderen */
+        env_sensor_unpack(sensor->raw, &uncomp_data);
+        DATALOG_LOG_AT(DATALOG_CH_ENV_RAW_TEMP, uncomp_data.temperature, u32_now);
+        DATALOG_LOG_AT(DATALOG_CH_ENV_RAW_PRESS, uncomp_data.pressure, u32_now);
+        DATALOG_LOG_AT(DATALOG_CH_ENV_RAW_HUM, uncomp_data.humidity, u32_now);
+    }
+#endif
+#else
+    env_sensor_compensate(sensor);
+#endif
+}
+
+/**
+ * @brief   Kompensiert die Rohdaten des letzten Bursts
+ *
+ * @details
+ * Schreibt sensor->data und die laufende Statistik; ohne
+ * ENV_SENSOR_DEFERRED auch die Werte in den Datenlogger.
+ *
+ * @param   sensor Instanz
+ * @return  None
+ */
+static void env_sensor_compensate(env_sensor_t *sensor)
+{
+    struct bme280_uncomp_data uncomp_data;
+
+    sensor->raw_pending = 0;
+    env_sensor_unpack(sensor->raw, &uncomp_data);
+    bme280_compensate_data(BME280_ALL, &uncomp_data, &sensor->data, &sensor->dev.calib_data);
+
+    {
+        float temperature;
+        float pressure;
+        float humidity;
+
+        env_sensor_copy_float(sensor, &temperature, &pressure, &humidity);
+        stats_welford_add(&sensor->stats[ENV_SENSOR_STATS_TEMPERATURE], temperature);
+        stats_welford_add(&sensor->stats[ENV_SENSOR_STATS_PRESSURE], pressure);
+        stats_welford_add(&sensor->stats[ENV_SENSOR_STATS_HUMIDITY], humidity);
+    }
+
+#if DATALOG_ENABLE && !ENV_SENSOR_DEFERRED
+    {
+        uint32_t u32_now = utils_now_cycles();
+        int32_t centi_celsius;
+        uint32_t pascal;
+        uint32_t milli_rh;
+
+        /* Festkomma wie env_sensor_get_data_fixed(), alle drei mit demselben Zeitstempel */
+        env_sensor_copy_fixed(sensor, &centi_celsius, &pascal, &milli_rh);
+        DATALOG_LOG_AT(DATALOG_CH_ENV_TEMP, centi_celsius, u32_now);
+        DATALOG_LOG_AT(DATALOG_CH_ENV_PRESS, pascal, u32_now);
+        DATALOG_LOG_AT(DATALOG_CH_ENV_HUM, milli_rh, u32_now);
+    }
+#endif
+}
+
+/**
+ * @brief   Oversampling der aktuellen Stufe
+ *
+ * @details
+ * Je Stufe halbes Druck- und Temperatur-Oversampling (Registerwert - 1),
+ * mindestens 1x; abgeschaltete Messgrößen bleiben aus. Feuchte und
+ * Filter bleiben wie bei der Init, ctrl_hum müsste sonst zusätzlich
+ * geschrieben werden.
+ *
+ * @param   sensor   Instanz
+ * @param   settings Ziel
+ * @return  None
+ */
+static void env_sensor_osr_settings(const env_sensor_t *sensor, struct bme280_settings *settings)
+{
+    *settings = sensor->settings;
+
+    for (uint8_t i = 0; i < sensor->osr.level; i++) {
+        if (settings->osr_p > BME280_OVERSAMPLING_1X) {
+            settings->osr_p--;
+        }
+        if (settings->osr_t > BME280_OVERSAMPLING_1X) {
+            settings->osr_t--;
+        }
+    }
+}
+
+/**
+ * @brief   Berechnet die Messzeit der aktuellen Stufe neu
+ *
+ * @param   sensor Instanz
+ * @return  None
+ */
+static void env_sensor_osr_plan(env_sensor_t *sensor)
+{
+    struct bme280_settings settings;
+    uint32_t max_delay_us;
+
+    env_sensor_osr_settings(sensor, &settings);
+    if (bme280_cal_meas_delay(&max_delay_us, &settings) == BME280_OK) {
+        sensor->meas_delay_ms = (max_delay_us + 999) / 1000;
+    }
+}
+
+/**
+ * @brief   Wählt die Oversampling-Stufe nach der Änderung der Messwerte
+ *
+ * @details
+ * Eine Änderung über einer Schwelle setzt sofort die Stufe 0 (volles
+ * Oversampling), damit ein Sprung mit der vollen Auflösung verfolgt
+ * wird. Nach ENV_SENSOR_OSR_STEADY_COUNT Messungen unter der halben
+ * Schwelle geht es eine Stufe tiefer; dazwischen bleibt die Stufe.
+ *
+ * @param   sensor Instanz
+ * @return  None
+ */
+static void env_sensor_osr_adapt(env_sensor_t *sensor)
+{
+    static const int32_t threshold[ENV_SENSOR_STATS_COUNT] = {
+        ENV_SENSOR_OSR_DT_CENTI, ENV_SENSOR_OSR_DP_PA, ENV_SENSOR_OSR_DH_MILLI
+    };
+    env_sensor_osr_t *osr = &sensor->osr;
+    int32_t now[ENV_SENSOR_STATS_COUNT];
+    uint32_t pascal;
+    uint32_t milli_rh;
+    uint8_t level = osr->level;
+    uint8_t steady = 1;
+
+    /* Die Stufe braucht jede Messung kompensiert, auch mit ENV_SENSOR_DEFERRED */
+    if (sensor->raw_pending) {
+        env_sensor_compensate(sensor);
+    }
+    env_sensor_copy_fixed(sensor, &now[ENV_SENSOR_STATS_TEMPERATURE], &pascal, &milli_rh);
+    now[ENV_SENSOR_STATS_PRESSURE] = (int32_t)pascal;
+    now[ENV_SENSOR_STATS_HUMIDITY] = (int32_t)milli_rh;
+
+    if (osr->valid) {
+        for (uint8_t i = 0; i < ENV_SENSOR_STATS_COUNT; i++) {
+            int32_t delta = now[i] - osr->last[i];
+
+            if (delta < 0) {
+                delta = -delta;
+            }
+            if (delta > threshold[i]) {
+                level = 0;
+            }
+            if (2 * delta > threshold[i]) {
+                steady = 0;
+            }
+        }
+
+        if (!steady) {
+            osr->steady = 0;
+        } else if (++osr->steady >= ENV_SENSOR_OSR_STEADY_COUNT) {
+            osr->steady = 0;
+            if (level < ENV_SENSOR_OSR_MAX_LEVEL) {
+                level++;
+            }
+        }
+    }
+
+    memcpy(osr->last, now, sizeof(osr->last));
+    osr->valid = 1;
+
+    if (level != osr->level) {
+        osr->level = level;
+        env_sensor_osr_plan(sensor);
+    }
+}
+
+/* HAL callbacks / IRQ handlers */
+
+/**
+ * @brief   Transferende eines Lesezugriffs (IT oder DMA)
+ */
+void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+    env_sensor_bus_done((hi2c == &i2c1_bus.i2c_handle) ? &i2c1_bus : &i2c3_bus, 0);
+}
+
+/**
+ * @brief   Transferende eines Schreibzugriffs
+ */
+void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+    env_sensor_bus_done((hi2c == &i2c1_bus.i2c_handle) ? &i2c1_bus : &i2c3_bus, 0);
+}
+
+/**
+ * @brief   Busfehler, NACK oder DMA-Fehler
+ */
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+    env_sensor_bus_done((hi2c == &i2c1_bus.i2c_handle) ? &i2c1_bus : &i2c3_bus, 1);
+}
+
+#if ENV_SENSOR_SPI_ENABLE
+/**
+ * @brief   Transferende eines SPI-Zugriffs
+ */
+void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+    env_sensor_spi_done(hspi, 0);
+}
+
+/**
+ * @brief   SPI-Fehler
+ */
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi)
+{
+    env_sensor_spi_done(hspi, 1);
+}
+#endif
+
+void I2C1_EV_IRQHandler(void)
+{
+    HAL_I2C_EV_IRQHandler(&i2c1_bus.i2c_handle);
+}
+
+void I2C1_ER_IRQHandler(void)
+{
+    HAL_I2C_ER_IRQHandler(&i2c1_bus.i2c_handle);
+}
+
+void I2C3_EV_IRQHandler(void)
+{
+    HAL_I2C_EV_IRQHandler(&i2c3_bus.i2c_handle);
+}
+
+void I2C3_ER_IRQHandler(void)
+{
+    HAL_I2C_ER_IRQHandler(&i2c3_bus.i2c_handle);
 }
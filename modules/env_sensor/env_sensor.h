@@ -11,6 +11,58 @@
  * eines Umweltsensors (z. B. BME280) bereit. Es ermöglicht das Erfassen
  * von Temperatur, Luftdruck und Luftfeuchtigkeit.
  *
+ * Neben dem blockierenden env_sensor_read_data() gibt es eine nicht
+ * blockierende Messung: env_sensor_start_measurement() startet den
+ * Forced-Mode, env_sensor_poll() liest die Daten, sobald die aus dem
+ * Oversampling berechnete Messzeit (bme280_cal_meas_delay) abgelaufen
+ * ist, env_sensor_get_data() liefert sie ab. Der I2C-Bus läuft mit
+ * 400 kHz über Interrupt und DMA; die Messdaten werden im Hintergrund
+ * in einem Burst gelesen. Im Normal-Mode (env_sensor_start_normal())
+ * misst der Sensor kontinuierlich und es wird nur der letzte Wert
+ * gelesen.
+ *
+ * Mehrere Sensoren: je Sensor eine env_sensor_t Instanz, angeschlossen
+ * an I2C1 oder I2C3 (beide Adressen) oder an einen SPI-Bus. Die
+ * Funktionen ohne env_sensor_t Argument verwenden einen eingebauten
+ * Sensor an I2C1, Adresse BME280_I2C_ADDR_SEC. env_sensor_measure_all()
+ * startet alle Sensoren direkt nacheinander, sie wandeln also
+ * gleichzeitig; env_sensor_process() liest die fertigen Sensoren eines
+ * Busses per Burst hintereinander aus, der nächste Burst wird direkt
+ * aus dem Transferende-Interrupt gestartet.
+ *
+ * Warmstart (ENV_SENSOR_WARM_START): Kalibrierdaten und Einstellungen
+ * jedes Sensors werden nach der ersten Initialisierung im Backup-SRAM
+ * abgelegt, Schlüssel sind Chip-ID und Anschluss. Nach einem Reset
+ * (z. B. Brown-Out) liest env_sensor_add() nur Chip-ID, dig_T1 und die
+ * Steuerregister; Soft-Reset und Kalibrier-Transfer entfallen, die
+ * Steuerregister werden nur bei Abweichung neu geschrieben.
+ *
+ * Verzögerte Kompensation (ENV_SENSOR_DEFERRED): eine Messung kopiert
+ * nur die 8 Datenbytes des Bursts, kompensiert wird erst beim Abholen
+ * (env_sensor_fetch() usw.); die Statistik enthält dann nur abgeholte
+ * Messungen. Der Datenlogger bekommt die Rohwerte
+ * (DATALOG_CH_ENV_RAW_*), env_sensor_datalog_filter() als Dump-Filter
+ * (datalog_set_dump_filter()) kompensiert sie blockweise beim Export.
+ *
+ * Adaptives Oversampling (env_sensor_set_adaptive()): im Forced-Mode
+ * werden Druck- und Temperatur-Oversampling stufenweise halbiert,
+ * solange die Messwerte ruhig sind, und beim Überschreiten einer
+ * Änderungsschwelle sofort auf die Einstellungen der Init zurückgesetzt.
+ * Die Messzeit wird je Stufe mit bme280_cal_meas_delay neu berechnet,
+ * das Oversampling geht mit dem ctrl_meas-Zugriff ohnehin jeder Messung
+ * auf den Bus.
+ *
+ * Busfehler (I2C): ein Transfer ohne Ende nach ENV_SENSOR_XFER_TIMEOUT_MS
+ * wird abgebrochen, ein Bus mit Fehler bekommt eine Wartezeit
+ * (ENV_SENSOR_BACKOFF_MIN_MS, je weiterem Fehler verdoppelt bis
+ * ENV_SENSOR_BACKOFF_MAX_MS), in der kein Transfer startet; Anfragen
+ * kosten dann nur den Aufruf. Nach der Wartezeit wird ein hängender Bus
+ * (BUSY, z. B. ein Sensor hält SDA low) mit bis zu 9 SCL-Takten und
+ * STOP per GPIO freigetaktet und die Peripherie zurückgesetzt. Bis
+ * ENV_SENSOR_DEGRADED_MAX_MS nach der letzten gültigen Messung liefern
+ * env_sensor_fetch() usw. bei einem Fehler den letzten gültigen
+ * Messwert (env_sensor_is_degraded()).
+ *
  * Verwendete Module:
  *  - bme280
  *
@@ -24,6 +76,10 @@
 #define ENV_SENSOR_ENV_SENSOR_H_
 
 #include <bme280/bme280.h>
+#include <datalog/datalog.h>
+#include <irq/irq.h>
+#include <osal/osal.h>
+#include <stats/stats.h>
 #include "stm32f4xx.h"
 
 /* Public Preprocessor defines */
@@ -37,6 +93,268 @@
  */
 #define TIMEOUT 100
 
+/**
+ * @brief I2C-Takt in Hz (Fast-Mode)
+ */
+#define ENV_SENSOR_I2C_CLOCK_HZ      400000
+
+/**
+ * @brief NVIC-Priorität der I2C- und DMA-Interrupts
+ */
+#define ENV_SENSOR_I2C_IRQ_PRIORITY  IRQ_CLASS_TRANSFER
+
+/**
+ * @brief Länge des Burst-Reads: Status (0xF3) bis Feuchte LSB (0xFE)
+ */
+#define ENV_SENSOR_BURST_LEN         12
+
+/**
+ * @brief Maximale Anzahl Sensoren
+ */
+#define ENV_SENSOR_MAX_SENSORS       4
+
+/**
+ * @brief SPI-Anschluss des BME280 (env_sensor_config_t.spi); 0: nur I2C,
+ *        der SPI-Code des Moduls entfällt und env_sensor_add()
+ *        lehnt SPI-Anschlüsse ab
+ */
+#ifndef ENV_SENSOR_SPI_ENABLE
+#define ENV_SENSOR_SPI_ENABLE        1
+#endif
+
+/**
+ * @brief Maximale Anzahl SPI-Busse
+ */
+#define ENV_SENSOR_MAX_SPI_BUSES     2
+
+/**
+ * @brief Maximaler SPI-Takt des BME280 in Hz (Vorteiler am LCD-Arbiter)
+ */
+#define ENV_SENSOR_SPI_MAX_CLOCK     10000000UL
+
+/**
+ * @brief Maximale Anzahl weiterer Teilnehmer der I2C-Busse
+ *        (env_sensor_i2c_attach())
+ */
+#define ENV_SENSOR_MAX_I2C_CLIENTS   2
+
+/**
+ * @brief Transfers weiterer Teilnehmer ab dieser Länge per DMA, kürzere
+ *        per Interrupt
+ */
+#define ENV_SENSOR_I2C_DMA_MIN_LEN   4
+
+/**
+ * @brief Längste Dauer eines Hintergrund-Transfers in ms (Burst: 0,4 ms),
+ *        danach wird er abgebrochen und der Bus freigetaktet
+ */
+#define ENV_SENSOR_XFER_TIMEOUT_MS   10
+
+/**
+ * @brief Wartezeit nach dem ersten Busfehler in Folge und Obergrenze der
+ *        Verdopplung in ms
+ */
+#define ENV_SENSOR_BACKOFF_MIN_MS    20
+#define ENV_SENSOR_BACKOFF_MAX_MS    2000
+
+/**
+ * @brief Längste Wartezeit auf den Abschluss des vorigen STOP vor einem
+ *        Transferstart in µs (statt der 25 ms der HAL), danach gilt der
+ *        Bus als hängend
+ */
+#define ENV_SENSOR_BUSY_WAIT_US      50
+
+/**
+ * @brief Höchstes Alter des letzten gültigen Messwerts, der bei einem
+ *        Fehler statt HAL_ERROR geliefert wird, in ms (0 = nie)
+ */
+#ifndef ENV_SENSOR_DEGRADED_MAX_MS
+#define ENV_SENSOR_DEGRADED_MAX_MS   60000
+#endif
+
+/**
+ * @brief Warmstart aus dem Backup-SRAM (1 = an)
+ */
+#ifndef ENV_SENSOR_WARM_START
+#define ENV_SENSOR_WARM_START        1
+#endif
+
+/**
+ * @brief Verzögerte Kompensation (1 = an): Messungen legen nur den
+ *        Roh-Burst ab, kompensiert wird beim Abholen bzw. im Export
+ */
+#ifndef ENV_SENSOR_DEFERRED
+#define ENV_SENSOR_DEFERRED          0
+#endif
+
+/**
+ * @brief Adaptives Oversampling: tiefste Stufe (je Stufe halbes
+ *        Oversampling, mindestens 1x)
+ */
+#define ENV_SENSOR_OSR_MAX_LEVEL     4
+
+/**
+ * @brief Adaptives Oversampling: ruhige Messungen in Folge je Stufe nach
+ *        unten
+ */
+#define ENV_SENSOR_OSR_STEADY_COUNT  8
+
+/**
+ * @brief Adaptives Oversampling: Änderungsschwellen zwischen zwei
+ *        Messungen (0,01 Grad Celsius, Pa, 0,001 %). Darüber gilt wieder
+ *        volles Oversampling, unter der halben Schwelle ist eine Messung
+ *        ruhig.
+ */
+#define ENV_SENSOR_OSR_DT_CENTI      10
+#define ENV_SENSOR_OSR_DP_PA         12
+#define ENV_SENSOR_OSR_DH_MILLI      500
+
+/* Public type definitions */
+
+/**
+ * @brief Zustand der nicht blockierenden Messung
+ */
+typedef enum {
+    ENV_SENSOR_IDLE = 0,  /**< Keine Messung aktiv, keine neuen Daten */
+    ENV_SENSOR_BUSY,      /**< Messung läuft                          */
+    ENV_SENSOR_READY,     /**< Neue Daten liegen vor                  */
+    ENV_SENSOR_ERROR      /**< Kommunikationsfehler                   */
+} env_sensor_state_t;
+
+/**
+ * @brief Messgrößen der laufenden Statistik (env_sensor_get_stats())
+ */
+typedef enum {
+    ENV_SENSOR_STATS_TEMPERATURE = 0,  /**< Grad Celsius       */
+    ENV_SENSOR_STATS_PRESSURE,         /**< hPa                */
+    ENV_SENSOR_STATS_HUMIDITY,         /**< Prozent            */
+    ENV_SENSOR_STATS_COUNT
+} env_sensor_stats_t;
+
+/**
+ * @brief Zustand des adaptiven Oversamplings eines Sensors
+ */
+typedef struct {
+    uint8_t enabled;
+    uint8_t level;                         /**< Stufen unter der Init    */
+    uint8_t steady;                        /**< Ruhige Messungen in Folge */
+    uint8_t valid;                         /**< last gültig              */
+    int32_t last[ENV_SENSOR_STATS_COUNT];  /**< 0,01 °C, Pa, 0,001 %     */
+} env_sensor_osr_t;
+
+/**
+ * @brief Fehlerzähler eines Busses (env_sensor_get_bus_health())
+ */
+typedef struct {
+    uint32_t u32_errors;      /**< Fehlgeschlagene Transfers             */
+    uint32_t u32_timeouts;    /**< Davon ohne Transferende abgebrochen   */
+    uint32_t u32_recoveries;  /**< Freitakten mit Peripherie-Reset       */
+    uint16_t u16_backoff_ms;  /**< Laufende Wartezeit, 0 = Bus frei      */
+    uint8_t  u8_failures;     /**< Fehler in Folge                       */
+} env_sensor_bus_health_t;
+
+struct env_sensor_s;
+
+/**
+ * @brief Callback bei abgeschlossener Messung (aus env_sensor_poll() bzw.
+ *        env_sensor_process())
+ */
+typedef void (*env_sensor_callback_t)(struct env_sensor_s *sensor);
+
+/**
+ * @brief Anschluss eines Sensors
+ *
+ * @details
+ * I2C: i2c = I2C1 (PB6/PB7) oder I2C3 (PA8/PC9), i2c_addr =
+ * BME280_I2C_ADDR_PRIM oder BME280_I2C_ADDR_SEC. Der Bus wird beim
+ * ersten Sensor initialisiert.
+ * SPI: i2c = NULL, spi = von der Anwendung initialisiertes Handle
+ * (Mode 0 oder 3, max. 10 MHz, SPIx_IRQHandler ruft
+ * HAL_SPI_IRQHandler auf), cs_port/cs_pin = Chip-Select. Sind hdmatx
+ * und hdmarx verknüpft (__HAL_LINKDMA, DMA-Interrupts rufen
+ * HAL_DMA_IRQHandler auf), laufen die Transfers per DMA; der Burst
+ * (13 Bytes) dauert bei 10 MHz rund 11 µs statt 13 Interrupts. Die
+ * env_sensor_t Instanz darf dann nicht im CCM-RAM liegen.
+ * spi = &hspi5: der Sensor teilt SPI5 mit dem LCD (Init durch den
+ * LCD-Treiber vorher, z. B. PF7/PF8/PF9 gemeinsam mit dem Gyroskop).
+ * Die Zugriffe reihen sich beim Arbiter von ILI9341_STM32_Driver ein
+ * (ein Teilnehmer, Takt auf ENV_SENSOR_SPI_MAX_CLOCK begrenzt) und
+ * warten höchstens einen Block des LCD (ILI9341_BUS_MAX_BLOCK).
+ */
+typedef struct {
+    I2C_TypeDef       *i2c;
+    uint8_t            i2c_addr;
+    SPI_HandleTypeDef *spi;
+    GPIO_TypeDef      *cs_port;
+    uint16_t           cs_pin;
+} env_sensor_config_t;
+
+struct env_sensor_bus_s;
+
+/**
+ * @brief Zustand eines Sensors, von der Anwendung angelegt und mit
+ *        env_sensor_add() initialisiert
+ */
+typedef struct env_sensor_s {
+    env_sensor_config_t      config;
+    struct env_sensor_bus_s *bus;
+    struct bme280_dev        dev;
+    struct bme280_settings   settings;
+    struct bme280_data       data;
+    volatile env_sensor_state_t state;
+    env_sensor_callback_t    callback;
+    uint32_t                 meas_delay_ms;
+    uint32_t                 meas_start_tick;
+    volatile uint8_t         meas_reading;  /**< Burst angefordert/läuft  */
+    volatile uint8_t         pending;       /**< Angeforderte Transfers   */
+    volatile uint8_t         done;          /**< Transferende            */
+    osal_event_t             done_event;    /**< Weckt env_sensor_wait() */
+    volatile uint8_t         error;         /**< Busfehler               */
+    uint8_t                  normal_mode;
+    uint8_t                  warm_start;    /**< Kalibrierung aus Cache   */
+    uint8_t                  ctrl_meas[2];  /**< SPI: Adresse + Wert      */
+    uint8_t                  burst[ENV_SENSOR_BURST_LEN + 1];
+    uint8_t                  raw[BME280_LEN_P_T_H_DATA]; /**< Daten des letzten Bursts */
+    uint8_t                  raw_pending;   /**< raw noch nicht kompensiert */
+    stats_welford_t          stats[ENV_SENSOR_STATS_COUNT]; /**< Seit add/reset */
+    env_sensor_osr_t         osr;           /**< Adaptives Oversampling   */
+    uint32_t                 good_tick;     /**< Letzte gültige Messung   */
+    uint8_t                  has_good;      /**< data/raw sind gültig     */
+    uint8_t                  degraded;      /**< Abgeholt: letzter gültiger Wert */
+} env_sensor_t;
+
+struct env_sensor_i2c_client_s;
+
+/**
+ * @brief Transferende eines weiteren I2C-Teilnehmers (im Interrupt)
+ */
+typedef void (*env_sensor_i2c_done_t)(struct env_sensor_i2c_client_s *client, uint8_t error);
+
+/**
+ * @brief Weiterer Teilnehmer eines I2C-Busses (z. B. Touch-Controller
+ *        an I2C3)
+ *
+ * @details
+ * env_sensor besitzt die I2C-Peripherie und ihre HAL-Callbacks; andere
+ * Bausteine am selben Bus geben ihre Registerzugriffe über
+ * env_sensor_i2c_submit() ab und teilen sich die Busvergabe mit den
+ * Sensoren. i2c, i2c_addr, done und context setzt die Anwendung, der
+ * Rest ist intern.
+ */
+typedef struct env_sensor_i2c_client_s {
+    I2C_TypeDef             *i2c;          /**< I2C1 oder I2C3             */
+    uint8_t                  i2c_addr;     /**< 7-Bit-Adresse              */
+    env_sensor_i2c_done_t    done;
+    void                    *context;
+    struct env_sensor_bus_s *bus;
+    uint8_t                 *data;
+    uint16_t                 len;
+    uint8_t                  reg;
+    uint8_t                  write;
+    volatile uint8_t         pending;      /**< Transfer wartet auf den Bus */
+    volatile uint8_t         busy;         /**< Angefordert oder laufend    */
+} env_sensor_i2c_client_t;
+
 /* Public functions (prototypes) */
 
 /**
@@ -68,4 +386,318 @@ void env_sensor_read_data(float *temperature,
                           float *pressure,
                           float *humidity);
 
+/**
+ * @brief   Startet eine Messung im Forced-Mode, ohne zu warten
+ *
+ * @details
+ * Die Daten sind nach env_sensor_get_meas_delay_ms() verfügbar und
+ * werden von env_sensor_poll() abgeholt.
+ *
+ * @param   None
+ * @return  HAL_OK, HAL_BUSY wenn bereits eine Messung läuft,
+ *          HAL_ERROR bei Kommunikationsfehler
+ */
+HAL_StatusTypeDef env_sensor_start_measurement(void);
+
+/**
+ * @brief   Schreitet die laufende Messung fort
+ *
+ * @details
+ * Liest nach Ablauf der Messzeit das Statusregister und, falls die
+ * Messung abgeschlossen ist, die Messwerte. Danach wird der Callback
+ * aufgerufen. Muss zyklisch aus der Hauptschleife aufgerufen werden.
+ *
+ * @param   None
+ * @return  Aktueller Zustand
+ */
+env_sensor_state_t env_sensor_poll(void);
+
+/**
+ * @brief   Holt die Messwerte der letzten abgeschlossenen Messung ab
+ *
+ * @param   temperature Zeiger auf die Temperatur in Grad Celsius
+ * @param   pressure    Zeiger auf den Luftdruck in hPa
+ * @param   humidity    Zeiger auf die relative Luftfeuchtigkeit in Prozent
+ *
+ * @return  HAL_OK bei neuen Daten (Zustand wird ENV_SENSOR_IDLE) bzw.
+ *          nach einem Fehler mit dem letzten gültigen Wert
+ *          (env_sensor_is_degraded()), HAL_BUSY während der Messung,
+ *          HAL_ERROR sonst
+ */
+HAL_StatusTypeDef env_sensor_get_data(float *temperature,
+                                      float *pressure,
+                                      float *humidity);
+
+/**
+ * @brief   Holt die Messwerte der letzten Messung als Festkommawerte ab
+ *
+ * @details
+ * Mit BME280_64BIT_ENABLE oder BME280_32BIT_ENABLE (Projekt-Define)
+ * rechnet die Kompensation nur mit Ganzzahlen; ohne diese Defines
+ * verwendet die Library double (auf dem Cortex-M4 in Software).
+ *
+ * @param   centi_celsius Temperatur in 0,01 Grad Celsius
+ * @param   pascal        Luftdruck in Pa
+ * @param   milli_rh      Relative Luftfeuchtigkeit in 0,001 %
+ *
+ * @return  HAL_OK bei neuen Daten bzw. dem letzten gültigen Wert,
+ *          HAL_BUSY während der Messung, HAL_ERROR sonst
+ */
+HAL_StatusTypeDef env_sensor_get_data_fixed(int32_t *centi_celsius,
+                                            uint32_t *pascal,
+                                            uint32_t *milli_rh);
+
+/**
+ * @brief   Setzt den Callback für abgeschlossene Messungen
+ *
+ * @param   callback Funktion oder NULL
+ * @return  None
+ */
+void env_sensor_set_callback(env_sensor_callback_t callback);
+
+/**
+ * @brief   Startet die kontinuierliche Messung im Normal-Mode
+ *
+ * @details
+ * Der BME280 misst selbständig alle Messzeit + standby_time. Danach
+ * startet env_sensor_start_measurement() nur noch den Burst-Read des
+ * letzten Messwerts, ohne Wartezeit.
+ *
+ * @param   standby_time BME280_STANDBY_TIME_0_5_MS .. BME280_STANDBY_TIME_20_MS
+ * @return  HAL_OK oder HAL_ERROR
+ */
+HAL_StatusTypeDef env_sensor_start_normal(uint8_t standby_time);
+
+/**
+ * @brief   Beendet den Normal-Mode, der Sensor geht in den Sleep-Mode
+ *
+ * @param   None
+ * @return  HAL_OK oder HAL_ERROR
+ */
+HAL_StatusTypeDef env_sensor_stop_normal(void);
+
+/**
+ * @brief   Liefert die Messzeit für das eingestellte Oversampling
+ *
+ * @param   None
+ * @return  Messzeit in Millisekunden (aufgerundet)
+ */
+uint32_t env_sensor_get_meas_delay_ms(void);
+
+/**
+ * @brief   Initialisiert einen Sensor und meldet ihn beim Scheduler an
+ *
+ * @param   sensor Instanz
+ * @param   config Anschluss, wird in die Instanz kopiert
+ * @return  HAL_OK, HAL_ERROR bei ungültigem Anschluss, fehlendem Sensor
+ *          oder zu vielen Sensoren
+ */
+HAL_StatusTypeDef env_sensor_add(env_sensor_t *sensor, const env_sensor_config_t *config);
+
+/**
+ * @brief   Startet eine Messung eines Sensors (Forced-Mode) bzw. im
+ *          Normal-Mode den Burst-Read des letzten Messwerts
+ *
+ * @param   sensor Instanz
+ * @return  HAL_OK, HAL_BUSY oder HAL_ERROR
+ */
+HAL_StatusTypeDef env_sensor_measure(env_sensor_t *sensor);
+
+/**
+ * @brief   Schreitet die Messung eines Sensors fort
+ *
+ * @param   sensor Instanz
+ * @return  Aktueller Zustand
+ */
+env_sensor_state_t env_sensor_step(env_sensor_t *sensor);
+
+/**
+ * @brief   Holt die Messwerte eines Sensors ab
+ *
+ * @param   sensor      Instanz
+ * @param   temperature Temperatur in Grad Celsius
+ * @param   pressure    Luftdruck in hPa
+ * @param   humidity    Relative Luftfeuchtigkeit in Prozent
+ * @return  HAL_OK, HAL_BUSY oder HAL_ERROR
+ */
+HAL_StatusTypeDef env_sensor_fetch(env_sensor_t *sensor,
+                                   float *temperature,
+                                   float *pressure,
+                                   float *humidity);
+
+/**
+ * @brief   Holt die Messwerte eines Sensors als Festkommawerte ab
+ *
+ * @param   sensor        Instanz
+ * @param   centi_celsius Temperatur in 0,01 Grad Celsius
+ * @param   pascal        Luftdruck in Pa
+ * @param   milli_rh      Relative Luftfeuchtigkeit in 0,001 %
+ * @return  HAL_OK, HAL_BUSY oder HAL_ERROR
+ */
+HAL_StatusTypeDef env_sensor_fetch_fixed(env_sensor_t *sensor,
+                                         int32_t *centi_celsius,
+                                         uint32_t *pascal,
+                                         uint32_t *milli_rh);
+
+/**
+ * @brief   Setzt den Callback eines Sensors
+ *
+ * @param   sensor   Instanz
+ * @param   callback Funktion oder NULL
+ * @return  None
+ */
+void env_sensor_set_sensor_callback(env_sensor_t *sensor, env_sensor_callback_t callback);
+
+/**
+ * @brief   Schaltet einen Sensor in den Normal-Mode
+ *
+ * @param   sensor       Instanz
+ * @param   standby_time BME280_STANDBY_TIME_0_5_MS .. BME280_STANDBY_TIME_20_MS
+ * @return  HAL_OK oder HAL_ERROR
+ */
+HAL_StatusTypeDef env_sensor_set_normal(env_sensor_t *sensor, uint8_t standby_time);
+
+/**
+ * @brief   Schaltet einen Sensor zurück in Sleep- / Forced-Mode
+ *
+ * @param   sensor Instanz
+ * @return  HAL_OK oder HAL_ERROR
+ */
+HAL_StatusTypeDef env_sensor_set_forced(env_sensor_t *sensor);
+
+/**
+ * @brief   Schaltet das adaptive Oversampling eines Sensors ein oder aus
+ *
+ * @details
+ * Wirkt im Forced-Mode; ausgeschaltet gelten wieder die Einstellungen
+ * der Init.
+ *
+ * @param   sensor Instanz
+ * @param   enable 1 = an, 0 = aus
+ * @return  None
+ */
+void env_sensor_set_adaptive(env_sensor_t *sensor, uint8_t enable);
+
+/**
+ * @brief   Startet alle angemeldeten Sensoren, die nicht messen
+ *
+ * @param   None
+ * @return  None
+ */
+void env_sensor_measure_all(void);
+
+/**
+ * @brief   Schreitet alle angemeldeten Sensoren fort (Hauptschleife)
+ *
+ * @param   None
+ * @return  Anzahl Sensoren mit neuen Daten (ENV_SENSOR_READY)
+ */
+uint8_t env_sensor_process(void);
+
+/**
+ * @brief   Liefert den eingebauten Sensor der Funktionen ohne Instanz
+ *
+ * @param   None
+ * @return  Instanz
+ */
+env_sensor_t *env_sensor_get_default(void);
+
+/**
+ * @brief   Verwirft die Kalibrierdaten im Backup-SRAM
+ *
+ * @details
+ * Nach dem Tausch eines Sensors bei erhaltener VBAT-Versorgung; die
+ * nächste Initialisierung liest die Kalibrierung wieder vom Sensor.
+ *
+ * @param   None
+ * @return  None
+ */
+void env_sensor_cache_invalidate(void);
+
+/**
+ * @brief   Kopiert die laufende Statistik der Messwerte eines Sensors
+ *
+ * @details
+ * Mittelwert, Standardabweichung, Minimum und Maximum jeder Messgröße
+ * seit env_sensor_add() bzw. env_sensor_reset_stats(), z. B. für das
+ * Rauschen des Sensors bei gewähltem Oversampling.
+ *
+ * @param   sensor Instanz
+ * @param   stats  Ziel, Index env_sensor_stats_t
+ * @return  None
+ */
+void env_sensor_get_stats(const env_sensor_t *sensor, stats_welford_t stats[ENV_SENSOR_STATS_COUNT]);
+
+/**
+ * @brief   Meldet, ob die zuletzt abgeholten Messwerte der letzte gültige
+ *          Wert statt einer neuen Messung waren
+ *
+ * @param   sensor Instanz
+ * @return  1 im Ersatzbetrieb, 0 sonst
+ */
+uint8_t env_sensor_is_degraded(const env_sensor_t *sensor);
+
+/**
+ * @brief   Kopiert die Fehlerzähler des Busses eines Sensors
+ *
+ * @param   sensor Instanz
+ * @param   health Ziel
+ * @return  HAL_OK, HAL_ERROR ohne Bus
+ */
+HAL_StatusTypeDef env_sensor_get_bus_health(const env_sensor_t *sensor, env_sensor_bus_health_t *health);
+
+/**
+ * @brief   Startet die Statistik der Messwerte eines Sensors neu
+ *
+ * @param   sensor Instanz
+ * @return  None
+ */
+void env_sensor_reset_stats(env_sensor_t *sensor);
+
+/**
+ * @brief   Dump-Filter des Datenloggers: kompensiert die Rohwerte
+ *          (DATALOG_CH_ENV_RAW_*) blockweise
+ *
+ * @details
+ * Mit der Kalibrierung des ersten angemeldeten Sensors;
+ * datalog_set_dump_filter(env_sensor_datalog_filter).
+ *
+ * @param   records   Block
+ * @param   u32_count Records im Block
+ * @param   u32_index Position im Dump, 0 am Anfang
+ * @return  None
+ */
+void env_sensor_datalog_filter(datalog_record_t *records, uint32_t u32_count, uint32_t u32_index);
+
+/**
+ * @brief   Meldet einen weiteren Teilnehmer an einem I2C-Bus an
+ *
+ * @details
+ * Initialisiert den Bus, falls noch kein Sensor daran hängt.
+ *
+ * @param   client Teilnehmer mit i2c, i2c_addr und done
+ * @return  HAL_OK, HAL_ERROR bei ungültigem Bus oder ohne freien Platz
+ */
+HAL_StatusTypeDef env_sensor_i2c_attach(env_sensor_i2c_client_t *client);
+
+/**
+ * @brief   Fordert einen Registerzugriff eines Teilnehmers an
+ *
+ * @details
+ * Wartet nicht: ist der Bus frei, startet der Transfer sofort, sonst am
+ * Ende des laufenden Transfers (Teilnehmer vor den Sensoren). Das Ende
+ * meldet client->done im Transferende-Interrupt; dort darf der nächste
+ * Zugriff angefordert werden. Aufruf auch aus Interrupts.
+ *
+ * @param   client Teilnehmer
+ * @param   reg    Registeradresse
+ * @param   data   Quelle bzw. Ziel, gültig bis zum Transferende
+ * @param   len    Anzahl Bytes
+ * @param   write  1 = Schreiben, 0 = Lesen
+ * @return  HAL_OK, HAL_BUSY solange ein Zugriff des Teilnehmers
+ *          aussteht, HAL_ERROR ohne Anmeldung
+ */
+HAL_StatusTypeDef env_sensor_i2c_submit(env_sensor_i2c_client_t *client, uint8_t reg, uint8_t *data,
+                                        uint16_t len, uint8_t write);
+
 #endif /* ENV_SENSOR_ENV_SENSOR_H_ */
@@ -10,6 +10,187 @@
 
 #include "stm32f4xx.h"
 #include "esd.h"
+#include <clock/clock.h>
+#include <ll/ll.h>
+#include <utils/utils.h>
+#include <tim_alloc/tim_alloc.h>
+
+/* Private Preprocessor defines */
+
+/** @brief Alle Steuerleitungen (Port D) */
+#define CNTL_ALL_PD		(CNTL1_PD | CNTL2_PD | CNTL3_PD | CNTL4_PD)
+
+/**
+ * @brief BSRR-Anteil eines Segments: Segment ein = LOW = Reset-Hälfte,
+ *        Segment aus = HIGH = Set-Hälfte.
+ */
+#define SEGMENT_BSRR(pattern, segment, pin) \
+	(((pattern) & (segment)) ? ((uint32_t)(pin) << 16) : (uint32_t)(pin))
+
+/** @brief BSRR-Wort für Port D (Segmente A–F) */
+#define SEGMENT_BSRR_D(pattern) \
+	(SEGMENT_BSRR(pattern, ESD_SEGMENT_A, A_PD) | SEGMENT_BSRR(pattern, ESD_SEGMENT_B, B_PD) | \
+	 SEGMENT_BSRR(pattern, ESD_SEGMENT_C, C_PD) | SEGMENT_BSRR(pattern, ESD_SEGMENT_D, D_PD) | \
+	 SEGMENT_BSRR(pattern, ESD_SEGMENT_E, E_PD) | SEGMENT_BSRR(pattern, ESD_SEGMENT_F, F_PD))
+
+/** @brief BSRR-Wort für Port E (Segment G, Komma) */
+#define SEGMENT_BSRR_E(pattern) \
+	(SEGMENT_BSRR(pattern, ESD_SEGMENT_G, G_PE) | SEGMENT_BSRR(pattern, ESD_SEGMENT_DOT, DOT_PE))
+
+/** @brief Eintrag der Zeichentabelle */
+#define DIGIT_ENTRY(pattern) { (pattern), SEGMENT_BSRR_D(pattern), SEGMENT_BSRR_E(pattern) }
+
+/**
+ * @brief Ganzzahlige Division durch 1000, 100 und 10 als Multiplikation mit
+ *        dem Kehrwert (Festkomma 2^-23, 2^-12, 2^-10).
+ *
+ * Exakt für die Wertebereiche der Zerlegung (0–9999, 0–999, 0–99), auf dem
+ * Cortex-M4 je ein MUL und ein Shift statt UDIV.
+ */
+#define DIV1000(value)		(((uint32_t)(value) * 8389U) >> 23)
+#define DIV100(value)		(((uint32_t)(value) * 41U) >> 12)
+#define DIV10(value)		(((uint32_t)(value) * 103U) >> 10)
+
+/** @brief Größter darstellbarer Wert (vierstellig, dreistellig mit Minus) */
+#define NUMBER_MAX			9999
+#define NUMBER_MIN			(-999)
+
+/** @brief Mindestlänge eines Abschnitts in Zähltakten (Dunkelzeit + Anzeige) */
+#define REFRESH_MIN_RELOAD	4U
+
+/** @brief Mindest-Dunkelzeit in Zähltakten: CC2/CC4 und Update brauchen im DMA-Betrieb je einen Takt */
+#define BLANKING_MIN_IRQ	1U
+#define BLANKING_MIN_DMA	2U
+
+/* Private Type definitions */
+
+/**
+ * @brief Betriebsart des Multiplexbetriebs.
+ */
+typedef enum {
+	REFRESH_OFF,		// kein Multiplexbetrieb
+	REFRESH_IRQ,		// TIM7-Interrupt
+	REFRESH_DMA			// TIM8 + DMA2
+} refresh_mode_t;
+
+/**
+ * @brief Nutzung des Hintergrund-Timers.
+ */
+typedef enum {
+	BACKGROUND_OFF,		// kein Timer belegt
+	BACKGROUND_COUNTER,	// Zähler / Countdown
+	BACKGROUND_MIRROR	// Spiegel einer Messgröße
+} background_mode_t;
+
+
+/**
+ * @brief Vorberechnete Ansteuerung eines Zeichens.
+ */
+typedef struct {
+	uint8_t  pattern;	// Bitmuster (Bit 6..0 = Segment A..G)
+	uint32_t gpiod;		// BSRR-Wort Port D
+	uint32_t gpioe;		// BSRR-Wort Port E
+} esd_bsrr_t;
+
+/* Static module variables */
+
+/** @brief Zeichentabelle, vom Compiler vollständig berechnet (liegt im Flash) */
+static const esd_bsrr_t digit_table[ESD_DIGIT_COUNT] = {
+		DIGIT_ENTRY(0b1111110), 	// 0
+		DIGIT_ENTRY(0b0110000), 	// 1
+		DIGIT_ENTRY(0b1101101), 	// 2
+		DIGIT_ENTRY(0b1111001), 	// 3
+		DIGIT_ENTRY(0b0110011),		// 4
+		DIGIT_ENTRY(0b1011011), 	// 5
+		DIGIT_ENTRY(0b1011111), 	// 6
+		DIGIT_ENTRY(0b1110000), 	// 7
+		DIGIT_ENTRY(0b1111111), 	// 8
+		DIGIT_ENTRY(0b1111011),		// 9
+		DIGIT_ENTRY(0b1110111),		// A
+		DIGIT_ENTRY(0b0011111),		// b
+		DIGIT_ENTRY(0b1001110),		// C
+		DIGIT_ENTRY(0b0111101),		// d
+		DIGIT_ENTRY(0b1001111),		// E
+		DIGIT_ENTRY(0b1000111),		// F
+		DIGIT_ENTRY(0b0000001),		// -
+		DIGIT_ENTRY(0b0000000)		// dunkel
+};
+
+/** @brief Steuerleitungen der Positionen 1–4 (Port D) */
+static const uint16_t position_pins[4] = { CNTL1_PD, CNTL2_PD, CNTL3_PD, CNTL4_PD };
+
+/** @brief Anzeigepuffer (BSRR-Worte je Position), wird vom Refresh-Interrupt gelesen */
+static volatile uint32_t display_gpiod[4];
+static volatile uint32_t display_gpioe[4];
+
+/** @brief Aktuelles Zeichen, Punkte und Helligkeit je Position */
+static esd_bsrr_t position_entry[4];
+static uint8_t position_points[4];
+static uint8_t position_brightness[4] = { ESD_BRIGHTNESS_MAX, ESD_BRIGHTNESS_MAX, ESD_BRIGHTNESS_MAX, ESD_BRIGHTNESS_MAX };
+
+/** @brief Einschaltdauer je Position in Zähltakten (Interrupt, DMA-Quelle für CCR1) */
+static volatile uint32_t on_ticks[4];
+
+/** @brief Länge eines Abschnitts in Zähltakten, 0 = kein Multiplexbetrieb */
+static uint32_t slot_ticks;
+
+/** @brief Gewünschte Dunkelzeit in µs */
+static uint16_t blanking_ticks = ESD_BLANKING_US;
+
+/** @brief Position des Refresh-Interrupts */
+static uint8_t refresh_position;
+
+/** @brief 1: der nächste Interrupt beginnt die Einschaltphase */
+static uint8_t refresh_on_phase;
+
+/** @brief Aktive Betriebsart */
+static refresh_mode_t refresh_mode = REFRESH_OFF;
+
+/** @brief Hintergrund-Timer von Zähler oder Spiegel, NULL wenn keiner läuft */
+static TIM_TypeDef *volatile background_tim;
+static background_mode_t background_mode = BACKGROUND_OFF;
+
+/** @brief Angezeigter Wert, Endwert und Schrittweite (+1 / -1) des Zählers */
+static volatile int16_t counter_value;
+static int16_t counter_end;
+static int16_t counter_step;
+
+/** @brief Darstellung, mit Vorzeichen wenn ein Wert des Laufs negativ ist */
+static esd_format_t counter_format;
+
+/** @brief Abschluss-Callback des Zählers */
+static esd_counter_done_t counter_done;
+static void *counter_context;
+
+/** @brief Quelle, Darstellung und zuletzt geschriebener Wert des Spiegels */
+static esd_mirror_source_t mirror_source;
+static void *mirror_context;
+static esd_format_t mirror_format;
+static int32_t mirror_last;
+
+/** @brief Konstantes BSRR-Wort "alle Positionen aus" für die DMA */
+static const uint32_t dma_positions_off = (uint32_t)CNTL_ALL_PD << 16;
+
+/** @brief DMA-Streams: Positionen aus, Port E, Port D, Einschaltdauer */
+static DMA_HandleTypeDef dma_off;
+static DMA_HandleTypeDef dma_gpioe;
+static DMA_HandleTypeDef dma_gpiod;
+static DMA_HandleTypeDef dma_on_time;
+
+/* Static module functions (prototypes) */
+static void set_position(uint8_t pos, const esd_bsrr_t *entry);
+static void update_position(uint8_t pos);
+static void split_digits(uint16_t value, uint8_t *digits);
+static void set_digits(const uint8_t *digits, int16_t value, uint8_t first);
+static void update_timing(void);
+static uint32_t points_gpioe(uint32_t gpioe, uint8_t points);
+static uint32_t refresh_reload(uint16_t rate_hz);
+static HAL_StatusTypeDef background_start(uint16_t interval_ms, background_mode_t mode, tim_alloc_handler_t handler);
+static void background_stop(void);
+static void counter_tick(TIM_TypeDef *tim, uint32_t flags, void *context);
+static void mirror_tick(TIM_TypeDef *tim, uint32_t flags, void *context);
+static HAL_StatusTypeDef dma_stream_start(DMA_HandleTypeDef *hdma, dma_alloc_request_t request,
+		const volatile void *source, uint32_t memory_inc, volatile uint32_t *destination);
 
 /**
  * @brief Initialisiert alle GPIO-Pins für das 7-Segment-Display.
@@ -33,17 +214,18 @@ void esd_init(void){
 	__HAL_RCC_GPIOD_CLK_ENABLE();
 	__HAL_RCC_GPIOE_CLK_ENABLE();
 
-	GPIO_InitTypeDef GPIO_InitStruct; // Port D & E aktivieren
- //Alle Segmente und Steuerleitungen sind als digitale Ausgänge bereit, um LEDs des Displays direkt anzusteuern.
-	GPIO_InitStruct.Pin = CNTL1_PD | CNTL2_PD | CNTL3_PD | CNTL4_PD | A_PD | B_PD | C_PD | D_PD | E_PD | F_PD;
-	GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
-	GPIO_InitStruct.Pull = GPIO_NOPULL;
-	GPIO_InitStruct.Speed = GPIO_SPEED_MEDIUM;
-	HAL_GPIO_Init(GPIOD, &GPIO_InitStruct);
-
-	GPIO_InitStruct.Pin = POINT_PE | G_PE | DOT_PE;
+	// Alle Segmente und Steuerleitungen sind als digitale Ausgänge bereit, um LEDs des Displays direkt anzusteuern.
+	// Pegel vor dem Umschalten: Segmente aus (HIGH), Positionen aus (LOW), kein Aufblitzen beim Start.
+	// Die Registermasken berechnet der Compiler aus ESD_PINS_PD / ESD_PINS_PE.
+	LL_GPIO_BSRR(GPIOD, UTILS_GPIO_BSRR_WORD(ESD_PINS_PD, ESD_PINS_PD & ~CNTL_ALL_PD));
+	LL_GPIO_SET(GPIOE, ESD_PINS_PE);
+	LL_GPIO_CONFIG(GPIOD, ESD_PINS_PD, GPIO_MODE_OUTPUT_PP, GPIO_NOPULL, GPIO_SPEED_FREQ_MEDIUM, 0U);
+	LL_GPIO_CONFIG(GPIOE, ESD_PINS_PE, GPIO_MODE_OUTPUT_PP, GPIO_NOPULL, GPIO_SPEED_FREQ_MEDIUM, 0U);
 
-	HAL_GPIO_Init(GPIOE, &GPIO_InitStruct);
+	// Anzeigepuffer dunkel
+	for (uint8_t i = 0; i < 4U; i++) {
+		set_position(i, &digit_table[ESD_DIGIT_BLANK]);
+	}
 }
 
 /**
@@ -53,71 +235,778 @@ void esd_init(void){
  * @param pos    Die Position des Displays, an der die Ziffer erscheinen soll
  *                (ESD_POSITION_1 ... ESD_POSITION_4 oder ESD_POSITION_ALL)
  *
- * Diese Funktion steuert die Segmente A–G entsprechend einem Bitmuster an.
- * Je nach Position wird die entsprechende Steuerleitung aktiviert.
+ * Die Segmente werden über die vorberechneten BSRR-Worte der Zeichentabelle
+ * angesteuert: zwei Speicherzugriffe statt eines HAL_GPIO_WritePin() je
+ * Segment, alle Segmente eines Ports schalten gleichzeitig.
  * Punkt (POINT) und Komma (DOT) werden standardmäßig deaktiviert.
  */
 void esd_show_digit(esd_digit_t digit, esd_position_t pos){
 
-	uint8_t numIndex[10] = {
-			0b1111110, 		// 0
-			0b0110000, 		// 1
-			0b1101101, 		// 2
-			0b1111001, 		// 3
-			0b0110011,		// 4
-			0b1011011, 		// 5
-			0b1011111, 		// 6
-			0b1110000, 		// 7
-			0b1111111, 		// 8
-			0b1111011		// 9
-		};
+	esd_show_digit_points(digit, pos, ESD_POINT_NONE);
+}
+
+/**
+ * @brief Zeigt eine Ziffer mit Punkt und/oder Komma an einer Position an.
+ */
+void esd_show_digit_points(esd_digit_t digit, esd_position_t pos, uint8_t points){
+
+	uint32_t position;
+
+	if (digit >= ESD_DIGIT_COUNT) {
+		digit = ESD_DIGIT_BLANK;
+	}
+
+	// Gewählte Displayposition(en)
 
-	uint8_t nI = numIndex[digit];//Bitmuster für geewählte Ziffer
+	position = (pos < ESD_POSITION_ALL) ? position_pins[pos] : CNTL_ALL_PD;
 
-	// Segmente A–G ansteuern (LOW aktiviert Segment)
+	// Segment G, Punkt und Komma (Port E), dann Segmente A–F und Position (Port D)
+
+	LL_GPIO_BSRR(GPIOE, points_gpioe(digit_table[digit].gpioe, points));
+	LL_GPIO_BSRR(GPIOD, digit_table[digit].gpiod | position);
+}
+
+/**
+ * @brief Schaltet alle Positionen (CNTL1–CNTL4) gleichzeitig aus.
+ *
+ * Wird im Multiplexbetrieb verwendet, um Flackern beim Wechsel der Positionen zu vermeiden.
+ */
+void turnAllPositionsOff(void){
+	LL_GPIO_RESET(GPIOD, CNTL_ALL_PD);
+}
+
+/**
+ * @brief Liefert das Segment-Bitmuster einer Ziffer.
+ */
+uint8_t esd_digit_pattern(esd_digit_t digit){
+	return (digit < ESD_DIGIT_COUNT) ? digit_table[digit].pattern : ESD_SEGMENT_BLANK;
+}
 
-	HAL_GPIO_WritePin(GPIOD, A_PD, (nI & (1<<6)) ? GPIO_PIN_RESET : GPIO_PIN_SET); // A
-	HAL_GPIO_WritePin(GPIOD, B_PD, (nI & (1<<5)) ? GPIO_PIN_RESET : GPIO_PIN_SET); // B
-	HAL_GPIO_WritePin(GPIOD, C_PD, (nI & (1<<4)) ? GPIO_PIN_RESET : GPIO_PIN_SET); // C
-	HAL_GPIO_WritePin(GPIOD, D_PD, (nI & (1<<3)) ? GPIO_PIN_RESET : GPIO_PIN_SET); // D
-	HAL_GPIO_WritePin(GPIOD, E_PD, (nI & (1<<2)) ? GPIO_PIN_RESET : GPIO_PIN_SET); // E
-	HAL_GPIO_WritePin(GPIOD, F_PD, (nI & (1<<1)) ? GPIO_PIN_RESET : GPIO_PIN_SET); // F
-	HAL_GPIO_WritePin(GPIOE, G_PE, (nI & (1<<0)) ? GPIO_PIN_RESET : GPIO_PIN_SET); // G
+/**
+ * @brief Startet den Multiplexbetrieb im Hintergrund.
+ *
+ * Der Timer wird direkt über die Register betrieben, damit
+ * HAL_TIM_PeriodElapsedCallback() dem Stopwatch-Modul vorbehalten bleibt.
+ * Vorteiler auf ESD_REFRESH_COUNTER_HZ, ein Abschnitt dauert
+ * 1 / (4 * rate_hz) Sekunden. Der Interrupt wechselt ARR abwechselnd
+ * zwischen Einschalt- und Dunkelphase; ARR ist gepuffert (ARPE), der
+ * neue Wert gilt ab dem nächsten Überlauf.
+ */
+HAL_StatusTypeDef esd_refresh_start(uint16_t rate_hz){
 
-	// Punkt und Komma standardmäßig deaktivieren
+	uint32_t reload = refresh_reload(rate_hz);
 
-	HAL_GPIO_WritePin(GPIOE, POINT_PE, GPIO_PIN_SET);
-	HAL_GPIO_WritePin(GPIOE, DOT_PE, GPIO_PIN_SET);
+	if (reload == 0) {
+		return HAL_ERROR;
+	}
 
-	// Gewählte Displayposition aktivieren
+	esd_refresh_stop();
 
-	switch(pos){
-		case ESD_POSITION_1:
-			HAL_GPIO_WritePin(GPIOD, CNTL1_PD, GPIO_PIN_SET);
-			break;
-		case ESD_POSITION_2:
-			HAL_GPIO_WritePin(GPIOD, CNTL2_PD, GPIO_PIN_SET);
-			break;
-		case ESD_POSITION_3:
-			HAL_GPIO_WritePin(GPIOD, CNTL3_PD, GPIO_PIN_SET);
-			break;
-		case ESD_POSITION_4:
-			HAL_GPIO_WritePin(GPIOD, CNTL4_PD, GPIO_PIN_SET);
-			break;
-		case ESD_POSITION_ALL: //Alle Positionen gleichzeitig leuchten
-			HAL_GPIO_WritePin(GPIOD, CNTL1_PD | CNTL2_PD | CNTL3_PD | CNTL4_PD, GPIO_PIN_SET);
-			break;
+	if (tim_alloc_claim(ESD_REFRESH_TIM, TIM_ALLOC_OWNER_ESD_REFRESH) != HAL_OK) {
+		return HAL_BUSY;
 	}
 
+	refresh_mode = REFRESH_IRQ;
+	slot_ticks = reload;
+	update_timing();
 
+	// Erster Abschnitt dunkel, danach Einschaltphase von Position 1
+	ESD_REFRESH_TIM->CR1 = TIM_CR1_ARPE;
+	ESD_REFRESH_TIM->PSC = (clock_get_apb1_timer_clock() / ESD_REFRESH_COUNTER_HZ) - 1U;
+	ESD_REFRESH_TIM->ARR = reload - 1U;
+	ESD_REFRESH_TIM->EGR = TIM_EGR_UG;		// Vorteiler und ARR sofort übernehmen
+	ESD_REFRESH_TIM->ARR = on_ticks[0] - 1U;
+	ESD_REFRESH_TIM->SR = 0;
+	ESD_REFRESH_TIM->DIER = TIM_DIER_UIE;
+
+	refresh_position = 0;
+	refresh_on_phase = 1;
+
+	HAL_NVIC_SetPriority(ESD_REFRESH_IRQn, ESD_REFRESH_IRQ_PRIORITY, 0);
+	HAL_NVIC_EnableIRQ(ESD_REFRESH_IRQn);
+
+	ESD_REFRESH_TIM->CR1 = TIM_CR1_ARPE | TIM_CR1_CEN;
+
+	return HAL_OK;
 }
 
 /**
- * @brief Schaltet alle Positionen (CNTL1–CNTL4) gleichzeitig aus.
+ * @brief Startet den Multiplexbetrieb per DMA ohne CPU und ohne Interrupts.
  *
- * Wird im Multiplexbetrieb verwendet, um Flackern beim Wechsel der Positionen zu vermeiden.
+ * Der Timer läuft nur als Taktgeber für die DMA-Anforderungen: CC1 nach
+ * der Einschaltdauer, CC2 und CC4 bei ARR, Update beim Überlauf. Die
+ * Vergleichskanäle sind "frozen" und nicht auf Pins geschaltet, CCR1 ist
+ * ungepuffert und wird per DMA für den nächsten Abschnitt gesetzt. Alle
+ * Streams beginnen bei Position 1 und laufen danach im Gleichschritt um.
+ */
+HAL_StatusTypeDef esd_refresh_start_dma(uint16_t rate_hz){
+
+	uint32_t reload = refresh_reload(rate_hz);
+
+	if (reload == 0) {
+		return HAL_ERROR;
+	}
+
+	esd_refresh_stop();
+
+	refresh_mode = REFRESH_DMA;
+	slot_ticks = reload;
+	update_timing();
+
+	// TIM8 gehört sonst potis_dma (ADC-Trigger)
+	if (tim_alloc_claim(ESD_DMA_TIM, TIM_ALLOC_OWNER_ESD_DMA) != HAL_OK) {
+		return HAL_BUSY;
+	}
+
+	if ((dma_stream_start(&dma_off, ESD_DMA_REQ_OFF, &dma_positions_off, DMA_MINC_DISABLE, &GPIOD->BSRR) != HAL_OK) ||
+		(dma_stream_start(&dma_gpioe, ESD_DMA_REQ_GPIOE, display_gpioe, DMA_MINC_ENABLE, &GPIOE->BSRR) != HAL_OK) ||
+		(dma_stream_start(&dma_gpiod, ESD_DMA_REQ_GPIOD, display_gpiod, DMA_MINC_ENABLE, &GPIOD->BSRR) != HAL_OK) ||
+		(dma_stream_start(&dma_on_time, ESD_DMA_REQ_ON_TIME, on_ticks, DMA_MINC_ENABLE, &ESD_DMA_TIM->CCR1) != HAL_OK)) {
+		esd_refresh_stop();
+		return HAL_ERROR;
+	}
+
+	ESD_DMA_TIM->CR1 = 0;
+	ESD_DMA_TIM->PSC = (clock_get_apb2_timer_clock() / ESD_REFRESH_COUNTER_HZ) - 1U;
+	ESD_DMA_TIM->ARR = reload - 1U;
+	ESD_DMA_TIM->CCMR1 = 0;					// CH1, CH2: frozen, ohne Puffer
+	ESD_DMA_TIM->CCMR2 = 0;					// CH4: frozen
+	ESD_DMA_TIM->CCER = 0;
+	ESD_DMA_TIM->CCR1 = on_ticks[0];		// alle Positionen aus
+	ESD_DMA_TIM->CCR2 = reload - 1U;		// Port E nächste Position
+	ESD_DMA_TIM->CCR4 = reload - 1U;		// Einschaltdauer nächste Position
+	ESD_DMA_TIM->EGR = TIM_EGR_UG;			// Vorteiler übernehmen, löst noch keine DMA aus
+	ESD_DMA_TIM->SR = 0;
+	ESD_DMA_TIM->DIER = TIM_DIER_UDE | TIM_DIER_CC1DE | TIM_DIER_CC2DE | TIM_DIER_CC4DE;
+
+	turnAllPositionsOff();
+
+	ESD_DMA_TIM->CR1 = TIM_CR1_CEN;
+
+	return HAL_OK;
+}
+
+/**
+ * @brief Stoppt den Multiplexbetrieb und schaltet alle Positionen aus.
+ */
+void esd_refresh_stop(void){
+
+	background_stop();
+
+	if (refresh_mode == REFRESH_IRQ) {
+		ESD_REFRESH_TIM->CR1 = 0;
+		ESD_REFRESH_TIM->DIER = 0;
+		HAL_NVIC_DisableIRQ(ESD_REFRESH_IRQn);
+	} else if (refresh_mode == REFRESH_DMA) {
+		ESD_DMA_TIM->CR1 = 0;
+		ESD_DMA_TIM->DIER = 0;
+		HAL_DMA_Abort(&dma_off);
+		HAL_DMA_Abort(&dma_gpioe);
+		HAL_DMA_Abort(&dma_gpiod);
+		HAL_DMA_Abort(&dma_on_time);
+		dma_alloc_release(&dma_off);
+		dma_alloc_release(&dma_gpioe);
+		dma_alloc_release(&dma_gpiod);
+		dma_alloc_release(&dma_on_time);
+	}
+
+	refresh_mode = REFRESH_OFF;
+	slot_ticks = 0;
+
+	turnAllPositionsOff();
+}
+
+/**
+ * @brief Wandelt eine Zahl in gepackte BCD-Ziffern.
+ */
+uint16_t esd_to_bcd(uint16_t value){
+
+	uint8_t digits[4];
+
+	if (value > NUMBER_MAX) {
+		value = NUMBER_MAX;
+	}
+	split_digits(value, digits);
+
+	return (uint16_t)((digits[0] << 12) | (digits[1] << 8) | (digits[2] << 4) | digits[3]);
+}
+
+/**
+ * @brief Schreibt eine vierstellige Zahl in den Anzeigepuffer.
+ *
+ * Die BSRR-Worte werden direkt aus der Zeichentabelle übernommen.
+ */
+void esd_set_number(uint16_t value){
+
+	uint8_t digits[4];
+
+	if (value > NUMBER_MAX) {
+		value = NUMBER_MAX;
+	}
+	split_digits(value, digits);
+
+	for (uint8_t i = 0; i < 4U; i++) {
+		set_position(i, &digit_table[digits[i]]);
+	}
+}
+
+/**
+ * @brief Schreibt eine Zahl mit Vorzeichen in den Anzeigepuffer.
+ */
+void esd_set_signed(int16_t value){
+
+	esd_set_fixed(value, 0);
+}
+
+/**
+ * @brief Schreibt eine Zahl hexadezimal in den Anzeigepuffer.
+ *
+ * Jede Position ist ein Nibble, nur Shift und Maske.
+ */
+void esd_set_hex(uint16_t value){
+
+	for (uint8_t i = 0; i < 4U; i++) {
+		set_position(i, &digit_table[(value >> (12U - 4U * i)) & 0x0FU]);
+	}
+}
+
+/**
+ * @brief Schreibt eine Festkommazahl in den Anzeigepuffer.
+ *
+ * Das Komma der Einerstelle wird gesetzt, alle anderen Kommas gelöscht;
+ * die Punkte (ESD_POINT_POINT) bleiben erhalten.
+ */
+void esd_set_fixed(int16_t value, uint8_t decimals){
+
+	uint8_t digits[4];
+	uint8_t magnitude;
+	uint8_t unit;
+
+	if (decimals > 3U) {
+		decimals = 3U;
+	}
+	if (value > NUMBER_MAX) {
+		value = NUMBER_MAX;
+	} else if (value < NUMBER_MIN) {
+		value = NUMBER_MIN;
+	}
+
+	if ((value < 0) && (decimals == 3U)) {
+		/* Kein Platz für das Minus vor der Einerstelle: eine Stelle weniger */
+		value = (int16_t)-(int16_t)DIV10(-value);
+		decimals = 2U;
+	}
+
+	magnitude = 0;
+	split_digits((uint16_t)((value < 0) ? -value : value), digits);
+	unit = (uint8_t)(3U - decimals);
+
+	/* Führende Nullen dunkel, die Einerstelle und die Nachkommastellen nie */
+	while ((magnitude < unit) && (digits[magnitude] == 0U)) {
+		magnitude++;
+	}
+	set_digits(digits, value, magnitude);
+
+	for (uint8_t i = 0; i < 4U; i++) {
+		position_points[i] &= (uint8_t)~ESD_POINT_DOT;
+		if ((decimals > 0U) && (i == unit)) {
+			position_points[i] |= ESD_POINT_DOT;
+		}
+		update_position(i);
+	}
+}
+
+/**
+ * @brief Schreibt ein Bitmuster für eine Position in den Anzeigepuffer.
+ */
+void esd_set_pattern(esd_position_t pos, uint8_t pattern){
+
+	esd_bsrr_t entry;
+
+	if (pos < ESD_POSITION_ALL) {
+		entry.pattern = pattern;
+		entry.gpiod   = SEGMENT_BSRR_D(pattern);
+		entry.gpioe   = SEGMENT_BSRR_E(pattern);
+		set_position(pos, &entry);
+	}
+}
+
+/**
+ * @brief Setzt Punkt und Komma einer Position im Anzeigepuffer.
+ */
+void esd_set_points(esd_position_t pos, uint8_t points){
+
+	for (uint8_t i = 0; i < 4U; i++) {
+		if ((pos == ESD_POSITION_ALL) || (pos == i)) {
+			position_points[i] = points;
+			update_position(i);
+		}
+	}
+}
+
+/**
+ * @brief Setzt die Helligkeit einer Position im Multiplexbetrieb.
+ *
+ * Helligkeit 0 nimmt die Steuerleitung aus dem BSRR-Wort der Position,
+ * der Zeitablauf bleibt unverändert.
+ */
+void esd_set_brightness(esd_position_t pos, uint8_t level){
+
+	for (uint8_t i = 0; i < 4U; i++) {
+		if ((pos == ESD_POSITION_ALL) || (pos == i)) {
+			position_brightness[i] = level;
+			update_position(i);
+		}
+	}
+
+	update_timing();
+}
+
+/**
+ * @brief Setzt die Dunkelzeit zwischen zwei Positionen.
+ */
+void esd_set_blanking_us(uint16_t blanking_us){
+
+	blanking_ticks = blanking_us;	// 1 Zähltakt = 1 µs
+	update_timing();
+}
+
+/**
+ * @brief Schreibt einen Wert in einer Darstellung in den Anzeigepuffer.
  */
-void turn_all_positions_off(void){
-		HAL_GPIO_WritePin(GPIOD, CNTL1_PD | CNTL2_PD | CNTL3_PD | CNTL4_PD, GPIO_PIN_RESET);
+void esd_set_formatted(int32_t value, esd_format_t format){
+
+	switch (format) {
+	case ESD_FORMAT_SIGNED:
+		esd_set_signed((int16_t)((value > NUMBER_MAX) ? NUMBER_MAX : ((value < NUMBER_MIN) ? NUMBER_MIN : value)));
+		break;
+	case ESD_FORMAT_HEX:
+		esd_set_hex((uint16_t)value);
+		break;
+	case ESD_FORMAT_TIME:
+		esd_set_number((uint16_t)((value > NUMBER_MAX) ? NUMBER_MAX : ((value < 0) ? 0 : value)));
+		for (uint8_t i = 0; i < 4U; i++) {
+			// Komma hinter den Minuten (Position 2)
+			position_points[i] &= (uint8_t)~ESD_POINT_DOT;
+			if (i == ESD_POSITION_2) {
+				position_points[i] |= ESD_POINT_DOT;
+			}
+			update_position(i);
+		}
+		break;
+	case ESD_FORMAT_NUMBER:
+	default:
+		esd_set_number((uint16_t)((value > NUMBER_MAX) ? NUMBER_MAX : ((value < 0) ? 0 : value)));
+		break;
+	}
+}
+
+/**
+ * @brief Startet einen Zähler oder Countdown im Hintergrund.
+ *
+ * Ein Überlauf des Hintergrund-Timers je Wert.
+ */
+HAL_StatusTypeDef esd_counter_start(int16_t from, int16_t to, uint16_t interval_ms,
+									esd_counter_done_t done, void *context){
+
+	if ((refresh_mode == REFRESH_OFF) || (interval_ms == 0U) || (interval_ms > ESD_COUNTER_MAX_INTERVAL_MS) ||
+		(from < NUMBER_MIN) || (from > NUMBER_MAX) || (to < NUMBER_MIN) || (to > NUMBER_MAX)) {
+		return HAL_ERROR;
+	}
+
+	background_stop();
+
+	counter_value   = from;
+	counter_end     = to;
+	counter_step    = (from > to) ? -1 : 1;
+	counter_format  = ((from < 0) || (to < 0)) ? ESD_FORMAT_SIGNED : ESD_FORMAT_NUMBER;
+	counter_done    = done;
+	counter_context = context;
+	esd_set_formatted(from, counter_format);
+
+	if (from == to) {
+		// Kein Schritt: sofort fertig
+		if (done != NULL) {
+			done(context);
+		}
+		return HAL_OK;
+	}
+
+	return background_start(interval_ms, BACKGROUND_COUNTER, counter_tick);
+}
+
+/**
+ * @brief Bricht einen laufenden Zähler ab.
+ */
+void esd_counter_stop(void){
+
+	if (background_mode == BACKGROUND_COUNTER) {
+		background_stop();
+	}
+}
+
+/**
+ * @brief Liefert den angezeigten Wert des Zählers.
+ */
+int16_t esd_counter_get(void){
+
+	return counter_value;
+}
+
+/**
+ * @brief Prüft, ob ein Zähler läuft.
+ */
+uint8_t esd_counter_is_running(void){
+
+	return ((background_tim != NULL) && (background_mode == BACKGROUND_COUNTER)) ? 1U : 0U;
+}
+
+/**
+ * @brief Spiegelt eine Messgröße im Hintergrund auf das Display.
+ *
+ * Der erste Wert wird sofort geschrieben, danach liest der Interrupt des
+ * Hintergrund-Timers die Quelle und schreibt nur bei einer Änderung.
+ */
+HAL_StatusTypeDef esd_mirror_start(esd_mirror_source_t source, void *context, esd_format_t format,
+								   uint16_t interval_ms){
+
+	if ((refresh_mode == REFRESH_OFF) || (source == NULL) || (interval_ms == 0U) ||
+		(interval_ms > ESD_COUNTER_MAX_INTERVAL_MS)) {
+		return HAL_ERROR;
+	}
+
+	background_stop();
+
+	mirror_source  = source;
+	mirror_context = context;
+	mirror_format  = format;
+	mirror_last    = source(context);
+	esd_set_formatted(mirror_last, format);
+
+	return background_start(interval_ms, BACKGROUND_MIRROR, mirror_tick);
+}
+
+/**
+ * @brief Beendet den Spiegel; der letzte Wert bleibt stehen.
+ */
+void esd_mirror_stop(void){
+
+	if (background_mode == BACKGROUND_MIRROR) {
+		background_stop();
+	}
+}
+
+/* Static module functions */
+
+/**
+ * @brief Übernimmt ein Zeichen für eine Position.
+ *
+ * @param pos    Position (0–3)
+ * @param entry  Vorberechnete Ansteuerung
+ */
+static void set_position(uint8_t pos, const esd_bsrr_t *entry){
+
+	position_entry[pos] = *entry;
+	update_position(pos);
+}
+
+/**
+ * @brief Zerlegt eine Zahl in vier Dezimalziffern ohne Division.
+ *
+ * @param value   Zahl (0–9999)
+ * @param digits  Ziffern, digits[0] = Tausender (Position 1)
+ */
+static void split_digits(uint16_t value, uint8_t *digits){
+
+	uint32_t rest = value;
+
+	digits[0] = (uint8_t)DIV1000(rest);
+	rest -= digits[0] * 1000U;
+	digits[1] = (uint8_t)DIV100(rest);
+	rest -= digits[1] * 100U;
+	digits[2] = (uint8_t)DIV10(rest);
+	digits[3] = (uint8_t)(rest - digits[2] * 10U);
+}
+
+/**
+ * @brief Schreibt Ziffern ab einer Position, davor dunkel und bei negativem
+ *        Wert ein Minus direkt vor der ersten Ziffer.
+ *
+ * @param digits  Ziffern des Betrags
+ * @param value   Wert (nur das Vorzeichen wird ausgewertet)
+ * @param first   Erste angezeigte Ziffer (0–3)
+ */
+static void set_digits(const uint8_t *digits, int16_t value, uint8_t first){
+
+	/* Betrag höchstens 999: digits[0] ist 0 und first mindestens 1 */
+	uint8_t sign = ((value < 0) && (first > 0U)) ? (uint8_t)(first - 1U) : 4U;
+
+	for (uint8_t i = 0; i < 4U; i++) {
+		if (i == sign) {
+			set_position(i, &digit_table[ESD_DIGIT_MINUS]);
+		} else if (i < first) {
+			set_position(i, &digit_table[ESD_DIGIT_BLANK]);
+		} else {
+			set_position(i, &digit_table[digits[i]]);
+		}
+	}
+}
+
+/**
+ * @brief Belegt den Hintergrund-Timer (tim_alloc, nach Fähigkeit) und
+ *        startet ihn.
+ *
+ * Vorteiler auf ESD_COUNTER_COUNTER_HZ, ein Überlauf je Intervall. Der
+ * Timer wird nach Fähigkeit belegt, damit keine festen Timer der anderen
+ * Module (TIM7, TIM8) gebraucht werden.
+ *
+ * @param interval_ms  Intervall (1–ESD_COUNTER_MAX_INTERVAL_MS)
+ * @param mode         Nutzung
+ * @param handler      Interrupt-Handler
+ * @return HAL_OK, HAL_BUSY wenn kein Timer frei ist, sonst HAL_ERROR
+ */
+static HAL_StatusTypeDef background_start(uint16_t interval_ms, background_mode_t mode, tim_alloc_handler_t handler){
+
+	TIM_TypeDef *tim = tim_alloc_claim_caps(TIM_ALLOC_CAP_IRQ, TIM_ALLOC_OWNER_ESD_COUNTER);
+
+	if (tim == NULL) {
+		return HAL_BUSY;
+	}
+
+	tim->CR1  = 0;
+	tim->PSC  = (tim_alloc_get_clock(tim) / ESD_COUNTER_COUNTER_HZ) - 1U;
+	tim->ARR  = ((uint32_t)interval_ms * (ESD_COUNTER_COUNTER_HZ / 1000U)) - 1U;
+	tim->CNT  = 0;
+	tim->EGR  = TIM_EGR_UG;		// Vorteiler und ARR sofort übernehmen
+	tim->SR   = 0;
+	tim->DIER = TIM_DIER_UIE;
+
+	if (tim_alloc_set_handler(tim, handler, NULL, ESD_REFRESH_IRQ_PRIORITY) != HAL_OK) {
+		tim_alloc_release(tim, TIM_ALLOC_OWNER_ESD_COUNTER);
+		return HAL_ERROR;
+	}
+
+	background_mode = mode;
+	background_tim = tim;
+	tim->CR1 = TIM_CR1_URS | TIM_CR1_CEN;	// nur Überläufe, nicht UG
+
+	return HAL_OK;
+}
+
+/**
+ * @brief Gibt den Hintergrund-Timer frei (Zähler oder Spiegel).
+ */
+static void background_stop(void){
+
+	TIM_TypeDef *tim = background_tim;
+
+	if (tim != NULL) {
+		background_tim = NULL;
+		tim_alloc_release(tim, TIM_ALLOC_OWNER_ESD_COUNTER);
 	}
+	background_mode = BACKGROUND_OFF;
+}
+
+/**
+ * @brief Zählschritt im Interrupt des Hintergrund-Timers (über tim_alloc).
+ *
+ * Zeigt den nächsten Wert an; nach dem Endwert wird der Timer freigegeben
+ * und der Abschluss-Callback aufgerufen.
+ */
+static void counter_tick(TIM_TypeDef *tim, uint32_t flags, void *context){
+
+	int16_t value;
+
+	(void)context;
+
+	if (((flags & TIM_SR_UIF) == 0U) || (tim != background_tim)) {
+		return;
+	}
+
+	value = (int16_t)(counter_value + counter_step);
+	counter_value = value;
+	esd_set_formatted(value, counter_format);
+
+	if (value == counter_end) {
+		background_stop();
+		if (counter_done != NULL) {
+			counter_done(counter_context);
+		}
+	}
+}
+
+/**
+ * @brief Spiegelschritt im Interrupt des Hintergrund-Timers: Quelle lesen,
+ *        bei Änderung in den Anzeigepuffer schreiben.
+ */
+static void mirror_tick(TIM_TypeDef *tim, uint32_t flags, void *context){
+
+	int32_t value;
+
+	(void)context;
+
+	if (((flags & TIM_SR_UIF) == 0U) || (tim != background_tim)) {
+		return;
+	}
+
+	value = mirror_source(mirror_context);
+	if (value != mirror_last) {
+		mirror_last = value;
+		esd_set_formatted(value, mirror_format);
+	}
+}
+
+/**
+ * @brief Berechnet die BSRR-Worte einer Position im Anzeigepuffer.
+ *
+ * Zeichen, Punkte und die Steuerleitung der Position werden in je ein
+ * Wort für Port D und Port E zusammengefasst, Interrupt und DMA schreiben
+ * die Worte unverändert. Bei Helligkeit 0 fehlt die Steuerleitung.
+ *
+ * @param pos  Position (0–3)
+ */
+static void update_position(uint8_t pos){
+
+	uint32_t position = (position_brightness[pos] > 0U) ? position_pins[pos] : 0U;
+
+	display_gpioe[pos] = points_gpioe(position_entry[pos].gpioe, position_points[pos]);
+	display_gpiod[pos] = position_entry[pos].gpiod | position;
+}
+
+/**
+ * @brief Berechnet die Einschaltdauer aller Positionen.
+ *
+ * Die Dunkelzeit wird auf die Mindestwerte der Betriebsart begrenzt, die
+ * Einschaltdauer ist mindestens 1 Zähltakt (Helligkeit 0 über die
+ * fehlende Steuerleitung), so bleiben Einschalt- und Dunkelphase im
+ * Interrupt-Betrieb immer > 0.
+ */
+static void update_timing(void){
+
+	uint32_t blanking = blanking_ticks;
+	uint32_t blanking_min = (refresh_mode == REFRESH_DMA) ? BLANKING_MIN_DMA : BLANKING_MIN_IRQ;
+	uint32_t active;
+
+	if (slot_ticks == 0) {
+		return;
+	}
+
+	if (blanking < blanking_min) {
+		blanking = blanking_min;
+	}
+	if (blanking > (slot_ticks - 1U)) {
+		blanking = slot_ticks - 1U;
+	}
+
+	active = slot_ticks - blanking;
+
+	for (uint8_t i = 0; i < 4U; i++) {
+		uint32_t ticks = (active * position_brightness[i] + (ESD_BRIGHTNESS_MAX / 2U)) / ESD_BRIGHTNESS_MAX;
+
+		on_ticks[i] = (ticks > 0U) ? ticks : 1U;
+	}
+}
+
+/**
+ * @brief Ergänzt das BSRR-Wort für Port E um Punkt und Komma.
+ *
+ * @param gpioe   BSRR-Wort des Zeichens (Segment G, Komma aus dem Bitmuster)
+ * @param points  ESD_POINT_DOT, ESD_POINT_POINT
+ * @return BSRR-Wort für Port E
+ */
+static uint32_t points_gpioe(uint32_t gpioe, uint8_t points){
+
+	if (points & ESD_POINT_DOT) {
+		gpioe = (gpioe & ~(uint32_t)DOT_PE) | ((uint32_t)DOT_PE << 16);
+	}
+
+	return gpioe | ((points & ESD_POINT_POINT) ? ((uint32_t)POINT_PE << 16) : (uint32_t)POINT_PE);
+}
+
+/**
+ * @brief Berechnet die Abschnittslänge für eine Bildwiederholrate.
+ *
+ * @param rate_hz  Bildwiederholrate des ganzen Displays
+ * @return Zähltakte je Position, 0 bei ungültiger Rate
+ */
+static uint32_t refresh_reload(uint16_t rate_hz){
+
+	uint32_t reload;
+
+	if (rate_hz == 0) {
+		return 0;
+	}
+
+	reload = ESD_REFRESH_COUNTER_HZ / (4U * rate_hz);
+	if ((reload < REFRESH_MIN_RELOAD) || (reload > 0x10000U)) {
+		return 0;
+	}
+
+	return reload;
+}
+
+/**
+ * @brief Startet einen zirkularen DMA2-Stream Speicher -> Register (GPIO-BSRR, CCR1).
+ *
+ * @param hdma        DMA-Handle
+ * @param request     TIM8-Anforderung, der Stream kommt von dma_alloc
+ * @param source      Quelle: 4 Worte Anzeigepuffer oder ein konstantes Wort
+ * @param memory_inc  DMA_MINC_ENABLE für den Puffer, DMA_MINC_DISABLE für das Wort
+ * @param destination Zielregister
+ * @return HAL_OK oder HAL_ERROR
+ */
+static HAL_StatusTypeDef dma_stream_start(DMA_HandleTypeDef *hdma, dma_alloc_request_t request,
+		const volatile void *source, uint32_t memory_inc, volatile uint32_t *destination){
+
+	/* Ohne Interrupt, ein belegter Stream wird bei dma_alloc als Konflikt gezählt */
+	if (dma_alloc_claim(hdma, request, DMA_ALLOC_LATENCY_BULK, HEALTH_ISR_COUNT) != HAL_OK) {
+		return HAL_ERROR;
+	}
+
+	hdma->Init.Direction           = DMA_MEMORY_TO_PERIPH;
+	hdma->Init.PeriphInc           = DMA_PINC_DISABLE;
+	hdma->Init.MemInc              = memory_inc;
+	hdma->Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+	hdma->Init.MemDataAlignment    = DMA_MDATAALIGN_WORD;
+	hdma->Init.Mode                = DMA_CIRCULAR;
+	hdma->Init.FIFOMode            = DMA_FIFOMODE_DISABLE;
+
+	if (HAL_DMA_Init(hdma) != HAL_OK) {
+		return HAL_ERROR;
+	}
+
+	return HAL_DMA_Start(hdma, (uint32_t)(uintptr_t)source, (uint32_t)(uintptr_t)destination, 4U);
+}
+
+/* Interrupt section */
+
+/**
+ * @brief Refresh-Interrupt: Einschalt- und Dunkelphase je Position.
+ *
+ * Einschaltphase: Port E (G, Punkte), dann Segmente A–F und die Position
+ * in einem Zugriff auf Port D; alle Positionen sind seit der Dunkelphase
+ * aus, es entsteht kein Geisterbild. Dunkelphase: alle Positionen aus.
+ * ARR wird jeweils für die folgende Phase gesetzt.
+ */
+void TIM7_IRQHandler(void){
+
+	if (ESD_REFRESH_TIM->SR & TIM_SR_UIF) {
+		ESD_REFRESH_TIM->SR = (uint32_t)~TIM_SR_UIF;
+
+		LL_GPIO_RESET(GPIOD, CNTL_ALL_PD);
+
+		if (refresh_on_phase) {
+			LL_GPIO_BSRR(GPIOE, display_gpioe[refresh_position]);
+			LL_GPIO_BSRR(GPIOD, display_gpiod[refresh_position]);
+
+			ESD_REFRESH_TIM->ARR = slot_ticks - on_ticks[refresh_position] - 1U;
+			refresh_on_phase = 0;
+		} else {
+			refresh_position = (refresh_position + 1U) & 0x03U;
+
+			ESD_REFRESH_TIM->ARR = on_ticks[refresh_position] - 1U;
+			refresh_on_phase = 1;
+		}
+	}
+}
 
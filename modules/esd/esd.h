@@ -12,6 +12,8 @@
 #define ESD_ESD_H_
 
 #include "stm32f4xx.h"
+#include <dma_alloc/dma_alloc.h>
+#include <irq/irq.h>
 /**
  * @file esd.h
  * @brief Headerdatei zur Ansteuerung eines 4-stelligen 7-Segment-Displays.
@@ -43,10 +45,85 @@
 #define G_PE GPIO_PIN_12 		// PE12
 #define DOT_PE GPIO_PIN_11 		// PE11
 
+/** @brief Alle Pins je Port (Konfiguration mit LL_GPIO_CONFIG) */
+#define ESD_PINS_PD	(CNTL1_PD | CNTL2_PD | CNTL3_PD | CNTL4_PD | A_PD | B_PD | C_PD | D_PD | E_PD | F_PD)
+#define ESD_PINS_PE	(POINT_PE | G_PE | DOT_PE)
+
+/** @brief Timer für den Multiplexbetrieb (APB1, von keinem anderen Modul belegt) */
+#define ESD_REFRESH_TIM				TIM7
+#define ESD_REFRESH_IRQn			TIM7_IRQn
+
+/** @brief Zähltakt des Refresh-Timers in Hz (1 µs Auflösung) */
+#define ESD_REFRESH_COUNTER_HZ		1000000U
+
+/** @brief Standard-Bildwiederholrate des ganzen Displays in Hz (je Position 4-fach) */
+#define ESD_REFRESH_RATE_HZ			250U
+
+/** @brief Zähltakt des Zähler-Timers in Hz (0,1 ms Auflösung) */
+#define ESD_COUNTER_COUNTER_HZ		10000U
+
+/** @brief Längster Zähl- bzw. Spiegelschritt in ms (16-Bit-Reload bei ESD_COUNTER_COUNTER_HZ) */
+#define ESD_COUNTER_MAX_INTERVAL_MS	6553U
+
+/** @brief NVIC-Priorität des Refresh-Interrupts */
+#define ESD_REFRESH_IRQ_PRIORITY	IRQ_CLASS_REFRESH
+
+/**
+ * @brief Timer und DMA-Streams für den Multiplexbetrieb ohne CPU.
+ *
+ * Nur DMA2 erreicht die GPIO-Ports am AHB1, daher ein APB2-Timer mit
+ * DMA2-Anforderungen (Kanal 7). TIM8 darf nicht gleichzeitig von
+ * potis_dma (POTIS_DMA_MODE_TIMER) oder fan verwendet werden.
+ * - Stream 2 (TIM8_CH1): alle Positionen aus (Port D)
+ * - Stream 3 (TIM8_CH2): Segment G und Komma der nächsten Position (Port E)
+ * - Stream 1 (TIM8_UP):  Segmente A–F und nächste Position ein (Port D)
+ */
+#define ESD_DMA_TIM					TIM8
+#define ESD_DMA_REQ_OFF				DMA_ALLOC_REQ_TIM8_CH1
+#define ESD_DMA_REQ_GPIOE			DMA_ALLOC_REQ_TIM8_CH2
+#define ESD_DMA_REQ_GPIOD			DMA_ALLOC_REQ_TIM8_UP
+
+/** @brief DMA-Anforderung für die Einschaltdauer je Position (TIM8_CH4, Stream 7 -> TIM8->CCR1) */
+#define ESD_DMA_REQ_ON_TIME			DMA_ALLOC_REQ_TIM8_CH4
+
+/** @brief Maximale Helligkeit einer Position (ganzer Abschnitt abzüglich Dunkelzeit) */
+#define ESD_BRIGHTNESS_MAX			255U
+
+/**
+ * @brief Standard-Dunkelzeit zwischen zwei Positionen in µs.
+ *
+ * Alle Positionen sind aus, während die Segmente umgeschaltet werden;
+ * die Treiber und die Kapazität der Leitungen klingen in dieser Zeit ab.
+ */
+#define ESD_BLANKING_US				10U
+
+/**
+ * @brief Punkte einer Position (esd_set_points(), esd_show_digit_points()).
+ */
+#define ESD_POINT_NONE		0x00U
+#define ESD_POINT_DOT		0x01U	// Komma (DOT_PE)
+#define ESD_POINT_POINT		0x02U	// Punkt (POINT_PE)
+
+/**
+ * @brief Bitmuster eines Zeichens (esd_set_pattern(), esd_digit_pattern()).
+ *
+ * Bit 6..0 = Segment A..G, Bit 7 = Komma (DOT). Ein gesetztes Bit
+ * schaltet das Segment ein.
+ */
+#define ESD_SEGMENT_A		(1U << 6)
+#define ESD_SEGMENT_B		(1U << 5)
+#define ESD_SEGMENT_C		(1U << 4)
+#define ESD_SEGMENT_D		(1U << 3)
+#define ESD_SEGMENT_E		(1U << 2)
+#define ESD_SEGMENT_F		(1U << 1)
+#define ESD_SEGMENT_G		(1U << 0)
+#define ESD_SEGMENT_DOT		(1U << 7)
+#define ESD_SEGMENT_BLANK	0x00U
+
 
 /**
  * @enum esd_digit_t
- * @brief Repräsentiert die anzuzeigenden Ziffern (0–9).
+ * @brief Repräsentiert die anzuzeigenden Zeichen (0–9, Hex A–F, Minus, dunkel).
  */
 typedef enum {
 	ESD_DIGIT_0, //Ziffer 0
@@ -58,7 +135,16 @@ typedef enum {
 	ESD_DIGIT_6, //Ziffer 6
 	ESD_DIGIT_7, //Ziffer 7
 	ESD_DIGIT_8, //Ziffer 8
-	ESD_DIGIT_9 //Ziffer 9
+	ESD_DIGIT_9, //Ziffer 9
+	ESD_DIGIT_A, //Hex A
+	ESD_DIGIT_B, //Hex b
+	ESD_DIGIT_C, //Hex C
+	ESD_DIGIT_D, //Hex d
+	ESD_DIGIT_E, //Hex E
+	ESD_DIGIT_F, //Hex F
+	ESD_DIGIT_MINUS, //Minuszeichen (Segment G)
+	ESD_DIGIT_BLANK, //Stelle dunkel
+	ESD_DIGIT_COUNT //Anzahl der Zeichen
 } esd_digit_t;
 
 /**
@@ -75,6 +161,30 @@ typedef enum {
 
 } esd_position_t;
 
+/**
+ * @enum esd_format_t
+ * @brief Darstellung eines Werts (esd_set_formatted(), Zähler, Spiegel).
+ */
+typedef enum {
+	ESD_FORMAT_NUMBER,	// 0000–9999 mit führenden Nullen
+	ESD_FORMAT_SIGNED,	// -999–9999, führende Nullen dunkel
+	ESD_FORMAT_HEX,		// 0000–FFFF
+	ESD_FORMAT_TIME		// mm,ss: Wert = Minuten * 100 + Sekunden, Komma hinter Position 2
+} esd_format_t;
+
+/**
+ * @brief Quelle eines Spiegels (Interrupt des Hintergrund-Timers).
+ *
+ * @return Anzuzeigender Wert in der Darstellung des Spiegels
+ */
+typedef int32_t (*esd_mirror_source_t)(void *context);
+
+/**
+ * @brief Wird am Ende eines Zähl- oder Countdown-Laufs aufgerufen
+ *        (Interrupt des Zähler-Timers).
+ */
+typedef void (*esd_counter_done_t)(void *context);
+
 /**
  * @brief Initialisiert alle benötigten GPIO-Pins für das Display.
  *
@@ -86,15 +196,24 @@ void esd_init(void);
 /**
  * @brief Zeigt eine Ziffer an einer bestimmten Displayposition an.
  *
- * @param digit  Die darzustellende Ziffer (0–9)
+ * @param digit  Das darzustellende Zeichen (ESD_DIGIT_0 ... ESD_DIGIT_BLANK)
  * @param pos    Die gewünschte Position (1–4 oder alle)
  *
- * Diese Funktion steuert die Segmente entsprechend dem
- * Bitmuster der gewählten Ziffer an und aktiviert die
- * zugehörige Position (CNTL1–CNTL4).
+ * Diese Funktion legt die vorberechneten BSRR-Worte des Zeichens an
+ * (je ein Schreibzugriff auf Port D und Port E) und aktiviert die
+ * zugehörige Position (CNTL1–CNTL4) im selben Zugriff auf Port D.
  */
 void esd_show_digit(esd_digit_t digit, esd_position_t pos);
 
+/**
+ * @brief Zeigt eine Ziffer mit Punkt und/oder Komma an einer Position an.
+ *
+ * @param digit   Das darzustellende Zeichen (ESD_DIGIT_0 ... ESD_DIGIT_BLANK)
+ * @param pos     Die gewünschte Position (1–4 oder alle)
+ * @param points  ESD_POINT_NONE oder Kombination aus ESD_POINT_DOT, ESD_POINT_POINT
+ */
+void esd_show_digit_points(esd_digit_t digit, esd_position_t pos, uint8_t points);
+
 /**
  * @brief Schaltet alle Positionen (CNTL1–CNTL4) aus.
  *
@@ -104,14 +223,229 @@ void esd_show_digit(esd_digit_t digit, esd_position_t pos);
 void turnAllPositionsOff(void);
 
 /**
- * @brief Schreibt ein 16-Bit-Bitmuster auf alle Display-GPIOs.
+ * @brief Liefert das Segment-Bitmuster einer Ziffer.
+ *
+ * @param digit  Zeichen (ESD_DIGIT_0 ... ESD_DIGIT_BLANK)
+ * @return Bitmuster (ESD_SEGMENT_A ... ESD_SEGMENT_G)
+ */
+uint8_t esd_digit_pattern(esd_digit_t digit);
+
+/**
+ * @brief Startet den Multiplexbetrieb im Hintergrund.
+ *
+ * Der Timer ESD_REFRESH_TIM teilt den Bildwechsel in 4 Abschnitte mit je
+ * einer Einschalt- und einer Dunkelphase (8 Interrupts je Bild). Zu Beginn
+ * der Einschaltphase legt der Interrupt das Bitmuster der Position aus dem
+ * Anzeigepuffer an und schaltet sie ein, zu Beginn der Dunkelphase alle
+ * Positionen aus (esd_set_brightness(), esd_set_blanking_us()).
+ * Die Anwendung schreibt nur noch in den Puffer (esd_set_number(),
+ * esd_set_pattern()) und blockiert nicht.
  *
- * Steuert Segmente (A–G, Punkt/DOT) und Steuerleitungen (CNTL1–CNTL4)
- * entsprechend dem übergebenen Bitmuster.
+ * Während der Multiplexbetrieb läuft, darf esd_show_digit() nicht
+ * verwendet werden.
  *
- * @param bincode  16-Bit-Wert für das Anzeigemuster.
+ * @param rate_hz  Bildwiederholrate des ganzen Displays (z. B. ESD_REFRESH_RATE_HZ)
+ * @return HAL_OK, HAL_ERROR bei ungültiger Rate
  */
-void utils_gpio_port_write(uint16_t bincode);
+HAL_StatusTypeDef esd_refresh_start(uint16_t rate_hz);
 
+/**
+ * @brief Startet den Multiplexbetrieb per DMA ohne CPU und ohne Interrupts.
+ *
+ * ESD_DMA_TIM teilt den Bildwechsel in 4 Abschnitte. Zirkulare DMA2-Streams
+ * schreiben die BSRR-Worte aus dem Anzeigepuffer: nach der Einschaltdauer
+ * (CC1) alle Positionen aus, einen Takt vor dem Überlauf (CC2, CC4) Port E
+ * und die Einschaltdauer der nächsten Position, beim Überlauf Port D mit
+ * der nächsten Position. Helligkeit und Dunkelzeit wie im Interrupt-Betrieb.
+ *
+ * Der Puffer wird wie im Interrupt-Betrieb mit esd_set_number() und
+ * esd_set_pattern() beschrieben, die DMA liest ihn direkt.
+ *
+ * @param rate_hz  Bildwiederholrate des ganzen Displays (z. B. ESD_REFRESH_RATE_HZ)
+ * @return HAL_OK, HAL_ERROR bei ungültiger Rate oder DMA-Fehler
+ */
+HAL_StatusTypeDef esd_refresh_start_dma(uint16_t rate_hz);
+
+/**
+ * @brief Stoppt den Multiplexbetrieb (Interrupt oder DMA) und schaltet alle
+ *        Positionen aus.
+ */
+void esd_refresh_stop(void);
+
+/**
+ * @brief Wandelt eine Zahl in gepackte BCD-Ziffern (ohne Division, je
+ *        Stelle eine Multiplikation mit dem Kehrwert).
+ *
+ * @param value  Zahl (0–9999), größere Werte werden auf 9999 begrenzt
+ * @return BCD, Bit 15..12 = Tausender ... Bit 3..0 = Einer
+ */
+uint16_t esd_to_bcd(uint16_t value);
+
+/**
+ * @brief Schreibt eine vierstellige Zahl in den Anzeigepuffer.
+ *
+ * Die Ziffern werden ohne Division zerlegt, führende Nullen werden
+ * angezeigt.
+ *
+ * @param value  Zahl (0–9999), größere Werte werden auf 9999 begrenzt
+ */
+void esd_set_number(uint16_t value);
+
+/**
+ * @brief Schreibt eine Zahl mit Vorzeichen in den Anzeigepuffer.
+ *
+ * Führende Nullen bleiben dunkel, das Minus steht direkt vor der ersten
+ * Ziffer.
+ *
+ * @param value  Zahl (-999–9999), Werte außerhalb werden begrenzt
+ */
+void esd_set_signed(int16_t value);
+
+/**
+ * @brief Schreibt eine Zahl hexadezimal (0000–FFFF) in den Anzeigepuffer.
+ *
+ * @param value  Zahl
+ */
+void esd_set_hex(uint16_t value);
+
+/**
+ * @brief Schreibt eine Festkommazahl in den Anzeigepuffer.
+ *
+ * value ist der Wert in Einheiten von 10^-decimals (z. B. 1234 mit 2
+ * Nachkommastellen = 12,34). Das Komma (ESD_POINT_DOT) der Einerstelle
+ * wird gesetzt, die Kommas der anderen Positionen gelöscht. Führende
+ * Nullen vor der Einerstelle bleiben dunkel.
+ *
+ * @param value     Wert (-999–9999), Werte außerhalb werden begrenzt
+ * @param decimals  Nachkommastellen (0–3)
+ */
+void esd_set_fixed(int16_t value, uint8_t decimals);
+
+/**
+ * @brief Schreibt ein Bitmuster für eine Position in den Anzeigepuffer.
+ *
+ * @param pos      Position (ESD_POSITION_1 ... ESD_POSITION_4)
+ * @param pattern  Bitmuster (ESD_SEGMENT_x, z. B. esd_digit_pattern() | ESD_SEGMENT_DOT)
+ */
+void esd_set_pattern(esd_position_t pos, uint8_t pattern);
+
+/**
+ * @brief Setzt Punkt und Komma einer Position im Anzeigepuffer.
+ *
+ * Die Punkte bleiben erhalten, wenn danach eine neue Zahl geschrieben wird.
+ *
+ * @param pos     Position (ESD_POSITION_1 ... ESD_POSITION_4 oder alle)
+ * @param points  ESD_POINT_NONE oder Kombination aus ESD_POINT_DOT, ESD_POINT_POINT
+ */
+void esd_set_points(esd_position_t pos, uint8_t points);
+
+/**
+ * @brief Setzt die Helligkeit einer Position im Multiplexbetrieb.
+ *
+ * Die Helligkeit ist die Einschaltdauer der Position innerhalb ihres
+ * Abschnitts (PWM): ESD_BRIGHTNESS_MAX = Abschnitt abzüglich Dunkelzeit,
+ * 0 = Position bleibt dunkel. Gilt im Interrupt- und im DMA-Betrieb.
+ *
+ * @param pos    Position (ESD_POSITION_1 ... ESD_POSITION_4 oder alle)
+ * @param level  Helligkeit 0 ... ESD_BRIGHTNESS_MAX
+ */
+void esd_set_brightness(esd_position_t pos, uint8_t level);
+
+/**
+ * @brief Setzt die Dunkelzeit zwischen zwei Positionen.
+ *
+ * Wird auf mindestens 1 µs (DMA-Betrieb 2 µs) und höchstens den Abschnitt
+ * abzüglich 1 µs Einschaltdauer begrenzt.
+ *
+ * @param blanking_us  Dunkelzeit in µs (Standard ESD_BLANKING_US)
+ */
+void esd_set_blanking_us(uint16_t blanking_us);
+
+/**
+ * @brief Schreibt einen Wert in einer Darstellung in den Anzeigepuffer.
+ *
+ * Werte außerhalb des Bereichs der Darstellung werden begrenzt (Hex:
+ * untere 16 Bit). ESD_FORMAT_TIME setzt das Komma hinter Position 2 und
+ * löscht die anderen Kommas.
+ *
+ * @param value   Wert
+ * @param format  Darstellung
+ */
+void esd_set_formatted(int32_t value, esd_format_t format);
+
+/**
+ * @brief Startet einen Zähler oder Countdown im Hintergrund.
+ *
+ * Der Hintergrund-Timer (tim_alloc, nach Fähigkeit) schreibt alle
+ * interval_ms den nächsten Wert in den Anzeigepuffer, der Multiplexbetrieb
+ * (Interrupt oder DMA) zeigt ihn an; die Anwendung läuft weiter. Von from
+ * nach to zählt abwärts (from > to) oder aufwärts. Beide Werte ab 0
+ * werden vierstellig mit führenden Nullen angezeigt (esd_set_number()),
+ * sonst mit Vorzeichen (esd_set_signed()). Nach dem Anzeigen von to wird
+ * der Timer freigegeben und done aufgerufen. Ein laufender Spiegel
+ * (esd_mirror_start()) wird beendet.
+ *
+ * Während der Zähler läuft, schreibt die Anwendung keine Zahlen in den
+ * Anzeigepuffer; Punkte und Helligkeit dürfen geändert werden.
+ *
+ * @param from         Startwert (-999–9999), sofort angezeigt
+ * @param to           Endwert (-999–9999)
+ * @param interval_ms  Dauer eines Werts (1–ESD_COUNTER_MAX_INTERVAL_MS)
+ * @param done         Abschluss-Callback oder NULL
+ * @param context      Wird an done übergeben
+ * @return HAL_OK, HAL_ERROR bei ungültigen Werten oder ohne laufenden
+ *         Multiplexbetrieb, HAL_BUSY wenn kein Timer frei ist
+ */
+HAL_StatusTypeDef esd_counter_start(int16_t from, int16_t to, uint16_t interval_ms,
+									esd_counter_done_t done, void *context);
+
+/**
+ * @brief Bricht einen laufenden Zähler ab, ohne done aufzurufen; der
+ *        zuletzt angezeigte Wert bleibt stehen.
+ */
+void esd_counter_stop(void);
+
+/**
+ * @brief Liefert den angezeigten Wert des Zählers.
+ *
+ * @return Aktueller Wert (nach dem Ende der Endwert)
+ */
+int16_t esd_counter_get(void);
+
+/**
+ * @brief Prüft, ob ein Zähler läuft.
+ *
+ * @return 1 während des Laufs, sonst 0
+ */
+uint8_t esd_counter_is_running(void);
+
+/**
+ * @brief Spiegelt eine Messgröße im Hintergrund auf das Display.
+ *
+ * Der Hintergrund-Timer ruft alle interval_ms die Quelle auf und schreibt
+ * den Wert nur bei einer Änderung in den Anzeigepuffer, der
+ * Multiplexbetrieb zeigt ihn ohne weitere Verzögerung an. Zeitkritische
+ * Anzeigen (Stoppuhr, Drehzahl) brauchen so keinen SPI-Transfer zum LCD.
+ * Die Quelle stellt die Anwendung bereit (z. B. 08_Stopwatch: Stoppuhr
+ * als mm,ss), das Modul hängt von keinem Messmodul ab. Ein laufender
+ * Zähler wird beendet.
+ *
+ * Die Quelle läuft im Interrupt (ESD_REFRESH_IRQ_PRIORITY) und darf nur
+ * interruptfeste Lesefunktionen verwenden.
+ *
+ * @param source       Quelle
+ * @param context      Wird an source übergeben
+ * @param format       Darstellung
+ * @param interval_ms  Abfrageintervall (1–ESD_COUNTER_MAX_INTERVAL_MS)
+ * @return HAL_OK, HAL_ERROR bei ungültigen Werten oder ohne laufenden
+ *         Multiplexbetrieb, HAL_BUSY wenn kein Timer frei ist
+ */
+HAL_StatusTypeDef esd_mirror_start(esd_mirror_source_t source, void *context, esd_format_t format,
+								   uint16_t interval_ms);
+
+/**
+ * @brief Beendet den Spiegel; der letzte Wert bleibt stehen.
+ */
+void esd_mirror_stop(void);
 
 #endif /* ESD_ESD_H_ */
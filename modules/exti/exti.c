@@ -0,0 +1,172 @@
+/**
+ ******************************************************************************
+ * @file        exti.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Shared EXTI dispatch implementation
+ *
+ * Functionality:
+ * - Handler table indexed by EXTI line
+ * - IRQ handlers read the pending register once, clear the served bits
+ *   and call the registered handlers directly
+ *
+ * Peripherals:
+ * - EXTI lines 0..15
+ * - EXTI0_IRQn .. EXTI4_IRQn, EXTI9_5_IRQn, EXTI15_10_IRQn
+ ******************************************************************************
+ */
+
+#include "exti.h"
+#include "health/health.h"
+
+/* Static module variables -------------------------------------------------- */
+/**
+ * @brief Registered handler of one line.
+ */
+typedef struct {
+    exti_handler_t handler;
+    void          *context;
+} exti_entry_t;
+
+/**
+ * @brief Handler table, NULL handler = line free.
+ */
+static exti_entry_t g_exti_entries[EXTI_LINE_COUNT];
+
+/* Static function prototypes ---------------------------------------------- */
+static IRQn_Type exti_line_irq(uint8_t u8_line);
+static void exti_dispatch(uint32_t u32_mask);
+
+/* Public functions --------------------------------------------------------- */
+HAL_StatusTypeDef exti_register(uint8_t u8_line, exti_handler_t handler, void *context)
+{
+    if ((u8_line >= EXTI_LINE_COUNT) || (handler == NULL) ||
+        (g_exti_entries[u8_line].handler != NULL)) {
+        return HAL_ERROR;
+    }
+
+    /* Context first: the IRQ may fire as soon as the handler is visible */
+    g_exti_entries[u8_line].context = context;
+    __DMB();
+    g_exti_entries[u8_line].handler = handler;
+
+    return HAL_OK;
+}
+
+void exti_unregister(uint8_t u8_line)
+{
+    if (u8_line >= EXTI_LINE_COUNT) {
+        return;
+    }
+
+    EXTI->IMR &= ~(1UL << u8_line);
+    EXTI->PR   = 1UL << u8_line;
+    g_exti_entries[u8_line].handler = NULL;
+}
+
+void exti_enable_irq(uint8_t u8_line, uint32_t u32_preempt, uint32_t u32_subpriority)
+{
+    IRQn_Type irq = exti_line_irq(u8_line);
+    uint32_t u32_preempt_set;
+    uint32_t u32_sub_set;
+
+    /* Shared vector already in use: never make it less urgent for the other lines */
+    if (NVIC_GetEnableIRQ(irq)) {
+        NVIC_DecodePriority(NVIC_GetPriority(irq), NVIC_GetPriorityGrouping(), &u32_preempt_set, &u32_sub_set);
+        if (u32_preempt_set < u32_preempt) {
+            return;
+        }
+    }
+
+    HAL_NVIC_SetPriority(irq, u32_preempt, u32_subpriority);
+    HAL_NVIC_EnableIRQ(irq);
+}
+
+uint8_t exti_pin_to_line(uint16_t u16_pin)
+{
+    return (uint8_t)__CLZ(__RBIT((uint32_t)u16_pin));
+}
+
+/* Static module functions -------------------------------------------------- */
+/**
+ * @brief Returns the NVIC interrupt serving an EXTI line.
+ *
+ * @param u8_line Line 0..15
+ * @return Interrupt number
+ */
+static IRQn_Type exti_line_irq(uint8_t u8_line)
+{
+    switch (u8_line) {
+    case 0u:  return EXTI0_IRQn;
+    case 1u:  return EXTI1_IRQn;
+    case 2u:  return EXTI2_IRQn;
+    case 3u:  return EXTI3_IRQn;
+    case 4u:  return EXTI4_IRQn;
+    default:
+        return (u8_line <= 9u) ? EXTI9_5_IRQn : EXTI15_10_IRQn;
+    }
+}
+
+/**
+ * @brief Clears and serves all pending lines of a mask.
+ *
+ * @param u32_mask Lines served by the calling IRQ handler
+ */
+static void exti_dispatch(uint32_t u32_mask)
+{
+    uint32_t u32_pending = EXTI->PR & u32_mask;
+
+    EXTI->PR = u32_pending;
+
+    while (u32_pending != 0u) {
+        uint32_t u32_line = __CLZ(__RBIT(u32_pending));
+        exti_handler_t handler = g_exti_entries[u32_line].handler;
+
+        u32_pending &= u32_pending - 1u;
+        if (handler != NULL) {
+            handler(g_exti_entries[u32_line].context);
+        }
+    }
+}
+
+/* Interrupt / callback section -------------------------------------------- */
+void EXTI0_IRQHandler(void)
+{
+    EXTI->PR = EXTI_PR_PR0;
+    if (g_exti_entries[0].handler != NULL) {
+        g_exti_entries[0].handler(g_exti_entries[0].context);
+    }
+}
+
+void EXTI1_IRQHandler(void)
+{
+    exti_dispatch(EXTI_PR_PR1);
+}
+
+void EXTI2_IRQHandler(void)
+{
+    exti_dispatch(EXTI_PR_PR2);
+}
+
+void EXTI3_IRQHandler(void)
+{
+    exti_dispatch(EXTI_PR_PR3);
+}
+
+void EXTI4_IRQHandler(void)
+{
+    exti_dispatch(EXTI_PR_PR4);
+}
+
+void EXTI9_5_IRQHandler(void)
+{
+    HEALTH_ISR_BEGIN(HEALTH_ISR_EXTI9_5);
+    exti_dispatch(0x000003E0u);
+    HEALTH_ISR_END(HEALTH_ISR_EXTI9_5);
+}
+
+void EXTI15_10_IRQHandler(void)
+{
+    exti_dispatch(0x0000FC00u);
+}
@@ -0,0 +1,86 @@
+/**
+ ******************************************************************************
+ * @file        exti.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the shared EXTI dispatch module.
+ *
+ * @details
+ * Owns the EXTI line interrupt handlers so several interrupt driven
+ * modules can be linked into one image. Each of the 16 GPIO EXTI lines
+ * has one registered handler with a context pointer. The IRQ handlers
+ * clear the pending bit and call the handler directly, without the HAL
+ * dispatcher (HAL_GPIO_EXTI_IRQHandler / HAL_GPIO_EXTI_Callback).
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - Per-line registration of handler + context (lines 0..15)
+ *  - EXTI0..EXTI4, EXTI9_5 and EXTI15_10 IRQ handlers
+ *  - NVIC setup per line group
+ *
+ * The GPIO itself is still configured by the owning module
+ * (HAL_GPIO_Init with GPIO_MODE_IT_*), after registering the handler.
+ *
+ ******************************************************************************
+ */
+
+#ifndef EXTI_EXTI_H_
+#define EXTI_EXTI_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief Number of GPIO EXTI lines.
+ */
+#define EXTI_LINE_COUNT     16U
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Handler of one EXTI line, called in interrupt context.
+ */
+typedef void (*exti_handler_t)(void *context);
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Registers the handler of an EXTI line.
+ *
+ * @param u8_line Line 0..15 (= GPIO pin number)
+ * @param handler Function called on every edge
+ * @param context Passed to the handler
+ * @return HAL_OK, HAL_ERROR if the line is invalid or already taken
+ */
+HAL_StatusTypeDef exti_register(uint8_t u8_line, exti_handler_t handler, void *context);
+
+/**
+ * @brief Removes the handler of an EXTI line and masks the line.
+ *
+ * @param u8_line Line 0..15
+ * @return None
+ */
+void exti_unregister(uint8_t u8_line);
+
+/**
+ * @brief Sets the priority of the NVIC interrupt serving a line and
+ *        enables it. EXTI9_5 and EXTI15_10 are shared by several lines;
+ *        an enabled vector keeps a more urgent priority of an earlier
+ *        call, so it serves its most urgent line (see modules/irq).
+ *
+ * @param u8_line         Line 0..15
+ * @param u32_preempt     Preemption priority
+ * @param u32_subpriority Subpriority
+ * @return None
+ */
+void exti_enable_irq(uint8_t u8_line, uint32_t u32_preempt, uint32_t u32_subpriority);
+
+/**
+ * @brief Converts a GPIO pin mask into its EXTI line.
+ *
+ * @param u16_pin GPIO_PIN_0 .. GPIO_PIN_15 (single bit)
+ * @return Line 0..15
+ */
+uint8_t exti_pin_to_line(uint16_t u16_pin);
+
+#endif /* EXTI_EXTI_H_ */
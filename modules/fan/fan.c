@@ -9,52 +9,201 @@
  * Functionality:
  * - Generates a PWM signal on TIM9 CH1 for fan speed control
  * - Measures fan tacho pulses via EXTI and computes RPM using TIM2 timestamps
+ *   (or, with FAN_TACHO_CAPTURE, via TIM2 CH1 input capture + DMA of
+ *   the freqmeter module)
  * - Applies a median filter to RPM values (median module)
- * - Provides a PI controller to reach a target RPM
+ * - Provides a PI(D) controller to reach a target RPM (step in fan_pi.c:
+ *   back-calculation anti-windup, duty slew limit, D on the measurement)
+ * - Any number of fans (up to FAN_MAX_INSTANCES) via fan_t instances
+ * - Relay feedback autotune of the PI gains
+ * - Feed-forward RPM -> duty table from a calibration sweep
+ * - Stall detection with kick-start and lock-out
+ * - Emergency guard: full duty written from the analog watchdog or tacho
+ *   interrupt, latched; every compare write of the control path gives
+ *   way to it
+ * - Tacho state and control statistics shared lock-free (sync snapshots)
+ * - Target and RPM of the default fan published per control step
+ *   (DATABUS_TOPIC_FAN)
  *
  * Peripherals:
  * - GPIOE:
  *   - PWM pin configured as AF (TIM9)
  *   - Tacho pin configured as EXTI rising edge interrupt
- * - TIM9: PWM generator
- * - TIM2: free-running timer @ 1 MHz
- * - EXTI9_5_IRQn: interrupt for tacho pulses
+ * - TIM9: PWM generator (TIM1/TIM8 channels for further fans)
+ * - TIM2: system timebase @ 1 MHz (timebase module), tacho time stamps
+ * - EXTI line of the tacho pin: interrupt for tacho pulses (exti module)
+ * - Capture mode: PA5 (TIM2 CH1) through the freqmeter module, TIM2_CH1
+ *   request of dma_alloc (DMA1 Stream5 Channel 3), one interrupt per
+ *   half ring (overspeed check)
+ * - TIM6: fixed-rate control task (fan_control_start)
+ * - Current sense: PC3 (ADC1_IN13) injected conversions (functions of
+ *   fan_set_adc_ops(), e.g. potis_dma),
+ *   trigger TIM1 / TIM8 CH4 or TIM9 CH2 compare interrupt
+ * - Guard: ADC1 analog watchdog (fan_set_adc_ops(), ADC_IRQn), capture
+ *   mode overspeed check in the freqmeter DMA interrupt
  ******************************************************************************
  */
 
 #include "fan.h"
-#include "median/median.h"
+#include "fan_pi.h"
+#include "clock/clock.h"
+#include "databus/databus.h"
+#include "dma_alloc/dma_alloc.h"
+#include "datalog/datalog.h"
+#include "deadline/deadline.h"
+#include "dlog/dlog.h"
+#include "exti/exti.h"
+#include "freqmeter/freqmeter.h"
+#include "health/health.h"
+#include "osal/osal.h"
+#include "params/params.h"
+#include "adc_cal/adc_cal.h"
+#include "bkptrace/bkptrace.h"
+#include "profile/profile.h"
+#include "pwm/pwm.h"
+#include "sync/sync.h"
+#include "trace/trace.h"
+#include "utils/utils.h"
+#include "ll/ll.h"
+#include "tim_alloc/tim_alloc.h"
+#include "timebase/timebase.h"
+
+#if (FAN_CONTROL_IRQ_PRIORITY < OSAL_IRQ_PRIORITY_MIN)
+#error "FAN_CONTROL_IRQ_PRIORITY must allow kernel calls (OSAL_IRQ_PRIORITY_MIN)"
+#endif
+
+#if (FAN_EDGE_HISTORY & (FAN_EDGE_HISTORY - 1u)) != 0
+#error "FAN_EDGE_HISTORY must be a power of two"
+#endif
+
+#if (FAN_EDGE_QUEUE & (FAN_EDGE_QUEUE - 1u)) != 0
+#error "FAN_EDGE_QUEUE must be a power of two"
+#endif
+
+#if (FAN_RPM_EDGES == 0) || (FAN_RPM_EDGES >= FAN_EDGE_HISTORY) || (FAN_RPM_EDGES >= FAN_TACHO_RING_LENGTH)
+#error "FAN_RPM_EDGES must be 1 .. FAN_EDGE_HISTORY - 1"
+#endif
+
+/* Private Preprocessor Defines -------------------------------------------- */
+/**
+ * @brief PWM compare of a fan: register access (FAN_LL_ENABLE) or the HAL
+ *        macro, which selects the register by comparing the channel.
+ */
+#if FAN_LL_ENABLE
+#define FAN_SET_COMPARE(fan, value) \
+    (LL_TIM_CCR((fan)->p_pwm_handle->Instance, (fan)->config.pwm_channel) = (uint32_t)(value))
+#define FAN_GET_COMPARE(fan) \
+    LL_TIM_CCR((fan)->p_pwm_handle->Instance, (fan)->config.pwm_channel)
+#define FAN_TACHO_READ(fan) \
+    LL_GPIO_READ((fan)->config.tacho_port, (fan)->config.tacho_pin)
+#else
+#define FAN_SET_COMPARE(fan, value) \
+    __HAL_TIM_SET_COMPARE((fan)->p_pwm_handle, (fan)->config.pwm_channel, (value))
+#define FAN_GET_COMPARE(fan) \
+    __HAL_TIM_GET_COMPARE((fan)->p_pwm_handle, (fan)->config.pwm_channel)
+#define FAN_TACHO_READ(fan) \
+    HAL_GPIO_ReadPin((fan)->config.tacho_port, (fan)->config.tacho_pin)
+#endif
 
 /* Static module variables -------------------------------------------------- */
 /**
- * @brief TIM9 handle used for PWM generation.
+ * @brief Built-in instance used by the single-fan API. Tacho history,
+ *        median ring and PI state live in CCM RAM (control interrupt).
+ */
+static fan_t g_fan_default UTILS_CCM_BSS;
+
+/**
+ * @brief Wiring of the built-in instance (board: PE5 TIM9 CH1, PE6 tacho).
+ */
+static const fan_config_t g_fan_default_config = {
+    .pwm_timer     = TIM9,
+    .pwm_channel   = TIM_CHANNEL_1,
+    .pwm_port      = FAN_GPIO_PORT,
+    .pwm_pin       = FAN_PWM_INPUT,
+    .pwm_alternate = GPIO_AF3_TIM9,
+#if FAN_TACHO_CAPTURE
+    .tacho_port    = NULL,
+#else
+    .tacho_port    = FAN_GPIO_PORT,
+#endif
+    .tacho_pin     = FAN_TACHO_OUTPUT,
+};
+
+/**
+ * @brief Registered instances, updated by fan_control_step_all().
+ */
+static fan_t *g_p_fans[FAN_MAX_INSTANCES] UTILS_CCM_BSS;
+static volatile uint8_t g_u8_fan_count = 0u;
+
+/**
+ * @brief Fan with the current sense (one ADC channel).
  */
-static TIM_HandleTypeDef g_fan_tim9_handle_struct;
+static fan_t *g_p_fan_current = NULL;
 
 /**
- * @brief TIM2 handle used as free-running timestamp timer for tacho.
+ * @brief ADC1 functions of the application, NULL: no current sense.
  */
-static TIM_HandleTypeDef g_fan_tim2_handle_struct;
+static const fan_adc_ops_t *g_p_fan_adc_ops = NULL;
 
 /**
- * @brief Last TIM2 tick count at previous tacho pulse.
+ * @brief Fan whose guard owns the analog watchdog.
  */
-static volatile uint32_t g_u32_ticks_last = 0u;
+static fan_t *g_p_fan_guard_adc = NULL;
 
 /**
- * @brief Time difference (ticks) between two tacho pulses (TIM2 @ 1 MHz).
+ * @brief PWM timers and their handles, one per distinct timer.
  */
-static volatile uint32_t g_u32_time_diff = 0u;
+static pwm_timer_t g_fan_pwm[FAN_MAX_PWM_TIMERS];
+static TIM_HandleTypeDef g_fan_pwm_handle_struct[FAN_MAX_PWM_TIMERS];
+static uint8_t g_u8_fan_pwm_count = 0u;
 
 /**
- * @brief CPU tick timestamp (ms) when last tacho pulse was received.
+ * @brief Batched output: compares of the fan timers collected during
+ *        fan_control_step_all(), bit per timer while collecting.
  */
-static volatile uint32_t g_u32_cpu_ticks_now = 0u;
+static uint32_t g_u32_fan_batch[FAN_MAX_PWM_TIMERS][PWM_MAX_CHANNELS];
+static uint8_t g_u8_fan_batching = 0u;
 
+#if FAN_TACHO_CAPTURE
 /**
- * @brief Target RPM set by application.
+ * @brief Tacho input on TIM2 CH1: capture stamps (TIM2 @ 1 MHz) written
+ *        circularly by DMA, counted by the freqmeter module.
  */
-static uint32_t g_u32_target_rpm = 0u;
+static freqmeter_t g_fan_freqmeter;
+#endif
+
+/**
+ * @brief TIM6 handle, time base of the control task.
+ */
+static TIM_HandleTypeDef g_fan_tim6_handle_struct;
+
+/**
+ * @brief Statistics of the control task: working copy of the TIM6
+ *        interrupt, published after every step; reset requested by flag
+ *        so the interrupt stays the only writer.
+ */
+static fan_control_stats_t g_fan_control_stats;
+static fan_control_stats_t g_fan_control_stats_buffers[2];
+static sync_snapshot_t g_fan_control_snapshot = SYNC_SNAPSHOT_INIT(g_fan_control_stats_buffers);
+static volatile uint8_t g_u8_fan_control_reset = 0u;
+
+/**
+ * @brief Deadline supervisor step of the control task.
+ */
+static volatile uint8_t g_u8_fan_control_deadline = DEADLINE_NONE;
+
+/**
+ * @brief Signal statistics, updated in place by the TIM6 interrupt under
+ *        the sequence lock; the first step sets them up.
+ */
+static fan_signal_stats_t g_fan_signal_stats;
+static sync_seqlock_t g_fan_signal_lock;
+static volatile uint8_t g_u8_fan_signal_reset = 1u;
+
+/**
+ * @brief Set after every control step, wakes fan_control_wait().
+ */
+static osal_event_t g_fan_control_event;
 
 /* PI controller parameters ------------------------------------------------- */
 /**
@@ -63,168 +212,2070 @@ static uint32_t g_u32_target_rpm = 0u;
 static float g_f_ta = 0.02f;
 
 /**
- * @brief Proportional gain of PI controller.
+ * @brief Default proportional gain of PI controller (PARAMS_KEY_FAN_KP
+ *        overrides it).
  */
-static float g_f_kp = 0.04f;
+static const float g_f_kp = 0.04f;
 
 /**
- * @brief Integral gain of PI controller.
+ * @brief Default integral gain of PI controller (PARAMS_KEY_FAN_KI
+ *        overrides it).
  */
-static float g_f_ki = 0.03f;
+static const float g_f_ki = 0.03f;
 
 /* Static function prototypes ---------------------------------------------- */
-static void fan_gpio_init(void);
-static void fan_timer_init(void);
-static void fan_tacho_timer_init(void);
-static void fan_init_interrupt(void);
+static TIM_HandleTypeDef *fan_pwm_timer_init(TIM_TypeDef *instance);
+static pwm_timer_t *fan_pwm_timer(const TIM_HandleTypeDef *handle);
+static void fan_tacho_edge(void *context);
+static void fan_tacho_limits(fan_t *fan);
+static uint8_t fan_tacho_valid(fan_t *fan, uint32_t u32_now);
+static uint8_t fan_new_period(fan_t *fan, uint32_t *p_period);
+static void fan_update_pi_params(fan_t *fan);
+static void fan_pi_reset(fan_t *fan);
+static void fan_gain_apply(fan_t *fan);
+static void fan_set_output(fan_t *fan, float f_percent);
+static void fan_write_compare(fan_t *fan, uint32_t u32_compare, uint32_t u32_fraction);
+static void fan_set_compare(const fan_t *fan, uint32_t u32_compare);
+static uint32_t fan_get_compare(const fan_t *fan);
+static void fan_dither_stop(fan_t *fan);
+static uint32_t fan_observer_step(fan_t *fan);
+static uint32_t fan_current_trigger_channel(const fan_t *fan);
+static void fan_current_step(fan_t *fan);
+static void fan_current_compare(TIM_TypeDef *tim, uint32_t u32_flags, void *context);
+static void fan_autotune_step(fan_t *fan);
+static void fan_ff_sweep_step(fan_t *fan);
+static int32_t fan_ff_counts(const fan_t *fan, uint32_t u32_rpm);
+static uint32_t fan_traj_setpoint(fan_t *fan, uint32_t *pu32_ff_rpm);
+static uint8_t fan_health_step(fan_t *fan);
+static uint8_t fan_health_stall(fan_t *fan, uint32_t u32_now);
+static uint32_t fan_expected_rpm(const fan_t *fan, uint32_t u32_compare);
+static void fan_health_set_state(fan_t *fan, fan_health_state_t state);
+static void fan_guard_apply(fan_t *fan);
+static void fan_guard_excursion(void *context);
+#if FAN_TACHO_CAPTURE
+static void fan_tacho_capture_init(fan_t *fan);
+static void fan_capture_guard(void *context);
+static uint8_t fan_capture_period(fan_t *fan, uint32_t *p_period);
+#endif
 
 /* Public functions --------------------------------------------------------- */
 void fan_control_init(void)
 {
-    fan_gpio_init();
-    fan_timer_init();
-    fan_init_interrupt();
-    fan_tacho_timer_init();
+    fan_init(&g_fan_default, &g_fan_default_config);
 }
 
 uint32_t fan_get_filtered_rpm(void)
 {
-    if ((HAL_GetTick() - g_u32_cpu_ticks_now) > 1000u) {
-        return 0u;
+    return fan_get_rpm(&g_fan_default);
+}
+
+void fan_change_target_rpm(uint32_t target_rpm)
+{
+    fan_set_target_rpm(&g_fan_default, target_rpm);
+}
+
+uint32_t fan_get_target_rpm(void)
+{
+    return g_fan_default.u32_target_rpm;
+}
+
+void fan_update_pi_controller(void)
+{
+    PROFILE_BEGIN(PROFILE_ZONE_FAN_PI);
+    fan_update(&g_fan_default);
+    PROFILE_END(PROFILE_ZONE_FAN_PI);
+}
+
+HAL_StatusTypeDef fan_init(fan_t *fan, const fan_config_t *config)
+{
+    GPIO_InitTypeDef gpio_init_struct;
+    pwm_channel_config_t pwm_channel_struct;
+
+    if ((fan == NULL) || (config == NULL) || (g_u8_fan_count >= FAN_MAX_INSTANCES)) {
+        return HAL_ERROR;
+    }
+
+    for (uint8_t i = 0u; i < g_u8_fan_count; i++) {
+        if (g_p_fans[i] == fan) {
+            return HAL_ERROR;
+        }
+    }
+
+    /* Fails if another fan or module owns the EXTI line of the pin */
+    if ((config->tacho_port != NULL) &&
+        (exti_register(exti_pin_to_line(config->tacho_pin), fan_tacho_edge, fan) != HAL_OK)) {
+        return HAL_ERROR;
+    }
+
+    fan->config         = *config;
+    fan->u32_edges      = 0u;
+    fan->u32_edges_used = 0u;
+    fan->u32_edges_rejected = 0u;
+    sync_snapshot_init(&fan->tacho, fan->tacho_buffers, sizeof(fan_tacho_sample_t));
+    (void)sync_queue_init(&fan->edge_queue, fan->u32_edge_queue_buffer, sizeof(uint32_t), FAN_EDGE_QUEUE);
+    fan->u32_target_rpm = 0u;
+    fan->u32_rpm        = 0u;
+    fan->u32_smoothed   = 0u;
+    fan->p_rpm_biquad   = NULL;
+    fan->f_kp           = params_get_float(PARAMS_KEY_FAN_KP, g_f_kp);
+    fan->f_ki           = params_get_float(PARAMS_KEY_FAN_KI, g_f_ki);
+    fan->f_kd           = params_get_float(PARAMS_KEY_FAN_KD, 0.0f);
+    fan->f_slew         = FAN_SLEW_DEFAULT_PERCENT_PER_S;
+    fan->traj.params.f_rate  = FAN_TRAJ_RATE_RPM_S;
+    fan->traj.params.f_accel = FAN_TRAJ_ACCEL_RPM_S2;
+    fan->traj.params.f_jerk  = FAN_TRAJ_JERK_RPM_S3;
+    fan->traj.u8_enabled     = ((FAN_TRAJ_ACCEL_RPM_S2 > 0.0f) && (FAN_TRAJ_JERK_RPM_S3 > 0.0f)) ? 1u : 0u;
+    fan->traj.u32_setpoint   = 0u;
+    fan_pi_reset(fan);
+    for (uint8_t i = 0u; i < FAN_GAIN_POINTS; i++) {
+        fan->schedule.f_kp[i] = fan->f_kp;
+        fan->schedule.f_ki[i] = fan->f_ki;
+    }
+    fan->schedule.u8_enabled = 0u;
+    fan->dither.mode      = FAN_DITHER_OFF;
+    fan->dither.u32_error = 0u;
+    fan->observer.u8_enabled = 0u;
+    fan->observer.u8_fresh   = 0u;
+    fan->current.u8_enabled  = 0u;
+    fan->current.u32_mv      = 0u;
+    fan->record.u32_length   = 0u;
+    fan->record.u32_count    = 0u;
+    fan->autotune.state   = FAN_AUTOTUNE_IDLE;
+    fan->ff.table.u8_valid = 0u;
+    fan->ff.u8_enabled     = 0u;
+    fan->ff.u8_sweeping    = 0u;
+    fan->health.state       = FAN_HEALTH_OK;
+    fan->health.callback    = NULL;
+    fan->health.u8_armed    = 0u;
+    fan->health.u8_failures = 0u;
+    fan->guard.u8_fault        = 0u;
+    fan->guard.u8_adc          = 0u;
+    fan->guard.u32_min_span_us = 0u;
+    fan->guard.u32_trips       = 0u;
+    fan->guard.callback        = NULL;
+    median_filter_init(&fan->median, MEDIAN_BUFFER_LENGTH, 0u);
+
+    fan->p_pwm_handle = fan_pwm_timer_init(config->pwm_timer);
+    if (fan->p_pwm_handle == NULL) {
+        if (config->tacho_port != NULL) {
+            exti_unregister(exti_pin_to_line(config->tacho_pin));
+        }
+        return HAL_ERROR;
+    }
+    fan_update_pi_params(fan);
+    fan_tacho_limits(fan);
+
+    /* PWM output (timer AF, open drain) */
+    utils_gpio_clock_enable(config->pwm_port);
+    gpio_init_struct.Pin       = config->pwm_pin;
+    gpio_init_struct.Mode      = GPIO_MODE_AF_OD;
+    gpio_init_struct.Pull      = GPIO_NOPULL;
+    gpio_init_struct.Speed     = GPIO_SPEED_FREQ_MEDIUM;
+    gpio_init_struct.Alternate = config->pwm_alternate;
+    HAL_GPIO_Init(config->pwm_port, &gpio_init_struct);
+
+    /* Compare updates take effect at the next update event only */
+    pwm_channel_struct.u32_polarity = TIM_OCPOLARITY_HIGH;
+    pwm_channel_struct.u32_idle     = TIM_OCIDLESTATE_RESET;
+    pwm_channel_struct.align        = PWM_ALIGN_LEADING;
+    pwm_channel_struct.u32_duty     = (fan->p_pwm_handle->Init.Period + 1u) / 2u;
+    (void)pwm_channel_init(fan_pwm_timer(fan->p_pwm_handle), config->pwm_channel, &pwm_channel_struct);
+
+#if FAN_TACHO_CAPTURE
+    if (config->tacho_port == NULL) {
+        fan_tacho_capture_init(fan);
     }
+#endif
+    /* Tacho stamps in the system time (idempotent) */
+    (void)timebase_init();
 
-    if (g_u32_time_diff == 0u) {
+    if (config->tacho_port != NULL) {
+        /* Tacho input (EXTI, line mapped to the port in SYSCFG) */
+        utils_gpio_clock_enable(config->tacho_port);
+        __HAL_RCC_SYSCFG_CLK_ENABLE();
+        gpio_init_struct.Pin  = config->tacho_pin;
+        gpio_init_struct.Mode = GPIO_MODE_IT_RISING;
+        gpio_init_struct.Pull = GPIO_PULLUP;
+        HAL_GPIO_Init(config->tacho_port, &gpio_init_struct);
+
+        exti_enable_irq(exti_pin_to_line(config->tacho_pin), FAN_TACHO_IRQ_PRIORITY, 0u);
+    }
+
+    g_p_fans[g_u8_fan_count] = fan;
+    __DMB();
+    g_u8_fan_count++;
+
+    return HAL_OK;
+}
+
+void fan_set_target_rpm(fan_t *fan, uint32_t target_rpm)
+{
+    fan->u32_target_rpm = target_rpm;
+}
+
+uint32_t fan_get_rpm(fan_t *fan)
+{
+    uint32_t u32_time_diff;
+
+    if (fan_get_sample_age_ms(fan) > 1000u) {
+        fan->u32_rpm = 0u;
         return 0u;
     }
 
+    /* No new edge: nothing to filter */
+    if (!fan_new_period(fan, &u32_time_diff) || (u32_time_diff == 0u)) {
+        return fan->u32_rpm;
+    }
+
     uint32_t u32_rpm =
-        (60u * 1000000ul) / (2u * g_u32_time_diff);
+        (60u * 1000000ul) / (2u * u32_time_diff);
+
+    /* The observer takes the unfiltered period */
+    fan->observer.i32_measured = (int32_t)u32_rpm;
+    fan->observer.u8_fresh     = 1u;
+
+    /* Median, then a light 4:1 smoothing or the IIR cascade */
+    u32_rpm = median_filter_update(&fan->median, u32_rpm);
+    {
+        biquad_f32_t *filter = fan->p_rpm_biquad;
+
+        if (filter != NULL) {
+            float f_rpm = (float)u32_rpm;
 
-    return median_get_median(u32_rpm);
+            biquad_f32_process(filter, &f_rpm, &f_rpm, 1u);
+            fan->u32_smoothed = (f_rpm > 0.0f) ? (uint32_t)(f_rpm + 0.5f) : 0u;
+        } else {
+            fan->u32_smoothed = (4u * fan->u32_smoothed + u32_rpm) / 5u;
+        }
+    }
+    fan->u32_rpm = fan->u32_smoothed;
+
+    return fan->u32_rpm;
 }
 
-void fan_change_target_rpm(uint32_t target_rpm)
+uint32_t fan_get_cached_rpm(const fan_t *fan)
 {
-    g_u32_target_rpm = target_rpm;
+    return fan->u32_rpm;
 }
 
-uint32_t fan_get_target_rpm(void)
+void fan_set_rpm_biquad(fan_t *fan, biquad_f32_t *filter)
 {
-    return g_u32_target_rpm;
+    /* fan_get_rpm() runs in the control step: detach, preset, attach */
+    fan->p_rpm_biquad = NULL;
+    __DMB();
+    if (filter != NULL) {
+        biquad_f32_settle(filter, (float)fan->u32_smoothed);
+        __DMB();
+        fan->p_rpm_biquad = filter;
+    }
 }
 
-void fan_update_pi_controller(void)
+HAL_StatusTypeDef fan_pwm_configure(fan_t *fan, uint32_t carrier_hz)
 {
-    static float f_esum = 0.0f;
+    TIM_HandleTypeDef *handle = fan->p_pwm_handle;
+    uint32_t u32_prescaler;
+    uint32_t u32_period;
+    float f_scale;
+
+    if (pwm_timebase(handle->Instance, carrier_hz, FAN_PWM_MIN_STEPS, &u32_prescaler, &u32_period) != HAL_OK) {
+        return HAL_ERROR;
+    }
 
-    float f_error  =
-        (float)g_u32_target_rpm - (float)fan_get_filtered_rpm();
+    f_scale = (float)(u32_period + 1u) / (float)(handle->Init.Period + 1u);
 
-    float f_output =
-        g_f_kp * f_error + g_f_ki * f_esum;
+    /* The control step must not write compares of the old range meanwhile */
+    HAL_NVIC_DisableIRQ(TIM6_DAC_IRQn);
 
-    if (f_output > 100.0f) {
-        f_output = 100.0f;
-    } else if (f_output < 0.0f) {
-        f_output = 0.0f;
-    } else {
-        f_esum += f_error * g_f_ta;
+    __HAL_TIM_SET_PRESCALER(handle, u32_prescaler);
+    handle->Init.Prescaler = u32_prescaler;
+    __HAL_TIM_SET_AUTORELOAD(handle, u32_period);
+
+    for (uint8_t i = 0u; i < g_u8_fan_count; i++) {
+        fan_t *other = g_p_fans[i];
+
+        if (other->p_pwm_handle != handle) {
+            continue;
+        }
+
+        fan_write_compare(other, (uint32_t)((float)FAN_GET_COMPARE(other) * f_scale), 0u);
+        other->pi_q16_state.i32_integral_q16 =
+            (int32_t)((float)other->pi_q16_state.i32_integral_q16 * f_scale);
+        fan_update_pi_params(other);
+        fan_tacho_limits(other);
+        if (other == g_p_fan_current) {
+            __HAL_TIM_SET_COMPARE(handle, fan_current_trigger_channel(other),
+                                  (u32_period + 1u) * FAN_CURRENT_SAMPLE_PERCENT / 100u);
+        }
     }
 
-    __HAL_TIM_SET_COMPARE(&g_fan_tim9_handle_struct,
-                          TIM_CHANNEL_1,
-                          (g_fan_tim9_handle_struct.Init.Period + 1u)
-                          * f_output / 100.0f);
+    /* Load PSC, ARR and CCR from their preload registers at once */
+    handle->Instance->EGR = TIM_EGR_UG;
+
+    HAL_NVIC_EnableIRQ(TIM6_DAC_IRQn);
+
+    return HAL_OK;
 }
 
-/* Static module functions -------------------------------------------------- */
-static void fan_gpio_init(void)
+HAL_StatusTypeDef fan_pwm_stagger(void)
 {
-    __HAL_RCC_GPIOE_CLK_ENABLE();
+    pwm_timer_t *ap_timers[FAN_MAX_PWM_TIMERS];
 
-    GPIO_InitTypeDef gpio_init_struct;
+    for (uint8_t i = 0u; i < g_u8_fan_pwm_count; i++) {
+        ap_timers[i] = &g_fan_pwm[i];
+    }
 
-    /* PWM output (TIM9 AF) */
-    gpio_init_struct.Pin       = FAN_PWM_INPUT;
-    gpio_init_struct.Mode      = GPIO_MODE_AF_OD;
-    gpio_init_struct.Pull      = GPIO_NOPULL;
-    gpio_init_struct.Speed     = GPIO_SPEED_FREQ_MEDIUM;
-    gpio_init_struct.Alternate = GPIO_AF3_TIM9;
-    HAL_GPIO_Init(GPIOE, &gpio_init_struct);
+    return pwm_stagger(ap_timers, g_u8_fan_pwm_count);
+}
+
+HAL_StatusTypeDef fan_pwm_batch_enable(uint8_t enable)
+{
+    HAL_StatusTypeDef status = HAL_OK;
+
+    for (uint8_t i = 0u; i < g_u8_fan_pwm_count; i++) {
+        TIM_TypeDef *instance = g_fan_pwm_handle_struct[i].Instance;
+
+        if (!enable) {
+            pwm_burst_disable(&g_fan_pwm[i]);
+        } else if (((instance == TIM1) || (instance == TIM8)) && (pwm_burst_enable(&g_fan_pwm[i]) != HAL_OK)) {
+            status = HAL_BUSY;
+        }
+    }
+
+    return status;
+}
 
-    /* Tacho input (EXTI) */
-    gpio_init_struct.Pin  = FAN_TACHO_OUTPUT;
-    gpio_init_struct.Mode = GPIO_MODE_IT_RISING;
-    gpio_init_struct.Pull = GPIO_PULLUP;
-    HAL_GPIO_Init(GPIOE, &gpio_init_struct);
+uint32_t fan_pwm_get_resolution(const fan_t *fan)
+{
+    return fan->p_pwm_handle->Init.Period + 1u;
 }
 
-static void fan_timer_init(void)
+uint32_t fan_get_sample_age_ms(fan_t *fan)
 {
-    __HAL_RCC_TIM9_CLK_ENABLE();
+#if FAN_TACHO_CAPTURE
+    if (fan->config.tacho_port == NULL) {
+        uint32_t u32_last = freqmeter_get_stamp(&g_fan_freqmeter, freqmeter_get_count(&g_fan_freqmeter) - 1u);
 
-    TIM_OC_InitTypeDef tim_oc_handle_struct;
+        return (timebase_now32() - u32_last) / 1000u;
+    }
+#endif
 
-    g_fan_tim9_handle_struct.Instance               = TIM9;
-    g_fan_tim9_handle_struct.Init.Prescaler         =
-        (SystemCoreClock / 10000000u) - 1u;
-    g_fan_tim9_handle_struct.Init.Period            = 400u - 1u;
-    g_fan_tim9_handle_struct.Init.CounterMode       =
-        TIM_COUNTERMODE_UP;
-    g_fan_tim9_handle_struct.Init.ClockDivision     =
-        TIM_CLOCKDIVISION_DIV1;
-    g_fan_tim9_handle_struct.Init.RepetitionCounter = 0u;
+    fan_tacho_sample_t sample;
 
-    tim_oc_handle_struct.OCMode     = TIM_OCMODE_PWM1;
-    tim_oc_handle_struct.Pulse      = (400u / 100u) * 50u;
-    tim_oc_handle_struct.OCPolarity = TIM_OCPOLARITY_HIGH;
-    tim_oc_handle_struct.OCFastMode = TIM_OCFAST_DISABLE;
+    /* Edges faster than the read: the sample is fresh */
+    if (sync_snapshot_read(&fan->tacho, &sample) != HAL_OK) {
+        return 0u;
+    }
 
-    HAL_TIM_Base_Init(&g_fan_tim9_handle_struct);
-    HAL_TIM_OC_ConfigChannel(&g_fan_tim9_handle_struct,
-                             &tim_oc_handle_struct,
-                             TIM_CHANNEL_1);
-    HAL_TIM_OC_Start(&g_fan_tim9_handle_struct,
-                     TIM_CHANNEL_1);
+    return HAL_GetTick() - sample.u32_tick_ms;
 }
 
-static void fan_tacho_timer_init(void)
+uint32_t fan_read_edges(fan_t *fan, uint32_t *pu32_cursor, uint32_t *pu32_ts, uint32_t u32_max)
 {
-    __HAL_RCC_TIM2_CLK_ENABLE();
+    uint32_t u32_count;
+
+#if FAN_TACHO_CAPTURE
+    if (fan->config.tacho_port == NULL) {
+        uint32_t u32_next = freqmeter_get_count(&g_fan_freqmeter);
 
-    g_fan_tim2_handle_struct.Instance           = TIM2;
-    g_fan_tim2_handle_struct.Init.Prescaler     =
-        (SystemCoreClock / 1000000u) - 1u;
-    g_fan_tim2_handle_struct.Init.Period        = 0xFFFFFFFF;
-    g_fan_tim2_handle_struct.Init.CounterMode   =
-        TIM_COUNTERMODE_UP;
-    g_fan_tim2_handle_struct.Init.ClockDivision =
-        TIM_CLOCKDIVISION_DIV1;
+        /* Lapped: skip to the oldest kept edge, the DMA may overwrite
+           the slot after it while copying */
+        if ((u32_next - *pu32_cursor) > (FAN_TACHO_RING_LENGTH - 1u)) {
+            *pu32_cursor = u32_next - (FAN_TACHO_RING_LENGTH - 1u);
+        }
+        u32_count = u32_next - *pu32_cursor;
+        if (u32_count > u32_max) {
+            u32_count = u32_max;
+        }
+        for (uint32_t i = 0u; i < u32_count; i++) {
+            pu32_ts[i] = freqmeter_get_stamp(&g_fan_freqmeter, *pu32_cursor + i);
+        }
+        *pu32_cursor += u32_count;
 
-    HAL_TIM_Base_Init(&g_fan_tim2_handle_struct);
-    HAL_TIM_Base_Start(&g_fan_tim2_handle_struct);
+        return u32_count;
+    }
+#endif
+
+    u32_count = 0u;
+    while ((u32_count < u32_max) && sync_queue_pop(&fan->edge_queue, &pu32_ts[u32_count])) {
+        u32_count++;
+    }
+    *pu32_cursor += u32_count;
+
+    return u32_count;
 }
 
-static void fan_init_interrupt(void)
+uint32_t fan_get_rejected_edges(const fan_t *fan)
 {
-    HAL_NVIC_SetPriority(EXTI9_5_IRQn, 0u, 0u);
-    HAL_NVIC_EnableIRQ(EXTI9_5_IRQn);
+    return fan->u32_edges_rejected;
 }
 
-/* Interrupt / callback section -------------------------------------------- */
-void HAL_GPIO_EXTI_Callback(uint16_t gpio_pin)
+uint32_t fan_get_dropped_edges(const fan_t *fan)
+{
+    return sync_queue_get_dropped(&fan->edge_queue);
+}
+
+void fan_update(fan_t *fan)
+{
+    /* Kick-start burst or lock-out own the output */
+    if (fan_health_step(fan)) {
+        return;
+    }
+
+    if (fan->autotune.state == FAN_AUTOTUNE_RUNNING) {
+        fan_autotune_step(fan);
+        return;
+    }
+
+    if (fan->ff.u8_sweeping) {
+        fan_ff_sweep_step(fan);
+        return;
+    }
+
+    uint32_t u32_rpm = fan_get_rpm(fan);
+    uint32_t u32_estimate = fan_observer_step(fan);
+
+    if (fan->observer.u8_enabled) {
+        u32_rpm = u32_estimate;
+    }
+
+    uint32_t u32_ff_rpm;
+    uint32_t u32_setpoint = fan_traj_setpoint(fan, &u32_ff_rpm);
+
+    TRACE_U32(TRACE_CH_FAN_RPM, (u32_setpoint << 16) | (u32_rpm & 0xFFFFu));
+    BKPTRACE_EVENT(BKPTRACE_EV_FAN_STEP, (u32_setpoint << 16) | (u32_rpm & 0xFFFFu));
+    DATALOG_LOG(DATALOG_CH_FAN_RPM, u32_rpm);
+    DATALOG_LOG(DATALOG_CH_FAN_ERROR, (int32_t)u32_setpoint - (int32_t)u32_rpm);
+
+    /* Scheduled gains only change with the target */
+    if (fan->schedule.u8_enabled && (fan->schedule.u32_target != fan->u32_target_rpm)) {
+        fan_gain_apply(fan);
+    }
+
+    /* Slew from the duty actually applied (kick-start, autotune and sweep write it too) */
+#if FAN_PI_FIXED_POINT
+    fan->pi_q16_state.i32_output = (int32_t)FAN_GET_COMPARE(fan);
+
+    int32_t i32_output = fan_pi_step_q16(&fan->pi_q16_state, &fan->pi_q16,
+                                         (int32_t)u32_setpoint, (int32_t)u32_rpm,
+                                         fan_ff_counts(fan, u32_ff_rpm));
+
+    fan_write_compare(fan, (uint32_t)i32_output,
+                      (uint32_t)fan->pi_q16_state.i32_fraction_q16 >> (16u - FAN_DITHER_FRACTION_BITS));
+#else
+    float f_full = (float)(fan->p_pwm_handle->Init.Period + 1u);
+
+    fan->pi_state.f_output = (float)FAN_GET_COMPARE(fan) * 100.0f / f_full;
+
+    float f_output = fan_pi_step_float(&fan->pi_state, &fan->pi,
+                                       (float)u32_setpoint, (float)u32_rpm,
+                                       (float)fan_ff_counts(fan, u32_ff_rpm) * 100.0f / f_full);
+
+    fan_set_output(fan, f_output);
+#endif
+
+    TRACE_U16(TRACE_CH_FAN_OUTPUT, fan_get_compare(fan));
+    DATALOG_LOG(DATALOG_CH_FAN_OUTPUT, fan_get_compare(fan));
+
+    if (fan->record.u32_count < fan->record.u32_length) {
+        fan->record.pu16_buffer[fan->record.u32_count] = (uint16_t)((u32_rpm > 0xFFFFu) ? 0xFFFFu : u32_rpm);
+        fan->record.u32_count++;
+    }
+}
+
+void fan_set_gains(fan_t *fan, float kp, float ki)
+{
+    fan->f_kp = kp;
+    fan->f_ki = ki;
+    fan_update_pi_params(fan);
+}
+
+void fan_get_gains(const fan_t *fan, float *kp, float *ki)
+{
+    *kp = fan->f_kp;
+    *ki = fan->f_ki;
+}
+
+void fan_set_derivative_gain(fan_t *fan, float kd)
+{
+    fan->f_kd = kd;
+    fan_update_pi_params(fan);
+}
+
+float fan_get_derivative_gain(const fan_t *fan)
+{
+    return fan->f_kd;
+}
+
+void fan_set_slew_rate(fan_t *fan, float percent_per_s)
+{
+    fan->f_slew = (percent_per_s > 0.0f) ? percent_per_s : 0.0f;
+    fan_update_pi_params(fan);
+}
+
+HAL_StatusTypeDef fan_autotune_start(fan_t *fan, uint32_t setpoint_rpm,
+                                     float bias_percent, float relay_percent)
+{
+    fan_autotune_t *tune = &fan->autotune;
+
+    if ((relay_percent <= 0.0f) ||
+        (bias_percent - relay_percent < 0.0f) ||
+        (bias_percent + relay_percent > 100.0f)) {
+        return HAL_ERROR;
+    }
+
+    tune->state = FAN_AUTOTUNE_IDLE;
+    tune->u32_setpoint    = setpoint_rpm;
+    tune->f_bias          = bias_percent;
+    tune->f_amplitude     = relay_percent;
+    tune->u8_high         = 1u;
+    tune->u8_cycles       = 0u;
+    tune->u32_steps       = 0u;
+    tune->u32_cycle_start = 0u;
+    tune->u32_rpm_max     = 0u;
+    tune->u32_rpm_min     = UINT32_MAX;
+    tune->u32_period_sum  = 0u;
+    tune->u32_swing_sum   = 0u;
+    __DMB();
+    tune->state = FAN_AUTOTUNE_RUNNING;
+
+    return HAL_OK;
+}
+
+fan_autotune_state_t fan_autotune_get_state(const fan_t *fan)
+{
+    return fan->autotune.state;
+}
+
+void fan_ff_start_sweep(fan_t *fan)
+{
+    fan->ff.u8_point  = 0u;
+    fan->ff.u32_steps = 0u;
+    fan->ff.table.u8_valid = 0u;
+    __DMB();
+    fan->ff.u8_sweeping = 1u;
+}
+
+uint8_t fan_ff_is_sweeping(const fan_t *fan)
+{
+    return fan->ff.u8_sweeping;
+}
+
+void fan_ff_enable(fan_t *fan, uint8_t enable)
+{
+    fan->ff.u8_enabled = enable ? 1u : 0u;
+}
+
+HAL_StatusTypeDef fan_gain_schedule_set(fan_t *fan, uint8_t u8_point, float kp, float ki)
+{
+    uint8_t u8_enabled = fan->schedule.u8_enabled;
+
+    if (u8_point >= FAN_GAIN_POINTS) {
+        return HAL_ERROR;
+    }
+
+    /* The control step keeps the old gains while the bands are rebuilt */
+    fan->schedule.u8_enabled = 0u;
+    __DMB();
+    fan->schedule.f_kp[u8_point] = kp;
+    fan->schedule.f_ki[u8_point] = ki;
+    fan_update_pi_params(fan);
+    __DMB();
+    fan->schedule.u8_enabled = u8_enabled;
+
+    return HAL_OK;
+}
+
+void fan_gain_schedule_enable(fan_t *fan, uint8_t enable)
+{
+    fan->schedule.u8_enabled = 0u;
+    __DMB();
+    /* Disabled: back to the single gains; enabled: bands apply at the next step */
+    fan_update_pi_params(fan);
+    __DMB();
+    fan->schedule.u8_enabled = enable ? 1u : 0u;
+}
+
+fan_dither_mode_t fan_dither_enable(fan_t *fan, uint8_t enable)
+{
+    TIM_TypeDef *tim = fan->p_pwm_handle->Instance;
+    dma_alloc_request_t request;
+    uint32_t u32_compare = FAN_GET_COMPARE(fan);
+
+    fan_dither_stop(fan);
+    fan->dither.u32_error = 0u;
+    if (!enable) {
+        return FAN_DITHER_OFF;
+    }
+
+    /* TIM9 has no DMA request; a busy stream (dot fade, esd) falls back too */
+    if ((tim == TIM1) || (tim == TIM8)) {
+        request = (tim == TIM1) ? DMA_ALLOC_REQ_TIM1_UP : DMA_ALLOC_REQ_TIM8_UP;
+
+        if (dma_alloc_claim(&fan->dither.dma, request, DMA_ALLOC_LATENCY_BULK,
+                            HEALTH_ISR_COUNT) == HAL_OK) {
+            fan->dither.dma.Init.Direction           = DMA_MEMORY_TO_PERIPH;
+            fan->dither.dma.Init.PeriphInc           = DMA_PINC_DISABLE;
+            fan->dither.dma.Init.MemInc              = DMA_MINC_ENABLE;
+            fan->dither.dma.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+            fan->dither.dma.Init.MemDataAlignment    = DMA_MDATAALIGN_HALFWORD;
+            fan->dither.dma.Init.Mode                = DMA_CIRCULAR;
+            fan->dither.dma.Init.FIFOMode            = DMA_FIFOMODE_DISABLE;
+
+            for (uint32_t i = 0u; i < FAN_DITHER_LENGTH; i++) {
+                fan->dither.u16_pattern[i] = (uint16_t)u32_compare;
+            }
+
+            /* No interrupt, the pattern repeats and is refilled per control step */
+            if ((HAL_DMA_Init(&fan->dither.dma) == HAL_OK) &&
+                (HAL_DMA_Start(&fan->dither.dma, (uint32_t)(uintptr_t)fan->dither.u16_pattern,
+                               (uint32_t)(uintptr_t)&LL_TIM_CCR(tim, fan->config.pwm_channel),
+                               FAN_DITHER_LENGTH) == HAL_OK)) {
+                fan->dither.mode = FAN_DITHER_DMA;
+                __HAL_TIM_ENABLE_DMA(fan->p_pwm_handle, TIM_DMA_UPDATE);
+                return FAN_DITHER_DMA;
+            }
+            dma_alloc_release(&fan->dither.dma);
+        }
+    }
+
+    fan->dither.mode = FAN_DITHER_STEP;
+
+    return FAN_DITHER_STEP;
+}
+
+void fan_observer_enable(fan_t *fan, uint8_t enable)
+{
+    fan->observer.u8_enabled = enable ? 1u : 0u;
+}
+
+uint32_t fan_get_estimated_rpm(const fan_t *fan)
+{
+    return (uint32_t)(fan->observer.state.i32_rpm_q8 >> 8);
+}
+
+HAL_StatusTypeDef fan_set_trajectory(fan_t *fan, float f_rate_rpm_s, float f_accel_rpm_s2, float f_jerk_rpm_s3)
+{
+    if ((f_rate_rpm_s < 0.0f) || (f_accel_rpm_s2 < 0.0f) || (f_jerk_rpm_s3 < 0.0f)) {
+        return HAL_ERROR;
+    }
+
+    /* The control step must not see half of the new limits */
+    fan->traj.u8_enabled     = 0u;
+    __DMB();
+    fan->traj.params.f_rate  = f_rate_rpm_s;
+    fan->traj.params.f_accel = f_accel_rpm_s2;
+    fan->traj.params.f_jerk  = f_jerk_rpm_s3;
+    fan_traj_reset(&fan->traj.state, (float)fan->traj.u32_setpoint);
+    __DMB();
+    fan->traj.u8_enabled     = ((f_accel_rpm_s2 > 0.0f) && (f_jerk_rpm_s3 > 0.0f)) ? 1u : 0u;
+
+    return HAL_OK;
+}
+
+uint32_t fan_get_setpoint_rpm(const fan_t *fan)
+{
+    return fan->traj.u32_setpoint;
+}
+
+uint16_t fan_get_duty_permille(const fan_t *fan)
+{
+    uint32_t u32_full = fan->p_pwm_handle->Init.Period + 1u;
+    uint32_t u32_compare = fan_get_compare(fan);
+
+    if (u32_compare >= u32_full) {
+        return 1000u;
+    }
+
+    return (uint16_t)((u32_compare * 1000u + u32_full / 2u) / u32_full);
+}
+
+HAL_StatusTypeDef fan_record_start(fan_t *fan, uint16_t *pu16_buffer, uint32_t u32_length)
+{
+    if ((pu16_buffer == NULL) || (u32_length == 0u)) {
+        return HAL_ERROR;
+    }
+
+    /* The control step sees either no recording or the new one */
+    fan->record.u32_length  = 0u;
+    __DMB();
+    fan->record.pu16_buffer = pu16_buffer;
+    fan->record.u32_count   = 0u;
+    __DMB();
+    fan->record.u32_length  = u32_length;
+
+    return HAL_OK;
+}
+
+uint32_t fan_record_get_count(const fan_t *fan)
+{
+    return fan->record.u32_count;
+}
+
+void fan_set_adc_ops(const fan_adc_ops_t *ops)
+{
+    g_p_fan_adc_ops = ops;
+}
+
+HAL_StatusTypeDef fan_current_enable(fan_t *fan, uint32_t u32_limit_mv)
+{
+    TIM_HandleTypeDef *handle = fan->p_pwm_handle;
+    uint32_t u32_channel = fan_current_trigger_channel(fan);
+    uint32_t u32_trigger = ADC_INJECTED_SOFTWARE_START;
+    GPIO_InitTypeDef gpio_init_struct;
+    TIM_OC_InitTypeDef tim_oc_init_struct;
+
+    if (((g_p_fan_current != NULL) && (g_p_fan_current != fan)) || (g_p_fan_adc_ops == NULL)) {
+        return HAL_ERROR;
+    }
+
+    /* The trigger channel must be a spare channel of the PWM timer */
+    for (uint8_t i = 0u; i < g_u8_fan_count; i++) {
+        if ((g_p_fans[i]->p_pwm_handle == handle) && (g_p_fans[i]->config.pwm_channel == u32_channel)) {
+            return HAL_ERROR;
+        }
+    }
+
+    if (handle->Instance == TIM1) {
+        u32_trigger = ADC_EXTERNALTRIGINJECCONV_T1_CC4;
+    } else if (handle->Instance == TIM8) {
+        u32_trigger = ADC_EXTERNALTRIGINJECCONV_T8_CC4;
+    } else if (tim_alloc_set_handler(handle->Instance, fan_current_compare, fan,
+                                     IRQ_CLASS_CAPTURE) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    __HAL_RCC_GPIOC_CLK_ENABLE();
+    gpio_init_struct.Pin   = FAN_CURRENT_PIN;
+    gpio_init_struct.Mode  = GPIO_MODE_ANALOG;
+    gpio_init_struct.Pull  = GPIO_NOPULL;
+    gpio_init_struct.Speed = GPIO_SPEED_FREQ_LOW;
+    HAL_GPIO_Init(FAN_CURRENT_PORT, &gpio_init_struct);
+
+    if (g_p_fan_adc_ops->injected_start(FAN_CURRENT_CHANNEL, u32_trigger) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    tim_oc_init_struct.OCMode       = TIM_OCMODE_PWM1;
+    tim_oc_init_struct.Pulse        = (handle->Init.Period + 1u) * FAN_CURRENT_SAMPLE_PERCENT / 100u;
+    tim_oc_init_struct.OCPolarity   = TIM_OCPOLARITY_HIGH;
+    tim_oc_init_struct.OCFastMode   = TIM_OCFAST_DISABLE;
+    tim_oc_init_struct.OCNPolarity  = TIM_OCNPOLARITY_HIGH;
+    tim_oc_init_struct.OCIdleState  = TIM_OCIDLESTATE_RESET;
+    tim_oc_init_struct.OCNIdleState = TIM_OCNIDLESTATE_RESET;
+    HAL_TIM_OC_ConfigChannel(handle, &tim_oc_init_struct, u32_channel);
+
+    /* TIM1 / TIM8: the CC4 event triggers the ADC (pin not in AF mode) */
+    if (u32_trigger != ADC_INJECTED_SOFTWARE_START) {
+        HAL_TIM_OC_Start(handle, u32_channel);
+    }
+
+    fan->current.u32_limit_mv = u32_limit_mv;
+    fan->current.u32_peak_mv  = 0u;
+    fan->current.u32_mv       = 0u;
+    fan->current.u8_enabled   = 1u;
+    g_p_fan_current = fan;
+
+    return HAL_OK;
+}
+
+void fan_current_disable(fan_t *fan)
 {
-    if (gpio_pin == FAN_TACHO_OUTPUT) {
-        uint32_t u32_ticks_now =
-            __HAL_TIM_GET_COUNTER(&g_fan_tim2_handle_struct);
+    if (g_p_fan_current != fan) {
+        return;
+    }
 
-        g_u32_time_diff  = u32_ticks_now - g_u32_ticks_last;
-        g_u32_ticks_last = u32_ticks_now;
-        g_u32_cpu_ticks_now = HAL_GetTick();
+    fan->current.u8_enabled = 0u;
+    __HAL_TIM_DISABLE_IT(fan->p_pwm_handle, TIM_IT_CC2);
+    g_p_fan_adc_ops->injected_stop();
+    g_p_fan_current = NULL;
+}
+
+uint32_t fan_get_current_mv(const fan_t *fan, uint32_t *pu32_peak)
+{
+    if (pu32_peak != NULL) {
+        *pu32_peak = fan->current.u32_peak_mv;
     }
+
+    return fan->current.u8_enabled ? fan->current.u32_mv : 0u;
 }
 
-void EXTI9_5_IRQHandler(void)
+void fan_ff_get_table(const fan_t *fan, fan_ff_table_t *table)
 {
-    HAL_GPIO_EXTI_IRQHandler(FAN_TACHO_OUTPUT);
+    *table = fan->ff.table;
+}
+
+HAL_StatusTypeDef fan_ff_set_table(fan_t *fan, const fan_ff_table_t *table)
+{
+    for (uint8_t i = 1u; i < FAN_FF_POINTS; i++) {
+        if (table->u16_rpm[i] < table->u16_rpm[i - 1u]) {
+            return HAL_ERROR;
+        }
+    }
+
+    fan->ff.table.u8_valid = 0u;
+    __DMB();
+    for (uint8_t i = 0u; i < FAN_FF_POINTS; i++) {
+        fan->ff.table.u16_rpm[i] = table->u16_rpm[i];
+    }
+    __DMB();
+    fan->ff.table.u8_valid = 1u;
+
+    return HAL_OK;
+}
+
+void fan_set_health_callback(fan_t *fan, fan_health_callback_t callback)
+{
+    fan->health.callback = callback;
+}
+
+fan_health_state_t fan_get_health(const fan_t *fan)
+{
+    return fan->health.state;
+}
+
+void fan_health_reset(fan_t *fan)
+{
+    fan->health.u8_failures = 0u;
+    fan->health.u8_armed    = 0u;
+    fan_health_set_state(fan, FAN_HEALTH_OK);
+}
+
+HAL_StatusTypeDef fan_guard_adc(fan_t *fan, uint32_t u32_channel, uint16_t u16_low, uint16_t u16_high)
+{
+    if ((g_p_fan_guard_adc != NULL) && (g_p_fan_guard_adc != fan)) {
+        return HAL_ERROR;
+    }
+
+    if ((g_p_fan_adc_ops == NULL) || (g_p_fan_adc_ops->watchdog_start == NULL) ||
+        (g_p_fan_adc_ops->watchdog_start(u32_channel, u16_low, u16_high, fan_guard_excursion, fan) != HAL_OK)) {
+        return HAL_ERROR;
+    }
+    fan->guard.u8_adc = 1u;
+    g_p_fan_guard_adc = fan;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef fan_guard_overspeed(fan_t *fan, uint32_t u32_rpm)
+{
+    uint32_t u32_period_us;
+
+    if (u32_rpm == 0u) {
+        fan->guard.u32_min_span_us = 0u;
+        return HAL_OK;
+    }
+
+    /* Two tacho edges per revolution; faster edges never get accepted */
+    u32_period_us = (60u * 1000000ul) / (2u * u32_rpm);
+    if (u32_period_us <= fan->u32_min_interval_us) {
+        return HAL_ERROR;
+    }
+    fan->guard.u32_min_span_us = u32_period_us * FAN_RPM_EDGES;
+
+    return HAL_OK;
+}
+
+void fan_guard_trip(fan_t *fan, uint8_t u8_cause)
+{
+    /* Output first, book-keeping after */
+    fan_guard_apply(fan);
+
+    if (fan->guard.u8_fault == 0u) {
+        fan->guard.u32_stamp = timebase_now32();
+        fan->guard.u32_trips++;
+        BKPTRACE_EVENT(BKPTRACE_EV_FAN_GUARD, (fan->u32_rpm << 8) | u8_cause);
+    }
+    fan->guard.u8_fault |= u8_cause;
+
+    if (fan->guard.callback != NULL) {
+        fan->guard.callback(fan, u8_cause);
+    }
+}
+
+void fan_guard_set_callback(fan_t *fan, fan_guard_callback_t callback)
+{
+    fan->guard.callback = callback;
+}
+
+uint8_t fan_guard_get_fault(const fan_t *fan, uint32_t *pu32_stamp)
+{
+    if (pu32_stamp != NULL) {
+        *pu32_stamp = fan->guard.u32_stamp;
+    }
+
+    return fan->guard.u8_fault;
+}
+
+void fan_guard_clear(fan_t *fan)
+{
+    fan->guard.u8_fault = 0u;
+    if (fan->guard.u8_adc && (g_p_fan_adc_ops->watchdog_rearm != NULL)) {
+        g_p_fan_adc_ops->watchdog_rearm();
+    }
+}
+
+fan_t *fan_get_default(void)
+{
+    return &g_fan_default;
+}
+
+void fan_control_step_all(void)
+{
+    uint8_t u8_count = g_u8_fan_count;
+    uint8_t u8_batching = 0u;
+
+    /* Fans that are not updated in this step keep their compare */
+    for (uint8_t i = 0u; i < g_u8_fan_pwm_count; i++) {
+        if (g_fan_pwm[i].u8_burst) {
+            for (uint32_t u32_ch = 0u; u32_ch < PWM_MAX_CHANNELS; u32_ch++) {
+                g_u32_fan_batch[i][u32_ch] = (&g_fan_pwm_handle_struct[i].Instance->CCR1)[u32_ch];
+            }
+            u8_batching |= (uint8_t)(1u << i);
+        }
+    }
+    g_u8_fan_batching = u8_batching;
+
+    for (uint8_t i = 0u; i < u8_count; i++) {
+        fan_update(g_p_fans[i]);
+    }
+
+    g_u8_fan_batching = 0u;
+
+    /* A burst still pending (step faster than the PWM period) drops this
+       step; the controllers start the next one from the applied duty */
+    for (uint8_t i = 0u; i < g_u8_fan_pwm_count; i++) {
+        if ((u8_batching & (1u << i)) != 0u) {
+            (void)pwm_write_all(&g_fan_pwm[i], g_u32_fan_batch[i]);
+        }
+    }
+
+    /* A trip during the step may have been overwritten by its output */
+    for (uint8_t i = 0u; i < u8_count; i++) {
+        if (g_p_fans[i]->guard.u8_fault != 0u) {
+            fan_guard_apply(g_p_fans[i]);
+        }
+    }
+}
+
+HAL_StatusTypeDef fan_control_start(uint32_t rate_hz)
+{
+    if ((rate_hz == 0u) || (rate_hz > 100000u)) {
+        return HAL_ERROR;
+    }
+
+    /* Cycle counter for the execution time */
+    utils_timebase_init();
+
+    if (tim_alloc_claim(TIM6, TIM_ALLOC_OWNER_FAN_CONTROL) != HAL_OK) {
+        return HAL_BUSY;
+    }
+
+    /* 1 MHz counter, update event at rate_hz */
+    g_fan_tim6_handle_struct.Instance         = TIM6;
+    g_fan_tim6_handle_struct.Init.Prescaler   =
+        (clock_get_apb1_timer_clock() / 1000000u) - 1u;
+    g_fan_tim6_handle_struct.Init.Period      = (1000000u / rate_hz) - 1u;
+    g_fan_tim6_handle_struct.Init.CounterMode = TIM_COUNTERMODE_UP;
+
+    if (HAL_TIM_Base_Init(&g_fan_tim6_handle_struct) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    g_f_ta = 1.0f / (float)rate_hz;
+    for (uint8_t i = 0u; i < g_u8_fan_count; i++) {
+        fan_update_pi_params(g_p_fans[i]);
+    }
+    fan_reset_control_stats();
+
+    HAL_NVIC_SetPriority(TIM6_DAC_IRQn, FAN_CONTROL_IRQ_PRIORITY, 0u);
+    HAL_NVIC_EnableIRQ(TIM6_DAC_IRQn);
+
+    return HAL_TIM_Base_Start_IT(&g_fan_tim6_handle_struct);
+}
+
+void fan_control_stop(void)
+{
+    HAL_TIM_Base_Stop_IT(&g_fan_tim6_handle_struct);
+    HAL_NVIC_DisableIRQ(TIM6_DAC_IRQn);
+}
+
+void fan_control_set_deadline(uint8_t u8_deadline_id)
+{
+    g_u8_fan_control_deadline = u8_deadline_id;
+}
+
+HAL_StatusTypeDef fan_get_control_stats(fan_control_stats_t *stats)
+{
+    return sync_snapshot_read(&g_fan_control_snapshot, stats);
+}
+
+HAL_StatusTypeDef fan_control_wait(uint32_t u32_timeout_ms)
+{
+    /* Only steps after the call count */
+    osal_event_clear(&g_fan_control_event);
+
+    return osal_event_wait(&g_fan_control_event, u32_timeout_ms);
+}
+
+void fan_reset_control_stats(void)
+{
+    /* Control task stopped: nobody else writes */
+    if (!NVIC_GetEnableIRQ(TIM6_DAC_IRQn)) {
+        g_fan_control_stats.u32_runs        = 0u;
+        g_fan_control_stats.u32_overruns    = 0u;
+        g_fan_control_stats.u32_last_cycles = 0u;
+        g_fan_control_stats.u32_max_cycles  = 0u;
+        g_u8_fan_control_reset = 0u;
+        sync_snapshot_publish(&g_fan_control_snapshot, &g_fan_control_stats);
+        return;
+    }
+
+    g_u8_fan_control_reset = 1u;
+}
+
+HAL_StatusTypeDef fan_get_signal_stats(fan_signal_stats_t *stats)
+{
+    for (uint8_t i = 0u; i < SYNC_READ_ATTEMPTS; i++) {
+        uint32_t u32_sequence = sync_seqlock_read_begin(&g_fan_signal_lock);
+
+        *stats = g_fan_signal_stats;
+        if (sync_seqlock_read_valid(&g_fan_signal_lock, u32_sequence)) {
+            return HAL_OK;
+        }
+    }
+
+    return HAL_BUSY;
+}
+
+void fan_reset_signal_stats(void)
+{
+    g_u8_fan_signal_reset = 1u;
+}
+
+uint32_t fan_get_last_rpm(void)
+{
+    return g_fan_default.u32_rpm;
+}
+
+/* Static module functions -------------------------------------------------- */
+/**
+ * @brief Returns the handle of a PWM timer, configuring the time base
+ *        (25 kHz) on first use.
+ *
+ * @param instance TIM1, TIM8 or TIM9
+ * @return Handle, NULL for an unsupported timer or too many timers
+ */
+static TIM_HandleTypeDef *fan_pwm_timer_init(TIM_TypeDef *instance)
+{
+    uint32_t u32_prescaler;
+    uint32_t u32_period;
+
+    for (uint8_t i = 0u; i < g_u8_fan_pwm_count; i++) {
+        if (g_fan_pwm_handle_struct[i].Instance == instance) {
+            return &g_fan_pwm_handle_struct[i];
+        }
+    }
+
+    if ((g_u8_fan_pwm_count >= FAN_MAX_PWM_TIMERS) ||
+        ((instance != TIM1) && (instance != TIM8) && (instance != TIM9)) ||
+        (pwm_timebase(instance, FAN_PWM_DEFAULT_CARRIER_HZ, FAN_PWM_MIN_STEPS,
+                      &u32_prescaler, &u32_period) != HAL_OK)) {
+        return NULL;
+    }
+
+    /* TIM1 / TIM8 may already drive the dot, the ESD or the ADC trigger */
+    if (pwm_timer_init(&g_fan_pwm[g_u8_fan_pwm_count], &g_fan_pwm_handle_struct[g_u8_fan_pwm_count],
+                       instance, TIM_ALLOC_OWNER_FAN_PWM, u32_prescaler, u32_period) != HAL_OK) {
+        return NULL;
+    }
+
+    return &g_fan_pwm_handle_struct[g_u8_fan_pwm_count++];
+}
+
+/**
+ * @brief Returns the PWM timer of a handle of fan_pwm_timer_init().
+ *
+ * @param handle PWM timer handle
+ * @return PWM timer
+ */
+static pwm_timer_t *fan_pwm_timer(const TIM_HandleTypeDef *handle)
+{
+    return &g_fan_pwm[handle - g_fan_pwm_handle_struct];
+}
+
+/**
+ * @brief Tacho edge of one fan (EXTI handler): stores the TIM2 timestamp.
+ *
+ * @param context Instance
+ */
+static void fan_tacho_edge(void *context)
+{
+    fan_t *fan = (fan_t *)context;
+    uint32_t u32_now = timebase_now32();
+    fan_tacho_sample_t sample;
+
+    if (!fan_tacho_valid(fan, u32_now)) {
+        fan->u32_edges_rejected++;
+        return;
+    }
+
+#if DATALOG_ENABLE
+    if (fan->u32_edges != 0u) {
+        DATALOG_LOG(DATALOG_CH_TACHO_PERIOD,
+                    u32_now - fan->u32_edge_ts[(fan->u32_edges - 1u) & (FAN_EDGE_HISTORY - 1u)]);
+    }
+#endif
+    fan->u32_edge_ts[fan->u32_edges & (FAN_EDGE_HISTORY - 1u)] = u32_now;
+    fan->u32_edges++;
+    (void)sync_queue_push(&fan->edge_queue, &u32_now);
+
+    /* Period, edge count and time stamp go out together */
+    sample.u32_edges   = fan->u32_edges;
+    sample.u32_periods = (fan->u32_edges > FAN_RPM_EDGES) ? FAN_RPM_EDGES : (fan->u32_edges - 1u);
+    sample.u32_span_us = u32_now - fan->u32_edge_ts[(fan->u32_edges - 1u - sample.u32_periods) &
+                                                    (FAN_EDGE_HISTORY - 1u)];
+    sample.u32_tick_ms = HAL_GetTick();
+    sync_snapshot_publish(&fan->tacho, &sample);
+
+    if ((fan->guard.u32_min_span_us != 0u) && (sample.u32_periods == FAN_RPM_EDGES) &&
+        (sample.u32_span_us < fan->guard.u32_min_span_us)) {
+        fan_guard_trip(fan, FAN_GUARD_OVERSPEED);
+    }
+}
+
+/**
+ * @brief Derives the shortest valid tacho period and the blanking window
+ *        in PWM counts (after init and a carrier change).
+ *
+ * @param fan Instance with a valid PWM handle
+ */
+static void fan_tacho_limits(fan_t *fan)
+{
+    uint32_t u32_max_rpm = params_get_u32(PARAMS_KEY_FAN_MAX_RPM, FAN_MAX_RPM);
+    uint32_t u32_counts_per_us =
+        clock_get_apb2_timer_clock() / (fan->p_pwm_handle->Instance->PSC + 1u) / 1000000u;
+    uint32_t u32_blanking = FAN_TACHO_BLANKING_US * (u32_counts_per_us + 1u);
+
+    if (u32_max_rpm == 0u) {
+        u32_max_rpm = FAN_MAX_RPM;
+    }
+    /* Two tacho edges per revolution */
+    fan->u32_min_interval_us = (60u * 1000000ul) / (2u * u32_max_rpm * FAN_TACHO_SPEED_MARGIN);
+
+    /* Both windows together must leave a part of the period unblanked */
+    if (u32_blanking > (fan->p_pwm_handle->Init.Period + 1u) / 4u) {
+        u32_blanking = (fan->p_pwm_handle->Init.Period + 1u) / 4u;
+    }
+    fan->u32_blanking = u32_blanking;
+}
+
+/**
+ * @brief Validates a tacho edge (EXTI handler), see FAN_TACHO_SPEED_MARGIN.
+ *
+ * The blanking wait is bounded by FAN_TACHO_BLANKING_US (and a quarter
+ * of the PWM period); it only happens if the edge came with a switching
+ * edge of the own PWM output. A 0 % or 100 % duty does not switch.
+ *
+ * @param fan     Instance
+ * @param u32_now TIM2 timestamp of the edge in us
+ * @return 1 to accept the edge, 0 to reject it
+ */
+static uint8_t fan_tacho_valid(fan_t *fan, uint32_t u32_now)
+{
+    TIM_TypeDef *tim = fan->p_pwm_handle->Instance;
+    uint32_t u32_period = tim->ARR + 1u;
+    uint32_t u32_compare = FAN_GET_COMPARE(fan);
+
+    if ((fan->u32_edges != 0u) &&
+        ((u32_now - fan->u32_edge_ts[(fan->u32_edges - 1u) & (FAN_EDGE_HISTORY - 1u)]) <
+         fan->u32_min_interval_us)) {
+        return 0u;
+    }
+
+    if ((fan->u32_blanking != 0u) && (u32_compare != 0u) && (u32_compare < u32_period)) {
+        uint32_t u32_count;
+        uint32_t u32_since_compare;
+
+        do {
+            u32_count = tim->CNT;
+            u32_since_compare = (u32_count >= u32_compare) ? (u32_count - u32_compare)
+                                                           : (u32_count + u32_period - u32_compare);
+        } while ((u32_count < fan->u32_blanking) || (u32_since_compare < fan->u32_blanking));
+    }
+
+    for (uint32_t i = 0u; i < FAN_TACHO_CONFIRM_READS; i++) {
+        if (FAN_TACHO_READ(fan) == GPIO_PIN_RESET) {
+            return 0u;
+        }
+    }
+
+    return 1u;
+}
+
+/**
+ * @brief Returns the mean tacho period over up to FAN_RPM_EDGES edges if
+ *        edges arrived since the last call.
+ *
+ * @param fan      Instance
+ * @param p_period Mean period in TIM2 ticks (us), only set if new
+ * @return 1 if a new period was computed, 0 otherwise
+ */
+static uint8_t fan_new_period(fan_t *fan, uint32_t *p_period)
+{
+    fan_tacho_sample_t sample;
+
+#if FAN_TACHO_CAPTURE
+    if (fan->config.tacho_port == NULL) {
+        return fan_capture_period(fan, p_period);
+    }
+#endif
+
+    /* One publication per edge: an unchanged sequence needs no copy, a
+       busy read is taken at the next call */
+    if ((sync_snapshot_get_sequence(&fan->tacho) == fan->u32_edges_used) ||
+        (sync_snapshot_read(&fan->tacho, &sample) != HAL_OK)) {
+        return 0u;
+    }
+    fan->u32_edges_used = sample.u32_edges;
+
+    if (sample.u32_periods == 0u) {
+        return 0u;
+    }
+
+    *p_period = sample.u32_span_us / sample.u32_periods;
+
+    return 1u;
+}
+
+/**
+ * @brief Derives the step parameters of both controllers from the gains,
+ *        the slew rate and the sample time.
+ *
+ * The float controller outputs percent, so one percent corresponds to
+ * (Period + 1) / 100 compare counts.
+ *
+ * @param fan Instance with a valid PWM handle
+ */
+static void fan_update_pi_params(fan_t *fan)
+{
+    float f_full = (float)(fan->p_pwm_handle->Init.Period + 1u);
+    float f_counts_per_percent = f_full / 100.0f;
+    float f_kt_ta = (FAN_PI_TRACKING_TIME_S > 0.0f) ? (g_f_ta / FAN_PI_TRACKING_TIME_S) : 0.0f;
+    uint32_t u32_max_rpm;
+
+    /* Kt * Ta above 1 would overcorrect the integral every step */
+    if (f_kt_ta > 1.0f) {
+        f_kt_ta = 1.0f;
+    }
+
+    fan->pi.f_kp    = fan->f_kp;
+    fan->pi.f_ki_ta = fan->f_ki * g_f_ta;
+    fan->pi.f_kd_ta = fan->f_kd / g_f_ta;
+    fan->pi.f_kt_ta = f_kt_ta;
+    fan->pi.f_slew  = fan->f_slew * g_f_ta;
+
+    fan->pi_q16.i32_kp_q16    = (int32_t)(fan->f_kp * f_counts_per_percent * 65536.0f + 0.5f);
+    fan->pi_q16.i32_ki_ta_q16 = (int32_t)(fan->f_ki * g_f_ta * f_counts_per_percent * 65536.0f + 0.5f);
+    fan->pi_q16.i32_kd_ta_q16 = (int32_t)(fan->f_kd / g_f_ta * f_counts_per_percent * 65536.0f + 0.5f);
+    fan->pi_q16.i32_kt_ta_q16 = (int32_t)(f_kt_ta * 65536.0f + 0.5f);
+    fan->pi_q16.i32_slew      = (int32_t)(fan->pi.f_slew * f_counts_per_percent + 0.5f);
+    fan->pi_q16.i32_full      = (int32_t)f_full;
+
+    fan->traj.params.f_ta = g_f_ta;
+
+    fan->observer.params.i32_ta_tau_q16 = (int32_t)(g_f_ta / FAN_OBSERVER_TAU_S * 65536.0f + 0.5f);
+    fan->observer.params.i32_alpha_q16  = (int32_t)(FAN_OBSERVER_ALPHA * 65536.0f + 0.5f);
+    fan->observer.params.i32_beta_q16   = (int32_t)(FAN_OBSERVER_BETA * 65536.0f + 0.5f);
+    if (fan->observer.params.i32_ta_tau_q16 > 65536) {
+        fan->observer.params.i32_ta_tau_q16 = 65536;
+    }
+
+    /* A slew limit below one count per step would stop the output */
+    if ((fan->f_slew > 0.0f) && (fan->pi_q16.i32_slew == 0)) {
+        fan->pi_q16.i32_slew = 1;
+    }
+
+    /* Gain schedule in the same units, slopes per 1/256 band */
+    for (uint8_t i = 0u; i < FAN_GAIN_POINTS; i++) {
+        fan_gain_band_t *band = &fan->schedule.bands[i];
+        uint8_t u8_next = (i + 1u < FAN_GAIN_POINTS) ? (uint8_t)(i + 1u) : i;
+        float f_kp      = fan->schedule.f_kp[i];
+        float f_ki_ta   = fan->schedule.f_ki[i] * g_f_ta;
+
+        band->f_kp          = f_kp;
+        band->f_kp_slope    = (fan->schedule.f_kp[u8_next] - f_kp) / 256.0f;
+        band->f_ki_ta       = f_ki_ta;
+        band->f_ki_ta_slope = (fan->schedule.f_ki[u8_next] * g_f_ta - f_ki_ta) / 256.0f;
+        band->i32_kp_q16          = (int32_t)(f_kp * f_counts_per_percent * 65536.0f + 0.5f);
+        band->i32_kp_slope_q16    = (int32_t)(band->f_kp_slope * f_counts_per_percent * 65536.0f);
+        band->i32_ki_ta_q16       = (int32_t)(f_ki_ta * f_counts_per_percent * 65536.0f + 0.5f);
+        band->i32_ki_ta_slope_q16 = (int32_t)(band->f_ki_ta_slope * f_counts_per_percent * 65536.0f);
+    }
+    u32_max_rpm = params_get_u32(PARAMS_KEY_FAN_MAX_RPM, FAN_MAX_RPM);
+    fan->schedule.u32_scale  = (((FAN_GAIN_POINTS - 1u) * 256u) << 16) / ((u32_max_rpm > 0u) ? u32_max_rpm : 1u);
+    fan->schedule.u32_target = UINT32_MAX;
+}
+
+/**
+ * @brief Takes Kp and Ki for the current target from the gain schedule:
+ *        band index and fraction from one multiply, clamped at the last
+ *        point, then base + slope * fraction. No search, no branch on
+ *        the band.
+ *
+ * @param fan Instance with an enabled schedule
+ */
+static void fan_gain_apply(fan_t *fan)
+{
+    uint32_t u32_target = fan->u32_target_rpm;
+    uint32_t u32_pos    = (uint32_t)(((uint64_t)u32_target * fan->schedule.u32_scale) >> 16);
+    const fan_gain_band_t *band;
+    int32_t i32_frac;
+
+    u32_pos  = (u32_pos < (FAN_GAIN_POINTS - 1u) * 256u) ? u32_pos : (FAN_GAIN_POINTS - 1u) * 256u;
+    band     = &fan->schedule.bands[u32_pos >> 8];
+    i32_frac = (int32_t)(u32_pos & 0xFFu);
+
+    fan->pi.f_kp              = band->f_kp + band->f_kp_slope * (float)i32_frac;
+    fan->pi.f_ki_ta           = band->f_ki_ta + band->f_ki_ta_slope * (float)i32_frac;
+    fan->pi_q16.i32_kp_q16    = band->i32_kp_q16 + band->i32_kp_slope_q16 * i32_frac;
+    fan->pi_q16.i32_ki_ta_q16 = band->i32_ki_ta_q16 + band->i32_ki_ta_slope_q16 * i32_frac;
+    fan->schedule.u32_target  = u32_target;
+}
+
+/**
+ * @brief Clears the controller state, e.g. after autotune or the sweep
+ *        wrote the output directly. The D term and the setpoint
+ *        trajectory start from the current RPM, so the first step gives
+ *        no derivative kick and no setpoint jump.
+ *
+ * @param fan Instance
+ */
+static void fan_pi_reset(fan_t *fan)
+{
+    fan->pi_state.f_integral         = 0.0f;
+    fan->pi_state.f_last_rpm         = (float)fan->u32_rpm;
+    fan->pi_state.f_output           = 0.0f;
+    fan->pi_q16_state.i32_integral_q16 = 0;
+    fan->pi_q16_state.i32_last_rpm     = (int32_t)fan->u32_rpm;
+    fan->pi_q16_state.i32_output       = 0;
+    fan->pi_q16_state.i32_fraction_q16 = 0;
+    fan_observer_reset(&fan->observer.state, (int32_t)fan->u32_rpm);
+    fan_traj_reset(&fan->traj.state, (float)fan->u32_rpm);
+}
+
+/**
+ * @brief Writes an output in percent to the PWM compare register.
+ *
+ * @param fan       Instance
+ * @param f_percent Duty cycle 0..100
+ */
+static void fan_set_output(fan_t *fan, float f_percent)
+{
+    /* Compare with FAN_DITHER_FRACTION_BITS fraction bits */
+    uint32_t u32_value = (uint32_t)((float)(fan->p_pwm_handle->Init.Period + 1u) * f_percent *
+                                    ((float)(1u << FAN_DITHER_FRACTION_BITS) / 100.0f));
+
+    fan_write_compare(fan, u32_value >> FAN_DITHER_FRACTION_BITS,
+                      u32_value & ((1u << FAN_DITHER_FRACTION_BITS) - 1u));
+}
+
+/**
+ * @brief One observer step: prediction from the duty of the last step,
+ *        correction with a new tacho period. Without edges for the
+ *        stall time of fan_get_rpm() the estimate is pulled to 0.
+ *
+ * @param fan Instance, after fan_get_rpm() of this step
+ * @return Estimated RPM
+ */
+static uint32_t fan_observer_step(fan_t *fan)
+{
+    fan_observer_t *observer = &fan->observer;
+    int32_t i32_estimate;
+
+    i32_estimate = fan_observer_predict(&observer->state, &observer->params,
+                                        (int32_t)fan_expected_rpm(fan, FAN_GET_COMPARE(fan)));
+    if (observer->u8_fresh) {
+        observer->u8_fresh = 0u;
+        i32_estimate = fan_observer_correct(&observer->state, &observer->params, observer->i32_measured);
+    } else if (fan->u32_rpm == 0u) {
+        i32_estimate = fan_observer_correct(&observer->state, &observer->params, 0);
+    }
+
+    return (uint32_t)i32_estimate;
+}
+
+/**
+ * @brief Returns the timer channel that marks the current sample point.
+ *
+ * @param fan Instance
+ * @return TIM_CHANNEL_2 on TIM9 (two channels), TIM_CHANNEL_4 otherwise
+ */
+static uint32_t fan_current_trigger_channel(const fan_t *fan)
+{
+    return (fan->p_pwm_handle->Instance == TIM9) ? TIM_CHANNEL_2 : TIM_CHANNEL_4;
+}
+
+/**
+ * @brief Takes the mean of the injected ranks (control step) and arms
+ *        the software trigger of a TIM9 fan for the next compare match.
+ *
+ * @param fan Instance with the current sense
+ */
+static void fan_current_step(fan_t *fan)
+{
+    uint32_t u32_mv = adc_cal_to_mv(FAN_CURRENT_CAL_CHANNEL, g_p_fan_adc_ops->injected_get_mean());
+
+    fan->current.u32_mv = u32_mv;
+    if (u32_mv > fan->current.u32_peak_mv) {
+        fan->current.u32_peak_mv = u32_mv;
+    }
+
+    if (fan->p_pwm_handle->Instance == TIM9) {
+        __HAL_TIM_CLEAR_FLAG(fan->p_pwm_handle, TIM_FLAG_CC2);
+        __HAL_TIM_ENABLE_IT(fan->p_pwm_handle, TIM_IT_CC2);
+    }
+}
+
+/**
+ * @brief Writes a compare value with a fraction below one count.
+ *
+ * Without dithering the fraction is dropped. Otherwise a first-order
+ * sigma-delta adds it to an error accumulator and writes one count more
+ * whenever the accumulator overflows: per entry of the DMA pattern (one
+ * PWM period each) or once per control step. The error carries over, so
+ * the mean compare equals compare + fraction / 2^FAN_DITHER_FRACTION_BITS.
+ *
+ * @param fan          Instance
+ * @param u32_compare  Compare value
+ * @param u32_fraction Fraction, 0..2^FAN_DITHER_FRACTION_BITS - 1
+ */
+static void fan_write_compare(fan_t *fan, uint32_t u32_compare, uint32_t u32_fraction)
+{
+    fan_dither_t *dither = &fan->dither;
+    const uint32_t u32_mask = (1u << FAN_DITHER_FRACTION_BITS) - 1u;
+
+    /* A tripped guard holds full duty against every writer */
+    if (fan->guard.u8_fault != 0u) {
+        u32_compare = fan->p_pwm_handle->Init.Period + 1u;
+    }
+
+    /* Full duty (Period + 1) has no count above it */
+    if (u32_compare > fan->p_pwm_handle->Init.Period) {
+        u32_fraction = 0u;
+    }
+
+    switch (dither->mode) {
+    case FAN_DITHER_DMA:
+        for (uint32_t i = 0u; i < FAN_DITHER_LENGTH; i++) {
+            dither->u32_error += u32_fraction;
+            dither->u16_pattern[i] = (uint16_t)(u32_compare + (dither->u32_error >> FAN_DITHER_FRACTION_BITS));
+            dither->u32_error &= u32_mask;
+        }
+        break;
+
+    case FAN_DITHER_STEP:
+        dither->u32_error += u32_fraction;
+        fan_set_compare(fan, u32_compare + (dither->u32_error >> FAN_DITHER_FRACTION_BITS));
+        dither->u32_error &= u32_mask;
+        break;
+
+    default:
+        fan_set_compare(fan, u32_compare);
+        break;
+    }
+}
+
+/**
+ * @brief Writes the compare of a fan, into the shadow array while
+ *        fan_control_step_all() batches its timer.
+ *
+ * @param fan         Instance
+ * @param u32_compare Compare value
+ */
+static void fan_set_compare(const fan_t *fan, uint32_t u32_compare)
+{
+    uint32_t u32_timer = (uint32_t)(fan->p_pwm_handle - g_fan_pwm_handle_struct);
+
+    if ((g_u8_fan_batching & (1u << u32_timer)) != 0u) {
+        g_u32_fan_batch[u32_timer][PWM_CHANNEL_INDEX(fan->config.pwm_channel)] = u32_compare;
+        return;
+    }
+
+    FAN_SET_COMPARE(fan, u32_compare);
+}
+
+/**
+ * @brief Returns the compare of a fan as last written (shadow array
+ *        while batched, else the register).
+ *
+ * @param fan Instance
+ * @return Compare value
+ */
+static uint32_t fan_get_compare(const fan_t *fan)
+{
+    uint32_t u32_timer = (uint32_t)(fan->p_pwm_handle - g_fan_pwm_handle_struct);
+
+    if ((g_u8_fan_batching & (1u << u32_timer)) != 0u) {
+        return g_u32_fan_batch[u32_timer][PWM_CHANNEL_INDEX(fan->config.pwm_channel)];
+    }
+
+    return FAN_GET_COMPARE(fan);
+}
+
+/**
+ * @brief Stops the dither DMA; the output keeps the last compare value.
+ *
+ * @param fan Instance
+ */
+static void fan_dither_stop(fan_t *fan)
+{
+    if (fan->dither.mode == FAN_DITHER_DMA) {
+        __HAL_TIM_DISABLE_DMA(fan->p_pwm_handle, TIM_DMA_UPDATE);
+        HAL_DMA_Abort(&fan->dither.dma);
+        dma_alloc_release(&fan->dither.dma);
+    }
+    fan->dither.mode = FAN_DITHER_OFF;
+}
+
+/**
+ * @brief One step of the relay autotune.
+ *
+ * The relay switches low when the RPM rises above setpoint + hysteresis
+ * and high when it falls below setpoint - hysteresis. A cycle ends at
+ * every low->high switch; its period and peak-to-peak RPM are summed
+ * after FAN_AUTOTUNE_SKIP_CYCLES transient cycles.
+ *
+ * @param fan Instance
+ */
+static void fan_autotune_step(fan_t *fan)
+{
+    fan_autotune_t *tune = &fan->autotune;
+    uint32_t u32_rpm = fan_get_rpm(fan);
+
+    tune->u32_steps++;
+
+    if ((float)tune->u32_steps * g_f_ta > (float)FAN_AUTOTUNE_TIMEOUT_S) {
+        tune->state = FAN_AUTOTUNE_FAILED;
+        return;
+    }
+
+    if (u32_rpm > tune->u32_rpm_max) {
+        tune->u32_rpm_max = u32_rpm;
+    }
+    if (u32_rpm < tune->u32_rpm_min) {
+        tune->u32_rpm_min = u32_rpm;
+    }
+
+    if (tune->u8_high && (u32_rpm > tune->u32_setpoint + FAN_AUTOTUNE_HYSTERESIS_RPM)) {
+        tune->u8_high = 0u;
+    } else if (!tune->u8_high && (u32_rpm + FAN_AUTOTUNE_HYSTERESIS_RPM < tune->u32_setpoint)) {
+        /* Low -> high: one full relay cycle */
+        tune->u8_high = 1u;
+
+        if (tune->u8_cycles >= FAN_AUTOTUNE_SKIP_CYCLES) {
+            tune->u32_period_sum += tune->u32_steps - tune->u32_cycle_start;
+            tune->u32_swing_sum  += tune->u32_rpm_max - tune->u32_rpm_min;
+        }
+        tune->u8_cycles++;
+        tune->u32_cycle_start = tune->u32_steps;
+        tune->u32_rpm_max     = 0u;
+        tune->u32_rpm_min     = UINT32_MAX;
+
+        if (tune->u8_cycles >= FAN_AUTOTUNE_SKIP_CYCLES + FAN_AUTOTUNE_CYCLES) {
+            float f_a  = (float)tune->u32_swing_sum / (2.0f * FAN_AUTOTUNE_CYCLES);
+            float f_tu = (float)tune->u32_period_sum * g_f_ta / FAN_AUTOTUNE_CYCLES;
+
+            if ((f_a <= 0.0f) || (f_tu <= 0.0f)) {
+                tune->state = FAN_AUTOTUNE_FAILED;
+                return;
+            }
+
+            /* Ku = 4 d / (pi a), Ziegler-Nichols PI */
+            float f_ku = 4.0f * tune->f_amplitude / (3.14159265f * f_a);
+
+            fan_pi_reset(fan);
+            fan_set_gains(fan, 0.45f * f_ku, 0.54f * f_ku / f_tu);
+            tune->state = FAN_AUTOTUNE_DONE;
+            return;
+        }
+    }
+
+    fan_set_output(fan, tune->u8_high ? tune->f_bias + tune->f_amplitude
+                                      : tune->f_bias - tune->f_amplitude);
+}
+
+/**
+ * @brief One step of the feed-forward calibration sweep.
+ *
+ * Holds the duty of the current point for FAN_FF_SETTLE_MS, then stores
+ * the filtered RPM (clamped to be monotonic) and moves to the next point.
+ *
+ * @param fan Instance
+ */
+static void fan_ff_sweep_step(fan_t *fan)
+{
+    fan_ff_t *ff = &fan->ff;
+    uint32_t u32_full = fan->p_pwm_handle->Init.Period + 1u;
+    uint32_t u32_rpm  = fan_get_rpm(fan);
+
+    fan_write_compare(fan, ff->u8_point * u32_full / (FAN_FF_POINTS - 1u), 0u);
+
+    ff->u32_steps++;
+    if ((float)ff->u32_steps * g_f_ta * 1000.0f < (float)FAN_FF_SETTLE_MS) {
+        return;
+    }
+
+    if (u32_rpm > 0xFFFFu) {
+        u32_rpm = 0xFFFFu;
+    }
+    if ((ff->u8_point > 0u) && (u32_rpm < ff->table.u16_rpm[ff->u8_point - 1u])) {
+        u32_rpm = ff->table.u16_rpm[ff->u8_point - 1u];
+    }
+    ff->table.u16_rpm[ff->u8_point] = (uint16_t)u32_rpm;
+
+    ff->u32_steps = 0u;
+    if (++ff->u8_point >= FAN_FF_POINTS) {
+        ff->table.u8_valid = 1u;
+        ff->u8_sweeping    = 0u;
+        fan_pi_reset(fan);
+    }
+}
+
+/**
+ * @brief Interpolates the duty in compare counts that the table
+ *        predicts for an RPM.
+ *
+ * @param fan     Instance
+ * @param u32_rpm Target RPM
+ * @return Compare counts, 0 if the feed-forward is off or invalid
+ */
+static int32_t fan_ff_counts(const fan_t *fan, uint32_t u32_rpm)
+{
+    const fan_ff_table_t *table = &fan->ff.table;
+    int32_t i32_step = (int32_t)(fan->p_pwm_handle->Init.Period + 1u) / (FAN_FF_POINTS - 1u);
+    uint8_t i;
+
+    if (!fan->ff.u8_enabled || !table->u8_valid || (u32_rpm == 0u)) {
+        return 0;
+    }
+
+    if (u32_rpm >= table->u16_rpm[FAN_FF_POINTS - 1u]) {
+        return i32_step * (int32_t)(FAN_FF_POINTS - 1u);
+    }
+
+    /* First point at or above the target */
+    for (i = 1u; (i < FAN_FF_POINTS - 1u) && (table->u16_rpm[i] < u32_rpm); i++) {
+    }
+
+    int32_t i32_r0 = table->u16_rpm[i - 1u];
+    int32_t i32_r1 = table->u16_rpm[i];
+
+    if ((int32_t)u32_rpm <= i32_r0) {
+        return i32_step * (int32_t)(i - 1u);
+    }
+
+    return i32_step * (int32_t)(i - 1u) +
+           (i32_step * ((int32_t)u32_rpm - i32_r0)) / (i32_r1 - i32_r0);
+}
+
+/**
+ * @brief Advances the setpoint trajectory by one control step.
+ *
+ * The fan lags its duty by about FAN_OBSERVER_TAU_S, so the
+ * feed-forward is looked up tau ahead on the ramp (setpoint + tau *
+ * rate) and the PI only corrects the model error.
+ *
+ * @param fan         Instance
+ * @param pu32_ff_rpm RPM for the feed-forward
+ * @return Setpoint of the PI
+ */
+static uint32_t fan_traj_setpoint(fan_t *fan, uint32_t *pu32_ff_rpm)
+{
+    float f_setpoint;
+    float f_lead;
+
+    if (!fan->traj.u8_enabled) {
+        fan->traj.u32_setpoint = fan->u32_target_rpm;
+        *pu32_ff_rpm = fan->u32_target_rpm;
+        return fan->u32_target_rpm;
+    }
+
+    f_setpoint = fan_traj_step(&fan->traj.state, &fan->traj.params, (float)fan->u32_target_rpm);
+    f_lead     = f_setpoint + FAN_OBSERVER_TAU_S * fan->traj.state.f_rate;
+
+    fan->traj.u32_setpoint = (f_setpoint > 0.0f) ? (uint32_t)(f_setpoint + 0.5f) : 0u;
+    *pu32_ff_rpm = (f_lead > 0.0f) ? (uint32_t)(f_lead + 0.5f) : 0u;
+
+    return fan->traj.u32_setpoint;
+}
+
+/**
+ * @brief One step of the stall detection, run before the controller.
+ *
+ * OK: armed while the RPM expected at the current duty is at least
+ * FAN_STALL_MIN_RPM; after FAN_STALL_SPINUP_MS a missing edge for
+ * FAN_STALL_PERIODS expected periods starts a kick. The measured RPM is
+ * used instead if it is lower, so a decelerating fan is not reported.
+ * KICK: 100 % duty for FAN_KICK_MS, then OK if edges arrived, else the
+ * next kick. Stalls and failed kicks are counted; the count is cleared
+ * after FAN_HEALTH_GOOD_MS without stall.
+ *
+ * @param fan Instance
+ * @return 1 if the output was set here and the controller must not run
+ */
+static uint8_t fan_health_step(fan_t *fan)
+{
+    fan_health_t *health = &fan->health;
+    uint32_t u32_full = fan->p_pwm_handle->Init.Period + 1u;
+    uint32_t u32_now  = HAL_GetTick();
+    uint32_t u32_rpm;
+    uint32_t u32_timeout_ms;
+
+    if (fan->current.u8_enabled) {
+        fan_current_step(fan);
+    }
+
+    if (health->state == FAN_HEALTH_LOCKED_OUT) {
+        fan_write_compare(fan, 0u, 0u);
+        return 1u;
+    }
+
+    if (health->state == FAN_HEALTH_KICK) {
+        if (u32_now - health->u32_since < FAN_KICK_MS) {
+            fan_write_compare(fan, u32_full, 0u);
+            return 1u;
+        }
+
+        /* Edge within the stall timeout of full speed: running again */
+        if (fan_get_sample_age_ms(fan) <= FAN_STALL_MAX_MS) {
+            health->u8_armed  = 1u;
+            health->u32_since = u32_now - FAN_STALL_SPINUP_MS;
+            fan_health_set_state(fan, FAN_HEALTH_OK);
+            return 0u;
+        }
+
+        health->u32_since = u32_now;
+        return fan_health_stall(fan, u32_now);
+    }
+
+    u32_rpm = fan_expected_rpm(fan, FAN_GET_COMPARE(fan));
+    if (u32_rpm < FAN_STALL_MIN_RPM) {
+        health->u8_armed = 0u;
+        return 0u;
+    }
+    if (!health->u8_armed) {
+        health->u8_armed  = 1u;
+        health->u32_since = u32_now;
+    }
+
+    if ((health->u8_failures != 0u) && (u32_now - health->u32_last_stall > FAN_HEALTH_GOOD_MS)) {
+        health->u8_failures = 0u;
+    }
+
+    if (u32_now - health->u32_since < FAN_STALL_SPINUP_MS) {
+        return 0u;
+    }
+
+    /* Spinning but drawing too much: seized or worn bearing */
+    if ((fan->current.u32_limit_mv != 0u) && fan->current.u8_enabled &&
+        (fan->current.u32_mv > fan->current.u32_limit_mv)) {
+        health->u32_since = u32_now;
+        return fan_health_stall(fan, u32_now);
+    }
+
+    if ((fan->u32_rpm != 0u) && (fan->u32_rpm < u32_rpm)) {
+        u32_rpm = fan->u32_rpm;
+    }
+
+    /* Two tacho pulses per revolution: period = 30000 / rpm ms */
+    u32_timeout_ms = FAN_STALL_PERIODS * 30000u / u32_rpm;
+    if (u32_timeout_ms < FAN_STALL_MIN_MS) {
+        u32_timeout_ms = FAN_STALL_MIN_MS;
+    } else if (u32_timeout_ms > FAN_STALL_MAX_MS) {
+        u32_timeout_ms = FAN_STALL_MAX_MS;
+    }
+
+    if (fan_get_sample_age_ms(fan) <= u32_timeout_ms) {
+        return 0u;
+    }
+
+    health->u32_since = u32_now;
+
+    return fan_health_stall(fan, u32_now);
+}
+
+/**
+ * @brief Counts a stall or failed kick and starts the next kick, or
+ *        locks the fan out after FAN_STALL_MAX_RETRIES.
+ *
+ * @param fan     Instance
+ * @param u32_now HAL tick
+ * @return 1 (the output was set)
+ */
+static uint8_t fan_health_stall(fan_t *fan, uint32_t u32_now)
+{
+    fan->health.u32_last_stall = u32_now;
+    BKPTRACE_EVENT(BKPTRACE_EV_FAN_STALL, (fan->u32_target_rpm << 8) | (fan->health.u8_failures + 1u));
+    DLOG("fan: stall %u of %u at target %u rpm", fan->health.u8_failures + 1u, FAN_STALL_MAX_RETRIES,
+         fan->u32_target_rpm);
+
+    if (++fan->health.u8_failures >= FAN_STALL_MAX_RETRIES) {
+        fan_write_compare(fan, 0u, 0u);
+        fan_health_set_state(fan, FAN_HEALTH_LOCKED_OUT);
+        return 1u;
+    }
+
+    fan_write_compare(fan, fan->p_pwm_handle->Init.Period + 1u, 0u);
+    fan_health_set_state(fan, FAN_HEALTH_KICK);
+
+    return 1u;
+}
+
+/**
+ * @brief Returns the RPM expected at a duty, from the feed-forward table
+ *        if one was measured, else linear up to the maximum RPM
+ *        (PARAMS_KEY_FAN_MAX_RPM, default FAN_MAX_RPM).
+ *
+ * @param fan         Instance
+ * @param u32_compare Compare value of the PWM channel
+ * @return Expected RPM
+ */
+static uint32_t fan_expected_rpm(const fan_t *fan, uint32_t u32_compare)
+{
+    const fan_ff_table_t *table = &fan->ff.table;
+    uint32_t u32_full = fan->p_pwm_handle->Init.Period + 1u;
+    uint32_t u32_step = u32_full / (FAN_FF_POINTS - 1u);
+    uint32_t u32_point;
+    uint32_t u32_frac;
+
+    if (u32_compare >= u32_full) {
+        u32_compare = u32_full;
+    }
+
+    if (!table->u8_valid || (u32_step == 0u)) {
+        return params_get_u32(PARAMS_KEY_FAN_MAX_RPM, FAN_MAX_RPM) * u32_compare / u32_full;
+    }
+
+    u32_point = u32_compare / u32_step;
+    if (u32_point >= FAN_FF_POINTS - 1u) {
+        return table->u16_rpm[FAN_FF_POINTS - 1u];
+    }
+    u32_frac = u32_compare - u32_point * u32_step;
+
+    return table->u16_rpm[u32_point] +
+           (table->u16_rpm[u32_point + 1u] - table->u16_rpm[u32_point]) * u32_frac / u32_step;
+}
+
+/**
+ * @brief Changes the health state and calls the callback.
+ *
+ * @param fan   Instance
+ * @param state New state
+ */
+static void fan_health_set_state(fan_t *fan, fan_health_state_t state)
+{
+    if (fan->health.state == state) {
+        return;
+    }
+    fan->health.state = state;
+
+    if (fan->health.callback != NULL) {
+        fan->health.callback(fan, state);
+    }
+}
+
+/**
+ * @brief Writes full duty straight to the compare register (and to the
+ *        dither pattern and burst shadow that would load over it).
+ *
+ * @param fan Instance
+ */
+static void fan_guard_apply(fan_t *fan)
+{
+    uint32_t u32_full = fan->p_pwm_handle->Init.Period + 1u;
+    uint32_t u32_timer = (uint32_t)(fan->p_pwm_handle - g_fan_pwm_handle_struct);
+
+    FAN_SET_COMPARE(fan, u32_full);
+    if (fan->dither.mode == FAN_DITHER_DMA) {
+        for (uint32_t i = 0u; i < FAN_DITHER_LENGTH; i++) {
+            fan->dither.u16_pattern[i] = (uint16_t)u32_full;
+        }
+    }
+    if (g_fan_pwm[u32_timer].u8_burst) {
+        g_u32_fan_batch[u32_timer][PWM_CHANNEL_INDEX(fan->config.pwm_channel)] = u32_full;
+    }
+}
+
+/**
+ * @brief Analog watchdog excursion (ADC_IRQn).
+ *
+ * @param context Guarded instance
+ */
+static void fan_guard_excursion(void *context)
+{
+    fan_guard_trip((fan_t *)context, FAN_GUARD_ADC);
+}
+
+#if FAN_TACHO_CAPTURE
+/**
+ * @brief Starts the tacho capture on TIM2 CH1 (freqmeter: circular DMA of
+ *        CCR1, one interrupt per half ring for the overspeed check).
+ *
+ * @param fan Instance on the capture input
+ */
+static void fan_tacho_capture_init(fan_t *fan)
+{
+    const freqmeter_config_t config = {
+        .port          = FAN_TACHO_CAPTURE_PORT,
+        .pin           = FAN_TACHO_CAPTURE_PIN,
+        .u32_pull      = GPIO_PULLUP,
+        .u32_channel   = TIM_CHANNEL_1,
+        .u32_polarity  = TIM_ICPOLARITY_RISING,
+        .u32_prescaler = TIM_ICPSC_DIV1,
+        .u32_filter    = FAN_TACHO_IC_FILTER,
+        .callback      = fan_capture_guard,
+        .context       = fan,
+    };
+
+    /* TIM2_CH1 request (DMA1 Stream5 Channel 3); without it no capture arrives */
+    (void)freqmeter_init(&g_fan_freqmeter, &config);
+}
+
+/**
+ * @brief Returns the mean period over the FAN_RPM_EDGES newest captures
+ *        if new captures arrived since the last call.
+ *
+ * @param fan      Instance, holds the capture count of the last call
+ * @param p_period Mean period in TIM2 ticks (us), only set if new
+ * @return 1 if a new period was computed, 0 otherwise
+ */
+static uint8_t fan_capture_period(fan_t *fan, uint32_t *p_period)
+{
+    uint32_t u32_count = freqmeter_get_count(&g_fan_freqmeter);
+    uint32_t u32_last  = freqmeter_get_stamp(&g_fan_freqmeter, u32_count - 1u);
+    uint32_t u32_first = freqmeter_get_stamp(&g_fan_freqmeter, u32_count - 1u - FAN_RPM_EDGES);
+
+    if (u32_count == fan->u32_edges_used) {
+        return 0u;
+    }
+    fan->u32_edges_used = u32_count;
+
+    /* The input filter takes the glitches; a period that is still too
+       short is not used, nor one before FAN_RPM_EDGES periods arrived */
+    if ((u32_count <= FAN_RPM_EDGES) || ((u32_last - u32_first) / FAN_RPM_EDGES < fan->u32_min_interval_us)) {
+        fan->u32_edges_rejected++;
+        return 0u;
+    }
+
+    *p_period = (u32_last - u32_first) / FAN_RPM_EDGES;
+
+    return 1u;
+}
+
+/**
+ * @brief Overspeed check of the capture input (freqmeter DMA interrupt,
+ *        every FREQMETER_RING_LENGTH / 2 captures): span of the
+ *        FAN_RPM_EDGES newest periods against the limit.
+ *
+ * @param context Instance on the capture input
+ */
+static void fan_capture_guard(void *context)
+{
+    fan_t *fan = (fan_t *)context;
+    uint32_t u32_count = freqmeter_get_count(&g_fan_freqmeter);
+
+    if ((fan->guard.u32_min_span_us != 0u) && (u32_count > FAN_RPM_EDGES) &&
+        ((freqmeter_get_stamp(&g_fan_freqmeter, u32_count - 1u) -
+          freqmeter_get_stamp(&g_fan_freqmeter, u32_count - 1u - FAN_RPM_EDGES)) < fan->guard.u32_min_span_us)) {
+        fan_guard_trip(fan, FAN_GUARD_OVERSPEED);
+    }
+}
+#endif
+
+/* Interrupt / callback section -------------------------------------------- */
+/**
+ * @brief TIM9 CC2 match of a fan with current sense: starts the injected
+ *        conversion at the sample point, once per control step.
+ *
+ * @param tim       TIM9
+ * @param u32_flags Served flags
+ * @param context   Instance
+ */
+static void fan_current_compare(TIM_TypeDef *tim, uint32_t u32_flags, void *context)
+{
+    (void)context;
+
+    if ((u32_flags & TIM_SR_CC2IF) != 0u) {
+        tim->DIER &= ~(uint32_t)TIM_DIER_CC2IE;
+        g_p_fan_adc_ops->injected_trigger();
+    }
+}
+
+/**
+ * @brief TIM6 update: one control step. Handled on register level, the
+ *        HAL period elapsed callback belongs to the stopwatch module.
+ */
+void TIM6_DAC_IRQHandler(void)
+{
+    uint32_t u32_start;
+    uint32_t u32_cycles;
+
+    if ((TIM6->SR & TIM_SR_UIF) == 0u) {
+        return;
+    }
+    TIM6->SR = ~(uint32_t)TIM_SR_UIF;
+
+    /* The 1 MHz counter restarted at the release */
+    deadline_begin(g_u8_fan_control_deadline, TIM6->CNT);
+    u32_start = DWT->CYCCNT;
+    fan_control_step_all();
+    u32_cycles = DWT->CYCCNT - u32_start;
+
+    {
+        databus_fan_t state = {g_fan_default.u32_target_rpm, g_fan_default.u32_rpm};
+
+        databus_publish(DATABUS_TOPIC_FAN, &state);
+    }
+
+#if HEALTH_ENABLE
+    health_isr_add(HEALTH_ISR_FAN_CONTROL, u32_cycles);
+#endif
+
+    if (g_u8_fan_control_reset) {
+        g_u8_fan_control_reset = 0u;
+        g_fan_control_stats.u32_runs       = 0u;
+        g_fan_control_stats.u32_overruns   = 0u;
+        g_fan_control_stats.u32_max_cycles = 0u;
+    }
+    g_fan_control_stats.u32_runs++;
+    g_fan_control_stats.u32_last_cycles = u32_cycles;
+    if (u32_cycles > g_fan_control_stats.u32_max_cycles) {
+        g_fan_control_stats.u32_max_cycles = u32_cycles;
+    }
+
+    /* Next period already elapsed: the step did not fit */
+    if (TIM6->SR & TIM_SR_UIF) {
+        g_fan_control_stats.u32_overruns++;
+    }
+    sync_snapshot_publish(&g_fan_control_snapshot, &g_fan_control_stats);
+
+    sync_seqlock_write_begin(&g_fan_signal_lock);
+    if (g_u8_fan_signal_reset) {
+        g_u8_fan_signal_reset = 0u;
+        stats_welford_reset(&g_fan_signal_stats.error);
+        stats_welford_reset(&g_fan_signal_stats.cycles);
+        stats_p2_init(&g_fan_signal_stats.cycles_quantile, FAN_STATS_QUANTILE);
+        (void)stats_hist_init(&g_fan_signal_stats.cycles_hist, 0, FAN_STATS_HIST_CYCLES, FAN_STATS_HIST_BINS);
+    }
+    if (g_fan_default.u32_target_rpm != 0u) {
+        stats_welford_add(&g_fan_signal_stats.error,
+                          (float)g_fan_default.u32_target_rpm - (float)g_fan_default.u32_rpm);
+    }
+    stats_welford_add(&g_fan_signal_stats.cycles, (float)u32_cycles);
+    stats_p2_add(&g_fan_signal_stats.cycles_quantile, (float)u32_cycles);
+    stats_hist_add(&g_fan_signal_stats.cycles_hist, (int32_t)u32_cycles);
+    sync_seqlock_write_end(&g_fan_signal_lock);
+
+    osal_event_signal(&g_fan_control_event);
+    deadline_end(g_u8_fan_control_deadline);
 }
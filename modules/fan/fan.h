@@ -14,10 +14,48 @@
  *
  * ----------------------------------------------------------------------------
  * 							### Functionality ###
- *  - PWM-based fan speed control
- *  - RPM measurement via tachometer (EXTI + timer)
- *  - Filtered RPM output
- *  - PI controller for closed-loop speed control
+ *  - PWM-based fan speed control, carrier frequency configurable at the
+ *    highest duty resolution of the timer clock, buffered updates
+ *  - RPM measurement via tachometer (EXTI + timer, or timer input
+ *    capture with DMA if FAN_TACHO_CAPTURE is set)
+ *  - Filtered RPM output, averaged over FAN_RPM_EDGES tacho periods and
+ *    only recomputed when new edges arrived
+ *  - PI controller for closed-loop speed control (float, or Q16 fixed
+ *    point with saturating arithmetic if FAN_PI_FIXED_POINT is set),
+ *    back-calculation anti-windup, duty slew limit, optional D term on
+ *    the measured RPM (PID)
+ *  - Fixed-rate control task on TIM6 with overrun/WCET statistics
+ *  - Relay feedback autotuning of the PI gains per fan
+ *  - Learned RPM -> duty feed-forward table added to the PI output
+ *  - Gain schedule: Kp / Ki per target RPM point, interpolated
+ *  - Tacho edge validation: minimum interval from the maximum RPM,
+ *    blanking window after the PWM switching edges, level confirm reads
+ *  - Speed observer: model of the fan driven by the duty, corrected per
+ *    tacho period, feeds the controller every step
+ *  - Setpoint trajectory: target changes reach the controller as a jerk
+ *    limited S-curve (fan_traj), its rate leads the feed-forward
+ *  - Current sense: injected ADC1 conversion at a fixed point of the PWM
+ *    period, over-current counts as stall in the health logic
+ *  - Duty dithering: first-order sigma-delta of the output fraction
+ *    below one compare count, per PWM period by update DMA on TIM1 /
+ *    TIM8, per control step on TIM9
+ *  - Stall detection within FAN_STALL_MAX_MS, kick-start burst and
+ *    lock-out after repeated failures, with state callback
+ *  - Emergency guard: an ADC analog watchdog excursion (current sense or
+ *    thermistor channel) or a tacho overspeed writes full duty to the
+ *    compare register from the interrupt and latches a fault, no task
+ *    or control step in between; the controller cannot lower the duty
+ *    until fan_guard_clear()
+ *  - Multiple fans: one fan_t per fan, PWM on any channel of
+ *    TIM1/TIM8/TIM9 (pwm service), tacho edges on any free EXTI line
+ *    timestamped by the shared TIM2, all fans updated in one control
+ *    step, PWM periods of the timers staggered against inrush current
+ *  - Batched output: the control step collects the duties of all fans on
+ *    TIM1 / TIM8 in a shadow array, one DMA burst per timer loads them
+ *    at the next update event
+ *
+ * The functions without fan_t argument operate on a built-in instance
+ * with the board wiring (FAN_PWM_INPUT / FAN_TACHO_OUTPUT).
  *
  ******************************************************************************
  */
@@ -27,6 +65,16 @@
 
 /* Includes ---------------------------------------------------------------- */
 #include "stm32f4xx.h"
+#include "median/median.h"
+#include "sync/sync.h"
+#include "ll/ll.h"
+#include "irq/irq.h"
+#include "freqmeter/freqmeter.h"
+#include "fan/fan_observer.h"
+#include "fan/fan_traj.h"
+#include "fan/fan_pi.h"
+#include "stats/stats.h"
+#include "biquad/biquad.h"
 
 /* Public Preprocessor Defines --------------------------------------------- */
 /**
@@ -45,10 +93,601 @@
 #define FAN_TACHO_OUTPUT     GPIO_PIN_6
 
 /**
- * @brief Maximum fan speed in revolutions per minute.
+ * @brief Maximum fan speed in revolutions per minute (default of
+ *        PARAMS_KEY_FAN_MAX_RPM).
  */
 #define FAN_MAX_RPM          5000U
 
+/**
+ * @brief 1: measure the tacho with TIM2 CH1 input capture, filtered in
+ *        hardware, timestamps written to a ring buffer by DMA.
+ *        0: EXTI interrupt on FAN_TACHO_OUTPUT reading TIM2 (default).
+ *
+ * PE6 only connects to TIM9 CH2, which has no DMA and runs the PWM
+ * timebase, so capture mode needs the tacho wired to
+ * FAN_TACHO_CAPTURE_PIN (PA5, TIM2_CH1).
+ */
+#ifndef FAN_TACHO_CAPTURE
+#define FAN_TACHO_CAPTURE    0
+#endif
+
+/**
+ * @brief 1: PI controller in Q16 fixed point with __QADD saturation, no
+ *        FPU use in the control step. 0: float controller (default).
+ *
+ * The fixed point path works directly in PWM compare counts; gains are
+ * converted once in fan_init() / fan_control_start().
+ */
+#ifndef FAN_PI_FIXED_POINT
+#define FAN_PI_FIXED_POINT   0
+#endif
+
+/**
+ * @brief 1: PWM compares written to CCRx directly (modules/ll), 0: HAL
+ *        macros. Init stays on the HAL either way.
+ */
+#ifndef FAN_LL_ENABLE
+#define FAN_LL_ENABLE        LL_ENABLE
+#endif
+
+/**
+ * @brief GPIO port of the tacho input in capture mode.
+ */
+#define FAN_TACHO_CAPTURE_PORT   GPIOA
+
+/**
+ * @brief GPIO pin of the tacho input in capture mode (TIM2_CH1, AF1).
+ */
+#define FAN_TACHO_CAPTURE_PIN    GPIO_PIN_5
+
+/**
+ * @brief Input capture filter (0..15), 15 = fDTS/32 with N = 8.
+ */
+#define FAN_TACHO_IC_FILTER      15U
+
+/**
+ * @brief Tacho edge validation in EXTI mode (the pin has no hardware
+ *        filter). An edge never reaches the history, the RPM or the raw
+ *        edge stream if
+ *        - it follows the last accepted edge by less than the tacho
+ *          period at FAN_TACHO_SPEED_MARGIN times PARAMS_KEY_FAN_MAX_RPM,
+ *        - the pin is low at one of FAN_TACHO_CONFIRM_READS reads
+ *          (spike shorter than the interrupt entry plus the reads).
+ *        The reads wait until the own PWM counter is FAN_TACHO_BLANKING_US
+ *        past its switching edges (update and compare match), so noise
+ *        coupled from the PWM output has settled; 0 disables the window.
+ *        Rejected edges are counted, see fan_get_rejected_edges().
+ */
+#define FAN_TACHO_SPEED_MARGIN   2U
+#define FAN_TACHO_CONFIRM_READS  3U
+#define FAN_TACHO_BLANKING_US    2U
+
+/**
+ * @brief Number of timestamps in the capture ring buffer (freqmeter).
+ */
+#define FAN_TACHO_RING_LENGTH    FREQMETER_RING_LENGTH
+
+/**
+ * @brief Number of tacho periods averaged into one RPM sample.
+ */
+#define FAN_RPM_EDGES                4U
+
+/**
+ * @brief Timestamps kept per fan (power of two, > FAN_RPM_EDGES).
+ */
+#define FAN_EDGE_HISTORY             8U
+
+/**
+ * @brief Timestamps queued per fan for fan_read_edges() (power of two).
+ */
+#define FAN_EDGE_QUEUE               32U
+
+/**
+ * @brief Default rate of the control task in Hz (the PI gains were tuned
+ *        for 20 ms).
+ */
+#define FAN_CONTROL_DEFAULT_RATE_HZ  50U
+
+/**
+ * @brief Tracking time constant Tt = 1 / Kt of the back-calculation
+ *        anti-windup in s, 0 for conditional integration (integral held
+ *        while the output is limited). Kt * Ta is capped at 1.
+ *
+ * On the host plant model (first order, 10 % dead band) conditional
+ * integration settled as fast as back-calculation with Tt = Ta and
+ * faster than with a longer Tt, so it stays the default; a fan whose
+ * integral still winds up (e.g. a setpoint above its maximum RPM for a
+ * long time) can use e.g. 0.02f.
+ */
+#ifndef FAN_PI_TRACKING_TIME_S
+#define FAN_PI_TRACKING_TIME_S       0.0f
+#endif
+
+/**
+ * @brief Default duty slew limit in % per second (full range in 0.25 s),
+ *        0 disables it. Set per fan with fan_set_slew_rate(). Cuts the
+ *        undershoot of aggressive (autotuned) gains after a setpoint
+ *        drop; the limited steps are part of the anti-windup.
+ */
+#ifndef FAN_SLEW_DEFAULT_PERCENT_PER_S
+#define FAN_SLEW_DEFAULT_PERCENT_PER_S  400.0f
+#endif
+
+/**
+ * @brief Speed observer (fan_observer): time constant of the fan model in
+ *        s and the correction gains per tacho measurement. alpha pulls
+ *        the estimate towards the measurement, beta learns the model
+ *        bias. On a simulated fan (tau 0.5 s, 10 % dead band, linear
+ *        model) duty steps gave a quarter of the RMS error of the median
+ *        pipeline; a larger beta follows the dead band faster but
+ *        overshoots more after a step.
+ */
+#ifndef FAN_OBSERVER_TAU_S
+#define FAN_OBSERVER_TAU_S           0.5f
+#endif
+#define FAN_OBSERVER_ALPHA           0.3f
+#define FAN_OBSERVER_BETA            0.02f
+
+/**
+ * @brief Default limits of the setpoint trajectory (fan_traj): rate in
+ *        RPM/s (0: none), acceleration in RPM/s^2 and jerk in RPM/s^3.
+ *        Acceleration or jerk 0 hands target changes to the controller
+ *        as steps. 0 -> 3000 RPM takes about 1.2 s, close to what the
+ *        fan follows at full duty, so the PI stays out of saturation
+ *        and the approach ends without overshoot. Set per fan with
+ *        fan_set_trajectory().
+ */
+#ifndef FAN_TRAJ_RATE_RPM_S
+#define FAN_TRAJ_RATE_RPM_S          0.0f
+#endif
+#ifndef FAN_TRAJ_ACCEL_RPM_S2
+#define FAN_TRAJ_ACCEL_RPM_S2        3000.0f
+#endif
+#ifndef FAN_TRAJ_JERK_RPM_S3
+#define FAN_TRAJ_JERK_RPM_S3         15000.0f
+#endif
+
+/**
+ * @brief NVIC preemption priority of the control task (TIM6).
+ */
+#define FAN_CONTROL_IRQ_PRIORITY     IRQ_CLASS_CONTROL
+
+/**
+ * @brief NVIC preemption priority of the tacho edge interrupt (EXTI).
+ */
+#define FAN_TACHO_IRQ_PRIORITY       IRQ_CLASS_CAPTURE
+
+/**
+ * @brief Maximum number of fan instances.
+ */
+#define FAN_MAX_INSTANCES            8U
+
+/**
+ * @brief Maximum number of distinct PWM timers over all instances.
+ */
+#define FAN_MAX_PWM_TIMERS           3U
+
+/**
+ * @brief Default PWM carrier frequency (4-pin fan specification).
+ */
+#define FAN_PWM_DEFAULT_CARRIER_HZ   25000U
+
+/**
+ * @brief Minimum number of duty steps accepted by fan_pwm_configure().
+ */
+#define FAN_PWM_MIN_STEPS            100U
+
+/**
+ * @brief Relay hysteresis around the autotune setpoint in RPM (rejects
+ *        tacho noise).
+ */
+#define FAN_AUTOTUNE_HYSTERESIS_RPM  50U
+
+/**
+ * @brief Relay cycles skipped before measuring (transient).
+ */
+#define FAN_AUTOTUNE_SKIP_CYCLES     2U
+
+/**
+ * @brief Relay cycles averaged for amplitude and period.
+ */
+#define FAN_AUTOTUNE_CYCLES          4U
+
+/**
+ * @brief Autotune is aborted if it has not finished after this time in s.
+ */
+#define FAN_AUTOTUNE_TIMEOUT_S       60U
+
+/**
+ * @brief Points of the feed-forward table, evenly spaced over the duty
+ *        range 0..100 %.
+ */
+#define FAN_FF_POINTS                11U
+
+/**
+ * @brief Time each duty point is held during the calibration sweep in ms
+ *        before its RPM is recorded.
+ */
+#define FAN_FF_SETTLE_MS             2000U
+
+/**
+ * @brief Points of the gain schedule, evenly spaced over the target
+ *        range 0..PARAMS_KEY_FAN_MAX_RPM.
+ */
+#define FAN_GAIN_POINTS              5U
+
+/**
+ * @brief Compare values per dither pattern (PWM periods the update DMA
+ *        cycles through) and fraction bits of the sigma-delta.
+ */
+#define FAN_DITHER_LENGTH            32U
+#define FAN_DITHER_FRACTION_BITS     8U
+
+/**
+ * @brief Tacho periods without edge after which a running fan counts as
+ *        stalled.
+ */
+#define FAN_STALL_PERIODS            4U
+
+/**
+ * @brief Expected RPM below which the stall detection is inactive (fans
+ *        may stop at low duty).
+ */
+#define FAN_STALL_MIN_RPM            300U
+
+/**
+ * @brief Limits of the stall timeout in ms.
+ */
+#define FAN_STALL_MIN_MS             20U
+#define FAN_STALL_MAX_MS             150U
+
+/**
+ * @brief Spin-up time in ms after the fan is switched on before the
+ *        stall detection is armed.
+ */
+#define FAN_STALL_SPINUP_MS          1000U
+
+/**
+ * @brief Duration of the 100 % kick-start burst in ms.
+ */
+#define FAN_KICK_MS                  300U
+
+/**
+ * @brief Stalls and failed kick-starts (within FAN_HEALTH_GOOD_MS of
+ *        each other) after which the fan is locked out.
+ */
+#define FAN_STALL_MAX_RETRIES        3U
+
+/**
+ * @brief Stall-free operation in ms after which the failure count is
+ *        cleared.
+ */
+#define FAN_HEALTH_GOOD_MS           10000U
+
+/**
+ * @brief Current sense input (shunt amplifier output), sampled by
+ *        injected conversions of ADC1 beside the potis_dma stream.
+ *        FAN_CURRENT_CAL_CHANNEL is the adc_cal index for the millivolts.
+ */
+#define FAN_CURRENT_PORT             GPIOC
+#define FAN_CURRENT_PIN              GPIO_PIN_3
+#define FAN_CURRENT_CHANNEL          ADC_CHANNEL_13
+#define FAN_CURRENT_CAL_CHANNEL      2U
+
+/**
+ * @brief Sample point in percent of the PWM period (compare match of the
+ *        trigger channel: CH4 on TIM1 / TIM8, CH2 on TIM9).
+ */
+#define FAN_CURRENT_SAMPLE_PERCENT   50U
+
+/**
+ * @brief Fault bits of the emergency guard (fan_guard_get_fault()).
+ */
+#define FAN_GUARD_ADC                0x01U  /**< Analog watchdog window left */
+#define FAN_GUARD_OVERSPEED          0x02U  /**< Tacho above the limit       */
+#define FAN_GUARD_EXTERNAL           0x04U  /**< fan_guard_trip() of a module */
+
+/**
+ * @brief Signal statistics of the control task: quantile of the step
+ *        time and its histogram (FAN_STATS_HIST_BINS bins of
+ *        FAN_STATS_HIST_CYCLES CPU cycles from 0).
+ */
+#define FAN_STATS_QUANTILE           0.99f
+#define FAN_STATS_HIST_BINS          32U
+#define FAN_STATS_HIST_CYCLES        500U
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Run time statistics of the control task.
+ */
+typedef struct {
+    uint32_t u32_runs;        /**< Completed control steps                 */
+    uint32_t u32_overruns;    /**< Steps that took longer than one period  */
+    uint32_t u32_last_cycles; /**< CPU cycles of the last step             */
+    uint32_t u32_max_cycles;  /**< Worst case CPU cycles of one step       */
+} fan_control_stats_t;
+
+/**
+ * @brief Streaming statistics of the control task since the last reset.
+ */
+typedef struct {
+    stats_welford_t error;      /**< Target - RPM of the default fan while
+                                     its target is not 0                   */
+    stats_welford_t cycles;     /**< CPU cycles of one step                */
+    stats_p2_t      cycles_quantile; /**< FAN_STATS_QUANTILE of cycles     */
+    stats_hist_t    cycles_hist;
+} fan_signal_stats_t;
+
+/**
+ * @brief Wiring of one fan.
+ */
+typedef struct {
+    TIM_TypeDef  *pwm_timer;     /**< TIM1, TIM8 or TIM9 (APB2 timers)      */
+    uint32_t      pwm_channel;   /**< TIM_CHANNEL_1 .. TIM_CHANNEL_4        */
+    GPIO_TypeDef *pwm_port;      /**< Port of the PWM pin                   */
+    uint16_t      pwm_pin;       /**< PWM pin (GPIO_PIN_x)                  */
+    uint8_t       pwm_alternate; /**< Alternate function, e.g. GPIO_AF3_TIM9 */
+    GPIO_TypeDef *tacho_port;    /**< Port of the tacho pin, NULL: capture  */
+    uint16_t      tacho_pin;     /**< Tacho pin, own EXTI line required    */
+} fan_config_t;
+
+/**
+ * @brief States of the relay autotune.
+ */
+typedef enum {
+    FAN_AUTOTUNE_IDLE = 0, /**< Not started, PI controller active       */
+    FAN_AUTOTUNE_RUNNING,  /**< Relay drives the PWM                    */
+    FAN_AUTOTUNE_DONE,     /**< New gains stored, PI controller active  */
+    FAN_AUTOTUNE_FAILED    /**< Timeout or no oscillation, gains kept   */
+} fan_autotune_state_t;
+
+/**
+ * @brief Health states of a fan.
+ */
+typedef enum {
+    FAN_HEALTH_OK = 0,     /**< Running or legitimately stopped          */
+    FAN_HEALTH_KICK,       /**< Stall detected, 100 % burst running      */
+    FAN_HEALTH_LOCKED_OUT  /**< Kick-starts failed, output off           */
+} fan_health_state_t;
+
+struct fan_s;
+
+/**
+ * @brief Called from the control step on every health state change.
+ */
+typedef void (*fan_health_callback_t)(struct fan_s *fan, fan_health_state_t state);
+
+/**
+ * @brief Called from the interrupt that tripped the guard (after the
+ *        full duty is written), must be short.
+ */
+typedef void (*fan_guard_callback_t)(struct fan_s *fan, uint8_t u8_cause);
+
+/**
+ * @brief ADC1 functions of the current sense and the guard, set by the
+ *        application (fan_set_adc_ops()). The fan module does not link
+ *        an ADC driver: potis_dma provides them with the same signatures
+ *        (potis_dma_injected_start(), _trigger(), _get_mean(), _stop(),
+ *        potis_dma_watchdog_start(), _rearm()).
+ */
+typedef struct {
+    /** Injected conversions of a channel with a trigger (ADC_EXTERNALTRIGINJECCONV_x) */
+    HAL_StatusTypeDef (*injected_start)(uint32_t u32_channel, uint32_t u32_trigger);
+    /** Software start of one conversion, interrupt context */
+    void              (*injected_trigger)(void);
+    /** Mean of the injected ranks, control step */
+    uint32_t          (*injected_get_mean)(void);
+    void              (*injected_stop)(void);
+    /** Analog watchdog on a channel, callback from ADC_IRQn on an excursion */
+    HAL_StatusTypeDef (*watchdog_start)(uint32_t u32_channel, uint16_t u16_low, uint16_t u16_high,
+                                        void (*callback)(void *context), void *context);
+    /** Re-enables the watchdog interrupt after an excursion */
+    void              (*watchdog_rearm)(void);
+} fan_adc_ops_t;
+
+/**
+ * @brief Emergency guard of one fan.
+ */
+typedef struct {
+    volatile uint8_t  u8_fault;     /**< FAN_GUARD_* bits, latched         */
+    uint8_t           u8_adc;       /**< Owns the analog watchdog          */
+    uint32_t          u32_min_span_us; /**< FAN_RPM_EDGES periods at the
+                                        overspeed limit, 0: off            */
+    volatile uint32_t u32_stamp;    /**< timebase_now32() of the first trip */
+    volatile uint32_t u32_trips;    /**< Trips since fan_init()            */
+    fan_guard_callback_t callback;
+} fan_guard_t;
+
+/**
+ * @brief Stall detection data of one fan.
+ */
+typedef struct {
+    volatile fan_health_state_t state;
+    fan_health_callback_t callback;
+    uint8_t  u8_armed;       /**< Expected RPM above FAN_STALL_MIN_RPM     */
+    uint8_t  u8_failures;    /**< Stalls and failed kicks counted          */
+    uint32_t u32_since;      /**< HAL tick of arming / the kick start      */
+    uint32_t u32_last_stall; /**< HAL tick of the last stall               */
+} fan_health_t;
+
+/**
+ * @brief Feed-forward table: RPM measured at FAN_FF_POINTS duty steps.
+ *        Point i corresponds to i * (Period + 1) / (FAN_FF_POINTS - 1)
+ *        compare counts. Can be copied out and restored (RAM/flash).
+ */
+typedef struct {
+    uint16_t u16_rpm[FAN_FF_POINTS]; /**< Monotonic non-decreasing RPM   */
+    uint8_t  u8_valid;               /**< Table filled by sweep or set   */
+} fan_ff_table_t;
+
+/**
+ * @brief Feed-forward state of one fan.
+ */
+typedef struct {
+    fan_ff_table_t    table;
+    uint8_t           u8_enabled; /**< Add the table output to the PI      */
+    volatile uint8_t  u8_sweeping;/**< Calibration sweep is running        */
+    uint8_t           u8_point;   /**< Current sweep point                 */
+    uint32_t          u32_steps;  /**< Control steps at the current point  */
+} fan_ff_t;
+
+/**
+ * @brief Step gains of one schedule point and their change to the next
+ *        point per 1/256 of the band (0 at the last point).
+ */
+typedef struct {
+    float   f_kp;
+    float   f_kp_slope;
+    float   f_ki_ta;
+    float   f_ki_ta_slope;
+    int32_t i32_kp_q16;
+    int32_t i32_kp_slope_q16;
+    int32_t i32_ki_ta_q16;
+    int32_t i32_ki_ta_slope_q16;
+} fan_gain_band_t;
+
+/**
+ * @brief RPM recording of one fan (fan_record_start()).
+ */
+typedef struct {
+    uint16_t         *pu16_buffer;
+    volatile uint32_t u32_length;  /**< Samples to record, 0: off          */
+    volatile uint32_t u32_count;   /**< Samples recorded                   */
+} fan_record_t;
+
+/**
+ * @brief Current sense state of one fan.
+ */
+typedef struct {
+    volatile uint32_t u32_mv;   /**< Mean of the last POTIS_DMA_INJECTED_RANKS
+                                     samples, updated per control step     */
+    uint32_t u32_peak_mv;       /**< Highest mean since enable             */
+    uint32_t u32_limit_mv;      /**< Over-current limit, 0: none           */
+    uint8_t  u8_enabled;
+} fan_current_t;
+
+/**
+ * @brief Speed observer of one fan.
+ */
+typedef struct {
+    fan_observer_params_t params;
+    fan_observer_state_t  state;
+    int32_t           i32_measured; /**< Unfiltered RPM of the newest period */
+    uint8_t           u8_fresh;     /**< i32_measured not used yet           */
+    volatile uint8_t  u8_enabled;   /**< Controller runs on the estimate     */
+} fan_observer_t;
+
+/**
+ * @brief Setpoint trajectory of one fan.
+ */
+typedef struct {
+    fan_traj_params_t params;
+    fan_traj_state_t  state;
+    uint32_t          u32_setpoint; /**< Setpoint of the last control step  */
+    volatile uint8_t  u8_enabled;   /**< 0: target changes are steps        */
+} fan_traj_t;
+
+/**
+ * @brief Dither modes.
+ */
+typedef enum {
+    FAN_DITHER_OFF = 0,    /**< Compare written once per control step    */
+    FAN_DITHER_STEP,       /**< Sigma-delta per control step (no DMA)    */
+    FAN_DITHER_DMA         /**< Sigma-delta per PWM period, update DMA   */
+} fan_dither_mode_t;
+
+/**
+ * @brief Dither state of one fan.
+ */
+typedef struct {
+    uint16_t          u16_pattern[FAN_DITHER_LENGTH]; /**< DMA source, CCR values */
+    DMA_HandleTypeDef dma;
+    uint32_t          u32_error;  /**< Sigma-delta accumulator (fraction)   */
+    fan_dither_mode_t mode;
+} fan_dither_t;
+
+/**
+ * @brief Gain schedule of one fan.
+ */
+typedef struct {
+    float             f_kp[FAN_GAIN_POINTS]; /**< Kp at the points, % per RPM   */
+    float             f_ki[FAN_GAIN_POINTS]; /**< Ki at the points, 1/s         */
+    fan_gain_band_t   bands[FAN_GAIN_POINTS];
+    uint32_t          u32_scale;  /**< Band position per RPM, Q16 of 1/256  */
+    uint32_t          u32_target; /**< Target of the applied gains          */
+    volatile uint8_t  u8_enabled; /**< Schedule replaces fan_set_gains()    */
+} fan_gain_schedule_t;
+
+/**
+ * @brief Working data of the relay autotune.
+ */
+typedef struct {
+    volatile fan_autotune_state_t state;
+    uint32_t u32_setpoint;     /**< RPM the relay oscillates around        */
+    float    f_bias;           /**< Relay centre output in percent         */
+    float    f_amplitude;      /**< Relay amplitude d in percent           */
+    uint8_t  u8_high;          /**< Relay currently at bias + d            */
+    uint8_t  u8_cycles;        /**< Complete relay cycles so far           */
+    uint32_t u32_steps;        /**< Control steps since start              */
+    uint32_t u32_cycle_start;  /**< Step of the last low->high switch      */
+    uint32_t u32_rpm_max;      /**< Extrema of the current cycle           */
+    uint32_t u32_rpm_min;
+    uint32_t u32_period_sum;   /**< Sum of measured periods in steps       */
+    uint32_t u32_swing_sum;    /**< Sum of peak-to-peak RPM                */
+} fan_autotune_t;
+
+/**
+ * @brief Tacho state published by the edge interrupt (sync snapshot).
+ */
+typedef struct {
+    uint32_t u32_edges;        /**< Edges received (free running)          */
+    uint32_t u32_span_us;      /**< Time over the last u32_periods periods */
+    uint32_t u32_periods;      /**< Periods in the span, 0..FAN_RPM_EDGES  */
+    uint32_t u32_tick_ms;      /**< HAL tick of the newest edge            */
+} fan_tacho_sample_t;
+
+/**
+ * @brief State of one fan. Allocated by the application, initialized
+ *        by fan_init().
+ */
+typedef struct fan_s {
+    fan_config_t       config;
+    TIM_HandleTypeDef *p_pwm_handle;
+    volatile uint32_t  u32_edge_ts[FAN_EDGE_HISTORY]; /**< TIM2 timestamps */
+    uint32_t           u32_edge_queue_buffer[FAN_EDGE_QUEUE];
+    sync_queue_t       edge_queue;      /**< Raw edge stream                 */
+    volatile uint32_t  u32_edges;       /**< Edges received, ISR write index */
+    uint32_t           u32_edges_used;  /**< Edge count of the cached RPM    */
+    volatile uint32_t  u32_edges_rejected; /**< Edges failing validation     */
+    uint32_t           u32_min_interval_us; /**< Shortest valid tacho period  */
+    uint32_t           u32_blanking;    /**< PWM counts blanked per switch   */
+    fan_tacho_sample_t tacho_buffers[2];
+    sync_snapshot_t    tacho;           /**< Published tacho state           */
+    volatile uint32_t  u32_target_rpm;
+    volatile uint32_t  u32_rpm;         /**< Filtered RPM of the last update */
+    uint32_t           u32_smoothed;
+    float              f_kp;             /**< % per RPM                         */
+    float              f_ki;             /**< % per RPM and second              */
+    float              f_kd;             /**< % per RPM/s on the RPM, 0: PI     */
+    float              f_slew;           /**< Duty slew limit in %/s, 0: off    */
+    fan_pi_float_t     pi;               /**< Float step parameters at Ta       */
+    fan_pi_float_state_t pi_state;
+    fan_pi_q16_t       pi_q16;           /**< Fixed point parameters at Ta      */
+    fan_pi_q16_state_t pi_q16_state;
+    median_filter_t    median;
+    biquad_f32_t * volatile p_rpm_biquad; /**< Replaces the 4:1 smoothing  */
+    fan_autotune_t     autotune;
+    fan_ff_t           ff;
+    fan_gain_schedule_t schedule;
+    fan_dither_t       dither;
+    fan_observer_t     observer;
+    fan_traj_t         traj;
+    fan_current_t      current;
+    fan_record_t       record;
+    fan_health_t       health;
+    fan_guard_t        guard;
+} fan_t;
+
 /* Public Function Prototypes ---------------------------------------------- */
 /**
  * @brief Initializes the fan control module.
@@ -95,4 +734,670 @@ uint32_t fan_get_target_rpm(void);
  */
 void fan_update_pi_controller(void);
 
+/**
+ * @brief Runs fan_control_step_all() from the TIM6 update interrupt at a
+ *        fixed rate, independent of the main loop.
+ *
+ * The sampling time of the controller is set to 1 / rate_hz. Each step
+ * is timed with the DWT cycle counter; a step is counted as overrun if
+ * the next timer period elapsed before it finished.
+ *
+ * @param rate_hz Control rate in Hz (1..100000), e.g. FAN_CONTROL_DEFAULT_RATE_HZ
+ * @return HAL_OK, HAL_ERROR for an invalid rate
+ */
+HAL_StatusTypeDef fan_control_start(uint32_t rate_hz);
+
+/**
+ * @brief Stops the fixed-rate control task.
+ *
+ * @return None
+ */
+void fan_control_stop(void);
+
+/**
+ * @brief Brackets every control step with deadline_begin() /
+ *        deadline_end(); the lateness is the TIM6 count at the start of
+ *        the interrupt (us since the update event).
+ *
+ * @param u8_deadline_id Step of deadline_add(), DEADLINE_NONE = none
+ * @return None
+ */
+void fan_control_set_deadline(uint8_t u8_deadline_id);
+
+/**
+ * @brief Copies the run time statistics of the control task.
+ *
+ * Reads the snapshot published after every step (sync module), the
+ * control interrupt stays enabled.
+ *
+ * @param stats Destination
+ * @return HAL_OK, HAL_BUSY if two steps ran during each copy attempt
+ */
+HAL_StatusTypeDef fan_get_control_stats(fan_control_stats_t *stats);
+
+/**
+ * @brief Waits for the next step of the fixed-rate control task.
+ *
+ * Sleeps until the TIM6 interrupt has run the next controller step
+ * (RTOS build: blocks the calling task), e.g. to display each new RPM
+ * once. Only one caller may wait at a time.
+ *
+ * @param u32_timeout_ms Timeout in ms, OSAL_WAIT_FOREVER = none
+ * @return HAL_OK, HAL_TIMEOUT if no step ran (control task stopped)
+ */
+HAL_StatusTypeDef fan_control_wait(uint32_t u32_timeout_ms);
+
+/**
+ * @brief Clears the run time statistics of the control task.
+ *
+ * While the task runs the clear is done by its next step (single
+ * writer), the snapshot shows it after that step.
+ *
+ * @return None
+ */
+void fan_reset_control_stats(void);
+
+/**
+ * @brief Copies the signal statistics of the control task (RPM error,
+ *        step time distribution).
+ *
+ * @param stats Destination
+ * @return HAL_OK, HAL_BUSY if a step updated them during each copy attempt
+ */
+HAL_StatusTypeDef fan_get_signal_stats(fan_signal_stats_t *stats);
+
+/**
+ * @brief Restarts the signal statistics, done by the next control step.
+ *
+ * @return None
+ */
+void fan_reset_signal_stats(void);
+
+/**
+ * @brief Returns the filtered RPM used by the last controller step,
+ *        without running the filter again.
+ *
+ * @return Fan speed in RPM.
+ */
+uint32_t fan_get_last_rpm(void);
+
+/**
+ * @brief Initializes one fan and registers it for fan_control_step_all().
+ *
+ * PWM timers shared by several fans are configured once. The EXTI line
+ * of the tacho pin (= pin number) must not be used by another fan or
+ * module, see exti_register().
+ *
+ * @param fan    Instance to initialize
+ * @param config Wiring, copied into the instance
+ * @return HAL_OK, HAL_ERROR for invalid wiring or too many instances
+ */
+HAL_StatusTypeDef fan_init(fan_t *fan, const fan_config_t *config);
+
+/**
+ * @brief Sets the target speed of one fan.
+ *
+ * @param fan        Instance
+ * @param target_rpm Target fan speed in RPM
+ * @return None
+ */
+void fan_set_target_rpm(fan_t *fan, uint32_t target_rpm);
+
+/**
+ * @brief Measures and filters the speed of one fan.
+ *
+ * A new sample (mean period over the last FAN_RPM_EDGES edges, median,
+ * 4:1 smoothing) is only computed if edges arrived since the last call;
+ * otherwise the cached value is returned.
+ *
+ * @param fan Instance
+ * @return Filtered fan speed in RPM, 0 without tacho signal for 1 s.
+ */
+uint32_t fan_get_rpm(fan_t *fan);
+
+/**
+ * @brief Returns the filtered RPM of the last fan_get_rpm() (control
+ *        step) without filtering again, any context.
+ *
+ * @param fan Instance
+ * @return Filtered fan speed in RPM
+ */
+uint32_t fan_get_cached_rpm(const fan_t *fan);
+
+/**
+ * @brief Replaces the 4:1 smoothing after the median by an IIR cascade,
+ *        e.g. a Butterworth low-pass for a sharper cut of the tacho
+ *        jitter.
+ *
+ * The cascade runs once per new RPM sample, so its sample rate is the
+ * edge rate up to the control rate (design it for the control rate, the
+ * edges keep up with 50 Hz above 1500 RPM). The state is preset to the
+ * current RPM.
+ *
+ * @param fan    Instance
+ * @param filter Cascade (biquad_f32_init()), kept by the caller; NULL
+ *               restores the 4:1 smoothing
+ * @return None
+ */
+void fan_set_rpm_biquad(fan_t *fan, biquad_f32_t *filter);
+
+/**
+ * @brief Sets the PWM carrier frequency of the timer of a fan.
+ *
+ * The prescaler is chosen as small as possible so that the 16 bit period
+ * gives the maximum duty resolution for the current timer clock (e.g.
+ * 7200 steps at 25 kHz with a 180 MHz timer clock). Duty cycles of all
+ * fans on the same timer are kept. ARR and CCR are preload buffered, so
+ * updates take effect at the next period without glitches.
+ *
+ * @param fan        Instance (the whole timer is reconfigured)
+ * @param carrier_hz PWM frequency in Hz
+ * @return HAL_OK, HAL_ERROR if fewer than FAN_PWM_MIN_STEPS steps remain
+ */
+HAL_StatusTypeDef fan_pwm_configure(fan_t *fan, uint32_t carrier_hz);
+
+/**
+ * @brief Spreads the PWM periods of the fan timers (TIM1 / TIM8 / TIM9)
+ *        evenly, so that the fans on different timers do not switch on
+ *        at the same time (inrush current).
+ *
+ * Call again after fan_pwm_configure().
+ *
+ * @return HAL_OK, HAL_ERROR if the timers run different periods
+ */
+HAL_StatusTypeDef fan_pwm_stagger(void);
+
+/**
+ * @brief Enables or disables the batched output of the fan timers.
+ *
+ * Enabled, fan_control_step_all() does not write the compare registers
+ * of fans on TIM1 / TIM8: the duties of all fans on a timer go into a
+ * shadow array, and after the last fan one DMA burst of the timer (pwm
+ * service) loads them at the next update event. All fans of the timer
+ * change in the same PWM period, the CPU does not wait for it. TIM9 has
+ * no update DMA and keeps the direct writes. The burst takes the update
+ * stream of the timer, so fans on it dither per control step.
+ *
+ * @param enable 1 to batch
+ * @return HAL_OK, HAL_BUSY if the update stream of a timer is taken
+ *         (dither DMA, dot fade); that timer keeps direct writes
+ */
+HAL_StatusTypeDef fan_pwm_batch_enable(uint8_t enable);
+
+/**
+ * @brief Returns the number of duty steps of the PWM of a fan.
+ *
+ * @param fan Instance
+ * @return Period + 1 in timer counts
+ */
+uint32_t fan_pwm_get_resolution(const fan_t *fan);
+
+/**
+ * @brief Returns the age of the newest tacho edge of a fan.
+ *
+ * @param fan Instance
+ * @return Milliseconds since the last edge.
+ */
+uint32_t fan_get_sample_age_ms(fan_t *fan);
+
+/**
+ * @brief Copies the tacho timestamps that arrived since the last call,
+ *        oldest first (raw edge stream, e.g. for usb_cdc).
+ *
+ * In EXTI mode the interrupt queues every edge (sync_queue_t, one
+ * consumer); a reader more than FAN_EDGE_QUEUE edges behind loses the
+ * newest ones, see fan_get_dropped_edges(). The cursor then counts the
+ * edges read. In capture mode the cursor counts the captures, only the
+ * last FAN_TACHO_RING_LENGTH - 1 edges are kept; a reader further behind
+ * skips to the oldest one.
+ *
+ * @param fan         Instance
+ * @param pu32_cursor Read position, updated
+ * @param pu32_ts     Destination, TIM2 timestamps in us
+ * @param u32_max     Room in the destination
+ * @return Timestamps copied
+ */
+uint32_t fan_read_edges(fan_t *fan, uint32_t *pu32_cursor, uint32_t *pu32_ts, uint32_t u32_max);
+
+/**
+ * @brief Returns the edges dropped from the raw edge stream (EXTI mode).
+ *
+ * @param fan Instance
+ * @return Edges lost because fan_read_edges() fell behind
+ */
+uint32_t fan_get_dropped_edges(const fan_t *fan);
+
+/**
+ * @brief Returns the tacho edges rejected as glitches (EXTI mode: too
+ *        short interval or pin low at the confirm reads; capture mode:
+ *        mean period below the shortest valid one).
+ *
+ * @param fan Instance
+ * @return Rejected edges (capture mode: rejected periods)
+ */
+uint32_t fan_get_rejected_edges(const fan_t *fan);
+
+/**
+ * @brief Runs one PI step for one fan.
+ *
+ * @param fan Instance
+ * @return None
+ */
+void fan_update(fan_t *fan);
+
+/**
+ * @brief Runs one PI step for every registered fan in a single pass.
+ *        Called by the control task if it is running.
+ *
+ * @return None
+ */
+void fan_control_step_all(void);
+
+/**
+ * @brief Sets the PI gains of a fan (percent output per RPM error).
+ *
+ * @param fan Instance
+ * @param kp  Proportional gain
+ * @param ki  Integral gain in 1/s
+ * @return None
+ */
+void fan_set_gains(fan_t *fan, float kp, float ki);
+
+/**
+ * @brief Returns the PI gains of a fan, e.g. to persist autotune results.
+ *
+ * @param fan Instance
+ * @param kp  Proportional gain (output)
+ * @param ki  Integral gain (output)
+ * @return None
+ */
+void fan_get_gains(const fan_t *fan, float *kp, float *ki);
+
+/**
+ * @brief Sets the derivative gain of a fan; it acts on the measured RPM,
+ *        so setpoint steps give no kick.
+ *
+ * @param fan Instance
+ * @param kd  Derivative gain in percent per RPM/s, 0 for a PI controller
+ * @return None
+ */
+void fan_set_derivative_gain(fan_t *fan, float kd);
+
+/**
+ * @brief Returns the derivative gain of a fan.
+ *
+ * @param fan Instance
+ * @return Derivative gain in percent per RPM/s
+ */
+float fan_get_derivative_gain(const fan_t *fan);
+
+/**
+ * @brief Limits how fast the duty of a fan may change under control.
+ *        The integral is back-calculated from the limited output, so a
+ *        slew limited ramp does not wind it up.
+ *
+ * @param fan               Instance
+ * @param percent_per_s     Duty change in % per second, 0 for no limit
+ * @return None
+ */
+void fan_set_slew_rate(fan_t *fan, float percent_per_s);
+
+/**
+ * @brief Starts the relay feedback autotune (Astrom-Hagglund).
+ *
+ * Instead of the PI controller, fan_update() switches the PWM between
+ * bias - d and bias + d whenever the RPM crosses the setpoint. From the
+ * resulting limit cycle (amplitude a, period Tu) the ultimate gain
+ * Ku = 4 d / (pi a) is computed and Ziegler-Nichols PI gains
+ * Kp = 0.45 Ku, Ki = 0.54 Ku / Tu are stored in the instance.
+ * Needs fan_update() to be called at a fixed rate (control task).
+ *
+ * @param fan          Instance
+ * @param setpoint_rpm RPM to oscillate around
+ * @param bias_percent Relay centre in percent
+ * @param relay_percent Relay amplitude d in percent
+ * @return HAL_OK, HAL_ERROR for an invalid relay range
+ */
+HAL_StatusTypeDef fan_autotune_start(fan_t *fan, uint32_t setpoint_rpm,
+                                     float bias_percent, float relay_percent);
+
+/**
+ * @brief Returns the autotune state of a fan.
+ *
+ * @param fan Instance
+ * @return Current state
+ */
+fan_autotune_state_t fan_autotune_get_state(const fan_t *fan);
+
+/**
+ * @brief Starts the feed-forward calibration sweep: every duty point is
+ *        held for FAN_FF_SETTLE_MS and the settled RPM is stored. Runs
+ *        from fan_update() instead of the PI controller.
+ *
+ * @param fan Instance
+ * @return None
+ */
+void fan_ff_start_sweep(fan_t *fan);
+
+/**
+ * @brief Returns 1 while the calibration sweep is running.
+ *
+ * @param fan Instance
+ * @return Sweep state
+ */
+uint8_t fan_ff_is_sweeping(const fan_t *fan);
+
+/**
+ * @brief Enables or disables the feed-forward term (needs a valid table).
+ *
+ * @param fan    Instance
+ * @param enable 1 to add the table output to the PI output
+ * @return None
+ */
+void fan_ff_enable(fan_t *fan, uint8_t enable);
+
+/**
+ * @brief Copies the feed-forward table, e.g. to store it in flash.
+ *
+ * @param fan   Instance
+ * @param table Destination
+ * @return None
+ */
+void fan_ff_get_table(const fan_t *fan, fan_ff_table_t *table);
+
+/**
+ * @brief Restores a feed-forward table.
+ *
+ * @param fan   Instance
+ * @param table Source, marked valid after the copy
+ * @return HAL_OK, HAL_ERROR if the RPM values are not monotonic
+ */
+HAL_StatusTypeDef fan_ff_set_table(fan_t *fan, const fan_ff_table_t *table);
+
+/**
+ * @brief Sets the gains of one point of the gain schedule. Point i is
+ *        the target i * max RPM / (FAN_GAIN_POINTS - 1); between points
+ *        Kp and Ki are interpolated linearly. All points start with the
+ *        gains of fan_init().
+ *
+ * @param fan      Instance
+ * @param u8_point 0 .. FAN_GAIN_POINTS - 1
+ * @param kp       Proportional gain
+ * @param ki       Integral gain in 1/s
+ * @return HAL_OK, HAL_ERROR for an invalid point
+ */
+HAL_StatusTypeDef fan_gain_schedule_set(fan_t *fan, uint8_t u8_point, float kp, float ki);
+
+/**
+ * @brief Enables or disables the gain schedule. While enabled it
+ *        replaces the gains of fan_set_gains() and the autotune; the
+ *        integral is kept as a term in output units, so switching gains
+ *        (by table or target) does not step the output.
+ *
+ * @param fan    Instance
+ * @param enable 1 to take Kp / Ki from the schedule
+ * @return None
+ */
+void fan_gain_schedule_enable(fan_t *fan, uint8_t enable);
+
+/**
+ * @brief Enables or disables duty dithering.
+ *
+ * The controller output below one compare count is accumulated by a
+ * first-order sigma-delta that adds one count to a share of the PWM
+ * periods, so the mean duty gets FAN_DITHER_FRACTION_BITS more bits and
+ * the output no longer limit-cycles between two counts. A fan on TIM1 /
+ * TIM8 gets a FAN_DITHER_LENGTH pattern per control step, played by the
+ * update DMA into CCRx (no CPU per PWM period). TIM9 has no DMA request,
+ * so a fan on it (or without a free stream) dithers once per control
+ * step; the fan still averages that over its inertia.
+ *
+ * @param fan    Instance
+ * @param enable 1 to dither
+ * @return Mode in effect
+ */
+fan_dither_mode_t fan_dither_enable(fan_t *fan, uint8_t enable);
+
+/**
+ * @brief Enables or disables the speed observer as controller feedback.
+ *
+ * Enabled, the control step predicts the RPM from the commanded duty
+ * and corrects it with the unfiltered RPM of every new tacho period
+ * instead of using the median-filtered RPM, which needs several edges
+ * to follow a change. fan_get_rpm() stays the filtered value.
+ *
+ * @param fan    Instance
+ * @param enable 1 to control on the estimate
+ * @return None
+ */
+void fan_observer_enable(fan_t *fan, uint8_t enable);
+
+/**
+ * @brief Returns the RPM estimate of the observer of the last control
+ *        step (also updated while the observer is not the feedback).
+ *
+ * @param fan Instance
+ * @return Estimated RPM
+ */
+uint32_t fan_get_estimated_rpm(const fan_t *fan);
+
+/**
+ * @brief Sets the limits of the setpoint trajectory.
+ *
+ * The controller (setpoint and feed-forward) follows a target change
+ * along a jerk limited S-curve instead of a step. A change while the
+ * setpoint moves continues from its current rate and acceleration.
+ *
+ * @param fan            Instance
+ * @param f_rate_rpm_s   Rate limit in RPM/s, 0: none
+ * @param f_accel_rpm_s2 Acceleration limit in RPM/s^2, 0: steps
+ * @param f_jerk_rpm_s3  Jerk limit in RPM/s^3, 0: steps
+ * @return HAL_OK, HAL_ERROR for a negative limit
+ */
+HAL_StatusTypeDef fan_set_trajectory(fan_t *fan, float f_rate_rpm_s, float f_accel_rpm_s2, float f_jerk_rpm_s3);
+
+/**
+ * @brief Returns the setpoint of the last control step (the target if
+ *        the trajectory is off).
+ *
+ * @param fan Instance
+ * @return Setpoint RPM
+ */
+uint32_t fan_get_setpoint_rpm(const fan_t *fan);
+
+/**
+ * @brief Returns the duty of the PWM output as last written.
+ *
+ * @param fan Instance
+ * @return Duty in per mille, 0..1000
+ */
+uint16_t fan_get_duty_permille(const fan_t *fan);
+
+/**
+ * @brief Records the controller feedback RPM of every control step into
+ *        RAM (fixed rate, e.g. for step responses, see fan_step).
+ *
+ * A running recording is replaced; the first sample is the next step.
+ *
+ * @param fan         Instance
+ * @param pu16_buffer Destination, RPM per control step
+ * @param u32_length  Samples to record
+ * @return HAL_OK, HAL_ERROR for a NULL buffer or length 0
+ */
+HAL_StatusTypeDef fan_record_start(fan_t *fan, uint16_t *pu16_buffer, uint32_t u32_length);
+
+/**
+ * @brief Returns the samples recorded so far.
+ *
+ * @param fan Instance
+ * @return Samples in the buffer of fan_record_start()
+ */
+uint32_t fan_record_get_count(const fan_t *fan);
+
+/**
+ * @brief Sets the ADC1 functions of the current sense and the guard.
+ *
+ * Called before fan_current_enable() and fan_guard_adc(), not while a
+ * current sense or an ADC guard runs.
+ *
+ * @param ops Functions, kept (static storage), NULL: no current sense
+ *            and no ADC guard
+ * @return None
+ */
+void fan_set_adc_ops(const fan_adc_ops_t *ops);
+
+/**
+ * @brief Starts the current sense of one fan (one fan at a time, ADC1
+ *        running, injected conversions of fan_set_adc_ops()).
+ *
+ * The PWM timer samples FAN_CURRENT_CHANNEL at FAN_CURRENT_SAMPLE_PERCENT
+ * of every period: TIM1 / TIM8 trigger the injected conversion with
+ * their CC4 event, the injected ranks hold the last four PWM periods.
+ * TIM9 is no ADC trigger source, so its CC2 match starts one conversion
+ * per control step from an interrupt (same phase, four steps averaged).
+ * The control step takes the mean into the health logic: after the
+ * spin-up time a mean above the limit (seized rotor, worn bearing)
+ * counts as a stall.
+ *
+ * @param fan          Instance
+ * @param u32_limit_mv Over-current limit at the ADC pin, 0 to only measure
+ * @return HAL_OK, HAL_ERROR if another fan senses, the trigger channel
+ *         drives a fan, no functions are set or ADC1 is off
+ */
+HAL_StatusTypeDef fan_current_enable(fan_t *fan, uint32_t u32_limit_mv);
+
+/**
+ * @brief Stops the current sense.
+ *
+ * @param fan Instance
+ * @return None
+ */
+void fan_current_disable(fan_t *fan);
+
+/**
+ * @brief Returns the current sense voltage of a fan.
+ *
+ * @param fan       Instance
+ * @param pu32_peak Highest mean since enable, NULL if not needed
+ * @return Mean in mV of the last samples, 0 if not enabled
+ */
+uint32_t fan_get_current_mv(const fan_t *fan, uint32_t *pu32_peak);
+
+/**
+ * @brief Sets the callback for health state changes of a fan.
+ *
+ * The callback runs in the context of fan_update() (control task
+ * interrupt) and must be short.
+ *
+ * @param fan      Instance
+ * @param callback Function, NULL to disable
+ * @return None
+ */
+void fan_set_health_callback(fan_t *fan, fan_health_callback_t callback);
+
+/**
+ * @brief Returns the health state of a fan.
+ *
+ * While the fan is driven, no tacho edge for FAN_STALL_PERIODS periods
+ * of the RPM expected at the current duty (feed-forward table, else
+ * linear up to FAN_MAX_RPM; at most FAN_STALL_MAX_MS) counts as stall.
+ * A stalled fan gets a FAN_KICK_MS burst at 100 % duty; after
+ * FAN_STALL_MAX_RETRIES stalls or failed bursts it is locked out with
+ * 0 % duty until fan_health_reset().
+ *
+ * @param fan Instance
+ * @return Current state
+ */
+fan_health_state_t fan_get_health(const fan_t *fan);
+
+/**
+ * @brief Clears a lock-out and the failure count of a fan.
+ *
+ * @param fan Instance
+ * @return None
+ */
+void fan_health_reset(fan_t *fan);
+
+/**
+ * @brief Guards a fan with the ADC1 analog watchdog (one fan at a time).
+ *
+ * A conversion of u32_channel outside [u16_low, u16_high] trips the
+ * guard from ADC_IRQn within the conversion (watchdog of
+ * fan_set_adc_ops(), e.g. potis_dma_watchdog_start()). On the current
+ * sense channel
+ * (fan_current_enable(), FAN_CURRENT_CHANNEL) the samples come per PWM
+ * period on TIM1 / TIM8, per control step on TIM9; a thermistor divider
+ * on a channel of the DMA stream is watched at the ADC sample rate.
+ *
+ * @param fan         Instance
+ * @param u32_channel ADC_CHANNEL_x
+ * @param u16_low     Lowest valid ADC value
+ * @param u16_high    Highest valid ADC value
+ * @return HAL_OK, HAL_ERROR if another fan owns the watchdog, no
+ *         functions are set or ADC1 is off
+ */
+HAL_StatusTypeDef fan_guard_adc(fan_t *fan, uint32_t u32_channel, uint16_t u16_low, uint16_t u16_high);
+
+/**
+ * @brief Guards a fan against overspeed.
+ *
+ * EXTI mode: every accepted tacho edge compares the span of the last
+ * FAN_RPM_EDGES periods (one subtraction in the edge interrupt).
+ * Capture mode has no edge interrupt, the check runs in the freqmeter
+ * DMA interrupt every FREQMETER_RING_LENGTH / 2 captures. The limit must stay below
+ * FAN_TACHO_SPEED_MARGIN times the maximum RPM, faster edges are
+ * rejected as noise before.
+ *
+ * @param fan     Instance
+ * @param u32_rpm Limit, 0 to stop the check
+ * @return HAL_OK, HAL_ERROR if the limit is not measurable
+ */
+HAL_StatusTypeDef fan_guard_overspeed(fan_t *fan, uint32_t u32_rpm);
+
+/**
+ * @brief Trips the guard: full duty to the compare register, fault
+ *        latched (any context, e.g. an external comparator interrupt).
+ *
+ * @param fan      Instance
+ * @param u8_cause FAN_GUARD_* bit
+ * @return None
+ */
+void fan_guard_trip(fan_t *fan, uint8_t u8_cause);
+
+/**
+ * @brief Sets the callback of a trip.
+ *
+ * @param fan      Instance
+ * @param callback Function, NULL to disable
+ * @return None
+ */
+void fan_guard_set_callback(fan_t *fan, fan_guard_callback_t callback);
+
+/**
+ * @brief Returns the latched faults of a fan.
+ *
+ * @param fan        Instance
+ * @param pu32_stamp timebase_now32() of the first trip, NULL if not needed
+ * @return FAN_GUARD_* bits, 0 if the guard has not tripped
+ */
+uint8_t fan_guard_get_fault(const fan_t *fan, uint32_t *pu32_stamp);
+
+/**
+ * @brief Clears the faults and re-arms the analog watchdog; the next
+ *        control step drives the fan again. A cause still present trips
+ *        again at once.
+ *
+ * @param fan Instance
+ * @return None
+ */
+void fan_guard_clear(fan_t *fan);
+
+/**
+ * @brief Returns the built-in instance used by the single-fan API, e.g.
+ *        to autotune the board fan.
+ *
+ * @return Instance
+ */
+fan_t *fan_get_default(void);
+
 #endif /* FAN_FAN_H_ */
@@ -0,0 +1,142 @@
+/**
+ ******************************************************************************
+ * @file        fan_curve.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Temperature to RPM fan curve
+ *
+ * Functionality:
+ * - Piecewise linear table, Q16 slope per segment precomputed
+ * - Segment hint, hysteresis on falling temperatures, rate limit
+ *
+ * Resources:
+ * - None (pure computation, also built on the host)
+ ******************************************************************************
+ */
+
+#include "fan_curve.h"
+
+#include <stddef.h>
+
+/* Public functions --------------------------------------------------------- */
+HAL_StatusTypeDef fan_curve_init(fan_curve_t *curve, const fan_curve_point_t *points, uint8_t u8_count,
+                                 int32_t i32_hysteresis, uint32_t u32_rate_rpm_s)
+{
+    if ((curve == NULL) || (points == NULL) || (u8_count < 2U) || (u8_count > FAN_CURVE_MAX_POINTS) ||
+        (i32_hysteresis < 0)) {
+        return HAL_ERROR;
+    }
+
+    for (uint8_t i = 0U; i < u8_count; i++) {
+        if ((points[i].u32_rpm > FAN_CURVE_MAX_RPM) ||
+            ((i > 0U) && (points[i].i32_temp <= points[i - 1U].i32_temp))) {
+            return HAL_ERROR;
+        }
+    }
+
+    for (uint8_t i = 0U; i < u8_count; i++) {
+        curve->points[i] = points[i];
+    }
+    for (uint8_t i = 0U; (i + 1U) < u8_count; i++) {
+        int64_t i64_rise  = (int64_t)points[i + 1U].u32_rpm - (int64_t)points[i].u32_rpm;
+        int64_t i64_width = (int64_t)points[i + 1U].i32_temp - (int64_t)points[i].i32_temp;
+
+        curve->i32_slope_q16[i] = (int32_t)((i64_rise * 65536) / i64_width);
+    }
+
+    curve->u8_count       = u8_count;
+    curve->u8_segment     = 0U;
+    curve->u8_started     = 0U;
+    curve->i32_hysteresis = i32_hysteresis;
+    curve->i32_offset     = 0;
+    curve->i32_effective  = 0;
+    curve->u32_rate       = u32_rate_rpm_s;
+    curve->u32_last_ms    = 0U;
+    curve->u32_output     = 0U;
+
+    return HAL_OK;
+}
+
+void fan_curve_set_offset(fan_curve_t *curve, int32_t i32_offset)
+{
+    curve->i32_offset = i32_offset;
+}
+
+uint32_t fan_curve_lookup(fan_curve_t *curve, int32_t i32_temp)
+{
+    /* Curve coordinates: the offset moves the input instead of every point */
+    int32_t i32_t = i32_temp - curve->i32_offset;
+    uint8_t u8_last = (uint8_t)(curve->u8_count - 1U);
+    uint8_t u8_seg = curve->u8_segment;
+
+    if (i32_t <= curve->points[0].i32_temp) {
+        return curve->points[0].u32_rpm;
+    }
+    if (i32_t >= curve->points[u8_last].i32_temp) {
+        return curve->points[u8_last].u32_rpm;
+    }
+
+    /* Inside the table: walk from the last segment, normally no step */
+    while (i32_t < curve->points[u8_seg].i32_temp) {
+        u8_seg--;
+    }
+    while (i32_t >= curve->points[u8_seg + 1U].i32_temp) {
+        u8_seg++;
+    }
+    curve->u8_segment = u8_seg;
+
+    /* Width below the next point, the product stays below 2^31 */
+    return (uint32_t)((int32_t)curve->points[u8_seg].u32_rpm +
+                      ((curve->i32_slope_q16[u8_seg] * (i32_t - curve->points[u8_seg].i32_temp)) >> 16));
+}
+
+uint32_t fan_curve_evaluate(fan_curve_t *curve, int32_t i32_temp, uint32_t u32_now_ms)
+{
+    uint32_t u32_target;
+    uint32_t u32_step;
+
+    if (!curve->u8_started) {
+        curve->u8_started    = 1U;
+        curve->i32_effective = i32_temp;
+        curve->u32_last_ms   = u32_now_ms;
+        curve->u32_output    = fan_curve_lookup(curve, i32_temp);
+        return curve->u32_output;
+    }
+
+    /* Follow rising temperatures, falling ones only beyond the hysteresis */
+    if (i32_temp > curve->i32_effective) {
+        curve->i32_effective = i32_temp;
+    } else if (i32_temp < (curve->i32_effective - curve->i32_hysteresis)) {
+        curve->i32_effective = i32_temp + curve->i32_hysteresis;
+    }
+
+    u32_target = fan_curve_lookup(curve, curve->i32_effective);
+
+    if (curve->u32_rate == 0U) {
+        curve->u32_output = u32_target;
+        return u32_target;
+    }
+
+    /* Whole RPM steps only, the rest of the time counts for the next call */
+    u32_step = (uint32_t)(((uint64_t)curve->u32_rate * (u32_now_ms - curve->u32_last_ms)) / 1000U);
+    if (u32_step == 0U) {
+        return curve->u32_output;
+    }
+    curve->u32_last_ms = u32_now_ms;
+
+    if (u32_target > curve->u32_output) {
+        curve->u32_output = ((u32_target - curve->u32_output) > u32_step) ? (curve->u32_output + u32_step)
+                                                                           : u32_target;
+    } else {
+        curve->u32_output = ((curve->u32_output - u32_target) > u32_step) ? (curve->u32_output - u32_step)
+                                                                           : u32_target;
+    }
+
+    return curve->u32_output;
+}
+
+uint32_t fan_curve_get_output(const fan_curve_t *curve)
+{
+    return curve->u32_output;
+}
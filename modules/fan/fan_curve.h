@@ -0,0 +1,128 @@
+/**
+ ******************************************************************************
+ * @file        fan_curve.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the temperature to RPM fan curve.
+ *
+ * @details
+ * Maps a temperature (0.01 C, as delivered by env_sensor) to a target
+ * RPM over a piecewise linear table. The slope of every segment is
+ * computed once by fan_curve_init(), an evaluation is one multiply and
+ * shift. The segment of the last evaluation is kept; temperatures move
+ * far less than a segment between two samples, so the search almost
+ * never takes a step. Every fan_curve_t is one curve with its own state,
+ * e.g. one per fan_t.
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - 2 .. FAN_CURVE_MAX_POINTS points, strictly rising temperatures;
+ *    below the first and above the last point their RPM holds
+ *  - Hysteresis: a rising temperature follows the curve at once, a
+ *    falling one only once it is the hysteresis below the highest value
+ *  - Rate limit of the output in RPM per second (0: none)
+ *  - Temperature offset, e.g. a start temperature from a potentiometer
+ *  - No peripheral access (also built on the host)
+ *
+ ******************************************************************************
+ */
+
+#ifndef FAN_FAN_CURVE_H_
+#define FAN_FAN_CURVE_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief Maximum number of points of one curve.
+ */
+#define FAN_CURVE_MAX_POINTS    8U
+
+/**
+ * @brief Largest RPM of a point (the Q16 slope times the segment width
+ *        stays below 2^31).
+ */
+#define FAN_CURVE_MAX_RPM       32767U
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief One point of the curve.
+ */
+typedef struct {
+    int32_t  i32_temp;          /**< Temperature in 0.01 C               */
+    uint32_t u32_rpm;           /**< Target RPM at this temperature      */
+} fan_curve_point_t;
+
+/**
+ * @brief One curve with its state.
+ */
+typedef struct {
+    fan_curve_point_t points[FAN_CURVE_MAX_POINTS];
+    int32_t  i32_slope_q16[FAN_CURVE_MAX_POINTS - 1U]; /**< RPM per 0.01 C, Q16 */
+    uint8_t  u8_count;          /**< Number of points                    */
+    uint8_t  u8_segment;        /**< Segment of the last evaluation      */
+    uint8_t  u8_started;        /**< First evaluation done               */
+    int32_t  i32_hysteresis;    /**< Hysteresis in 0.01 C                */
+    int32_t  i32_offset;        /**< Added to every point temperature    */
+    int32_t  i32_effective;     /**< Temperature after the hysteresis    */
+    uint32_t u32_rate;          /**< Rate limit in RPM per second, 0 off */
+    uint32_t u32_last_ms;       /**< Time of the last output step        */
+    uint32_t u32_output;        /**< Last returned RPM                   */
+} fan_curve_t;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Copies the points and computes the slopes.
+ *
+ * @param curve            Curve
+ * @param points           u8_count points, strictly rising temperatures,
+ *                         RPM up to FAN_CURVE_MAX_RPM
+ * @param u8_count         2 .. FAN_CURVE_MAX_POINTS
+ * @param i32_hysteresis   Hysteresis in 0.01 C (>= 0)
+ * @param u32_rate_rpm_s   Rate limit in RPM per second, 0 for none
+ * @return HAL_OK, HAL_ERROR for invalid points
+ */
+HAL_StatusTypeDef fan_curve_init(fan_curve_t *curve, const fan_curve_point_t *points, uint8_t u8_count,
+                                 int32_t i32_hysteresis, uint32_t u32_rate_rpm_s);
+
+/**
+ * @brief Shifts the whole curve along the temperature axis.
+ *
+ * @param curve      Curve
+ * @param i32_offset Offset in 0.01 C added to every point temperature
+ * @return None
+ */
+void fan_curve_set_offset(fan_curve_t *curve, int32_t i32_offset);
+
+/**
+ * @brief RPM of a temperature without hysteresis and rate limit (keeps
+ *        the segment hint).
+ *
+ * @param curve    Curve
+ * @param i32_temp Temperature in 0.01 C
+ * @return RPM
+ */
+uint32_t fan_curve_lookup(fan_curve_t *curve, int32_t i32_temp);
+
+/**
+ * @brief Evaluates the curve for a new sample with hysteresis and rate
+ *        limit. The first call after init returns the curve value.
+ *
+ * @param curve     Curve
+ * @param i32_temp  Temperature in 0.01 C
+ * @param u32_now_ms Time in ms (HAL tick)
+ * @return Target RPM
+ */
+uint32_t fan_curve_evaluate(fan_curve_t *curve, int32_t i32_temp, uint32_t u32_now_ms);
+
+/**
+ * @brief Returns the last result of fan_curve_evaluate().
+ *
+ * @param curve Curve
+ * @return RPM
+ */
+uint32_t fan_curve_get_output(const fan_curve_t *curve);
+
+#endif /* FAN_FAN_CURVE_H_ */
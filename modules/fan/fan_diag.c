@@ -0,0 +1,260 @@
+/**
+ ******************************************************************************
+ * @file        fan_diag.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Fan vibration diagnostics
+ *
+ * Functionality:
+ * - Interval and current blocks, one block transformed at a time
+ * - Radix-2 FFT in slices: bit reversal with mean removal, one stage per
+ *   slice, evaluation
+ *
+ * Resources:
+ * - None (scheduler task, reads the fan module)
+ ******************************************************************************
+ */
+
+#include "fan_diag.h"
+
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+
+#if (FAN_DIAG_LENGTH < 8U) || (FAN_DIAG_LENGTH > 1024U) || ((FAN_DIAG_LENGTH & (FAN_DIAG_LENGTH - 1U)) != 0U)
+#error "FAN_DIAG_LENGTH must be a power of two, 8..1024"
+#endif
+
+/* Preprocessor defines ---------------------------------------------------- */
+/**
+ * @brief Tacho edges per revolution (as in fan_get_rpm()).
+ */
+#define FAN_DIAG_EDGES_PER_REV  2.0f
+
+/* Static function prototypes ----------------------------------------------- */
+static void fan_diag_load(fan_diag_t *diag);
+static void fan_diag_stage(fan_diag_t *diag, uint8_t u8_stage);
+static void fan_diag_evaluate(fan_diag_t *diag);
+
+/* Public functions --------------------------------------------------------- */
+HAL_StatusTypeDef fan_diag_init(fan_diag_t *diag, fan_t *fan, uint32_t u32_rate_hz)
+{
+    fan_control_stats_t stats;
+
+    if ((diag == NULL) || (fan == NULL) || (u32_rate_hz == 0u)) {
+        return HAL_ERROR;
+    }
+
+    memset(diag, 0, sizeof(*diag));
+    diag->p_fan     = fan;
+    diag->f_rate_hz = (float)u32_rate_hz;
+
+    while ((1UL << diag->u8_stages) < FAN_DIAG_LENGTH) {
+        diag->u8_stages++;
+    }
+
+    for (uint32_t i = 0u; i < FAN_DIAG_LENGTH / 2u; i++) {
+        float f_angle = 2.0f * 3.14159265f * (float)i / (float)FAN_DIAG_LENGTH;
+
+        diag->f_cos[i] = cosf(f_angle);
+        diag->f_sin[i] = sinf(f_angle);
+    }
+
+    if (fan_get_control_stats(&stats) == HAL_OK) {
+        diag->u32_steps = stats.u32_runs;
+    }
+
+    return HAL_OK;
+}
+
+void fan_diag_add_edges(fan_diag_t *diag, const uint32_t *pu32_ts, uint32_t u32_count)
+{
+    uint16_t *pu16_fill = &diag->u16_fill[FAN_DIAG_TACHO];
+
+    for (uint32_t i = 0u; i < u32_count; i++) {
+        uint32_t u32_interval = pu32_ts[i] - diag->u32_last_ts;
+
+        diag->u32_last_ts = pu32_ts[i];
+        if (!diag->u8_has_ts) {
+            diag->u8_has_ts = 1u;
+            continue;
+        }
+
+        /* A full block waits for the transform, newer intervals are lost */
+        if (*pu16_fill >= FAN_DIAG_LENGTH) {
+            diag->u32_dropped++;
+            continue;
+        }
+        diag->f_input[FAN_DIAG_TACHO][(*pu16_fill)++] = (float)u32_interval;
+    }
+}
+
+void fan_diag_task(void *context)
+{
+    fan_diag_t *diag = (fan_diag_t *)context;
+    fan_control_stats_t stats;
+
+    /* One current sample per control step; a missed step breaks the
+       equidistant block, so it starts again */
+    if (diag->p_fan->current.u8_enabled && (fan_get_control_stats(&stats) == HAL_OK) &&
+        (stats.u32_runs != diag->u32_steps)) {
+        uint16_t *pu16_fill = &diag->u16_fill[FAN_DIAG_CURRENT];
+
+        if ((stats.u32_runs - diag->u32_steps != 1u) && (*pu16_fill < FAN_DIAG_LENGTH)) {
+            *pu16_fill = 0u;
+        }
+        diag->u32_steps = stats.u32_runs;
+
+        if (*pu16_fill < FAN_DIAG_LENGTH) {
+            diag->f_input[FAN_DIAG_CURRENT][(*pu16_fill)++] =
+                (float)fan_get_current_mv(diag->p_fan, NULL);
+        } else {
+            diag->u32_dropped++;
+        }
+    }
+
+    if (diag->u8_slice == 0u) {
+        for (uint8_t i = 0u; i < FAN_DIAG_SOURCES; i++) {
+            if (diag->u16_fill[i] >= FAN_DIAG_LENGTH) {
+                diag->u8_source = i;
+                diag->u8_slice  = 1u;
+                break;
+            }
+        }
+        return;
+    }
+
+    if (diag->u8_slice == 1u) {
+        fan_diag_load(diag);
+    } else if (diag->u8_slice <= diag->u8_stages + 1u) {
+        fan_diag_stage(diag, diag->u8_slice - 1u);
+    } else {
+        fan_diag_evaluate(diag);
+        diag->u8_slice = 0u;
+        return;
+    }
+    diag->u8_slice++;
+}
+
+HAL_StatusTypeDef fan_diag_get_result(const fan_diag_t *diag, fan_diag_source_t source,
+                                      fan_diag_result_t *result)
+{
+    if ((source >= FAN_DIAG_SOURCES) || (diag->result[source].u32_blocks == 0u)) {
+        return HAL_ERROR;
+    }
+
+    *result = diag->result[source];
+
+    return HAL_OK;
+}
+
+/* Static functions --------------------------------------------------------- */
+/**
+ * @brief First slice: moves the block without its mean to the transform
+ *        buffer in bit-reversed order and frees the input block.
+ *
+ * @param diag State
+ */
+static void fan_diag_load(fan_diag_t *diag)
+{
+    const float *pf_in = diag->f_input[diag->u8_source];
+    float f_sum = 0.0f;
+
+    for (uint32_t i = 0u; i < FAN_DIAG_LENGTH; i++) {
+        f_sum += pf_in[i];
+    }
+    diag->f_block_mean = f_sum / (float)FAN_DIAG_LENGTH;
+
+    for (uint32_t i = 0u; i < FAN_DIAG_LENGTH; i++) {
+        uint32_t u32_reversed = 0u;
+
+        for (uint8_t b = 0u; b < diag->u8_stages; b++) {
+            u32_reversed |= ((i >> b) & 1u) << (diag->u8_stages - 1u - b);
+        }
+        diag->f_re[u32_reversed] = pf_in[i] - diag->f_block_mean;
+        diag->f_im[u32_reversed] = 0.0f;
+    }
+
+    diag->u16_fill[diag->u8_source] = 0u;
+}
+
+/**
+ * @brief One radix-2 decimation-in-time stage.
+ *
+ * @param diag     State
+ * @param u8_stage 1 .. log2(FAN_DIAG_LENGTH)
+ */
+static void fan_diag_stage(fan_diag_t *diag, uint8_t u8_stage)
+{
+    uint32_t u32_span = 1UL << u8_stage;
+    uint32_t u32_half = u32_span / 2u;
+    uint32_t u32_step = FAN_DIAG_LENGTH / u32_span;
+
+    for (uint32_t k = 0u; k < FAN_DIAG_LENGTH; k += u32_span) {
+        for (uint32_t j = 0u; j < u32_half; j++) {
+            float f_wr = diag->f_cos[j * u32_step];
+            float f_wi = -diag->f_sin[j * u32_step];
+            uint32_t u32_a = k + j;
+            uint32_t u32_b = u32_a + u32_half;
+            float f_tr = f_wr * diag->f_re[u32_b] - f_wi * diag->f_im[u32_b];
+            float f_ti = f_wr * diag->f_im[u32_b] + f_wi * diag->f_re[u32_b];
+
+            diag->f_re[u32_b] = diag->f_re[u32_a] - f_tr;
+            diag->f_im[u32_b] = diag->f_im[u32_a] - f_ti;
+            diag->f_re[u32_a] += f_tr;
+            diag->f_im[u32_a] += f_ti;
+        }
+    }
+}
+
+/**
+ * @brief Last slice: amplitudes, RMS (Parseval), peak and flags.
+ *
+ * @param diag State
+ */
+static void fan_diag_evaluate(fan_diag_t *diag)
+{
+    fan_diag_result_t *result = &diag->result[diag->u8_source];
+    const uint32_t u32_nyquist = FAN_DIAG_LENGTH / 2u;
+    uint32_t u32_last = (diag->u8_source == FAN_DIAG_TACHO) ? (u32_nyquist - 1u) : u32_nyquist;
+    float f_energy = 0.0f;
+    float f_peak = 0.0f;
+    uint32_t u32_peak_bin = 0u;
+
+    for (uint32_t k = 0u; k < FAN_DIAG_LENGTH; k++) {
+        f_energy += diag->f_re[k] * diag->f_re[k] + diag->f_im[k] * diag->f_im[k];
+    }
+
+    for (uint32_t k = 1u; k <= u32_last; k++) {
+        float f_power = diag->f_re[k] * diag->f_re[k] + diag->f_im[k] * diag->f_im[k];
+
+        if (f_power > f_peak) {
+            f_peak = f_power;
+            u32_peak_bin = k;
+        }
+    }
+
+    result->f_mean = diag->f_block_mean;
+    result->f_rms  = sqrtf(f_energy) / (float)FAN_DIAG_LENGTH;
+    /* One-sided amplitude 2 |X| / N, the Nyquist bin is real: |X| / N */
+    result->f_peak = (u32_peak_bin == u32_nyquist) ? (sqrtf(f_peak) / (float)FAN_DIAG_LENGTH)
+                                                   : (2.0f * sqrtf(f_peak) / (float)FAN_DIAG_LENGTH);
+    result->u8_flags = 0u;
+
+    if (diag->u8_source == FAN_DIAG_TACHO) {
+        result->f_once    = fabsf(diag->f_re[u32_nyquist]) / (float)FAN_DIAG_LENGTH;
+        result->f_peak_at = FAN_DIAG_EDGES_PER_REV * (float)u32_peak_bin / (float)FAN_DIAG_LENGTH;
+        if (result->f_once > FAN_DIAG_IMBALANCE_RATIO * result->f_mean) {
+            result->u8_flags |= FAN_DIAG_FLAG_IMBALANCE;
+        }
+        if (result->f_rms > FAN_DIAG_ROUGH_RATIO * result->f_mean) {
+            result->u8_flags |= FAN_DIAG_FLAG_ROUGH;
+        }
+    } else {
+        result->f_once    = 0.0f;
+        result->f_peak_at = (float)u32_peak_bin * diag->f_rate_hz / (float)FAN_DIAG_LENGTH;
+    }
+
+    result->u32_blocks++;
+}
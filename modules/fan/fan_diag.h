@@ -0,0 +1,167 @@
+/**
+ ******************************************************************************
+ * @file        fan_diag.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the fan vibration diagnostics.
+ *
+ * @details
+ * Collects blocks of FAN_DIAG_LENGTH tacho intervals and current samples
+ * and looks at their spectrum for signs of wear: a rotor that is out of
+ * balance or a magnet ring that is not centred modulates the speed once
+ * per revolution, a rough bearing raises the interval jitter and shows
+ * as peaks at non-integer orders.
+ *
+ * The interval block is sampled per tacho edge, i.e. in the order domain
+ * (two edges per revolution): bin k is 2 * k / FAN_DIAG_LENGTH cycles
+ * per revolution, the last bin (FAN_DIAG_LENGTH / 2) is one per
+ * revolution. The current block is sampled once per control step (mean
+ * of the PWM-synchronous injected samples, see fan_current_enable()),
+ * bin k is k * rate / FAN_DIAG_LENGTH Hz.
+ *
+ * fan_diag_task() is a scheduler task for the lowest priority: every run
+ * does one slice of a block (mean removal and bit reversal, one radix-2
+ * stage, or the evaluation), a few microseconds each. The control step
+ * runs in the TIM6 interrupt and is never delayed by it. The FFT is a
+ * plain complex radix-2 transform in float (FPU), no DSP library.
+ *
+ * Example (P1 main loop, next to the USB tacho stream):
+ *
+ *     fan_diag_init(&diag, fan_get_default(), FAN_CONTROL_DEFAULT_RATE_HZ);
+ *     sched_add(fan_diag_task, &diag, 5u, SCHED_PRIORITY_LOWEST, NULL);
+ *     ...
+ *     n = fan_read_edges(fan, &cursor, ts, 16u);
+ *     fan_diag_add_edges(&diag, ts, n);
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - Blocks of tacho intervals (given edge time stamps) and per-step
+ *    current means
+ *  - FFT split into slices for a cooperative scheduler task
+ *  - Per block: RMS, once-per-revolution amplitude, strongest other bin,
+ *    imbalance and roughness flags
+ *
+ ******************************************************************************
+ */
+
+#ifndef FAN_FAN_DIAG_H_
+#define FAN_FAN_DIAG_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "fan/fan.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief Samples per block (power of two, 8..1024).
+ */
+#define FAN_DIAG_LENGTH              128U
+
+/**
+ * @brief Imbalance: once-per-revolution amplitude of the intervals above
+ *        this share of the mean interval.
+ */
+#define FAN_DIAG_IMBALANCE_RATIO     0.01f
+
+/**
+ * @brief Roughness: interval RMS above this share of the mean interval.
+ */
+#define FAN_DIAG_ROUGH_RATIO         0.02f
+
+/**
+ * @brief Result flags.
+ */
+#define FAN_DIAG_FLAG_IMBALANCE      0x01U
+#define FAN_DIAG_FLAG_ROUGH          0x02U
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Block sources.
+ */
+typedef enum {
+    FAN_DIAG_TACHO = 0,    /**< Intervals in us, order domain             */
+    FAN_DIAG_CURRENT,      /**< Current sense in mV, control rate         */
+    FAN_DIAG_SOURCES
+} fan_diag_source_t;
+
+/**
+ * @brief Evaluation of the last block of one source.
+ */
+typedef struct {
+    uint32_t u32_blocks;   /**< Evaluated blocks                          */
+    float    f_mean;       /**< Block mean (us or mV)                     */
+    float    f_rms;        /**< RMS without the mean                      */
+    float    f_once;       /**< Amplitude at one cycle per revolution
+                                (tacho only)                              */
+    float    f_peak;       /**< Amplitude of the strongest other bin      */
+    float    f_peak_at;    /**< Its frequency: cycles per revolution
+                                (tacho) or Hz (current)                   */
+    uint8_t  u8_flags;     /**< FAN_DIAG_FLAG_*                           */
+} fan_diag_result_t;
+
+/**
+ * @brief Diagnostics state of one fan. Allocated by the application.
+ */
+typedef struct {
+    fan_t   *p_fan;
+    float    f_rate_hz;                      /**< Control rate              */
+    float    f_input[FAN_DIAG_SOURCES][FAN_DIAG_LENGTH];
+    uint16_t u16_fill[FAN_DIAG_SOURCES];
+    float    f_re[FAN_DIAG_LENGTH];          /**< Block being transformed   */
+    float    f_im[FAN_DIAG_LENGTH];
+    float    f_cos[FAN_DIAG_LENGTH / 2U];    /**< Twiddle factors           */
+    float    f_sin[FAN_DIAG_LENGTH / 2U];
+    float    f_block_mean;
+    uint32_t u32_last_ts;                    /**< Newest edge time stamp    */
+    uint32_t u32_steps;                      /**< Control steps seen        */
+    uint32_t u32_dropped;                    /**< Samples lost while busy   */
+    uint8_t  u8_has_ts;
+    uint8_t  u8_stages;                      /**< log2(FAN_DIAG_LENGTH)     */
+    uint8_t  u8_source;                      /**< Source being transformed  */
+    uint8_t  u8_slice;                       /**< 0: idle, then the slices  */
+    fan_diag_result_t result[FAN_DIAG_SOURCES];
+} fan_diag_t;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Initializes the diagnostics of one fan.
+ *
+ * @param diag        State
+ * @param fan         Instance (fan_init() done)
+ * @param u32_rate_hz Control rate (fan_control_start())
+ * @return HAL_OK, HAL_ERROR for a NULL instance or rate 0
+ */
+HAL_StatusTypeDef fan_diag_init(fan_diag_t *diag, fan_t *fan, uint32_t u32_rate_hz);
+
+/**
+ * @brief Adds tacho edge time stamps (oldest first, e.g. from
+ *        fan_read_edges()); consecutive ones give the intervals.
+ *
+ * @param diag      State
+ * @param pu32_ts   TIM2 time stamps in us
+ * @param u32_count Number of time stamps
+ * @return None
+ */
+void fan_diag_add_edges(fan_diag_t *diag, const uint32_t *pu32_ts, uint32_t u32_count);
+
+/**
+ * @brief Scheduler task: takes the current mean of a new control step
+ *        and runs one slice of a full block.
+ *
+ * @param context State (fan_diag_t *)
+ * @return None
+ */
+void fan_diag_task(void *context);
+
+/**
+ * @brief Copies the evaluation of the last block of a source.
+ *
+ * @param diag   State
+ * @param source FAN_DIAG_TACHO or FAN_DIAG_CURRENT
+ * @param result Destination
+ * @return HAL_OK, HAL_ERROR for an invalid source or no block yet
+ */
+HAL_StatusTypeDef fan_diag_get_result(const fan_diag_t *diag, fan_diag_source_t source,
+                                      fan_diag_result_t *result);
+
+#endif /* FAN_FAN_DIAG_H_ */
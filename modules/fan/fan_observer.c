@@ -0,0 +1,76 @@
+/**
+ ******************************************************************************
+ * @file        fan_observer.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Fan speed observer
+ *
+ * Functionality:
+ * - First order model prediction in Q8 RPM
+ * - Alpha-beta correction of estimate and model bias
+ *
+ * Resources:
+ * - None (pure computation, also built on the host)
+ ******************************************************************************
+ */
+
+#include "fan_observer.h"
+
+/* Preprocessor defines ---------------------------------------------------- */
+/**
+ * @brief Estimate limits in RPM, Q8 (no negative speed, 16 bit RPM).
+ */
+#define FAN_OBSERVER_MAX_Q8  (65535 << 8)
+
+/**
+ * @brief Product of a Q16 gain and a Q8 difference, back to Q8. The
+ *        difference can use the full 32 bit, so the product is 64 bit.
+ */
+#define FAN_OBSERVER_MUL(gain_q16, value_q8) \
+    ((int32_t)(((int64_t)(gain_q16) * (int64_t)(value_q8)) >> 16))
+
+/* Public functions --------------------------------------------------------- */
+void fan_observer_reset(fan_observer_state_t *state, int32_t i32_rpm)
+{
+    state->i32_rpm_q8  = i32_rpm << 8;
+    state->i32_bias_q8 = 0;
+}
+
+int32_t fan_observer_predict(fan_observer_state_t *state, const fan_observer_params_t *params,
+                             int32_t i32_model_rpm)
+{
+    int32_t i32_rpm_q8 = state->i32_rpm_q8;
+
+    i32_rpm_q8 += FAN_OBSERVER_MUL(params->i32_ta_tau_q16, (i32_model_rpm << 8) - i32_rpm_q8);
+    i32_rpm_q8 += state->i32_bias_q8;
+
+    if (i32_rpm_q8 < 0) {
+        i32_rpm_q8 = 0;
+    } else if (i32_rpm_q8 > FAN_OBSERVER_MAX_Q8) {
+        i32_rpm_q8 = FAN_OBSERVER_MAX_Q8;
+    }
+    state->i32_rpm_q8 = i32_rpm_q8;
+
+    return i32_rpm_q8 >> 8;
+}
+
+int32_t fan_observer_correct(fan_observer_state_t *state, const fan_observer_params_t *params,
+                             int32_t i32_measured)
+{
+    int32_t i32_error_q8;
+
+    if (i32_measured > (FAN_OBSERVER_MAX_Q8 >> 8)) {
+        i32_measured = FAN_OBSERVER_MAX_Q8 >> 8;
+    }
+    i32_error_q8 = (i32_measured << 8) - state->i32_rpm_q8;
+
+    state->i32_rpm_q8  += FAN_OBSERVER_MUL(params->i32_alpha_q16, i32_error_q8);
+    state->i32_bias_q8 += FAN_OBSERVER_MUL(params->i32_beta_q16, i32_error_q8);
+
+    if (state->i32_rpm_q8 < 0) {
+        state->i32_rpm_q8 = 0;
+    }
+
+    return state->i32_rpm_q8 >> 8;
+}
@@ -0,0 +1,91 @@
+/**
+ ******************************************************************************
+ * @file        fan_observer.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the fan speed observer.
+ *
+ * @details
+ * At low speed a fan gives only a few tacho edges per control period and
+ * the RPM pipeline (mean over FAN_RPM_EDGES periods, median, 4:1
+ * smoothing) lags behind. The observer runs a first order model of the
+ * fan every control step, driven by the commanded duty:
+ *
+ *     x += Ta / tau * (rpm_model(u) - x) + b
+ *
+ * and corrects it with every new tacho period y (alpha-beta form):
+ *
+ *     x += alpha * (y - x),   b += beta * (y - x)
+ *
+ * The bias b (RPM per step) absorbs the error of the static model
+ * rpm_model(u) (feed-forward table or linear up to the maximum RPM), so
+ * the estimate follows the fan between edges without a steady offset.
+ * Integer arithmetic (RPM in Q8, gains in Q16), usable with the fixed
+ * point controller; also built on the host.
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - Model prediction per control step from the commanded duty
+ *  - Alpha-beta correction per tacho measurement, model bias estimate
+ *
+ ******************************************************************************
+ */
+
+#ifndef FAN_FAN_OBSERVER_H_
+#define FAN_FAN_OBSERVER_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Parameters of the observer.
+ */
+typedef struct {
+    int32_t i32_ta_tau_q16; /**< Ta / tau, Q16 (0..65536)                  */
+    int32_t i32_alpha_q16;  /**< Estimate correction, Q16 (0..65536)       */
+    int32_t i32_beta_q16;   /**< Bias correction, Q16 (0..65536)           */
+} fan_observer_params_t;
+
+/**
+ * @brief State of the observer.
+ */
+typedef struct {
+    int32_t i32_rpm_q8;     /**< Estimated RPM, Q8                         */
+    int32_t i32_bias_q8;    /**< Model bias in RPM per step, Q8            */
+} fan_observer_state_t;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Sets the estimate to a known RPM and clears the bias.
+ *
+ * @param state   State
+ * @param i32_rpm RPM
+ * @return None
+ */
+void fan_observer_reset(fan_observer_state_t *state, int32_t i32_rpm);
+
+/**
+ * @brief Advances the estimate by one control step.
+ *
+ * @param state         State, updated
+ * @param params        Parameters
+ * @param i32_model_rpm Steady state RPM of the commanded duty
+ * @return Estimated RPM
+ */
+int32_t fan_observer_predict(fan_observer_state_t *state, const fan_observer_params_t *params,
+                             int32_t i32_model_rpm);
+
+/**
+ * @brief Corrects the estimate with a measured RPM.
+ *
+ * @param state        State, updated
+ * @param params       Parameters
+ * @param i32_measured Measured RPM (one tacho period or mean of several)
+ * @return Estimated RPM
+ */
+int32_t fan_observer_correct(fan_observer_state_t *state, const fan_observer_params_t *params,
+                             int32_t i32_measured);
+
+#endif /* FAN_FAN_OBSERVER_H_ */
@@ -0,0 +1,110 @@
+/**
+ ******************************************************************************
+ * @file        fan_pi.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Fan PI(D) controller step
+ *
+ * Functionality:
+ * - PI(D) step in Q16 counts (__QADD) or float percent
+ * - Clamping and slew limiting of the output
+ * - Back-calculation of the integral from the limited output
+ *
+ * Resources:
+ * - None (pure computation, also built on the host)
+ ******************************************************************************
+ */
+
+#include "fan_pi.h"
+#include "utils/utils.h"
+
+/* Preprocessor defines ---------------------------------------------------- */
+/**
+ * @brief Limit of the back-calculation difference in counts, keeps
+ *        Kt * Ta (Q16, <= 65536) times the difference inside 32 bit.
+ */
+#define FAN_PI_TRACK_LIMIT  32767
+
+/* Public functions --------------------------------------------------------- */
+UTILS_RAMFUNC int32_t fan_pi_step_q16(fan_pi_q16_state_t *state, const fan_pi_q16_t *pi,
+                                      int32_t i32_target, int32_t i32_rpm, int32_t i32_ff)
+{
+    int32_t i32_error = i32_target - i32_rpm;
+    int32_t i32_pid_q16;
+    int32_t i32_raw;
+    int32_t i32_output;
+
+    /* FF + P + I - D(measurement) in Q16 counts, saturating instead of wrapping */
+    i32_pid_q16 = __QADD(pi->i32_kp_q16 * i32_error, state->i32_integral_q16);
+    if (pi->i32_kd_ta_q16 != 0) {
+        i32_pid_q16 = __QSUB(i32_pid_q16, pi->i32_kd_ta_q16 * (i32_rpm - state->i32_last_rpm));
+    }
+    state->i32_last_rpm = i32_rpm;
+    i32_raw = (i32_pid_q16 >> 16) + i32_ff;
+
+    i32_output = i32_raw;
+    if (i32_output > pi->i32_full) {
+        i32_output = pi->i32_full;
+    } else if (i32_output < 0) {
+        i32_output = 0;
+    }
+    if (pi->i32_slew != 0) {
+        if (i32_output > state->i32_output + pi->i32_slew) {
+            i32_output = state->i32_output + pi->i32_slew;
+        } else if (i32_output < state->i32_output - pi->i32_slew) {
+            i32_output = state->i32_output - pi->i32_slew;
+        }
+    }
+    state->i32_output       = i32_output;
+    state->i32_fraction_q16 = (i32_output == i32_raw) ? (i32_pid_q16 & 0xFFFF) : 0;
+
+    if (pi->i32_kt_ta_q16 != 0) {
+        int32_t i32_track = i32_output - i32_raw;
+
+        if (i32_track > FAN_PI_TRACK_LIMIT) {
+            i32_track = FAN_PI_TRACK_LIMIT;
+        } else if (i32_track < -FAN_PI_TRACK_LIMIT) {
+            i32_track = -FAN_PI_TRACK_LIMIT;
+        }
+        state->i32_integral_q16 = __QADD(__QADD(state->i32_integral_q16, pi->i32_ki_ta_q16 * i32_error),
+                                         pi->i32_kt_ta_q16 * i32_track);
+    } else if (i32_output == i32_raw) {
+        state->i32_integral_q16 = __QADD(state->i32_integral_q16, pi->i32_ki_ta_q16 * i32_error);
+    }
+
+    return i32_output;
+}
+
+UTILS_RAMFUNC float fan_pi_step_float(fan_pi_float_state_t *state, const fan_pi_float_t *pi,
+                                      float f_target, float f_rpm, float f_ff)
+{
+    float f_error  = f_target - f_rpm;
+    float f_raw    = pi->f_kp * f_error + state->f_integral + f_ff -
+                     pi->f_kd_ta * (f_rpm - state->f_last_rpm);
+    float f_output = f_raw;
+
+    state->f_last_rpm = f_rpm;
+
+    if (f_output > 100.0f) {
+        f_output = 100.0f;
+    } else if (f_output < 0.0f) {
+        f_output = 0.0f;
+    }
+    if (pi->f_slew > 0.0f) {
+        if (f_output > state->f_output + pi->f_slew) {
+            f_output = state->f_output + pi->f_slew;
+        } else if (f_output < state->f_output - pi->f_slew) {
+            f_output = state->f_output - pi->f_slew;
+        }
+    }
+    state->f_output = f_output;
+
+    if (pi->f_kt_ta > 0.0f) {
+        state->f_integral += pi->f_ki_ta * f_error + pi->f_kt_ta * (f_output - f_raw);
+    } else if (f_output == f_raw) {
+        state->f_integral += pi->f_ki_ta * f_error;
+    }
+
+    return f_output;
+}
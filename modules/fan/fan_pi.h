@@ -0,0 +1,116 @@
+/**
+ ******************************************************************************
+ * @file        fan_pi.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the fan PI(D) controller step.
+ *
+ * @details
+ * The arithmetic of one controller step without any peripheral access:
+ * setpoint and measurement in, actuator value out. fan_update() feeds
+ * the measured RPM in and writes the result to the PWM compare register;
+ * the host build (host/) runs the same code on recorded RPM traces.
+ *
+ * The sum v = P + I + D + FF gives the output u: clamped to 0..100 %, then
+ * limited to a slew per step around the previous output. Anti-windup
+ * is either conditional integration (Kt = 0: no integration while the
+ * output is limited) or back-calculation: the integral gets
+ * Kt * Ta * (u - v) besides Ki * Ta * e, so during saturation (or while
+ * the slew limit holds the output) it is pulled towards the value that
+ * just reaches the limit instead of staying wherever it was when the
+ * limit was hit. D acts on the measurement, not the error: a setpoint
+ * step from the potentiometer gives no derivative kick. Kd = 0 is a PI.
+ *
+ * The parameters are stored as products with the sample time (Ki * Ta,
+ * Kd / Ta, Kt * Ta, slew per step), so a step needs no division.
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - Q16 fixed point step in compare counts, saturating additions
+ *  - Float step in percent duty
+ *  - Back-calculation anti-windup (or conditional integration)
+ *  - Output slew limit per step, derivative on measurement
+ *
+ ******************************************************************************
+ */
+
+#ifndef FAN_FAN_PI_H_
+#define FAN_FAN_PI_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Parameters of the fixed point step, in compare counts.
+ */
+typedef struct {
+    int32_t i32_kp_q16;     /**< Kp in counts per RPM, Q16                 */
+    int32_t i32_ki_ta_q16;  /**< Ki * Ta in counts per RPM, Q16            */
+    int32_t i32_kd_ta_q16;  /**< Kd / Ta in counts per RPM, Q16, 0: PI     */
+    int32_t i32_kt_ta_q16;  /**< Kt * Ta, Q16 (0..65536), 0: conditional   */
+    int32_t i32_slew;       /**< Output change per step in counts, 0: off  */
+    int32_t i32_full;       /**< Compare value of 100 % duty               */
+} fan_pi_q16_t;
+
+/**
+ * @brief State of the fixed point step.
+ */
+typedef struct {
+    int32_t i32_integral_q16; /**< Integral term in counts, Q16            */
+    int32_t i32_last_rpm;     /**< Measurement of the previous step        */
+    int32_t i32_output;       /**< Output of the previous step in counts   */
+    int32_t i32_fraction_q16; /**< Part of the output below one count, Q16
+                                   (0 while limited), for dithering        */
+} fan_pi_q16_state_t;
+
+/**
+ * @brief Parameters of the float step, in percent duty.
+ */
+typedef struct {
+    float f_kp;             /**< % per RPM                                 */
+    float f_ki_ta;          /**< Ki * Ta in % per RPM                      */
+    float f_kd_ta;          /**< Kd / Ta in % per RPM, 0: PI               */
+    float f_kt_ta;          /**< Kt * Ta (0..1), 0: conditional            */
+    float f_slew;           /**< Output change per step in %, 0: off       */
+} fan_pi_float_t;
+
+/**
+ * @brief State of the float step.
+ */
+typedef struct {
+    float f_integral;       /**< Integral term in %                        */
+    float f_last_rpm;       /**< Measurement of the previous step          */
+    float f_output;         /**< Output of the previous step in %          */
+} fan_pi_float_state_t;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief One fixed point step.
+ *
+ * @param state      State, updated (i32_output: previous output, e.g.
+ *                   the compare register before the step)
+ * @param pi         Parameters
+ * @param i32_target Target RPM
+ * @param i32_rpm    Measured RPM
+ * @param i32_ff     Feed-forward in counts
+ * @return Compare value 0 .. i32_full
+ */
+int32_t fan_pi_step_q16(fan_pi_q16_state_t *state, const fan_pi_q16_t *pi,
+                        int32_t i32_target, int32_t i32_rpm, int32_t i32_ff);
+
+/**
+ * @brief One float step.
+ *
+ * @param state    State, updated (f_output: previous output)
+ * @param pi       Parameters
+ * @param f_target Target RPM
+ * @param f_rpm    Measured RPM
+ * @param f_ff     Feed-forward in %
+ * @return Duty 0.0 .. 100.0 %
+ */
+float fan_pi_step_float(fan_pi_float_state_t *state, const fan_pi_float_t *pi,
+                        float f_target, float f_rpm, float f_ff);
+
+#endif /* FAN_FAN_PI_H_ */
@@ -0,0 +1,155 @@
+/**
+ ******************************************************************************
+ * @file        fan_step.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Fan step-response rig
+ *
+ * Functionality:
+ * - Rise time, overshoot, settling time and IAE of a recorded step
+ * - Script sequencing on top of the fan RPM recording
+ *
+ * Resources:
+ * - None (fan module recording, task context)
+ ******************************************************************************
+ */
+
+#include "fan_step.h"
+
+#include <stddef.h>
+
+/* Static function prototypes ----------------------------------------------- */
+static void fan_step_rig_begin(fan_step_rig_t *rig);
+
+/* Public functions --------------------------------------------------------- */
+HAL_StatusTypeDef fan_step_evaluate(const uint16_t *pu16_rpm, uint32_t u32_count, uint32_t u32_rate_hz,
+                                    uint32_t u32_target, fan_step_metrics_t *metrics)
+{
+    int32_t i32_from = (int32_t)pu16_rpm[0];
+    int32_t i32_to = (int32_t)u32_target;
+    int32_t i32_step = i32_to - i32_from;
+    int32_t i32_size = (i32_step < 0) ? -i32_step : i32_step;
+    int32_t i32_dir = (i32_step < 0) ? -1 : 1;
+    int32_t i32_band = i32_size * (int32_t)FAN_STEP_SETTLE_PERCENT / 100;
+    int32_t i32_peak = 0;
+    uint32_t u32_rise_start = UINT32_MAX;
+    uint32_t u32_rise_end = UINT32_MAX;
+    uint32_t u32_outside = 0u;
+    uint64_t u64_iae = 0u;
+
+    if ((u32_count < 2u) || (u32_rate_hz == 0u) || (i32_size == 0)) {
+        return HAL_ERROR;
+    }
+    if (i32_band < (int32_t)FAN_STEP_SETTLE_MIN_RPM) {
+        i32_band = (int32_t)FAN_STEP_SETTLE_MIN_RPM;
+    }
+
+    for (uint32_t i = 0u; i < u32_count; i++) {
+        /* Progress along the step direction, 0 at the start, size at the target */
+        int32_t i32_progress = ((int32_t)pu16_rpm[i] - i32_from) * i32_dir;
+        int32_t i32_error = i32_to - (int32_t)pu16_rpm[i];
+
+        if ((u32_rise_start == UINT32_MAX) && (10 * i32_progress >= i32_size)) {
+            u32_rise_start = i;
+        }
+        if ((u32_rise_end == UINT32_MAX) && (10 * i32_progress >= 9 * i32_size)) {
+            u32_rise_end = i;
+        }
+        if (i32_progress - i32_size > i32_peak) {
+            i32_peak = i32_progress - i32_size;
+        }
+        if ((i32_error > i32_band) || (i32_error < -i32_band)) {
+            u32_outside = i + 1u;
+        }
+        u64_iae += (uint32_t)((i32_error < 0) ? -i32_error : i32_error);
+    }
+
+    metrics->u32_from_rpm  = (uint32_t)i32_from;
+    metrics->u32_to_rpm    = u32_target;
+    metrics->u32_rise_ms   = (u32_rise_end == UINT32_MAX) ? 0u
+                             : (u32_rise_end - u32_rise_start) * 1000u / u32_rate_hz;
+    metrics->u32_settle_ms = u32_outside * 1000u / u32_rate_hz;
+    metrics->u32_overshoot_permille = (uint32_t)(i32_peak * 1000 / i32_size);
+    metrics->u32_iae       = (uint32_t)(u64_iae / u32_rate_hz);
+    metrics->u8_settled    = (u32_outside < u32_count) ? 1u : 0u;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef fan_step_rig_start(fan_step_rig_t *rig, fan_t *fan, const fan_step_point_t *script,
+                                     uint8_t u8_steps, uint32_t u32_rate_hz,
+                                     fan_step_report_t report, void *context)
+{
+    if ((rig == NULL) || (fan == NULL) || (script == NULL) || (u8_steps == 0u) || (u32_rate_hz == 0u)) {
+        return HAL_ERROR;
+    }
+    if (rig->u8_running) {
+        return HAL_BUSY;
+    }
+
+    rig->p_fan       = fan;
+    rig->p_script    = script;
+    rig->u8_steps    = u8_steps;
+    rig->u8_index    = 0u;
+    rig->u32_rate_hz = u32_rate_hz;
+    rig->report      = report;
+    rig->p_context   = context;
+    rig->u8_running  = 1u;
+    fan_step_rig_begin(rig);
+
+    return HAL_OK;
+}
+
+uint8_t fan_step_rig_poll(fan_step_rig_t *rig)
+{
+    fan_step_metrics_t metrics;
+
+    if (!rig->u8_running) {
+        return 0u;
+    }
+    if (fan_record_get_count(rig->p_fan) < rig->u32_samples) {
+        return 1u;
+    }
+
+    if ((fan_step_evaluate(rig->u16_record, rig->u32_samples, rig->u32_rate_hz,
+                           rig->p_script[rig->u8_index].u32_target_rpm, &metrics) == HAL_OK) &&
+        (rig->report != NULL)) {
+        rig->report(rig->u8_index, &metrics, rig->p_context);
+    }
+
+    if (++rig->u8_index >= rig->u8_steps) {
+        rig->u8_running = 0u;
+        return 0u;
+    }
+    fan_step_rig_begin(rig);
+
+    return 1u;
+}
+
+void fan_step_rig_stop(fan_step_rig_t *rig)
+{
+    rig->u8_running = 0u;
+}
+
+/* Static functions --------------------------------------------------------- */
+/**
+ * @brief Starts the recording of the current step and sets its target.
+ *
+ * @param rig State
+ */
+static void fan_step_rig_begin(fan_step_rig_t *rig)
+{
+    const fan_step_point_t *point = &rig->p_script[rig->u8_index];
+    uint32_t u32_samples = point->u32_hold_ms * rig->u32_rate_hz / 1000u;
+
+    if (u32_samples < 2u) {
+        u32_samples = 2u;
+    } else if (u32_samples > FAN_STEP_MAX_SAMPLES) {
+        u32_samples = FAN_STEP_MAX_SAMPLES;
+    }
+    rig->u32_samples = u32_samples;
+
+    (void)fan_record_start(rig->p_fan, rig->u16_record, u32_samples);
+    fan_set_target_rpm(rig->p_fan, point->u32_target_rpm);
+}
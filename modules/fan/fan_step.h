@@ -0,0 +1,144 @@
+/**
+ ******************************************************************************
+ * @file        fan_step.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the fan step-response rig.
+ *
+ * @details
+ * Replaces judging a tuning change by watching the RPM on the LCD: the
+ * rig runs a script of setpoint steps, records the RPM of every control
+ * step into RAM (fan_record_start()) and computes per step
+ *
+ *  - rise time:     10 % to 90 % of the step,
+ *  - overshoot:     largest excursion beyond the target in permille of
+ *                   the step,
+ *  - settling time: from the step to the last sample outside the band of
+ *                   FAN_STEP_SETTLE_PERCENT (at least FAN_STEP_SETTLE_MIN_RPM),
+ *  - IAE:           integral of |target - RPM| in RPM * s.
+ *
+ * The step starts at the RPM measured in its first sample, so a step
+ * from a not yet settled operating point is still measured correctly.
+ * fan_step_evaluate() is plain computation (also for recorded traces on
+ * the host); the rig calls a report function per step, e.g. to send the
+ * numbers over the telemetry UART.
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - Step metrics from a fixed-rate RPM record
+ *  - Script of (target, hold time) steps, polled from a task
+ *
+ ******************************************************************************
+ */
+
+#ifndef FAN_FAN_STEP_H_
+#define FAN_FAN_STEP_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "fan/fan.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief Record length of one step (20 s at 50 Hz).
+ */
+#define FAN_STEP_MAX_SAMPLES         1024U
+
+/**
+ * @brief Settling band in % of the step and its minimum in RPM (tacho
+ *        resolution at low speed).
+ */
+#define FAN_STEP_SETTLE_PERCENT      5U
+#define FAN_STEP_SETTLE_MIN_RPM      20U
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief One step of a script.
+ */
+typedef struct {
+    uint32_t u32_target_rpm;
+    uint32_t u32_hold_ms;       /**< Recording time of the step           */
+} fan_step_point_t;
+
+/**
+ * @brief Metrics of one step response.
+ */
+typedef struct {
+    uint32_t u32_from_rpm;      /**< RPM of the first sample               */
+    uint32_t u32_to_rpm;        /**< Target                                */
+    uint32_t u32_rise_ms;       /**< 10 % .. 90 %, 0 if 90 % not reached   */
+    uint32_t u32_settle_ms;     /**< Until the band is kept                */
+    uint32_t u32_overshoot_permille; /**< Of the step size                 */
+    uint32_t u32_iae;           /**< Integral of |error| in RPM * s        */
+    uint8_t  u8_settled;        /**< 1 if the record ends inside the band  */
+} fan_step_metrics_t;
+
+/**
+ * @brief Per-step report of the rig (task context).
+ */
+typedef void (*fan_step_report_t)(uint8_t u8_step, const fan_step_metrics_t *metrics, void *context);
+
+/**
+ * @brief State of the rig.
+ */
+typedef struct {
+    fan_t                  *p_fan;
+    const fan_step_point_t *p_script;
+    uint8_t                 u8_steps;
+    uint8_t                 u8_index;   /**< Step being recorded           */
+    volatile uint8_t        u8_running;
+    uint32_t                u32_rate_hz;
+    uint32_t                u32_samples; /**< Samples of the current step  */
+    fan_step_report_t       report;
+    void                   *p_context;
+    uint16_t                u16_record[FAN_STEP_MAX_SAMPLES];
+} fan_step_rig_t;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Computes the metrics of one step response.
+ *
+ * @param pu16_rpm     RPM at a fixed rate, the first sample at the step
+ * @param u32_count    Samples
+ * @param u32_rate_hz  Sample rate
+ * @param u32_target   Target RPM of the step
+ * @param metrics      Result
+ * @return HAL_OK, HAL_ERROR for fewer than 2 samples, rate 0 or no step
+ */
+HAL_StatusTypeDef fan_step_evaluate(const uint16_t *pu16_rpm, uint32_t u32_count, uint32_t u32_rate_hz,
+                                    uint32_t u32_target, fan_step_metrics_t *metrics);
+
+/**
+ * @brief Starts a script: sets the first target and records.
+ *
+ * @param rig         State
+ * @param fan         Instance under control (fan_control_start() done)
+ * @param script      Steps, kept by the caller during the run
+ * @param u8_steps    Number of steps
+ * @param u32_rate_hz Control rate
+ * @param report      Called after every step, NULL for none
+ * @param context     Passed to report
+ * @return HAL_OK, HAL_BUSY if running, HAL_ERROR for invalid arguments
+ */
+HAL_StatusTypeDef fan_step_rig_start(fan_step_rig_t *rig, fan_t *fan, const fan_step_point_t *script,
+                                     uint8_t u8_steps, uint32_t u32_rate_hz,
+                                     fan_step_report_t report, void *context);
+
+/**
+ * @brief Evaluates a completed step and starts the next one. Call from
+ *        a task (any rate, the recording runs at the control rate).
+ *
+ * @param rig State
+ * @return 1 while the script runs, 0 when done or not started
+ */
+uint8_t fan_step_rig_poll(fan_step_rig_t *rig);
+
+/**
+ * @brief Stops the script; the fan keeps the last target.
+ *
+ * @param rig State
+ * @return None
+ */
+void fan_step_rig_stop(fan_step_rig_t *rig);
+
+#endif /* FAN_FAN_STEP_H_ */
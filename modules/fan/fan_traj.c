@@ -0,0 +1,161 @@
+/**
+ ******************************************************************************
+ * @file        fan_traj.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Jerk limited setpoint trajectory
+ *
+ * Functionality:
+ * - Decisions in the frame of the remaining distance (target ahead =
+ *   positive), the state is mirrored in and out
+ * - Braking distance: jerk -J to the peak deceleration ap, hold ap,
+ *   jerk +J to rest; ap from v + (a^2 - 2 ap^2) / (2 J) - ap t2 = 0
+ *
+ * Resources:
+ * - None (pure computation, also built on the host)
+ ******************************************************************************
+ */
+
+#include "fan_traj.h"
+#include <float.h>
+#include <math.h>
+
+/* Preprocessor defines ---------------------------------------------------- */
+/**
+ * @brief Distance to the target in RPM below which a setpoint at rest
+ *        snaps to it.
+ */
+#define FAN_TRAJ_SNAP_RPM   1.0f
+
+/* Private Type Definitions ------------------------------------------------- */
+/**
+ * @brief Distance, rate and acceleration after a constant jerk phase.
+ */
+typedef struct {
+    float f_x;
+    float f_v;
+    float f_a;
+} fan_traj_motion_t;
+
+/* Static function prototypes ----------------------------------------------- */
+static fan_traj_motion_t fan_traj_advance(float f_v, float f_a, float f_j, float f_t);
+static float fan_traj_stop_distance(float f_v, float f_a, float f_accel, float f_jerk);
+
+/* Public functions --------------------------------------------------------- */
+void fan_traj_reset(fan_traj_state_t *state, float f_rpm)
+{
+    state->f_rpm   = f_rpm;
+    state->f_rate  = 0.0f;
+    state->f_accel = 0.0f;
+}
+
+float fan_traj_step(fan_traj_state_t *state, const fan_traj_params_t *params, float f_target)
+{
+    float f_jerk  = params->f_jerk;
+    float f_accel = params->f_accel;
+    float f_ta    = params->f_ta;
+    float f_rate  = (params->f_rate > 0.0f) ? params->f_rate : FLT_MAX;
+    float f_sign  = (f_target >= state->f_rpm) ? 1.0f : -1.0f;
+    float f_dist  = (f_target - state->f_rpm) * f_sign;
+    float f_v     = state->f_rate * f_sign;
+    float f_a     = state->f_accel * f_sign;
+    float f_j;
+    fan_traj_motion_t next;
+
+    if ((f_jerk <= 0.0f) || (f_accel <= 0.0f) || (f_ta <= 0.0f)) {
+        fan_traj_reset(state, f_target);
+        return f_target;
+    }
+
+    /* Accelerate, or level off where the rate reaches its limit */
+    f_j = ((f_v + f_a * fabsf(f_a) / (2.0f * f_jerk)) < f_rate) ? f_accel : 0.0f;
+    f_j = fminf(f_jerk, fmaxf(-f_jerk, (f_j - f_a) / f_ta));
+    next = fan_traj_advance(f_v, f_a, f_j, f_ta);
+
+    if (fan_traj_stop_distance(next.f_v, next.f_a, f_accel, f_jerk) > f_dist - next.f_x) {
+        if ((f_a < 0.0f) && (f_v <= f_a * f_a / (2.0f * f_jerk))) {
+            /* Last phase: acceleration and rate reach 0 together */
+            f_j = fminf(f_jerk, -f_a / f_ta);
+        } else {
+            float f_peak = sqrtf(fmaxf(f_jerk * f_v + 0.5f * f_a * f_a, 0.0f));
+
+            f_j = fminf(f_jerk, fmaxf(-f_jerk, (-fminf(f_accel, f_peak) - f_a) / f_ta));
+        }
+        next = fan_traj_advance(f_v, f_a, f_j, f_ta);
+    }
+
+    state->f_rpm  += next.f_x * f_sign;
+    state->f_rate  = next.f_v * f_sign;
+    state->f_accel = next.f_a * f_sign;
+
+    if ((fabsf(f_target - state->f_rpm) < FAN_TRAJ_SNAP_RPM) &&
+        (fabsf(state->f_rate) < 2.0f * f_jerk * f_ta * f_ta) &&
+        (fabsf(state->f_accel) <= 1.01f * f_jerk * f_ta)) {
+        fan_traj_reset(state, f_target);
+    }
+
+    return state->f_rpm;
+}
+
+/* Static functions --------------------------------------------------------- */
+/**
+ * @brief Constant jerk phase.
+ *
+ * @param f_v Rate at the start
+ * @param f_a Acceleration at the start
+ * @param f_j Jerk
+ * @param f_t Duration
+ * @return Distance covered, rate and acceleration at the end
+ */
+static fan_traj_motion_t fan_traj_advance(float f_v, float f_a, float f_j, float f_t)
+{
+    fan_traj_motion_t motion;
+
+    motion.f_x = f_t * (f_v + f_t * (0.5f * f_a + f_t * f_j * (1.0f / 6.0f)));
+    motion.f_v = f_v + f_t * (f_a + 0.5f * f_j * f_t);
+    motion.f_a = f_a + f_j * f_t;
+
+    return motion;
+}
+
+/**
+ * @brief Distance the braking profile needs to come to rest.
+ *
+ * @param f_v     Rate towards the target
+ * @param f_a     Acceleration towards the target
+ * @param f_accel Acceleration limit
+ * @param f_jerk  Jerk limit
+ * @return Distance, -FLT_MAX when moving away (speeding up is safe)
+ */
+static float fan_traj_stop_distance(float f_v, float f_a, float f_accel, float f_jerk)
+{
+    fan_traj_motion_t phase1;
+    fan_traj_motion_t phase2;
+    fan_traj_motion_t phase3;
+    float f_peak2 = f_jerk * f_v + 0.5f * f_a * f_a;
+    float f_peak;
+    float f_hold = 0.0f;
+
+    if (f_v < 0.0f) {
+        return -FLT_MAX;
+    }
+
+    /* Braking so hard that releasing it alone stops short */
+    if ((f_a < 0.0f) && (f_v <= f_a * f_a / (2.0f * f_jerk))) {
+        return fan_traj_advance(f_v, f_a, f_jerk, -f_a / f_jerk).f_x;
+    }
+
+    if (f_peak2 <= f_accel * f_accel) {
+        f_peak = sqrtf(f_peak2);
+    } else {
+        f_peak = f_accel;
+        f_hold = (f_peak2 / f_jerk - f_accel * f_accel / f_jerk) / f_accel;
+    }
+
+    phase1 = fan_traj_advance(f_v, f_a, -f_jerk, (f_a + f_peak) / f_jerk);
+    phase2 = fan_traj_advance(phase1.f_v, phase1.f_a, 0.0f, f_hold);
+    phase3 = fan_traj_advance(phase2.f_v, phase2.f_a, f_jerk, f_peak / f_jerk);
+
+    return phase1.f_x + phase2.f_x + phase3.f_x;
+}
@@ -0,0 +1,83 @@
+/**
+ ******************************************************************************
+ * @file        fan_traj.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the jerk limited setpoint trajectory.
+ *
+ * @details
+ * A new target RPM (potentiometer, script, shell) is not handed to the
+ * controller as a step. The trajectory moves the setpoint towards it
+ * with limited rate (RPM/s), acceleration (RPM/s^2) and jerk (RPM/s^3):
+ * an S-curve, without overshoot, for any target change on the way.
+ *
+ * Every step decides the jerk of the next step in constant time:
+ *
+ *  - Accelerate (jerk towards +a_max, or back to 0 at the rate limit)
+ *    if from the state after that step the braking profile still stops
+ *    at the target
+ *  - Else follow the braking profile: jerk -j_max down to the peak
+ *    deceleration, hold it, jerk +j_max so that acceleration and rate
+ *    reach 0 together
+ *
+ * The braking distance is closed form (three constant jerk phases, one
+ * square root). Within 1 RPM of the target and at rest the setpoint
+ * snaps to the target. Float, also built on the host.
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - Online S-curve: the target may change in every step, the state
+ *    (setpoint, rate, acceleration) stays continuous
+ *  - Rate and acceleration of the setpoint for the feed-forward lead
+ *
+ ******************************************************************************
+ */
+
+#ifndef FAN_FAN_TRAJ_H_
+#define FAN_FAN_TRAJ_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Limits of the trajectory.
+ */
+typedef struct {
+    float f_rate;           /**< RPM/s, 0: none                            */
+    float f_accel;          /**< RPM/s^2, > 0                              */
+    float f_jerk;           /**< RPM/s^3, > 0                              */
+    float f_ta;             /**< Step time in s                            */
+} fan_traj_params_t;
+
+/**
+ * @brief State of the trajectory.
+ */
+typedef struct {
+    float f_rpm;            /**< Setpoint                                  */
+    float f_rate;           /**< RPM/s                                     */
+    float f_accel;          /**< RPM/s^2                                   */
+} fan_traj_state_t;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Puts the setpoint at rest on a known RPM.
+ *
+ * @param state State
+ * @param f_rpm RPM (e.g. the measured speed)
+ * @return None
+ */
+void fan_traj_reset(fan_traj_state_t *state, float f_rpm);
+
+/**
+ * @brief Advances the setpoint by one step towards the target.
+ *
+ * @param state    State, updated
+ * @param params   Limits
+ * @param f_target Target RPM
+ * @return Setpoint
+ */
+float fan_traj_step(fan_traj_state_t *state, const fan_traj_params_t *params, float f_target);
+
+#endif /* FAN_FAN_TRAJ_H_ */
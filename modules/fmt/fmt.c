@@ -0,0 +1,230 @@
+/**
+ ******************************************************************************
+ * @file        fmt.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Float-free number formatting
+ *
+ * Functionality:
+ * - Digit count from a power-of-ten table (compare only)
+ * - Conversion from the last digit pair to the first: value / 100 by a
+ *   constant compiles to a multiply, the pair comes from a 200 byte table
+ * - Fixed-point split with one division by the table power of ten
+ ******************************************************************************
+ */
+
+#include "fmt.h"
+#include <lcd/lcd.h>
+
+/* Static module variables -------------------------------------------------- */
+/**
+ * @brief Powers of ten, g_u32_fmt_pow10[i] = 10^i.
+ */
+static const uint32_t g_u32_fmt_pow10[10] = {
+    1UL, 10UL, 100UL, 1000UL, 10000UL, 100000UL,
+    1000000UL, 10000000UL, 100000000UL, 1000000000UL
+};
+
+/**
+ * @brief Two-digit table "00" .. "99".
+ */
+static const char g_ch_fmt_pairs[200] = {
+    '0','0','0','1','0','2','0','3','0','4','0','5','0','6','0','7','0','8','0','9',
+    '1','0','1','1','1','2','1','3','1','4','1','5','1','6','1','7','1','8','1','9',
+    '2','0','2','1','2','2','2','3','2','4','2','5','2','6','2','7','2','8','2','9',
+    '3','0','3','1','3','2','3','3','3','4','3','5','3','6','3','7','3','8','3','9',
+    '4','0','4','1','4','2','4','3','4','4','4','5','4','6','4','7','4','8','4','9',
+    '5','0','5','1','5','2','5','3','5','4','5','5','5','6','5','7','5','8','5','9',
+    '6','0','6','1','6','2','6','3','6','4','6','5','6','6','6','7','6','8','6','9',
+    '7','0','7','1','7','2','7','3','7','4','7','5','7','6','7','7','7','8','7','9',
+    '8','0','8','1','8','2','8','3','8','4','8','5','8','6','8','7','8','8','8','9',
+    '9','0','9','1','9','2','9','3','9','4','9','5','9','6','9','7','9','8','9','9'
+};
+
+/* Static function prototypes ---------------------------------------------- */
+static uint8_t fmt_digit_count(uint32_t u32_value);
+static void fmt_digits(fmt_t *fmt, uint32_t u32_value, uint8_t u8_digits);
+static void fmt_repeat(fmt_t *fmt, char ch, uint8_t u8_count);
+
+/* Public functions --------------------------------------------------------- */
+void fmt_init(fmt_t *fmt, char *pch_buffer, uint16_t u16_size)
+{
+    fmt->pch_buffer = pch_buffer;
+    fmt->u16_size   = u16_size;
+    fmt->u16_length = 0u;
+
+    if (u16_size > 0u) {
+        pch_buffer[0] = '\0';
+    }
+}
+
+void fmt_str(fmt_t *fmt, const char *pch_text)
+{
+    while (*pch_text != '\0') {
+        fmt_char(fmt, *pch_text++);
+    }
+}
+
+void fmt_char(fmt_t *fmt, char ch)
+{
+    if ((uint16_t)(fmt->u16_length + 1u) >= fmt->u16_size) {
+        return;
+    }
+
+    fmt->pch_buffer[fmt->u16_length++] = ch;
+    fmt->pch_buffer[fmt->u16_length]   = '\0';
+}
+
+void fmt_u32(fmt_t *fmt, uint32_t u32_value, uint8_t u8_width, char ch_pad)
+{
+    uint8_t u8_digits = fmt_digit_count(u32_value);
+
+    if (u8_width > u8_digits) {
+        fmt_repeat(fmt, ch_pad, u8_width - u8_digits);
+    }
+
+    fmt_digits(fmt, u32_value, u8_digits);
+}
+
+void fmt_i32(fmt_t *fmt, int32_t i32_value, uint8_t u8_width, char ch_pad)
+{
+    uint32_t u32_abs = (i32_value < 0) ? (0u - (uint32_t)i32_value) : (uint32_t)i32_value;
+    uint8_t u8_sign = (i32_value < 0) ? 1u : 0u;
+    uint8_t u8_digits = fmt_digit_count(u32_abs);
+    uint8_t u8_fill = (u8_width > (u8_digits + u8_sign)) ? (uint8_t)(u8_width - u8_digits - u8_sign) : 0u;
+
+    if (ch_pad != '0') {
+        fmt_repeat(fmt, ch_pad, u8_fill);
+    }
+    if (u8_sign) {
+        fmt_char(fmt, '-');
+    }
+    if (ch_pad == '0') {
+        fmt_repeat(fmt, '0', u8_fill);
+    }
+
+    fmt_digits(fmt, u32_abs, u8_digits);
+}
+
+void fmt_fixed(fmt_t *fmt, int32_t i32_value, uint8_t u8_decimals, uint8_t u8_width)
+{
+    uint32_t u32_abs = (i32_value < 0) ? (0u - (uint32_t)i32_value) : (uint32_t)i32_value;
+    uint8_t u8_sign = (i32_value < 0) ? 1u : 0u;
+    uint32_t u32_int;
+    uint32_t u32_frac;
+    uint8_t u8_digits;
+    uint8_t u8_length;
+
+    if (u8_decimals > FMT_MAX_DECIMALS) {
+        u8_decimals = FMT_MAX_DECIMALS;
+    }
+
+    u32_int  = u32_abs / g_u32_fmt_pow10[u8_decimals];
+    u32_frac = u32_abs - u32_int * g_u32_fmt_pow10[u8_decimals];
+
+    u8_digits = fmt_digit_count(u32_int);
+    u8_length = (uint8_t)(u8_sign + u8_digits + ((u8_decimals > 0u) ? (u8_decimals + 1u) : 0u));
+
+    if (u8_width > u8_length) {
+        fmt_repeat(fmt, ' ', u8_width - u8_length);
+    }
+    if (u8_sign) {
+        fmt_char(fmt, '-');
+    }
+
+    fmt_digits(fmt, u32_int, u8_digits);
+
+    if (u8_decimals > 0u) {
+        fmt_char(fmt, '.');
+        fmt_digits(fmt, u32_frac, u8_decimals);
+    }
+}
+
+void fmt_pad(fmt_t *fmt, uint16_t u16_column)
+{
+    while (fmt->u16_length < u16_column) {
+        uint16_t u16_before = fmt->u16_length;
+
+        fmt_char(fmt, ' ');
+        if (fmt->u16_length == u16_before) {
+            break;
+        }
+    }
+}
+
+const char *fmt_get(const fmt_t *fmt)
+{
+    return fmt->pch_buffer;
+}
+
+void fmt_lcd_line(const fmt_t *fmt, uint8_t u8_line, uint16_t u16_color,
+                  uint16_t u16_size, uint16_t u16_background_color)
+{
+    lcd_update_text_at_line(fmt->pch_buffer, u8_line, u16_color, u16_size, u16_background_color);
+}
+
+/* Static module functions -------------------------------------------------- */
+/**
+ * @brief Returns the number of decimal digits of a value (0 has one).
+ *
+ * @param u32_value Value
+ * @return 1 .. 10
+ */
+static uint8_t fmt_digit_count(uint32_t u32_value)
+{
+    uint8_t u8_digits = 1u;
+
+    while ((u8_digits < 10u) && (u32_value >= g_u32_fmt_pow10[u8_digits])) {
+        u8_digits++;
+    }
+
+    return u8_digits;
+}
+
+/**
+ * @brief Appends exactly u8_digits digits of a value (leading zeros).
+ *
+ * The digits are produced from the end in pairs into a local buffer and
+ * then copied to the builder.
+ *
+ * @param fmt       Builder
+ * @param u32_value Value (< 10^u8_digits)
+ * @param u8_digits Number of digits (1 .. 10)
+ */
+static void fmt_digits(fmt_t *fmt, uint32_t u32_value, uint8_t u8_digits)
+{
+    char ch_digits[10];
+    uint8_t u8_pos = u8_digits;
+
+    while (u8_pos >= 2u) {
+        uint32_t u32_pair = u32_value % 100u;
+
+        u32_value /= 100u;
+        u8_pos -= 2u;
+        ch_digits[u8_pos]      = g_ch_fmt_pairs[2u * u32_pair];
+        ch_digits[u8_pos + 1u] = g_ch_fmt_pairs[2u * u32_pair + 1u];
+    }
+
+    if (u8_pos == 1u) {
+        ch_digits[0] = (char)('0' + (u32_value % 10u));
+    }
+
+    for (uint8_t i = 0u; i < u8_digits; i++) {
+        fmt_char(fmt, ch_digits[i]);
+    }
+}
+
+/**
+ * @brief Appends a character several times.
+ *
+ * @param fmt      Builder
+ * @param ch       Character
+ * @param u8_count Number of characters
+ */
+static void fmt_repeat(fmt_t *fmt, char ch, uint8_t u8_count)
+{
+    while (u8_count-- > 0u) {
+        fmt_char(fmt, ch);
+    }
+}
@@ -0,0 +1,153 @@
+/**
+ ******************************************************************************
+ * @file        fmt.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the float-free number formatting module.
+ *
+ * @details
+ * Replaces sprintf() for display values. Integers and fixed-point values
+ * (value scaled by 10^decimals) are converted to decimal text with a
+ * power-of-ten table for the digit count and a two-digit table
+ * ("00".."99") for the conversion, so each digit pair costs one
+ * multiply-by-reciprocal instead of a division loop, and no float
+ * printf support is linked.
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - Builder on a caller buffer, always NUL terminated, truncates on overflow
+ *  - Unsigned / signed integers with fixed width and ' ' or '0' padding
+ *  - Fixed-point values ("-12.34") with fixed width
+ *  - Padding up to a column (left aligned fields)
+ *  - Output to the retained lcd text layer: only changed glyphs are drawn
+ *
+ * Example, equivalent to sprintf(buf, "TAR: %-4lu", rpm):
+ *
+ *     fmt_t fmt;
+ *     fmt_init(&fmt, buf, sizeof(buf));
+ *     fmt_str(&fmt, "TAR: ");
+ *     fmt_u32(&fmt, rpm, 0u, ' ');
+ *     fmt_pad(&fmt, 9u);
+ *     fmt_lcd_line(&fmt, 4u, BLACK, 3u, WHITE);
+ *
+ ******************************************************************************
+ */
+
+#ifndef FMT_FMT_H_
+#define FMT_FMT_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief Maximum number of decimals of a fixed-point value.
+ */
+#define FMT_MAX_DECIMALS    9U
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Text builder on a caller provided buffer.
+ */
+typedef struct {
+    char    *pch_buffer;
+    uint16_t u16_size;      /**< Buffer size including the terminator */
+    uint16_t u16_length;    /**< Characters written                   */
+} fmt_t;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Starts a new text in a buffer.
+ *
+ * @param fmt        Builder
+ * @param pch_buffer Destination buffer
+ * @param u16_size   Size of the buffer in bytes (>= 1)
+ * @return None
+ */
+void fmt_init(fmt_t *fmt, char *pch_buffer, uint16_t u16_size);
+
+/**
+ * @brief Appends a string.
+ *
+ * @param fmt Builder
+ * @param pch_text NUL terminated string
+ * @return None
+ */
+void fmt_str(fmt_t *fmt, const char *pch_text);
+
+/**
+ * @brief Appends one character.
+ *
+ * @param fmt Builder
+ * @param ch  Character
+ * @return None
+ */
+void fmt_char(fmt_t *fmt, char ch);
+
+/**
+ * @brief Appends an unsigned integer, right aligned.
+ *
+ * @param fmt       Builder
+ * @param u32_value Value
+ * @param u8_width  Minimum field width, 0 = no padding
+ * @param ch_pad    Padding character (' ' or '0')
+ * @return None
+ */
+void fmt_u32(fmt_t *fmt, uint32_t u32_value, uint8_t u8_width, char ch_pad);
+
+/**
+ * @brief Appends a signed integer, right aligned.
+ *
+ * With '0' padding the sign precedes the zeros ("-007").
+ *
+ * @param fmt       Builder
+ * @param i32_value Value
+ * @param u8_width  Minimum field width including the sign, 0 = no padding
+ * @param ch_pad    Padding character (' ' or '0')
+ * @return None
+ */
+void fmt_i32(fmt_t *fmt, int32_t i32_value, uint8_t u8_width, char ch_pad);
+
+/**
+ * @brief Appends a fixed-point value, right aligned with spaces.
+ *
+ * @param fmt         Builder
+ * @param i32_value   Value scaled by 10^u8_decimals (e.g. 0.01 degC)
+ * @param u8_decimals Number of decimals (0 .. FMT_MAX_DECIMALS)
+ * @param u8_width    Minimum field width including sign and point
+ * @return None
+ */
+void fmt_fixed(fmt_t *fmt, int32_t i32_value, uint8_t u8_decimals, uint8_t u8_width);
+
+/**
+ * @brief Pads with spaces up to a column (left aligned fields).
+ *
+ * @param fmt        Builder
+ * @param u16_column Column the next character is written to
+ * @return None
+ */
+void fmt_pad(fmt_t *fmt, uint16_t u16_column);
+
+/**
+ * @brief Returns the text.
+ *
+ * @param fmt Builder
+ * @return NUL terminated text in the caller buffer
+ */
+const char *fmt_get(const fmt_t *fmt);
+
+/**
+ * @brief Shows the text on a line of the lcd (lcd_update_text_at_line).
+ *
+ * @param fmt       Builder
+ * @param u8_line   Line on the screen
+ * @param u16_color Text color
+ * @param u16_size  Text size
+ * @param u16_background_color Background color
+ * @return None
+ */
+void fmt_lcd_line(const fmt_t *fmt, uint8_t u8_line, uint16_t u16_color,
+                  uint16_t u16_size, uint16_t u16_background_color);
+
+#endif /* FMT_FMT_H_ */
@@ -0,0 +1,1070 @@
+/**
+ ******************************************************************************
+ * @file        framebuffer.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       SDRAM framebuffer with LTDC scanout
+ *
+ * Functionality:
+ * - Brings up the SDRAM (sdram module) and places one RGB565 frame at
+ *   its start address
+ * - Switches the ILI9341 to the RGB interface (commands still via SPI5)
+ * - Generates a 6 MHz pixel clock with PLLSAI (1 MHz * 192 / 4 / 8)
+ * - Configures LTDC timing for the 240x320 panel and layer 1
+ * - Optional keyed / blended overlay frame on layer 2
+ * - Optional double buffering of layer 1: flip in the LTDC line interrupt,
+ *   dirty rectangles copied forward by the DMA2D
+ * - Optional L8 frames with a CLUT of the named colours and a colour cube
+ * - Drawing primitives operating on the framebuffer; fills, blits and
+ *   glyphs are offloaded to the DMA2D (register-to-memory,
+ *   memory-to-memory and memory-to-memory with blending)
+ *
+ * Peripherals:
+ * - LTDC (line interrupt with double buffering), PLLSAI, DMA2D
+ * - GPIOA, GPIOB, GPIOC, GPIOD, GPIOF, GPIOG (LTDC alternate function)
+ * - SPI5 (panel configuration only, see ILI9341_STM32_Driver)
+ ******************************************************************************
+ */
+
+#include "framebuffer.h"
+#include "sdram/sdram.h"
+#include "colour/colour.h"
+#include <lcd/ILI9341_STM32_Driver.h>
+#include <lcd/5x5_font.h>
+#include <profile/profile.h>
+
+/* Preprocessor Defines ----------------------------------------------------- */
+/**
+ * @brief DMA2D transfer modes (CR.MODE).
+ */
+#define FRAMEBUFFER_DMA2D_M2M        (0u << DMA2D_CR_MODE_Pos)
+#define FRAMEBUFFER_DMA2D_M2M_BLEND  (2u << DMA2D_CR_MODE_Pos)
+#define FRAMEBUFFER_DMA2D_R2M        (3u << DMA2D_CR_MODE_Pos)
+
+/**
+ * @brief DMA2D colour modes (xxPFCCR.CM).
+ */
+#define FRAMEBUFFER_DMA2D_CM_RGB565  0x2u
+#define FRAMEBUFFER_DMA2D_CM_L8      0x5u
+#define FRAMEBUFFER_DMA2D_CM_A8      0x9u
+#define FRAMEBUFFER_DMA2D_CM_A4      0xAu
+
+/**
+ * @brief Colour mode of the frames (copies between frames).
+ */
+#if FRAMEBUFFER_L8
+#define FRAMEBUFFER_DMA2D_CM_PIXEL   FRAMEBUFFER_DMA2D_CM_L8
+#define FRAMEBUFFER_LTDC_FORMAT      LTDC_PIXEL_FORMAT_L8
+#else
+#define FRAMEBUFFER_DMA2D_CM_PIXEL   FRAMEBUFFER_DMA2D_CM_RGB565
+#define FRAMEBUFFER_LTDC_FORMAT      LTDC_PIXEL_FORMAT_RGB565
+#endif
+
+/**
+ * @brief CLUT layout with FRAMEBUFFER_L8: the named colours first, the
+ *        6x6x6 colour cube behind them.
+ */
+#define FRAMEBUFFER_CLUT_SIZE        256u
+#define FRAMEBUFFER_CUBE_LEVELS      6u
+
+/* Static module variables -------------------------------------------------- */
+/**
+ * @brief LTDC handle.
+ */
+static LTDC_HandleTypeDef g_framebuffer_ltdc_handle_struct;
+
+/**
+ * @brief RGB565 frame in the SDRAM the drawing functions write to
+ *        (selected layer).
+ */
+static framebuffer_pixel_t * volatile g_p_framebuffer = (framebuffer_pixel_t *)FRAMEBUFFER_ADDR;
+
+/**
+ * @brief Overlay state: shown on layer 2, key colour.
+ */
+static uint8_t g_u8_overlay_enabled;
+static uint16_t g_u16_overlay_key = FRAMEBUFFER_OVERLAY_KEY;
+
+/**
+ * @brief Double buffering: frames of layer 1, flip requested for the next
+ *        blanking.
+ */
+static uint8_t g_u8_double;
+static framebuffer_pixel_t *g_p_front = (framebuffer_pixel_t *)FRAMEBUFFER_ADDR;
+static framebuffer_pixel_t *g_p_back = (framebuffer_pixel_t *)FRAMEBUFFER_BACK_ADDR;
+static volatile uint8_t g_u8_swap_pending;
+
+/**
+ * @brief Rectangles drawn into the back frame since the last swap, and
+ *        those of the flipped frame still to be copied forward.
+ */
+static framebuffer_rect_t g_dirty[FRAMEBUFFER_DIRTY_RECTS];
+static uint8_t g_u8_dirty_count;
+static framebuffer_rect_t g_copy[FRAMEBUFFER_DIRTY_RECTS];
+static uint8_t g_u8_copy_count;
+
+/**
+ * @brief Told the rectangles of every swapped frame (display mirror).
+ */
+static framebuffer_swap_callback_t g_framebuffer_swap_callback;
+
+static volatile framebuffer_stats_t g_framebuffer_stats;
+
+#if PROFILE_ENABLE
+/**
+ * @brief Cycle counter at the last framebuffer_swap() and the last flip.
+ */
+static uint32_t g_u32_swap_cycles;
+static uint32_t g_u32_flip_cycles;
+#endif
+
+#if FRAMEBUFFER_L8
+/**
+ * @brief Colours of ILI9341_STM32_Driver.h, drawn exactly (PINK is
+ *        MAGENTA).
+ */
+static const uint16_t g_u16_framebuffer_named[] = {
+    BLACK, NAVY, DARKGREEN, DARKCYAN, MAROON, PURPLE, OLIVE, LIGHTGREY, DARKGREY,
+    BLUE, GREEN, CYAN, RED, MAGENTA, YELLOW, WHITE, ORANGE, GREENYELLOW
+};
+
+#define FRAMEBUFFER_NAMED_COLOURS    (sizeof(g_u16_framebuffer_named) / sizeof(g_u16_framebuffer_named[0]))
+
+/**
+ * @brief RGB888 CLUT of both layers.
+ */
+static uint32_t g_u32_framebuffer_clut[FRAMEBUFFER_CLUT_SIZE];
+#endif
+
+/**
+ * @brief A8 cell for one scaled glyph, source of the DMA2D blend.
+ */
+static uint8_t g_u8_glyph_cell[CHAR_WIDTH * CHAR_HEIGHT *
+                               FRAMEBUFFER_GLYPH_MAX_SIZE * FRAMEBUFFER_GLYPH_MAX_SIZE];
+
+/* Static function prototypes ---------------------------------------------- */
+static void framebuffer_gpio_init(void);
+static HAL_StatusTypeDef framebuffer_ltdc_init(void);
+static HAL_StatusTypeDef framebuffer_layer_init(uint32_t u32_layer, uint32_t u32_addr, uint8_t u8_alpha,
+                                                uint32_t u32_factor1, uint32_t u32_factor2);
+static void framebuffer_draw_char(char ch, uint16_t x, uint16_t y,
+                                  uint16_t colour, uint16_t size, uint16_t bg_colour);
+static void framebuffer_copy_forward(void);
+#if FRAMEBUFFER_L8
+static void framebuffer_clut_init(void);
+static void framebuffer_fill_column(uint16_t x, uint16_t y, uint16_t height, framebuffer_pixel_t pixel);
+#endif
+static void framebuffer_flip(void);
+
+/* Public functions --------------------------------------------------------- */
+HAL_StatusTypeDef framebuffer_init(void)
+{
+    if (sdram_init() != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    __HAL_RCC_DMA2D_CLK_ENABLE();
+    DMA2D->OPFCCR = FRAMEBUFFER_DMA2D_CM_RGB565;
+#if FRAMEBUFFER_L8
+    framebuffer_clut_init();
+#endif
+
+    framebuffer_fill_screen(BLACK);
+
+    /* Panel registers are written over SPI, pixels then come from the LTDC */
+    ILI9341_Init();
+    ILI9341_Enable_RGB_Interface();
+
+    framebuffer_gpio_init();
+
+    return framebuffer_ltdc_init();
+}
+
+HAL_StatusTypeDef framebuffer_overlay_enable(uint16_t key_colour, uint8_t u8_alpha)
+{
+    framebuffer_pixel_t *p_target = g_p_framebuffer;
+
+    /* Cleared to transparent before it is shown */
+    g_p_framebuffer = (framebuffer_pixel_t *)FRAMEBUFFER_OVERLAY_ADDR;
+    framebuffer_fill_screen(key_colour);
+    framebuffer_wait();
+    g_p_framebuffer = p_target;
+
+    /* Pixel alpha times constant alpha: keyed pixels (alpha 0) show the
+     * background, the others are mixed with it by u8_alpha */
+    if ((framebuffer_layer_init(1u, FRAMEBUFFER_OVERLAY_ADDR, u8_alpha,
+                                LTDC_BLENDING_FACTOR1_PAxCA, LTDC_BLENDING_FACTOR2_PAxCA) != HAL_OK) ||
+#if FRAMEBUFFER_L8
+        (HAL_LTDC_ConfigColorKeying(&g_framebuffer_ltdc_handle_struct,
+                                    g_u32_framebuffer_clut[framebuffer_pixel(key_colour)], 1u) != HAL_OK) ||
+#else
+        (HAL_LTDC_ConfigColorKeying(&g_framebuffer_ltdc_handle_struct,
+                                    colour_to_rgb888(key_colour), 1u) != HAL_OK) ||
+#endif
+        (HAL_LTDC_EnableColorKeying(&g_framebuffer_ltdc_handle_struct, 1u) != HAL_OK)) {
+        return HAL_ERROR;
+    }
+
+    g_u16_overlay_key    = key_colour;
+    g_u8_overlay_enabled = 1u;
+
+    return HAL_OK;
+}
+
+void framebuffer_overlay_disable(void)
+{
+    if (!g_u8_overlay_enabled) {
+        return;
+    }
+
+    __HAL_LTDC_LAYER_DISABLE(&g_framebuffer_ltdc_handle_struct, 1u);
+    __HAL_LTDC_RELOAD_IMMEDIATE_CONFIG(&g_framebuffer_ltdc_handle_struct);
+
+    g_u8_overlay_enabled = 0u;
+    g_p_framebuffer   = g_u8_double ? g_p_back : (framebuffer_pixel_t *)FRAMEBUFFER_ADDR;
+}
+
+void framebuffer_overlay_set_alpha(uint8_t u8_alpha)
+{
+    if (!g_u8_overlay_enabled) {
+        return;
+    }
+
+    /* Shadow register, taken over between two frames: no tearing */
+    (void)HAL_LTDC_SetAlpha_NoReload(&g_framebuffer_ltdc_handle_struct, u8_alpha, 1u);
+    (void)HAL_LTDC_Reload(&g_framebuffer_ltdc_handle_struct, LTDC_RELOAD_VERTICAL_BLANKING);
+}
+
+uint16_t framebuffer_overlay_get_key(void)
+{
+    return g_u16_overlay_key;
+}
+
+HAL_StatusTypeDef framebuffer_select_layer(framebuffer_layer_t layer)
+{
+    if (layer == FRAMEBUFFER_LAYER_OVERLAY) {
+        if (!g_u8_overlay_enabled) {
+            return HAL_ERROR;
+        }
+        g_p_framebuffer = (framebuffer_pixel_t *)FRAMEBUFFER_OVERLAY_ADDR;
+    } else {
+        g_p_framebuffer = g_u8_double ? g_p_back : (framebuffer_pixel_t *)FRAMEBUFFER_ADDR;
+    }
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef framebuffer_double_buffer_enable(void)
+{
+    if (g_u8_double) {
+        return HAL_OK;
+    }
+    if (g_framebuffer_ltdc_handle_struct.Instance != LTDC) {
+        return HAL_ERROR;
+    }
+
+    /* The back frame starts as a copy of the shown one */
+    framebuffer_wait();
+    g_p_front     = (framebuffer_pixel_t *)FRAMEBUFFER_ADDR;
+    g_p_back      = (framebuffer_pixel_t *)FRAMEBUFFER_BACK_ADDR;
+    g_copy[0]        = (framebuffer_rect_t){ 0u, 0u, FRAMEBUFFER_WIDTH, FRAMEBUFFER_HEIGHT };
+    g_u8_copy_count  = 1u;
+    g_u8_dirty_count = 0u;
+    framebuffer_copy_forward();
+
+    if (g_p_framebuffer == g_p_front) {
+        g_p_framebuffer = g_p_back;
+    }
+    g_u8_double = 1u;
+
+    /* Line event at the end of the active area: the flip happens in the
+     * vertical blanking that follows */
+    HAL_NVIC_SetPriority(LTDC_IRQn, FRAMEBUFFER_IRQ_PRIORITY, 0u);
+    HAL_NVIC_EnableIRQ(LTDC_IRQn);
+
+    return HAL_LTDC_ProgramLineEvent(&g_framebuffer_ltdc_handle_struct,
+                                     g_framebuffer_ltdc_handle_struct.Init.AccumulatedActiveH);
+}
+
+HAL_StatusTypeDef framebuffer_swap(void)
+{
+    if (!g_u8_double) {
+        return HAL_ERROR;
+    }
+
+    /* Drawing of the frame finished, the previous swap flipped and copied */
+    framebuffer_wait();
+
+    for (uint8_t i = 0u; i < g_u8_dirty_count; i++) {
+        g_copy[i] = g_dirty[i];
+    }
+    g_u8_copy_count  = g_u8_dirty_count;
+    g_u8_dirty_count = 0u;
+
+    if (g_framebuffer_swap_callback != NULL) {
+        g_framebuffer_swap_callback(g_copy, g_u8_copy_count);
+    }
+
+#if PROFILE_ENABLE
+    g_u32_swap_cycles = DWT->CYCCNT;
+#endif
+    g_u8_swap_pending = 1u;
+
+    return HAL_OK;
+}
+
+uint8_t framebuffer_swap_pending(void)
+{
+    return g_u8_swap_pending;
+}
+
+void framebuffer_mark_dirty(uint16_t x, uint16_t y, uint16_t width, uint16_t height)
+{
+    framebuffer_rect_t *rect;
+
+    if (!g_u8_double || (g_p_framebuffer != g_p_back) ||
+        (x >= FRAMEBUFFER_WIDTH) || (y >= FRAMEBUFFER_HEIGHT) || (width == 0u) || (height == 0u)) {
+        return;
+    }
+    if ((uint32_t)x + width > FRAMEBUFFER_WIDTH) {
+        width = FRAMEBUFFER_WIDTH - x;
+    }
+    if ((uint32_t)y + height > FRAMEBUFFER_HEIGHT) {
+        height = FRAMEBUFFER_HEIGHT - y;
+    }
+
+    /* Grow a rectangle the new one overlaps or touches, otherwise append;
+     * a full list grows its last rectangle */
+    rect = NULL;
+    for (uint8_t i = 0u; i < g_u8_dirty_count; i++) {
+        framebuffer_rect_t *candidate = &g_dirty[i];
+
+        if (((uint32_t)x <= (uint32_t)candidate->u16_x + candidate->u16_width) &&
+            ((uint32_t)candidate->u16_x <= (uint32_t)x + width) &&
+            ((uint32_t)y <= (uint32_t)candidate->u16_y + candidate->u16_height) &&
+            ((uint32_t)candidate->u16_y <= (uint32_t)y + height)) {
+            rect = candidate;
+            break;
+        }
+    }
+    if ((rect == NULL) && (g_u8_dirty_count < FRAMEBUFFER_DIRTY_RECTS)) {
+        g_dirty[g_u8_dirty_count++] = (framebuffer_rect_t){ x, y, width, height };
+        return;
+    }
+    if (rect == NULL) {
+        rect = &g_dirty[FRAMEBUFFER_DIRTY_RECTS - 1u];
+    }
+
+    uint16_t u16_right  = ((uint32_t)x + width > (uint32_t)rect->u16_x + rect->u16_width)
+                        ? (uint16_t)(x + width) : (uint16_t)(rect->u16_x + rect->u16_width);
+    uint16_t u16_bottom = ((uint32_t)y + height > (uint32_t)rect->u16_y + rect->u16_height)
+                        ? (uint16_t)(y + height) : (uint16_t)(rect->u16_y + rect->u16_height);
+
+    rect->u16_x      = (x < rect->u16_x) ? x : rect->u16_x;
+    rect->u16_y      = (y < rect->u16_y) ? y : rect->u16_y;
+    rect->u16_width  = u16_right - rect->u16_x;
+    rect->u16_height = u16_bottom - rect->u16_y;
+}
+
+void framebuffer_set_swap_callback(framebuffer_swap_callback_t callback)
+{
+    g_framebuffer_swap_callback = callback;
+}
+
+void framebuffer_get_stats(framebuffer_stats_t *stats)
+{
+    uint32_t u32_primask = __get_PRIMASK();
+
+    __disable_irq();
+    *stats = g_framebuffer_stats;
+    __set_PRIMASK(u32_primask);
+}
+
+/**
+ * @brief LTDC interrupt: line event at the end of the active area.
+ */
+void LTDC_IRQHandler(void)
+{
+    if (LTDC->ISR & LTDC_ISR_LIF) {
+        LTDC->ICR = LTDC_ICR_CLIF;
+        g_framebuffer_stats.u32_blankings++;
+        if (g_u8_swap_pending) {
+            framebuffer_flip();
+        }
+    }
+}
+
+framebuffer_pixel_t *framebuffer_get_buffer(void)
+{
+    return g_p_framebuffer;
+}
+
+const framebuffer_pixel_t *framebuffer_get_front(void)
+{
+    return g_u8_double ? g_p_front : (const framebuffer_pixel_t *)FRAMEBUFFER_ADDR;
+}
+
+const framebuffer_pixel_t *framebuffer_snapshot(void)
+{
+    framebuffer_pixel_t *p_copy = (framebuffer_pixel_t *)FRAMEBUFFER_SNAPSHOT_ADDR;
+
+    /* A pending flip is waited for, the copy shows a complete frame */
+    framebuffer_wait();
+
+    DMA2D->CR      = FRAMEBUFFER_DMA2D_M2M;
+    DMA2D->FGPFCCR = FRAMEBUFFER_DMA2D_CM_PIXEL;
+    DMA2D->FGMAR   = (uint32_t)framebuffer_get_front();
+    DMA2D->FGOR    = 0u;
+    DMA2D->OMAR    = (uint32_t)p_copy;
+    DMA2D->OOR     = 0u;
+    DMA2D->NLR     = ((uint32_t)FRAMEBUFFER_WIDTH << DMA2D_NLR_PL_Pos) | FRAMEBUFFER_HEIGHT;
+    DMA2D->CR     |= DMA2D_CR_START;
+
+    return p_copy;
+}
+
+uint16_t framebuffer_colour(framebuffer_pixel_t pixel)
+{
+#if FRAMEBUFFER_L8
+    return colour_from_rgb888(g_u32_framebuffer_clut[pixel]);
+#else
+    return pixel;
+#endif
+}
+
+framebuffer_pixel_t framebuffer_pixel(uint16_t colour)
+{
+#if FRAMEBUFFER_L8
+    uint32_t u32_r;
+    uint32_t u32_g;
+    uint32_t u32_b;
+
+    for (uint8_t i = 0u; i < FRAMEBUFFER_NAMED_COLOURS; i++) {
+        if (g_u16_framebuffer_named[i] == colour) {
+            return i;
+        }
+    }
+
+    /* Nearest level of the cube per channel */
+    u32_r = (((colour >> 11) & 0x1Fu) * (FRAMEBUFFER_CUBE_LEVELS - 1u) + 15u) / 31u;
+    u32_g = (((colour >> 5) & 0x3Fu) * (FRAMEBUFFER_CUBE_LEVELS - 1u) + 31u) / 63u;
+    u32_b = ((colour & 0x1Fu) * (FRAMEBUFFER_CUBE_LEVELS - 1u) + 15u) / 31u;
+
+    return (framebuffer_pixel_t)(FRAMEBUFFER_NAMED_COLOURS +
+                                 (u32_r * FRAMEBUFFER_CUBE_LEVELS + u32_g) * FRAMEBUFFER_CUBE_LEVELS + u32_b);
+#else
+    return colour;
+#endif
+}
+
+void framebuffer_fill_screen(uint16_t colour)
+{
+    framebuffer_fill_rect(0u, 0u, FRAMEBUFFER_WIDTH, FRAMEBUFFER_HEIGHT, colour);
+}
+
+void framebuffer_draw_pixel(uint16_t x, uint16_t y, uint16_t colour)
+{
+    if ((x >= FRAMEBUFFER_WIDTH) || (y >= FRAMEBUFFER_HEIGHT)) {
+        return;
+    }
+
+    framebuffer_wait();
+    framebuffer_mark_dirty(x, y, 1u, 1u);
+    g_p_framebuffer[(uint32_t)y * FRAMEBUFFER_WIDTH + x] = framebuffer_pixel(colour);
+}
+
+void framebuffer_fill_rect(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint16_t colour)
+{
+    if ((x >= FRAMEBUFFER_WIDTH) || (y >= FRAMEBUFFER_HEIGHT)) {
+        return;
+    }
+    if ((uint32_t)x + width > FRAMEBUFFER_WIDTH) {
+        width = FRAMEBUFFER_WIDTH - x;
+    }
+    if ((uint32_t)y + height > FRAMEBUFFER_HEIGHT) {
+        height = FRAMEBUFFER_HEIGHT - y;
+    }
+
+    if ((width == 0u) || (height == 0u)) {
+        return;
+    }
+
+    /* Register-to-memory: DMA2D writes OCOLR into the output window */
+    framebuffer_wait();
+    framebuffer_mark_dirty(x, y, width, height);
+#if FRAMEBUFFER_L8
+    /* No L8 output: pairs of pixels are filled as RGB565 of the doubled
+     * index, odd edge columns by the CPU (the frame width is even) */
+    framebuffer_pixel_t pixel = framebuffer_pixel(colour);
+
+    if (x & 1u) {
+        framebuffer_fill_column(x, y, height, pixel);
+        x++;
+        width--;
+    }
+    if (width & 1u) {
+        width--;
+        framebuffer_fill_column(x + width, y, height, pixel);
+    }
+    if (width == 0u) {
+        return;
+    }
+    DMA2D->CR    = FRAMEBUFFER_DMA2D_R2M;
+    DMA2D->OCOLR = ((uint32_t)pixel << 8) | pixel;
+    DMA2D->OMAR  = (uint32_t)&g_p_framebuffer[(uint32_t)y * FRAMEBUFFER_WIDTH + x];
+    DMA2D->OOR   = (FRAMEBUFFER_WIDTH - width) / 2u;
+    DMA2D->NLR   = ((uint32_t)(width / 2u) << DMA2D_NLR_PL_Pos) | height;
+    DMA2D->CR   |= DMA2D_CR_START;
+#else
+    DMA2D->CR    = FRAMEBUFFER_DMA2D_R2M;
+    DMA2D->OCOLR = colour;
+    DMA2D->OMAR  = (uint32_t)&g_p_framebuffer[(uint32_t)y * FRAMEBUFFER_WIDTH + x];
+    DMA2D->OOR   = FRAMEBUFFER_WIDTH - width;
+    DMA2D->NLR   = ((uint32_t)width << DMA2D_NLR_PL_Pos) | height;
+    DMA2D->CR   |= DMA2D_CR_START;
+#endif
+}
+
+void framebuffer_blit(const uint16_t *image, uint16_t x, uint16_t y,
+                      uint16_t width, uint16_t height)
+{
+    uint16_t u16_visible_w = width;
+    uint16_t u16_visible_h = height;
+
+    if ((x >= FRAMEBUFFER_WIDTH) || (y >= FRAMEBUFFER_HEIGHT)) {
+        return;
+    }
+    if ((uint32_t)x + u16_visible_w > FRAMEBUFFER_WIDTH) {
+        u16_visible_w = FRAMEBUFFER_WIDTH - x;
+    }
+    if ((uint32_t)y + u16_visible_h > FRAMEBUFFER_HEIGHT) {
+        u16_visible_h = FRAMEBUFFER_HEIGHT - y;
+    }
+    if ((u16_visible_w == 0u) || (u16_visible_h == 0u)) {
+        return;
+    }
+
+    framebuffer_wait();
+    framebuffer_mark_dirty(x, y, u16_visible_w, u16_visible_h);
+#if FRAMEBUFFER_L8
+    /* RGB565 source, converted to CLUT indices pixel by pixel */
+    for (uint16_t row = 0u; row < u16_visible_h; row++) {
+        const uint16_t *pu16_source = &image[(uint32_t)row * width];
+        framebuffer_pixel_t *p_pixel = &g_p_framebuffer[((uint32_t)y + row) * FRAMEBUFFER_WIDTH + x];
+
+        for (uint16_t col = 0u; col < u16_visible_w; col++) {
+            p_pixel[col] = framebuffer_pixel(pu16_source[col]);
+        }
+    }
+#else
+    /* Memory-to-memory: foreground source copied 1:1, no conversion */
+    DMA2D->CR      = FRAMEBUFFER_DMA2D_M2M;
+    DMA2D->FGPFCCR = FRAMEBUFFER_DMA2D_CM_RGB565;
+    DMA2D->FGMAR   = (uint32_t)image;
+    DMA2D->FGOR    = width - u16_visible_w;
+    DMA2D->OMAR    = (uint32_t)&g_p_framebuffer[(uint32_t)y * FRAMEBUFFER_WIDTH + x];
+    DMA2D->OOR     = FRAMEBUFFER_WIDTH - u16_visible_w;
+    DMA2D->NLR     = ((uint32_t)u16_visible_w << DMA2D_NLR_PL_Pos) | u16_visible_h;
+    DMA2D->CR     |= DMA2D_CR_START;
+#endif
+}
+
+void framebuffer_blend_alpha(const uint8_t *alpha, framebuffer_alpha_format_t format,
+                             uint16_t x, uint16_t y, uint16_t width, uint16_t height,
+                             uint16_t colour)
+{
+#if !FRAMEBUFFER_L8
+    uint32_t u32_out_addr;
+#endif
+
+    if (((uint32_t)x + width > FRAMEBUFFER_WIDTH) ||
+        ((uint32_t)y + height > FRAMEBUFFER_HEIGHT) ||
+        (width == 0u) || (height == 0u)) {
+        return;
+    }
+
+    /* After the wait: a flip changes the frame drawn into */
+    framebuffer_wait();
+    framebuffer_mark_dirty(x, y, width, height);
+#if FRAMEBUFFER_L8
+    /* Indices cannot be mixed: a pixel is set from an alpha of one half */
+    framebuffer_pixel_t pixel = framebuffer_pixel(colour);
+
+    for (uint16_t row = 0u; row < height; row++) {
+        framebuffer_pixel_t *p_pixel = &g_p_framebuffer[((uint32_t)y + row) * FRAMEBUFFER_WIDTH + x];
+
+        for (uint16_t col = 0u; col < width; col++) {
+            uint32_t u32_index = (uint32_t)row * width + col;
+            uint8_t u8_alpha = (format == FRAMEBUFFER_ALPHA_A4)
+                             ? (uint8_t)(((alpha[u32_index >> 1] >> ((u32_index & 1u) ? 4u : 0u)) & 0x0Fu) << 4)
+                             : alpha[u32_index];
+
+            if (u8_alpha >= 0x80u) {
+                p_pixel[col] = pixel;
+            }
+        }
+    }
+#else
+    u32_out_addr = (uint32_t)&g_p_framebuffer[(uint32_t)y * FRAMEBUFFER_WIDTH + x];
+
+    /* Blend: foreground = colour weighted by the alpha map,
+     * background = current framebuffer content, output written in place */
+    DMA2D->CR      = FRAMEBUFFER_DMA2D_M2M_BLEND;
+    DMA2D->FGPFCCR = (format == FRAMEBUFFER_ALPHA_A4) ? FRAMEBUFFER_DMA2D_CM_A4
+                                                      : FRAMEBUFFER_DMA2D_CM_A8;
+    DMA2D->FGCOLR  = colour_to_rgb888(colour);
+    DMA2D->FGMAR   = (uint32_t)alpha;
+    DMA2D->FGOR    = 0u;
+    DMA2D->BGPFCCR = FRAMEBUFFER_DMA2D_CM_RGB565;
+    DMA2D->BGMAR   = u32_out_addr;
+    DMA2D->BGOR    = FRAMEBUFFER_WIDTH - width;
+    DMA2D->OMAR    = u32_out_addr;
+    DMA2D->OOR     = FRAMEBUFFER_WIDTH - width;
+    DMA2D->NLR     = ((uint32_t)width << DMA2D_NLR_PL_Pos) | height;
+    DMA2D->CR     |= DMA2D_CR_START;
+#endif
+}
+
+void framebuffer_wait(void)
+{
+    while (DMA2D->CR & DMA2D_CR_START) {
+    }
+
+    if (g_u8_swap_pending) {
+        g_framebuffer_stats.u32_waits++;
+        while (g_u8_swap_pending) {
+        }
+    }
+    if (g_u8_copy_count != 0u) {
+        framebuffer_copy_forward();
+    }
+}
+
+void framebuffer_draw_rect(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t colour)
+{
+    uint16_t u16_left   = (x0 < x1) ? x0 : x1;
+    uint16_t u16_top    = (y0 < y1) ? y0 : y1;
+    uint16_t u16_width  = (uint16_t)(((x0 < x1) ? (x1 - x0) : (x0 - x1)) + 1u);
+    uint16_t u16_height = (uint16_t)(((y0 < y1) ? (y1 - y0) : (y0 - y1)) + 1u);
+
+    framebuffer_draw_hline(u16_left, u16_top, u16_width, colour);
+    framebuffer_draw_hline(u16_left, u16_top + u16_height - 1u, u16_width, colour);
+    framebuffer_draw_vline(u16_left, u16_top, u16_height, colour);
+    framebuffer_draw_vline(u16_left + u16_width - 1u, u16_top, u16_height, colour);
+}
+
+void framebuffer_draw_hline(uint16_t x, uint16_t y, uint16_t width, uint16_t colour)
+{
+    framebuffer_fill_rect(x, y, width, 1u, colour);
+}
+
+void framebuffer_draw_vline(uint16_t x, uint16_t y, uint16_t height, uint16_t colour)
+{
+    framebuffer_fill_rect(x, y, 1u, height, colour);
+}
+
+void framebuffer_draw_line(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t colour)
+{
+    int32_t s32_dx   = (x1 > x0) ? (int32_t)(x1 - x0) : (int32_t)(x0 - x1);
+    int32_t s32_dy   = (y1 > y0) ? -(int32_t)(y1 - y0) : -(int32_t)(y0 - y1);
+    int32_t s32_sx   = (x1 > x0) ? 1 : -1;
+    int32_t s32_sy   = (y1 > y0) ? 1 : -1;
+    int32_t s32_err  = s32_dx + s32_dy;
+    int32_t s32_x    = x0;
+    int32_t s32_y    = y0;
+    framebuffer_pixel_t pixel = framebuffer_pixel(colour);
+
+    /* Bresenham for all octants, pixels go straight to memory */
+    framebuffer_wait();
+    framebuffer_mark_dirty((x0 < x1) ? x0 : x1, (y0 < y1) ? y0 : y1,
+                           (uint16_t)(s32_dx + 1), (uint16_t)(1 - s32_dy));
+    for (;;) {
+        if (((uint32_t)s32_x < FRAMEBUFFER_WIDTH) && ((uint32_t)s32_y < FRAMEBUFFER_HEIGHT)) {
+            g_p_framebuffer[(uint32_t)s32_y * FRAMEBUFFER_WIDTH + (uint32_t)s32_x] = pixel;
+        }
+        if ((s32_x == x1) && (s32_y == y1)) {
+            break;
+        }
+
+        int32_t s32_err2 = 2 * s32_err;
+        if (s32_err2 >= s32_dy) {
+            s32_err += s32_dy;
+            s32_x   += s32_sx;
+        }
+        if (s32_err2 <= s32_dx) {
+            s32_err += s32_dx;
+            s32_y   += s32_sy;
+        }
+    }
+}
+
+void framebuffer_draw_circle(uint16_t x, uint16_t y, uint16_t r, uint16_t colour, uint8_t filled)
+{
+    int32_t s32_x   = r;
+    int32_t s32_y   = 0;
+    int32_t s32_err = 1 - (int32_t)r;
+
+    /* Midpoint circle, one octant mirrored eight times */
+    while (s32_x >= s32_y) {
+        if (filled) {
+            framebuffer_draw_hline(x - s32_x, y + s32_y, 2 * s32_x + 1, colour);
+            framebuffer_draw_hline(x - s32_x, y - s32_y, 2 * s32_x + 1, colour);
+            framebuffer_draw_hline(x - s32_y, y + s32_x, 2 * s32_y + 1, colour);
+            framebuffer_draw_hline(x - s32_y, y - s32_x, 2 * s32_y + 1, colour);
+        } else {
+            framebuffer_draw_pixel(x + s32_x, y + s32_y, colour);
+            framebuffer_draw_pixel(x + s32_y, y + s32_x, colour);
+            framebuffer_draw_pixel(x - s32_y, y + s32_x, colour);
+            framebuffer_draw_pixel(x - s32_x, y + s32_y, colour);
+            framebuffer_draw_pixel(x - s32_x, y - s32_y, colour);
+            framebuffer_draw_pixel(x - s32_y, y - s32_x, colour);
+            framebuffer_draw_pixel(x + s32_y, y - s32_x, colour);
+            framebuffer_draw_pixel(x + s32_x, y - s32_y, colour);
+        }
+
+        s32_y++;
+        if (s32_err < 0) {
+            s32_err += 2 * s32_y + 1;
+        } else {
+            s32_x--;
+            s32_err += 2 * (s32_y - s32_x) + 1;
+        }
+    }
+}
+
+void framebuffer_draw_text(const char *text, uint16_t x, uint16_t y,
+                           uint16_t colour, uint16_t size, uint16_t bg_colour)
+{
+    while (*text) {
+        framebuffer_draw_char(*text++, x, y, colour, size, bg_colour);
+        x += CHAR_WIDTH * size;
+    }
+}
+
+uint16_t framebuffer_draw_text_font(const char *text, uint16_t x, uint16_t y,
+                                    const ILI9341_Font_t *font, uint16_t colour, uint16_t bg_colour)
+{
+    uint32_t u32_x = x;
+    framebuffer_pixel_t pixel    = framebuffer_pixel(colour);
+    framebuffer_pixel_t bg_pixel = framebuffer_pixel(bg_colour);
+
+    /* Row-packed glyphs, pixels go straight to memory */
+    framebuffer_wait();
+    for (; *text; text++) {
+        uint8_t u8_code = (uint8_t)*text;
+
+        if ((u8_code < font->First) || (u8_code > font->Last)) {
+            u8_code = font->First;
+        }
+
+        const ILI9341_Glyph_t *glyph  = &font->Glyphs[u8_code - font->First];
+        uint16_t u16_stride           = (glyph->Width + 7u) >> 3;
+        uint16_t u16_cell_w           = glyph->Width + font->Spacing;
+
+        for (uint16_t row = 0u; (row < font->Height) && ((uint32_t)y + row < FRAMEBUFFER_HEIGHT); row++) {
+            const uint8_t *pu8_bits = &font->Bitmap[glyph->Offset + row * u16_stride];
+            framebuffer_pixel_t *p_pixel = &g_p_framebuffer[((uint32_t)y + row) * FRAMEBUFFER_WIDTH];
+
+            for (uint16_t col = 0u; (col < u16_cell_w) && (u32_x + col < FRAMEBUFFER_WIDTH); col++) {
+                uint8_t u8_lit = (col < glyph->Width) && (pu8_bits[col >> 3] & (0x80u >> (col & 7u)));
+
+                p_pixel[u32_x + col] = u8_lit ? pixel : bg_pixel;
+            }
+        }
+        u32_x += u16_cell_w;
+    }
+    if (u32_x > x) {
+        framebuffer_mark_dirty(x, y, (u32_x - x > 0xFFFFu) ? 0xFFFFu : (uint16_t)(u32_x - x), font->Height);
+    }
+
+    return (u32_x - x > 0xFFFFu) ? 0xFFFFu : (uint16_t)(u32_x - x);
+}
+
+/* Static module functions -------------------------------------------------- */
+static void framebuffer_draw_char(char ch, uint16_t x, uint16_t y,
+                                  uint16_t colour, uint16_t size, uint16_t bg_colour)
+{
+    uint8_t u8_index = ((uint8_t)ch < ' ') ? 0u : (uint8_t)(ch - ' ');
+
+    if (u8_index >= 96u) {
+        u8_index = 0u;
+    }
+
+    framebuffer_fill_rect(x, y, CHAR_WIDTH * size, CHAR_HEIGHT * size, bg_colour);
+
+#if FRAMEBUFFER_L8
+    /* No blending of indices: the lit font pixels are written directly */
+    if (((uint32_t)x + CHAR_WIDTH * size <= FRAMEBUFFER_WIDTH) &&
+        ((uint32_t)y + CHAR_HEIGHT * size <= FRAMEBUFFER_HEIGHT)) {
+        framebuffer_pixel_t pixel = framebuffer_pixel(colour);
+
+        framebuffer_wait();
+        for (uint16_t row = 0u; row < CHAR_HEIGHT * size; row++) {
+            framebuffer_pixel_t *p_pixel = &g_p_framebuffer[((uint32_t)y + row) * FRAMEBUFFER_WIDTH + x];
+
+            for (uint16_t col = 0u; col < CHAR_WIDTH * size; col++) {
+                if (font[u8_index][col / size] & (1u << (row / size))) {
+                    p_pixel[col] = pixel;
+                }
+            }
+        }
+        return;
+    }
+#else
+    if ((size <= FRAMEBUFFER_GLYPH_MAX_SIZE) &&
+        ((uint32_t)x + CHAR_WIDTH * size <= FRAMEBUFFER_WIDTH) &&
+        ((uint32_t)y + CHAR_HEIGHT * size <= FRAMEBUFFER_HEIGHT)) {
+        uint16_t u16_cell_w = CHAR_WIDTH * size;
+
+        /* Expand the 1 bpp glyph into an A8 cell; the cell is still the
+         * source of the previous blend until the DMA2D is idle */
+        framebuffer_wait();
+        for (uint16_t row = 0u; row < CHAR_HEIGHT * size; row++) {
+            for (uint16_t col = 0u; col < u16_cell_w; col++) {
+                uint8_t u8_bits = font[u8_index][col / size];
+                g_u8_glyph_cell[row * u16_cell_w + col] =
+                    (u8_bits & (1u << (row / size))) ? 0xFFu : 0x00u;
+            }
+        }
+
+        framebuffer_blend_alpha(g_u8_glyph_cell, FRAMEBUFFER_ALPHA_A8,
+                                x, y, u16_cell_w, CHAR_HEIGHT * size, colour);
+        return;
+    }
+#endif
+
+    for (uint8_t col = 0u; col < CHAR_WIDTH; col++) {
+        uint8_t u8_bits = font[u8_index][col];
+
+        for (uint8_t row = 0u; row < CHAR_HEIGHT; row++) {
+            if (u8_bits & (1u << row)) {
+                framebuffer_fill_rect(x + col * size, y + row * size, size, size, colour);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Copies the rectangles of the flipped frame from the front into
+ *        the back frame. The last copy may still run on return.
+ */
+static void framebuffer_copy_forward(void)
+{
+    for (uint8_t i = 0u; i < g_u8_copy_count; i++) {
+        const framebuffer_rect_t *rect = &g_copy[i];
+        uint32_t u32_offset = (uint32_t)rect->u16_y * FRAMEBUFFER_WIDTH + rect->u16_x;
+
+        while (DMA2D->CR & DMA2D_CR_START) {
+        }
+        DMA2D->CR      = FRAMEBUFFER_DMA2D_M2M;
+        DMA2D->FGPFCCR = FRAMEBUFFER_DMA2D_CM_PIXEL;
+        DMA2D->FGMAR   = (uint32_t)&g_p_front[u32_offset];
+        DMA2D->FGOR    = FRAMEBUFFER_WIDTH - rect->u16_width;
+        DMA2D->OMAR    = (uint32_t)&g_p_back[u32_offset];
+        DMA2D->OOR     = FRAMEBUFFER_WIDTH - rect->u16_width;
+        DMA2D->NLR     = ((uint32_t)rect->u16_width << DMA2D_NLR_PL_Pos) | rect->u16_height;
+        DMA2D->CR     |= DMA2D_CR_START;
+
+        g_framebuffer_stats.u32_copy_pixels += (uint32_t)rect->u16_width * rect->u16_height;
+    }
+    g_u8_copy_count = 0u;
+}
+
+/**
+ * @brief Exchanges front and back frame (LTDC interrupt, vertical
+ *        blanking): the immediate reload takes effect before the next
+ *        active line.
+ */
+static void framebuffer_flip(void)
+{
+    framebuffer_pixel_t *p_shown = g_p_back;
+
+    g_p_back  = g_p_front;
+    g_p_front = p_shown;
+    LTDC_Layer1->CFBAR = (uint32_t)p_shown;
+    LTDC->SRCR = LTDC_SRCR_IMR;
+
+    if (g_p_framebuffer == p_shown) {
+        g_p_framebuffer = g_p_back;
+    }
+    g_framebuffer_stats.u32_swaps++;
+
+#if PROFILE_ENABLE
+    uint32_t u32_now = DWT->CYCCNT;
+
+    if (g_framebuffer_stats.u32_swaps > 1u) {
+        profile_add(PROFILE_ZONE_FB_FRAME, u32_now - g_u32_flip_cycles);
+    }
+    profile_add(PROFILE_ZONE_FB_FLIP, u32_now - g_u32_swap_cycles);
+    g_u32_flip_cycles = u32_now;
+#endif
+
+    g_u8_swap_pending = 0u;
+}
+
+static void framebuffer_gpio_init(void)
+{
+    GPIO_InitTypeDef gpio_init_struct;
+
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+    __HAL_RCC_GPIOB_CLK_ENABLE();
+    __HAL_RCC_GPIOC_CLK_ENABLE();
+    __HAL_RCC_GPIOD_CLK_ENABLE();
+    __HAL_RCC_GPIOF_CLK_ENABLE();
+    __HAL_RCC_GPIOG_CLK_ENABLE();
+
+    gpio_init_struct.Mode      = GPIO_MODE_AF_PP;
+    gpio_init_struct.Pull      = GPIO_NOPULL;
+    gpio_init_struct.Speed     = GPIO_SPEED_FREQ_HIGH;
+    gpio_init_struct.Alternate = GPIO_AF14_LTDC;
+
+    /* B5, VSYNC, G2, R4, R5 */
+    gpio_init_struct.Pin = GPIO_PIN_3 | GPIO_PIN_4 | GPIO_PIN_6 |
+                           GPIO_PIN_11 | GPIO_PIN_12;
+    HAL_GPIO_Init(GPIOA, &gpio_init_struct);
+
+    /* B6, B7, G4, G5 */
+    gpio_init_struct.Pin = GPIO_PIN_8 | GPIO_PIN_9 | GPIO_PIN_10 | GPIO_PIN_11;
+    HAL_GPIO_Init(GPIOB, &gpio_init_struct);
+
+    /* HSYNC, G6, R2 */
+    gpio_init_struct.Pin = GPIO_PIN_6 | GPIO_PIN_7 | GPIO_PIN_10;
+    HAL_GPIO_Init(GPIOC, &gpio_init_struct);
+
+    /* G7, B2 */
+    gpio_init_struct.Pin = GPIO_PIN_3 | GPIO_PIN_6;
+    HAL_GPIO_Init(GPIOD, &gpio_init_struct);
+
+    /* DE */
+    gpio_init_struct.Pin = GPIO_PIN_10;
+    HAL_GPIO_Init(GPIOF, &gpio_init_struct);
+
+    /* R7, CLK, B3 */
+    gpio_init_struct.Pin = GPIO_PIN_6 | GPIO_PIN_7 | GPIO_PIN_11;
+    HAL_GPIO_Init(GPIOG, &gpio_init_struct);
+
+    /* R3, R6 on AF9 */
+    gpio_init_struct.Alternate = GPIO_AF9_LTDC;
+    gpio_init_struct.Pin = GPIO_PIN_0 | GPIO_PIN_1;
+    HAL_GPIO_Init(GPIOB, &gpio_init_struct);
+
+    /* G3, B4 on AF9 */
+    gpio_init_struct.Pin = GPIO_PIN_10 | GPIO_PIN_12;
+    HAL_GPIO_Init(GPIOG, &gpio_init_struct);
+}
+
+static HAL_StatusTypeDef framebuffer_ltdc_init(void)
+{
+    RCC_PeriphCLKInitTypeDef periph_clk_init_struct;
+
+    /* Pixel clock: PLL input (1 MHz) * 192 / 4 / 8 = 6 MHz */
+    periph_clk_init_struct.PeriphClockSelection = RCC_PERIPHCLK_LTDC;
+    periph_clk_init_struct.PLLSAI.PLLSAIN       = 192u;
+    periph_clk_init_struct.PLLSAI.PLLSAIR       = 4u;
+    periph_clk_init_struct.PLLSAIDivR           = RCC_PLLSAIDIVR_8;
+
+    if (HAL_RCCEx_PeriphCLKConfig(&periph_clk_init_struct) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    __HAL_RCC_LTDC_CLK_ENABLE();
+
+    g_framebuffer_ltdc_handle_struct.Instance                = LTDC;
+    g_framebuffer_ltdc_handle_struct.Init.HSPolarity         = LTDC_HSPOLARITY_AL;
+    g_framebuffer_ltdc_handle_struct.Init.VSPolarity         = LTDC_VSPOLARITY_AL;
+    g_framebuffer_ltdc_handle_struct.Init.DEPolarity         = LTDC_DEPOLARITY_AL;
+    g_framebuffer_ltdc_handle_struct.Init.PCPolarity         = LTDC_PCPOLARITY_IPC;
+    /* Panel timing: HSYNC 10, HBP 20, HFP 10 / VSYNC 2, VBP 2, VFP 4 */
+    g_framebuffer_ltdc_handle_struct.Init.HorizontalSync     = 9u;
+    g_framebuffer_ltdc_handle_struct.Init.VerticalSync       = 1u;
+    g_framebuffer_ltdc_handle_struct.Init.AccumulatedHBP     = 29u;
+    g_framebuffer_ltdc_handle_struct.Init.AccumulatedVBP     = 3u;
+    g_framebuffer_ltdc_handle_struct.Init.AccumulatedActiveW = 29u + FRAMEBUFFER_WIDTH;
+    g_framebuffer_ltdc_handle_struct.Init.AccumulatedActiveH = 3u + FRAMEBUFFER_HEIGHT;
+    g_framebuffer_ltdc_handle_struct.Init.TotalWidth         = 29u + FRAMEBUFFER_WIDTH + 10u;
+    g_framebuffer_ltdc_handle_struct.Init.TotalHeigh         = 3u + FRAMEBUFFER_HEIGHT + 4u;
+    g_framebuffer_ltdc_handle_struct.Init.Backcolor.Red      = 0u;
+    g_framebuffer_ltdc_handle_struct.Init.Backcolor.Green    = 0u;
+    g_framebuffer_ltdc_handle_struct.Init.Backcolor.Blue     = 0u;
+
+    if (HAL_LTDC_Init(&g_framebuffer_ltdc_handle_struct) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    return framebuffer_layer_init(0u, FRAMEBUFFER_ADDR, 255u,
+                                  LTDC_BLENDING_FACTOR1_CA, LTDC_BLENDING_FACTOR2_CA);
+}
+
+static HAL_StatusTypeDef framebuffer_layer_init(uint32_t u32_layer, uint32_t u32_addr, uint8_t u8_alpha,
+                                                uint32_t u32_factor1, uint32_t u32_factor2)
+{
+    LTDC_LayerCfgTypeDef layer_cfg_struct;
+
+    layer_cfg_struct.WindowX0        = 0u;
+    layer_cfg_struct.WindowX1        = FRAMEBUFFER_WIDTH;
+    layer_cfg_struct.WindowY0        = 0u;
+    layer_cfg_struct.WindowY1        = FRAMEBUFFER_HEIGHT;
+    layer_cfg_struct.PixelFormat     = FRAMEBUFFER_LTDC_FORMAT;
+    layer_cfg_struct.Alpha           = u8_alpha;
+    layer_cfg_struct.Alpha0          = 0u;
+    layer_cfg_struct.BlendingFactor1 = u32_factor1;
+    layer_cfg_struct.BlendingFactor2 = u32_factor2;
+    layer_cfg_struct.FBStartAdress   = u32_addr;
+    layer_cfg_struct.ImageWidth      = FRAMEBUFFER_WIDTH;
+    layer_cfg_struct.ImageHeight     = FRAMEBUFFER_HEIGHT;
+    layer_cfg_struct.Backcolor.Red   = 0u;
+    layer_cfg_struct.Backcolor.Green = 0u;
+    layer_cfg_struct.Backcolor.Blue  = 0u;
+
+#if FRAMEBUFFER_L8
+    if ((HAL_LTDC_ConfigLayer(&g_framebuffer_ltdc_handle_struct, &layer_cfg_struct, u32_layer) != HAL_OK) ||
+        (HAL_LTDC_ConfigCLUT(&g_framebuffer_ltdc_handle_struct, g_u32_framebuffer_clut,
+                             FRAMEBUFFER_CLUT_SIZE, u32_layer) != HAL_OK)) {
+        return HAL_ERROR;
+    }
+
+    return HAL_LTDC_EnableCLUT(&g_framebuffer_ltdc_handle_struct, u32_layer);
+#else
+    return HAL_LTDC_ConfigLayer(&g_framebuffer_ltdc_handle_struct,
+                                &layer_cfg_struct,
+                                u32_layer);
+#endif
+}
+
+#if FRAMEBUFFER_L8
+/**
+ * @brief Fills the CLUT: named colours, then the colour cube (levels 0,
+ *        51, .. 255 per channel), unused entries black.
+ */
+static void framebuffer_clut_init(void)
+{
+    uint32_t u32_index = 0u;
+
+    for (; u32_index < FRAMEBUFFER_NAMED_COLOURS; u32_index++) {
+        g_u32_framebuffer_clut[u32_index] = colour_to_rgb888(g_u16_framebuffer_named[u32_index]);
+    }
+    for (uint32_t u32_r = 0u; u32_r < FRAMEBUFFER_CUBE_LEVELS; u32_r++) {
+        for (uint32_t u32_g = 0u; u32_g < FRAMEBUFFER_CUBE_LEVELS; u32_g++) {
+            for (uint32_t u32_b = 0u; u32_b < FRAMEBUFFER_CUBE_LEVELS; u32_b++) {
+                g_u32_framebuffer_clut[u32_index++] = ((u32_r * 51u) << 16) | ((u32_g * 51u) << 8) | (u32_b * 51u);
+            }
+        }
+    }
+    for (; u32_index < FRAMEBUFFER_CLUT_SIZE; u32_index++) {
+        g_u32_framebuffer_clut[u32_index] = 0u;
+    }
+}
+
+/**
+ * @brief Writes one column of pixels (odd edges of an L8 fill).
+ */
+static void framebuffer_fill_column(uint16_t x, uint16_t y, uint16_t height, framebuffer_pixel_t pixel)
+{
+    framebuffer_pixel_t *p_pixel = &g_p_framebuffer[(uint32_t)y * FRAMEBUFFER_WIDTH + x];
+
+    for (uint16_t row = 0u; row < height; row++) {
+        p_pixel[(uint32_t)row * FRAMEBUFFER_WIDTH] = pixel;
+    }
+}
+#endif
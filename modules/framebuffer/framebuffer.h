@@ -0,0 +1,539 @@
+/**
+ ******************************************************************************
+ * @file        framebuffer.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the SDRAM framebuffer / LTDC display backend.
+ *
+ * @details
+ * The panel is switched from SPI pixel writes to the RGB interface and is
+ * refreshed continuously by the LTDC from an RGB565 framebuffer in the
+ * external SDRAM. Drawing functions only write to memory; the LTDC scans
+ * the buffer out without any CPU involvement.
+ *
+ * The framebuffer uses the native panel orientation (portrait,
+ * FRAMEBUFFER_WIDTH x FRAMEBUFFER_HEIGHT), which matches the rotation
+ * used by lcd_init().
+ *
+ * A second frame in the SDRAM can be shown on top as LTDC layer 2
+ * (framebuffer_overlay_enable()). The LTDC blends both layers during the
+ * scanout: overlay pixels in the key colour are transparent, the others
+ * are mixed with the background by the constant alpha of the layer. A
+ * static screen (labels, frames, scales) is drawn once into the
+ * background, the changing values into the overlay; an update rewrites a
+ * few overlay pixels and never the art below. All drawing functions work
+ * on the layer chosen with framebuffer_select_layer(); erasing in the
+ * overlay means drawing the key colour.
+ *
+ * Layer 1 can be double buffered (framebuffer_double_buffer_enable()):
+ * drawing goes to a back frame while the LTDC shows the front frame.
+ * framebuffer_swap() hands the back frame over; the LTDC line interrupt
+ * at the end of the active area exchanges the layer address during the
+ * vertical blanking, so a frame is never shown half drawn. Afterwards
+ * the rectangles drawn into the new front are copied forward into the
+ * new back by the DMA2D (only those, not the whole frame), before the
+ * next drawing call touches it. The overlay stays single buffered.
+ *
+ * With FRAMEBUFFER_L8 the frames hold one byte per pixel: the LTDC scans
+ * them in L8 format through a colour lookup table holding the colours of
+ * ILI9341_STM32_Driver.h (BLACK .. PINK) and a 6x6x6 colour cube. The
+ * drawing functions keep their RGB565 colour arguments; a named colour is
+ * drawn exactly, any other as the nearest cube colour. This halves frame
+ * memory and scanout bandwidth (SDRAM time left to the datalog). The
+ * DMA2D has no L8 output, so fills are written as RGB565 pixel pairs with
+ * odd edge columns set by the CPU; copies run as 8 bit memory-to-memory
+ * transfers, RGB565 images and alpha maps are converted by the CPU.
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - SDRAM + PLLSAI + LTDC layer 1 bring-up
+ *  - Optional overlay on layer 2 with colour keying and constant alpha
+ *  - Optional double buffering of layer 1, swap at vertical blanking,
+ *    DMA2D copy forward of the dirty rectangles
+ *  - Optional 8 bit indexed colour (L8 with CLUT) instead of RGB565
+ *  - Pixel, line, rectangle, circle and text drawing into the framebuffer
+ *  - Chrom-ART (DMA2D) fills, RGB565 blits and A8/A4 alpha blending
+ *
+ * DMA2D operations are started and the function returns immediately.
+ * Every drawing function waits for a running DMA2D transfer before it
+ * touches the framebuffer, so the order of drawing calls is kept.
+ *
+ * @note The LTDC pins overlap with POTI_1 (PA6), the ESD segments (PD6)
+ *       and the joystick (PG11/PG12). See also sdram.h.
+ *
+ ******************************************************************************
+ */
+
+#ifndef FRAMEBUFFER_FRAMEBUFFER_H_
+#define FRAMEBUFFER_FRAMEBUFFER_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+#include <irq/irq.h>
+#include <lcd/ILI9341_Fonts.h>
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief 1 for 8 bit indexed frames (LTDC L8 with CLUT), 0 for RGB565.
+ */
+#ifndef FRAMEBUFFER_L8
+#define FRAMEBUFFER_L8           0
+#endif
+
+/**
+ * @brief Visible width of the framebuffer in pixels.
+ */
+#define FRAMEBUFFER_WIDTH        240U
+
+/**
+ * @brief Visible height of the framebuffer in pixels.
+ */
+#define FRAMEBUFFER_HEIGHT       320U
+
+/**
+ * @brief Bytes per pixel and size of one frame in bytes.
+ */
+#if FRAMEBUFFER_L8
+#define FRAMEBUFFER_BYTES_PER_PIXEL 1U
+#else
+#define FRAMEBUFFER_BYTES_PER_PIXEL 2U
+#endif
+#define FRAMEBUFFER_FRAME_SIZE   (FRAMEBUFFER_WIDTH * FRAMEBUFFER_HEIGHT * FRAMEBUFFER_BYTES_PER_PIXEL)
+
+/**
+ * @brief Start address of the framebuffer (beginning of the SDRAM).
+ */
+#define FRAMEBUFFER_ADDR         SDRAM_BANK_ADDR
+
+/**
+ * @brief Start address of the overlay frame (directly behind the first).
+ */
+#define FRAMEBUFFER_OVERLAY_ADDR (FRAMEBUFFER_ADDR + FRAMEBUFFER_FRAME_SIZE)
+
+/**
+ * @brief Start address of the back frame of layer 1 (double buffering).
+ */
+#define FRAMEBUFFER_BACK_ADDR    (FRAMEBUFFER_ADDR + 2U * FRAMEBUFFER_FRAME_SIZE)
+
+/**
+ * @brief Copy of the shown frame for screenshots (framebuffer_snapshot()),
+ *        behind the back frame, below the datalog ring.
+ */
+#define FRAMEBUFFER_SNAPSHOT_ADDR (FRAMEBUFFER_ADDR + 3U * FRAMEBUFFER_FRAME_SIZE)
+
+/**
+ * @brief Rectangles remembered per frame for the copy forward; further
+ *        drawing is merged into the last one.
+ */
+#define FRAMEBUFFER_DIRTY_RECTS  8U
+
+/**
+ * @brief Priority of the LTDC line interrupt (swap at vertical blanking).
+ */
+#define FRAMEBUFFER_IRQ_PRIORITY IRQ_CLASS_REFRESH
+
+/**
+ * @brief Default key colour of the overlay (magenta). The LTDC compares
+ *        the key after expanding RGB565 to RGB888; colours whose channels
+ *        are all zero or all one bits compare exactly. With FRAMEBUFFER_L8
+ *        the key is compared with the CLUT entry of the colour.
+ */
+#define FRAMEBUFFER_OVERLAY_KEY  0xF81FU
+
+/**
+ * @brief Largest text scaling factor rendered in a single DMA2D blend.
+ *        Larger sizes fall back to one rectangle fill per font pixel.
+ */
+#define FRAMEBUFFER_GLYPH_MAX_SIZE  4U
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief One pixel of a frame: RGB565 colour or CLUT index.
+ */
+#if FRAMEBUFFER_L8
+typedef uint8_t framebuffer_pixel_t;
+#else
+typedef uint16_t framebuffer_pixel_t;
+#endif
+
+/**
+ * @brief Layers the drawing functions can write to.
+ */
+typedef enum {
+    FRAMEBUFFER_LAYER_BACKGROUND = 0,   /**< LTDC layer 1, always shown      */
+    FRAMEBUFFER_LAYER_OVERLAY           /**< LTDC layer 2, keyed and blended */
+} framebuffer_layer_t;
+
+/**
+ * @brief Formats of alpha maps accepted by framebuffer_blend_alpha().
+ */
+typedef enum {
+    FRAMEBUFFER_ALPHA_A8 = 0,   /**< 8 bit alpha per pixel                  */
+    FRAMEBUFFER_ALPHA_A4        /**< 4 bit alpha per pixel, two per byte     */
+} framebuffer_alpha_format_t;
+
+/**
+ * @brief Rectangle in pixels (dirty rectangles of a frame).
+ */
+typedef struct {
+    uint16_t u16_x;
+    uint16_t u16_y;
+    uint16_t u16_width;
+    uint16_t u16_height;
+} framebuffer_rect_t;
+
+/**
+ * @brief Called by framebuffer_swap() with the rectangles drawn into the
+ *        swapped frame (task context, before the flip).
+ *
+ * @param rects    Rectangles, valid during the call only
+ * @param u8_count Number of rectangles
+ */
+typedef void (*framebuffer_swap_callback_t)(const framebuffer_rect_t *rects, uint8_t u8_count);
+
+/**
+ * @brief Frame pacing of the double buffering. The profile zones
+ *        PROFILE_ZONE_FB_FRAME and PROFILE_ZONE_FB_FLIP add the cycles
+ *        from flip to flip and from framebuffer_swap() to the flip.
+ */
+typedef struct {
+    uint32_t u32_blankings;     /**< Vertical blankings (LTDC frames)       */
+    uint32_t u32_swaps;         /**< Frames flipped                         */
+    uint32_t u32_waits;         /**< Drawing calls held for a pending flip  */
+    uint32_t u32_copy_pixels;   /**< Pixels copied forward                  */
+} framebuffer_stats_t;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Initializes SDRAM, panel RGB interface and LTDC scanout.
+ *
+ * The framebuffer is cleared to black before the layer is enabled.
+ *
+ * @return HAL_OK on success, HAL_ERROR if SDRAM or LTDC init failed.
+ */
+HAL_StatusTypeDef framebuffer_init(void);
+
+/**
+ * @brief Clears the overlay frame to the key colour and shows it as LTDC
+ *        layer 2 on top of the background.
+ *
+ * May be called again to change key and alpha; the overlay is cleared
+ * each time.
+ *
+ * @param key_colour RGB565 colour shown as transparent.
+ * @param u8_alpha   Constant alpha of the other pixels, 255 opaque.
+ * @return HAL_OK, HAL_ERROR if the LTDC rejects the layer.
+ */
+HAL_StatusTypeDef framebuffer_overlay_enable(uint16_t key_colour, uint8_t u8_alpha);
+
+/**
+ * @brief Hides the overlay; drawing goes to the background again.
+ *
+ * @return None
+ */
+void framebuffer_overlay_disable(void);
+
+/**
+ * @brief Changes the constant alpha of the overlay (fades, dimming),
+ *        applied at the next vertical blanking.
+ *
+ * @param u8_alpha Alpha, 0 invisible .. 255 opaque.
+ * @return None
+ */
+void framebuffer_overlay_set_alpha(uint8_t u8_alpha);
+
+/**
+ * @brief Returns the key colour of the overlay.
+ *
+ * @return RGB565 colour.
+ */
+uint16_t framebuffer_overlay_get_key(void);
+
+/**
+ * @brief Switches layer 1 to double buffering: the shown frame is copied
+ *        into the back frame, drawing goes to the back frame from now on.
+ *
+ * @return HAL_OK, HAL_ERROR if the LTDC is not running.
+ */
+HAL_StatusTypeDef framebuffer_double_buffer_enable(void);
+
+/**
+ * @brief Shows the back frame from the next vertical blanking on.
+ *
+ * Returns at once; the next drawing call waits for the flip (at most one
+ * LTDC frame) and for the copy forward.
+ *
+ * @return HAL_OK, HAL_ERROR without double buffering.
+ */
+HAL_StatusTypeDef framebuffer_swap(void);
+
+/**
+ * @brief Returns whether a swap waits for its vertical blanking.
+ *
+ * @return 1 pending, 0 flipped (drawing does not block)
+ */
+uint8_t framebuffer_swap_pending(void);
+
+/**
+ * @brief Adds a rectangle written directly into the back frame to the
+ *        copy forward of the next swap. The drawing functions mark their
+ *        own output.
+ *
+ * @param x      Column of the upper left corner.
+ * @param y      Row of the upper left corner.
+ * @param width  Width in pixels.
+ * @param height Height in pixels.
+ * @return None
+ */
+void framebuffer_mark_dirty(uint16_t x, uint16_t y, uint16_t width, uint16_t height);
+
+/**
+ * @brief Installs the notification of framebuffer_swap() (NULL: none).
+ *
+ * @param callback Function, task context
+ * @return None
+ */
+void framebuffer_set_swap_callback(framebuffer_swap_callback_t callback);
+
+/**
+ * @brief Copies the frame pacing counters.
+ *
+ * @param stats Destination.
+ * @return None
+ */
+void framebuffer_get_stats(framebuffer_stats_t *stats);
+
+/**
+ * @brief Chooses the layer all following drawing calls write to.
+ *
+ * The overlay can only be chosen while it is enabled.
+ *
+ * @param layer FRAMEBUFFER_LAYER_BACKGROUND or FRAMEBUFFER_LAYER_OVERLAY.
+ * @return HAL_OK, HAL_ERROR if the overlay is not enabled.
+ */
+HAL_StatusTypeDef framebuffer_select_layer(framebuffer_layer_t layer);
+
+/**
+ * @brief Returns a pointer to the first pixel of the selected layer (the
+ *        back frame with double buffering).
+ *
+ * Pixels are stored row by row, FRAMEBUFFER_WIDTH pixels per row. Direct
+ * writes need a framebuffer_wait() before them and are copied forward
+ * only if marked with framebuffer_mark_dirty().
+ *
+ * @return Pointer to the frame.
+ */
+framebuffer_pixel_t *framebuffer_get_buffer(void);
+
+/**
+ * @brief Returns a pointer to the frame of layer 1 the LTDC shows.
+ *
+ * With double buffering the frame is not drawn into and stays unchanged
+ * until the next flip (framebuffer_swap_pending() returns 0 from the
+ * flip to the next swap).
+ *
+ * @return Pointer to the frame.
+ */
+const framebuffer_pixel_t *framebuffer_get_front(void);
+
+/**
+ * @brief Copies the frame of layer 1 the LTDC shows into
+ *        FRAMEBUFFER_SNAPSHOT_ADDR with the DMA2D (about 1 ms).
+ *
+ * Returns at once; the copy is complete after the next framebuffer_wait()
+ * (or drawing call). The shown frame stays as it is, the display is not
+ * held.
+ *
+ * @return Pointer to the copy.
+ */
+const framebuffer_pixel_t *framebuffer_snapshot(void);
+
+/**
+ * @brief Returns the RGB565 colour of a pixel value (reverse of
+ *        framebuffer_pixel(), the CLUT entry with FRAMEBUFFER_L8).
+ *
+ * @param pixel Pixel value read from a frame.
+ * @return RGB565 colour.
+ */
+uint16_t framebuffer_colour(framebuffer_pixel_t pixel);
+
+/**
+ * @brief Returns the pixel value of a colour: the colour itself, or its
+ *        CLUT index with FRAMEBUFFER_L8.
+ *
+ * @param colour RGB565 colour.
+ * @return Pixel value for direct writes into framebuffer_get_buffer().
+ */
+framebuffer_pixel_t framebuffer_pixel(uint16_t colour);
+
+/**
+ * @brief Fills the complete framebuffer with one colour.
+ *
+ * @param colour RGB565 colour.
+ * @return None
+ */
+void framebuffer_fill_screen(uint16_t colour);
+
+/**
+ * @brief Sets a single pixel. Out-of-range coordinates are ignored.
+ *
+ * @param x      Column.
+ * @param y      Row.
+ * @param colour RGB565 colour.
+ * @return None
+ */
+void framebuffer_draw_pixel(uint16_t x, uint16_t y, uint16_t colour);
+
+/**
+ * @brief Fills a rectangle given by its upper left corner and size.
+ *
+ * The rectangle is clipped to the framebuffer.
+ *
+ * @param x      Column of the upper left corner.
+ * @param y      Row of the upper left corner.
+ * @param width  Width in pixels.
+ * @param height Height in pixels.
+ * @param colour RGB565 colour.
+ * @return None
+ */
+void framebuffer_fill_rect(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint16_t colour);
+
+/**
+ * @brief Draws the outline of a rectangle given by two corners.
+ *
+ * @param x0     Column of the first corner.
+ * @param y0     Row of the first corner.
+ * @param x1     Column of the second corner.
+ * @param y1     Row of the second corner.
+ * @param colour RGB565 colour.
+ * @return None
+ */
+void framebuffer_draw_rect(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t colour);
+
+/**
+ * @brief Draws a horizontal line starting at (x, y).
+ *
+ * @param x      Column of the left point.
+ * @param y      Row.
+ * @param width  Length in pixels.
+ * @param colour RGB565 colour.
+ * @return None
+ */
+void framebuffer_draw_hline(uint16_t x, uint16_t y, uint16_t width, uint16_t colour);
+
+/**
+ * @brief Draws a vertical line starting at (x, y).
+ *
+ * @param x      Column.
+ * @param y      Row of the topmost point.
+ * @param height Length in pixels.
+ * @param colour RGB565 colour.
+ * @return None
+ */
+void framebuffer_draw_vline(uint16_t x, uint16_t y, uint16_t height, uint16_t colour);
+
+/**
+ * @brief Draws a straight line from (x0, y0) to (x1, y1), both included.
+ *
+ * @param x0     Column of the start point.
+ * @param y0     Row of the start point.
+ * @param x1     Column of the end point.
+ * @param y1     Row of the end point.
+ * @param colour RGB565 colour.
+ * @return None
+ */
+void framebuffer_draw_line(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t colour);
+
+/**
+ * @brief Draws a hollow or filled circle around (x, y).
+ *
+ * @param x      Column of the center.
+ * @param y      Row of the center.
+ * @param r      Radius in pixels.
+ * @param colour RGB565 colour.
+ * @param filled 0 for the outline only, otherwise filled.
+ * @return None
+ */
+void framebuffer_draw_circle(uint16_t x, uint16_t y, uint16_t r, uint16_t colour, uint8_t filled);
+
+/**
+ * @brief Draws a text with the 5x5 library font.
+ *
+ * @param text       Zero terminated string.
+ * @param x          Column of the upper left corner.
+ * @param y          Row of the upper left corner.
+ * @param colour     Text colour.
+ * @param size       Scaling factor of the font.
+ * @param bg_colour  Background colour of the character cells.
+ * @return None
+ */
+void framebuffer_draw_text(const char *text, uint16_t x, uint16_t y,
+                           uint16_t colour, uint16_t size, uint16_t bg_colour);
+
+/**
+ * @brief Draws a text in a proportional bitmap font (ILI9341_Fonts.h).
+ *
+ * The glyphs are expanded straight into the framebuffer, clipped at its
+ * edges.
+ *
+ * @param text       Zero terminated string.
+ * @param x          Column of the upper left corner.
+ * @param y          Row of the upper left corner.
+ * @param font       Font, e.g. &Font_Medium.
+ * @param colour     Text colour.
+ * @param bg_colour  Background colour of the glyph cells.
+ * @return Width of the text in pixels.
+ */
+uint16_t framebuffer_draw_text_font(const char *text, uint16_t x, uint16_t y,
+                                    const ILI9341_Font_t *font, uint16_t colour, uint16_t bg_colour);
+
+/**
+ * @brief Copies an RGB565 image into the framebuffer (DMA2D memory-to-memory,
+ *        converted per pixel by the CPU with FRAMEBUFFER_L8).
+ *
+ * The image is clipped to the framebuffer. It must stay valid until the
+ * transfer has finished (see framebuffer_wait()).
+ *
+ * @param image  Pointer to width * height RGB565 pixels, row by row.
+ * @param x      Column of the upper left corner.
+ * @param y      Row of the upper left corner.
+ * @param width  Image width in pixels.
+ * @param height Image height in pixels.
+ * @return None
+ */
+void framebuffer_blit(const uint16_t *image, uint16_t x, uint16_t y,
+                      uint16_t width, uint16_t height);
+
+/**
+ * @brief Blends a solid colour through an alpha map onto the framebuffer.
+ *
+ * Used for anti-aliased glyphs: every alpha value mixes 'colour' with the
+ * pixel already in the framebuffer. The map must stay valid until the
+ * transfer has finished. A4 maps need an even width. Indexed frames
+ * (FRAMEBUFFER_L8) cannot mix colours: pixels with alpha of at least one
+ * half are set to 'colour', the others are kept.
+ *
+ * @param alpha  Alpha map, row by row.
+ * @param format FRAMEBUFFER_ALPHA_A8 or FRAMEBUFFER_ALPHA_A4.
+ * @param x      Column of the upper left corner.
+ * @param y      Row of the upper left corner.
+ * @param width  Map width in pixels.
+ * @param height Map height in pixels.
+ * @param colour RGB565 foreground colour.
+ * @return None
+ */
+void framebuffer_blend_alpha(const uint8_t *alpha, framebuffer_alpha_format_t format,
+                             uint16_t x, uint16_t y, uint16_t width, uint16_t height,
+                             uint16_t colour);
+
+/**
+ * @brief Waits until the DMA2D has finished the last drawing operation;
+ *        with double buffering also for a pending flip and the copy
+ *        forward after it.
+ *
+ * @return None
+ */
+void framebuffer_wait(void);
+
+#endif /* FRAMEBUFFER_FRAMEBUFFER_H_ */
@@ -0,0 +1,254 @@
+/**
+ ******************************************************************************
+ * @file        freqmeter.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Reciprocal frequency and period meter: TIM2 input captures,
+ *              circular DMA per input, lap count per ring.
+ *
+ * Functionality:
+ * - Channel setup through the HAL on the timebase handle, capture and
+ *   its DMA request enabled on register level (the HAL capture callbacks
+ *   stay free)
+ * - Capture count = laps * FREQMETER_RING_LENGTH + DMA position; a lap
+ *   whose interrupt is still pending (masked or same priority) is added
+ *   when the position is in the lower half of the ring
+ * - Gate: opening and closing edge are stamps of the ring, the edges
+ *   in between come from the count
+ *
+ * Resources:
+ * - TIM2 CH1..CH4 (timebase), DMA1 S5 / S6 / S1 / S7 channel 3 (dma_alloc)
+ ******************************************************************************
+ */
+
+#include "freqmeter.h"
+#include "dma_alloc/dma_alloc.h"
+#include "timebase/timebase.h"
+#include "utils/utils.h"
+
+/* Static module variables -------------------------------------------------- */
+/**
+ * @brief DMA request per channel index (TIM_CHANNEL_x / 4).
+ */
+static const dma_alloc_request_t g_freqmeter_requests[4] = {
+    DMA_ALLOC_REQ_TIM2_CH1, DMA_ALLOC_REQ_TIM2_CH2, DMA_ALLOC_REQ_TIM2_CH3, DMA_ALLOC_REQ_TIM2_CH4
+};
+
+/**
+ * @brief Channels in use, bit per channel index.
+ */
+static uint8_t g_u8_freqmeter_channels = 0u;
+
+/* Static function prototypes ----------------------------------------------- */
+static void freqmeter_lap(DMA_HandleTypeDef *hdma);
+static void freqmeter_half(DMA_HandleTypeDef *hdma);
+
+/* Public functions --------------------------------------------------------- */
+HAL_StatusTypeDef freqmeter_init(freqmeter_t *meter, const freqmeter_config_t *config)
+{
+    GPIO_InitTypeDef gpio_init_struct;
+    TIM_IC_InitTypeDef tim_ic_init_struct;
+    TIM_HandleTypeDef *p_timer;
+    uint32_t u32_index = config->u32_channel / 4u;
+
+    if ((config->u32_channel > TIM_CHANNEL_4) || ((config->u32_channel & 3u) != 0u) ||
+        (config->u32_filter > 15u) || (config->port == NULL)) {
+        return HAL_ERROR;
+    }
+    if ((g_u8_freqmeter_channels & (1u << u32_index)) != 0u) {
+        return HAL_BUSY;
+    }
+
+    /* The captures are stamps of the system time */
+    p_timer = timebase_get_timer();
+    if ((p_timer == NULL) && (timebase_init() == HAL_OK)) {
+        p_timer = timebase_get_timer();
+    }
+    if (p_timer == NULL) {
+        return HAL_BUSY;
+    }
+
+    if (dma_alloc_claim(&meter->dma, g_freqmeter_requests[u32_index], DMA_ALLOC_LATENCY_SAMPLED,
+                        HEALTH_ISR_COUNT) != HAL_OK) {
+        return HAL_BUSY;
+    }
+    g_u8_freqmeter_channels |= (uint8_t)(1u << u32_index);
+
+    meter->config         = *config;
+    meter->u32_laps       = 0u;
+    meter->u32_gate_count = 0u;
+    meter->u32_gate_stamp = 0u;
+    meter->u8_gate_open   = 0u;
+
+    utils_gpio_clock_enable(config->port);
+    gpio_init_struct.Pin       = config->pin;
+    gpio_init_struct.Mode      = GPIO_MODE_AF_PP;
+    gpio_init_struct.Pull      = config->u32_pull;
+    gpio_init_struct.Speed     = GPIO_SPEED_FREQ_MEDIUM;
+    gpio_init_struct.Alternate = GPIO_AF1_TIM2;
+    HAL_GPIO_Init(config->port, &gpio_init_struct);
+
+    meter->dma.Init.Direction           = DMA_PERIPH_TO_MEMORY;
+    meter->dma.Init.PeriphInc           = DMA_PINC_DISABLE;
+    meter->dma.Init.MemInc              = DMA_MINC_ENABLE;
+    meter->dma.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+    meter->dma.Init.MemDataAlignment    = DMA_MDATAALIGN_WORD;
+    meter->dma.Init.Mode                = DMA_CIRCULAR;
+    meter->dma.Init.FIFOMode            = DMA_FIFOMODE_DISABLE;
+    meter->dma.Parent                   = meter;
+    HAL_DMA_Init(&meter->dma);
+    meter->dma.XferCpltCallback         = freqmeter_lap;
+    /* Half transfer interrupt only for a capture callback */
+    meter->dma.XferHalfCpltCallback     = (config->callback != NULL) ? freqmeter_half : NULL;
+    meter->dma.XferErrorCallback        = NULL;
+    meter->dma.XferAbortCallback        = NULL;
+
+    tim_ic_init_struct.ICPolarity  = config->u32_polarity;
+    tim_ic_init_struct.ICSelection = TIM_ICSELECTION_DIRECTTI;
+    tim_ic_init_struct.ICPrescaler = config->u32_prescaler;
+    tim_ic_init_struct.ICFilter    = config->u32_filter;
+    HAL_TIM_IC_ConfigChannel(p_timer, &tim_ic_init_struct, config->u32_channel);
+
+    HAL_NVIC_SetPriority(dma_alloc_get_irqn(&meter->dma), FREQMETER_IRQ_PRIORITY, 0u);
+    HAL_NVIC_EnableIRQ(dma_alloc_get_irqn(&meter->dma));
+
+    /* CCRx of the channel into the ring, no capture interrupt */
+    HAL_DMA_Start_IT(&meter->dma, (uint32_t)(uintptr_t)(&TIMEBASE_TIM->CCR1 + u32_index),
+                     (uint32_t)(uintptr_t)meter->u32_ring, FREQMETER_RING_LENGTH);
+    meter->u8_ready = 1u;
+    TIMEBASE_TIM->DIER |= TIM_DIER_CC1DE << u32_index;
+    TIMEBASE_TIM->CCER |= TIM_CCER_CC1E << config->u32_channel;
+
+    return HAL_OK;
+}
+
+void freqmeter_deinit(freqmeter_t *meter)
+{
+    uint32_t u32_index = meter->config.u32_channel / 4u;
+
+    if (!meter->u8_ready) {
+        return;
+    }
+
+    TIMEBASE_TIM->CCER &= ~(TIM_CCER_CC1E << meter->config.u32_channel);
+    TIMEBASE_TIM->DIER &= ~(TIM_DIER_CC1DE << u32_index);
+    HAL_NVIC_DisableIRQ(dma_alloc_get_irqn(&meter->dma));
+    (void)HAL_DMA_Abort(&meter->dma);
+    (void)HAL_DMA_DeInit(&meter->dma);
+    dma_alloc_release(&meter->dma);
+
+    meter->u8_ready = 0u;
+    g_u8_freqmeter_channels &= (uint8_t)~(1u << u32_index);
+}
+
+uint32_t freqmeter_get_count(freqmeter_t *meter)
+{
+    uint32_t u32_laps;
+    uint32_t u32_position;
+    uint32_t u32_pending;
+
+    if (!meter->u8_ready) {
+        return 0u;
+    }
+
+    do {
+        u32_laps     = meter->u32_laps;
+        u32_position = (FREQMETER_RING_LENGTH - __HAL_DMA_GET_COUNTER(&meter->dma)) &
+                       (FREQMETER_RING_LENGTH - 1u);
+        u32_pending  = __HAL_DMA_GET_FLAG(&meter->dma, __HAL_DMA_GET_TC_FLAG_INDEX(&meter->dma));
+    } while (u32_laps != meter->u32_laps);
+
+    /* Lapped, interrupt not served yet */
+    if ((u32_pending != 0u) && (u32_position < FREQMETER_RING_LENGTH / 2u)) {
+        u32_laps++;
+    }
+
+    return u32_laps * FREQMETER_RING_LENGTH + u32_position;
+}
+
+HAL_StatusTypeDef freqmeter_measure(freqmeter_t *meter, uint32_t u32_gate_us, uint32_t u32_timeout_us,
+                                    freqmeter_result_t *result)
+{
+    uint32_t u32_count = freqmeter_get_count(meter);
+    uint32_t u32_stamp;
+    uint32_t u32_idle;
+    uint32_t u32_edges;
+    uint32_t u32_periods;
+    uint64_t u64_freq;
+
+    if (!meter->u8_ready) {
+        return HAL_ERROR;
+    }
+    if (u32_count == 0u) {
+        return HAL_BUSY;
+    }
+
+    u32_stamp = freqmeter_get_stamp(meter, u32_count - 1u);
+
+    if (!meter->u8_gate_open) {
+        meter->u32_gate_count = u32_count;
+        meter->u32_gate_stamp = u32_stamp;
+        meter->u8_gate_open   = 1u;
+        return HAL_BUSY;
+    }
+
+    if (u32_count == meter->u32_gate_count) {
+        u32_idle = timebase_now32() - u32_stamp;
+        if ((u32_timeout_us != 0u) && (u32_idle > u32_timeout_us)) {
+            result->u32_edges    = 0u;
+            result->u32_span_us  = u32_idle;
+            result->u32_freq_mhz = 0u;
+            return HAL_TIMEOUT;
+        }
+        return HAL_BUSY;
+    }
+
+    if ((u32_stamp - meter->u32_gate_stamp) < u32_gate_us) {
+        return HAL_BUSY;
+    }
+
+    /* ICPSC: 1 << (bits / 4) input edges per capture */
+    u32_edges   = (u32_count - meter->u32_gate_count) << (meter->config.u32_prescaler >> TIM_CCMR1_IC1PSC_Pos);
+    u32_periods = (meter->config.u32_polarity == TIM_ICPOLARITY_BOTHEDGE) ? 2u : 1u;
+
+    result->u32_edges   = u32_edges;
+    result->u32_span_us = u32_stamp - meter->u32_gate_stamp;
+    u64_freq = ((uint64_t)u32_edges * (uint64_t)TIMEBASE_HZ * 1000u) /
+               ((uint64_t)result->u32_span_us * u32_periods);
+    result->u32_freq_mhz = (u64_freq > 0xFFFFFFFFULL) ? 0xFFFFFFFFUL : (uint32_t)u64_freq;
+
+    /* The closing edge opens the next gate */
+    meter->u32_gate_count = u32_count;
+    meter->u32_gate_stamp = u32_stamp;
+
+    return HAL_OK;
+}
+
+/* Static functions --------------------------------------------------------- */
+/**
+ * @brief Transfer complete of the ring (flag cleared by the HAL): one lap.
+ *
+ * @param hdma DMA handle of the instance
+ */
+static void freqmeter_lap(DMA_HandleTypeDef *hdma)
+{
+    freqmeter_t *meter = (freqmeter_t *)hdma->Parent;
+
+    meter->u32_laps++;
+    if (meter->config.callback != NULL) {
+        meter->config.callback(meter->config.context);
+    }
+}
+
+/**
+ * @brief Half transfer of the ring (capture callback set): half a lap.
+ *
+ * @param hdma DMA handle of the instance
+ */
+static void freqmeter_half(DMA_HandleTypeDef *hdma)
+{
+    freqmeter_t *meter = (freqmeter_t *)hdma->Parent;
+
+    meter->config.callback(meter->config.context);
+}
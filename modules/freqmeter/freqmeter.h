@@ -0,0 +1,175 @@
+/**
+ ******************************************************************************
+ * @file        freqmeter.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the reciprocal frequency and period
+ *              meter on the input captures of the system timebase.
+ *
+ * @details
+ * Each input is one capture channel of TIM2 (the 1 MHz system timebase,
+ * CH1..CH4, AF1). The timer latches every input edge - or every 2nd, 4th,
+ * 8th with the capture prescaler - and a circular DMA moves the stamps
+ * into the ring of the instance. The only interrupt is the transfer
+ * complete of the ring, once per FREQMETER_RING_LENGTH captures; its lap
+ * count and the DMA position give the total number of captures.
+ *
+ * freqmeter_measure() counts reciprocally: a gate opens at a captured
+ * edge and closes at the first captured edge after u32_gate_us, the
+ * result is the number of input edges over the exact time between the
+ * two edges. Both ends are input edges, so the error is one timebase
+ * tick (1 us) per gate at any input frequency:
+ *
+ *  - 1 kHz, 100 ms gate:  100 edges,    1e-5 relative
+ *  - 1 MHz, 100 ms gate:  ICPSC 8, 12500 captures, 1e-5 relative
+ *  - 10 mHz:              the gate closes at the next edge (100 s)
+ *
+ * The next gate starts at the closing edge, no edge is lost between two
+ * results. Inputs without edges for u32_timeout_us read as 0 Hz.
+ *
+ * The stamps stay available for users that need the single edges (fan
+ * tacho RPM, raw edge stream): freqmeter_get_count() and
+ * freqmeter_get_stamp().
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - Up to four inputs at the same time (TIM2 CH1..CH4), each with its
+ *    own DMA request (dma_alloc)
+ *  - Capture prescaler 1/2/4/8 and input filter per input, rising,
+ *    falling or both edges
+ *  - Interrupt load: one DMA interrupt per ring lap, none per edge; with
+ *    a capture callback (e.g. an overspeed check) one per half ring
+ *
+ * The ring must not lap while a reader copies a stamp: at 1 MHz with
+ * ICPSC 8 the 16 entries last 128 us.
+ *
+ ******************************************************************************
+ */
+
+#ifndef FREQMETER_FREQMETER_H_
+#define FREQMETER_FREQMETER_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+#include "irq/irq.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief Stamps per input (power of two), also the captures per lap
+ *        interrupt.
+ */
+#ifndef FREQMETER_RING_LENGTH
+#define FREQMETER_RING_LENGTH   16U
+#endif
+
+#if (FREQMETER_RING_LENGTH < 4U) || ((FREQMETER_RING_LENGTH & (FREQMETER_RING_LENGTH - 1U)) != 0U)
+#error "FREQMETER_RING_LENGTH must be a power of two of at least 4"
+#endif
+
+/**
+ * @brief NVIC preemption priority of the lap interrupt (DMA stream).
+ */
+#define FREQMETER_IRQ_PRIORITY  IRQ_CLASS_CAPTURE
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Called from the DMA interrupt after every FREQMETER_RING_LENGTH / 2
+ *        captures, must be short.
+ */
+typedef void (*freqmeter_callback_t)(void *context);
+
+/**
+ * @brief Wiring and capture setup of one input.
+ */
+typedef struct {
+    GPIO_TypeDef *port;         /**< Port of the TIM2 channel pin          */
+    uint16_t      pin;          /**< Pin (GPIO_PIN_x), AF1                 */
+    uint32_t      u32_pull;     /**< GPIO_NOPULL, GPIO_PULLUP, ...         */
+    uint32_t      u32_channel;  /**< TIM_CHANNEL_1 .. TIM_CHANNEL_4        */
+    uint32_t      u32_polarity; /**< TIM_ICPOLARITY_RISING / _FALLING / _BOTHEDGE */
+    uint32_t      u32_prescaler;/**< TIM_ICPSC_DIV1 .. TIM_ICPSC_DIV8      */
+    uint32_t      u32_filter;   /**< Input filter 0..15                    */
+    freqmeter_callback_t callback; /**< Per half ring, NULL: none          */
+    void         *context;      /**< Passed to the callback                */
+} freqmeter_config_t;
+
+/**
+ * @brief One input, provided by the user.
+ */
+typedef struct {
+    freqmeter_config_t config;
+    DMA_HandleTypeDef  dma;
+    volatile uint32_t  u32_ring[FREQMETER_RING_LENGTH];
+    volatile uint32_t  u32_laps;        /**< Ring laps (lap interrupt)      */
+    uint32_t           u32_gate_count;  /**< Captures at the gate opening   */
+    uint32_t           u32_gate_stamp;  /**< Stamp of the opening edge      */
+    uint8_t            u8_gate_open;
+    uint8_t            u8_ready;
+} freqmeter_t;
+
+/**
+ * @brief One closed gate.
+ */
+typedef struct {
+    uint32_t u32_edges;         /**< Input edges in the gate (captures * ICPSC) */
+    uint32_t u32_span_us;       /**< Opening to closing edge               */
+    uint32_t u32_freq_mhz;      /**< Frequency in mHz, saturated           */
+} freqmeter_result_t;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Starts the capture of an input (starts the timebase if needed).
+ *
+ * @param meter  Instance, lives as long as the capture runs
+ * @param config Wiring and capture setup, copied
+ * @return HAL_OK, HAL_BUSY if the channel or its DMA stream is taken,
+ *         HAL_ERROR for an invalid setup
+ */
+HAL_StatusTypeDef freqmeter_init(freqmeter_t *meter, const freqmeter_config_t *config);
+
+/**
+ * @brief Stops the capture and frees the DMA stream.
+ *
+ * @param meter Instance
+ * @return None
+ */
+void freqmeter_deinit(freqmeter_t *meter);
+
+/**
+ * @brief Returns the number of captures since freqmeter_init(), any
+ *        context.
+ *
+ * @param meter Instance
+ * @return Captures (wraps at 2^32), 0 before the init
+ */
+uint32_t freqmeter_get_count(freqmeter_t *meter);
+
+/**
+ * @brief Returns the stamp of a capture.
+ *
+ * @param meter    Instance
+ * @param u32_index Capture number, valid for the last
+ *                 FREQMETER_RING_LENGTH - 1 below freqmeter_get_count()
+ * @return Timebase stamp in us
+ */
+static inline uint32_t freqmeter_get_stamp(const freqmeter_t *meter, uint32_t u32_index)
+{
+    return meter->u32_ring[u32_index & (FREQMETER_RING_LENGTH - 1U)];
+}
+
+/**
+ * @brief Reciprocal measurement: closes the open gate at the newest edge
+ *        once it spans u32_gate_us and opens the next one there.
+ *
+ * @param meter          Instance
+ * @param u32_gate_us    Shortest gate
+ * @param u32_timeout_us No edge for this long reads as 0 Hz, 0 = never
+ * @param result         Set on HAL_OK and HAL_TIMEOUT
+ * @return HAL_OK a gate closed, HAL_BUSY still open (or no edge yet),
+ *         HAL_TIMEOUT no edge within u32_timeout_us, HAL_ERROR not started
+ */
+HAL_StatusTypeDef freqmeter_measure(freqmeter_t *meter, uint32_t u32_gate_us, uint32_t u32_timeout_us,
+                                    freqmeter_result_t *result);
+
+#endif /* FREQMETER_FREQMETER_H_ */
@@ -0,0 +1,472 @@
+/**
+ ******************************************************************************
+ * @file        fw_update.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       In-application firmware update into the other flash bank
+ *
+ * Functionality:
+ * - Header first, then only the sectors the image needs are erased, one
+ *   per run, started and polled like the ones of modules/params
+ * - Image bytes are assembled into words and programmed word by word
+ *   (about 16 us each), the last word padded with 0xFF
+ * - The CRC is taken over the flash contents in one call (main loop, the
+ *   CRC unit has no other user in this context)
+ * - FLASH_CR SNB names the physical sectors, the other bank is sectors
+ *   0..9 (running from bank 2) or 12..21 (running from bank 1)
+ *
+ * Resources:
+ * - Flash bank not running (sectors 0..9 of it), option byte BFB2
+ * - CRC unit, FLASH controller from the main loop
+ ******************************************************************************
+ */
+
+#include "fw_update.h"
+#include "fmt/fmt.h"
+
+/* Preprocessor Defines ----------------------------------------------------- */
+/**
+ * @brief Size of the stream header.
+ */
+#define FW_UPDATE_HEADER_SIZE   12U
+
+/**
+ * @brief Sectors of the image in a bank.
+ */
+#define FW_UPDATE_SECTORS       10U
+
+/**
+ * @brief Error flags of an erase or program operation.
+ */
+#define FW_UPDATE_FLASH_ERRORS  (FLASH_FLAG_OPERR | FLASH_FLAG_WRPERR | FLASH_FLAG_PGAERR | \
+                                 FLASH_FLAG_PGPERR | FLASH_FLAG_PGSERR)
+
+/**
+ * @brief Range of a plausible initial stack pointer (SRAM1..3).
+ */
+#define FW_UPDATE_SRAM_START    0x20000000UL
+#define FW_UPDATE_SRAM_END      0x20030000UL
+
+/**
+ * @brief Start of the running image (vector table of the new one).
+ */
+#define FW_UPDATE_RUN_ADDR      0x08000000UL
+
+/* Static module variables -------------------------------------------------- */
+/**
+ * @brief Sizes of the sectors of a bank, in KB.
+ */
+static const uint16_t g_u16_fw_update_sector_kb[FW_UPDATE_SECTORS] = {
+    16u, 16u, 16u, 16u, 64u, 128u, 128u, 128u, 128u, 128u
+};
+
+static CRC_HandleTypeDef g_fw_update_crc;
+
+static fw_update_state_t g_fw_update_state = FW_UPDATE_IDLE;
+
+/**
+ * @brief Stream header, then the image: size, CRC, bytes in flash.
+ */
+static uint8_t g_u8_fw_update_header[FW_UPDATE_HEADER_SIZE];
+static uint8_t g_u8_fw_update_header_fill = 0u;
+static uint32_t g_u32_fw_update_size = 0u;
+static uint32_t g_u32_fw_update_crc = 0u;
+static uint32_t g_u32_fw_update_written = 0u;
+
+/**
+ * @brief Word being assembled and its byte count.
+ */
+static uint32_t g_u32_fw_update_word = 0u;
+static uint8_t g_u8_fw_update_word_fill = 0u;
+
+/**
+ * @brief Next sector to erase, sectors of the image, erase running.
+ */
+static uint8_t g_u8_fw_update_sector = 0u;
+static uint8_t g_u8_fw_update_sectors = 0u;
+static uint8_t g_u8_fw_update_erasing = 0u;
+
+/**
+ * @brief Tick of the last byte (timeout) or of the swap (reset).
+ */
+static uint32_t g_u32_fw_update_tick = 0u;
+
+/**
+ * @brief Flow control line not sent yet (sink busy).
+ */
+static char g_ch_fw_update_line[24];
+static fmt_t g_fw_update_line;
+static uint8_t g_u8_fw_update_line_pending = 0u;
+
+/* Static function prototypes ----------------------------------------------- */
+static uint32_t fw_update_sector_num(uint8_t u8_sector);
+static uint32_t fw_update_word(const uint8_t *pu8_data);
+static void fw_update_reply(const char *pch_text, uint8_t u8_number, uint32_t u32_value);
+static void fw_update_fail(const char *pch_reason);
+static void fw_update_header(void);
+static void fw_update_erase(void);
+static void fw_update_erase_done(void);
+static uint16_t fw_update_program(const uint8_t *pu8_data, uint16_t u16_size);
+static void fw_update_verify(void);
+
+/* Public functions --------------------------------------------------------- */
+HAL_StatusTypeDef fw_update_begin(void)
+{
+    if ((g_fw_update_state != FW_UPDATE_IDLE) && (g_fw_update_state != FW_UPDATE_VERIFIED) &&
+        (g_fw_update_state != FW_UPDATE_FAILED)) {
+        return HAL_BUSY;
+    }
+
+    g_u8_fw_update_header_fill = 0u;
+    g_u32_fw_update_size       = 0u;
+    g_u32_fw_update_written    = 0u;
+    g_u8_fw_update_word_fill   = 0u;
+    g_u32_fw_update_tick       = HAL_GetTick();
+    g_fw_update_state          = FW_UPDATE_HEADER;
+    fw_update_reply("fw ready", 0u, 0u);
+
+    return HAL_OK;
+}
+
+void fw_update_abort(void)
+{
+    /* A running erase is completed by the next fw_update_poll() */
+    if (g_fw_update_state != FW_UPDATE_SWAPPING) {
+        g_fw_update_state = FW_UPDATE_IDLE;
+    }
+}
+
+uint8_t fw_update_poll(fw_update_read_t read, fw_update_write_t write)
+{
+    uint8_t u8_data[FW_UPDATE_CHUNK_BYTES];
+    uint16_t u16_count;
+    uint16_t u16_used;
+
+    if (g_u8_fw_update_line_pending &&
+        (write(fmt_get(&g_fw_update_line), g_fw_update_line.u16_length) == HAL_OK)) {
+        g_u8_fw_update_line_pending = 0u;
+    }
+
+    if (g_u8_fw_update_erasing) {
+        if (__HAL_FLASH_GET_FLAG(FLASH_FLAG_BSY)) {
+            return (g_fw_update_state == FW_UPDATE_ERASING) ? 1u : 0u;
+        }
+        fw_update_erase_done();
+    }
+
+    switch (g_fw_update_state) {
+    case FW_UPDATE_HEADER:
+        u16_count = read(&g_u8_fw_update_header[g_u8_fw_update_header_fill],
+                         (uint16_t)(FW_UPDATE_HEADER_SIZE - g_u8_fw_update_header_fill));
+        if (u16_count > 0u) {
+            g_u32_fw_update_tick = HAL_GetTick();
+            g_u8_fw_update_header_fill = (uint8_t)(g_u8_fw_update_header_fill + u16_count);
+            if (g_u8_fw_update_header_fill == FW_UPDATE_HEADER_SIZE) {
+                fw_update_header();
+            }
+        }
+        break;
+
+    case FW_UPDATE_ERASING:
+        fw_update_erase();
+        break;
+
+    case FW_UPDATE_RECEIVING:
+        /* An erase of modules/params would stall the word programming */
+        if (__HAL_FLASH_GET_FLAG(FLASH_FLAG_BSY) || g_u8_fw_update_line_pending) {
+            break;
+        }
+        u16_count = read(u8_data, (uint16_t)FW_UPDATE_CHUNK_BYTES);
+        if (u16_count > 0u) {
+            g_u32_fw_update_tick = HAL_GetTick();
+            u16_used = fw_update_program(u8_data, u16_count);
+            if (g_fw_update_state != FW_UPDATE_RECEIVING) {
+                break;
+            }
+            if (u16_used < u16_count) {
+                fw_update_fail("length");
+            } else if (g_u32_fw_update_written == g_u32_fw_update_size) {
+                fw_update_verify();
+            } else if ((g_u32_fw_update_written % FW_UPDATE_CHUNK_BYTES) == 0u) {
+                fw_update_reply("fw ack ", 1u, g_u32_fw_update_written);
+            }
+        }
+        break;
+
+    case FW_UPDATE_SWAPPING:
+        if ((HAL_GetTick() - g_u32_fw_update_tick) >= FW_UPDATE_SWAP_DELAY_MS) {
+            NVIC_SystemReset();
+        }
+        return 0u;
+
+    default:
+        return 0u;
+    }
+
+    if (((g_fw_update_state == FW_UPDATE_HEADER) || (g_fw_update_state == FW_UPDATE_RECEIVING)) &&
+        ((HAL_GetTick() - g_u32_fw_update_tick) > FW_UPDATE_TIMEOUT_MS)) {
+        fw_update_fail("timeout");
+    }
+
+    return ((g_fw_update_state == FW_UPDATE_HEADER) || (g_fw_update_state == FW_UPDATE_ERASING) ||
+            (g_fw_update_state == FW_UPDATE_RECEIVING)) ? 1u : 0u;
+}
+
+HAL_StatusTypeDef fw_update_swap(void)
+{
+    FLASH_AdvOBProgramInitTypeDef option;
+    HAL_StatusTypeDef status;
+
+    if (g_fw_update_state != FW_UPDATE_VERIFIED) {
+        return HAL_ERROR;
+    }
+
+    /* BFB2 set: the bootloader starts bank 2 if its vector table is valid, else bank 1 */
+    option.OptionType = OPTIONBYTE_BOOTCONFIG;
+    option.BootConfig = (fw_update_get_bank() == 1u) ? OB_DUAL_BOOT_ENABLE : OB_DUAL_BOOT_DISABLE;
+
+    HAL_FLASH_Unlock();
+    HAL_FLASH_OB_Unlock();
+    status = HAL_FLASHEx_AdvOBProgram(&option);
+    if (status == HAL_OK) {
+        status = HAL_FLASH_OB_Launch();
+    }
+    HAL_FLASH_OB_Lock();
+    HAL_FLASH_Lock();
+
+    if (status != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    g_u32_fw_update_tick = HAL_GetTick();
+    g_fw_update_state    = FW_UPDATE_SWAPPING;
+
+    return HAL_OK;
+}
+
+uint8_t fw_update_get_bank(void)
+{
+    __HAL_RCC_SYSCFG_CLK_ENABLE();
+
+    return (SYSCFG->MEMRMP & SYSCFG_MEMRMP_UFB_MODE) ? 2u : 1u;
+}
+
+void fw_update_get_status(fw_update_status_t *status)
+{
+    status->state       = g_fw_update_state;
+    status->u8_bank     = fw_update_get_bank();
+    status->u32_size    = g_u32_fw_update_size;
+    status->u32_written = g_u32_fw_update_written;
+    status->u32_crc     = g_u32_fw_update_crc;
+}
+
+/* Static functions --------------------------------------------------------- */
+/**
+ * @brief Returns the physical sector number of a sector of the other bank.
+ *
+ * @param u8_sector Sector in the bank, 0..FW_UPDATE_SECTORS - 1
+ * @return FLASH_SECTOR_x
+ */
+static uint32_t fw_update_sector_num(uint8_t u8_sector)
+{
+    return (fw_update_get_bank() == 1u) ? (FLASH_SECTOR_12 + u8_sector) : (FLASH_SECTOR_0 + u8_sector);
+}
+
+/**
+ * @brief Reads a little endian word.
+ *
+ * @param pu8_data Bytes
+ * @return Word
+ */
+static uint32_t fw_update_word(const uint8_t *pu8_data)
+{
+    return (uint32_t)pu8_data[0] | ((uint32_t)pu8_data[1] << 8) |
+           ((uint32_t)pu8_data[2] << 16) | ((uint32_t)pu8_data[3] << 24);
+}
+
+/**
+ * @brief Sends a flow control line, or keeps it for the next run if the
+ *        sink is busy.
+ *
+ * @param pch_text  Text
+ * @param u8_number 1: u32_value follows the text
+ * @param u32_value Number
+ * @return None
+ */
+static void fw_update_reply(const char *pch_text, uint8_t u8_number, uint32_t u32_value)
+{
+    fmt_init(&g_fw_update_line, g_ch_fw_update_line, sizeof(g_ch_fw_update_line));
+    fmt_str(&g_fw_update_line, pch_text);
+    if (u8_number) {
+        fmt_u32(&g_fw_update_line, u32_value, 0u, ' ');
+    }
+    g_u8_fw_update_line_pending = 1u;
+}
+
+/**
+ * @brief Ends the update with a failure line.
+ *
+ * @param pch_reason Short reason
+ * @return None
+ */
+static void fw_update_fail(const char *pch_reason)
+{
+    fmt_init(&g_fw_update_line, g_ch_fw_update_line, sizeof(g_ch_fw_update_line));
+    fmt_str(&g_fw_update_line, "fw fail ");
+    fmt_str(&g_fw_update_line, pch_reason);
+    g_u8_fw_update_line_pending = 1u;
+    g_fw_update_state = FW_UPDATE_FAILED;
+}
+
+/**
+ * @brief Checks the complete header and selects the sectors to erase.
+ *
+ * @return None
+ */
+static void fw_update_header(void)
+{
+    uint32_t u32_span = 0u;
+
+    g_u32_fw_update_size = fw_update_word(&g_u8_fw_update_header[4]);
+    g_u32_fw_update_crc  = fw_update_word(&g_u8_fw_update_header[8]);
+
+    if ((fw_update_word(&g_u8_fw_update_header[0]) != FW_UPDATE_MAGIC) ||
+        (g_u32_fw_update_size < 8u) || (g_u32_fw_update_size > FW_UPDATE_MAX_SIZE)) {
+        fw_update_fail("header");
+        return;
+    }
+
+    g_u8_fw_update_sectors = 0u;
+    while (u32_span < g_u32_fw_update_size) {
+        u32_span += (uint32_t)g_u16_fw_update_sector_kb[g_u8_fw_update_sectors++] * 1024u;
+    }
+    g_u8_fw_update_sector = 0u;
+    g_fw_update_state     = FW_UPDATE_ERASING;
+}
+
+/**
+ * @brief Starts the erase of the next sector; after the last one the
+ *        image may come.
+ *
+ * @return None
+ */
+static void fw_update_erase(void)
+{
+    /* An erase of modules/params is still running */
+    if (__HAL_FLASH_GET_FLAG(FLASH_FLAG_BSY)) {
+        return;
+    }
+
+    if (g_u8_fw_update_sector < g_u8_fw_update_sectors) {
+        HAL_FLASH_Unlock();
+        __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_EOP | FW_UPDATE_FLASH_ERRORS);
+        FLASH_Erase_Sector(fw_update_sector_num(g_u8_fw_update_sector), FLASH_VOLTAGE_RANGE_3);
+        g_u8_fw_update_erasing = 1u;
+        return;
+    }
+
+    FLASH_FlushCaches();
+    g_u32_fw_update_tick = HAL_GetTick();
+    g_fw_update_state    = FW_UPDATE_RECEIVING;
+    fw_update_reply("fw ack ", 1u, 0u);
+}
+
+/**
+ * @brief Completes a finished erase, also one of a cancelled update.
+ *
+ * @return None
+ */
+static void fw_update_erase_done(void)
+{
+    uint8_t u8_failed = (__HAL_FLASH_GET_FLAG(FW_UPDATE_FLASH_ERRORS) != 0u) ? 1u : 0u;
+
+    CLEAR_BIT(FLASH->CR, FLASH_CR_SER | FLASH_CR_SNB);
+    __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_EOP | FW_UPDATE_FLASH_ERRORS);
+    HAL_FLASH_Lock();
+    g_u8_fw_update_erasing = 0u;
+
+    if (g_fw_update_state != FW_UPDATE_ERASING) {
+        return;
+    }
+    if (u8_failed) {
+        fw_update_fail("erase");
+    } else {
+        g_u8_fw_update_sector++;
+    }
+}
+
+/**
+ * @brief Programs image bytes, the last word of the image padded.
+ *
+ * @param pu8_data Bytes
+ * @param u16_size Count
+ * @return Bytes taken (fewer than u16_size: more than the image)
+ */
+static uint16_t fw_update_program(const uint8_t *pu8_data, uint16_t u16_size)
+{
+    uint32_t u32_addr;
+    uint16_t u16_pos = 0u;
+
+    HAL_FLASH_Unlock();
+    while ((u16_pos < u16_size) && (g_u32_fw_update_written < g_u32_fw_update_size)) {
+        g_u32_fw_update_word |= (uint32_t)pu8_data[u16_pos++] << (8u * g_u8_fw_update_word_fill);
+        g_u8_fw_update_word_fill++;
+        g_u32_fw_update_written++;
+
+        if ((g_u8_fw_update_word_fill < 4u) && (g_u32_fw_update_written < g_u32_fw_update_size)) {
+            continue;
+        }
+        while (g_u8_fw_update_word_fill < 4u) {
+            g_u32_fw_update_word |= 0xFFUL << (8u * g_u8_fw_update_word_fill++);
+        }
+
+        u32_addr = FW_UPDATE_BANK_ADDR + ((g_u32_fw_update_written - 1u) & ~3UL);
+        if (HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, u32_addr, g_u32_fw_update_word) != HAL_OK) {
+            HAL_FLASH_Lock();
+            fw_update_fail("program");
+            return u16_pos;
+        }
+        g_u32_fw_update_word     = 0u;
+        g_u8_fw_update_word_fill = 0u;
+    }
+    HAL_FLASH_Lock();
+
+    return u16_pos;
+}
+
+/**
+ * @brief Checks the CRC and the vector table of the complete image.
+ *
+ * @return None
+ */
+static void fw_update_verify(void)
+{
+    const uint32_t *pu32_image = (const uint32_t *)FW_UPDATE_BANK_ADDR;
+    uint32_t u32_crc;
+
+    FLASH_FlushCaches();
+
+    if (g_fw_update_crc.Instance != CRC) {
+        __HAL_RCC_CRC_CLK_ENABLE();
+        g_fw_update_crc.Instance = CRC;
+        HAL_CRC_Init(&g_fw_update_crc);
+    }
+    u32_crc = HAL_CRC_Calculate(&g_fw_update_crc, (uint32_t *)(uintptr_t)FW_UPDATE_BANK_ADDR,
+                                (g_u32_fw_update_size + 3u) / 4u);
+    if (u32_crc != g_u32_fw_update_crc) {
+        fw_update_fail("crc");
+        return;
+    }
+
+    /* Linked for 0x08000000, where the bank is mapped after the swap */
+    if ((pu32_image[0] < FW_UPDATE_SRAM_START) || (pu32_image[0] > FW_UPDATE_SRAM_END) ||
+        ((pu32_image[1] & 1u) == 0u) || (pu32_image[1] < FW_UPDATE_RUN_ADDR) ||
+        (pu32_image[1] >= FW_UPDATE_RUN_ADDR + g_u32_fw_update_size)) {
+        fw_update_fail("vectors");
+        return;
+    }
+
+    g_fw_update_state = FW_UPDATE_VERIFIED;
+    fw_update_reply("fw ok ", 1u, u32_crc);
+}
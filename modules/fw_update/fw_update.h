@@ -0,0 +1,191 @@
+/**
+ ******************************************************************************
+ * @file        fw_update.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the in-application firmware update
+ *              (dual bank flash, bank swap by BFB2).
+ *
+ * @details
+ * The 2 MB flash of the STM32F429 has two banks of 1 MB. The running
+ * firmware is always mapped at 0x08000000, the other bank at 0x08100000
+ * (with BFB2 booting from bank 2 the bootloader sets UFB_MODE and the
+ * banks trade places in the memory map). A new image is streamed into the
+ * other bank while the firmware keeps running from its own bank (read
+ * while write), verified with the CRC unit, and then activated by
+ * toggling the BFB2 option bit: the downtime is one reset. The old image
+ * stays in the other bank.
+ *
+ * The image occupies the first ten sectors of a bank (768 KB), the last
+ * two sectors of each bank are left to modules/params.
+ *
+ * Stream (from any byte source, e.g. the telemetry UART):
+ *
+ *      "FWU1" (u32 0x31555746), image size (u32), CRC (u32), image
+ *
+ * little endian. The CRC is the one of the CRC unit (0x04C11DB7, initial
+ * value 0xFFFFFFFF, little endian words) over the image, the last word
+ * padded with 0xFF. Flow control by text lines to the sink:
+ *
+ *      "fw ready"          send the header
+ *      "fw ack <n>"        n bytes of the image are in flash, send up to
+ *                          FW_UPDATE_CHUNK_BYTES more
+ *      "fw ok <crc>"       image verified, fw_update_swap() activates it
+ *      "fw fail <reason>"  header, erase, program, crc, vectors, timeout
+ *
+ * The sectors of the image are erased after the header, one at a time
+ * and only polled, so "fw ack 0" follows some seconds later.
+ * modules/fw_update/fw_update_send.py does the host side.
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - Erase and program without stopping the CPU, at most
+ *    FW_UPDATE_CHUNK_BYTES per fw_update_poll()
+ *  - Shares the flash controller with modules/params: no operation is
+ *    started while the other one has one running
+ *  - Verification by CRC over the flash contents and a plausible vector
+ *    table (stack pointer in SRAM, reset handler in the image)
+ *  - fw_update_swap(): BFB2 toggled, reset after FW_UPDATE_SWAP_DELAY_MS
+ *    so the reply still goes out
+ *
+ ******************************************************************************
+ */
+
+#ifndef FW_UPDATE_FW_UPDATE_H_
+#define FW_UPDATE_FW_UPDATE_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief Enables the firmware update (and the migration of the parameter
+ *        store after a bank swap, see modules/params).
+ */
+#ifndef FW_UPDATE_ENABLE
+#define FW_UPDATE_ENABLE            0
+#endif
+
+/**
+ * @brief Address of the other bank, whichever bank runs.
+ */
+#define FW_UPDATE_BANK_ADDR         0x08100000UL
+
+/**
+ * @brief Largest image: sectors 0..9 of a bank.
+ */
+#define FW_UPDATE_MAX_SIZE          0x000C0000UL
+
+/**
+ * @brief First word of the stream header ("FWU1").
+ */
+#define FW_UPDATE_MAGIC             0x31555746UL
+
+/**
+ * @brief Image bytes between two acknowledgements (at most the RX ring of
+ *        the source minus some slack).
+ */
+#ifndef FW_UPDATE_CHUNK_BYTES
+#define FW_UPDATE_CHUNK_BYTES       128U
+#endif
+
+/**
+ * @brief Time without a byte after which the update fails, in ms.
+ */
+#ifndef FW_UPDATE_TIMEOUT_MS
+#define FW_UPDATE_TIMEOUT_MS        10000U
+#endif
+
+/**
+ * @brief Time between fw_update_swap() and the reset, in ms.
+ */
+#define FW_UPDATE_SWAP_DELAY_MS     100U
+
+#if (FW_UPDATE_CHUNK_BYTES % 4U) != 0U
+#error "FW_UPDATE_CHUNK_BYTES must be a multiple of 4"
+#endif
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Byte source and text sink (same shape as the ones of modules/shell).
+ */
+typedef uint16_t (*fw_update_read_t)(uint8_t *pu8_data, uint16_t u16_size);
+typedef HAL_StatusTypeDef (*fw_update_write_t)(const char *pch_text, uint16_t u16_length);
+
+/**
+ * @brief State of the update.
+ */
+typedef enum {
+    FW_UPDATE_IDLE = 0,
+    FW_UPDATE_HEADER,               /**< Waiting for the stream header     */
+    FW_UPDATE_ERASING,              /**< Erasing the sectors of the image  */
+    FW_UPDATE_RECEIVING,            /**< Programming the image             */
+    FW_UPDATE_VERIFIED,             /**< Image complete, CRC correct       */
+    FW_UPDATE_SWAPPING,             /**< BFB2 toggled, reset pending       */
+    FW_UPDATE_FAILED
+} fw_update_state_t;
+
+/**
+ * @brief Progress of the update.
+ */
+typedef struct {
+    fw_update_state_t state;
+    uint8_t  u8_bank;               /**< Running bank, 1 or 2              */
+    uint32_t u32_size;              /**< Image size of the header          */
+    uint32_t u32_written;           /**< Image bytes in flash              */
+    uint32_t u32_crc;               /**< CRC of the header                 */
+} fw_update_status_t;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Starts an update: waits for the header of a stream.
+ *
+ * @return HAL_OK, HAL_BUSY while an update or a swap is running
+ */
+HAL_StatusTypeDef fw_update_begin(void);
+
+/**
+ * @brief Cancels a running update, the other bank is left as it is.
+ *
+ * @return None
+ */
+void fw_update_abort(void);
+
+/**
+ * @brief Runs the update: reads and programs at most
+ *        FW_UPDATE_CHUNK_BYTES, polls the erase, sends the flow control
+ *        lines, performs a pending swap. Main loop.
+ *
+ * @param read  Byte source
+ * @param write Text sink
+ * @return 1 while the update owns the byte source (header, erase, image),
+ *         0 otherwise (the source is free for e.g. the shell)
+ */
+uint8_t fw_update_poll(fw_update_read_t read, fw_update_write_t write);
+
+/**
+ * @brief Activates the verified image: BFB2 is toggled, the reset follows
+ *        in fw_update_poll() FW_UPDATE_SWAP_DELAY_MS later.
+ *
+ * @return HAL_OK, HAL_ERROR without a verified image or if the option
+ *         bytes could not be written
+ */
+HAL_StatusTypeDef fw_update_swap(void);
+
+/**
+ * @brief Returns the bank the firmware runs from.
+ *
+ * @return 1 or 2
+ */
+uint8_t fw_update_get_bank(void);
+
+/**
+ * @brief Copies the progress.
+ *
+ * @param status Destination
+ * @return None
+ */
+void fw_update_get_status(fw_update_status_t *status);
+
+#endif /* FW_UPDATE_FW_UPDATE_H_ */
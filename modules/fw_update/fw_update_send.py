@@ -0,0 +1,75 @@
+#!/usr/bin/env python3
+"""Sender for the firmware update of modules/fw_update.
+
+Streams a binary image (``arm-none-eabi-objcopy -O binary P1.elf P1.bin``)
+over the telemetry UART of P1 (e.g. ``stty -F /dev/ttyACM0 921600 raw``
+first): enters the update with the shell command ``fw 1``, sends the
+header once the board reports ``fw ready`` and then one chunk per
+``fw ack``. Replies come as text records of the telemetry batch frames
+and are decoded with modules/uart_telemetry/uart_telemetry_decode.py.
+``--swap`` sends ``fw 2`` after ``fw ok``: the board resets into the new
+image.
+
+Only the standard library is needed.
+
+Usage:
+    fw_update_send.py /dev/ttyACM0 P1.bin [--swap]
+"""
+
+import argparse
+import os
+import struct
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "uart_telemetry"))
+import uart_telemetry_decode  # noqa: E402
+
+MAGIC = 0x31555746
+MAX_SIZE = 0xC0000
+CHUNK = 128  # FW_UPDATE_CHUNK_BYTES
+
+
+def replies(stream):
+    """Yields the words of every "fw ..." text line."""
+    stats = {"frames": 0, "skipped": 0}
+    for _, channel, _, text in uart_telemetry_decode.batches(stream, stats):
+        if channel == "shell" and text.startswith("fw "):
+            yield text.split()[1:]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("port", help="serial device")
+    parser.add_argument("image", help="binary image, linked for 0x08000000")
+    parser.add_argument("--swap", action="store_true", help="boot the image once it is verified")
+    args = parser.parse_args()
+
+    with open(args.image, "rb") as source:
+        image = source.read()
+    if not 8 <= len(image) <= MAX_SIZE:
+        sys.exit("image size %d, at most %d bytes" % (len(image), MAX_SIZE))
+    # Flash contents: the last word is padded with erased bytes
+    crc = uart_telemetry_decode.crc32_stm32(image + b"\xff" * (-len(image) % 4))
+
+    with open(args.port, "rb", buffering=0) as rx, open(args.port, "wb", buffering=0) as tx:
+        tx.write(b"fw 1\r\n")
+        for words in replies(rx):
+            if words[0] == "ready":
+                tx.write(struct.pack("<III", MAGIC, len(image), crc))
+            elif words[0] == "ack":
+                done = int(words[1])
+                tx.write(image[done:done + CHUNK])
+                sys.stderr.write("\r%d / %d" % (done, len(image)))
+            elif words[0] == "ok":
+                sys.stderr.write("\rverified, crc 0x%08x\n" % int(words[1]))
+                break
+            elif words[0] == "fail":
+                sys.exit("\nupdate failed: %s" % " ".join(words[1:]))
+
+        if args.swap:
+            tx.write(b"fw 2\r\n")
+            sys.stderr.write("swapping banks\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,403 @@
+/**
+ ******************************************************************************
+ * @file        gyro.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       L3GD20 gyroscope driver.
+ *
+ * Functionality:
+ * - Sensor check, rate / range / FIFO stream mode setup
+ * - Watermark interrupt, FIFO_SRC and sample burst per bus grant
+ * - Sample queue for the main loop
+ *
+ * Resources:
+ * - SPI5 through the LCD driver (bus arbitration, DMA2 RX stream)
+ * - PC1 chip select, PA2 / EXTI2 (through exti)
+ ******************************************************************************
+ */
+
+#include "gyro.h"
+#include <exti/exti.h>
+#include <lcd/ILI9341_STM32_Driver.h>
+#include <sync/sync.h>
+
+#include <stddef.h>
+
+/* Preprocessor Defines ----------------------------------------------------- */
+/**
+ * @brief L3GD20 registers.
+ */
+#define GYRO_REG_WHO_AM_I       0x0FU
+#define GYRO_REG_CTRL_REG1      0x20U
+#define GYRO_REG_FIFO_CTRL      0x2EU
+#define GYRO_REG_FIFO_SRC       0x2FU
+#define GYRO_REG_OUT_X_L        0x28U
+
+/**
+ * @brief First byte of a transfer: read and auto increment flags.
+ */
+#define GYRO_SPI_READ           0x80U
+#define GYRO_SPI_INCREMENT      0x40U
+
+/**
+ * @brief Register values.
+ */
+#define GYRO_ID_L3GD20          0xD4U
+#define GYRO_ID_I3G4250D        0xD3U
+#define GYRO_CTRL1_ON           0x3FU   /**< Widest bandwidth, PD, X/Y/Z on */
+#define GYRO_CTRL3_I2_WTM       0x04U   /**< Watermark on INT2              */
+#define GYRO_CTRL5_FIFO_EN      0x40U
+#define GYRO_FIFO_BYPASS        0x00U
+#define GYRO_FIFO_STREAM        0x40U
+#define GYRO_FIFO_SRC_OVRN      0x40U
+#define GYRO_FIFO_SRC_FSS       0x1FU
+
+/**
+ * @brief Bytes of one sample (X, Y, Z little endian).
+ */
+#define GYRO_SAMPLE_BYTES       6U
+
+/**
+ * @brief Timeout of one register access during gyro_init().
+ */
+#define GYRO_TIMEOUT_MS         10U
+
+/* Type Definitions --------------------------------------------------------- */
+/**
+ * @brief Step of a burst, i.e. the transfer in flight.
+ */
+typedef enum {
+    GYRO_STEP_IDLE = 0,
+    GYRO_STEP_SYNC,         /**< Blocking access of gyro_init()           */
+    GYRO_STEP_SOURCE,       /**< FIFO_SRC read                            */
+    GYRO_STEP_DATA          /**< Samples read                             */
+} gyro_step_t;
+
+/* Static Module Variables -------------------------------------------------- */
+static void gyro_grant(ILI9341_Bus_Client_t *client);
+static void gyro_done(ILI9341_Bus_Client_t *client);
+
+static ILI9341_Bus_Client_t g_gyro_client = {
+    .Grant     = gyro_grant,
+    .Done      = gyro_done,
+    .Max_Clock = GYRO_SPI_MAX_CLOCK,
+};
+
+/**
+ * @brief mdps per digit per range, times 100.
+ */
+static const int32_t g_i32_gyro_sensitivity[] = { 875, 1750, 7000 };
+
+static volatile gyro_step_t g_gyro_step = GYRO_STEP_IDLE;
+static volatile uint8_t g_u8_gyro_again;        /**< Edge during a burst      */
+static volatile uint8_t g_u8_gyro_sync_done;
+static uint8_t g_u8_gyro_attached;
+static uint16_t g_u16_gyro_sync_len;
+static uint8_t g_u8_gyro_count;                 /**< Samples of the burst     */
+static gyro_range_t g_gyro_range = GYRO_RANGE_250DPS;
+static uint8_t g_u8_gyro_sync[8];
+static uint8_t g_u8_gyro_source[2];
+static uint8_t g_u8_gyro_burst[1U + GYRO_FIFO_DEPTH * GYRO_SAMPLE_BYTES];
+static volatile gyro_stats_t g_gyro_stats;
+
+static gyro_sample_t g_gyro_queue_buffer[GYRO_QUEUE_SIZE];
+static sync_queue_t g_gyro_queue = SYNC_QUEUE_INIT(g_gyro_queue_buffer);
+
+/* Static function prototypes ----------------------------------------------- */
+static HAL_StatusTypeDef gyro_transfer(uint16_t u16_len);
+static HAL_StatusTypeDef gyro_write(uint8_t u8_reg, uint8_t u8_value);
+static void gyro_edge(void *context);
+static void gyro_finish(void);
+static void gyro_queue_samples(void);
+
+/* Public functions --------------------------------------------------------- */
+HAL_StatusTypeDef gyro_init(gyro_odr_t odr, gyro_range_t range)
+{
+    GPIO_InitTypeDef gpio_init;
+    uint8_t u8_line = exti_pin_to_line(GYRO_INT2_PIN);
+
+    if ((range > GYRO_RANGE_2000DPS) || (odr > GYRO_ODR_760HZ)) {
+        return HAL_ERROR;
+    }
+
+    /* CS high before the first grant */
+    __HAL_RCC_GPIOC_CLK_ENABLE();
+    HAL_GPIO_WritePin(GYRO_CS_PORT, GYRO_CS_PIN, GPIO_PIN_SET);
+    gpio_init.Pin   = GYRO_CS_PIN;
+    gpio_init.Mode  = GPIO_MODE_OUTPUT_PP;
+    gpio_init.Pull  = GPIO_NOPULL;
+    gpio_init.Speed = GPIO_SPEED_FREQ_HIGH;
+    HAL_GPIO_Init(GYRO_CS_PORT, &gpio_init);
+
+    if (!g_u8_gyro_attached) {
+        if (ILI9341_Bus_Attach(&g_gyro_client) != HAL_OK) {
+            return HAL_BUSY;
+        }
+        g_u8_gyro_attached = 1u;
+    }
+
+    g_gyro_step     = GYRO_STEP_SYNC;
+    g_u8_gyro_again = 0u;
+    g_gyro_range    = range;
+    g_gyro_stats    = (gyro_stats_t){ 0 };
+
+    g_u8_gyro_sync[0] = GYRO_SPI_READ | GYRO_REG_WHO_AM_I;
+    if ((gyro_transfer(2u) != HAL_OK) ||
+        ((g_u8_gyro_sync[1] != GYRO_ID_L3GD20) && (g_u8_gyro_sync[1] != GYRO_ID_I3G4250D))) {
+        g_gyro_step = GYRO_STEP_IDLE;
+        return HAL_ERROR;
+    }
+
+    /* CTRL_REG1..5 in one write: rate, high pass off, watermark on INT2,
+     * range, FIFO on. The FIFO is reset by the bypass mode before streaming. */
+    g_u8_gyro_sync[0] = GYRO_SPI_INCREMENT | GYRO_REG_CTRL_REG1;
+    g_u8_gyro_sync[1] = (uint8_t)(((uint8_t)odr << 6) | GYRO_CTRL1_ON);
+    g_u8_gyro_sync[2] = 0x00u;
+    g_u8_gyro_sync[3] = GYRO_CTRL3_I2_WTM;
+    g_u8_gyro_sync[4] = (uint8_t)((uint8_t)range << 4);
+    g_u8_gyro_sync[5] = GYRO_CTRL5_FIFO_EN;
+    if ((gyro_transfer(6u) != HAL_OK) ||
+        (gyro_write(GYRO_REG_FIFO_CTRL, GYRO_FIFO_BYPASS) != HAL_OK) ||
+        (gyro_write(GYRO_REG_FIFO_CTRL, (uint8_t)(GYRO_FIFO_STREAM | (GYRO_WATERMARK & 0x1Fu))) != HAL_OK)) {
+        g_gyro_step = GYRO_STEP_IDLE;
+        return HAL_ERROR;
+    }
+
+    /* Handler before the pin, so no edge arrives without it */
+    if (exti_register(u8_line, gyro_edge, NULL) != HAL_OK) {
+        g_gyro_step = GYRO_STEP_IDLE;
+        return HAL_BUSY;
+    }
+
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+    gpio_init.Pin   = GYRO_INT2_PIN;
+    gpio_init.Mode  = GPIO_MODE_IT_RISING;
+    gpio_init.Pull  = GPIO_NOPULL;
+    gpio_init.Speed = GPIO_SPEED_FREQ_LOW;
+    HAL_GPIO_Init(GYRO_INT2_PORT, &gpio_init);
+    exti_enable_irq(u8_line, GYRO_IRQ_PRIORITY, 0u);
+
+    /* A watermark reached during the setup gives no edge anymore */
+    gyro_finish();
+
+    return HAL_OK;
+}
+
+uint8_t gyro_get_sample(gyro_sample_t *sample)
+{
+    return sync_queue_pop(&g_gyro_queue, sample);
+}
+
+uint32_t gyro_get_count(void)
+{
+    return sync_queue_count(&g_gyro_queue);
+}
+
+int32_t gyro_to_mdps(int16_t i16_raw)
+{
+    return ((int32_t)i16_raw * g_i32_gyro_sensitivity[g_gyro_range]) / 100;
+}
+
+void gyro_get_stats(gyro_stats_t *stats)
+{
+    uint32_t u32_primask = __get_PRIMASK();
+
+    __disable_irq();
+    *stats = g_gyro_stats;
+    __set_PRIMASK(u32_primask);
+}
+
+/* Static functions --------------------------------------------------------- */
+/**
+ * @brief Transfer of g_u8_gyro_sync that waits for its end (gyro_init()
+ *        only).
+ *
+ * @param u16_len Bytes, command byte included
+ * @return HAL_OK, HAL_TIMEOUT
+ */
+static HAL_StatusTypeDef gyro_transfer(uint16_t u16_len)
+{
+    uint32_t u32_start = HAL_GetTick();
+
+    g_u16_gyro_sync_len = u16_len;
+    g_u8_gyro_sync_done = 0u;
+    ILI9341_Bus_Request(&g_gyro_client);
+    while (!g_u8_gyro_sync_done) {
+        if ((HAL_GetTick() - u32_start) > GYRO_TIMEOUT_MS) {
+            return HAL_TIMEOUT;
+        }
+    }
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Writes one register (gyro_init() only).
+ *
+ * @param u8_reg   Register
+ * @param u8_value Value
+ * @return HAL_OK, HAL_TIMEOUT
+ */
+static HAL_StatusTypeDef gyro_write(uint8_t u8_reg, uint8_t u8_value)
+{
+    g_u8_gyro_sync[0] = u8_reg;
+    g_u8_gyro_sync[1] = u8_value;
+    return gyro_transfer(2u);
+}
+
+/**
+ * @brief EXTI handler of INT2: requests the bus for a burst, or marks one
+ *        for afterwards if a burst is running.
+ *
+ * @param context Unused
+ * @return None
+ */
+static void gyro_edge(void *context)
+{
+    uint32_t u32_primask = __get_PRIMASK();
+
+    (void)context;
+
+    __disable_irq();
+    if (g_gyro_step != GYRO_STEP_IDLE) {
+        g_u8_gyro_again = 1u;
+        __set_PRIMASK(u32_primask);
+        return;
+    }
+    g_gyro_step = GYRO_STEP_SOURCE;
+    __set_PRIMASK(u32_primask);
+
+    ILI9341_Bus_Request(&g_gyro_client);
+}
+
+/**
+ * @brief Ends a burst; starts the next one if an edge came in meanwhile or
+ *        the FIFO is still above the watermark (no new edge then).
+ *
+ * @return None
+ */
+static void gyro_finish(void)
+{
+    uint32_t u32_primask = __get_PRIMASK();
+    uint8_t u8_again;
+
+    __disable_irq();
+    u8_again = g_u8_gyro_again;
+    g_u8_gyro_again = 0u;
+    g_gyro_step = GYRO_STEP_IDLE;
+    __set_PRIMASK(u32_primask);
+
+    if (u8_again || (HAL_GPIO_ReadPin(GYRO_INT2_PORT, GYRO_INT2_PIN) == GPIO_PIN_SET)) {
+        gyro_edge(NULL);
+    }
+}
+
+/**
+ * @brief Bus granted: first transfer of the step.
+ *
+ * @param client Gyro client
+ * @return None
+ */
+static void gyro_grant(ILI9341_Bus_Client_t *client)
+{
+    uint8_t *pu8_data = g_u8_gyro_source;
+    uint16_t u16_len = 2u;
+
+    (void)client;
+
+    if (g_gyro_step == GYRO_STEP_SYNC) {
+        pu8_data = g_u8_gyro_sync;
+        u16_len  = g_u16_gyro_sync_len;
+    } else if (g_gyro_step == GYRO_STEP_SOURCE) {
+        g_u8_gyro_source[0] = GYRO_SPI_READ | GYRO_REG_FIFO_SRC;
+    } else {
+        return;
+    }
+
+    HAL_GPIO_WritePin(GYRO_CS_PORT, GYRO_CS_PIN, GPIO_PIN_RESET);
+    if (ILI9341_Bus_Transfer(pu8_data, u16_len) != HAL_OK) {
+        HAL_GPIO_WritePin(GYRO_CS_PORT, GYRO_CS_PIN, GPIO_PIN_SET);
+        g_gyro_stats.u32_errors++;
+        if (g_gyro_step == GYRO_STEP_SOURCE) {
+            /* Requested again while held: granted after the next LCD block */
+            g_u8_gyro_again = 1u;
+            gyro_finish();
+        }
+    }
+}
+
+/**
+ * @brief End of a transfer (SPI5 RX DMA interrupt): samples after FIFO_SRC,
+ *        end of the burst after the samples.
+ *
+ * @param client Gyro client
+ * @return None
+ */
+static void gyro_done(ILI9341_Bus_Client_t *client)
+{
+    (void)client;
+
+    HAL_GPIO_WritePin(GYRO_CS_PORT, GYRO_CS_PIN, GPIO_PIN_SET);
+
+    switch (g_gyro_step) {
+    case GYRO_STEP_SYNC:
+        g_u8_gyro_sync_done = 1u;
+        break;
+
+    case GYRO_STEP_SOURCE:
+        g_u8_gyro_count = g_u8_gyro_source[1] & GYRO_FIFO_SRC_FSS;
+        if (g_u8_gyro_source[1] & GYRO_FIFO_SRC_OVRN) {
+            g_gyro_stats.u32_overruns++;
+            g_u8_gyro_count = GYRO_FIFO_DEPTH;
+        }
+        if (g_u8_gyro_count == 0u) {
+            gyro_finish();
+            break;
+        }
+
+        /* Chained on the same grant: the address wraps from OUT_Z_H back to
+         * OUT_X_L in FIFO mode, one transfer drains all samples */
+        g_gyro_step = GYRO_STEP_DATA;
+        g_u8_gyro_burst[0] = GYRO_SPI_READ | GYRO_SPI_INCREMENT | GYRO_REG_OUT_X_L;
+        HAL_GPIO_WritePin(GYRO_CS_PORT, GYRO_CS_PIN, GPIO_PIN_RESET);
+        if (ILI9341_Bus_Transfer(g_u8_gyro_burst, (uint16_t)(1u + g_u8_gyro_count * GYRO_SAMPLE_BYTES)) != HAL_OK) {
+            HAL_GPIO_WritePin(GYRO_CS_PORT, GYRO_CS_PIN, GPIO_PIN_SET);
+            g_gyro_stats.u32_errors++;
+            gyro_finish();
+        }
+        break;
+
+    case GYRO_STEP_DATA:
+        gyro_queue_samples();
+        gyro_finish();
+        break;
+
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief Queues the samples of a burst.
+ *
+ * @return None
+ */
+static void gyro_queue_samples(void)
+{
+    gyro_sample_t sample;
+
+    for (uint8_t i = 0u; i < g_u8_gyro_count; i++) {
+        const uint8_t *pu8_sample = &g_u8_gyro_burst[1u + GYRO_SAMPLE_BYTES * i];
+
+        sample.i16_x = (int16_t)(((uint16_t)pu8_sample[1] << 8) | pu8_sample[0]);
+        sample.i16_y = (int16_t)(((uint16_t)pu8_sample[3] << 8) | pu8_sample[2]);
+        sample.i16_z = (int16_t)(((uint16_t)pu8_sample[5] << 8) | pu8_sample[4]);
+        if (sync_queue_push(&g_gyro_queue, &sample) != HAL_OK) {
+            g_gyro_stats.u32_dropped++;
+        }
+    }
+
+    g_gyro_stats.u32_bursts++;
+    g_gyro_stats.u32_samples += g_u8_gyro_count;
+}
@@ -0,0 +1,164 @@
+/**
+ ******************************************************************************
+ * @file        gyro.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the L3GD20 gyroscope driver.
+ *
+ * @details
+ * The on-board gyro (L3GD20, on newer boards the register compatible
+ * I3G4250D) shares SPI5 with the ILI9341 (CS on PC1, INT2 on PA2). It
+ * runs in FIFO stream mode: the sensor buffers up to 32 samples on its
+ * own and raises INT2 when GYRO_WATERMARK are stored. The edge asks the
+ * LCD driver for the bus (ILI9341_Bus_Request()); it is handed over
+ * before the next DMA block of the display queue, at most
+ * ILI9341_BUS_MAX_BLOCK pixels later, so a full screen fill delays a
+ * burst by about 6 ms while the FIFO holds 42 ms at 760 Hz. With the bus
+ * the driver
+ *
+ *  1. reads FIFO_SRC (fill level, overrun),
+ *  2. reads all stored samples in one DMA burst (the output registers
+ *     wrap around in FIFO mode),
+ *
+ * and queues them for the main loop (gyro_get_sample()). If INT2 is
+ * still high afterwards (samples arrived during the burst), the next
+ * burst follows at once.
+ *
+ * gyro_init() needs the SPI5 setup of the LCD (ILI9341_SPI_Init()).
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - Output rate 95 .. 760 Hz, range 250 .. 2000 dps
+ *  - Watermark interrupt, DMA bursts arbitrated against the display
+ *  - Sample queue for the main loop, counters for FIFO and queue overruns
+ *
+ ******************************************************************************
+ */
+
+#ifndef GYRO_GYRO_H_
+#define GYRO_GYRO_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+#include <irq/irq.h>
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief Chip select and watermark interrupt line.
+ */
+#define GYRO_CS_PORT            GPIOC
+#define GYRO_CS_PIN             GPIO_PIN_1
+#define GYRO_INT2_PORT          GPIOA
+#define GYRO_INT2_PIN           GPIO_PIN_2
+
+/**
+ * @brief SCK limit of the sensor.
+ */
+#define GYRO_SPI_MAX_CLOCK      10000000U
+
+/**
+ * @brief Priority of the INT2 interrupt, the same as the SPI5 DMA
+ *        interrupts, so bus requests and transfer ends do not preempt
+ *        each other.
+ */
+#define GYRO_IRQ_PRIORITY       IRQ_CLASS_TRANSFER
+
+/**
+ * @brief Samples of the sensor FIFO and the level that raises INT2.
+ */
+#define GYRO_FIFO_DEPTH         32U
+#ifndef GYRO_WATERMARK
+#define GYRO_WATERMARK          16U
+#endif
+
+/**
+ * @brief Samples buffered for the main loop, power of two.
+ */
+#define GYRO_QUEUE_SIZE         256U
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Output data rate (CTRL_REG1 DR, widest bandwidth each).
+ */
+typedef enum {
+    GYRO_ODR_95HZ = 0,
+    GYRO_ODR_190HZ,
+    GYRO_ODR_380HZ,
+    GYRO_ODR_760HZ
+} gyro_odr_t;
+
+/**
+ * @brief Full scale (CTRL_REG4 FS).
+ */
+typedef enum {
+    GYRO_RANGE_250DPS = 0,  /**< 8.75 mdps per digit */
+    GYRO_RANGE_500DPS,      /**< 17.5 mdps per digit */
+    GYRO_RANGE_2000DPS      /**< 70 mdps per digit   */
+} gyro_range_t;
+
+/**
+ * @brief One sample, raw angular rates.
+ */
+typedef struct {
+    int16_t i16_x;
+    int16_t i16_y;
+    int16_t i16_z;
+} gyro_sample_t;
+
+/**
+ * @brief Counters since gyro_init().
+ */
+typedef struct {
+    uint32_t u32_bursts;        /**< FIFO reads                              */
+    uint32_t u32_samples;       /**< Samples read                            */
+    uint32_t u32_overruns;      /**< FIFO overruns (samples lost in sensor)  */
+    uint32_t u32_dropped;       /**< Samples dropped by a full queue         */
+    uint32_t u32_errors;        /**< Failed bus transfers                    */
+} gyro_stats_t;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Checks the sensor, configures rate, range and FIFO and enables
+ *        the watermark interrupt.
+ *
+ * @param odr   Output data rate
+ * @param range Full scale
+ * @return HAL_OK, HAL_ERROR if the sensor does not answer,
+ *         HAL_BUSY if SPI5 or the EXTI line cannot be shared
+ */
+HAL_StatusTypeDef gyro_init(gyro_odr_t odr, gyro_range_t range);
+
+/**
+ * @brief Takes the oldest sample.
+ *
+ * @param sample Destination
+ * @return 1 if a sample was read, 0 if none is queued
+ */
+uint8_t gyro_get_sample(gyro_sample_t *sample);
+
+/**
+ * @brief Returns the number of queued samples.
+ *
+ * @return Samples
+ */
+uint32_t gyro_get_count(void);
+
+/**
+ * @brief Converts a raw rate into millidegrees per second (range of the
+ *        last gyro_init()).
+ *
+ * @param i16_raw Raw rate
+ * @return mdps
+ */
+int32_t gyro_to_mdps(int16_t i16_raw);
+
+/**
+ * @brief Copies the counters.
+ *
+ * @param stats Destination
+ * @return None
+ */
+void gyro_get_stats(gyro_stats_t *stats);
+
+#endif /* GYRO_GYRO_H_ */
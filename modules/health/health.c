@@ -0,0 +1,244 @@
+/**
+ ******************************************************************************
+ * @file        health.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       CPU load, interrupt share and stack high water monitor
+ *
+ * Functionality:
+ * - Idle and interrupt cycles accumulated from the instrumentation
+ *   macros, taken and cleared with interrupts masked in health_update()
+ * - Window length from the cycle counter, shares in 0.1 %
+ * - Stack scan from the heap end (sbrk(0)) up to the first word that is
+ *   not HEALTH_STACK_PAINT
+ *
+ * Resources:
+ * - DWT cycle counter (shared, read only after the start)
+ * - DBGMCU_CR DBG_SLEEP: HCLK keeps running in sleep mode so the counter
+ *   covers __WFI() (slightly higher sleep current)
+ ******************************************************************************
+ */
+
+#include "health.h"
+#include <fmt/fmt.h>
+#include <trace/trace.h>
+#include <utils/utils.h>
+#include <unistd.h>
+
+/* Static module variables -------------------------------------------------- */
+/**
+ * @brief Top of the main stack (linker script).
+ */
+extern uint32_t _estack;
+
+static volatile uint32_t g_u32_health_idle = 0u;
+static volatile uint32_t g_u32_health_isr_cycles[HEALTH_ISR_COUNT];
+static volatile uint32_t g_u32_health_isr_calls[HEALTH_ISR_COUNT];
+static uint32_t g_u32_health_window_start = 0u;
+static health_stats_t g_health_stats;
+
+static const char * const g_pch_health_isr_names[HEALTH_ISR_COUNT] = {
+    "exti9_5",
+    "fan_control",
+    "potis_dma",
+    "lcd_dma",
+    "env_dma",
+    "dot",
+    "user"
+};
+
+/* Static function prototypes ---------------------------------------------- */
+static uint16_t health_permille(uint32_t u32_part, uint32_t u32_whole);
+static void health_puts(health_putc_t putc, const char *pch_text);
+
+/* Public functions --------------------------------------------------------- */
+void health_init(void)
+{
+    utils_timebase_init();
+    DBGMCU->CR |= DBGMCU_CR_DBG_SLEEP;
+
+    __disable_irq();
+    g_u32_health_idle = 0u;
+    for (uint8_t i = 0u; i < HEALTH_ISR_COUNT; i++) {
+        g_u32_health_isr_cycles[i] = 0u;
+        g_u32_health_isr_calls[i]  = 0u;
+    }
+    g_u32_health_window_start = DWT->CYCCNT;
+    __enable_irq();
+
+    g_health_stats.u16_load_peak_permille = 0u;
+}
+
+void health_update(void)
+{
+    uint32_t u32_primask = __get_PRIMASK();
+    uint32_t u32_isr_cycles[HEALTH_ISR_COUNT];
+    uint32_t u32_now;
+    uint32_t u32_idle;
+
+    __disable_irq();
+    u32_now  = DWT->CYCCNT;
+    u32_idle = g_u32_health_idle;
+    g_u32_health_idle = 0u;
+    for (uint8_t i = 0u; i < HEALTH_ISR_COUNT; i++) {
+        u32_isr_cycles[i] = g_u32_health_isr_cycles[i];
+        g_health_stats.u32_isr_calls[i] = g_u32_health_isr_calls[i];
+        g_u32_health_isr_cycles[i] = 0u;
+        g_u32_health_isr_calls[i]  = 0u;
+    }
+    __set_PRIMASK(u32_primask);
+
+    g_health_stats.u32_window_cycles = u32_now - g_u32_health_window_start;
+    g_u32_health_window_start = u32_now;
+
+    g_health_stats.u16_load_permille =
+        1000u - health_permille(u32_idle, g_health_stats.u32_window_cycles);
+    if (g_health_stats.u16_load_permille > g_health_stats.u16_load_peak_permille) {
+        g_health_stats.u16_load_peak_permille = g_health_stats.u16_load_permille;
+    }
+    for (uint8_t i = 0u; i < HEALTH_ISR_COUNT; i++) {
+        g_health_stats.u16_isr_permille[i] =
+            health_permille(u32_isr_cycles[i], g_health_stats.u32_window_cycles);
+    }
+
+    g_health_stats.u32_stack_used = health_stack_used();
+
+    TRACE_U16(TRACE_CH_CPU_LOAD, g_health_stats.u16_load_permille);
+    TRACE_U32(TRACE_CH_STACK, g_health_stats.u32_stack_used);
+}
+
+void health_idle_add(uint32_t u32_cycles)
+{
+    g_u32_health_idle += u32_cycles;
+}
+
+void health_isr_add(health_isr_t isr, uint32_t u32_cycles)
+{
+    if ((uint32_t)isr >= HEALTH_ISR_COUNT) {
+        return;
+    }
+
+    /* Handlers of other priorities may nest, keep the update atomic */
+    uint32_t u32_primask = __get_PRIMASK();
+    __disable_irq();
+    g_u32_health_isr_cycles[isr] += u32_cycles;
+    g_u32_health_isr_calls[isr]++;
+    __set_PRIMASK(u32_primask);
+}
+
+void health_get(health_stats_t *stats)
+{
+    *stats = g_health_stats;
+}
+
+uint32_t health_stack_used(void)
+{
+    const uint32_t *pu32_top  = &_estack;
+    const uint32_t *pu32_heap = (const uint32_t *)(((uintptr_t)sbrk(0) + 3u) & ~(uintptr_t)3u);
+    const uint32_t *pu32_word = pu32_heap;
+
+    while ((pu32_word < pu32_top) && (*pu32_word == HEALTH_STACK_PAINT)) {
+        pu32_word++;
+    }
+
+    if (pu32_word == pu32_heap) {
+        /* Not painted, or heap and stack met */
+        g_health_stats.u32_stack_free = 0u;
+        return 0u;
+    }
+
+    g_health_stats.u32_stack_free = (uint32_t)((uintptr_t)pu32_word - (uintptr_t)pu32_heap);
+    return (uint32_t)((uintptr_t)pu32_top - (uintptr_t)pu32_word);
+}
+
+void health_dump(health_putc_t putc)
+{
+    char buffer[64];
+    fmt_t fmt;
+
+    if (putc == NULL) {
+        return;
+    }
+
+    fmt_init(&fmt, buffer, sizeof(buffer));
+    fmt_str(&fmt, "cpu ");
+    fmt_fixed(&fmt, g_health_stats.u16_load_permille, 1u, 5u);
+    fmt_str(&fmt, " %  peak ");
+    fmt_fixed(&fmt, g_health_stats.u16_load_peak_permille, 1u, 5u);
+    fmt_str(&fmt, " %  window_us ");
+    fmt_u32(&fmt, utils_cycles_to_us(g_health_stats.u32_window_cycles), 0u, ' ');
+    fmt_str(&fmt, "\r\n");
+    health_puts(putc, fmt_get(&fmt));
+
+    fmt_init(&fmt, buffer, sizeof(buffer));
+    fmt_str(&fmt, "stack used ");
+    fmt_u32(&fmt, g_health_stats.u32_stack_used, 0u, ' ');
+    fmt_str(&fmt, " B  free ");
+    fmt_u32(&fmt, g_health_stats.u32_stack_free, 0u, ' ');
+    fmt_str(&fmt, " B\r\n");
+    health_puts(putc, fmt_get(&fmt));
+
+    health_puts(putc, "isr          calls  share\r\n");
+    for (uint8_t i = 0u; i < HEALTH_ISR_COUNT; i++) {
+        if (g_health_stats.u32_isr_calls[i] == 0u) {
+            continue;
+        }
+
+        fmt_init(&fmt, buffer, sizeof(buffer));
+        fmt_str(&fmt, g_pch_health_isr_names[i]);
+        fmt_pad(&fmt, 12u);
+        fmt_u32(&fmt, g_health_stats.u32_isr_calls[i], 6u, ' ');
+        fmt_fixed(&fmt, g_health_stats.u16_isr_permille[i], 1u, 7u);
+        fmt_str(&fmt, " %\r\n");
+        health_puts(putc, fmt_get(&fmt));
+    }
+}
+
+void health_lcd_line(uint8_t u8_line, uint16_t u16_color, uint16_t u16_size,
+                     uint16_t u16_background_color)
+{
+    char buffer[24];
+    fmt_t fmt;
+
+    fmt_init(&fmt, buffer, sizeof(buffer));
+    fmt_str(&fmt, "CPU ");
+    fmt_fixed(&fmt, g_health_stats.u16_load_permille, 1u, 5u);
+    fmt_str(&fmt, "% STK ");
+    fmt_u32(&fmt, g_health_stats.u32_stack_used, 0u, ' ');
+    fmt_pad(&fmt, 20u);
+    fmt_lcd_line(&fmt, u8_line, u16_color, u16_size, u16_background_color);
+}
+
+/* Static module functions -------------------------------------------------- */
+/**
+ * @brief Share of a part in 0.1 %, saturated at 100 %.
+ *
+ * @param u32_part  Part
+ * @param u32_whole Whole, 0 gives 0
+ * @return 0 .. 1000
+ */
+static uint16_t health_permille(uint32_t u32_part, uint32_t u32_whole)
+{
+    if (u32_whole == 0u) {
+        return 0u;
+    }
+    if (u32_part >= u32_whole) {
+        return 1000u;
+    }
+
+    return (uint16_t)(((uint64_t)u32_part * 1000u) / u32_whole);
+}
+
+/**
+ * @brief Writes a string through the output function.
+ *
+ * @param putc     Character output
+ * @param pch_text NUL terminated string
+ */
+static void health_puts(health_putc_t putc, const char *pch_text)
+{
+    while (*pch_text != '\0') {
+        putc(*pch_text++);
+    }
+}
@@ -0,0 +1,182 @@
+/**
+ ******************************************************************************
+ * @file        health.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the system health monitor.
+ *
+ * @details
+ * Shows how much headroom a configuration has at runtime: CPU load,
+ * time share of the main interrupts and the high water mark of the main
+ * stack. All times are DWT cycles; health_update() closes one
+ * measurement window and should be called regularly (e.g. once per
+ * second, at least every 23 s because of the counter wrap).
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - CPU load: the idle points of the modules (idle_sleep(), osal event
+ *    wait) count their __WFI() time, load = 1 - idle / window
+ *  - Interrupt share per handler (health_isr_t), preinstrumented in the
+ *    exti, fan, potis_dma, lcd, env_sensor and dot modules
+ *  - Main stack high water mark: the startup code paints the free RAM
+ *    between heap and stack with HEALTH_STACK_PAINT, the lowest
+ *    overwritten word is the deepest stack use so far
+ *  - Output as text (health_dump()), lcd line or trace packets
+ *  - Load and interrupt measurement compiled out unless HEALTH_ENABLE
+ *    is 1, the stack mark works always
+ *
+ * A main loop that polls without sleeping is never idle and shows 100 %
+ * load. Interrupt times include higher priority interrupts that preempt
+ * the handler. STOP mode (lowpower module) stops the cycle counter, such
+ * phases are missing from the window.
+ *
+ ******************************************************************************
+ */
+
+#ifndef HEALTH_HEALTH_H_
+#define HEALTH_HEALTH_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief 1 to compile the idle and interrupt instrumentation in.
+ */
+#ifndef HEALTH_ENABLE
+#define HEALTH_ENABLE       0
+#endif
+
+/**
+ * @brief Fill pattern of the free RAM, written by Reset_Handler in the
+ *        startup code of every project (keep both in sync).
+ */
+#define HEALTH_STACK_PAINT  0xA5A5A5A5UL
+
+#if HEALTH_ENABLE
+/**
+ * @brief Brackets a __WFI() (or any other idle time) in the same scope.
+ */
+#define HEALTH_IDLE_BEGIN()     uint32_t health_idle_start = DWT->CYCCNT
+#define HEALTH_IDLE_END()       health_idle_add(DWT->CYCCNT - health_idle_start)
+
+/**
+ * @brief Brackets the body of an interrupt handler in the same scope.
+ */
+#define HEALTH_ISR_BEGIN(isr)   uint32_t health_isr_start_##isr = DWT->CYCCNT
+#define HEALTH_ISR_END(isr)     health_isr_add((isr), DWT->CYCCNT - health_isr_start_##isr)
+#else
+#define HEALTH_IDLE_BEGIN()     do { } while (0)
+#define HEALTH_IDLE_END()       do { } while (0)
+#define HEALTH_ISR_BEGIN(isr)   do { } while (0)
+#define HEALTH_ISR_END(isr)     do { } while (0)
+#endif
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Measured interrupt handlers.
+ */
+typedef enum {
+    HEALTH_ISR_EXTI9_5 = 0,     /**< EXTI9_5_IRQHandler (fan tacho)       */
+    HEALTH_ISR_FAN_CONTROL,     /**< TIM6_DAC_IRQHandler (fan PI task)    */
+    HEALTH_ISR_POTIS_DMA,       /**< ADC1 stream (dma_alloc dispatch)     */
+    HEALTH_ISR_LCD_DMA,         /**< SPI5 TX stream (dma_alloc dispatch)  */
+    HEALTH_ISR_ENV_DMA,         /**< I2C RX streams (dma_alloc dispatch)  */
+    HEALTH_ISR_DOT,             /**< TIM4_IRQHandler (dot blink)          */
+    HEALTH_ISR_USER,            /**< Free for the application             */
+    HEALTH_ISR_COUNT
+} health_isr_t;
+
+/**
+ * @brief Result of the last window, shares in 0.1 %.
+ */
+typedef struct {
+    uint16_t u16_load_permille;                     /**< CPU load              */
+    uint16_t u16_load_peak_permille;                /**< Highest window load   */
+    uint16_t u16_isr_permille[HEALTH_ISR_COUNT];    /**< Share per handler     */
+    uint32_t u32_isr_calls[HEALTH_ISR_COUNT];       /**< Calls in the window   */
+    uint32_t u32_window_cycles;                     /**< Length of the window  */
+    uint32_t u32_stack_used;                        /**< High water in bytes   */
+    uint32_t u32_stack_free;                        /**< Bytes above the heap  */
+} health_stats_t;
+
+/**
+ * @brief Character output function (same signature as __io_putchar()).
+ */
+typedef int (*health_putc_t)(int ch);
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Starts the cycle counter, keeps it running in sleep mode
+ *        (DBGMCU DBG_SLEEP) and opens the first window.
+ *
+ * @return None
+ */
+void health_init(void);
+
+/**
+ * @brief Closes the window: computes load and interrupt shares, scans
+ *        the stack and sends the results on the trace channels.
+ *
+ * @return None
+ */
+void health_update(void);
+
+/**
+ * @brief Adds idle cycles (called by HEALTH_IDLE_END()).
+ *
+ * @param u32_cycles Idle cycles
+ * @return None
+ */
+void health_idle_add(uint32_t u32_cycles);
+
+/**
+ * @brief Adds one handler run (called by HEALTH_ISR_END()).
+ *
+ * @param isr        Handler
+ * @param u32_cycles Cycles of the run
+ * @return None
+ */
+void health_isr_add(health_isr_t isr, uint32_t u32_cycles);
+
+/**
+ * @brief Returns the results of the last window.
+ *
+ * @param stats Copy of the results
+ * @return None
+ */
+void health_get(health_stats_t *stats);
+
+/**
+ * @brief Returns the deepest main stack use since reset.
+ *
+ * Scans the painted area from the heap end up, takes a few cycles per
+ * free word.
+ *
+ * @return Bytes below _estack, 0 if the RAM was not painted
+ */
+uint32_t health_stack_used(void);
+
+/**
+ * @brief Prints the last window: load, stack and one line per handler
+ *        that ran.
+ *
+ * @param putc Character output (UART, ITM, ...)
+ * @return None
+ */
+void health_dump(health_putc_t putc);
+
+/**
+ * @brief Shows "CPU xx.x% STK n" on a line of the lcd.
+ *
+ * @param u8_line   Line on the screen
+ * @param u16_color Text color
+ * @param u16_size  Text size
+ * @param u16_background_color Background color
+ * @return None
+ */
+void health_lcd_line(uint8_t u8_line, uint16_t u16_color, uint16_t u16_size,
+                     uint16_t u16_background_color);
+
+#endif /* HEALTH_HEALTH_H_ */
@@ -0,0 +1,248 @@
+/**
+ ******************************************************************************
+ * @file        idle.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Tickless idle: SysTick suppression and timed __WFI()
+ *
+ * Functionality:
+ * - Deadline table, earliest deadline bounds the sleep
+ * - SysTick counter stopped during the sleep, its partial millisecond
+ *   and the wakeup timer count are added to a 0.1 ms accumulator, whole
+ *   milliseconds go to uwTick
+ * - Wakeup timer in one-pulse mode, URS set so only the overflow (not
+ *   the UG of the setup) raises the update flag
+ * - Everything between stopping and restarting SysTick runs with
+ *   interrupts masked; __WFI() still wakes on a pending interrupt
+ *
+ * Resources:
+ * - TIM13 (TIM8_UP_TIM13_IRQn), SysTick
+ ******************************************************************************
+ */
+
+#include "idle.h"
+#include <clock/clock.h>
+#include <osal/osal.h>
+#include <health/health.h>
+#include <tim_alloc/tim_alloc.h>
+
+/* Private Preprocessor Defines -------------------------------------------- */
+/**
+ * @brief Wakeup timer ticks per millisecond.
+ */
+#define IDLE_TICKS_PER_MS       (IDLE_TIM_COUNTER_HZ / 1000U)
+
+/* Static module variables -------------------------------------------------- */
+static uint32_t g_u32_idle_deadline[IDLE_MAX_CLIENTS];
+static volatile uint8_t g_u8_idle_active = 0u;     /**< Bit per client with deadline */
+static uint8_t g_u8_idle_clients = 0u;
+static uint8_t g_u8_idle_ready = 0u;
+static uint32_t g_u32_idle_sub_ticks = 0u;          /**< Carried 0.1 ms remainder */
+static idle_stats_t g_idle_stats;
+
+/* Static function prototypes ---------------------------------------------- */
+static uint32_t idle_time_to_deadline(uint32_t u32_now, uint32_t u32_max_ms);
+
+/* Public functions --------------------------------------------------------- */
+void idle_init(void)
+{
+    /* Without the timer idle_sleep() keeps the SysTick (g_u8_idle_ready 0) */
+    if (tim_alloc_claim(IDLE_TIM, TIM_ALLOC_OWNER_IDLE) != HAL_OK) {
+        return;
+    }
+
+    IDLE_TIM->CR1  = TIM_CR1_URS | TIM_CR1_OPM;
+    IDLE_TIM->SR   = 0u;
+    IDLE_TIM->DIER = TIM_DIER_UIE;
+
+    HAL_NVIC_SetPriority(IDLE_IRQn, IDLE_IRQ_PRIORITY, 0u);
+    HAL_NVIC_EnableIRQ(IDLE_IRQn);
+
+    g_idle_stats = (idle_stats_t){0};
+    g_u32_idle_sub_ticks = 0u;
+    g_u8_idle_ready = 1u;
+}
+
+HAL_StatusTypeDef idle_add_client(uint8_t *pu8_id)
+{
+    if (g_u8_idle_clients >= IDLE_MAX_CLIENTS) {
+        return HAL_ERROR;
+    }
+
+    *pu8_id = g_u8_idle_clients++;
+
+    return HAL_OK;
+}
+
+void idle_set_deadline(uint8_t u8_id, uint32_t u32_tick)
+{
+    uint32_t u32_primask = __get_PRIMASK();
+
+    if (u8_id >= g_u8_idle_clients) {
+        return;
+    }
+
+    __disable_irq();
+    g_u32_idle_deadline[u8_id] = u32_tick;
+    g_u8_idle_active |= (uint8_t)(1u << u8_id);
+    __set_PRIMASK(u32_primask);
+}
+
+void idle_clear_deadline(uint8_t u8_id)
+{
+    uint32_t u32_primask = __get_PRIMASK();
+
+    if (u8_id >= g_u8_idle_clients) {
+        return;
+    }
+
+    __disable_irq();
+    g_u8_idle_active &= (uint8_t)~(1u << u8_id);
+    __set_PRIMASK(u32_primask);
+}
+
+uint32_t idle_sleep(uint32_t u32_max_ms)
+{
+    uint32_t u32_primask = __get_PRIMASK();
+    uint32_t u32_ms;
+    uint32_t u32_load;
+    uint32_t u32_ticks;
+    uint32_t u32_slept_ms;
+
+    if (__get_IPSR() != 0u) {
+        return 0u;
+    }
+
+    __disable_irq();
+
+    u32_ms = idle_time_to_deadline(HAL_GetTick(), u32_max_ms);
+    if (u32_ms == 0u) {
+        __set_PRIMASK(u32_primask);
+        return 0u;
+    }
+
+    /* Next tick is close or no wakeup timer: sleep until the next interrupt */
+    if (!g_u8_idle_ready || OSAL_FREERTOS || (u32_ms <= 1u)) {
+        HEALTH_IDLE_BEGIN();
+        __DSB();
+        __WFI();
+        HEALTH_IDLE_END();
+        __set_PRIMASK(u32_primask);
+        return 0u;
+    }
+
+    if (u32_ms > IDLE_MAX_SLEEP_MS) {
+        u32_ms = IDLE_MAX_SLEEP_MS;
+    }
+
+    /* Stop SysTick, keep the part of the running millisecond */
+    u32_load = SysTick->LOAD;
+    SysTick->CTRL &= ~(SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk);
+    g_u32_idle_sub_ticks += ((u32_load - SysTick->VAL) * IDLE_TICKS_PER_MS) / (u32_load + 1u);
+
+    /* One pulse: overflows once after the sleep time, minus the carry */
+    u32_ticks = u32_ms * IDLE_TICKS_PER_MS - g_u32_idle_sub_ticks;
+    IDLE_TIM->PSC = (clock_get_apb1_timer_clock() / IDLE_TIM_COUNTER_HZ) - 1u;
+    IDLE_TIM->ARR = u32_ticks - 1u;
+    IDLE_TIM->EGR = TIM_EGR_UG;
+    IDLE_TIM->SR  = 0u;
+    IDLE_TIM->CR1 = TIM_CR1_URS | TIM_CR1_OPM | TIM_CR1_CEN;
+
+    HEALTH_IDLE_BEGIN();
+    __DSB();
+    __WFI();
+    HEALTH_IDLE_END();
+
+    /* Woken: timer overflow or another interrupt (not served yet) */
+    IDLE_TIM->CR1 = TIM_CR1_URS | TIM_CR1_OPM;
+    if (IDLE_TIM->SR & TIM_SR_UIF) {
+        g_u32_idle_sub_ticks += u32_ticks;
+    } else {
+        g_u32_idle_sub_ticks += IDLE_TIM->CNT;
+        g_idle_stats.u32_early_wakeups++;
+    }
+    IDLE_TIM->SR = 0u;
+    NVIC_ClearPendingIRQ(IDLE_IRQn);
+
+    u32_slept_ms = g_u32_idle_sub_ticks / IDLE_TICKS_PER_MS;
+    g_u32_idle_sub_ticks -= u32_slept_ms * IDLE_TICKS_PER_MS;
+    uwTick += u32_slept_ms;
+
+    /* Restart SysTick with a full millisecond */
+    SysTick->VAL  = 0u;
+    SysTick->CTRL |= SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk;
+
+    g_idle_stats.u32_sleeps++;
+    g_idle_stats.u32_slept_ms += u32_slept_ms;
+
+    __set_PRIMASK(u32_primask);
+
+    return u32_slept_ms;
+}
+
+void idle_get_stats(idle_stats_t *stats)
+{
+    *stats = g_idle_stats;
+}
+
+#if IDLE_HAL_DELAY && !OSAL_FREERTOS
+/**
+ * @brief Sleeping replacement of the weak HAL_Delay(), same timing
+ *        (at least Delay ms). Busy like the HAL version in interrupts
+ *        and with interrupts masked.
+ *
+ * @param Delay Time in ms
+ * @return None
+ */
+void HAL_Delay(uint32_t Delay)
+{
+    uint32_t u32_start = HAL_GetTick();
+    uint32_t u32_wait = Delay;
+
+    if (u32_wait < HAL_MAX_DELAY) {
+        u32_wait += (uint32_t)uwTickFreq;
+    }
+
+    while ((HAL_GetTick() - u32_start) < u32_wait) {
+        if ((__get_IPSR() == 0u) && (__get_PRIMASK() == 0u)) {
+            idle_sleep(u32_wait - (HAL_GetTick() - u32_start));
+        }
+    }
+}
+#endif
+
+/* Static module functions -------------------------------------------------- */
+/**
+ * @brief Returns the time until the earliest deadline.
+ *
+ * @param u32_now    Current HAL tick
+ * @param u32_max_ms Upper bound
+ * @return Time in ms, 0 if a deadline has already passed
+ */
+static uint32_t idle_time_to_deadline(uint32_t u32_now, uint32_t u32_max_ms)
+{
+    uint32_t u32_ms = u32_max_ms;
+
+    for (uint8_t i = 0u; i < g_u8_idle_clients; i++) {
+        if (g_u8_idle_active & (1u << i)) {
+            int32_t i32_left = (int32_t)(g_u32_idle_deadline[i] - u32_now);
+
+            if (i32_left <= 0) {
+                return 0u;
+            }
+            if ((uint32_t)i32_left < u32_ms) {
+                u32_ms = (uint32_t)i32_left;
+            }
+        }
+    }
+
+    return u32_ms;
+}
+
+/* Interrupt / callback section -------------------------------------------- */
+void TIM8_UP_TIM13_IRQHandler(void)
+{
+    /* Only wakes the core, idle_sleep() evaluates the flag */
+    IDLE_TIM->SR = (uint32_t)~TIM_SR_UIF;
+}
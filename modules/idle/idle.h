@@ -0,0 +1,143 @@
+/**
+ ******************************************************************************
+ * @file        idle.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the tickless idle module.
+ *
+ * @details
+ * Lets the main loop sleep between work items instead of spinning.
+ * Modules register as idle clients and declare the next HAL tick they
+ * need to run at; idle_sleep() stops SysTick, programs a one-pulse
+ * wakeup timer for the earliest deadline and sleeps with __WFI(). Any
+ * other interrupt (DMA, EXTI, control timers) still ends the sleep
+ * early. On wakeup the elapsed time is read from the wakeup timer, the
+ * HAL tick is advanced by it and SysTick is restarted before the
+ * interrupt that woke the core runs, so HAL_GetTick() is correct in it.
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - Up to IDLE_MAX_CLIENTS deadlines (absolute HAL ticks)
+ *  - Tickless sleep up to IDLE_MAX_SLEEP_MS per call, 0.1 ms timer
+ *    resolution, remainders carried over (no tick drift)
+ *  - Short or unconfigured sleeps: plain __WFI() with SysTick running
+ *  - HAL_Delay() replacement that sleeps instead of polling uwTick
+ *    (IDLE_HAL_DELAY), busy in interrupts as before
+ *  - Statistics: sleeps, time slept, wakeups before the deadline
+ *
+ * Bare metal only: with OSAL_FREERTOS the kernel owns SysTick and
+ * idle_sleep() is a plain __WFI().
+ *
+ ******************************************************************************
+ */
+
+#ifndef IDLE_IDLE_H_
+#define IDLE_IDLE_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+#include "irq/irq.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief Maximum number of idle clients.
+ */
+#define IDLE_MAX_CLIENTS        8U
+
+/**
+ * @brief Wakeup timer (APB1, 16 bit). Its interrupt is shared with the
+ *        TIM8 update interrupt, which no module uses.
+ */
+#define IDLE_TIM                TIM13
+#define IDLE_IRQn               TIM8_UP_TIM13_IRQn
+
+/**
+ * @brief Counter clock of the wakeup timer in Hz (0.1 ms per tick).
+ */
+#define IDLE_TIM_COUNTER_HZ     10000U
+
+/**
+ * @brief Longest tickless sleep per idle_sleep() call in ms (16 bit
+ *        counter).
+ */
+#define IDLE_MAX_SLEEP_MS       6000U
+
+/**
+ * @brief NVIC priority of the wakeup timer interrupt (lowest).
+ */
+#define IDLE_IRQ_PRIORITY       IRQ_CLASS_IDLE
+
+/**
+ * @brief 1 to replace the weak HAL_Delay() by a sleeping version.
+ */
+#ifndef IDLE_HAL_DELAY
+#define IDLE_HAL_DELAY          1
+#endif
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Idle statistics since idle_init().
+ */
+typedef struct {
+    uint32_t u32_sleeps;        /**< Tickless sleeps                       */
+    uint32_t u32_slept_ms;      /**< Time spent in tickless sleep          */
+    uint32_t u32_early_wakeups; /**< Sleeps ended by another interrupt     */
+} idle_stats_t;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Prepares the wakeup timer. Without it idle_sleep() only uses
+ *        __WFI() with SysTick running.
+ *
+ * @return None
+ */
+void idle_init(void);
+
+/**
+ * @brief Registers an idle client.
+ *
+ * @param pu8_id Receives the client id
+ * @return HAL_OK, HAL_ERROR if all clients are taken
+ */
+HAL_StatusTypeDef idle_add_client(uint8_t *pu8_id);
+
+/**
+ * @brief Sets the next HAL tick a client needs the CPU at.
+ *
+ * @param u8_id    Client id
+ * @param u32_tick Absolute HAL tick (HAL_GetTick() + delay)
+ * @return None
+ */
+void idle_set_deadline(uint8_t u8_id, uint32_t u32_tick);
+
+/**
+ * @brief Removes the deadline of a client (no timed wakeup needed).
+ *
+ * @param u8_id Client id
+ * @return None
+ */
+void idle_clear_deadline(uint8_t u8_id);
+
+/**
+ * @brief Sleeps until the earliest deadline, at most u32_max_ms, or
+ *        until any interrupt.
+ *
+ * May be called with interrupts masked (e.g. after checking for work
+ * with __disable_irq()): a pending interrupt still ends the sleep and
+ * runs once the caller unmasks.
+ *
+ * @param u32_max_ms Upper bound of the sleep in ms
+ * @return Time slept in ms (tickless part)
+ */
+uint32_t idle_sleep(uint32_t u32_max_ms);
+
+/**
+ * @brief Copies the idle statistics.
+ *
+ * @param stats Destination
+ * @return None
+ */
+void idle_get_stats(idle_stats_t *stats);
+
+#endif /* IDLE_IDLE_H_ */
@@ -0,0 +1,102 @@
+/**
+ ******************************************************************************
+ * @file        irq.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       System-wide NVIC priority plan
+ *
+ * Functionality:
+ * - Plan table of the fixed vectors with their owners
+ * - Grouping and priorities at init, check of the enabled vectors for a
+ *   priority less urgent than planned
+ *
+ * Resources:
+ * - NVIC priority registers (no vector is enabled here)
+ ******************************************************************************
+ */
+
+#include "irq.h"
+
+#include <stddef.h>
+
+/* Private Type Definitions ------------------------------------------------ */
+/**
+ * @brief One fixed vector of the plan.
+ */
+typedef struct {
+    IRQn_Type irqn;
+    uint8_t   u8_class;
+    uint8_t   u8_subpriority;
+} irq_plan_entry_t;
+
+/* Static Module Variables ------------------------------------------------- */
+/**
+ * @brief Fixed vectors. A vector shared by several lines (EXTI9_5,
+ *        EXTI15_10) takes the class of its most urgent user.
+ */
+static const irq_plan_entry_t g_irq_plan[] = {
+    { EXTI0_IRQn,              IRQ_CLASS_CAPTURE,  1U },  /* stopwatch button     */
+    { EXTI2_IRQn,              IRQ_CLASS_TRANSFER, 0U },  /* gyro watermark       */
+    { TIM5_IRQn,               IRQ_CLASS_CAPTURE,  0U },  /* stopwatch timer      */
+    { EXTI9_5_IRQn,            IRQ_CLASS_CAPTURE,  0U },  /* fan tacho, joystick  */
+    { RTC_WKUP_IRQn,           IRQ_CLASS_WAKEUP,   0U },  /* lowpower             */
+    { TIM7_IRQn,               IRQ_CLASS_REFRESH,  0U },  /* esd refresh          */
+    { TIM3_IRQn,               IRQ_CLASS_REFRESH,  0U },  /* joystick sampling    */
+    { EXTI15_10_IRQn,          IRQ_CLASS_REFRESH,  0U },  /* joystick, lcd TE     */
+    { LTDC_IRQn,               IRQ_CLASS_REFRESH,  0U },  /* framebuffer flip     */
+    { TIM4_IRQn,               IRQ_CLASS_GATE,     0U },  /* dot blink            */
+    { TIM6_DAC_IRQn,           IRQ_CLASS_CONTROL,  0U },  /* fan control task     */
+    { ADC_IRQn,                IRQ_CLASS_TRANSFER, 0U },  /* potis; AWD: capture  */
+    { I2C1_EV_IRQn,            IRQ_CLASS_TRANSFER, 0U },  /* env_sensor           */
+    { I2C1_ER_IRQn,            IRQ_CLASS_TRANSFER, 0U },
+    { I2C3_EV_IRQn,            IRQ_CLASS_TRANSFER, 0U },
+    { I2C3_ER_IRQn,            IRQ_CLASS_TRANSFER, 0U },
+    { USART1_IRQn,             IRQ_CLASS_TRANSFER, 0U },  /* uart_telemetry       */
+    { CAN1_TX_IRQn,            IRQ_CLASS_TRANSFER, 0U },  /* can_node             */
+    { CAN1_RX0_IRQn,           IRQ_CLASS_TRANSFER, 0U },
+    { CAN1_RX1_IRQn,           IRQ_CLASS_TRANSFER, 0U },
+    { CAN2_TX_IRQn,            IRQ_CLASS_TRANSFER, 0U },
+    { CAN2_RX0_IRQn,           IRQ_CLASS_TRANSFER, 0U },
+    { CAN2_RX1_IRQn,           IRQ_CLASS_TRANSFER, 0U },
+    { OTG_HS_IRQn,             IRQ_CLASS_TRANSFER, 0U },  /* usb_cdc              */
+    { SDIO_IRQn,               IRQ_CLASS_STORAGE,  0U },  /* sdcard               */
+    { TIM8_UP_TIM13_IRQn,      IRQ_CLASS_IDLE,     0U },  /* idle wakeup          */
+};
+
+#define IRQ_PLAN_LENGTH (sizeof(g_irq_plan) / sizeof(g_irq_plan[0]))
+
+/* Public functions --------------------------------------------------------- */
+void irq_init(void)
+{
+    HAL_NVIC_SetPriorityGrouping(IRQ_PRIORITY_GROUPING);
+
+    for (uint32_t i = 0U; i < IRQ_PLAN_LENGTH; i++) {
+        HAL_NVIC_SetPriority(g_irq_plan[i].irqn, g_irq_plan[i].u8_class, g_irq_plan[i].u8_subpriority);
+    }
+}
+
+HAL_StatusTypeDef irq_check(irq_mismatch_t *p_mismatch)
+{
+    uint32_t u32_grouping = NVIC_GetPriorityGrouping();
+
+    for (uint32_t i = 0U; i < IRQ_PLAN_LENGTH; i++) {
+        uint32_t u32_preempt;
+        uint32_t u32_sub;
+
+        if (!NVIC_GetEnableIRQ(g_irq_plan[i].irqn)) {
+            continue;
+        }
+        NVIC_DecodePriority(NVIC_GetPriority(g_irq_plan[i].irqn), u32_grouping, &u32_preempt, &u32_sub);
+        if (u32_preempt > g_irq_plan[i].u8_class) {
+            if (p_mismatch != NULL) {
+                p_mismatch->irqn        = g_irq_plan[i].irqn;
+                p_mismatch->u32_planned = g_irq_plan[i].u8_class;
+                p_mismatch->u32_actual  = u32_preempt;
+            }
+            return HAL_ERROR;
+        }
+    }
+
+    return HAL_OK;
+}
@@ -0,0 +1,94 @@
+/**
+ ******************************************************************************
+ * @file        irq.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       System-wide NVIC priority plan.
+ *
+ * @details
+ * Every interrupt source belongs to a latency class; the class fixes its
+ * preemption priority. The module headers take their *_IRQ_PRIORITY
+ * defaults from the classes here, so the relation between the sources
+ * is decided in one place: an edge time stamp (fan tacho, stopwatch)
+ * preempts the control task, which preempts the completion handlers of
+ * the bulk transfers (SPI display DMA, ADC blocks, I2C, UART, USB,
+ * SDIO). Before, the tacho and the stopwatch ran at 0 (fine) but the
+ * display DMA shared level 5 with the control task and could delay it.
+ *
+ * All four priority bits are preemption bits (NVIC_PRIORITYGROUP_4, as
+ * HAL_Init() sets it), subpriorities only order pending interrupts of
+ * one level. With the RTOS build every class that signals the kernel
+ * must stay at or below OSAL_IRQ_PRIORITY_MIN (checked by the modules).
+ *
+ * irq_init() sets the grouping and the priority of every fixed vector in
+ * the plan table; DMA stream vectors come from dma_alloc at run time and
+ * are set by their owners with the same class macros. irq_check() finds
+ * an enabled vector that is less urgent than planned, e.g. after a
+ * module was built with its own -D..._IRQ_PRIORITY. More urgent is
+ * allowed: a shared EXTI vector is planned for its most urgent user and
+ * runs at the class of the users present in the image.
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - Latency classes as preemption priorities (usable in #if)
+ *  - Plan table: fixed vector -> class, applied at init
+ *  - Check of the enabled vectors against the plan
+ *
+ ******************************************************************************
+ */
+
+#ifndef IRQ_IRQ_H_
+#define IRQ_IRQ_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief Priority grouping: 4 preemption bits, no subpriority bits.
+ */
+#define IRQ_PRIORITY_GROUPING   NVIC_PRIORITYGROUP_4
+
+/**
+ * @brief Latency classes, most urgent first (preemption priority).
+ */
+#define IRQ_CLASS_CAPTURE       0U  /**< Edge time stamps: tacho, stopwatch    */
+#define IRQ_CLASS_WAKEUP        2U  /**< RTC wakeup from stop mode             */
+#define IRQ_CLASS_REFRESH       3U  /**< Display multiplex, key sampling       */
+#define IRQ_CLASS_GATE          4U  /**< PWM gates (dot blink)                 */
+#define IRQ_CLASS_CONTROL       5U  /**< Control task                          */
+#define IRQ_CLASS_TRANSFER      6U  /**< DMA / ADC / I2C / SPI / UART / USB    */
+#define IRQ_CLASS_STORAGE       7U  /**< SDIO and its DMA                      */
+#define IRQ_CLASS_IDLE          15U /**< Idle wakeup timer, HAL tick           */
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Vector less urgent than planned.
+ */
+typedef struct {
+    IRQn_Type irqn;             /**< Vector                              */
+    uint32_t  u32_planned;      /**< Preemption priority of the plan     */
+    uint32_t  u32_actual;       /**< Preemption priority set             */
+} irq_mismatch_t;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Sets the priority grouping and the priorities of all fixed
+ *        vectors of the plan. Call after HAL_Init(), before the modules
+ *        enable their interrupts.
+ *
+ * @return None
+ */
+void irq_init(void);
+
+/**
+ * @brief Compares the enabled vectors of the plan with their priority.
+ *
+ * @param p_mismatch First vector less urgent than planned, NULL if not
+ *                   needed
+ * @return HAL_OK, HAL_ERROR if a vector is less urgent than planned
+ */
+HAL_StatusTypeDef irq_check(irq_mismatch_t *p_mismatch);
+
+#endif /* IRQ_IRQ_H_ */
@@ -10,6 +10,49 @@
 
 
 #include "joystick.h"
+#include <clock/clock.h>
+#include <exti/exti.h>
+#include <sync/sync.h>
+#include <tim_alloc/tim_alloc.h>
+
+/** @brief Zähltakt des Abtast-Timers in Hz */
+#define SAMPLE_COUNTER_HZ	1000000U
+
+/** @brief Umrechnung einer Zeit in ms in Abtastungen */
+#define MS_TO_SAMPLES(ms)	(((uint32_t)(ms) * JOYSTICK_SAMPLE_HZ) / 1000U)
+
+/** @brief Pin je Richtung, Reihenfolge wie joystick_key_t */
+static const uint16_t key_pins[JOYSTICK_KEY_COUNT] = {
+	JS_UP, JS_DOWN, JS_LEFT, JS_RIGHT, JS_PRESS
+};
+
+/** @brief Integrator je Richtung (0 = losgelassen, JOYSTICK_DEBOUNCE_SAMPLES = gedrückt) */
+static uint8_t integrator[JOYSTICK_KEY_COUNT];
+
+/** @brief Haltezeit je Richtung in Abtastungen, bleibt beim langen Druck stehen */
+static uint16_t hold_samples[JOYSTICK_KEY_COUNT];
+
+/** @brief Abtastungen bis zum nächsten Wiederholereignis */
+static uint16_t repeat_samples[JOYSTICK_KEY_COUNT];
+
+/** @brief Aktueller Abstand der Wiederholereignisse in Abtastungen (beschleunigt) */
+static uint16_t repeat_interval[JOYSTICK_KEY_COUNT];
+
+/** @brief Wiederholereignisse seit dem Drücken */
+static uint16_t repeat_count[JOYSTICK_KEY_COUNT];
+
+/** @brief Entprellter Zustand, Bit joystick_key_t = gedrückt */
+static volatile uint8_t keys;
+
+/** @brief Ereigniswarteschlange: Schreiben im Interrupt, Lesen in der Hauptschleife */
+static joystick_event_t queue_buffer[JOYSTICK_QUEUE_SIZE];
+static sync_queue_t queue;
+
+static void start_sampling(void *context);
+static void stop_sampling(void);
+static void sample(void);
+static void accelerate(uint8_t k);
+static void push_event(joystick_key_t key, joystick_event_type_t type, uint16_t repeat);
 
 /**
  * @brief Initialisiert alle GPIO-Pins für den Joystick als Eingänge.
@@ -84,3 +127,237 @@ GPIO_PinState readPRESS(void){
 	return HAL_GPIO_ReadPin(GPIOG, JS_PRESS);
 }
 
+/**
+ * @brief Startet den Ereignisbetrieb.
+ *
+ * Die EXTI-Handler werden vor der Pin-Konfiguration eingetragen, damit
+ * keine Flanke ohne Handler ankommt. Leitung 6 und 9 teilen sich
+ * EXTI9_5, die Leitungen 10..12 EXTI15_10.
+ */
+HAL_StatusTypeDef joystick_init_events(void){
+
+	GPIO_InitTypeDef GPIO_InitStructPG;
+
+	if (tim_alloc_claim(JOYSTICK_SAMPLE_TIM, TIM_ALLOC_OWNER_JOYSTICK) != HAL_OK) {
+		return HAL_BUSY;
+	}
+
+	for (uint8_t k = 0; k < JOYSTICK_KEY_COUNT; k++) {
+		if (exti_register(exti_pin_to_line(key_pins[k]), start_sampling, NULL) != HAL_OK) {
+			while (k-- > 0) {
+				exti_unregister(exti_pin_to_line(key_pins[k]));
+			}
+			return HAL_ERROR;
+		}
+		integrator[k] = 0;
+		hold_samples[k] = 0;
+	}
+
+	keys = 0;
+	sync_queue_init(&queue, queue_buffer, sizeof(joystick_event_t), JOYSTICK_QUEUE_SIZE);
+
+	// Abtast-Timer vorbereiten, er läuft erst nach der ersten Flanke
+
+	JOYSTICK_SAMPLE_TIM->CR1 = 0;
+	JOYSTICK_SAMPLE_TIM->PSC = (clock_get_apb1_timer_clock() / SAMPLE_COUNTER_HZ) - 1U;
+	JOYSTICK_SAMPLE_TIM->ARR = (SAMPLE_COUNTER_HZ / JOYSTICK_SAMPLE_HZ) - 1U;
+	JOYSTICK_SAMPLE_TIM->EGR = TIM_EGR_UG;
+	JOYSTICK_SAMPLE_TIM->SR = 0;
+	JOYSTICK_SAMPLE_TIM->DIER = TIM_DIER_UIE;
+
+	HAL_NVIC_SetPriority(JOYSTICK_SAMPLE_IRQn, JOYSTICK_IRQ_PRIORITY, 0);
+	HAL_NVIC_EnableIRQ(JOYSTICK_SAMPLE_IRQn);
+
+	__HAL_RCC_GPIOG_CLK_ENABLE();
+
+	GPIO_InitStructPG.Pin = JS_ALL;
+	GPIO_InitStructPG.Mode = GPIO_MODE_IT_RISING_FALLING;
+	GPIO_InitStructPG.Pull = GPIO_PULLUP;
+	GPIO_InitStructPG.Speed = GPIO_SPEED_MEDIUM;
+
+	HAL_GPIO_Init(GPIOG, &GPIO_InitStructPG);
+
+	exti_enable_irq(exti_pin_to_line(JS_DOWN), JOYSTICK_IRQ_PRIORITY, 0);
+	exti_enable_irq(exti_pin_to_line(JS_UP), JOYSTICK_IRQ_PRIORITY, 0);
+
+	// Schon beim Start gedrückt: sofort abtasten
+	if ((~GPIOG->IDR) & JS_ALL) {
+		start_sampling(NULL);
+	}
+
+	return HAL_OK;
+}
+
+/**
+ * @brief Holt das älteste Ereignis aus der Warteschlange.
+ *
+ * Einziger Leser ist die Hauptschleife, einziger Schreiber der
+ * Abtast-Interrupt (sync_queue_t, ohne Sperren).
+ */
+uint8_t joystick_get_event(joystick_event_t *event){
+	return sync_queue_pop(&queue, event);
+}
+
+/**
+ * @brief Liefert den entprellten Zustand aller Richtungen.
+ */
+uint8_t joystick_get_keys(void){
+	return keys;
+}
+
+/**
+ * @brief Liefert die Anzahl der verworfenen Ereignisse.
+ */
+uint32_t joystick_get_dropped(void){
+	return sync_queue_get_dropped(&queue);
+}
+
+/**
+ * @brief EXTI-Handler aller Joystick-Leitungen: sperrt die Leitungen und
+ *        startet den Abtast-Timer.
+ *
+ * @param context Unbenutzt
+ */
+static void start_sampling(void *context){
+
+	(void)context;
+
+	EXTI->IMR &= ~(uint32_t)JS_ALL;
+	EXTI->PR = JS_ALL;
+
+	JOYSTICK_SAMPLE_TIM->CNT = 0;
+	JOYSTICK_SAMPLE_TIM->CR1 |= TIM_CR1_CEN;
+}
+
+/**
+ * @brief Hält den Abtast-Timer an und gibt die EXTI-Leitungen frei.
+ *
+ * Eine Flanke zwischen der letzten Abtastung und der Freigabe würde
+ * verloren gehen; ist danach schon eine Richtung gedrückt, wird sofort
+ * weiter abgetastet.
+ */
+static void stop_sampling(void){
+
+	JOYSTICK_SAMPLE_TIM->CR1 &= ~TIM_CR1_CEN;
+
+	EXTI->PR = JS_ALL;
+	EXTI->IMR |= JS_ALL;
+
+	if ((~GPIOG->IDR) & JS_ALL) {
+		start_sampling(NULL);
+	}
+}
+
+/**
+ * @brief Eine Abtastung: alle fünf Leitungen mit einem IDR-Zugriff.
+ *
+ * Der Integrator zählt je Abtastung um 1 in Richtung des Pegels und
+ * schaltet den Zustand erst an den Grenzen um; Prellen kürzer als
+ * JOYSTICK_DEBOUNCE_SAMPLES Abtastungen erzeugt kein Ereignis.
+ */
+static void sample(void){
+
+	uint32_t pressed = ~GPIOG->IDR;		// gedrückt = LOW
+	uint8_t busy = 0;
+
+	for (uint8_t k = 0; k < JOYSTICK_KEY_COUNT; k++) {
+		uint8_t bit = (uint8_t)(1U << k);
+
+		if (pressed & key_pins[k]) {
+			if (integrator[k] < JOYSTICK_DEBOUNCE_SAMPLES) {
+				integrator[k]++;
+			}
+		} else if (integrator[k] > 0) {
+			integrator[k]--;
+		}
+
+		if ((integrator[k] == JOYSTICK_DEBOUNCE_SAMPLES) && !(keys & bit)) {
+			keys |= bit;
+			hold_samples[k] = 0;
+			repeat_samples[k] = MS_TO_SAMPLES(JOYSTICK_REPEAT_DELAY_MS);
+			repeat_interval[k] = MS_TO_SAMPLES(JOYSTICK_REPEAT_MS);
+			repeat_count[k] = 0;
+			push_event((joystick_key_t)k, JOYSTICK_EVENT_PRESS, 0);
+		} else if ((integrator[k] == 0) && (keys & bit)) {
+			keys &= (uint8_t)~bit;
+			push_event((joystick_key_t)k, JOYSTICK_EVENT_RELEASE, 0);
+		} else if (keys & bit) {
+			if ((hold_samples[k] < MS_TO_SAMPLES(JOYSTICK_LONG_PRESS_MS)) &&
+				(++hold_samples[k] == MS_TO_SAMPLES(JOYSTICK_LONG_PRESS_MS))) {
+				push_event((joystick_key_t)k, JOYSTICK_EVENT_LONG, 0);
+			}
+			if (--repeat_samples[k] == 0) {
+				repeat_samples[k] = repeat_interval[k];
+				if (repeat_count[k] < UINT16_MAX) {
+					repeat_count[k]++;
+				}
+				push_event((joystick_key_t)k, JOYSTICK_EVENT_REPEAT, repeat_count[k]);
+				accelerate(k);
+			}
+		}
+
+		busy |= integrator[k];
+	}
+
+	if (!busy) {
+		stop_sampling();
+	}
+}
+
+/**
+ * @brief Verkürzt den Abstand der Wiederholereignisse einer Richtung.
+ *
+ * Abstand -= Abstand / 2^JOYSTICK_REPEAT_ACCEL_SHIFT, mindestens um eine
+ * Abtastung, nicht unter JOYSTICK_REPEAT_MIN_MS: die Frequenz wächst
+ * exponentiell bis zur Grenze. Nur Shift und Subtraktion im Interrupt.
+ *
+ * @param k  Richtung
+ */
+static void accelerate(uint8_t k){
+
+	uint16_t step;
+
+	if (JOYSTICK_REPEAT_ACCEL_SHIFT == 0U) {
+		return;
+	}
+
+	step = (uint16_t)(repeat_interval[k] >> JOYSTICK_REPEAT_ACCEL_SHIFT);
+	if (step == 0) {
+		step = 1;
+	}
+	if (repeat_interval[k] > MS_TO_SAMPLES(JOYSTICK_REPEAT_MIN_MS) + step) {
+		repeat_interval[k] -= step;
+	} else {
+		repeat_interval[k] = MS_TO_SAMPLES(JOYSTICK_REPEAT_MIN_MS);
+	}
+}
+
+/**
+ * @brief Hängt ein Ereignis an die Warteschlange an; ist sie voll, wird
+ *        das neue Ereignis verworfen und gezählt.
+ *
+ * @param key    Richtung
+ * @param type   Ereignisart
+ * @param repeat Nummer des Wiederholereignisses, sonst 0
+ */
+static void push_event(joystick_key_t key, joystick_event_type_t type, uint16_t repeat){
+
+	joystick_event_t event;
+
+	event.key = key;
+	event.type = type;
+	event.repeat = repeat;
+	event.time_ms = HAL_GetTick();
+	(void)sync_queue_push(&queue, &event);
+}
+
+/**
+ * @brief Interrupt des Abtast-Timers (1 je Abtastung).
+ */
+void TIM3_IRQHandler(void){
+
+	if (JOYSTICK_SAMPLE_TIM->SR & TIM_SR_UIF) {
+		JOYSTICK_SAMPLE_TIM->SR = (uint32_t)~TIM_SR_UIF;
+		sample();
+	}
+}
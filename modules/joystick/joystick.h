@@ -12,6 +12,7 @@
 #define JOYSTICK_JOYSTICK_H_
 
 #include "stm32f4xx.h"
+#include "irq/irq.h"
 
 /**
  * @file joystick.h
@@ -57,6 +58,96 @@
 #define JS_ALL (JS_UP | JS_DOWN | JS_LEFT | JS_RIGHT | JS_PRESS)
 
 
+/**
+ * @brief Timer für die Abtastung im Ereignisbetrieb (APB1, von keinem
+ *        anderen Modul belegt)
+ */
+#define JOYSTICK_SAMPLE_TIM				TIM3
+#define JOYSTICK_SAMPLE_IRQn			TIM3_IRQn
+
+/** @brief Abtastrate des Ereignisbetriebs in Hz (1 Abtastung je ms) */
+#define JOYSTICK_SAMPLE_HZ				1000U
+
+/**
+ * @brief Integratorgrenze: so viele Abtastungen in Folge muss eine Leitung
+ *        gedrückt bzw. losgelassen sein, bis der Zustand wechselt (5 ms)
+ */
+#ifndef JOYSTICK_DEBOUNCE_SAMPLES
+#define JOYSTICK_DEBOUNCE_SAMPLES		5U
+#endif
+
+/** @brief Haltezeit bis zum ersten Wiederholereignis in ms */
+#ifndef JOYSTICK_REPEAT_DELAY_MS
+#define JOYSTICK_REPEAT_DELAY_MS		500U
+#endif
+
+/** @brief Abstand der ersten Wiederholereignisse in ms */
+#ifndef JOYSTICK_REPEAT_MS
+#define JOYSTICK_REPEAT_MS				150U
+#endif
+
+/**
+ * @brief Beschleunigung: nach jedem Wiederholereignis wird der Abstand um
+ *        1/2^JOYSTICK_REPEAT_ACCEL_SHIFT kürzer (exponentiell), bis
+ *        JOYSTICK_REPEAT_MIN_MS erreicht ist. Shift 0 schaltet die
+ *        Beschleunigung ab. Mit den Standardwerten nach etwa 1,6 s gehalten
+ *        50 Ereignisse je Sekunde.
+ */
+#ifndef JOYSTICK_REPEAT_ACCEL_SHIFT
+#define JOYSTICK_REPEAT_ACCEL_SHIFT		3U
+#endif
+
+/** @brief Kürzester Abstand der Wiederholereignisse in ms */
+#ifndef JOYSTICK_REPEAT_MIN_MS
+#define JOYSTICK_REPEAT_MIN_MS			20U
+#endif
+
+/** @brief Haltezeit für das Ereignis "langer Druck" in ms */
+#ifndef JOYSTICK_LONG_PRESS_MS
+#define JOYSTICK_LONG_PRESS_MS			1000U
+#endif
+
+/** @brief Größe der Ereigniswarteschlange (Zweierpotenz) */
+#define JOYSTICK_QUEUE_SIZE				16U
+
+/** @brief NVIC-Priorität von Abtast-Timer und EXTI-Wecken */
+#define JOYSTICK_IRQ_PRIORITY			IRQ_CLASS_REFRESH
+
+/**
+ * @brief Richtungen des Joysticks im Ereignisbetrieb
+ *
+ * Der Zustand aller Richtungen ist eine Bitmaske (1 << joystick_key_t).
+ */
+typedef enum {
+	JOYSTICK_KEY_UP = 0,
+	JOYSTICK_KEY_DOWN,
+	JOYSTICK_KEY_LEFT,
+	JOYSTICK_KEY_RIGHT,
+	JOYSTICK_KEY_PRESS,
+	JOYSTICK_KEY_COUNT
+} joystick_key_t;
+
+/**
+ * @brief Ereignisarten
+ */
+typedef enum {
+	JOYSTICK_EVENT_PRESS = 0,		// entprellt gedrückt
+	JOYSTICK_EVENT_RELEASE,			// entprellt losgelassen
+	JOYSTICK_EVENT_REPEAT,			// gehalten, ab JOYSTICK_REPEAT_DELAY_MS, beschleunigt von JOYSTICK_REPEAT_MS bis JOYSTICK_REPEAT_MIN_MS
+	JOYSTICK_EVENT_LONG				// einmal nach JOYSTICK_LONG_PRESS_MS gehalten
+} joystick_event_type_t;
+
+/**
+ * @brief Ein Eintrag der Ereigniswarteschlange
+ */
+typedef struct {
+	joystick_key_t key;
+	joystick_event_type_t type;
+	uint16_t repeat;				// Nummer des Wiederholereignisses (1, 2, ...), sonst 0
+	uint32_t time_ms;				// HAL-Tick beim Ereignis
+} joystick_event_t;
+
+
 /**
  * @brief Initialisiert alle GPIO-Pins für den Joystick.
  *
@@ -105,4 +196,46 @@ GPIO_PinState readLEFT(void);
  */
 GPIO_PinState readPRESS(void);
 
+/**
+ * @brief Startet den Ereignisbetrieb: Entprellung im Hintergrund und
+ *        Ereigniswarteschlange.
+ *
+ * Die fünf Leitungen lösen im Ruhezustand einen EXTI-Interrupt bei jeder
+ * Flanke aus. Die erste Flanke sperrt die EXTI-Leitungen und startet den
+ * Abtast-Timer; jede Abtastung liest alle Leitungen mit einem Zugriff auf
+ * GPIOG->IDR und führt je Leitung einen Integrator (0 .. JOYSTICK_DEBOUNCE_SAMPLES).
+ * Sind alle Richtungen losgelassen und alle Integratoren bei 0, hält der
+ * Timer an und die EXTI-Leitungen werden wieder freigegeben. Ohne Eingabe
+ * läuft also kein Interrupt, die Anwendung kann mit __WFI() schlafen.
+ *
+ * Ersetzt initJoyStick(); readUP() usw. lesen weiterhin den Pin direkt.
+ *
+ * @retval HAL_OK    Ereignisbetrieb läuft
+ * @retval HAL_ERROR Eine der EXTI-Leitungen 6, 9..12 ist schon belegt
+ */
+HAL_StatusTypeDef joystick_init_events(void);
+
+/**
+ * @brief Holt das älteste Ereignis aus der Warteschlange.
+ *
+ * @param event Ziel für das Ereignis
+ * @retval 1 Ein Ereignis wurde gelesen
+ * @retval 0 Die Warteschlange ist leer
+ */
+uint8_t joystick_get_event(joystick_event_t *event);
+
+/**
+ * @brief Liefert den entprellten Zustand aller Richtungen.
+ *
+ * @return Bitmaske, Bit joystick_key_t gesetzt = gedrückt
+ */
+uint8_t joystick_get_keys(void);
+
+/**
+ * @brief Liefert die Anzahl der verworfenen Ereignisse (volle Warteschlange).
+ *
+ * @return Verworfene Ereignisse seit joystick_init_events()
+ */
+uint32_t joystick_get_dropped(void);
+
 #endif /* JOYSTICK_JOYSTICK_H_ */
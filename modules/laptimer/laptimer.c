@@ -0,0 +1,412 @@
+/**
+ ******************************************************************************
+ * @file        laptimer.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Multi-lane hardware lap timer: TIM5 input captures, circular
+ *              DMA per lane, evaluation and ranking in the main loop.
+ *
+ * Functionality:
+ * - Channel setup through the HAL, capture and DMA request enabled on
+ *   register level; no timer or DMA interrupt
+ * - Upper 32 bits of the time counted by laptimer_poll() from the wraps
+ *   of CNT; a capture lies less than one wrap before the read of CNT
+ * - Per lane: capture ring (DMA), read index, lap ring and statistics,
+ *   written only by laptimer_poll()
+ * - Ranking: lane numbers in race order, a lane with a new lap bubbles
+ *   up past the lanes it now leads
+ *
+ * Resources:
+ * - TIM5 CH1..CH4 (tim_alloc), DMA1 S2 / S4 / S0 / S1 channel 6
+ *   (dma_alloc)
+ ******************************************************************************
+ */
+
+#include "laptimer.h"
+#include "dma_alloc/dma_alloc.h"
+#include "tim_alloc/tim_alloc.h"
+#include "utils/utils.h"
+
+/* Private Type Definitions ------------------------------------------------- */
+/**
+ * @brief One lane.
+ */
+typedef struct {
+    laptimer_lane_config_t config;
+    DMA_HandleTypeDef      dma;
+    uint32_t               u32_ring[LAPTIMER_CAPTURE_RING];
+    uint32_t               u32_read;        /**< Next capture of the ring  */
+    uint32_t               u32_holdoff;     /**< Hold-off in ticks         */
+    uint64_t               u64_start;       /**< Start of the lane         */
+    uint64_t               u64_last_edge;   /**< Last accepted edge        */
+    laptimer_lane_stats_t  stats;
+    laptimer_lap_t         laps[LAPTIMER_LAP_RING];
+} laptimer_lane_t;
+
+/* Static module variables -------------------------------------------------- */
+static TIM_HandleTypeDef g_laptimer_handle;
+static laptimer_lane_t g_laptimer_lanes[LAPTIMER_MAX_LANES];
+static uint8_t g_u8_laptimer_count = 0u;
+static uint8_t g_u8_laptimer_channels = 0u;     /* Bit per channel index */
+static uint32_t g_u32_laptimer_tick_hz = 0u;
+static uint32_t g_u32_laptimer_target = 0u;
+
+/**
+ * @brief Lane numbers, leader first.
+ */
+static uint8_t g_u8_laptimer_rank[LAPTIMER_MAX_LANES];
+
+/**
+ * @brief Upper 32 bits of the time and the CNT of the last read.
+ */
+static uint32_t g_u32_laptimer_high = 0u;
+static uint32_t g_u32_laptimer_last = 0u;
+
+/**
+ * @brief DMA request per channel index (TIM_CHANNEL_x / 4).
+ */
+static const dma_alloc_request_t g_laptimer_requests[LAPTIMER_MAX_LANES] = {
+    DMA_ALLOC_REQ_TIM5_CH1, DMA_ALLOC_REQ_TIM5_CH2, DMA_ALLOC_REQ_TIM5_CH3, DMA_ALLOC_REQ_TIM5_CH4
+};
+
+/* Static function prototypes ----------------------------------------------- */
+static uint64_t laptimer_now(void);
+static uint32_t laptimer_write_index(const laptimer_lane_t *lane);
+static uint8_t laptimer_edge(uint8_t u8_lane, uint64_t u64_edge);
+static void laptimer_rank(uint8_t u8_lane);
+
+/* Public functions --------------------------------------------------------- */
+HAL_StatusTypeDef laptimer_init(void)
+{
+    uint32_t u32_clock;
+    uint32_t u32_divider;
+
+    if (tim_alloc_claim(TIM5, TIM_ALLOC_OWNER_LAPTIMER) != HAL_OK) {
+        return HAL_BUSY;
+    }
+
+    u32_clock   = tim_alloc_get_clock(TIM5);
+    u32_divider = (u32_clock + LAPTIMER_COUNTER_HZ / 2u) / LAPTIMER_COUNTER_HZ;
+    if (u32_divider == 0u) {
+        u32_divider = 1u;
+    }
+
+    g_laptimer_handle.Instance               = TIM5;
+    g_laptimer_handle.Init.Prescaler         = u32_divider - 1u;
+    g_laptimer_handle.Init.Period            = 0xFFFFFFFFu;
+    g_laptimer_handle.Init.CounterMode       = TIM_COUNTERMODE_UP;
+    g_laptimer_handle.Init.ClockDivision     = TIM_CLOCKDIVISION_DIV1;
+    g_laptimer_handle.Init.RepetitionCounter = 0u;
+    g_laptimer_handle.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+    if (HAL_TIM_IC_Init(&g_laptimer_handle) != HAL_OK) {
+        tim_alloc_release(TIM5, TIM_ALLOC_OWNER_LAPTIMER);
+        return HAL_ERROR;
+    }
+
+    g_u32_laptimer_tick_hz = u32_clock / u32_divider;
+    g_u8_laptimer_count    = 0u;
+    g_u8_laptimer_channels = 0u;
+    g_u32_laptimer_high    = 0u;
+    g_u32_laptimer_last    = 0u;
+    __HAL_TIM_ENABLE(&g_laptimer_handle);
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef laptimer_add_lane(const laptimer_lane_config_t *config, uint8_t *pu8_lane)
+{
+    GPIO_InitTypeDef gpio_init_struct;
+    TIM_IC_InitTypeDef tim_ic_init_struct;
+    laptimer_lane_t *lane;
+    uint32_t u32_index = config->u32_channel / 4u;
+
+    *pu8_lane = LAPTIMER_NO_LANE;
+
+    if ((g_u32_laptimer_tick_hz == 0u) || (config->u32_channel > TIM_CHANNEL_4) ||
+        ((config->u32_channel & 3u) != 0u) || (config->u32_filter > 15u) || (config->port == NULL)) {
+        return HAL_ERROR;
+    }
+    if ((g_u8_laptimer_channels & (1u << u32_index)) != 0u) {
+        return HAL_BUSY;
+    }
+
+    lane = &g_laptimer_lanes[g_u8_laptimer_count];
+    if (dma_alloc_claim(&lane->dma, g_laptimer_requests[u32_index], DMA_ALLOC_LATENCY_SAMPLED,
+                        HEALTH_ISR_COUNT) != HAL_OK) {
+        return HAL_BUSY;
+    }
+
+    lane->config      = *config;
+    lane->u32_holdoff = (uint32_t)(((uint64_t)config->u32_holdoff_us * g_u32_laptimer_tick_hz) / 1000000u);
+
+    utils_gpio_clock_enable(config->port);
+    gpio_init_struct.Pin       = config->pin;
+    gpio_init_struct.Mode      = GPIO_MODE_AF_PP;
+    gpio_init_struct.Pull      = config->u32_pull;
+    gpio_init_struct.Speed     = GPIO_SPEED_FREQ_MEDIUM;
+    gpio_init_struct.Alternate = GPIO_AF2_TIM5;
+    HAL_GPIO_Init(config->port, &gpio_init_struct);
+
+    lane->dma.Init.Direction           = DMA_PERIPH_TO_MEMORY;
+    lane->dma.Init.PeriphInc           = DMA_PINC_DISABLE;
+    lane->dma.Init.MemInc              = DMA_MINC_ENABLE;
+    lane->dma.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+    lane->dma.Init.MemDataAlignment    = DMA_MDATAALIGN_WORD;
+    lane->dma.Init.Mode                = DMA_CIRCULAR;
+    lane->dma.Init.FIFOMode            = DMA_FIFOMODE_DISABLE;
+    if ((HAL_DMA_Init(&lane->dma) != HAL_OK) ||
+        (HAL_DMA_Start(&lane->dma, (uint32_t)(uintptr_t)(&TIM5->CCR1 + u32_index),
+                       (uint32_t)(uintptr_t)lane->u32_ring, LAPTIMER_CAPTURE_RING) != HAL_OK)) {
+        dma_alloc_release(&lane->dma);
+        return HAL_ERROR;
+    }
+
+    tim_ic_init_struct.ICPolarity  = config->u32_polarity;
+    tim_ic_init_struct.ICSelection = TIM_ICSELECTION_DIRECTTI;
+    tim_ic_init_struct.ICPrescaler = TIM_ICPSC_DIV1;
+    tim_ic_init_struct.ICFilter    = config->u32_filter;
+    HAL_TIM_IC_ConfigChannel(&g_laptimer_handle, &tim_ic_init_struct, config->u32_channel);
+
+    /* CCRx of the channel into the ring, no capture interrupt */
+    TIM5->DIER |= TIM_DIER_CC1DE << u32_index;
+    TIM5->CCER |= TIM_CCER_CC1E << config->u32_channel;
+
+    g_u8_laptimer_channels |= (uint8_t)(1u << u32_index);
+    *pu8_lane = g_u8_laptimer_count++;
+    laptimer_arm(g_u32_laptimer_target);
+
+    return HAL_OK;
+}
+
+void laptimer_arm(uint32_t u32_target_laps)
+{
+    g_u32_laptimer_target = u32_target_laps;
+
+    for (uint8_t i = 0u; i < g_u8_laptimer_count; i++) {
+        laptimer_lane_t *lane = &g_laptimer_lanes[i];
+
+        lane->u32_read      = laptimer_write_index(lane);
+        lane->u64_start     = 0u;
+        lane->u64_last_edge = 0u;
+        lane->stats         = (laptimer_lane_stats_t){0};
+        lane->stats.u8_rank = i;
+        g_u8_laptimer_rank[i] = i;
+    }
+}
+
+void laptimer_start_all(void)
+{
+    uint64_t u64_now = laptimer_now();
+
+    for (uint8_t i = 0u; i < g_u8_laptimer_count; i++) {
+        laptimer_lane_t *lane = &g_laptimer_lanes[i];
+
+        if (!lane->stats.u8_started) {
+            lane->u64_start        = u64_now;
+            lane->u64_last_edge    = u64_now;
+            lane->stats.u8_started = 1u;
+        }
+    }
+}
+
+uint16_t laptimer_poll(void)
+{
+    uint64_t u64_now = laptimer_now();
+    uint16_t u16_laps = 0u;
+
+    for (uint8_t i = 0u; i < g_u8_laptimer_count; i++) {
+        laptimer_lane_t *lane = &g_laptimer_lanes[i];
+        uint32_t u32_write = laptimer_write_index(lane);
+
+        while (lane->u32_read != u32_write) {
+            uint64_t u64_edge = (u64_now & 0xFFFFFFFF00000000ULL) | lane->u32_ring[lane->u32_read];
+
+            lane->u32_read = (lane->u32_read + 1u) & (LAPTIMER_CAPTURE_RING - 1u);
+
+            /* Extend to 64 bit: the edge lies less than one wrap before now */
+            if (u64_edge > u64_now) {
+                u64_edge -= 0x100000000ULL;
+            }
+            u16_laps += laptimer_edge(i, u64_edge);
+        }
+    }
+
+    return u16_laps;
+}
+
+HAL_StatusTypeDef laptimer_get_lane(uint8_t u8_lane, laptimer_lane_stats_t *stats)
+{
+    if (u8_lane >= g_u8_laptimer_count) {
+        return HAL_ERROR;
+    }
+
+    *stats = g_laptimer_lanes[u8_lane].stats;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef laptimer_get_lap(uint8_t u8_lane, uint32_t u32_lap, laptimer_lap_t *lap)
+{
+    const laptimer_lane_t *lane;
+
+    if (u8_lane >= g_u8_laptimer_count) {
+        return HAL_ERROR;
+    }
+
+    lane = &g_laptimer_lanes[u8_lane];
+    if ((u32_lap >= lane->stats.u32_laps) || ((lane->stats.u32_laps - u32_lap) > LAPTIMER_LAP_RING)) {
+        return HAL_ERROR;
+    }
+
+    *lap = lane->laps[u32_lap & (LAPTIMER_LAP_RING - 1u)];
+
+    return HAL_OK;
+}
+
+uint8_t laptimer_get_ranking(uint8_t *pu8_lanes, uint8_t u8_max)
+{
+    uint8_t u8_count = (u8_max < g_u8_laptimer_count) ? u8_max : g_u8_laptimer_count;
+
+    for (uint8_t i = 0u; i < u8_count; i++) {
+        pu8_lanes[i] = g_u8_laptimer_rank[i];
+    }
+
+    return u8_count;
+}
+
+uint32_t laptimer_get_tick_hz(void)
+{
+    return g_u32_laptimer_tick_hz;
+}
+
+uint64_t laptimer_ticks_to_ns(uint64_t u64_ticks)
+{
+    uint64_t u64_hz = g_u32_laptimer_tick_hz;
+
+    if (u64_hz == 0u) {
+        return 0u;
+    }
+
+    /* Whole seconds first, the product would overflow after ~30 min */
+    return (u64_ticks / u64_hz) * 1000000000ULL + ((u64_ticks % u64_hz) * 1000000000ULL) / u64_hz;
+}
+
+/* Static functions --------------------------------------------------------- */
+/**
+ * @brief Reads the 64 bit time; counts the wrap of CNT since the last
+ *        read (at least one read per wrap).
+ *
+ * @return Ticks since laptimer_init()
+ */
+static uint64_t laptimer_now(void)
+{
+    uint32_t u32_count = TIM5->CNT;
+
+    if (u32_count < g_u32_laptimer_last) {
+        g_u32_laptimer_high++;
+    }
+    g_u32_laptimer_last = u32_count;
+
+    return ((uint64_t)g_u32_laptimer_high << 32) | u32_count;
+}
+
+/**
+ * @brief Position of the DMA in the capture ring of a lane.
+ *
+ * @param lane Lane
+ * @return Index of the next capture to be written
+ */
+static uint32_t laptimer_write_index(const laptimer_lane_t *lane)
+{
+    return (LAPTIMER_CAPTURE_RING - __HAL_DMA_GET_COUNTER(&lane->dma)) & (LAPTIMER_CAPTURE_RING - 1u);
+}
+
+/**
+ * @brief Evaluates one captured edge of a lane.
+ *
+ * @param u8_lane  Lane
+ * @param u64_edge Time of the edge
+ * @return 1 if the edge ended a lap, else 0
+ */
+static uint8_t laptimer_edge(uint8_t u8_lane, uint64_t u64_edge)
+{
+    laptimer_lane_t *lane = &g_laptimer_lanes[u8_lane];
+    laptimer_lane_stats_t *stats = &lane->stats;
+    laptimer_lap_t *lap;
+    uint64_t u64_delta;
+
+    if (stats->u8_finished) {
+        return 0u;
+    }
+
+    if (stats->u8_started) {
+        /* Before a common start, or chatter of the last edge */
+        if (u64_edge < lane->u64_last_edge) {
+            return 0u;
+        }
+        if ((u64_edge - lane->u64_last_edge) < lane->u32_holdoff) {
+            stats->u32_dropped++;
+            return 0u;
+        }
+    }
+
+    lane->u64_last_edge = u64_edge;
+
+    if (!stats->u8_started) {
+        lane->u64_start     = u64_edge;
+        stats->u8_started   = 1u;
+        return 0u;
+    }
+
+    u64_delta = (u64_edge - lane->u64_start) - stats->u64_split_ticks;
+
+    lap = &lane->laps[stats->u32_laps & (LAPTIMER_LAP_RING - 1u)];
+    lap->u32_lap         = stats->u32_laps;
+    lap->u32_ticks       = (u64_delta > 0xFFFFFFFFULL) ? 0xFFFFFFFFu : (uint32_t)u64_delta;
+    lap->u64_split_ticks = u64_edge - lane->u64_start;
+
+    if ((stats->u32_laps == 0u) || (lap->u32_ticks < stats->u32_best_ticks)) {
+        stats->u32_best_ticks = lap->u32_ticks;
+        stats->u32_best_lap   = stats->u32_laps;
+    }
+    stats->u32_last_ticks  = lap->u32_ticks;
+    stats->u64_split_ticks = lap->u64_split_ticks;
+    stats->u32_laps++;
+    if ((g_u32_laptimer_target != 0u) && (stats->u32_laps >= g_u32_laptimer_target)) {
+        stats->u8_finished = 1u;
+    }
+
+    laptimer_rank(u8_lane);
+
+    return 1u;
+}
+
+/**
+ * @brief Moves a lane that just completed a lap up the ranking.
+ *
+ * @param u8_lane Lane
+ */
+static void laptimer_rank(uint8_t u8_lane)
+{
+    const laptimer_lane_stats_t *stats = &g_laptimer_lanes[u8_lane].stats;
+    uint8_t u8_position = stats->u8_rank;
+
+    while (u8_position > 0u) {
+        uint8_t u8_other = g_u8_laptimer_rank[u8_position - 1u];
+        laptimer_lane_stats_t *other = &g_laptimer_lanes[u8_other].stats;
+
+        /* More laps, or the same laps completed earlier */
+        if ((stats->u32_laps < other->u32_laps) ||
+            ((stats->u32_laps == other->u32_laps) && (stats->u64_split_ticks >= other->u64_split_ticks))) {
+            break;
+        }
+
+        g_u8_laptimer_rank[u8_position] = u8_other;
+        other->u8_rank = u8_position;
+        u8_position--;
+    }
+
+    g_u8_laptimer_rank[u8_position] = u8_lane;
+    g_laptimer_lanes[u8_lane].stats.u8_rank = u8_position;
+}
@@ -0,0 +1,213 @@
+/**
+ ******************************************************************************
+ * @file        laptimer.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the multi-lane hardware lap timer.
+ *
+ * @details
+ * Up to four lanes, each one input capture channel of TIM5 (32 bit,
+ * CH1..CH4 on PA0..PA3 or PH10..PH12 / PI0, AF2). The timer counts at
+ * LAPTIMER_COUNTER_HZ (100 ns at 10 MHz) and latches the counter at the
+ * edge of a lane; a circular DMA per lane moves the values into the
+ * capture ring of the lane. Lanes captured in the same tick get the same
+ * value, there is no interrupt at all - neither per edge nor per ring.
+ *
+ * laptimer_poll() extends the captures to 64 bit and evaluates them:
+ * edges within the hold-off of a lane (photo gate chatter, a second
+ * axle) are dropped, the first edge after laptimer_arm() starts the lane
+ * (or laptimer_start_all() starts every lane at one instant), each
+ * further one is a lap. Per lane the lap time, the split since the start
+ * and the best lap are updated with each lap, the last LAPTIMER_LAP_RING
+ * laps are kept in the lap ring of the lane.
+ *
+ * The ranking is kept incrementally: more laps first, at equal laps the
+ * earlier split. A new lap can only move its lane up, so one lap costs
+ * at most three compares and swaps.
+ *
+ * laptimer_poll() must run at least once per LAPTIMER_CAPTURE_RING edges
+ * of a lane and once per counter wrap (2^32 ticks, 7 min at 10 MHz).
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - 4 lanes on one 32 bit timer, simultaneous capture, input filter and
+ *    polarity per lane
+ *  - Resolution 1 / LAPTIMER_COUNTER_HZ, up to the APB1 timer clock
+ *  - Lap ring, best lap, split and target laps (finished) per lane,
+ *    incremental ranking
+ *  - TIM5 is claimed through tim_alloc: the stopwatch (TIM5) and the lap
+ *    timer exclude each other
+ *
+ ******************************************************************************
+ */
+
+#ifndef LAPTIMER_LAPTIMER_H_
+#define LAPTIMER_LAPTIMER_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief Counter clock of TIM5 in Hz (rounded to a divider of the APB1
+ *        timer clock, see laptimer_get_tick_hz()).
+ */
+#ifndef LAPTIMER_COUNTER_HZ
+#define LAPTIMER_COUNTER_HZ     10000000U
+#endif
+
+/**
+ * @brief Lanes (TIM5 CH1..CH4).
+ */
+#define LAPTIMER_MAX_LANES      4U
+
+/**
+ * @brief Raw captures per lane between two laptimer_poll() calls (power
+ *        of two).
+ */
+#ifndef LAPTIMER_CAPTURE_RING
+#define LAPTIMER_CAPTURE_RING   16U
+#endif
+
+/**
+ * @brief Laps kept per lane (power of two).
+ */
+#ifndef LAPTIMER_LAP_RING
+#define LAPTIMER_LAP_RING       32U
+#endif
+
+#if ((LAPTIMER_CAPTURE_RING & (LAPTIMER_CAPTURE_RING - 1U)) != 0U) || \
+    ((LAPTIMER_LAP_RING & (LAPTIMER_LAP_RING - 1U)) != 0U)
+#error "LAPTIMER_CAPTURE_RING and LAPTIMER_LAP_RING must be powers of two"
+#endif
+
+/**
+ * @brief No lane (laptimer_add_lane() failed).
+ */
+#define LAPTIMER_NO_LANE        0xFFU
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Wiring and capture setup of one lane.
+ */
+typedef struct {
+    GPIO_TypeDef *port;             /**< Port of the TIM5 channel pin      */
+    uint16_t      pin;              /**< Pin (GPIO_PIN_x), AF2             */
+    uint32_t      u32_pull;         /**< GPIO_NOPULL, GPIO_PULLUP, ...     */
+    uint32_t      u32_channel;      /**< TIM_CHANNEL_1 .. TIM_CHANNEL_4    */
+    uint32_t      u32_polarity;     /**< TIM_ICPOLARITY_RISING / _FALLING  */
+    uint32_t      u32_filter;       /**< Input filter 0..15                */
+    uint32_t      u32_holdoff_us;   /**< Edges this close to the last one are dropped */
+} laptimer_lane_config_t;
+
+/**
+ * @brief One lap.
+ */
+typedef struct {
+    uint32_t u32_lap;               /**< Lap number (0 = first lap)        */
+    uint32_t u32_ticks;             /**< Lap time, saturated               */
+    uint64_t u64_split_ticks;       /**< Start to the end of the lap       */
+} laptimer_lap_t;
+
+/**
+ * @brief State of one lane.
+ */
+typedef struct {
+    uint32_t u32_laps;              /**< Completed laps                    */
+    uint32_t u32_last_ticks;        /**< Last lap                          */
+    uint32_t u32_best_ticks;        /**< Best lap                          */
+    uint32_t u32_best_lap;          /**< Number of the best lap            */
+    uint64_t u64_split_ticks;       /**< Start to the end of the last lap  */
+    uint32_t u32_dropped;           /**< Edges within the hold-off         */
+    uint8_t  u8_started;
+    uint8_t  u8_finished;           /**< Target laps completed             */
+    uint8_t  u8_rank;               /**< Position, 0 = leader              */
+} laptimer_lane_stats_t;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Claims TIM5 and starts its counter, no lane yet.
+ *
+ * @return HAL_OK, HAL_BUSY if TIM5 is taken (stopwatch)
+ */
+HAL_StatusTypeDef laptimer_init(void);
+
+/**
+ * @brief Starts the capture of a lane.
+ *
+ * @param config   Wiring and capture setup, copied
+ * @param pu8_lane Lane number (0..3, in the order of the calls)
+ * @return HAL_OK, HAL_BUSY if the channel or its DMA stream is taken,
+ *         HAL_ERROR for an invalid setup or before laptimer_init()
+ */
+HAL_StatusTypeDef laptimer_add_lane(const laptimer_lane_config_t *config, uint8_t *pu8_lane);
+
+/**
+ * @brief Resets all lanes for a new race; edges captured before are
+ *        discarded. Main loop.
+ *
+ * @param u32_target_laps Laps until a lane is finished, 0 = endless
+ * @return None
+ */
+void laptimer_arm(uint32_t u32_target_laps);
+
+/**
+ * @brief Starts every armed lane now (common start), their first edge
+ *        ends the first lap. Main loop.
+ *
+ * @return None
+ */
+void laptimer_start_all(void);
+
+/**
+ * @brief Evaluates the captures of all lanes. Main loop.
+ *
+ * @return Laps added
+ */
+uint16_t laptimer_poll(void);
+
+/**
+ * @brief Copies the state of a lane.
+ *
+ * @param u8_lane Lane
+ * @param stats   Destination
+ * @return HAL_OK, HAL_ERROR for an unknown lane
+ */
+HAL_StatusTypeDef laptimer_get_lane(uint8_t u8_lane, laptimer_lane_stats_t *stats);
+
+/**
+ * @brief Copies one lap from the lap ring of a lane.
+ *
+ * @param u8_lane Lane
+ * @param u32_lap Lap number, one of the last LAPTIMER_LAP_RING
+ * @param lap     Destination
+ * @return HAL_OK, HAL_ERROR for an unknown lane or a lap not in the ring
+ */
+HAL_StatusTypeDef laptimer_get_lap(uint8_t u8_lane, uint32_t u32_lap, laptimer_lap_t *lap);
+
+/**
+ * @brief Copies the ranking.
+ *
+ * @param pu8_lanes Lanes, leader first
+ * @param u8_max    Entries of pu8_lanes
+ * @return Entries written
+ */
+uint8_t laptimer_get_ranking(uint8_t *pu8_lanes, uint8_t u8_max);
+
+/**
+ * @brief Returns the actual counter clock.
+ *
+ * @return Ticks per second, 0 before laptimer_init()
+ */
+uint32_t laptimer_get_tick_hz(void);
+
+/**
+ * @brief Converts ticks into nanoseconds.
+ *
+ * @param u64_ticks Ticks (lap time or split)
+ * @return Nanoseconds
+ */
+uint64_t laptimer_ticks_to_ns(uint64_t u64_ticks);
+
+#endif /* LAPTIMER_LAPTIMER_H_ */
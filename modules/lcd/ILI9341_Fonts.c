@@ -0,0 +1,609 @@
+//GENERATED BY font_convert.py, DO NOT EDIT
+//  font_convert.py 5x5_font.h:1:Font_Small 5x5_font.h:2:Font_Medium 5x5_font.h:3:Font_Large
+
+#include <lcd/ILI9341_Fonts.h>
+
+/* Font_Small: 5x5_font.h, 8 pixels high, 760 bitmap bytes */
+static const uint8_t Font_Small_Bitmap[760] = {
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,	//' '
+	0x00,0x00,0x80,0x80,0x80,0x00,0x80,0x00,	//'!'
+	0x00,0xA0,0xA0,0x00,0x00,0x00,0x00,0x00,	//'"'
+	0x00,0x00,0x50,0xF8,0x50,0xF8,0x50,0x00,	//'#'
+	0x00,0x20,0xF8,0xA0,0xF8,0x28,0xF8,0x20,	//'$'
+	0x00,0x00,0x88,0x10,0x20,0x40,0x88,0x00,	//'%'
+	0x00,0x00,0x60,0x80,0x68,0x90,0x68,0x00,	//'&'
+	0x00,0x80,0x80,0x00,0x00,0x00,0x00,0x00,	//'\''
+	0x00,0x00,0x40,0x80,0x80,0x80,0x40,0x00,	//'('
+	0x00,0x00,0x80,0x40,0x40,0x40,0x80,0x00,	//')'
+	0x40,0xE0,0x40,0x00,0x00,0x00,0x00,0x00,	//'*'
+	0x00,0x00,0x20,0x20,0xF8,0x20,0x20,0x00,	//'+'
+	0x00,0x00,0x00,0x00,0x00,0x00,0x80,0x80,	//','
+	0x00,0x00,0x00,0x00,0xF8,0x00,0x00,0x00,	//'-'
+	0x00,0x00,0x00,0x00,0x00,0x00,0x80,0x00,	//'.'
+	0x00,0x00,0x20,0x20,0x40,0x80,0x80,0x00,	//'/'
+	0x00,0x00,0xF8,0x98,0xA8,0xC8,0xF8,0x00,	//'0'
+	0x00,0x00,0x20,0x60,0x20,0x20,0x70,0x00,	//'1'
+	0x00,0x00,0xF0,0x08,0x70,0x80,0xF8,0x00,	//'2'
+	0x00,0x00,0xF8,0x08,0x70,0x08,0xF8,0x00,	//'3'
+	0x00,0x00,0x80,0x80,0xA0,0xF8,0x20,0x00,	//'4'
+	0x00,0x00,0xF8,0x80,0xF0,0x08,0xF0,0x00,	//'5'
+	0x00,0x00,0xF8,0x80,0xF8,0x88,0xF8,0x00,	//'6'
+	0x00,0x00,0xF8,0x08,0x10,0x20,0x20,0x00,	//'7'
+	0x00,0x00,0xF8,0x88,0xF8,0x88,0xF8,0x00,	//'8'
+	0x00,0x00,0xF8,0x88,0xF8,0x08,0xF8,0x00,	//'9'
+	0x00,0x00,0x80,0x00,0x00,0x00,0x80,0x00,	//':'
+	0x00,0x00,0x80,0x00,0x00,0x00,0x80,0x80,	//';'
+	0x00,0x00,0x20,0x40,0x80,0x40,0x20,0x00,	//'<'
+	0x00,0x00,0x00,0xF8,0x00,0xF8,0x00,0x00,	//'='
+	0x00,0x00,0x80,0x40,0x20,0x40,0x80,0x00,	//'>'
+	0x00,0x00,0x60,0x90,0x20,0x00,0x20,0x00,	//'?'
+	0x00,0x00,0xF8,0x88,0xB8,0x80,0xF8,0x00,	//'@'
+	0x00,0x00,0xF8,0x88,0x88,0xF8,0x88,0x00,	//'A'
+	0x00,0x00,0xF8,0x88,0xF0,0x88,0xF8,0x00,	//'B'
+	0x00,0x00,0xF8,0x80,0x80,0x80,0xF8,0x00,	//'C'
+	0x00,0x00,0xF0,0x88,0x88,0x88,0xF0,0x00,	//'D'
+	0x00,0x00,0xF8,0x80,0xF0,0x80,0xF8,0x00,	//'E'
+	0x00,0x00,0xF8,0x80,0xF0,0x80,0x80,0x00,	//'F'
+	0x00,0x00,0xF8,0x80,0x98,0x88,0xF8,0x00,	//'G'
+	0x00,0x00,0x88,0x88,0xF8,0x88,0x88,0x00,	//'H'
+	0x00,0x00,0xF8,0x20,0x20,0x20,0xF8,0x00,	//'I'
+	0x00,0x00,0x18,0x08,0x08,0x88,0xF8,0x00,	//'J'
+	0x00,0x00,0x88,0x90,0xE0,0x90,0x88,0x00,	//'K'
+	0x00,0x00,0x80,0x80,0x80,0x80,0xF8,0x00,	//'L'
+	0x00,0x00,0x88,0xD8,0xA8,0x88,0x88,0x00,	//'M'
+	0x00,0x00,0x88,0xC8,0xA8,0x98,0x88,0x00,	//'N'
+	0x00,0x00,0x70,0x88,0x88,0x88,0x70,0x00,	//'O'
+	0x00,0x00,0xF0,0x88,0xF0,0x80,0x80,0x00,	//'P'
+	0x00,0x00,0xF8,0x88,0x88,0xF8,0x20,0x00,	//'Q'
+	0x00,0x00,0xF0,0x88,0xF0,0x88,0x88,0x00,	//'R'
+	0x00,0x00,0xF8,0x80,0xF8,0x08,0xF8,0x00,	//'S'
+	0x00,0x00,0xF8,0x20,0x20,0x20,0x20,0x00,	//'T'
+	0x00,0x00,0x88,0x88,0x88,0x88,0xF8,0x00,	//'U'
+	0x00,0x00,0x88,0x88,0x50,0x50,0x20,0x00,	//'V'
+	0x00,0x00,0x88,0x88,0xA8,0xA8,0x50,0x00,	//'W'
+	0x00,0x00,0x88,0x50,0x20,0x50,0x88,0x00,	//'X'
+	0x00,0x00,0x88,0x88,0x50,0x20,0x20,0x00,	//'Y'
+	0x00,0x00,0xF8,0x10,0x20,0x40,0xF8,0x00,	//'Z'
+	0x00,0x00,0xC0,0x80,0x80,0x80,0xC0,0x00,	//'['
+	0x00,0x00,0x80,0x80,0x40,0x20,0x20,0x00,	//'\\'
+	0x00,0x00,0xC0,0x40,0x40,0x40,0xC0,0x00,	//']'
+	0xA0,0x00,0x00,0x00,0x00,0x00,0x00,0x00,	//'^'
+	0x00,0x00,0x00,0x00,0x00,0x00,0xFC,0x00,	//'_'
+	0x80,0x00,0x00,0x00,0x00,0x00,0x00,0x00,	//'`'
+	0x00,0x00,0xF8,0x88,0x88,0xF8,0x88,0x00,	//'a'
+	0x00,0x00,0xF8,0x88,0xF0,0x88,0xF8,0x00,	//'b'
+	0x00,0x00,0xF8,0x80,0x80,0x80,0xF8,0x00,	//'c'
+	0x00,0x00,0xF0,0x88,0x88,0x88,0xF0,0x00,	//'d'
+	0x00,0x00,0xF8,0x80,0xF0,0x80,0xF8,0x00,	//'e'
+	0x00,0x00,0xF8,0x80,0xF0,0x80,0x80,0x00,	//'f'
+	0x00,0x00,0xF8,0x80,0x98,0x88,0xF8,0x00,	//'g'
+	0x00,0x00,0x88,0x88,0xF8,0x88,0x88,0x00,	//'h'
+	0x00,0x00,0xF8,0x20,0x20,0x20,0xF8,0x00,	//'i'
+	0x00,0x00,0x18,0x08,0x08,0x88,0xF8,0x00,	//'j'
+	0x00,0x00,0x88,0x90,0xE0,0x90,0x88,0x00,	//'k'
+	0x00,0x00,0x80,0x80,0x80,0x80,0xF8,0x00,	//'l'
+	0x00,0x00,0x88,0xD8,0xA8,0x88,0x88,0x00,	//'m'
+	0x00,0x00,0x88,0xC8,0xA8,0x98,0x88,0x00,	//'n'
+	0x00,0x00,0x70,0x88,0x88,0x88,0x70,0x00,	//'o'
+	0x00,0x00,0xF0,0x88,0xF0,0x80,0x80,0x00,	//'p'
+	0x00,0x00,0xF8,0x88,0x88,0xF8,0x20,0x00,	//'q'
+	0x00,0x00,0xF0,0x88,0xF0,0x88,0x88,0x00,	//'r'
+	0x00,0x00,0xF8,0x80,0xF8,0x08,0xF8,0x00,	//'s'
+	0x00,0x00,0xF8,0x20,0x20,0x20,0x20,0x00,	//'t'
+	0x00,0x00,0x88,0x88,0x88,0x88,0xF8,0x00,	//'u'
+	0x00,0x00,0x88,0x88,0x50,0x50,0x20,0x00,	//'v'
+	0x00,0x00,0x88,0x88,0xA8,0xA8,0x50,0x00,	//'w'
+	0x00,0x00,0x88,0x50,0x20,0x50,0x88,0x00,	//'x'
+	0x00,0x00,0x88,0x88,0x50,0x20,0x20,0x00,	//'y'
+	0x00,0x00,0xF8,0x10,0x20,0x40,0xF8,0x00,	//'z'
+	0x00,0x00,0x60,0x40,0xC0,0x40,0x60,0x00,	//'{'
+	0x00,0x00,0x80,0x80,0x00,0x80,0x80,0x00,	//'|'
+	0x00,0x00,0xC0,0x40,0x60,0x40,0xC0,0x00,	//'}'
+	0x50,0xA0,0x00,0x00,0x00,0x00,0x00,0x00,	//'~'
+};
+
+static const ILI9341_Glyph_t Font_Small_Glyphs[95] = {
+	{0,3}, {8,1}, {16,3}, {24,5}, {32,5}, {40,5}, {48,5}, {56,1},
+	{64,2}, {72,2}, {80,3}, {88,5}, {96,1}, {104,5}, {112,1}, {120,3},
+	{128,5}, {136,5}, {144,5}, {152,5}, {160,5}, {168,5}, {176,5}, {184,5},
+	{192,5}, {200,5}, {208,1}, {216,1}, {224,3}, {232,5}, {240,3}, {248,4},
+	{256,5}, {264,5}, {272,5}, {280,5}, {288,5}, {296,5}, {304,5}, {312,5},
+	{320,5}, {328,5}, {336,5}, {344,5}, {352,5}, {360,5}, {368,5}, {376,5},
+	{384,5}, {392,5}, {400,5}, {408,5}, {416,5}, {424,5}, {432,5}, {440,5},
+	{448,5}, {456,5}, {464,5}, {472,2}, {480,3}, {488,2}, {496,3}, {504,6},
+	{512,1}, {520,5}, {528,5}, {536,5}, {544,5}, {552,5}, {560,5}, {568,5},
+	{576,5}, {584,5}, {592,5}, {600,5}, {608,5}, {616,5}, {624,5}, {632,5},
+	{640,5}, {648,5}, {656,5}, {664,5}, {672,5}, {680,5}, {688,5}, {696,5},
+	{704,5}, {712,5}, {720,5}, {728,3}, {736,1}, {744,3}, {752,4},
+};
+
+const ILI9341_Font_t Font_Small = {
+	8, 32, 126, 1, Font_Small_Glyphs, Font_Small_Bitmap
+};
+
+/* Font_Medium: 5x5_font.h, 16 pixels high, 2656 bitmap bytes */
+static const uint8_t Font_Medium_Bitmap[2656] = {
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,	//' '
+	0x00,0x00,0x00,0x00,0xC0,0xC0,0xC0,0xC0,0xC0,0xC0,0x00,0x00,0xC0,0xC0,0x00,0x00,	//'!'
+	0x00,0x00,0xCC,0xCC,0xCC,0xCC,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,	//'"'
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x33,0x00,0x73,0x80,0xFF,0xC0,0xFF,0xC0,	//'#'
+	0x33,0x00,0x33,0x00,0xFF,0xC0,0xFF,0xC0,0x73,0x80,0x33,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x0C,0x00,0x1E,0x00,0x7F,0xC0,0xFF,0xC0,0xCC,0x00,0xCC,0x00,	//'$'
+	0xFF,0x80,0x7F,0xC0,0x0C,0xC0,0x0C,0xC0,0xFF,0xC0,0xFF,0x80,0x1E,0x00,0x0C,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xC0,0xC0,0xC1,0xC0,0x03,0x80,0x07,0x00,	//'%'
+	0x0E,0x00,0x1C,0x00,0x38,0x00,0x70,0x00,0xE0,0xC0,0xC0,0xC0,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x3C,0x00,0x7C,0x00,0xC0,0x00,0xC0,0x00,	//'&'
+	0x3C,0xC0,0x3C,0xC0,0xC3,0x00,0xC3,0x00,0x7C,0xC0,0x3C,0xC0,0x00,0x00,0x00,0x00,
+	0x00,0x00,0xC0,0xC0,0xC0,0xC0,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,	//'\''
+	0x00,0x00,0x00,0x00,0x30,0x70,0xE0,0xC0,0xC0,0xC0,0xC0,0xE0,0x70,0x30,0x00,0x00,	//'('
+	0x00,0x00,0x00,0x00,0xC0,0xE0,0x70,0x30,0x30,0x30,0x30,0x70,0xE0,0xC0,0x00,0x00,	//')'
+	0x30,0x78,0xFC,0xFC,0x78,0x30,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,	//'*'
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x0C,0x00,0x0C,0x00,0x0C,0x00,0x1E,0x00,	//'+'
+	0xFF,0xC0,0xFF,0xC0,0x1E,0x00,0x0C,0x00,0x0C,0x00,0x0C,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xC0,0xC0,0xC0,0xC0,	//','
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,	//'-'
+	0xFF,0xC0,0xFF,0xC0,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xC0,0xC0,0x00,0x00,	//'.'
+	0x00,0x00,0x00,0x00,0x0C,0x0C,0x0C,0x1C,0x38,0x70,0xE0,0xC0,0xC0,0xC0,0x00,0x00,	//'/'
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x7F,0x80,0xFF,0xC0,0xE3,0xC0,0xC1,0xC0,	//'0'
+	0xCC,0xC0,0xCC,0xC0,0xE0,0xC0,0xF1,0xC0,0xFF,0xC0,0x7F,0x80,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x0C,0x00,0x1C,0x00,0x3C,0x00,0x3C,0x00,	//'1'
+	0x1C,0x00,0x0C,0x00,0x0C,0x00,0x1E,0x00,0x3F,0x00,0x3F,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xFF,0x00,0xFF,0x80,0x00,0xC0,0x00,0xC0,	//'2'
+	0x3F,0x80,0x7F,0x00,0xC0,0x00,0xC0,0x00,0xFF,0xC0,0x7F,0xC0,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xFF,0x80,0xFF,0xC0,0x00,0xC0,0x00,0xC0,	//'3'
+	0x3F,0x00,0x3F,0x00,0x00,0xC0,0x00,0xC0,0xFF,0xC0,0xFF,0x80,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xC0,0x00,0xC0,0x00,0xC0,0x00,0xC0,0x00,	//'4'
+	0xCC,0x00,0xCE,0x00,0xFF,0xC0,0x7F,0xC0,0x1E,0x00,0x0C,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x7F,0xC0,0xFF,0xC0,0xC0,0x00,0xC0,0x00,	//'5'
+	0xFF,0x00,0x7F,0x80,0x00,0xC0,0x00,0xC0,0xFF,0x80,0xFF,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x7F,0xC0,0xFF,0xC0,0xC0,0x00,0xC0,0x00,	//'6'
+	0xFF,0x80,0xFF,0xC0,0xC0,0xC0,0xC0,0xC0,0xFF,0xC0,0x7F,0x80,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xFF,0x80,0xFF,0xC0,0x00,0xC0,0x00,0xC0,	//'7'
+	0x03,0x80,0x07,0x00,0x0E,0x00,0x0C,0x00,0x0C,0x00,0x0C,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x7F,0x80,0xFF,0xC0,0xC0,0xC0,0xC0,0xC0,	//'8'
+	0xFF,0xC0,0xFF,0xC0,0xC0,0xC0,0xC0,0xC0,0xFF,0xC0,0x7F,0x80,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x7F,0x80,0xFF,0xC0,0xC0,0xC0,0xC0,0xC0,	//'9'
+	0xFF,0xC0,0x7F,0xC0,0x00,0xC0,0x00,0xC0,0xFF,0xC0,0xFF,0x80,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0xC0,0xC0,0x00,0x00,0x00,0x00,0x00,0x00,0xC0,0xC0,0x00,0x00,	//':'
+	0x00,0x00,0x00,0x00,0xC0,0xC0,0x00,0x00,0x00,0x00,0x00,0x00,0xC0,0xC0,0xC0,0xC0,	//';'
+	0x00,0x00,0x00,0x00,0x0C,0x1C,0x38,0x70,0xC0,0xC0,0x70,0x38,0x1C,0x0C,0x00,0x00,	//'<'
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xFF,0xC0,0xFF,0xC0,	//'='
+	0x00,0x00,0x00,0x00,0xFF,0xC0,0xFF,0xC0,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0xC0,0xE0,0x70,0x38,0x0C,0x0C,0x38,0x70,0xE0,0xC0,0x00,0x00,	//'>'
+	0x00,0x00,0x00,0x00,0x3C,0x7E,0xE3,0xC3,0x0E,0x0C,0x00,0x00,0x0C,0x0C,0x00,0x00,	//'?'
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x7F,0x80,0xFF,0xC0,0xE0,0xC0,0xC0,0xC0,	//'@'
+	0xCF,0xC0,0xCF,0x80,0xC0,0x00,0xE0,0x00,0xFF,0xC0,0x7F,0xC0,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x7F,0x80,0xFF,0xC0,0xE1,0xC0,0xC0,0xC0,	//'A'
+	0xC0,0xC0,0xE1,0xC0,0xFF,0xC0,0xFF,0xC0,0xE1,0xC0,0xC0,0xC0,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x7F,0x80,0xFF,0xC0,0xC0,0xC0,0xC0,0xC0,	//'B'
+	0xFF,0x00,0xFF,0x00,0xC0,0xC0,0xC0,0xC0,0xFF,0xC0,0x7F,0x80,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x7F,0xC0,0xFF,0xC0,0xE0,0x00,0xC0,0x00,	//'C'
+	0xC0,0x00,0xC0,0x00,0xC0,0x00,0xE0,0x00,0xFF,0xC0,0x7F,0xC0,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x7F,0x00,0xFF,0x80,0xE1,0xC0,0xC0,0xC0,	//'D'
+	0xC0,0xC0,0xC0,0xC0,0xC0,0xC0,0xE1,0xC0,0xFF,0x80,0x7F,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x7F,0xC0,0xFF,0xC0,0xC0,0x00,0xC0,0x00,	//'E'
+	0xFF,0x00,0xFF,0x00,0xC0,0x00,0xC0,0x00,0xFF,0xC0,0x7F,0xC0,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x7F,0xC0,0xFF,0xC0,0xC0,0x00,0xC0,0x00,	//'F'
+	0xFF,0x00,0xFF,0x00,0xE0,0x00,0xC0,0x00,0xC0,0x00,0xC0,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x7F,0xC0,0xFF,0xC0,0xE0,0x00,0xC0,0x00,	//'G'
+	0xC3,0x80,0xC3,0xC0,0xC0,0xC0,0xE0,0xC0,0xFF,0xC0,0x7F,0x80,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xC0,0xC0,0xC0,0xC0,0xC0,0xC0,0xE1,0xC0,	//'H'
+	0xFF,0xC0,0xFF,0xC0,0xE1,0xC0,0xC0,0xC0,0xC0,0xC0,0xC0,0xC0,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xFF,0xC0,0xFF,0xC0,0x1E,0x00,0x0C,0x00,	//'I'
+	0x0C,0x00,0x0C,0x00,0x0C,0x00,0x1E,0x00,0xFF,0xC0,0xFF,0xC0,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x03,0x80,0x03,0xC0,0x01,0xC0,0x00,0xC0,	//'J'
+	0x00,0xC0,0x00,0xC0,0xC0,0xC0,0xE1,0xC0,0xFF,0xC0,0x7F,0x80,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xC0,0xC0,0xC1,0xC0,0xC3,0x80,0xE7,0x00,	//'K'
+	0xFC,0x00,0xFC,0x00,0xE7,0x00,0xC3,0x80,0xC1,0xC0,0xC0,0xC0,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xC0,0x00,0xC0,0x00,0xC0,0x00,0xC0,0x00,	//'L'
+	0xC0,0x00,0xC0,0x00,0xC0,0x00,0xE0,0x00,0xFF,0xC0,0x7F,0xC0,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xC0,0xC0,0xE1,0xC0,0xF3,0xC0,0xF3,0xC0,	//'M'
+	0xCC,0xC0,0xCC,0xC0,0xC0,0xC0,0xC0,0xC0,0xC0,0xC0,0xC0,0xC0,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xC0,0xC0,0xE0,0xC0,0xF0,0xC0,0xF8,0xC0,	//'N'
+	0xCC,0xC0,0xCC,0xC0,0xC7,0xC0,0xC3,0xC0,0xC1,0xC0,0xC0,0xC0,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x3F,0x00,0x7F,0x80,0xE1,0xC0,0xC0,0xC0,	//'O'
+	0xC0,0xC0,0xC0,0xC0,0xC0,0xC0,0xE1,0xC0,0x7F,0x80,0x3F,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x7F,0x00,0xFF,0x80,0xC0,0xC0,0xC0,0xC0,	//'P'
+	0xFF,0x80,0xFF,0x00,0xE0,0x00,0xC0,0x00,0xC0,0x00,0xC0,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x7F,0x80,0xFF,0xC0,0xE1,0xC0,0xC0,0xC0,	//'Q'
+	0xC0,0xC0,0xE1,0xC0,0xFF,0xC0,0x7F,0x80,0x1E,0x00,0x0C,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x7F,0x00,0xFF,0x80,0xC0,0xC0,0xC0,0xC0,	//'R'
+	0xFF,0x00,0xFF,0x00,0xE1,0xC0,0xC0,0xC0,0xC0,0xC0,0xC0,0xC0,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x7F,0xC0,0xFF,0xC0,0xC0,0x00,0xC0,0x00,	//'S'
+	0xFF,0x80,0x7F,0xC0,0x00,0xC0,0x00,0xC0,0xFF,0xC0,0xFF,0x80,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xFF,0xC0,0xFF,0xC0,0x1E,0x00,0x0C,0x00,	//'T'
+	0x0C,0x00,0x0C,0x00,0x0C,0x00,0x0C,0x00,0x0C,0x00,0x0C,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xC0,0xC0,0xC0,0xC0,0xC0,0xC0,0xC0,0xC0,	//'U'
+	0xC0,0xC0,0xC0,0xC0,0xC0,0xC0,0xE1,0xC0,0xFF,0xC0,0x7F,0x80,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xC0,0xC0,0xC0,0xC0,0xC0,0xC0,0xE1,0xC0,	//'V'
+	0x73,0x80,0x33,0x00,0x33,0x00,0x33,0x00,0x1E,0x00,0x0C,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xC0,0xC0,0xC0,0xC0,0xC0,0xC0,0xC0,0xC0,	//'W'
+	0xCC,0xC0,0xCC,0xC0,0xCC,0xC0,0xCC,0xC0,0x73,0x80,0x33,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xC0,0xC0,0xE1,0xC0,0x73,0x80,0x33,0x00,	//'X'
+	0x0C,0x00,0x0C,0x00,0x33,0x00,0x73,0x80,0xE1,0xC0,0xC0,0xC0,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xC0,0xC0,0xC0,0xC0,0xC0,0xC0,0xE1,0xC0,	//'Y'
+	0x73,0x80,0x33,0x00,0x1E,0x00,0x0C,0x00,0x0C,0x00,0x0C,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xFF,0xC0,0xFF,0xC0,0x03,0x80,0x03,0x00,	//'Z'
+	0x0E,0x00,0x1C,0x00,0x30,0x00,0x70,0x00,0xFF,0xC0,0xFF,0xC0,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x70,0xF0,0xE0,0xC0,0xC0,0xC0,0xC0,0xE0,0xF0,0x70,0x00,0x00,	//'['
+	0x00,0x00,0x00,0x00,0xC0,0xC0,0xC0,0xE0,0x70,0x38,0x1C,0x0C,0x0C,0x0C,0x00,0x00,	//'\\'
+	0x00,0x00,0x00,0x00,0xE0,0xF0,0x70,0x30,0x30,0x30,0x30,0x70,0xF0,0xE0,0x00,0x00,	//']'
+	0xCC,0xCC,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,	//'^'
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,	//'_'
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xFF,0xF0,0xFF,0xF0,0x00,0x00,0x00,0x00,
+	0xC0,0xC0,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,	//'`'
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x7F,0x80,0xFF,0xC0,0xE1,0xC0,0xC0,0xC0,	//'a'
+	0xC0,0xC0,0xE1,0xC0,0xFF,0xC0,0xFF,0xC0,0xE1,0xC0,0xC0,0xC0,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x7F,0x80,0xFF,0xC0,0xC0,0xC0,0xC0,0xC0,	//'b'
+	0xFF,0x00,0xFF,0x00,0xC0,0xC0,0xC0,0xC0,0xFF,0xC0,0x7F,0x80,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x7F,0xC0,0xFF,0xC0,0xE0,0x00,0xC0,0x00,	//'c'
+	0xC0,0x00,0xC0,0x00,0xC0,0x00,0xE0,0x00,0xFF,0xC0,0x7F,0xC0,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x7F,0x00,0xFF,0x80,0xE1,0xC0,0xC0,0xC0,	//'d'
+	0xC0,0xC0,0xC0,0xC0,0xC0,0xC0,0xE1,0xC0,0xFF,0x80,0x7F,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x7F,0xC0,0xFF,0xC0,0xC0,0x00,0xC0,0x00,	//'e'
+	0xFF,0x00,0xFF,0x00,0xC0,0x00,0xC0,0x00,0xFF,0xC0,0x7F,0xC0,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x7F,0xC0,0xFF,0xC0,0xC0,0x00,0xC0,0x00,	//'f'
+	0xFF,0x00,0xFF,0x00,0xE0,0x00,0xC0,0x00,0xC0,0x00,0xC0,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x7F,0xC0,0xFF,0xC0,0xE0,0x00,0xC0,0x00,	//'g'
+	0xC3,0x80,0xC3,0xC0,0xC0,0xC0,0xE0,0xC0,0xFF,0xC0,0x7F,0x80,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xC0,0xC0,0xC0,0xC0,0xC0,0xC0,0xE1,0xC0,	//'h'
+	0xFF,0xC0,0xFF,0xC0,0xE1,0xC0,0xC0,0xC0,0xC0,0xC0,0xC0,0xC0,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xFF,0xC0,0xFF,0xC0,0x1E,0x00,0x0C,0x00,	//'i'
+	0x0C,0x00,0x0C,0x00,0x0C,0x00,0x1E,0x00,0xFF,0xC0,0xFF,0xC0,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x03,0x80,0x03,0xC0,0x01,0xC0,0x00,0xC0,	//'j'
+	0x00,0xC0,0x00,0xC0,0xC0,0xC0,0xE1,0xC0,0xFF,0xC0,0x7F,0x80,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xC0,0xC0,0xC1,0xC0,0xC3,0x80,0xE7,0x00,	//'k'
+	0xFC,0x00,0xFC,0x00,0xE7,0x00,0xC3,0x80,0xC1,0xC0,0xC0,0xC0,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xC0,0x00,0xC0,0x00,0xC0,0x00,0xC0,0x00,	//'l'
+	0xC0,0x00,0xC0,0x00,0xC0,0x00,0xE0,0x00,0xFF,0xC0,0x7F,0xC0,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xC0,0xC0,0xE1,0xC0,0xF3,0xC0,0xF3,0xC0,	//'m'
+	0xCC,0xC0,0xCC,0xC0,0xC0,0xC0,0xC0,0xC0,0xC0,0xC0,0xC0,0xC0,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xC0,0xC0,0xE0,0xC0,0xF0,0xC0,0xF8,0xC0,	//'n'
+	0xCC,0xC0,0xCC,0xC0,0xC7,0xC0,0xC3,0xC0,0xC1,0xC0,0xC0,0xC0,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x3F,0x00,0x7F,0x80,0xE1,0xC0,0xC0,0xC0,	//'o'
+	0xC0,0xC0,0xC0,0xC0,0xC0,0xC0,0xE1,0xC0,0x7F,0x80,0x3F,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x7F,0x00,0xFF,0x80,0xC0,0xC0,0xC0,0xC0,	//'p'
+	0xFF,0x80,0xFF,0x00,0xE0,0x00,0xC0,0x00,0xC0,0x00,0xC0,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x7F,0x80,0xFF,0xC0,0xE1,0xC0,0xC0,0xC0,	//'q'
+	0xC0,0xC0,0xE1,0xC0,0xFF,0xC0,0x7F,0x80,0x1E,0x00,0x0C,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x7F,0x00,0xFF,0x80,0xC0,0xC0,0xC0,0xC0,	//'r'
+	0xFF,0x00,0xFF,0x00,0xE1,0xC0,0xC0,0xC0,0xC0,0xC0,0xC0,0xC0,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x7F,0xC0,0xFF,0xC0,0xC0,0x00,0xC0,0x00,	//'s'
+	0xFF,0x80,0x7F,0xC0,0x00,0xC0,0x00,0xC0,0xFF,0xC0,0xFF,0x80,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xFF,0xC0,0xFF,0xC0,0x1E,0x00,0x0C,0x00,	//'t'
+	0x0C,0x00,0x0C,0x00,0x0C,0x00,0x0C,0x00,0x0C,0x00,0x0C,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xC0,0xC0,0xC0,0xC0,0xC0,0xC0,0xC0,0xC0,	//'u'
+	0xC0,0xC0,0xC0,0xC0,0xC0,0xC0,0xE1,0xC0,0xFF,0xC0,0x7F,0x80,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xC0,0xC0,0xC0,0xC0,0xC0,0xC0,0xE1,0xC0,	//'v'
+	0x73,0x80,0x33,0x00,0x33,0x00,0x33,0x00,0x1E,0x00,0x0C,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xC0,0xC0,0xC0,0xC0,0xC0,0xC0,0xC0,0xC0,	//'w'
+	0xCC,0xC0,0xCC,0xC0,0xCC,0xC0,0xCC,0xC0,0x73,0x80,0x33,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xC0,0xC0,0xE1,0xC0,0x73,0x80,0x33,0x00,	//'x'
+	0x0C,0x00,0x0C,0x00,0x33,0x00,0x73,0x80,0xE1,0xC0,0xC0,0xC0,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xC0,0xC0,0xC0,0xC0,0xC0,0xC0,0xE1,0xC0,	//'y'
+	0x73,0x80,0x33,0x00,0x1E,0x00,0x0C,0x00,0x0C,0x00,0x0C,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xFF,0xC0,0xFF,0xC0,0x03,0x80,0x03,0x00,	//'z'
+	0x0E,0x00,0x1C,0x00,0x30,0x00,0x70,0x00,0xFF,0xC0,0xFF,0xC0,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x1C,0x3C,0x38,0x70,0xF0,0xF0,0x70,0x38,0x3C,0x1C,0x00,0x00,	//'{'
+	0x00,0x00,0x00,0x00,0xC0,0xC0,0xC0,0xC0,0x00,0x00,0xC0,0xC0,0xC0,0xC0,0x00,0x00,	//'|'
+	0x00,0x00,0x00,0x00,0xE0,0xF0,0x70,0x38,0x3C,0x3C,0x38,0x70,0xF0,0xE0,0x00,0x00,	//'}'
+	0x33,0x73,0xCE,0xCC,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,	//'~'
+};
+
+static const ILI9341_Glyph_t Font_Medium_Glyphs[95] = {
+	{0,6}, {16,2}, {32,6}, {48,10}, {80,10}, {112,10}, {144,10}, {176,2},
+	{192,4}, {208,4}, {224,6}, {240,10}, {272,2}, {288,10}, {320,2}, {336,6},
+	{352,10}, {384,10}, {416,10}, {448,10}, {480,10}, {512,10}, {544,10}, {576,10},
+	{608,10}, {640,10}, {672,2}, {688,2}, {704,6}, {720,10}, {752,6}, {768,8},
+	{784,10}, {816,10}, {848,10}, {880,10}, {912,10}, {944,10}, {976,10}, {1008,10},
+	{1040,10}, {1072,10}, {1104,10}, {1136,10}, {1168,10}, {1200,10}, {1232,10}, {1264,10},
+	{1296,10}, {1328,10}, {1360,10}, {1392,10}, {1424,10}, {1456,10}, {1488,10}, {1520,10},
+	{1552,10}, {1584,10}, {1616,10}, {1648,4}, {1664,6}, {1680,4}, {1696,6}, {1712,12},
+	{1744,2}, {1760,10}, {1792,10}, {1824,10}, {1856,10}, {1888,10}, {1920,10}, {1952,10},
+	{1984,10}, {2016,10}, {2048,10}, {2080,10}, {2112,10}, {2144,10}, {2176,10}, {2208,10},
+	{2240,10}, {2272,10}, {2304,10}, {2336,10}, {2368,10}, {2400,10}, {2432,10}, {2464,10},
+	{2496,10}, {2528,10}, {2560,10}, {2592,6}, {2608,2}, {2624,6}, {2640,8},
+};
+
+const ILI9341_Font_t Font_Medium = {
+	16, 32, 126, 2, Font_Medium_Glyphs, Font_Medium_Bitmap
+};
+
+/* Font_Large: 5x5_font.h, 24 pixels high, 4296 bitmap bytes */
+static const uint8_t Font_Large_Bitmap[4296] = {
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,	//' '
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0xE0,0xE0,0xE0,0xE0,0xE0,0xE0,0xE0,0xE0,0xE0,0x00,	//'!'
+	0x00,0x00,0xE0,0xE0,0xE0,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0xE3,0x80,0xE3,0x80,0xE3,0x80,0xE3,0x80,0xE3,0x80,	//'"'
+	0xE3,0x80,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x1C,0x70,0x1C,0x70,	//'#'
+	0x3C,0x78,0xFF,0xFE,0xFF,0xFE,0xFF,0xFE,0x1C,0x70,0x1C,0x70,0x1C,0x70,0xFF,0xFE,
+	0xFF,0xFE,0xFF,0xFE,0x3C,0x78,0x1C,0x70,0x1C,0x70,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x03,0x80,0x03,0x80,0x0F,0xE0,0x3F,0xFE,0x7F,0xFE,	//'$'
+	0xFF,0xFE,0xE3,0x80,0xE3,0x80,0xE3,0x80,0xFF,0xF8,0x7F,0xFC,0x3F,0xFE,0x03,0x8E,
+	0x03,0x8E,0x03,0x8E,0xFF,0xFE,0xFF,0xFC,0xFF,0xF8,0x0F,0xE0,0x03,0x80,0x03,0x80,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xE0,0x0E,0xE0,0x0E,	//'%'
+	0xE0,0x1E,0x00,0x78,0x00,0x70,0x00,0xF0,0x03,0xC0,0x03,0x80,0x07,0x80,0x1E,0x00,
+	0x1C,0x00,0x3C,0x00,0xF0,0x0E,0xE0,0x0E,0xE0,0x0E,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x1F,0x80,0x1F,0x80,	//'&'
+	0x3F,0x80,0xE0,0x00,0xE0,0x00,0xE0,0x00,0x1F,0x8E,0x1F,0x8E,0x1F,0x8E,0xE0,0x70,
+	0xE0,0x70,0xE0,0x70,0x3F,0x8E,0x1F,0x8E,0x1F,0x8E,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0xE0,0xE0,0xE0,0xE0,0xE0,0xE0,0x00,0x00,0x00,0x00,0x00,0x00,0x00,	//'\''
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x1C,0x1C,0x3C,0xF0,0xF0,0xE0,0xE0,0xE0,0xE0,0xE0,	//'('
+	0xF0,0xF0,0x3C,0x1C,0x1C,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0xE0,0xE0,0xF0,0x3C,0x3C,0x1C,0x1C,0x1C,0x1C,0x1C,	//')'
+	0x3C,0x3C,0xF0,0xE0,0xE0,0x00,0x00,0x00,
+	0x1C,0x00,0x1C,0x00,0x3E,0x00,0xFF,0x80,0xFF,0x80,0xFF,0x80,0x3E,0x00,0x1C,0x00,	//'*'
+	0x1C,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x03,0x80,0x03,0x80,	//'+'
+	0x03,0x80,0x03,0x80,0x07,0xC0,0x0F,0xE0,0xFF,0xFE,0xFF,0xFE,0xFF,0xFE,0x0F,0xE0,
+	0x07,0xC0,0x03,0x80,0x03,0x80,0x03,0x80,0x03,0x80,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,	//','
+	0x00,0x00,0xE0,0xE0,0xE0,0xE0,0xE0,0xE0,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,	//'-'
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xFF,0xFE,0xFF,0xFE,0xFF,0xFE,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,	//'.'
+	0x00,0x00,0xE0,0xE0,0xE0,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x03,0x80,0x03,0x80,	//'/'
+	0x03,0x80,0x03,0x80,0x07,0x80,0x07,0x80,0x1E,0x00,0x1C,0x00,0x3C,0x00,0xF0,0x00,
+	0xF0,0x00,0xE0,0x00,0xE0,0x00,0xE0,0x00,0xE0,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x3F,0xF8,0x7F,0xFC,	//'0'
+	0xFF,0xFE,0xF8,0x7E,0xF0,0x7E,0xE0,0x3E,0xE3,0x8E,0xE3,0x8E,0xE3,0x8E,0xF8,0x0E,
+	0xFC,0x1E,0xFC,0x3E,0xFF,0xFE,0x7F,0xFC,0x3F,0xF8,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x03,0x80,0x03,0x80,	//'1'
+	0x07,0x80,0x1F,0x80,0x1F,0x80,0x1F,0x80,0x07,0x80,0x07,0x80,0x03,0x80,0x03,0x80,
+	0x07,0xC0,0x07,0xC0,0x1F,0xF0,0x1F,0xF0,0x1F,0xF0,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xFF,0xF0,0xFF,0xF0,	//'2'
+	0xFF,0xF8,0x00,0x0E,0x00,0x0E,0x00,0x0E,0x1F,0xF8,0x1F,0xF0,0x3F,0xF0,0xE0,0x00,
+	0xE0,0x00,0xE0,0x00,0xFF,0xFE,0x7F,0xFE,0x3F,0xFE,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xFF,0xF8,0xFF,0xFC,	//'3'
+	0xFF,0xFE,0x00,0x0E,0x00,0x0E,0x00,0x0E,0x1F,0xF0,0x1F,0xF0,0x1F,0xF0,0x00,0x0E,
+	0x00,0x0E,0x00,0x0E,0xFF,0xFE,0xFF,0xFC,0xFF,0xF8,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xE0,0x00,0xE0,0x00,	//'4'
+	0xE0,0x00,0xE0,0x00,0xE0,0x00,0xE0,0x00,0xE3,0x80,0xE3,0x80,0xE3,0xE0,0xFF,0xFE,
+	0x7F,0xFE,0x3F,0xFE,0x0F,0xE0,0x03,0x80,0x03,0x80,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x3F,0xFE,0x7F,0xFE,	//'5'
+	0xFF,0xFE,0xE0,0x00,0xE0,0x00,0xE0,0x00,0xFF,0xF0,0x7F,0xF0,0x3F,0xF8,0x00,0x0E,
+	0x00,0x0E,0x00,0x0E,0xFF,0xF8,0xFF,0xF0,0xFF,0xF0,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x3F,0xFE,0x7F,0xFE,	//'6'
+	0xFF,0xFE,0xE0,0x00,0xE0,0x00,0xE0,0x00,0xFF,0xF8,0xFF,0xFC,0xFF,0xFE,0xE0,0x0E,
+	0xE0,0x0E,0xE0,0x0E,0xFF,0xFE,0x7F,0xFC,0x3F,0xF8,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xFF,0xF8,0xFF,0xFC,	//'7'
+	0xFF,0xFE,0x00,0x0E,0x00,0x0E,0x00,0x0E,0x00,0x78,0x00,0x70,0x00,0xF0,0x03,0xC0,
+	0x03,0xC0,0x03,0x80,0x03,0x80,0x03,0x80,0x03,0x80,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x3F,0xF8,0x7F,0xFC,	//'8'
+	0xFF,0xFE,0xE0,0x0E,0xE0,0x0E,0xE0,0x0E,0xFF,0xFE,0xFF,0xFE,0xFF,0xFE,0xE0,0x0E,
+	0xE0,0x0E,0xE0,0x0E,0xFF,0xFE,0x7F,0xFC,0x3F,0xF8,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x3F,0xF8,0x7F,0xFC,	//'9'
+	0xFF,0xFE,0xE0,0x0E,0xE0,0x0E,0xE0,0x0E,0xFF,0xFE,0x7F,0xFE,0x3F,0xFE,0x00,0x0E,
+	0x00,0x0E,0x00,0x0E,0xFF,0xFE,0xFF,0xFC,0xFF,0xF8,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0xE0,0xE0,0xE0,0x00,0x00,0x00,0x00,0x00,0x00,0x00,	//':'
+	0x00,0x00,0xE0,0xE0,0xE0,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0xE0,0xE0,0xE0,0x00,0x00,0x00,0x00,0x00,0x00,0x00,	//';'
+	0x00,0x00,0xE0,0xE0,0xE0,0xE0,0xE0,0xE0,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x03,0x80,0x03,0x80,	//'<'
+	0x07,0x80,0x1E,0x00,0x1C,0x00,0x3C,0x00,0xE0,0x00,0xE0,0x00,0xE0,0x00,0x3C,0x00,
+	0x1C,0x00,0x1E,0x00,0x07,0x80,0x03,0x80,0x03,0x80,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,	//'='
+	0x00,0x00,0xFF,0xFE,0xFF,0xFE,0xFF,0xFE,0x00,0x00,0x00,0x00,0x00,0x00,0xFF,0xFE,
+	0xFF,0xFE,0xFF,0xFE,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xE0,0x00,0xE0,0x00,	//'>'
+	0xF0,0x00,0x3C,0x00,0x1C,0x00,0x1E,0x00,0x03,0x80,0x03,0x80,0x03,0x80,0x1E,0x00,
+	0x1C,0x00,0x3C,0x00,0xF0,0x00,0xE0,0x00,0xE0,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x1F,0x80,0x1F,0x80,	//'?'
+	0x3F,0xC0,0xF8,0x70,0xE0,0x70,0xE0,0x70,0x03,0xC0,0x03,0x80,0x03,0x80,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x03,0x80,0x03,0x80,0x03,0x80,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x3F,0xF8,0x7F,0xFC,	//'@'
+	0xFF,0xFE,0xF8,0x0E,0xF0,0x0E,0xE0,0x0E,0xE3,0xFE,0xE3,0xFC,0xE3,0xF8,0xE0,0x00,
+	0xF0,0x00,0xF8,0x00,0xFF,0xFE,0x7F,0xFE,0x3F,0xFE,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x3F,0xF8,0x7F,0xFC,	//'A'
+	0xFF,0xFE,0xF8,0x3E,0xF0,0x1E,0xE0,0x0E,0xE0,0x0E,0xF0,0x1E,0xF8,0x3E,0xFF,0xFE,
+	0xFF,0xFE,0xFF,0xFE,0xF8,0x3E,0xE0,0x0E,0xE0,0x0E,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x3F,0xF8,0x7F,0xFC,	//'B'
+	0xFF,0xFE,0xE0,0x0E,0xE0,0x0E,0xE0,0x0E,0xFF,0xF0,0xFF,0xF0,0xFF,0xF0,0xE0,0x0E,
+	0xE0,0x0E,0xE0,0x0E,0xFF,0xFE,0x7F,0xFC,0x3F,0xF8,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x3F,0xFE,0x7F,0xFE,	//'C'
+	0xFF,0xFE,0xF8,0x00,0xF0,0x00,0xE0,0x00,0xE0,0x00,0xE0,0x00,0xE0,0x00,0xE0,0x00,
+	0xF0,0x00,0xF8,0x00,0xFF,0xFE,0x7F,0xFE,0x3F,0xFE,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x3F,0xF0,0x7F,0xF0,	//'D'
+	0xFF,0xF8,0xF8,0x3E,0xF0,0x1E,0xE0,0x0E,0xE0,0x0E,0xE0,0x0E,0xE0,0x0E,0xE0,0x0E,
+	0xF0,0x1E,0xF8,0x3E,0xFF,0xF8,0x7F,0xF0,0x3F,0xF0,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x3F,0xFE,0x7F,0xFE,	//'E'
+	0xFF,0xFE,0xE0,0x00,0xE0,0x00,0xE0,0x00,0xFF,0xF0,0xFF,0xF0,0xFF,0xF0,0xE0,0x00,
+	0xE0,0x00,0xE0,0x00,0xFF,0xFE,0x7F,0xFE,0x3F,0xFE,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x3F,0xFE,0x7F,0xFE,	//'F'
+	0xFF,0xFE,0xE0,0x00,0xE0,0x00,0xE0,0x00,0xFF,0xF0,0xFF,0xF0,0xFF,0xF0,0xF8,0x00,
+	0xF0,0x00,0xE0,0x00,0xE0,0x00,0xE0,0x00,0xE0,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x3F,0xFE,0x7F,0xFE,	//'G'
+	0xFF,0xFE,0xF8,0x00,0xF0,0x00,0xE0,0x00,0xE0,0x78,0xE0,0x7C,0xE0,0x7E,0xE0,0x0E,
+	0xF0,0x0E,0xF8,0x0E,0xFF,0xFE,0x7F,0xFC,0x3F,0xF8,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xE0,0x0E,0xE0,0x0E,	//'H'
+	0xE0,0x0E,0xE0,0x0E,0xF0,0x1E,0xF8,0x3E,0xFF,0xFE,0xFF,0xFE,0xFF,0xFE,0xF8,0x3E,
+	0xF0,0x1E,0xE0,0x0E,0xE0,0x0E,0xE0,0x0E,0xE0,0x0E,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xFF,0xFE,0xFF,0xFE,	//'I'
+	0xFF,0xFE,0x0F,0xE0,0x07,0xC0,0x03,0x80,0x03,0x80,0x03,0x80,0x03,0x80,0x03,0x80,
+	0x07,0xC0,0x0F,0xE0,0xFF,0xFE,0xFF,0xFE,0xFF,0xFE,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x78,0x00,0x7C,	//'J'
+	0x00,0x7E,0x00,0x1E,0x00,0x1E,0x00,0x0E,0x00,0x0E,0x00,0x0E,0x00,0x0E,0xE0,0x0E,
+	0xE0,0x1E,0xF8,0x3E,0xFF,0xFE,0x7F,0xFC,0x3F,0xF8,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xE0,0x0E,0xE0,0x0E,	//'K'
+	0xE0,0x1E,0xE0,0x78,0xF0,0x70,0xF9,0xF0,0xFF,0x80,0xFF,0x80,0xFF,0x80,0xF9,0xF0,
+	0xF0,0x70,0xE0,0x78,0xE0,0x1E,0xE0,0x0E,0xE0,0x0E,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xE0,0x00,0xE0,0x00,	//'L'
+	0xE0,0x00,0xE0,0x00,0xE0,0x00,0xE0,0x00,0xE0,0x00,0xE0,0x00,0xE0,0x00,0xE0,0x00,
+	0xF0,0x00,0xF8,0x00,0xFF,0xFE,0x7F,0xFE,0x3F,0xFE,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xE0,0x0E,0xE0,0x0E,	//'M'
+	0xF0,0x1E,0xFC,0x7E,0xFC,0x7E,0xFC,0x7E,0xE3,0x8E,0xE3,0x8E,0xE3,0x8E,0xE0,0x0E,
+	0xE0,0x0E,0xE0,0x0E,0xE0,0x0E,0xE0,0x0E,0xE0,0x0E,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xE0,0x0E,0xE0,0x0E,	//'N'
+	0xF0,0x0E,0xFC,0x0E,0xFC,0x0E,0xFE,0x0E,0xE3,0x8E,0xE3,0x8E,0xE3,0x8E,0xE0,0xFE,
+	0xE0,0x7E,0xE0,0x7E,0xE0,0x1E,0xE0,0x0E,0xE0,0x0E,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x1F,0xF0,0x1F,0xF0,	//'O'
+	0x3F,0xF8,0xF8,0x3E,0xF0,0x1E,0xE0,0x0E,0xE0,0x0E,0xE0,0x0E,0xE0,0x0E,0xE0,0x0E,
+	0xF0,0x1E,0xF8,0x3E,0x3F,0xF8,0x1F,0xF0,0x1F,0xF0,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x3F,0xF0,0x7F,0xF0,	//'P'
+	0xFF,0xF8,0xE0,0x0E,0xE0,0x0E,0xE0,0x0E,0xFF,0xF8,0xFF,0xF0,0xFF,0xF0,0xF8,0x00,
+	0xF0,0x00,0xE0,0x00,0xE0,0x00,0xE0,0x00,0xE0,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x3F,0xF8,0x7F,0xFC,	//'Q'
+	0xFF,0xFE,0xF8,0x3E,0xF0,0x1E,0xE0,0x0E,0xE0,0x0E,0xF0,0x1E,0xF8,0x3E,0xFF,0xFE,
+	0x7F,0xFC,0x3F,0xF8,0x0F,0xE0,0x03,0x80,0x03,0x80,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x3F,0xF0,0x7F,0xF0,	//'R'
+	0xFF,0xF8,0xE0,0x0E,0xE0,0x0E,0xE0,0x0E,0xFF,0xF0,0xFF,0xF0,0xFF,0xF0,0xF8,0x3E,
+	0xF0,0x1E,0xE0,0x0E,0xE0,0x0E,0xE0,0x0E,0xE0,0x0E,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x3F,0xFE,0x7F,0xFE,	//'S'
+	0xFF,0xFE,0xE0,0x00,0xE0,0x00,0xE0,0x00,0xFF,0xF8,0x7F,0xFC,0x3F,0xFE,0x00,0x0E,
+	0x00,0x0E,0x00,0x0E,0xFF,0xFE,0xFF,0xFC,0xFF,0xF8,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xFF,0xFE,0xFF,0xFE,	//'T'
+	0xFF,0xFE,0x0F,0xE0,0x07,0xC0,0x03,0x80,0x03,0x80,0x03,0x80,0x03,0x80,0x03,0x80,
+	0x03,0x80,0x03,0x80,0x03,0x80,0x03,0x80,0x03,0x80,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xE0,0x0E,0xE0,0x0E,	//'U'
+	0xE0,0x0E,0xE0,0x0E,0xE0,0x0E,0xE0,0x0E,0xE0,0x0E,0xE0,0x0E,0xE0,0x0E,0xE0,0x0E,
+	0xF0,0x1E,0xF8,0x3E,0xFF,0xFE,0x7F,0xFC,0x3F,0xF8,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xE0,0x0E,0xE0,0x0E,	//'V'
+	0xE0,0x0E,0xE0,0x0E,0xF0,0x1E,0xF0,0x1E,0x3C,0x78,0x3C,0x78,0x1C,0x70,0x1C,0x70,
+	0x1C,0x70,0x1C,0x70,0x07,0xC0,0x03,0x80,0x03,0x80,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xE0,0x0E,0xE0,0x0E,	//'W'
+	0xE0,0x0E,0xE0,0x0E,0xE0,0x0E,0xE0,0x0E,0xE3,0x8E,0xE3,0x8E,0xE3,0x8E,0xE3,0x8E,
+	0xE3,0x8E,0xE3,0x8E,0x3C,0x78,0x1C,0x70,0x1C,0x70,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xE0,0x0E,0xE0,0x0E,	//'X'
+	0xF0,0x1E,0x3C,0x78,0x1C,0x70,0x1C,0x70,0x03,0x80,0x03,0x80,0x03,0x80,0x1C,0x70,
+	0x1C,0x70,0x3C,0x78,0xF0,0x1E,0xE0,0x0E,0xE0,0x0E,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xE0,0x0E,0xE0,0x0E,	//'Y'
+	0xE0,0x0E,0xE0,0x0E,0xF0,0x1E,0xF0,0x1E,0x3C,0x78,0x1C,0x70,0x1C,0x70,0x07,0xC0,
+	0x07,0xC0,0x03,0x80,0x03,0x80,0x03,0x80,0x03,0x80,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xFF,0xFE,0xFF,0xFE,	//'Z'
+	0xFF,0xFE,0x00,0x78,0x00,0x70,0x00,0x70,0x03,0xC0,0x03,0x80,0x07,0x80,0x1C,0x00,
+	0x1C,0x00,0x3C,0x00,0xFF,0xFE,0xFF,0xFE,0xFF,0xFE,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x3C,0x7C,0xFC,0xF0,0xF0,0xE0,0xE0,0xE0,0xE0,0xE0,	//'['
+	0xF0,0xF0,0xFC,0x7C,0x3C,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xE0,0x00,0xE0,0x00,	//'\\'
+	0xE0,0x00,0xE0,0x00,0xF0,0x00,0xF0,0x00,0x3C,0x00,0x1C,0x00,0x1E,0x00,0x07,0x80,
+	0x07,0x80,0x03,0x80,0x03,0x80,0x03,0x80,0x03,0x80,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0xF0,0xF8,0xFC,0x3C,0x3C,0x1C,0x1C,0x1C,0x1C,0x1C,	//']'
+	0x3C,0x3C,0xFC,0xF8,0xF0,0x00,0x00,0x00,
+	0xE3,0x80,0xE3,0x80,0xE3,0x80,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,	//'^'
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,	//'_'
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0xFF,0xFF,0xC0,0xFF,0xFF,0xC0,0xFF,0xFF,0xC0,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0xE0,0xE0,0xE0,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,	//'`'
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x3F,0xF8,0x7F,0xFC,	//'a'
+	0xFF,0xFE,0xF8,0x3E,0xF0,0x1E,0xE0,0x0E,0xE0,0x0E,0xF0,0x1E,0xF8,0x3E,0xFF,0xFE,
+	0xFF,0xFE,0xFF,0xFE,0xF8,0x3E,0xE0,0x0E,0xE0,0x0E,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x3F,0xF8,0x7F,0xFC,	//'b'
+	0xFF,0xFE,0xE0,0x0E,0xE0,0x0E,0xE0,0x0E,0xFF,0xF0,0xFF,0xF0,0xFF,0xF0,0xE0,0x0E,
+	0xE0,0x0E,0xE0,0x0E,0xFF,0xFE,0x7F,0xFC,0x3F,0xF8,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x3F,0xFE,0x7F,0xFE,	//'c'
+	0xFF,0xFE,0xF8,0x00,0xF0,0x00,0xE0,0x00,0xE0,0x00,0xE0,0x00,0xE0,0x00,0xE0,0x00,
+	0xF0,0x00,0xF8,0x00,0xFF,0xFE,0x7F,0xFE,0x3F,0xFE,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x3F,0xF0,0x7F,0xF0,	//'d'
+	0xFF,0xF8,0xF8,0x3E,0xF0,0x1E,0xE0,0x0E,0xE0,0x0E,0xE0,0x0E,0xE0,0x0E,0xE0,0x0E,
+	0xF0,0x1E,0xF8,0x3E,0xFF,0xF8,0x7F,0xF0,0x3F,0xF0,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x3F,0xFE,0x7F,0xFE,	//'e'
+	0xFF,0xFE,0xE0,0x00,0xE0,0x00,0xE0,0x00,0xFF,0xF0,0xFF,0xF0,0xFF,0xF0,0xE0,0x00,
+	0xE0,0x00,0xE0,0x00,0xFF,0xFE,0x7F,0xFE,0x3F,0xFE,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x3F,0xFE,0x7F,0xFE,	//'f'
+	0xFF,0xFE,0xE0,0x00,0xE0,0x00,0xE0,0x00,0xFF,0xF0,0xFF,0xF0,0xFF,0xF0,0xF8,0x00,
+	0xF0,0x00,0xE0,0x00,0xE0,0x00,0xE0,0x00,0xE0,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x3F,0xFE,0x7F,0xFE,	//'g'
+	0xFF,0xFE,0xF8,0x00,0xF0,0x00,0xE0,0x00,0xE0,0x78,0xE0,0x7C,0xE0,0x7E,0xE0,0x0E,
+	0xF0,0x0E,0xF8,0x0E,0xFF,0xFE,0x7F,0xFC,0x3F,0xF8,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xE0,0x0E,0xE0,0x0E,	//'h'
+	0xE0,0x0E,0xE0,0x0E,0xF0,0x1E,0xF8,0x3E,0xFF,0xFE,0xFF,0xFE,0xFF,0xFE,0xF8,0x3E,
+	0xF0,0x1E,0xE0,0x0E,0xE0,0x0E,0xE0,0x0E,0xE0,0x0E,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xFF,0xFE,0xFF,0xFE,	//'i'
+	0xFF,0xFE,0x0F,0xE0,0x07,0xC0,0x03,0x80,0x03,0x80,0x03,0x80,0x03,0x80,0x03,0x80,
+	0x07,0xC0,0x0F,0xE0,0xFF,0xFE,0xFF,0xFE,0xFF,0xFE,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x78,0x00,0x7C,	//'j'
+	0x00,0x7E,0x00,0x1E,0x00,0x1E,0x00,0x0E,0x00,0x0E,0x00,0x0E,0x00,0x0E,0xE0,0x0E,
+	0xE0,0x1E,0xF8,0x3E,0xFF,0xFE,0x7F,0xFC,0x3F,0xF8,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xE0,0x0E,0xE0,0x0E,	//'k'
+	0xE0,0x1E,0xE0,0x78,0xF0,0x70,0xF9,0xF0,0xFF,0x80,0xFF,0x80,0xFF,0x80,0xF9,0xF0,
+	0xF0,0x70,0xE0,0x78,0xE0,0x1E,0xE0,0x0E,0xE0,0x0E,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xE0,0x00,0xE0,0x00,	//'l'
+	0xE0,0x00,0xE0,0x00,0xE0,0x00,0xE0,0x00,0xE0,0x00,0xE0,0x00,0xE0,0x00,0xE0,0x00,
+	0xF0,0x00,0xF8,0x00,0xFF,0xFE,0x7F,0xFE,0x3F,0xFE,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xE0,0x0E,0xE0,0x0E,	//'m'
+	0xF0,0x1E,0xFC,0x7E,0xFC,0x7E,0xFC,0x7E,0xE3,0x8E,0xE3,0x8E,0xE3,0x8E,0xE0,0x0E,
+	0xE0,0x0E,0xE0,0x0E,0xE0,0x0E,0xE0,0x0E,0xE0,0x0E,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xE0,0x0E,0xE0,0x0E,	//'n'
+	0xF0,0x0E,0xFC,0x0E,0xFC,0x0E,0xFE,0x0E,0xE3,0x8E,0xE3,0x8E,0xE3,0x8E,0xE0,0xFE,
+	0xE0,0x7E,0xE0,0x7E,0xE0,0x1E,0xE0,0x0E,0xE0,0x0E,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x1F,0xF0,0x1F,0xF0,	//'o'
+	0x3F,0xF8,0xF8,0x3E,0xF0,0x1E,0xE0,0x0E,0xE0,0x0E,0xE0,0x0E,0xE0,0x0E,0xE0,0x0E,
+	0xF0,0x1E,0xF8,0x3E,0x3F,0xF8,0x1F,0xF0,0x1F,0xF0,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x3F,0xF0,0x7F,0xF0,	//'p'
+	0xFF,0xF8,0xE0,0x0E,0xE0,0x0E,0xE0,0x0E,0xFF,0xF8,0xFF,0xF0,0xFF,0xF0,0xF8,0x00,
+	0xF0,0x00,0xE0,0x00,0xE0,0x00,0xE0,0x00,0xE0,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x3F,0xF8,0x7F,0xFC,	//'q'
+	0xFF,0xFE,0xF8,0x3E,0xF0,0x1E,0xE0,0x0E,0xE0,0x0E,0xF0,0x1E,0xF8,0x3E,0xFF,0xFE,
+	0x7F,0xFC,0x3F,0xF8,0x0F,0xE0,0x03,0x80,0x03,0x80,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x3F,0xF0,0x7F,0xF0,	//'r'
+	0xFF,0xF8,0xE0,0x0E,0xE0,0x0E,0xE0,0x0E,0xFF,0xF0,0xFF,0xF0,0xFF,0xF0,0xF8,0x3E,
+	0xF0,0x1E,0xE0,0x0E,0xE0,0x0E,0xE0,0x0E,0xE0,0x0E,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x3F,0xFE,0x7F,0xFE,	//'s'
+	0xFF,0xFE,0xE0,0x00,0xE0,0x00,0xE0,0x00,0xFF,0xF8,0x7F,0xFC,0x3F,0xFE,0x00,0x0E,
+	0x00,0x0E,0x00,0x0E,0xFF,0xFE,0xFF,0xFC,0xFF,0xF8,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xFF,0xFE,0xFF,0xFE,	//'t'
+	0xFF,0xFE,0x0F,0xE0,0x07,0xC0,0x03,0x80,0x03,0x80,0x03,0x80,0x03,0x80,0x03,0x80,
+	0x03,0x80,0x03,0x80,0x03,0x80,0x03,0x80,0x03,0x80,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xE0,0x0E,0xE0,0x0E,	//'u'
+	0xE0,0x0E,0xE0,0x0E,0xE0,0x0E,0xE0,0x0E,0xE0,0x0E,0xE0,0x0E,0xE0,0x0E,0xE0,0x0E,
+	0xF0,0x1E,0xF8,0x3E,0xFF,0xFE,0x7F,0xFC,0x3F,0xF8,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xE0,0x0E,0xE0,0x0E,	//'v'
+	0xE0,0x0E,0xE0,0x0E,0xF0,0x1E,0xF0,0x1E,0x3C,0x78,0x3C,0x78,0x1C,0x70,0x1C,0x70,
+	0x1C,0x70,0x1C,0x70,0x07,0xC0,0x03,0x80,0x03,0x80,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xE0,0x0E,0xE0,0x0E,	//'w'
+	0xE0,0x0E,0xE0,0x0E,0xE0,0x0E,0xE0,0x0E,0xE3,0x8E,0xE3,0x8E,0xE3,0x8E,0xE3,0x8E,
+	0xE3,0x8E,0xE3,0x8E,0x3C,0x78,0x1C,0x70,0x1C,0x70,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xE0,0x0E,0xE0,0x0E,	//'x'
+	0xF0,0x1E,0x3C,0x78,0x1C,0x70,0x1C,0x70,0x03,0x80,0x03,0x80,0x03,0x80,0x1C,0x70,
+	0x1C,0x70,0x3C,0x78,0xF0,0x1E,0xE0,0x0E,0xE0,0x0E,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xE0,0x0E,0xE0,0x0E,	//'y'
+	0xE0,0x0E,0xE0,0x0E,0xF0,0x1E,0xF0,0x1E,0x3C,0x78,0x1C,0x70,0x1C,0x70,0x07,0xC0,
+	0x07,0xC0,0x03,0x80,0x03,0x80,0x03,0x80,0x03,0x80,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xFF,0xFE,0xFF,0xFE,	//'z'
+	0xFF,0xFE,0x00,0x78,0x00,0x70,0x00,0x70,0x03,0xC0,0x03,0x80,0x07,0x80,0x1C,0x00,
+	0x1C,0x00,0x3C,0x00,0xFF,0xFE,0xFF,0xFE,0xFF,0xFE,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x07,0x80,0x0F,0x80,	//'{'
+	0x1F,0x80,0x1E,0x00,0x3E,0x00,0x3C,0x00,0xFC,0x00,0xFC,0x00,0xFC,0x00,0x3C,0x00,
+	0x3E,0x00,0x1E,0x00,0x1F,0x80,0x0F,0x80,0x07,0x80,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0xE0,0xE0,0xE0,0xE0,0xE0,0xE0,0x00,0x00,0x00,0xE0,	//'|'
+	0xE0,0xE0,0xE0,0xE0,0xE0,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xF0,0x00,0xF8,0x00,	//'}'
+	0xFC,0x00,0x3C,0x00,0x3E,0x00,0x1E,0x00,0x1F,0x80,0x1F,0x80,0x1F,0x80,0x1E,0x00,
+	0x3E,0x00,0x3C,0x00,0xFC,0x00,0xF8,0x00,0xF0,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x1C,0x70,0x1C,0x70,0x3C,0x70,0xE3,0xC0,0xE3,0x80,0xE3,0x80,0x00,0x00,0x00,0x00,	//'~'
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+};
+
+static const ILI9341_Glyph_t Font_Large_Glyphs[95] = {
+	{0,9}, {48,3}, {72,9}, {120,15}, {168,15}, {216,15}, {264,15}, {312,3},
+	{336,6}, {360,6}, {384,9}, {432,15}, {480,3}, {504,15}, {552,3}, {576,9},
+	{624,15}, {672,15}, {720,15}, {768,15}, {816,15}, {864,15}, {912,15}, {960,15},
+	{1008,15}, {1056,15}, {1104,3}, {1128,3}, {1152,9}, {1200,15}, {1248,9}, {1296,12},
+	{1344,15}, {1392,15}, {1440,15}, {1488,15}, {1536,15}, {1584,15}, {1632,15}, {1680,15},
+	{1728,15}, {1776,15}, {1824,15}, {1872,15}, {1920,15}, {1968,15}, {2016,15}, {2064,15},
+	{2112,15}, {2160,15}, {2208,15}, {2256,15}, {2304,15}, {2352,15}, {2400,15}, {2448,15},
+	{2496,15}, {2544,15}, {2592,15}, {2640,6}, {2664,9}, {2712,6}, {2736,9}, {2784,18},
+	{2856,3}, {2880,15}, {2928,15}, {2976,15}, {3024,15}, {3072,15}, {3120,15}, {3168,15},
+	{3216,15}, {3264,15}, {3312,15}, {3360,15}, {3408,15}, {3456,15}, {3504,15}, {3552,15},
+	{3600,15}, {3648,15}, {3696,15}, {3744,15}, {3792,15}, {3840,15}, {3888,15}, {3936,15},
+	{3984,15}, {4032,15}, {4080,15}, {4128,9}, {4176,3}, {4200,9}, {4248,12},
+};
+
+const ILI9341_Font_t Font_Large = {
+	24, 32, 126, 3, Font_Large_Glyphs, Font_Large_Bitmap
+};
@@ -0,0 +1,35 @@
+#ifndef ILI9341_FONTS_H
+#define ILI9341_FONTS_H
+
+#include <stdint.h>
+
+//PROPORTIONAL BITMAP FONTS FOR ILI9341_Draw_Text_Font(), SEE font_convert.py FOR THE CONVERSION
+//
+//	Every glyph is Width pixels wide and Font->Height pixels high, followed by Spacing background columns.
+//	The bitmap is row-packed: one row after the other, most significant bit = leftmost pixel, every row
+//	starts on a new byte ((Width+7)/8 bytes per row). A row of a string is expanded by reading a few
+//	bytes per glyph, no bit has to be gathered from other rows.
+//	The digits 0-9 of the fonts below share one width, numbers keep their position when they change.
+
+typedef struct
+{
+	uint16_t Offset;	//FIRST BYTE OF THE GLYPH IN Bitmap
+	uint8_t Width;		//PIXEL COLUMNS OF THE GLYPH
+} ILI9341_Glyph_t;
+
+typedef struct
+{
+	uint8_t Height;		//PIXEL ROWS OF EVERY GLYPH
+	uint8_t First;		//CHARACTER CODE OF Glyphs[0]
+	uint8_t Last;		//LAST CHARACTER CODE, OTHERS ARE DRAWN AS First
+	uint8_t Spacing;	//BACKGROUND COLUMNS AFTER EVERY GLYPH
+	const ILI9341_Glyph_t* Glyphs;
+	const uint8_t* Bitmap;
+} ILI9341_Font_t;
+
+//GENERATED FROM THE 5x5 LIBRARY FONT (ILI9341_Fonts.c)
+extern const ILI9341_Font_t Font_Small;		//8 PIXELS HIGH, NATIVE
+extern const ILI9341_Font_t Font_Medium;	//16 PIXELS HIGH, SCALE2X SMOOTHED
+extern const ILI9341_Font_t Font_Large;		//24 PIXELS HIGH, SCALE3X SMOOTHED
+
+#endif
@@ -48,314 +48,1087 @@
 #include <lcd/5x5_font.h>
 #include <lcd/ILI9341_GFX.h>
 #include <lcd/ILI9341_STM32_Driver.h>
+#include <profile/profile.h>
+#include <string.h>
+
+//-----------------------------------
+//	Clip rectangle
+//-----------------------------------
+//
+//	Every primitive is clipped once against the clip rectangle (intersected with the screen of the current rotation)
+//	before it is rasterized: fills by rectangle intersection, lines by Cohen-Sutherland outcodes and a cut of the
+//	Bresenham step range, text, images and sprites by their visible window. Spans and runs that come out of that lie
+//	inside the screen and go to the address window without further checks.
+
+//INCLUSIVE RECTANGLE WITH SIGNED CORNERS
+typedef struct
+{
+	int32_t X0;
+	int32_t Y0;
+	int32_t X1;
+	int32_t Y1;
+} ILI9341_Rect_t;
+
+//COHEN-SUTHERLAND OUTCODE BITS
+#define CLIP_LEFT		0x01
+#define CLIP_RIGHT		0x02
+#define CLIP_TOP		0x04
+#define CLIP_BOTTOM		0x08
+
+//CLIP RECTANGLE OF ILI9341_Set_Clip(), THE DEFAULT COVERS THE SCREEN IN EVERY ROTATION
+static ILI9341_Rect_t Clip = {0, 0, INT16_MAX, INT16_MAX};
+
+/*Clip rectangle intersected with the screen of the current rotation, X0 > X1 or Y0 > Y1 if nothing is visible*/
+static ILI9341_Rect_t ILI9341_Clip_Bounds(void)
+{
+	ILI9341_Rect_t Bounds = Clip;
+	if(Bounds.X0 < 0) Bounds.X0 = 0;
+	if(Bounds.Y0 < 0) Bounds.Y0 = 0;
+	if(Bounds.X1 >= (int32_t)LCD_WIDTH) Bounds.X1 = LCD_WIDTH - 1;
+	if(Bounds.Y1 >= (int32_t)LCD_HEIGHT) Bounds.Y1 = LCD_HEIGHT - 1;
+	return Bounds;
+}
+
+/*Cohen-Sutherland outcode of X,Y against Bounds*/
+static uint8_t ILI9341_Outcode(int32_t X, int32_t Y, const ILI9341_Rect_t* Bounds)
+{
+	uint8_t Code = 0;
+	if(X < Bounds->X0) Code |= CLIP_LEFT;
+	else if(X > Bounds->X1) Code |= CLIP_RIGHT;
+	if(Y < Bounds->Y0) Code |= CLIP_TOP;
+	else if(Y > Bounds->Y1) Code |= CLIP_BOTTOM;
+	return Code;
+}
+
+/*Limits all following drawing to X0,Y0 - X1,Y1 (inclusive, intersected with the screen), X1 < X0 or Y1 < Y0 draws nothing*/
+void ILI9341_Set_Clip(int16_t X0, int16_t Y0, int16_t X1, int16_t Y1)
+{
+	Clip.X0 = X0;
+	Clip.Y0 = Y0;
+	Clip.X1 = X1;
+	Clip.Y1 = Y1;
+}
+
+/*Removes the clip rectangle, drawing is clipped to the screen only*/
+void ILI9341_Reset_Clip(void)
+{
+	ILI9341_Set_Clip(0, 0, INT16_MAX, INT16_MAX);
+}
+
+/*Sends the rectangle X0,Y0 - X1,Y1 (inclusive, inside the screen) in one address window and burst, nothing is checked*/
+static void ILI9341_Fill_Window(int32_t X0, int32_t Y0, int32_t X1, int32_t Y1, uint16_t Colour)
+{
+	//A SINGLE PIXEL FITS INTO ONE TRANSACTION WITHOUT THE BURST BUFFER
+	if((X0 == X1) && (Y0 == Y1))
+	{
+		unsigned char Temp_Buffer[2] = {Colour>>8, Colour};
+		ILI9341_Begin_Transaction();
+		ILI9341_Transaction_Address(X0, Y0, X0+1, Y0+1);
+		ILI9341_Transaction_Data(Temp_Buffer, 2);
+		ILI9341_End_Transaction();
+		return;
+	}
+
+	ILI9341_Set_Address(X0, Y0, X1, Y1);
+	ILI9341_Draw_Colour_Burst(Colour, (uint32_t)(X1 - X0 + 1) * (uint32_t)(Y1 - Y0 + 1));
+}
+
+/*Clips the rectangle X0,Y0 - X1,Y1 (inclusive) to the clip rectangle and sends it in one address window and burst*/
+static void ILI9341_Fill_Clipped(int32_t X0, int32_t Y0, int32_t X1, int32_t Y1, uint16_t Colour)
+{
+	ILI9341_Rect_t Bounds = ILI9341_Clip_Bounds();
+
+	if(X0 < Bounds.X0) X0 = Bounds.X0;
+	if(Y0 < Bounds.Y0) Y0 = Bounds.Y0;
+	if(X1 > Bounds.X1) X1 = Bounds.X1;
+	if(Y1 > Bounds.Y1) Y1 = Bounds.Y1;
+	if((X0 > X1) || (Y0 > Y1)) return;
+
+	ILI9341_Fill_Window(X0, Y0, X1, Y1, Colour);
+}
+
+/*Fills Width x Height pixels with the upper left corner at X,Y, clipped to the clip rectangle*/
+void ILI9341_Fill_Rectangle(uint16_t X, uint16_t Y, uint16_t Width, uint16_t Height, uint16_t Colour)
+{
+	ILI9341_Fill_Clipped(X, Y, (int32_t)X + Width - 1, (int32_t)Y + Height - 1, Colour);
+}
+
+//-----------------------------------
+//	Span rasterizer for round shapes
+//-----------------------------------
+//
+//	Every address window costs a DMA drain and eleven command/parameter bytes, so round shapes are
+//	sent as long horizontal spans and vertical runs instead of single pixels. All shapes are built from
+//	one ellipse quadrant that is produced row by row and mirrored around a rectangle of corner centres
+//	(a single point for circles and ellipses). Coordinates are signed internally and clipped span by span.
+
+//ONE QUADRANT ROW BY ROW: LARGEST X WHOSE PIXEL CENTRE LIES INSIDE THE ELLIPSE WITH RADII RX+1/2, RY+1/2
+//4*X^2*(2*RY+1)^2 + 4*Y^2*(2*RX+1)^2 <= (2*RX+1)^2*(2*RY+1)^2, THE SCANLINE FORM OF THE MIDPOINT TEST
+typedef struct
+{
+	int64_t Error;		//LEFT MINUS RIGHT SIDE FOR THE CURRENT X,Y, <= 0 IS INSIDE
+	int64_t Step_X;		//4*(2*RY+1)^2
+	int64_t Step_Y;		//4*(2*RX+1)^2
+	int32_t X;
+	int32_t Y;
+} ILI9341_Quadrant_t;
+
+//SINE OF 0..90 DEGREES IN Q14
+static const int16_t Sine_Q14[91] =
+{
+	0, 286, 572, 857, 1143, 1428, 1713, 1997, 2280, 2563,
+	2845, 3126, 3406, 3686, 3964, 4240, 4516, 4790, 5063, 5334,
+	5604, 5872, 6138, 6402, 6664, 6924, 7182, 7438, 7692, 7943,
+	8192, 8438, 8682, 8923, 9162, 9397, 9630, 9860, 10087, 10311,
+	10531, 10749, 10963, 11174, 11381, 11585, 11786, 11982, 12176, 12365,
+	12551, 12733, 12911, 13085, 13255, 13421, 13583, 13741, 13894, 14044,
+	14189, 14330, 14466, 14598, 14726, 14849, 14968, 15082, 15191, 15296,
+	15396, 15491, 15582, 15668, 15749, 15826, 15897, 15964, 16026, 16083,
+	16135, 16182, 16225, 16262, 16294, 16322, 16344, 16362, 16374, 16382,
+	16384
+};
+
+/*Starts a quadrant with radii Rx,Ry and returns the half width of row 0 (Rx)*/
+static int32_t ILI9341_Quadrant_Init(ILI9341_Quadrant_t *Quadrant, uint16_t Rx, uint16_t Ry)
+{
+	int64_t A = (2*(int64_t)Rx + 1) * (2*(int64_t)Rx + 1);
+	int64_t B = (2*(int64_t)Ry + 1) * (2*(int64_t)Ry + 1);
+
+	Quadrant->Step_X = 4*B;
+	Quadrant->Step_Y = 4*A;
+	Quadrant->Error = 4*(int64_t)Rx*Rx*B - A*B;
+	Quadrant->X = Rx;
+	Quadrant->Y = 0;
+	return Rx;
+}
+
+/*Moves the quadrant one row away from the centre and returns the half width, -1 past Ry*/
+static int32_t ILI9341_Quadrant_Next(ILI9341_Quadrant_t *Quadrant)
+{
+	//Y -> Y+1 ADDS 4*A*(2Y+1), X -> X-1 SUBTRACTS 4*B*(2X-1)
+	Quadrant->Error += Quadrant->Step_Y * (2*Quadrant->Y + 1);
+	Quadrant->Y++;
+	while((Quadrant->Error > 0) && (Quadrant->X > 0))
+	{
+		Quadrant->Error -= Quadrant->Step_X * (2*Quadrant->X - 1);
+		Quadrant->X--;
+	}
+	return (Quadrant->Error > 0) ? -1 : Quadrant->X;
+}
+
+/*Rows Top-From..Top-To above and Bottom+From..Bottom+To below, row 0 runs through the straight part in between*/
+static void ILI9341_Fill_Mirrored(int32_t X0, int32_t X1, int32_t Top, int32_t Bottom, int32_t From, int32_t To, uint16_t Colour)
+{
+	if(From == 0)
+	{
+		ILI9341_Fill_Clipped(X0, Top - To, X1, Bottom + To, Colour);
+		return;
+	}
+	ILI9341_Fill_Clipped(X0, Top - To, X1, Top - From, Colour);
+	ILI9341_Fill_Clipped(X0, Bottom + From, X1, Bottom + To, Colour);
+}
+
+/*Row Top-Row above and Bottom+Row below, sent once if both are the same row*/
+static void ILI9341_Fill_Row_Pair(int32_t X0, int32_t X1, int32_t Top, int32_t Bottom, int32_t Row, uint16_t Colour)
+{
+	ILI9341_Fill_Clipped(X0, Top - Row, X1, Top - Row, Colour);
+	if((Row > 0) || (Bottom > Top))
+	{
+		ILI9341_Fill_Clipped(X0, Bottom + Row, X1, Bottom + Row, Colour);
+	}
+}
+
+/*Draws four quadrants with radii Rx,Ry mirrored around the corner centres Left,Top (upper left) and Right,Bottom (lower right)*/
+/*Filled: rows of equal width are merged into one rectangle above and one below*/
+/*Outline: each row covers its width down to the width of the next row, rows that are a single pixel in the same column are merged into vertical runs*/
+static void ILI9341_Draw_Quadrants(int32_t Left, int32_t Top, int32_t Right, int32_t Bottom, uint16_t Rx, uint16_t Ry, uint8_t Filled, uint16_t Colour)
+{
+	ILI9341_Quadrant_t Quadrant;
+	int32_t Width = ILI9341_Quadrant_Init(&Quadrant, Rx, Ry);
+	int32_t Run_Start = 0;
+	int32_t Run_Width = Width;
+	uint8_t Run_Open = 0;
+
+	for(int32_t Row = 0; Row <= Ry; Row++)
+	{
+		int32_t Next = (Row < Ry) ? ILI9341_Quadrant_Next(&Quadrant) : -1;
+
+		if(Filled)
+		{
+			if(Next != Width)
+			{
+				ILI9341_Fill_Mirrored(Left - Width, Right + Width, Top, Bottom, Run_Start, Row, Colour);
+				Run_Start = Row + 1;
+			}
+		}
+		else
+		{
+			int32_t Inner = (Next + 1 < Width) ? Next + 1 : Width;
+
+			//SINGLE PIXEL ROW IN THE COLUMN OF THE OPEN RUN: EXTEND IT
+			if(Run_Open && (Inner == Width) && (Width == Run_Width))
+			{
+				Width = Next;
+				continue;
+			}
+			if(Run_Open)
+			{
+				ILI9341_Fill_Mirrored(Left - Run_Width, Left - Run_Width, Top, Bottom, Run_Start, Row - 1, Colour);
+				ILI9341_Fill_Mirrored(Right + Run_Width, Right + Run_Width, Top, Bottom, Run_Start, Row - 1, Colour);
+				Run_Open = 0;
+			}
+
+			if((Inner == Width) && (Inner > 0))
+			{
+				Run_Open = 1;
+				Run_Start = Row;
+				Run_Width = Width;
+			}
+			else
+			{
+				if(Inner == 0)
+				{
+					ILI9341_Fill_Row_Pair(Left - Width, Right + Width, Top, Bottom, Row, Colour);
+				}
+				else
+				{
+					ILI9341_Fill_Row_Pair(Left - Width, Left - Inner, Top, Bottom, Row, Colour);
+					ILI9341_Fill_Row_Pair(Right + Inner, Right + Width, Top, Bottom, Row, Colour);
+				}
+
+				//STRAIGHT SIDES OF A ROUNDED RECTANGLE BELONG TO ROW 0
+				if((Row == 0) && (Bottom > Top))
+				{
+					ILI9341_Fill_Clipped(Left - Width, Top + 1, Left - Width, Bottom - 1, Colour);
+					ILI9341_Fill_Clipped(Right + Width, Top + 1, Right + Width, Bottom - 1, Colour);
+				}
+			}
+		}
+		Width = Next;
+	}
+	//THE LAST ROW ALWAYS REACHES THE CENTRE COLUMN, NO RUN IS LEFT OPEN
+}
+/*Orders the corners, limits the radius and draws the corner quadrants around the inner rectangle*/
+static void ILI9341_Draw_Round_Rectangle(uint16_t X0, uint16_t Y0, uint16_t X1, uint16_t Y1, uint16_t Radius, uint8_t Filled, uint16_t Colour)
+{
+	int32_t Left = (X0 < X1) ? X0 : X1;
+	int32_t Right = (X0 < X1) ? X1 : X0;
+	int32_t Top = (Y0 < Y1) ? Y0 : Y1;
+	int32_t Bottom = (Y0 < Y1) ? Y1 : Y0;
+	int32_t Limit = ((Right - Left) < (Bottom - Top)) ? (Right - Left)/2 : (Bottom - Top)/2;
+
+	if(Radius > Limit) Radius = Limit;
+	ILI9341_Draw_Quadrants(Left + Radius, Top + Radius, Right - Radius, Bottom - Radius, Radius, Radius, Filled, Colour);
+}
+
+/*Sine of an angle in degrees in Q14, any sign and range*/
+static int32_t ILI9341_Sin_Q14(int32_t Angle)
+{
+	Angle %= 360;
+	if(Angle < 0) Angle += 360;
+
+	if(Angle <= 90) return Sine_Q14[Angle];
+	if(Angle <= 180) return Sine_Q14[180 - Angle];
+	if(Angle <= 270) return -Sine_Q14[Angle - 180];
+	return -Sine_Q14[360 - Angle];
+}
+
+/*Floor of N/D for D > 0*/
+static int32_t ILI9341_Floor_Div(int32_t N, int32_t D)
+{
+	return (N >= 0) ? N / D : -((D - 1 - N) / D);
+}
+
+/*Narrows the columns Lo..Hi of row Y (both relative to the centre) to the points up to 180 degrees clockwise of the direction Ux,Uy*/
+/*Ux*Y - Uy*X >= 0, or > 0 if Strict. The condition is linear in X, so the result is again one interval (empty: Hi < Lo)*/
+static void ILI9341_Clip_Half_Plane(int32_t Ux, int32_t Uy, int32_t Y, uint8_t Strict, int32_t *Lo, int32_t *Hi)
+{
+	//UY*X <= N
+	int32_t N = Ux*Y - (Strict ? 1 : 0);
+
+	if(Uy == 0)
+	{
+		if(N < 0) *Hi = *Lo - 1;
+	}
+	else if(Uy > 0)
+	{
+		int32_t Limit = ILI9341_Floor_Div(N, Uy);
+		if(*Hi > Limit) *Hi = Limit;
+	}
+	else
+	{
+		int32_t Limit = -ILI9341_Floor_Div(N, -Uy);
+		if(*Lo < Limit) *Lo = Limit;
+	}
+}
+
+//DIRECTIONS OF THE ARC ENDS IN Q14 AND THE SWEEP IN DEGREES
+typedef struct
+{
+	int32_t Start_X;
+	int32_t Start_Y;
+	int32_t End_X;
+	int32_t End_Y;
+	int32_t Sweep;
+} ILI9341_Sector_t;
+
+/*Draws the part of the columns Lo..Hi of row Row (both relative to the centre X,Y) that lies inside the sector*/
+static void ILI9341_Fill_Sector_Span(const ILI9341_Sector_t *Sector, int32_t X, int32_t Y, int32_t Row, int32_t Lo, int32_t Hi, uint16_t Colour)
+{
+	if(Sector->Sweep >= 360)
+	{
+		ILI9341_Fill_Clipped(X + Lo, Y + Row, X + Hi, Y + Row, Colour);
+		return;
+	}
+
+	//UP TO 180 DEGREES: CLOCKWISE OF THE START AND COUNTERCLOCKWISE OF THE END
+	if(Sector->Sweep <= 180)
+	{
+		ILI9341_Clip_Half_Plane(Sector->Start_X, Sector->Start_Y, Row, 0, &Lo, &Hi);
+		ILI9341_Clip_Half_Plane(-Sector->End_X, -Sector->End_Y, Row, 0, &Lo, &Hi);
+		ILI9341_Fill_Clipped(X + Lo, Y + Row, X + Hi, Y + Row, Colour);
+		return;
+	}
+
+	//WIDER: EVERYTHING EXCEPT THE GAP FROM THE END CLOCKWISE TO THE START, AT MOST TWO PIECES
+	int32_t Gap_Lo = Lo;
+	int32_t Gap_Hi = Hi;
+	ILI9341_Clip_Half_Plane(Sector->End_X, Sector->End_Y, Row, 1, &Gap_Lo, &Gap_Hi);
+	ILI9341_Clip_Half_Plane(-Sector->Start_X, -Sector->Start_Y, Row, 1, &Gap_Lo, &Gap_Hi);
+	if(Gap_Lo > Gap_Hi)
+	{
+		ILI9341_Fill_Clipped(X + Lo, Y + Row, X + Hi, Y + Row, Colour);
+		return;
+	}
+	ILI9341_Fill_Clipped(X + Lo, Y + Row, X + Gap_Lo - 1, Y + Row, Colour);
+	ILI9341_Fill_Clipped(X + Gap_Hi + 1, Y + Row, X + Hi, Y + Row, Colour);
+}
+
+/*Draws row Row of the ring between the half widths Inner (exclusive, -1 for none) and Outer, limited to the sector*/
+static void ILI9341_Fill_Ring_Row(const ILI9341_Sector_t *Sector, int32_t X, int32_t Y, int32_t Row, int32_t Outer, int32_t Inner, uint16_t Colour)
+{
+	if(Inner < 0)
+	{
+		ILI9341_Fill_Sector_Span(Sector, X, Y, Row, -Outer, Outer, Colour);
+		return;
+	}
+	ILI9341_Fill_Sector_Span(Sector, X, Y, Row, -Outer, -Inner - 1, Colour);
+	ILI9341_Fill_Sector_Span(Sector, X, Y, Row, Inner + 1, Outer, Colour);
+}
 
 /*Draw hollow circle at X,Y location with specified radius and colour. X and Y represent circles center */
 void ILI9341_Draw_Hollow_Circle(uint16_t X, uint16_t Y, uint16_t Radius, uint16_t Colour)
 {
-	int x = Radius-1;
-    int y = 0;
-    int dx = 1;
-    int dy = 1;
-    int err = dx - (Radius << 1);
-
-    while (x >= y)
-    {
-        ILI9341_Draw_Pixel(X + x, Y + y, Colour);
-        ILI9341_Draw_Pixel(X + y, Y + x, Colour);
-        ILI9341_Draw_Pixel(X - y, Y + x, Colour);
-        ILI9341_Draw_Pixel(X - x, Y + y, Colour);
-        ILI9341_Draw_Pixel(X - x, Y - y, Colour);
-        ILI9341_Draw_Pixel(X - y, Y - x, Colour);
-        ILI9341_Draw_Pixel(X + y, Y - x, Colour);
-        ILI9341_Draw_Pixel(X + x, Y - y, Colour);
-
-        if (err <= 0)
-        {
-            y++;
-            err += dy;
-            dy += 2;
-        }
-        if (err > 0)
-        {
-            x--;
-            dx += 2;
-            err += (-Radius << 1) + dx;
-        }
-    }
+	ILI9341_Draw_Quadrants(X, Y, X, Y, Radius, Radius, 0, Colour);
 }
 
 /*Draw filled circle at X,Y location with specified radius and colour. X and Y represent circles center */
 void ILI9341_Draw_Filled_Circle(uint16_t X, uint16_t Y, uint16_t Radius, uint16_t Colour)
 {
-	
-		int x = Radius;
-    int y = 0;
-    int xChange = 1 - (Radius << 1);
-    int yChange = 0;
-    int radiusError = 0;
-
-    while (x >= y)
-    {
-        for (int i = X - x; i <= X + x; i++)
-        {
-            ILI9341_Draw_Pixel(i, Y + y,Colour);
-            ILI9341_Draw_Pixel(i, Y - y,Colour);
-        }
-        for (int i = X - y; i <= X + y; i++)
-        {
-            ILI9341_Draw_Pixel(i, Y + x,Colour);
-            ILI9341_Draw_Pixel(i, Y - x,Colour);
-        }
-
-        y++;
-        radiusError += yChange;
-        yChange += 2;
-        if (((radiusError << 1) + xChange) > 0)
-        {
-            x--;
-            radiusError += xChange;
-            xChange += 2;
-        }
-    }
-		//Really slow implementation, will require future overhaul
-		//TODO:	https://stackoverflow.com/questions/1201200/fast-algorithm-for-drawing-filled-circles	
-}
-
-/*Draw a hollow rectangle between positions X0,Y0 and X1,Y1 with specified colour*/
-void ILI9341_Draw_Hollow_Rectangle_Coord(uint16_t X0, uint16_t Y0, uint16_t X1, uint16_t Y1, uint16_t Colour)
+	ILI9341_Draw_Quadrants(X, Y, X, Y, Radius, Radius, 1, Colour);
+}
+
+/*Draw hollow ellipse at X,Y location with radii Radius_X (horizontal), Radius_Y (vertical) and specified colour*/
+void ILI9341_Draw_Hollow_Ellipse(uint16_t X, uint16_t Y, uint16_t Radius_X, uint16_t Radius_Y, uint16_t Colour)
+{
+	ILI9341_Draw_Quadrants(X, Y, X, Y, Radius_X, Radius_Y, 0, Colour);
+}
+
+/*Draw filled ellipse at X,Y location with radii Radius_X (horizontal), Radius_Y (vertical) and specified colour*/
+void ILI9341_Draw_Filled_Ellipse(uint16_t X, uint16_t Y, uint16_t Radius_X, uint16_t Radius_Y, uint16_t Colour)
+{
+	ILI9341_Draw_Quadrants(X, Y, X, Y, Radius_X, Radius_Y, 1, Colour);
+}
+
+/*Draw an arc (ring sector) around X,Y with outer radius Radius and width Thickness, Thickness >= Radius gives a pie slice*/
+/*Angles in degrees, 0 points to the right and angles grow clockwise on the screen. The arc runs from Start_Angle clockwise*/
+/*to End_Angle, nothing is drawn if End_Angle <= Start_Angle and a full ring if they are 360 or more apart*/
+/*Example gauge: Start_Angle 135, End_Angle 405 is a 270 degree dial open at the bottom*/
+void ILI9341_Draw_Arc(uint16_t X, uint16_t Y, uint16_t Radius, uint16_t Thickness, int16_t Start_Angle, int16_t End_Angle, uint16_t Colour)
 {
-	uint16_t 	X_length = 0;
-	uint16_t 	Y_length = 0;
-	uint8_t		Negative_X = 0;
-	uint8_t 	Negative_Y = 0;
-	float 		Calc_Negative = 0;
-	
-	Calc_Negative = X1 - X0;
-	if(Calc_Negative < 0) Negative_X = 1;
-	Calc_Negative = 0;
-	
-	Calc_Negative = Y1 - Y0;
-	if(Calc_Negative < 0) Negative_Y = 1;
-	
-	
-	//DRAW HORIZONTAL!
-	if(!Negative_X)
-	{
-		X_length = X1 - X0;		
+	ILI9341_Quadrant_t Outer_Quadrant;
+	ILI9341_Quadrant_t Inner_Quadrant;
+	ILI9341_Sector_t Sector;
+
+	if((End_Angle <= Start_Angle) || (Thickness == 0)) return;
+
+	Sector.Sweep = End_Angle - Start_Angle;
+	Sector.Start_X = ILI9341_Sin_Q14(Start_Angle + 90);
+	Sector.Start_Y = ILI9341_Sin_Q14(Start_Angle);
+	Sector.End_X = ILI9341_Sin_Q14(End_Angle + 90);
+	Sector.End_Y = ILI9341_Sin_Q14(End_Angle);
+
+	//HALF WIDTHS OF THE OUTER CIRCLE AND OF THE CUT OUT INNER ONE, -1 WHERE THE ROW MISSES IT
+	int32_t Outer = ILI9341_Quadrant_Init(&Outer_Quadrant, Radius, Radius);
+	int32_t Inner = (Thickness < Radius) ? ILI9341_Quadrant_Init(&Inner_Quadrant, Radius - Thickness, Radius - Thickness) : -1;
+
+	for(int32_t Row = 0; Row <= Radius; Row++)
+	{
+		ILI9341_Fill_Ring_Row(&Sector, X, Y, Row, Outer, Inner, Colour);
+		if(Row > 0)
+		{
+			ILI9341_Fill_Ring_Row(&Sector, X, Y, -Row, Outer, Inner, Colour);
+		}
+
+		Outer = ILI9341_Quadrant_Next(&Outer_Quadrant);
+		if(Inner >= 0) Inner = ILI9341_Quadrant_Next(&Inner_Quadrant);
 	}
-	else
+}
+
+/*Draw a hollow rectangle with rounded corners between positions X0,Y0 and X1,Y1, Radius is limited to half the shorter side*/
+void ILI9341_Draw_Hollow_Round_Rectangle_Coord(uint16_t X0, uint16_t Y0, uint16_t X1, uint16_t Y1, uint16_t Radius, uint16_t Colour)
+{
+	ILI9341_Draw_Round_Rectangle(X0, Y0, X1, Y1, Radius, 0, Colour);
+}
+
+/*Draw a filled rectangle with rounded corners between positions X0,Y0 and X1,Y1, Radius is limited to half the shorter side*/
+void ILI9341_Draw_Filled_Round_Rectangle_Coord(uint16_t X0, uint16_t Y0, uint16_t X1, uint16_t Y1, uint16_t Radius, uint16_t Colour)
+{
+	ILI9341_Draw_Round_Rectangle(X0, Y0, X1, Y1, Radius, 1, Colour);
+}
+
+/*Bresenham line from X0,Y0 to X1,Y1, Skip_First leaves out the first pixel (shared corner of a polyline)*/
+/*Pixels on the same row (flat lines) or column (steep lines) are collected into one run and sent as one span*/
+/*Partly visible lines start and stop at the steps inside the clip rectangle, the pixels stay those of the whole line*/
+static void ILI9341_Draw_Line_Runs(int32_t X0, int32_t Y0, int32_t X1, int32_t Y1, uint8_t Skip_First, uint16_t Colour)
+{
+	ILI9341_Rect_t Bounds = ILI9341_Clip_Bounds();
+	uint8_t Code0 = ILI9341_Outcode(X0, Y0, &Bounds);
+	uint8_t Code1 = ILI9341_Outcode(X1, Y1, &Bounds);
+
+	//EMPTY CLIP RECTANGLE OR BOTH ENDS ON THE SAME OUTER SIDE
+	if((Bounds.X0 > Bounds.X1) || (Bounds.Y0 > Bounds.Y1) || (Code0 & Code1)) return;
+
+	//MAJOR AXIS IS THE LONGER ONE, THE MINOR COORDINATE CHANGES AT MOST ONCE PER STEP
+	uint8_t Steep = ((Y1 > Y0 ? Y1 - Y0 : Y0 - Y1) > (X1 > X0 ? X1 - X0 : X0 - X1));
+	int32_t Major = Steep ? Y0 : X0;
+	int32_t Minor = Steep ? X0 : Y0;
+	int32_t Major_End = Steep ? Y1 : X1;
+	int32_t Minor_End = Steep ? X1 : Y1;
+	int32_t Major_Step = (Major_End >= Major) ? 1 : -1;
+	int32_t Minor_Step = (Minor_End >= Minor) ? 1 : -1;
+	int32_t Delta_Major = (Major_End - Major) * Major_Step;
+	int32_t Delta_Minor = (Minor_End - Minor) * Minor_Step;
+	int32_t First = Skip_First ? 1 : 0;
+	int32_t Last = Delta_Major;
+
+	if(Code0 | Code1)
 	{
-		X_length = X0 - X1;		
+		//BOUNDS AS DISTANCES FROM THE START IN STEP DIRECTION
+		int32_t Major_Lo = Steep ? Bounds.Y0 : Bounds.X0;
+		int32_t Major_Hi = Steep ? Bounds.Y1 : Bounds.X1;
+		int32_t Minor_Lo = Steep ? Bounds.X0 : Bounds.Y0;
+		int32_t Minor_Hi = Steep ? Bounds.X1 : Bounds.Y1;
+		int32_t Near = (Major_Step > 0) ? Major_Lo - Major : Major - Major_Hi;
+		int32_t Far = (Major_Step > 0) ? Major_Hi - Major : Major - Major_Lo;
+		int32_t Minor_Near = (Minor_Step > 0) ? Minor_Lo - Minor : Minor - Minor_Hi;
+		int32_t Minor_Far = (Minor_Step > 0) ? Minor_Hi - Minor : Minor - Minor_Lo;
+
+		if(Near > First) First = Near;
+		if(Far < Last) Last = Far;
+		if(Minor_Far < 0) return;
+
+		//THE MINOR OFFSET AFTER K STEPS IS CEIL((2*K*DM - DMAJ) / (2*DMAJ)), INVERTED FOR THE FIRST AND LAST STEP
+		if(Delta_Minor == 0)
+		{
+			if(Minor_Near > 0) return;
+		}
+		else
+		{
+			if(Minor_Near > 0)
+			{
+				int32_t Step = (2*(int64_t)Delta_Major*(Minor_Near - 1) + Delta_Major) / (2*(int64_t)Delta_Minor) + 1;
+				if(Step > First) First = Step;
+			}
+			int32_t Step = (2*(int64_t)Delta_Major*Minor_Far + Delta_Major) / (2*(int64_t)Delta_Minor);
+			if(Step < Last) Last = Step;
+		}
 	}
-	ILI9341_Draw_Horizontal_Line(X0, Y0, X_length, Colour);
-	ILI9341_Draw_Horizontal_Line(X0, Y1, X_length, Colour);
-	
-	
-	
-	//DRAW VERTICAL!
-	if(!Negative_Y)
+	if(First > Last) return;
+
+	//BRESENHAM STATE AT STEP FIRST
+	int64_t Numerator = 2*(int64_t)First*Delta_Minor - Delta_Major;
+	int32_t Offset = (Numerator > 0) ? (Numerator + 2*(int64_t)Delta_Major - 1) / (2*(int64_t)Delta_Major) : 0;
+	int32_t Error = 2*Delta_Minor - Delta_Major + 2*(int64_t)First*Delta_Minor - 2*(int64_t)Delta_Major*Offset;
+	Major += First * Major_Step;
+	Minor += Offset * Minor_Step;
+	int32_t Run_Start = Major;
+
+	for(int32_t Step = First; Step <= Last; Step++)
 	{
-		Y_length = Y1 - Y0;		
+		if((Error > 0) || (Step == Last))
+		{
+			//RUN ENDS HERE, EVERY PIXEL OF IT LIES IN THE BOUNDS
+			int32_t Lo = (Run_Start < Major) ? Run_Start : Major;
+			int32_t Hi = (Run_Start < Major) ? Major : Run_Start;
+
+			if(Steep) ILI9341_Fill_Window(Minor, Lo, Minor, Hi, Colour);
+			else ILI9341_Fill_Window(Lo, Minor, Hi, Minor, Colour);
+
+			if(Error > 0)
+			{
+				Minor += Minor_Step;
+				Error -= 2*Delta_Major;
+			}
+			Run_Start = Major + Major_Step;
+		}
+		Error += 2*Delta_Minor;
+		Major += Major_Step;
 	}
-	else
+}
+
+/*Draw a straight line from X0,Y0 to X1,Y1 (both included) with specified colour, clipped to the clip rectangle*/
+void ILI9341_Draw_Line(uint16_t X0, uint16_t Y0, uint16_t X1, uint16_t Y1, uint16_t Colour)
+{
+	ILI9341_Draw_Line_Runs(X0, Y0, X1, Y1, 0, Colour);
+}
+
+/*Draw connected lines through Count points, Points holds X,Y pairs (X0, Y0, X1, Y1, ...)*/
+/*Shared corners are drawn once, a single point draws one pixel*/
+void ILI9341_Draw_Polyline(const uint16_t* Points, uint16_t Count, uint16_t Colour)
+{
+	if(Count == 0) return;
+	if(Count == 1)
 	{
-		Y_length = Y0 - Y1;		
+		ILI9341_Fill_Clipped(Points[0], Points[1], Points[0], Points[1], Colour);
+		return;
 	}
-	ILI9341_Draw_Vertical_Line(X0, Y0, Y_length, Colour);
-	ILI9341_Draw_Vertical_Line(X1, Y0, Y_length, Colour);
-	
-	if((X_length > 0)||(Y_length > 0)) 
+
+	for(uint16_t i = 1; i < Count; i++)
+	{
+		ILI9341_Draw_Line_Runs(Points[2*i - 2], Points[2*i - 1], Points[2*i], Points[2*i + 1], (i > 1), Colour);
+	}
+}
+
+/*Draw a hollow rectangle between positions X0,Y0 and X1,Y1 (both included) with specified colour*/
+void ILI9341_Draw_Hollow_Rectangle_Coord(uint16_t X0, uint16_t Y0, uint16_t X1, uint16_t Y1, uint16_t Colour)
+{
+	int32_t Left = (X0 < X1) ? X0 : X1;
+	int32_t Right = (X0 < X1) ? X1 : X0;
+	int32_t Top = (Y0 < Y1) ? Y0 : Y1;
+	int32_t Bottom = (Y0 < Y1) ? Y1 : Y0;
+
+	//TOP AND BOTTOM ROW, THE SIDES IN BETWEEN
+	ILI9341_Fill_Clipped(Left, Top, Right, Top, Colour);
+	if(Bottom > Top) ILI9341_Fill_Clipped(Left, Bottom, Right, Bottom, Colour);
+	if(Bottom - Top > 1)
 	{
-		ILI9341_Draw_Pixel(X1, Y1, Colour);
+		ILI9341_Fill_Clipped(Left, Top + 1, Left, Bottom - 1, Colour);
+		if(Right > Left) ILI9341_Fill_Clipped(Right, Top + 1, Right, Bottom - 1, Colour);
 	}
-	
 }
 
-/*Draw a filled rectangle between positions X0,Y0 and X1,Y1 with specified colour*/
+/*Draw a filled rectangle between positions X0,Y0 and X1,Y1 with specified colour, the larger X and Y are excluded*/
 void ILI9341_Draw_Filled_Rectangle_Coord(uint16_t X0, uint16_t Y0, uint16_t X1, uint16_t Y1, uint16_t Colour)
 {
-	uint16_t 	X_length = 0;
-	uint16_t 	Y_length = 0;
-	uint8_t		Negative_X = 0;
-	uint8_t 	Negative_Y = 0;
-	int32_t 	Calc_Negative = 0;
-	
-	uint16_t X0_true = 0;
-	uint16_t Y0_true = 0;
-	
-	Calc_Negative = X1 - X0;
-	if(Calc_Negative < 0) Negative_X = 1;
-	Calc_Negative = 0;
-	
-	Calc_Negative = Y1 - Y0;
-	if(Calc_Negative < 0) Negative_Y = 1;
-	
-	
-	//DRAW HORIZONTAL!
-	if(!Negative_X)
-	{
-		X_length = X1 - X0;
-		X0_true = X0;
+	int32_t Left = (X0 < X1) ? X0 : X1;
+	int32_t Right = (X0 < X1) ? X1 : X0;
+	int32_t Top = (Y0 < Y1) ? Y0 : Y1;
+	int32_t Bottom = (Y0 < Y1) ? Y1 : Y0;
+
+	ILI9341_Fill_Clipped(Left, Top, Right - 1, Bottom - 1, Colour);
+}
+
+//WIDEST RUN OF CHARACTERS SENT IN ONE ADDRESS WINDOW
+#define TEXT_MAX_PIXELS		ILI9341_SCREEN_WIDTH
+
+//ONE RGB565 PIXEL ROW PER FONT ROW, EACH ROW IS QUEUED ONCE WITH REPEAT = SIZE
+static uint16_t Text_Rows[CHAR_HEIGHT][TEXT_MAX_PIXELS];
+
+/*Expands Length characters into the row buffers and sends them in a single address window and burst*/
+static void ILI9341_Draw_Glyphs(const char* Text, uint16_t Length, uint16_t X, uint16_t Y, uint16_t Colour, uint16_t Size, uint16_t Background_Colour)
+{
+	//STRINGS STARTING LEFT OF OR ABOVE THE CLIP RECTANGLE ARE LEFT OUT, THE RIGHT AND BOTTOM EDGE CUT THEM
+	ILI9341_Rect_t Bounds = ILI9341_Clip_Bounds();
+	if((Length == 0) || (Size == 0) || (X < Bounds.X0) || (X > Bounds.X1) || (Y < Bounds.Y0) || (Y > Bounds.Y1)) return;
+
+	uint16_t Cell_Width = CHAR_WIDTH*Size;
+	uint32_t Width = (uint32_t)Length*Cell_Width;
+	if(X + Width > (uint32_t)Bounds.X1 + 1)
+	{
+		Width = Bounds.X1 + 1 - X;
 	}
-	else
+	uint32_t Lines = (uint32_t)CHAR_HEIGHT*Size;
+	if(Y + Lines > (uint32_t)Bounds.Y1 + 1)
 	{
-		X_length = X0 - X1;
-		X0_true = X1;
+		Lines = Bounds.Y1 + 1 - Y;
 	}
-	
-	//DRAW VERTICAL!
-	if(!Negative_Y)
+
+	//ROWS OF THE PREVIOUS STRING MAY STILL BE IN FLIGHT
+	ILI9341_DMA_Wait();
+
+	for(uint16_t Col = 0; Col < Width; Col++)
 	{
-		Y_length = Y1 - Y0;
-		Y0_true = Y0;		
+		uint8_t function_char = Text[Col / Cell_Width];
+		function_char = (function_char < ' ') ? 0 : function_char - 32;
+		uint8_t Bits = font[function_char][(Col % Cell_Width) / Size];
+
+		for(uint8_t Row = 0; Row < CHAR_HEIGHT; Row++)
+		{
+			Text_Rows[Row][Col] = (Bits & (1<<Row)) ? Colour : Background_Colour;
+		}
 	}
-	else
+
+	ILI9341_Set_Address(X, Y, X+Width-1, Y+Lines-1);
+	for(uint8_t Row = 0; (Row < CHAR_HEIGHT) && (Lines > 0); Row++)
 	{
-		Y_length = Y0 - Y1;
-		Y0_true = Y1;	
+		uint16_t Repeat = (Lines < Size) ? Lines : Size;
+		ILI9341_DMA_Transmit_Pixels(Text_Rows[Row], Width, Repeat);
+		Lines -= Repeat;
 	}
-	
-	ILI9341_Draw_Rectangle(X0_true, Y0_true, X_length, Y_length, Colour);	
 }
 
 /*Draws a character (fonts imported from fonts.h) at X,Y location with specified font colour, size and Background colour*/
 /*See fonts.h implementation of font on what is required for changing to a different font when switching fonts libraries*/
 void ILI9341_Draw_Char(char Character, uint8_t X, uint8_t Y, uint16_t Colour, uint16_t Size, uint16_t Background_Colour) 
 {
-		uint8_t 	function_char;
-    uint8_t 	i,j;
-		
-		function_char = Character;
-		
-    if (function_char < ' ') {
-        Character = 0;
-    } else {
-        function_char -= 32;
-		}
-   	
-		char temp[CHAR_WIDTH];
-		for(uint8_t k = 0; k<CHAR_WIDTH; k++)
-		{
-		temp[k] = font[function_char][k];
-		}
-		
-    // Draw pixels
-		ILI9341_Draw_Rectangle(X, Y, CHAR_WIDTH*Size, CHAR_HEIGHT*Size, Background_Colour);
-    for (j=0; j<CHAR_WIDTH; j++) {
-        for (i=0; i<CHAR_HEIGHT; i++) {
-            if (temp[j] & (1<<i)) {			
-							if(Size == 1)
-							{
-              ILI9341_Draw_Pixel(X+j, Y+i, Colour);
-							}
-							else
-							{
-							ILI9341_Draw_Rectangle(X+(j*Size), Y+(i*Size), Size, Size, Colour);
-							}
-            }						
-        }
-    }
+	PROFILE_BEGIN(PROFILE_ZONE_LCD_CHAR);
+	ILI9341_Draw_Glyphs(&Character, 1, X, Y, Colour, Size, Background_Colour);
+	PROFILE_END(PROFILE_ZONE_LCD_CHAR);
 }
 
 /*Draws an array of characters (fonts imported from fonts.h) at X,Y location with specified font colour, size and Background colour*/
 /*See fonts.h implementation of font on what is required for changing to a different font when switching fonts libraries*/
+/*All characters share one row, so the whole string is sent in one address window*/
 void ILI9341_Draw_Text(const char* Text, uint8_t X, uint8_t Y, uint16_t Colour, uint16_t Size, uint16_t Background_Colour)
 {
-    while (*Text) {
-        ILI9341_Draw_Char(*Text++, X, Y, Colour, Size, Background_Colour);
-        X += CHAR_WIDTH*Size;
-    }
+	uint16_t Length = 0;
+	while(Text[Length]) Length++;
+
+	ILI9341_Draw_Glyphs(Text, Length, X, Y, Colour, Size, Background_Colour);
+}
+
+//-----------------------------------
+//	Proportional fonts
+//-----------------------------------
+//
+//	A string is sent in one address window of Font->Height rows. Every row is expanded from the row-packed
+//	glyph bitmaps into one of the Text_Rows buffers while the rows before it are still in flight.
+//	With the glyph cache the glyphs of the current colour pair are expanded once into RGB565 cells, later
+//	strings send the cells as they are, one address window per glyph.
+
+//ROWS OF A FONT STRING CYCLE THROUGH THE Text_Rows BUFFERS
+#define TEXT_ROW_BUFFERS	CHAR_HEIGHT
+
+/*Glyph of Character, characters outside First..Last are drawn as First*/
+static const ILI9341_Glyph_t* ILI9341_Font_Glyph(const ILI9341_Font_t* Font, char Character)
+{
+	uint8_t Code = (uint8_t)Character;
+	if((Code < Font->First) || (Code > Font->Last)) Code = Font->First;
+
+	return &Font->Glyphs[Code - Font->First];
+}
+
+/*Width of Length characters including the spacing after every glyph*/
+static uint32_t ILI9341_Font_Width(const char* Text, uint16_t Length, const ILI9341_Font_t* Font)
+{
+	uint32_t Width = 0;
+	for(uint16_t i = 0; i < Length; i++)
+	{
+		Width += ILI9341_Font_Glyph(Font, Text[i])->Width + Font->Spacing;
+	}
+	return Width;
+}
+
+/*Expands font row Row of Length characters into Line, stops after Count pixels*/
+static void ILI9341_Expand_Font_Row(const char* Text, uint16_t Length, const ILI9341_Font_t* Font, uint8_t Row, uint16_t* Line, uint16_t Count, uint16_t Colour, uint16_t Background_Colour)
+{
+	uint16_t Col = 0;
+	for(uint16_t i = 0; (i < Length) && (Col < Count); i++)
+	{
+		const ILI9341_Glyph_t* Glyph = ILI9341_Font_Glyph(Font, Text[i]);
+		const uint8_t* Bits = &Font->Bitmap[Glyph->Offset + Row*((Glyph->Width + 7) >> 3)];
+		uint16_t End = (Col + Glyph->Width > Count) ? Count : Col + Glyph->Width;
+		uint8_t Byte = 0;
+
+		for(uint8_t Bit = 0; Col < End; Bit++, Col++)
+		{
+			if((Bit & 7) == 0) Byte = *Bits++;
+			Line[Col] = (Byte & 0x80) ? Colour : Background_Colour;
+			Byte <<= 1;
+		}
+
+		End = (Col + Font->Spacing > Count) ? Count : Col + Font->Spacing;
+		while(Col < End) Line[Col++] = Background_Colour;
+	}
+}
+
+/*Sends Length characters at X,Y row by row, Width pixels of the string and its first Rows rows are visible*/
+static void ILI9341_Draw_Font_Rows(const char* Text, uint16_t Length, uint16_t X, uint16_t Y, uint16_t Width, uint16_t Rows, const ILI9341_Font_t* Font, uint16_t Colour, uint16_t Background_Colour)
+{
+	//WAITS FOR EVERY EARLIER TRANSFER, ALL Text_Rows BUFFERS ARE FREE AFTERWARDS
+	ILI9341_Set_Address(X, Y, X+Width-1, Y+Rows-1);
+	for(uint8_t Row = 0; Row < Rows; Row++)
+	{
+		uint16_t* Line = Text_Rows[Row % TEXT_ROW_BUFFERS];
+
+		//THE ROW SENT TEXT_ROW_BUFFERS ROWS AGO USED THE SAME BUFFER
+		while(ILI9341_DMA_Pending() > TEXT_ROW_BUFFERS - 1)
+		{
+		}
+
+		ILI9341_Expand_Font_Row(Text, Length, Font, Row, Line, Width, Colour, Background_Colour);
+		ILI9341_DMA_Transmit_Pixels(Line, Width, 1);
+	}
+}
+
+#if ILI9341_GLYPH_CACHE_PIXELS > 0
+//ONE EXPANDED GLYPH, (Width+Spacing) x Height PIXELS AT Glyph_Cache[Offset]
+typedef struct
+{
+	const ILI9341_Font_t* Font;
+	uint16_t Offset;
+	char Character;
+} ILI9341_Glyph_Cell_t;
+
+static uint16_t Glyph_Cache[ILI9341_GLYPH_CACHE_PIXELS];
+static ILI9341_Glyph_Cell_t Glyph_Cells[ILI9341_GLYPH_CACHE_ENTRIES];
+static uint8_t Glyph_Cell_Count = 0;
+static uint16_t Glyph_Cache_Used = 0;
+static uint16_t Glyph_Cache_Colour = 0;
+static uint16_t Glyph_Cache_Background = 0;
+
+/*Returns the cell of Character, expands it on a miss. NULL if the cell is larger than the whole cache*/
+static const uint16_t* ILI9341_Glyph_Cell(const ILI9341_Font_t* Font, char Character, uint16_t Colour, uint16_t Background_Colour)
+{
+	if((Colour != Glyph_Cache_Colour) || (Background_Colour != Glyph_Cache_Background))
+	{
+		ILI9341_Glyph_Cache_Flush();
+		Glyph_Cache_Colour = Colour;
+		Glyph_Cache_Background = Background_Colour;
+	}
+
+	for(uint8_t i = 0; i < Glyph_Cell_Count; i++)
+	{
+		if((Glyph_Cells[i].Font == Font) && (Glyph_Cells[i].Character == Character))
+		{
+			return &Glyph_Cache[Glyph_Cells[i].Offset];
+		}
+	}
+
+	uint16_t Cell_Width = ILI9341_Font_Glyph(Font, Character)->Width + Font->Spacing;
+	uint32_t Size = (uint32_t)Cell_Width * Font->Height;
+	if(Size > ILI9341_GLYPH_CACHE_PIXELS) return NULL;
+
+	//FULL: START OVER, THE RECENT GLYPHS ARE EXPANDED AGAIN ON THEIR NEXT USE
+	if((Glyph_Cell_Count == ILI9341_GLYPH_CACHE_ENTRIES) || (Glyph_Cache_Used + Size > ILI9341_GLYPH_CACHE_PIXELS))
+	{
+		ILI9341_Glyph_Cache_Flush();
+	}
+
+	uint16_t* Cell = &Glyph_Cache[Glyph_Cache_Used];
+	for(uint8_t Row = 0; Row < Font->Height; Row++)
+	{
+		ILI9341_Expand_Font_Row(&Character, 1, Font, Row, &Cell[Row*Cell_Width], Cell_Width, Colour, Background_Colour);
+	}
+
+	Glyph_Cells[Glyph_Cell_Count].Font = Font;
+	Glyph_Cells[Glyph_Cell_Count].Offset = Glyph_Cache_Used;
+	Glyph_Cells[Glyph_Cell_Count].Character = Character;
+	Glyph_Cell_Count++;
+	Glyph_Cache_Used += Size;
+
+	return Cell;
+}
+#endif
+
+/*Drops all cached glyph cells, e.g. before the cache memory of a font is reused. Waits for cells in flight*/
+void ILI9341_Glyph_Cache_Flush(void)
+{
+#if ILI9341_GLYPH_CACHE_PIXELS > 0
+	ILI9341_DMA_Wait();
+	Glyph_Cell_Count = 0;
+	Glyph_Cache_Used = 0;
+#endif
+}
+
+/*Width of a string in Font in pixels, including the spacing after the last glyph*/
+uint16_t ILI9341_Text_Width(const char* Text, const ILI9341_Font_t* Font)
+{
+	uint16_t Length = 0;
+	while(Text[Length]) Length++;
+
+	uint32_t Width = ILI9341_Font_Width(Text, Length, Font);
+	return (Width > 0xFFFF) ? 0xFFFF : Width;
+}
+
+/*Draws a string in a proportional font at X,Y with specified font colour and background colour*/
+/*Glyphs are taken from the cache as long as they fit the clip rectangle completely, the rest is sent row by row and clipped*/
+/*Strings starting left of or above the clip rectangle are left out, the right and bottom edge cut them*/
+uint16_t ILI9341_Draw_Text_Font(const char* Text, uint16_t X, uint16_t Y, const ILI9341_Font_t* Font, uint16_t Colour, uint16_t Background_Colour)
+{
+	ILI9341_Rect_t Bounds = ILI9341_Clip_Bounds();
+	uint16_t Width = ILI9341_Text_Width(Text, Font);
+	uint16_t Length = 0;
+	while(Text[Length]) Length++;
+
+	if((Length == 0) || (X < Bounds.X0) || (X > Bounds.X1) || (Y < Bounds.Y0) || (Y > Bounds.Y1)) return Width;
+
+	uint32_t Right = Bounds.X1 + 1;
+	uint16_t Rows = ((int32_t)Y + Font->Height > Bounds.Y1 + 1) ? Bounds.Y1 + 1 - Y : Font->Height;
+
+#if ILI9341_GLYPH_CACHE_PIXELS > 0
+	if(Rows == Font->Height)
+	{
+		while(Length > 0)
+		{
+			uint16_t Cell_Width = ILI9341_Font_Glyph(Font, *Text)->Width + Font->Spacing;
+			if((Cell_Width == 0) || (X + Cell_Width > Right)) break;
+
+			const uint16_t* Cell = ILI9341_Glyph_Cell(Font, *Text, Colour, Background_Colour);
+			if(Cell == NULL) break;
+
+			ILI9341_Set_Address(X, Y, X+Cell_Width-1, Y+Font->Height-1);
+			ILI9341_DMA_Transmit_Pixels(Cell, Cell_Width*Font->Height, 1);
+			X += Cell_Width;
+			Text++;
+			Length--;
+		}
+		if((Length == 0) || (X >= Right)) return Width;
+	}
+#endif
+
+	uint32_t Visible = ILI9341_Font_Width(Text, Length, Font);
+	if(X + Visible > Right) Visible = Right - X;
+	if((Visible > 0) && (Rows > 0))
+	{
+		ILI9341_Draw_Font_Rows(Text, Length, X, Y, Visible, Rows, Font, Colour, Background_Colour);
+	}
+
+	return Width;
+}
+
+//-----------------------------------
+//	Rotated images
+//-----------------------------------
+//
+//	An image made for another rotation is sent with the controller switched to that rotation for the duration of the
+//	transfer. The frame memory keeps its content across MADCTL changes, so only the address window has to be converted
+//	(ILI9341_Rotate_Rect) and the pixels go out unchanged, no pixel is turned by the CPU and nothing else is redrawn.
+
+/*Sends the part of an image that is visible in the current rotation, Bytes: big endian byte stream instead of native pixels*/
+static void ILI9341_Blit_Rotated(const void* Data, uint16_t Width, uint16_t Height, uint8_t Image_Rotation, int16_t X, int16_t Y, uint8_t Bytes)
+{
+	uint8_t Current = ILI9341_Get_Rotation();
+	uint8_t Turns = (Image_Rotation - Current) & 3;
+	int16_t Box_W = (Turns & 1) ? Height : Width;
+	int16_t Box_H = (Turns & 1) ? Width : Height;
+
+	if((Width == 0) || (Height == 0) || (Image_Rotation > SCREEN_HORIZONTAL_2)) return;
+
+	//VISIBLE PART OF THE TURNED IMAGE IN CURRENT COORDINATES
+	ILI9341_Rect_t Bounds = ILI9341_Clip_Bounds();
+	int16_t X0 = (X < Bounds.X0) ? (int16_t)Bounds.X0 : X;
+	int16_t Y0 = (Y < Bounds.Y0) ? (int16_t)Bounds.Y0 : Y;
+	int16_t X1 = ((int32_t)X + Box_W - 1 > Bounds.X1) ? (int16_t)Bounds.X1 : X + Box_W - 1;
+	int16_t Y1 = ((int32_t)Y + Box_H - 1 > Bounds.Y1) ? (int16_t)Bounds.Y1 : Y + Box_H - 1;
+	if((X0 > X1) || (Y0 > Y1)) return;
+
+	//THE SAME AREAS IN THE IMAGE ROTATION, THE IMAGE STARTS AT THE UPPER LEFT CORNER OF ITS TURNED BOX
+	int16_t Box_X0 = X, Box_Y0 = Y, Box_X1 = X + Box_W - 1, Box_Y1 = Y + Box_H - 1;
+	ILI9341_Rotate_Rect(Current, Image_Rotation, &Box_X0, &Box_Y0, &Box_X1, &Box_Y1);
+	ILI9341_Rotate_Rect(Current, Image_Rotation, &X0, &Y0, &X1, &Y1);
+
+	uint16_t Left = X0 - Box_X0;
+	uint16_t Top = Y0 - Box_Y0;
+	uint16_t Count = X1 - X0 + 1;
+	uint16_t Rows = Y1 - Y0 + 1;
+
+	if(Turns) ILI9341_Set_Rotation(Image_Rotation);
+	ILI9341_Set_Address(X0, Y0, X1, Y1);
+
+	if(Bytes)
+	{
+		const uint8_t* Source = (const uint8_t*)Data + ((uint32_t)Top*Width + Left)*2;
+		if(Count == Width)
+		{
+			ILI9341_DMA_Transmit_Buffer(Source, (uint32_t)Count*Rows*2);
+		}
+		else for(uint16_t Row = 0; Row < Rows; Row++)
+		{
+			ILI9341_DMA_Transmit(Source + (uint32_t)Row*Width*2, Count*2, 1);
+		}
+	}
+	else
+	{
+		const uint16_t* Source = (const uint16_t*)Data + (uint32_t)Top*Width + Left;
+		if(Count == Width)
+		{
+			ILI9341_DMA_Transmit_Pixel_Buffer(Source, (uint32_t)Count*Rows);
+		}
+		else for(uint16_t Row = 0; Row < Rows; Row++)
+		{
+			ILI9341_DMA_Transmit_Pixels(Source + (uint32_t)Row*Width, Count, 1);
+		}
+	}
+
+	//MADCTL IS WRITTEN ONCE THE TRANSFER HAS DRAINED
+	if(Turns) ILI9341_Set_Rotation(Current);
+}
+
+/*Draws Width x Height native RGB565 pixels that were made for rotation Image_Rotation, upright for that rotation*/
+/*X,Y is the upper left corner of the (turned) image in the current rotation, the current rotation stays set*/
+/*Blocks until the image is sent if Image_Rotation differs from the current rotation, the pixels must stay valid until then*/
+void ILI9341_Draw_Image_Rotated(const uint16_t* Pixels, uint16_t Width, uint16_t Height, uint8_t Image_Rotation, int16_t X, int16_t Y)
+{
+	ILI9341_Blit_Rotated(Pixels, Width, Height, Image_Rotation, X, Y, 0);
 }
 
 /*Draws a full screen picture from flash. Image converted from RGB .jpeg/other to C array using online converter*/
 //USING CONVERTER: http://www.digole.com/tools/PicturetoC_Hex_converter.php
 //65K colour (2Bytes / Pixel)
+//Orientation is the rotation the picture was made for, it appears upright for it while the current rotation stays set
+//Image is streamed by DMA straight from the array, it has to stay valid until ILI9341_DMA_Busy() returns 0
 void ILI9341_Draw_Image(const char* Image_Array, uint8_t Orientation)
 {
-	if(Orientation == SCREEN_HORIZONTAL_1)
-	{
-		ILI9341_Set_Rotation(SCREEN_HORIZONTAL_1);
-		ILI9341_Set_Address(0,0,ILI9341_SCREEN_WIDTH,ILI9341_SCREEN_HEIGHT);
-			
-		HAL_GPIO_WritePin(LCD_DC_PORT, LCD_DC_PIN, GPIO_PIN_SET);
-		HAL_GPIO_WritePin(LCD_CS_PORT, LCD_CS_PIN, GPIO_PIN_RESET);
-		
-		unsigned char Temp_small_buffer[BURST_MAX_SIZE];
-		uint32_t counter = 0;
-		for(uint32_t i = 0; i < ILI9341_SCREEN_WIDTH*ILI9341_SCREEN_HEIGHT*2/BURST_MAX_SIZE; i++)
-		{			
-				for(uint32_t k = 0; k< BURST_MAX_SIZE; k++)
-				{
-					Temp_small_buffer[k]	= Image_Array[counter+k];		
-				}						
-				HAL_SPI_Transmit(HSPI_INSTANCE, (unsigned char*)Temp_small_buffer, BURST_MAX_SIZE, 10);
-				counter += BURST_MAX_SIZE;			
+	uint16_t Width = (Orientation & 1) ? ILI9341_SCREEN_WIDTH : ILI9341_SCREEN_HEIGHT;
+	uint16_t Height = (Orientation & 1) ? ILI9341_SCREEN_HEIGHT : ILI9341_SCREEN_WIDTH;
+
+	ILI9341_Blit_Rotated(Image_Array, Width, Height, Orientation, 0, 0, 1);
+}
+
+
+//-----------------------------------
+//	Sprites
+//-----------------------------------
+//
+//	The clipped sprite is sent in one address window. RGB565 rows go to the DMA straight from flash, indexed and
+//	run length coded rows are decoded into two line buffers: one row is decoded while the previous one is sent.
+
+//DECODED ROWS, ONE IS FILLED WHILE THE OTHER ONE IS IN FLIGHT
+static uint16_t Sprite_Lines[2][ILI9341_SCREEN_WIDTH];
+
+/*Decodes the palette indices From..From+Count-1 of one row, Source points to the row (RLE8: to its first packet)*/
+/*Returns the start of the next row for SPRITE_RLE8, Line may be NULL to only skip the row*/
+static const uint8_t* ILI9341_Sprite_Decode_Row(const ILI9341_Sprite_t* Sprite, const uint8_t* Source, uint16_t From, uint16_t Count, uint16_t* Line)
+{
+	const uint16_t* Palette = Sprite->Palette;
+
+	if(Sprite->Format == SPRITE_INDEX8)
+	{
+		for(uint16_t i = 0; i < Count; i++)
+		{
+			Line[i] = Palette[Source[From + i]];
 		}
-		HAL_GPIO_WritePin(LCD_CS_PORT, LCD_CS_PIN, GPIO_PIN_SET);
-	}
-	else if(Orientation == SCREEN_HORIZONTAL_2)
-	{
-		ILI9341_Set_Rotation(SCREEN_HORIZONTAL_2);
-		ILI9341_Set_Address(0,0,ILI9341_SCREEN_WIDTH,ILI9341_SCREEN_HEIGHT);
-			
-		HAL_GPIO_WritePin(LCD_DC_PORT, LCD_DC_PIN, GPIO_PIN_SET);
-		HAL_GPIO_WritePin(LCD_CS_PORT, LCD_CS_PIN, GPIO_PIN_RESET);
-		
-		unsigned char Temp_small_buffer[BURST_MAX_SIZE];
-		uint32_t counter = 0;
-		for(uint32_t i = 0; i < ILI9341_SCREEN_WIDTH*ILI9341_SCREEN_HEIGHT*2/BURST_MAX_SIZE; i++)
-		{			
-				for(uint32_t k = 0; k< BURST_MAX_SIZE; k++)
-				{
-					Temp_small_buffer[k]	= Image_Array[counter+k];		
-				}						
-				HAL_SPI_Transmit(&hspi5, (unsigned char*)Temp_small_buffer, BURST_MAX_SIZE, 10);	
-				counter += BURST_MAX_SIZE;			
+		return Source + Sprite->Width;
+	}
+
+	if(Sprite->Format == SPRITE_INDEX4)
+	{
+		for(uint16_t i = 0; i < Count; i++)
+		{
+			uint16_t Column = From + i;
+			uint8_t Pair = Source[Column >> 1];
+			Line[i] = Palette[(Column & 1) ? (Pair & 0x0F) : (Pair >> 4)];
 		}
-		HAL_GPIO_WritePin(LCD_CS_PORT, LCD_CS_PIN, GPIO_PIN_SET);
-	}
-	else if(Orientation == SCREEN_VERTICAL_2)
-	{
-		ILI9341_Set_Rotation(SCREEN_VERTICAL_2);
-		ILI9341_Set_Address(0,0,ILI9341_SCREEN_HEIGHT,ILI9341_SCREEN_WIDTH);
-			
-		HAL_GPIO_WritePin(LCD_DC_PORT, LCD_DC_PIN, GPIO_PIN_SET);
-		HAL_GPIO_WritePin(LCD_CS_PORT, LCD_CS_PIN, GPIO_PIN_RESET);
-		
-		unsigned char Temp_small_buffer[BURST_MAX_SIZE];
-		uint32_t counter = 0;
-		for(uint32_t i = 0; i < ILI9341_SCREEN_WIDTH*ILI9341_SCREEN_HEIGHT*2/BURST_MAX_SIZE; i++)
-		{			
-				for(uint32_t k = 0; k< BURST_MAX_SIZE; k++)
-				{
-					Temp_small_buffer[k]	= Image_Array[counter+k];		
-				}						
-				HAL_SPI_Transmit(&hspi5, (unsigned char*)Temp_small_buffer, BURST_MAX_SIZE, 10);	
-				counter += BURST_MAX_SIZE;			
+		return Source + ((Sprite->Width + 1) >> 1);
+	}
+
+	//SPRITE_RLE8: WALK THE PACKETS OF THE WHOLE ROW, KEEP THE VISIBLE PART
+	uint16_t Column = 0;
+	uint16_t End = From + Count;
+	while(Column < Sprite->Width)
+	{
+		uint8_t Packet = *Source++;
+		uint16_t Length = (Packet < 128) ? Packet + 1 : Packet - 127;
+		uint8_t Repeat = (Packet >= 128);
+
+		for(uint16_t i = 0; i < Length; i++, Column++)
+		{
+			uint8_t Index = Repeat ? Source[0] : Source[i];
+			if(Line && (Column >= From) && (Column < End))
+			{
+				Line[Column - From] = Palette[Index];
+			}
 		}
-		HAL_GPIO_WritePin(LCD_CS_PORT, LCD_CS_PIN, GPIO_PIN_SET);
-	}
-	else if(Orientation == SCREEN_VERTICAL_1)
-	{
-		ILI9341_Set_Rotation(SCREEN_VERTICAL_1);
-		ILI9341_Set_Address(0,0,ILI9341_SCREEN_HEIGHT,ILI9341_SCREEN_WIDTH);
-			
-		HAL_GPIO_WritePin(LCD_DC_PORT, LCD_DC_PIN, GPIO_PIN_SET);
-		HAL_GPIO_WritePin(LCD_CS_PORT, LCD_CS_PIN, GPIO_PIN_RESET);
-		
-		unsigned char Temp_small_buffer[BURST_MAX_SIZE];
-		uint32_t counter = 0;
-		for(uint32_t i = 0; i < ILI9341_SCREEN_WIDTH*ILI9341_SCREEN_HEIGHT*2/BURST_MAX_SIZE; i++)
-		{			
-				for(uint32_t k = 0; k< BURST_MAX_SIZE; k++)
-				{
-					Temp_small_buffer[k]	= Image_Array[counter+k];		
-				}						
-				HAL_SPI_Transmit(&hspi5, (unsigned char*)Temp_small_buffer, BURST_MAX_SIZE, 10);	
-				counter += BURST_MAX_SIZE;			
+		Source += Repeat ? 1 : Length;
+	}
+	return Source;
+}
+
+/*Draws a sprite at X,Y (upper left corner, may be outside the screen), only the part in the clip rectangle is sent*/
+void ILI9341_Draw_Sprite(const ILI9341_Sprite_t* Sprite, int16_t X, int16_t Y)
+{
+	//VISIBLE COLUMNS AND ROWS OF THE SPRITE
+	ILI9341_Rect_t Bounds = ILI9341_Clip_Bounds();
+	int32_t Left = (X < Bounds.X0) ? Bounds.X0 - X : 0;
+	int32_t Top = (Y < Bounds.Y0) ? Bounds.Y0 - Y : 0;
+	int32_t Right = ((int32_t)X + Sprite->Width > Bounds.X1 + 1) ? Bounds.X1 + 1 - X : Sprite->Width;
+	int32_t Bottom = ((int32_t)Y + Sprite->Height > Bounds.Y1 + 1) ? Bounds.Y1 + 1 - Y : Sprite->Height;
+	if((Left >= Right) || (Top >= Bottom)) return;
+
+	uint16_t Count = Right - Left;
+	ILI9341_Set_Address(X + Left, Y + Top, X + Right - 1, Y + Bottom - 1);
+
+	if(Sprite->Format == SPRITE_RGB565)
+	{
+		const uint16_t* Pixels = (const uint16_t*)Sprite->Data;
+
+		//FULL WIDTH VISIBLE: THE ROWS ARE CONTIGUOUS IN FLASH
+		if(Count == Sprite->Width)
+		{
+			ILI9341_DMA_Transmit_Pixel_Buffer(&Pixels[(uint32_t)Top * Sprite->Width], (uint32_t)Count * (Bottom - Top));
+			return;
 		}
-		HAL_GPIO_WritePin(LCD_CS_PORT, LCD_CS_PIN, GPIO_PIN_SET);
+		for(int32_t Row = Top; Row < Bottom; Row++)
+		{
+			ILI9341_DMA_Transmit_Pixels(&Pixels[(uint32_t)Row * Sprite->Width + Left], Count, 1);
+		}
+		return;
+	}
+
+	const uint8_t* Source = (const uint8_t*)Sprite->Data;
+	uint8_t Buffer = 0;
+
+	//INDEXED ROWS HAVE A FIXED STRIDE, RUN LENGTH CODED ROWS ABOVE THE CLIP RECTANGLE ARE DECODED AND DROPPED
+	if(Sprite->Format == SPRITE_RLE8)
+	{
+		for(int32_t Row = 0; Row < Top; Row++)
+		{
+			Source = ILI9341_Sprite_Decode_Row(Sprite, Source, 0, 0, 0);
+		}
+	}
+	else if(Sprite->Format == SPRITE_INDEX8)
+	{
+		Source += (uint32_t)Top * Sprite->Width;
+	}
+	else
+	{
+		Source += (uint32_t)Top * ((Sprite->Width + 1) >> 1);
+	}
+
+	for(int32_t Row = Top; Row < Bottom; Row++)
+	{
+		//THE BUFFER IS FREE ONCE AT MOST THE OTHER ROW IS STILL QUEUED
+		while(ILI9341_DMA_Pending() > 1)
+		{
+		}
+
+		Source = ILI9341_Sprite_Decode_Row(Sprite, Source, Left, Count, Sprite_Lines[Buffer]);
+		ILI9341_DMA_Transmit_Pixels(Sprite_Lines[Buffer], Count, 1);
+		Buffer ^= 1;
 	}
 }
 
+/*Decodes one full row of a sprite that is not SPRITE_RGB565, Source points to the row (first row: Sprite->Data)*/
+/*Returns the start of the next row*/
+const uint8_t* ILI9341_Decode_Sprite_Row(const ILI9341_Sprite_t* Sprite, const uint8_t* Source, uint16_t* Line)
+{
+	return ILI9341_Sprite_Decode_Row(Sprite, Source, 0, Sprite->Width, Line);
+}
 
+/*Expands the whole sprite into Width*Height RGB565 pixels, row by row (e.g. into a RAM copy sent in one transfer)*/
+void ILI9341_Decode_Sprite(const ILI9341_Sprite_t* Sprite, uint16_t* Pixels)
+{
+	if(Sprite->Format == SPRITE_RGB565)
+	{
+		memcpy(Pixels, Sprite->Data, (uint32_t)Sprite->Width * Sprite->Height * sizeof(uint16_t));
+		return;
+	}
+
+	const uint8_t* Source = (const uint8_t*)Sprite->Data;
+	for(uint16_t Row = 0; Row < Sprite->Height; Row++)
+	{
+		Source = ILI9341_Sprite_Decode_Row(Sprite, Source, 0, Sprite->Width, &Pixels[(uint32_t)Row * Sprite->Width]);
+	}
+}
@@ -48,20 +48,82 @@
 #define ILI9341_GFX_H
 
 #include "stm32f4xx_hal.h"
+#include <lcd/ILI9341_Fonts.h>
 
 #define HORIZONTAL_IMAGE	0
 #define VERTICAL_IMAGE		1
 
+//SPRITE FORMATS, SEE sprite_convert.py FOR THE CONVERSION FROM A PPM IMAGE
+//SPRITE_RGB565		Data: uint16_t pixels, row after row
+//SPRITE_INDEX8		Data: one palette index per pixel, row after row
+//SPRITE_INDEX4		Data: two palette indices per byte (high nibble first), every row starts on a new byte
+//SPRITE_RLE8		Data: palette indices, run length coded per row. Packet byte N < 128: N+1 literal indices follow,
+//					N >= 128: the next index repeats N-127 times. No packet crosses the end of a row
+#define SPRITE_RGB565		0
+#define SPRITE_INDEX8		1
+#define SPRITE_INDEX4		2
+#define SPRITE_RLE8			3
+
+//IMAGE OF ANY SIZE IN FLASH, PALETTE ENTRIES AND RGB565 PIXELS ARE NATIVE RGB565 VALUES
+typedef struct
+{
+	uint16_t Width;
+	uint16_t Height;
+	uint8_t Format;
+	const uint16_t* Palette;	//NULL FOR SPRITE_RGB565
+	const void* Data;
+} ILI9341_Sprite_t;
+
+//RAM CACHE OF PRE-EXPANDED RGB565 GLYPH CELLS FOR ILI9341_Draw_Text_Font(), 0 PIXELS DISABLES IT
+//	The cache holds the glyphs of the most recent colour pair, a different colour pair starts it over.
+//	Cell pixels are sent by DMA straight from the cache, so redrawing e.g. the same digits costs one
+//	address window and one transfer per glyph and no expansion at all.
+#ifndef ILI9341_GLYPH_CACHE_PIXELS
+#define ILI9341_GLYPH_CACHE_PIXELS	5120
+#endif
+#ifndef ILI9341_GLYPH_CACHE_ENTRIES
+#define ILI9341_GLYPH_CACHE_ENTRIES	32
+#endif
+
+//CLIP RECTANGLE (INCLUSIVE) FOR ALL FOLLOWING GFX CALLS, INTERSECTED WITH THE SCREEN. EVERY PRIMITIVE IS CLIPPED ONCE
+//BEFORE IT IS RASTERIZED, TEXT STARTING LEFT OF OR ABOVE IT IS LEFT OUT. ILI9341_Reset_Clip(): THE WHOLE SCREEN
+void ILI9341_Set_Clip(int16_t X0, int16_t Y0, int16_t X1, int16_t Y1);
+void ILI9341_Reset_Clip(void);
+void ILI9341_Fill_Rectangle(uint16_t X, uint16_t Y, uint16_t Width, uint16_t Height, uint16_t Colour);
+
 void ILI9341_Draw_Hollow_Circle(uint16_t X, uint16_t Y, uint16_t Radius, uint16_t Colour);
 void ILI9341_Draw_Filled_Circle(uint16_t X, uint16_t Y, uint16_t Radius, uint16_t Colour);
+void ILI9341_Draw_Hollow_Ellipse(uint16_t X, uint16_t Y, uint16_t Radius_X, uint16_t Radius_Y, uint16_t Colour);
+void ILI9341_Draw_Filled_Ellipse(uint16_t X, uint16_t Y, uint16_t Radius_X, uint16_t Radius_Y, uint16_t Colour);
+void ILI9341_Draw_Arc(uint16_t X, uint16_t Y, uint16_t Radius, uint16_t Thickness, int16_t Start_Angle, int16_t End_Angle, uint16_t Colour);
+void ILI9341_Draw_Hollow_Round_Rectangle_Coord(uint16_t X0, uint16_t Y0, uint16_t X1, uint16_t Y1, uint16_t Radius, uint16_t Colour);
+void ILI9341_Draw_Filled_Round_Rectangle_Coord(uint16_t X0, uint16_t Y0, uint16_t X1, uint16_t Y1, uint16_t Radius, uint16_t Colour);
+void ILI9341_Draw_Line(uint16_t X0, uint16_t Y0, uint16_t X1, uint16_t Y1, uint16_t Colour);
+void ILI9341_Draw_Polyline(const uint16_t* Points, uint16_t Count, uint16_t Colour);
 void ILI9341_Draw_Hollow_Rectangle_Coord(uint16_t X0, uint16_t Y0, uint16_t X1, uint16_t Y1, uint16_t Colour);
 void ILI9341_Draw_Filled_Rectangle_Coord(uint16_t X0, uint16_t Y0, uint16_t X1, uint16_t Y1, uint16_t Colour);
 void ILI9341_Draw_Char(char Character, uint8_t X, uint8_t Y, uint16_t Colour, uint16_t Size, uint16_t Background_Colour);
 void ILI9341_Draw_Text(const char* Text, uint8_t X, uint8_t Y, uint16_t Colour, uint16_t Size, uint16_t Background_Colour);
+//PROPORTIONAL FONT TEXT AT X,Y (UPPER LEFT CORNER), CLIPPED TO THE CLIP RECTANGLE, RETURNS THE WIDTH OF THE STRING IN PIXELS
+uint16_t ILI9341_Draw_Text_Font(const char* Text, uint16_t X, uint16_t Y, const ILI9341_Font_t* Font, uint16_t Colour, uint16_t Background_Colour);
+uint16_t ILI9341_Text_Width(const char* Text, const ILI9341_Font_t* Font);
+void ILI9341_Glyph_Cache_Flush(void);
 void ILI9341_Draw_Filled_Rectangle_Size_Text(uint16_t X0, uint16_t Y0, uint16_t Size_X, uint16_t Size_Y, uint16_t Colour);
 
 //USING CONVERTER: http://www.digole.com/tools/PicturetoC_Hex_converter.php
 //65K colour (2Bytes / Pixel)
 void ILI9341_Draw_Image(const char* Image_Array, uint8_t Orientation);
 
+//NATIVE RGB565 IMAGE MADE FOR ROTATION Image_Rotation, DRAWN UPRIGHT FOR IT WITHOUT CHANGING THE CURRENT ROTATION
+//X,Y IS THE UPPER LEFT CORNER OF THE TURNED IMAGE IN CURRENT COORDINATES, PARTS OUTSIDE THE CLIP RECTANGLE ARE CLIPPED
+void ILI9341_Draw_Image_Rotated(const uint16_t* Pixels, uint16_t Width, uint16_t Height, uint8_t Image_Rotation, int16_t X, int16_t Y);
+
+//SPRITE AT X,Y (UPPER LEFT CORNER), PARTS OUTSIDE THE CLIP RECTANGLE ARE CLIPPED
+void ILI9341_Draw_Sprite(const ILI9341_Sprite_t* Sprite, int16_t X, int16_t Y);
+
+//ALL PIXELS OF A SPRITE AS RGB565, ROW BY ROW, INTO Width*Height WORDS
+void ILI9341_Decode_Sprite(const ILI9341_Sprite_t* Sprite, uint16_t* Pixels);
+//ONE ROW OF AN INDEXED OR RUN LENGTH CODED SPRITE INTO Width WORDS, Source: Data FOR THE FIRST ROW, THEN THE RETURN VALUE
+const uint8_t* ILI9341_Decode_Sprite_Row(const ILI9341_Sprite_t* Sprite, const uint8_t* Source, uint16_t* Line);
+
 #endif
@@ -82,41 +82,105 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include <lcd/ILI9341_STM32_Driver.h>
+#include <osal/osal.h>
+#include <utils/utils.h>
+#include <profile/profile.h>
+#include <health/health.h>
+#include <exti/exti.h>
+#include <dma_alloc/dma_alloc.h>
+#include <pt/pt.h>
+#include <clock/clock.h>
 #include "stm32f4xx.h"
+#include <string.h>
+
+#if ILI9341_DMA_IRQ_PRIORITY < OSAL_IRQ_PRIORITY_MIN
+#error "ILI9341_DMA_IRQ_PRIORITY must allow kernel calls (OSAL_IRQ_PRIORITY_MIN)"
+#endif
 
 /* Global Variables ------------------------------------------------------------------*/
 volatile uint16_t LCD_HEIGHT = ILI9341_SCREEN_HEIGHT;
 volatile uint16_t LCD_WIDTH	 = ILI9341_SCREEN_WIDTH;
 
 SPI_HandleTypeDef hspi5;
+DMA_HandleTypeDef hdma_spi5_tx;
+DMA_HandleTypeDef hdma_spi5_rx;
+
+/* DMA transfer queue ------------------------------------------------------------------*/
+//Size counts SPI frames, bytes for 8-bit transfers and pixels for 16-bit transfers
+//Offset: frames of the current repetition already sent (blocks split for bus clients)
+typedef struct
+{
+	const void *Data;
+	uint16_t Size;
+	uint16_t Repeat;
+	uint16_t Offset;
+	uint8_t Frame16;
+} ILI9341_DMA_Transfer_t;
+
+static ILI9341_DMA_Transfer_t DMA_Queue[ILI9341_DMA_QUEUE_LENGTH];
+static volatile uint8_t DMA_Queue_Head = 0;
+static volatile uint8_t DMA_Queue_Tail = 0;
+static volatile uint8_t DMA_Active = 0;
+static void (*DMA_Complete_Callback)(void) = 0;
+//SET WHENEVER A QUEUE SLOT IS FREED OR THE QUEUE DRAINS, WAKES THE (SINGLE) WAITING CALLER
+static osal_event_t DMA_Event;
+
+/* Shared SPI5 ------------------------------------------------------------------*/
+//Bus_Client: CLIENT HOLDING THE BUS, Bus_Held: A POLLED TRANSACTION OF THE LCD HAS CS ASSERTED
+static ILI9341_Bus_Client_t *Bus_Clients[ILI9341_BUS_MAX_CLIENTS];
+static uint8_t Bus_Client_Count = 0;
+static ILI9341_Bus_Client_t *volatile Bus_Client = 0;
+static volatile uint8_t Bus_Held = 0;
+static volatile uint8_t Bus_Transfer_Active = 0;
+static uint32_t Bus_LCD_Prescaler;
+static uint16_t Block_Frames;	//FRAMES OF THE DMA BLOCK IN FLIGHT
+static volatile ILI9341_Bus_Stats_t Bus_Stats;
+
+//Burst buffer must outlive the transfer, therefore not on the stack
+static uint16_t Burst_Buffer[BURST_MAX_SIZE/2];
+static uint8_t Current_Rotation = SCREEN_VERTICAL_1;
+
+#if ILI9341_TE_ENABLE
+/* Tearing effect line ------------------------------------------------------------------*/
+//TE_Held: THE QUEUE IS BUSY BUT ITS HEAD WAITS FOR THE NEXT EDGE, TE_Sync: LARGE TRANSFERS ARE HELD BACK
+static volatile uint8_t TE_Held = 0;
+static volatile uint8_t TE_Sync = 0;
+static volatile uint32_t TE_Held_Cycles = 0;
+static volatile uint32_t TE_Last_Cycles = 0;
+static volatile uint8_t TE_In_Flight = 0;	//A TRANSFER STARTED BY AN EDGE HAS NOT DRAINED YET
+static volatile ILI9341_TE_Stats_t TE_Stats;
+static osal_event_t TE_Event;
+
+static void ILI9341_TE_Handler(void *Context);
+#endif
+
+static void ILI9341_DMA_Queue(const void *Data, uint16_t Size, uint16_t Repeat, uint8_t Frame16);
+static void ILI9341_DMA_Start_Next(void);
+static void ILI9341_SPI_Set_Frame(uint8_t Frame16);
+static void ILI9341_SPI_Set_Prescaler(uint32_t Prescaler);
+static uint8_t ILI9341_Bus_Grant(void);
+static void ILI9341_Bus_Release(void);
 
 /* Initialize GPIO */
 static
 void ILI9341_GPIO_Init(void)
 {
-	GPIO_InitTypeDef gpio;
 	__GPIOC_CLK_ENABLE();
 	__GPIOD_CLK_ENABLE();
 	__GPIOF_CLK_ENABLE();
 
-	gpio.Pin = LCD_CS_PIN;
-	gpio.Mode = GPIO_MODE_OUTPUT_PP;
-	gpio.Pull = GPIO_NOPULL;
-	gpio.Speed = GPIO_SPEED_MEDIUM;
-	HAL_GPIO_Init(LCD_CS_PORT, &gpio);
-
-	gpio.Pin = LCD_DC_PIN;
-	gpio.Mode = GPIO_MODE_OUTPUT_PP;
-	gpio.Pull = GPIO_NOPULL;
-	gpio.Speed = GPIO_SPEED_MEDIUM;
-	HAL_GPIO_Init(LCD_DC_PORT, &gpio);
+	//REGISTER MASKS FOLDED AT COMPILE TIME (modules/ll), CS RELEASED BEFORE IT BECOMES AN OUTPUT
+	LCD_CS_HIGH();
+	LL_GPIO_CONFIG(LCD_CS_PORT, LCD_CS_PIN, GPIO_MODE_OUTPUT_PP, GPIO_NOPULL, GPIO_SPEED_FREQ_MEDIUM, 0U);
+	LL_GPIO_CONFIG(LCD_DC_PORT, LCD_DC_PIN, GPIO_MODE_OUTPUT_PP, GPIO_NOPULL, GPIO_SPEED_FREQ_MEDIUM, 0U);
+	LL_GPIO_CONFIG(LCD_SPI_PORT, LCD_SPI_PINS, GPIO_MODE_AF_PP, GPIO_NOPULL, GPIO_SPEED_FREQ_MEDIUM, GPIO_AF5_SPI5);
+}
 
-	gpio.Pin = GPIO_PIN_7 | GPIO_PIN_8 | GPIO_PIN_9;
-	gpio.Mode = GPIO_MODE_AF_PP;
-	gpio.Pull = GPIO_NOPULL;
-	gpio.Speed = GPIO_SPEED_MEDIUM;
-	gpio.Alternate = GPIO_AF5_SPI5;
-	HAL_GPIO_Init(GPIOF, &gpio);
+/* Smallest SPI5 prescaler that keeps SCK at or below Max_Clock for the current PCLK2, from the rate planner */
+static
+uint32_t ILI9341_SPI_Prescaler(clock_rate_t Rate, uint32_t Max_Clock)
+{
+	return clock_plan_spi(Rate, SPI5, Max_Clock);
 }
 
 /* Initialize SPI */
@@ -131,7 +195,8 @@ void ILI9341_SPI_Init(void)
 	hspi5.Init.CLKPolarity = SPI_POLARITY_LOW;
 	hspi5.Init.CLKPhase = SPI_PHASE_1EDGE;
 	hspi5.Init.NSS = SPI_NSS_SOFT;
-	hspi5.Init.BaudRatePrescaler = SPI_BAUDRATEPRESCALER_2;
+	Bus_LCD_Prescaler = ILI9341_SPI_Prescaler(CLOCK_RATE_LCD_SPI, ILI9341_SPI_MAX_CLOCK);
+	hspi5.Init.BaudRatePrescaler = Bus_LCD_Prescaler;
 	hspi5.Init.FirstBit = SPI_FIRSTBIT_MSB;
 	hspi5.Init.TIMode = SPI_TIMODE_DISABLE;
 	hspi5.Init.CRCCalculation = SPI_CRCCALCULATION_DISABLE;
@@ -140,62 +205,607 @@ void ILI9341_SPI_Init(void)
 
 	HAL_SPI_Init(&hspi5);
 	ILI9341_GPIO_Init();
+	ILI9341_DMA_Init();
 
 
 	HAL_GPIO_WritePin(LCD_CS_PORT, LCD_CS_PIN, GPIO_PIN_RESET);	//CS OFF
 }
 
+/* Initialize the SPI5_TX stream of dma_alloc (DMA2 Stream4 Channel 2), its interrupt is dispatched there */
+void ILI9341_DMA_Init(void)
+{
+	osal_event_init(&DMA_Event);
+
+	if (dma_alloc_claim(&hdma_spi5_tx, DMA_ALLOC_REQ_SPI5_TX, DMA_ALLOC_LATENCY_BULK, HEALTH_ISR_LCD_DMA) != HAL_OK) {
+		return;
+	}
+
+	hdma_spi5_tx.Init.Direction = DMA_MEMORY_TO_PERIPH;
+	hdma_spi5_tx.Init.PeriphInc = DMA_PINC_DISABLE;
+	hdma_spi5_tx.Init.MemInc = DMA_MINC_ENABLE;
+	hdma_spi5_tx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+	hdma_spi5_tx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+	hdma_spi5_tx.Init.Mode = DMA_NORMAL;
+	hdma_spi5_tx.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+
+	HAL_DMA_Init(&hdma_spi5_tx);
+	__HAL_LINKDMA(&hspi5, hdmatx, hdma_spi5_tx);
+
+	HAL_NVIC_SetPriority(dma_alloc_get_irqn(&hdma_spi5_tx), ILI9341_DMA_IRQ_PRIORITY, 0);
+	HAL_NVIC_EnableIRQ(dma_alloc_get_irqn(&hdma_spi5_tx));
+}
+
+/* Queue a block of bytes for background transmission */
+/* Data must stay valid until the transfer has completed, Repeat sends the same block multiple times */
+void ILI9341_DMA_Transmit(const uint8_t *Data, uint16_t Size, uint16_t Repeat)
+{
+	ILI9341_DMA_Queue(Data, Size, Repeat, 0);
+}
+
+/* Queue a block of native RGB565 pixels, sent as 16-bit SPI frames without byte swapping */
+void ILI9341_DMA_Transmit_Pixels(const uint16_t *Pixels, uint16_t Count, uint16_t Repeat)
+{
+	ILI9341_DMA_Queue(Pixels, Count, Repeat, 1);
+}
+
+//INTERNAL FUNCTION, ADDS ONE ENTRY TO THE QUEUE AND STARTS IT IF THE DMA IS IDLE
+static void ILI9341_DMA_Queue(const void *Data, uint16_t Size, uint16_t Repeat, uint8_t Frame16)
+{
+	if((Size == 0) || (Repeat == 0)) return;
+
+	uint8_t next = (DMA_Queue_Tail + 1) % ILI9341_DMA_QUEUE_LENGTH;
+	while(next == DMA_Queue_Head)	//QUEUE FULL, SLEEP UNTIL A SLOT IS FREE
+	{
+		osal_event_wait(&DMA_Event, OSAL_WAIT_FOREVER);
+	}
+
+	DMA_Queue[DMA_Queue_Tail].Data = Data;
+	DMA_Queue[DMA_Queue_Tail].Size = Size;
+	DMA_Queue[DMA_Queue_Tail].Repeat = Repeat;
+	DMA_Queue[DMA_Queue_Tail].Offset = 0;
+	DMA_Queue[DMA_Queue_Tail].Frame16 = Frame16;
+
+	__disable_irq();
+	DMA_Queue_Tail = next;
+	if(!DMA_Active)
+	{
+#if ILI9341_TE_ENABLE
+		uint32_t Pixels = Frame16 ? (uint32_t)Size*Repeat : ((uint32_t)Size*Repeat)/2;
+		if(TE_Sync && (Pixels >= ILI9341_TE_SYNC_MIN_PIXELS))
+		{
+			//BUSY FROM NOW ON, THE NEXT TE EDGE STARTS THE QUEUE
+			DMA_Active = 1;
+			TE_Held = 1;
+			TE_Held_Cycles = DWT->CYCCNT;
+		}
+		else
+#endif
+		ILI9341_DMA_Start_Next();
+	}
+	__enable_irq();
+}
+
+/* Queue a buffer of arbitrary length, split into DMA sized chunks */
+void ILI9341_DMA_Transmit_Buffer(const uint8_t *Data, uint32_t Size)
+{
+	while(Size > 0)
+	{
+		uint16_t Chunk = (Size > ILI9341_DMA_MAX_CHUNK) ? ILI9341_DMA_MAX_CHUNK : Size;
+		ILI9341_DMA_Transmit(Data, Chunk, 1);
+		Data += Chunk;
+		Size -= Chunk;
+	}
+}
+
+/* Queue a pixel array of arbitrary length, split into DMA sized chunks */
+void ILI9341_DMA_Transmit_Pixel_Buffer(const uint16_t *Pixels, uint32_t Count)
+{
+	while(Count > 0)
+	{
+		uint16_t Chunk = (Count > ILI9341_DMA_MAX_CHUNK) ? ILI9341_DMA_MAX_CHUNK : Count;
+		ILI9341_DMA_Transmit_Pixels(Pixels, Chunk, 1);
+		Pixels += Chunk;
+		Count -= Chunk;
+	}
+}
+
+/* Returns 1 while transfers are pending or in flight */
+uint8_t ILI9341_DMA_Busy(void)
+{
+	return DMA_Active;
+}
+
+/* Returns the number of queued transfers including the one in flight */
+uint8_t ILI9341_DMA_Pending(void)
+{
+	return (DMA_Queue_Tail + ILI9341_DMA_QUEUE_LENGTH - DMA_Queue_Head) % ILI9341_DMA_QUEUE_LENGTH;
+}
+
+/* Blocks until every queued transfer has been sent and CS is released */
+/* Sleeps (bare metal: WFI, RTOS: blocks the task) until the DMA interrupt reports the drain */
+void ILI9341_DMA_Wait(void)
+{
+	while(DMA_Active)
+	{
+		osal_event_wait(&DMA_Event, OSAL_WAIT_FOREVER);
+	}
+}
+
+/* Register a function that is called from interrupt context whenever the queue drains */
+void ILI9341_DMA_Set_Callback(void (*Callback)(void))
+{
+	DMA_Complete_Callback = Callback;
+}
+
+/* Switches the tearing effect line on and holds large transfers back until its next edge */
+/* Returns HAL_TIMEOUT (and switches it off again) if no two edges arrive within ILI9341_TE_TIMEOUT_MS, */
+/* e.g. if the line is not wired. Needs the HAL tick, call it before the SysTick is stopped */
+HAL_StatusTypeDef ILI9341_TE_Init(void)
+{
+#if ILI9341_TE_ENABLE
+	GPIO_InitTypeDef gpio;
+	uint8_t Line = exti_pin_to_line(LCD_TE_PIN);
+
+	if(exti_register(Line, ILI9341_TE_Handler, NULL) != HAL_OK) return HAL_ERROR;
+
+	//EDGES ARE TIMESTAMPED WITH THE CYCLE COUNTER
+	utils_timebase_init();
+
+	osal_event_init(&TE_Event);
+	memset((void *)&TE_Stats, 0, sizeof(TE_Stats));
+	TE_In_Flight = 0;
+
+	__GPIOD_CLK_ENABLE();
+	gpio.Pin = LCD_TE_PIN;
+	gpio.Mode = GPIO_MODE_IT_RISING;
+	gpio.Pull = GPIO_NOPULL;
+	gpio.Speed = GPIO_SPEED_LOW;
+	HAL_GPIO_Init(LCD_TE_PORT, &gpio);
+
+	//SAME PRIORITY AS THE DMA INTERRUPT, BOTH START QUEUE ENTRIES WITHOUT PREEMPTING EACH OTHER
+	exti_enable_irq(Line, ILI9341_DMA_IRQ_PRIORITY, 0);
+
+	ILI9341_Write_Command(0x35);
+	ILI9341_Write_Data(0x00);	//V-BLANKING INFORMATION ONLY
+
+	uint32_t Start = HAL_GetTick();
+	while((TE_Stats.Frames < 2) && ((HAL_GetTick() - Start) < ILI9341_TE_TIMEOUT_MS))
+	{
+	}
+	if(TE_Stats.Frames < 2)
+	{
+		ILI9341_TE_Off();
+		return HAL_TIMEOUT;
+	}
+
+	TE_Sync = 1;
+	return HAL_OK;
+#else
+	return HAL_ERROR;
+#endif
+}
+
+/* Switches the tearing effect line off, a held back transfer is started at once */
+void ILI9341_TE_Off(void)
+{
+#if ILI9341_TE_ENABLE
+	__disable_irq();
+	TE_Sync = 0;
+	if(TE_Held)
+	{
+		TE_Held = 0;
+		ILI9341_DMA_Start_Next();
+	}
+	__enable_irq();
+
+	ILI9341_Write_Command(0x34);
+	exti_unregister(exti_pin_to_line(LCD_TE_PIN));
+#endif
+}
+
+/* Blocks until the next TE edge, e.g. to begin a sequence of small window updates in the V-blanking */
+/* Returns HAL_TIMEOUT after ILI9341_TE_TIMEOUT_MS, HAL_ERROR if the line is not in use */
+HAL_StatusTypeDef ILI9341_TE_Wait(void)
+{
+#if ILI9341_TE_ENABLE
+	if(!TE_Sync) return HAL_ERROR;
+
+	osal_event_clear(&TE_Event);
+	return osal_event_wait(&TE_Event, ILI9341_TE_TIMEOUT_MS);
+#else
+	return HAL_ERROR;
+#endif
+}
+
+/* Copies the frame rate statistics, all zero without the tearing effect line */
+void ILI9341_TE_Get_Stats(ILI9341_TE_Stats_t *Stats)
+{
+#if ILI9341_TE_ENABLE
+	__disable_irq();
+	*Stats = TE_Stats;
+	__enable_irq();
+#else
+	memset(Stats, 0, sizeof(*Stats));
+#endif
+}
+
+#if ILI9341_TE_ENABLE
+//TE EDGE (EXTI INTERRUPT): MEASURES THE REFRESH PERIOD AND STARTS A HELD BACK TRANSFER
+static void ILI9341_TE_Handler(void *Context)
+{
+	uint32_t Now = DWT->CYCCNT;
+	uint32_t Cycles_Per_Us = SystemCoreClock / 1000000;
+
+	(void)Context;
+
+	if(TE_Stats.Frames > 0)
+	{
+		uint32_t Period = (Now - TE_Last_Cycles) / Cycles_Per_Us;
+		TE_Stats.Period_Us = (TE_Stats.Period_Us == 0) ? Period : TE_Stats.Period_Us - (TE_Stats.Period_Us >> 3) + (Period >> 3);
+	}
+	TE_Last_Cycles = Now;
+	TE_Stats.Frames++;
+
+	//THE PANEL STARTS SCANNING AGAIN WHILE THE UPDATE OF THE LAST REFRESH IS STILL BEING WRITTEN
+	if(TE_In_Flight) TE_Stats.Overruns++;
+
+	if(TE_Held)
+	{
+		uint32_t Hold = (Now - TE_Held_Cycles) / Cycles_Per_Us;
+		if(Hold > TE_Stats.Max_Hold_Us) TE_Stats.Max_Hold_Us = Hold;
+
+		TE_Held = 0;
+		TE_In_Flight = 1;
+		TE_Stats.Synced_Starts++;
+		ILI9341_DMA_Start_Next();
+	}
+
+	osal_event_signal(&TE_Event);
+}
+#endif
+
+//INTERNAL FUNCTION, CALLED WITH INTERRUPTS DISABLED OR FROM THE DMA INTERRUPT
+//A PENDING BUS CLIENT GOES FIRST, THE QUEUE CONTINUES WHEN IT RELEASES THE BUS
+static void ILI9341_DMA_Start_Next(void)
+{
+	if(Bus_Client != 0)
+	{
+		if(DMA_Queue_Head != DMA_Queue_Tail) DMA_Active = 1;
+		return;
+	}
+
+	if(DMA_Queue_Head == DMA_Queue_Tail)
+	{
+		DMA_Active = 0;
+#if ILI9341_TE_ENABLE
+		TE_In_Flight = 0;
+#endif
+		LCD_CS_HIGH();
+		ILI9341_SPI_Set_Frame(0);	//COMMANDS ARE ALWAYS 8-BIT
+		if(DMA_Complete_Callback) DMA_Complete_Callback();
+		osal_event_signal(&DMA_Event);
+		ILI9341_Bus_Grant();
+		return;
+	}
+
+	DMA_Active = 1;
+	if(ILI9341_Bus_Grant())
+	{
+		Bus_Stats.Preemptions++;
+		return;
+	}
+
+	ILI9341_DMA_Transfer_t *Entry = &DMA_Queue[DMA_Queue_Head];
+	Block_Frames = Entry->Size - Entry->Offset;
+	if((Bus_Client_Count > 0) && (Block_Frames > ILI9341_BUS_MAX_BLOCK)) Block_Frames = ILI9341_BUS_MAX_BLOCK;
+
+	ILI9341_SPI_Set_Frame(Entry->Frame16);
+	LCD_DC_DATA();
+	LCD_CS_LOW();	//A PAUSE WITH CS HIGH KEEPS THE MEMORY WRITE OF THE PANEL GOING, NO NEW ADDRESS WINDOW NEEDED
+	HAL_SPI_Transmit_DMA(HSPI_INSTANCE, (uint8_t *)Entry->Data + ((uint32_t)Entry->Offset << Entry->Frame16), Block_Frames);
+}
+
+//INTERNAL FUNCTION, SETS THE SCK PRESCALER, ONLY CALLED WHILE NO TRANSFER IS RUNNING
+static void ILI9341_SPI_Set_Prescaler(uint32_t Prescaler)
+{
+	if(hspi5.Init.BaudRatePrescaler == Prescaler) return;
+
+	__HAL_SPI_DISABLE(&hspi5);
+	MODIFY_REG(hspi5.Instance->CR1, SPI_CR1_BR, Prescaler);
+	hspi5.Init.BaudRatePrescaler = Prescaler;
+}
+
+//INTERNAL FUNCTION, SWITCHES SPI5 AND ITS DMA STREAM BETWEEN 8-BIT AND 16-BIT FRAMES
+//ONLY CALLED WHILE NO TRANSFER IS RUNNING, SPI MUST BE DISABLED TO CHANGE DFF
+static void ILI9341_SPI_Set_Frame(uint8_t Frame16)
+{
+	uint32_t DataSize = Frame16 ? SPI_DATASIZE_16BIT : SPI_DATASIZE_8BIT;
+	if(hspi5.Init.DataSize == DataSize) return;
+
+	__HAL_SPI_DISABLE(&hspi5);
+	MODIFY_REG(hspi5.Instance->CR1, SPI_CR1_DFF, DataSize);
+	hspi5.Init.DataSize = DataSize;
+
+	hdma_spi5_tx.Init.PeriphDataAlignment = Frame16 ? DMA_PDATAALIGN_HALFWORD : DMA_PDATAALIGN_BYTE;
+	hdma_spi5_tx.Init.MemDataAlignment = Frame16 ? DMA_MDATAALIGN_HALFWORD : DMA_MDATAALIGN_BYTE;
+	MODIFY_REG(hdma_spi5_tx.Instance->CR, DMA_SxCR_PSIZE | DMA_SxCR_MSIZE,
+			hdma_spi5_tx.Init.PeriphDataAlignment | hdma_spi5_tx.Init.MemDataAlignment);
+}
+
+/* SPI5 TX complete: repeat the current block or move on to the next queued one */
+void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+	if(hspi != HSPI_INSTANCE) return;
+
+	ILI9341_DMA_Transfer_t *Entry = &DMA_Queue[DMA_Queue_Head];
+	Entry->Offset += Block_Frames;
+	if(Entry->Offset < Entry->Size)
+	{
+		//REST OF A SPLIT BLOCK
+	}
+	else if(Entry->Repeat > 1)
+	{
+		Entry->Offset = 0;
+		Entry->Repeat--;
+	}
+	else
+	{
+		DMA_Queue_Head = (DMA_Queue_Head + 1) % ILI9341_DMA_QUEUE_LENGTH;
+		osal_event_signal(&DMA_Event);
+	}
+	ILI9341_DMA_Start_Next();
+}
+
+/* Shared SPI5 ------------------------------------------------------------------*/
+
+/* Registers a device sharing SPI5, earlier clients have priority. Needs ILI9341_SPI_Init() */
+/* Returns HAL_BUSY without a free SPI5_RX stream, HAL_ERROR for too many clients or missing callbacks */
+HAL_StatusTypeDef ILI9341_Bus_Attach(ILI9341_Bus_Client_t *Client)
+{
+	if((Client->Grant == 0) || (Client->Done == 0) || (Client->Max_Clock == 0) ||
+	   (Bus_Client_Count >= ILI9341_BUS_MAX_CLIENTS)) return HAL_ERROR;
+
+	if(hspi5.hdmarx == 0)
+	{
+		//THE RX STREAM HAS TO KEEP UP WITH THE TX STREAM OF THE LCD, OTHERWISE SPI5 OVERRUNS
+		if(dma_alloc_claim(&hdma_spi5_rx, DMA_ALLOC_REQ_SPI5_RX, DMA_ALLOC_LATENCY_SAMPLED, HEALTH_ISR_COUNT) != HAL_OK)
+		{
+			return HAL_BUSY;
+		}
+
+		hdma_spi5_rx.Init.Direction = DMA_PERIPH_TO_MEMORY;
+		hdma_spi5_rx.Init.PeriphInc = DMA_PINC_DISABLE;
+		hdma_spi5_rx.Init.MemInc = DMA_MINC_ENABLE;
+		hdma_spi5_rx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+		hdma_spi5_rx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+		hdma_spi5_rx.Init.Mode = DMA_NORMAL;
+		hdma_spi5_rx.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+
+		HAL_DMA_Init(&hdma_spi5_rx);
+		__HAL_LINKDMA(&hspi5, hdmarx, hdma_spi5_rx);
+
+		HAL_NVIC_SetPriority(dma_alloc_get_irqn(&hdma_spi5_rx), ILI9341_DMA_IRQ_PRIORITY, 0);
+		HAL_NVIC_EnableIRQ(dma_alloc_get_irqn(&hdma_spi5_rx));
+	}
+
+	//CYCLE COUNTER FOR THE WAIT STATISTICS
+	utils_timebase_init();
+
+	Client->Prescaler = ILI9341_SPI_Prescaler(CLOCK_RATE_NONE, Client->Max_Clock);
+	Client->Pending = 0;
+	Bus_Clients[Bus_Client_Count++] = Client;
+	return HAL_OK;
+}
+
+/* Asks for SPI5, from any context: Grant is called at once if the bus is idle, otherwise after the DMA block in */
+/* flight, the polled LCD transaction or the transfers of the client holding the bus */
+void ILI9341_Bus_Request(ILI9341_Bus_Client_t *Client)
+{
+	uint32_t Primask = __get_PRIMASK();
+	uint8_t Idle;
+
+	__disable_irq();
+	if(!Client->Pending)
+	{
+		Client->Pending = 1;
+		Client->Request_Cycles = DWT->CYCCNT;
+	}
+	Idle = !DMA_Active && !Bus_Held && (Bus_Client == 0);
+#if ILI9341_TE_ENABLE
+	Idle = Idle || (TE_Held && !Bus_Held && (Bus_Client == 0));	//THE QUEUE WAITS FOR ITS EDGE, THE BUS IS FREE
+#endif
+	if(Idle) ILI9341_Bus_Grant();
+	__set_PRIMASK(Primask);
+}
+
+/* Full duplex DMA transfer of the client holding the bus, only from its Grant or Done callback */
+/* Data is sent and overwritten with the received bytes */
+HAL_StatusTypeDef ILI9341_Bus_Transfer(uint8_t *Data, uint16_t Size)
+{
+	if((Bus_Client == 0) || (hspi5.hdmarx == 0)) return HAL_ERROR;
+
+	Bus_Transfer_Active = 1;
+	if(HAL_SPI_Receive_DMA(HSPI_INSTANCE, Data, Size) != HAL_OK)
+	{
+		Bus_Transfer_Active = 0;
+		return HAL_ERROR;
+	}
+	return HAL_OK;
+}
+
+/* Copies the arbitration statistics */
+void ILI9341_Bus_Get_Stats(ILI9341_Bus_Stats_t *Stats)
+{
+	uint32_t Primask = __get_PRIMASK();
+
+	__disable_irq();
+	*Stats = Bus_Stats;
+	__set_PRIMASK(Primask);
+}
+
+//INTERNAL FUNCTION, HANDS THE BUS TO THE FIRST PENDING CLIENT, WITH INTERRUPTS DISABLED OR FROM A SPI5 INTERRUPT
+//RETURNS 1 IF A CLIENT STARTED A TRANSFER
+static uint8_t ILI9341_Bus_Grant(void)
+{
+	for(uint8_t i = 0; i < Bus_Client_Count; i++)
+	{
+		ILI9341_Bus_Client_t *Client = Bus_Clients[i];
+		if(!Client->Pending) continue;
+
+		uint32_t Wait = (DWT->CYCCNT - Client->Request_Cycles) / (SystemCoreClock / 1000000);
+		if(Wait > Bus_Stats.Max_Wait_Us) Bus_Stats.Max_Wait_Us = Wait;
+		Bus_Stats.Grants++;
+
+		Client->Pending = 0;
+		Bus_Client = Client;
+		LCD_CS_HIGH();
+		ILI9341_SPI_Set_Frame(0);
+		ILI9341_SPI_Set_Prescaler(Client->Prescaler);
+		__HAL_SPI_CLEAR_OVRFLAG(&hspi5);	//STALE BYTE OF THE LAST TRANSMIT-ONLY TRANSFER
+		Bus_Transfer_Active = 0;
+		Client->Grant(Client);
+		if(Bus_Transfer_Active) return 1;
+
+		Bus_Client = 0;
+		ILI9341_SPI_Set_Prescaler(Bus_LCD_Prescaler);
+	}
+	return 0;
+}
+
+//INTERNAL FUNCTION, END OF THE TRANSFERS OF A CLIENT: NEXT CLIENT OR REST OF THE QUEUE
+static void ILI9341_Bus_Release(void)
+{
+	Bus_Client = 0;
+	ILI9341_SPI_Set_Prescaler(Bus_LCD_Prescaler);
+
+	if(ILI9341_Bus_Grant()) return;
+#if ILI9341_TE_ENABLE
+	if(TE_Held) return;
+#endif
+	if(DMA_Active) ILI9341_DMA_Start_Next();
+}
+
+/* SPI5 transfer of a bus client complete (HAL_SPI_Receive_DMA) */
+void HAL_SPI_RxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+	ILI9341_Bus_Client_t *Client = Bus_Client;
+
+	if((hspi != HSPI_INSTANCE) || (Client == 0)) return;
+
+	Bus_Transfer_Active = 0;
+	Client->Done(Client);
+	if(!Bus_Transfer_Active) ILI9341_Bus_Release();
+}
+
 /*Send data (char) to LCD*/
 void ILI9341_SPI_Send(unsigned char SPI_Data)
 {
+	ILI9341_DMA_Wait();
+#if ILI9341_LL_ENABLE
+	ll_spi_write8((HSPI_INSTANCE)->Instance, &SPI_Data, 1);
+#else
 	HAL_SPI_Transmit(HSPI_INSTANCE, &SPI_Data, 1, 1);
+#endif
 }
 
 /* Send command (char) to LCD */
 void ILI9341_Write_Command(uint8_t Command)
 {
-	HAL_GPIO_WritePin(LCD_CS_PORT, LCD_CS_PIN, GPIO_PIN_RESET);
-	HAL_GPIO_WritePin(LCD_DC_PORT, LCD_DC_PIN, GPIO_PIN_RESET);
-	ILI9341_SPI_Send(Command);
-	HAL_GPIO_WritePin(LCD_CS_PORT, LCD_CS_PIN, GPIO_PIN_SET);
+	ILI9341_Begin_Transaction();
+	ILI9341_Transaction_Command(Command);
+	ILI9341_End_Transaction();
 }
 
 /* Send Data (char) to LCD */
 void ILI9341_Write_Data(uint8_t Data)
 {
-	HAL_GPIO_WritePin(LCD_DC_PORT, LCD_DC_PIN, GPIO_PIN_SET);
-	HAL_GPIO_WritePin(LCD_CS_PORT, LCD_CS_PIN, GPIO_PIN_RESET);
-	ILI9341_SPI_Send(Data);
-	HAL_GPIO_WritePin(LCD_CS_PORT, LCD_CS_PIN, GPIO_PIN_SET);
+	ILI9341_Begin_Transaction();
+	ILI9341_Transaction_Data(&Data, 1);
+	ILI9341_End_Transaction();
 }
 
-/* Set Address - Location block - to draw into */
-void ILI9341_Set_Address(uint16_t X1, uint16_t Y1, uint16_t X2, uint16_t Y2)
+/* Transactions ------------------------------------------------------------------*/
+//CS stays asserted from Begin to End, DC is switched per command/data block
+
+/* Wait for queued pixel data and assert CS */
+/* A bus client holding SPI5 finishes first, clients asking meanwhile wait for ILI9341_End_Transaction() */
+void ILI9341_Begin_Transaction(void)
+{
+	while(1)
+	{
+		ILI9341_DMA_Wait();
+		__disable_irq();
+		if(!DMA_Active && (Bus_Client == 0)) break;
+		__enable_irq();
+	}
+	Bus_Held = 1;
+	__enable_irq();
+	LCD_CS_LOW();
+}
+
+/* Send a command byte inside a transaction */
+void ILI9341_Transaction_Command(uint8_t Command)
 {
-	ILI9341_Write_Command(0x2A);
-	ILI9341_Write_Data(X1>>8);
-	ILI9341_Write_Data(X1);
-	ILI9341_Write_Data(X2>>8);
-	ILI9341_Write_Data(X2);
+	LCD_DC_COMMAND();
+#if ILI9341_LL_ENABLE
+	ll_spi_write8((HSPI_INSTANCE)->Instance, &Command, 1);
+#else
+	HAL_SPI_Transmit(HSPI_INSTANCE, &Command, 1, 1);
+#endif
+}
 
-	ILI9341_Write_Command(0x2B);
-	ILI9341_Write_Data(Y1>>8);
-	ILI9341_Write_Data(Y1);
-	ILI9341_Write_Data(Y2>>8);
-	ILI9341_Write_Data(Y2);
+/* Send parameter/pixel bytes inside a transaction, returns when the last byte is shifted out */
+void ILI9341_Transaction_Data(const uint8_t *Data, uint16_t Size)
+{
+	LCD_DC_DATA();
+#if ILI9341_LL_ENABLE
+	ll_spi_write8((HSPI_INSTANCE)->Instance, Data, Size);
+#else
+	HAL_SPI_Transmit(HSPI_INSTANCE, (uint8_t *)Data, Size, 1 + Size);
+#endif
+}
 
-	ILI9341_Write_Command(0x2C);
+/* Column/page window and memory write command, each parameter set packed into one 4-byte transfer */
+void ILI9341_Transaction_Address(uint16_t X1, uint16_t Y1, uint16_t X2, uint16_t Y2)
+{
+	uint8_t Column[4] = {X1>>8, X1, X2>>8, X2};
+	uint8_t Page[4] = {Y1>>8, Y1, Y2>>8, Y2};
+
+	ILI9341_Transaction_Command(0x2A);
+	ILI9341_Transaction_Data(Column, 4);
+	ILI9341_Transaction_Command(0x2B);
+	ILI9341_Transaction_Data(Page, 4);
+	ILI9341_Transaction_Command(0x2C);
+}
+
+/* Release CS and hand the bus to a waiting client */
+void ILI9341_End_Transaction(void)
+{
+	LCD_CS_HIGH();
+	__disable_irq();
+	Bus_Held = 0;
+	if(!DMA_Active) ILI9341_Bus_Grant();
+	__enable_irq();
+}
+
+/* Set Address - Location block - to draw into */
+void ILI9341_Set_Address(uint16_t X1, uint16_t Y1, uint16_t X2, uint16_t Y2)
+{
+	ILI9341_Begin_Transaction();
+	ILI9341_Transaction_Address(X1, Y1, X2, Y2);
+	ILI9341_End_Transaction();
 }
 
 /*HARDWARE RESET*/
 void ILI9341_Reset(void)
 {
+	//PANEL RESET IS WIRED TO NRST ON THE DISCOVERY BOARD. WITH A RESET PIN: LOW FOR AT LEAST 10 US,
+	//THEN 5 MS BEFORE THE FIRST COMMAND (DATASHEET MINIMUM)
 	/*
 HAL_GPIO_WritePin(LCD_RST_PORT, LCD_RST_PIN, GPIO_PIN_RESET);
-HAL_Delay(200);
-HAL_GPIO_WritePin(LCD_CS_PORT, LCD_CS_PIN, GPIO_PIN_RESET);
-HAL_Delay(200);
+utils_delay_us(10);
 HAL_GPIO_WritePin(LCD_RST_PORT, LCD_RST_PIN, GPIO_PIN_SET);	
+utils_delay_us(ILI9341_SWRESET_COLD_DELAY_US);
 	 */
 }
 
@@ -204,9 +814,9 @@ void ILI9341_Set_Rotation(uint8_t Rotation)
 {
 
 	uint8_t screen_rotation = Rotation;
+	if(Rotation <= SCREEN_HORIZONTAL_2) Current_Rotation = Rotation;
 
 	ILI9341_Write_Command(0x36);
-	HAL_Delay(1);
 
 	switch(screen_rotation)
 	{
@@ -236,149 +846,283 @@ void ILI9341_Set_Rotation(uint8_t Rotation)
 	}
 }
 
+/*Returns the rotation last set with ILI9341_Set_Rotation*/
+uint8_t ILI9341_Get_Rotation(void)
+{
+	return Current_Rotation;
+}
+
+//ADDRESS TRANSFORMS BETWEEN THE ROTATIONS
+//	The rotations are quarter turns of one frame memory: SCREEN_VERTICAL_1 -> SCREEN_HORIZONTAL_1 -> SCREEN_VERTICAL_2 ->
+//	SCREEN_HORIZONTAL_2 -> SCREEN_VERTICAL_1 each map a point (X,Y) of a W x H screen to (Y, W-1-X). A pixel can therefore
+//	be addressed in any rotation without reading the frame memory back or redrawing it. Per number of quarter turns:
+//	X' = XX*X + XY*Y + (W-1)*X_W + (H-1)*X_H, Y' = YX*X + YY*Y + (W-1)*Y_W + (H-1)*Y_H
+typedef struct
+{
+	int8_t XX, XY, X_W, X_H;
+	int8_t YX, YY, Y_W, Y_H;
+} ILI9341_Address_Transform_t;
+
+static const ILI9341_Address_Transform_t Address_Transforms[4] =
+{
+	{ 1,  0, 0, 0,    0,  1, 0, 0},	//SAME ROTATION
+	{ 0,  1, 0, 0,   -1,  0, 1, 0},	//(Y, W-1-X)
+	{-1,  0, 1, 0,    0, -1, 0, 1},	//(W-1-X, H-1-Y)
+	{ 0, -1, 0, 1,    1,  0, 0, 0},	//(H-1-Y, X)
+};
+
+/*Converts a point given in rotation From into the coordinates of the same pixel in rotation To, also off-screen points*/
+void ILI9341_Rotate_Point(uint8_t From, uint8_t To, int16_t* X, int16_t* Y)
+{
+	const ILI9341_Address_Transform_t* T = &Address_Transforms[(To - From) & 3];
+	int32_t W = (From & 1) ? ILI9341_SCREEN_WIDTH : ILI9341_SCREEN_HEIGHT;
+	int32_t H = (From & 1) ? ILI9341_SCREEN_HEIGHT : ILI9341_SCREEN_WIDTH;
+	int32_t X_In = *X;
+	int32_t Y_In = *Y;
+
+	*X = T->XX*X_In + T->XY*Y_In + (W-1)*T->X_W + (H-1)*T->X_H;
+	*Y = T->YX*X_In + T->YY*Y_In + (W-1)*T->Y_W + (H-1)*T->Y_H;
+}
+
+/*Converts the rectangle X0,Y0..X1,Y1 (corners included) from rotation From to rotation To, X0<=X1 and Y0<=Y1 afterwards*/
+void ILI9341_Rotate_Rect(uint8_t From, uint8_t To, int16_t* X0, int16_t* Y0, int16_t* X1, int16_t* Y1)
+{
+	ILI9341_Rotate_Point(From, To, X0, Y0);
+	ILI9341_Rotate_Point(From, To, X1, Y1);
+
+	if(*X0 > *X1) { int16_t T = *X0; *X0 = *X1; *X1 = T; }
+	if(*Y0 > *Y1) { int16_t T = *Y0; *Y0 = *Y1; *Y1 = T; }
+}
+
+//VERTICAL SCROLLING MOVES THE 320 FRAME MEMORY LINES OF THE PANEL: SCREEN Y IN THE VERTICAL ROTATIONS, SCREEN X IN THE HORIZONTAL ONES
+//MY (SCREEN_VERTICAL_2, SCREEN_HORIZONTAL_2) REVERSES THE LINES AGAINST THE SCREEN COORDINATE: LINE = ILI9341_SCREEN_WIDTH-1-COORDINATE
+
+/*Vertical Scrolling Definition (0x33), Top_Fixed + Scroll_Lines + Bottom_Fixed has to be ILI9341_SCREEN_WIDTH frame memory lines*/
+void ILI9341_Set_Scroll_Area(uint16_t Top_Fixed, uint16_t Scroll_Lines, uint16_t Bottom_Fixed)
+{
+	uint8_t Data[6] = {Top_Fixed>>8, Top_Fixed, Scroll_Lines>>8, Scroll_Lines, Bottom_Fixed>>8, Bottom_Fixed};
+
+	ILI9341_Begin_Transaction();
+	ILI9341_Transaction_Command(0x33);
+	ILI9341_Transaction_Data(Data, 6);
+	ILI9341_End_Transaction();
+}
+
+/*Vertical Scrolling Start Address (0x37), frame memory line shown on the first line of the scroll area*/
+/*Only the display is shifted, drawing still addresses the unshifted frame memory*/
+void ILI9341_Set_Scroll_Start(uint16_t Line)
+{
+	uint8_t Data[2] = {Line>>8, Line};
+
+	ILI9341_Begin_Transaction();
+	ILI9341_Transaction_Command(0x37);
+	ILI9341_Transaction_Data(Data, 2);
+	ILI9341_End_Transaction();
+}
+
 /*Enable LCD display*/
 void ILI9341_Enable(void)
 {
 	//HAL_GPIO_WritePin(LCD_RST_PORT, LCD_RST_PIN, GPIO_PIN_SET);
 }
 
-/*Initialize LCD display*/
-void ILI9341_Init(void)
+//INIT SEQUENCE: COMMAND, PARAMETER COUNT, PARAMETERS, WAIT AFTER THE COMMAND IN US
+//ENTRIES WITHOUT A WAIT ARE SENT BACK TO BACK IN ONE TRANSACTION (CS STAYS LOW, NO PER-BYTE CALL)
+typedef struct
+{
+	uint8_t Command;
+	uint8_t Length;
+	uint8_t Data[15];
+	uint16_t Delay_Us;
+} ILI9341_Init_Command_t;
+
+static const ILI9341_Init_Command_t Init_Sequence[] =
+{
+	{0xCB, 5, {0x39, 0x2C, 0x00, 0x34, 0x02}, 0},		//POWER CONTROL A
+	{0xCF, 3, {0x00, 0xC1, 0x30}, 0},					//POWER CONTROL B
+	{0xE8, 3, {0x85, 0x00, 0x78}, 0},					//DRIVER TIMING CONTROL A
+	{0xEA, 2, {0x00, 0x00}, 0},							//DRIVER TIMING CONTROL B
+	{0xED, 4, {0x64, 0x03, 0x12, 0x81}, 0},				//POWER ON SEQUENCE CONTROL
+	{0xF7, 1, {0x20}, 0},								//PUMP RATIO CONTROL
+	{0xC0, 1, {0x23}, 0},								//POWER CONTROL,VRH[5:0]
+	{0xC1, 1, {0x10}, 0},								//POWER CONTROL,SAP[2:0];BT[3:0]
+	{0xC5, 2, {0x3E, 0x28}, 0},							//VCM CONTROL
+	{0xC7, 1, {0x86}, 0},								//VCM CONTROL 2
+	{0x36, 1, {0x48}, 0},								//MEMORY ACCESS CONTROL
+	{0x3A, 1, {0x55}, 0},								//PIXEL FORMAT
+	{0xB1, 2, {0x00, 0x18}, 0},							//FRAME RATIO CONTROL, STANDARD RGB COLOR
+	{0xB6, 3, {0x08, 0x82, 0x27}, 0},					//DISPLAY FUNCTION CONTROL
+	{0xF2, 1, {0x00}, 0},								//3GAMMA FUNCTION DISABLE
+	{0x26, 1, {0x01}, 0},								//GAMMA CURVE SELECTED
+	{0xE0, 15, {0x0F, 0x31, 0x2B, 0x0C, 0x0E, 0x08, 0x4E, 0xF1,
+				0x37, 0x07, 0x10, 0x03, 0x0E, 0x09, 0x00}, 0},	//POSITIVE GAMMA CORRECTION
+	{0xE1, 15, {0x00, 0x0E, 0x14, 0x03, 0x11, 0x07, 0x31, 0xC1,
+				0x48, 0x08, 0x0F, 0x0C, 0x31, 0x36, 0x0F}, 0},	//NEGATIVE GAMMA CORRECTION
+	{0x11, 0, {0}, ILI9341_SLPOUT_DELAY_US},			//EXIT SLEEP
+	{0x29, 0, {0}, 0},									//TURN ON DISPLAY
+};
+
+#define INIT_SEQUENCE_LENGTH	(sizeof(Init_Sequence)/sizeof(Init_Sequence[0]))
+
+//STATE OF ILI9341_Init_Thread ACROSS ITS WAITS, ONE PANEL
+static uint16_t Init_Index;
+static uint32_t Init_Wait_Us;
+
+//SLEEP IN STATE AND HAL TICK OF THE LAST SLEEP IN OR SLEEP OUT
+static volatile uint8_t Sleeping;
+static uint32_t Sleep_Tick;
+
+/*Send the entries from Start in one transaction up to and including the first one with a wait, returns the next entry*/
+static uint16_t ILI9341_Send_Run(const ILI9341_Init_Command_t* Sequence, uint16_t Start, uint16_t Count)
 {
+	uint16_t i = Start;
+
+	ILI9341_Begin_Transaction();
+	while(i < Count)
+	{
+		ILI9341_Transaction_Command(Sequence[i].Command);
+		if(Sequence[i].Length != 0)
+		{
+			ILI9341_Transaction_Data(Sequence[i].Data, Sequence[i].Length);
+		}
+		if(Sequence[i++].Delay_Us != 0)
+		{
+			break;
+		}
+	}
+	ILI9341_End_Transaction();
+
+	return i;
+}
+
+/*Initialize LCD display as protothread: returns at the reset and sleep out waits instead of blocking*/
+/*Call until it returns PT_ENDED (PT_INIT first), e.g. while other peripherals are set up*/
+pt_state_t ILI9341_Init_Thread(pt_t* Pt)
+{
+	PT_BEGIN(Pt);
 
 	ILI9341_Enable();
 	ILI9341_SPI_Init();
 	ILI9341_Reset();
 
 	//SOFTWARE RESET
+	//AFTER POWER-UP OR NRST (THE PANEL RESET IS WIRED TO NRST ON THE DISCOVERY BOARD) THE PANEL IS IN SLEEP IN,
+	//THE FACTORY DEFAULTS ARE LOADED WITHIN 5 MS. A SOFTWARE OR WATCHDOG RESET LEAVES IT IN SLEEP OUT, SLEEP OUT
+	//IS THEN ONLY ALLOWED 120 MS AFTER THE RESET. THE RESET FLAGS ARE NOT CLEARED, A STALE FLAG ONLY COSTS THE LONG WAIT
 	ILI9341_Write_Command(0x01);
-	HAL_Delay(1000);
-
-	//POWER CONTROL A
-	ILI9341_Write_Command(0xCB);
-	ILI9341_Write_Data(0x39);
-	ILI9341_Write_Data(0x2C);
-	ILI9341_Write_Data(0x00);
-	ILI9341_Write_Data(0x34);
-	ILI9341_Write_Data(0x02);
+	if(__HAL_RCC_GET_FLAG(RCC_FLAG_SFTRST) || __HAL_RCC_GET_FLAG(RCC_FLAG_IWDGRST) ||
+	   __HAL_RCC_GET_FLAG(RCC_FLAG_WWDGRST) || __HAL_RCC_GET_FLAG(RCC_FLAG_LPWRRST))
+	{
+		Init_Wait_Us = ILI9341_SWRESET_DELAY_US;
+	}
+	else
+	{
+		Init_Wait_Us = ILI9341_SWRESET_COLD_DELAY_US;
+	}
+	PT_DELAY_US(Pt, Init_Wait_Us);
 
-	//POWER CONTROL B
-	ILI9341_Write_Command(0xCF);
-	ILI9341_Write_Data(0x00);
-	ILI9341_Write_Data(0xC1);
-	ILI9341_Write_Data(0x30);
+	//ONE TRANSACTION PER RUN OF ENTRIES WITHOUT A WAIT
+	for(Init_Index = 0; Init_Index < INIT_SEQUENCE_LENGTH; )
+	{
+		Init_Index = ILI9341_Send_Run(Init_Sequence, Init_Index, INIT_SEQUENCE_LENGTH);
+		Init_Wait_Us = Init_Sequence[Init_Index - 1].Delay_Us;
+		PT_DELAY_US(Pt, Init_Wait_Us);
+	}
 
-	//DRIVER TIMING CONTROL A
-	ILI9341_Write_Command(0xE8);
-	ILI9341_Write_Data(0x85);
-	ILI9341_Write_Data(0x00);
-	ILI9341_Write_Data(0x78);
+	Sleeping = 0;
+	Sleep_Tick = HAL_GetTick();
 
-	//DRIVER TIMING CONTROL B
-	ILI9341_Write_Command(0xEA);
-	ILI9341_Write_Data(0x00);
-	ILI9341_Write_Data(0x00);
+	//STARTING ROTATION
+	ILI9341_Set_Rotation(SCREEN_VERTICAL_1);
 
-	//POWER ON SEQUENCE CONTROL
-	ILI9341_Write_Command(0xED);
-	ILI9341_Write_Data(0x64);
-	ILI9341_Write_Data(0x03);
-	ILI9341_Write_Data(0x12);
-	ILI9341_Write_Data(0x81);
+	PT_END(Pt);
+}
 
-	//PUMP RATIO CONTROL
-	ILI9341_Write_Command(0xF7);
-	ILI9341_Write_Data(0x20);
+/*Initialize LCD display, blocks through the waits*/
+void ILI9341_Init(void)
+{
+	pt_t Pt;
 
-	//POWER CONTROL,VRH[5:0]
-	ILI9341_Write_Command(0xC0);
-	ILI9341_Write_Data(0x23);
+	PT_RUN(&Pt, ILI9341_Init_Thread(&Pt));
+}
 
-	//POWER CONTROL,SAP[2:0];BT[3:0]
-	ILI9341_Write_Command(0xC1);
-	ILI9341_Write_Data(0x10);
+/*Switch the panel to the RGB interface, pixel data is then supplied by the LTDC*/
+/*Call after ILI9341_Init, the SPI link stays usable for register access only*/
+void ILI9341_Enable_RGB_Interface(void)
+{
+	//RGB INTERFACE SIGNAL CONTROL, DE MODE, FALLING DOTCLK
+	ILI9341_Write_Command(0xB0);
+	ILI9341_Write_Data(0xC2);
 
-	//VCM CONTROL
-	ILI9341_Write_Command(0xC5);
-	ILI9341_Write_Data(0x3E);
-	ILI9341_Write_Data(0x28);
+	//DISPLAY FUNCTION CONTROL, 320 LINES
+	ILI9341_Write_Command(0xB6);
+	ILI9341_Write_Data(0x0A);
+	ILI9341_Write_Data(0xA7);
+	ILI9341_Write_Data(0x27);
+	ILI9341_Write_Data(0x04);
 
-	//VCM CONTROL 2
-	ILI9341_Write_Command(0xC7);
-	ILI9341_Write_Data(0x86);
+	//INTERFACE CONTROL, MEMORY WRITE THROUGH RGB INTERFACE
+	ILI9341_Write_Command(0xF6);
+	ILI9341_Write_Data(0x01);
+	ILI9341_Write_Data(0x00);
+	ILI9341_Write_Data(0x06);
 
-	//MEMORY ACCESS CONTROL
-	ILI9341_Write_Command(0x36);
-	ILI9341_Write_Data(0x48);
+	//MEMORY WRITE
+	ILI9341_Write_Command(0x2C);
+	HAL_Delay(20);
+}
 
-	//PIXEL FORMAT
-	ILI9341_Write_Command(0x3A);
-	ILI9341_Write_Data(0x55);
+/*Display Off (0x28) and Sleep In (0x10) after the queued transfers, e.g. before STOP mode*/
+/*GRAM, registers, rotation and scroll area are kept, drawing meanwhile still goes to the GRAM*/
+/*Returns HAL_BUSY within ILI9341_SLPOUT_HOLD_MS after the last sleep out (init or resume)*/
+HAL_StatusTypeDef ILI9341_Sleep(void)
+{
+	if(Sleeping) return HAL_OK;
+	if((HAL_GetTick() - Sleep_Tick) < ILI9341_SLPOUT_HOLD_MS) return HAL_BUSY;
 
-	//FRAME RATIO CONTROL, STANDARD RGB COLOR
-	ILI9341_Write_Command(0xB1);
-	ILI9341_Write_Data(0x00);
-	ILI9341_Write_Data(0x18);
+	ILI9341_Begin_Transaction();
+	ILI9341_Transaction_Command(0x28);
+	ILI9341_Transaction_Command(0x10);
+	ILI9341_End_Transaction();
 
-	//DISPLAY FUNCTION CONTROL
-	ILI9341_Write_Command(0xB6);
-	ILI9341_Write_Data(0x08);
-	ILI9341_Write_Data(0x82);
-	ILI9341_Write_Data(0x27);
+	Sleep_Tick = HAL_GetTick();
+	Sleeping = 1;
+	return HAL_OK;
+}
 
-	//3GAMMA FUNCTION DISABLE
-	ILI9341_Write_Command(0xF2);
-	ILI9341_Write_Data(0x00);
+/*Sleep Out (0x11) and Display On (0x29) as protothread: returns at the waits instead of blocking*/
+/*The previous frame is shown again after about ILI9341_SLPOUT_DELAY_US, no reset, init sequence or clear*/
+pt_state_t ILI9341_Resume_Thread(pt_t* Pt)
+{
+	PT_BEGIN(Pt);
 
-	//GAMMA CURVE SELECTED
-	ILI9341_Write_Command(0x26);
-	ILI9341_Write_Data(0x01);
+	if(!Sleeping) PT_EXIT(Pt);
 
-	//POSITIVE GAMMA CORRECTION
-	ILI9341_Write_Command(0xE0);
-	ILI9341_Write_Data(0x0F);
-	ILI9341_Write_Data(0x31);
-	ILI9341_Write_Data(0x2B);
-	ILI9341_Write_Data(0x0C);
-	ILI9341_Write_Data(0x0E);
-	ILI9341_Write_Data(0x08);
-	ILI9341_Write_Data(0x4E);
-	ILI9341_Write_Data(0xF1);
-	ILI9341_Write_Data(0x37);
-	ILI9341_Write_Data(0x07);
-	ILI9341_Write_Data(0x10);
-	ILI9341_Write_Data(0x03);
-	ILI9341_Write_Data(0x0E);
-	ILI9341_Write_Data(0x09);
-	ILI9341_Write_Data(0x00);
+	//A SLEEP IN RIGHT BEFORE (SHORT STOP PHASE) HAS TO FINISH FIRST
+	PT_WAIT_UNTIL(Pt, (HAL_GetTick() - Sleep_Tick) >= ILI9341_SLPIN_DELAY_MS);
 
-	//NEGATIVE GAMMA CORRECTION
-	ILI9341_Write_Command(0xE1);
-	ILI9341_Write_Data(0x00);
-	ILI9341_Write_Data(0x0E);
-	ILI9341_Write_Data(0x14);
-	ILI9341_Write_Data(0x03);
-	ILI9341_Write_Data(0x11);
-	ILI9341_Write_Data(0x07);
-	ILI9341_Write_Data(0x31);
-	ILI9341_Write_Data(0xC1);
-	ILI9341_Write_Data(0x48);
-	ILI9341_Write_Data(0x08);
-	ILI9341_Write_Data(0x0F);
-	ILI9341_Write_Data(0x0C);
-	ILI9341_Write_Data(0x31);
-	ILI9341_Write_Data(0x36);
-	ILI9341_Write_Data(0x0F);
-
-	//EXIT SLEEP
 	ILI9341_Write_Command(0x11);
-	HAL_Delay(120);
-
-	//TURN ON DISPLAY
+	PT_DELAY_US(Pt, ILI9341_SLPOUT_DELAY_US);
 	ILI9341_Write_Command(0x29);
 
-	//STARTING ROTATION
-	ILI9341_Set_Rotation(SCREEN_VERTICAL_1);
+	Sleep_Tick = HAL_GetTick();
+	Sleeping = 0;
+
+	PT_END(Pt);
+}
+
+/*Wake the panel from ILI9341_Sleep, blocks through the waits*/
+void ILI9341_Resume(void)
+{
+	pt_t Pt;
+
+	PT_RUN(&Pt, ILI9341_Resume_Thread(&Pt));
+}
+
+/*Returns 1 between ILI9341_Sleep and the end of the resume*/
+uint8_t ILI9341_Is_Sleeping(void)
+{
+	return Sleeping;
 }
 
 //INTERNAL FUNCTION OF LIBRARY, USAGE NOT RECOMENDED, USE Draw_Pixel INSTEAD
@@ -387,54 +1131,42 @@ void ILI9341_Draw_Colour(uint16_t Colour)
 {
 	//SENDS COLOUR
 	unsigned char TempBuffer[2] = {Colour>>8, Colour};
-	HAL_GPIO_WritePin(LCD_DC_PORT, LCD_DC_PIN, GPIO_PIN_SET);
-	HAL_GPIO_WritePin(LCD_CS_PORT, LCD_CS_PIN, GPIO_PIN_RESET);
-	HAL_SPI_Transmit(HSPI_INSTANCE, TempBuffer, 2, 1);
-	HAL_GPIO_WritePin(LCD_CS_PORT, LCD_CS_PIN, GPIO_PIN_SET);
+	ILI9341_Begin_Transaction();
+	ILI9341_Transaction_Data(TempBuffer, 2);
+	ILI9341_End_Transaction();
 }
 
 //INTERNAL FUNCTION OF LIBRARY
 /*Sends block colour information to LCD*/
+/*Returns as soon as the transfer is queued, SPI5 shifts the data out via DMA in the background*/
 void ILI9341_Draw_Colour_Burst(uint16_t Colour, uint32_t Size)
 {
-	//SENDS COLOUR
-	uint32_t Buffer_Size = 0;
-	if((Size*2) < BURST_MAX_SIZE)
-	{
-		Buffer_Size = Size;
-	}
-	else
-	{
-		Buffer_Size = BURST_MAX_SIZE;
-	}
+	PROFILE_BEGIN(PROFILE_ZONE_LCD_BURST);
 
-	HAL_GPIO_WritePin(LCD_DC_PORT, LCD_DC_PIN, GPIO_PIN_SET);
-	HAL_GPIO_WritePin(LCD_CS_PORT, LCD_CS_PIN, GPIO_PIN_RESET);
+	//BUFFER IS SHARED, WAIT UNTIL THE PREVIOUS BURST IS OUT
+	ILI9341_DMA_Wait();
 
-	unsigned char chifted = 	Colour>>8;;
-	unsigned char burst_buffer[Buffer_Size];
-	for(uint32_t j = 0; j < Buffer_Size; j+=2)
+	//16-BIT FRAMES, THE COLOUR IS STORED AS IS
+	const uint32_t Block_Pixels = BURST_MAX_SIZE/2;
+	for(uint32_t j = 0; j < Block_Pixels; j++)
 	{
-		burst_buffer[j] = 	chifted;
-		burst_buffer[j+1] = Colour;
+		Burst_Buffer[j] = Colour;
 	}
 
-	uint32_t Sending_Size = Size*2;
-	uint32_t Sending_in_Block = Sending_Size/Buffer_Size;
-	uint32_t Remainder_from_block = Sending_Size%Buffer_Size;
+	uint32_t Sending_in_Block = Size/Block_Pixels;
+	uint32_t Remainder_from_block = Size%Block_Pixels;
 
-	if(Sending_in_Block != 0)
+	while(Sending_in_Block != 0)
 	{
-		for(uint32_t j = 0; j < (Sending_in_Block); j++)
-		{
-			HAL_SPI_Transmit(HSPI_INSTANCE, (unsigned char *)burst_buffer, Buffer_Size, 10);
-		}
+		uint16_t Repeat = (Sending_in_Block > 0xFFFF) ? 0xFFFF : Sending_in_Block;
+		ILI9341_DMA_Transmit_Pixels(Burst_Buffer, Block_Pixels, Repeat);
+		Sending_in_Block -= Repeat;
 	}
 
 	//REMAINDER!
-	HAL_SPI_Transmit(HSPI_INSTANCE, (unsigned char *)burst_buffer, Remainder_from_block, 10);
+	ILI9341_DMA_Transmit_Pixels(Burst_Buffer, Remainder_from_block, 1);
 
-	HAL_GPIO_WritePin(LCD_CS_PORT, LCD_CS_PIN, GPIO_PIN_SET);
+	PROFILE_END(PROFILE_ZONE_LCD_BURST);
 }
 
 //FILL THE ENTIRE SCREEN WITH SELECTED COLOUR (either #define-d ones or custom 16bit)
@@ -455,45 +1187,12 @@ void ILI9341_Draw_Pixel(uint16_t X,uint16_t Y,uint16_t Colour)
 {
 	if((X >=LCD_WIDTH) || (Y >=LCD_HEIGHT)) return;	//OUT OF BOUNDS!
 
-	//ADDRESS
-	HAL_GPIO_WritePin(LCD_DC_PORT, LCD_DC_PIN, GPIO_PIN_RESET);
-	HAL_GPIO_WritePin(LCD_CS_PORT, LCD_CS_PIN, GPIO_PIN_RESET);
-	ILI9341_SPI_Send(0x2A);
-	HAL_GPIO_WritePin(LCD_DC_PORT, LCD_DC_PIN, GPIO_PIN_SET);
-	HAL_GPIO_WritePin(LCD_CS_PORT, LCD_CS_PIN, GPIO_PIN_SET);
-
-	//XDATA
-	HAL_GPIO_WritePin(LCD_CS_PORT, LCD_CS_PIN, GPIO_PIN_RESET);
-	unsigned char Temp_Buffer[4] = {X>>8,X, (X+1)>>8, (X+1)};
-	HAL_SPI_Transmit(HSPI_INSTANCE, Temp_Buffer, 4, 1);
-	HAL_GPIO_WritePin(LCD_CS_PORT, LCD_CS_PIN, GPIO_PIN_SET);
-
-	//ADDRESS
-	HAL_GPIO_WritePin(LCD_DC_PORT, LCD_DC_PIN, GPIO_PIN_RESET);
-	HAL_GPIO_WritePin(LCD_CS_PORT, LCD_CS_PIN, GPIO_PIN_RESET);
-	ILI9341_SPI_Send(0x2B);
-	HAL_GPIO_WritePin(LCD_DC_PORT, LCD_DC_PIN, GPIO_PIN_SET);
-	HAL_GPIO_WritePin(LCD_CS_PORT, LCD_CS_PIN, GPIO_PIN_SET);
-
-	//YDATA
-	HAL_GPIO_WritePin(LCD_CS_PORT, LCD_CS_PIN, GPIO_PIN_RESET);
-	unsigned char Temp_Buffer1[4] = {Y>>8,Y, (Y+1)>>8, (Y+1)};
-	HAL_SPI_Transmit(HSPI_INSTANCE, Temp_Buffer1, 4, 1);
-	HAL_GPIO_WritePin(LCD_CS_PORT, LCD_CS_PIN, GPIO_PIN_SET);
-
-	//ADDRESS
-	HAL_GPIO_WritePin(LCD_DC_PORT, LCD_DC_PIN, GPIO_PIN_RESET);
-	HAL_GPIO_WritePin(LCD_CS_PORT, LCD_CS_PIN, GPIO_PIN_RESET);
-	ILI9341_SPI_Send(0x2C);
-	HAL_GPIO_WritePin(LCD_DC_PORT, LCD_DC_PIN, GPIO_PIN_SET);
-	HAL_GPIO_WritePin(LCD_CS_PORT, LCD_CS_PIN, GPIO_PIN_SET);
-
-	//COLOUR
-	HAL_GPIO_WritePin(LCD_CS_PORT, LCD_CS_PIN, GPIO_PIN_RESET);
-	unsigned char Temp_Buffer2[2] = {Colour>>8, Colour};
-	HAL_SPI_Transmit(HSPI_INSTANCE, Temp_Buffer2, 2, 1);
-	HAL_GPIO_WritePin(LCD_CS_PORT, LCD_CS_PIN, GPIO_PIN_SET);
-
+	//ADDRESS AND COLOUR IN ONE TRANSACTION
+	unsigned char Temp_Buffer[2] = {Colour>>8, Colour};
+	ILI9341_Begin_Transaction();
+	ILI9341_Transaction_Address(X, Y, X+1, Y+1);
+	ILI9341_Transaction_Data(Temp_Buffer, 2);
+	ILI9341_End_Transaction();
 }
 
 //DRAW RECTANGLE OF SET SIZE AND HEIGTH AT X and Y POSITION WITH CUSTOM COLOUR
@@ -85,6 +85,9 @@
 #define ILI9341_STM32_DRIVER_H
 
 #include "stm32f4xx_hal.h"
+#include "pt/pt.h"
+#include "ll/ll.h"
+#include "irq/irq.h"
 
 
 #define ILI9341_SCREEN_HEIGHT 240 
@@ -94,6 +97,9 @@
 //SPI INSTANCE
 #define HSPI_INSTANCE							&hspi5
 
+//MAXIMUM SPI CLOCK (WRITE CYCLE OF THE ILI9341), PRESCALER IS PLANNED FROM PCLK2 AT INIT (clock_plan_spi)
+#define ILI9341_SPI_MAX_CLOCK					12000000
+
 //CHIP SELECT PIN AND PORT, STANDARD GPIO
 #define LCD_CS_PORT								GPIOC
 #define LCD_CS_PIN								GPIO_PIN_2
@@ -102,13 +108,65 @@
 #define LCD_DC_PORT								GPIOD
 #define LCD_DC_PIN								GPIO_PIN_13
 
+//SPI5 SCK/MISO/MOSI (PF7/PF8/PF9, AF5)
+#define LCD_SPI_PORT							GPIOF
+#define LCD_SPI_PINS							(GPIO_PIN_7 | GPIO_PIN_8 | GPIO_PIN_9)
+
 //RESET PIN AND PORT, STANDARD GPIO
 //#define	LCD_RST_PORT							GPIOC
 //#define	LCD_RST_PIN								RST_Pin
 
 
+//CS/DC CONTROL THROUGH DIRECT BSRR WRITES
+#define LCD_CS_LOW()							LL_GPIO_RESET(LCD_CS_PORT, LCD_CS_PIN)
+#define LCD_CS_HIGH()							LL_GPIO_SET(LCD_CS_PORT, LCD_CS_PIN)
+#define LCD_DC_COMMAND()						LL_GPIO_RESET(LCD_DC_PORT, LCD_DC_PIN)
+#define LCD_DC_DATA()							LL_GPIO_SET(LCD_DC_PORT, LCD_DC_PIN)
+
+//BURST BUFFER SIZE IN BYTES (BURST_MAX_SIZE/2 PIXELS)
 #define BURST_MAX_SIZE 	500
 
+//COMMAND AND PARAMETER BYTES: 1 WRITES SPI5 DR ON TXE (modules/ll), 0 HAL_SPI_Transmit WITH ITS HANDLE STATE AND TIMEOUT
+#ifndef ILI9341_LL_ENABLE
+#define ILI9341_LL_ENABLE				LL_ENABLE
+#endif
+
+//DMA TRANSFER QUEUE (SPI5_TX ON DMA2 STREAM4 CHANNEL 2)
+#define ILI9341_DMA_QUEUE_LENGTH	8
+#define ILI9341_DMA_MAX_CHUNK		0xFFFF
+#define ILI9341_DMA_IRQ_PRIORITY	IRQ_CLASS_TRANSFER
+
+//OTHER DEVICES ON SPI5 (L3GD20 GYRO): A PENDING CLIENT GETS THE BUS BEFORE THE NEXT DMA BLOCK OF THE QUEUE, CLIENTS
+//IN THE ORDER OF ILI9341_Bus_Attach(). WHILE A CLIENT IS ATTACHED, QUEUE ENTRIES ARE SENT IN BLOCKS OF AT MOST
+//ILI9341_BUS_MAX_BLOCK FRAMES (4096 PIXELS = 6 MS AT 11 MHZ), WHICH BOUNDS THE WAIT OF A CLIENT. CLIENT TRANSFERS
+//ARE FULL DUPLEX DMA IN 8-BIT FRAMES (SPI5_RX ON DMA2 STREAM3 CHANNEL 2, CLAIMED WITH THE FIRST CLIENT)
+#define ILI9341_BUS_MAX_CLIENTS		2
+#define ILI9341_BUS_MAX_BLOCK		4096
+
+//TEARING EFFECT LINE (COMMAND 0x35): ONE PULSE PER PANEL REFRESH AT THE START OF V-BLANKING, ON PD11 (LCD_TE)
+//WITH ILI9341_TE_ENABLE THE DMA QUEUE HOLDS A TRANSFER OF AT LEAST ILI9341_TE_SYNC_MIN_PIXELS THAT FINDS IT IDLE
+//BACK UNTIL THE NEXT TE EDGE, SO LARGE FILLS AND IMAGES START RIGHT AFTER THE PANEL HAS FINISHED A REFRESH.
+//THE EDGE IS ON EXTI LINE 11 (EXTI15_10, SAME PRIORITY AS THE DMA INTERRUPT), NOT TOGETHER WITH JS_UP OF THE JOYSTICK
+//OR THE F SEGMENT (PD11) OF THE ESD MODULE
+#ifndef ILI9341_TE_ENABLE
+#define ILI9341_TE_ENABLE				0
+#endif
+#define LCD_TE_PORT						GPIOD
+#define LCD_TE_PIN						GPIO_PIN_11
+#define ILI9341_TE_SYNC_MIN_PIXELS		4096
+#define ILI9341_TE_TIMEOUT_MS			50
+
+//CONTROLLER WAIT TIMES IN US (ILI9341 DATASHEET, SWRESET AND SLPOUT)
+//SWRESET: 5 MS AFTER POWER-ON OR NRST (PANEL IN SLEEP IN), 120 MS AFTER SOFTWARE AND WATCHDOG RESETS
+#define ILI9341_SWRESET_COLD_DELAY_US	5000
+#define ILI9341_SWRESET_DELAY_US	120000
+#define ILI9341_SLPOUT_DELAY_US		5000
+
+//SLEEP IN (ILI9341_Sleep): NO SLEEP OUT WITHIN 5 MS AFTER SLEEP IN, NO SLEEP IN WITHIN 120 MS AFTER SLEEP OUT
+//HAL TICKS, lowpower_stop() ADVANCES THE TICK BY THE TIME IN STOP
+#define ILI9341_SLPIN_DELAY_MS		6
+#define ILI9341_SLPOUT_HOLD_MS		121
+
 #define BLACK       0x0000      
 #define NAVY        0x000F      
 #define DARKGREEN   0x03E0      
@@ -135,17 +193,88 @@
 #define SCREEN_HORIZONTAL_2		3
 
 
+//CURRENT SCREEN SIZE, DEPENDS ON THE ROTATION
+extern volatile uint16_t LCD_HEIGHT;
+extern volatile uint16_t LCD_WIDTH;
+
+//FRAME RATE STATISTICS OF THE TEARING EFFECT LINE
+typedef struct
+{
+	uint32_t Frames;			//TE EDGES = PANEL REFRESHES SINCE ILI9341_TE_Init()
+	uint32_t Period_Us;			//PANEL REFRESH PERIOD, AVERAGED OVER ABOUT 8 FRAMES
+	uint32_t Synced_Starts;		//TRANSFERS HELD BACK AND STARTED ON A TE EDGE
+	uint32_t Overruns;			//EDGES WHILE A HELD BACK TRANSFER WAS STILL RUNNING (POSSIBLE TEARING)
+	uint32_t Max_Hold_Us;		//LONGEST TIME A TRANSFER WAITED FOR ITS EDGE
+} ILI9341_TE_Stats_t;
+
+//DEVICE SHARING SPI5 WITH THE LCD, SET UP BY ITS DRIVER. Grant AND Done RUN IN INTERRUPT CONTEXT
+//Grant: THE BUS IS FREE, ASSERT CS AND START ILI9341_Bus_Transfer() (WITHOUT A TRANSFER THE BUS IS RELEASED AGAIN)
+//Done: THE TRANSFER HAS ENDED, RELEASE CS OR CHAIN THE NEXT ILI9341_Bus_Transfer(); WITHOUT ONE THE BUS IS RELEASED
+typedef struct ILI9341_Bus_Client_s
+{
+	void (*Grant)(struct ILI9341_Bus_Client_s *Client);
+	void (*Done)(struct ILI9341_Bus_Client_s *Client);
+	uint32_t Max_Clock;			//SCK LIMIT OF THE DEVICE IN HZ
+	void *Context;
+	uint32_t Prescaler;			//INTERNAL
+	uint32_t Request_Cycles;	//INTERNAL
+	volatile uint8_t Pending;	//INTERNAL
+} ILI9341_Bus_Client_t;
+
+//ARBITRATION STATISTICS OF SPI5
+typedef struct
+{
+	uint32_t Grants;			//BUS HANDOVERS TO CLIENTS
+	uint32_t Preemptions;		//HANDOVERS BETWEEN TWO DMA BLOCKS OF THE QUEUE
+	uint32_t Max_Wait_Us;		//LONGEST TIME FROM ILI9341_Bus_Request() TO THE GRANT
+} ILI9341_Bus_Stats_t;
+
 extern SPI_HandleTypeDef hspi5;
+extern DMA_HandleTypeDef hdma_spi5_tx;
+extern DMA_HandleTypeDef hdma_spi5_rx;
 
 void ILI9341_SPI_Init(void);
+void ILI9341_DMA_Init(void);
+void ILI9341_DMA_Transmit(const uint8_t *Data, uint16_t Size, uint16_t Repeat);
+void ILI9341_DMA_Transmit_Buffer(const uint8_t *Data, uint32_t Size);
+void ILI9341_DMA_Transmit_Pixels(const uint16_t *Pixels, uint16_t Count, uint16_t Repeat);
+void ILI9341_DMA_Transmit_Pixel_Buffer(const uint16_t *Pixels, uint32_t Count);
+uint8_t ILI9341_DMA_Busy(void);
+uint8_t ILI9341_DMA_Pending(void);
+void ILI9341_DMA_Wait(void);
+void ILI9341_DMA_Set_Callback(void (*Callback)(void));
+HAL_StatusTypeDef ILI9341_TE_Init(void);
+void ILI9341_TE_Off(void);
+HAL_StatusTypeDef ILI9341_TE_Wait(void);
+void ILI9341_TE_Get_Stats(ILI9341_TE_Stats_t *Stats);
+HAL_StatusTypeDef ILI9341_Bus_Attach(ILI9341_Bus_Client_t *Client);
+void ILI9341_Bus_Request(ILI9341_Bus_Client_t *Client);
+HAL_StatusTypeDef ILI9341_Bus_Transfer(uint8_t *Data, uint16_t Size);
+void ILI9341_Bus_Get_Stats(ILI9341_Bus_Stats_t *Stats);
 void ILI9341_SPI_Send(unsigned char SPI_Data);
 void ILI9341_Write_Command(uint8_t Command);
 void ILI9341_Write_Data(uint8_t Data);
+void ILI9341_Begin_Transaction(void);
+void ILI9341_Transaction_Command(uint8_t Command);
+void ILI9341_Transaction_Data(const uint8_t *Data, uint16_t Size);
+void ILI9341_Transaction_Address(uint16_t X1, uint16_t Y1, uint16_t X2, uint16_t Y2);
+void ILI9341_End_Transaction(void);
 void ILI9341_Set_Address(uint16_t X1, uint16_t Y1, uint16_t X2, uint16_t Y2);
 void ILI9341_Reset(void);
 void ILI9341_Set_Rotation(uint8_t Rotation);
+uint8_t ILI9341_Get_Rotation(void);
+void ILI9341_Rotate_Point(uint8_t From, uint8_t To, int16_t* X, int16_t* Y);
+void ILI9341_Rotate_Rect(uint8_t From, uint8_t To, int16_t* X0, int16_t* Y0, int16_t* X1, int16_t* Y1);
+void ILI9341_Set_Scroll_Area(uint16_t Top_Fixed, uint16_t Scroll_Lines, uint16_t Bottom_Fixed);
+void ILI9341_Set_Scroll_Start(uint16_t Line);
 void ILI9341_Enable(void);
 void ILI9341_Init(void);
+pt_state_t ILI9341_Init_Thread(pt_t* Pt);
+void ILI9341_Enable_RGB_Interface(void);
+HAL_StatusTypeDef ILI9341_Sleep(void);
+pt_state_t ILI9341_Resume_Thread(pt_t* Pt);
+void ILI9341_Resume(void);
+uint8_t ILI9341_Is_Sleeping(void);
 void ILI9341_Fill_Screen(uint16_t Colour);
 void ILI9341_Draw_Colour(uint16_t Colour);
 void ILI9341_Draw_Pixel(uint16_t X,uint16_t Y,uint16_t Colour);
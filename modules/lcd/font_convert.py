@@ -0,0 +1,246 @@
+#!/usr/bin/env python3
+"""Converter from bitmap fonts to ILI9341_Font_t C sources.
+
+Sources:
+  - the 5x5 library font (5x5_font.h) at a native scale of 1, 2 or 3.
+    Scale 2 and 3 are smoothed with Scale2x / Scale3x instead of blowing
+    every pixel up to a block, so the larger sizes keep their diagonals.
+  - any BDF font (X11 bitmap fonts, exported by most font editors), glyphs
+    are placed on their baseline, the advance width becomes the glyph width.
+
+The glyphs are proportional: a glyph is as wide as its leftmost to
+rightmost lit column (5x5 font) or its advance (BDF). The digits 0-9 are
+padded to the width of the widest digit so that numbers do not jump when
+they change. The bitmaps are stored row-packed, most significant bit
+first, every row starts on a new byte (see ILI9341_Fonts.h).
+
+Several fonts can be written into one file. Only the standard library is
+needed, ILI9341_Fonts.c is generated with:
+
+    font_convert.py 5x5_font.h:1:Font_Small 5x5_font.h:2:Font_Medium \\
+                    5x5_font.h:3:Font_Large -o ILI9341_Fonts.c
+
+Usage:
+    font_convert.py SOURCE:SCALE:NAME [SOURCE:SCALE:NAME ...] [-o fonts.c]
+    (SCALE is ignored for BDF sources)
+"""
+
+import argparse
+import re
+import sys
+
+FIRST = 32
+LAST = 126
+
+
+def read_5x5(path):
+    """Returns {char: rows} of the column packed 5x5 font, rows as lists of 0/1."""
+    with open(path) as file:
+        text = file.read()
+    height = int(re.search(r"#define\s+CHAR_HEIGHT\s+(\d+)", text).group(1))
+    columns = [[int(v, 16) for v in m.split(",")]
+               for m in re.findall(r"\{\s*(0x[0-9a-fA-F]{2}(?:\s*,\s*0x[0-9a-fA-F]{2})*)\s*\}", text)]
+
+    glyphs = {}
+    for index, cols in enumerate(columns):
+        code = FIRST + index
+        if code > LAST:
+            break
+        glyphs[code] = [[(c >> row) & 1 for c in cols] for row in range(height)]
+    return glyphs
+
+
+def scale2x(rows):
+    height, width = len(rows), len(rows[0])
+    get = lambda y, x: rows[y][x] if 0 <= y < height and 0 <= x < width else 0
+    out = [[0] * (width * 2) for _ in range(height * 2)]
+    for y in range(height):
+        for x in range(width):
+            p, a, b, c, d = get(y, x), get(y - 1, x), get(y, x + 1), get(y, x - 1), get(y + 1, x)
+            out[2 * y][2 * x] = a if (c == a and c != d and a != b) else p
+            out[2 * y][2 * x + 1] = b if (a == b and a != c and b != d) else p
+            out[2 * y + 1][2 * x] = c if (d == c and d != b and c != a) else p
+            out[2 * y + 1][2 * x + 1] = d if (b == d and b != a and d != c) else p
+    return out
+
+
+def scale3x(rows):
+    height, width = len(rows), len(rows[0])
+    get = lambda y, x: rows[y][x] if 0 <= y < height and 0 <= x < width else 0
+    out = [[0] * (width * 3) for _ in range(height * 3)]
+    for y in range(height):
+        for x in range(width):
+            a, b, c = get(y - 1, x - 1), get(y - 1, x), get(y - 1, x + 1)
+            d, e, f = get(y, x - 1), get(y, x), get(y, x + 1)
+            g, h, i = get(y + 1, x - 1), get(y + 1, x), get(y + 1, x + 1)
+            cell = [e] * 9
+            if b != h and d != f:
+                cell[0] = d if d == b else e
+                cell[1] = b if (d == b and e != c) or (b == f and e != a) else e
+                cell[2] = f if b == f else e
+                cell[3] = d if (d == b and e != g) or (d == h and e != a) else e
+                cell[5] = f if (b == f and e != i) or (h == f and e != c) else e
+                cell[6] = d if d == h else e
+                cell[7] = h if (d == h and e != i) or (h == f and e != g) else e
+                cell[8] = f if h == f else e
+            for k in range(9):
+                out[3 * y + k // 3][3 * x + k % 3] = cell[k]
+    return out
+
+
+def from_5x5(path, scale):
+    """Returns height, spacing and {char: rows} of the scaled, trimmed 5x5 font."""
+    if scale not in (1, 2, 3):
+        sys.exit("%s: the 5x5 font is available at scale 1, 2 or 3" % path)
+
+    glyphs = {}
+    for code, rows in read_5x5(path).items():
+        rows = {1: lambda r: r, 2: scale2x, 3: scale3x}[scale](rows)
+        lit = [x for x in range(len(rows[0])) if any(row[x] for row in rows)]
+        if not lit:
+            # Space: half the cell
+            glyphs[code] = [[0] * (3 * scale) for _ in rows]
+            continue
+        glyphs[code] = [row[lit[0]:lit[-1] + 1] for row in rows]
+    return len(glyphs[FIRST]), scale, glyphs
+
+
+def from_bdf(path):
+    """Returns height, spacing (0, included in the advance) and {char: rows} of a BDF font."""
+    with open(path, encoding="latin-1") as file:
+        lines = file.read().split("\n")
+
+    ascent = descent = None
+    glyphs = {}
+    pos = 0
+    while pos < len(lines):
+        words = lines[pos].split()
+        pos += 1
+        if not words:
+            continue
+        if words[0] == "FONT_ASCENT":
+            ascent = int(words[1])
+        elif words[0] == "FONT_DESCENT":
+            descent = int(words[1])
+        elif words[0] == "STARTCHAR":
+            code = advance = bbx = None
+            while not lines[pos].startswith("BITMAP"):
+                words = lines[pos].split()
+                if words and words[0] == "ENCODING":
+                    code = int(words[1])
+                elif words and words[0] == "DWIDTH":
+                    advance = int(words[1])
+                elif words and words[0] == "BBX":
+                    bbx = [int(w) for w in words[1:5]]
+                pos += 1
+            pos += 1
+            bits = []
+            while not lines[pos].startswith("ENDCHAR"):
+                bits.append(int(lines[pos].strip(), 16))
+                pos += 1
+            if FIRST <= code <= LAST:
+                glyphs[code] = (advance, bbx, bits)
+
+    if ascent is None or descent is None:
+        sys.exit("%s: FONT_ASCENT / FONT_DESCENT missing" % path)
+
+    height = ascent + descent
+    result = {}
+    for code, (advance, (width, rows, x_off, y_off), bits) in glyphs.items():
+        cell = [[0] * advance for _ in range(height)]
+        row_bits = ((width + 7) // 8) * 8
+        top = ascent - y_off - rows
+        for r, value in enumerate(bits):
+            for x in range(width):
+                if (value >> (row_bits - 1 - x)) & 1 and 0 <= top + r < height and 0 <= x_off + x < advance:
+                    cell[top + r][x_off + x] = 1
+        result[code] = cell
+    for code in range(FIRST, LAST + 1):
+        if code not in result:
+            result[code] = [[0] * max(1, height // 3) for _ in range(height)]
+    return height, 0, result
+
+
+def pad_digits(glyphs):
+    """Tabular digits: centres 0-9 in the width of the widest digit."""
+    width = max(len(glyphs[c][0]) for c in range(ord("0"), ord("9") + 1))
+    for code in range(ord("0"), ord("9") + 1):
+        rows = glyphs[code]
+        left = (width - len(rows[0])) // 2
+        right = width - len(rows[0]) - left
+        glyphs[code] = [[0] * left + row + [0] * right for row in rows]
+
+
+def pack(rows):
+    data = []
+    for row in rows:
+        for start in range(0, len(row), 8):
+            chunk = row[start:start + 8] + [0] * (8 - len(row[start:start + 8]))
+            data.append(sum(bit << (7 - i) for i, bit in enumerate(chunk)))
+    return data
+
+
+def emit(source, name, height, spacing, glyphs):
+    pad_digits(glyphs)
+    lines = []
+    bitmap = []
+    table = []
+    for code in range(FIRST, LAST + 1):
+        table.append((len(bitmap), len(glyphs[code][0]), code))
+        bitmap += pack(glyphs[code])
+    if len(bitmap) > 0xFFFF:
+        sys.exit("%s: %d bitmap bytes do not fit the 16 bit offsets" % (name, len(bitmap)))
+
+    lines.append("/* %s: %s, %d pixels high, %d bitmap bytes */" % (name, source, height, len(bitmap)))
+    lines.append("static const uint8_t %s_Bitmap[%d] = {" % (name, len(bitmap)))
+    for offset, width, code in table:
+        size = ((width + 7) // 8) * height
+        chunk = bitmap[offset:offset + size]
+        comment = "'%s'" % chr(code) if chr(code) not in "\\'" else "'\\%s'" % chr(code)
+        for i in range(0, len(chunk), 16):
+            text = "\t" + ",".join("0x%02X" % v for v in chunk[i:i + 16]) + ","
+            lines.append(text + ("\t//%s" % comment if i == 0 else ""))
+    lines += ["};", ""]
+
+    lines.append("static const ILI9341_Glyph_t %s_Glyphs[%d] = {" % (name, len(table)))
+    for i in range(0, len(table), 8):
+        lines.append("\t" + " ".join("{%d,%d}," % (offset, width) for offset, width, _ in table[i:i + 8]))
+    lines += ["};", ""]
+
+    lines += ["const ILI9341_Font_t %s = {" % name,
+              "\t%d, %d, %d, %d, %s_Glyphs, %s_Bitmap" % (height, FIRST, LAST, spacing, name, name),
+              "};", ""]
+    return lines
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("fonts", nargs="+", help="SOURCE:SCALE:NAME, SOURCE is 5x5_font.h or a .bdf file")
+    parser.add_argument("-o", "--output", help="C file, default: stdout")
+    args = parser.parse_args()
+
+    lines = ["//GENERATED BY font_convert.py, DO NOT EDIT",
+             "//  font_convert.py " + " ".join(args.fonts),
+             "", "#include <lcd/ILI9341_Fonts.h>", ""]
+    for spec in args.fonts:
+        try:
+            source, scale, name = spec.rsplit(":", 2)
+            scale = int(scale)
+        except ValueError:
+            sys.exit("%s: expected SOURCE:SCALE:NAME" % spec)
+        if source.lower().endswith(".bdf"):
+            height, spacing, glyphs = from_bdf(source)
+        else:
+            height, spacing, glyphs = from_5x5(source, scale)
+        lines += emit(source.rsplit("/", 1)[-1], name, height, spacing, glyphs)
+
+    text = "\n".join(lines)
+    if args.output:
+        with open(args.output, "w") as file:
+            file.write(text)
+    else:
+        sys.stdout.write(text)
+
+
+if __name__ == "__main__":
+    main()
@@ -9,19 +9,329 @@
 #include <lcd/ILI9341_GFX.h>
 #include <lcd/ILI9341_STM32_Driver.h>
 #include <lcd/lcd.h>
+#include <framebuffer/framebuffer.h>
+#include <osal/osal.h>
 #include "stm32f4xx.h"
+#include <string.h>
 
 /**
- * Initializes the LCD
+ * Character cell width in pixels at size 1 (see 5x5_font.h)
+ */
+#define LCD_CHAR_WIDTH	6
+
+/**
+ * Text region remembered by the retained layer
+ */
+typedef struct
+{
+	uint8_t used;
+	uint16_t x;
+	uint16_t y;
+	uint16_t color;
+	uint16_t size;
+	uint16_t background_color;
+	char text[LCD_RETAINED_TEXT_LENGTH + 1];
+} lcd_region_t;
+
+/**
+ * Viewport: origin of the lcd_* coordinates and clip rectangle
+ * (screen coordinates, inclusive, x1 < x0 or y1 < y0 if empty)
+ */
+typedef struct
+{
+	int32_t x;
+	int32_t y;
+	int32_t x0;
+	int32_t y0;
+	int32_t x1;
+	int32_t y1;
+} lcd_viewport_t;
+
+/**
+ * Backend all lcd_* calls are routed to. A constant without the framebuffer
+ * backend, the framebuffer branches of the lcd_* calls drop out.
+ */
+#if LCD_FRAMEBUFFER_ENABLE
+static lcd_backend_t lcd_backend = LCD_BACKEND_SPI;
+#else
+#define lcd_backend		LCD_BACKEND_SPI
+#endif
+
+/**
+ * Content of the retained regions as last sent to the display
+ */
+static lcd_region_t lcd_regions[LCD_RETAINED_REGIONS];
+
+/**
+ * Viewport stack, entry 0 is the whole screen
+ */
+static lcd_viewport_t lcd_viewports[LCD_VIEWPORT_DEPTH + 1] = {{0, 0, 0, 0, INT16_MAX, INT16_MAX}};
+static uint8_t lcd_viewport_depth;
+
+/**
+ * Serializes the lcd_* calls of several tasks (RTOS build, recursive).
+ * Zero initialized, the kernel object is created on the first use.
+ */
+static osal_lock_t lcd_mutex;
+
+static lcd_region_t* lcd_find_region(uint16_t x, uint16_t y);
+static void lcd_draw_run(const char* text, uint8_t length, uint16_t x, uint16_t y, uint16_t color, uint16_t size, uint16_t background_color);
+static void lcd_init_spi_finish(void);
+static void lcd_draw_text(const char* text, uint16_t x, uint16_t y, uint16_t color, uint16_t size, uint16_t background_color);
+static void lcd_fill_framebuffer(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint16_t color);
+
+/**
+ * Initializes the LCD (SPI backend)
  */
 void lcd_init(void)
 {
+	lcd_init_backend(LCD_BACKEND_SPI);
+}
+
+/**
+ * Initializes the LCD with the given backend.
+ * If the framebuffer can not be brought up (or LCD_FRAMEBUFFER_ENABLE is 0), the SPI backend is used.
+ * @param	backend	LCD_BACKEND_SPI or LCD_BACKEND_FRAMEBUFFER
+ */
+void lcd_init_backend(lcd_backend_t backend)
+{
+	lcd_lock();
+#if LCD_FRAMEBUFFER_ENABLE
+	if(backend == LCD_BACKEND_FRAMEBUFFER && framebuffer_init() == HAL_OK)
+	{
+		lcd_backend = LCD_BACKEND_FRAMEBUFFER;
+		lcd_invalidate();
+
+		/* Clear screen with white color */
+		framebuffer_fill_screen(WHITE);
+		lcd_unlock();
+		return;
+	}
+
+	lcd_backend = LCD_BACKEND_SPI;
+#else
+	(void)backend;
+#endif
+	lcd_invalidate();
+
 	/* Initialization of the LCD */
 	ILI9341_Init();
+	lcd_init_spi_finish();
+	lcd_unlock();
+}
+
+/**
+ * Initializes the LCD (SPI backend) as protothread. Returns at the panel
+ * waits after reset and sleep out (about 125 ms in total) instead of
+ * blocking, the caller brings up other peripherals in between and calls
+ * again until PT_ENDED. The display is locked until then.
+ * @param	pt	State, PT_INIT() before the first call
+ * @return	PT_WAITING while the panel is waiting, PT_ENDED when done
+ */
+pt_state_t lcd_init_thread(pt_t* pt)
+{
+	static pt_t panel_pt;
+
+	PT_BEGIN(pt);
+
+	lcd_lock();
+#if LCD_FRAMEBUFFER_ENABLE
+	lcd_backend = LCD_BACKEND_SPI;
+#endif
+	lcd_invalidate();
+
+	PT_SPAWN(pt, &panel_pt, ILI9341_Init_Thread(&panel_pt));
+
+	lcd_init_spi_finish();
+	lcd_unlock();
+
+	PT_END(pt);
+}
+
+/**
+ * Puts the panel to sleep (display off, sleep in), e.g. before lowpower_stop().
+ * Waits for the queued transfers first. The panel keeps its frame memory and
+ * registers, lcd_resume() shows the same frame again without lcd_init().
+ * @return	HAL_OK, HAL_BUSY within 120 ms after the last sleep out of the panel,
+ *			HAL_ERROR on the framebuffer backend (the frame is scanned out of the SDRAM)
+ */
+HAL_StatusTypeDef lcd_sleep(void)
+{
+	HAL_StatusTypeDef status = HAL_ERROR;
+
+	lcd_lock();
+	if(lcd_backend == LCD_BACKEND_SPI)
+	{
+		status = ILI9341_Sleep();
+	}
+	lcd_unlock();
+	return status;
+}
+
+/**
+ * Wakes the panel after lcd_sleep() (sleep out, display on), blocks for about
+ * 5 ms. No-op if the panel is not asleep.
+ */
+void lcd_resume(void)
+{
+	pt_t pt;
+
+	PT_RUN(&pt, lcd_resume_thread(&pt));
+}
+
+/**
+ * lcd_resume() as protothread, returns at the sleep out wait instead of
+ * blocking. The display is locked until PT_ENDED.
+ * @param	pt	State, PT_INIT() before the first call
+ * @return	PT_WAITING while the panel is waiting, PT_ENDED when done
+ */
+pt_state_t lcd_resume_thread(pt_t* pt)
+{
+	static pt_t panel_pt;
+
+	PT_BEGIN(pt);
+
+	lcd_lock();
+	PT_SPAWN(pt, &panel_pt, ILI9341_Resume_Thread(&panel_pt));
+	lcd_unlock();
+
+	PT_END(pt);
+}
+
+/**
+ * Part of the SPI init after the panel init: tearing effect and first clear
+ */
+static void lcd_init_spi_finish(void)
+{
+#if ILI9341_TE_ENABLE
+	/* Large transfers start on the tearing effect edge, stays off if the line does not toggle */
+	ILI9341_TE_Init();
+#endif
 
+#if LCD_INIT_DEFERRED_CLEAR
+	/* Clear screen with white color, the transfer runs on after the return */
+	ILI9341_Set_Rotation(SCREEN_VERTICAL_2);
+	ILI9341_Fill_Screen(WHITE);
+#else
 	/* Clear screen with white color */
 	ILI9341_Fill_Screen(WHITE);
 	ILI9341_Set_Rotation(SCREEN_VERTICAL_2);
+#endif
+}
+
+/**
+ * Takes the display for a sequence of lcd_* calls (RTOS build: recursive
+ * mutex, other tasks drawing block until lcd_unlock()). Every lcd_* call
+ * takes it by itself, so a single call needs no lock.
+ * Bare metal build: no-op.
+ */
+void lcd_lock(void)
+{
+	osal_lock(&lcd_mutex);
+}
+
+/**
+ * Releases the display taken with lcd_lock().
+ */
+void lcd_unlock(void)
+{
+	osal_unlock(&lcd_mutex);
+}
+
+/**
+ * Starts drawing into a sub-window, e.g. of a widget: the coordinates of the
+ * following lcd_* calls are relative to x,y and everything outside
+ * width x height (and outside the enclosing viewports) is clipped. The clip
+ * is applied once per primitive, not per pixel. Takes the display like
+ * lcd_lock() until lcd_pop_viewport().
+ * Framebuffer backend: rectangles, lines along an axis and pixels are
+ * clipped, other primitives are only moved by the origin.
+ * @param	x		The x coordinate of the window in the current viewport
+ * @param	y		The y coordinate of the window in the current viewport
+ * @param	width	The width of the window
+ * @param	height	The height of the window
+ * @return	HAL_OK, HAL_ERROR if LCD_VIEWPORT_DEPTH viewports are open
+ */
+HAL_StatusTypeDef lcd_push_viewport(uint16_t x, uint16_t y, uint16_t width, uint16_t height)
+{
+	lcd_lock();
+	if(lcd_viewport_depth == LCD_VIEWPORT_DEPTH)
+	{
+		lcd_unlock();
+		return HAL_ERROR;
+	}
+
+	const lcd_viewport_t* parent = &lcd_viewports[lcd_viewport_depth];
+	lcd_viewport_t* viewport = &lcd_viewports[lcd_viewport_depth + 1];
+
+	/* Intersection with the parent, the parent clip never exceeds INT16_MAX */
+	viewport->x = parent->x + x;
+	viewport->y = parent->y + y;
+	viewport->x0 = (viewport->x > parent->x0) ? viewport->x : parent->x0;
+	viewport->y0 = (viewport->y > parent->y0) ? viewport->y : parent->y0;
+	viewport->x1 = (viewport->x + width - 1 < parent->x1) ? viewport->x + width - 1 : parent->x1;
+	viewport->y1 = (viewport->y + height - 1 < parent->y1) ? viewport->y + height - 1 : parent->y1;
+	if(viewport->x0 > INT16_MAX) viewport->x0 = INT16_MAX;
+	if(viewport->y0 > INT16_MAX) viewport->y0 = INT16_MAX;
+
+	lcd_viewport_depth++;
+	ILI9341_Set_Clip(viewport->x0, viewport->y0, viewport->x1, viewport->y1);
+	return HAL_OK;
+}
+
+/**
+ * Returns to the enclosing viewport and releases the display taken with
+ * lcd_push_viewport(). Without an open viewport it does nothing.
+ */
+void lcd_pop_viewport(void)
+{
+	if(lcd_viewport_depth == 0)
+	{
+		return;
+	}
+
+	lcd_viewport_depth--;
+	const lcd_viewport_t* viewport = &lcd_viewports[lcd_viewport_depth];
+	ILI9341_Set_Clip(viewport->x0, viewport->y0, viewport->x1, viewport->y1);
+	lcd_unlock();
+}
+
+/**
+ * Returns the active backend.
+ * @return	LCD_BACKEND_SPI or LCD_BACKEND_FRAMEBUFFER
+ */
+lcd_backend_t lcd_get_backend(void)
+{
+	return lcd_backend;
+}
+
+/**
+ * Chooses the layer the following lcd_* calls draw to. The SPI backend has the panel memory only.
+ * The retained regions are forgotten, they describe the content of the previous layer.
+ * @param	layer	LCD_LAYER_BACKGROUND or LCD_LAYER_OVERLAY
+ * @return	HAL_OK, HAL_ERROR for the overlay on the SPI backend or without framebuffer_overlay_enable()
+ */
+HAL_StatusTypeDef lcd_select_layer(lcd_layer_t layer)
+{
+	HAL_StatusTypeDef status = HAL_OK;
+
+	lcd_lock();
+	if(lcd_backend == LCD_BACKEND_FRAMEBUFFER)
+	{
+		status = framebuffer_select_layer((layer == LCD_LAYER_OVERLAY) ? FRAMEBUFFER_LAYER_OVERLAY
+		                                                               : FRAMEBUFFER_LAYER_BACKGROUND);
+	}
+	else if(layer == LCD_LAYER_OVERLAY)
+	{
+		status = HAL_ERROR;
+	}
+	if(status == HAL_OK)
+	{
+		lcd_invalidate();
+	}
+	lcd_unlock();
+
+	return status;
 }
 
 
@@ -37,7 +347,7 @@ void lcd_draw_text_at_line(const char* text, uint8_t line, uint16_t color, uint1
 {
 	uint16_t y = line * (8*size)+10;
 
-	ILI9341_Draw_Text(text, 10, y, color, size, background_color);
+	lcd_draw_text_at_coord(text, 10, y, color, size, background_color);
 }
 
 /**
@@ -51,16 +361,73 @@ void lcd_draw_text_at_line(const char* text, uint8_t line, uint16_t color, uint1
  */
 void lcd_draw_text_at_coord(const char* text, uint16_t x, uint16_t y, uint16_t color, uint16_t size, uint16_t background_color)
 {
-	ILI9341_Draw_Text(text, x, y, color, size, background_color);
+	lcd_lock();
+	lcd_draw_text(text, x + lcd_viewports[lcd_viewport_depth].x, y + lcd_viewports[lcd_viewport_depth].y, color, size, background_color);
+	lcd_unlock();
+}
+
+/**
+ * Draws a text in a proportional font at a given position.
+ * @param	text	The text to draw
+ * @param 	x		The x coordinate on the screen
+ * @param 	y		The y coordinate on the screen
+ * @param	font	The font, e.g. &Font_Medium (see ILI9341_Fonts.h)
+ * @param	color	The text color
+ * @param	background_color	The background color
+ * @return	The width of the text in pixels
+ */
+uint16_t lcd_draw_text_font(const char* text, uint16_t x, uint16_t y, const ILI9341_Font_t* font, uint16_t color, uint16_t background_color)
+{
+	uint16_t width;
+
+	lcd_lock();
+	x += lcd_viewports[lcd_viewport_depth].x;
+	y += lcd_viewports[lcd_viewport_depth].y;
+	if(lcd_backend == LCD_BACKEND_FRAMEBUFFER)
+	{
+		width = framebuffer_draw_text_font(text, x, y, font, color, background_color);
+		lcd_unlock();
+		return width;
+	}
+
+	width = ILI9341_Draw_Text_Font(text, x, y, font, color, background_color);
+	lcd_unlock();
+	return width;
 }
 
 /**
- * Fills the screen with a color.
+ * Fills the screen with a color, inside a viewport only the viewport.
  * @param color	The color to fill the screen
  */
 void lcd_fill_screen(uint16_t color)
 {
+	lcd_lock();
+	const lcd_viewport_t* viewport = &lcd_viewports[lcd_viewport_depth];
+	lcd_invalidate();
+
+	if(lcd_viewport_depth > 0)
+	{
+		if(lcd_backend == LCD_BACKEND_FRAMEBUFFER)
+		{
+			lcd_fill_framebuffer(viewport->x0, viewport->y0, viewport->x1, viewport->y1, color);
+		}
+		else if((viewport->x0 <= viewport->x1) && (viewport->y0 <= viewport->y1))
+		{
+			ILI9341_Fill_Rectangle(viewport->x0, viewport->y0, viewport->x1 - viewport->x0 + 1, viewport->y1 - viewport->y0 + 1, color);
+		}
+		lcd_unlock();
+		return;
+	}
+
+	if(lcd_backend == LCD_BACKEND_FRAMEBUFFER)
+	{
+		framebuffer_fill_screen(color);
+		lcd_unlock();
+		return;
+	}
+
 	ILI9341_Fill_Screen(color);
+	lcd_unlock();
 }
 
 /**
@@ -74,6 +441,33 @@ void lcd_fill_screen(uint16_t color)
  */
 void lcd_draw_rect(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color, uint8_t filled)
 {
+	lcd_lock();
+	x0 += lcd_viewports[lcd_viewport_depth].x;
+	y0 += lcd_viewports[lcd_viewport_depth].y;
+	x1 += lcd_viewports[lcd_viewport_depth].x;
+	y1 += lcd_viewports[lcd_viewport_depth].y;
+	if(lcd_backend == LCD_BACKEND_FRAMEBUFFER)
+	{
+		int32_t left = (x0 < x1) ? x0 : x1;
+		int32_t right = (x0 < x1) ? x1 : x0;
+		int32_t top = (y0 < y1) ? y0 : y1;
+		int32_t bottom = (y0 < y1) ? y1 : y0;
+
+		if(filled)
+		{
+			lcd_fill_framebuffer(left, top, right - 1, bottom - 1, color);
+		}
+		else
+		{
+			lcd_fill_framebuffer(left, top, right, top, color);
+			lcd_fill_framebuffer(left, bottom, right, bottom, color);
+			lcd_fill_framebuffer(left, top, left, bottom, color);
+			lcd_fill_framebuffer(right, top, right, bottom, color);
+		}
+		lcd_unlock();
+		return;
+	}
+
 	if(filled)
 	{
 		ILI9341_Draw_Filled_Rectangle_Coord(x0, y0, x1, y1, color);
@@ -82,6 +476,7 @@ void lcd_draw_rect(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t
 	{
 		ILI9341_Draw_Hollow_Rectangle_Coord(x0, y0, x1, y1, color);
 	}
+	lcd_unlock();
 }
 
 /**
@@ -94,6 +489,16 @@ void lcd_draw_rect(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t
  */
 void lcd_draw_circle(uint16_t x, uint16_t y, uint16_t r, uint16_t color, uint8_t filled)
 {
+	lcd_lock();
+	x += lcd_viewports[lcd_viewport_depth].x;
+	y += lcd_viewports[lcd_viewport_depth].y;
+	if(lcd_backend == LCD_BACKEND_FRAMEBUFFER)
+	{
+		framebuffer_draw_circle(x, y, r, color, filled);
+		lcd_unlock();
+		return;
+	}
+
 	if(filled)
 	{
 		ILI9341_Draw_Filled_Circle(x, y, r, color);
@@ -102,6 +507,7 @@ void lcd_draw_circle(uint16_t x, uint16_t y, uint16_t r, uint16_t color, uint8_t
 	{
 		ILI9341_Draw_Hollow_Circle(x, y, r, color);
 	}
+	lcd_unlock();
 }
 
 /**
@@ -113,7 +519,18 @@ void lcd_draw_circle(uint16_t x, uint16_t y, uint16_t r, uint16_t color, uint8_t
  */
 void lcd_draw_horizontal_line(uint16_t x, uint16_t y, uint16_t width, uint16_t color)
 {
-	ILI9341_Draw_Horizontal_Line(x, y, width, color);
+	lcd_lock();
+	x += lcd_viewports[lcd_viewport_depth].x;
+	y += lcd_viewports[lcd_viewport_depth].y;
+	if(lcd_backend == LCD_BACKEND_FRAMEBUFFER)
+	{
+		lcd_fill_framebuffer(x, y, (int32_t)x + width - 1, y, color);
+		lcd_unlock();
+		return;
+	}
+
+	ILI9341_Fill_Rectangle(x, y, width, 1, color);
+	lcd_unlock();
 }
 
 /**
@@ -125,7 +542,90 @@ void lcd_draw_horizontal_line(uint16_t x, uint16_t y, uint16_t width, uint16_t c
  */
 void lcd_draw_vertical_line(uint16_t x, uint16_t y, uint16_t height, uint16_t color)
 {
-	ILI9341_Draw_Vertical_Line(x, y, height, color);
+	lcd_lock();
+	x += lcd_viewports[lcd_viewport_depth].x;
+	y += lcd_viewports[lcd_viewport_depth].y;
+	if(lcd_backend == LCD_BACKEND_FRAMEBUFFER)
+	{
+		lcd_fill_framebuffer(x, y, x, (int32_t)y + height - 1, color);
+		lcd_unlock();
+		return;
+	}
+
+	ILI9341_Fill_Rectangle(x, y, 1, height, color);
+	lcd_unlock();
+}
+
+/**
+ * Draws a straight line to the screen, runs of pixels in the same row or
+ * column are sent in one address window.
+ * @param x0		The x coordinate of the start point
+ * @param y0		The y coordinate of the start point
+ * @param x1		The x coordinate of the end point
+ * @param y1		The y coordinate of the end point
+ * @param color		The color of the line
+ */
+void lcd_draw_line(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color)
+{
+	lcd_lock();
+	x0 += lcd_viewports[lcd_viewport_depth].x;
+	y0 += lcd_viewports[lcd_viewport_depth].y;
+	x1 += lcd_viewports[lcd_viewport_depth].x;
+	y1 += lcd_viewports[lcd_viewport_depth].y;
+	if(lcd_backend == LCD_BACKEND_FRAMEBUFFER)
+	{
+		framebuffer_draw_line(x0, y0, x1, y1, color);
+		lcd_unlock();
+		return;
+	}
+
+	ILI9341_Draw_Line(x0, y0, x1, y1, color);
+	lcd_unlock();
+}
+
+/**
+ * Draws connected lines through a list of points, e.g. a plot of samples.
+ * @param points	The points as x,y pairs: x0, y0, x1, y1, ...
+ * @param count		The number of points
+ * @param color		The color of the lines
+ */
+void lcd_draw_polyline(const uint16_t* points, uint16_t count, uint16_t color)
+{
+	lcd_lock();
+	uint16_t x = lcd_viewports[lcd_viewport_depth].x;
+	uint16_t y = lcd_viewports[lcd_viewport_depth].y;
+
+	if(lcd_backend == LCD_BACKEND_FRAMEBUFFER)
+	{
+		if(count == 1)
+		{
+			framebuffer_draw_pixel(points[0] + x, points[1] + y, color);
+		}
+		for(uint16_t i = 1; i < count; i++)
+		{
+			framebuffer_draw_line(points[2*i - 2] + x, points[2*i - 1] + y, points[2*i] + x, points[2*i + 1] + y, color);
+		}
+		lcd_unlock();
+		return;
+	}
+
+	if((x == 0) && (y == 0))
+	{
+		ILI9341_Draw_Polyline(points, count, color);
+		lcd_unlock();
+		return;
+	}
+
+	/* Moved by the origin segment by segment, the shared corners are sent twice */
+	if(count == 1)
+	{
+		ILI9341_Fill_Rectangle(points[0] + x, points[1] + y, 1, 1, color);
+	}
+	for(uint16_t i = 1; i < count; i++)
+	{
+		ILI9341_Draw_Line(points[2*i - 2] + x, points[2*i - 1] + y, points[2*i] + x, points[2*i + 1] + y, color);
+	}
+	lcd_unlock();
 }
 
 /**
@@ -136,6 +636,221 @@ void lcd_draw_vertical_line(uint16_t x, uint16_t y, uint16_t height, uint16_t co
  */
 void lcd_draw_pixel(uint16_t x, uint16_t y, uint16_t color)
 {
-	ILI9341_Draw_Pixel(x, y, color);
+	lcd_lock();
+	x += lcd_viewports[lcd_viewport_depth].x;
+	y += lcd_viewports[lcd_viewport_depth].y;
+	if(lcd_backend == LCD_BACKEND_FRAMEBUFFER)
+	{
+		lcd_fill_framebuffer(x, y, x, y, color);
+		lcd_unlock();
+		return;
+	}
+
+	ILI9341_Fill_Rectangle(x, y, 1, 1, color);
+	lcd_unlock();
+}
+
+
+/**
+ * Draws a text at a given line, only the characters that differ from the
+ * previous call for the same line are sent to the display.
+ * @param	text	The text to draw
+ * @param 	line	The line on the screen
+ * @param	color	The text color
+ * @param	size	The text size
+ * @param	background_color	The background color
+ */
+void lcd_update_text_at_line(const char* text, uint8_t line, uint16_t color, uint16_t size, uint16_t background_color)
+{
+	uint16_t y = line * (8*size)+10;
+
+	lcd_update_text_at_coord(text, 10, y, color, size, background_color);
+}
+
+/**
+ * Draws a text at a given position, only the characters that differ from the
+ * previous call for the same position are sent to the display.
+ * Adjacent changed characters are merged into one address window.
+ * If the new text is shorter, the remaining old characters are cleared.
+ * Overdrawing the region with other lcd_* calls requires lcd_invalidate().
+ * @param	text	The text to draw
+ * @param 	x		The x coordinate on the screen
+ * @param 	y		The y coordinate on the screen
+ * @param	color	The text color
+ * @param	size	The text size
+ * @param	background_color	The background color
+ */
+void lcd_update_text_at_coord(const char* text, uint16_t x, uint16_t y, uint16_t color, uint16_t size, uint16_t background_color)
+{
+	char next[LCD_RETAINED_TEXT_LENGTH + 1];
+	uint8_t length = strnlen(text, LCD_RETAINED_TEXT_LENGTH);
+	lcd_region_t* region;
+
+	lcd_lock();
+	x += lcd_viewports[lcd_viewport_depth].x;
+	y += lcd_viewports[lcd_viewport_depth].y;
+	region = lcd_find_region(x, y);
+
+	if(region == 0)
+	{
+		/* No region left, draw without retaining */
+		lcd_draw_text(text, x, y, color, size, background_color);
+		lcd_unlock();
+		return;
+	}
+
+	if(!region->used || region->color != color || region->size != size || region->background_color != background_color)
+	{
+		/* New region or changed attributes: everything is dirty */
+		region->used = 1;
+		region->x = x;
+		region->y = y;
+		region->color = color;
+		region->size = size;
+		region->background_color = background_color;
+		memset(region->text, 0, sizeof(region->text));
+	}
+
+	/* Pad with spaces so that leftovers of a longer old text are cleared */
+	memcpy(next, text, length);
+	for(uint8_t i = length; i < LCD_RETAINED_TEXT_LENGTH; i++)
+	{
+		next[i] = (region->text[i] != 0) ? ' ' : 0;
+	}
+	next[LCD_RETAINED_TEXT_LENGTH] = 0;
+
+	uint8_t i = 0;
+	while(i < LCD_RETAINED_TEXT_LENGTH && next[i] != 0)
+	{
+		if(next[i] == region->text[i])
+		{
+			i++;
+			continue;
+		}
+
+		/* Collect the run of changed characters */
+		uint8_t start = i;
+		while(i < LCD_RETAINED_TEXT_LENGTH && next[i] != 0 && next[i] != region->text[i])
+		{
+			i++;
+		}
+
+		lcd_draw_run(&next[start], i - start, x + start * LCD_CHAR_WIDTH * size, y, color, size, background_color);
+	}
+
+	/* Remember the text without the clearing spaces */
+	memcpy(region->text, text, length);
+	memset(&region->text[length], 0, sizeof(region->text) - length);
+	lcd_unlock();
+}
+
+/**
+ * Forgets the content of all retained regions,
+ * the next update of every region redraws it completely.
+ */
+void lcd_invalidate(void)
+{
+	lcd_lock();
+	memset(lcd_regions, 0, sizeof(lcd_regions));
+	lcd_unlock();
 }
 
+/**
+ * Returns the region stored for a position or a free one.
+ * @param 	x		The x coordinate on the screen
+ * @param 	y		The y coordinate on the screen
+ * @return	The region or 0 if all regions are in use
+ */
+static lcd_region_t* lcd_find_region(uint16_t x, uint16_t y)
+{
+	lcd_region_t* free_region = 0;
+
+	for(uint8_t i = 0; i < LCD_RETAINED_REGIONS; i++)
+	{
+		if(lcd_regions[i].used)
+		{
+			if(lcd_regions[i].x == x && lcd_regions[i].y == y)
+			{
+				return &lcd_regions[i];
+			}
+		}
+		else if(free_region == 0)
+		{
+			free_region = &lcd_regions[i];
+		}
+	}
+
+	return free_region;
+}
+
+/**
+ * Draws a run of characters.
+ * @param	text	The characters to draw
+ * @param	length	The number of characters
+ * @param 	x		The x coordinate on the screen
+ * @param 	y		The y coordinate on the screen
+ * @param	color	The text color
+ * @param	size	The text size
+ * @param	background_color	The background color
+ */
+static void lcd_draw_run(const char* text, uint8_t length, uint16_t x, uint16_t y, uint16_t color, uint16_t size, uint16_t background_color)
+{
+	char run[LCD_RETAINED_TEXT_LENGTH + 1];
+
+	memcpy(run, text, length);
+	run[length] = 0;
+
+	/* One address window per run on the SPI backend, see ILI9341_Draw_Text */
+	lcd_draw_text(run, x, y, color, size, background_color);
+}
+
+/**
+ * Draws a text at a given screen position (viewport origin applied).
+ * @param	text	The text to draw
+ * @param 	x		The x coordinate on the screen
+ * @param 	y		The y coordinate on the screen
+ * @param	color	The text color
+ * @param	size	The text size
+ * @param	background_color	The background color
+ */
+static void lcd_draw_text(const char* text, uint16_t x, uint16_t y, uint16_t color, uint16_t size, uint16_t background_color)
+{
+	if(lcd_backend == LCD_BACKEND_FRAMEBUFFER)
+	{
+		framebuffer_draw_text(text, x, y, color, size, background_color);
+		return;
+	}
+
+	ILI9341_Draw_Text(text, x, y, color, size, background_color);
+}
+
+/**
+ * Fills a rectangle clipped to the current viewport and the screen (framebuffer backend).
+ * @param x0		The x coordinate of the upper left corner on the screen
+ * @param y0		The y coordinate of the upper left corner on the screen
+ * @param x1		The x coordinate of the lower right corner on the screen, included
+ * @param y1		The y coordinate of the lower right corner on the screen, included
+ * @param color		The color of the rectangle
+ */
+static void lcd_fill_framebuffer(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint16_t color)
+{
+	const lcd_viewport_t* viewport = &lcd_viewports[lcd_viewport_depth];
+
+	if(x0 < viewport->x0) x0 = viewport->x0;
+	if(y0 < viewport->y0) y0 = viewport->y0;
+	if(x1 > viewport->x1) x1 = viewport->x1;
+	if(y1 > viewport->y1) y1 = viewport->y1;
+	if(x1 >= (int32_t)FRAMEBUFFER_WIDTH) x1 = FRAMEBUFFER_WIDTH - 1;
+	if(y1 >= (int32_t)FRAMEBUFFER_HEIGHT) y1 = FRAMEBUFFER_HEIGHT - 1;
+	if((x0 > x1) || (y0 > y1))
+	{
+		return;
+	}
+
+	if((x0 == x1) && (y0 == y1))
+	{
+		framebuffer_draw_pixel(x0, y0, color);
+		return;
+	}
+	framebuffer_fill_rect(x0, y0, x1 - x0 + 1, y1 - y0 + 1, color);
+}
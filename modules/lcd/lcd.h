@@ -21,13 +21,79 @@
  */
 
 
+/**
+ * Display backends:
+ * LCD_BACKEND_SPI			pixels are written to the panel over SPI5
+ * LCD_BACKEND_FRAMEBUFFER	pixels are written to the SDRAM framebuffer, scanned out by the LTDC
+ */
+typedef enum
+{
+	LCD_BACKEND_SPI = 0,
+	LCD_BACKEND_FRAMEBUFFER
+} lcd_backend_t;
+
+/**
+ * Drawing layers (framebuffer backend with framebuffer_overlay_enable()):
+ * LCD_LAYER_BACKGROUND	static art (labels, frames, scales), drawn once
+ * LCD_LAYER_OVERLAY	changing values, blended over the background by the LTDC, erased with the key colour
+ */
+typedef enum
+{
+	LCD_LAYER_BACKGROUND = 0,
+	LCD_LAYER_OVERLAY
+} lcd_layer_t;
+
+/**
+ * Retained text layer:
+ * LCD_RETAINED_REGIONS		number of text regions whose content is remembered
+ * LCD_RETAINED_TEXT_LENGTH	maximum number of characters per region
+ */
+#define LCD_RETAINED_REGIONS		16
+#define LCD_RETAINED_TEXT_LENGTH	40
+
+/**
+ * Viewports (lcd_push_viewport()):
+ * LCD_VIEWPORT_DEPTH		number of viewports that can be nested, the whole screen below them is not counted
+ */
+#define LCD_VIEWPORT_DEPTH			4
+
+/**
+ * Framebuffer backend:
+ * LCD_FRAMEBUFFER_ENABLE	0: the lcd_* calls go to the SPI panel only, lcd_init_backend() ignores
+ *							LCD_BACKEND_FRAMEBUFFER and framebuffer, SDRAM and LTDC code is not linked
+ */
+#ifndef LCD_FRAMEBUFFER_ENABLE
+#define LCD_FRAMEBUFFER_ENABLE		1
+#endif
+
+/**
+ * First clear in lcd_init():
+ * LCD_INIT_DEFERRED_CLEAR	1: the white clear is queued on the DMA and lcd_init() returns while it is
+ *							sent, the next lcd call waits for it. 0: lcd_init() returns after the clear
+ */
+#ifndef LCD_INIT_DEFERRED_CLEAR
+#define LCD_INIT_DEFERRED_CLEAR		1
+#endif
+
 /**
  * Function prototypes
  */
 void lcd_init(void);
+void lcd_init_backend(lcd_backend_t backend);
+pt_state_t lcd_init_thread(pt_t* pt);
+HAL_StatusTypeDef lcd_sleep(void);
+void lcd_resume(void);
+pt_state_t lcd_resume_thread(pt_t* pt);
+lcd_backend_t lcd_get_backend(void);
+HAL_StatusTypeDef lcd_select_layer(lcd_layer_t layer);
+void lcd_lock(void);
+void lcd_unlock(void);
+HAL_StatusTypeDef lcd_push_viewport(uint16_t x, uint16_t y, uint16_t width, uint16_t height);
+void lcd_pop_viewport(void);
 
 void lcd_draw_text_at_line(const char* text, uint8_t line, uint16_t color, uint16_t size, uint16_t background_color);
 void lcd_draw_text_at_coord(const char* text, uint16_t x, uint16_t y, uint16_t color, uint16_t size, uint16_t background_color);
+uint16_t lcd_draw_text_font(const char* text, uint16_t x, uint16_t y, const ILI9341_Font_t* font, uint16_t color, uint16_t background_color);
 
 void lcd_fill_screen(uint16_t color);
 
@@ -35,8 +101,14 @@ void lcd_draw_rect(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t
 void lcd_draw_circle(uint16_t x, uint16_t y, uint16_t r, uint16_t color, uint8_t filled);
 void lcd_draw_horizontal_line(uint16_t x, uint16_t y, uint16_t width, uint16_t color);
 void lcd_draw_vertical_line(uint16_t x, uint16_t y, uint16_t height, uint16_t color);
+void lcd_draw_line(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color);
+void lcd_draw_polyline(const uint16_t* points, uint16_t count, uint16_t color);
 void lcd_draw_pixel(uint16_t x, uint16_t y, uint16_t color);
 
+void lcd_update_text_at_line(const char* text, uint8_t line, uint16_t color, uint16_t size, uint16_t background_color);
+void lcd_update_text_at_coord(const char* text, uint16_t x, uint16_t y, uint16_t color, uint16_t size, uint16_t background_color);
+void lcd_invalidate(void);
+
 
 
 #endif /* __LCD_H_ */
@@ -0,0 +1,332 @@
+/**
+ ******************************************************************************
+ * @file        lcd_band.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Band renderer for full-screen updates without a framebuffer.
+ *
+ * Functionality:
+ * - Stores rectangles, texts and bargraphs in a fixed-size display list
+ * - Composes LCD_BAND_LINES lines at a time into one of two band buffers
+ * - Streams the bands through a single full-screen address window
+ * - Switches the controller to the rotation of the display list while the
+ *   bands are sent
+ *
+ * Peripherals:
+ * - SPI5 + DMA2 Stream4 through the ILI9341 driver DMA queue
+ ******************************************************************************
+ */
+
+#include "lcd_band.h"
+#include "lcd/ILI9341_STM32_Driver.h"
+#include "lcd/5x5_font.h"
+#include "bkptrace/bkptrace.h"
+#include "trace/trace.h"
+#include "utils/utils.h"
+#include <string.h>
+
+/* Preprocessor Defines ----------------------------------------------------- */
+/**
+ * @brief Widest supported screen (horizontal rotation).
+ */
+#define LCD_BAND_MAX_WIDTH      ILI9341_SCREEN_WIDTH
+
+/* Type Definitions --------------------------------------------------------- */
+/**
+ * @brief Kinds of display list items.
+ */
+typedef enum {
+    LCD_BAND_ITEM_RECT = 0,
+    LCD_BAND_ITEM_TEXT,
+    LCD_BAND_ITEM_BARGRAPH
+} lcd_band_item_type_t;
+
+/**
+ * @brief One display list item, the bounding box covers the whole item.
+ */
+typedef struct {
+    lcd_band_item_type_t type;
+    uint16_t x;
+    uint16_t y;
+    uint16_t width;
+    uint16_t height;
+    uint16_t color;
+    uint16_t bg_color;
+    uint16_t size;          /**< Text: font scale, bargraph: filled width */
+    char text[LCD_BAND_TEXT_LENGTH + 1u];
+} lcd_band_item_t;
+
+/* Static module variables -------------------------------------------------- */
+/**
+ * @brief Display list.
+ */
+static lcd_band_item_t g_lcd_band_items[LCD_BAND_MAX_ITEMS];
+
+/**
+ * @brief Number of used display list entries.
+ */
+static uint8_t g_u8_lcd_band_item_count = 0u;
+
+/**
+ * @brief Colour of pixels not covered by any item.
+ */
+static uint16_t g_u16_lcd_band_background = 0xFFFFu;
+
+/**
+ * @brief Rotation the display list is laid out for.
+ */
+static uint8_t g_u8_lcd_band_rotation = LCD_BAND_ROTATION_CURRENT;
+
+/**
+ * @brief Ping-pong band buffers, one is composed while the other is sent.
+ *        Not cleared at startup, every band is composed in full.
+ */
+static uint16_t g_u16_lcd_band_buffer[2][LCD_BAND_LINES * LCD_BAND_MAX_WIDTH] UTILS_NOINIT;
+
+/* Static function prototypes ----------------------------------------------- */
+static lcd_band_item_t *lcd_band_new_item(lcd_band_item_type_t type, uint16_t x, uint16_t y,
+                                          uint16_t width, uint16_t height);
+static void lcd_band_fill(uint16_t *band, uint16_t band_y, uint16_t lines, uint16_t screen_width,
+                          uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint16_t color);
+static void lcd_band_draw_text(uint16_t *band, uint16_t band_y, uint16_t lines,
+                               uint16_t screen_width, const lcd_band_item_t *item);
+static void lcd_band_compose(uint16_t *band, uint16_t band_y, uint16_t lines, uint16_t screen_width);
+
+/* Public functions --------------------------------------------------------- */
+void lcd_band_clear(uint16_t background_color)
+{
+    g_u8_lcd_band_item_count  = 0u;
+    g_u16_lcd_band_background = background_color;
+}
+
+HAL_StatusTypeDef lcd_band_add_rect(uint16_t x, uint16_t y, uint16_t width,
+                                    uint16_t height, uint16_t color)
+{
+    lcd_band_item_t *item = lcd_band_new_item(LCD_BAND_ITEM_RECT, x, y, width, height);
+
+    if (item == NULL) {
+        return HAL_ERROR;
+    }
+
+    item->color = color;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef lcd_band_add_text(const char *text, uint16_t x, uint16_t y,
+                                    uint16_t color, uint16_t size,
+                                    uint16_t background_color)
+{
+    size_t length = strnlen(text, LCD_BAND_TEXT_LENGTH);
+    lcd_band_item_t *item = lcd_band_new_item(LCD_BAND_ITEM_TEXT, x, y,
+                                              length * CHAR_WIDTH * size,
+                                              CHAR_HEIGHT * size);
+
+    if (item == NULL) {
+        return HAL_ERROR;
+    }
+
+    item->color    = color;
+    item->bg_color = background_color;
+    item->size     = size;
+    memcpy(item->text, text, length);
+    item->text[length] = '\0';
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef lcd_band_add_bargraph(uint16_t x, uint16_t y, uint16_t width,
+                                        uint16_t height, uint16_t value,
+                                        uint16_t color, uint16_t bg_color)
+{
+    lcd_band_item_t *item = lcd_band_new_item(LCD_BAND_ITEM_BARGRAPH, x, y, width, height);
+
+    if (item == NULL) {
+        return HAL_ERROR;
+    }
+
+    if (value > LCD_BAND_BARGRAPH_MAX) {
+        value = LCD_BAND_BARGRAPH_MAX;
+    }
+
+    item->color    = color;
+    item->bg_color = bg_color;
+    item->size     = ((uint32_t)width * value) / LCD_BAND_BARGRAPH_MAX;
+    return HAL_OK;
+}
+
+void lcd_band_set_rotation(uint8_t rotation)
+{
+    g_u8_lcd_band_rotation = (rotation <= SCREEN_HORIZONTAL_2) ? rotation : LCD_BAND_ROTATION_CURRENT;
+}
+
+void lcd_band_render(void)
+{
+    uint8_t  u8_rotation = ILI9341_Get_Rotation();
+    uint8_t  u8_turned   = (g_u8_lcd_band_rotation != LCD_BAND_ROTATION_CURRENT) &&
+                           (g_u8_lcd_band_rotation != u8_rotation);
+    uint16_t u16_width;
+    uint16_t u16_height;
+    uint8_t  u8_buffer   = 0u;
+#if TRACE_ENABLE || BKPTRACE_ENABLE
+    uint32_t u32_start   = utils_now_cycles();
+#endif
+
+    /* Screen size of the display list rotation */
+    if (u8_turned) {
+        ILI9341_Set_Rotation(g_u8_lcd_band_rotation);
+    }
+    u16_width  = LCD_WIDTH;
+    u16_height = LCD_HEIGHT;
+
+    ILI9341_Set_Address(0u, 0u, u16_width - 1u, u16_height - 1u);
+
+    for (uint16_t band_y = 0u; band_y < u16_height; band_y += LCD_BAND_LINES) {
+        uint16_t u16_lines = u16_height - band_y;
+
+        if (u16_lines > LCD_BAND_LINES) {
+            u16_lines = LCD_BAND_LINES;
+        }
+
+        /* The buffer is free once at most the other band is still queued */
+        while (ILI9341_DMA_Pending() > 1u) {
+        }
+
+        lcd_band_compose(g_u16_lcd_band_buffer[u8_buffer], band_y, u16_lines, u16_width);
+        ILI9341_DMA_Transmit_Pixels(g_u16_lcd_band_buffer[u8_buffer], u16_lines * u16_width, 1u);
+
+        u8_buffer ^= 1u;
+    }
+
+    /* Written once the last band has drained */
+    if (u8_turned) {
+        ILI9341_Set_Rotation(u8_rotation);
+    }
+
+    TRACE_U32(TRACE_CH_LCD_FRAME, utils_elapsed_us(u32_start));
+    BKPTRACE_EVENT(BKPTRACE_EV_LCD_BAND, utils_elapsed_us(u32_start));
+}
+
+/* Static functions --------------------------------------------------------- */
+/**
+ * @brief Reserves the next display list entry.
+ *
+ * @return Pointer to the entry or NULL if the list is full.
+ */
+static lcd_band_item_t *lcd_band_new_item(lcd_band_item_type_t type, uint16_t x, uint16_t y,
+                                          uint16_t width, uint16_t height)
+{
+    lcd_band_item_t *item;
+
+    if (g_u8_lcd_band_item_count >= LCD_BAND_MAX_ITEMS) {
+        return NULL;
+    }
+
+    item = &g_lcd_band_items[g_u8_lcd_band_item_count++];
+    item->type   = type;
+    item->x      = x;
+    item->y      = y;
+    item->width  = width;
+    item->height = height;
+    return item;
+}
+
+/**
+ * @brief Fills the part of a rectangle that lies inside the band.
+ */
+static void lcd_band_fill(uint16_t *band, uint16_t band_y, uint16_t lines, uint16_t screen_width,
+                          uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint16_t color)
+{
+    uint32_t u32_top    = (y > band_y) ? y : band_y;
+    uint32_t u32_bottom = (uint32_t)y + height;
+    uint32_t u32_right  = (uint32_t)x + width;
+
+    if (u32_bottom > (uint32_t)band_y + lines) {
+        u32_bottom = (uint32_t)band_y + lines;
+    }
+    if (u32_right > screen_width) {
+        u32_right = screen_width;
+    }
+
+    for (uint32_t row = u32_top; row < u32_bottom; row++) {
+        uint16_t *pu16_pixel = &band[(row - band_y) * screen_width];
+
+        for (uint32_t col = x; col < u32_right; col++) {
+            pu16_pixel[col] = color;
+        }
+    }
+}
+
+/**
+ * @brief Renders the rows of a text item that lie inside the band.
+ */
+static void lcd_band_draw_text(uint16_t *band, uint16_t band_y, uint16_t lines,
+                               uint16_t screen_width, const lcd_band_item_t *item)
+{
+    uint32_t u32_top    = (item->y > band_y) ? item->y : band_y;
+    uint32_t u32_bottom = (uint32_t)item->y + item->height;
+    uint32_t u32_right  = (uint32_t)item->x + item->width;
+    uint16_t u16_cell_w = CHAR_WIDTH * item->size;
+
+    if (u32_bottom > (uint32_t)band_y + lines) {
+        u32_bottom = (uint32_t)band_y + lines;
+    }
+    if (u32_right > screen_width) {
+        u32_right = screen_width;
+    }
+
+    for (uint32_t row = u32_top; row < u32_bottom; row++) {
+        uint16_t *pu16_pixel = &band[(row - band_y) * screen_width];
+        uint8_t   u8_mask    = 1u << ((row - item->y) / item->size);
+
+        for (uint32_t col = item->x; col < u32_right; col++) {
+            uint16_t u16_offset = col - item->x;
+            uint8_t  u8_char    = (uint8_t)item->text[u16_offset / u16_cell_w];
+
+            u8_char = (u8_char < ' ') ? 0u : (uint8_t)(u8_char - ' ');
+            pu16_pixel[col] = (font[u8_char][(u16_offset % u16_cell_w) / item->size] & u8_mask)
+                              ? item->color : item->bg_color;
+        }
+    }
+}
+
+/**
+ * @brief Composes one band from the display list.
+ */
+static void lcd_band_compose(uint16_t *band, uint16_t band_y, uint16_t lines, uint16_t screen_width)
+{
+    for (uint32_t i = 0u; i < (uint32_t)lines * screen_width; i++) {
+        band[i] = g_u16_lcd_band_background;
+    }
+
+    for (uint8_t i = 0u; i < g_u8_lcd_band_item_count; i++) {
+        const lcd_band_item_t *item = &g_lcd_band_items[i];
+
+        /* Skip items outside the band */
+        if ((item->y >= band_y + lines) || ((uint32_t)item->y + item->height <= band_y) ||
+            (item->x >= screen_width)) {
+            continue;
+        }
+
+        switch (item->type) {
+        case LCD_BAND_ITEM_RECT:
+            lcd_band_fill(band, band_y, lines, screen_width,
+                          item->x, item->y, item->width, item->height, item->color);
+            break;
+
+        case LCD_BAND_ITEM_TEXT:
+            lcd_band_draw_text(band, band_y, lines, screen_width, item);
+            break;
+
+        case LCD_BAND_ITEM_BARGRAPH:
+            lcd_band_fill(band, band_y, lines, screen_width,
+                          item->x, item->y, item->size, item->height, item->color);
+            lcd_band_fill(band, band_y, lines, screen_width,
+                          item->x + item->size, item->y, item->width - item->size,
+                          item->height, item->bg_color);
+            break;
+
+        default:
+            break;
+        }
+    }
+}
@@ -0,0 +1,139 @@
+/**
+ ******************************************************************************
+ * @file        lcd_band.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Band renderer for full-screen updates without a framebuffer.
+ *
+ * @details
+ * The screen content is described by a display list of rectangles, texts
+ * and bargraphs. lcd_band_render() composes the screen in bands of
+ * LCD_BAND_LINES lines into two internal SRAM buffers. While one band is
+ * sent to the ILI9341 via DMA, the next one is composed into the other
+ * buffer. Every pixel is written exactly once, so the update is free of
+ * flicker.
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - Display list with rectangles, texts (5x5 font) and bargraphs
+ *  - Ping-pong band buffers, 2 * LCD_BAND_LINES * 320 RGB565 pixels
+ *  - One address window for the whole screen
+ *  - Display list laid out for any rotation, sent through the controller's
+ *    address transform without touching the rest of the frame memory
+ *
+ ******************************************************************************
+ */
+
+#ifndef LCD_LCD_BAND_H_
+#define LCD_LCD_BAND_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief Number of display lines per band.
+ */
+#define LCD_BAND_LINES          16U
+
+/**
+ * @brief Capacity of the display list.
+ */
+#define LCD_BAND_MAX_ITEMS      32U
+
+/**
+ * @brief Maximum number of characters of a text item.
+ */
+#define LCD_BAND_TEXT_LENGTH    40U
+
+/**
+ * @brief Full scale value of a bargraph item (see my_lcd_draw_baargraph()).
+ */
+#define LCD_BAND_BARGRAPH_MAX   1000U
+
+/**
+ * @brief lcd_band_set_rotation(): lay out for the rotation of the screen.
+ */
+#define LCD_BAND_ROTATION_CURRENT   0xFFU
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Clears the display list.
+ *
+ * @param background_color Colour of all pixels not covered by an item.
+ * @return None
+ */
+void lcd_band_clear(uint16_t background_color);
+
+/**
+ * @brief Adds a filled rectangle to the display list.
+ *
+ * @param x      Column of the upper left corner.
+ * @param y      Row of the upper left corner.
+ * @param width  Width in pixels.
+ * @param height Height in pixels.
+ * @param color  Fill colour.
+ * @return HAL_OK, or HAL_ERROR if the display list is full.
+ */
+HAL_StatusTypeDef lcd_band_add_rect(uint16_t x, uint16_t y, uint16_t width,
+                                    uint16_t height, uint16_t color);
+
+/**
+ * @brief Adds a text to the display list. The text is copied.
+ *
+ * @param text             Zero terminated text, cut at LCD_BAND_TEXT_LENGTH.
+ * @param x                Column of the upper left corner.
+ * @param y                Row of the upper left corner.
+ * @param color            Text colour.
+ * @param size             Scaling factor of the 5x5 font.
+ * @param background_color Colour of the character cells.
+ * @return HAL_OK, or HAL_ERROR if the display list is full.
+ */
+HAL_StatusTypeDef lcd_band_add_text(const char *text, uint16_t x, uint16_t y,
+                                    uint16_t color, uint16_t size,
+                                    uint16_t background_color);
+
+/**
+ * @brief Adds a horizontal bargraph to the display list.
+ *
+ * @param x        Column of the upper left corner.
+ * @param y        Row of the upper left corner.
+ * @param width    Width in pixels.
+ * @param height   Height in pixels.
+ * @param value    Fill level, 0 .. LCD_BAND_BARGRAPH_MAX.
+ * @param color    Colour of the filled part.
+ * @param bg_color Colour of the empty part.
+ * @return HAL_OK, or HAL_ERROR if the display list is full.
+ */
+HAL_StatusTypeDef lcd_band_add_bargraph(uint16_t x, uint16_t y, uint16_t width,
+                                        uint16_t height, uint16_t value,
+                                        uint16_t color, uint16_t bg_color);
+
+/**
+ * @brief Sets the rotation the display list coordinates refer to.
+ *
+ * With a rotation other than the current screen rotation the controller is
+ * switched to it while the bands are sent (MADCTL only addresses the frame
+ * memory differently, its content stays), so the list appears upright for
+ * that rotation without any pixel being turned and lcd_band_render()
+ * returns after the last band has been sent. Coordinates of the other lcd
+ * functions keep referring to the screen rotation.
+ *
+ * @param rotation SCREEN_VERTICAL_1 .. SCREEN_HORIZONTAL_2 or
+ *                 LCD_BAND_ROTATION_CURRENT (default).
+ * @return None
+ */
+void lcd_band_set_rotation(uint8_t rotation);
+
+/**
+ * @brief Composes the display list band by band and sends it to the display.
+ *
+ * Items are drawn in the order they were added, later items cover earlier
+ * ones. Returns when the last band is queued on the SPI DMA.
+ *
+ * @return None
+ */
+void lcd_band_render(void);
+
+#endif /* LCD_LCD_BAND_H_ */
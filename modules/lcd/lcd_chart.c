@@ -0,0 +1,260 @@
+/**
+ ******************************************************************************
+ * @file        lcd_chart.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Scrolling strip chart on the ILI9341 hardware scroll.
+ *
+ * Functionality:
+ * - Maps the chart band to frame memory lines for the current rotation
+ * - Composes one line per sample (background, grid, trace segments)
+ * - Writes the line at the head of the ring of scroll lines and moves the
+ *   scroll start so that it shows up at the newest edge
+ *
+ * Peripherals:
+ * - SPI5 + DMA2 Stream4 through the ILI9341 driver DMA queue
+ ******************************************************************************
+ */
+
+#include "lcd_chart.h"
+#include "lcd/lcd.h"
+#include "lcd/ILI9341_STM32_Driver.h"
+
+/* Preprocessor Defines ----------------------------------------------------- */
+/**
+ * @brief Frame memory lines, the direction the controller scrolls.
+ */
+#define LCD_CHART_LINES         ILI9341_SCREEN_WIDTH
+
+/**
+ * @brief Pixels of one line, the value axis.
+ */
+#define LCD_CHART_LINE_PIXELS   ILI9341_SCREEN_HEIGHT
+
+/* Static module variables -------------------------------------------------- */
+/**
+ * @brief Layout of the active chart.
+ */
+static lcd_chart_config_t g_lcd_chart_config;
+
+/**
+ * @brief Pixels of the line that is composed and sent.
+ */
+static uint16_t g_u16_lcd_chart_line[LCD_CHART_LINE_PIXELS];
+
+/**
+ * @brief Value axis position of the previous sample per trace.
+ */
+static uint16_t g_u16_lcd_chart_previous[LCD_CHART_MAX_SERIES];
+
+/**
+ * @brief First frame memory line of the scroll area (top fixed area).
+ */
+static uint16_t g_u16_lcd_chart_first_line = 0u;
+
+/**
+ * @brief Frame memory line the next sample is written to.
+ */
+static uint16_t g_u16_lcd_chart_head = 0u;
+
+/**
+ * @brief Samples since lcd_chart_init() (time grid).
+ */
+static uint32_t g_u32_lcd_chart_samples = 0u;
+
+/**
+ * @brief 1 if the rotation uses horizontal time (columns as lines).
+ */
+static uint8_t g_u8_lcd_chart_horizontal = 0u;
+
+/**
+ * @brief 1 if the frame memory lines run against the screen coordinate (MY).
+ */
+static uint8_t g_u8_lcd_chart_reversed = 0u;
+
+static uint8_t g_u8_lcd_chart_active = 0u;
+
+/* Static function prototypes ----------------------------------------------- */
+static uint16_t lcd_chart_position(const lcd_chart_series_t *series, int32_t value);
+static void lcd_chart_compose(const int32_t *values);
+
+/* Public functions --------------------------------------------------------- */
+HAL_StatusTypeDef lcd_chart_init(const lcd_chart_config_t *config)
+{
+    uint8_t u8_rotation = ILI9341_Get_Rotation();
+
+    if ((config == NULL) || (lcd_get_backend() != LCD_BACKEND_SPI)) {
+        return HAL_ERROR;
+    }
+    if ((config->u8_series_count == 0u) || (config->u8_series_count > LCD_CHART_MAX_SERIES) ||
+        (config->u16_length < 2u) ||
+        ((uint32_t)config->u16_start + config->u16_length > LCD_CHART_LINES)) {
+        return HAL_ERROR;
+    }
+    for (uint8_t i = 0u; i < config->u8_series_count; i++) {
+        if (config->series[i].i32_max <= config->series[i].i32_min) {
+            return HAL_ERROR;
+        }
+    }
+
+    lcd_lock();
+    g_lcd_chart_config        = *config;
+    g_u8_lcd_chart_horizontal = (u8_rotation == SCREEN_HORIZONTAL_1) || (u8_rotation == SCREEN_HORIZONTAL_2);
+    g_u8_lcd_chart_reversed   = (u8_rotation == SCREEN_VERTICAL_2) || (u8_rotation == SCREEN_HORIZONTAL_2);
+    g_u32_lcd_chart_samples   = 0u;
+
+    /* Band in frame memory lines, mirrored if MY reverses the lines */
+    if (g_u8_lcd_chart_reversed) {
+        g_u16_lcd_chart_first_line = LCD_CHART_LINES - config->u16_start - config->u16_length;
+    } else {
+        g_u16_lcd_chart_first_line = config->u16_start;
+    }
+    g_u16_lcd_chart_head = g_u16_lcd_chart_first_line;
+
+    if (g_u8_lcd_chart_horizontal) {
+        ILI9341_Draw_Rectangle(config->u16_start, 0u, config->u16_length, LCD_CHART_LINE_PIXELS,
+                               config->u16_background_color);
+    } else {
+        ILI9341_Draw_Rectangle(0u, config->u16_start, LCD_CHART_LINE_PIXELS, config->u16_length,
+                               config->u16_background_color);
+    }
+
+    ILI9341_Set_Scroll_Area(g_u16_lcd_chart_first_line, config->u16_length,
+                            LCD_CHART_LINES - g_u16_lcd_chart_first_line - config->u16_length);
+    ILI9341_Set_Scroll_Start(g_u16_lcd_chart_first_line);
+    g_u8_lcd_chart_active = 1u;
+    lcd_unlock();
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef lcd_chart_add(const int32_t *values)
+{
+    uint16_t u16_last = g_u16_lcd_chart_first_line + g_lcd_chart_config.u16_length - 1u;
+    uint16_t u16_scroll_start;
+    uint16_t u16_coordinate;
+
+    if (!g_u8_lcd_chart_active || (values == NULL)) {
+        return HAL_ERROR;
+    }
+
+    lcd_lock();
+
+    /* The previous line may still be in flight */
+    ILI9341_DMA_Wait();
+    lcd_chart_compose(values);
+
+    u16_coordinate = g_u8_lcd_chart_reversed ? (LCD_CHART_LINES - 1u - g_u16_lcd_chart_head)
+                                             : g_u16_lcd_chart_head;
+    if (g_u8_lcd_chart_horizontal) {
+        ILI9341_Set_Address(u16_coordinate, 0u, u16_coordinate, LCD_CHART_LINE_PIXELS - 1u);
+    } else {
+        ILI9341_Set_Address(0u, u16_coordinate, LCD_CHART_LINE_PIXELS - 1u, u16_coordinate);
+    }
+    ILI9341_DMA_Transmit_Pixels(g_u16_lcd_chart_line, LCD_CHART_LINE_PIXELS, 1u);
+
+    /*
+     * The scroll start is the line shown at the low end of the area. Not
+     * reversed: the newest edge is the high end, the head moves up and the
+     * line after it (the oldest) starts the area. Reversed: the newest edge
+     * is the low end, the head moves down and starts the area itself.
+     */
+    if (g_u8_lcd_chart_reversed) {
+        u16_scroll_start = g_u16_lcd_chart_head;
+        g_u16_lcd_chart_head = (g_u16_lcd_chart_head == g_u16_lcd_chart_first_line) ? u16_last
+                                                                                     : g_u16_lcd_chart_head - 1u;
+    } else {
+        g_u16_lcd_chart_head = (g_u16_lcd_chart_head == u16_last) ? g_u16_lcd_chart_first_line
+                                                                   : g_u16_lcd_chart_head + 1u;
+        u16_scroll_start = g_u16_lcd_chart_head;
+    }
+    ILI9341_Set_Scroll_Start(u16_scroll_start);
+
+    g_u32_lcd_chart_samples++;
+    lcd_unlock();
+
+    return HAL_OK;
+}
+
+void lcd_chart_stop(void)
+{
+    lcd_lock();
+    if (g_u8_lcd_chart_active) {
+        ILI9341_Set_Scroll_Area(0u, LCD_CHART_LINES, 0u);
+        ILI9341_Set_Scroll_Start(0u);
+        g_u8_lcd_chart_active = 0u;
+    }
+    lcd_unlock();
+}
+
+/* Static functions --------------------------------------------------------- */
+/**
+ * @brief Position of a value on the value axis (index in the line).
+ *
+ * Horizontal time: index = screen row, the maximum is at the top.
+ * Vertical time: index = screen column, the maximum is at the right.
+ *
+ * @param series Range of the trace.
+ * @param value  Value, clamped to the range.
+ * @return 0 .. LCD_CHART_LINE_PIXELS - 1
+ */
+static uint16_t lcd_chart_position(const lcd_chart_series_t *series, int32_t value)
+{
+    uint32_t u32_scaled;
+
+    if (value < series->i32_min) {
+        value = series->i32_min;
+    } else if (value > series->i32_max) {
+        value = series->i32_max;
+    }
+
+    u32_scaled = (uint32_t)(((int64_t)(value - series->i32_min) * (LCD_CHART_LINE_PIXELS - 1u)) /
+                            (series->i32_max - series->i32_min));
+
+    return g_u8_lcd_chart_horizontal ? (uint16_t)(LCD_CHART_LINE_PIXELS - 1u - u32_scaled)
+                                     : (uint16_t)u32_scaled;
+}
+
+/**
+ * @brief Composes the line of one sample.
+ *
+ * @param values One value per trace.
+ * @return None
+ */
+static void lcd_chart_compose(const int32_t *values)
+{
+    const lcd_chart_config_t *config = &g_lcd_chart_config;
+    uint16_t u16_background = config->u16_background_color;
+
+    /* Time grid: dotted line across the whole value axis */
+    uint8_t u8_time_grid = (config->u16_grid_samples != 0u) &&
+                           ((g_u32_lcd_chart_samples % config->u16_grid_samples) == 0u);
+
+    for (uint16_t i = 0u; i < LCD_CHART_LINE_PIXELS; i++) {
+        g_u16_lcd_chart_line[i] = (u8_time_grid && ((i & 1u) == 0u)) ? config->u16_grid_color
+                                                                       : u16_background;
+    }
+
+    /* Value grid: one pixel per line, counted from the minimum edge */
+    if (config->u16_grid_pixels != 0u) {
+        for (uint16_t i = 0u; i < LCD_CHART_LINE_PIXELS; i += config->u16_grid_pixels) {
+            uint16_t u16_index = g_u8_lcd_chart_horizontal ? (LCD_CHART_LINE_PIXELS - 1u - i) : i;
+            g_u16_lcd_chart_line[u16_index] = config->u16_grid_color;
+        }
+    }
+
+    /* Traces: segment from the previous to the new position */
+    for (uint8_t s = 0u; s < config->u8_series_count; s++) {
+        uint16_t u16_position = lcd_chart_position(&config->series[s], values[s]);
+        uint16_t u16_from     = (g_u32_lcd_chart_samples == 0u) ? u16_position
+                                                                : g_u16_lcd_chart_previous[s];
+        uint16_t u16_low      = (u16_from < u16_position) ? u16_from : u16_position;
+        uint16_t u16_high     = (u16_from < u16_position) ? u16_position : u16_from;
+
+        for (uint16_t i = u16_low; i <= u16_high; i++) {
+            g_u16_lcd_chart_line[i] = config->series[s].u16_color;
+        }
+        g_u16_lcd_chart_previous[s] = u16_position;
+    }
+}
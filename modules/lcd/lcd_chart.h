@@ -0,0 +1,106 @@
+/**
+ ******************************************************************************
+ * @file        lcd_chart.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Scrolling strip chart on the ILI9341 hardware scroll.
+ *
+ * @details
+ * The chart is a band of frame memory lines that the controller scrolls
+ * (Vertical Scrolling Definition 0x33 / Start Address 0x37). Each sample
+ * composes one new line of pixels and moves the scroll start by one, the
+ * older samples move on without being sent again.
+ *
+ * The ILI9341 only scrolls along its 320 frame memory lines:
+ *  - Horizontal rotations (SCREEN_HORIZONTAL_x): time runs from left to
+ *    right, the chart covers the columns u16_start .. u16_start +
+ *    u16_length - 1 over the full screen height, values grow upwards.
+ *  - Vertical rotations (SCREEN_VERTICAL_x): time runs from top to
+ *    bottom over the full screen width, values grow to the right.
+ * Everything outside the chart band is a fixed area and can be used
+ * with the normal lcd functions (labels, scale, numbers).
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - Up to LCD_CHART_MAX_SERIES traces with own range and colour, each
+ *    sample is connected to the previous one
+ *  - Optional grid lines along the time and the value axis
+ *  - One address window and one DMA transfer of ILI9341_SCREEN_HEIGHT
+ *    pixels plus the 0x37 command per sample
+ *
+ * Only one chart at a time, the scroll area is a state of the controller.
+ * Set the rotation before lcd_chart_init(). Drawing into the chart band
+ * with other functions while it scrolls lands at shifted positions.
+ * SPI backend only (the LTDC scans the framebuffer without scrolling).
+ *
+ ******************************************************************************
+ */
+
+#ifndef LCD_LCD_CHART_H_
+#define LCD_LCD_CHART_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief Maximum number of traces in the chart.
+ */
+#define LCD_CHART_MAX_SERIES    2U
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Range and colour of one trace.
+ */
+typedef struct {
+    int32_t  i32_min;       /**< Value at the bottom (left) edge   */
+    int32_t  i32_max;       /**< Value at the top (right) edge     */
+    uint16_t u16_color;     /**< Trace colour                      */
+} lcd_chart_series_t;
+
+/**
+ * @brief Layout of the chart.
+ */
+typedef struct {
+    uint16_t u16_start;             /**< First screen column (row) of the band      */
+    uint16_t u16_length;            /**< Samples visible, columns (rows) of the band */
+    uint16_t u16_background_color;  /**< Colour behind the traces                   */
+    uint16_t u16_grid_color;        /**< Colour of the grid lines                   */
+    uint16_t u16_grid_pixels;       /**< Distance of the value grid lines, 0 = none */
+    uint16_t u16_grid_samples;      /**< Distance of the time grid lines, 0 = none  */
+    uint8_t  u8_series_count;       /**< Used entries of series[]                   */
+    lcd_chart_series_t series[LCD_CHART_MAX_SERIES];
+} lcd_chart_config_t;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Clears the chart band and sets up the scroll area for the
+ *        current rotation.
+ *
+ * @param config Layout, copied.
+ * @return HAL_OK, or HAL_ERROR for an invalid layout or the framebuffer
+ *         backend.
+ */
+HAL_StatusTypeDef lcd_chart_init(const lcd_chart_config_t *config);
+
+/**
+ * @brief Appends one sample of every trace at the newest edge and
+ *        scrolls the older samples by one line.
+ *
+ * @param values One value per trace (u8_series_count), clamped to the range.
+ * @return HAL_OK, or HAL_ERROR if no chart is active.
+ */
+HAL_StatusTypeDef lcd_chart_add(const int32_t *values);
+
+/**
+ * @brief Ends the chart and switches scrolling off.
+ *
+ * The band keeps its pixels but shows them unshifted, redraw it before
+ * it is used for something else.
+ *
+ * @return None
+ */
+void lcd_chart_stop(void);
+
+#endif /* LCD_LCD_CHART_H_ */
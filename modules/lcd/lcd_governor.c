@@ -0,0 +1,216 @@
+/**
+ ******************************************************************************
+ * @file        lcd_governor.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Frame rate governor of the display task.
+ *
+ * Functionality:
+ * - Frame period from the load of the rest of the system, paced by the
+ *   HAL tick (independent of clock changes, e.g. by modules/dvfs)
+ * - CPU time of a frame by the DWT cycle counter, converted at the clock
+ *   at the end of the frame
+ * - Cost per pixel of the dirty area as running average, limits the rate
+ *   so that the pending area fits the budget of a frame
+ ******************************************************************************
+ */
+
+#include "lcd_governor.h"
+#include "lcd/ILI9341_STM32_Driver.h"
+#include <bkptrace/bkptrace.h>
+#include <utils/utils.h>
+
+/* Preprocessor Defines ----------------------------------------------------- */
+/**
+ * @brief Largest dirty area: the whole screen.
+ */
+#define LCD_GOVERNOR_SCREEN_PIXELS  ((uint32_t)ILI9341_SCREEN_WIDTH * ILI9341_SCREEN_HEIGHT)
+
+/**
+ * @brief Fraction bits of the cost in ns per pixel.
+ */
+#define LCD_GOVERNOR_COST_SHIFT     4U
+
+/* Static module variables -------------------------------------------------- */
+/**
+ * @brief Statistics, also holding the current rate and load.
+ */
+static lcd_governor_stats_t g_lcd_governor_stats = { .u16_fps = LCD_GOVERNOR_MAX_FPS };
+
+/**
+ * @brief Pixels marked dirty since the last frame started.
+ */
+static uint32_t g_u32_lcd_governor_dirty;
+
+/**
+ * @brief Pixels of the running frame.
+ */
+static uint32_t g_u32_lcd_governor_frame_pixels;
+
+/**
+ * @brief Cost in ns per pixel (Q4), 0 until the first frame with a dirty
+ *        area was measured.
+ */
+static uint32_t g_u32_lcd_governor_cost;
+
+/**
+ * @brief HAL tick of the last frame start and cycle counter at the start
+ *        of the running frame.
+ */
+static uint32_t g_u32_lcd_governor_frame_tick;
+static uint32_t g_u32_lcd_governor_frame_cycles;
+
+/**
+ * @brief Load window: HAL tick of its start and CPU time of the frames
+ *        in it.
+ */
+static uint32_t g_u32_lcd_governor_window_tick;
+static uint32_t g_u32_lcd_governor_window_us;
+
+/**
+ * @brief Load as set, display share included.
+ */
+static uint16_t g_u16_lcd_governor_load;
+
+/* Static function prototypes ----------------------------------------------- */
+static void lcd_governor_rate(void);
+
+/* Public functions --------------------------------------------------------- */
+void lcd_governor_init(void)
+{
+    utils_timebase_init();
+
+    g_lcd_governor_stats             = (lcd_governor_stats_t){ 0 };
+    g_u32_lcd_governor_dirty         = 0u;
+    g_u32_lcd_governor_frame_pixels  = 0u;
+    g_u32_lcd_governor_cost          = 0u;
+    g_u16_lcd_governor_load          = 0u;
+    g_u32_lcd_governor_window_us     = 0u;
+    g_u32_lcd_governor_window_tick   = HAL_GetTick();
+    g_u32_lcd_governor_frame_tick    = g_u32_lcd_governor_window_tick - 1000u;
+    lcd_governor_rate();
+}
+
+void lcd_governor_mark_dirty(uint16_t u16_width, uint16_t u16_height)
+{
+    g_u32_lcd_governor_dirty += (uint32_t)u16_width * u16_height;
+    if (g_u32_lcd_governor_dirty > LCD_GOVERNOR_SCREEN_PIXELS) {
+        g_u32_lcd_governor_dirty = LCD_GOVERNOR_SCREEN_PIXELS;
+    }
+}
+
+void lcd_governor_set_load(uint16_t u16_load_permille)
+{
+    uint32_t u32_window_ms = HAL_GetTick() - g_u32_lcd_governor_window_tick;
+    uint32_t u32_share = 0u;
+
+    /* Share of the frames in the window the load was measured over */
+    if (u32_window_ms > 0u) {
+        u32_share = g_u32_lcd_governor_window_us / u32_window_ms;
+        if (u32_share > 1000u) {
+            u32_share = 1000u;
+        }
+    }
+    g_u32_lcd_governor_window_tick += u32_window_ms;
+    g_u32_lcd_governor_window_us = 0u;
+
+    g_u16_lcd_governor_load = (u16_load_permille > 1000u) ? 1000u : u16_load_permille;
+    g_lcd_governor_stats.u16_display_permille = (uint16_t)u32_share;
+    g_lcd_governor_stats.u16_load_permille =
+        (g_u16_lcd_governor_load > u32_share) ? (uint16_t)(g_u16_lcd_governor_load - u32_share) : 0u;
+    lcd_governor_rate();
+}
+
+uint8_t lcd_governor_begin(void)
+{
+    uint32_t u32_now = HAL_GetTick();
+
+    if ((u32_now - g_u32_lcd_governor_frame_tick) < 1000u / g_lcd_governor_stats.u16_fps) {
+        if (g_u32_lcd_governor_dirty > 0u) {
+            g_lcd_governor_stats.u32_held++;
+        }
+        return 0u;
+    }
+    if (g_u32_lcd_governor_dirty == 0u) {
+        /* The period stays over, the next mark draws at once */
+        g_lcd_governor_stats.u32_clean++;
+        g_u32_lcd_governor_frame_tick = u32_now - 1000u;
+        return 0u;
+    }
+
+    g_u32_lcd_governor_frame_tick   = u32_now;
+    g_u32_lcd_governor_frame_pixels = g_u32_lcd_governor_dirty;
+    g_u32_lcd_governor_dirty        = 0u;
+    g_u32_lcd_governor_frame_cycles = utils_now_cycles();
+    return 1u;
+}
+
+void lcd_governor_end(void)
+{
+    uint32_t u32_us = utils_elapsed_us(g_u32_lcd_governor_frame_cycles);
+
+    BKPTRACE_EVENT(BKPTRACE_EV_LCD_FRAME, u32_us);
+    g_lcd_governor_stats.u32_frames++;
+    g_lcd_governor_stats.u32_last_us = u32_us;
+    if (u32_us > g_lcd_governor_stats.u32_max_us) {
+        g_lcd_governor_stats.u32_max_us = u32_us;
+    }
+    if (u32_us > g_lcd_governor_stats.u32_budget_us) {
+        g_lcd_governor_stats.u32_over_budget++;
+    }
+    g_u32_lcd_governor_window_us += u32_us;
+
+    /* Cost per pixel, running average over about four frames */
+    uint32_t u32_cost = (uint32_t)(((uint64_t)u32_us * (1000u << LCD_GOVERNOR_COST_SHIFT)) /
+                                   g_u32_lcd_governor_frame_pixels);
+    if (g_u32_lcd_governor_cost == 0u) {
+        g_u32_lcd_governor_cost = u32_cost;
+    } else {
+        g_u32_lcd_governor_cost = g_u32_lcd_governor_cost - (g_u32_lcd_governor_cost >> 2) + (u32_cost >> 2);
+    }
+    lcd_governor_rate();
+}
+
+void lcd_governor_get_stats(lcd_governor_stats_t *stats)
+{
+    *stats = g_lcd_governor_stats;
+}
+
+/* Static functions --------------------------------------------------------- */
+/**
+ * @brief Sets rate and budget from the load and the cost of the pending
+ *        area.
+ *
+ * @return None
+ */
+static void lcd_governor_rate(void)
+{
+    uint32_t u32_load = g_lcd_governor_stats.u16_load_permille;
+    uint32_t u32_fps;
+
+    if (u32_load <= LCD_GOVERNOR_LOAD_LOW_PERMILLE) {
+        u32_fps = LCD_GOVERNOR_MAX_FPS;
+    } else if (u32_load >= LCD_GOVERNOR_LOAD_HIGH_PERMILLE) {
+        u32_fps = LCD_GOVERNOR_MIN_FPS;
+    } else {
+        u32_fps = LCD_GOVERNOR_MAX_FPS - ((LCD_GOVERNOR_MAX_FPS - LCD_GOVERNOR_MIN_FPS) *
+                                          (u32_load - LCD_GOVERNOR_LOAD_LOW_PERMILLE)) /
+                                         (LCD_GOVERNOR_LOAD_HIGH_PERMILLE - LCD_GOVERNOR_LOAD_LOW_PERMILLE);
+    }
+
+    /* The pending area (at least the last frame's) has to fit the budget */
+    uint32_t u32_pixels = (g_u32_lcd_governor_dirty > g_u32_lcd_governor_frame_pixels)
+                        ? g_u32_lcd_governor_dirty : g_u32_lcd_governor_frame_pixels;
+    uint32_t u32_cost_us = (uint32_t)(((uint64_t)u32_pixels * g_u32_lcd_governor_cost) /
+                                      (1000u << LCD_GOVERNOR_COST_SHIFT));
+    if (u32_cost_us > 0u) {
+        uint32_t u32_fit = (1000u * LCD_GOVERNOR_BUDGET_PERMILLE) / u32_cost_us;
+        if (u32_fit < u32_fps) {
+            u32_fps = (u32_fit < LCD_GOVERNOR_MIN_FPS) ? LCD_GOVERNOR_MIN_FPS : u32_fit;
+        }
+    }
+
+    g_lcd_governor_stats.u16_fps       = (uint16_t)u32_fps;
+    g_lcd_governor_stats.u32_budget_us = (1000u * LCD_GOVERNOR_BUDGET_PERMILLE) / u32_fps;
+}
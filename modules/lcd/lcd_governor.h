@@ -0,0 +1,154 @@
+/**
+ ******************************************************************************
+ * @file        lcd_governor.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Frame rate governor of the display task.
+ *
+ * @details
+ * Instead of redrawing as often as the main loop comes by, the display
+ * task asks the governor whether a frame is due and brackets the drawing
+ * with lcd_governor_begin() / lcd_governor_end():
+ *
+ *     if (lcd_governor_begin()) {
+ *         ... lcd_* calls ...
+ *         lcd_governor_end();
+ *     }
+ *
+ * The rate follows the CPU load of the rest of the system
+ * (lcd_governor_set_load(), e.g. from health_get(); the share of the
+ * display frames themselves is taken out): LCD_GOVERNOR_MAX_FPS up to
+ * LCD_GOVERNOR_LOAD_LOW_PERMILLE, LCD_GOVERNOR_MIN_FPS from
+ * LCD_GOVERNOR_LOAD_HIGH_PERMILLE on, linear in between.
+ *
+ * Every frame has a CPU budget of LCD_GOVERNOR_BUDGET_PERMILLE of its
+ * period. The areas the application marks dirty (lcd_governor_mark_dirty())
+ * and the measured CPU time of the frames give a cost per pixel; a
+ * pending area that would not fit the budget at the load rate lowers the
+ * rate further. Without a dirty area no frame is drawn at all.
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - Rate from LCD_GOVERNOR_MIN_FPS to LCD_GOVERNOR_MAX_FPS, recomputed
+ *    after every frame and every load update
+ *  - Frame time by the DWT cycle counter, CPU time only (the DMA of the
+ *    SPI backend runs on after lcd_governor_end())
+ *  - Statistics: frames, frames over budget, held back and clean
+ *    periods, last / worst frame time, rate, load and display share
+ *
+ ******************************************************************************
+ */
+
+#ifndef LCD_LCD_GOVERNOR_H_
+#define LCD_LCD_GOVERNOR_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief Lowest and highest frame rate in frames per second.
+ */
+#ifndef LCD_GOVERNOR_MIN_FPS
+#define LCD_GOVERNOR_MIN_FPS                4U
+#endif
+#ifndef LCD_GOVERNOR_MAX_FPS
+#define LCD_GOVERNOR_MAX_FPS                60U
+#endif
+
+/**
+ * @brief CPU load (without the display) up to which the highest rate is
+ *        used and from which the lowest rate is used, in 0.1 %.
+ */
+#ifndef LCD_GOVERNOR_LOAD_LOW_PERMILLE
+#define LCD_GOVERNOR_LOAD_LOW_PERMILLE      300U
+#endif
+#ifndef LCD_GOVERNOR_LOAD_HIGH_PERMILLE
+#define LCD_GOVERNOR_LOAD_HIGH_PERMILLE     800U
+#endif
+
+/**
+ * @brief CPU time a frame may take, in 0.1 % of its period.
+ */
+#ifndef LCD_GOVERNOR_BUDGET_PERMILLE
+#define LCD_GOVERNOR_BUDGET_PERMILLE        200U
+#endif
+
+#if (LCD_GOVERNOR_MIN_FPS == 0U) || (LCD_GOVERNOR_MIN_FPS > LCD_GOVERNOR_MAX_FPS)
+#error "LCD_GOVERNOR_MIN_FPS must be 1 .. LCD_GOVERNOR_MAX_FPS"
+#endif
+#if LCD_GOVERNOR_LOAD_LOW_PERMILLE >= LCD_GOVERNOR_LOAD_HIGH_PERMILLE
+#error "LCD_GOVERNOR_LOAD_LOW_PERMILLE must be below LCD_GOVERNOR_LOAD_HIGH_PERMILLE"
+#endif
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Statistics since lcd_governor_init().
+ */
+typedef struct {
+    uint32_t u32_frames;            /**< Frames drawn                          */
+    uint32_t u32_over_budget;       /**< Frames longer than their budget       */
+    uint32_t u32_held;              /**< Calls with a dirty area before the period ended */
+    uint32_t u32_clean;             /**< Periods without a dirty area          */
+    uint32_t u32_last_us;           /**< CPU time of the last frame            */
+    uint32_t u32_max_us;            /**< Longest frame                         */
+    uint32_t u32_budget_us;         /**< Budget at the current rate            */
+    uint16_t u16_fps;               /**< Current rate                          */
+    uint16_t u16_load_permille;     /**< Load without the display              */
+    uint16_t u16_display_permille;  /**< Share of the frames in the last load window */
+} lcd_governor_stats_t;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Starts the cycle counter, resets rate and statistics (highest
+ *        rate, nothing dirty).
+ *
+ * @return None
+ */
+void lcd_governor_init(void);
+
+/**
+ * @brief Adds an area that the next frame redraws (task context).
+ *
+ * @param u16_width  Width in pixels
+ * @param u16_height Height in pixels
+ * @return None
+ */
+void lcd_governor_mark_dirty(uint16_t u16_width, uint16_t u16_height);
+
+/**
+ * @brief Sets the CPU load measured over the last window (display
+ *        frames included, their share is subtracted) and recomputes the
+ *        rate.
+ *
+ * @param u16_load_permille Load in 0.1 %
+ * @return None
+ */
+void lcd_governor_set_load(uint16_t u16_load_permille);
+
+/**
+ * @brief Decides whether a frame is drawn now and starts its time.
+ *
+ * @return 1: draw and call lcd_governor_end(), 0: period not over or
+ *         nothing dirty
+ */
+uint8_t lcd_governor_begin(void);
+
+/**
+ * @brief Ends the frame started by lcd_governor_begin(): measures it,
+ *        updates the cost per pixel and the rate.
+ *
+ * @return None
+ */
+void lcd_governor_end(void);
+
+/**
+ * @brief Copies the statistics.
+ *
+ * @param stats Destination
+ * @return None
+ */
+void lcd_governor_get_stats(lcd_governor_stats_t *stats);
+
+#endif /* LCD_LCD_GOVERNOR_H_ */
@@ -0,0 +1,353 @@
+/**
+ ******************************************************************************
+ * @file        lcd_plot.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Min/max decimated plot of long histories.
+ *
+ * Functionality:
+ * - Merges every sample into the open bucket of level 0, a completed
+ *   bucket goes into the ring of its level and into the open bucket of
+ *   the next level
+ * - Maps the columns of the zoom level to buckets (newest = open buckets)
+ * - Diffs the span of every column against the drawn one and sends only
+ *   the rows that change colour
+ *
+ * Peripherals:
+ * - None directly, drawing goes through the lcd module (both backends)
+ ******************************************************************************
+ */
+
+#include "lcd_plot.h"
+#include "lcd/lcd.h"
+#include <string.h>
+
+/* Preprocessor Defines ----------------------------------------------------- */
+/**
+ * @brief Column span with nothing drawn (top below bottom).
+ */
+#define LCD_PLOT_EMPTY_TOP      0xFFFFU
+#define LCD_PLOT_EMPTY_BOTTOM   0U
+
+/* Static function prototypes ----------------------------------------------- */
+static void lcd_plot_merge(lcd_plot_bucket_t *bucket, uint16_t u16_fill, const lcd_plot_bucket_t *add);
+static uint8_t lcd_plot_open_column(const lcd_plot_t *plot, lcd_plot_bucket_t *bucket);
+static uint8_t lcd_plot_column(const lcd_plot_t *plot, uint16_t u16_index, uint8_t u8_open,
+                               const lcd_plot_bucket_t *open, lcd_plot_bucket_t *bucket);
+static void lcd_plot_span(const lcd_plot_t *plot, const lcd_plot_bucket_t *bucket, uint16_t *pu16_top,
+                          uint16_t *pu16_bottom);
+static uint16_t lcd_plot_row(const lcd_plot_t *plot, int32_t value);
+static uint8_t lcd_plot_fill(const lcd_plot_t *plot, uint16_t u16_column, uint16_t u16_from, uint16_t u16_to,
+                             uint16_t u16_color);
+static uint8_t lcd_plot_draw_column(lcd_plot_t *plot, uint16_t u16_column, uint16_t u16_top,
+                                    uint16_t u16_bottom);
+
+/* Public functions --------------------------------------------------------- */
+HAL_StatusTypeDef lcd_plot_init(lcd_plot_t *plot, const lcd_plot_config_t *config)
+{
+    if ((config->u16_width < 2u) || (config->u16_width > LCD_PLOT_COLUMNS) || (config->u16_height < 2u) ||
+        (config->i32_min >= config->i32_max) || (config->u16_base == 0u)) {
+        return HAL_ERROR;
+    }
+
+    memset(plot, 0, sizeof(*plot));
+    plot->config = *config;
+    lcd_plot_invalidate(plot);
+    return HAL_OK;
+}
+
+void lcd_plot_add(lcd_plot_t *plot, int32_t value)
+{
+    lcd_plot_bucket_t carry = { value, value };
+    uint8_t u8_level = 0u;
+
+    plot->u32_samples++;
+    lcd_plot_merge(&plot->open[0], plot->u16_open_fill[0], &carry);
+    if (++plot->u16_open_fill[0] < plot->config.u16_base) {
+        return;
+    }
+
+    /* Completed bucket: into the ring, one half of the next level */
+    for (;;) {
+        carry = plot->open[u8_level];
+        plot->u16_open_fill[u8_level] = 0u;
+        plot->ring[u8_level][plot->u32_done[u8_level] % LCD_PLOT_COLUMNS] = carry;
+        plot->u32_done[u8_level]++;
+
+        if (++u8_level >= LCD_PLOT_LEVELS) {
+            return;
+        }
+        lcd_plot_merge(&plot->open[u8_level], plot->u16_open_fill[u8_level], &carry);
+        if (++plot->u16_open_fill[u8_level] < 2u) {
+            return;
+        }
+    }
+}
+
+HAL_StatusTypeDef lcd_plot_zoom(lcd_plot_t *plot, uint8_t u8_level)
+{
+    if (u8_level >= LCD_PLOT_LEVELS) {
+        return HAL_ERROR;
+    }
+    if (u8_level != plot->u8_level) {
+        plot->u8_level = u8_level;
+        plot->u8_moved = 1u;
+    }
+    return HAL_OK;
+}
+
+uint8_t lcd_plot_zoom_fit(lcd_plot_t *plot)
+{
+    uint8_t u8_level = 0u;
+
+    while ((u8_level < (LCD_PLOT_LEVELS - 1u)) &&
+           (((uint64_t)plot->config.u16_width * ((uint32_t)plot->config.u16_base << u8_level)) <
+            plot->u32_samples)) {
+        u8_level++;
+    }
+    (void)lcd_plot_zoom(plot, u8_level);
+    return u8_level;
+}
+
+uint32_t lcd_plot_samples_per_column(const lcd_plot_t *plot)
+{
+    return (uint32_t)plot->config.u16_base << plot->u8_level;
+}
+
+HAL_StatusTypeDef lcd_plot_set_range(lcd_plot_t *plot, int32_t i32_min, int32_t i32_max)
+{
+    if (i32_min >= i32_max) {
+        return HAL_ERROR;
+    }
+    if ((i32_min != plot->config.i32_min) || (i32_max != plot->config.i32_max)) {
+        plot->config.i32_min = i32_min;
+        plot->config.i32_max = i32_max;
+        plot->u8_moved = 1u;
+    }
+    return HAL_OK;
+}
+
+uint16_t lcd_plot_draw(lcd_plot_t *plot)
+{
+    uint16_t u16_width = plot->config.u16_width;
+    lcd_plot_bucket_t open;
+    lcd_plot_bucket_t bucket;
+    uint8_t  u8_open = lcd_plot_open_column(plot, &open);
+    uint32_t u32_key = plot->u32_done[plot->u8_level] + u8_open;
+    uint16_t u16_first = 0u;
+    uint16_t u16_prev_top = LCD_PLOT_EMPTY_TOP;
+    uint16_t u16_prev_bottom = LCD_PLOT_EMPTY_BOTTOM;
+    uint16_t u16_sent = 0u;
+
+    /* Same buckets in the same columns: only the open one has changed */
+    if (plot->u8_valid && !plot->u8_moved && (u32_key == plot->u32_drawn_key)) {
+        u16_first = u16_width - 1u;
+    }
+    if ((u16_first > 0u) &&
+        lcd_plot_column(plot, u16_width - u16_first, u8_open, &open, &bucket)) {
+        lcd_plot_span(plot, &bucket, &u16_prev_top, &u16_prev_bottom);
+    }
+
+    lcd_lock();
+    for (uint16_t x = u16_first; x < u16_width; x++) {
+        uint16_t u16_top = LCD_PLOT_EMPTY_TOP;
+        uint16_t u16_bottom = LCD_PLOT_EMPTY_BOTTOM;
+        uint16_t u16_raw_top = LCD_PLOT_EMPTY_TOP;
+        uint16_t u16_raw_bottom = LCD_PLOT_EMPTY_BOTTOM;
+
+        if (lcd_plot_column(plot, u16_width - 1u - x, u8_open, &open, &bucket)) {
+            lcd_plot_span(plot, &bucket, &u16_raw_top, &u16_raw_bottom);
+            u16_top = u16_raw_top;
+            u16_bottom = u16_raw_bottom;
+
+            /* Touch the older neighbour so the trace stays connected */
+            if (u16_prev_top <= u16_prev_bottom) {
+                if (u16_top > u16_prev_bottom) {
+                    u16_top = u16_prev_bottom;
+                }
+                if (u16_bottom < u16_prev_top) {
+                    u16_bottom = u16_prev_top;
+                }
+            }
+        }
+        u16_sent += lcd_plot_draw_column(plot, x, u16_top, u16_bottom);
+        u16_prev_top = u16_raw_top;
+        u16_prev_bottom = u16_raw_bottom;
+    }
+    lcd_unlock();
+
+    plot->u32_drawn_key = u32_key;
+    plot->u8_valid = 1u;
+    plot->u8_moved = 0u;
+    return u16_sent;
+}
+
+void lcd_plot_invalidate(lcd_plot_t *plot)
+{
+    for (uint16_t i = 0u; i < LCD_PLOT_COLUMNS; i++) {
+        plot->u16_top[i] = LCD_PLOT_EMPTY_TOP;
+        plot->u16_bottom[i] = LCD_PLOT_EMPTY_BOTTOM;
+    }
+    plot->u8_valid = 0u;
+}
+
+/* Static functions --------------------------------------------------------- */
+/**
+ * @brief Widens a bucket by another one.
+ * @param bucket   Bucket to widen
+ * @param u16_fill Parts merged into it so far, 0: it is taken as it is
+ * @param add      Bucket added
+ */
+static void lcd_plot_merge(lcd_plot_bucket_t *bucket, uint16_t u16_fill, const lcd_plot_bucket_t *add)
+{
+    if (u16_fill == 0u) {
+        *bucket = *add;
+        return;
+    }
+    if (add->i32_min < bucket->i32_min) {
+        bucket->i32_min = add->i32_min;
+    }
+    if (add->i32_max > bucket->i32_max) {
+        bucket->i32_max = add->i32_max;
+    }
+}
+
+/**
+ * @brief Newest column: the open bucket of the zoom level and the open
+ *        buckets below it.
+ * @return 1 if it holds samples, 0 if the last sample completed it
+ */
+static uint8_t lcd_plot_open_column(const lcd_plot_t *plot, lcd_plot_bucket_t *bucket)
+{
+    uint16_t u16_parts = 0u;
+
+    for (uint8_t u8_level = 0u; u8_level <= plot->u8_level; u8_level++) {
+        if (plot->u16_open_fill[u8_level] > 0u) {
+            lcd_plot_merge(bucket, u16_parts++, &plot->open[u8_level]);
+        }
+    }
+    return (u16_parts > 0u) ? 1u : 0u;
+}
+
+/**
+ * @brief Bucket of a column at the zoom level.
+ * @param u16_index Column counted from the newest (0)
+ * @param u8_open   The newest column is the open bucket
+ * @return 1, or 0 if the history does not reach back that far
+ */
+static uint8_t lcd_plot_column(const lcd_plot_t *plot, uint16_t u16_index, uint8_t u8_open,
+                               const lcd_plot_bucket_t *open, lcd_plot_bucket_t *bucket)
+{
+    uint32_t u32_done = plot->u32_done[plot->u8_level];
+
+    if (u8_open) {
+        if (u16_index == 0u) {
+            *bucket = *open;
+            return 1u;
+        }
+        u16_index--;
+    }
+    if ((u16_index >= u32_done) || (u16_index >= LCD_PLOT_COLUMNS)) {
+        return 0u;
+    }
+    *bucket = plot->ring[plot->u8_level][(u32_done - 1u - u16_index) % LCD_PLOT_COLUMNS];
+    return 1u;
+}
+
+/**
+ * @brief Rows of the extremes of a bucket.
+ */
+static void lcd_plot_span(const lcd_plot_t *plot, const lcd_plot_bucket_t *bucket, uint16_t *pu16_top,
+                          uint16_t *pu16_bottom)
+{
+    *pu16_top = lcd_plot_row(plot, bucket->i32_max);
+    *pu16_bottom = lcd_plot_row(plot, bucket->i32_min);
+}
+
+/**
+ * @brief Row of a value relative to the top edge, clamped to the range.
+ */
+static uint16_t lcd_plot_row(const lcd_plot_t *plot, int32_t value)
+{
+    int32_t i32_min = plot->config.i32_min;
+    int32_t i32_max = plot->config.i32_max;
+
+    if (value > i32_max) {
+        value = i32_max;
+    } else if (value < i32_min) {
+        value = i32_min;
+    }
+    return (uint16_t)((((int64_t)i32_max - value) * (plot->config.u16_height - 1u)) /
+                      ((int64_t)i32_max - i32_min));
+}
+
+/**
+ * @brief Fills the rows u16_from .. u16_to of a column.
+ * @return 1 if anything was sent
+ */
+static uint8_t lcd_plot_fill(const lcd_plot_t *plot, uint16_t u16_column, uint16_t u16_from, uint16_t u16_to,
+                             uint16_t u16_color)
+{
+    if (u16_from > u16_to) {
+        return 0u;
+    }
+    lcd_draw_vertical_line(plot->config.u16_x + u16_column, plot->config.u16_y + u16_from,
+                           u16_to - u16_from + 1u, u16_color);
+    return 1u;
+}
+
+/**
+ * @brief Moves the drawn span of a column to a new one, only the rows
+ *        that change colour are sent (all rows after an invalidation).
+ * @return 1 if anything was sent
+ */
+static uint8_t lcd_plot_draw_column(lcd_plot_t *plot, uint16_t u16_column, uint16_t u16_top,
+                                    uint16_t u16_bottom)
+{
+    uint16_t u16_old_top = plot->u16_top[u16_column];
+    uint16_t u16_old_bottom = plot->u16_bottom[u16_column];
+    uint16_t u16_last = plot->config.u16_height - 1u;
+    uint16_t u16_fg = plot->config.u16_color;
+    uint16_t u16_bg = plot->config.u16_background_color;
+    uint8_t  u8_new = (u16_top <= u16_bottom) ? 1u : 0u;
+    uint8_t  u8_old = (u16_old_top <= u16_old_bottom) ? 1u : 0u;
+    uint8_t  u8_sent = 0u;
+
+    plot->u16_top[u16_column] = u16_top;
+    plot->u16_bottom[u16_column] = u16_bottom;
+
+    if (!plot->u8_valid) {
+        if (!u8_new) {
+            return lcd_plot_fill(plot, u16_column, 0u, u16_last, u16_bg);
+        }
+        u8_sent |= (u16_top > 0u) ? lcd_plot_fill(plot, u16_column, 0u, u16_top - 1u, u16_bg) : 0u;
+        u8_sent |= lcd_plot_fill(plot, u16_column, u16_top, u16_bottom, u16_fg);
+        u8_sent |= lcd_plot_fill(plot, u16_column, u16_bottom + 1u, u16_last, u16_bg);
+        return u8_sent;
+    }
+
+    if (!u8_old || !u8_new || (u16_top > u16_old_bottom) || (u16_bottom < u16_old_top)) {
+        /* Disjoint spans: clear the old one, draw the new one */
+        if (u8_old) {
+            u8_sent |= lcd_plot_fill(plot, u16_column, u16_old_top, u16_old_bottom, u16_bg);
+        }
+        if (u8_new) {
+            u8_sent |= lcd_plot_fill(plot, u16_column, u16_top, u16_bottom, u16_fg);
+        }
+        return u8_sent;
+    }
+
+    /* Overlapping spans: only the ends move */
+    if (u16_top < u16_old_top) {
+        u8_sent |= lcd_plot_fill(plot, u16_column, u16_top, u16_old_top - 1u, u16_fg);
+    } else {
+        u8_sent |= (u16_top > 0u) ? lcd_plot_fill(plot, u16_column, u16_old_top, u16_top - 1u, u16_bg) : 0u;
+    }
+    if (u16_bottom > u16_old_bottom) {
+        u8_sent |= lcd_plot_fill(plot, u16_column, u16_old_bottom + 1u, u16_bottom, u16_fg);
+    } else {
+        u8_sent |= lcd_plot_fill(plot, u16_column, u16_bottom + 1u, u16_old_bottom, u16_bg);
+    }
+    return u8_sent;
+}
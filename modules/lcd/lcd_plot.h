@@ -0,0 +1,191 @@
+/**
+ ******************************************************************************
+ * @file        lcd_plot.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Min/max decimated plot of long histories.
+ *
+ * @details
+ * Hours of RPM or pressure do not fit into the columns of the screen, and
+ * scanning 100k samples for every redraw is far too slow. The plot keeps
+ * a min/max pyramid instead, updated with every sample:
+ *
+ *   level 0     buckets of u16_base samples
+ *   level L     buckets of u16_base << L samples, two of level L - 1
+ *
+ * Every level stores its last LCD_PLOT_COLUMNS completed buckets in a
+ * ring plus the bucket still being filled. lcd_plot_add() is O(1)
+ * amortised (one merge per level at most, two on average). At zoom level
+ * L one column of the plot is one bucket of that level: the newest
+ * column is the open bucket (together with the open buckets below it),
+ * the others come straight from the ring, so a redraw is O(columns) and
+ * a zoom only picks another level.
+ *
+ * A column is drawn as one vertical span from its minimum to its
+ * maximum, stretched to touch the span of its older neighbour so the
+ * trace stays connected. The plot remembers the span of every column on
+ * the screen and only sends the rows that change: while the newest
+ * bucket fills only the last column is touched, when the columns move on
+ * by one the diff of each column is usually a few pixels.
+ *
+ * Memory: LCD_PLOT_LEVELS * LCD_PLOT_COLUMNS * 8 bytes for the pyramid
+ * (20 KB with the defaults) plus 4 bytes per column for the drawn spans,
+ * all inside lcd_plot_t (static, or SDRAM for several plots).
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - Any history length, the oldest buckets of a level fall out of its
+ *    ring; level L shows the last LCD_PLOT_COLUMNS * (u16_base << L)
+ *    samples
+ *  - Zoom by level, lcd_plot_zoom_fit() for the whole history
+ *  - Range change and invalidation for redraws after other lcd calls
+ *  - Drawing through the lcd module (span fills of ILI9341_GFX.c on the
+ *    SPI backend, framebuffer fills on the LTDC backend), inside the
+ *    current viewport
+ *
+ * lcd_plot_add() and lcd_plot_draw() belong to the same context (main
+ * loop or one scheduler task).
+ *
+ ******************************************************************************
+ */
+
+#ifndef LCD_LCD_PLOT_H_
+#define LCD_LCD_PLOT_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief Widest plot in columns (the long side of the ILI9341).
+ */
+#ifndef LCD_PLOT_COLUMNS
+#define LCD_PLOT_COLUMNS    320U
+#endif
+
+/**
+ * @brief Levels of the pyramid (zoom steps of a factor of two).
+ */
+#ifndef LCD_PLOT_LEVELS
+#define LCD_PLOT_LEVELS     8U
+#endif
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Extremes of the samples of one bucket.
+ */
+typedef struct {
+    int32_t i32_min;
+    int32_t i32_max;
+} lcd_plot_bucket_t;
+
+/**
+ * @brief Layout and scaling of a plot.
+ */
+typedef struct {
+    uint16_t u16_x;                 /**< Left edge                                 */
+    uint16_t u16_y;                 /**< Top edge                                  */
+    uint16_t u16_width;             /**< Columns, 2 .. LCD_PLOT_COLUMNS            */
+    uint16_t u16_height;            /**< Rows, at least 2                          */
+    int32_t  i32_min;               /**< Value at the bottom row                   */
+    int32_t  i32_max;               /**< Value at the top row                      */
+    uint16_t u16_base;              /**< Samples per level 0 bucket, at least 1    */
+    uint16_t u16_color;             /**< Trace colour                              */
+    uint16_t u16_background_color;  /**< Colour around the trace                   */
+} lcd_plot_config_t;
+
+/**
+ * @brief State of one plot.
+ */
+typedef struct {
+    lcd_plot_config_t config;
+    lcd_plot_bucket_t ring[LCD_PLOT_LEVELS][LCD_PLOT_COLUMNS]; /**< Completed buckets    */
+    lcd_plot_bucket_t open[LCD_PLOT_LEVELS];    /**< Buckets being filled                 */
+    uint16_t u16_open_fill[LCD_PLOT_LEVELS];    /**< Samples (level 0) or halves in open  */
+    uint32_t u32_done[LCD_PLOT_LEVELS];         /**< Buckets completed since init         */
+    uint32_t u32_samples;                       /**< Samples since init                   */
+    uint16_t u16_top[LCD_PLOT_COLUMNS];         /**< Drawn span per column, top > bottom:  */
+    uint16_t u16_bottom[LCD_PLOT_COLUMNS];      /**< nothing drawn                        */
+    uint32_t u32_drawn_key;                     /**< Column position of the last draw     */
+    uint8_t  u8_level;                          /**< Zoom level shown                     */
+    uint8_t  u8_valid;                          /**< 0: next draw paints every row        */
+    uint8_t  u8_moved;                          /**< Zoom or range changed since the draw */
+} lcd_plot_t;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Sets up an empty plot at zoom level 0, nothing is drawn until
+ *        lcd_plot_draw().
+ *
+ * @param plot   Plot state
+ * @param config Layout, copied
+ * @return HAL_OK, HAL_ERROR for an invalid layout
+ */
+HAL_StatusTypeDef lcd_plot_init(lcd_plot_t *plot, const lcd_plot_config_t *config);
+
+/**
+ * @brief Adds the next sample to every level of the pyramid.
+ *
+ * @param plot  Plot state
+ * @param value Sample, any value (clamped to the range when drawn)
+ * @return None
+ */
+void lcd_plot_add(lcd_plot_t *plot, int32_t value);
+
+/**
+ * @brief Selects the zoom level, one column per bucket of that level.
+ *
+ * @param plot    Plot state
+ * @param u8_level 0 .. LCD_PLOT_LEVELS - 1
+ * @return HAL_OK, HAL_ERROR for an invalid level
+ */
+HAL_StatusTypeDef lcd_plot_zoom(lcd_plot_t *plot, uint8_t u8_level);
+
+/**
+ * @brief Selects the lowest zoom level that shows all samples since
+ *        lcd_plot_init() (the highest one if the history is longer).
+ *
+ * @param plot Plot state
+ * @return Level selected
+ */
+uint8_t lcd_plot_zoom_fit(lcd_plot_t *plot);
+
+/**
+ * @brief Returns the samples per column at the current zoom level.
+ *
+ * @param plot Plot state
+ * @return u16_base << level
+ */
+uint32_t lcd_plot_samples_per_column(const lcd_plot_t *plot);
+
+/**
+ * @brief Changes the value range, the next draw moves every column.
+ *
+ * @param plot    Plot state
+ * @param i32_min Value at the bottom row
+ * @param i32_max Value at the top row, above i32_min
+ * @return HAL_OK, HAL_ERROR for an empty range
+ */
+HAL_StatusTypeDef lcd_plot_set_range(lcd_plot_t *plot, int32_t i32_min, int32_t i32_max);
+
+/**
+ * @brief Brings the screen up to date: the newest column only, or every
+ *        column after new buckets, a zoom or a range change, each by
+ *        the rows that differ from the drawn span.
+ *
+ * @param plot Plot state
+ * @return Columns sent to the display
+ */
+uint16_t lcd_plot_draw(lcd_plot_t *plot);
+
+/**
+ * @brief Forgets the drawn spans, the next draw paints the whole area
+ *        (after lcd_fill_screen() or anything else drawn over the plot).
+ *
+ * @param plot Plot state
+ * @return None
+ */
+void lcd_plot_invalidate(lcd_plot_t *plot);
+
+#endif /* LCD_LCD_PLOT_H_ */
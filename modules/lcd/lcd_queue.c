@@ -0,0 +1,363 @@
+/**
+ ******************************************************************************
+ * @file        lcd_queue.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Deferred drawing through a fixed-capacity command queue.
+ *
+ * Functionality:
+ * - Single-producer / single-consumer ring buffer of draw commands
+ * - Flush drops commands covered by later opaque commands, merges
+ *   adjacent same-colour rectangles and replays the rest in order
+ * - Texts in blocks of the shared pool, freed once replayed or dropped
+ ******************************************************************************
+ */
+
+#include "lcd_queue.h"
+#include "lcd/lcd.h"
+#include "pool/pool.h"
+#include <string.h>
+
+/* Preprocessor Defines ----------------------------------------------------- */
+/**
+ * @brief Character cell of the 5x5 font at size 1 (see 5x5_font.h).
+ */
+#define LCD_QUEUE_CHAR_WIDTH    6U
+#define LCD_QUEUE_CHAR_HEIGHT   8U
+
+/**
+ * @brief Full scale bargraph value.
+ */
+#define LCD_QUEUE_BARGRAPH_MAX  1000U
+
+#if (LCD_QUEUE_TEXT_LENGTH + 1U) > POOL_SMALL_SIZE
+#error "A queued text must fit into a small pool block"
+#endif
+
+/* Type Definitions --------------------------------------------------------- */
+/**
+ * @brief Kinds of queued commands.
+ */
+typedef enum {
+    LCD_QUEUE_CMD_NONE = 0,         /**< Dropped during flush              */
+    LCD_QUEUE_CMD_TEXT,
+    LCD_QUEUE_CMD_RECT,
+    LCD_QUEUE_CMD_FILLED_RECT,
+    LCD_QUEUE_CMD_BARGRAPH,
+    LCD_QUEUE_CMD_FILL_SCREEN
+} lcd_queue_cmd_type_t;
+
+/**
+ * @brief One queued command. x0/y0 inclusive, x1/y1 exclusive.
+ */
+typedef struct {
+    lcd_queue_cmd_type_t type;
+    uint16_t x0;
+    uint16_t y0;
+    uint16_t x1;
+    uint16_t y1;
+    uint16_t color;
+    uint16_t bg_color;
+    uint16_t param;                 /**< Text: size, bargraph: value       */
+    char *p_text;                   /**< Text: pool block, otherwise NULL  */
+} lcd_queue_cmd_t;
+
+/* Static module variables -------------------------------------------------- */
+/**
+ * @brief Command ring buffer.
+ */
+static lcd_queue_cmd_t g_lcd_queue[LCD_QUEUE_LENGTH];
+
+/**
+ * @brief Next slot to replay, written by the flushing context only.
+ */
+static volatile uint8_t g_u8_lcd_queue_head = 0u;
+
+/**
+ * @brief Next free slot, written by the recording context only.
+ */
+static volatile uint8_t g_u8_lcd_queue_tail = 0u;
+
+/* Static function prototypes ----------------------------------------------- */
+static lcd_queue_cmd_t *lcd_queue_reserve(void);
+static void lcd_queue_commit(void);
+static uint8_t lcd_queue_is_opaque(const lcd_queue_cmd_t *cmd);
+static uint8_t lcd_queue_covers(const lcd_queue_cmd_t *outer, const lcd_queue_cmd_t *inner);
+static void lcd_queue_optimize(uint8_t head, uint8_t tail);
+static void lcd_queue_execute(const lcd_queue_cmd_t *cmd);
+
+/* Public functions --------------------------------------------------------- */
+HAL_StatusTypeDef lcd_queue_text_at_line(const char *text, uint8_t line, uint16_t color,
+                                         uint16_t size, uint16_t background_color)
+{
+    /* Same placement as lcd_draw_text_at_line() */
+    return lcd_queue_text_at_coord(text, 10u, line * (8u * size) + 10u,
+                                   color, size, background_color);
+}
+
+HAL_StatusTypeDef lcd_queue_text_at_coord(const char *text, uint16_t x, uint16_t y,
+                                          uint16_t color, uint16_t size,
+                                          uint16_t background_color)
+{
+    lcd_queue_cmd_t *cmd = lcd_queue_reserve();
+    size_t length = strnlen(text, LCD_QUEUE_TEXT_LENGTH);
+
+    if (cmd == NULL) {
+        return HAL_BUSY;
+    }
+
+    cmd->p_text = pool_shared_alloc((uint16_t)(length + 1u));
+    if (cmd->p_text == NULL) {
+        return HAL_BUSY;
+    }
+
+    cmd->type     = LCD_QUEUE_CMD_TEXT;
+    cmd->x0       = x;
+    cmd->y0       = y;
+    cmd->x1       = x + length * LCD_QUEUE_CHAR_WIDTH * size;
+    cmd->y1       = y + LCD_QUEUE_CHAR_HEIGHT * size;
+    cmd->color    = color;
+    cmd->bg_color = background_color;
+    cmd->param    = size;
+    memcpy(cmd->p_text, text, length);
+    cmd->p_text[length] = '\0';
+
+    lcd_queue_commit();
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef lcd_queue_rect(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1,
+                                 uint16_t color, uint8_t filled)
+{
+    lcd_queue_cmd_t *cmd = lcd_queue_reserve();
+
+    if (cmd == NULL) {
+        return HAL_BUSY;
+    }
+
+    cmd->type  = filled ? LCD_QUEUE_CMD_FILLED_RECT : LCD_QUEUE_CMD_RECT;
+    cmd->x0    = (x0 < x1) ? x0 : x1;
+    cmd->y0    = (y0 < y1) ? y0 : y1;
+    cmd->x1    = (x0 < x1) ? x1 : x0;
+    cmd->y1    = (y0 < y1) ? y1 : y0;
+    cmd->color = color;
+
+    lcd_queue_commit();
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef lcd_queue_bargraph(uint16_t x, uint16_t y, uint16_t width, uint16_t height,
+                                     uint16_t value, uint16_t color, uint16_t bgcolor)
+{
+    lcd_queue_cmd_t *cmd = lcd_queue_reserve();
+
+    if (cmd == NULL) {
+        return HAL_BUSY;
+    }
+
+    cmd->type     = LCD_QUEUE_CMD_BARGRAPH;
+    cmd->x0       = x;
+    cmd->y0       = y;
+    cmd->x1       = x + width;
+    cmd->y1       = y + height;
+    cmd->color    = color;
+    cmd->bg_color = bgcolor;
+    cmd->param    = (value > LCD_QUEUE_BARGRAPH_MAX) ? LCD_QUEUE_BARGRAPH_MAX : value;
+
+    lcd_queue_commit();
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef lcd_queue_fill_screen(uint16_t color)
+{
+    lcd_queue_cmd_t *cmd = lcd_queue_reserve();
+
+    if (cmd == NULL) {
+        return HAL_BUSY;
+    }
+
+    cmd->type  = LCD_QUEUE_CMD_FILL_SCREEN;
+    cmd->x0    = 0u;
+    cmd->y0    = 0u;
+    cmd->x1    = 0xFFFFu;
+    cmd->y1    = 0xFFFFu;
+    cmd->color = color;
+
+    lcd_queue_commit();
+    return HAL_OK;
+}
+
+uint8_t lcd_queue_flush(uint8_t max_commands)
+{
+    uint8_t u8_head = g_u8_lcd_queue_head;
+    uint8_t u8_tail = g_u8_lcd_queue_tail;   /* Snapshot, later commands wait */
+    uint8_t u8_done = 0u;
+
+    lcd_queue_optimize(u8_head, u8_tail);
+
+    while ((u8_head != u8_tail) && ((max_commands == 0u) || (u8_done < max_commands))) {
+        if (g_lcd_queue[u8_head].type != LCD_QUEUE_CMD_NONE) {
+            lcd_queue_execute(&g_lcd_queue[u8_head]);
+            u8_done++;
+        }
+        pool_shared_free(g_lcd_queue[u8_head].p_text);
+
+        u8_head = (u8_head + 1u) % LCD_QUEUE_LENGTH;
+        g_u8_lcd_queue_head = u8_head;
+    }
+
+    return lcd_queue_pending();
+}
+
+uint8_t lcd_queue_pending(void)
+{
+    return (g_u8_lcd_queue_tail + LCD_QUEUE_LENGTH - g_u8_lcd_queue_head) % LCD_QUEUE_LENGTH;
+}
+
+/* Static functions --------------------------------------------------------- */
+/**
+ * @brief Returns the next free slot without publishing it.
+ *
+ * @return Pointer to the slot or NULL if the queue is full.
+ */
+static lcd_queue_cmd_t *lcd_queue_reserve(void)
+{
+    if (((g_u8_lcd_queue_tail + 1u) % LCD_QUEUE_LENGTH) == g_u8_lcd_queue_head) {
+        return NULL;
+    }
+
+    g_lcd_queue[g_u8_lcd_queue_tail].p_text = NULL;
+    return &g_lcd_queue[g_u8_lcd_queue_tail];
+}
+
+/**
+ * @brief Publishes the slot returned by lcd_queue_reserve().
+ */
+static void lcd_queue_commit(void)
+{
+    __DMB();
+    g_u8_lcd_queue_tail = (g_u8_lcd_queue_tail + 1u) % LCD_QUEUE_LENGTH;
+}
+
+/**
+ * @brief Returns 1 if the command overwrites every pixel of its area.
+ */
+static uint8_t lcd_queue_is_opaque(const lcd_queue_cmd_t *cmd)
+{
+    return (cmd->type == LCD_QUEUE_CMD_TEXT) || (cmd->type == LCD_QUEUE_CMD_FILLED_RECT) ||
+           (cmd->type == LCD_QUEUE_CMD_BARGRAPH) || (cmd->type == LCD_QUEUE_CMD_FILL_SCREEN);
+}
+
+/**
+ * @brief Returns 1 if the area of 'outer' contains the area of 'inner'.
+ */
+static uint8_t lcd_queue_covers(const lcd_queue_cmd_t *outer, const lcd_queue_cmd_t *inner)
+{
+    return (outer->x0 <= inner->x0) && (outer->y0 <= inner->y0) &&
+           (outer->x1 >= inner->x1) && (outer->y1 >= inner->y1);
+}
+
+/**
+ * @brief Drops overdrawn commands and merges adjacent rectangles.
+ *
+ * Only commands in [head, tail) are touched, the recording context never
+ * writes to these slots.
+ */
+static void lcd_queue_optimize(uint8_t head, uint8_t tail)
+{
+    for (uint8_t i = head; i != tail; i = (i + 1u) % LCD_QUEUE_LENGTH) {
+        lcd_queue_cmd_t *cmd = &g_lcd_queue[i];
+
+        if (cmd->type == LCD_QUEUE_CMD_NONE) {
+            continue;
+        }
+
+        for (uint8_t j = (i + 1u) % LCD_QUEUE_LENGTH; j != tail; j = (j + 1u) % LCD_QUEUE_LENGTH) {
+            lcd_queue_cmd_t *later = &g_lcd_queue[j];
+
+            if (lcd_queue_is_opaque(later) && lcd_queue_covers(later, cmd)) {
+                /* Never drawn, the retained text layer still holds what
+                 * is actually on the screen */
+                cmd->type = LCD_QUEUE_CMD_NONE;
+                break;
+            }
+        }
+    }
+
+    /* Merge directly following filled rectangles that share an edge */
+    for (uint8_t i = head; i != tail; i = (i + 1u) % LCD_QUEUE_LENGTH) {
+        lcd_queue_cmd_t *cmd = &g_lcd_queue[i];
+        uint8_t j = (i + 1u) % LCD_QUEUE_LENGTH;
+
+        if (cmd->type != LCD_QUEUE_CMD_FILLED_RECT) {
+            continue;
+        }
+
+        while (j != tail) {
+            lcd_queue_cmd_t *next = &g_lcd_queue[j];
+
+            if (next->type == LCD_QUEUE_CMD_NONE) {
+                j = (j + 1u) % LCD_QUEUE_LENGTH;
+                continue;
+            }
+            if ((next->type != LCD_QUEUE_CMD_FILLED_RECT) || (next->color != cmd->color)) {
+                break;
+            }
+
+            if ((next->y0 == cmd->y0) && (next->y1 == cmd->y1) &&
+                ((next->x0 == cmd->x1) || (next->x1 == cmd->x0))) {
+                cmd->x0 = (next->x0 < cmd->x0) ? next->x0 : cmd->x0;
+                cmd->x1 = (next->x1 > cmd->x1) ? next->x1 : cmd->x1;
+            } else if ((next->x0 == cmd->x0) && (next->x1 == cmd->x1) &&
+                       ((next->y0 == cmd->y1) || (next->y1 == cmd->y0))) {
+                cmd->y0 = (next->y0 < cmd->y0) ? next->y0 : cmd->y0;
+                cmd->y1 = (next->y1 > cmd->y1) ? next->y1 : cmd->y1;
+            } else {
+                break;
+            }
+
+            next->type = LCD_QUEUE_CMD_NONE;
+            j = (j + 1u) % LCD_QUEUE_LENGTH;
+        }
+    }
+}
+
+/**
+ * @brief Draws one command through the lcd module.
+ */
+static void lcd_queue_execute(const lcd_queue_cmd_t *cmd)
+{
+    uint16_t u16_filled;
+
+    switch (cmd->type) {
+    case LCD_QUEUE_CMD_TEXT:
+        lcd_update_text_at_coord(cmd->p_text, cmd->x0, cmd->y0, cmd->color, cmd->param, cmd->bg_color);
+        break;
+
+    case LCD_QUEUE_CMD_RECT:
+        lcd_draw_rect(cmd->x0, cmd->y0, cmd->x1, cmd->y1, cmd->color, 0u);
+        break;
+
+    case LCD_QUEUE_CMD_FILLED_RECT:
+        lcd_draw_rect(cmd->x0, cmd->y0, cmd->x1, cmd->y1, cmd->color, 1u);
+        break;
+
+    case LCD_QUEUE_CMD_BARGRAPH:
+        u16_filled = cmd->x0 + ((uint32_t)(cmd->x1 - cmd->x0) * cmd->param) / LCD_QUEUE_BARGRAPH_MAX;
+        if (u16_filled > cmd->x0) {
+            lcd_draw_rect(cmd->x0, cmd->y0, u16_filled, cmd->y1, cmd->color, 1u);
+        }
+        if (u16_filled < cmd->x1) {
+            lcd_draw_rect(u16_filled, cmd->y0, cmd->x1, cmd->y1, cmd->bg_color, 1u);
+        }
+        break;
+
+    case LCD_QUEUE_CMD_FILL_SCREEN:
+        lcd_fill_screen(cmd->color);
+        break;
+
+    default:
+        break;
+    }
+}
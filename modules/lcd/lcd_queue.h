@@ -0,0 +1,107 @@
+/**
+ ******************************************************************************
+ * @file        lcd_queue.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Deferred drawing through a fixed-capacity command queue.
+ *
+ * @details
+ * Draw calls of this module only record a command and return immediately.
+ * lcd_queue_flush() replays the recorded commands through the lcd module,
+ * either from the idle part of the main loop or from a low-priority
+ * interrupt. Before drawing, commands whose area is completely covered by
+ * a later opaque command are dropped and horizontally adjacent filled
+ * rectangles of the same colour are merged into one address window.
+ *
+ * One context records, one context flushes. Texts are drawn through the
+ * retained text layer, so unchanged characters cost no SPI traffic. A
+ * queued text is copied into a block of the shared pool (modules/pool)
+ * instead of a text array in every slot; the block returns to the pool
+ * when the command is drawn or dropped.
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - Text, rectangle, bargraph and fill-screen commands
+ *  - Removal of overdrawn commands and merging of adjacent rectangles
+ *  - Time-bounded flushing
+ *
+ ******************************************************************************
+ */
+
+#ifndef LCD_LCD_QUEUE_H_
+#define LCD_LCD_QUEUE_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief Capacity of the command queue.
+ */
+#define LCD_QUEUE_LENGTH        32U
+
+/**
+ * @brief Maximum number of characters of a queued text.
+ */
+#define LCD_QUEUE_TEXT_LENGTH   40U
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Queues lcd_update_text_at_line().
+ *
+ * @return HAL_OK, or HAL_BUSY if the queue or the pool is full.
+ */
+HAL_StatusTypeDef lcd_queue_text_at_line(const char *text, uint8_t line, uint16_t color,
+                                         uint16_t size, uint16_t background_color);
+
+/**
+ * @brief Queues lcd_update_text_at_coord(). The text is copied.
+ *
+ * @return HAL_OK, or HAL_BUSY if the queue or the pool is full.
+ */
+HAL_StatusTypeDef lcd_queue_text_at_coord(const char *text, uint16_t x, uint16_t y,
+                                          uint16_t color, uint16_t size,
+                                          uint16_t background_color);
+
+/**
+ * @brief Queues lcd_draw_rect().
+ *
+ * @return HAL_OK, or HAL_BUSY if the queue is full.
+ */
+HAL_StatusTypeDef lcd_queue_rect(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1,
+                                 uint16_t color, uint8_t filled);
+
+/**
+ * @brief Queues a horizontal bargraph (see my_lcd_draw_baargraph()).
+ *
+ * @param value Fill level 0 .. 1000.
+ * @return HAL_OK, or HAL_BUSY if the queue is full.
+ */
+HAL_StatusTypeDef lcd_queue_bargraph(uint16_t x, uint16_t y, uint16_t width, uint16_t height,
+                                     uint16_t value, uint16_t color, uint16_t bgcolor);
+
+/**
+ * @brief Queues lcd_fill_screen(). All commands queued before are dropped.
+ *
+ * @return HAL_OK, or HAL_BUSY if the queue is full.
+ */
+HAL_StatusTypeDef lcd_queue_fill_screen(uint16_t color);
+
+/**
+ * @brief Replays queued commands.
+ *
+ * @param max_commands Maximum number of commands to draw in this call,
+ *                     0 draws everything queued at the time of the call.
+ * @return Number of commands still queued.
+ */
+uint8_t lcd_queue_flush(uint8_t max_commands);
+
+/**
+ * @brief Returns the number of queued commands.
+ *
+ * @return Number of commands.
+ */
+uint8_t lcd_queue_pending(void);
+
+#endif /* LCD_LCD_QUEUE_H_ */
@@ -0,0 +1,177 @@
+/**
+ ******************************************************************************
+ * @file        lcd_template.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Static screen templates in flash, restored in one transfer.
+ *
+ * Functionality:
+ * - Looks the template up in the cache, decodes it into the next slot
+ *   (round robin) on a miss
+ * - Sends the RGB565 screen from the slot or the flash in one address
+ *   window, streams the rows of compressed templates without a cache
+ * - Invalidates the retained text layer, sets up the template fields
+ *
+ * Peripherals:
+ * - SPI5 / DMA through the ILI9341 driver or the DMA2D through the
+ *   framebuffer, depending on the lcd backend
+ ******************************************************************************
+ */
+
+#include "lcd_template.h"
+#include "lcd/lcd.h"
+#include "framebuffer/framebuffer.h"
+#include <lcd/ILI9341_STM32_Driver.h>
+#include <string.h>
+
+/* Preprocessor Defines ----------------------------------------------------- */
+/**
+ * @brief Pixels of one screen, the size of a cache slot.
+ */
+#define LCD_TEMPLATE_PIXELS     ((uint32_t)ILI9341_SCREEN_WIDTH * ILI9341_SCREEN_HEIGHT)
+
+/* Static module variables -------------------------------------------------- */
+/**
+ * @brief Cache slots: decoded pixels and the template they hold.
+ */
+static uint16_t *g_p_template_slot_pixels[LCD_TEMPLATE_CACHE_SLOTS];
+static const lcd_template_t *g_p_template_slot_owner[LCD_TEMPLATE_CACHE_SLOTS];
+static uint8_t g_u8_template_slots;
+static uint8_t g_u8_template_next_slot;
+
+/**
+ * @brief Decoded row of the framebuffer backend without a cache.
+ */
+static uint16_t g_u16_template_row[ILI9341_SCREEN_WIDTH];
+
+/* Static function prototypes ----------------------------------------------- */
+static const uint16_t *lcd_template_pixels(const lcd_template_t *tpl);
+static void lcd_template_stream(const ILI9341_Sprite_t *image);
+
+/* Public functions --------------------------------------------------------- */
+uint8_t lcd_template_set_cache(void *memory, uint32_t u32_size)
+{
+    uint32_t u32_slots = (memory != NULL) ? u32_size / (LCD_TEMPLATE_PIXELS * sizeof(uint16_t)) : 0u;
+
+    if (u32_slots > LCD_TEMPLATE_CACHE_SLOTS) {
+        u32_slots = LCD_TEMPLATE_CACHE_SLOTS;
+    }
+
+    lcd_lock();
+    for (uint32_t i = 0u; i < LCD_TEMPLATE_CACHE_SLOTS; i++) {
+        g_p_template_slot_pixels[i] = (i < u32_slots) ? &((uint16_t *)memory)[i * LCD_TEMPLATE_PIXELS] : NULL;
+        g_p_template_slot_owner[i]  = NULL;
+    }
+    g_u8_template_slots     = (uint8_t)u32_slots;
+    g_u8_template_next_slot = 0u;
+    lcd_unlock();
+
+    return (uint8_t)u32_slots;
+}
+
+HAL_StatusTypeDef lcd_template_show(const lcd_template_t *tpl, lcd_text_field_t *fields)
+{
+    const uint16_t *pixels;
+
+    if ((tpl->image.Width != LCD_WIDTH) || (tpl->image.Height != LCD_HEIGHT) ||
+        (tpl->image.Width * tpl->image.Height != LCD_TEMPLATE_PIXELS)) {
+        return HAL_ERROR;
+    }
+
+    lcd_lock();
+    lcd_invalidate();
+
+    pixels = lcd_template_pixels(tpl);
+    if (pixels == NULL) {
+        lcd_template_stream(&tpl->image);
+    } else if (lcd_get_backend() == LCD_BACKEND_FRAMEBUFFER) {
+        framebuffer_blit(pixels, 0u, 0u, tpl->image.Width, tpl->image.Height);
+    } else {
+        ILI9341_Set_Address(0u, 0u, tpl->image.Width - 1u, tpl->image.Height - 1u);
+        ILI9341_DMA_Transmit_Pixel_Buffer(pixels, LCD_TEMPLATE_PIXELS);
+    }
+
+    if (fields != NULL) {
+        for (uint8_t i = 0u; i < tpl->u8_fields; i++) {
+            const lcd_template_field_t *field = &tpl->fields[i];
+
+            lcd_text_field_init(&fields[i], field->u16_x, field->u16_y, field->font, field->u16_size,
+                                field->u16_color, field->u16_background_color);
+        }
+    }
+    lcd_unlock();
+
+    return HAL_OK;
+}
+
+void lcd_template_flush(void)
+{
+    lcd_lock();
+    memset(g_p_template_slot_owner, 0, sizeof(g_p_template_slot_owner));
+    g_u8_template_next_slot = 0u;
+    lcd_unlock();
+}
+
+/* Static functions --------------------------------------------------------- */
+/**
+ * @brief RGB565 screen of a template: the flash data itself, a cache slot
+ *        (decoded now on a miss) or NULL without a cache.
+ *
+ * @param tpl Template
+ * @return Pixels or NULL
+ */
+static const uint16_t *lcd_template_pixels(const lcd_template_t *tpl)
+{
+    uint16_t *slot;
+
+    if (tpl->image.Format == SPRITE_RGB565) {
+        return (const uint16_t *)tpl->image.Data;
+    }
+
+    for (uint8_t i = 0u; i < g_u8_template_slots; i++) {
+        if (g_p_template_slot_owner[i] == tpl) {
+            return g_p_template_slot_pixels[i];
+        }
+    }
+    if (g_u8_template_slots == 0u) {
+        return NULL;
+    }
+
+    /* The slot may still be in flight from an earlier show */
+    if (lcd_get_backend() == LCD_BACKEND_FRAMEBUFFER) {
+        framebuffer_wait();
+    } else {
+        ILI9341_DMA_Wait();
+    }
+
+    slot = g_p_template_slot_pixels[g_u8_template_next_slot];
+    g_p_template_slot_owner[g_u8_template_next_slot] = tpl;
+    g_u8_template_next_slot = (uint8_t)((g_u8_template_next_slot + 1u) % g_u8_template_slots);
+
+    ILI9341_Decode_Sprite(&tpl->image, slot);
+    return slot;
+}
+
+/**
+ * @brief Sends a compressed template row by row (no cache).
+ *
+ * @param image Template screen
+ * @return None
+ */
+static void lcd_template_stream(const ILI9341_Sprite_t *image)
+{
+    const uint8_t *pu8_source = (const uint8_t *)image->Data;
+
+    if (lcd_get_backend() != LCD_BACKEND_FRAMEBUFFER) {
+        ILI9341_Draw_Sprite(image, 0, 0);
+        return;
+    }
+
+    /* The blit of a row has finished before the next one is decoded */
+    for (uint16_t u16_row = 0u; u16_row < image->Height; u16_row++) {
+        pu8_source = ILI9341_Decode_Sprite_Row(image, pu8_source, g_u16_template_row);
+        framebuffer_blit(g_u16_template_row, 0u, u16_row, image->Width, 1u);
+        framebuffer_wait();
+    }
+}
@@ -0,0 +1,119 @@
+/**
+ ******************************************************************************
+ * @file        lcd_template.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Static screen templates in flash, restored in one transfer.
+ *
+ * @details
+ * A template is the static part of a screen (background, labels, frames,
+ * images) rasterised offline by template_convert.py from a description
+ * file, compressed like a sprite (usually SPRITE_RLE8), plus the positions
+ * and colours of its dynamic text fields. lcd_template_show() replaces the
+ * whole screen and sets up the fields, the application then only writes
+ * the values with lcd_text_field_update().
+ *
+ * The screen is restored in one address window:
+ *  - With a cache (lcd_template_set_cache(), e.g. in the SDRAM) the first
+ *    show decodes the template into a free slot, every later show sends
+ *    the slot in one transfer: one DMA2D copy on the framebuffer backend,
+ *    one queued pixel buffer on the SPI backend.
+ *  - A template converted as SPRITE_RGB565 goes to the display straight
+ *    from flash the same way (153 KB of flash per screen).
+ *  - Otherwise the rows are decoded while the previous one is sent
+ *    (ILI9341_Draw_Sprite(), framebuffer: a blit per row).
+ *
+ * Description file, one command per line, '#' starts a comment, colours
+ * are names of ILI9341_STM32_Driver.h or RGB565 values (0xF800):
+ *    background WHITE
+ *    text  X Y SIZE COLOUR BACKGROUND "Label"      (5x5 library font)
+ *    label LINE SIZE COLOUR BACKGROUND "Label"     (lcd_draw_text_at_line())
+ *    rect  X Y WIDTH HEIGHT COLOUR [fill]
+ *    hline X Y WIDTH COLOUR, vline X Y HEIGHT COLOUR
+ *    image X Y picture.ppm
+ *    field NAME X Y SIZE COLOUR BACKGROUND [FONT]  (dynamic, not drawn)
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - Full screen restore with one transfer from the cache or flash
+ *  - Round robin cache of decoded templates, LCD_TEMPLATE_CACHE_SLOTS
+ *  - Retained text regions are invalidated, fields start empty
+ *
+ * A template has the size of the display in its current orientation
+ * (240 x 320 after lcd_init()), lcd_template_show() refuses others.
+ *
+ ******************************************************************************
+ */
+
+#ifndef LCD_LCD_TEMPLATE_H_
+#define LCD_LCD_TEMPLATE_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+#include "lcd/ILI9341_GFX.h"
+#include "lcd/lcd_text_field.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief Decoded templates kept in the cache at most.
+ */
+#ifndef LCD_TEMPLATE_CACHE_SLOTS
+#define LCD_TEMPLATE_CACHE_SLOTS    4U
+#endif
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Dynamic text field of a template (see lcd_text_field_init()).
+ */
+typedef struct {
+    uint16_t u16_x;                 /**< Left edge on the screen                     */
+    uint16_t u16_y;                 /**< Top edge on the screen                      */
+    const ILI9341_Font_t *font;     /**< Proportional font, NULL: 5x5 library font   */
+    uint16_t u16_size;              /**< Scaling of the 5x5 library font             */
+    uint16_t u16_color;             /**< Text colour                                 */
+    uint16_t u16_background_color;  /**< Background colour                           */
+} lcd_template_field_t;
+
+/**
+ * @brief Screen template, generated by template_convert.py.
+ */
+typedef struct {
+    ILI9341_Sprite_t image;             /**< Static screen, full display size     */
+    const lcd_template_field_t *fields; /**< Dynamic fields, may be NULL          */
+    uint8_t u8_fields;                  /**< Number of fields                     */
+} lcd_template_t;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Gives the module memory for decoded templates, one slot per
+ *        240 x 320 RGB565 screen (153600 bytes). NULL disables the cache.
+ *
+ * @param memory    Half word aligned memory, e.g. in the SDRAM
+ * @param u32_size  Size in bytes
+ * @return Number of slots
+ */
+uint8_t lcd_template_set_cache(void *memory, uint32_t u32_size);
+
+/**
+ * @brief Replaces the screen by a template and sets up its fields.
+ *
+ * The transfer runs on after the return; a cache slot is only decoded
+ * into again after the transfers before have finished.
+ *
+ * @param tpl    Template
+ * @param fields tpl->u8_fields text fields, set up empty; NULL if the
+ *               application keeps its own
+ * @return HAL_OK, HAL_ERROR if the template does not match the display
+ *         size
+ */
+HAL_StatusTypeDef lcd_template_show(const lcd_template_t *tpl, lcd_text_field_t *fields);
+
+/**
+ * @brief Drops all decoded templates from the cache.
+ *
+ * @return None
+ */
+void lcd_template_flush(void);
+
+#endif /* LCD_LCD_TEMPLATE_H_ */
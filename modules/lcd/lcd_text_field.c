@@ -0,0 +1,163 @@
+/**
+ ******************************************************************************
+ * @file        lcd_text_field.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Text field widget with per-character diff rendering.
+ *
+ * Functionality:
+ * - Compares the new string with the drawn one character by character
+ * - Draws each run of changed characters with one lcd text call
+ * - Redraws the rest of the string once a character changes its width
+ * - Clears the cells of a longer previous string with one rectangle
+ *
+ * Peripherals:
+ * - None directly, drawing goes through the lcd module (both backends)
+ ******************************************************************************
+ */
+
+#include "lcd_text_field.h"
+#include "lcd/lcd.h"
+#include <string.h>
+
+/* Preprocessor Defines ----------------------------------------------------- */
+/**
+ * @brief Cell of the 5x5 library font at size 1 (see 5x5_font.h).
+ */
+#define LCD_TEXT_FIELD_CHAR_WIDTH   6U
+#define LCD_TEXT_FIELD_CHAR_HEIGHT  8U
+
+/* Static function prototypes ----------------------------------------------- */
+static uint16_t lcd_text_field_char_width(const lcd_text_field_t *field, char ch);
+static void lcd_text_field_draw_run(const lcd_text_field_t *field, const char *text, uint8_t length,
+                                    uint16_t x);
+
+/* Public functions --------------------------------------------------------- */
+void lcd_text_field_init(lcd_text_field_t *field, uint16_t x, uint16_t y, const ILI9341_Font_t *font,
+                         uint16_t size, uint16_t color, uint16_t background_color)
+{
+    memset(field, 0, sizeof(*field));
+    field->u16_x                = x;
+    field->u16_y                = y;
+    field->font                 = font;
+    field->u16_size             = (size == 0u) ? 1u : size;
+    field->u16_color            = color;
+    field->u16_background_color = background_color;
+}
+
+uint8_t lcd_text_field_update(lcd_text_field_t *field, const char *text)
+{
+    uint8_t  u8_length   = (uint8_t)strnlen(text, LCD_TEXT_FIELD_LENGTH);
+    uint8_t  u8_old      = field->u8_valid ? (uint8_t)strlen(field->ch_text) : 0u;
+    uint8_t  u8_shifted  = !field->u8_valid;     /* From here on every cell is redrawn */
+    uint8_t  u8_redrawn  = 0u;
+    uint16_t u16_x       = field->u16_x;
+    uint8_t  i           = 0u;
+
+    lcd_lock();
+    while (i < u8_length) {
+        if (!u8_shifted && (i < u8_old) && (text[i] == field->ch_text[i])) {
+            u16_x += lcd_text_field_char_width(field, text[i]);
+            i++;
+            continue;
+        }
+
+        /* Run of changed characters, one address window */
+        uint8_t  u8_start = i;
+        uint16_t u16_start_x = u16_x;
+
+        while ((i < u8_length) && (u8_shifted || (i >= u8_old) || (text[i] != field->ch_text[i]))) {
+            uint16_t u16_width = lcd_text_field_char_width(field, text[i]);
+
+            if ((i < u8_old) && (u16_width != lcd_text_field_char_width(field, field->ch_text[i]))) {
+                u8_shifted = 1u;
+            }
+            u16_x += u16_width;
+            i++;
+        }
+
+        lcd_text_field_draw_run(field, &text[u8_start], i - u8_start, u16_start_x);
+        u8_redrawn += i - u8_start;
+    }
+
+    /* Cells of the previous string behind the new end */
+    if (field->u8_valid && (field->u16_x + field->u16_width > u16_x)) {
+        uint16_t u16_height = (field->font != NULL) ? field->font->Height
+                                                    : LCD_TEXT_FIELD_CHAR_HEIGHT * field->u16_size;
+
+        lcd_draw_rect(u16_x, field->u16_y, field->u16_x + field->u16_width, field->u16_y + u16_height,
+                      field->u16_background_color, 1u);
+    }
+
+    memcpy(field->ch_text, text, u8_length);
+    field->ch_text[u8_length] = '\0';
+    field->u16_width = u16_x - field->u16_x;
+    field->u8_valid  = 1u;
+    lcd_unlock();
+
+    return u8_redrawn;
+}
+
+void lcd_text_field_set_color(lcd_text_field_t *field, uint16_t color, uint16_t background_color)
+{
+    if ((color != field->u16_color) || (background_color != field->u16_background_color)) {
+        field->u16_color            = color;
+        field->u16_background_color = background_color;
+        field->u8_valid             = 0u;
+    }
+}
+
+void lcd_text_field_invalidate(lcd_text_field_t *field)
+{
+    field->u8_valid = 0u;
+}
+
+/* Static functions --------------------------------------------------------- */
+/**
+ * @brief Width of the cell of one character including the spacing.
+ *
+ * @param field Field (font and size)
+ * @param ch    Character
+ * @return Pixels
+ */
+static uint16_t lcd_text_field_char_width(const lcd_text_field_t *field, char ch)
+{
+    const ILI9341_Font_t *font = field->font;
+    uint8_t u8_code = (uint8_t)ch;
+
+    if (font == NULL) {
+        return LCD_TEXT_FIELD_CHAR_WIDTH * field->u16_size;
+    }
+    if ((u8_code < font->First) || (u8_code > font->Last)) {
+        u8_code = font->First;
+    }
+
+    return font->Glyphs[u8_code - font->First].Width + font->Spacing;
+}
+
+/**
+ * @brief Draws a run of characters of the new string.
+ *
+ * @param field  Field (position, font, colours)
+ * @param text   First character of the run
+ * @param length Characters in the run
+ * @param x      Left edge of the run on the screen
+ * @return None
+ */
+static void lcd_text_field_draw_run(const lcd_text_field_t *field, const char *text, uint8_t length,
+                                    uint16_t x)
+{
+    char ch_run[LCD_TEXT_FIELD_LENGTH + 1];
+
+    memcpy(ch_run, text, length);
+    ch_run[length] = '\0';
+
+    if (field->font != NULL) {
+        lcd_draw_text_font(ch_run, x, field->u16_y, field->font, field->u16_color,
+                           field->u16_background_color);
+    } else {
+        lcd_draw_text_at_coord(ch_run, x, field->u16_y, field->u16_color, field->u16_size,
+                               field->u16_background_color);
+    }
+}
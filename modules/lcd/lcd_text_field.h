@@ -0,0 +1,104 @@
+/**
+ ******************************************************************************
+ * @file        lcd_text_field.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Text field widget with per-character diff rendering.
+ *
+ * @details
+ * A text field remembers the string it has drawn last. A new string is
+ * compared character by character and only the changed glyph cells are
+ * sent, adjacent changes in one lcd call. A 4 digit readout whose last
+ * digit changes costs one glyph.
+ *
+ * In a proportional font a changed character of a different width moves
+ * everything behind it, the field redraws from there on. Digits of the
+ * fonts in ILI9341_Fonts.h share one width, so numbers keep the cheap path.
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - 5x5 library font at any size or a proportional font (ILI9341_Fonts.h)
+ *  - Leftovers of a longer previous string are cleared with one rectangle
+ *  - Colour changes and lcd_text_field_invalidate() redraw the whole field
+ *
+ * The field owns its state, other lcd calls that draw over it (e.g.
+ * lcd_fill_screen()) require lcd_text_field_invalidate().
+ *
+ ******************************************************************************
+ */
+
+#ifndef LCD_LCD_TEXT_FIELD_H_
+#define LCD_LCD_TEXT_FIELD_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+#include "lcd/ILI9341_Fonts.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief Maximum number of characters of a field, longer strings are cut.
+ */
+#define LCD_TEXT_FIELD_LENGTH   16U
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief State of one text field.
+ */
+typedef struct {
+    uint16_t u16_x;                 /**< Left edge on the screen                     */
+    uint16_t u16_y;                 /**< Top edge on the screen                      */
+    const ILI9341_Font_t *font;     /**< Proportional font, NULL: 5x5 library font   */
+    uint16_t u16_size;              /**< Scaling of the 5x5 library font             */
+    uint16_t u16_color;             /**< Text colour                                 */
+    uint16_t u16_background_color;  /**< Colour of the glyph cells and the clearing  */
+    uint16_t u16_width;             /**< Pixels covered by the drawn string          */
+    uint8_t  u8_valid;              /**< 0: the next update redraws everything       */
+    char     ch_text[LCD_TEXT_FIELD_LENGTH + 1]; /**< String on the screen           */
+} lcd_text_field_t;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Sets up a field, nothing is drawn until lcd_text_field_update().
+ *
+ * @param field            Field state
+ * @param x                Left edge on the screen
+ * @param y                Top edge on the screen
+ * @param font             Proportional font, NULL for the 5x5 library font
+ * @param size             Scaling of the 5x5 library font (ignored for fonts)
+ * @param color            Text colour
+ * @param background_color Background colour
+ * @return None
+ */
+void lcd_text_field_init(lcd_text_field_t *field, uint16_t x, uint16_t y, const ILI9341_Font_t *font,
+                         uint16_t size, uint16_t color, uint16_t background_color);
+
+/**
+ * @brief Shows a new string, only the changed characters are drawn.
+ *
+ * @param field Field state
+ * @param text  Zero terminated string, at most LCD_TEXT_FIELD_LENGTH
+ *              characters are used
+ * @return Number of characters sent to the display
+ */
+uint8_t lcd_text_field_update(lcd_text_field_t *field, const char *text);
+
+/**
+ * @brief Changes the colours, the next update redraws the whole field.
+ *
+ * @param field            Field state
+ * @param color            Text colour
+ * @param background_color Background colour
+ * @return None
+ */
+void lcd_text_field_set_color(lcd_text_field_t *field, uint16_t color, uint16_t background_color);
+
+/**
+ * @brief Forgets the drawn string, the next update redraws the whole field.
+ *
+ * @param field Field state
+ * @return None
+ */
+void lcd_text_field_invalidate(lcd_text_field_t *field);
+
+#endif /* LCD_LCD_TEXT_FIELD_H_ */
@@ -0,0 +1,172 @@
+#!/usr/bin/env python3
+"""Converter from PPM images to ILI9341_Sprite_t C sources.
+
+Reads a binary PPM (P6, 8 bit per channel, e.g. ``convert logo.png
+logo.ppm`` or any image editor that exports PPM), reduces the pixels to
+RGB565 and writes a C file with the sprite data for ILI9341_Draw_Sprite()
+(see ILI9341_GFX.h for the formats).
+
+``--format auto`` (default) picks the smallest format the image fits:
+palette formats need at most 16 (INDEX4) or 256 (INDEX8, RLE8) distinct
+RGB565 colours, otherwise the image stays RGB565.
+
+Only the standard library is needed.
+
+Usage:
+    sprite_convert.py logo.ppm [--name logo] [--format auto|rgb565|index8|index4|rle8] [-o logo.c]
+"""
+
+import argparse
+import sys
+
+
+def read_ppm(path):
+    """Returns width, height and a list of (r, g, b) tuples."""
+    with open(path, "rb") as file:
+        data = file.read()
+
+    # Header: magic, width, height, maximum value, separated by whitespace,
+    # comments start with '#'
+    fields = []
+    pos = 0
+    while len(fields) < 4:
+        while data[pos:pos + 1].isspace():
+            pos += 1
+        if data[pos:pos + 1] == b"#":
+            pos = data.index(b"\n", pos) + 1
+            continue
+        start = pos
+        while not data[pos:pos + 1].isspace():
+            pos += 1
+        fields.append(data[start:pos])
+    pos += 1
+
+    if fields[0] != b"P6" or int(fields[3]) != 255:
+        sys.exit("%s: only binary PPM (P6) with 8 bit channels is supported" % path)
+
+    width, height = int(fields[1]), int(fields[2])
+    raw = data[pos:pos + width * height * 3]
+    if len(raw) != width * height * 3:
+        sys.exit("%s: truncated pixel data" % path)
+
+    pixels = [tuple(raw[i:i + 3]) for i in range(0, len(raw), 3)]
+    return width, height, pixels
+
+
+def rgb565(pixel):
+    r, g, b = pixel
+    return ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3)
+
+
+def rle_row(indices):
+    """PackBits style packets: N < 128 -> N+1 literals, N >= 128 -> run of N-127."""
+    out = []
+    pos = 0
+    while pos < len(indices):
+        run = 1
+        while pos + run < len(indices) and run < 128 and indices[pos + run] == indices[pos]:
+            run += 1
+        if run >= 2:
+            out += [127 + run, indices[pos]]
+            pos += run
+            continue
+
+        # Literals up to the next run of at least two
+        start = pos
+        while pos < len(indices) and pos - start < 128:
+            if pos + 1 < len(indices) and indices[pos + 1] == indices[pos]:
+                break
+            pos += 1
+        if pos == start:
+            pos += 1
+        out += [pos - start - 1] + indices[start:pos]
+    return out
+
+
+def encode(width, height, colours, fmt):
+    """Returns (palette or None, data bytes or words) for a format."""
+    if fmt == "rgb565":
+        return None, colours
+
+    palette = sorted(set(colours))
+    lookup = {c: i for i, c in enumerate(palette)}
+    indices = [lookup[c] for c in colours]
+    rows = [indices[y * width:(y + 1) * width] for y in range(height)]
+
+    if fmt == "index8":
+        return palette, indices
+    if fmt == "index4":
+        data = []
+        for row in rows:
+            row = row + [0] * (len(row) & 1)
+            data += [(row[i] << 4) | row[i + 1] for i in range(0, len(row), 2)]
+        return palette, data
+    data = []
+    for row in rows:
+        data += rle_row(row)
+    return palette, data
+
+
+def size_of(palette, data, fmt):
+    return (len(palette) * 2 if palette else 0) + len(data) * (2 if fmt == "rgb565" else 1)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("image", help="binary PPM (P6)")
+    parser.add_argument("--name", help="C symbol, default: file name")
+    parser.add_argument("--format", default="auto",
+                        choices=["auto", "rgb565", "index8", "index4", "rle8"])
+    parser.add_argument("-o", "--output", help="C file, default: stdout")
+    args = parser.parse_args()
+
+    width, height, pixels = read_ppm(args.image)
+    colours = [rgb565(p) for p in pixels]
+    distinct = len(set(colours))
+    name = args.name or args.image.rsplit("/", 1)[-1].split(".")[0]
+
+    candidates = ["rgb565"]
+    if distinct <= 256:
+        candidates += ["index8", "rle8"]
+    if distinct <= 16:
+        candidates += ["index4"]
+    if args.format != "auto":
+        if args.format not in candidates:
+            sys.exit("%s: %d colours do not fit %s" % (args.image, distinct, args.format))
+        candidates = [args.format]
+
+    encoded = {fmt: encode(width, height, colours, fmt) for fmt in candidates}
+    fmt = min(candidates, key=lambda f: size_of(*encoded[f], f))
+    palette, data = encoded[fmt]
+
+    lines = ["/* %s: %dx%d, %d colours, %s, %d bytes (RGB565: %d) */"
+             % (args.image, width, height, distinct, fmt.upper(),
+                size_of(palette, data, fmt), width * height * 2),
+             "#include <lcd/ILI9341_GFX.h>", ""]
+    if palette:
+        lines.append("static const uint16_t %s_palette[%d] = {" % (name, len(palette)))
+        for i in range(0, len(palette), 12):
+            lines.append("\t" + ", ".join("0x%04X" % c for c in palette[i:i + 12]) + ",")
+        lines += ["};", ""]
+
+    ctype, per_line, digits = ("uint16_t", 12, 4) if fmt == "rgb565" else ("uint8_t", 16, 2)
+    lines.append("static const %s %s_data[%d] = {" % (ctype, name, len(data)))
+    for i in range(0, len(data), per_line):
+        lines.append("\t" + ", ".join("0x%0*X" % (digits, v) for v in data[i:i + per_line]) + ",")
+    lines += ["};", ""]
+
+    lines += ["const ILI9341_Sprite_t %s = {" % name,
+              "\t%d, %d, SPRITE_%s, %s, %s_data" % (width, height, fmt.upper(),
+                                                   "%s_palette" % name if palette else "0", name),
+              "};", ""]
+
+    text = "\n".join(lines)
+    if args.output:
+        with open(args.output, "w") as file:
+            file.write(text)
+    else:
+        sys.stdout.write(text)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,213 @@
+#!/usr/bin/env python3
+"""Generator of lcd_template_t screens from a description file.
+
+Rasterises the static part of a screen (background, 5x5 font texts,
+rectangles, lines, PPM images) exactly as the lcd module draws it,
+compresses it like sprite_convert.py (smallest of RGB565 / INDEX8 / INDEX4
+/ RLE8, or --format) and writes a C source with the template and a header
+with one NAME_FIELD_<field> index per dynamic field (see lcd_template.h
+for the command list).
+
+Only the standard library is needed.
+
+Usage:
+    template_convert.py screen.tpl [--name screen] [--format auto|rgb565|index8|index4|rle8]
+                        [-o screen.c] [--header screen.h]
+"""
+
+import argparse
+import os
+import re
+import shlex
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import sprite_convert  # noqa: E402
+
+WIDTH, HEIGHT = 240, 320
+HERE = os.path.dirname(os.path.abspath(__file__))
+
+# lcd_draw_text_at_line(): x and y of a line
+LINE_X, LINE_Y = 10, 10
+
+
+def read_colours():
+    """Colour names of ILI9341_STM32_Driver.h."""
+    with open(os.path.join(HERE, "ILI9341_STM32_Driver.h")) as file:
+        return {m.group(1): int(m.group(2), 16)
+                for m in re.finditer(r"#define\s+([A-Z]+)\s+0x([0-9A-Fa-f]{4})\b", file.read())}
+
+
+def read_font():
+    """Column bytes of the 96 characters of 5x5_font.h."""
+    with open(os.path.join(HERE, "5x5_font.h")) as file:
+        text = file.read()
+    rows = re.findall(r"\{((?:\s*0x[0-9A-Fa-f]{2}\s*,?){6})\}", text)
+    return [[int(v, 16) for v in re.findall(r"0x([0-9A-Fa-f]{2})", row)] for row in rows]
+
+
+class Screen:
+    def __init__(self, colours, font):
+        self.pixels = [0xFFFF] * (WIDTH * HEIGHT)
+        self.colours = colours
+        self.font = font
+
+    def colour(self, token):
+        if token in self.colours:
+            return self.colours[token]
+        return int(token, 0) & 0xFFFF
+
+    def fill(self, x, y, width, height, colour):
+        for row in range(max(y, 0), min(y + height, HEIGHT)):
+            for col in range(max(x, 0), min(x + width, WIDTH)):
+                self.pixels[row * WIDTH + col] = colour
+
+    def text(self, x, y, size, colour, background, string):
+        """Glyph cells of 6 x 8 pixels per size step, like ILI9341_Draw_Text()."""
+        for i, char in enumerate(string):
+            code = ord(char) - 32 if ord(char) >= 32 else 0
+            columns = self.font[code] if code < len(self.font) else self.font[0]
+            for col in range(6 * size):
+                bits = columns[col // size]
+                for row in range(8 * size):
+                    on = bits & (1 << (row // size))
+                    self.fill(x + i * 6 * size + col, y + row, 1, 1, colour if on else background)
+
+    def image(self, x, y, path):
+        width, height, pixels = sprite_convert.read_ppm(path)
+        for row in range(height):
+            for col in range(width):
+                if 0 <= x + col < WIDTH and 0 <= y + row < HEIGHT:
+                    self.pixels[(y + row) * WIDTH + x + col] = sprite_convert.rgb565(pixels[row * width + col])
+
+
+def parse(path, screen):
+    """Draws the static commands, returns the fields in file order."""
+    fields = []
+    base = os.path.dirname(path)
+    with open(path) as file:
+        for number, line in enumerate(file, 1):
+            words = shlex.split(line, comments=True)
+            if not words:
+                continue
+            cmd, args = words[0], words[1:]
+            try:
+                if cmd == "background":
+                    screen.fill(0, 0, WIDTH, HEIGHT, screen.colour(args[0]))
+                elif cmd == "text":
+                    x, y, size = int(args[0]), int(args[1]), int(args[2])
+                    screen.text(x, y, size, screen.colour(args[3]), screen.colour(args[4]), args[5])
+                elif cmd == "label":
+                    line_no, size = int(args[0]), int(args[1])
+                    screen.text(LINE_X, line_no * 8 * size + LINE_Y, size,
+                                screen.colour(args[2]), screen.colour(args[3]), args[4])
+                elif cmd == "rect":
+                    x, y, width, height = (int(v) for v in args[:4])
+                    colour = screen.colour(args[4])
+                    if len(args) > 5 and args[5] == "fill":
+                        screen.fill(x, y, width, height, colour)
+                    else:
+                        screen.fill(x, y, width, 1, colour)
+                        screen.fill(x, y + height - 1, width, 1, colour)
+                        screen.fill(x, y, 1, height, colour)
+                        screen.fill(x + width - 1, y, 1, height, colour)
+                elif cmd == "hline":
+                    screen.fill(int(args[0]), int(args[1]), int(args[2]), 1, screen.colour(args[3]))
+                elif cmd == "vline":
+                    screen.fill(int(args[0]), int(args[1]), 1, int(args[2]), screen.colour(args[3]))
+                elif cmd == "image":
+                    screen.image(int(args[0]), int(args[1]), os.path.join(base, args[2]))
+                elif cmd == "field":
+                    fields.append({"name": args[0], "x": int(args[1]), "y": int(args[2]),
+                                   "size": int(args[3]), "colour": screen.colour(args[4]),
+                                   "background": screen.colour(args[5]),
+                                   "font": "&" + args[6] if len(args) > 6 else "NULL"})
+                else:
+                    sys.exit("%s:%d: unknown command '%s'" % (path, number, cmd))
+            except (IndexError, ValueError):
+                sys.exit("%s:%d: bad arguments for '%s'" % (path, number, cmd))
+    return fields
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("description", help="template description file")
+    parser.add_argument("--name", help="C symbol, default: file name")
+    parser.add_argument("--format", default="auto",
+                        choices=["auto", "rgb565", "index8", "index4", "rle8"])
+    parser.add_argument("-o", "--output", help="C file, default: NAME.c")
+    parser.add_argument("--header", help="header file, default: NAME.h next to the C file")
+    args = parser.parse_args()
+
+    name = args.name or os.path.basename(args.description).split(".")[0]
+    output = args.output or name + ".c"
+    header = args.header or os.path.join(os.path.dirname(output), name + ".h")
+
+    screen = Screen(read_colours(), read_font())
+    fields = parse(args.description, screen)
+    colours = screen.pixels
+    distinct = len(set(colours))
+
+    candidates = ["rgb565"]
+    if distinct <= 256:
+        candidates += ["index8", "rle8"]
+    if distinct <= 16:
+        candidates += ["index4"]
+    if args.format != "auto":
+        if args.format not in candidates:
+            sys.exit("%s: %d colours do not fit %s" % (args.description, distinct, args.format))
+        candidates = [args.format]
+
+    encoded = {fmt: sprite_convert.encode(WIDTH, HEIGHT, colours, fmt) for fmt in candidates}
+    fmt = min(candidates, key=lambda f: sprite_convert.size_of(*encoded[f], f))
+    palette, data = encoded[fmt]
+    source = os.path.basename(args.description)
+
+    guard = re.sub(r"\W", "_", os.path.basename(header)).upper() + "_"
+    lines = ["/* Generated by template_convert.py from %s, do not edit */" % source,
+             "#ifndef %s" % guard, "#define %s" % guard, "",
+             '#include "lcd/lcd_template.h"', ""]
+    for i, field in enumerate(fields):
+        lines.append("#define %s_FIELD_%s %du" % (name.upper(), field["name"].upper(), i))
+    lines += ["#define %s_FIELDS %du" % (name.upper(), len(fields)), "",
+              "extern const lcd_template_t %s;" % name, "", "#endif /* %s */" % guard, ""]
+    with open(header, "w") as file:
+        file.write("\n".join(lines))
+
+    lines = ["/* Generated by template_convert.py from %s: %d colours, %s, %d bytes (RGB565: %d) */"
+             % (source, distinct, fmt.upper(), sprite_convert.size_of(palette, data, fmt), WIDTH * HEIGHT * 2),
+             '#include "%s"' % os.path.basename(header), "", "#include <lcd/ILI9341_Fonts.h>", ""]
+    if palette:
+        lines.append("static const uint16_t %s_palette[%d] = {" % (name, len(palette)))
+        for i in range(0, len(palette), 12):
+            lines.append("\t" + ", ".join("0x%04X" % c for c in palette[i:i + 12]) + ",")
+        lines += ["};", ""]
+
+    ctype, per_line, digits = ("uint16_t", 12, 4) if fmt == "rgb565" else ("uint8_t", 16, 2)
+    lines.append("static const %s %s_data[%d] = {" % (ctype, name, len(data)))
+    for i in range(0, len(data), per_line):
+        lines.append("\t" + ", ".join("0x%0*X" % (digits, v) for v in data[i:i + per_line]) + ",")
+    lines += ["};", ""]
+
+    if fields:
+        lines.append("static const lcd_template_field_t %s_fields[%d] = {" % (name, len(fields)))
+        for field in fields:
+            lines.append("\t{ %d, %d, %s, %d, 0x%04X, 0x%04X },  /* %s */"
+                         % (field["x"], field["y"], field["font"], field["size"], field["colour"],
+                            field["background"], field["name"]))
+        lines += ["};", ""]
+
+    lines += ["const lcd_template_t %s = {" % name,
+              "\t{ %d, %d, SPRITE_%s, %s, %s_data }," % (WIDTH, HEIGHT, fmt.upper(),
+                                                       "%s_palette" % name if palette else "0", name),
+              "\t%s, %d" % ("%s_fields" % name if fields else "0", len(fields)),
+              "};", ""]
+    with open(output, "w") as file:
+        file.write("\n".join(lines))
+
+    sys.stderr.write("%s: %d colours, %s, %d bytes, %d fields\n"
+                     % (output, distinct, fmt.upper(), sprite_convert.size_of(palette, data, fmt), len(fields)))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,41 @@
+/**
+ ******************************************************************************
+ * @file        ll.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Register-level fast paths
+ *
+ * Functionality:
+ * - SPI transmit loop on TXE / BSY without handle state or timeout
+ *
+ * Resources:
+ * - None (the caller's peripheral)
+ ******************************************************************************
+ */
+
+#include "ll.h"
+
+/* Public functions --------------------------------------------------------- */
+void ll_spi_write8(SPI_TypeDef *spi, const uint8_t *pu8_data, uint16_t u16_size)
+{
+    if ((spi->CR1 & SPI_CR1_SPE) == 0U) {
+        spi->CR1 |= SPI_CR1_SPE;
+    }
+
+    for (uint16_t i = 0U; i < u16_size; i++) {
+        while ((spi->SR & SPI_SR_TXE) == 0U) {
+        }
+        *(volatile uint8_t *)&spi->DR = pu8_data[i];
+    }
+
+    /* TXE only means the last byte moved to the shift register */
+    while ((spi->SR & SPI_SR_TXE) == 0U) {
+    }
+    while ((spi->SR & SPI_SR_BSY) != 0U) {
+    }
+
+    /* Full duplex: the received bytes are not read, clear the overrun */
+    (void)spi->DR;
+    (void)spi->SR;
+}
@@ -0,0 +1,142 @@
+/**
+ ******************************************************************************
+ * @file        ll.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Register-level fast paths for GPIO, SPI, ADC and timers.
+ *
+ * @details
+ * The HAL stays in charge of clocks and peripheral init; only the
+ * accesses in hot loops go to the registers. HAL_GPIO_WritePin() is a
+ * call with parameter checks for one store to BSRR, HAL_SPI_Transmit()
+ * locks the handle, checks the state and sets up a timeout for every
+ * byte of a command. The macros here are the single store or load, the
+ * SPI loop is a small function without state machine.
+ *
+ * Pin groups are configured with LL_GPIO_CONFIG() instead of a
+ * GPIO_InitTypeDef: for a constant pin mask the compiler folds the
+ * field masks of MODER, OTYPER, OSPEEDR, PUPDR and AFR into constants,
+ * so one group costs one read-modify-write per register and no loop
+ * over the 16 pins as in HAL_GPIO_Init(). Modules name their groups
+ * once per port (e.g. ESD_PINS_PD), the same masks serve the BSRR
+ * stores.
+ *
+ * Every user module has its own switch (ILI9341_LL_ENABLE, FAN_LL_ENABLE,
+ * ...) that defaults to LL_ENABLE, so a suspected fast path can be
+ * compared with the HAL one per module.
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - GPIO: set, reset and combined set/reset through BSRR, pin read
+ *  - GPIO: configuration of a pin group of one port, field masks from
+ *    the pin mask at compile time (HAL mode, pull and speed constants)
+ *  - SPI: 8 bit transmit on TXE, wait for the last frame, clear the
+ *    overrun of the unused receive side
+ *  - ADC: end of conversion, data register
+ *  - TIM: capture/compare register by HAL channel (TIM_CHANNEL_1..4)
+ *
+ ******************************************************************************
+ */
+
+#ifndef LL_LL_H_
+#define LL_LL_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief Default of the per-module switches: 1 register fast paths,
+ *        0 HAL calls.
+ */
+#ifndef LL_ENABLE
+#define LL_ENABLE               1
+#endif
+
+/**
+ * @brief GPIO: drive pins high / low, both in one store (upper half of
+ *        set_reset resets), read one pin as GPIO_PinState.
+ */
+#define LL_GPIO_SET(port, pins)         ((port)->BSRR = (uint32_t)(pins))
+#define LL_GPIO_RESET(port, pins)       ((port)->BSRR = (uint32_t)(pins) << 16U)
+#define LL_GPIO_BSRR(port, set_reset)   ((port)->BSRR = (uint32_t)(set_reset))
+#define LL_GPIO_READ(port, pin) \
+    ((((port)->IDR & (uint32_t)(pin)) != 0U) ? GPIO_PIN_SET : GPIO_PIN_RESET)
+
+/**
+ * @brief Spreads the bits of a 16 bit pin mask to 2 bit (MODER, OSPEEDR,
+ *        PUPDR) or, for 8 pins, 4 bit fields (AFR) at the pin positions.
+ *        Multiplied by a field value they give the register value of all
+ *        pins of the mask; constants for a constant mask.
+ */
+#define LL_SPREAD2(pins) \
+    ((((uint32_t)(pins) & 0x0001U) <<  0U) | (((uint32_t)(pins) & 0x0002U) <<  1U) | \
+     (((uint32_t)(pins) & 0x0004U) <<  2U) | (((uint32_t)(pins) & 0x0008U) <<  3U) | \
+     (((uint32_t)(pins) & 0x0010U) <<  4U) | (((uint32_t)(pins) & 0x0020U) <<  5U) | \
+     (((uint32_t)(pins) & 0x0040U) <<  6U) | (((uint32_t)(pins) & 0x0080U) <<  7U) | \
+     (((uint32_t)(pins) & 0x0100U) <<  8U) | (((uint32_t)(pins) & 0x0200U) <<  9U) | \
+     (((uint32_t)(pins) & 0x0400U) << 10U) | (((uint32_t)(pins) & 0x0800U) << 11U) | \
+     (((uint32_t)(pins) & 0x1000U) << 12U) | (((uint32_t)(pins) & 0x2000U) << 13U) | \
+     (((uint32_t)(pins) & 0x4000U) << 14U) | (((uint32_t)(pins) & 0x8000U) << 15U))
+#define LL_SPREAD4(pins8) \
+    ((((uint32_t)(pins8) & 0x01U) <<  0U) | (((uint32_t)(pins8) & 0x02U) <<  3U) | \
+     (((uint32_t)(pins8) & 0x04U) <<  6U) | (((uint32_t)(pins8) & 0x08U) <<  9U) | \
+     (((uint32_t)(pins8) & 0x10U) << 12U) | (((uint32_t)(pins8) & 0x20U) << 15U) | \
+     (((uint32_t)(pins8) & 0x40U) << 18U) | (((uint32_t)(pins8) & 0x80U) << 21U))
+
+/**
+ * @brief Configures a pin group of one port (clock enabled by the caller).
+ *        AF before MODER, so a pin never drives its previous function in
+ *        the new mode; set the output level (LL_GPIO_SET) before for
+ *        glitch-free outputs.
+ *
+ * @param port  GPIOx
+ * @param pins  Pin mask (GPIO_PIN_x | ...)
+ * @param mode  GPIO_MODE_INPUT, _OUTPUT_PP/_OD, _AF_PP/_OD, _ANALOG (no
+ *              EXTI modes, see modules/exti)
+ * @param pull  GPIO_NOPULL, GPIO_PULLUP, GPIO_PULLDOWN
+ * @param speed GPIO_SPEED_FREQ_LOW .. _VERY_HIGH
+ * @param af    Alternate function 0..15 (GPIO_AFx_...), 0 for other modes
+ */
+#define LL_GPIO_CONFIG(port, pins, mode, pull, speed, af) \
+    do { \
+        MODIFY_REG((port)->AFR[0], LL_SPREAD4((pins) & 0xFFU) * 0xFU, \
+                   LL_SPREAD4((pins) & 0xFFU) * (uint32_t)(af)); \
+        MODIFY_REG((port)->AFR[1], LL_SPREAD4(((pins) >> 8U) & 0xFFU) * 0xFU, \
+                   LL_SPREAD4(((pins) >> 8U) & 0xFFU) * (uint32_t)(af)); \
+        MODIFY_REG((port)->OSPEEDR, LL_SPREAD2(pins) * 3U, LL_SPREAD2(pins) * (uint32_t)(speed)); \
+        MODIFY_REG((port)->OTYPER, (uint32_t)(pins), \
+                   (((uint32_t)(mode) & OUTPUT_TYPE) != 0U) ? (uint32_t)(pins) : 0U); \
+        MODIFY_REG((port)->PUPDR, LL_SPREAD2(pins) * 3U, LL_SPREAD2(pins) * (uint32_t)(pull)); \
+        MODIFY_REG((port)->MODER, LL_SPREAD2(pins) * 3U, \
+                   LL_SPREAD2(pins) * ((uint32_t)(mode) & GPIO_MODE)); \
+    } while (0)
+
+/**
+ * @brief ADC: end of regular conversion, data register (reading it
+ *        clears EOC).
+ */
+#define LL_ADC_EOC(adc)                 (((adc)->SR & ADC_SR_EOC) != 0U)
+#define LL_ADC_READ(adc)                ((adc)->DR)
+
+/**
+ * @brief TIM: capture/compare register of a HAL channel. TIM_CHANNEL_1..4
+ *        are 0x0, 0x4, 0x8, 0xC, the CCRx registers are consecutive words.
+ */
+#define LL_TIM_CCR(tim, channel)        ((&(tim)->CCR1)[(uint32_t)(channel) >> 2U])
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Sends bytes in 8 bit frames and returns when the last one has
+ *        left the shift register. Enables the SPI if needed; the frame
+ *        format must be 8 bit and no DMA may run on it.
+ *
+ * @param spi     SPI instance
+ * @param pu8_data Bytes
+ * @param u16_size Number of bytes
+ * @return None
+ */
+void ll_spi_write8(SPI_TypeDef *spi, const uint8_t *pu8_data, uint16_t u16_size);
+
+#endif /* LL_LL_H_ */
@@ -0,0 +1,184 @@
+/**
+ ******************************************************************************
+ * @file        lowpower.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       STOP mode with RTC wakeup and clock restore
+ *
+ * Functionality:
+ * - LSI as RTC clock, calendar at 1 Hz with 4 ms sub-second resolution
+ * - Wakeup timer in RTCCLK / 16 steps (0.5 ms) up to 32 s, above in
+ *   ck_spre steps (1 s)
+ * - Time in STOP from the calendar before/after, added to the HAL tick
+ * - Clock restore time measured with the DWT cycle counter; the restore
+ *   runs almost completely on the HSI, so cycles / 16 MHz are used
+ *
+ * Peripherals:
+ * - RTC (wakeup timer, EXTI line 22, RTC_WKUP_IRQn)
+ * - PWR, RCC (LSI), DWT
+ ******************************************************************************
+ */
+
+#include "lowpower.h"
+#include <clock/clock.h>
+#include <utils/utils.h>
+
+/* Private Preprocessor Defines -------------------------------------------- */
+/**
+ * @brief Wakeup timer steps per second with RTCCLK / 16.
+ */
+#define LOWPOWER_WAKEUP_DIV16_HZ    (LOWPOWER_LSI_HZ / 16U)
+
+/**
+ * @brief Longest sleep time in RTCCLK / 16 steps (16 bit counter).
+ */
+#define LOWPOWER_WAKEUP_DIV16_MAX_MS  ((65536UL * 1000UL) / LOWPOWER_WAKEUP_DIV16_HZ)
+
+/**
+ * @brief Milliseconds per day (calendar wrap).
+ */
+#define LOWPOWER_DAY_MS             86400000UL
+
+/**
+ * @brief HSI frequency in MHz (system clock right after STOP).
+ */
+#define LOWPOWER_HSI_MHZ            16U
+
+/* Static module variables -------------------------------------------------- */
+static RTC_HandleTypeDef g_lowpower_rtc;
+static lowpower_stats_t g_lowpower_stats;
+static uint8_t g_u8_lowpower_ready = 0u;
+
+/* Static function prototypes ---------------------------------------------- */
+static uint32_t lowpower_rtc_ms(void);
+
+/* Public functions --------------------------------------------------------- */
+HAL_StatusTypeDef lowpower_init(void)
+{
+    RCC_OscInitTypeDef osc_init_struct = {0};
+    RCC_PeriphCLKInitTypeDef periph_init_struct = {0};
+
+    __HAL_RCC_PWR_CLK_ENABLE();
+    HAL_PWR_EnableBkUpAccess();
+
+    osc_init_struct.OscillatorType = RCC_OSCILLATORTYPE_LSI;
+    osc_init_struct.LSIState       = RCC_LSI_ON;
+    osc_init_struct.PLL.PLLState   = RCC_PLL_NONE;
+    if (HAL_RCC_OscConfig(&osc_init_struct) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    periph_init_struct.PeriphClockSelection = RCC_PERIPHCLK_RTC;
+    periph_init_struct.RTCClockSelection    = RCC_RTCCLKSOURCE_LSI;
+    if (HAL_RCCEx_PeriphCLKConfig(&periph_init_struct) != HAL_OK) {
+        return HAL_ERROR;
+    }
+    __HAL_RCC_RTC_ENABLE();
+
+    g_lowpower_rtc.Instance            = RTC;
+    g_lowpower_rtc.Init.HourFormat     = RTC_HOURFORMAT_24;
+    g_lowpower_rtc.Init.AsynchPrediv   = LOWPOWER_RTC_ASYNC_PREDIV;
+    g_lowpower_rtc.Init.SynchPrediv    = LOWPOWER_RTC_SYNC_PREDIV;
+    g_lowpower_rtc.Init.OutPut         = RTC_OUTPUT_DISABLE;
+    g_lowpower_rtc.Init.OutPutPolarity = RTC_OUTPUT_POLARITY_HIGH;
+    g_lowpower_rtc.Init.OutPutType     = RTC_OUTPUT_TYPE_OPENDRAIN;
+    if (HAL_RTC_Init(&g_lowpower_rtc) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    HAL_NVIC_SetPriority(RTC_WKUP_IRQn, LOWPOWER_WAKEUP_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(RTC_WKUP_IRQn);
+
+    /* Cycle counter for the restore time */
+    utils_timebase_init();
+
+#if LOWPOWER_FLASH_POWER_DOWN
+    HAL_PWREx_EnableFlashPowerDown();
+#endif
+
+    g_u8_lowpower_ready = 1u;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef lowpower_stop(uint32_t u32_ms)
+{
+    clock_profile_t profile = clock_get_profile();
+    uint32_t u32_counter;
+    uint32_t u32_clock;
+    uint32_t u32_start_ms;
+    uint32_t u32_cycles;
+
+    if (!g_u8_lowpower_ready || (u32_ms == 0u) || (u32_ms > 65535000UL)) {
+        return HAL_ERROR;
+    }
+
+    if (u32_ms <= LOWPOWER_WAKEUP_DIV16_MAX_MS) {
+        u32_counter = (u32_ms * LOWPOWER_WAKEUP_DIV16_HZ) / 1000u;
+        u32_clock   = RTC_WAKEUPCLOCK_RTCCLK_DIV16;
+    } else {
+        u32_counter = u32_ms / 1000u;
+        u32_clock   = RTC_WAKEUPCLOCK_CK_SPRE_16BITS;
+    }
+    u32_counter = (u32_counter > 0u) ? (u32_counter - 1u) : 0u;
+
+    u32_start_ms = lowpower_rtc_ms();
+
+    if (HAL_RTCEx_SetWakeUpTimer_IT(&g_lowpower_rtc, u32_counter, u32_clock) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    HAL_SuspendTick();
+    __HAL_PWR_CLEAR_FLAG(PWR_FLAG_WU);
+    HAL_PWR_EnterSTOPMode(PWR_LOWPOWERREGULATOR_ON, PWR_STOPENTRY_WFI);
+
+    /* Woken up: SYSCLK = HSI */
+    u32_cycles = DWT->CYCCNT;
+    clock_init(profile);
+    u32_cycles = DWT->CYCCNT - u32_cycles;
+
+    HAL_RTCEx_DeactivateWakeUpTimer(&g_lowpower_rtc);
+
+    /* Shadow registers are stale after STOP */
+    HAL_RTC_WaitForSynchro(&g_lowpower_rtc);
+    g_lowpower_stats.u32_slept_ms = (lowpower_rtc_ms() + LOWPOWER_DAY_MS - u32_start_ms) % LOWPOWER_DAY_MS;
+    g_lowpower_stats.u32_restore_us = u32_cycles / LOWPOWER_HSI_MHZ;
+
+    uwTick += g_lowpower_stats.u32_slept_ms;
+    HAL_ResumeTick();
+    g_lowpower_stats.u32_wake_tick = HAL_GetTick();
+
+    return HAL_OK;
+}
+
+const lowpower_stats_t *lowpower_get_stats(void)
+{
+    return &g_lowpower_stats;
+}
+
+/* Static module functions -------------------------------------------------- */
+/**
+ * @brief Returns the calendar time of day in milliseconds.
+ *
+ * The date has to be read after the time to unlock the shadow registers.
+ *
+ * @return Time of day in ms (4 ms resolution)
+ */
+static uint32_t lowpower_rtc_ms(void)
+{
+    RTC_TimeTypeDef time;
+    RTC_DateTypeDef date;
+
+    HAL_RTC_GetTime(&g_lowpower_rtc, &time, RTC_FORMAT_BIN);
+    HAL_RTC_GetDate(&g_lowpower_rtc, &date, RTC_FORMAT_BIN);
+
+    return ((uint32_t)time.Hours * 3600u + (uint32_t)time.Minutes * 60u + time.Seconds) * 1000u +
+           ((time.SecondFraction - time.SubSeconds) * 1000u) / (time.SecondFraction + 1u);
+}
+
+/* Interrupt / callback section -------------------------------------------- */
+void RTC_WKUP_IRQHandler(void)
+{
+    HAL_RTCEx_WakeUpTimerIRQHandler(&g_lowpower_rtc);
+}
@@ -0,0 +1,100 @@
+/**
+ ******************************************************************************
+ * @file        lowpower.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the STOP mode / RTC wakeup module.
+ *
+ * @details
+ * Puts the MCU into STOP mode (low-power regulator, flash powered down)
+ * for a given time and wakes it up with the RTC wakeup timer. After
+ * wakeup the system runs on the 16 MHz HSI; the module restores the
+ * clock profile that was active before with clock_init() and advances
+ * the HAL tick by the time spent in STOP, so HAL_GetTick() based
+ * timeouts and periods keep working.
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - RTC on the LSI (~32 kHz), calendar used as sleep time reference
+ *  - RTC wakeup timer: RTCCLK / 16 (0.5 ms steps, up to 32 s) or
+ *    ck_spre (1 s steps) for longer periods
+ *  - STOP entry with SysTick suspended, clock restore on wakeup
+ *  - Time spent in STOP and clock restore time of the last wakeup
+ *
+ * All transfers (SPI, I2C, DMA) must be finished before lowpower_stop()
+ * is called, their clocks are stopped in STOP mode. Any enabled EXTI
+ * interrupt (e.g. a button) also ends the STOP phase early.
+ *
+ ******************************************************************************
+ */
+
+#ifndef LOWPOWER_LOWPOWER_H_
+#define LOWPOWER_LOWPOWER_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+#include "irq/irq.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief Nominal LSI frequency in Hz (17..47 kHz over temperature).
+ */
+#define LOWPOWER_LSI_HZ                 32000U
+
+/**
+ * @brief RTC prescalers: 32 kHz / 128 / 250 = 1 Hz calendar clock.
+ */
+#define LOWPOWER_RTC_ASYNC_PREDIV       127U
+#define LOWPOWER_RTC_SYNC_PREDIV        249U
+
+/**
+ * @brief NVIC priority of the RTC wakeup interrupt.
+ */
+#define LOWPOWER_WAKEUP_IRQ_PRIORITY    IRQ_CLASS_WAKEUP
+
+/**
+ * @brief 1 to power down the flash in STOP mode (lower current, longer
+ *        wakeup).
+ */
+#ifndef LOWPOWER_FLASH_POWER_DOWN
+#define LOWPOWER_FLASH_POWER_DOWN       1
+#endif
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Measurements of the last STOP phase.
+ */
+typedef struct {
+    uint32_t u32_slept_ms;      /**< Time in STOP (RTC calendar)       */
+    uint32_t u32_restore_us;    /**< Clock restore time after wakeup   */
+    uint32_t u32_wake_tick;     /**< HAL tick when the restore finished */
+} lowpower_stats_t;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Starts the LSI, selects it as RTC clock and initializes the RTC.
+ *
+ * @return HAL_OK, HAL_ERROR if the LSI or the RTC does not start
+ */
+HAL_StatusTypeDef lowpower_init(void);
+
+/**
+ * @brief Enters STOP mode for the given time.
+ *
+ * Returns after the RTC wakeup timer (or another interrupt) has ended the
+ * STOP phase and the clock profile has been restored.
+ *
+ * @param u32_ms Sleep time in milliseconds (1 .. 65535 s)
+ * @return HAL_OK, HAL_ERROR if not initialized or the time is invalid
+ */
+HAL_StatusTypeDef lowpower_stop(uint32_t u32_ms);
+
+/**
+ * @brief Returns the measurements of the last STOP phase.
+ *
+ * @return Pointer to the statistics
+ */
+const lowpower_stats_t *lowpower_get_stats(void);
+
+#endif /* LOWPOWER_LOWPOWER_H_ */
@@ -9,10 +9,33 @@
 /* Includes */
 
 #include "median.h"
+#include <string.h>
+#include <profile/profile.h>
+#include <utils/utils.h>
+#include <stats/stats.h>
+
+/* Preprocessor macros */
+
+/**
+ * @brief Vergleicher eines Sortiernetzwerks: danach gilt a <= b.
+ *
+ * Die Bedingungen werden vom Compiler als IT-Block mit bedingten Moves
+ * umgesetzt, es entstehen keine Sprünge - die Laufzeit ist konstant.
+ */
+#define MEDIAN_SORT2(a, b)	do { uint32_t min_ = ((a) < (b)) ? (a) : (b); \
+								 (b) = ((a) < (b)) ? (b) : (a); \
+								 (a) = min_; } while(0)
+
+/* Static module variables */
+
+/**
+ * @brief Nachglättung von median_get_median(), siehe median_set_smoothing().
+ */
+static stats_ratio_t g_median_smoothing = STATS_RATIO_INIT(MEDIAN_SMOOTHING_WEIGHT);
 
 /* Static module functions (prototypes) */
 
-void median_sort_list(uint32_t *list, uint32_t *srcList, uint16_t length);
+static uint16_t median_lower_bound(const uint32_t *list, uint16_t length, uint32_t value);
 
 /* Public functions */
 
@@ -39,62 +62,245 @@ void median_sort_list(uint32_t *list, uint32_t *srcList, uint16_t length);
  */
 uint32_t median_get_median(uint32_t newElement)
 {
-	static uint32_t ringBuffer[MEDIAN_BUFFER_LENGTH] = { 0 };	// mit 0,0,0,... initialisieren
+	uint32_t		median;
+
+	PROFILE_BEGIN(PROFILE_ZONE_MEDIAN);
+
+#if MEDIAN_HAS_NETWORK
+	static uint32_t ringBuffer[MEDIAN_BUFFER_LENGTH] UTILS_CCM_BSS;	// CCM-RAM, beim Start mit 0 gefüllt
 	static uint16_t pos = 0;
-	static uint32_t lastMedian = 0;
-	uint32_t		median;				// Positionszeiger deklarieren
-	uint32_t list[MEDIAN_BUFFER_LENGTH];					// leere Datenstruktur für den sortierten Ring-Puffer
 
 	// 1. neues Element in Ring-Puffer einfügen
 	ringBuffer[pos] = newElement;
-	pos = (pos+1) % MEDIAN_BUFFER_LENGTH;	// neuge Zeigerposition berechnen
+	pos = (pos+1) % MEDIAN_BUFFER_LENGTH;
 
-	// 2. Ring-puffer sortieren
-	median_sort_list(list, ringBuffer, MEDIAN_BUFFER_LENGTH);
+	// 2. Median per Sortiernetzwerk (konstante Laufzeit)
+	median = MEDIAN_NETWORK(ringBuffer);
+#else
+	static median_filter_t filter UTILS_CCM_BSS;
+	static uint8_t initialized = 0;
 
-	// 3. Mittleres Element der sortierten Liste (=Median) zurück geben
-	median = list[MEDIAN_BUFFER_LENGTH/2];
+	if(!initialized)
+	{	// mit 0,0,0,... initialisieren
+		median_filter_init(&filter, MEDIAN_BUFFER_LENGTH, 0);
+		initialized = 1;
+	}
+
+	// 1./2. neues Element einfügen, Median der sortierten Liste lesen
+	median = median_filter_update(&filter, newElement);
+#endif
+
+	// 3. zusätzlich, leichte Glättung (weight*letzter + neuer) / (weight+1)
+	median = stats_ratio_add(&g_median_smoothing, median);
 
-	// 4. zusätzlich, leichte Glättung via Mittelwert-Filter
-	median = (4*lastMedian + 1*median) / 5;
-	lastMedian = median;
+	PROFILE_END(PROFILE_ZONE_MEDIAN);
 
 	return median;
 }
 
-/* Static module functions (implementation) */
+/**
+ * @brief  Stellt die Nachglättung von median_get_median() ein.
+ *
+ * Ergebnis = (weight * letztes Ergebnis + Median) / (weight + 1), siehe
+ * stats_ratio_add(). Der bisherige feste Filter ist weight = 4
+ * (MEDIAN_SMOOTHING_WEIGHT), 0 liefert den Median ungeglättet.
+ *
+ * @param  weight:	Gewicht des letzten Ergebnisses.
+ * @retval None
+ */
+void median_set_smoothing(uint16_t weight)
+{
+	g_median_smoothing.u16_weight = weight;
+}
 
 /**
- * @brief  Sortieralgorithmus zur Sortierung einer ungeordneten Liste.
- * @param  list:	 Zeiger auf Ziel-Liste.
- * @param  srcList: Zeiger auf Quell-Liste.
- * @param	length	 Länge der Liste(n).
+ * @brief  Initialisiert eine Medianfilter-Instanz.
+ *
+ * Das Fenster wird vollständig mit 'initial' gefüllt, so dass der Filter
+ * sofort einen gültigen Median liefert.
+ *
+ * @param  filter:	Filter-Instanz.
+ * @param  length:	Fensterlänge (1..MEDIAN_FILTER_MAX_LENGTH, wird begrenzt).
+ * @param  initial:	Startwert aller Fensterelemente.
  * @retval None
  */
-void median_sort_list(uint32_t *list, uint32_t *srcList, uint16_t length)
+void median_filter_init(median_filter_t *filter, uint16_t length, uint32_t initial)
+{
+	uint16_t i;
+
+	if(length == 0)
+	{
+		length = 1;
+	}
+	else if(length > MEDIAN_FILTER_MAX_LENGTH)
+	{
+		length = MEDIAN_FILTER_MAX_LENGTH;
+	}
+
+	for(i=0; i<length; i++)
+	{
+		filter->ring[i] = initial;
+		filter->sorted[i] = initial;
+	}
+	filter->length = length;
+	filter->pos = 0;
+}
+
+/**
+ * @brief  Ersetzt den ältesten Wert des Fensters durch 'newElement'.
+ *
+ * Der alte Wert wird per Binärsuche in der sortierten Liste gefunden und
+ * entfernt, der neue Wert an seiner sortierten Position eingefügt. Es wird
+ * nur der Bereich zwischen beiden Positionen verschoben.
+ *
+ * @param  filter:		Filter-Instanz.
+ * @param  newElement:	Neuer Datenwert.
+ * @retval Median des Fensters (ohne Glättung).
+ */
+UTILS_RAMFUNC uint32_t median_filter_update(median_filter_t *filter, uint32_t newElement)
 {
-	uint16_t i,j;
-	uint32_t tmp;
+	uint32_t oldElement = filter->ring[filter->pos];
+	uint16_t oldIndex;
+	uint16_t newIndex;
 
-	// 1. Quell-Liste kopieren
-	for(j=0; j<length; j++)
+	// 1. Ring-Puffer aktualisieren
+	filter->ring[filter->pos] = newElement;
+	filter->pos++;
+	if(filter->pos >= filter->length)
 	{
-		list[j] = srcList[j];
+		filter->pos = 0;
 	}
 
-	// 2. Sortierung durchführen
-	for(j=0; j<length; j++)
-	{	// Bouble-Sort muss length mal aufgerufen werden,
-		// um sicher zu stellen, dass die Liste auch im Worst-Case sortiert ist.
+	// 2. alten Wert in der sortierten Liste finden (existiert immer)
+	oldIndex = median_lower_bound(filter->sorted, filter->length, oldElement);
+
+	// 3. Einfügeposition des neuen Wertes bestimmen und Lücke verschieben
+	if(newElement > oldElement)
+	{	// Lücke wandert nach rechts: Elemente (oldIndex, newIndex) nach links
+		newIndex = median_lower_bound(filter->sorted, filter->length, newElement);
+		newIndex--;
+		memmove(&filter->sorted[oldIndex], &filter->sorted[oldIndex + 1],
+				(newIndex - oldIndex) * sizeof(uint32_t));
+	}
+	else
+	{	// Lücke wandert nach links: Elemente [newIndex, oldIndex) nach rechts
+		newIndex = median_lower_bound(filter->sorted, oldIndex, newElement);
+		memmove(&filter->sorted[newIndex + 1], &filter->sorted[newIndex],
+				(oldIndex - newIndex) * sizeof(uint32_t));
+	}
+	filter->sorted[newIndex] = newElement;
+
+	return filter->sorted[filter->length / 2];
+}
+
+/**
+ * @brief  Liefert den aktuellen Median ohne neuen Wert einzufügen.
+ * @param  filter:	Filter-Instanz.
+ * @retval Median des Fensters.
+ */
+uint32_t median_filter_get(const median_filter_t *filter)
+{
+	return filter->sorted[filter->length / 2];
+}
+
+/**
+ * @brief  Median aus 3 Werten (Sortiernetzwerk, 3 Vergleicher).
+ * @param  list:	Zeiger auf 3 Werte (werden nicht verändert).
+ * @retval Median.
+ */
+uint32_t median_network_3(const uint32_t *list)
+{
+	uint32_t p0 = list[0], p1 = list[1], p2 = list[2];
+
+	MEDIAN_SORT2(p0, p1); MEDIAN_SORT2(p1, p2); MEDIAN_SORT2(p0, p1);
+
+	return p1;
+}
+
+/**
+ * @brief  Median aus 5 Werten (Sortiernetzwerk, 7 Vergleicher).
+ * @param  list:	Zeiger auf 5 Werte (werden nicht verändert).
+ * @retval Median.
+ */
+uint32_t median_network_5(const uint32_t *list)
+{
+	uint32_t p0 = list[0], p1 = list[1], p2 = list[2], p3 = list[3], p4 = list[4];
+
+	MEDIAN_SORT2(p0, p1); MEDIAN_SORT2(p3, p4); MEDIAN_SORT2(p0, p3);
+	MEDIAN_SORT2(p1, p4); MEDIAN_SORT2(p1, p2); MEDIAN_SORT2(p2, p3);
+	MEDIAN_SORT2(p1, p2);
+
+	return p2;
+}
+
+/**
+ * @brief  Median aus 7 Werten (Sortiernetzwerk, 13 Vergleicher).
+ * @param  list:	Zeiger auf 7 Werte (werden nicht verändert).
+ * @retval Median.
+ */
+uint32_t median_network_7(const uint32_t *list)
+{
+	uint32_t p0 = list[0], p1 = list[1], p2 = list[2], p3 = list[3];
+	uint32_t p4 = list[4], p5 = list[5], p6 = list[6];
+
+	MEDIAN_SORT2(p0, p5); MEDIAN_SORT2(p0, p3); MEDIAN_SORT2(p1, p6);
+	MEDIAN_SORT2(p2, p4); MEDIAN_SORT2(p0, p1); MEDIAN_SORT2(p3, p5);
+	MEDIAN_SORT2(p2, p6); MEDIAN_SORT2(p2, p3); MEDIAN_SORT2(p3, p6);
+	MEDIAN_SORT2(p4, p5); MEDIAN_SORT2(p1, p4); MEDIAN_SORT2(p1, p3);
+	MEDIAN_SORT2(p3, p4);
+
+	return p3;
+}
+
+/**
+ * @brief  Median aus 9 Werten (Sortiernetzwerk, 19 Vergleicher).
+ * @param  list:	Zeiger auf 9 Werte (werden nicht verändert).
+ * @retval Median.
+ */
+uint32_t median_network_9(const uint32_t *list)
+{
+	uint32_t p0 = list[0], p1 = list[1], p2 = list[2], p3 = list[3], p4 = list[4];
+	uint32_t p5 = list[5], p6 = list[6], p7 = list[7], p8 = list[8];
+
+	MEDIAN_SORT2(p1, p2); MEDIAN_SORT2(p4, p5); MEDIAN_SORT2(p7, p8);
+	MEDIAN_SORT2(p0, p1); MEDIAN_SORT2(p3, p4); MEDIAN_SORT2(p6, p7);
+	MEDIAN_SORT2(p1, p2); MEDIAN_SORT2(p4, p5); MEDIAN_SORT2(p7, p8);
+	MEDIAN_SORT2(p0, p3); MEDIAN_SORT2(p5, p8); MEDIAN_SORT2(p4, p7);
+	MEDIAN_SORT2(p3, p6); MEDIAN_SORT2(p1, p4); MEDIAN_SORT2(p2, p5);
+	MEDIAN_SORT2(p4, p7); MEDIAN_SORT2(p4, p2); MEDIAN_SORT2(p6, p4);
+	MEDIAN_SORT2(p4, p2);
+
+	return p4;
+}
+
+/* Static module functions (implementation) */
+
+/**
+ * @brief  Binärsuche: erste Position in einer sortierten Liste, deren
+ *         Element nicht kleiner als 'value' ist.
+ * @param  list:	Sortierte Liste.
+ * @param  length:	Anzahl der zu durchsuchenden Elemente.
+ * @param  value:	Gesuchter Wert.
+ * @retval Position 0..length.
+ */
+static uint16_t median_lower_bound(const uint32_t *list, uint16_t length, uint32_t value)
+{
+	uint16_t low = 0;
+	uint16_t high = length;
 
-		for(i=0; i<(length-1); i++)
+	while(low < high)
+	{
+		uint16_t mid = (low + high) / 2;
+
+		if(list[mid] < value)
+		{
+			low = mid + 1;
+		}
+		else
 		{
-			if( list[i] > list[i+1] )
-			{	// Elemente tauschen, falls list[i] > list[i+1]
-				tmp = list[i];
-				list[i] = list[i+1];
-				list[i+1] = tmp;
-			}
-		}	// Ende for i
-	}	// Ende for j
+			high = mid;
+		}
+	}
+
+	return low;
 }
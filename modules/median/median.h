@@ -16,8 +16,76 @@
 
 #define MEDIAN_BUFFER_LENGTH	9
 
+/**
+ * @brief Maximale Fensterlänge eines Medianfilters (ungerade Längen
+ *        liefern einen eindeutigen Median).
+ */
+#define MEDIAN_FILTER_MAX_LENGTH	31
+
+/**
+ * @brief Startgewicht der Nachglättung von median_get_median(), siehe
+ *        median_set_smoothing().
+ */
+#ifndef MEDIAN_SMOOTHING_WEIGHT
+#define MEDIAN_SMOOTHING_WEIGHT	4
+#endif
+
+/**
+ * @brief 1, wenn für MEDIAN_BUFFER_LENGTH ein Sortiernetzwerk existiert
+ *        (3, 5, 7 oder 9 Elemente).
+ */
+#if (MEDIAN_BUFFER_LENGTH == 3) || (MEDIAN_BUFFER_LENGTH == 5) || \
+	(MEDIAN_BUFFER_LENGTH == 7) || (MEDIAN_BUFFER_LENGTH == 9)
+#define MEDIAN_HAS_NETWORK	1
+#else
+#define MEDIAN_HAS_NETWORK	0
+#endif
+
+/* Public Preprocessor macros */
+
+/**
+ * @brief Median-Kern passend zu MEDIAN_BUFFER_LENGTH, zur Compile-Zeit
+ *        gewählt. Argument: Zeiger auf MEDIAN_BUFFER_LENGTH Werte.
+ */
+#if MEDIAN_BUFFER_LENGTH == 3
+#define MEDIAN_NETWORK(list)	median_network_3(list)
+#elif MEDIAN_BUFFER_LENGTH == 5
+#define MEDIAN_NETWORK(list)	median_network_5(list)
+#elif MEDIAN_BUFFER_LENGTH == 7
+#define MEDIAN_NETWORK(list)	median_network_7(list)
+#elif MEDIAN_BUFFER_LENGTH == 9
+#define MEDIAN_NETWORK(list)	median_network_9(list)
+#endif
+
+/* Public type definitions */
+
+/**
+ * @brief Instanz eines gleitenden Medianfilters.
+ *
+ * 'ring' hält die Werte in Eingangsreihenfolge, 'sorted' dieselben Werte
+ * aufsteigend sortiert. Ein neuer Wert ersetzt den ältesten: Suche per
+ * Binärsuche (O(log n)), Verschieben per memmove (O(n)).
+ */
+typedef struct
+{
+	uint32_t ring[MEDIAN_FILTER_MAX_LENGTH];
+	uint32_t sorted[MEDIAN_FILTER_MAX_LENGTH];
+	uint16_t length;
+	uint16_t pos;
+} median_filter_t;
+
 /* Public functions (prototypes) */
 
 uint32_t median_get_median(uint32_t newElement);
+void median_set_smoothing(uint16_t weight);
+
+void median_filter_init(median_filter_t *filter, uint16_t length, uint32_t initial);
+uint32_t median_filter_update(median_filter_t *filter, uint32_t newElement);
+uint32_t median_filter_get(const median_filter_t *filter);
+
+uint32_t median_network_3(const uint32_t *list);
+uint32_t median_network_5(const uint32_t *list);
+uint32_t median_network_7(const uint32_t *list);
+uint32_t median_network_9(const uint32_t *list);
 
 #endif /* MEDIAN_MEDIAN_H_ */
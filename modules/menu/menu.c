@@ -0,0 +1,386 @@
+/**
+ ******************************************************************************
+ * @file        menu.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Joystick driven LCD menu.
+ *
+ * Functionality:
+ * - Selection, editing and page navigation from joystick events
+ * - Dirty bit per visible row, set only for the rows an event changes
+ * - Bounded rendering through diffing text fields
+ *
+ * Resources:
+ * - None directly, drawing goes through lcd_text_field (both lcd backends)
+ ******************************************************************************
+ */
+
+#include "menu.h"
+#include "fmt/fmt.h"
+
+#include <stddef.h>
+
+/* Preprocessor Defines ----------------------------------------------------- */
+/**
+ * @brief Dirty bit of the title row.
+ */
+#define MENU_DIRTY_TITLE        (1UL << 31)
+
+/**
+ * @brief Cell of the 5x5 library font at size 1 (see lcd_text_field.c),
+ *        one pixel line between rows.
+ */
+#define MENU_CHAR_WIDTH         6U
+#define MENU_ROW_HEIGHT         9U
+
+/**
+ * @brief Markers in front of the label.
+ */
+#define MENU_MARK_NONE          ' '
+#define MENU_MARK_SELECTED      '>'
+#define MENU_MARK_EDITING       '*'
+
+/* Static function prototypes ----------------------------------------------- */
+static const menu_page_t *menu_page(const menu_t *menu);
+static void menu_select(menu_t *menu, int8_t i8_delta);
+static void menu_edit(menu_t *menu, const menu_item_t *item, int32_t i32_steps);
+static void menu_enter(menu_t *menu);
+static void menu_back(menu_t *menu);
+static void menu_mark_row(menu_t *menu, uint8_t u8_item);
+static void menu_mark_page(menu_t *menu);
+static void menu_draw_row(menu_t *menu, uint8_t u8_row);
+
+/* Public functions --------------------------------------------------------- */
+HAL_StatusTypeDef menu_init(menu_t *menu, const menu_page_t *root, uint16_t x, uint16_t y, uint8_t rows,
+                            uint16_t size, uint16_t color, uint16_t background_color)
+{
+    uint16_t u16_row_height;
+
+    if ((rows == 0u) || (rows > MENU_MAX_ROWS) || (root == NULL) || (root->u8_count == 0u)) {
+        return HAL_ERROR;
+    }
+    if (size == 0u) {
+        size = 1u;
+    }
+    u16_row_height = MENU_ROW_HEIGHT * size;
+
+    menu->pages[0]       = root;
+    menu->u8_selected[0] = 0u;
+    menu->u8_depth       = 0u;
+    menu->u8_first       = 0u;
+    menu->u8_rows        = rows;
+    menu->u8_editing     = 0u;
+    menu->u32_rendered   = 0u;
+
+    lcd_text_field_init(&menu->title, x, y, NULL, size, color, background_color);
+    for (uint8_t i = 0u; i < rows; i++) {
+        uint16_t u16_y = (uint16_t)(y + (i + 1u) * u16_row_height);
+
+        lcd_text_field_init(&menu->labels[i], x, u16_y, NULL, size, color, background_color);
+        lcd_text_field_init(&menu->values[i], (uint16_t)(x + MENU_LABEL_COLUMNS * MENU_CHAR_WIDTH * size),
+                            u16_y, NULL, size, color, background_color);
+    }
+    menu_mark_page(menu);
+
+    return HAL_OK;
+}
+
+uint8_t menu_handle_event(menu_t *menu, const joystick_event_t *event)
+{
+    const menu_item_t *item = menu_get_selected(menu);
+    uint8_t u8_repeat = (event->type == JOYSTICK_EVENT_REPEAT);
+
+    /* Presses act, held UP / DOWN repeat, releases and long presses not */
+    if ((event->type != JOYSTICK_EVENT_PRESS) && !(u8_repeat && ((event->key == JOYSTICK_KEY_UP) ||
+                                                                 (event->key == JOYSTICK_KEY_DOWN)))) {
+        return 0u;
+    }
+
+    if (menu->u8_editing) {
+        int32_t i32_steps = (event->repeat >= MENU_ACCEL_REPEATS) ? MENU_ACCEL_FACTOR : 1;
+
+        switch (event->key) {
+        case JOYSTICK_KEY_UP:
+            menu_edit(menu, item, i32_steps);
+            break;
+        case JOYSTICK_KEY_DOWN:
+            menu_edit(menu, item, -i32_steps);
+            break;
+        default:
+            menu->u8_editing = 0u;
+            menu_mark_row(menu, menu->u8_selected[menu->u8_depth]);
+            break;
+        }
+        return 1u;
+    }
+
+    switch (event->key) {
+    case JOYSTICK_KEY_UP:
+        menu_select(menu, -1);
+        break;
+    case JOYSTICK_KEY_DOWN:
+        menu_select(menu, 1);
+        break;
+    case JOYSTICK_KEY_RIGHT:
+    case JOYSTICK_KEY_PRESS:
+        menu_enter(menu);
+        break;
+    case JOYSTICK_KEY_LEFT:
+        if (menu->u8_depth == 0u) {
+            return 0u;
+        }
+        menu_back(menu);
+        break;
+    default:
+        return 0u;
+    }
+
+    return 1u;
+}
+
+void menu_refresh(menu_t *menu)
+{
+    const menu_page_t *page = menu_page(menu);
+
+    for (uint8_t i = 0u; i < menu->u8_rows; i++) {
+        uint8_t u8_item = (uint8_t)(menu->u8_first + i);
+
+        if ((u8_item < page->u8_count) && (page->items[u8_item].type == MENU_ITEM_VALUE) &&
+            (*page->items[u8_item].pi32_value != menu->i32_shown[i])) {
+            menu->u32_dirty |= 1UL << i;
+        }
+    }
+}
+
+uint8_t menu_render(menu_t *menu, uint8_t u8_max_rows)
+{
+    uint8_t u8_drawn = 0u;
+    uint8_t u8_left = 0u;
+
+    if (menu->u32_dirty & MENU_DIRTY_TITLE) {
+        const menu_page_t *page = menu_page(menu);
+        char ch_title[LCD_TEXT_FIELD_LENGTH + 1];
+        fmt_t fmt;
+
+        fmt_init(&fmt, ch_title, sizeof(ch_title));
+        fmt_str(&fmt, (menu->u8_depth > 0u) ? "< " : "");
+        fmt_str(&fmt, page->pch_title);
+        lcd_text_field_update(&menu->title, fmt_get(&fmt));
+        menu->u32_dirty &= ~MENU_DIRTY_TITLE;
+        u8_drawn++;
+    }
+
+    for (uint8_t i = 0u; i < menu->u8_rows; i++) {
+        if ((menu->u32_dirty & (1UL << i)) == 0u) {
+            continue;
+        }
+        if ((u8_max_rows != 0u) && (u8_drawn >= u8_max_rows)) {
+            u8_left++;
+            continue;
+        }
+        menu_draw_row(menu, i);
+        menu->u32_dirty &= ~(1UL << i);
+        u8_drawn++;
+    }
+    menu->u32_rendered += u8_drawn;
+
+    return u8_left;
+}
+
+const menu_item_t *menu_get_selected(const menu_t *menu)
+{
+    return &menu_page(menu)->items[menu->u8_selected[menu->u8_depth]];
+}
+
+/* Static functions --------------------------------------------------------- */
+/**
+ * @brief Visible page.
+ *
+ * @param menu State
+ * @return Page
+ */
+static const menu_page_t *menu_page(const menu_t *menu)
+{
+    return menu->pages[menu->u8_depth];
+}
+
+/**
+ * @brief Moves the selection by one item (wrapping), scrolls the window
+ *        if it leaves it.
+ *
+ * @param menu     State
+ * @param i8_delta -1 up, 1 down
+ * @return None
+ */
+static void menu_select(menu_t *menu, int8_t i8_delta)
+{
+    uint8_t u8_count = menu_page(menu)->u8_count;
+    uint8_t u8_old = menu->u8_selected[menu->u8_depth];
+    uint8_t u8_new = (uint8_t)((u8_old + u8_count + i8_delta) % u8_count);
+    uint8_t u8_first = menu->u8_first;
+
+    menu->u8_selected[menu->u8_depth] = u8_new;
+
+    if (u8_new < u8_first) {
+        u8_first = u8_new;
+    } else if (u8_new >= u8_first + menu->u8_rows) {
+        u8_first = (uint8_t)(u8_new - menu->u8_rows + 1u);
+    }
+
+    if (u8_first != menu->u8_first) {
+        /* Every row shows another item, the fields send the differences */
+        menu->u8_first = u8_first;
+        menu_mark_page(menu);
+    } else {
+        menu_mark_row(menu, u8_old);
+        menu_mark_row(menu, u8_new);
+    }
+}
+
+/**
+ * @brief Changes a value by a number of steps, limited to its range, and
+ *        applies it.
+ *
+ * @param menu      State
+ * @param item      Value item
+ * @param i32_steps Steps, negative down
+ * @return None
+ */
+static void menu_edit(menu_t *menu, const menu_item_t *item, int32_t i32_steps)
+{
+    int32_t i32_value = *item->pi32_value + i32_steps * item->i32_step;
+
+    if (i32_value > item->i32_max) {
+        i32_value = item->i32_max;
+    } else if (i32_value < item->i32_min) {
+        i32_value = item->i32_min;
+    }
+    if (i32_value == *item->pi32_value) {
+        return;
+    }
+
+    *item->pi32_value = i32_value;
+    if (item->fn != NULL) {
+        item->fn(i32_value, item->p_context);
+    }
+    menu_mark_row(menu, menu->u8_selected[menu->u8_depth]);
+}
+
+/**
+ * @brief Activates the selected item: edit a value, open a page, run an
+ *        action.
+ *
+ * @param menu State
+ * @return None
+ */
+static void menu_enter(menu_t *menu)
+{
+    const menu_item_t *item = menu_get_selected(menu);
+
+    switch (item->type) {
+    case MENU_ITEM_VALUE:
+        menu->u8_editing = 1u;
+        menu_mark_row(menu, menu->u8_selected[menu->u8_depth]);
+        break;
+    case MENU_ITEM_PAGE:
+        if ((menu->u8_depth + 1u < MENU_MAX_DEPTH) && (item->page != NULL) && (item->page->u8_count > 0u)) {
+            menu->u8_depth++;
+            menu->pages[menu->u8_depth]       = item->page;
+            menu->u8_selected[menu->u8_depth] = 0u;
+            menu->u8_first                    = 0u;
+            menu_mark_page(menu);
+        }
+        break;
+    case MENU_ITEM_ACTION:
+    default:
+        if (item->fn != NULL) {
+            item->fn(0, item->p_context);
+        }
+        break;
+    }
+}
+
+/**
+ * @brief Returns to the parent page with its selection in view.
+ *
+ * @param menu State
+ * @return None
+ */
+static void menu_back(menu_t *menu)
+{
+    uint8_t u8_selected;
+
+    menu->u8_depth--;
+    u8_selected = menu->u8_selected[menu->u8_depth];
+    menu->u8_first = (u8_selected >= menu->u8_rows) ? (uint8_t)(u8_selected - menu->u8_rows + 1u) : 0u;
+    menu_mark_page(menu);
+}
+
+/**
+ * @brief Marks the row of an item, if it is visible.
+ *
+ * @param menu    State
+ * @param u8_item Item of the visible page
+ * @return None
+ */
+static void menu_mark_row(menu_t *menu, uint8_t u8_item)
+{
+    if ((u8_item >= menu->u8_first) && (u8_item < menu->u8_first + menu->u8_rows)) {
+        menu->u32_dirty |= 1UL << (u8_item - menu->u8_first);
+    }
+}
+
+/**
+ * @brief Marks the title and all rows (page change, scrolling).
+ *
+ * @param menu State
+ * @return None
+ */
+static void menu_mark_page(menu_t *menu)
+{
+    menu->u32_dirty = MENU_DIRTY_TITLE | ((1UL << menu->u8_rows) - 1UL);
+}
+
+/**
+ * @brief Formats one row into its label and value fields.
+ *
+ * @param menu   State
+ * @param u8_row Visible row
+ * @return None
+ */
+static void menu_draw_row(menu_t *menu, uint8_t u8_row)
+{
+    const menu_page_t *page = menu_page(menu);
+    uint8_t u8_item = (uint8_t)(menu->u8_first + u8_row);
+    char ch_text[LCD_TEXT_FIELD_LENGTH + 1];
+    fmt_t fmt;
+
+    if (u8_item >= page->u8_count) {
+        /* Below the last item: the fields clear what they had drawn */
+        lcd_text_field_update(&menu->labels[u8_row], "");
+        lcd_text_field_update(&menu->values[u8_row], "");
+        return;
+    }
+
+    const menu_item_t *item = &page->items[u8_item];
+    char ch_mark = MENU_MARK_NONE;
+
+    if (u8_item == menu->u8_selected[menu->u8_depth]) {
+        ch_mark = menu->u8_editing ? MENU_MARK_EDITING : MENU_MARK_SELECTED;
+    }
+
+    fmt_init(&fmt, ch_text, MENU_LABEL_COLUMNS + 1u);
+    fmt_char(&fmt, ch_mark);
+    fmt_str(&fmt, item->pch_label);
+    lcd_text_field_update(&menu->labels[u8_row], fmt_get(&fmt));
+
+    fmt_init(&fmt, ch_text, sizeof(ch_text));
+    if (item->type == MENU_ITEM_VALUE) {
+        menu->i32_shown[u8_row] = *item->pi32_value;
+        fmt_fixed(&fmt, menu->i32_shown[u8_row], item->u8_decimals, 0u);
+    } else if (item->type == MENU_ITEM_PAGE) {
+        fmt_char(&fmt, '>');
+    }
+    lcd_text_field_update(&menu->values[u8_row], fmt_get(&fmt));
+}
@@ -0,0 +1,219 @@
+/**
+ ******************************************************************************
+ * @file        menu.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the joystick driven LCD menu.
+ *
+ * @details
+ * Pages of items (integer values, links to sub pages, actions) fixed at
+ * compile time, operated with the debounced joystick event queue
+ * (joystick_init_events()) and drawn through lcd_text_field_t widgets:
+ *
+ *  - UP / DOWN move the selection, while editing they change the value
+ *    by its step (held keys repeat with the acceleration of the joystick
+ *    module, from the MENU_ACCEL_REPEATS-th repeat on by MENU_ACCEL_FACTOR
+ *    steps),
+ *  - RIGHT or PRESS edits a value, opens a sub page or runs an action,
+ *  - LEFT or PRESS ends the editing, LEFT goes back to the parent page.
+ *
+ * Every change only marks the rows it affects (a moved selection the two
+ * rows, an edited value its row); menu_render() draws at most a given
+ * number of dirty rows per call, and the text fields send the changed
+ * characters only. A key press costs a few glyphs of SPI instead of a
+ * full screen. Only the visible page has widgets: values of other pages
+ * are formatted once that page is opened, values changed elsewhere
+ * (shell, parameter load) are picked up by menu_refresh() for the visible
+ * rows.
+ *
+ * A value item points to an int32_t in fixed point (u8_decimals digits),
+ * its change callback applies it (e.g. fan_set_gains()).
+ *
+ * Example:
+ *
+ *     static int32_t g_i32_target = 2000;
+ *     static const menu_item_t g_items[] = {
+ *         MENU_VALUE("Target", &g_i32_target, 0, 5000, 50, 0u, app_set_target, NULL),
+ *         MENU_ACTION("Save", app_save, NULL)
+ *     };
+ *     static const menu_page_t g_page = MENU_PAGE("Fan", g_items);
+ *
+ *     menu_init(&menu, &g_page, 0u, 200u, 4u, 2u, BLACK, WHITE);
+ *     ...
+ *     while (joystick_get_event(&event)) {
+ *         menu_handle_event(&menu, &event);
+ *     }
+ *     menu_render(&menu, 2u);
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - Value, page and action items, nested pages up to MENU_MAX_DEPTH
+ *  - Scrolling window of up to MENU_MAX_ROWS rows
+ *  - Dirty rows per event, bounded rendering per call, diffing text fields
+ *  - Compiled into the applications only with MENU_ENABLE
+ *
+ ******************************************************************************
+ */
+
+#ifndef MENU_MENU_H_
+#define MENU_MENU_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+#include "joystick/joystick.h"
+#include "lcd/lcd_text_field.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief 1 to build the menu into the applications.
+ */
+#ifndef MENU_ENABLE
+#define MENU_ENABLE             0
+#endif
+
+/**
+ * @brief Most visible rows and nesting depth of pages.
+ */
+#define MENU_MAX_ROWS           8U
+#define MENU_MAX_DEPTH          4U
+
+/**
+ * @brief Value acceleration: repeats of a held key after which one event
+ *        changes the value by MENU_ACCEL_FACTOR steps (0..5000 RPM in steps
+ *        of 50 takes about 2 s held).
+ */
+#define MENU_ACCEL_REPEATS      16U
+#define MENU_ACCEL_FACTOR       10
+
+/**
+ * @brief Characters of the label column (selection marker included).
+ */
+#define MENU_LABEL_COLUMNS      10U
+
+/**
+ * @brief Static initializers of items and pages.
+ */
+#define MENU_VALUE(label, value, min, max, step, decimals, fn, context) \
+    { (label), MENU_ITEM_VALUE, (value), (min), (max), (step), (decimals), NULL, (fn), (context) }
+#define MENU_LINK(label, page) \
+    { (label), MENU_ITEM_PAGE, NULL, 0, 0, 0, 0u, (page), NULL, NULL }
+#define MENU_ACTION(label, fn, context) \
+    { (label), MENU_ITEM_ACTION, NULL, 0, 0, 0, 0u, NULL, (fn), (context) }
+#define MENU_PAGE(title, items) \
+    { (title), (items), (uint8_t)(sizeof(items) / sizeof((items)[0])) }
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Kind of an item.
+ */
+typedef enum {
+    MENU_ITEM_VALUE = 0,    /**< Editable fixed-point value                  */
+    MENU_ITEM_PAGE,         /**< Opens a sub page                            */
+    MENU_ITEM_ACTION        /**< Calls its callback                          */
+} menu_item_type_t;
+
+struct menu_page_s;
+
+/**
+ * @brief Callback of an item: a value item after every change (new value),
+ *        an action item when it is activated (value 0). Task context.
+ */
+typedef void (*menu_fn_t)(int32_t i32_value, void *context);
+
+/**
+ * @brief One item of a page.
+ */
+typedef struct {
+    const char               *pch_label;
+    menu_item_type_t          type;
+    int32_t                  *pi32_value;   /**< Value item: the value         */
+    int32_t                   i32_min;
+    int32_t                   i32_max;
+    int32_t                   i32_step;
+    uint8_t                   u8_decimals;  /**< Fixed-point digits shown      */
+    const struct menu_page_s *page;         /**< Page item: the sub page       */
+    menu_fn_t                 fn;
+    void                     *p_context;
+} menu_item_t;
+
+/**
+ * @brief A page: title and items.
+ */
+typedef struct menu_page_s {
+    const char        *pch_title;
+    const menu_item_t *items;
+    uint8_t            u8_count;
+} menu_page_t;
+
+/**
+ * @brief Menu state and widgets of the visible rows.
+ */
+typedef struct {
+    const menu_page_t *pages[MENU_MAX_DEPTH];   /**< Open pages, [depth] visible */
+    uint8_t            u8_selected[MENU_MAX_DEPTH];
+    uint8_t            u8_depth;
+    uint8_t            u8_first;        /**< Item in the first visible row     */
+    uint8_t            u8_rows;
+    uint8_t            u8_editing;
+    uint32_t           u32_dirty;       /**< Bit per row, bit 31 the title     */
+    int32_t            i32_shown[MENU_MAX_ROWS]; /**< Values drawn per row     */
+    lcd_text_field_t   title;
+    lcd_text_field_t   labels[MENU_MAX_ROWS];
+    lcd_text_field_t   values[MENU_MAX_ROWS];
+    uint32_t           u32_rendered;    /**< Rows drawn since menu_init()      */
+} menu_t;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Sets up a menu on its root page, everything is drawn by the
+ *        following menu_render() calls.
+ *
+ * @param menu             State
+ * @param root             Root page
+ * @param x                Left edge on the screen
+ * @param y                Top edge of the title row
+ * @param rows             Visible item rows (1 .. MENU_MAX_ROWS)
+ * @param size             Scaling of the 5x5 library font
+ * @param color            Text colour
+ * @param background_color Background colour
+ * @return HAL_OK, HAL_ERROR for an invalid number of rows or an empty page
+ */
+HAL_StatusTypeDef menu_init(menu_t *menu, const menu_page_t *root, uint16_t x, uint16_t y, uint8_t rows,
+                            uint16_t size, uint16_t color, uint16_t background_color);
+
+/**
+ * @brief Applies one joystick event.
+ *
+ * @param menu  State
+ * @param event Event from joystick_get_event()
+ * @return 1 if the event changed the menu, 0 if it was ignored
+ */
+uint8_t menu_handle_event(menu_t *menu, const joystick_event_t *event);
+
+/**
+ * @brief Marks the visible rows whose value changed outside the menu.
+ *
+ * @param menu State
+ * @return None
+ */
+void menu_refresh(menu_t *menu);
+
+/**
+ * @brief Draws dirty rows, the title first.
+ *
+ * @param menu        State
+ * @param u8_max_rows Most rows drawn in this call, 0 for all
+ * @return Rows still dirty
+ */
+uint8_t menu_render(menu_t *menu, uint8_t u8_max_rows);
+
+/**
+ * @brief Returns the item under the selection.
+ *
+ * @param menu State
+ * @return Item
+ */
+const menu_item_t *menu_get_selected(const menu_t *menu);
+
+#endif /* MENU_MENU_H_ */
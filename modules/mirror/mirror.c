@@ -0,0 +1,390 @@
+/**
+ ******************************************************************************
+ * @file        mirror.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Remote display mirror: dirty rectangles, run length packets
+ *
+ * Functionality:
+ * - Swap callback of the framebuffer: merges the rectangles of every
+ *   swapped frame into the list to send, counts the frame sequence
+ * - Poll: after the flip, encodes the first rectangle from the shown frame
+ *   into a packet, sends it and advances only if the transport took it
+ * - A rectangle that grows while it is sent starts again at its first
+ *   pixel; a transport error queues the full screen
+ * - Packet encoder shared with the screenshot module
+ *
+ * Resources:
+ * - None of its own, the framebuffer swap callback and the chosen
+ *   transport (usb_cdc or uart_telemetry)
+ ******************************************************************************
+ */
+
+#include "mirror.h"
+#include "lcd/lcd.h"
+#include "uart_telemetry/uart_telemetry.h"
+#include "usb_cdc/usb_cdc.h"
+#include <string.h>
+
+/* Private Preprocessor Defines -------------------------------------------- */
+/**
+ * @brief Bytes of the packet head and of the checksum.
+ */
+#define MIRROR_HEAD_SIZE        4U
+#define MIRROR_CHECK_SIZE       2U
+
+/**
+ * @brief Longest literal and repeat of the run length code.
+ */
+#define MIRROR_RLE_LITERAL_MAX  128U
+#define MIRROR_RLE_REPEAT_MIN   2U
+#define MIRROR_RLE_REPEAT_MAX   129U
+
+/* Static module variables -------------------------------------------------- */
+static uint8_t g_u8_mirror_init;
+static mirror_transport_t g_mirror_transport;
+
+/**
+ * @brief Rectangles to send, the first one from pixel g_u32_mirror_offset.
+ */
+static framebuffer_rect_t g_mirror_rects[MIRROR_RECTS];
+static uint8_t g_u8_mirror_rect_count;
+static uint32_t g_u32_mirror_offset;
+
+/**
+ * @brief Sequence number of the newest swapped frame, rectangle packets
+ *        of the running update, end packet still to send, error seen.
+ */
+static uint16_t g_u16_mirror_frame;
+static uint16_t g_u16_mirror_update_packets;
+static uint8_t g_u8_mirror_end_pending;
+static uint8_t g_u8_mirror_resync;
+
+static uint8_t g_u8_mirror_packet[MIRROR_PACKET_SIZE];
+static mirror_stats_t g_mirror_stats;
+
+/* Private function prototypes ---------------------------------------------- */
+static void mirror_on_swap(const framebuffer_rect_t *rects, uint8_t u8_count);
+static void mirror_add(const framebuffer_rect_t *rect);
+static uint16_t mirror_build_rect(const framebuffer_pixel_t *frame, uint32_t *pu32_pixels);
+static uint16_t mirror_build_end(void);
+static uint16_t mirror_finish(uint8_t *pu8_packet, uint16_t u16_length);
+static HAL_StatusTypeDef mirror_send(uint16_t u16_length);
+
+/* Public functions --------------------------------------------------------- */
+HAL_StatusTypeDef mirror_init(mirror_transport_t transport)
+{
+    if (lcd_get_backend() != LCD_BACKEND_FRAMEBUFFER) {
+        return HAL_ERROR;
+    }
+
+    memset(&g_mirror_stats, 0, sizeof(g_mirror_stats));
+    g_mirror_transport = transport;
+    g_u16_mirror_frame = 0u;
+    g_u8_mirror_resync = 0u;
+    mirror_request_full();
+
+    framebuffer_set_swap_callback(mirror_on_swap);
+    g_u8_mirror_init = 1u;
+
+    return HAL_OK;
+}
+
+void mirror_poll(void)
+{
+    const framebuffer_pixel_t *frame;
+
+    if (!g_u8_mirror_init || framebuffer_swap_pending()) {
+        return;
+    }
+    if ((g_mirror_transport == MIRROR_TRANSPORT_USB_CDC) && !usb_cdc_is_open()) {
+        /* Nobody listens: the viewer needs everything when it opens the port */
+        if (!g_u8_mirror_resync) {
+            g_u8_mirror_resync = 1u;
+            g_mirror_stats.u32_resyncs++;
+        }
+        mirror_request_full();
+        return;
+    }
+
+    /* Up to the next swap the shown frame is not drawn into */
+    frame = framebuffer_get_front();
+
+    for (uint32_t u32_packet = 0u; u32_packet < MIRROR_PACKETS_PER_POLL; u32_packet++) {
+        uint32_t u32_pixels = 0u;
+        uint16_t u16_length;
+        HAL_StatusTypeDef status;
+
+        if (g_u8_mirror_rect_count != 0u) {
+            u16_length = mirror_build_rect(frame, &u32_pixels);
+        } else if (g_u8_mirror_end_pending) {
+            u16_length = mirror_build_end();
+        } else {
+            return;
+        }
+
+        status = mirror_send(u16_length);
+        if (status == HAL_BUSY) {
+            g_mirror_stats.u32_retries++;
+            return;
+        }
+        if (status != HAL_OK) {
+            if (!g_u8_mirror_resync) {
+                g_u8_mirror_resync = 1u;
+                g_mirror_stats.u32_resyncs++;
+            }
+            mirror_request_full();
+            return;
+        }
+        g_u8_mirror_resync = 0u;
+        g_mirror_stats.u32_packets++;
+        g_mirror_stats.u32_bytes += u16_length;
+
+        if (g_u8_mirror_rect_count == 0u) {
+            g_u8_mirror_end_pending = 0u;
+            g_u16_mirror_update_packets = 0u;
+            g_mirror_stats.u32_updates++;
+            continue;
+        }
+
+        g_mirror_stats.u32_pixels += u32_pixels;
+        g_u16_mirror_update_packets++;
+        g_u32_mirror_offset += u32_pixels;
+        if (g_u32_mirror_offset >= (uint32_t)g_mirror_rects[0].u16_width * g_mirror_rects[0].u16_height) {
+            g_u8_mirror_rect_count--;
+            memmove(&g_mirror_rects[0], &g_mirror_rects[1], g_u8_mirror_rect_count * sizeof(g_mirror_rects[0]));
+            g_u32_mirror_offset = 0u;
+            if (g_u8_mirror_rect_count == 0u) {
+                g_u8_mirror_end_pending = 1u;
+            }
+        }
+    }
+}
+
+void mirror_request_full(void)
+{
+    g_mirror_rects[0] = (framebuffer_rect_t){ 0u, 0u, FRAMEBUFFER_WIDTH, FRAMEBUFFER_HEIGHT };
+    g_u8_mirror_rect_count = 1u;
+    g_u32_mirror_offset = 0u;
+    g_u8_mirror_end_pending = 0u;
+}
+
+uint8_t mirror_is_busy(void)
+{
+    return (g_u8_mirror_rect_count != 0u) || g_u8_mirror_end_pending;
+}
+
+void mirror_get_stats(mirror_stats_t *stats)
+{
+    *stats = g_mirror_stats;
+}
+
+/* Private functions -------------------------------------------------------- */
+/**
+ * @brief Swap callback: new frame, its rectangles join the list.
+ */
+static void mirror_on_swap(const framebuffer_rect_t *rects, uint8_t u8_count)
+{
+    g_u16_mirror_frame++;
+    g_mirror_stats.u32_frames++;
+
+    for (uint8_t i = 0u; i < u8_count; i++) {
+        mirror_add(&rects[i]);
+    }
+}
+
+/**
+ * @brief Grows a rectangle the new one overlaps or touches, otherwise
+ *        appends it; a full list grows its last rectangle. A grown first
+ *        rectangle is sent again from its first pixel.
+ */
+static void mirror_add(const framebuffer_rect_t *rect)
+{
+    framebuffer_rect_t *target = NULL;
+    uint8_t u8_index;
+
+    for (u8_index = 0u; u8_index < g_u8_mirror_rect_count; u8_index++) {
+        framebuffer_rect_t *candidate = &g_mirror_rects[u8_index];
+
+        if (((uint32_t)rect->u16_x <= (uint32_t)candidate->u16_x + candidate->u16_width) &&
+            ((uint32_t)candidate->u16_x <= (uint32_t)rect->u16_x + rect->u16_width) &&
+            ((uint32_t)rect->u16_y <= (uint32_t)candidate->u16_y + candidate->u16_height) &&
+            ((uint32_t)candidate->u16_y <= (uint32_t)rect->u16_y + rect->u16_height)) {
+            target = candidate;
+            break;
+        }
+    }
+    if ((target == NULL) && (g_u8_mirror_rect_count < MIRROR_RECTS)) {
+        g_mirror_rects[g_u8_mirror_rect_count++] = *rect;
+        return;
+    }
+    if (target == NULL) {
+        u8_index = MIRROR_RECTS - 1u;
+        target = &g_mirror_rects[u8_index];
+    }
+
+    uint16_t u16_right  = ((uint32_t)rect->u16_x + rect->u16_width > (uint32_t)target->u16_x + target->u16_width)
+                        ? (uint16_t)(rect->u16_x + rect->u16_width) : (uint16_t)(target->u16_x + target->u16_width);
+    uint16_t u16_bottom = ((uint32_t)rect->u16_y + rect->u16_height > (uint32_t)target->u16_y + target->u16_height)
+                        ? (uint16_t)(rect->u16_y + rect->u16_height) : (uint16_t)(target->u16_y + target->u16_height);
+
+    target->u16_x      = (rect->u16_x < target->u16_x) ? rect->u16_x : target->u16_x;
+    target->u16_y      = (rect->u16_y < target->u16_y) ? rect->u16_y : target->u16_y;
+    target->u16_width  = u16_right - target->u16_x;
+    target->u16_height = u16_bottom - target->u16_y;
+
+    if (u8_index == 0u) {
+        g_u32_mirror_offset = 0u;
+    }
+}
+
+/**
+ * @brief Encoded packet of the first rectangle from g_u32_mirror_offset on.
+ */
+static uint16_t mirror_build_rect(const framebuffer_pixel_t *frame, uint32_t *pu32_pixels)
+{
+    const framebuffer_rect_t *rect = &g_mirror_rects[0];
+    mirror_source_t source = {
+        &frame[(uint32_t)rect->u16_y * FRAMEBUFFER_WIDTH + rect->u16_x], FRAMEBUFFER_WIDTH, 0u
+    };
+
+    return mirror_pack_rect(g_u8_mirror_packet, g_u16_mirror_frame, rect, &source,
+                            g_u32_mirror_offset, pu32_pixels);
+}
+
+/**
+ * @brief End packet of the running update.
+ */
+static uint16_t mirror_build_end(void)
+{
+    return mirror_pack_end(g_u8_mirror_packet, g_u16_mirror_frame, g_u16_mirror_update_packets);
+}
+
+/**
+ * @brief RGB565 colour of pixel u32_index (row by row) of a rectangle.
+ */
+static inline uint16_t mirror_pixel(const mirror_source_t *source, uint16_t u16_width, uint32_t u32_index)
+{
+    uint32_t u32_row = u32_index / u16_width;
+    uint32_t u32_offset = u32_row * source->u16_stride + (u32_index - u32_row * u16_width);
+
+    if (source->u8_rgb565) {
+        return ((const uint16_t *)source->pixels)[u32_offset];
+    }
+    return framebuffer_colour(((const framebuffer_pixel_t *)source->pixels)[u32_offset]);
+}
+
+/**
+ * @brief Writes the packet head: magic, kind, frame sequence number.
+ */
+static uint16_t mirror_head(uint8_t *pu8_packet, mirror_packet_t kind, uint16_t u16_frame)
+{
+    pu8_packet[0] = MIRROR_MAGIC;
+    pu8_packet[1] = (uint8_t)kind;
+    pu8_packet[2] = (uint8_t)u16_frame;
+    pu8_packet[3] = (uint8_t)(u16_frame >> 8);
+
+    return MIRROR_HEAD_SIZE;
+}
+
+static uint16_t mirror_put_u16(uint8_t *pu8_packet, uint16_t u16_pos, uint16_t u16_value)
+{
+    pu8_packet[u16_pos]      = (uint8_t)u16_value;
+    pu8_packet[u16_pos + 1u] = (uint8_t)(u16_value >> 8);
+
+    return u16_pos + 2u;
+}
+
+uint16_t mirror_pack_rect(uint8_t *pu8_packet, uint16_t u16_frame, const framebuffer_rect_t *rect,
+                          const mirror_source_t *source, uint32_t u32_first, uint32_t *pu32_pixels)
+{
+    uint32_t u32_total = (uint32_t)rect->u16_width * rect->u16_height;
+    uint32_t u32_index = u32_first;
+    uint16_t u16_space = MIRROR_PACKET_SIZE - MIRROR_CHECK_SIZE;
+    uint16_t u16_pos;
+    uint16_t u16_count_pos;
+
+    u16_pos = mirror_head(pu8_packet, MIRROR_PACKET_RECT, u16_frame);
+    u16_pos = mirror_put_u16(pu8_packet, u16_pos, rect->u16_x);
+    u16_pos = mirror_put_u16(pu8_packet, u16_pos, rect->u16_y);
+    u16_pos = mirror_put_u16(pu8_packet, u16_pos, rect->u16_width);
+    u16_pos = mirror_put_u16(pu8_packet, u16_pos, rect->u16_height);
+    u16_pos = mirror_put_u16(pu8_packet, u16_pos, (uint16_t)u32_index);
+    u16_pos = mirror_put_u16(pu8_packet, u16_pos, (uint16_t)(u32_index >> 16));
+    u16_count_pos = u16_pos;
+    u16_pos += 2u;
+
+    /* Each token needs its control byte and one pixel at least */
+    while ((u32_index < u32_total) && (u16_pos + 3u <= u16_space)) {
+        uint16_t u16_colour = mirror_pixel(source, rect->u16_width, u32_index);
+        uint32_t u32_run = 1u;
+
+        while ((u32_index + u32_run < u32_total) && (u32_run < MIRROR_RLE_REPEAT_MAX) &&
+               (mirror_pixel(source, rect->u16_width, u32_index + u32_run) == u16_colour)) {
+            u32_run++;
+        }
+        if (u32_run >= MIRROR_RLE_REPEAT_MIN) {
+            pu8_packet[u16_pos++] = (uint8_t)(0x80u + u32_run - MIRROR_RLE_REPEAT_MIN);
+            u16_pos = mirror_put_u16(pu8_packet, u16_pos, u16_colour);
+            u32_index += u32_run;
+            continue;
+        }
+
+        /* Literal up to the start of the next repeat */
+        uint16_t u16_control = u16_pos++;
+        uint32_t u32_literal = 0u;
+
+        while ((u32_index < u32_total) && (u32_literal < MIRROR_RLE_LITERAL_MAX) && (u16_pos + 2u <= u16_space)) {
+            u16_colour = mirror_pixel(source, rect->u16_width, u32_index);
+            if ((u32_literal != 0u) && (u32_index + 1u < u32_total) &&
+                (mirror_pixel(source, rect->u16_width, u32_index + 1u) == u16_colour)) {
+                break;
+            }
+            u16_pos = mirror_put_u16(pu8_packet, u16_pos, u16_colour);
+            u32_literal++;
+            u32_index++;
+        }
+        pu8_packet[u16_control] = (uint8_t)(u32_literal - 1u);
+    }
+
+    *pu32_pixels = u32_index - u32_first;
+    mirror_put_u16(pu8_packet, u16_count_pos, (uint16_t)*pu32_pixels);
+
+    return mirror_finish(pu8_packet, u16_pos);
+}
+
+uint16_t mirror_pack_end(uint8_t *pu8_packet, uint16_t u16_frame, uint16_t u16_packets)
+{
+    uint16_t u16_pos = mirror_head(pu8_packet, MIRROR_PACKET_END, u16_frame);
+
+    u16_pos = mirror_put_u16(pu8_packet, u16_pos, u16_packets);
+
+    return mirror_finish(pu8_packet, u16_pos);
+}
+
+/**
+ * @brief Appends the Fletcher-16 over the packet.
+ */
+static uint16_t mirror_finish(uint8_t *pu8_packet, uint16_t u16_length)
+{
+    uint16_t u16_sum1 = 0u;
+    uint16_t u16_sum2 = 0u;
+
+    for (uint16_t i = 0u; i < u16_length; i++) {
+        u16_sum1 = (uint16_t)((u16_sum1 + pu8_packet[i]) % 255u);
+        u16_sum2 = (uint16_t)((u16_sum2 + u16_sum1) % 255u);
+    }
+    pu8_packet[u16_length]      = (uint8_t)u16_sum1;
+    pu8_packet[u16_length + 1u] = (uint8_t)u16_sum2;
+
+    return u16_length + MIRROR_CHECK_SIZE;
+}
+
+static HAL_StatusTypeDef mirror_send(uint16_t u16_length)
+{
+    if (g_mirror_transport == MIRROR_TRANSPORT_UART) {
+        return uart_telemetry_send_cobs(g_u8_mirror_packet, u16_length);
+    }
+    return usb_cdc_send_block(USB_CDC_BLOCK_MIRROR, g_u8_mirror_packet, u16_length);
+}
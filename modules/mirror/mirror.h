@@ -0,0 +1,197 @@
+/**
+ ******************************************************************************
+ * @file        mirror.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the remote display mirror.
+ *
+ * @details
+ * Streams what the LCD shows to a host, at a cost proportional to the
+ * change instead of the 153 KB of a full frame. The mirror follows the
+ * double buffered framebuffer backend: every framebuffer_swap() hands it
+ * the dirty rectangles of the swapped frame. After the flip these pixels
+ * are read from the shown frame (which is not drawn into until the next
+ * swap), run length encoded and sent as packets over USB CDC
+ * (usb_cdc_send_block(), USB_CDC_BLOCK_MIRROR) or USART1
+ * (uart_telemetry_send_cobs()).
+ *
+ * Rectangles of frames swapped before the previous ones have been sent
+ * are merged into the list still to send; the packets always carry the
+ * pixels of the newest frame, so the host ends up with the current screen
+ * even when the link is slower than the drawing. A packet the transport
+ * has no room for is encoded again at the next mirror_poll(); a closed
+ * port (or a dropped block) leads to a full frame once it works again.
+ *
+ * Packet, little endian:
+ *   u8 MIRROR_MAGIC, u8 kind, u16 frame sequence number, body,
+ *   u16 Fletcher-16 over the bytes before it
+ *  - MIRROR_PACKET_RECT: u16 x, u16 y, u16 width, u16 height of the
+ *    rectangle, u32 index of the first pixel (row by row inside the
+ *    rectangle), u16 pixels, run length data
+ *  - MIRROR_PACKET_END: u16 rectangle packets of the update; the host
+ *    shows the frame of the sequence number
+ * Run length data: control byte c < 0x80 is followed by c + 1 literal
+ * RGB565 pixels, c >= 0x80 by one pixel repeated c - 0x7E times (2 .. 129).
+ * With FRAMEBUFFER_L8 the pixels are sent as their CLUT colours.
+ *
+ * modules/mirror/mirror_view.py rebuilds the screen from a capture or the
+ * port and writes it as a PPM image.
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - Dirty rectangles from the framebuffer swap, merged while they wait
+ *  - Run length encoding straight from the shown frame, no frame copy
+ *  - USB CDC or UART transport, bounded work per poll, full frame on
+ *    request and after transport errors
+ *
+ * Only layer 1 (background) is mirrored, the overlay is not. The SPI
+ * backend keeps no frame in memory and cannot be mirrored. Single
+ * context: mirror_poll() runs next to the drawing, e.g. as one
+ * scheduler task.
+ *
+ ******************************************************************************
+ */
+
+#ifndef MIRROR_MIRROR_H_
+#define MIRROR_MIRROR_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+#include "framebuffer/framebuffer.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief First byte of every packet.
+ */
+#define MIRROR_MAGIC                0xD5U
+
+/**
+ * @brief Largest packet in bytes, fits a large pool block COBS stuffed.
+ */
+#define MIRROR_PACKET_SIZE          480U
+
+/**
+ * @brief Rectangles waiting to be sent; further ones are merged into the
+ *        last.
+ */
+#define MIRROR_RECTS                8U
+
+/**
+ * @brief Packets sent per mirror_poll() at most.
+ */
+#ifndef MIRROR_PACKETS_PER_POLL
+#define MIRROR_PACKETS_PER_POLL     4U
+#endif
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Link the packets are sent over.
+ */
+typedef enum {
+    MIRROR_TRANSPORT_USB_CDC = 0,   /**< usb_cdc blocks (USB_CDC_BLOCK_MIRROR) */
+    MIRROR_TRANSPORT_UART           /**< uart_telemetry COBS blocks            */
+} mirror_transport_t;
+
+/**
+ * @brief Packet kinds.
+ */
+typedef enum {
+    MIRROR_PACKET_RECT = 1,         /**< Run length pixels of a rectangle    */
+    MIRROR_PACKET_END  = 2          /**< Update of a frame complete          */
+} mirror_packet_t;
+
+/**
+ * @brief Pixels of a rectangle for mirror_pack_rect().
+ */
+typedef struct {
+    const void *pixels;         /**< First pixel of the rectangle           */
+    uint16_t    u16_stride;     /**< Pixels from one row to the next         */
+    uint8_t     u8_rgb565;      /**< 1 RGB565 values, 0 framebuffer_pixel_t */
+} mirror_source_t;
+
+/**
+ * @brief Counters since mirror_init().
+ */
+typedef struct {
+    uint32_t u32_frames;        /**< Swapped frames seen                     */
+    uint32_t u32_updates;       /**< Updates completed (end packets)         */
+    uint32_t u32_packets;       /**< Packets accepted by the transport       */
+    uint32_t u32_pixels;        /**< Pixels sent                             */
+    uint32_t u32_bytes;         /**< Packet bytes sent                       */
+    uint32_t u32_retries;       /**< Packets held back, transport busy       */
+    uint32_t u32_resyncs;       /**< Full frames after a transport error     */
+} mirror_stats_t;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Hooks the mirror into the framebuffer swap and queues a full
+ *        frame.
+ *
+ * The lcd has to run on the framebuffer backend, the transport has to be
+ * initialised. Changes are only followed with double buffering
+ * (framebuffer_double_buffer_enable()); without it only the full frames
+ * of mirror_request_full() are sent.
+ *
+ * @param transport Link
+ * @return HAL_OK, HAL_ERROR on the SPI backend
+ */
+HAL_StatusTypeDef mirror_init(mirror_transport_t transport);
+
+/**
+ * @brief Sends up to MIRROR_PACKETS_PER_POLL packets of the waiting
+ *        rectangles. Returns at once while a swap waits for its flip.
+ *
+ * @return None
+ */
+void mirror_poll(void);
+
+/**
+ * @brief Queues the full screen, e.g. when a viewer connects.
+ *
+ * @return None
+ */
+void mirror_request_full(void);
+
+/**
+ * @brief Returns whether rectangles wait to be sent.
+ *
+ * @return 1 busy, 0 the host shows the newest frame
+ */
+uint8_t mirror_is_busy(void);
+
+/**
+ * @brief Copies the counters.
+ *
+ * @param stats Destination
+ * @return None
+ */
+void mirror_get_stats(mirror_stats_t *stats);
+
+/**
+ * @brief Encodes pixels of a rectangle into one rectangle packet, from
+ *        pixel u32_first on until the packet is full or the rectangle
+ *        ends. Shared with the screenshot module.
+ *
+ * @param pu8_packet  Destination, MIRROR_PACKET_SIZE bytes
+ * @param u16_frame   Sequence number of the packet
+ * @param rect        Rectangle on the screen
+ * @param source      Its pixels
+ * @param u32_first   First pixel, row by row inside the rectangle
+ * @param pu32_pixels Pixels covered by the packet
+ * @return Packet length
+ */
+uint16_t mirror_pack_rect(uint8_t *pu8_packet, uint16_t u16_frame, const framebuffer_rect_t *rect,
+                          const mirror_source_t *source, uint32_t u32_first, uint32_t *pu32_pixels);
+
+/**
+ * @brief Encodes an end packet.
+ *
+ * @param pu8_packet  Destination, MIRROR_PACKET_SIZE bytes
+ * @param u16_frame   Sequence number of the completed frame
+ * @param u16_packets Rectangle packets sent for it
+ * @return Packet length
+ */
+uint16_t mirror_pack_end(uint8_t *pu8_packet, uint16_t u16_frame, uint16_t u16_packets);
+
+#endif /* MIRROR_MIRROR_H_ */
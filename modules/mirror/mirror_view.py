@@ -0,0 +1,183 @@
+#!/usr/bin/env python3
+"""Viewer for the display mirror packets of modules/mirror.
+
+Reads a capture or the port itself, as USB CDC blocks (default, Linux:
+/dev/ttyACM*) or as COBS stuffed blocks of the ST-LINK virtual COM port
+(--uart), rebuilds the 240x320 screen from the run length rectangles and
+writes it as a binary PPM image after every completed update (the file is
+replaced, an image viewer with auto reload shows it live). --frames keeps
+every update as PREFIX_<sequence>.ppm as well. Packets with a bad
+checksum are skipped, the next full frame or the rectangles of later
+updates repair the screen. Screenshots of modules/screenshot use the same
+packets and come out as one update.
+
+Only the standard library is needed.
+
+Usage:
+    mirror_view.py /dev/ttyACM1|capture.bin [--uart] [--out screen.ppm] [--frames PREFIX]
+"""
+
+import argparse
+import os
+import struct
+import sys
+import time
+
+WIDTH, HEIGHT = 240, 320
+MAGIC = 0xD5
+RECT, END = 1, 2
+RECT_HEADER = struct.Struct("<BBHHHHHIH")   # magic, kind, frame, x, y, w, h, first, pixels
+END_HEADER = struct.Struct("<BBHH")          # magic, kind, frame, packets
+
+# USB CDC block framing, see usb_cdc.h
+USB_SYNC = 0x5A
+USB_HEADER = struct.Struct("<BBHHI")        # sync, type, sequence, length, cycles
+USB_MAX_LENGTH = 4096 - USB_HEADER.size
+USB_BLOCK_MIRROR = 5
+
+
+def fletcher16(data):
+    sum1 = sum2 = 0
+    for byte in data:
+        sum1 = (sum1 + byte) % 255
+        sum2 = (sum2 + sum1) % 255
+    return sum1 | (sum2 << 8)
+
+
+def cobs_decode(block):
+    out = bytearray()
+    pos = 0
+    while pos < len(block):
+        code = block[pos]
+        if code == 0 or pos + code > len(block):
+            return None
+        out += block[pos + 1:pos + code]
+        pos += code
+        if code < 0xFF and pos < len(block):
+            out.append(0)
+    return bytes(out)
+
+
+def read_chunks(stream):
+    while True:
+        chunk = stream.read(65536)
+        if not chunk:
+            return
+        yield chunk
+
+
+def usb_packets(stream, stats):
+    """Yields the data of every mirror block of a usb_cdc stream."""
+    data = bytearray()
+    for chunk in read_chunks(stream):
+        data += chunk
+        pos = 0
+        while len(data) - pos >= USB_HEADER.size:
+            sync, block_type, _seq, length, _cycles = USB_HEADER.unpack_from(data, pos)
+            if sync != USB_SYNC or length > USB_MAX_LENGTH:
+                pos += 1
+                stats["skipped"] += 1
+                continue
+            if len(data) - pos < USB_HEADER.size + length:
+                break
+            if block_type == USB_BLOCK_MIRROR:
+                yield bytes(data[pos + USB_HEADER.size:pos + USB_HEADER.size + length])
+            stats["bytes"] += USB_HEADER.size + length
+            pos += USB_HEADER.size + length
+        del data[:pos]
+
+
+def uart_packets(stream, stats):
+    """Yields every COBS block that starts with the mirror magic."""
+    data = bytearray()
+    for chunk in read_chunks(stream):
+        data += chunk
+        *blocks, data = data.split(b"\0")
+        for block in blocks:
+            stats["bytes"] += len(block) + 1
+            packet = cobs_decode(block)
+            if packet and packet[0] == MAGIC:
+                yield packet
+
+
+def apply_rect(screen, packet):
+    """Decodes the run length pixels of a rectangle packet into the screen."""
+    _magic, _kind, _frame, x, y, width, height, first, pixels = RECT_HEADER.unpack_from(packet)
+    if width == 0 or x + width > WIDTH or y + height > HEIGHT or first + pixels > width * height:
+        return False
+    colours = []
+    pos = RECT_HEADER.size
+    end = len(packet) - 2
+    while pos < end and len(colours) < pixels:
+        control = packet[pos]
+        pos += 1
+        if control < 0x80:
+            count = control + 1
+            colours += struct.unpack_from("<%dH" % count, packet, pos)
+            pos += 2 * count
+        else:
+            colours += [struct.unpack_from("<H", packet, pos)[0]] * (control - 0x7E)
+            pos += 2
+    if len(colours) != pixels:
+        return False
+    for index, colour in enumerate(colours, first):
+        row, col = divmod(index, width)
+        screen[(y + row) * WIDTH + x + col] = colour
+    return True
+
+
+def write_ppm(path, screen):
+    rgb = bytearray(WIDTH * HEIGHT * 3)
+    for i, colour in enumerate(screen):
+        r, g, b = (colour >> 11) & 0x1F, (colour >> 5) & 0x3F, colour & 0x1F
+        rgb[3 * i] = (r << 3) | (r >> 2)
+        rgb[3 * i + 1] = (g << 2) | (g >> 4)
+        rgb[3 * i + 2] = (b << 3) | (b >> 2)
+    tmp = path + ".tmp"
+    with open(tmp, "wb") as out:
+        out.write(b"P6\n%d %d\n255\n" % (WIDTH, HEIGHT))
+        out.write(rgb)
+    os.replace(tmp, path)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("source", help="serial device or capture file")
+    parser.add_argument("--uart", action="store_true", help="COBS blocks of uart_telemetry instead of usb_cdc blocks")
+    parser.add_argument("--out", default="screen.ppm", help="image of the newest update, default: screen.ppm")
+    parser.add_argument("--frames", help="write every update as PREFIX_<sequence>.ppm")
+    args = parser.parse_args()
+
+    screen = [0] * (WIDTH * HEIGHT)
+    stats = {"bytes": 0, "skipped": 0, "packets": 0, "bad": 0, "updates": 0}
+    start = time.monotonic()
+    try:
+        with open(args.source, "rb", buffering=0) as stream:
+            packets = uart_packets(stream, stats) if args.uart else usb_packets(stream, stats)
+            for packet in packets:
+                if len(packet) < END_HEADER.size + 2 or \
+                        struct.unpack_from("<H", packet, len(packet) - 2)[0] != fletcher16(packet[:-2]):
+                    stats["bad"] += 1
+                    continue
+                stats["packets"] += 1
+                kind = packet[1]
+                if kind == RECT and len(packet) >= RECT_HEADER.size + 2:
+                    if not apply_rect(screen, packet):
+                        stats["bad"] += 1
+                elif kind == END:
+                    _magic, _kind, frame, _count = END_HEADER.unpack_from(packet)
+                    stats["updates"] += 1
+                    if args.frames:
+                        write_ppm("%s_%05d.ppm" % (args.frames, frame), screen)
+                    write_ppm(args.out, screen)
+    except KeyboardInterrupt:
+        pass
+
+    seconds = max(time.monotonic() - start, 1e-3)
+    sys.stderr.write("%d updates, %d packets, %d bad, %d bytes skipped, %.1f kB/s\n" %
+                     (stats["updates"], stats["packets"], stats["bad"], stats["skipped"],
+                      stats["bytes"] / seconds / 1000.0))
+
+
+if __name__ == "__main__":
+    main()
@@ -10,6 +10,51 @@
 
 #include "my_lcd.h"
 
+/**
+ * @brief sin(i · 90° / 256) in Q15 für i = 0..256, Rest der Welle über
+ *        Symmetrie.
+ */
+static const int16_t sin_q15_quarter[MY_LCD_ANGLE_STEPS / 4 + 1] = {
+        0,   201,   402,   603,   804,  1005,  1206,  1407,  1608,  1809,  2009,  2210,
+     2411,  2611,  2811,  3012,  3212,  3412,  3612,  3812,  4011,  4211,  4410,  4609,
+     4808,  5007,  5205,  5404,  5602,  5800,  5998,  6195,  6393,  6590,  6787,  6983,
+     7180,  7376,  7571,  7767,  7962,  8157,  8351,  8546,  8740,  8933,  9127,  9319,
+     9512,  9704,  9896, 10088, 10279, 10469, 10660, 10850, 11039, 11228, 11417, 11605,
+    11793, 11980, 12167, 12354, 12540, 12725, 12910, 13095, 13279, 13463, 13646, 13828,
+    14010, 14192, 14373, 14553, 14733, 14912, 15091, 15269, 15447, 15624, 15800, 15976,
+    16151, 16326, 16500, 16673, 16846, 17018, 17190, 17361, 17531, 17700, 17869, 18037,
+    18205, 18372, 18538, 18703, 18868, 19032, 19195, 19358, 19520, 19681, 19841, 20001,
+    20160, 20318, 20475, 20632, 20788, 20943, 21097, 21251, 21403, 21555, 21706, 21856,
+    22006, 22154, 22302, 22449, 22595, 22740, 22884, 23028, 23170, 23312, 23453, 23593,
+    23732, 23870, 24008, 24144, 24279, 24414, 24548, 24680, 24812, 24943, 25073, 25202,
+    25330, 25457, 25583, 25708, 25833, 25956, 26078, 26199, 26320, 26439, 26557, 26674,
+    26791, 26906, 27020, 27133, 27246, 27357, 27467, 27576, 27684, 27791, 27897, 28002,
+    28106, 28209, 28311, 28411, 28511, 28610, 28707, 28803, 28899, 28993, 29086, 29178,
+    29269, 29359, 29448, 29535, 29622, 29707, 29792, 29875, 29957, 30038, 30118, 30196,
+    30274, 30350, 30425, 30499, 30572, 30644, 30715, 30784, 30853, 30920, 30986, 31050,
+    31114, 31177, 31238, 31298, 31357, 31415, 31471, 31527, 31581, 31634, 31686, 31737,
+    31786, 31834, 31881, 31927, 31972, 32015, 32058, 32099, 32138, 32177, 32214, 32251,
+    32286, 32319, 32352, 32383, 32413, 32442, 32470, 32496, 32522, 32546, 32568, 32590,
+    32610, 32629, 32647, 32664, 32679, 32693, 32706, 32718, 32729, 32738, 32746, 32753,
+    32758, 32762, 32766, 32767, 32767
+};
+
+/**
+ * @brief Wandelt Grad in Tabellenschritte um (gerundet).
+ */
+static int my_lcd_deg_to_steps(int deg){
+    return (deg * MY_LCD_ANGLE_STEPS + (deg >= 0 ? 180 : -180)) / 360;
+}
+
+/**
+ * @brief Punkt im Abstand r vom Mittelpunkt unter einem Winkel
+ *        (Uhrzeigersinn ab 12 Uhr, Bildschirm-Y nach unten).
+ */
+static void my_lcd_gauge_point(const my_lcd_gauge_t *gauge, int angle, int r, int *x, int *y){
+    *x = gauge->cx + ((r * my_lcd_sin_q15(angle) + 16384) >> 15);
+    *y = gauge->cy - ((r * my_lcd_cos_q15(angle) + 16384) >> 15);
+}
+
 /**
  * @brief Startet einen Countdown auf dem LCD.
  *
@@ -62,6 +107,190 @@ void my_lcd_draw_baargraph(int x, int y, int width, int height, int value, uint1
     ILI9341_Draw_Filled_Rectangle_Coord(x + filled, y, x + width, y + height, bgcolor);
 }
 
+/**
+ * @brief Legt einen Bargraphen an, der nur Änderungen neu zeichnet.
+ *
+ * Es wird noch nichts gezeichnet, das erste `my_lcd_bargraph_update()`
+ * zeichnet den ganzen Balken.
+ */
+void my_lcd_bargraph_init(my_lcd_bargraph_t *bar, int x, int y, int width, int height, uint16_t color, uint16_t bgcolor){
+    bar->x = x;
+    bar->y = y;
+    bar->width = width;
+    bar->height = height;
+    bar->color = color;
+    bar->bgcolor = bgcolor;
+    bar->filled = -1;
+}
+
+/**
+ * @brief Zeigt einen neuen Wert an und zeichnet nur den geänderten Streifen.
+ *
+ * Wächst der Balken, wird der Streifen von der alten bis zur neuen Breite
+ * in `color` gefüllt, schrumpft er, in `bgcolor`. Die Rechtecke haben die
+ * gleichen Grenzen wie bei `my_lcd_draw_baargraph()`.
+ *
+ * Beispiel: Wert 500 → 510 bei 150 Pixel Breite füllt ein 1×50-Pixel-
+ * Rechteck statt zweier Rechtecke mit zusammen 150×50 Pixel.
+ */
+void my_lcd_bargraph_update(my_lcd_bargraph_t *bar, int value){
+    if (value < 0) value = 0;
+    if (value > MAX_BAARGRAPH_VALUE) value = MAX_BAARGRAPH_VALUE;
+
+    int filled = (bar->width * value) / MAX_BAARGRAPH_VALUE;
+
+    if (bar->filled < 0) {
+        // Erster Aufruf: ganzer Balken
+        my_lcd_draw_baargraph(bar->x, bar->y, bar->width, bar->height, value, bar->color, bar->bgcolor);
+    } else if (filled > bar->filled) {
+        // Balken wächst: Streifen in Füllfarbe
+        lcd_draw_rect(bar->x + bar->filled, bar->y, bar->x + filled, bar->y + bar->height, bar->color, 1);
+    } else if (filled < bar->filled) {
+        // Balken schrumpft: Streifen in Hintergrundfarbe
+        lcd_draw_rect(bar->x + filled, bar->y, bar->x + bar->filled, bar->y + bar->height, bar->bgcolor, 1);
+    }
+
+    bar->filled = filled;
+}
+
+/**
+ * @brief Erzwingt beim nächsten Update ein vollständiges Neuzeichnen.
+ */
+void my_lcd_bargraph_invalidate(my_lcd_bargraph_t *bar){
+    bar->filled = -1;
+}
+
+/**
+ * @brief Sinus über die Viertelwelle: Quadranten 1..3 aus Spiegelung und
+ *        Vorzeichen, keine Gleitkommarechnung.
+ */
+int16_t my_lcd_sin_q15(int angle){
+    int quarter = MY_LCD_ANGLE_STEPS / 4;
+    int a = angle & (MY_LCD_ANGLE_STEPS - 1);
+
+    if (a < quarter) {
+        return sin_q15_quarter[a];
+    } else if (a < 2 * quarter) {
+        return sin_q15_quarter[2 * quarter - a];
+    } else if (a < 3 * quarter) {
+        return (int16_t)-sin_q15_quarter[a - 2 * quarter];
+    }
+    return (int16_t)-sin_q15_quarter[4 * quarter - a];
+}
+
+/**
+ * @brief Kosinus als um 90° verschobener Sinus.
+ */
+int16_t my_lcd_cos_q15(int angle){
+    return my_lcd_sin_q15(angle + MY_LCD_ANGLE_STEPS / 4);
+}
+
+/**
+ * @brief Legt ein Rundinstrument mit Vorgabeskala an, gezeichnet wird
+ *        erst mit `my_lcd_gauge_draw()`.
+ */
+void my_lcd_gauge_init(my_lcd_gauge_t *gauge, int cx, int cy, int radius, int min, int max,
+                       uint16_t color, uint16_t scale_color, uint16_t bgcolor){
+    gauge->cx = cx;
+    gauge->cy = cy;
+    gauge->radius = radius;
+    gauge->min = min;
+    gauge->max = (max > min) ? max : min + 1;
+    gauge->start_deg = -135;
+    gauge->sweep_deg = 270;
+    gauge->ticks = 10;
+    gauge->color = color;
+    gauge->scale_color = scale_color;
+    gauge->bgcolor = bgcolor;
+    gauge->tip_x = 0;
+    gauge->tip_y = -1;
+}
+
+/**
+ * @brief Zeichnet das Zifferblatt einmal.
+ *
+ * Der Bogen wird als Polygonzug mit Punkten alle 8 Tabellenschritte
+ * (2,8°) gezeichnet, bei 100 Pixel Radius weicht er höchstens 0,1 Pixel
+ * vom Kreis ab.
+ */
+void my_lcd_gauge_draw(my_lcd_gauge_t *gauge){
+    uint16_t points[2 * 16];
+    int start = my_lcd_deg_to_steps(gauge->start_deg);
+    int sweep = my_lcd_deg_to_steps(gauge->sweep_deg);
+    int count = 0;
+
+    lcd_draw_circle(gauge->cx, gauge->cy, gauge->radius + 1, gauge->bgcolor, 1);
+
+    // Bogen in Stücken zu 16 Punkten, der letzte Punkt beginnt das nächste Stück
+    for (int step = 0; ; step += 8) {
+        int x, y;
+
+        if (step > sweep) step = sweep;
+        my_lcd_gauge_point(gauge, start + step, gauge->radius, &x, &y);
+        points[2 * count] = (uint16_t)x;
+        points[2 * count + 1] = (uint16_t)y;
+        count++;
+
+        if ((count == 16) || (step == sweep)) {
+            lcd_draw_polyline(points, (uint16_t)count, gauge->scale_color);
+            points[0] = points[2 * count - 2];
+            points[1] = points[2 * count - 1];
+            count = 1;
+        }
+        if (step == sweep) break;
+    }
+
+    // Teilstriche nach innen
+    for (int i = 0; i <= gauge->ticks; i++) {
+        int angle = start + (sweep * i) / ((gauge->ticks > 0) ? gauge->ticks : 1);
+        int x0, y0, x1, y1;
+
+        my_lcd_gauge_point(gauge, angle, gauge->radius, &x0, &y0);
+        my_lcd_gauge_point(gauge, angle, gauge->radius - MY_LCD_GAUGE_TICK_LEN, &x1, &y1);
+        lcd_draw_line(x0, y0, x1, y1, gauge->scale_color);
+    }
+
+    lcd_draw_circle(gauge->cx, gauge->cy, MY_LCD_GAUGE_HUB, gauge->scale_color, 1);
+    gauge->tip_y = -1;
+}
+
+/**
+ * @brief Bewegt die Nadel: alte Linie in Hintergrundfarbe, neue Linie,
+ *        Nabe darüber (deckt die Enden beider Linien in der Mitte ab).
+ *
+ * Die Nadel endet MY_LCD_GAUGE_NEEDLE_GAP Pixel vor den Teilstrichen,
+ * das Löschen trifft daher nie die Skala.
+ */
+void my_lcd_gauge_update(my_lcd_gauge_t *gauge, int value){
+    int length = gauge->radius - MY_LCD_GAUGE_TICK_LEN - MY_LCD_GAUGE_NEEDLE_GAP;
+    int start = my_lcd_deg_to_steps(gauge->start_deg);
+    int sweep = my_lcd_deg_to_steps(gauge->sweep_deg);
+    int x, y;
+
+    if (value < gauge->min) value = gauge->min;
+    if (value > gauge->max) value = gauge->max;
+
+    my_lcd_gauge_point(gauge, start + (int)(((int64_t)sweep * (value - gauge->min)) / (gauge->max - gauge->min)),
+                       length, &x, &y);
+    if ((x == gauge->tip_x) && (y == gauge->tip_y)) return;
+
+    if (gauge->tip_y >= 0) {
+        lcd_draw_line(gauge->cx, gauge->cy, gauge->tip_x, gauge->tip_y, gauge->bgcolor);
+    }
+    lcd_draw_line(gauge->cx, gauge->cy, x, y, gauge->color);
+    lcd_draw_circle(gauge->cx, gauge->cy, MY_LCD_GAUGE_HUB, gauge->scale_color, 1);
+
+    gauge->tip_x = x;
+    gauge->tip_y = y;
+}
+
+/**
+ * @brief Vergisst die gezeichnete Nadel.
+ */
+void my_lcd_gauge_invalidate(my_lcd_gauge_t *gauge){
+    gauge->tip_y = -1;
+}
+
 /**
  * @brief Zeichnet ein diagonales Kreuz aus zwei Linien.
  *
@@ -76,8 +305,6 @@ void my_lcd_draw_baargraph(int x, int y, int width, int height, int value, uint1
  * `draw_cross(50, 50);` zeichnet ein Kreuz mit Startpunkt (50,50).
  */
 void draw_cross(int x, int y) {
-    for (int i = 0; i < 100; i++) {
-        lcd_draw_pixel(x + i, y + i, RED);// Diagonale von oben links nach unten rechts
-        lcd_draw_pixel(x + i, y + 99 - i, BLUE); // Diagonale von oben rechts nach unten links
-	}
+    lcd_draw_line(x, y, x + 99, y + 99, RED);  // Diagonale von oben links nach unten rechts
+    lcd_draw_line(x, y + 99, x + 99, y, BLUE); // Diagonale von oben rechts nach unten links
 }
@@ -16,6 +16,66 @@
 
 #define MAX_BAARGRAPH_VALUE 1000
 
+/**
+ * @brief Winkelschritte pro Umdrehung der Sinustabelle (1024 = 0,35°).
+ */
+#define MY_LCD_ANGLE_STEPS      1024
+
+/**
+ * @brief Kantenlänge der Teilstriche und Abstand der Nadelspitze zur
+ *        Skala in Pixel, Radius der Nabe.
+ */
+#define MY_LCD_GAUGE_TICK_LEN   8
+#define MY_LCD_GAUGE_NEEDLE_GAP 4
+#define MY_LCD_GAUGE_HUB        4
+
+/**
+ * @brief Zustand eines Bargraphen, der nur Änderungen neu zeichnet.
+ *
+ * Merkt sich die zuletzt gezeichnete Füllbreite. Bei einer Aktualisierung
+ * wird nur der Streifen zwischen alter und neuer Breite gefüllt, die
+ * Kosten hängen von der Änderung ab und nicht von der Balkenfläche.
+ */
+typedef struct {
+    int x;              /**< X-Koordinate der linken oberen Ecke          */
+    int y;              /**< Y-Koordinate der linken oberen Ecke          */
+    int width;          /**< Breite in Pixel                              */
+    int height;         /**< Höhe in Pixel                                */
+    uint16_t color;     /**< Farbe des gefüllten Bereichs                 */
+    uint16_t bgcolor;   /**< Hintergrundfarbe                             */
+    int filled;         /**< Gezeichnete Füllbreite, -1 = noch nicht gezeichnet */
+} my_lcd_bargraph_t;
+
+/**
+ * @brief Zustand eines Rundinstruments (Drehzahl, Druck) mit Nadel.
+ *
+ * Skala (Bogen und Teilstriche) wird einmal gezeichnet. Eine neue
+ * Nadelstellung löscht nur die alte Nadel (Linie in Hintergrundfarbe),
+ * zeichnet die neue und die Nabe; das Zifferblatt bleibt unberührt, weil
+ * die Nadel vor der Skala endet. Über SPI kostet ein Update damit einige
+ * hundert Pixel statt der ganzen Fläche, die Nadel läuft flüssig mit
+ * mehr als 30 Bildern pro Sekunde.
+ *
+ * Winkel in Grad im Uhrzeigersinn ab 12 Uhr. Die Felder start_deg,
+ * sweep_deg und ticks können nach `my_lcd_gauge_init()` vor dem ersten
+ * `my_lcd_gauge_draw()` geändert werden.
+ */
+typedef struct {
+    int cx;             /**< Mittelpunkt X                                */
+    int cy;             /**< Mittelpunkt Y                                */
+    int radius;         /**< Radius des Skalenbogens                      */
+    int min;            /**< Wert am Skalenanfang                         */
+    int max;            /**< Wert am Skalenende                           */
+    int start_deg;      /**< Winkel des Skalenanfangs, Vorgabe -135       */
+    int sweep_deg;      /**< Skalenbogen, Vorgabe 270                     */
+    int ticks;          /**< Teilstrich-Intervalle, Vorgabe 10            */
+    uint16_t color;     /**< Farbe der Nadel                              */
+    uint16_t scale_color; /**< Farbe von Bogen, Teilstrichen und Nabe     */
+    uint16_t bgcolor;   /**< Hintergrundfarbe des Zifferblatts            */
+    int tip_x;          /**< Gezeichnete Nadelspitze X                    */
+    int tip_y;          /**< Gezeichnete Nadelspitze Y, -1 = keine Nadel  */
+} my_lcd_gauge_t;
+
 /**
  * @brief Startet einen Countdown (10 → 1) auf dem LCD.
  *
@@ -43,6 +103,101 @@ void startLCDTimer();
  */
 void my_lcd_draw_baargraph(int x, int y, int width, int height, int value, uint16_t color, uint16_t bgcolor);
 
+/**
+ * @brief Legt einen Bargraphen an, gezeichnet wird erst beim ersten Update.
+ *
+ * @param bar       Zustand des Bargraphen
+ * @param x         X-Startkoordinate des Balkens (linke obere Ecke)
+ * @param y         Y-Startkoordinate des Balkens
+ * @param width     Breite des Balkens in Pixel
+ * @param height    Höhe des Balkens in Pixel
+ * @param color     Farbe des gefüllten Bereichs
+ * @param bgcolor   Hintergrundfarbe (nicht gefüllter Bereich)
+ */
+void my_lcd_bargraph_init(my_lcd_bargraph_t *bar, int x, int y, int width, int height, uint16_t color, uint16_t bgcolor);
+
+/**
+ * @brief Zeigt einen neuen Wert an.
+ *
+ * Beim ersten Aufruf (oder nach `my_lcd_bargraph_invalidate()`) wird der
+ * ganze Balken gezeichnet, danach nur der Streifen zwischen alter und
+ * neuer Füllbreite. Ohne Änderung der Breite wird nichts gesendet.
+ *
+ * @param bar       Zustand des Bargraphen
+ * @param value     Füllstandswert (0–1000 entspricht 0–100 %)
+ */
+void my_lcd_bargraph_update(my_lcd_bargraph_t *bar, int value);
+
+/**
+ * @brief Erzwingt beim nächsten Update ein vollständiges Neuzeichnen,
+ *        z. B. nachdem der Bildschirm gelöscht wurde.
+ *
+ * @param bar       Zustand des Bargraphen
+ */
+void my_lcd_bargraph_invalidate(my_lcd_bargraph_t *bar);
+
+/**
+ * @brief Sinus aus der Tabelle (Viertelwelle, 257 Einträge Q15).
+ *
+ * @param angle     Winkel in Schritten, MY_LCD_ANGLE_STEPS pro Umdrehung,
+ *                  beliebig (auch negativ)
+ * @return sin(angle) in Q15 (-32767..32767)
+ */
+int16_t my_lcd_sin_q15(int angle);
+
+/**
+ * @brief Kosinus aus der Tabelle.
+ *
+ * @param angle     Winkel in Schritten, MY_LCD_ANGLE_STEPS pro Umdrehung
+ * @return cos(angle) in Q15
+ */
+int16_t my_lcd_cos_q15(int angle);
+
+/**
+ * @brief Legt ein Rundinstrument an (Skala -135° .. +135°, 10 Intervalle).
+ *
+ * @param gauge       Zustand
+ * @param cx          Mittelpunkt X
+ * @param cy          Mittelpunkt Y
+ * @param radius      Radius des Skalenbogens
+ * @param min         Wert am Skalenanfang
+ * @param max         Wert am Skalenende (> min)
+ * @param color       Farbe der Nadel
+ * @param scale_color Farbe der Skala
+ * @param bgcolor     Hintergrundfarbe
+ *
+ * Beispiel:
+ * `my_lcd_gauge_init(&rpm, 120, 160, 80, 0, 5000, RED, BLACK, WHITE);`
+ */
+void my_lcd_gauge_init(my_lcd_gauge_t *gauge, int cx, int cy, int radius, int min, int max,
+                       uint16_t color, uint16_t scale_color, uint16_t bgcolor);
+
+/**
+ * @brief Zeichnet Zifferblatt, Skalenbogen, Teilstriche und Nabe; die
+ *        Nadel folgt beim nächsten Update.
+ *
+ * @param gauge     Zustand
+ */
+void my_lcd_gauge_draw(my_lcd_gauge_t *gauge);
+
+/**
+ * @brief Stellt die Nadel auf einen neuen Wert (begrenzt auf min..max).
+ *
+ * Ohne Änderung der Nadelspitze wird nichts gesendet.
+ *
+ * @param gauge     Zustand
+ * @param value     Wert
+ */
+void my_lcd_gauge_update(my_lcd_gauge_t *gauge, int value);
+
+/**
+ * @brief Vergisst die gezeichnete Nadel, z. B. nachdem der Bildschirm
+ *        gelöscht wurde (danach `my_lcd_gauge_draw()`).
+ *
+ * @param gauge     Zustand
+ */
+void my_lcd_gauge_invalidate(my_lcd_gauge_t *gauge);
+
 /**
  * @brief Zeichnet ein diagonales Kreuz auf dem LCD.
  *
@@ -0,0 +1,283 @@
+/**
+ ******************************************************************************
+ * @file        osal.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Optional RTOS layer: events, locks, delay, HAL timebase
+ *
+ * Functionality:
+ * - Event = flag + (RTOS build) binary semaphore. The flag carries the
+ *   state, the semaphore only wakes the waiting task, so a signal given
+ *   before the wait is never lost and a stale semaphore count only
+ *   causes one extra check.
+ * - Kernel objects are created on the first wait / lock from a running
+ *   task. Before vTaskStartScheduler() FreeRTOS leaves the syscall
+ *   interrupts masked after every API call; creating nothing before the
+ *   start keeps the DMA and I2C completion interrupts working while the
+ *   drivers are initialized from main().
+ * - Before the scheduler runs and in the bare metal build a wait sleeps
+ *   with __WFI() until the flag is set.
+ *
+ * Peripherals:
+ * - RTOS build: TIM14 as HAL timebase (TIM8_TRG_COM_TIM14_IRQn)
+ ******************************************************************************
+ */
+
+#include "osal.h"
+#include <health/health.h>
+
+#if OSAL_FREERTOS
+#include "task.h"
+#include <clock/clock.h>
+#include <tim_alloc/tim_alloc.h>
+#endif
+
+/* Private Preprocessor Defines -------------------------------------------- */
+/**
+ * @brief RTOS build: counter clock of the timebase timer in Hz.
+ */
+#define OSAL_TIMEBASE_COUNTER_HZ    1000000U
+
+/* Static function prototypes ---------------------------------------------- */
+static HAL_StatusTypeDef osal_poll(osal_event_t *event, uint32_t u32_timeout_ms);
+
+#if OSAL_FREERTOS
+static uint8_t osal_kernel_running(void);
+#endif
+
+/* Public functions --------------------------------------------------------- */
+void osal_event_init(osal_event_t *event)
+{
+#if OSAL_FREERTOS
+    event->handle = NULL;
+#endif
+    event->u8_set = 0u;
+}
+
+void osal_event_signal(osal_event_t *event)
+{
+    event->u8_set = 1u;
+
+#if OSAL_FREERTOS
+    __DMB();
+    if (event->handle == NULL) {
+        return;
+    }
+
+    if (osal_in_isr()) {
+        BaseType_t woken = pdFALSE;
+
+        xSemaphoreGiveFromISR(event->handle, &woken);
+        portYIELD_FROM_ISR(woken);
+    } else {
+        xSemaphoreGive(event->handle);
+    }
+#endif
+}
+
+void osal_event_clear(osal_event_t *event)
+{
+    event->u8_set = 0u;
+}
+
+HAL_StatusTypeDef osal_event_wait(osal_event_t *event, uint32_t u32_timeout_ms)
+{
+#if OSAL_FREERTOS
+    TickType_t start;
+    TickType_t timeout;
+
+    if (!osal_kernel_running() || osal_in_isr()) {
+        return osal_poll(event, u32_timeout_ms);
+    }
+
+    if (event->handle == NULL) {
+        taskENTER_CRITICAL();
+        if (event->handle == NULL) {
+            event->handle = xSemaphoreCreateBinaryStatic(&event->storage);
+        }
+        taskEXIT_CRITICAL();
+    }
+
+    start   = xTaskGetTickCount();
+    timeout = (u32_timeout_ms == OSAL_WAIT_FOREVER) ? portMAX_DELAY : pdMS_TO_TICKS(u32_timeout_ms);
+
+    while (!event->u8_set) {
+        TickType_t elapsed = xTaskGetTickCount() - start;
+
+        if ((timeout != portMAX_DELAY) && (elapsed >= timeout)) {
+            return HAL_TIMEOUT;
+        }
+
+        xSemaphoreTake(event->handle, (timeout == portMAX_DELAY) ? portMAX_DELAY : (timeout - elapsed));
+    }
+
+    event->u8_set = 0u;
+
+    return HAL_OK;
+#else
+    return osal_poll(event, u32_timeout_ms);
+#endif
+}
+
+void osal_lock_init(osal_lock_t *lock)
+{
+#if OSAL_FREERTOS
+    lock->handle = NULL;
+#else
+    (void)lock;
+#endif
+}
+
+void osal_lock(osal_lock_t *lock)
+{
+#if OSAL_FREERTOS
+    if (!osal_kernel_running() || osal_in_isr()) {
+        return;
+    }
+
+    if (lock->handle == NULL) {
+        taskENTER_CRITICAL();
+        if (lock->handle == NULL) {
+            lock->handle = xSemaphoreCreateRecursiveMutexStatic(&lock->storage);
+        }
+        taskEXIT_CRITICAL();
+    }
+
+    xSemaphoreTakeRecursive(lock->handle, portMAX_DELAY);
+#else
+    (void)lock;
+#endif
+}
+
+void osal_unlock(osal_lock_t *lock)
+{
+#if OSAL_FREERTOS
+    if ((lock->handle == NULL) || !osal_kernel_running() || osal_in_isr()) {
+        return;
+    }
+
+    xSemaphoreGiveRecursive(lock->handle);
+#else
+    (void)lock;
+#endif
+}
+
+void osal_delay_ms(uint32_t u32_ms)
+{
+#if OSAL_FREERTOS
+    if (osal_kernel_running() && !osal_in_isr()) {
+        TickType_t ticks = pdMS_TO_TICKS(u32_ms);
+
+        vTaskDelay((ticks > 0u) ? ticks : 1u);
+        return;
+    }
+#endif
+
+    HAL_Delay(u32_ms);
+}
+
+uint8_t osal_in_isr(void)
+{
+    return (__get_IPSR() != 0u) ? 1u : 0u;
+}
+
+/* Static module functions -------------------------------------------------- */
+/**
+ * @brief Waits for the event flag without a kernel.
+ *
+ * __WFI() with PRIMASK set still wakes on a pending interrupt; checking
+ * the flag with interrupts masked closes the gap between the check and
+ * the sleep. Called with interrupts already masked the flag is only
+ * polled (the setting interrupt cannot run then anyway).
+ *
+ * @param event          Event
+ * @param u32_timeout_ms Timeout, OSAL_WAIT_FOREVER = none
+ * @return HAL_OK, HAL_TIMEOUT
+ */
+static HAL_StatusTypeDef osal_poll(osal_event_t *event, uint32_t u32_timeout_ms)
+{
+    uint32_t u32_start = HAL_GetTick();
+    uint32_t u32_primask = __get_PRIMASK();
+
+    while (1) {
+        __disable_irq();
+        if (event->u8_set) {
+            event->u8_set = 0u;
+            __set_PRIMASK(u32_primask);
+            return HAL_OK;
+        }
+        if ((u32_primask == 0u) && !osal_in_isr()) {
+            HEALTH_IDLE_BEGIN();
+            __WFI();
+            HEALTH_IDLE_END();
+        }
+        __set_PRIMASK(u32_primask);
+
+        if ((u32_timeout_ms != OSAL_WAIT_FOREVER) && ((HAL_GetTick() - u32_start) >= u32_timeout_ms)) {
+            return HAL_TIMEOUT;
+        }
+    }
+}
+
+#if OSAL_FREERTOS
+/**
+ * @brief Returns 1 once vTaskStartScheduler() has started the kernel.
+ *
+ * @return 1 if the scheduler runs
+ */
+static uint8_t osal_kernel_running(void)
+{
+    return (xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED) ? 1u : 0u;
+}
+
+/* HAL timebase (RTOS build) ----------------------------------------------- */
+/**
+ * @brief Replaces the SysTick based HAL timebase: TIM14 update interrupt
+ *        every 1 / uwTickFreq ms. Called by HAL_Init() and after every
+ *        clock change (HAL_RCC_ClockConfig()).
+ *
+ * @param TickPriority NVIC priority of the tick interrupt
+ * @return HAL_OK
+ */
+HAL_StatusTypeDef HAL_InitTick(uint32_t TickPriority)
+{
+    if (tim_alloc_claim(OSAL_TIMEBASE_TIM, TIM_ALLOC_OWNER_OSAL) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    OSAL_TIMEBASE_TIM->CR1  = 0u;
+    OSAL_TIMEBASE_TIM->PSC  = (clock_get_apb1_timer_clock() / OSAL_TIMEBASE_COUNTER_HZ) - 1u;
+    OSAL_TIMEBASE_TIM->ARR  = (OSAL_TIMEBASE_COUNTER_HZ / 1000u) * (uint32_t)uwTickFreq - 1u;
+    OSAL_TIMEBASE_TIM->EGR  = TIM_EGR_UG;
+    OSAL_TIMEBASE_TIM->SR   = 0u;
+    OSAL_TIMEBASE_TIM->DIER = TIM_DIER_UIE;
+
+    HAL_NVIC_SetPriority(OSAL_TIMEBASE_IRQn, TickPriority, 0u);
+    HAL_NVIC_EnableIRQ(OSAL_TIMEBASE_IRQn);
+    uwTickPrio = TickPriority;
+
+    OSAL_TIMEBASE_TIM->CR1 = TIM_CR1_CEN;
+
+    return HAL_OK;
+}
+
+void HAL_SuspendTick(void)
+{
+    OSAL_TIMEBASE_TIM->DIER &= ~TIM_DIER_UIE;
+}
+
+void HAL_ResumeTick(void)
+{
+    OSAL_TIMEBASE_TIM->DIER |= TIM_DIER_UIE;
+}
+
+/* Interrupt / callback section -------------------------------------------- */
+void TIM8_TRG_COM_TIM14_IRQHandler(void)
+{
+    if (OSAL_TIMEBASE_TIM->SR & TIM_SR_UIF) {
+        OSAL_TIMEBASE_TIM->SR = (uint32_t)~TIM_SR_UIF;
+        HAL_IncTick();
+    }
+}
+#endif
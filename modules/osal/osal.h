@@ -0,0 +1,190 @@
+/**
+ ******************************************************************************
+ * @file        osal.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the optional RTOS layer of the modules.
+ *
+ * @details
+ * Small wait/lock layer used by lcd, env_sensor, fan and potis_dma
+ * where they wait for a DMA or interrupt completion. The same driver code
+ * builds for two targets:
+ *
+ *  - OSAL_FREERTOS = 0 (default, bare metal): events are flags set from
+ *    the interrupt, a wait sleeps with __WFI() until the flag is set,
+ *    locks are empty.
+ *  - OSAL_FREERTOS = 1: events are binary semaphores, a waiting task
+ *    blocks and the scheduler runs other tasks (or its idle hook) until
+ *    the completion interrupt gives the semaphore; locks are recursive
+ *    mutexes. Needs FreeRTOS in the project (FreeRTOS.h, semphr.h,
+ *    configSUPPORT_STATIC_ALLOCATION = 1) and USE_RTOS_SYSTICK, so
+ *    SysTick belongs to the kernel. The HAL tick then runs on
+ *    OSAL_TIMEBASE_TIM, osal.c provides HAL_InitTick() for it.
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - Events: wait with timeout (task), signal (task or interrupt)
+ *  - Recursive locks for driver APIs shared by several tasks
+ *  - Delay: vTaskDelay() or HAL_Delay()
+ *  - HAL timebase on TIM14 in the RTOS build
+ *
+ * Events and locks must be initialized before the first use; the RTOS
+ * build creates the kernel objects statically on the first wait / lock
+ * of a running task, no heap is used. Interrupts signalling an event
+ * need a priority >= configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY
+ * (OSAL_IRQ_PRIORITY_MIN). Drivers initialized from main() before
+ * vTaskStartScheduler() must be initialized before other kernel objects
+ * are created: FreeRTOS masks these interrupts until the start after
+ * its first API call.
+ *
+ ******************************************************************************
+ */
+
+#ifndef OSAL_OSAL_H_
+#define OSAL_OSAL_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief 1 to build the modules for FreeRTOS.
+ */
+#ifndef OSAL_FREERTOS
+#define OSAL_FREERTOS       0
+#endif
+
+#if OSAL_FREERTOS
+#include "FreeRTOS.h"
+#include "semphr.h"
+
+#if !defined(USE_RTOS_SYSTICK)
+#error "OSAL_FREERTOS needs USE_RTOS_SYSTICK: SysTick belongs to the kernel"
+#endif
+#endif
+
+/**
+ * @brief Timeout value "wait forever".
+ */
+#define OSAL_WAIT_FOREVER   0xFFFFFFFFUL
+
+/**
+ * @brief Lowest NVIC priority value of an interrupt that signals an event.
+ */
+#if OSAL_FREERTOS
+#define OSAL_IRQ_PRIORITY_MIN   configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY
+#else
+#define OSAL_IRQ_PRIORITY_MIN   0
+#endif
+
+/**
+ * @brief RTOS build: timer of the HAL tick (APB1, IRQ shared with the
+ *        TIM8 trigger/commutation interrupt, which no module uses).
+ */
+#define OSAL_TIMEBASE_TIM       TIM14
+#define OSAL_TIMEBASE_IRQn      TIM8_TRG_COM_TIM14_IRQn
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Completion event (binary: several signals before the wait count
+ *        once).
+ */
+typedef struct {
+    volatile uint8_t  u8_set;       /**< Event state                     */
+#if OSAL_FREERTOS
+    SemaphoreHandle_t handle;       /**< Wakes the waiting task, lazy    */
+    StaticSemaphore_t storage;
+#endif
+} osal_event_t;
+
+/**
+ * @brief Recursive lock.
+ */
+typedef struct {
+#if OSAL_FREERTOS
+    SemaphoreHandle_t handle;       /**< Recursive mutex, lazy           */
+    StaticSemaphore_t storage;
+#else
+    uint8_t           u8_unused;
+#endif
+} osal_lock_t;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Initializes an event (not set).
+ *
+ * @param event Event
+ * @return None
+ */
+void osal_event_init(osal_event_t *event);
+
+/**
+ * @brief Waits for an event and clears it.
+ *
+ * May only be called from a task / the main loop; with interrupts masked
+ * the bare metal build polls the flag instead of sleeping.
+ *
+ * @param event         Event
+ * @param u32_timeout_ms Timeout, OSAL_WAIT_FOREVER = none
+ * @return HAL_OK, HAL_TIMEOUT
+ */
+HAL_StatusTypeDef osal_event_wait(osal_event_t *event, uint32_t u32_timeout_ms);
+
+/**
+ * @brief Sets an event from a task or an interrupt.
+ *
+ * @param event Event
+ * @return None
+ */
+void osal_event_signal(osal_event_t *event);
+
+/**
+ * @brief Clears an event without waiting.
+ *
+ * @param event Event
+ * @return None
+ */
+void osal_event_clear(osal_event_t *event);
+
+/**
+ * @brief Initializes a recursive lock.
+ *
+ * @param lock Lock
+ * @return None
+ */
+void osal_lock_init(osal_lock_t *lock);
+
+/**
+ * @brief Takes a lock (nestable by the same task). No-op in interrupts,
+ *        before the kernel runs and in the bare metal build.
+ *
+ * @param lock Lock
+ * @return None
+ */
+void osal_lock(osal_lock_t *lock);
+
+/**
+ * @brief Releases a lock taken with osal_lock().
+ *
+ * @param lock Lock
+ * @return None
+ */
+void osal_unlock(osal_lock_t *lock);
+
+/**
+ * @brief Waits for the given time, other tasks run meanwhile.
+ *
+ * @param u32_ms Time in ms
+ * @return None
+ */
+void osal_delay_ms(uint32_t u32_ms);
+
+/**
+ * @brief Returns 1 in interrupt context.
+ *
+ * @return 1 in an interrupt, 0 in a task / the main loop
+ */
+uint8_t osal_in_isr(void);
+
+#endif /* OSAL_OSAL_H_ */
@@ -0,0 +1,533 @@
+/**
+ ******************************************************************************
+ * @file        params.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Persistent parameter store (log structured, two sectors)
+ *
+ * Functionality:
+ * - Sector: magic, sequence number, then entries of two words (value,
+ *   key | check << 16) from the start to the first erased entry
+ * - Boot: the sector with the higher sequence number is active; if both
+ *   are valid a compaction was cut, the older one is read first and the
+ *   compaction continues
+ * - Compaction: the erased spare sector gets the header with the next
+ *   sequence number, all values are marked changed and appended, then
+ *   the old sector is erased for the next round
+ * - The erase is only started and polled, the program keeps running from
+ *   the other bank meanwhile; no operation starts while the controller
+ *   is busy with one of modules/fw_update
+ * - After a bank swap (FW_UPDATE_ENABLE) the store of the old bank is
+ *   found in the running one: it is read when the other bank holds no
+ *   store yet, written there by the first compaction and then
+ *   invalidated (magic 0, one program operation that stalls the CPU)
+ *
+ * Resources:
+ * - Flash sectors 22 and 23 (bank 2), 10 and 11 after a bank swap,
+ *   FLASH controller from the main loop
+ ******************************************************************************
+ */
+
+#include "params.h"
+#include "fw_update/fw_update.h"
+
+/* Preprocessor Defines ----------------------------------------------------- */
+#if PARAMS_MAX_KEYS > 32U
+#error "PARAMS_MAX_KEYS: the valid and dirty masks hold 32 keys"
+#endif
+
+/**
+ * @brief Header words of a sector ("PRM1", sequence number).
+ */
+#define PARAMS_MAGIC            0x314D5250UL
+#define PARAMS_HEADER_SIZE      8UL
+
+/**
+ * @brief Size of an entry and the value of an erased word.
+ */
+#define PARAMS_ENTRY_SIZE       8UL
+#define PARAMS_ERASED           0xFFFFFFFFUL
+
+/**
+ * @brief No active sector (first boot).
+ */
+#define PARAMS_NONE             0xFFU
+
+/**
+ * @brief Distance of the store of the running bank (left by the image
+ *        before a bank swap).
+ */
+#define PARAMS_MIRROR_OFFSET    0x00100000UL
+
+/**
+ * @brief Error flags of an erase or program operation.
+ */
+#define PARAMS_FLASH_ERRORS     (FLASH_FLAG_OPERR | FLASH_FLAG_WRPERR | FLASH_FLAG_PGAERR | \
+                                 FLASH_FLAG_PGPERR | FLASH_FLAG_PGSERR)
+
+/* Static module variables -------------------------------------------------- */
+/**
+ * @brief Base addresses and HAL sector numbers of the two sectors (the
+ *        numbers are physical, set by params_init() for the bank).
+ */
+static const uint32_t g_u32_params_sector_addr[2] = { PARAMS_SECTOR_A_ADDR, PARAMS_SECTOR_B_ADDR };
+static uint32_t g_u32_params_sector_num[2]        = { FLASH_SECTOR_22, FLASH_SECTOR_23 };
+
+/**
+ * @brief RAM table, keys with a value, keys not written to flash yet.
+ */
+static uint32_t g_u32_params_value[PARAMS_MAX_KEYS];
+static volatile uint32_t g_u32_params_valid = 0u;
+static volatile uint32_t g_u32_params_dirty = 0u;
+
+/**
+ * @brief Set by params_init(), the flash is only written afterwards.
+ */
+static uint8_t g_u8_params_ready = 0u;
+
+/**
+ * @brief Active sector, its sequence number and the next free entry.
+ */
+static uint8_t g_u8_params_active = PARAMS_NONE;
+static uint32_t g_u32_params_seq = 0u;
+static uint32_t g_u32_params_write = 0u;
+
+/**
+ * @brief State of the other sector: erased, erase running, old copy
+ *        to be erased once all values are in the active one.
+ */
+static uint8_t g_u8_params_spare_blank = 0u;
+static uint8_t g_u8_params_erasing = 0u;
+static uint8_t g_u8_params_erase_old = 0u;
+
+/**
+ * @brief Active sector full, compact at the next run.
+ */
+static uint8_t g_u8_params_compact = 0u;
+
+#if FW_UPDATE_ENABLE
+/**
+ * @brief Store of the running bank and its sectors that still hold one
+ *        (bit 0: A, bit 1: B).
+ */
+static const uint32_t g_u32_params_mirror_addr[2] = {
+    PARAMS_SECTOR_A_ADDR - PARAMS_MIRROR_OFFSET, PARAMS_SECTOR_B_ADDR - PARAMS_MIRROR_OFFSET
+};
+static uint8_t g_u8_params_mirror = 0u;
+#endif
+
+/* Static function prototypes ---------------------------------------------- */
+static uint32_t params_header(uint32_t u32_key, uint32_t u32_value);
+static uint32_t params_load(uint32_t u32_base);
+static uint8_t params_blank(uint8_t u8_sector);
+static uint8_t params_spare(void);
+static void params_erase_start(uint8_t u8_sector);
+static void params_erase_done(void);
+static HAL_StatusTypeDef params_program(uint32_t u32_addr, uint32_t u32_word);
+static HAL_StatusTypeDef params_start_sector(void);
+static uint8_t params_append(void);
+#if FW_UPDATE_ENABLE
+static void params_load_mirror(void);
+static void params_drop_mirror(void);
+#endif
+
+/* Public functions --------------------------------------------------------- */
+HAL_StatusTypeDef params_init(void)
+{
+    const uint32_t *pu32_a = (const uint32_t *)PARAMS_SECTOR_A_ADDR;
+    const uint32_t *pu32_b = (const uint32_t *)PARAMS_SECTOR_B_ADDR;
+    uint8_t u8_valid_a = (pu32_a[0] == PARAMS_MAGIC) ? 1u : 0u;
+    uint8_t u8_valid_b = (pu32_b[0] == PARAMS_MAGIC) ? 1u : 0u;
+    uint8_t u8_newer;
+
+    g_u32_params_valid = 0u;
+    g_u32_params_dirty = 0u;
+    g_u8_params_ready  = 1u;
+
+    if (fw_update_get_bank() == 2u) {
+        g_u32_params_sector_num[0] = FLASH_SECTOR_10;
+        g_u32_params_sector_num[1] = FLASH_SECTOR_11;
+    }
+
+#if FW_UPDATE_ENABLE
+    g_u8_params_mirror = 0u;
+    for (uint8_t u8_sector = 0u; u8_sector < 2u; u8_sector++) {
+        if (((const uint32_t *)(uintptr_t)g_u32_params_mirror_addr[u8_sector])[0] == PARAMS_MAGIC) {
+            g_u8_params_mirror |= (uint8_t)(1u << u8_sector);
+        }
+    }
+#endif
+
+    if (!u8_valid_a && !u8_valid_b) {
+        /* First boot: params_task() formats sector A */
+        g_u8_params_active      = PARAMS_NONE;
+        g_u8_params_spare_blank = params_blank(0u);
+#if FW_UPDATE_ENABLE
+        /* First boot after a bank swap: the values come along */
+        if (g_u8_params_mirror) {
+            params_load_mirror();
+            return HAL_OK;
+        }
+#endif
+        return HAL_ERROR;
+    }
+
+    if (u8_valid_a && u8_valid_b) {
+        /* Compaction cut by a reset: old values first, the newer sector overrides */
+        u8_newer = ((int32_t)(pu32_b[1] - pu32_a[1]) > 0) ? 1u : 0u;
+        (void)params_load(g_u32_params_sector_addr[u8_newer ^ 1u]);
+        g_u32_params_write      = params_load(g_u32_params_sector_addr[u8_newer]);
+        g_u32_params_dirty      = g_u32_params_valid;
+        g_u8_params_spare_blank = 0u;
+        g_u8_params_erase_old   = 1u;
+    } else {
+        u8_newer = u8_valid_b;
+        g_u32_params_write      = params_load(g_u32_params_sector_addr[u8_newer]);
+        g_u8_params_spare_blank = params_blank(u8_newer ^ 1u);
+    }
+
+    g_u8_params_active = u8_newer;
+    g_u32_params_seq   = ((const uint32_t *)(uintptr_t)g_u32_params_sector_addr[u8_newer])[1];
+
+    return HAL_OK;
+}
+
+uint8_t params_has(params_key_t key)
+{
+    return ((uint32_t)key < PARAMS_MAX_KEYS) ? (uint8_t)((g_u32_params_valid >> key) & 1u) : 0u;
+}
+
+uint32_t params_get_u32(params_key_t key, uint32_t u32_default)
+{
+    return params_has(key) ? g_u32_params_value[key] : u32_default;
+}
+
+float params_get_float(params_key_t key, float f_default)
+{
+    union { uint32_t u32; float f; } value;
+
+    value.f = f_default;
+    value.u32 = params_get_u32(key, value.u32);
+
+    return value.f;
+}
+
+HAL_StatusTypeDef params_set_u32(params_key_t key, uint32_t u32_value)
+{
+    uint32_t u32_primask;
+    uint32_t u32_bit;
+
+    if ((uint32_t)key >= PARAMS_MAX_KEYS) {
+        return HAL_ERROR;
+    }
+    u32_bit = 1UL << key;
+
+    u32_primask = __get_PRIMASK();
+    __disable_irq();
+    if (!(g_u32_params_valid & u32_bit) || (g_u32_params_value[key] != u32_value)) {
+        g_u32_params_value[key] = u32_value;
+        g_u32_params_valid     |= u32_bit;
+        g_u32_params_dirty     |= u32_bit;
+    }
+    __set_PRIMASK(u32_primask);
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef params_set_float(params_key_t key, float f_value)
+{
+    union { uint32_t u32; float f; } value;
+
+    value.f = f_value;
+
+    return params_set_u32(key, value.u32);
+}
+
+void params_task(void)
+{
+    if (!g_u8_params_ready) {
+        return;
+    }
+
+    if (g_u8_params_erasing) {
+        if (__HAL_FLASH_GET_FLAG(FLASH_FLAG_BSY)) {
+            return;
+        }
+        params_erase_done();
+    }
+
+    /* The controller is busy with modules/fw_update */
+    if (__HAL_FLASH_GET_FLAG(FLASH_FLAG_BSY)) {
+        return;
+    }
+
+    if ((g_u8_params_active == PARAMS_NONE) || g_u8_params_compact) {
+        if (!g_u8_params_spare_blank) {
+            params_erase_start(params_spare());
+            return;
+        }
+        if (params_start_sector() != HAL_OK) {
+            return;
+        }
+    }
+
+    if (!params_append()) {
+        return;
+    }
+
+    /* All values are in the active sector, the old copy can go */
+    if ((g_u32_params_dirty == 0u) && g_u8_params_erase_old) {
+        g_u8_params_erase_old = 0u;
+        params_erase_start(params_spare());
+        return;
+    }
+
+#if FW_UPDATE_ENABLE
+    if ((g_u32_params_dirty == 0u) && g_u8_params_mirror) {
+        params_drop_mirror();
+    }
+#endif
+}
+
+uint8_t params_pending(void)
+{
+    return ((g_u32_params_dirty != 0u) || g_u8_params_erase_old) ? 1u : 0u;
+}
+
+/* Static module functions -------------------------------------------------- */
+/**
+ * @brief Returns the second word of an entry: key and check value.
+ *
+ * @param u32_key   Key
+ * @param u32_value Value
+ * @return Header word, never erased (key < PARAMS_MAX_KEYS)
+ */
+static uint32_t params_header(uint32_t u32_key, uint32_t u32_value)
+{
+    uint32_t u32_check = ((u32_value ^ (u32_key * 0x9E3779B1UL)) * 0x85EBCA6BUL) >> 16;
+
+    return u32_key | (u32_check << 16);
+}
+
+/**
+ * @brief Reads the entries of a sector into the RAM table.
+ *
+ * @param u32_base Address of the sector
+ * @return Address of the first erased entry
+ */
+static uint32_t params_load(uint32_t u32_base)
+{
+    uint32_t u32_addr = u32_base + PARAMS_HEADER_SIZE;
+    uint32_t u32_end  = u32_base + PARAMS_SECTOR_SIZE;
+    uint32_t u32_value;
+    uint32_t u32_header;
+    uint32_t u32_key;
+
+    while (u32_addr + PARAMS_ENTRY_SIZE <= u32_end) {
+        u32_value  = ((const uint32_t *)(uintptr_t)u32_addr)[0];
+        u32_header = ((const uint32_t *)(uintptr_t)u32_addr)[1];
+        if ((u32_value == PARAMS_ERASED) && (u32_header == PARAMS_ERASED)) {
+            break;
+        }
+
+        /* Entries with a wrong check value were cut by a reset */
+        u32_key = u32_header & 0xFFFFu;
+        if ((u32_key < PARAMS_MAX_KEYS) && (u32_header == params_header(u32_key, u32_value))) {
+            g_u32_params_value[u32_key] = u32_value;
+            g_u32_params_valid |= 1UL << u32_key;
+        }
+        u32_addr += PARAMS_ENTRY_SIZE;
+    }
+
+    return u32_addr;
+}
+
+/**
+ * @brief Checks whether a sector is completely erased.
+ *
+ * @param u8_sector Sector index
+ * @return 1 if erased
+ */
+static uint8_t params_blank(uint8_t u8_sector)
+{
+    const uint32_t *pu32_word = (const uint32_t *)(uintptr_t)g_u32_params_sector_addr[u8_sector];
+
+    for (uint32_t i = 0u; i < PARAMS_SECTOR_SIZE / sizeof(uint32_t); i++) {
+        if (pu32_word[i] != PARAMS_ERASED) {
+            return 0u;
+        }
+    }
+
+    return 1u;
+}
+
+/**
+ * @brief Returns the sector that is not active (A on the first boot).
+ *
+ * @return Sector index
+ */
+static uint8_t params_spare(void)
+{
+    return (g_u8_params_active == PARAMS_NONE) ? 0u : (uint8_t)(g_u8_params_active ^ 1u);
+}
+
+/**
+ * @brief Starts the erase of a sector and returns at once.
+ *
+ * @param u8_sector Sector index
+ * @return None
+ */
+static void params_erase_start(uint8_t u8_sector)
+{
+    HAL_FLASH_Unlock();
+    __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_EOP | PARAMS_FLASH_ERRORS);
+    FLASH_Erase_Sector(g_u32_params_sector_num[u8_sector], FLASH_VOLTAGE_RANGE_3);
+    g_u8_params_erasing = 1u;
+}
+
+/**
+ * @brief Completes a finished erase; a failed one is repeated with the
+ *        next compaction.
+ *
+ * @return None
+ */
+static void params_erase_done(void)
+{
+    CLEAR_BIT(FLASH->CR, FLASH_CR_SER | FLASH_CR_SNB);
+    g_u8_params_spare_blank = (__HAL_FLASH_GET_FLAG(PARAMS_FLASH_ERRORS) == 0u) ? 1u : 0u;
+    __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_EOP | PARAMS_FLASH_ERRORS);
+    FLASH_FlushCaches();
+    HAL_FLASH_Lock();
+    g_u8_params_erasing = 0u;
+}
+
+/**
+ * @brief Programs one word (about 16 us, the CPU keeps running).
+ *
+ * @param u32_addr Address
+ * @param u32_word Word
+ * @return HAL status of the program operation
+ */
+static HAL_StatusTypeDef params_program(uint32_t u32_addr, uint32_t u32_word)
+{
+    HAL_StatusTypeDef status;
+
+    HAL_FLASH_Unlock();
+    status = HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, u32_addr, u32_word);
+    HAL_FLASH_Lock();
+
+    return status;
+}
+
+/**
+ * @brief Makes the erased spare sector the active one: header with the
+ *        next sequence number, all values to be appended again.
+ *
+ * @return HAL_OK, HAL_ERROR if programming failed (erased again)
+ */
+static HAL_StatusTypeDef params_start_sector(void)
+{
+    uint8_t u8_sector = params_spare();
+    uint32_t u32_addr = g_u32_params_sector_addr[u8_sector];
+    uint32_t u32_primask;
+
+    /* Sequence number first: without the magic the sector is not valid */
+    g_u8_params_spare_blank = 0u;
+    if ((params_program(u32_addr + 4u, g_u32_params_seq + 1u) != HAL_OK) ||
+        (params_program(u32_addr, PARAMS_MAGIC) != HAL_OK)) {
+        return HAL_ERROR;
+    }
+
+    /* The old sector stays valid until every value is in the new one */
+    g_u8_params_erase_old = (g_u8_params_active != PARAMS_NONE) ? 1u : 0u;
+    g_u8_params_active    = u8_sector;
+    g_u8_params_compact   = 0u;
+    g_u32_params_seq++;
+    g_u32_params_write    = u32_addr + PARAMS_HEADER_SIZE;
+
+    u32_primask = __get_PRIMASK();
+    __disable_irq();
+    g_u32_params_dirty |= g_u32_params_valid;
+    __set_PRIMASK(u32_primask);
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Appends up to PARAMS_WRITES_PER_RUN changed values.
+ *
+ * @return 1 if the run is done, 0 if the sector is full or failed
+ *         (compaction at the next run)
+ */
+static uint8_t params_append(void)
+{
+    uint32_t u32_end = g_u32_params_sector_addr[g_u8_params_active] + PARAMS_SECTOR_SIZE;
+    uint32_t u32_primask;
+    uint32_t u32_key;
+    uint32_t u32_value;
+
+    for (uint32_t u32_count = 0u; (u32_count < PARAMS_WRITES_PER_RUN) && (g_u32_params_dirty != 0u); u32_count++) {
+        /* Snapshot of the value, a set during the write marks it again */
+        u32_primask = __get_PRIMASK();
+        __disable_irq();
+        u32_key   = (uint32_t)__builtin_ctz(g_u32_params_dirty);
+        u32_value = g_u32_params_value[u32_key];
+        g_u32_params_dirty &= ~(1UL << u32_key);
+        __set_PRIMASK(u32_primask);
+
+        /* Value first: an entry without its header is skipped at boot */
+        if ((g_u32_params_write + PARAMS_ENTRY_SIZE > u32_end) ||
+            (params_program(g_u32_params_write, u32_value) != HAL_OK) ||
+            (params_program(g_u32_params_write + 4u, params_header(u32_key, u32_value)) != HAL_OK)) {
+            u32_primask = __get_PRIMASK();
+            __disable_irq();
+            g_u32_params_dirty |= 1UL << u32_key;
+            __set_PRIMASK(u32_primask);
+            g_u8_params_compact = 1u;
+            return 0u;
+        }
+        g_u32_params_write += PARAMS_ENTRY_SIZE;
+    }
+
+    return 1u;
+}
+
+#if FW_UPDATE_ENABLE
+/**
+ * @brief Reads the store of the running bank like params_init() the own
+ *        one; the first compaction writes all values into the own store.
+ *
+ * @return None
+ */
+static void params_load_mirror(void)
+{
+    uint32_t u32_a = g_u32_params_mirror_addr[0];
+    uint32_t u32_b = g_u32_params_mirror_addr[1];
+    uint32_t u32_seq_a = ((const uint32_t *)(uintptr_t)u32_a)[1];
+    uint32_t u32_seq_b = ((const uint32_t *)(uintptr_t)u32_b)[1];
+    uint8_t u8_newer = (uint8_t)(g_u8_params_mirror >> 1);
+
+    if (g_u8_params_mirror == 3u) {
+        u8_newer = ((int32_t)(u32_seq_b - u32_seq_a) > 0) ? 1u : 0u;
+        (void)params_load(u8_newer ? u32_a : u32_b);
+    }
+    (void)params_load(u8_newer ? u32_b : u32_a);
+    g_u32_params_seq = u8_newer ? u32_seq_b : u32_seq_a;
+}
+
+/**
+ * @brief Invalidates the store of the running bank once every value is
+ *        in the own one; a failed sector is tried again at the next run.
+ *
+ * @return None
+ */
+static void params_drop_mirror(void)
+{
+    for (uint8_t u8_sector = 0u; u8_sector < 2u; u8_sector++) {
+        if ((g_u8_params_mirror & (1u << u8_sector)) && (params_program(g_u32_params_mirror_addr[u8_sector], 0u) == HAL_OK)) {
+            g_u8_params_mirror &= (uint8_t)~(1u << u8_sector);
+        }
+    }
+}
+#endif
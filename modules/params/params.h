@@ -0,0 +1,156 @@
+/**
+ ******************************************************************************
+ * @file        params.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the persistent parameter store.
+ *
+ * @details
+ * Key-value store for values that are tuned on the unit: PI gains,
+ * maximum RPM, BME280 oversampling, ADC trims. The values live in a RAM
+ * table indexed by the key, built from flash at boot; reading and
+ * setting only touch this table and may happen from any context. The
+ * flash is written later by params_task() from the main loop.
+ *
+ * The store uses the sectors 22 and 23 (128 KB each) at the end of bank 2.
+ * Entries are appended, a changed value is a new entry; a full sector
+ * is compacted into the other one, which is erased in the background
+ * beforehand. Both sectors wear evenly, one erase per about 16000
+ * writes. As long as the program stays in bank 1 (first MB) the CPU
+ * keeps running from flash during the erase (read while write).
+ *
+ * The addresses stay the same after a bank swap of modules/fw_update
+ * (the program runs from bank 2, mapped first): the store is then in
+ * the sectors 10 and 11, the values of the old bank are taken over at
+ * the first boot (FW_UPDATE_ENABLE).
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - O(1) params_get_u32() / params_get_float() with a default for keys
+ *    that were never stored
+ *  - params_set_u32() / params_set_float(): RAM at once, flash with the
+ *    next runs of params_task()
+ *  - Each entry carries a check value, a write cut by a reset is
+ *    ignored at the next boot
+ *  - A compaction cut by a reset is completed at the next boot, no value
+ *    is lost
+ *
+ ******************************************************************************
+ */
+
+#ifndef PARAMS_PARAMS_H_
+#define PARAMS_PARAMS_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief Number of keys (size of the RAM table).
+ */
+#define PARAMS_MAX_KEYS             32U
+
+/**
+ * @brief Flash sectors of the store and their size.
+ */
+#define PARAMS_SECTOR_A_ADDR        0x081C0000UL
+#define PARAMS_SECTOR_B_ADDR        0x081E0000UL
+#define PARAMS_SECTOR_SIZE          0x00020000UL
+
+/**
+ * @brief Entries written per run of params_task() (about 30 us each).
+ */
+#define PARAMS_WRITES_PER_RUN       4U
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Keys. Once stored, a key must keep its number.
+ */
+typedef enum {
+    PARAMS_KEY_FAN_KP          = 0,     /**< float, fan_set_gains()         */
+    PARAMS_KEY_FAN_KI          = 1,     /**< float, 1/s                     */
+    PARAMS_KEY_FAN_MAX_RPM     = 2,     /**< u32, replaces FAN_MAX_RPM      */
+    PARAMS_KEY_ENV_OSR_T       = 3,     /**< u32, BME280_OVERSAMPLING_*     */
+    PARAMS_KEY_ENV_OSR_P       = 4,
+    PARAMS_KEY_ENV_OSR_H       = 5,
+    PARAMS_KEY_ENV_FILTER      = 6,     /**< u32, BME280_FILTER_COEFF_*     */
+    PARAMS_KEY_FAN_KD          = 7,     /**< float, % per RPM/s, 0 = PI     */
+    PARAMS_KEY_ADC_CAL_LOW_0   = 8,     /**< u32, raw at 0 V, channel 0..3  */
+    PARAMS_KEY_ADC_CAL_HIGH_0  = 12,    /**< u32, raw at VDDA, channel 0..3 */
+    PARAMS_KEY_USER            = 16     /**< First key of the application   */
+} params_key_t;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Builds the RAM table from flash.
+ *
+ * Without params_init() every get returns its default and nothing is
+ * written to flash.
+ *
+ * @return HAL_OK, HAL_ERROR if no sector holds a store (first boot:
+ *         the store is formatted by params_task())
+ */
+HAL_StatusTypeDef params_init(void);
+
+/**
+ * @brief Returns 1 if the key has a stored or set value.
+ *
+ * @param key Key
+ * @return 1 or 0
+ */
+uint8_t params_has(params_key_t key);
+
+/**
+ * @brief Returns the value of a key.
+ *
+ * @param key           Key
+ * @param u32_default   Value if the key has none
+ * @return Value
+ */
+uint32_t params_get_u32(params_key_t key, uint32_t u32_default);
+
+/**
+ * @brief Returns the value of a key stored as float.
+ *
+ * @param key       Key
+ * @param f_default Value if the key has none
+ * @return Value
+ */
+float params_get_float(params_key_t key, float f_default);
+
+/**
+ * @brief Sets a value (any context), written to flash by params_task().
+ *
+ * @param key       Key
+ * @param u32_value Value
+ * @return HAL_OK, HAL_ERROR for an invalid key
+ */
+HAL_StatusTypeDef params_set_u32(params_key_t key, uint32_t u32_value);
+
+/**
+ * @brief Sets a float value, see params_set_u32().
+ *
+ * @param key     Key
+ * @param f_value Value
+ * @return HAL_OK, HAL_ERROR for an invalid key
+ */
+HAL_StatusTypeDef params_set_float(params_key_t key, float f_value);
+
+/**
+ * @brief Flash work of the store: polls a running erase, appends up to
+ *        PARAMS_WRITES_PER_RUN changed values, compacts a full sector.
+ *        Main loop only, never waits for an erase.
+ *
+ * @return None
+ */
+void params_task(void);
+
+/**
+ * @brief Returns 1 while set values are not in flash yet.
+ *
+ * @return 1 or 0
+ */
+uint8_t params_pending(void);
+
+#endif /* PARAMS_PARAMS_H_ */
@@ -0,0 +1,206 @@
+/**
+ ******************************************************************************
+ * @file        pool.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Fixed-block memory pools
+ *
+ * Functionality:
+ * - Free list through the first word of every free block
+ * - Allocate / free with PRIMASK set for the list update only
+ * - Shared small and large pools, built on first use
+ *
+ * Resources:
+ * - POOL_SMALL_BLOCKS * POOL_SMALL_SIZE + POOL_LARGE_BLOCKS *
+ *   POOL_LARGE_SIZE bytes of SRAM
+ ******************************************************************************
+ */
+
+#include "pool.h"
+#include <utils/utils.h>
+
+#include <stddef.h>
+
+#if ((POOL_SMALL_SIZE % 4U) != 0U) || ((POOL_LARGE_SIZE % 4U) != 0U) || (POOL_SMALL_SIZE >= POOL_LARGE_SIZE)
+#error "POOL_SMALL_SIZE and POOL_LARGE_SIZE must be multiples of 4, small < large"
+#endif
+
+/* Static module variables -------------------------------------------------- */
+/**
+ * @brief Storage of the shared pools (words: aligned for the DMA). Not
+ *        cleared at startup, pool_init() links the blocks.
+ */
+static uint32_t g_u32_pool_small_storage[(POOL_SMALL_BLOCKS * POOL_SMALL_SIZE) / 4U] UTILS_NOINIT;
+static uint32_t g_u32_pool_large_storage[(POOL_LARGE_BLOCKS * POOL_LARGE_SIZE) / 4U] UTILS_NOINIT;
+
+/**
+ * @brief Shared pools, in rising block size.
+ */
+static pool_t g_pool_shared[POOL_CLASS_COUNT];
+static volatile uint8_t g_u8_pool_shared_ready = 0U;
+
+/* Static function prototypes ----------------------------------------------- */
+static void pool_shared_init(void);
+static pool_t *pool_shared_owner(const void *block);
+
+/* Public functions --------------------------------------------------------- */
+HAL_StatusTypeDef pool_init(pool_t *pool, void *storage, uint16_t u16_block_size, uint16_t u16_blocks)
+{
+    uint8_t *pu8_block = (uint8_t *)storage;
+
+    if ((pool == NULL) || (storage == NULL) || (u16_blocks == 0U) || (u16_block_size < sizeof(void *)) ||
+        ((u16_block_size % 4U) != 0U) || (((uintptr_t)storage % 4U) != 0U)) {
+        return HAL_ERROR;
+    }
+
+    /* Every block points to the next, the last one ends the list */
+    for (uint16_t i = 0U; i < u16_blocks; i++) {
+        *(void **)pu8_block = ((i + 1U) < u16_blocks) ? (pu8_block + u16_block_size) : NULL;
+        pu8_block += u16_block_size;
+    }
+
+    pool->pu8_storage    = (uint8_t *)storage;
+    pool->u16_block_size = u16_block_size;
+    pool->u16_blocks     = u16_blocks;
+    pool->u16_used       = 0U;
+    pool->u16_high_water = 0U;
+    pool->u32_failures   = 0U;
+    pool->p_free         = storage;
+
+    return HAL_OK;
+}
+
+void *pool_alloc(pool_t *pool)
+{
+    uint32_t u32_primask = __get_PRIMASK();
+    void *block;
+
+    __disable_irq();
+
+    block = pool->p_free;
+    if (block == NULL) {
+        pool->u32_failures++;
+    } else {
+        pool->p_free = *(void **)block;
+        pool->u16_used++;
+        if (pool->u16_used > pool->u16_high_water) {
+            pool->u16_high_water = pool->u16_used;
+        }
+    }
+
+    __set_PRIMASK(u32_primask);
+
+    return block;
+}
+
+void pool_free(pool_t *pool, void *block)
+{
+    uint32_t u32_primask;
+
+    if (block == NULL) {
+        return;
+    }
+
+    u32_primask = __get_PRIMASK();
+    __disable_irq();
+
+    *(void **)block = pool->p_free;
+    pool->p_free = block;
+    pool->u16_used--;
+
+    __set_PRIMASK(u32_primask);
+}
+
+void pool_get_stats(const pool_t *pool, pool_stats_t *stats)
+{
+    uint32_t u32_primask = __get_PRIMASK();
+
+    __disable_irq();
+    stats->u16_block_size = pool->u16_block_size;
+    stats->u16_blocks     = pool->u16_blocks;
+    stats->u16_used       = pool->u16_used;
+    stats->u16_high_water = pool->u16_high_water;
+    stats->u32_failures   = pool->u32_failures;
+    __set_PRIMASK(u32_primask);
+}
+
+void *pool_shared_alloc(uint16_t u16_size)
+{
+    pool_shared_init();
+
+    for (uint8_t i = 0U; i < (uint8_t)POOL_CLASS_COUNT; i++) {
+        if (u16_size <= g_pool_shared[i].u16_block_size) {
+            return pool_alloc(&g_pool_shared[i]);
+        }
+    }
+
+    return NULL;
+}
+
+void pool_shared_free(void *block)
+{
+    pool_t *pool = pool_shared_owner(block);
+
+    if (pool != NULL) {
+        pool_free(pool, block);
+    }
+}
+
+void pool_shared_get_stats(pool_class_t pool_class, pool_stats_t *stats)
+{
+    pool_shared_init();
+    pool_get_stats(&g_pool_shared[pool_class], stats);
+}
+
+/* Static module functions -------------------------------------------------- */
+/**
+ * @brief Builds the shared pools on the first call from any context.
+ *
+ * @return None
+ */
+static void pool_shared_init(void)
+{
+    uint32_t u32_primask;
+
+    if (g_u8_pool_shared_ready) {
+        return;
+    }
+
+    u32_primask = __get_PRIMASK();
+    __disable_irq();
+    if (!g_u8_pool_shared_ready) {
+        (void)pool_init(&g_pool_shared[POOL_CLASS_SMALL], g_u32_pool_small_storage, POOL_SMALL_SIZE,
+                        POOL_SMALL_BLOCKS);
+        (void)pool_init(&g_pool_shared[POOL_CLASS_LARGE], g_u32_pool_large_storage, POOL_LARGE_SIZE,
+                        POOL_LARGE_BLOCKS);
+        g_u8_pool_shared_ready = 1U;
+    }
+    __set_PRIMASK(u32_primask);
+}
+
+/**
+ * @brief Returns the shared pool whose storage holds a block.
+ *
+ * @param block Block
+ * @return Pool, NULL for a block of no shared pool
+ */
+static pool_t *pool_shared_owner(const void *block)
+{
+    const uint8_t *pu8_block = (const uint8_t *)block;
+
+    if (!g_u8_pool_shared_ready || (block == NULL)) {
+        return NULL;
+    }
+
+    for (uint8_t i = 0U; i < (uint8_t)POOL_CLASS_COUNT; i++) {
+        const pool_t *pool = &g_pool_shared[i];
+
+        if ((pu8_block >= pool->pu8_storage) &&
+            (pu8_block < pool->pu8_storage + (uint32_t)pool->u16_blocks * pool->u16_block_size)) {
+            return &g_pool_shared[i];
+        }
+    }
+
+    return NULL;
+}
@@ -0,0 +1,160 @@
+/**
+ ******************************************************************************
+ * @file        pool.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the fixed-block memory pools.
+ *
+ * @details
+ * Drivers that need a buffer per command, frame or record take it from a
+ * pool instead of malloc() (newlib heap, unbounded and slow through
+ * _sbrk()) or an array sized for their worst case. A pool is an array of
+ * equal blocks; the free blocks form a list through their first word, so
+ * allocating and freeing is O(1) with interrupts masked for a few
+ * instructions. Both work from any context.
+ *
+ * Two shared pools are built in, pool_shared_alloc() takes the smaller
+ * class that fits the size:
+ *  - POOL_CLASS_SMALL: lcd_queue texts, short telemetry frames
+ *  - POOL_CLASS_LARGE: SD card log sectors, batched telemetry frames
+ * The blocks lie in SRAM (not CCM), the DMA can read and write them.
+ * Further pools can be made with pool_init() over own storage.
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - O(1) allocate / free, per-pool free list, ISR safe
+ *  - Blocks word aligned, sizes a multiple of 4
+ *  - Statistics: used blocks, high-water mark, failed allocations
+ *
+ ******************************************************************************
+ */
+
+#ifndef POOL_POOL_H_
+#define POOL_POOL_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief Shared small blocks: size in bytes (multiple of 4) and count.
+ */
+#ifndef POOL_SMALL_SIZE
+#define POOL_SMALL_SIZE         64U
+#endif
+#ifndef POOL_SMALL_BLOCKS
+#define POOL_SMALL_BLOCKS       32U
+#endif
+
+/**
+ * @brief Shared large blocks: one SD card sector each.
+ */
+#ifndef POOL_LARGE_SIZE
+#define POOL_LARGE_SIZE         512U
+#endif
+#ifndef POOL_LARGE_BLOCKS
+#define POOL_LARGE_BLOCKS       8U
+#endif
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Classes of the shared pools.
+ */
+typedef enum {
+    POOL_CLASS_SMALL = 0,
+    POOL_CLASS_LARGE,
+    POOL_CLASS_COUNT
+} pool_class_t;
+
+/**
+ * @brief One pool. Fields are private to the module.
+ */
+typedef struct {
+    void     *p_free;           /**< First free block, NULL when empty    */
+    uint8_t  *pu8_storage;      /**< u16_blocks blocks of u16_block_size  */
+    uint16_t  u16_block_size;
+    uint16_t  u16_blocks;
+    uint16_t  u16_used;
+    uint16_t  u16_high_water;   /**< Most blocks used at the same time    */
+    uint32_t  u32_failures;     /**< Allocations from an empty pool       */
+} pool_t;
+
+/**
+ * @brief Usage of one pool.
+ */
+typedef struct {
+    uint16_t u16_block_size;
+    uint16_t u16_blocks;
+    uint16_t u16_used;
+    uint16_t u16_high_water;
+    uint32_t u32_failures;
+} pool_stats_t;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Builds the free list over the storage.
+ *
+ * @param pool           Pool
+ * @param storage        u16_blocks * u16_block_size bytes, word aligned
+ * @param u16_block_size Bytes per block, multiple of 4
+ * @param u16_blocks     Number of blocks (> 0)
+ * @return HAL_OK, HAL_ERROR for invalid sizes
+ */
+HAL_StatusTypeDef pool_init(pool_t *pool, void *storage, uint16_t u16_block_size, uint16_t u16_blocks);
+
+/**
+ * @brief Takes a block.
+ *
+ * @param pool Pool
+ * @return Block, NULL if the pool is empty (counted)
+ */
+void *pool_alloc(pool_t *pool);
+
+/**
+ * @brief Returns a block to its pool.
+ *
+ * @param pool  Pool the block came from
+ * @param block Block, NULL is ignored
+ * @return None
+ */
+void pool_free(pool_t *pool, void *block);
+
+/**
+ * @brief Copies the usage of a pool.
+ *
+ * @param pool  Pool
+ * @param stats Destination
+ * @return None
+ */
+void pool_get_stats(const pool_t *pool, pool_stats_t *stats);
+
+/**
+ * @brief Takes a block of at least u16_size bytes from the shared pools.
+ *
+ * Only the smallest class that fits is tried, so small users cannot
+ * drain the large blocks.
+ *
+ * @param u16_size Bytes needed
+ * @return Block, NULL if the class is empty or no class is large enough
+ */
+void *pool_shared_alloc(uint16_t u16_size);
+
+/**
+ * @brief Returns a block of pool_shared_alloc().
+ *
+ * @param block Block, NULL is ignored
+ * @return None
+ */
+void pool_shared_free(void *block);
+
+/**
+ * @brief Copies the usage of a shared pool.
+ *
+ * @param pool_class Class
+ * @param stats      Destination
+ * @return None
+ */
+void pool_shared_get_stats(pool_class_t pool_class, pool_stats_t *stats);
+
+#endif /* POOL_POOL_H_ */
@@ -9,7 +9,8 @@
 ==================================================
 				### Resources used ###
 	GPIO:  PA6 (ADC1_), PA7 (TB_ADC2)
-	ADC:   ADC1 (2 channels: CH6, CH7)
+	ADC:   ADC1 (2 channels: CH6, CH7), EOC interrupt (ADC_IRQn,
+	       dispatched by adc_irq)
 ==================================================
 					### Usage ###
 	(#) Call 'potis_init()' once during system initialization to:
@@ -19,6 +20,12 @@
 
 	(#) Use 'potis_get_val(POTI_1)' or 'potis_get_val(POTI_2)'
     	to read the raw ADC value of the respective potentiometer.
+
+	(#) Conversions run in the background: every EOC interrupt stores
+	    one channel, the end of the sequence publishes both values.
+	    The getters return the last completed scan and start the next
+	    one, so they never wait for the ADC. 'potis_get_all()' returns
+	    both values of the same scan.
 ==================================================
 @endverbatim
 **************************************************
@@ -27,6 +34,10 @@
 /* Includes */
 
 #include "potis.h"
+#include "adc_cal/adc_cal.h"
+#include "adc_irq/adc_irq.h"
+#include "clock/clock.h"
+#include "ll/ll.h"
 
 /* Preprocessor defines */
 
@@ -37,9 +48,34 @@
 /* Static module variables */
 
 /**
- * @brief Global ADC handle structure used for ADC1 configuration and operation.
+ * @brief ADC handle structure used for ADC1 configuration and operation.
+ */
+static ADC_HandleTypeDef g_potis_adc_handle_struct;
+
+/**
+ * @brief Values of the scan that is currently converted.
+ */
+static uint32_t g_u32_potis_scan[POTIS_CHANNEL_COUNT] = {0};
+
+/**
+ * @brief Values of the last completed scan.
+ */
+static volatile uint32_t g_u32_potis_values[POTIS_CHANNEL_COUNT] = {0};
+
+/**
+ * @brief Rank of the next conversion within the running scan.
  */
-ADC_HandleTypeDef ADC_handle_structure;
+static volatile uint8_t g_u8_potis_rank = 0;
+
+/**
+ * @brief Set while a scan is running.
+ */
+static volatile uint8_t g_u8_potis_busy = 0;
+
+/**
+ * @brief Completed scans, odd while the published values are updated.
+ */
+static volatile uint32_t g_u32_potis_sequence = 0;
 
 /* Static module functions (prototypes) */
 
@@ -51,6 +87,13 @@ ADC_HandleTypeDef ADC_handle_structure;
  */
 void potis_init_gpio(void);
 
+/**
+ * @brief  ADC interrupt (adc_irq client): one stored conversion per EOC.
+ * @param  context  Unused
+ * @return None
+ */
+static void potis_adc_irq(void *context);
+
 /* Public functions */
 
 /**
@@ -70,17 +113,17 @@ void potis_init(void)
     __HAL_RCC_ADC1_CLK_ENABLE();
 
     /* Configure ADC instance */
-    ADC_handle_structure.Instance = ADC1;
-    ADC_handle_structure.Init.ClockPrescaler = ADC_CLOCK_SYNC_PCLK_DIV4;
-    ADC_handle_structure.Init.Resolution = ADC_RESOLUTION_12B;
-    ADC_handle_structure.Init.DataAlign = ADC_DATAALIGN_RIGHT;
-    ADC_handle_structure.Init.ScanConvMode = ENABLE;
-    ADC_handle_structure.Init.EOCSelection = ADC_EOC_SINGLE_CONV;
-    ADC_handle_structure.Init.ContinuousConvMode = DISABLE;
-    ADC_handle_structure.Init.NbrOfConversion = 2;
-    ADC_handle_structure.Init.ExternalTrigConv = ADC_SOFTWARE_START;
-
-    HAL_ADC_Init(&ADC_handle_structure);
+    g_potis_adc_handle_struct.Instance = ADC1;
+    g_potis_adc_handle_struct.Init.ClockPrescaler = clock_plan_adc();
+    g_potis_adc_handle_struct.Init.Resolution = ADC_RESOLUTION_12B;
+    g_potis_adc_handle_struct.Init.DataAlign = ADC_DATAALIGN_RIGHT;
+    g_potis_adc_handle_struct.Init.ScanConvMode = ENABLE;
+    g_potis_adc_handle_struct.Init.EOCSelection = ADC_EOC_SINGLE_CONV;
+    g_potis_adc_handle_struct.Init.ContinuousConvMode = DISABLE;
+    g_potis_adc_handle_struct.Init.NbrOfConversion = 2;
+    g_potis_adc_handle_struct.Init.ExternalTrigConv = ADC_SOFTWARE_START;
+
+    HAL_ADC_Init(&g_potis_adc_handle_struct);
 
     /* Channel configuration */
     ADC_ChannelConfTypeDef ADC_channel_structure;
@@ -89,55 +132,112 @@ void potis_init(void)
     ADC_channel_structure.Channel = ADC_CHANNEL_6;
     ADC_channel_structure.Rank = 1;
     ADC_channel_structure.SamplingTime = ADC_SAMPLETIME_84CYCLES;
-    HAL_ADC_ConfigChannel(&ADC_handle_structure, &ADC_channel_structure);
+    HAL_ADC_ConfigChannel(&g_potis_adc_handle_struct, &ADC_channel_structure);
 
     /* Configure channel 7 (POTI_2) */
     ADC_channel_structure.Channel = ADC_CHANNEL_7;
     ADC_channel_structure.Rank = 2;
     ADC_channel_structure.SamplingTime = ADC_SAMPLETIME_84CYCLES;
-    HAL_ADC_ConfigChannel(&ADC_handle_structure, &ADC_channel_structure);
+    HAL_ADC_ConfigChannel(&g_potis_adc_handle_struct, &ADC_channel_structure);
+
+    /* End of conversion interrupt, one interrupt per channel */
+    adc_irq_set_handler(ADC_IRQ_CLIENT_POTIS, potis_adc_irq, NULL);
+    adc_irq_enable(POTIS_IRQ_PRIORITY);
+
+    /* Real VDDA for the millivolt conversion (injected conversion) */
+    adc_cal_measure_vdda(ADC1);
+
+    /* First scan, so values are available right after start-up */
+    potis_start_scan();
 }
 
 /**
- * @brief  Reads the raw ADC value of the selected potentiometer.
- *         Starts a conversion sequence for both channels and returns
- *         either the first or second conversion result.
+ * @brief  Returns the raw ADC value of the selected potentiometer from the
+ *         last completed scan and starts the next scan.
  * @param  poti_num  Potentiometer identifier:
- *                   - POTI_1 : read value from channel 6
- *                   - POTI_2 : read value from channel 7
+ *                   - POTI_1 : value from channel 6
+ *                   - POTI_2 : value from channel 7
  * @return uint32_t  Raw ADC value of the requested potentiometer.
- *         Returns 0 if poti_num is invalid (>2) or on timeout.
+ *         Returns 0 if poti_num is invalid.
  */
 uint32_t potis_get_val(uint8_t poti_num)
 {
-    if (poti_num > 2) {
+    if ((poti_num < POTI_1) || (poti_num > POTI_2)) {
         return 0;
     }
 
-    HAL_StatusTypeDef adc_conv_status;
-    uint32_t u32_poti1_value = 0;
-    uint32_t u32_poti2_value = 0;
+    uint32_t u32_value = g_u32_potis_values[poti_num - POTI_1];
 
-    /* Start ADC conversion */
-    HAL_ADC_Start(&ADC_handle_structure);
+    potis_start_scan();
 
-    /* Read first conversion (POTI_1) */
-    adc_conv_status = HAL_ADC_PollForConversion(&ADC_handle_structure, ADC_POLL_TIMEOUT_MS);
-    if (adc_conv_status != HAL_TIMEOUT) {
-        u32_poti1_value = HAL_ADC_GetValue(&ADC_handle_structure);
-    }
+    return u32_value;
+}
+
+/**
+ * @brief  Copies both values of the last completed scan (lock-free, retried
+ *         via the sequence counter) and starts the next scan.
+ * @param  values  Output array, values[0] = POTI_1, values[1] = POTI_2
+ * @return None
+ */
+void potis_get_all(uint32_t values[POTIS_CHANNEL_COUNT])
+{
+    uint32_t u32_sequence;
+
+    do {
+        u32_sequence = g_u32_potis_sequence;
+        __DMB();
+        for (uint8_t i = 0; i < POTIS_CHANNEL_COUNT; i++) {
+            values[i] = g_u32_potis_values[i];
+        }
+        __DMB();
+    } while ((u32_sequence & 1u) || (u32_sequence != g_u32_potis_sequence));
 
-    /* Read second conversion (POTI_2) */
-    adc_conv_status = HAL_ADC_PollForConversion(&ADC_handle_structure, ADC_POLL_TIMEOUT_MS);
-    if (adc_conv_status != HAL_TIMEOUT) {
-        u32_poti2_value = HAL_ADC_GetValue(&ADC_handle_structure);
+    potis_start_scan();
+}
+
+/**
+ * @brief  Starts a conversion of the whole sequence unless one is running.
+ * @param  None
+ * @return None
+ */
+void potis_start_scan(void)
+{
+    if (g_u8_potis_busy) {
+        return;
     }
 
-    /* Stop ADC conversion */
-    HAL_ADC_Stop(&ADC_handle_structure);
+    g_u8_potis_rank = 0;
+    g_u8_potis_busy = 1;
+
+    /* Clear stale flags, EOC and overrun interrupts, software start */
+    ADC1->SR = ~(uint32_t)(ADC_SR_EOC | ADC_SR_OVR);
+    ADC1->CR1 |= ADC_CR1_EOCIE | ADC_CR1_OVRIE;
+    ADC1->CR2 |= ADC_CR2_ADON;
+    ADC1->CR2 |= ADC_CR2_SWSTART;
+}
+
+/**
+ * @brief  Returns the number of completed scans.
+ * @param  None
+ * @return uint32_t  Scan counter.
+ */
+uint32_t potis_get_scan_count(void)
+{
+    return g_u32_potis_sequence / 2u;
+}
+
+/**
+ * @brief  Returns the calibrated voltage of the selected potentiometer.
+ * @param  poti_num  POTI_1 or POTI_2
+ * @return uint32_t  Millivolts, 0 if poti_num is invalid.
+ */
+uint32_t potis_get_mv(uint8_t poti_num)
+{
+    if ((poti_num < POTI_1) || (poti_num > POTI_2)) {
+        return 0;
+    }
 
-    /* Return value depending on selected potentiometer */
-    return (poti_num == POTI_1) ? u32_poti1_value : u32_poti2_value;
+    return adc_cal_to_mv(poti_num - POTI_1, potis_get_val(poti_num));
 }
 
 /* Static module functions (implementation) */
@@ -161,3 +261,49 @@ void potis_init_gpio(void)
 
     HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
 }
+
+/**
+ * @brief  ADC interrupt: stores one conversion per EOC and publishes the
+ *         values at the end of the sequence. Reading DR clears EOC.
+ * @param  context  Unused
+ * @return None
+ */
+static void potis_adc_irq(void *context)
+{
+    uint32_t u32_status = ADC1->SR;
+
+    (void)context;
+
+    /* DMA stream: EOC and OVR belong to potis_dma */
+    if ((ADC1->CR1 & ADC_CR1_EOCIE) == 0u) {
+        return;
+    }
+
+    if (u32_status & ADC_SR_OVR) {
+        /* Sequence lost, drop it; the next getter starts a new one */
+        ADC1->SR = ~(uint32_t)(ADC_SR_OVR | ADC_SR_EOC);
+        (void)LL_ADC_READ(ADC1);
+        g_u8_potis_busy = 0;
+        return;
+    }
+
+    if ((u32_status & ADC_SR_EOC) == 0u) {
+        return;
+    }
+
+    g_u32_potis_scan[g_u8_potis_rank] = LL_ADC_READ(ADC1);
+
+    if (++g_u8_potis_rank < POTIS_CHANNEL_COUNT) {
+        return;
+    }
+
+    g_u32_potis_sequence++;
+    __DMB();
+    for (uint8_t i = 0; i < POTIS_CHANNEL_COUNT; i++) {
+        g_u32_potis_values[i] = g_u32_potis_scan[i];
+    }
+    __DMB();
+    g_u32_potis_sequence++;
+
+    g_u8_potis_busy = 0;
+}
@@ -13,6 +13,7 @@
 
 /* Includes */
 #include "stm32f4xx.h"
+#include "irq/irq.h"
 
 /* Public Preprocessor defines */
 /**
@@ -50,6 +51,16 @@
  */
 #define ADC_POLL_TIMEOUT_MS 1000
 
+/**
+ * @brief Number of channels converted in one scan sequence.
+ */
+#define POTIS_CHANNEL_COUNT 2
+
+/**
+ * @brief NVIC preemption priority of the ADC end-of-conversion interrupt.
+ */
+#define POTIS_IRQ_PRIORITY IRQ_CLASS_TRANSFER
+
 /* Public Preprocessor macros */
 
 /* Public type definitions */
@@ -65,13 +76,47 @@
 void potis_init(void);
 
 /**
- * @brief  Reads the current raw ADC value of the selected potentiometer.
+ * @brief  Returns the raw ADC value of the selected potentiometer from the
+ *         last completed scan and starts a new scan if none is running.
+ *         Does not wait for the ADC.
  * @param  poti_num  Identifier of the potentiometer:
  *                   - POTI_1 for potentiometer 1
  *                   - POTI_2 for potentiometer 2
  * @return uint32_t  Raw ADC conversion value (0..ADC_12_BIT_RESOLUTION).
- *         Returns 0 if an invalid potentiometer number is passed.
+ *         Returns 0 if an invalid potentiometer number is passed or
+ *         before the first scan has completed.
  */
 uint32_t potis_get_val(uint8_t poti_num);
 
+/**
+ * @brief  Returns the raw values of both potentiometers from the same scan
+ *         sequence and starts a new scan if none is running.
+ * @param  values  Output array, values[0] = POTI_1, values[1] = POTI_2
+ * @return None
+ */
+void potis_get_all(uint32_t values[POTIS_CHANNEL_COUNT]);
+
+/**
+ * @brief  Starts a scan of both channels in the background. Does nothing
+ *         while a scan is already running.
+ * @param  None
+ * @return None
+ */
+void potis_start_scan(void);
+
+/**
+ * @brief  Returns a counter that is incremented after every completed scan.
+ * @param  None
+ * @return uint32_t  Number of completed scans.
+ */
+uint32_t potis_get_scan_count(void);
+
+/**
+ * @brief  Returns the calibrated voltage of the selected potentiometer
+ *         (VDDA measured via VREFINT in 'potis_init()', see adc_cal).
+ * @param  poti_num  POTI_1 or POTI_2
+ * @return uint32_t  Millivolts, 0 if poti_num is invalid.
+ */
+uint32_t potis_get_mv(uint8_t poti_num);
+
 #endif /* POTIS_POTIS_H_ */
@@ -11,13 +11,19 @@
 	GPIO:  PA6 (POTENTIOMETER1_GPIO_PIN, ADC1_IN6)
        	   PA7 (POTENTIOMETER2_GPIO_PIN, ADC1_IN7)
 	ADC:   ADC1 (2 channels: CH6, CH7)
-	DMA:   DMA2 Stream0 Channel 0 (ADC1)
+	DMA:   ADC1 request of dma_alloc (DMA2 Stream0 Channel 0 unless taken),
+	       interrupt dispatched by dma_alloc
+	TIM:   TIM8 TRGO (POTIS_DMA_MODE_TIMER only)
+	       (POTIS_DMA_MODE_BURST: no timer, ADC1 powered per burst only)
+	       optional injected trigger of another module (TIMx_CC4, ...)
+	IRQ:   ADC_IRQn for the analog watchdog (potis_dma_watchdog_start()
+	       only, dispatched by adc_irq)
 ==================================================
 				### Usage ###
 	(#) Call 'potis_dma_init()' once during system initialization to:
     	- Enable GPIOA, ADC1 and DMA2 clocks
     	- Configure PA6 and PA7 as analog inputs
-    	- Configure DMA2 Stream0 Channel 0 for ADC1
+    	- Claim the ADC1 DMA stream and configure it
     	- Set up ADC1 for continuous, scan-mode, 2-channel conversion
 
 	(#) Call 'potis_dma_start()' to start ADC1 with DMA transfers.
@@ -25,8 +31,8 @@
 	(#) To access the potentiometer values you have two options:
     	1) Simple access:
        	   - Call 'potis_dma_get_val(POTI_1)' or 'potis_dma_get_val(POTI_2)'
-       	   - The function internally filters the DMA buffer and returns
-         the averaged value of the selected potentiometer.
+       	   - The function returns the averaged value of the selected
+         potentiometer from its running sum.
 
     	2) Manual filtering in the application:
        	   - Periodically call 'potis_dma_filter_data()' in your main loop
@@ -34,6 +40,28 @@
        	   - Then read the filtered values directly from:
            	   g_u32_potis_filtered_data[POTI_1]
            	   g_u32_potis_filtered_data[POTI_2]
+
+	(#) Both modes keep a running sum per potentiometer that is updated
+	    from the DMA half/full transfer interrupt with the sum of the half
+	    that was just completed. Reading a value is O(1); a sequence
+	    counter makes 'potis_dma_get_all()' return a consistent pair.
+
+	(#) For a fixed sample rate call 'potis_dma_init_mode(POTIS_DMA_MODE_TIMER,
+	    rate)' instead of 'potis_dma_init()'. The filtered values are then
+	    updated from the DMA interrupt on every half buffer.
+
+	(#) For slowly changing inputs 'potis_dma_init_mode(POTIS_DMA_MODE_BURST,
+	    0)' keeps ADC1 powered down; every 'potis_dma_burst_trigger()'
+	    (e.g. a scheduler task at the acquisition interval) powers it up,
+	    fills the buffer once by DMA, publishes the result and powers it
+	    down again from the transfer complete interrupt.
+
+	(#) Instead of polling, 'potis_dma_set_change_callback(callback, hyst)'
+	    reports a channel only when its filtered value leaves the
+	    current hysteresis band (software window, works in both modes).
+
+	(#) Every half buffer publishes both averages as DATABUS_TOPIC_POTIS
+	    (modules/databus); consumers read the cached pair from there.
 ==================================================
 @endverbatim
 **************************************************
@@ -41,29 +69,64 @@
 
 /* Includes */
 #include "potis_dma.h"
+#include "potis_filter.h"
+#include "clock/clock.h"
+#include "datalog/datalog.h"
+#include "databus/databus.h"
+#include "dma_alloc/dma_alloc.h"
+#include "health/health.h"
+#include "adc_cal/adc_cal.h"
+#include "adc_irq/adc_irq.h"
+#include "osal/osal.h"
+#include "profile/profile.h"
+#include "trace/trace.h"
+#include "utils/utils.h"
+#include "tim_alloc/tim_alloc.h"
+
+#if (POTIS_DMA_IRQ_PRIORITY < OSAL_IRQ_PRIORITY_MIN)
+#error "POTIS_DMA_IRQ_PRIORITY must allow kernel calls (OSAL_IRQ_PRIORITY_MIN)"
+#endif
 
 /* Preprocessor defines */
+/**
+ * @brief TIM8 counter clock in POTIS_DMA_MODE_TIMER.
+ */
+#define POTIS_DMA_TIMER_CLOCK_HZ 1000000U
+
 /* Preprocessor macros */
 /* Module intern type definitions */
 
 /* Static module variables */
 /**
- * @brief DMA handle structure for DMA2 Stream0 Channel 0.
+ * @brief DMA handle structure of the ADC1 stream and its interrupt.
  */
-DMA_HandleTypeDef DMA_handle_structure;
+static DMA_HandleTypeDef g_potis_dma_dma_handle_struct;
+static IRQn_Type g_potis_dma_irqn = DMA2_Stream0_IRQn;
 
 /**
  * @brief ADC handle structure for ADC1.
  */
-ADC_HandleTypeDef ADC_handle_structure;
+static ADC_HandleTypeDef g_potis_dma_adc_handle_struct;
+
+/**
+ * @brief TIM8 handle, trigger source in POTIS_DMA_MODE_TIMER.
+ */
+static TIM_HandleTypeDef g_potis_dma_tim8_handle_struct;
 
 /**
- * @brief Raw DMA data buffer (interleaved samples of both potentiometers).
+ * @brief Active sampling mode.
+ */
+static potis_dma_mode_t g_potis_dma_mode = POTIS_DMA_MODE_CONTINUOUS;
+
+/**
+ * @brief Raw DMA data buffer (interleaved samples of both potentiometers),
+ *        halfword packed if POTIS_DMA_HALFWORD_SAMPLES is set.
  *
  *        Even indices  (0,2,4,...) belong to POTI_1.
  *        Odd indices   (1,3,5,...) belong to POTI_2.
  */
-uint32_t u32_potis_data[NON_FILTERED_DATA_ARRAY_LENGTH];
+/* 8 byte aligned so that no burst crosses a 1 KB boundary */
+__ALIGNED(8) potis_dma_sample_t g_potis_samples[NON_FILTERED_DATA_ARRAY_LENGTH];
 
 /**
  * @brief Filtered potentiometer values (averaged).
@@ -72,6 +135,96 @@ uint32_t u32_potis_data[NON_FILTERED_DATA_ARRAY_LENGTH];
  */
 uint32_t g_u32_potis_filtered_data[FILTERED_DATA_ARRAY_LENGTH];
 
+/**
+ * @brief Running sum over the whole DMA buffer per potentiometer.
+ */
+static volatile uint32_t g_u32_potis_sum[FILTERED_DATA_ARRAY_LENGTH];
+
+/**
+ * @brief Contribution of each buffer half to 'g_u32_potis_sum'.
+ */
+static uint32_t g_u32_potis_half_sum[2][FILTERED_DATA_ARRAY_LENGTH];
+
+/**
+ * @brief Sequence counter, odd while the running sums are being updated.
+ */
+static volatile uint32_t g_u32_potis_sequence = 0;
+
+/**
+ * @brief Set after every completed buffer half, wakes potis_dma_wait_block().
+ */
+static osal_event_t g_potis_block_event;
+
+/**
+ * @brief Decimation and FIR filter state, runs in the DMA interrupt.
+ *        In CCM RAM: no bus sharing with the ADC DMA writing the samples
+ *        (which must stay in normal SRAM).
+ */
+static potis_filter_t g_potis_filter UTILS_CCM_BSS;
+
+/**
+ * @brief IIR cascades per channel (NULL: none) and their last output in
+ *        ADC counts.
+ */
+static biquad_q31_t *volatile g_p_potis_biquad[FILTERED_DATA_ARRAY_LENGTH];
+static volatile uint32_t g_u32_potis_biquad[FILTERED_DATA_ARRAY_LENGTH];
+
+/**
+ * @brief FIR output per channel.
+ */
+static volatile uint32_t g_u32_potis_oversampled[FILTERED_DATA_ARRAY_LENGTH];
+
+/**
+ * @brief Change notification and its band half width.
+ */
+static volatile potis_dma_change_callback_t g_potis_dma_change_callback = NULL;
+static uint32_t g_u32_potis_hysteresis = POTIS_DMA_DEFAULT_HYSTERESIS;
+
+/**
+ * @brief Raw block notification.
+ */
+static volatile potis_dma_block_callback_t g_potis_dma_block_callback = NULL;
+
+/**
+ * @brief Analog watchdog notification and its context.
+ */
+static volatile potis_dma_watchdog_callback_t g_potis_dma_watchdog_callback = NULL;
+static void *g_p_potis_dma_watchdog_context = NULL;
+
+/**
+ * @brief Centre of the current band per channel, invalid until the first
+ *        evaluation after registering the callback.
+ */
+static uint32_t g_u32_potis_band[FILTERED_DATA_ARRAY_LENGTH];
+static uint8_t g_u8_potis_band_valid = 0;
+
+/**
+ * @brief Quantisers of the change notifications, used instead of the
+ *        bands while g_u8_potis_quantised is 1.
+ */
+static potis_dma_quant_t g_potis_quant[FILTERED_DATA_ARRAY_LENGTH];
+static uint8_t g_u8_potis_quantised = 0;
+
+/**
+ * @brief Buffer half that was completed last.
+ */
+static volatile uint8_t g_u8_potis_last_half = 0;
+
+/**
+ * @brief POTIS_DMA_MODE_BURST: 1 from the trigger to the end of the burst,
+ *        bursts completed.
+ */
+static volatile uint8_t g_u8_potis_burst_running = 0;
+static volatile uint32_t g_u32_potis_bursts = 0;
+
+#if DATALOG_ENABLE
+/**
+ * @brief Core cycles between two scans in POTIS_DMA_MODE_TIMER (0 in
+ *        continuous mode: all scans of a half get its completion time).
+ */
+static uint32_t g_u32_potis_scan_cycles = 0;
+#endif
+
 /* Static module functions (prototypes) */
 /**
  * @brief  Initializes GPIO pins for the ADC channels used by the potentiometers.
@@ -82,42 +235,120 @@ uint32_t g_u32_potis_filtered_data[FILTERED_DATA_ARRAY_LENGTH];
 void potis_gpio_init(void);
 
 /**
- * @brief  Initializes DMA2 Stream0 Channel 0 for ADC1.
+ * @brief  Claims and initializes the ADC1 DMA stream.
  * @param  None
  * @return None
  */
 void potis_dma_hardware_init(void);
 
+/**
+ * @brief  Configures TIM8 to output an update TRGO at the sample rate.
+ * @param  sample_rate_hz  Trigger rate
+ * @return None
+ */
+static void potis_dma_timer_init(uint32_t sample_rate_hz);
+
+/**
+ * @brief  Replaces the contribution of one buffer half in the running sums.
+ * @param  half     0 for the first, 1 for the second half
+ * @param  publish  0: sums and filters only (first half of a burst)
+ * @return None
+ */
+static void potis_dma_update_half(uint8_t half, uint8_t publish);
+
+/**
+ * @brief  Powers ADC1 down at the end of a burst.
+ * @param  None
+ * @return None
+ */
+static void potis_dma_burst_end(void);
+
+
+/**
+ * @brief  Raises the change callback for channels outside their band.
+ * @param  None
+ * @return None
+ */
+static void potis_dma_check_bands(void);
+
+/**
+ * @brief  Runs the decimation and FIR filter on one half buffer.
+ * @param  p_sample  First sample of the half
+ * @return None
+ */
+static void potis_dma_decimate_half(const potis_dma_sample_t* p_sample);
+
+/**
+ * @brief  Analog watchdog part of ADC_IRQn (adc_irq client). Clears the
+ *         flag and calls the callback.
+ * @param  context  Unused
+ * @return None
+ */
+static void potis_dma_watchdog_irq(void *context);
+
 /* Public functions */
 
 /**
  * @brief  Initializes potentiometer module hardware for ADC+DMA operation.
  *         - Configures GPIOA pins PA6/PA7 as analog inputs
- *         - Configures DMA2 Stream0 for ADC1
+ *         - Claims the ADC1 DMA stream (DMA2 Stream0) and configures it
  *         - Configures ADC1 for continuous scan conversion of 2 channels
  * @param  None
  * @return None
  */
 void potis_dma_init(void)
 {
+    potis_dma_init_mode(POTIS_DMA_MODE_CONTINUOUS, 0);
+}
+
+/**
+ * @brief  Initializes the module in the given sampling mode.
+ * @param  mode            POTIS_DMA_MODE_CONTINUOUS or POTIS_DMA_MODE_TIMER
+ * @param  sample_rate_hz  Scan rate in POTIS_DMA_MODE_TIMER
+ * @return None
+ */
+void potis_dma_init_mode(potis_dma_mode_t mode, uint32_t sample_rate_hz)
+{
+    g_potis_dma_mode = mode;
+
+    potis_filter_init(&g_potis_filter);
+
     potis_gpio_init();
     potis_dma_hardware_init();
 
     __HAL_RCC_ADC1_CLK_ENABLE();
 
-    ADC_handle_structure.Instance = ADC1;
-    ADC_handle_structure.DMA_Handle = &DMA_handle_structure;
-    ADC_handle_structure.Init.ClockPrescaler      = ADC_CLOCK_SYNC_PCLK_DIV4;
-    ADC_handle_structure.Init.Resolution          = ADC_RESOLUTION_12B;
-    ADC_handle_structure.Init.DataAlign           = ADC_DATAALIGN_RIGHT;
-    ADC_handle_structure.Init.ScanConvMode        = ENABLE;
-    ADC_handle_structure.Init.EOCSelection        = ADC_EOC_SEQ_CONV;
-    ADC_handle_structure.Init.ContinuousConvMode  = ENABLE;
-    ADC_handle_structure.Init.NbrOfConversion     = 2;
-    ADC_handle_structure.Init.ExternalTrigConv    = ADC_SOFTWARE_START;
-    ADC_handle_structure.Init.DMAContinuousRequests = ENABLE;
+    g_potis_dma_adc_handle_struct.Instance = ADC1;
+    g_potis_dma_adc_handle_struct.DMA_Handle = &g_potis_dma_dma_handle_struct;
+    g_potis_dma_adc_handle_struct.Init.ClockPrescaler      = clock_plan_adc();
+    g_potis_dma_adc_handle_struct.Init.Resolution          = ADC_RESOLUTION_12B;
+    g_potis_dma_adc_handle_struct.Init.DataAlign           = ADC_DATAALIGN_RIGHT;
+    g_potis_dma_adc_handle_struct.Init.ScanConvMode        = ENABLE;
+    g_potis_dma_adc_handle_struct.Init.EOCSelection        = ADC_EOC_SEQ_CONV;
+    g_potis_dma_adc_handle_struct.Init.ContinuousConvMode  = ENABLE;
+    g_potis_dma_adc_handle_struct.Init.NbrOfConversion     = 2;
+    g_potis_dma_adc_handle_struct.Init.ExternalTrigConv    = ADC_SOFTWARE_START;
+    g_potis_dma_adc_handle_struct.Init.DMAContinuousRequests = ENABLE;
 
-    HAL_ADC_Init(&ADC_handle_structure);
+    if (mode == POTIS_DMA_MODE_BURST) {
+        /* Scans back to back, no DMA request after the last transfer */
+        g_potis_dma_adc_handle_struct.Init.DMAContinuousRequests = DISABLE;
+    }
+
+    if (mode == POTIS_DMA_MODE_TIMER) {
+        /* One scan of both channels per TIM8 update */
+        g_potis_dma_adc_handle_struct.Init.ContinuousConvMode   = DISABLE;
+        g_potis_dma_adc_handle_struct.Init.ExternalTrigConv     = ADC_EXTERNALTRIGCONV_T8_TRGO;
+        g_potis_dma_adc_handle_struct.Init.ExternalTrigConvEdge = ADC_EXTERNALTRIGCONVEDGE_RISING;
+
+        potis_dma_timer_init(sample_rate_hz);
+    }
+
+    /* Half/full transfer interrupts feed the running sums */
+    HAL_NVIC_SetPriority(g_potis_dma_irqn, POTIS_DMA_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(g_potis_dma_irqn);
+
+    HAL_ADC_Init(&g_potis_dma_adc_handle_struct);
 
     /* Channel configuration */
     ADC_ChannelConfTypeDef ADC_channel_structure1;
@@ -126,13 +357,23 @@ void potis_dma_init(void)
     ADC_channel_structure1.Channel      = ADC_CHANNEL_6;
     ADC_channel_structure1.Rank         = 1;
     ADC_channel_structure1.SamplingTime = ADC_SAMPLETIME_84CYCLES;
-    HAL_ADC_ConfigChannel(&ADC_handle_structure, &ADC_channel_structure1);
+    HAL_ADC_ConfigChannel(&g_potis_dma_adc_handle_struct, &ADC_channel_structure1);
 
     /* Configure channel 7 (POTI_2) */
     ADC_channel_structure1.Channel      = ADC_CHANNEL_7;
     ADC_channel_structure1.Rank         = 2;
     ADC_channel_structure1.SamplingTime = ADC_SAMPLETIME_84CYCLES;
-    HAL_ADC_ConfigChannel(&ADC_handle_structure, &ADC_channel_structure1);
+    HAL_ADC_ConfigChannel(&g_potis_dma_adc_handle_struct, &ADC_channel_structure1);
+
+    /* Real VDDA for the millivolt conversion (injected, before DMA start) */
+    adc_cal_measure_vdda(ADC1);
+
+    g_u8_potis_burst_running = 0;
+    g_u32_potis_bursts = 0;
+    if (mode == POTIS_DMA_MODE_BURST) {
+        /* Powered up by every burst */
+        ADC1->CR2 &= ~(uint32_t)ADC_CR2_ADON;
+    }
 }
 
 /**
@@ -142,43 +383,74 @@ void potis_dma_init(void)
  */
 void potis_dma_start(void)
 {
-    HAL_ADC_Start_DMA(&ADC_handle_structure, u32_potis_data, NON_FILTERED_DATA_ARRAY_LENGTH);
+    if (g_potis_dma_mode == POTIS_DMA_MODE_BURST) {
+        (void)potis_dma_burst_trigger();
+        return;
+    }
+
+    /* Length is counted in DMA transfers, independent of the sample width */
+    HAL_ADC_Start_DMA(&g_potis_dma_adc_handle_struct, (uint32_t*)g_potis_samples, NON_FILTERED_DATA_ARRAY_LENGTH);
+
+    if (g_potis_dma_mode == POTIS_DMA_MODE_TIMER) {
+        HAL_TIM_Base_Start(&g_potis_dma_tim8_handle_struct);
+    }
 }
 
 /**
- * @brief  Filters the raw DMA data and stores averaged values per potentiometer.
- *
- *         Even indices of 'u32_potis_data' belong to POTI_1,
- *         odd indices belong to POTI_2. The function sums all values
- *         per potentiometer and divides by (NON_FILTERED_DATA_ARRAY_LENGTH / 2)
- *         to obtain the average.
- *
+ * @brief  Powers up ADC1 and converts one burst.
  * @param  None
- * @return None
+ * @return HAL_OK, HAL_BUSY while a burst runs, HAL_ERROR in another mode
+ *         or without a DMA stream
  */
-void potis_dma_filter_data(void)
+HAL_StatusTypeDef potis_dma_burst_trigger(void)
 {
-    g_u32_potis_filtered_data[POTI_1] = 0;
-    g_u32_potis_filtered_data[POTI_2] = 0;
+    if ((g_potis_dma_mode != POTIS_DMA_MODE_BURST) || (g_potis_dma_dma_handle_struct.Instance == NULL)) {
+        return HAL_ERROR;
+    }
+    if (g_u8_potis_burst_running) {
+        return HAL_BUSY;
+    }
 
-    for (int i = 0; i < NON_FILTERED_DATA_ARRAY_LENGTH; i++) {
-        if (i % 2 == 0) {
-            g_u32_potis_filtered_data[POTI_1] += u32_potis_data[i];
-        } else {
-            g_u32_potis_filtered_data[POTI_2] += u32_potis_data[i];
-        }
+    /* HAL_ADC_Start_DMA() sets ADON and waits the stabilisation time */
+    g_u8_potis_burst_running = 1;
+    if (HAL_ADC_Start_DMA(&g_potis_dma_adc_handle_struct, (uint32_t*)g_potis_samples,
+                          NON_FILTERED_DATA_ARRAY_LENGTH) != HAL_OK) {
+        potis_dma_burst_end();
+        return HAL_ERROR;
     }
 
-    g_u32_potis_filtered_data[POTI_1] /= (NON_FILTERED_DATA_ARRAY_LENGTH / 2);
-    g_u32_potis_filtered_data[POTI_2] /= (NON_FILTERED_DATA_ARRAY_LENGTH / 2);
+    return HAL_OK;
 }
 
 /**
- * @brief  Returns the filtered ADC value of the selected potentiometer.
+ * @brief  Returns the number of completed bursts.
+ * @param  None
+ * @return Bursts since potis_dma_init_mode()
+ */
+uint32_t potis_dma_burst_count(void)
+{
+    return g_u32_potis_bursts;
+}
+
+/**
+ * @brief  Stores the averaged values per potentiometer in
+ *         'g_u32_potis_filtered_data'.
  *
- *         Internally this function calls 'potis_dma_filter_data()'
- *         before returning the value from 'g_u32_potis_filtered_data'.
+ *         The averages are taken from the running sums, so the cost no
+ *         longer depends on NON_FILTERED_DATA_ARRAY_LENGTH.
  *
+ * @param  None
+ * @return None
+ */
+void potis_dma_filter_data(void)
+{
+    PROFILE_BEGIN(PROFILE_ZONE_POTIS_FILTER);
+    potis_dma_get_all(g_u32_potis_filtered_data);
+    PROFILE_END(PROFILE_ZONE_POTIS_FILTER);
+}
+
+/**
+ * @brief  Returns the filtered ADC value of the selected potentiometer.
  * @param  poti_num  Potentiometer index:
  *                   - POTI_1 : potentiometer 1
  *                   - POTI_2 : potentiometer 2
@@ -187,13 +459,395 @@ void potis_dma_filter_data(void)
  */
 uint32_t potis_dma_get_val(uint8_t poti_num)
 {
-    if (poti_num >= 2) {
+    if (poti_num >= FILTERED_DATA_ARRAY_LENGTH) {
         return 0;
     }
 
-    potis_dma_filter_data();
+    /* A single aligned word, always consistent */
+    return g_u32_potis_sum[poti_num] / (NON_FILTERED_DATA_ARRAY_LENGTH / 2);
+}
+
+/**
+ * @brief  Returns the filtered values of all potentiometers from the
+ *         same buffer update.
+ * @param  values  Output array, index with POTI_1 and POTI_2
+ * @return None
+ */
+void potis_dma_get_all(uint32_t values[FILTERED_DATA_ARRAY_LENGTH])
+{
+    uint32_t u32_sequence;
+
+    do {
+        u32_sequence = g_u32_potis_sequence;
+        __DMB();
+        for (uint8_t i = 0; i < FILTERED_DATA_ARRAY_LENGTH; i++) {
+            values[i] = g_u32_potis_sum[i] / (NON_FILTERED_DATA_ARRAY_LENGTH / 2);
+        }
+        __DMB();
+    } while ((u32_sequence & 1u) || (u32_sequence != g_u32_potis_sequence));
+}
+
+/**
+ * @brief  Returns the oversampled and FIR filtered value of a potentiometer.
+ * @param  poti_num  POTI_1 or POTI_2
+ * @return uint32_t  0 .. POTIS_DMA_OVERSAMPLED_MAX, 0 if poti_num is invalid.
+ */
+uint32_t potis_dma_get_oversampled(uint8_t poti_num)
+{
+    if (poti_num >= FILTERED_DATA_ARRAY_LENGTH) {
+        return 0;
+    }
 
-    return g_u32_potis_filtered_data[poti_num];
+    return g_u32_potis_oversampled[poti_num];
+}
+
+/**
+ * @brief  Replaces the FIR coefficients.
+ * @param  coefficients  POTIS_DMA_FIR_TAPS signed coefficients
+ * @param  shift         Right shift applied to the sum
+ * @return None
+ */
+void potis_dma_set_fir(const int16_t coefficients[POTIS_DMA_FIR_TAPS], uint8_t shift)
+{
+    /* The filter runs in the DMA interrupt */
+    HAL_NVIC_DisableIRQ(g_potis_dma_irqn);
+    potis_filter_set_fir(&g_potis_filter, coefficients, shift);
+    HAL_NVIC_EnableIRQ(g_potis_dma_irqn);
+}
+
+/**
+ * @brief  Returns the calibrated voltage of a potentiometer.
+ * @param  poti_num  POTI_1 or POTI_2
+ * @return uint32_t  Millivolts, 0 if poti_num is invalid.
+ */
+uint32_t potis_dma_get_mv(uint8_t poti_num)
+{
+    if (poti_num >= FILTERED_DATA_ARRAY_LENGTH) {
+        return 0;
+    }
+
+    return adc_cal_to_mv(poti_num, potis_dma_get_val(poti_num));
+}
+
+/**
+ * @brief  Converts the last completed buffer half of one potentiometer.
+ *         The half is stable until the DMA wraps around to it again.
+ * @param  poti_num  POTI_1 or POTI_2
+ * @param  mv        Output, NON_FILTERED_DATA_ARRAY_LENGTH / 4 values
+ * @return None
+ */
+void potis_dma_get_block_mv(uint8_t poti_num, uint16_t mv[NON_FILTERED_DATA_ARRAY_LENGTH / 4])
+{
+#if POTIS_DMA_HALFWORD_SAMPLES
+    if (poti_num >= FILTERED_DATA_ARRAY_LENGTH) {
+        return;
+    }
+
+    adc_cal_to_mv_block(poti_num,
+                        &g_potis_samples[g_u8_potis_last_half * (NON_FILTERED_DATA_ARRAY_LENGTH / 2) + poti_num],
+                        FILTERED_DATA_ARRAY_LENGTH, mv, POTIS_DMA_SCANS_PER_HALF);
+#else
+    const potis_dma_sample_t* p_sample;
+
+    if (poti_num >= FILTERED_DATA_ARRAY_LENGTH) {
+        return;
+    }
+
+    p_sample = &g_potis_samples[g_u8_potis_last_half * (NON_FILTERED_DATA_ARRAY_LENGTH / 2) + poti_num];
+    for (uint32_t i = 0; i < POTIS_DMA_SCANS_PER_HALF; i++) {
+        mv[i] = (uint16_t)adc_cal_to_mv(poti_num, p_sample[i * FILTERED_DATA_ARRAY_LENGTH]);
+    }
+#endif
+}
+
+/**
+ * @brief  Computes the block statistics of one potentiometer.
+ * @param  poti_num  POTI_1 or POTI_2
+ * @param  stats     Output
+ * @return HAL_OK, HAL_ERROR if poti_num is invalid
+ */
+HAL_StatusTypeDef potis_dma_get_noise(uint8_t poti_num, stats_welford_t *stats)
+{
+    uint16_t u16_mv[NON_FILTERED_DATA_ARRAY_LENGTH / 4];
+
+    if (poti_num >= FILTERED_DATA_ARRAY_LENGTH) {
+        return HAL_ERROR;
+    }
+
+    potis_dma_get_block_mv(poti_num, u16_mv);
+    stats_welford_reset(stats);
+    for (uint32_t i = 0; i < POTIS_DMA_SCANS_PER_HALF; i++) {
+        stats_welford_add(stats, (float)u16_mv[i]);
+    }
+
+    return HAL_OK;
+}
+
+/**
+ * @brief  Attaches an IIR cascade to one potentiometer.
+ * @param  poti_num  POTI_1 or POTI_2
+ * @param  filter    Cascade, NULL detaches
+ * @return None
+ */
+void potis_dma_set_biquad(uint8_t poti_num, biquad_q31_t *filter)
+{
+    if (poti_num >= FILTERED_DATA_ARRAY_LENGTH) {
+        return;
+    }
+
+    /* The cascade runs in the DMA interrupt */
+    HAL_NVIC_DisableIRQ(g_potis_dma_irqn);
+    if (filter != NULL) {
+        uint32_t u32_value = potis_dma_get_val(poti_num);
+
+        biquad_q31_settle(filter, (int32_t)(u32_value << POTIS_DMA_BIQUAD_SHIFT));
+        g_u32_potis_biquad[poti_num] = u32_value;
+    } else {
+        g_u32_potis_biquad[poti_num] = 0;
+    }
+    g_p_potis_biquad[poti_num] = filter;
+    HAL_NVIC_EnableIRQ(g_potis_dma_irqn);
+}
+
+/**
+ * @brief  Returns the IIR output of a potentiometer.
+ * @param  poti_num  POTI_1 or POTI_2
+ * @return uint32_t  0 .. 4095, 0 without filter or if poti_num is invalid.
+ */
+uint32_t potis_dma_get_biquad(uint8_t poti_num)
+{
+    if (poti_num >= FILTERED_DATA_ARRAY_LENGTH) {
+        return 0;
+    }
+
+    return g_u32_potis_biquad[poti_num];
+}
+
+/**
+ * @brief  Registers the change callback and its hysteresis.
+ * @param  callback    Function to call, NULL disables the notification
+ * @param  hysteresis  Band half width, 0 selects the default
+ * @return None
+ */
+void potis_dma_set_change_callback(potis_dma_change_callback_t callback, uint32_t hysteresis)
+{
+    /* The bands are evaluated in the DMA interrupt */
+    HAL_NVIC_DisableIRQ(g_potis_dma_irqn);
+    g_potis_dma_change_callback = callback;
+    g_u32_potis_hysteresis      = (hysteresis == 0) ? POTIS_DMA_DEFAULT_HYSTERESIS : hysteresis;
+    g_u8_potis_band_valid       = 0;
+    for (uint8_t i = 0; i < FILTERED_DATA_ARRAY_LENGTH; i++) {
+        g_potis_quant[i].u8_valid = 0;
+    }
+    HAL_NVIC_EnableIRQ(g_potis_dma_irqn);
+}
+
+/**
+ * @brief  Switches the change notifications to quantised values.
+ * @param  step        Level distance, 0 returns to the band
+ * @param  hysteresis  Extra dead-band beyond half a step
+ * @return None
+ */
+void potis_dma_set_quantiser(uint32_t step, uint32_t hysteresis)
+{
+    HAL_NVIC_DisableIRQ(g_potis_dma_irqn);
+    for (uint8_t i = 0; i < FILTERED_DATA_ARRAY_LENGTH; i++) {
+        potis_dma_quant_init(&g_potis_quant[i], step, hysteresis);
+    }
+    g_u8_potis_quantised  = (step != 0) ? 1 : 0;
+    g_u8_potis_band_valid = 0;
+    HAL_NVIC_EnableIRQ(g_potis_dma_irqn);
+}
+
+/**
+ * @brief  Starts a quantiser.
+ * @param  quant       Instance
+ * @param  step        Level distance, 0 selects the default
+ * @param  hysteresis  Extra dead-band beyond half a step
+ * @return None
+ */
+void potis_dma_quant_init(potis_dma_quant_t *quant, uint32_t step, uint32_t hysteresis)
+{
+    quant->u32_step       = (step == 0) ? POTIS_DMA_QUANT_DEFAULT_STEP : step;
+    quant->u32_hysteresis = hysteresis;
+    quant->u32_level      = 0;
+    quant->u8_valid       = 0;
+}
+
+/**
+ * @brief  Feeds one value into a quantiser.
+ * @param  quant   Instance
+ * @param  value   Input
+ * @param  output  Quantised value, written only on a change
+ * @return 1 if the level changed, else 0
+ */
+uint8_t potis_dma_quant_update(potis_dma_quant_t *quant, uint32_t value, uint32_t *output)
+{
+    uint32_t u32_centre = quant->u32_level * quant->u32_step;
+    uint32_t u32_reach  = quant->u32_step / 2 + quant->u32_hysteresis;
+    uint32_t u32_quantised;
+
+    /* Inside the dead-band of the current level: no change */
+    if (quant->u8_valid &&
+        (value <= u32_centre + u32_reach) &&
+        ((u32_centre < u32_reach) || (value >= u32_centre - u32_reach))) {
+        return 0;
+    }
+
+    quant->u32_level = (value + quant->u32_step / 2) / quant->u32_step;
+    quant->u8_valid  = 1;
+
+    u32_quantised = quant->u32_level * quant->u32_step;
+    *output = (u32_quantised > ADC_12_BIT_RESOLUTION) ? ADC_12_BIT_RESOLUTION : u32_quantised;
+
+    return 1;
+}
+
+/**
+ * @brief  Registers the raw block notification.
+ * @param  callback  Function to call, NULL disables the notification
+ * @return None
+ */
+void potis_dma_set_block_callback(potis_dma_block_callback_t callback)
+{
+    HAL_NVIC_DisableIRQ(g_potis_dma_irqn);
+    g_potis_dma_block_callback = callback;
+    HAL_NVIC_EnableIRQ(g_potis_dma_irqn);
+}
+
+HAL_StatusTypeDef potis_dma_wait_block(uint32_t u32_timeout_ms)
+{
+    /* Only halves completed after the call count */
+    osal_event_clear(&g_potis_block_event);
+
+    return osal_event_wait(&g_potis_block_event, u32_timeout_ms);
+}
+
+HAL_StatusTypeDef potis_dma_injected_start(uint32_t u32_channel, uint32_t u32_trigger)
+{
+    uint32_t u32_jsqr = (uint32_t)(POTIS_DMA_INJECTED_RANKS - 1) << ADC_JSQR_JL_Pos;
+
+    if (((ADC1->CR2 & ADC_CR2_ADON) == 0u) || (u32_channel > ADC_CHANNEL_18)) {
+        return HAL_ERROR;
+    }
+
+    potis_dma_injected_stop();
+
+    for (uint32_t i = 0; i < POTIS_DMA_INJECTED_RANKS; i++) {
+        u32_jsqr |= u32_channel << (i * ADC_JSQR_JSQ2_Pos);
+    }
+
+    /* Same sampling time as the potentiometers */
+    if (u32_channel >= ADC_CHANNEL_10) {
+        MODIFY_REG(ADC1->SMPR1, 7u << ((u32_channel - 10u) * 3u),
+                   ADC_SAMPLETIME_84CYCLES << ((u32_channel - 10u) * 3u));
+    } else {
+        MODIFY_REG(ADC1->SMPR2, 7u << (u32_channel * 3u), ADC_SAMPLETIME_84CYCLES << (u32_channel * 3u));
+    }
+
+    ADC1->JSQR = u32_jsqr;
+    ADC1->JOFR1 = 0u;
+    ADC1->JOFR2 = 0u;
+    ADC1->JOFR3 = 0u;
+    ADC1->JOFR4 = 0u;
+    ADC1->CR1 |= ADC_CR1_JDISCEN;
+
+    if (u32_trigger != ADC_INJECTED_SOFTWARE_START) {
+        MODIFY_REG(ADC1->CR2, ADC_CR2_JEXTSEL | ADC_CR2_JEXTEN,
+                   u32_trigger | ADC_EXTERNALTRIGINJECCONVEDGE_RISING);
+    }
+
+    return HAL_OK;
+}
+
+void potis_dma_injected_trigger(void)
+{
+    ADC1->CR2 |= ADC_CR2_JSWSTART;
+}
+
+uint32_t potis_dma_injected_get_mean(void)
+{
+    return (ADC1->JDR1 + ADC1->JDR2 + ADC1->JDR3 + ADC1->JDR4 + POTIS_DMA_INJECTED_RANKS / 2) /
+           POTIS_DMA_INJECTED_RANKS;
+}
+
+void potis_dma_injected_stop(void)
+{
+    ADC1->CR2 &= ~(uint32_t)(ADC_CR2_JEXTEN | ADC_CR2_JEXTSEL);
+    ADC1->CR1 &= ~(uint32_t)ADC_CR1_JDISCEN;
+    ADC1->SR   = ~(uint32_t)(ADC_SR_JEOC | ADC_SR_JSTRT);
+}
+
+HAL_StatusTypeDef potis_dma_watchdog_start(uint32_t u32_channel, uint16_t u16_low, uint16_t u16_high,
+                                           potis_dma_watchdog_callback_t callback, void *context)
+{
+    if (((ADC1->CR2 & ADC_CR2_ADON) == 0u) || (u32_channel > ADC_CHANNEL_18) ||
+        (u16_low > u16_high) || (u16_high > ADC_12_BIT_RESOLUTION) || (callback == NULL)) {
+        return HAL_ERROR;
+    }
+
+    potis_dma_watchdog_stop();
+
+    g_p_potis_dma_watchdog_context = context;
+    g_potis_dma_watchdog_callback  = callback;
+    ADC1->LTR = u16_low;
+    ADC1->HTR = u16_high;
+    MODIFY_REG(ADC1->CR1, ADC_CR1_AWDCH, u32_channel << ADC_CR1_AWDCH_Pos);
+    ADC1->CR1 |= ADC_CR1_AWDSGL | ADC_CR1_AWDEN | ADC_CR1_JAWDEN;
+    ADC1->SR   = ~(uint32_t)ADC_SR_AWD;
+
+    adc_irq_set_handler(ADC_IRQ_CLIENT_POTIS_DMA, potis_dma_watchdog_irq, NULL);
+    adc_irq_enable(POTIS_DMA_WATCHDOG_IRQ_PRIORITY);
+    ADC1->CR1 |= ADC_CR1_AWDIE;
+
+    return HAL_OK;
+}
+
+void potis_dma_watchdog_rearm(void)
+{
+    if (g_potis_dma_watchdog_callback == NULL) {
+        return;
+    }
+
+    /* A value still outside the window trips again with the next conversion */
+    ADC1->SR   = ~(uint32_t)ADC_SR_AWD;
+    ADC1->CR1 |= ADC_CR1_AWDIE;
+}
+
+void potis_dma_watchdog_stop(void)
+{
+    ADC1->CR1 &= ~(uint32_t)(ADC_CR1_AWDIE | ADC_CR1_AWDEN | ADC_CR1_JAWDEN | ADC_CR1_AWDSGL);
+    ADC1->SR   = ~(uint32_t)ADC_SR_AWD;
+    g_potis_dma_watchdog_callback = NULL;
+}
+
+/**
+ * @brief  DMA half transfer: the first half of the buffer is stable.
+ * @param  hadc  ADC handle
+ * @return None
+ */
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef* hadc)
+{
+    if (hadc == &g_potis_dma_adc_handle_struct) {
+        /* Burst: the result is published with the second half */
+        potis_dma_update_half(0, (g_potis_dma_mode != POTIS_DMA_MODE_BURST) ? 1 : 0);
+    }
+}
+
+/**
+ * @brief  DMA transfer complete: the second half of the buffer is stable.
+ * @param  hadc  ADC handle
+ * @return None
+ */
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef* hadc)
+{
+    if (hadc == &g_potis_dma_adc_handle_struct) {
+        if (g_potis_dma_mode == POTIS_DMA_MODE_BURST) {
+            potis_dma_burst_end();
+            g_u32_potis_bursts++;
+        }
+        potis_dma_update_half(1, 1);
+    }
 }
 
 /* Static module functions (implementation) */
@@ -219,24 +873,262 @@ void potis_gpio_init(void)
 }
 
 /**
- * @brief  Initializes DMA2 Stream0 Channel 0 for ADC1 transfers.
+ * @brief  Claims the ADC1 stream (event latency class, interrupt
+ *         dispatched by dma_alloc) and initializes it.
  * @param  None
  * @return None
  */
 void potis_dma_hardware_init(void)
 {
-    __HAL_RCC_DMA2_CLK_ENABLE();
+    /* Without a stream the ADC converts, but no sums are fed */
+    if (dma_alloc_claim(&g_potis_dma_dma_handle_struct, DMA_ALLOC_REQ_ADC1,
+                        DMA_ALLOC_LATENCY_EVENT, HEALTH_ISR_POTIS_DMA) != HAL_OK) {
+        return;
+    }
+    g_potis_dma_irqn = dma_alloc_get_irqn(&g_potis_dma_dma_handle_struct);
+
+    g_potis_dma_dma_handle_struct.Init.Direction           = DMA_PERIPH_TO_MEMORY;
+    g_potis_dma_dma_handle_struct.Init.PeriphInc           = DMA_PINC_DISABLE;
+    g_potis_dma_dma_handle_struct.Init.MemInc              = DMA_MINC_ENABLE;
+    /* A burst is one pass over the buffer */
+    g_potis_dma_dma_handle_struct.Init.Mode                = (g_potis_dma_mode == POTIS_DMA_MODE_BURST) ?
+                                                             DMA_NORMAL : DMA_CIRCULAR;
+#if POTIS_DMA_HALFWORD_SAMPLES
+    /* ADC1->DR is read as halfword, the FIFO collects 4 samples (8 bytes)
+     * and writes them to SRAM in one INC4 burst. Both buffer halves are a
+     * multiple of the burst size, as required in circular mode. */
+    g_potis_dma_dma_handle_struct.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+    g_potis_dma_dma_handle_struct.Init.MemDataAlignment    = DMA_MDATAALIGN_HALFWORD;
+    g_potis_dma_dma_handle_struct.Init.FIFOMode            = DMA_FIFOMODE_ENABLE;
+    g_potis_dma_dma_handle_struct.Init.FIFOThreshold       = DMA_FIFO_THRESHOLD_HALFFULL;
+    g_potis_dma_dma_handle_struct.Init.MemBurst            = DMA_MBURST_INC4;
+    g_potis_dma_dma_handle_struct.Init.PeriphBurst         = DMA_PBURST_SINGLE;
+#else
+    g_potis_dma_dma_handle_struct.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+    g_potis_dma_dma_handle_struct.Init.MemDataAlignment    = DMA_MDATAALIGN_WORD;
+    g_potis_dma_dma_handle_struct.Init.FIFOMode            = DMA_FIFOMODE_DISABLE;
+#endif
+
+    HAL_DMA_Init(&g_potis_dma_dma_handle_struct);
+}
 
-    DMA_handle_structure.Instance                 = DMA2_Stream0;
-    DMA_handle_structure.Init.Channel             = DMA_CHANNEL_0;
-    DMA_handle_structure.Init.Direction           = DMA_PERIPH_TO_MEMORY;
-    DMA_handle_structure.Init.PeriphInc           = DMA_PINC_DISABLE;
-    DMA_handle_structure.Init.MemInc              = DMA_MINC_ENABLE;
-    DMA_handle_structure.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
-    DMA_handle_structure.Init.MemDataAlignment    = DMA_MDATAALIGN_WORD;
-    DMA_handle_structure.Init.Mode                = DMA_CIRCULAR;
-    DMA_handle_structure.Init.Priority            = DMA_PRIORITY_MEDIUM;
-    DMA_handle_structure.Init.FIFOMode            = DMA_FIFOMODE_DISABLE;
+/**
+ * @brief  Configures TIM8 as ADC trigger with update event on TRGO.
+ * @param  sample_rate_hz  Trigger rate, falls back to
+ *                         POTIS_DMA_DEFAULT_SAMPLE_RATE_HZ if 0
+ * @return None
+ */
+static void potis_dma_timer_init(uint32_t sample_rate_hz)
+{
+    TIM_MasterConfigTypeDef master_config_struct;
+
+    if (sample_rate_hz == 0 || sample_rate_hz > POTIS_DMA_TIMER_CLOCK_HZ) {
+        sample_rate_hz = POTIS_DMA_DEFAULT_SAMPLE_RATE_HZ;
+    }
 
-    HAL_DMA_Init(&DMA_handle_structure);
+    /* TIM8 is also the ESD DMA refresh; without it no scan is triggered */
+    if (tim_alloc_claim(TIM8, TIM_ALLOC_OWNER_POTIS_DMA) != HAL_OK) {
+        return;
+    }
+
+    g_potis_dma_tim8_handle_struct.Instance               = TIM8;
+    g_potis_dma_tim8_handle_struct.Init.Prescaler         = (clock_get_apb2_timer_clock() / POTIS_DMA_TIMER_CLOCK_HZ) - 1;
+    g_potis_dma_tim8_handle_struct.Init.CounterMode       = TIM_COUNTERMODE_UP;
+    g_potis_dma_tim8_handle_struct.Init.Period            = (POTIS_DMA_TIMER_CLOCK_HZ / sample_rate_hz) - 1;
+    g_potis_dma_tim8_handle_struct.Init.ClockDivision     = TIM_CLOCKDIVISION_DIV1;
+    g_potis_dma_tim8_handle_struct.Init.RepetitionCounter = 0;
+    HAL_TIM_Base_Init(&g_potis_dma_tim8_handle_struct);
+
+    master_config_struct.MasterOutputTrigger = TIM_TRGO_UPDATE;
+    master_config_struct.MasterSlaveMode     = TIM_MASTERSLAVEMODE_DISABLE;
+    HAL_TIMEx_MasterConfigSynchronization(&g_potis_dma_tim8_handle_struct, &master_config_struct);
+
+#if DATALOG_ENABLE
+    g_u32_potis_scan_cycles = SystemCoreClock / sample_rate_hz;
+#endif
+}
+
+/**
+ * @brief  Powers ADC1 down: ADON cleared ends the conversions, a scan
+ *         finished after the last DMA transfer only leaves flags behind.
+ * @param  None
+ * @return None
+ */
+static void potis_dma_burst_end(void)
+{
+    ADC1->CR2 &= ~(uint32_t)(ADC_CR2_ADON | ADC_CR2_DMA);
+    ADC1->SR   = ~(uint32_t)(ADC_SR_OVR | ADC_SR_EOC | ADC_SR_STRT);
+    g_u8_potis_burst_running = 0;
+}
+
+/**
+ * @brief  Sums one half of the interleaved DMA buffer and replaces the
+ *         previous contribution of that half in the running sums.
+ * @param  half     0 for the first, 1 for the second half
+ * @param  publish  0: no databus, trace, change callback or block event
+ * @return None
+ */
+static void potis_dma_update_half(uint8_t half, uint8_t publish)
+{
+    const potis_dma_sample_t* p_sample = &g_potis_samples[half * (NON_FILTERED_DATA_ARRAY_LENGTH / 2)];
+    potis_dma_block_callback_t block_callback = g_potis_dma_block_callback;
+    uint32_t u32_sum_1 = 0;
+    uint32_t u32_sum_2 = 0;
+
+    PROFILE_BEGIN(PROFILE_ZONE_POTIS_BLOCK);
+
+    if (block_callback != NULL) {
+        block_callback(p_sample, NON_FILTERED_DATA_ARRAY_LENGTH / 2);
+    }
+
+    for (uint32_t i = 0; i < NON_FILTERED_DATA_ARRAY_LENGTH / 2; i += 2) {
+        u32_sum_1 += p_sample[i];
+        u32_sum_2 += p_sample[i + 1];
+    }
+
+    g_u32_potis_sequence++;
+    __DMB();
+    g_u32_potis_sum[POTI_1] += u32_sum_1 - g_u32_potis_half_sum[half][POTI_1];
+    g_u32_potis_sum[POTI_2] += u32_sum_2 - g_u32_potis_half_sum[half][POTI_2];
+    __DMB();
+    g_u32_potis_sequence++;
+
+    g_u32_potis_half_sum[half][POTI_1] = u32_sum_1;
+    g_u32_potis_half_sum[half][POTI_2] = u32_sum_2;
+
+    g_u8_potis_last_half = half;
+
+    if (publish) {
+        databus_potis_t potis = {g_u32_potis_sum[POTI_1] / (NON_FILTERED_DATA_ARRAY_LENGTH / 2),
+                                 g_u32_potis_sum[POTI_2] / (NON_FILTERED_DATA_ARRAY_LENGTH / 2)};
+
+        databus_publish(DATABUS_TOPIC_POTIS, &potis);
+    }
+
+#if DATALOG_ENABLE
+    {
+        /* The half completes with its last scan, the earlier scans are back dated */
+        uint32_t u32_now = utils_now_cycles();
+
+        for (uint32_t i = 0; i < NON_FILTERED_DATA_ARRAY_LENGTH / 2; i += 2) {
+            uint32_t u32_time = u32_now - ((NON_FILTERED_DATA_ARRAY_LENGTH / 2 - 2 - i) / 2) * g_u32_potis_scan_cycles;
+
+            DATALOG_LOG_AT(DATALOG_CH_POTI_1, p_sample[i], u32_time);
+            DATALOG_LOG_AT(DATALOG_CH_POTI_2, p_sample[i + 1], u32_time);
+        }
+    }
+#endif
+
+    potis_dma_decimate_half(p_sample);
+
+    if (publish) {
+        TRACE_U32(TRACE_CH_POTIS,
+                  ((g_u32_potis_sum[POTI_2] / (NON_FILTERED_DATA_ARRAY_LENGTH / 2)) << 16) |
+                  (g_u32_potis_sum[POTI_1] / (NON_FILTERED_DATA_ARRAY_LENGTH / 2)));
+        potis_dma_check_bands();
+    }
+
+    PROFILE_END(PROFILE_ZONE_POTIS_BLOCK);
+
+    if (publish) {
+        osal_event_signal(&g_potis_block_event);
+    }
+}
+
+/**
+ * @brief  Compares the filtered values with their band centres and
+ *         reports and re-centres every channel that left its band.
+ * @param  None
+ * @return None
+ */
+static void potis_dma_check_bands(void)
+{
+    potis_dma_change_callback_t callback = g_potis_dma_change_callback;
+
+    if (callback == NULL) {
+        return;
+    }
+
+    for (uint8_t i = 0; i < FILTERED_DATA_ARRAY_LENGTH; i++) {
+        uint32_t u32_value = g_u32_potis_sum[i] / (NON_FILTERED_DATA_ARRAY_LENGTH / 2);
+        uint32_t u32_delta;
+
+        if (g_u8_potis_quantised) {
+            if (potis_dma_quant_update(&g_potis_quant[i], u32_value, &u32_value)) {
+                callback(i, u32_value);
+            }
+            continue;
+        }
+
+        u32_delta = (u32_value > g_u32_potis_band[i]) ? u32_value - g_u32_potis_band[i]
+                                                       : g_u32_potis_band[i] - u32_value;
+
+        if (!g_u8_potis_band_valid || (u32_delta > g_u32_potis_hysteresis)) {
+            g_u32_potis_band[i] = u32_value;
+            callback(i, u32_value);
+        }
+    }
+
+    g_u8_potis_band_valid = 1;
+}
+
+/**
+ * @brief  Runs the decimation and FIR filter on one half buffer.
+ * @param  p_sample  First sample of the half
+ * @return None
+ */
+static void potis_dma_decimate_half(const potis_dma_sample_t* p_sample)
+{
+    uint32_t u32_output[FILTERED_DATA_ARRAY_LENGTH];
+
+    potis_filter_half(&g_potis_filter, p_sample, u32_output);
+
+    for (uint8_t channel = 0; channel < FILTERED_DATA_ARRAY_LENGTH; channel++) {
+        g_u32_potis_oversampled[channel] = u32_output[channel];
+    }
+
+    for (uint8_t channel = 0; channel < FILTERED_DATA_ARRAY_LENGTH; channel++) {
+        biquad_q31_t *filter = g_p_potis_biquad[channel];
+        int32_t i32_block[POTIS_DMA_SCANS_PER_HALF];
+        int32_t i32_last;
+
+        if (filter == NULL) {
+            continue;
+        }
+
+        /* Whole half as one block, the last output is the result */
+        for (uint32_t i = 0; i < POTIS_DMA_SCANS_PER_HALF; i++) {
+            i32_block[i] = (int32_t)((uint32_t)p_sample[i * FILTERED_DATA_ARRAY_LENGTH + channel]
+                                     << POTIS_DMA_BIQUAD_SHIFT);
+        }
+        biquad_q31_process(filter, i32_block, i32_block, POTIS_DMA_SCANS_PER_HALF);
+
+        i32_last = i32_block[POTIS_DMA_SCANS_PER_HALF - 1u] >> POTIS_DMA_BIQUAD_SHIFT;
+        g_u32_potis_biquad[channel] = (i32_last < 0) ? 0u : ((i32_last > 4095) ? 4095u : (uint32_t)i32_last);
+    }
+}
+
+/**
+ * @brief  Analog watchdog interrupt: one callback per excursion, the
+ *         interrupt stays off until potis_dma_watchdog_rearm().
+ * @param  context  Unused
+ * @return None
+ */
+static void potis_dma_watchdog_irq(void *context)
+{
+    potis_dma_watchdog_callback_t callback = g_potis_dma_watchdog_callback;
+
+    (void)context;
+
+    if (((ADC1->SR & ADC_SR_AWD) == 0u) || ((ADC1->CR1 & ADC_CR1_AWDIE) == 0u)) {
+        return;
+    }
+
+    /* One notification per excursion, the flag is set on every conversion outside */
+    ADC1->CR1 &= ~(uint32_t)ADC_CR1_AWDIE;
+    ADC1->SR   = ~(uint32_t)ADC_SR_AWD;
+
+    if (callback != NULL) {
+        callback(g_p_potis_dma_watchdog_context);
+    }
 }
@@ -7,11 +7,25 @@
 * @brief Potentiometer module using ADC1 with DMA for continuous sampling.
 *
 *        This module provides two ways to access the potentiometer data:
-*        1) By calling 'potis_dma_get_val(POTI_x)' which internally
-*           filters the DMA buffer before returning the value.
+*        1) By calling 'potis_dma_get_val(POTI_x)' which returns the
+*           average of the DMA buffer from a running sum.
 *        2) By calling 'potis_dma_filter_data()' in the application and
 *           then reading the filtered values from the global array
 *           'g_u32_potis_filtered_data[POTI_x]'.
+*
+*        The DMA buffer is used as two halves: while the DMA fills one
+*        half, the other half is summed from the half/full transfer
+*        interrupt into per-channel running sums, so the filtered values
+*        are built from data that is not being overwritten.
+*        In POTIS_DMA_MODE_TIMER the ADC is triggered by TIM8 TRGO, so
+*        the values are updated at a deterministic rate.
+*        In POTIS_DMA_MODE_BURST the ADC is only powered while
+*        potis_dma_burst_trigger() fills the buffer once (one DMA pass,
+*        POTIS_DMA_BURST_SCANS scans), the results are published at its
+*        end and the ADC is switched off again until the next trigger.
+*        3) Optionally per potentiometer an IIR cascade (biquad module,
+*           potis_dma_set_biquad()) over every half buffer, read with
+*           'potis_dma_get_biquad(POTI_x)'.
 **************************************************
 */
 #ifndef POTIS_DMA_POTIS_DMA_H_
@@ -19,6 +33,9 @@
 
 /* Includes */
 #include "stm32f4xx.h"
+#include "irq/irq.h"
+#include "stats/stats.h"
+#include "biquad/biquad.h"
 
 /* Public Preprocessor defines */
 /**
@@ -49,7 +66,42 @@
 /**
  * @brief Length of the raw DMA data buffer (interleaved samples).
  */
-#define NON_FILTERED_DATA_ARRAY_LENGTH 200
+#define NON_FILTERED_DATA_ARRAY_LENGTH 256
+
+/**
+ * @brief Scale of the samples in the IIR cascade, 12 bit counts with 3 bit
+ *        headroom for the overshoot.
+ */
+#define POTIS_DMA_BIQUAD_SHIFT 16
+
+/**
+ * @brief 1: samples are stored as packed 16 bit halfwords and moved by the
+ *        DMA FIFO in 4-beat bursts, 0: one 32 bit word per sample.
+ */
+#ifndef POTIS_DMA_HALFWORD_SAMPLES
+#define POTIS_DMA_HALFWORD_SAMPLES 1
+#endif
+
+/**
+ * @brief Number of 12 bit samples per channel combined into one
+ *        oversampled value (4^n samples give n extra bits, max. 16).
+ */
+#define POTIS_DMA_OVERSAMPLING 16
+
+/**
+ * @brief Extra bits gained by oversampling: log4(POTIS_DMA_OVERSAMPLING).
+ */
+#define POTIS_DMA_EXTRA_BITS 2
+
+/**
+ * @brief Maximum oversampled value (14 bit for 16x oversampling).
+ */
+#define POTIS_DMA_OVERSAMPLED_MAX ((ADC_12_BIT_RESOLUTION + 1) * (1 << POTIS_DMA_EXTRA_BITS) - 1)
+
+/**
+ * @brief Number of taps of the FIR filter behind the decimator (even).
+ */
+#define POTIS_DMA_FIR_TAPS 8
 
 /**
  * @brief Timeout in milliseconds for ADC conversion polling (if used).
@@ -66,8 +118,106 @@
  */
 #define POTI_2 1
 
+/**
+ * @brief Default sample rate in POTIS_DMA_MODE_TIMER (conversions of
+ *        both channels per second).
+ */
+#define POTIS_DMA_DEFAULT_SAMPLE_RATE_HZ 10000
+
+/**
+ * @brief Scans of both channels per burst in POTIS_DMA_MODE_BURST (the
+ *        whole buffer, ~1.1 ms at 84 cycles per conversion).
+ */
+#define POTIS_DMA_BURST_SCANS (NON_FILTERED_DATA_ARRAY_LENGTH / 2)
+
+/**
+ * @brief Interrupt priority of the ADC1 DMA stream (half/full transfer).
+ */
+#define POTIS_DMA_IRQ_PRIORITY IRQ_CLASS_TRANSFER
+
+/**
+ * @brief Interrupt priority of ADC_IRQn while the analog watchdog runs
+ *        (a protection path, preempts the control task).
+ */
+#define POTIS_DMA_WATCHDOG_IRQ_PRIORITY IRQ_CLASS_CAPTURE
+
+/**
+ * @brief Default half width of the hysteresis band in ADC counts for
+ *        'potis_dma_set_change_callback()'.
+ */
+#define POTIS_DMA_DEFAULT_HYSTERESIS 16
+
+/**
+ * @brief Default step and extra dead-band in ADC counts of the quantiser
+ *        (potis_dma_quant_init(), potis_dma_set_quantiser()): 128 levels,
+ *        a level changes once the input is a quarter step past the
+ *        middle between two levels.
+ */
+#define POTIS_DMA_QUANT_DEFAULT_STEP 32
+#define POTIS_DMA_QUANT_DEFAULT_HYSTERESIS 8
+
+/**
+ * @brief Ranks of the injected sequence: JDR1..4 hold the conversions of
+ *        the last POTIS_DMA_INJECTED_RANKS triggers.
+ */
+#define POTIS_DMA_INJECTED_RANKS 4
+
 /* Public Preprocessor macros */
 /* Public type definitions */
+/**
+ * @brief Element type of the raw DMA data buffer.
+ */
+#if POTIS_DMA_HALFWORD_SAMPLES
+typedef uint16_t potis_dma_sample_t;
+#else
+typedef uint32_t potis_dma_sample_t;
+#endif
+/**
+ * @brief Sampling modes of ADC1.
+ */
+typedef enum {
+    POTIS_DMA_MODE_CONTINUOUS = 0, /**< Free-running, software started        */
+    POTIS_DMA_MODE_TIMER,          /**< One scan per TIM8 TRGO, half buffers   */
+    POTIS_DMA_MODE_BURST           /**< One buffer per trigger, ADC off between */
+} potis_dma_mode_t;
+
+/**
+ * @brief Dead-band quantiser: the output moves in steps of u32_step and
+ *        only when the input leaves the current level by more than half
+ *        a step plus u32_hysteresis (Schmitt trigger per level edge), so
+ *        ADC noise around a level edge does not toggle the output.
+ */
+typedef struct {
+    uint32_t u32_step;
+    uint32_t u32_hysteresis;
+    uint32_t u32_level;     /**< Current level, output = level * step */
+    uint8_t  u8_valid;      /**< 0 until the first value             */
+} potis_dma_quant_t;
+
+/**
+ * @brief Change notification, called from the DMA interrupt when a
+ *        potentiometer leaves its hysteresis band.
+ * @param poti_num  POTI_1 or POTI_2
+ * @param value     New filtered value (0..ADC_12_BIT_RESOLUTION)
+ */
+typedef void (*potis_dma_change_callback_t)(uint8_t poti_num, uint32_t value);
+
+/**
+ * @brief Raw block notification, called from the DMA interrupt for every
+ *        completed buffer half before it is filtered.
+ * @param p_samples  Interleaved samples (POTI_1, POTI_2, ...), stable until
+ *                   the DMA wraps around to this half again
+ * @param count      Number of samples (NON_FILTERED_DATA_ARRAY_LENGTH / 2)
+ */
+typedef void (*potis_dma_block_callback_t)(const potis_dma_sample_t* p_samples, uint32_t count);
+
+/**
+ * @brief Analog watchdog notification, called from ADC_IRQn after the
+ *        conversion that left the window. The watchdog interrupt is off
+ *        until potis_dma_watchdog_rearm().
+ * @param context  Pointer given to potis_dma_watchdog_start()
+ */
+typedef void (*potis_dma_watchdog_callback_t)(void *context);
 
 /* Public variables */
 /**
@@ -80,7 +230,7 @@ extern uint32_t g_u32_potis_filtered_data[FILTERED_DATA_ARRAY_LENGTH];
 /**
  * @brief  Initializes hardware resources for ADC+DMA potentiometer sampling.
  *         - Configures GPIO pins (PA6, PA7) as analog inputs
- *         - Configures DMA2 Stream0 Channel 0
+ *         - Claims the ADC1 DMA stream from dma_alloc
  *         - Configures ADC1 with two channels (6 and 7)
  * @param  None
  * @return None
@@ -88,24 +238,66 @@ extern uint32_t g_u32_potis_filtered_data[FILTERED_DATA_ARRAY_LENGTH];
 void potis_dma_init(void);
 
 /**
- * @brief  Starts ADC1 DMA transfers into the raw data buffer.
+ * @brief  Initializes the module in the given sampling mode.
+ *
+ *         In POTIS_DMA_MODE_TIMER TIM8 is configured to trigger one scan of
+ *         both channels 'sample_rate_hz' times per second, the filtered
+ *         values are then updated once per NON_FILTERED_DATA_ARRAY_LENGTH / 4
+ *         scans.
+ *
+ *         In POTIS_DMA_MODE_BURST the DMA stream runs in normal mode and
+ *         the ADC is left powered down. Every potis_dma_burst_trigger()
+ *         converts POTIS_DMA_BURST_SCANS scans back to back; the first
+ *         half is filtered while the second one converts, the values,
+ *         the databus topic, the change callback and
+ *         potis_dma_wait_block() follow at the end of the burst. The
+ *         injected conversions and the analog watchdog need a powered
+ *         ADC: control-critical channels stay in one of the other modes.
+ *
+ * @param  mode            POTIS_DMA_MODE_CONTINUOUS, POTIS_DMA_MODE_TIMER or
+ *                         POTIS_DMA_MODE_BURST
+ * @param  sample_rate_hz  Scan rate in POTIS_DMA_MODE_TIMER, ignored otherwise
+ * @return None
+ */
+void potis_dma_init_mode(potis_dma_mode_t mode, uint32_t sample_rate_hz);
+
+/**
+ * @brief  Starts ADC1 DMA transfers into the raw data buffer
+ *         (and TIM8 in POTIS_DMA_MODE_TIMER, the first burst in
+ *         POTIS_DMA_MODE_BURST).
  * @param  None
  * @return None
  */
 void potis_dma_start(void);
 
 /**
- * @brief  Filters the raw DMA data and calculates averaged values
- *         for each potentiometer.
+ * @brief  Powers up ADC1 and converts one burst (POTIS_DMA_MODE_BURST).
+ *         Call at the acquisition interval, e.g. from a scheduler task;
+ *         the DMA interrupt powers the ADC down again after the last scan.
+ * @param  None
+ * @return HAL_OK, HAL_BUSY while the previous burst runs, HAL_ERROR in
+ *         another mode or without a DMA stream
+ */
+HAL_StatusTypeDef potis_dma_burst_trigger(void);
+
+/**
+ * @brief  Returns the number of completed bursts.
+ * @param  None
+ * @return Bursts since potis_dma_init_mode()
+ */
+uint32_t potis_dma_burst_count(void);
+
+/**
+ * @brief  Copies the averaged value of each potentiometer into
+ *         'g_u32_potis_filtered_data'.
  *
  *         The DMA buffer contains interleaved samples:
  *         index 0,2,4,... -> POTI_1
  *         index 1,3,5,... -> POTI_2
  *
- *         This function:
- *         - Sums up all samples per potentiometer
- *         - Divides by (NON_FILTERED_DATA_ARRAY_LENGTH / 2)
- *         - Stores the results into 'g_u32_potis_filtered_data'
+ *         The averages over the whole buffer are kept as running sums that
+ *         are updated from the DMA half/full transfer interrupts, so this
+ *         function is O(1).
  *
  * @param  None
  * @return None
@@ -115,8 +307,7 @@ void potis_dma_filter_data(void);
 /**
  * @brief  Returns the filtered ADC value of the selected potentiometer.
  *
- *         Internally calls 'potis_dma_filter_data()' before returning
- *         the filtered value.
+ *         O(1), reads the running sum maintained by the DMA interrupt.
  *
  * @param  poti_num  Potentiometer index:
  *                   - POTI_1 : potentiometer 1
@@ -126,4 +317,227 @@ void potis_dma_filter_data(void);
  */
 uint32_t potis_dma_get_val(uint8_t poti_num);
 
+/**
+ * @brief  Returns the filtered values of all potentiometers, taken from the
+ *         same buffer update (lock-free, retried via a sequence counter).
+ * @param  values  Output array, index with POTI_1 and POTI_2
+ * @return None
+ */
+void potis_dma_get_all(uint32_t values[FILTERED_DATA_ARRAY_LENGTH]);
+
+/**
+ * @brief  Returns the oversampled and FIR filtered value of a potentiometer.
+ *
+ *         Every POTIS_DMA_OVERSAMPLING samples of a channel are summed
+ *         and decimated to one value with POTIS_DMA_EXTRA_BITS extra bits.
+ *         The decimated values pass a POTIS_DMA_FIR_TAPS FIR filter
+ *         (boxcar by default). Updated from the DMA interrupt.
+ *
+ * @param  poti_num  POTI_1 or POTI_2
+ * @return uint32_t  0 .. POTIS_DMA_OVERSAMPLED_MAX, 0 if poti_num is invalid.
+ */
+uint32_t potis_dma_get_oversampled(uint8_t poti_num);
+
+/**
+ * @brief  Replaces the FIR coefficients.
+ *
+ *         output = (sum of coefficient[k] * x[n - TAPS + 1 + k]) >> shift,
+ *         coefficient[0] weights the oldest value. The sum of all
+ *         coefficients should be 2^shift for unity gain.
+ *
+ * @param  coefficients  POTIS_DMA_FIR_TAPS signed coefficients
+ * @param  shift         Right shift applied to the sum
+ * @return None
+ */
+void potis_dma_set_fir(const int16_t coefficients[POTIS_DMA_FIR_TAPS], uint8_t shift);
+
+/**
+ * @brief  Registers a callback that is raised only when a filtered value
+ *         leaves the band [centre - hysteresis, centre + hysteresis].
+ *         The band is then re-centred on the new value.
+ *
+ *         Evaluated on every half buffer in the DMA interrupt; the first
+ *         evaluation after registering always reports both channels. The
+ *         callback runs in interrupt context and must be short.
+ *
+ * @param  callback    Function to call, NULL disables the notification
+ * @param  hysteresis  Band half width in ADC counts, 0 selects
+ *                     POTIS_DMA_DEFAULT_HYSTERESIS
+ * @return None
+ */
+void potis_dma_set_change_callback(potis_dma_change_callback_t callback, uint32_t hysteresis);
+
+/**
+ * @brief  Switches the change notifications to quantised values: the
+ *         callback reports level * step on every level change instead of
+ *         re-centring a band on the raw value.
+ * @param  step        Level distance in ADC counts, 0 returns to the band
+ * @param  hysteresis  Extra dead-band beyond half a step in ADC counts
+ * @return None
+ */
+void potis_dma_set_quantiser(uint32_t step, uint32_t hysteresis);
+
+/**
+ * @brief  Starts a quantiser.
+ * @param  quant       Instance
+ * @param  step        Level distance, 0 selects POTIS_DMA_QUANT_DEFAULT_STEP
+ * @param  hysteresis  Extra dead-band beyond half a step
+ * @return None
+ */
+void potis_dma_quant_init(potis_dma_quant_t *quant, uint32_t step, uint32_t hysteresis);
+
+/**
+ * @brief  Feeds one value into a quantiser.
+ * @param  quant   Instance
+ * @param  value   Input (0..ADC_12_BIT_RESOLUTION)
+ * @param  output  Quantised value, limited to ADC_12_BIT_RESOLUTION;
+ *                 written only on a change
+ * @return 1 if the level changed (always for the first value), else 0
+ */
+uint8_t potis_dma_quant_update(potis_dma_quant_t *quant, uint32_t value, uint32_t *output);
+
+/**
+ * @brief  Registers a callback that receives every completed buffer half
+ *         unfiltered, e.g. to stream the raw samples (usb_cdc).
+ *
+ *         Runs in the DMA interrupt and must only copy the block.
+ * @param  callback  Function to call, NULL disables the notification
+ * @return None
+ */
+void potis_dma_set_block_callback(potis_dma_block_callback_t callback);
+
+/**
+ * @brief  Returns the calibrated voltage of a potentiometer from its
+ *         running average (VDDA measured via VREFINT during init).
+ * @param  poti_num  POTI_1 or POTI_2
+ * @return uint32_t  Millivolts, 0 if poti_num is invalid.
+ */
+uint32_t potis_dma_get_mv(uint8_t poti_num);
+
+/**
+ * @brief  Converts the last completed buffer half of one potentiometer
+ *         to millivolts.
+ * @param  poti_num  POTI_1 or POTI_2
+ * @param  mv        Output, NON_FILTERED_DATA_ARRAY_LENGTH / 4 values
+ * @return None
+ */
+void potis_dma_get_block_mv(uint8_t poti_num, uint16_t mv[NON_FILTERED_DATA_ARRAY_LENGTH / 4]);
+
+/**
+ * @brief  Noise of one potentiometer: mean, standard deviation, min and
+ *         max of the last completed buffer half in millivolts.
+ * @param  poti_num  POTI_1 or POTI_2
+ * @param  stats     Output, restarted with the samples of the block
+ * @return HAL_OK, HAL_ERROR if poti_num is invalid
+ */
+HAL_StatusTypeDef potis_dma_get_noise(uint8_t poti_num, stats_welford_t *stats);
+
+/**
+ * @brief  Attaches an IIR cascade to one potentiometer. The DMA interrupt
+ *         runs it over every half buffer at the scan rate (sample rate
+ *         of the design), in ADC counts scaled by 2^POTIS_DMA_BIQUAD_SHIFT.
+ *         The state is preset to the current average.
+ * @param  poti_num  POTI_1 or POTI_2
+ * @param  filter    Cascade (biquad_q31_init()), kept by the caller;
+ *                   NULL detaches
+ * @return None
+ */
+void potis_dma_set_biquad(uint8_t poti_num, biquad_q31_t *filter);
+
+/**
+ * @brief  Returns the IIR output of a potentiometer after the last half
+ *         buffer.
+ * @param  poti_num  POTI_1 or POTI_2
+ * @return uint32_t  0 .. 4095, 0 without filter or if poti_num is invalid.
+ */
+uint32_t potis_dma_get_biquad(uint8_t poti_num);
+
+/**
+ * @brief  Waits for the next completed buffer half (new running average,
+ *         new block for potis_dma_get_block_mv()).
+ *
+ *         Sleeps until the DMA interrupt reports the half (RTOS build:
+ *         blocks the calling task) instead of polling the values. Only
+ *         one caller may wait at a time.
+ * @param  u32_timeout_ms  Timeout in ms, OSAL_WAIT_FOREVER = none
+ * @return HAL_OK, HAL_TIMEOUT if no half completed (conversion stopped)
+ */
+HAL_StatusTypeDef potis_dma_wait_block(uint32_t u32_timeout_ms);
+
+/**
+ * @brief  Samples one more channel with injected conversions beside the
+ *         regular DMA stream (e.g. a current shunt).
+ *
+ *         Injected discontinuous mode: every trigger converts the next of
+ *         the POTIS_DMA_INJECTED_RANKS ranks, all on the same channel, so
+ *         no interrupt is needed and potis_dma_injected_get_mean() gives
+ *         the mean of the last triggers. A trigger suspends the running
+ *         regular scan, which repeats its conversion afterwards; the DMA
+ *         stream keeps its order.
+ * @param  u32_channel  ADC_CHANNEL_x, analog pin set up by the caller
+ * @param  u32_trigger  ADC_EXTERNALTRIGINJECCONV_x (rising edge) or
+ *                      ADC_INJECTED_SOFTWARE_START for
+ *                      potis_dma_injected_trigger()
+ * @return HAL_OK, HAL_ERROR if ADC1 is off (potis_dma_init() not called)
+ */
+HAL_StatusTypeDef potis_dma_injected_start(uint32_t u32_channel, uint32_t u32_trigger);
+
+/**
+ * @brief  Starts the next injected conversion by software.
+ * @param  None
+ * @return None
+ */
+void potis_dma_injected_trigger(void);
+
+/**
+ * @brief  Returns the mean of the injected data registers.
+ * @param  None
+ * @return Mean of the last POTIS_DMA_INJECTED_RANKS conversions (0..4095),
+ *         older ranks are 0 until as many triggers arrived
+ */
+uint32_t potis_dma_injected_get_mean(void);
+
+/**
+ * @brief  Disables the injected trigger; the regular stream continues.
+ * @param  None
+ * @return None
+ */
+void potis_dma_injected_stop(void);
+
+/**
+ * @brief  Starts the analog watchdog of ADC1 on one channel: the
+ *         conversion of a value outside [u16_low, u16_high] interrupts
+ *         within the conversion time, no DMA half or main loop between.
+ *
+ *         The channel is guarded in the regular and the injected group,
+ *         so either a channel of the DMA stream or the injected channel
+ *         (potis_dma_injected_start(), e.g. a current shunt or a
+ *         thermistor divider) can be watched. ADC_IRQn runs at
+ *         POTIS_DMA_WATCHDOG_IRQ_PRIORITY; the vector is shared with the
+ *         interrupt driven potis module (not used together).
+ * @param  u32_channel  ADC_CHANNEL_x
+ * @param  u16_low      Lowest valid value (0..4095)
+ * @param  u16_high     Highest valid value (0..4095)
+ * @param  callback     Called once per excursion
+ * @param  context      Passed to the callback
+ * @return HAL_OK, HAL_ERROR if ADC1 is off, the window is empty or no
+ *         callback is given
+ */
+HAL_StatusTypeDef potis_dma_watchdog_start(uint32_t u32_channel, uint16_t u16_low, uint16_t u16_high,
+                                           potis_dma_watchdog_callback_t callback, void *context);
+
+/**
+ * @brief  Enables the watchdog interrupt again after an excursion.
+ * @param  None
+ * @return None
+ */
+void potis_dma_watchdog_rearm(void);
+
+/**
+ * @brief  Stops the analog watchdog.
+ * @param  None
+ * @return None
+ */
+void potis_dma_watchdog_stop(void);
+
 #endif /* POTIS_DMA_POTIS_DMA_H_ */
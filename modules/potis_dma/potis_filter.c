@@ -0,0 +1,120 @@
+/**
+ ******************************************************************************
+ * @file        potis_filter.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Decimation and FIR filter of the potis_dma half buffers
+ *
+ * Functionality:
+ * - Boxcar sum of POTIS_DMA_OVERSAMPLING scans per decimated value
+ * - Mirrored history, FIR over a contiguous window
+ *
+ * Resources:
+ * - None (pure computation, also built on the host)
+ ******************************************************************************
+ */
+
+#include "potis_filter.h"
+#include "utils/utils.h"
+#include <string.h>
+
+#if (POTIS_DMA_SCANS_PER_HALF % POTIS_DMA_OVERSAMPLING) != 0
+#error "Each buffer half must hold a multiple of POTIS_DMA_OVERSAMPLING scans"
+#endif
+
+#if POTIS_DMA_OVERSAMPLING > 16
+#error "16 bit lane sums overflow for more than 16 12-bit samples"
+#endif
+
+#if (POTIS_DMA_FIR_TAPS % 2) != 0
+#error "POTIS_DMA_FIR_TAPS must be even, two taps are processed per __SMLAD"
+#endif
+
+#if POTIS_DMA_FIR_TAPS != 8
+#error "Adapt the default boxcar 'g_i16_potis_filter_boxcar' to POTIS_DMA_FIR_TAPS"
+#endif
+
+/* Static module variables -------------------------------------------------- */
+/**
+ * @brief Default coefficients and shift (log2 of the boxcar length).
+ */
+static const int16_t g_i16_potis_filter_boxcar[POTIS_DMA_FIR_TAPS] = {1, 1, 1, 1, 1, 1, 1, 1};
+static const uint8_t g_u8_potis_filter_boxcar_shift = 3;
+
+/* Public functions --------------------------------------------------------- */
+void potis_filter_init(potis_filter_t *filter)
+{
+    memset(filter->i16_history, 0, sizeof(filter->i16_history));
+    filter->u8_history_pos = 0;
+    potis_filter_set_fir(filter, g_i16_potis_filter_boxcar, g_u8_potis_filter_boxcar_shift);
+}
+
+void potis_filter_set_fir(potis_filter_t *filter, const int16_t coefficients[POTIS_DMA_FIR_TAPS],
+                          uint8_t shift)
+{
+    for (uint8_t i = 0; i < POTIS_DMA_FIR_TAPS; i++) {
+        filter->i16_fir[i] = coefficients[i];
+    }
+    filter->u8_fir_shift = shift;
+}
+
+/**
+ * With halfword samples one 32 bit load holds a POTI_1/POTI_2 pair and
+ * __UADD16 accumulates both channels in one instruction. The FIR
+ * processes two taps per __SMLAD.
+ */
+UTILS_RAMFUNC void potis_filter_half(potis_filter_t *filter, const potis_dma_sample_t *p_sample,
+                                     uint32_t output[FILTERED_DATA_ARRAY_LENGTH])
+{
+    for (uint32_t block = 0; block < POTIS_DMA_SCANS_PER_HALF / POTIS_DMA_OVERSAMPLING; block++) {
+        uint32_t u32_sum[FILTERED_DATA_ARRAY_LENGTH];
+
+#if POTIS_DMA_HALFWORD_SAMPLES
+        const uint32_t* pu32_pair = (const uint32_t*)&p_sample[block * POTIS_DMA_OVERSAMPLING * 2];
+        uint32_t u32_lanes = 0;
+
+        for (uint32_t i = 0; i < POTIS_DMA_OVERSAMPLING; i++) {
+            u32_lanes = __UADD16(u32_lanes, pu32_pair[i]);
+        }
+        u32_sum[POTI_1] = u32_lanes & 0xFFFFu;
+        u32_sum[POTI_2] = u32_lanes >> 16;
+#else
+        const potis_dma_sample_t* p_scan = &p_sample[block * POTIS_DMA_OVERSAMPLING * 2];
+
+        u32_sum[POTI_1] = 0;
+        u32_sum[POTI_2] = 0;
+        for (uint32_t i = 0; i < POTIS_DMA_OVERSAMPLING * 2; i += 2) {
+            u32_sum[POTI_1] += p_scan[i];
+            u32_sum[POTI_2] += p_scan[i + 1];
+        }
+#endif
+
+        for (uint8_t channel = 0; channel < FILTERED_DATA_ARRAY_LENGTH; channel++) {
+            int16_t i16_value = (int16_t)(u32_sum[channel] >> POTIS_DMA_EXTRA_BITS);
+
+            filter->i16_history[channel][filter->u8_history_pos] = i16_value;
+            filter->i16_history[channel][filter->u8_history_pos + POTIS_DMA_FIR_TAPS] = i16_value;
+        }
+        filter->u8_history_pos = (filter->u8_history_pos + 1) % POTIS_DMA_FIR_TAPS;
+    }
+
+    for (uint8_t channel = 0; channel < FILTERED_DATA_ARRAY_LENGTH; channel++) {
+        const int16_t* pi16_window = &filter->i16_history[channel][filter->u8_history_pos];
+        int32_t i32_acc = 0;
+
+        for (uint8_t k = 0; k < POTIS_DMA_FIR_TAPS; k += 2) {
+            i32_acc = (int32_t)__SMLAD(__UNALIGNED_UINT32_READ(&pi16_window[k]),
+                                       __UNALIGNED_UINT32_READ(&filter->i16_fir[k]),
+                                       (uint32_t)i32_acc);
+        }
+
+        i32_acc >>= filter->u8_fir_shift;
+        if (i32_acc < 0) {
+            i32_acc = 0;
+        } else if (i32_acc > POTIS_DMA_OVERSAMPLED_MAX) {
+            i32_acc = POTIS_DMA_OVERSAMPLED_MAX;
+        }
+        output[channel] = (uint32_t)i32_acc;
+    }
+}
@@ -0,0 +1,83 @@
+/**
+ ******************************************************************************
+ * @file        potis_filter.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the potis_dma decimation and FIR filter.
+ *
+ * @details
+ * The processing of one DMA half buffer without peripheral access: sum
+ * POTIS_DMA_OVERSAMPLING scans per output, decimate by
+ * POTIS_DMA_EXTRA_BITS and pass the result through a POTIS_DMA_FIR_TAPS
+ * FIR filter. potis_dma owns one instance and runs it in the DMA
+ * interrupt; the host build (host/) feeds recorded sample buffers
+ * through the same code.
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - State per instance (potis_filter_t), no module globals
+ *  - Channel pairs summed with __UADD16, two taps per __SMLAD
+ *  - Default boxcar, coefficients replaceable
+ *
+ ******************************************************************************
+ */
+
+#ifndef POTIS_DMA_POTIS_FILTER_H_
+#define POTIS_DMA_POTIS_FILTER_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "potis_dma.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief Scans (one sample per channel) in one half of the DMA buffer.
+ */
+#define POTIS_DMA_SCANS_PER_HALF (NON_FILTERED_DATA_ARRAY_LENGTH / 4)
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Filter state.
+ */
+typedef struct {
+    /** Decimated history per channel, stored twice so that the FIR window
+     *  is always contiguous: x[i] == x[i + POTIS_DMA_FIR_TAPS] */
+    int16_t i16_history[FILTERED_DATA_ARRAY_LENGTH][2 * POTIS_DMA_FIR_TAPS];
+    int16_t i16_fir[POTIS_DMA_FIR_TAPS];    /**< Coefficients, oldest value first */
+    uint8_t u8_history_pos;                 /**< Write position (oldest value)    */
+    uint8_t u8_fir_shift;                   /**< Right shift of the FIR sum       */
+} potis_filter_t;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Clears the history and loads the boxcar coefficients.
+ *
+ * @param filter Instance
+ * @return None
+ */
+void potis_filter_init(potis_filter_t *filter);
+
+/**
+ * @brief Replaces the FIR coefficients.
+ *
+ * @param filter       Instance
+ * @param coefficients POTIS_DMA_FIR_TAPS signed coefficients
+ * @param shift        Right shift applied to the sum
+ * @return None
+ */
+void potis_filter_set_fir(potis_filter_t *filter, const int16_t coefficients[POTIS_DMA_FIR_TAPS],
+                          uint8_t shift);
+
+/**
+ * @brief Decimates one half buffer into the history and filters it.
+ *
+ * @param filter   Instance
+ * @param p_sample First of POTIS_DMA_SCANS_PER_HALF interleaved scans
+ *                 (32 bit aligned for halfword samples)
+ * @param output   FIR output per channel, 0 .. POTIS_DMA_OVERSAMPLED_MAX
+ * @return None
+ */
+void potis_filter_half(potis_filter_t *filter, const potis_dma_sample_t *p_sample,
+                       uint32_t output[FILTERED_DATA_ARRAY_LENGTH]);
+
+#endif /* POTIS_DMA_POTIS_FILTER_H_ */
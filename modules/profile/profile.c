@@ -0,0 +1,158 @@
+/**
+ ******************************************************************************
+ * @file        profile.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Cycle counting zone profiler
+ *
+ * Functionality:
+ * - Zone begin is a single CYCCNT read into a local (macro), zone end
+ *   one read plus profile_add()
+ * - Overhead of the two reads measured once in profile_init() and
+ *   subtracted from every pass (saturating at 0)
+ * - Text output with the fmt module, one line per zone
+ *
+ * Resources:
+ * - DWT cycle counter (shared, read only after the start)
+ ******************************************************************************
+ */
+
+#include "profile.h"
+#include <fmt/fmt.h>
+#include <utils/utils.h>
+
+/* Static module variables -------------------------------------------------- */
+static profile_stats_t g_profile_stats[PROFILE_ZONE_COUNT];
+static uint32_t g_u32_profile_overhead = 0u;
+
+/**
+ * @brief Zone names, padded to one column in the dump.
+ */
+static const char * const g_pch_profile_names[PROFILE_ZONE_COUNT] = {
+    "lcd_burst",
+    "lcd_char",
+    "potis_filter",
+    "median",
+    "fan_pi",
+    "env_read",
+    "potis_block",
+    "fb_frame",
+    "fb_flip",
+    "user_0",
+    "user_1"
+};
+
+/* Static function prototypes ---------------------------------------------- */
+static void profile_puts(profile_putc_t putc, const char *pch_text);
+
+/* Public functions --------------------------------------------------------- */
+void profile_init(void)
+{
+    volatile uint32_t u32_start;
+
+    utils_timebase_init();
+
+    /* Same code as PROFILE_BEGIN() / PROFILE_END() without the table */
+    u32_start = DWT->CYCCNT;
+    g_u32_profile_overhead = DWT->CYCCNT - u32_start;
+
+    profile_reset();
+}
+
+void profile_reset(void)
+{
+    for (uint8_t i = 0u; i < PROFILE_ZONE_COUNT; i++) {
+        g_profile_stats[i].u32_calls = 0u;
+        g_profile_stats[i].u32_min   = UINT32_MAX;
+        g_profile_stats[i].u32_max   = 0u;
+        g_profile_stats[i].u64_total = 0u;
+    }
+}
+
+void profile_add(profile_zone_t zone, uint32_t u32_cycles)
+{
+    profile_stats_t *stats;
+
+    if ((uint32_t)zone >= PROFILE_ZONE_COUNT) {
+        return;
+    }
+    stats = &g_profile_stats[zone];
+
+    u32_cycles = (u32_cycles > g_u32_profile_overhead) ? (u32_cycles - g_u32_profile_overhead) : 0u;
+
+    stats->u32_calls++;
+    stats->u64_total += u32_cycles;
+    if (u32_cycles < stats->u32_min) {
+        stats->u32_min = u32_cycles;
+    }
+    if (u32_cycles > stats->u32_max) {
+        stats->u32_max = u32_cycles;
+    }
+}
+
+const profile_stats_t *profile_get(profile_zone_t zone)
+{
+    if ((uint32_t)zone >= PROFILE_ZONE_COUNT) {
+        return NULL;
+    }
+
+    return &g_profile_stats[zone];
+}
+
+const char *profile_get_name(profile_zone_t zone)
+{
+    if ((uint32_t)zone >= PROFILE_ZONE_COUNT) {
+        return "?";
+    }
+
+    return g_pch_profile_names[zone];
+}
+
+void profile_dump(profile_putc_t putc)
+{
+    char buffer[80];
+    fmt_t fmt;
+
+    if (putc == NULL) {
+        return;
+    }
+
+    profile_puts(putc, "zone         calls      min     mean      max  mean_us\r\n");
+
+    for (uint8_t i = 0u; i < PROFILE_ZONE_COUNT; i++) {
+        /* Copy first, the zone may run in an interrupt meanwhile */
+        profile_stats_t stats = g_profile_stats[i];
+        uint32_t u32_mean;
+
+        if (stats.u32_calls == 0u) {
+            continue;
+        }
+        u32_mean = (uint32_t)(stats.u64_total / stats.u32_calls);
+
+        fmt_init(&fmt, buffer, sizeof(buffer));
+        fmt_str(&fmt, g_pch_profile_names[i]);
+        fmt_pad(&fmt, 12u);
+        fmt_u32(&fmt, stats.u32_calls, 6u, ' ');
+        fmt_u32(&fmt, stats.u32_min, 9u, ' ');
+        fmt_u32(&fmt, u32_mean, 9u, ' ');
+        fmt_u32(&fmt, stats.u32_max, 9u, ' ');
+        fmt_u32(&fmt, utils_cycles_to_us(u32_mean), 9u, ' ');
+        fmt_str(&fmt, "\r\n");
+        profile_puts(putc, fmt_get(&fmt));
+    }
+}
+
+/* Static module functions -------------------------------------------------- */
+/**
+ * @brief Writes a string through the output function.
+ *
+ * @param putc     Character output
+ * @param pch_text NUL terminated string
+ */
+static void profile_puts(profile_putc_t putc, const char *pch_text)
+{
+    while (*pch_text != '\0') {
+        putc(*pch_text++);
+    }
+}
@@ -0,0 +1,178 @@
+/**
+ ******************************************************************************
+ * @file        profile.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the cycle counting zone profiler.
+ *
+ * @details
+ * Measures hot code paths on the target with the DWT cycle counter. A
+ * zone is a code section between PROFILE_BEGIN() and PROFILE_END(); each
+ * pass adds its cycle count to a static table entry of the zone. The
+ * table can be printed character by character through any output
+ * function, e.g. __io_putchar() of the project syscalls (UART) or an ITM
+ * stimulus port (SWO).
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - Fixed zone table (profile_zone_t), preinstrumented in the lcd,
+ *    potis_dma, median, fan, env_sensor and framebuffer modules
+ *  - Per zone: calls, min / mean / max cycles
+ *  - Measurement overhead (two counter reads) is subtracted
+ *  - Compiled out completely unless PROFILE_ENABLE is 1, single zones
+ *    can be selected with PROFILE_ZONE_MASK
+ *
+ * A zone must be entered and left in the same function, between begin
+ * and end there must be no return. Zones may nest and be used from
+ * interrupts, but one zone must not be entered from two contexts at the
+ * same time. Time spent in interrupts is counted to the interrupted
+ * zone. The cycle counter wraps after 2^32 cycles (23.8 s at 180 MHz).
+ *
+ * Example:
+ *
+ *     profile_init();
+ *     ...
+ *     PROFILE_BEGIN(PROFILE_ZONE_USER_0);
+ *     work();
+ *     PROFILE_END(PROFILE_ZONE_USER_0);
+ *     ...
+ *     profile_dump(__io_putchar);
+ *
+ ******************************************************************************
+ */
+
+#ifndef PROFILE_PROFILE_H_
+#define PROFILE_PROFILE_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief 1 to compile the instrumentation in, 0 removes all zones.
+ */
+#ifndef PROFILE_ENABLE
+#define PROFILE_ENABLE      0
+#endif
+
+/**
+ * @brief Bit of a zone in PROFILE_ZONE_MASK.
+ */
+#define PROFILE_ZONE_BIT(zone)  (1UL << (zone))
+
+/**
+ * @brief Zones compiled in with PROFILE_ENABLE, e.g.
+ *        -DPROFILE_ZONE_MASK=PROFILE_ZONE_BIT(PROFILE_ZONE_MEDIAN)
+ *        to keep the other hot paths free of instrumentation.
+ */
+#ifndef PROFILE_ZONE_MASK
+#define PROFILE_ZONE_MASK       0xFFFFFFFFUL
+#endif
+
+#if PROFILE_ENABLE
+/**
+ * @brief Starts a zone: takes a timestamp into a local variable.
+ *        Zones outside the mask are removed by the compiler.
+ */
+#define PROFILE_BEGIN(zone)     uint32_t profile_start_##zone = \
+                                    ((PROFILE_ZONE_MASK >> (zone)) & 1UL) ? DWT->CYCCNT : 0u
+
+/**
+ * @brief Ends a zone started with PROFILE_BEGIN() in the same scope.
+ */
+#define PROFILE_END(zone)       do { \
+                                    if ((PROFILE_ZONE_MASK >> (zone)) & 1UL) { \
+                                        profile_add((zone), DWT->CYCCNT - profile_start_##zone); \
+                                    } \
+                                } while (0)
+#else
+#define PROFILE_BEGIN(zone)     do { } while (0)
+#define PROFILE_END(zone)       do { } while (0)
+#endif
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Profiling zones.
+ */
+typedef enum {
+    PROFILE_ZONE_LCD_BURST = 0,     /**< ILI9341_Draw_Colour_Burst()  */
+    PROFILE_ZONE_LCD_CHAR,          /**< ILI9341_Draw_Char()          */
+    PROFILE_ZONE_POTIS_FILTER,      /**< potis_dma_filter_data()      */
+    PROFILE_ZONE_MEDIAN,            /**< median_get_median()          */
+    PROFILE_ZONE_FAN_PI,            /**< fan_update_pi_controller()   */
+    PROFILE_ZONE_ENV_READ,          /**< env_sensor_read_data()       */
+    PROFILE_ZONE_POTIS_BLOCK,       /**< potis_dma half buffer (ISR)  */
+    PROFILE_ZONE_FB_FRAME,          /**< framebuffer flip to flip     */
+    PROFILE_ZONE_FB_FLIP,           /**< framebuffer_swap() to flip   */
+    PROFILE_ZONE_USER_0,            /**< Free for the application     */
+    PROFILE_ZONE_USER_1,            /**< Free for the application     */
+    PROFILE_ZONE_COUNT
+} profile_zone_t;
+
+/**
+ * @brief Statistics of one zone, times in core cycles.
+ */
+typedef struct {
+    uint32_t u32_calls;
+    uint32_t u32_min;
+    uint32_t u32_max;
+    uint64_t u64_total;
+} profile_stats_t;
+
+/**
+ * @brief Character output function (same signature as __io_putchar()).
+ */
+typedef int (*profile_putc_t)(int ch);
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Starts the cycle counter, measures the overhead and clears the
+ *        table.
+ *
+ * @return None
+ */
+void profile_init(void);
+
+/**
+ * @brief Clears the statistics of all zones.
+ *
+ * @return None
+ */
+void profile_reset(void);
+
+/**
+ * @brief Adds one pass to a zone (called by PROFILE_END()).
+ *
+ * @param zone       Zone
+ * @param u32_cycles Measured cycles including the overhead
+ * @return None
+ */
+void profile_add(profile_zone_t zone, uint32_t u32_cycles);
+
+/**
+ * @brief Returns the statistics of a zone.
+ *
+ * @param zone Zone
+ * @return Pointer into the table, NULL if the zone is invalid
+ */
+const profile_stats_t *profile_get(profile_zone_t zone);
+
+/**
+ * @brief Returns the name of a zone.
+ *
+ * @param zone Zone
+ * @return Name, "?" if the zone is invalid
+ */
+const char *profile_get_name(profile_zone_t zone);
+
+/**
+ * @brief Prints the table, one line per zone that ran:
+ *        "name calls min mean max mean_us".
+ *
+ * @param putc Character output (UART, ITM, ...)
+ * @return None
+ */
+void profile_dump(profile_putc_t putc);
+
+#endif /* PROFILE_PROFILE_H_ */
@@ -0,0 +1,175 @@
+/**
+ ******************************************************************************
+ * @file        pt.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Stackless coroutines (protothreads) for sequential driver code.
+ *
+ * @details
+ * A driver sequence such as "reset, wait 120 ms, send the init table,
+ * wait 5 ms" stays written top to bottom, but instead of a blocking
+ * delay it returns at every wait and continues behind it on the next
+ * call, e.g. from a scheduler task or a boot loop that drives several
+ * sequences at once. The resume point is the source line, stored in a
+ * pt_t together with the start of the current delay; the thread needs
+ * no stack of its own.
+ *
+ *     pt_state_t my_thread(pt_t *pt)
+ *     {
+ *         PT_BEGIN(pt);
+ *         start();
+ *         PT_DELAY_MS(pt, 120u);
+ *         PT_WAIT_UNTIL(pt, ready());
+ *         PT_END(pt);
+ *     }
+ *
+ * Rules of the switch based implementation:
+ *  - Local variables do not survive a wait, keep state in the pt_t
+ *    owner (static or context structure)
+ *  - At most one PT_ macro per source line, no switch statement around
+ *    a wait inside the thread
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - Wait for a condition, yield once, exit, restart
+ *  - Delays against the cycle counter (us) or the HAL tick (ms)
+ *  - Child threads (PT_SPAWN) and a blocking run to completion
+ *    (PT_RUN) for callers that keep the old behaviour
+ *
+ ******************************************************************************
+ */
+
+#ifndef PT_PT_H_
+#define PT_PT_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+#include "utils/utils.h"
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Result of one call of a thread.
+ */
+typedef enum {
+    PT_WAITING = 0,             /**< Blocked in a wait                   */
+    PT_YIELDED,                 /**< Gave up the CPU once                */
+    PT_EXITED,                  /**< Left with PT_EXIT()                 */
+    PT_ENDED                    /**< Reached PT_END(), restarts next call */
+} pt_state_t;
+
+/**
+ * @brief Continuation of one thread.
+ */
+typedef struct {
+    uint16_t u16_line;          /**< Resume point, 0 = start             */
+    uint32_t u32_start;         /**< Start of the running delay          */
+} pt_t;
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief Marks the intended fall through into a resume point
+ *        (-Wimplicit-fallthrough sees no comments inside macros).
+ */
+#if defined(__GNUC__) && (__GNUC__ >= 7)
+#define PT_FALLTHROUGH          __attribute__((fallthrough))
+#else
+#define PT_FALLTHROUGH
+#endif
+
+/**
+ * @brief Makes a thread start from the beginning.
+ */
+#define PT_INIT(pt)             ((pt)->u16_line = 0U)
+
+/**
+ * @brief First and last statement of a thread function returning
+ *        pt_state_t.
+ */
+#define PT_BEGIN(pt) \
+    { uint8_t u8_pt_yielded = 1U; (void)u8_pt_yielded; switch ((pt)->u16_line) { case 0U:
+
+#define PT_END(pt) \
+    } (pt)->u16_line = 0U; return PT_ENDED; }
+
+/**
+ * @brief Returns until the condition holds; it is evaluated on every call.
+ */
+#define PT_WAIT_UNTIL(pt, cond) \
+    do { \
+        (pt)->u16_line = (uint16_t)__LINE__; \
+        PT_FALLTHROUGH; \
+        case __LINE__: \
+        if (!(cond)) { \
+            return PT_WAITING; \
+        } \
+    } while (0)
+
+#define PT_WAIT_WHILE(pt, cond) PT_WAIT_UNTIL((pt), !(cond))
+
+/**
+ * @brief Returns once and continues behind it on the next call.
+ */
+#define PT_YIELD(pt) \
+    do { \
+        u8_pt_yielded = 0U; \
+        (pt)->u16_line = (uint16_t)__LINE__; \
+        PT_FALLTHROUGH; \
+        case __LINE__: \
+        if (u8_pt_yielded == 0U) { \
+            return PT_YIELDED; \
+        } \
+    } while (0)
+
+/**
+ * @brief Waits without blocking, us up to 2^32 core cycles (23 s at
+ *        180 MHz), ms against the HAL tick.
+ */
+#define PT_DELAY_US(pt, us) \
+    do { \
+        (pt)->u32_start = utils_now_cycles(); \
+        PT_WAIT_UNTIL((pt), utils_elapsed_us((pt)->u32_start) >= (uint32_t)(us)); \
+    } while (0)
+
+#define PT_DELAY_MS(pt, ms) \
+    do { \
+        (pt)->u32_start = HAL_GetTick(); \
+        PT_WAIT_UNTIL((pt), (HAL_GetTick() - (pt)->u32_start) >= (uint32_t)(ms)); \
+    } while (0)
+
+/**
+ * @brief Leaves the thread, the next call starts it again.
+ */
+#define PT_EXIT(pt) \
+    do { \
+        (pt)->u16_line = 0U; \
+        return PT_EXITED; \
+    } while (0)
+
+/**
+ * @brief Runs a child thread to its end, waiting whenever it waits.
+ *
+ * @param pt     Continuation of the caller
+ * @param child  Continuation of the child
+ * @param thread Call of the child thread, e.g. child_thread(child)
+ */
+#define PT_SPAWN(pt, child, thread) \
+    do { \
+        PT_INIT(child); \
+        PT_WAIT_WHILE((pt), (thread) < PT_EXITED); \
+    } while (0)
+
+/**
+ * @brief Calls a thread until it has ended (blocking, busy waiting).
+ *
+ * @param pt     Continuation
+ * @param thread Call of the thread
+ */
+#define PT_RUN(pt, thread) \
+    do { \
+        PT_INIT(pt); \
+        while ((thread) < PT_EXITED) { \
+        } \
+    } while (0)
+
+#endif /* PT_PT_H_ */
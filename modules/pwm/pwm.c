@@ -0,0 +1,367 @@
+/**
+ ******************************************************************************
+ * @file        pwm.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Multi-channel hardware PWM service: time base, channels,
+ *              atomic updates, staggering.
+ *
+ * Functionality:
+ * - Time base and channels through the HAL (PWM1 / PWM2, OCxPE), later
+ *   writes on register level so that any context may set a duty
+ * - Trailing channels store CCR = period - duty; all duties are kept in
+ *   the CCRx, there is no shadow copy to get out of step
+ * - Burst: DCR = CCR1 base, CCR1..CCRn burst length, the stream (normal
+ *   mode, no interrupt) is re-armed by pwm_write_all() and written by the
+ *   next update request; EN still set = burst pending
+ *
+ * Resources:
+ * - Timer of the user (tim_alloc), DMA2 S5 ch 6 (TIM1_UP) / S1 ch 7
+ *   (TIM8_UP) with the burst (dma_alloc)
+ ******************************************************************************
+ */
+
+#include "pwm.h"
+#include "dma_alloc/dma_alloc.h"
+#include "dvfs/dvfs.h"
+
+/* Static function prototypes ----------------------------------------------- */
+static uint32_t pwm_compare(const pwm_timer_t *pwm, uint32_t u32_index, uint32_t u32_duty);
+static uint32_t pwm_duty(const pwm_timer_t *pwm, uint32_t u32_index);
+static uint32_t pwm_burst_length(const pwm_timer_t *pwm);
+
+/* Public functions --------------------------------------------------------- */
+HAL_StatusTypeDef pwm_timebase(const TIM_TypeDef *instance, uint32_t u32_frequency_hz, uint32_t u32_min_steps,
+                               uint32_t *p_prescaler, uint32_t *p_period)
+{
+    uint32_t u32_clock = tim_alloc_get_clock(instance);
+    uint32_t u32_counts;
+    uint32_t u32_divider = 1u;
+
+    if ((u32_frequency_hz == 0u) || (u32_clock / u32_frequency_hz < u32_min_steps)) {
+        return HAL_ERROR;
+    }
+
+    /* Counts per period at prescaler 1, then the smallest divider that
+     * brings the period into 16 bit (even for the idle level of dvfs) */
+    u32_counts = (u32_clock + u32_frequency_hz / 2u) / u32_frequency_hz;
+    if ((instance != TIM2) && (instance != TIM5)) {
+        u32_divider = DVFS_EVEN_DIVIDER((u32_counts + 0xFFFFu) / 0x10000u);
+        if (u32_divider > 0x10000u) {
+            return HAL_ERROR;
+        }
+    }
+
+    *p_prescaler = u32_divider - 1u;
+    *p_period    = (u32_clock / u32_divider + u32_frequency_hz / 2u) / u32_frequency_hz - 1u;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef pwm_timer_init(pwm_timer_t *pwm, TIM_HandleTypeDef *handle, TIM_TypeDef *instance,
+                                 tim_alloc_owner_t owner, uint32_t u32_prescaler, uint32_t u32_period)
+{
+    if (tim_alloc_claim(instance, owner) != HAL_OK) {
+        return HAL_BUSY;
+    }
+
+    pwm->p_handle    = handle;
+    pwm->u8_channels = 0u;
+    pwm->u8_trailing = 0u;
+    pwm->u8_burst    = 0u;
+
+    handle->Instance               = instance;
+    handle->Init.Prescaler         = u32_prescaler;
+    handle->Init.Period            = u32_period;
+    handle->Init.CounterMode       = TIM_COUNTERMODE_UP;
+    handle->Init.ClockDivision     = TIM_CLOCKDIVISION_DIV1;
+    handle->Init.RepetitionCounter = 0u;
+    handle->Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_ENABLE;
+
+    if (HAL_TIM_PWM_Init(handle) != HAL_OK) {
+        tim_alloc_release(instance, owner);
+        return HAL_ERROR;
+    }
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef pwm_channel_init(pwm_timer_t *pwm, uint32_t u32_channel, const pwm_channel_config_t *config)
+{
+    TIM_OC_InitTypeDef tim_oc_init_struct;
+    uint32_t u32_index = PWM_CHANNEL_INDEX(u32_channel);
+
+    if ((u32_channel > TIM_CHANNEL_4) || ((u32_channel & 3u) != 0u) || (pwm->p_handle == NULL)) {
+        return HAL_ERROR;
+    }
+
+    if (config->align == PWM_ALIGN_TRAILING) {
+        pwm->u8_trailing |= (uint8_t)(1u << u32_index);
+    } else {
+        pwm->u8_trailing &= (uint8_t)~(1u << u32_index);
+    }
+
+    tim_oc_init_struct.OCMode       = (config->align == PWM_ALIGN_TRAILING) ? TIM_OCMODE_PWM2 : TIM_OCMODE_PWM1;
+    tim_oc_init_struct.Pulse        = pwm_compare(pwm, u32_index, config->u32_duty);
+    tim_oc_init_struct.OCPolarity   = config->u32_polarity;
+    tim_oc_init_struct.OCFastMode   = TIM_OCFAST_DISABLE;
+    tim_oc_init_struct.OCNPolarity  = TIM_OCNPOLARITY_HIGH;
+    tim_oc_init_struct.OCIdleState  = config->u32_idle;
+    tim_oc_init_struct.OCNIdleState = TIM_OCNIDLESTATE_RESET;
+
+    /* Also sets OCxPE: compares take effect at the next update event */
+    if ((HAL_TIM_PWM_ConfigChannel(pwm->p_handle, &tim_oc_init_struct, u32_channel) != HAL_OK) ||
+        (HAL_TIM_PWM_Start(pwm->p_handle, u32_channel) != HAL_OK)) {
+        return HAL_ERROR;
+    }
+    pwm->u8_channels |= (uint8_t)(1u << u32_index);
+
+    return HAL_OK;
+}
+
+uint32_t pwm_get_period(const pwm_timer_t *pwm)
+{
+    return pwm->p_handle->Instance->ARR + 1u;
+}
+
+void pwm_set_duty(pwm_timer_t *pwm, uint32_t u32_channel, uint32_t u32_duty)
+{
+    uint32_t u32_index = PWM_CHANNEL_INDEX(u32_channel);
+
+    (&pwm->p_handle->Instance->CCR1)[u32_index] = pwm_compare(pwm, u32_index, u32_duty);
+}
+
+HAL_StatusTypeDef pwm_set(pwm_timer_t *pwm, uint32_t u32_channel, uint32_t u32_frequency_hz,
+                          uint16_t u16_duty_permille)
+{
+    TIM_TypeDef *tim = pwm->p_handle->Instance;
+    uint32_t u32_duty[PWM_MAX_CHANNELS];
+    uint32_t u32_prescaler;
+    uint32_t u32_period;
+    uint32_t u32_old = tim->ARR + 1u;
+    uint32_t u32_index = PWM_CHANNEL_INDEX(u32_channel);
+
+    if (pwm_timebase(tim, u32_frequency_hz, 2u, &u32_prescaler, &u32_period) != HAL_OK) {
+        return HAL_ERROR;
+    }
+    if (u16_duty_permille > 1000u) {
+        u16_duty_permille = 1000u;
+    }
+
+    /* Same share of the new period for the other channels */
+    for (uint32_t i = 0u; i < PWM_MAX_CHANNELS; i++) {
+        u32_duty[i] = (uint32_t)(((uint64_t)pwm_duty(pwm, i) * (u32_period + 1u)) / u32_old);
+    }
+    u32_duty[u32_index] = (uint32_t)(((uint64_t)(u32_period + 1u) * u16_duty_permille) / 1000u);
+
+    /* No update event between the first and the last preload write */
+    tim->CR1 |= TIM_CR1_UDIS;
+    tim->PSC = u32_prescaler;
+    tim->ARR = u32_period;
+    for (uint32_t i = 0u; i < PWM_MAX_CHANNELS; i++) {
+        if ((pwm->u8_channels & (1u << i)) != 0u) {
+            (&tim->CCR1)[i] = pwm_compare(pwm, i, u32_duty[i]);
+        }
+    }
+    tim->CR1 &= ~TIM_CR1_UDIS;
+
+    pwm->p_handle->Init.Prescaler = u32_prescaler;
+    pwm->p_handle->Init.Period    = u32_period;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef pwm_write_all(pwm_timer_t *pwm, const uint32_t pu32_duty[PWM_MAX_CHANNELS])
+{
+    TIM_TypeDef *tim = pwm->p_handle->Instance;
+    DMA_Stream_TypeDef *stream = pwm->dma.Instance;
+    uint32_t u32_length;
+
+    if (!pwm->u8_burst) {
+        tim->CR1 |= TIM_CR1_UDIS;
+        for (uint32_t i = 0u; i < PWM_MAX_CHANNELS; i++) {
+            if ((pwm->u8_channels & (1u << i)) != 0u) {
+                (&tim->CCR1)[i] = pwm_compare(pwm, i, pu32_duty[i]);
+            }
+        }
+        tim->CR1 &= ~TIM_CR1_UDIS;
+        return HAL_OK;
+    }
+
+    /* The stream still waits for its update request */
+    if ((stream->CR & DMA_SxCR_EN) != 0u) {
+        return HAL_BUSY;
+    }
+
+    u32_length = pwm_burst_length(pwm);
+    for (uint32_t i = 0u; i < u32_length; i++) {
+        pwm->u32_burst[i] = ((pwm->u8_channels & (1u << i)) != 0u) ? pwm_compare(pwm, i, pu32_duty[i])
+                                                                   : (&tim->CCR1)[i];
+    }
+
+    __HAL_DMA_CLEAR_FLAG(&pwm->dma, __HAL_DMA_GET_TC_FLAG_INDEX(&pwm->dma) |
+                                    __HAL_DMA_GET_HT_FLAG_INDEX(&pwm->dma) |
+                                    __HAL_DMA_GET_TE_FLAG_INDEX(&pwm->dma) |
+                                    __HAL_DMA_GET_DME_FLAG_INDEX(&pwm->dma) |
+                                    __HAL_DMA_GET_FE_FLAG_INDEX(&pwm->dma));
+    tim->DCR     = TIM_DMABASE_CCR1 | ((u32_length - 1u) << TIM_DCR_DBL_Pos);
+    stream->NDTR = u32_length;
+    stream->CR  |= DMA_SxCR_EN;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef pwm_burst_enable(pwm_timer_t *pwm)
+{
+    TIM_TypeDef *tim = pwm->p_handle->Instance;
+    dma_alloc_request_t request;
+
+    if (pwm->u8_burst) {
+        return HAL_OK;
+    }
+
+    if (tim == TIM1) {
+        request = DMA_ALLOC_REQ_TIM1_UP;
+    } else if (tim == TIM8) {
+        request = DMA_ALLOC_REQ_TIM8_UP;
+    } else {
+        return HAL_ERROR;
+    }
+
+    if (dma_alloc_claim(&pwm->dma, request, DMA_ALLOC_LATENCY_EVENT, HEALTH_ISR_COUNT) != HAL_OK) {
+        return HAL_BUSY;
+    }
+
+    pwm->dma.Init.Direction           = DMA_MEMORY_TO_PERIPH;
+    pwm->dma.Init.PeriphInc           = DMA_PINC_DISABLE;
+    pwm->dma.Init.MemInc              = DMA_MINC_ENABLE;
+    pwm->dma.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+    pwm->dma.Init.MemDataAlignment    = DMA_MDATAALIGN_WORD;
+    pwm->dma.Init.Mode                = DMA_NORMAL;
+    pwm->dma.Init.FIFOMode            = DMA_FIFOMODE_DISABLE;
+    if (HAL_DMA_Init(&pwm->dma) != HAL_OK) {
+        dma_alloc_release(&pwm->dma);
+        return HAL_ERROR;
+    }
+
+    /* Fixed addresses, pwm_write_all() only re-arms the count */
+    pwm->dma.Instance->PAR  = (uint32_t)(uintptr_t)&tim->DMAR;
+    pwm->dma.Instance->M0AR = (uint32_t)(uintptr_t)pwm->u32_burst;
+    tim->DIER |= TIM_DIER_UDE;
+    pwm->u8_burst = 1u;
+
+    return HAL_OK;
+}
+
+void pwm_burst_disable(pwm_timer_t *pwm)
+{
+    if (!pwm->u8_burst) {
+        return;
+    }
+
+    pwm->p_handle->Instance->DIER &= ~TIM_DIER_UDE;
+    pwm->dma.Instance->CR &= ~DMA_SxCR_EN;
+    while ((pwm->dma.Instance->CR & DMA_SxCR_EN) != 0u) {
+    }
+    (void)HAL_DMA_DeInit(&pwm->dma);
+    dma_alloc_release(&pwm->dma);
+    pwm->u8_burst = 0u;
+}
+
+HAL_StatusTypeDef pwm_stagger(pwm_timer_t *const ap_timers[], uint8_t u8_count)
+{
+    const TIM_TypeDef *first;
+    uint32_t u32_period;
+    uint32_t u32_primask;
+
+    if (u8_count < 2u) {
+        return HAL_OK;
+    }
+
+    first = ap_timers[0]->p_handle->Instance;
+    u32_period = first->ARR + 1u;
+    for (uint8_t i = 1u; i < u8_count; i++) {
+        const TIM_TypeDef *tim = ap_timers[i]->p_handle->Instance;
+
+        if ((tim->ARR != first->ARR) || (tim->PSC != first->PSC) ||
+            (tim_alloc_get_clock(tim) != tim_alloc_get_clock(first))) {
+            return HAL_ERROR;
+        }
+    }
+
+    /* Timer i is i / count of a period behind timer 0 */
+    u32_primask = __get_PRIMASK();
+    __disable_irq();
+    for (uint8_t i = 0u; i < u8_count; i++) {
+        ap_timers[i]->p_handle->Instance->CR1 &= ~TIM_CR1_CEN;
+    }
+    for (uint8_t i = 0u; i < u8_count; i++) {
+        uint32_t u32_offset = (uint32_t)(((uint64_t)u32_period * i) / u8_count);
+
+        ap_timers[i]->p_handle->Instance->CNT = (u32_period - u32_offset) % u32_period;
+    }
+    for (uint8_t i = 0u; i < u8_count; i++) {
+        ap_timers[i]->p_handle->Instance->CR1 |= TIM_CR1_CEN;
+    }
+    __set_PRIMASK(u32_primask);
+
+    return HAL_OK;
+}
+
+/* Static functions --------------------------------------------------------- */
+/**
+ * @brief Compare value of an on-time.
+ *
+ * @param pwm       Instance
+ * @param u32_index Channel index
+ * @param u32_duty  On-time in counts
+ * @return CCRx value, saturated (period = always on)
+ */
+static uint32_t pwm_compare(const pwm_timer_t *pwm, uint32_t u32_index, uint32_t u32_duty)
+{
+    uint32_t u32_period = pwm->p_handle->Instance->ARR + 1u;
+
+    if (u32_duty > u32_period) {
+        u32_duty = u32_period;
+    }
+
+    return ((pwm->u8_trailing & (1u << u32_index)) != 0u) ? (u32_period - u32_duty) : u32_duty;
+}
+
+/**
+ * @brief On-time of a channel from its compare value.
+ *
+ * @param pwm       Instance
+ * @param u32_index Channel index
+ * @return On-time in counts
+ */
+static uint32_t pwm_duty(const pwm_timer_t *pwm, uint32_t u32_index)
+{
+    const TIM_TypeDef *tim = pwm->p_handle->Instance;
+    uint32_t u32_period = tim->ARR + 1u;
+    uint32_t u32_compare = (&tim->CCR1)[u32_index];
+
+    if (u32_compare > u32_period) {
+        u32_compare = u32_period;
+    }
+
+    return ((pwm->u8_trailing & (1u << u32_index)) != 0u) ? (u32_period - u32_compare) : u32_compare;
+}
+
+/**
+ * @brief Burst length: CCR1 up to the highest started channel.
+ *
+ * @param pwm Instance
+ * @return Registers per burst, 1..4
+ */
+static uint32_t pwm_burst_length(const pwm_timer_t *pwm)
+{
+    uint32_t u32_length = PWM_MAX_CHANNELS;
+
+    while ((u32_length > 1u) && ((pwm->u8_channels & (1u << (u32_length - 1u))) == 0u)) {
+        u32_length--;
+    }
+
+    return u32_length;
+}
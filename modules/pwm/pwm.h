@@ -0,0 +1,218 @@
+/**
+ ******************************************************************************
+ * @file        pwm.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the multi-channel hardware PWM service.
+ *
+ * @details
+ * One pwm_timer_t per timer: the service claims the timer (tim_alloc),
+ * sets up the time base with preloaded PSC / ARR / CCRx and starts the
+ * channels; the GPIO (alternate function, push-pull or open drain) stays
+ * with the user, as the wiring does. The fan PWM (TIM1 / TIM8 / TIM9) and
+ * the dot carrier (TIM1 CH2) are built on it.
+ *
+ * All values written to a running timer are taken at the next update
+ * event: a duty change never cuts a period, a frequency change never
+ * leaves the counter above a new, shorter ARR. pwm_set() changes the
+ * frequency and the duty in one call; the other channels of the timer
+ * keep their duty (their compares are rescaled) and the update event is
+ * held off (UDIS) until PSC, ARR and all CCRx are written.
+ *
+ * pwm_write_all() sets all channels of a timer in one step. With
+ * pwm_burst_enable() on TIM1 / TIM8 the compares go through the DMA
+ * burst of the timer: the update event requests DMAR, which writes CCR1
+ * .. CCRn in one burst right after it, so they all start in the same
+ * period without the CPU near the update. Without the burst (or on other
+ * timers) the write is bracketed with UDIS.
+ *
+ * Staggering, to spread the inrush current of several fans:
+ *  - On one timer: PWM_ALIGN_TRAILING channels switch on at the end of
+ *    the period (PWM2, CCR = period - duty), the leading ones at its
+ *    start; two fans on a timer overlap only above 50 % each
+ *  - Across timers: pwm_stagger() offsets the counters of timers with
+ *    the same period evenly (i * period / count)
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - Any timer of tim_alloc, CH1..CH4, frequency from the kernel clock
+ *    of the timer with the most steps that fit 16 / 32 bit
+ *  - Duty in counts or per mille, 0 and 100 % exact
+ *  - Atomic update of all channels: DMA burst (TIM1_UP / TIM8_UP of
+ *    dma_alloc) or UDIS
+ *  - Leading / trailing alignment, counter offsets between timers
+ *
+ * The dividers are rounded with DVFS_EVEN_DIVIDER() for the idle level
+ * of dvfs.
+ *
+ ******************************************************************************
+ */
+
+#ifndef PWM_PWM_H_
+#define PWM_PWM_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+#include "tim_alloc/tim_alloc.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief Channels per timer (CH1..CH4).
+ */
+#define PWM_MAX_CHANNELS        4U
+
+/**
+ * @brief Channel index of a HAL channel (TIM_CHANNEL_1 .. TIM_CHANNEL_4).
+ */
+#define PWM_CHANNEL_INDEX(channel)  ((channel) / 4U)
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Position of the on-time in the period.
+ */
+typedef enum {
+    PWM_ALIGN_LEADING = 0,      /**< On from the update event (PWM1)     */
+    PWM_ALIGN_TRAILING          /**< On until the update event (PWM2)    */
+} pwm_align_t;
+
+/**
+ * @brief Setup of one output channel.
+ */
+typedef struct {
+    uint32_t    u32_polarity;   /**< TIM_OCPOLARITY_HIGH / _LOW          */
+    uint32_t    u32_idle;       /**< TIM_OCIDLESTATE_SET / _RESET (TIM1 / TIM8) */
+    pwm_align_t align;
+    uint32_t    u32_duty;       /**< Initial on-time in counts           */
+} pwm_channel_config_t;
+
+/**
+ * @brief One timer, provided by the user.
+ */
+typedef struct {
+    TIM_HandleTypeDef *p_handle;    /**< HAL handle (user storage)        */
+    DMA_HandleTypeDef  dma;         /**< Burst stream                     */
+    uint32_t           u32_burst[PWM_MAX_CHANNELS]; /**< CCR1..CCRn of the burst */
+    uint8_t            u8_channels; /**< Started channels, bit per index  */
+    uint8_t            u8_trailing; /**< Trailing channels, bit per index */
+    uint8_t            u8_burst;    /**< DMA burst enabled                */
+} pwm_timer_t;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Computes prescaler and period for a frequency with the most
+ *        steps the counter of the timer allows.
+ *
+ * @param instance         Timer (kernel clock and counter width)
+ * @param u32_frequency_hz PWM frequency
+ * @param u32_min_steps    Fewest steps per period accepted
+ * @param p_prescaler      PSC value
+ * @param p_period         ARR value
+ * @return HAL_OK, HAL_ERROR if fewer than u32_min_steps are possible or
+ *         the frequency is too low
+ */
+HAL_StatusTypeDef pwm_timebase(const TIM_TypeDef *instance, uint32_t u32_frequency_hz, uint32_t u32_min_steps,
+                               uint32_t *p_prescaler, uint32_t *p_period);
+
+/**
+ * @brief Claims a timer and starts its time base (up counting, ARR
+ *        preload), no channel yet.
+ *
+ * @param pwm           Instance
+ * @param handle        HAL handle of the timer, lives as long as pwm
+ * @param instance      Timer
+ * @param owner         Owner for tim_alloc
+ * @param u32_prescaler PSC value
+ * @param u32_period    ARR value
+ * @return HAL_OK, HAL_BUSY if another owner holds the timer, HAL_ERROR
+ *         if the HAL init fails
+ */
+HAL_StatusTypeDef pwm_timer_init(pwm_timer_t *pwm, TIM_HandleTypeDef *handle, TIM_TypeDef *instance,
+                                 tim_alloc_owner_t owner, uint32_t u32_prescaler, uint32_t u32_period);
+
+/**
+ * @brief Sets up and starts one output channel (CCRx preload).
+ *
+ * @param pwm         Instance
+ * @param u32_channel TIM_CHANNEL_1 .. TIM_CHANNEL_4
+ * @param config      Channel setup
+ * @return HAL_OK, HAL_ERROR for an invalid channel or a HAL failure
+ */
+HAL_StatusTypeDef pwm_channel_init(pwm_timer_t *pwm, uint32_t u32_channel, const pwm_channel_config_t *config);
+
+/**
+ * @brief Returns the steps per period (ARR + 1).
+ *
+ * @param pwm Instance
+ * @return Steps, 100 % duty
+ */
+uint32_t pwm_get_period(const pwm_timer_t *pwm);
+
+/**
+ * @brief Sets the on-time of one channel from the next period on, any
+ *        context.
+ *
+ * @param pwm         Instance
+ * @param u32_channel TIM_CHANNEL_1 .. TIM_CHANNEL_4
+ * @param u32_duty    On-time in counts, saturated at pwm_get_period()
+ * @return None
+ */
+void pwm_set_duty(pwm_timer_t *pwm, uint32_t u32_channel, uint32_t u32_duty);
+
+/**
+ * @brief Sets frequency and duty of one channel in one update event; the
+ *        other channels keep their duty. Main loop.
+ *
+ * @param pwm                Instance
+ * @param u32_channel        TIM_CHANNEL_1 .. TIM_CHANNEL_4
+ * @param u32_frequency_hz   PWM frequency of the timer
+ * @param u16_duty_permille  0..1000
+ * @return HAL_OK, HAL_ERROR if the frequency does not fit the timer
+ *         (nothing changed)
+ */
+HAL_StatusTypeDef pwm_set(pwm_timer_t *pwm, uint32_t u32_channel, uint32_t u32_frequency_hz,
+                          uint16_t u16_duty_permille);
+
+/**
+ * @brief Sets the on-time of all started channels from the same period
+ *        on.
+ *
+ * @param pwm          Instance
+ * @param pu32_duty    On-time in counts per channel index (CH1 first),
+ *                     entries of channels not started are ignored
+ * @return HAL_OK, HAL_BUSY if the previous burst has not been written
+ *         yet (nothing changed, retry next period)
+ */
+HAL_StatusTypeDef pwm_write_all(pwm_timer_t *pwm, const uint32_t pu32_duty[PWM_MAX_CHANNELS]);
+
+/**
+ * @brief Routes pwm_write_all() through the DMA burst of the timer.
+ *
+ * @param pwm Instance (TIM1 or TIM8)
+ * @return HAL_OK, HAL_BUSY if the update stream is taken (dot fade, esd
+ *         refresh), HAL_ERROR for a timer without update request
+ */
+HAL_StatusTypeDef pwm_burst_enable(pwm_timer_t *pwm);
+
+/**
+ * @brief Back to UDIS bracketed writes, frees the stream.
+ *
+ * @param pwm Instance
+ * @return None
+ */
+void pwm_burst_disable(pwm_timer_t *pwm);
+
+/**
+ * @brief Spreads the periods of several timers evenly: timer i starts
+ *        i / u8_count of a period after timer 0.
+ *
+ * Stops the counters for a few cycles (outputs hold their level) and
+ * restarts them back to back.
+ *
+ * @param ap_timers Instances, same kernel clock, PSC and ARR
+ * @param u8_count  Number of instances
+ * @return HAL_OK, HAL_ERROR if the periods differ
+ */
+HAL_StatusTypeDef pwm_stagger(pwm_timer_t *const ap_timers[], uint8_t u8_count);
+
+#endif /* PWM_PWM_H_ */
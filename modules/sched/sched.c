@@ -0,0 +1,305 @@
+/**
+ ******************************************************************************
+ * @file        sched.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Cooperative run-to-completion task scheduler
+ *
+ * Functionality:
+ * - Static task table, the ready task with the lowest priority value
+ *   runs next (ties: lower id)
+ * - Periodic release grid in microseconds, independent of the start
+ *   time of the task (no drift)
+ * - Event release by a pending flag written by sched_trigger()
+ * - Execution time and release jitter from the microsecond time base
+ * - Tasks with a deadline supervisor step are bracketed by
+ *   deadline_begin() / deadline_end(), the lateness is start - release
+ * - Idle check and sleep with interrupts masked, so a trigger between
+ *   the check and the sleep still wakes the core; the sleep is
+ *   idle_sleep() up to the next periodic release (tickless once
+ *   idle_init() was called)
+ *
+ * Resources:
+ * - SysTick (read only, HAL tick and counter)
+ ******************************************************************************
+ */
+
+#include "sched.h"
+#include <idle/idle.h>
+#include <deadline/deadline.h>
+#include <bkptrace/bkptrace.h>
+
+/* Private Preprocessor Defines -------------------------------------------- */
+/**
+ * @brief Marker for "no task ready".
+ */
+#define SCHED_NONE              0xFFU
+
+/**
+ * @brief Longest period, keeps release differences in the signed range.
+ */
+#define SCHED_MAX_PERIOD_MS     (0x7FFFFFFFUL / 1000UL)
+
+/* Private Type Definitions ------------------------------------------------ */
+/**
+ * @brief One task table entry.
+ */
+typedef struct {
+    sched_task_t      task;
+    void             *context;
+    uint32_t          u32_period_us;    /**< 0 = event task               */
+    uint32_t          u32_release_us;   /**< Next periodic release        */
+    volatile uint32_t u32_trigger_us;   /**< Time of the pending trigger  */
+    volatile uint8_t  u8_pending;       /**< Set by sched_trigger()       */
+    uint8_t           u8_priority;
+    uint8_t           u8_deadline;      /**< Supervisor step, DEADLINE_NONE */
+    sched_stats_t     stats;
+} sched_entry_t;
+
+/* Static module variables -------------------------------------------------- */
+static sched_entry_t g_sched_tasks[SCHED_MAX_TASKS];
+static uint8_t g_u8_sched_count = 0u;
+
+/* Static function prototypes ---------------------------------------------- */
+static uint8_t sched_select(uint32_t u32_now_us);
+static uint32_t sched_next_release_ms(uint32_t u32_now_us);
+
+/* Public functions --------------------------------------------------------- */
+void sched_init(void)
+{
+    g_u8_sched_count = 0u;
+}
+
+HAL_StatusTypeDef sched_add(sched_task_t task, void *context, uint32_t u32_period_ms,
+                            uint8_t u8_priority, uint8_t *pu8_id)
+{
+    sched_entry_t *entry;
+
+    if ((task == NULL) || (g_u8_sched_count >= SCHED_MAX_TASKS) ||
+        (u32_period_ms > SCHED_MAX_PERIOD_MS)) {
+        return HAL_ERROR;
+    }
+
+    entry = &g_sched_tasks[g_u8_sched_count];
+    entry->task           = task;
+    entry->context        = context;
+    entry->u32_period_us  = u32_period_ms * 1000u;
+    entry->u32_release_us = sched_now_us() + entry->u32_period_us;
+    entry->u32_trigger_us = 0u;
+    entry->u8_pending     = 0u;
+    entry->u8_priority    = u8_priority;
+    entry->u8_deadline    = DEADLINE_NONE;
+    entry->stats          = (sched_stats_t){0};
+
+    if (pu8_id != NULL) {
+        *pu8_id = g_u8_sched_count;
+    }
+
+    /* Visible to sched_trigger() only when complete */
+    __DMB();
+    g_u8_sched_count++;
+
+    return HAL_OK;
+}
+
+void sched_trigger(uint8_t u8_id)
+{
+    sched_entry_t *entry;
+
+    if (u8_id >= g_u8_sched_count) {
+        return;
+    }
+
+    entry = &g_sched_tasks[u8_id];
+
+    /* Keep the first trigger time for the jitter */
+    if (!entry->u8_pending) {
+        entry->u32_trigger_us = sched_now_us();
+        __DMB();
+        entry->u8_pending = 1u;
+    }
+}
+
+HAL_StatusTypeDef sched_set_deadline(uint8_t u8_id, uint8_t u8_deadline_id)
+{
+    if (u8_id >= g_u8_sched_count) {
+        return HAL_ERROR;
+    }
+
+    g_sched_tasks[u8_id].u8_deadline = u8_deadline_id;
+
+    return HAL_OK;
+}
+
+uint8_t sched_run_once(void)
+{
+    uint32_t u32_start_us = sched_now_us();
+    uint8_t u8_id = sched_select(u32_start_us);
+    sched_entry_t *entry;
+    uint32_t u32_release_us;
+    uint32_t u32_elapsed_us;
+
+    if (u8_id == SCHED_NONE) {
+        return 0u;
+    }
+
+    entry = &g_sched_tasks[u8_id];
+
+    if (entry->u8_pending) {
+        /* Clear first: a trigger during the run releases the task again */
+        entry->u8_pending = 0u;
+        __DMB();
+        u32_release_us = entry->u32_trigger_us;
+    } else {
+        u32_release_us = entry->u32_release_us;
+        entry->u32_release_us += entry->u32_period_us;
+
+        /* Skip releases that already passed completely */
+        if ((int32_t)(u32_start_us - entry->u32_release_us) >= 0) {
+            uint32_t u32_missed = (u32_start_us - entry->u32_release_us) / entry->u32_period_us + 1u;
+
+            entry->u32_release_us += u32_missed * entry->u32_period_us;
+            entry->stats.u32_overruns += u32_missed;
+        }
+    }
+
+    BKPTRACE_EVENT(BKPTRACE_EV_SCHED_BEGIN, u8_id);
+    deadline_begin(entry->u8_deadline,
+                   ((int32_t)(u32_start_us - u32_release_us) > 0) ? (u32_start_us - u32_release_us) : 0u);
+    entry->task(entry->context);
+    deadline_end(entry->u8_deadline);
+
+    u32_elapsed_us = sched_now_us() - u32_start_us;
+    BKPTRACE_EVENT(BKPTRACE_EV_SCHED_END,
+                   ((uint32_t)u8_id << 24) | ((u32_elapsed_us > 0xFFFFFFu) ? 0xFFFFFFu : u32_elapsed_us));
+
+    entry->stats.u32_runs++;
+    entry->stats.u32_last_us = u32_elapsed_us;
+    if (u32_elapsed_us > entry->stats.u32_wcet_us) {
+        entry->stats.u32_wcet_us = u32_elapsed_us;
+    }
+    if (((int32_t)(u32_start_us - u32_release_us) > 0) &&
+        ((u32_start_us - u32_release_us) > entry->stats.u32_jitter_us)) {
+        entry->stats.u32_jitter_us = u32_start_us - u32_release_us;
+    }
+
+    return 1u;
+}
+
+void sched_run(void)
+{
+    while (1) {
+        if (sched_run_once()) {
+            continue;
+        }
+
+#if SCHED_IDLE_WFI
+        /* A pending interrupt ends the sleep even with PRIMASK set; the
+           tickless idle sleeps until the next periodic release */
+        __disable_irq();
+        uint32_t u32_now_us = sched_now_us();
+        if (sched_select(u32_now_us) == SCHED_NONE) {
+            idle_sleep(sched_next_release_ms(u32_now_us));
+        }
+        __enable_irq();
+#endif
+    }
+}
+
+HAL_StatusTypeDef sched_get_stats(uint8_t u8_id, sched_stats_t *stats)
+{
+    if (u8_id >= g_u8_sched_count) {
+        return HAL_ERROR;
+    }
+
+    *stats = g_sched_tasks[u8_id].stats;
+
+    return HAL_OK;
+}
+
+void sched_reset_stats(void)
+{
+    for (uint8_t i = 0u; i < g_u8_sched_count; i++) {
+        g_sched_tasks[i].stats = (sched_stats_t){0};
+    }
+}
+
+uint32_t sched_now_us(void)
+{
+    uint32_t u32_tick;
+    uint32_t u32_value;
+    uint32_t u32_cycles_per_us = SystemCoreClock / 1000000u;
+
+    uint32_t u32_load = SysTick->LOAD;
+
+    /* Tick and counter of the same millisecond */
+    do {
+        u32_tick  = uwTick;
+        u32_value = SysTick->VAL;
+    } while (u32_tick != uwTick);
+
+    /* Counter already reloaded, tick interrupt not served yet (called
+       with masked interrupts or from a higher priority interrupt) */
+    if ((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) && (u32_value > (u32_load / 2u))) {
+        u32_tick += uwTickFreq;
+    }
+
+    return u32_tick * 1000u + (u32_load - u32_value) / u32_cycles_per_us;
+}
+
+/* Static module functions -------------------------------------------------- */
+/**
+ * @brief Finds the ready task with the highest priority.
+ *
+ * @param u32_now_us Current time
+ * @return Task id, SCHED_NONE if no task is ready
+ */
+static uint8_t sched_select(uint32_t u32_now_us)
+{
+    uint8_t u8_best = SCHED_NONE;
+
+    for (uint8_t i = 0u; i < g_u8_sched_count; i++) {
+        const sched_entry_t *entry = &g_sched_tasks[i];
+        uint8_t u8_ready = entry->u8_pending ||
+                           ((entry->u32_period_us != 0u) &&
+                            ((int32_t)(u32_now_us - entry->u32_release_us) >= 0));
+
+        if (u8_ready && ((u8_best == SCHED_NONE) ||
+                         (entry->u8_priority < g_sched_tasks[u8_best].u8_priority))) {
+            u8_best = i;
+        }
+    }
+
+    return u8_best;
+}
+
+/**
+ * @brief Returns the time until the next periodic release, rounded up.
+ *
+ * @param u32_now_us Current time
+ * @return Time in ms, IDLE_MAX_SLEEP_MS if only event tasks exist
+ */
+static uint32_t sched_next_release_ms(uint32_t u32_now_us)
+{
+    uint32_t u32_min_us = IDLE_MAX_SLEEP_MS * 1000u;
+
+    for (uint8_t i = 0u; i < g_u8_sched_count; i++) {
+        const sched_entry_t *entry = &g_sched_tasks[i];
+        int32_t i32_left;
+
+        if (entry->u32_period_us == 0u) {
+            continue;
+        }
+
+        i32_left = (int32_t)(entry->u32_release_us - u32_now_us);
+        if (i32_left <= 0) {
+            return 0u;
+        }
+        if ((uint32_t)i32_left < u32_min_us) {
+            u32_min_us = (uint32_t)i32_left;
+        }
+    }
+
+    return (u32_min_us + 999u) / 1000u;
+}
@@ -0,0 +1,165 @@
+/**
+ ******************************************************************************
+ * @file        sched.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the cooperative task scheduler.
+ *
+ * @details
+ * Run-to-completion scheduler for the main loop. Tasks are plain
+ * functions that return quickly and never block; the scheduler always
+ * starts the ready task with the highest priority, so a slow display
+ * task delays but never starves a control or sensor task. Interrupts
+ * stay the place for hard deadlines (e.g. the fan PI controller on
+ * TIM6), tasks replace the blocking delays of the main loops.
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - Up to SCHED_MAX_TASKS tasks with priority 0 (highest) .. 255
+ *  - Periodic tasks: fixed release grid in milliseconds, releases that
+ *    are missed completely are skipped and counted
+ *  - Event tasks (period 0): released by sched_trigger(), also from an
+ *    interrupt
+ *  - Per task: runs, last and worst-case execution time (WCET), worst
+ *    release jitter (start - release) in microseconds
+ *  - Critical tasks supervised by the deadline module (sched_set_deadline())
+ *  - Idle: idle_sleep() until the next periodic release or interrupt,
+ *    tickless if the application called idle_init()
+ *
+ * Time base is the HAL tick (1 kHz SysTick) refined with the SysTick
+ * counter to 1 us, no timer is used.
+ *
+ * Example:
+ *
+ *     sched_init();
+ *     sched_add(sensor_task, NULL, 20u, 1u, &sensor_id);
+ *     sched_add(display_task, NULL, 100u, 2u, NULL);
+ *     sched_run();
+ *
+ ******************************************************************************
+ */
+
+#ifndef SCHED_SCHED_H_
+#define SCHED_SCHED_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief Maximum number of tasks.
+ */
+#define SCHED_MAX_TASKS     12U
+
+/**
+ * @brief Highest and lowest task priority.
+ */
+#define SCHED_PRIORITY_HIGHEST  0U
+#define SCHED_PRIORITY_LOWEST   255U
+
+/**
+ * @brief 1 to sleep (idle_sleep()) while no task is ready.
+ */
+#ifndef SCHED_IDLE_WFI
+#define SCHED_IDLE_WFI      1
+#endif
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Task function, runs to completion.
+ */
+typedef void (*sched_task_t)(void *context);
+
+/**
+ * @brief Statistics of one task, all times in microseconds.
+ */
+typedef struct {
+    uint32_t u32_runs;          /**< Completed runs                        */
+    uint32_t u32_last_us;       /**< Execution time of the last run        */
+    uint32_t u32_wcet_us;       /**< Worst-case execution time             */
+    uint32_t u32_jitter_us;     /**< Worst start - release                 */
+    uint32_t u32_overruns;      /**< Periodic releases skipped (late task) */
+} sched_stats_t;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Removes all tasks.
+ *
+ * @return None
+ */
+void sched_init(void);
+
+/**
+ * @brief Adds a task.
+ *
+ * A periodic task is released for the first time one period after
+ * sched_add().
+ *
+ * @param task           Task function
+ * @param context        Passed to the task
+ * @param u32_period_ms  Period in ms, 0 = event task (sched_trigger())
+ * @param u8_priority    0 (highest) .. 255
+ * @param pu8_id         Receives the task id, may be NULL
+ * @return HAL_OK, HAL_ERROR if the table is full or task is NULL
+ */
+HAL_StatusTypeDef sched_add(sched_task_t task, void *context, uint32_t u32_period_ms,
+                            uint8_t u8_priority, uint8_t *pu8_id);
+
+/**
+ * @brief Brackets every run of a task with deadline_begin() /
+ *        deadline_end() of a supervisor step.
+ *
+ * @param u8_id          Task id
+ * @param u8_deadline_id Step of deadline_add(), DEADLINE_NONE = none
+ * @return HAL_OK, HAL_ERROR if the task id is invalid
+ */
+HAL_StatusTypeDef sched_set_deadline(uint8_t u8_id, uint8_t u8_deadline_id);
+
+/**
+ * @brief Releases a task once (interrupt safe). A task triggered again
+ *        before it ran runs only once.
+ *
+ * @param u8_id Task id
+ * @return None
+ */
+void sched_trigger(uint8_t u8_id);
+
+/**
+ * @brief Runs the ready task with the highest priority, if any.
+ *
+ * @return 1 if a task ran, 0 if none was ready
+ */
+uint8_t sched_run_once(void);
+
+/**
+ * @brief Runs the scheduler forever, sleeping while no task is ready.
+ *
+ * @return Does not return
+ */
+void sched_run(void);
+
+/**
+ * @brief Copies the statistics of a task.
+ *
+ * @param u8_id Task id
+ * @param stats Destination
+ * @return HAL_OK, HAL_ERROR if the id is invalid
+ */
+HAL_StatusTypeDef sched_get_stats(uint8_t u8_id, sched_stats_t *stats);
+
+/**
+ * @brief Clears the statistics of all tasks.
+ *
+ * @return None
+ */
+void sched_reset_stats(void);
+
+/**
+ * @brief Returns the scheduler time base.
+ *
+ * @return Microseconds (wraps after 71 minutes, use differences)
+ */
+uint32_t sched_now_us(void);
+
+#endif /* SCHED_SCHED_H_ */
@@ -0,0 +1,386 @@
+/**
+ ******************************************************************************
+ * @file        screenshot.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Screenshot export: DMA2D copy or GRAM read back, mirror packets
+ *
+ * Functionality:
+ * - Slice buffer shared by both sources: the GRAM read (dummy byte and
+ *   3 bytes per pixel) is converted in place into RGB565
+ * - GRAM read as a SPI5 bus client, chained in the SPI5 RX interrupt:
+ *   column address, page address, Memory Read, pixels; a grant that finds
+ *   an LCD transfer running is passed on and requested again
+ * - Slices are encoded with mirror_pack_rect() and sent as
+ *   USB_CDC_BLOCK_MIRROR blocks, closed with a mirror end packet
+ *
+ * Resources:
+ * - SPI5 through the bus arbitration of the LCD driver (second client
+ *   next to the gyro), LCD CS / DC
+ * - FRAMEBUFFER_SNAPSHOT_ADDR in the SDRAM (framebuffer backend)
+ ******************************************************************************
+ */
+
+#include "screenshot.h"
+#include "framebuffer/framebuffer.h"
+#include "lcd/lcd.h"
+#include "mirror/mirror.h"
+#include "usb_cdc/usb_cdc.h"
+#include <lcd/ILI9341_STM32_Driver.h>
+#include <string.h>
+
+/* Private Preprocessor Defines -------------------------------------------- */
+/**
+ * @brief Screen size and bytes of one GRAM read (dummy byte, RGB666).
+ */
+#define SCREENSHOT_WIDTH            FRAMEBUFFER_WIDTH
+#define SCREENSHOT_HEIGHT           FRAMEBUFFER_HEIGHT
+#define SCREENSHOT_SLICE_PIXELS     (SCREENSHOT_WIDTH * SCREENSHOT_ROWS)
+#define SCREENSHOT_READ_SIZE        (1U + 3U * SCREENSHOT_SLICE_PIXELS)
+
+/**
+ * @brief Panel commands of the read.
+ */
+#define SCREENSHOT_CMD_CASET        0x2AU
+#define SCREENSHOT_CMD_PASET        0x2BU
+#define SCREENSHOT_CMD_RAMRD        0x2EU
+
+#if (SCREENSHOT_HEIGHT % SCREENSHOT_ROWS) != 0U
+#error "SCREENSHOT_ROWS must divide the screen height"
+#endif
+
+/* Private Type Definitions ------------------------------------------------ */
+typedef enum {
+    SCREENSHOT_STATE_IDLE = 0,
+    SCREENSHOT_STATE_SLICE,         /* Slice to be read or converted      */
+    SCREENSHOT_STATE_SEND,          /* Packets of the slice               */
+    SCREENSHOT_STATE_END            /* End packet                         */
+} screenshot_state_t;
+
+typedef enum {
+    SCREENSHOT_READ_NONE = 0,
+    SCREENSHOT_READ_REQUESTED,
+    SCREENSHOT_READ_DONE,
+    SCREENSHOT_READ_DECLINED,
+    SCREENSHOT_READ_FAILED
+} screenshot_read_t;
+
+/* Static module variables -------------------------------------------------- */
+static screenshot_state_t g_screenshot_state;
+static volatile screenshot_read_t g_screenshot_read;
+static uint8_t g_u8_screenshot_attached;
+
+/**
+ * @brief Slice: GRAM bytes, afterwards RGB565 pixels from the start.
+ */
+static uint16_t g_u16_screenshot_slice[(SCREENSHOT_READ_SIZE + 1U) / 2U];
+
+/**
+ * @brief Copy of the frame (framebuffer backend), first row of the slice,
+ *        next pixel of the slice to send, sequence number, packets.
+ */
+static const framebuffer_pixel_t *g_p_screenshot_copy;
+static uint16_t g_u16_screenshot_row;
+static uint32_t g_u32_screenshot_offset;
+static uint16_t g_u16_screenshot_seq;
+static uint16_t g_u16_screenshot_packets;
+
+/**
+ * @brief Step of the GRAM read, command bytes, cycle counter at the grant.
+ */
+static uint8_t g_u8_screenshot_step;
+static uint8_t g_u8_screenshot_cmd[4];
+static uint32_t g_u32_screenshot_grant_cycles;
+
+static uint8_t g_u8_screenshot_packet[MIRROR_PACKET_SIZE];
+static screenshot_stats_t g_screenshot_stats;
+
+/* Private function prototypes ---------------------------------------------- */
+static HAL_StatusTypeDef screenshot_fill_slice(void);
+static void screenshot_send(void);
+static void screenshot_grant(ILI9341_Bus_Client_t *client);
+static void screenshot_done(ILI9341_Bus_Client_t *client);
+static void screenshot_read_step(void);
+
+static ILI9341_Bus_Client_t g_screenshot_client = {
+    .Grant     = screenshot_grant,
+    .Done      = screenshot_done,
+    .Max_Clock = SCREENSHOT_READ_CLOCK,
+};
+
+/* Public functions --------------------------------------------------------- */
+HAL_StatusTypeDef screenshot_start(void)
+{
+    if (g_screenshot_state != SCREENSHOT_STATE_IDLE) {
+        return HAL_BUSY;
+    }
+    if (!usb_cdc_is_open()) {
+        return HAL_ERROR;
+    }
+
+    if (lcd_get_backend() == LCD_BACKEND_FRAMEBUFFER) {
+        g_p_screenshot_copy = framebuffer_snapshot();
+    } else {
+        if ((LCD_WIDTH != SCREENSHOT_WIDTH) || (LCD_HEIGHT != SCREENSHOT_HEIGHT)) {
+            return HAL_ERROR;
+        }
+        if (!g_u8_screenshot_attached) {
+            if (ILI9341_Bus_Attach(&g_screenshot_client) != HAL_OK) {
+                return HAL_BUSY;
+            }
+            g_u8_screenshot_attached = 1u;
+        }
+        g_p_screenshot_copy = NULL;
+    }
+
+    g_u16_screenshot_seq++;
+    g_u16_screenshot_packets = 0u;
+    g_u16_screenshot_row = 0u;
+    g_u32_screenshot_offset = 0u;
+    g_screenshot_read = SCREENSHOT_READ_NONE;
+    g_screenshot_state = SCREENSHOT_STATE_SLICE;
+
+    return HAL_OK;
+}
+
+void screenshot_poll(void)
+{
+    if (g_screenshot_state == SCREENSHOT_STATE_SLICE) {
+        if (screenshot_fill_slice() != HAL_OK) {
+            return;
+        }
+        g_screenshot_state = SCREENSHOT_STATE_SEND;
+    }
+    if (g_screenshot_state != SCREENSHOT_STATE_IDLE) {
+        screenshot_send();
+    }
+}
+
+uint8_t screenshot_is_busy(void)
+{
+    return g_screenshot_state != SCREENSHOT_STATE_IDLE;
+}
+
+void screenshot_get_stats(screenshot_stats_t *stats)
+{
+    *stats = g_screenshot_stats;
+}
+
+/* Private functions -------------------------------------------------------- */
+/**
+ * @brief Brings the slice at g_u16_screenshot_row into the buffer as
+ *        RGB565.
+ *
+ * @return HAL_OK when it is there, HAL_BUSY while the read is waiting or
+ *         running, HAL_ERROR after a failed read (screenshot ended)
+ */
+static HAL_StatusTypeDef screenshot_fill_slice(void)
+{
+    const uint8_t *pu8_bytes = (const uint8_t *)g_u16_screenshot_slice;
+
+    if (g_p_screenshot_copy != NULL) {
+        const framebuffer_pixel_t *p_row = &g_p_screenshot_copy[(uint32_t)g_u16_screenshot_row * SCREENSHOT_WIDTH];
+
+        if (g_u16_screenshot_row == 0u) {
+            framebuffer_wait();     /* Copy complete */
+        }
+        for (uint32_t i = 0u; i < SCREENSHOT_SLICE_PIXELS; i++) {
+            g_u16_screenshot_slice[i] = framebuffer_colour(p_row[i]);
+        }
+        return HAL_OK;
+    }
+
+    switch (g_screenshot_read) {
+    case SCREENSHOT_READ_NONE:
+    case SCREENSHOT_READ_DECLINED:
+        /* Only from an idle queue: never inside an LCD write */
+        if (ILI9341_DMA_Busy()) {
+            return HAL_BUSY;
+        }
+        memset(g_u16_screenshot_slice, 0, sizeof(g_u16_screenshot_slice));
+        g_screenshot_read = SCREENSHOT_READ_REQUESTED;
+        ILI9341_Bus_Request(&g_screenshot_client);
+        return HAL_BUSY;
+
+    case SCREENSHOT_READ_REQUESTED:
+        return HAL_BUSY;
+
+    case SCREENSHOT_READ_DONE:
+        break;
+
+    default:
+        g_screenshot_stats.u32_aborted++;
+        g_screenshot_state = SCREENSHOT_STATE_IDLE;
+        return HAL_ERROR;
+    }
+
+    /* In place: pixel i is written below the bytes it is read from */
+    for (uint32_t i = 0u; i < SCREENSHOT_SLICE_PIXELS; i++) {
+        const uint8_t *pu8_rgb = &pu8_bytes[1u + 3u * i];
+
+        g_u16_screenshot_slice[i] = (uint16_t)(((uint16_t)(pu8_rgb[0] & 0xF8u) << 8) |
+                                               ((uint16_t)(pu8_rgb[1] & 0xFCu) << 3) |
+                                               (pu8_rgb[2] >> 3));
+    }
+    g_screenshot_read = SCREENSHOT_READ_NONE;
+    return HAL_OK;
+}
+
+/**
+ * @brief Sends up to SCREENSHOT_PACKETS_PER_POLL packets of the slice,
+ *        moves on to the next slice or the end packet.
+ */
+static void screenshot_send(void)
+{
+    framebuffer_rect_t rect = { 0u, g_u16_screenshot_row, SCREENSHOT_WIDTH, SCREENSHOT_ROWS };
+    mirror_source_t source = { g_u16_screenshot_slice, SCREENSHOT_WIDTH, 1u };
+
+    for (uint32_t u32_packet = 0u; u32_packet < SCREENSHOT_PACKETS_PER_POLL; u32_packet++) {
+        uint32_t u32_pixels = 0u;
+        uint16_t u16_length;
+        HAL_StatusTypeDef status;
+
+        if (g_screenshot_state == SCREENSHOT_STATE_END) {
+            u16_length = mirror_pack_end(g_u8_screenshot_packet, g_u16_screenshot_seq, g_u16_screenshot_packets);
+        } else {
+            u16_length = mirror_pack_rect(g_u8_screenshot_packet, g_u16_screenshot_seq, &rect, &source,
+                                          g_u32_screenshot_offset, &u32_pixels);
+        }
+
+        status = usb_cdc_send_block(USB_CDC_BLOCK_MIRROR, g_u8_screenshot_packet, u16_length);
+        if (status == HAL_BUSY) {
+            g_screenshot_stats.u32_retries++;
+            return;
+        }
+        if (status != HAL_OK) {
+            g_screenshot_stats.u32_aborted++;
+            g_screenshot_state = SCREENSHOT_STATE_IDLE;
+            return;
+        }
+        g_screenshot_stats.u32_packets++;
+        g_screenshot_stats.u32_bytes += u16_length;
+
+        if (g_screenshot_state == SCREENSHOT_STATE_END) {
+            g_screenshot_stats.u32_shots++;
+            g_screenshot_state = SCREENSHOT_STATE_IDLE;
+            return;
+        }
+
+        g_u16_screenshot_packets++;
+        g_u32_screenshot_offset += u32_pixels;
+        if (g_u32_screenshot_offset >= SCREENSHOT_SLICE_PIXELS) {
+            g_u32_screenshot_offset = 0u;
+            g_u16_screenshot_row += SCREENSHOT_ROWS;
+            g_screenshot_state = (g_u16_screenshot_row < SCREENSHOT_HEIGHT) ? SCREENSHOT_STATE_SLICE
+                                                                            : SCREENSHOT_STATE_END;
+            /* The next slice is read by the next poll */
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Bus granted (interrupt context): starts the read, or passes the
+ *        bus on if an LCD transfer is between two of its blocks.
+ *
+ * @param client Screenshot client
+ * @return None
+ */
+static void screenshot_grant(ILI9341_Bus_Client_t *client)
+{
+    (void)client;
+
+    if (ILI9341_DMA_Busy()) {
+        g_screenshot_stats.u32_declined++;
+        g_screenshot_read = SCREENSHOT_READ_DECLINED;
+        return;
+    }
+
+    g_u32_screenshot_grant_cycles = DWT->CYCCNT;
+    g_u8_screenshot_step = 0u;
+    LCD_CS_LOW();
+    screenshot_read_step();
+}
+
+/**
+ * @brief End of a transfer of the read (SPI5 RX DMA interrupt).
+ *
+ * @param client Screenshot client
+ * @return None
+ */
+static void screenshot_done(ILI9341_Bus_Client_t *client)
+{
+    (void)client;
+
+    g_u8_screenshot_step++;
+    screenshot_read_step();
+}
+
+/**
+ * @brief Starts the transfer of the current step; after the pixels the
+ *        panel is deselected and the bus released.
+ */
+static void screenshot_read_step(void)
+{
+    uint16_t u16_last_row = g_u16_screenshot_row + SCREENSHOT_ROWS - 1u;
+    uint8_t *pu8_data = g_u8_screenshot_cmd;
+    uint16_t u16_size = 1u;
+
+    switch (g_u8_screenshot_step) {
+    case 0u:
+        LCD_DC_COMMAND();
+        g_u8_screenshot_cmd[0] = SCREENSHOT_CMD_CASET;
+        break;
+
+    case 1u:
+        LCD_DC_DATA();
+        g_u8_screenshot_cmd[0] = 0u;
+        g_u8_screenshot_cmd[1] = 0u;
+        g_u8_screenshot_cmd[2] = (uint8_t)((SCREENSHOT_WIDTH - 1u) >> 8);
+        g_u8_screenshot_cmd[3] = (uint8_t)(SCREENSHOT_WIDTH - 1u);
+        u16_size = 4u;
+        break;
+
+    case 2u:
+        LCD_DC_COMMAND();
+        g_u8_screenshot_cmd[0] = SCREENSHOT_CMD_PASET;
+        break;
+
+    case 3u:
+        LCD_DC_DATA();
+        g_u8_screenshot_cmd[0] = (uint8_t)(g_u16_screenshot_row >> 8);
+        g_u8_screenshot_cmd[1] = (uint8_t)g_u16_screenshot_row;
+        g_u8_screenshot_cmd[2] = (uint8_t)(u16_last_row >> 8);
+        g_u8_screenshot_cmd[3] = (uint8_t)u16_last_row;
+        u16_size = 4u;
+        break;
+
+    case 4u:
+        LCD_DC_COMMAND();
+        g_u8_screenshot_cmd[0] = SCREENSHOT_CMD_RAMRD;
+        break;
+
+    case 5u:
+        LCD_DC_DATA();
+        pu8_data = (uint8_t *)g_u16_screenshot_slice;
+        u16_size = SCREENSHOT_READ_SIZE;
+        break;
+
+    default: {
+        uint32_t u32_hold_us = (DWT->CYCCNT - g_u32_screenshot_grant_cycles) / (SystemCoreClock / 1000000u);
+
+        LCD_CS_HIGH();
+        if (u32_hold_us > g_screenshot_stats.u32_max_hold_us) {
+            g_screenshot_stats.u32_max_hold_us = u32_hold_us;
+        }
+        g_screenshot_read = SCREENSHOT_READ_DONE;
+        return;
+    }
+    }
+
+    if (ILI9341_Bus_Transfer(pu8_data, u16_size) != HAL_OK) {
+        LCD_CS_HIGH();
+        g_screenshot_read = SCREENSHOT_READ_FAILED;
+    }
+}
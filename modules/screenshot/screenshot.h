@@ -0,0 +1,113 @@
+/**
+ ******************************************************************************
+ * @file        screenshot.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the screenshot export over USB.
+ *
+ * @details
+ * Sends what the display shows to the host, run length encoded in the
+ * packets of the display mirror (mirror_pack_rect(), USB_CDC_BLOCK_MIRROR
+ * blocks), so modules/mirror/mirror_view.py writes it as an image. The
+ * screen is taken in slices of SCREENSHOT_ROWS rows:
+ *
+ *  - Framebuffer backend: screenshot_start() copies the shown frame with
+ *    the DMA2D (framebuffer_snapshot()), the slices are converted from
+ *    the copy; the display is never held.
+ *  - SPI backend: every slice is read back from the panel memory (GRAM)
+ *    with Memory Read (0x2E) as a client of the SPI5 arbitration
+ *    (ILI9341_Bus_Request()). The panel answers on MISO (PF8, shared
+ *    with the gyro) with one dummy byte, then 3 bytes per pixel (6 bits
+ *    per colour, left aligned) at no more than SCREENSHOT_READ_CLOCK.
+ *    The bus is only taken between two transfers of the LCD queue, never
+ *    inside one (the address window of a running write would be lost);
+ *    a slice holds the LCD for about 9 ms, less than one panel refresh.
+ *    The slices show the screen at successive moments.
+ *
+ * Encoding and sending run in screenshot_poll(), a few packets per call;
+ * a full USB buffer retries the packet, a closed port ends the
+ * screenshot. A uniform screen takes about 3 KB, a busy one up to the
+ * 153 KB of the raw frame.
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - Both lcd backends, portrait orientation of lcd_init() (240 x 320)
+ *  - Bounded work per poll, no display stall beyond one slice
+ *  - Sequence number per screenshot, counters with the longest LCD hold
+ *
+ ******************************************************************************
+ */
+
+#ifndef SCREENSHOT_SCREENSHOT_H_
+#define SCREENSHOT_SCREENSHOT_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief Rows per slice, a divisor of the screen height.
+ */
+#define SCREENSHOT_ROWS             8U
+
+/**
+ * @brief SCK limit of the panel for reads (ILI9341 serial read cycle
+ *        150 ns).
+ */
+#define SCREENSHOT_READ_CLOCK       6000000U
+
+/**
+ * @brief Packets sent per screenshot_poll() at most.
+ */
+#ifndef SCREENSHOT_PACKETS_PER_POLL
+#define SCREENSHOT_PACKETS_PER_POLL 4U
+#endif
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Counters since the first screenshot_start().
+ */
+typedef struct {
+    uint32_t u32_shots;         /**< Screenshots sent completely             */
+    uint32_t u32_aborted;       /**< Screenshots ended by a closed port      */
+    uint32_t u32_packets;       /**< Packets sent                            */
+    uint32_t u32_bytes;         /**< Packet bytes sent                       */
+    uint32_t u32_retries;       /**< Packets held back, USB buffers full     */
+    uint32_t u32_declined;      /**< Grants passed on, LCD transfer running  */
+    uint32_t u32_max_hold_us;   /**< Longest GRAM read of a slice            */
+} screenshot_stats_t;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Starts a screenshot (framebuffer backend: takes the copy).
+ *
+ * @return HAL_OK, HAL_BUSY while one is running or SPI5 has no room for
+ *         another client, HAL_ERROR if the USB port is closed or the
+ *         display is rotated
+ */
+HAL_StatusTypeDef screenshot_start(void);
+
+/**
+ * @brief Reads, encodes and sends the next part (main loop).
+ *
+ * @return None
+ */
+void screenshot_poll(void);
+
+/**
+ * @brief Returns whether a screenshot is running.
+ *
+ * @return 1 running, 0 idle
+ */
+uint8_t screenshot_is_busy(void);
+
+/**
+ * @brief Copies the counters.
+ *
+ * @param stats Destination
+ * @return None
+ */
+void screenshot_get_stats(screenshot_stats_t *stats);
+
+#endif /* SCREENSHOT_SCREENSHOT_H_ */
@@ -0,0 +1,306 @@
+/**
+ ******************************************************************************
+ * @file        sdcard.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       SDIO block driver (HAL_SD, DMA transfers, polled completion)
+ *
+ * Functionality:
+ * - Identification by HAL_SD_Init() at 400 kHz, then the data clock of
+ *   SDCARD_CLOCK_DIV and optionally the 4 bit bus
+ * - One DMA handle serves as hdmatx and hdmarx, HAL_SD sets its
+ *   direction for every transfer
+ * - A write is over when HAL_SD is ready again and CMD13 reports the
+ *   transfer state, i.e. the card has programmed the blocks
+ *
+ * Resources:
+ * - SDIO, SDIO_IRQHandler, SDIO request of dma_alloc (DMA2 Stream6
+ *   Channel 4, else Stream3)
+ * - PC8 (D0), PC12 (CK), PD2 (CMD), with SDCARD_WIDE_BUS PC9..PC11 (AF12)
+ ******************************************************************************
+ */
+
+#include "sdcard.h"
+#include "clock/clock.h"
+#include "dma_alloc/dma_alloc.h"
+#include <string.h>
+
+/* Static module variables -------------------------------------------------- */
+/**
+ * @brief Card handle and its DMA stream.
+ */
+static SD_HandleTypeDef g_sdcard_sd;
+static DMA_HandleTypeDef g_sdcard_dma;
+
+/**
+ * @brief 1 after a successful init, blocks of the card.
+ */
+static uint8_t g_u8_sdcard_ready = 0u;
+static uint32_t g_u32_sdcard_blocks = 0u;
+
+/**
+ * @brief Write in progress: blocks and start tick.
+ */
+static uint32_t g_u32_sdcard_write_count = 0u;
+static uint32_t g_u32_sdcard_write_tick = 0u;
+
+static sdcard_stats_t g_sdcard_stats;
+
+/* Static function prototypes ---------------------------------------------- */
+static void sdcard_init_gpio(void);
+static HAL_StatusTypeDef sdcard_init_dma(void);
+static HAL_StatusTypeDef sdcard_wait(uint32_t u32_start_tick);
+
+/* Public functions --------------------------------------------------------- */
+HAL_StatusTypeDef sdcard_init(void)
+{
+    HAL_SD_CardInfoTypeDef card_info;
+
+    g_u8_sdcard_ready        = 0u;
+    g_u32_sdcard_blocks      = 0u;
+    g_u32_sdcard_write_count = 0u;
+    memset(&g_sdcard_stats, 0, sizeof(g_sdcard_stats));
+
+    /* SDIOCLK from PLLQ = 7 must not exceed 48 MHz, 180 MHz gives 51 */
+    if (clock_get_profile() != CLOCK_PROFILE_168MHZ) {
+        return HAL_ERROR;
+    }
+
+    sdcard_init_gpio();
+    __HAL_RCC_SDIO_CLK_ENABLE();
+
+    if (sdcard_init_dma() != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    memset(&g_sdcard_sd, 0, sizeof(g_sdcard_sd));
+    g_sdcard_sd.Instance                 = SDIO;
+    g_sdcard_sd.Init.ClockEdge           = SDIO_CLOCK_EDGE_RISING;
+    g_sdcard_sd.Init.ClockBypass         = SDIO_CLOCK_BYPASS_DISABLE;
+    g_sdcard_sd.Init.ClockPowerSave      = SDIO_CLOCK_POWER_SAVE_DISABLE;
+    g_sdcard_sd.Init.BusWide             = SDIO_BUS_WIDE_1B;
+    /* No hardware flow control (F4 errata sheet), the DMA keeps up anyway */
+    g_sdcard_sd.Init.HardwareFlowControl = SDIO_HARDWARE_FLOW_CONTROL_DISABLE;
+    g_sdcard_sd.Init.ClockDiv            = SDCARD_CLOCK_DIV;
+    __HAL_LINKDMA(&g_sdcard_sd, hdmatx, g_sdcard_dma);
+    __HAL_LINKDMA(&g_sdcard_sd, hdmarx, g_sdcard_dma);
+
+    HAL_NVIC_SetPriority(SDIO_IRQn, SDCARD_IRQ_PRIORITY, 0u);
+    HAL_NVIC_EnableIRQ(SDIO_IRQn);
+
+    if (HAL_SD_Init(&g_sdcard_sd) != HAL_OK) {
+        return HAL_ERROR;
+    }
+#if SDCARD_WIDE_BUS
+    if (HAL_SD_ConfigWideBusOperation(&g_sdcard_sd, SDIO_BUS_WIDE_4B) != HAL_OK) {
+        return HAL_ERROR;
+    }
+#endif
+    if ((HAL_SD_GetCardInfo(&g_sdcard_sd, &card_info) != HAL_OK) ||
+        (card_info.LogBlockSize != SDCARD_BLOCK_SIZE)) {
+        return HAL_ERROR;
+    }
+
+    g_u32_sdcard_blocks = card_info.LogBlockNbr;
+    g_u8_sdcard_ready   = 1u;
+
+    return HAL_OK;
+}
+
+uint32_t sdcard_get_blocks(void)
+{
+    return g_u32_sdcard_blocks;
+}
+
+HAL_StatusTypeDef sdcard_read(uint32_t u32_block, void *data, uint32_t u32_count)
+{
+    HAL_StatusTypeDef status;
+
+    if (!g_u8_sdcard_ready || (((uintptr_t)data & 3u) != 0u)) {
+        return HAL_ERROR;
+    }
+    status = sdcard_poll();
+    if (status == HAL_BUSY) {
+        return HAL_BUSY;
+    }
+
+    if (HAL_SD_ReadBlocks_DMA(&g_sdcard_sd, (uint8_t *)data, u32_block, u32_count) != HAL_OK) {
+        g_sdcard_stats.u32_errors++;
+        return HAL_ERROR;
+    }
+    if (sdcard_wait(HAL_GetTick()) != HAL_OK) {
+        g_sdcard_stats.u32_errors++;
+        return HAL_ERROR;
+    }
+
+    g_sdcard_stats.u32_blocks_read += u32_count;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef sdcard_write_start(uint32_t u32_block, const void *data, uint32_t u32_count)
+{
+    if (!g_u8_sdcard_ready || (((uintptr_t)data & 3u) != 0u) || (u32_count == 0u)) {
+        return HAL_ERROR;
+    }
+    if (g_u32_sdcard_write_count != 0u) {
+        return HAL_BUSY;
+    }
+
+    /* HAL_SD only reads the buffer, its prototype is not const */
+    if (HAL_SD_WriteBlocks_DMA(&g_sdcard_sd, (uint8_t *)(uintptr_t)data, u32_block, u32_count) != HAL_OK) {
+        g_sdcard_stats.u32_errors++;
+        return HAL_ERROR;
+    }
+
+    g_u32_sdcard_write_count = u32_count;
+    g_u32_sdcard_write_tick  = HAL_GetTick();
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef sdcard_poll(void)
+{
+    uint32_t u32_busy_ms;
+
+    if (!g_u8_sdcard_ready) {
+        return HAL_ERROR;
+    }
+    if (g_u32_sdcard_write_count == 0u) {
+        return HAL_OK;
+    }
+
+    u32_busy_ms = HAL_GetTick() - g_u32_sdcard_write_tick;
+
+    if ((g_sdcard_sd.State == HAL_SD_STATE_READY) && (g_sdcard_sd.ErrorCode == HAL_SD_ERROR_NONE)) {
+        if (HAL_SD_GetCardState(&g_sdcard_sd) == HAL_SD_CARD_TRANSFER) {
+            g_sdcard_stats.u32_blocks_written += g_u32_sdcard_write_count;
+            if (u32_busy_ms > g_sdcard_stats.u32_busy_max_ms) {
+                g_sdcard_stats.u32_busy_max_ms = u32_busy_ms;
+            }
+            g_u32_sdcard_write_count = 0u;
+            return HAL_OK;
+        }
+    } else if (g_sdcard_sd.State == HAL_SD_STATE_READY) {
+        /* CRC, timeout or DMA error, reported by the interrupt */
+        g_sdcard_stats.u32_errors++;
+        g_u32_sdcard_write_count = 0u;
+        return HAL_ERROR;
+    }
+
+    if (u32_busy_ms > SDCARD_TIMEOUT_MS) {
+        (void)HAL_SD_Abort(&g_sdcard_sd);
+        g_sdcard_stats.u32_errors++;
+        g_u32_sdcard_write_count = 0u;
+        return HAL_ERROR;
+    }
+
+    return HAL_BUSY;
+}
+
+const sdcard_stats_t *sdcard_get_stats(void)
+{
+    return &g_sdcard_stats;
+}
+
+/* Static module functions -------------------------------------------------- */
+/**
+ * @brief Configures the SDIO pins, pull-ups on CMD and the data lines.
+ *
+ * @return None
+ */
+static void sdcard_init_gpio(void)
+{
+    GPIO_InitTypeDef gpio_init_struct;
+
+    __HAL_RCC_GPIOC_CLK_ENABLE();
+    __HAL_RCC_GPIOD_CLK_ENABLE();
+
+    gpio_init_struct.Mode      = GPIO_MODE_AF_PP;
+    gpio_init_struct.Pull      = GPIO_PULLUP;
+    gpio_init_struct.Speed     = GPIO_SPEED_FREQ_VERY_HIGH;
+    gpio_init_struct.Alternate = GPIO_AF12_SDIO;
+
+#if SDCARD_WIDE_BUS
+    gpio_init_struct.Pin = GPIO_PIN_8 | GPIO_PIN_9 | GPIO_PIN_10 | GPIO_PIN_11;
+#else
+    gpio_init_struct.Pin = GPIO_PIN_8;
+#endif
+    HAL_GPIO_Init(GPIOC, &gpio_init_struct);
+
+    gpio_init_struct.Pin = GPIO_PIN_2;
+    HAL_GPIO_Init(GPIOD, &gpio_init_struct);
+
+    /* The clock is driven, no pull-up */
+    gpio_init_struct.Pull = GPIO_NOPULL;
+    gpio_init_struct.Pin  = GPIO_PIN_12;
+    HAL_GPIO_Init(GPIOC, &gpio_init_struct);
+}
+
+/**
+ * @brief Claims the SDIO stream (critical: the FIFO must never run empty
+ *        or over) and configures it: words, bursts of four, the SDIO ends
+ *        the transfer (peripheral flow control).
+ *
+ * @return HAL_OK or HAL_ERROR
+ */
+static HAL_StatusTypeDef sdcard_init_dma(void)
+{
+    if (dma_alloc_claim(&g_sdcard_dma, DMA_ALLOC_REQ_SDIO, DMA_ALLOC_LATENCY_CRITICAL,
+                        HEALTH_ISR_COUNT) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    g_sdcard_dma.Init.Direction           = DMA_MEMORY_TO_PERIPH;
+    g_sdcard_dma.Init.PeriphInc           = DMA_PINC_DISABLE;
+    g_sdcard_dma.Init.MemInc              = DMA_MINC_ENABLE;
+    g_sdcard_dma.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+    g_sdcard_dma.Init.MemDataAlignment    = DMA_MDATAALIGN_WORD;
+    g_sdcard_dma.Init.Mode                = DMA_PFCTRL;
+    g_sdcard_dma.Init.FIFOMode            = DMA_FIFOMODE_ENABLE;
+    g_sdcard_dma.Init.FIFOThreshold       = DMA_FIFO_THRESHOLD_FULL;
+    g_sdcard_dma.Init.MemBurst            = DMA_MBURST_INC4;
+    g_sdcard_dma.Init.PeriphBurst         = DMA_PBURST_INC4;
+
+    if (HAL_DMA_Init(&g_sdcard_dma) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    HAL_NVIC_SetPriority(dma_alloc_get_irqn(&g_sdcard_dma), SDCARD_IRQ_PRIORITY, 0u);
+    HAL_NVIC_EnableIRQ(dma_alloc_get_irqn(&g_sdcard_dma));
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Waits for the end of a read and the transfer state of the card.
+ *
+ * @param u32_start_tick Tick of the start
+ * @return HAL_OK, HAL_ERROR for a failed transfer or SDCARD_TIMEOUT_MS
+ */
+static HAL_StatusTypeDef sdcard_wait(uint32_t u32_start_tick)
+{
+    while (g_sdcard_sd.State == HAL_SD_STATE_BUSY) {
+        if ((HAL_GetTick() - u32_start_tick) > SDCARD_TIMEOUT_MS) {
+            (void)HAL_SD_Abort(&g_sdcard_sd);
+            return HAL_ERROR;
+        }
+    }
+    if (g_sdcard_sd.ErrorCode != HAL_SD_ERROR_NONE) {
+        return HAL_ERROR;
+    }
+
+    while (HAL_SD_GetCardState(&g_sdcard_sd) != HAL_SD_CARD_TRANSFER) {
+        if ((HAL_GetTick() - u32_start_tick) > SDCARD_TIMEOUT_MS) {
+            return HAL_ERROR;
+        }
+    }
+
+    return HAL_OK;
+}
+
+void SDIO_IRQHandler(void)
+{
+    HAL_SD_IRQHandler(&g_sdcard_sd);
+}
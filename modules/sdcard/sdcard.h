@@ -0,0 +1,135 @@
+/**
+ ******************************************************************************
+ * @file        sdcard.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the SDIO block driver.
+ *
+ * @details
+ * Reads and writes 512 byte blocks of an SD card on the SDIO interface,
+ * all data moves by DMA. A write is started and returns; sdcard_poll()
+ * from the main loop reports when the transfer and the programming of
+ * the card are over, so the caller never waits for the card (a card
+ * may stay busy for 100 ms and more now and then). Reads wait, they are
+ * meant for the mount (partition table, directory, FAT).
+ *
+ * The discovery board has no card slot, the card is wired to the pins:
+ * PC8 (D0), PC12 (CK), PD2 (CMD) and for the 4 bit bus PC9 (D1),
+ * PC10 (D2), PC11 (D3), all with pull-ups. PC10 is LTDC R2 of the
+ * framebuffer and PC9 the SDA of the optional I2C3 of env_sensor; with
+ * one of them only the 1 bit bus is possible. The SDIO clock comes from
+ * PLLQ and needs the 168 MHz profile (48 MHz), like usb_cdc.
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - SDSC, SDHC and SDXC cards, block addresses only
+ *  - 1 or 4 bit bus (SDCARD_WIDE_BUS), 24 MHz data clock
+ *  - One DMA stream for both directions, one transfer at a time
+ *  - Counters of the transfers and errors
+ *
+ ******************************************************************************
+ */
+
+#ifndef SDCARD_SDCARD_H_
+#define SDCARD_SDCARD_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+#include "irq/irq.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief 1 for the 4 bit bus (PC9..PC11 in use), 0 for D0 only.
+ */
+#ifndef SDCARD_WIDE_BUS
+#define SDCARD_WIDE_BUS         0
+#endif
+
+/**
+ * @brief Data clock divider: 48 MHz / (SDCARD_CLOCK_DIV + 2).
+ */
+#define SDCARD_CLOCK_DIV        0U
+
+/**
+ * @brief Block size in bytes.
+ */
+#define SDCARD_BLOCK_SIZE       512U
+
+/**
+ * @brief Longest wait of sdcard_read() and the init in ms.
+ */
+#define SDCARD_TIMEOUT_MS       250U
+
+/**
+ * @brief NVIC priority of SDIO and its DMA stream (no kernel calls).
+ */
+#define SDCARD_IRQ_PRIORITY     IRQ_CLASS_STORAGE
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Counters since sdcard_init().
+ */
+typedef struct {
+    uint32_t u32_blocks_read;
+    uint32_t u32_blocks_written;
+    uint32_t u32_errors;        /**< Failed transfers (CRC, timeout, DMA) */
+    uint32_t u32_busy_max_ms;   /**< Longest programming time of a write  */
+} sdcard_stats_t;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Configures the pins, SDIO and its DMA stream and identifies the
+ *        card (waits up to about one second).
+ *
+ * @return HAL_OK, HAL_ERROR without a card, with a card that does not
+ *         answer, without a free SDIO stream or outside the 168 MHz profile
+ */
+HAL_StatusTypeDef sdcard_init(void);
+
+/**
+ * @brief Returns the number of blocks of the card.
+ *
+ * @return Blocks, 0 before sdcard_init()
+ */
+uint32_t sdcard_get_blocks(void);
+
+/**
+ * @brief Reads blocks and waits until they are there (init, mount).
+ *
+ * @param u32_block First block
+ * @param data      Word aligned buffer of u32_count blocks
+ * @param u32_count Number of blocks
+ * @return HAL_OK, HAL_BUSY while a write is running, HAL_ERROR
+ */
+HAL_StatusTypeDef sdcard_read(uint32_t u32_block, void *data, uint32_t u32_count);
+
+/**
+ * @brief Starts writing blocks and returns; the buffer must stay
+ *        untouched until sdcard_poll() no longer returns HAL_BUSY.
+ *
+ * @param u32_block First block
+ * @param data      Word aligned buffer of u32_count blocks, not CCM RAM
+ * @param u32_count Number of blocks
+ * @return HAL_OK, HAL_BUSY while the last transfer is running, HAL_ERROR
+ */
+HAL_StatusTypeDef sdcard_write_start(uint32_t u32_block, const void *data, uint32_t u32_count);
+
+/**
+ * @brief State of the last write (main loop, sends CMD13 while the card
+ *        is programming).
+ *
+ * @return HAL_BUSY while the transfer or the programming runs, HAL_OK
+ *         once the blocks are on the card, HAL_ERROR once for a failed
+ *         write (then idle)
+ */
+HAL_StatusTypeDef sdcard_poll(void);
+
+/**
+ * @brief Returns the counters.
+ *
+ * @return Counters
+ */
+const sdcard_stats_t *sdcard_get_stats(void);
+
+#endif /* SDCARD_SDCARD_H_ */
@@ -0,0 +1,675 @@
+/**
+ ******************************************************************************
+ * @file        sdlog.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Append-only SD card log in a preallocated file
+ *
+ * Functionality:
+ * - Mount: partition table or superfloppy, FAT32 boot sector, root
+ *   directory chain, cluster chain of the file (one cached FAT sector);
+ *   all reads go through two pool blocks, freed before logging starts
+ * - The end of the log is the first sector without SDLOG_MAGIC, found
+ *   with about log2(sectors) reads; the session of the sector before it
+ *   plus one is the session of this boot
+ * - Adding and flushing run with interrupts masked; a full sector goes
+ *   into a queue (sync_queue_t) and belongs to sdlog_task() from then on,
+ *   so the writer and the task never share one
+ * - sdlog_task() writes one sector per transfer and frees its block
+ * - SDLOG_COMPRESS: the sector being filled is a tscomp block, a record
+ *   the block refuses closes the sector and starts the next one
+ *
+ * Resources:
+ * - modules/sdcard (SDIO, DMA2 Stream6), up to SDLOG_MAX_SECTORS large
+ *   blocks of the shared pool
+ ******************************************************************************
+ */
+
+#include "sdlog.h"
+#include "sdcard/sdcard.h"
+#include "pool/pool.h"
+#include "sync/sync.h"
+#include "tscomp/tscomp.h"
+#include "dlog/dlog.h"
+#include <string.h>
+
+/* Private Preprocessor Defines -------------------------------------------- */
+/**
+ * @brief FAT32 boot sector and directory entry fields (byte offsets).
+ */
+#define SDLOG_BPB_BYTES_PER_SECTOR  11U
+#define SDLOG_BPB_SECTORS_PER_CLUST 13U
+#define SDLOG_BPB_RESERVED_SECTORS  14U
+#define SDLOG_BPB_FATS              16U
+#define SDLOG_BPB_FAT_SIZE_32       36U
+#define SDLOG_BPB_ROOT_CLUSTER      44U
+#define SDLOG_BPB_FS_TYPE_32        82U
+#define SDLOG_MBR_PARTITION         446U
+#define SDLOG_DIR_ENTRY_SIZE        32U
+#define SDLOG_DIR_ATTR              11U
+#define SDLOG_DIR_CLUSTER_HIGH      20U
+#define SDLOG_DIR_CLUSTER_LOW       26U
+#define SDLOG_DIR_SIZE              28U
+
+/**
+ * @brief FAT32 entry mask and end of chain, clusters of the root
+ *        directory searched at most.
+ */
+#define SDLOG_FAT_MASK              0x0FFFFFFFUL
+#define SDLOG_FAT_EOC               0x0FFFFFF8UL
+#define SDLOG_ROOT_MAX_CLUSTERS     16U
+
+#if (8U + SDLOG_RECORDS_PER_SECTOR * 12U) != SDCARD_BLOCK_SIZE
+#error "sdlog_sector_t must fill one block"
+#endif
+
+#if (SDCARD_BLOCK_SIZE > POOL_LARGE_SIZE) || (SDLOG_MAX_SECTORS >= POOL_LARGE_BLOCKS)
+#error "A sector must fit into a large pool block, and other users need one"
+#endif
+
+#if (8U + SDLOG_PACKED_BLOCK_SIZE) != SDCARD_BLOCK_SIZE
+#error "sdlog_packed_sector_t must fill one block"
+#endif
+
+#if (SDLOG_MAX_SECTORS & (SDLOG_MAX_SECTORS - 1U)) != 0
+#error "SDLOG_MAX_SECTORS must be a power of two"
+#endif
+
+/* Static module variables -------------------------------------------------- */
+/**
+ * @brief Sector being filled (NULL: none yet), blocks held in total.
+ */
+static sdlog_sector_t * volatile g_p_sdlog_fill = NULL;
+static volatile uint8_t g_u8_sdlog_held = 0u;
+
+#if SDLOG_COMPRESS
+/**
+ * @brief Encoder of the sector being filled.
+ */
+static tscomp_t g_sdlog_packer;
+#endif
+
+/**
+ * @brief Full sectors: sdlog_add() and sdlog_flush() push, sdlog_task() pops.
+ */
+static sdlog_sector_t *g_p_sdlog_full[SDLOG_MAX_SECTORS];
+static sync_queue_t g_sdlog_queue = SYNC_QUEUE_INIT(g_p_sdlog_full);
+
+/**
+ * @brief Sector of the next or running write (main loop only), 1 while
+ *        the write runs.
+ */
+static sdlog_sector_t *g_p_sdlog_writing = NULL;
+static uint8_t g_u8_sdlog_busy = 0u;
+static uint8_t g_u8_sdlog_retries = 0u;
+
+/**
+ * @brief First block and sectors of the file, next sector to write,
+ *        1 while the file takes records.
+ */
+static uint32_t g_u32_sdlog_file_lba = 0u;
+static uint32_t g_u32_sdlog_file_sectors = 0u;
+static uint32_t g_u32_sdlog_next = 0u;
+static volatile uint8_t g_u8_sdlog_open = 0u;
+
+/**
+ * @brief Record number of the session.
+ */
+static uint16_t g_u16_sdlog_sequence = 0u;
+
+/**
+ * @brief Sector buffer and cached FAT sector of the mount (pool blocks).
+ */
+static uint8_t *g_pu8_sdlog_sector = NULL;
+static uint8_t *g_pu8_sdlog_fat = NULL;
+
+/**
+ * @brief Volume layout during the mount, block of the cached FAT sector.
+ */
+static uint32_t g_u32_sdlog_fat_lba = 0u;
+static uint32_t g_u32_sdlog_data_lba = 0u;
+static uint32_t g_u32_sdlog_cluster_sectors = 0u;
+static uint32_t g_u32_sdlog_fat_cached = 0u;
+
+static sdlog_stats_t g_sdlog_stats;
+
+/* Static function prototypes ---------------------------------------------- */
+static HAL_StatusTypeDef sdlog_mount(void);
+static HAL_StatusTypeDef sdlog_find_file(uint32_t u32_root_cluster, uint32_t *pu32_cluster, uint32_t *pu32_size);
+static HAL_StatusTypeDef sdlog_check_chain(uint32_t u32_cluster, uint32_t u32_clusters);
+static HAL_StatusTypeDef sdlog_fat_next(uint32_t u32_cluster, uint32_t *pu32_next);
+static HAL_StatusTypeDef sdlog_find_end(void);
+static sdlog_sector_t *sdlog_open_sector(void);
+static void sdlog_close_sector(void);
+static uint32_t sdlog_sector_records(const sdlog_sector_t *sector);
+static void sdlog_write_failed(void);
+static void sdlog_release(sdlog_sector_t *sector, uint8_t u8_written);
+static void sdlog_discard(void);
+static uint32_t sdlog_le16(const uint8_t *pu8_data);
+static uint32_t sdlog_le32(const uint8_t *pu8_data);
+
+/* Public functions --------------------------------------------------------- */
+HAL_StatusTypeDef sdlog_init(void)
+{
+    HAL_StatusTypeDef status;
+
+    g_u8_sdlog_open = 0u;
+    sdlog_discard();
+    memset(&g_sdlog_stats, 0, sizeof(g_sdlog_stats));
+
+    /* Borrowed for the mount only, logging takes them right back */
+    g_pu8_sdlog_sector = pool_shared_alloc(SDCARD_BLOCK_SIZE);
+    g_pu8_sdlog_fat    = pool_shared_alloc(SDCARD_BLOCK_SIZE);
+    status = ((g_pu8_sdlog_sector != NULL) && (g_pu8_sdlog_fat != NULL) && (sdcard_init() == HAL_OK) &&
+              (sdlog_mount() == HAL_OK) && (sdlog_find_end() == HAL_OK)) ? HAL_OK : HAL_ERROR;
+    pool_shared_free(g_pu8_sdlog_sector);
+    pool_shared_free(g_pu8_sdlog_fat);
+    g_pu8_sdlog_sector = NULL;
+    g_pu8_sdlog_fat    = NULL;
+    if (status != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    g_u8_sdlog_retries   = 0u;
+    g_u16_sdlog_sequence = 0u;
+
+    g_sdlog_stats.u32_free_sectors = g_u32_sdlog_file_sectors - g_u32_sdlog_next;
+    if (g_sdlog_stats.u32_free_sectors == 0u) {
+        return HAL_ERROR;
+    }
+    g_u8_sdlog_open = 1u;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef sdlog_add(uint16_t u16_channel, int32_t i32_value)
+{
+    uint32_t u32_primask;
+    sdlog_sector_t *sector;
+#if !SDLOG_COMPRESS
+    sdlog_record_t *record;
+#endif
+
+    if (!g_u8_sdlog_open) {
+        return HAL_ERROR;
+    }
+#if SDLOG_COMPRESS
+    if (u16_channel > TSCOMP_MAX_CHANNEL) {
+        return HAL_ERROR;
+    }
+#endif
+
+    u32_primask = __get_PRIMASK();
+    __disable_irq();
+
+    sector = sdlog_open_sector();
+#if SDLOG_COMPRESS
+    if ((sector != NULL) && (tscomp_encode(&g_sdlog_packer, HAL_GetTick(), u16_channel, i32_value) == HAL_BUSY)) {
+        /* An empty block takes any record */
+        sdlog_close_sector();
+        sector = sdlog_open_sector();
+        if (sector != NULL) {
+            (void)tscomp_encode(&g_sdlog_packer, HAL_GetTick(), u16_channel, i32_value);
+        }
+    }
+#endif
+    if (sector == NULL) {
+        g_sdlog_stats.u32_dropped++;
+        g_u16_sdlog_sequence++;
+        __set_PRIMASK(u32_primask);
+        return HAL_BUSY;
+    }
+#if !SDLOG_COMPRESS
+    record = &sector->records[sector->u16_records++];
+    record->u32_time     = HAL_GetTick();
+    record->i32_value    = i32_value;
+    record->u16_channel  = u16_channel;
+    record->u16_sequence = g_u16_sdlog_sequence;
+    if (sector->u16_records == SDLOG_RECORDS_PER_SECTOR) {
+        sdlog_close_sector();
+    }
+#endif
+    g_u16_sdlog_sequence++;
+    g_sdlog_stats.u32_records++;
+
+    __set_PRIMASK(u32_primask);
+
+    return HAL_OK;
+}
+
+void sdlog_flush(void)
+{
+    uint32_t u32_primask;
+
+    u32_primask = __get_PRIMASK();
+    __disable_irq();
+    sdlog_close_sector();
+    __set_PRIMASK(u32_primask);
+}
+
+void sdlog_task(void)
+{
+    HAL_StatusTypeDef status;
+
+    if (!g_u8_sdlog_open) {
+        return;
+    }
+
+    status = sdcard_poll();
+    if (status == HAL_BUSY) {
+        return;
+    }
+
+    if (g_u8_sdlog_busy) {
+        g_u8_sdlog_busy = 0u;
+
+        if (status == HAL_OK) {
+            g_u32_sdlog_next++;
+            g_sdlog_stats.u32_sectors++;
+            g_sdlog_stats.u32_free_sectors = g_u32_sdlog_file_sectors - g_u32_sdlog_next;
+            g_u8_sdlog_retries = 0u;
+            sdlog_release(g_p_sdlog_writing, 1u);
+            if (g_sdlog_stats.u32_free_sectors == 0u) {
+                /* File full: nothing is written any more */
+                g_u8_sdlog_open = 0u;
+                sdlog_discard();
+                return;
+            }
+        } else {
+            sdlog_write_failed();
+        }
+    }
+
+    if ((g_p_sdlog_writing == NULL) && (sync_queue_pop(&g_sdlog_queue, &g_p_sdlog_writing) == 0u)) {
+        return;
+    }
+
+    status = sdcard_write_start(g_u32_sdlog_file_lba + g_u32_sdlog_next, g_p_sdlog_writing, 1u);
+    if (status == HAL_OK) {
+        g_u8_sdlog_busy = 1u;
+    } else if (status == HAL_ERROR) {
+        sdlog_write_failed();
+    }
+}
+
+uint8_t sdlog_pending(void)
+{
+    /* A closed log writes nothing any more */
+    return (g_u8_sdlog_open && ((g_p_sdlog_writing != NULL) || (sync_queue_count(&g_sdlog_queue) != 0u))) ? 1u : 0u;
+}
+
+const sdlog_stats_t *sdlog_get_stats(void)
+{
+    return &g_sdlog_stats;
+}
+
+/* Static module functions -------------------------------------------------- */
+/**
+ * @brief Finds the FAT32 volume and the file, checks that the file is
+ *        one run of clusters and sets its first block and size.
+ *
+ * @return HAL_OK or HAL_ERROR
+ */
+static HAL_StatusTypeDef sdlog_mount(void)
+{
+    uint8_t *pu8_sector = g_pu8_sdlog_sector;
+    uint32_t u32_volume_lba = 0u;
+    uint32_t u32_root_cluster;
+    uint32_t u32_cluster;
+    uint32_t u32_size;
+    uint32_t u32_cluster_bytes;
+
+    if (sdcard_read(0u, pu8_sector, 1u) != HAL_OK) {
+        return HAL_ERROR;
+    }
+    if ((pu8_sector[510] != 0x55u) || (pu8_sector[511] != 0xAAu)) {
+        return HAL_ERROR;
+    }
+
+    /* No FAT32 boot sector at block 0: first partition of the MBR */
+    if (memcmp(&pu8_sector[SDLOG_BPB_FS_TYPE_32], "FAT32   ", 8u) != 0) {
+        const uint8_t *pu8_entry = &pu8_sector[SDLOG_MBR_PARTITION];
+
+        if ((pu8_entry[4] != 0x0Bu) && (pu8_entry[4] != 0x0Cu)) {
+            return HAL_ERROR;
+        }
+        u32_volume_lba = sdlog_le32(&pu8_entry[8]);
+        if (sdcard_read(u32_volume_lba, pu8_sector, 1u) != HAL_OK) {
+            return HAL_ERROR;
+        }
+    }
+
+    if ((sdlog_le16(&pu8_sector[SDLOG_BPB_BYTES_PER_SECTOR]) != SDCARD_BLOCK_SIZE) ||
+        (pu8_sector[SDLOG_BPB_SECTORS_PER_CLUST] == 0u) || (pu8_sector[SDLOG_BPB_FATS] == 0u)) {
+        return HAL_ERROR;
+    }
+
+    g_u32_sdlog_cluster_sectors = pu8_sector[SDLOG_BPB_SECTORS_PER_CLUST];
+    g_u32_sdlog_fat_lba  = u32_volume_lba + sdlog_le16(&pu8_sector[SDLOG_BPB_RESERVED_SECTORS]);
+    g_u32_sdlog_data_lba = g_u32_sdlog_fat_lba +
+                           pu8_sector[SDLOG_BPB_FATS] * sdlog_le32(&pu8_sector[SDLOG_BPB_FAT_SIZE_32]);
+    g_u32_sdlog_fat_cached = 0xFFFFFFFFUL;
+    u32_root_cluster = sdlog_le32(&pu8_sector[SDLOG_BPB_ROOT_CLUSTER]);
+
+    if (sdlog_find_file(u32_root_cluster, &u32_cluster, &u32_size) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    u32_cluster_bytes = g_u32_sdlog_cluster_sectors * SDCARD_BLOCK_SIZE;
+    if ((u32_cluster < 2u) || (u32_size < SDCARD_BLOCK_SIZE) ||
+        (sdlog_check_chain(u32_cluster, (u32_size + u32_cluster_bytes - 1u) / u32_cluster_bytes) != HAL_OK)) {
+        return HAL_ERROR;
+    }
+
+    g_u32_sdlog_file_lba     = g_u32_sdlog_data_lba + (u32_cluster - 2u) * g_u32_sdlog_cluster_sectors;
+    g_u32_sdlog_file_sectors = u32_size / SDCARD_BLOCK_SIZE;
+
+    if (g_u32_sdlog_file_lba + g_u32_sdlog_file_sectors > sdcard_get_blocks()) {
+        return HAL_ERROR;
+    }
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Searches the root directory for SDLOG_FILE_NAME.
+ *
+ * @param u32_root_cluster First cluster of the root directory
+ * @param pu32_cluster     First cluster of the file
+ * @param pu32_size        Size of the file in bytes
+ * @return HAL_OK, HAL_ERROR if not found
+ */
+static HAL_StatusTypeDef sdlog_find_file(uint32_t u32_root_cluster, uint32_t *pu32_cluster, uint32_t *pu32_size)
+{
+    uint8_t *pu8_sector = g_pu8_sdlog_sector;
+    uint32_t u32_cluster = u32_root_cluster;
+
+    for (uint32_t u32_count = 0u; u32_count < SDLOG_ROOT_MAX_CLUSTERS; u32_count++) {
+        uint32_t u32_lba = g_u32_sdlog_data_lba + (u32_cluster - 2u) * g_u32_sdlog_cluster_sectors;
+
+        for (uint32_t s = 0u; s < g_u32_sdlog_cluster_sectors; s++) {
+            if (sdcard_read(u32_lba + s, pu8_sector, 1u) != HAL_OK) {
+                return HAL_ERROR;
+            }
+
+            for (uint32_t e = 0u; e < SDCARD_BLOCK_SIZE; e += SDLOG_DIR_ENTRY_SIZE) {
+                const uint8_t *pu8_entry = &pu8_sector[e];
+
+                if (pu8_entry[0] == 0x00u) {
+                    return HAL_ERROR;
+                }
+                /* Deleted entries, long names, volume label, directories */
+                if ((pu8_entry[0] == 0xE5u) || ((pu8_entry[SDLOG_DIR_ATTR] & 0x18u) != 0u) ||
+                    (memcmp(pu8_entry, SDLOG_FILE_NAME, 11u) != 0)) {
+                    continue;
+                }
+                *pu32_cluster = (sdlog_le16(&pu8_entry[SDLOG_DIR_CLUSTER_HIGH]) << 16) |
+                                sdlog_le16(&pu8_entry[SDLOG_DIR_CLUSTER_LOW]);
+                *pu32_size    = sdlog_le32(&pu8_entry[SDLOG_DIR_SIZE]);
+                return HAL_OK;
+            }
+        }
+
+        if ((sdlog_fat_next(u32_cluster, &u32_cluster) != HAL_OK) ||
+            (u32_cluster < 2u) || (u32_cluster >= SDLOG_FAT_EOC)) {
+            return HAL_ERROR;
+        }
+    }
+
+    return HAL_ERROR;
+}
+
+/**
+ * @brief Checks that the chain of a file is u32_clusters consecutive
+ *        clusters.
+ *
+ * @param u32_cluster  First cluster
+ * @param u32_clusters Clusters of the file
+ * @return HAL_OK, HAL_ERROR if the file is fragmented
+ */
+static HAL_StatusTypeDef sdlog_check_chain(uint32_t u32_cluster, uint32_t u32_clusters)
+{
+    uint32_t u32_next;
+
+    for (uint32_t i = 1u; i < u32_clusters; i++, u32_cluster++) {
+        if ((sdlog_fat_next(u32_cluster, &u32_next) != HAL_OK) || (u32_next != u32_cluster + 1u)) {
+            return HAL_ERROR;
+        }
+    }
+
+    if ((sdlog_fat_next(u32_cluster, &u32_next) != HAL_OK) || (u32_next < SDLOG_FAT_EOC)) {
+        return HAL_ERROR;
+    }
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Returns the FAT entry of a cluster, the sector is cached in its
+ *        own block.
+ *
+ * @param u32_cluster Cluster
+ * @param pu32_next   Next cluster or end of chain
+ * @return HAL_OK or HAL_ERROR
+ */
+static HAL_StatusTypeDef sdlog_fat_next(uint32_t u32_cluster, uint32_t *pu32_next)
+{
+    const uint8_t *pu8_fat = g_pu8_sdlog_fat;
+    uint32_t u32_lba = g_u32_sdlog_fat_lba + u32_cluster / (SDCARD_BLOCK_SIZE / 4u);
+
+    if (u32_lba != g_u32_sdlog_fat_cached) {
+        if (sdcard_read(u32_lba, g_pu8_sdlog_fat, 1u) != HAL_OK) {
+            g_u32_sdlog_fat_cached = 0xFFFFFFFFUL;
+            return HAL_ERROR;
+        }
+        g_u32_sdlog_fat_cached = u32_lba;
+    }
+
+    *pu32_next = sdlog_le32(&pu8_fat[(u32_cluster % (SDCARD_BLOCK_SIZE / 4u)) * 4u]) & SDLOG_FAT_MASK;
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Binary search for the first sector without SDLOG_MAGIC, sets
+ *        the next sector and the session of this boot.
+ *
+ * @return HAL_OK or HAL_ERROR
+ */
+static HAL_StatusTypeDef sdlog_find_end(void)
+{
+    const sdlog_sector_t *sector = (const sdlog_sector_t *)g_pu8_sdlog_sector;
+    uint32_t u32_low = 0u;
+    uint32_t u32_high = g_u32_sdlog_file_sectors;
+    uint32_t u32_mid;
+
+    /* Sectors below u32_low are written, from u32_high on empty */
+    while (u32_low < u32_high) {
+        u32_mid = u32_low + (u32_high - u32_low) / 2u;
+        if (sdcard_read(g_u32_sdlog_file_lba + u32_mid, g_pu8_sdlog_sector, 1u) != HAL_OK) {
+            return HAL_ERROR;
+        }
+        if ((sector->u32_magic == SDLOG_MAGIC) || (sector->u32_magic == SDLOG_MAGIC_PACKED)) {
+            u32_low = u32_mid + 1u;
+        } else {
+            u32_high = u32_mid;
+        }
+    }
+
+    g_u32_sdlog_next          = u32_low;
+    g_sdlog_stats.u16_session = 1u;
+
+    if (u32_low != 0u) {
+        if (sdcard_read(g_u32_sdlog_file_lba + u32_low - 1u, g_pu8_sdlog_sector, 1u) != HAL_OK) {
+            return HAL_ERROR;
+        }
+        g_sdlog_stats.u16_session = (uint16_t)(sector->u16_session + 1u);
+    }
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Returns the sector being filled, takes a new one from the pool
+ *        if there is none (interrupts masked).
+ *
+ * @return Sector, NULL without a free one
+ */
+static sdlog_sector_t *sdlog_open_sector(void)
+{
+    sdlog_sector_t *sector = g_p_sdlog_fill;
+
+    if (sector != NULL) {
+        return sector;
+    }
+
+    sector = (g_u8_sdlog_held < SDLOG_MAX_SECTORS) ? pool_shared_alloc(SDCARD_BLOCK_SIZE) : NULL;
+    if (sector == NULL) {
+        return NULL;
+    }
+    /* Unused records of a partial sector are written as zeros */
+    memset(sector, 0, sizeof(*sector));
+    sector->u32_magic   = SDLOG_MAGIC;
+    sector->u16_session = g_sdlog_stats.u16_session;
+#if SDLOG_COMPRESS
+    {
+        sdlog_packed_sector_t *packed = (sdlog_packed_sector_t *)(void *)sector;
+
+        packed->u32_magic    = SDLOG_MAGIC_PACKED;
+        packed->u16_sequence = g_u16_sdlog_sequence;
+        (void)tscomp_encoder_init(&g_sdlog_packer, packed->block, SDLOG_PACKED_BLOCK_SIZE);
+    }
+#endif
+    g_p_sdlog_fill = sector;
+    g_u8_sdlog_held++;
+
+    return sector;
+}
+
+/**
+ * @brief Queues the sector being filled for sdlog_task() (interrupts
+ *        masked).
+ *
+ * @return None
+ */
+static void sdlog_close_sector(void)
+{
+    sdlog_sector_t *sector = g_p_sdlog_fill;
+
+    if (sector == NULL) {
+        return;
+    }
+#if SDLOG_COMPRESS
+    (void)tscomp_encoder_finish(&g_sdlog_packer);
+#endif
+    /* Never full: it holds fewer than SDLOG_MAX_SECTORS sectors */
+    (void)sync_queue_push(&g_sdlog_queue, &sector);
+    g_p_sdlog_fill = NULL;
+}
+
+/**
+ * @brief Records in a sector of either kind.
+ *
+ * @param sector Sector
+ * @return Records
+ */
+static uint32_t sdlog_sector_records(const sdlog_sector_t *sector)
+{
+    const sdlog_packed_sector_t *packed = (const sdlog_packed_sector_t *)(const void *)sector;
+
+    if (sector->u32_magic != SDLOG_MAGIC_PACKED) {
+        return sector->u16_records;
+    }
+#if SDLOG_COMPRESS
+    /* The sector being filled has no header yet */
+    if (sector == g_p_sdlog_fill) {
+        return g_sdlog_packer.u16_records;
+    }
+#endif
+
+    return sdlog_le16(&packed->block[2]);
+}
+
+/**
+ * @brief Counts a failed write, drops the sector after the last retry.
+ *
+ * @return None
+ */
+static void sdlog_write_failed(void)
+{
+    g_sdlog_stats.u32_errors++;
+    DLOG("sdlog: write of sector %u failed, retry %u", g_u32_sdlog_next, g_u8_sdlog_retries);
+    if (++g_u8_sdlog_retries > SDLOG_WRITE_RETRIES) {
+        g_u8_sdlog_retries = 0u;
+        sdlog_release(g_p_sdlog_writing, 0u);
+    }
+}
+
+/**
+ * @brief Returns a written or dropped sector of sdlog_task() to the pool,
+ *        the records of an unwritten one count as dropped.
+ *
+ * @param sector     Sector, g_p_sdlog_writing or popped from the queue
+ * @param u8_written 1 if the sector is on the card
+ * @return None
+ */
+static void sdlog_release(sdlog_sector_t *sector, uint8_t u8_written)
+{
+    uint32_t u32_primask;
+
+    if (!u8_written) {
+        g_sdlog_stats.u32_dropped += sdlog_sector_records(sector);
+    }
+    if (sector == g_p_sdlog_writing) {
+        g_p_sdlog_writing = NULL;
+    }
+    pool_shared_free(sector);
+
+    u32_primask = __get_PRIMASK();
+    __disable_irq();
+    g_u8_sdlog_held--;
+    __set_PRIMASK(u32_primask);
+}
+
+/**
+ * @brief Drops every held sector: the file is full or mounted again.
+ *
+ * @return None
+ */
+static void sdlog_discard(void)
+{
+    uint32_t u32_primask;
+    sdlog_sector_t *sector;
+
+    /* No sdlog_add() any more, the sector being filled is free game */
+    u32_primask = __get_PRIMASK();
+    __disable_irq();
+    sector = g_p_sdlog_fill;
+    g_p_sdlog_fill = NULL;
+    __set_PRIMASK(u32_primask);
+
+    if (sector != NULL) {
+        sdlog_release(sector, 0u);
+    }
+    while (sync_queue_pop(&g_sdlog_queue, &sector) != 0u) {
+        sdlog_release(sector, 0u);
+    }
+    if (g_p_sdlog_writing != NULL) {
+        sdlog_release(g_p_sdlog_writing, 0u);
+    }
+    g_u8_sdlog_busy = 0u;
+}
+
+/**
+ * @brief Little endian fields of the FAT structures.
+ */
+static uint32_t sdlog_le16(const uint8_t *pu8_data)
+{
+    return (uint32_t)pu8_data[0] | ((uint32_t)pu8_data[1] << 8);
+}
+
+static uint32_t sdlog_le32(const uint8_t *pu8_data)
+{
+    return sdlog_le16(pu8_data) | (sdlog_le16(&pu8_data[2]) << 16);
+}
@@ -0,0 +1,195 @@
+/**
+ ******************************************************************************
+ * @file        sdlog.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the SD card long-term logger.
+ *
+ * @details
+ * Appends time stamped values to a file on the SD card, e.g. the
+ * samples of env_sensor and the fan over weeks. The file is created
+ * beforehand on the PC with its full size and filled with zeros
+ * (sdlog_tool.py create); the firmware never changes the FAT, the
+ * directory or the file size, it only writes data sectors inside the
+ * file. A reset or power loss can thus never damage the file system,
+ * and no metadata sector wears out.
+ *
+ * Records go into sectors taken from the large blocks of the shared pool
+ * (modules/pool): one is filled, full ones wait in a queue and are
+ * written by DMA one after the other. Adding a record only copies it
+ * with interrupts masked and never waits for the card; with
+ * SDLOG_MAX_SECTORS sectors held or an empty pool the record is dropped
+ * and counted. sdlog_task() from the main loop starts the writes,
+ * checks their end and returns the written sectors to the pool.
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - Mount: FAT32 volume (partitioned or not), file SDLOG_FILE_NAME in
+ *    the root directory, its clusters must be contiguous (a file copied
+ *    to a freshly formatted card is)
+ *  - Sector: magic, session, record count, SDLOG_RECORDS_PER_SECTOR
+ *    records of 12 bytes; the first zero sector is the end of the log,
+ *    found by a binary search at the mount
+ *  - Every boot is a new session and starts in a new sector, the log
+ *    of the previous sessions stays
+ *  - Record sequence numbers show dropped records
+ *  - modules/sdlog/sdlog_tool.py creates the file and turns it into CSV
+ *
+ * With SDLOG_COMPRESS the sectors carry the records as a modules/tscomp
+ * block instead (sdlog_packed_sector_t): 2 to 3 bytes instead of 12 per
+ * record of a slowly varying channel, so the same file holds several
+ * times the duration. Both kinds of sectors may follow each other in one
+ * file; channels above TSCOMP_MAX_CHANNEL are refused then.
+ *
+ * Channel numbers are those of datalog_channel_t, e.g. DATALOG_CH_ENV_TEMP
+ * in 0.01 C, so both logs decode alike.
+ *
+ ******************************************************************************
+ */
+
+#ifndef SDLOG_SDLOG_H_
+#define SDLOG_SDLOG_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief 1 to log to the SD card, used by the applications.
+ */
+#ifndef SDLOG_ENABLE
+#define SDLOG_ENABLE                0
+#endif
+
+/**
+ * @brief Name of the log file as 8.3 directory entry (SDLOG.BIN).
+ */
+#define SDLOG_FILE_NAME             "SDLOG   BIN"
+
+/**
+ * @brief First word of every written sector ("SLG1").
+ */
+#define SDLOG_MAGIC                 0x31474C53UL
+
+/**
+ * @brief 1 to write compressed sectors, first word of them ("SLZ1").
+ */
+#ifndef SDLOG_COMPRESS
+#define SDLOG_COMPRESS              0
+#endif
+#define SDLOG_MAGIC_PACKED          0x315A4C53UL
+
+/**
+ * @brief Pool blocks held at most (filled, waiting and being written),
+ *        power of two; records per sector.
+ */
+#define SDLOG_MAX_SECTORS           4U
+#define SDLOG_RECORDS_PER_SECTOR    42U
+#define SDLOG_PACKED_BLOCK_SIZE     504U
+
+/**
+ * @brief Attempts of a failed write before its records are dropped.
+ */
+#define SDLOG_WRITE_RETRIES         3U
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief One record.
+ */
+typedef struct {
+    uint32_t u32_time;              /**< HAL tick in ms                      */
+    int32_t  i32_value;
+    uint16_t u16_channel;           /**< datalog_channel_t numbers           */
+    uint16_t u16_sequence;          /**< Record number in the session       */
+} sdlog_record_t;
+
+/**
+ * @brief One sector of the file (512 bytes).
+ */
+typedef struct {
+    uint32_t       u32_magic;       /**< SDLOG_MAGIC, 0 after the end       */
+    uint16_t       u16_session;     /**< Boot count of the log              */
+    uint16_t       u16_records;     /**< Valid records                      */
+    sdlog_record_t records[SDLOG_RECORDS_PER_SECTOR];
+} sdlog_sector_t;
+
+/**
+ * @brief One compressed sector (512 bytes), the records numbered on from
+ *        u16_sequence without gaps.
+ */
+typedef struct {
+    uint32_t u32_magic;             /**< SDLOG_MAGIC_PACKED                 */
+    uint16_t u16_session;           /**< Boot count of the log              */
+    uint16_t u16_sequence;          /**< Number of the first record         */
+    uint8_t  block[SDLOG_PACKED_BLOCK_SIZE]; /**< tscomp block              */
+} sdlog_packed_sector_t;
+
+/**
+ * @brief State and counters since sdlog_init().
+ */
+typedef struct {
+    uint32_t u32_records;           /**< Records added                      */
+    uint32_t u32_dropped;           /**< Records lost (no sector, errors)   */
+    uint32_t u32_sectors;           /**< Sectors written                    */
+    uint32_t u32_errors;            /**< Failed writes                      */
+    uint32_t u32_free_sectors;      /**< Sectors left in the file           */
+    uint16_t u16_session;           /**< Session of this boot               */
+} sdlog_stats_t;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Initializes the card, finds the file and the end of the log.
+ *
+ * Waits for the card and reads some hundred sectors (FAT and binary
+ * search), meant for the start of the application.
+ *
+ * @return HAL_OK, HAL_ERROR without a card, a FAT32 volume or the file,
+ *         for a fragmented or a full file or without two free large pool
+ *         blocks
+ */
+HAL_StatusTypeDef sdlog_init(void);
+
+/**
+ * @brief Adds a record (any context, never waits).
+ *
+ * @param u16_channel Channel
+ * @param i32_value   Value
+ * @return HAL_OK, HAL_BUSY if dropped (no free sector), HAL_ERROR
+ *         without a mounted or with a full file (or a channel above
+ *         TSCOMP_MAX_CHANNEL with SDLOG_COMPRESS)
+ */
+HAL_StatusTypeDef sdlog_add(uint16_t u16_channel, int32_t i32_value);
+
+/**
+ * @brief Closes the partly filled sector, it is written with the next
+ *        sdlog_task() (e.g. before the power is switched off).
+ *
+ * @return None
+ */
+void sdlog_flush(void);
+
+/**
+ * @brief Starts the write of a full sector and checks the end of a
+ *        running one (main loop).
+ *
+ * @return None
+ */
+void sdlog_task(void);
+
+/**
+ * @brief Returns 1 while a full sector waits or a write runs, e.g.
+ *        before the STOP mode.
+ *
+ * @return 1 or 0
+ */
+uint8_t sdlog_pending(void);
+
+/**
+ * @brief Returns state and counters.
+ *
+ * @return Counters
+ */
+const sdlog_stats_t *sdlog_get_stats(void);
+
+#endif /* SDLOG_SDLOG_H_ */
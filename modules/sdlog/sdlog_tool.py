@@ -0,0 +1,148 @@
+#!/usr/bin/env python3
+"""Creates and decodes the log file of modules/sdlog.
+
+create: writes SDLOG.BIN of the given size in MB filled with zeros.
+Copy it to a freshly formatted FAT32 card (or create it there right
+away) so its clusters are contiguous; sdlog_init() rejects a fragmented
+file. A card with an old log gets a fresh file the same way.
+
+decode: writes one CSV line per record of a copied SDLOG.BIN (or a
+whole card image with --offset): session, time in seconds, channel
+name, value. Gaps in the record numbers of a session are reported.
+Sectors written with SDLOG_COMPRESS are unpacked with
+modules/tscomp/tscomp.py.
+
+Only the standard library is needed; ``--plot`` uses matplotlib.
+
+Usage:
+    sdlog_tool.py create /media/card/SDLOG.BIN 256
+    sdlog_tool.py decode SDLOG.BIN [--csv out.csv] [--plot]
+"""
+
+import argparse
+import csv
+import os
+import struct
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "tscomp"))
+import tscomp  # noqa: E402
+
+MAGIC = 0x31474C53
+MAGIC_PACKED = 0x315A4C53
+SECTOR = 512
+HEADER = struct.Struct("<IHH")      # magic, session, records / first sequence
+RECORD = struct.Struct("<IiHH")     # time (ms), value, channel, sequence
+RECORDS_PER_SECTOR = (SECTOR - HEADER.size) // RECORD.size
+
+# Channels, the numbers of datalog.h
+CHANNELS = {
+    1: "poti_1", 2: "poti_2", 3: "tacho_period_us", 4: "fan_rpm",
+    5: "fan_error_rpm", 6: "fan_output", 7: "env_temp_0.01C",
+    8: "env_press_pa", 9: "env_hum_0.001%", 10: "env_raw_temp",
+    11: "env_raw_press", 12: "env_raw_hum",
+}
+
+
+def create(path, size_mb):
+    """Writes the zero filled file."""
+    chunk = bytes(1024 * 1024)
+    with open(path, "wb") as stream:
+        for _ in range(size_mb):
+            stream.write(chunk)
+    sys.stderr.write("%s: %d sectors, %d records\n" %
+                     (path, size_mb * 2048, size_mb * 2048 * RECORDS_PER_SECTOR))
+
+
+def records(data):
+    """Yields (session, time_ms, value, channel, sequence) up to the end of the log."""
+    for pos in range(0, len(data) - SECTOR + 1, SECTOR):
+        magic, session, count = HEADER.unpack_from(data, pos)
+        if magic == MAGIC_PACKED:
+            try:
+                for i, (time_ms, channel, value) in enumerate(
+                        tscomp.decode_block(data, pos + HEADER.size, SECTOR - HEADER.size)):
+                    yield session, time_ms, value, channel, (count + i) % 65536
+            except ValueError as error:
+                sys.stderr.write("sector %d: %s\n" % (pos // SECTOR, error))
+            continue
+        if magic != MAGIC:
+            return
+        for i in range(min(count, RECORDS_PER_SECTOR)):
+            time_ms, value, channel, sequence = RECORD.unpack_from(data, pos + HEADER.size + i * RECORD.size)
+            yield session, time_ms, value, channel, sequence
+
+
+def decode(args):
+    with open(args.source, "rb") as stream:
+        stream.seek(args.offset)
+        data = stream.read()
+
+    out = open(args.csv, "w", newline="") if args.csv else sys.stdout
+    writer = csv.writer(out)
+    writer.writerow(["session", "time_s", "channel", "value"])
+
+    series = {}
+    last = {}
+    count = 0
+    origin = {}
+    for session, time_ms, value, channel, sequence in records(data):
+        # Tick wraps after 49 days: unwrap within the session
+        base, previous = origin.get(session, (0, time_ms))
+        if time_ms < previous:
+            base += 2**32
+        origin[session] = (base, time_ms)
+        time_s = (base + time_ms) / 1000.0
+
+        expected = last.get(session)
+        if expected is not None and sequence != expected:
+            sys.stderr.write("session %d: %d records lost at %.3f s\n" %
+                             (session, (sequence - expected) % 65536, time_s))
+        last[session] = (sequence + 1) % 65536
+
+        name = CHANNELS.get(channel, "ch_%d" % channel)
+        writer.writerow([session, "%.3f" % time_s, name, value])
+        series.setdefault((session, name), []).append((time_s, value))
+        count += 1
+
+    if out is not sys.stdout:
+        out.close()
+    sys.stderr.write("%d records in %d sessions\n" % (count, len(last)))
+
+    if args.plot and series:
+        import matplotlib.pyplot as plt
+
+        names = sorted(set(name for _, name in series))
+        fig, axes = plt.subplots(len(names), 1, sharex=True, squeeze=False)
+        for axis, name in zip(axes[:, 0], names):
+            for (session, label), points in sorted(series.items()):
+                if label == name:
+                    axis.plot([p[0] for p in points], [p[1] for p in points], label="session %d" % session)
+            axis.set_ylabel(name)
+        axes[-1, 0].set_xlabel("time since boot [s]")
+        plt.show()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    commands = parser.add_subparsers(dest="command", required=True)
+
+    parser_create = commands.add_parser("create", help="write an empty log file")
+    parser_create.add_argument("path", help="file, normally SDLOG.BIN on the card")
+    parser_create.add_argument("size_mb", type=int, help="size in MB")
+
+    parser_decode = commands.add_parser("decode", help="log file to CSV")
+    parser_decode.add_argument("source", help="SDLOG.BIN or a card image")
+    parser_decode.add_argument("--offset", type=int, default=0, help="byte offset of the file in the source")
+    parser_decode.add_argument("--csv", help="CSV file, default: stdout")
+    parser_decode.add_argument("--plot", action="store_true", help="plot the channels")
+
+    args = parser.parse_args()
+    if args.command == "create":
+        create(args.path, args.size_mb)
+    else:
+        decode(args)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,203 @@
+/**
+ ******************************************************************************
+ * @file        sdram.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       FMC SDRAM initialization (IS42S16400J, 8 MB)
+ *
+ * Functionality:
+ * - Configures all FMC SDRAM pins as AF12
+ * - 16-bit data, 4 internal banks, 12 row / 8 column bits, CAS latency 3
+ * - JEDEC start-up: clock enable, precharge all, 4x auto refresh,
+ *   load mode register (burst length 1, single write burst)
+ * - Refresh rate: 64 ms / 4096 rows, derived from the current HCLK
+ *
+ * Peripherals:
+ * - FMC SDRAM bank 2
+ * - GPIOB, GPIOC, GPIOD, GPIOE, GPIOF, GPIOG (FMC alternate function)
+ ******************************************************************************
+ */
+
+#include "sdram.h"
+#include <utils/utils.h>
+
+/* Preprocessor Defines ----------------------------------------------------- */
+#define SDRAM_MODEREG_BURST_LENGTH_1        0x0000U
+#define SDRAM_MODEREG_BURST_TYPE_SEQUENTIAL 0x0000U
+#define SDRAM_MODEREG_CAS_LATENCY_3         0x0030U
+#define SDRAM_MODEREG_OPERATING_MODE_STD    0x0000U
+#define SDRAM_MODEREG_WRITEBURST_SINGLE     0x0200U
+
+/**
+ * @brief Number of rows that must be refreshed within 64 ms.
+ */
+#define SDRAM_ROW_COUNT                     4096U
+
+/* Static module variables -------------------------------------------------- */
+/**
+ * @brief FMC SDRAM handle.
+ */
+static SDRAM_HandleTypeDef g_sdram_handle_struct;
+
+/**
+ * @brief Set once the SDRAM has been brought up.
+ */
+static uint8_t g_u8_sdram_ready = 0u;
+
+/* Static function prototypes ---------------------------------------------- */
+static void sdram_gpio_init(void);
+static HAL_StatusTypeDef sdram_send_command(uint32_t u32_mode,
+                                            uint32_t u32_refresh,
+                                            uint32_t u32_mode_reg);
+
+/* Public functions --------------------------------------------------------- */
+HAL_StatusTypeDef sdram_init(void)
+{
+    FMC_SDRAM_TimingTypeDef sdram_timing_struct;
+    uint32_t u32_sdclk;
+    uint32_t u32_refresh_count;
+
+    if (g_u8_sdram_ready) {
+        return HAL_OK;
+    }
+
+    sdram_gpio_init();
+
+    __HAL_RCC_FMC_CLK_ENABLE();
+
+    g_sdram_handle_struct.Instance                = FMC_SDRAM_DEVICE;
+    g_sdram_handle_struct.Init.SDBank             = FMC_SDRAM_BANK2;
+    g_sdram_handle_struct.Init.ColumnBitsNumber   = FMC_SDRAM_COLUMN_BITS_NUM_8;
+    g_sdram_handle_struct.Init.RowBitsNumber      = FMC_SDRAM_ROW_BITS_NUM_12;
+    g_sdram_handle_struct.Init.MemoryDataWidth    = FMC_SDRAM_MEM_BUS_WIDTH_16;
+    g_sdram_handle_struct.Init.InternalBankNumber = FMC_SDRAM_INTERN_BANKS_NUM_4;
+    g_sdram_handle_struct.Init.CASLatency         = FMC_SDRAM_CAS_LATENCY_3;
+    g_sdram_handle_struct.Init.WriteProtection    = FMC_SDRAM_WRITE_PROTECTION_DISABLE;
+    g_sdram_handle_struct.Init.SDClockPeriod      = FMC_SDRAM_CLOCK_PERIOD_2;
+    g_sdram_handle_struct.Init.ReadBurst          = FMC_SDRAM_RBURST_DISABLE;
+    g_sdram_handle_struct.Init.ReadPipeDelay      = FMC_SDRAM_RPIPE_DELAY_1;
+
+    /* Timing in SDCLK cycles, valid up to SDCLK = 90 MHz (HCLK = 180 MHz) */
+    sdram_timing_struct.LoadToActiveDelay    = 2u;
+    sdram_timing_struct.ExitSelfRefreshDelay = 7u;
+    sdram_timing_struct.SelfRefreshTime      = 4u;
+    sdram_timing_struct.RowCycleDelay        = 7u;
+    sdram_timing_struct.WriteRecoveryTime    = 3u;
+    sdram_timing_struct.RPDelay              = 2u;
+    sdram_timing_struct.RCDDelay             = 2u;
+
+    if (HAL_SDRAM_Init(&g_sdram_handle_struct, &sdram_timing_struct) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    /* JEDEC power-up sequence */
+    if (sdram_send_command(FMC_SDRAM_CMD_CLK_ENABLE, 1u, 0u) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    /* At least 100 us with stable clock before the precharge */
+    utils_delay_us(SDRAM_POWER_UP_US);
+
+    if (sdram_send_command(FMC_SDRAM_CMD_PALL, 1u, 0u) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    if (sdram_send_command(FMC_SDRAM_CMD_AUTOREFRESH_MODE, 4u, 0u) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    if (sdram_send_command(FMC_SDRAM_CMD_LOAD_MODE, 1u,
+                           SDRAM_MODEREG_BURST_LENGTH_1 |
+                           SDRAM_MODEREG_BURST_TYPE_SEQUENTIAL |
+                           SDRAM_MODEREG_CAS_LATENCY_3 |
+                           SDRAM_MODEREG_OPERATING_MODE_STD |
+                           SDRAM_MODEREG_WRITEBURST_SINGLE) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    /* Refresh count = (64 ms / rows) * SDCLK - 20 (safety margin) */
+    u32_sdclk         = HAL_RCC_GetHCLKFreq() / 2u;
+    u32_refresh_count = ((u32_sdclk / 1000u) * 64u) / SDRAM_ROW_COUNT - 20u;
+
+    if (HAL_SDRAM_ProgramRefreshRate(&g_sdram_handle_struct,
+                                     u32_refresh_count) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    g_u8_sdram_ready = 1u;
+
+    return HAL_OK;
+}
+
+/* Static module functions -------------------------------------------------- */
+static void sdram_gpio_init(void)
+{
+    GPIO_InitTypeDef gpio_init_struct;
+
+    __HAL_RCC_GPIOB_CLK_ENABLE();
+    __HAL_RCC_GPIOC_CLK_ENABLE();
+    __HAL_RCC_GPIOD_CLK_ENABLE();
+    __HAL_RCC_GPIOE_CLK_ENABLE();
+    __HAL_RCC_GPIOF_CLK_ENABLE();
+    __HAL_RCC_GPIOG_CLK_ENABLE();
+
+    gpio_init_struct.Mode      = GPIO_MODE_AF_PP;
+    gpio_init_struct.Pull      = GPIO_NOPULL;
+    gpio_init_struct.Speed     = GPIO_SPEED_FREQ_VERY_HIGH;
+    gpio_init_struct.Alternate = GPIO_AF12_FMC;
+
+    /* SDCKE1, SDNE1 */
+    gpio_init_struct.Pin = GPIO_PIN_5 | GPIO_PIN_6;
+    HAL_GPIO_Init(GPIOB, &gpio_init_struct);
+
+    /* SDNWE */
+    gpio_init_struct.Pin = GPIO_PIN_0;
+    HAL_GPIO_Init(GPIOC, &gpio_init_struct);
+
+    /* D2, D3, D13, D14, D15, D0, D1 */
+    gpio_init_struct.Pin = GPIO_PIN_0 | GPIO_PIN_1 | GPIO_PIN_8 | GPIO_PIN_9 |
+                           GPIO_PIN_10 | GPIO_PIN_14 | GPIO_PIN_15;
+    HAL_GPIO_Init(GPIOD, &gpio_init_struct);
+
+    /* NBL0, NBL1, D4..D12 */
+    gpio_init_struct.Pin = GPIO_PIN_0 | GPIO_PIN_1 | GPIO_PIN_7 | GPIO_PIN_8 |
+                           GPIO_PIN_9 | GPIO_PIN_10 | GPIO_PIN_11 | GPIO_PIN_12 |
+                           GPIO_PIN_13 | GPIO_PIN_14 | GPIO_PIN_15;
+    HAL_GPIO_Init(GPIOE, &gpio_init_struct);
+
+    /* A0..A5, SDNRAS, A6..A9 */
+    gpio_init_struct.Pin = GPIO_PIN_0 | GPIO_PIN_1 | GPIO_PIN_2 | GPIO_PIN_3 |
+                           GPIO_PIN_4 | GPIO_PIN_5 | GPIO_PIN_11 | GPIO_PIN_12 |
+                           GPIO_PIN_13 | GPIO_PIN_14 | GPIO_PIN_15;
+    HAL_GPIO_Init(GPIOF, &gpio_init_struct);
+
+    /* A10, A11, BA0, BA1, SDCLK, SDNCAS */
+    gpio_init_struct.Pin = GPIO_PIN_0 | GPIO_PIN_1 | GPIO_PIN_4 | GPIO_PIN_5 |
+                           GPIO_PIN_8 | GPIO_PIN_15;
+    HAL_GPIO_Init(GPIOG, &gpio_init_struct);
+}
+
+/**
+ * @brief Sends one command to SDRAM bank 2.
+ *
+ * @param u32_mode     FMC_SDRAM_CMD_x command.
+ * @param u32_refresh  Number of consecutive auto refresh cycles.
+ * @param u32_mode_reg Mode register value (LOAD_MODE only).
+ * @return HAL status of the command.
+ */
+static HAL_StatusTypeDef sdram_send_command(uint32_t u32_mode,
+                                            uint32_t u32_refresh,
+                                            uint32_t u32_mode_reg)
+{
+    FMC_SDRAM_CommandTypeDef sdram_command_struct;
+
+    sdram_command_struct.CommandMode            = u32_mode;
+    sdram_command_struct.CommandTarget          = FMC_SDRAM_CMD_TARGET_BANK2;
+    sdram_command_struct.AutoRefreshNumber      = u32_refresh;
+    sdram_command_struct.ModeRegisterDefinition = u32_mode_reg;
+
+    return HAL_SDRAM_SendCommand(&g_sdram_handle_struct,
+                                 &sdram_command_struct,
+                                 SDRAM_TIMEOUT_MS);
+}
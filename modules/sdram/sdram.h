@@ -0,0 +1,63 @@
+/**
+ ******************************************************************************
+ * @file        sdram.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the external SDRAM module.
+ *
+ * @details
+ * Initializes the FMC SDRAM controller for the 8 MB IS42S16400J on the
+ * STM32F429I-Discovery (FMC bank 2, SDNE1/SDCKE1). After sdram_init()
+ * the memory is mapped at SDRAM_BANK_ADDR and can be accessed like
+ * internal RAM.
+ *
+ * @note The FMC pins overlap with the test board pins of the ESD
+ *       (PD0/PD1/PD14/PD15, PE7/PE11/PE12) and with I2C1 SCL (PB6).
+ *       SDRAM can therefore not be used together with the esd, dot or
+ *       env_sensor modules.
+ *
+ ******************************************************************************
+ */
+
+#ifndef SDRAM_SDRAM_H_
+#define SDRAM_SDRAM_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief Start address of the SDRAM (FMC SDRAM bank 2).
+ */
+#define SDRAM_BANK_ADDR      0xD0000000UL
+
+/**
+ * @brief Size of the SDRAM in bytes.
+ */
+#define SDRAM_SIZE           0x00800000UL
+
+/**
+ * @brief Timeout for SDRAM commands in milliseconds.
+ */
+#define SDRAM_TIMEOUT_MS     100U
+
+/**
+ * @brief Power-up delay with stable clock before the first command in
+ *        microseconds (JEDEC: at least 100 us).
+ */
+#define SDRAM_POWER_UP_US    100U
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Initializes the FMC SDRAM controller and the SDRAM device.
+ *
+ * Configures the FMC GPIOs, the controller timing (SDCLK = HCLK / 2),
+ * runs the JEDEC power-up sequence and programs the refresh counter
+ * for the current HCLK. Calling it a second time has no effect.
+ *
+ * @return HAL_OK on success, HAL_ERROR if the controller rejected a command.
+ */
+HAL_StatusTypeDef sdram_init(void);
+
+#endif /* SDRAM_SDRAM_H_ */
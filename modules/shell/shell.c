@@ -0,0 +1,308 @@
+/**
+ ******************************************************************************
+ * @file        shell.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Line based command shell with a compile time hash table
+ *
+ * Functionality:
+ * - Collects bytes into a line buffer, a CR or LF ends the line and the
+ *   run; the rest stays in the source for the next shell_poll()
+ * - Splits the line in place into words, looks up the first word in its
+ *   SHELL_HASH() slot and compares the name
+ * - One reply per line, handlers fill a fmt_t on the stack
+ *
+ * Resources:
+ * - None, byte source and reply sink of the application
+ ******************************************************************************
+ */
+
+#include "shell.h"
+#include <string.h>
+
+/* Static module variables -------------------------------------------------- */
+/**
+ * @brief Command table, byte source and reply sink.
+ */
+static const shell_command_t *g_p_shell_table = NULL;
+static shell_read_t g_shell_read = NULL;
+static shell_write_t g_shell_write = NULL;
+
+/**
+ * @brief Line collected so far, 1 while an overlong line is skipped.
+ */
+static char g_ch_shell_line[SHELL_LINE_SIZE];
+static uint16_t g_u16_shell_length = 0u;
+static uint8_t g_u8_shell_overflow = 0u;
+
+/* Static function prototypes ---------------------------------------------- */
+static uint32_t shell_hash(const char *pch_name);
+static void shell_execute(char *pch_line);
+static void shell_reply(const fmt_t *reply);
+
+/* Public functions --------------------------------------------------------- */
+HAL_StatusTypeDef shell_init(const shell_command_t *table, shell_read_t read, shell_write_t write)
+{
+    if ((table == NULL) || (read == NULL) || (write == NULL)) {
+        return HAL_ERROR;
+    }
+
+    /* Catches a list entry whose length or characters do not fit its name */
+    for (uint32_t i = 0u; i < SHELL_TABLE_SIZE; i++) {
+        if ((table[i].pch_name != NULL) &&
+            ((table[i].handler == NULL) || (table[i].pch_name[0] == '\0') || (shell_hash(table[i].pch_name) != i))) {
+            return HAL_ERROR;
+        }
+    }
+
+    g_p_shell_table     = table;
+    g_shell_read        = read;
+    g_shell_write       = write;
+    g_u16_shell_length  = 0u;
+    g_u8_shell_overflow = 0u;
+
+    return HAL_OK;
+}
+
+void shell_poll(void)
+{
+    uint8_t u8_byte;
+
+    if (g_p_shell_table == NULL) {
+        return;
+    }
+
+    for (uint32_t u32_count = 0u; u32_count < SHELL_BYTES_PER_RUN; u32_count++) {
+        if (g_shell_read(&u8_byte, 1u) == 0u) {
+            return;
+        }
+
+        if ((u8_byte == '\r') || (u8_byte == '\n')) {
+            if (g_u8_shell_overflow) {
+                char ch_buffer[32];
+                fmt_t reply;
+
+                fmt_init(&reply, ch_buffer, sizeof(ch_buffer));
+                fmt_str(&reply, "error: line too long");
+                shell_reply(&reply);
+            } else if (g_u16_shell_length != 0u) {
+                g_ch_shell_line[g_u16_shell_length] = '\0';
+                shell_execute(g_ch_shell_line);
+            }
+            g_u16_shell_length  = 0u;
+            g_u8_shell_overflow = 0u;
+
+            /* At most one command per run */
+            return;
+        }
+
+        if (g_u16_shell_length < SHELL_LINE_SIZE - 1u) {
+            g_ch_shell_line[g_u16_shell_length++] = (char)u8_byte;
+        } else {
+            g_u8_shell_overflow = 1u;
+        }
+    }
+}
+
+void shell_list(fmt_t *reply)
+{
+    if (g_p_shell_table == NULL) {
+        return;
+    }
+
+    for (uint32_t i = 0u; i < SHELL_TABLE_SIZE; i++) {
+        if (g_p_shell_table[i].pch_name != NULL) {
+            fmt_str(reply, g_p_shell_table[i].pch_name);
+            fmt_char(reply, ' ');
+        }
+    }
+}
+
+void shell_usage(const char *pch_name, fmt_t *reply)
+{
+    const shell_command_t *command;
+
+    if (g_p_shell_table == NULL) {
+        return;
+    }
+
+    command = &g_p_shell_table[shell_hash(pch_name)];
+    if ((command->pch_name != NULL) && (strcmp(command->pch_name, pch_name) == 0)) {
+        fmt_str(reply, "usage: ");
+        fmt_str(reply, (command->pch_help != NULL) ? command->pch_help : command->pch_name);
+    }
+}
+
+HAL_StatusTypeDef shell_parse_u32(const char *pch_text, uint32_t *pu32_value)
+{
+    uint32_t u32_value = 0u;
+
+    if ((pch_text == NULL) || (*pch_text == '\0')) {
+        return HAL_ERROR;
+    }
+
+    for (; *pch_text != '\0'; pch_text++) {
+        if ((*pch_text < '0') || (*pch_text > '9') ||
+            (u32_value > (0xFFFFFFFFUL - (uint32_t)(*pch_text - '0')) / 10u)) {
+            return HAL_ERROR;
+        }
+        u32_value = u32_value * 10u + (uint32_t)(*pch_text - '0');
+    }
+
+    *pu32_value = u32_value;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef shell_parse_u64(const char *pch_text, uint64_t *pu64_value)
+{
+    uint64_t u64_value = 0u;
+
+    if ((pch_text == NULL) || (*pch_text == '\0')) {
+        return HAL_ERROR;
+    }
+
+    for (; *pch_text != '\0'; pch_text++) {
+        if ((*pch_text < '0') || (*pch_text > '9') ||
+            (u64_value > (UINT64_MAX - (uint64_t)(*pch_text - '0')) / 10u)) {
+            return HAL_ERROR;
+        }
+        u64_value = u64_value * 10u + (uint64_t)(*pch_text - '0');
+    }
+
+    *pu64_value = u64_value;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef shell_parse_fixed(const char *pch_text, uint8_t u8_decimals, int32_t *pi32_value)
+{
+    uint32_t u32_value = 0u;
+    uint8_t u8_fraction = 0u;
+    uint8_t u8_point = 0u;
+    uint8_t u8_digits = 0u;
+    uint8_t u8_negative = 0u;
+    uint32_t u32_digit;
+
+    if ((pch_text == NULL) || (u8_decimals > FMT_MAX_DECIMALS)) {
+        return HAL_ERROR;
+    }
+    if ((*pch_text == '-') || (*pch_text == '+')) {
+        u8_negative = (*pch_text == '-') ? 1u : 0u;
+        pch_text++;
+    }
+
+    for (; *pch_text != '\0'; pch_text++) {
+        if ((*pch_text == '.') && !u8_point) {
+            u8_point = 1u;
+            continue;
+        }
+        if ((*pch_text < '0') || (*pch_text > '9')) {
+            return HAL_ERROR;
+        }
+        u8_digits++;
+
+        /* Digits beyond the decimals of the result are cut */
+        if (u8_point && (u8_fraction >= u8_decimals)) {
+            continue;
+        }
+        u32_digit = (uint32_t)(*pch_text - '0');
+        if (u32_value > (0x7FFFFFFFUL - u32_digit) / 10u) {
+            return HAL_ERROR;
+        }
+        u32_value = u32_value * 10u + u32_digit;
+        u8_fraction += u8_point;
+    }
+
+    if (u8_digits == 0u) {
+        return HAL_ERROR;
+    }
+    for (; u8_fraction < u8_decimals; u8_fraction++) {
+        if (u32_value > 0x7FFFFFFFUL / 10u) {
+            return HAL_ERROR;
+        }
+        u32_value *= 10u;
+    }
+
+    *pi32_value = u8_negative ? -(int32_t)u32_value : (int32_t)u32_value;
+
+    return HAL_OK;
+}
+
+/* Static module functions -------------------------------------------------- */
+/**
+ * @brief Returns the table slot of a name, see SHELL_HASH().
+ *
+ * @param pch_name Name, not empty
+ * @return Slot
+ */
+static uint32_t shell_hash(const char *pch_name)
+{
+    uint32_t u32_length = (uint32_t)strlen(pch_name);
+
+    if (u32_length == 0u) {
+        return 0u;
+    }
+
+    return SHELL_HASH(u32_length, (uint32_t)(uint8_t)pch_name[0], (uint32_t)(uint8_t)pch_name[u32_length - 1u]);
+}
+
+/**
+ * @brief Splits a line into words and runs its command.
+ *
+ * @param pch_line Line, modified
+ * @return None
+ */
+static void shell_execute(char *pch_line)
+{
+    char *argv[SHELL_MAX_ARGS];
+    uint8_t u8_argc = 0u;
+    const shell_command_t *command;
+    char ch_buffer[SHELL_REPLY_SIZE];
+    fmt_t reply;
+
+    while (u8_argc < SHELL_MAX_ARGS) {
+        while (*pch_line == ' ') {
+            pch_line++;
+        }
+        if (*pch_line == '\0') {
+            break;
+        }
+        argv[u8_argc++] = pch_line;
+        while ((*pch_line != ' ') && (*pch_line != '\0')) {
+            pch_line++;
+        }
+        if (*pch_line != '\0') {
+            *pch_line++ = '\0';
+        }
+    }
+    if (u8_argc == 0u) {
+        return;
+    }
+
+    fmt_init(&reply, ch_buffer, sizeof(ch_buffer));
+
+    command = &g_p_shell_table[shell_hash(argv[0])];
+    if ((command->pch_name != NULL) && (strcmp(command->pch_name, argv[0]) == 0)) {
+        command->handler(u8_argc, argv, &reply);
+    } else {
+        fmt_str(&reply, "error: unknown command ");
+        fmt_str(&reply, argv[0]);
+    }
+
+    shell_reply(&reply);
+}
+
+/**
+ * @brief Hands a reply to the sink, an empty one is not sent.
+ *
+ * @param reply Reply text
+ * @return None
+ */
+static void shell_reply(const fmt_t *reply)
+{
+    if (reply->u16_length != 0u) {
+        (void)g_shell_write(fmt_get(reply), reply->u16_length);
+    }
+}
@@ -0,0 +1,199 @@
+/**
+ ******************************************************************************
+ * @file        shell.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the line based command shell.
+ *
+ * @details
+ * Reads command lines from a byte source (e.g. uart_telemetry_read()),
+ * splits them into words and calls the handler of the first word; the
+ * reply of the handler goes to a text sink. The shell runs from the main
+ * loop: one shell_poll() reads at most SHELL_BYTES_PER_RUN bytes and
+ * runs at most one command, so a low priority task stays short and
+ * interrupts (e.g. the fan PI controller) are never delayed.
+ *
+ * The commands are a perfect hash table fixed at compile time: the slot
+ * of a command is SHELL_HASH() of its length, first and last character,
+ * so the lookup is one table access and one string compare. The table is
+ * written with an X macro list of the application:
+ *
+ *     #define APP_COMMANDS(X) \
+ *         X(2, 'k', 'p', "kp",  app_cmd_kp,  "kp [gain]") \
+ *         X(3, 'r', 'm', "rpm", app_cmd_rpm, "rpm [target]")
+ *
+ *     #if (0 APP_COMMANDS(SHELL_SLOT_SUM)) != (0 APP_COMMANDS(SHELL_SLOT_OR))
+ *     #error "Two commands share a hash slot"
+ *     #endif
+ *
+ *     static const shell_command_t g_commands[SHELL_TABLE_SIZE] = {
+ *         APP_COMMANDS(SHELL_TABLE_ENTRY)
+ *     };
+ *
+ * Two commands in one slot stop the build; shell_init() rejects an
+ * entry whose length or characters do not match its name.
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - Lines end with CR or LF, words are separated by spaces
+ *  - Longer lines than SHELL_LINE_SIZE are dropped with an error reply
+ *  - Unknown commands get an error reply
+ *  - shell_parse_u32() / shell_parse_u64() / shell_parse_fixed():
+ *    arguments without strtol and float parsing
+ *
+ ******************************************************************************
+ */
+
+#ifndef SHELL_SHELL_H_
+#define SHELL_SHELL_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+#include "fmt/fmt.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief 1 to build the shell into the applications.
+ */
+#ifndef SHELL_ENABLE
+#define SHELL_ENABLE            0
+#endif
+
+/**
+ * @brief Slots of the command table, power of two, at most 32.
+ */
+#define SHELL_TABLE_SIZE        32U
+
+/**
+ * @brief Longest line including the terminator, words per line.
+ */
+#define SHELL_LINE_SIZE         64U
+#define SHELL_MAX_ARGS          6U
+
+/**
+ * @brief Size of the reply buffer of a handler.
+ */
+#define SHELL_REPLY_SIZE        128U
+
+/**
+ * @brief Bytes read per shell_poll() (bounds one run).
+ */
+#define SHELL_BYTES_PER_RUN     32U
+
+/**
+ * @brief Slot of a command from its length, first and last character
+ *        (constant expression, also in #if).
+ */
+#define SHELL_HASH(len, first, last) \
+    (((len) + 2U * (first) + 7U * (last)) & (SHELL_TABLE_SIZE - 1U))
+
+/**
+ * @brief Expansions of an X macro command list (see above).
+ */
+#define SHELL_TABLE_ENTRY(len, first, last, name, handler, help) \
+    [SHELL_HASH(len, first, last)] = { (name), (handler), (help) },
+#define SHELL_SLOT_SUM(len, first, last, name, handler, help)   + (1UL << SHELL_HASH(len, first, last))
+#define SHELL_SLOT_OR(len, first, last, name, handler, help)    | (1UL << SHELL_HASH(len, first, last))
+
+#if (SHELL_TABLE_SIZE > 32U) || ((SHELL_TABLE_SIZE & (SHELL_TABLE_SIZE - 1U)) != 0U)
+#error "SHELL_TABLE_SIZE must be a power of two up to 32"
+#endif
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Command handler.
+ *
+ * @param u8_argc Number of words including the command
+ * @param argv    Words, NUL terminated
+ * @param reply   Reply text, sent after the handler returns
+ */
+typedef void (*shell_handler_t)(uint8_t u8_argc, char *argv[], fmt_t *reply);
+
+/**
+ * @brief One slot of the command table, unused slots are zero.
+ */
+typedef struct {
+    const char     *pch_name;
+    shell_handler_t handler;
+    const char     *pch_help;   /**< Usage line */
+} shell_command_t;
+
+/**
+ * @brief Byte source, e.g. uart_telemetry_read().
+ *
+ * @return Bytes copied into pu8_data
+ */
+typedef uint16_t (*shell_read_t)(uint8_t *pu8_data, uint16_t u16_size);
+
+/**
+ * @brief Text sink of the replies, e.g. telemetry_batch_send_text().
+ */
+typedef HAL_StatusTypeDef (*shell_write_t)(const char *pch_text, uint16_t u16_length);
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Installs the command table and the byte source and sink.
+ *
+ * @param table Table of SHELL_TABLE_SIZE slots
+ * @param read  Byte source
+ * @param write Reply sink
+ * @return HAL_OK, HAL_ERROR if an entry is not in the slot of its name
+ */
+HAL_StatusTypeDef shell_init(const shell_command_t *table, shell_read_t read, shell_write_t write);
+
+/**
+ * @brief Reads up to SHELL_BYTES_PER_RUN bytes and runs at most one
+ *        command (main loop, e.g. a low priority task).
+ *
+ * @return None
+ */
+void shell_poll(void);
+
+/**
+ * @brief Appends the names of all commands, e.g. for a help command.
+ *
+ * @param reply Reply text
+ * @return None
+ */
+void shell_list(fmt_t *reply);
+
+/**
+ * @brief Appends the usage line of a command.
+ *
+ * @param pch_name Command
+ * @param reply    Reply text
+ * @return None
+ */
+void shell_usage(const char *pch_name, fmt_t *reply);
+
+/**
+ * @brief Parses a decimal unsigned integer.
+ *
+ * @param pch_text  Word
+ * @param pu32_value Result
+ * @return HAL_OK, HAL_ERROR if the word is no number or too large
+ */
+HAL_StatusTypeDef shell_parse_u32(const char *pch_text, uint32_t *pu32_value);
+
+/**
+ * @brief Parses a decimal unsigned 64 bit integer (e.g. a time in us).
+ *
+ * @param pch_text   Word
+ * @param pu64_value Result
+ * @return HAL_OK, HAL_ERROR if the word is no number or too large
+ */
+HAL_StatusTypeDef shell_parse_u64(const char *pch_text, uint64_t *pu64_value);
+
+/**
+ * @brief Parses a decimal fraction into a fixed-point value
+ *        ("-0.045" with 4 decimals: -450), further digits are cut.
+ *
+ * @param pch_text    Word
+ * @param u8_decimals Decimals of the result (0 .. FMT_MAX_DECIMALS)
+ * @param pi32_value  Result
+ * @return HAL_OK, HAL_ERROR if the word is no number or too large
+ */
+HAL_StatusTypeDef shell_parse_fixed(const char *pch_text, uint8_t u8_decimals, int32_t *pi32_value);
+
+#endif /* SHELL_SHELL_H_ */
@@ -0,0 +1,454 @@
+/**
+ ******************************************************************************
+ * @file        siginject.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       DAC signal injection for hardware in the loop tests.
+ *
+ * Functionality:
+ * - Trigger timer: ARR preloaded, TRGO on update; the DAC transfers its
+ *   holding register at the update and requests the next sample at once
+ * - Per-sample durations: TIMx_UP DMA writes the next ARR at the same
+ *   update, it becomes active at the one after (preload), which is why
+ *   the first two periods come from the priming
+ * - Streams claimed in siginject_start() and released in siginject_stop(),
+ *   the stream interrupt only runs for the callbacks
+ *
+ * Resources:
+ * - DAC channel 1 (PA4), TIM5, DAC1 and TIM5_UP requests of dma_alloc
+ * - DAC channel 2 (PA5), TIM7, DAC2 and TIM7_UP requests of dma_alloc
+ * - No timer interrupts (the TIM5 / TIM7 vectors belong to other modules)
+ ******************************************************************************
+ */
+
+#include "siginject.h"
+#include "dma_alloc/dma_alloc.h"
+#include "health/health.h"
+#include "irq/irq.h"
+#include "tim_alloc/tim_alloc.h"
+#include "timebase/timebase.h"
+
+/* Preprocessor Defines ----------------------------------------------------- */
+/**
+ * @brief Priority of the DMA stream interrupts (callbacks).
+ */
+#define SIGINJECT_IRQ_PRIORITY      IRQ_CLASS_TRANSFER
+
+/**
+ * @brief Shortest sample in timer ticks: the reload DMA needs the period
+ *        to write the next ARR.
+ */
+#define SIGINJECT_MIN_TICKS         2U
+
+/* Static module variables -------------------------------------------------- */
+/**
+ * @brief Fixed hardware of an output.
+ */
+typedef struct {
+    TIM_TypeDef        *tim;
+    uint32_t            u32_channel;    /**< DAC_CHANNEL_x, also the bit shift in DAC->CR */
+    uint32_t            u32_trigger;    /**< DAC_TRIGGER_Tx_TRGO                */
+    uint16_t            u16_pin;        /**< GPIOA pin                          */
+    uint8_t             u8_keep_af;     /**< Alternate function left on the pin, 0xFF none */
+    uint32_t            u32_arr_max;    /**< 16 or 32 bit counter               */
+    dma_alloc_request_t sample_request;
+    dma_alloc_request_t reload_request;
+} siginject_hw_t;
+
+/**
+ * @brief State of an output.
+ */
+typedef struct {
+    DMA_HandleTypeDef    sample_dma;
+    DMA_HandleTypeDef    reload_dma;
+    siginject_wave_t     wave;
+    siginject_callback_t callback;
+    siginject_stats_t    stats;
+    uint8_t              u8_init;
+    uint8_t              u8_started;    /**< Timer and streams active       */
+} siginject_state_t;
+
+static const siginject_hw_t g_siginject_hw[SIGINJECT_OUTS] = {
+    [SIGINJECT_OUT1] = { TIM5, DAC_CHANNEL_1, DAC_TRIGGER_T5_TRGO, GPIO_PIN_4, 0xFFU, 0xFFFFFFFFU,
+                         DMA_ALLOC_REQ_DAC1, DMA_ALLOC_REQ_TIM5_UP },
+    [SIGINJECT_OUT2] = { TIM7, DAC_CHANNEL_2, DAC_TRIGGER_T7_TRGO, GPIO_PIN_5, GPIO_AF1_TIM2, 0x0000FFFFU,
+                         DMA_ALLOC_REQ_DAC2, DMA_ALLOC_REQ_TIM7_UP },
+};
+
+static siginject_state_t g_siginject_state[SIGINJECT_OUTS];
+
+/**
+ * @brief DAC handle, shared by both channels.
+ */
+static DAC_HandleTypeDef g_siginject_dac = { .Instance = DAC };
+
+/* Static function prototypes ----------------------------------------------- */
+static HAL_StatusTypeDef siginject_claim_dma(DMA_HandleTypeDef *hdma, dma_alloc_request_t request,
+                                             uint32_t u32_align, uint32_t u32_mode);
+static volatile uint32_t *siginject_dhr(siginject_out_t out);
+static uint32_t siginject_dor(siginject_out_t out);
+static void siginject_dma_half(DMA_HandleTypeDef *hdma);
+static void siginject_dma_complete(DMA_HandleTypeDef *hdma);
+static siginject_out_t siginject_find(const DMA_HandleTypeDef *hdma);
+
+/* Public functions --------------------------------------------------------- */
+HAL_StatusTypeDef siginject_init(siginject_out_t out)
+{
+    GPIO_InitTypeDef gpio = { 0 };
+    DAC_ChannelConfTypeDef config = { 0 };
+    HAL_StatusTypeDef status;
+
+    if (out >= SIGINJECT_OUTS) {
+        return HAL_ERROR;
+    }
+    const siginject_hw_t *hw = &g_siginject_hw[out];
+
+    status = tim_alloc_claim(hw->tim, TIM_ALLOC_OWNER_SIGINJECT);
+    if (status != HAL_OK) {
+        return status;
+    }
+
+    timebase_init();
+
+    /* The fan capture input on PA5 (TIM2 CH1) stays, the DAC drives it anyway */
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+    uint32_t u32_position = POSITION_VAL(hw->u16_pin);
+    if ((((GPIOA->MODER >> (2U * u32_position)) & 0x3U) != 0x2U) ||
+        (((GPIOA->AFR[u32_position >> 3] >> (4U * (u32_position & 0x7U))) & 0xFU) != hw->u8_keep_af)) {
+        gpio.Pin  = hw->u16_pin;
+        gpio.Mode = GPIO_MODE_ANALOG;
+        gpio.Pull = GPIO_NOPULL;
+        HAL_GPIO_Init(GPIOA, &gpio);
+    }
+
+    __HAL_RCC_DAC_CLK_ENABLE();
+    if (g_siginject_dac.State == HAL_DAC_STATE_RESET) {
+        if (HAL_DAC_Init(&g_siginject_dac) != HAL_OK) {
+            return HAL_ERROR;
+        }
+    }
+
+    config.DAC_Trigger      = hw->u32_trigger;
+    config.DAC_OutputBuffer = DAC_OUTPUTBUFFER_ENABLE;
+    if (HAL_DAC_ConfigChannel(&g_siginject_dac, &config, hw->u32_channel) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    /* Without a waveform the trigger is off: a holding register write goes out directly */
+    DAC->CR &= ~(DAC_CR_TEN1 << hw->u32_channel);
+    *siginject_dhr(out) = SIGINJECT_LEVEL_LOW;
+    DAC->CR |= DAC_CR_EN1 << hw->u32_channel;
+
+    g_siginject_state[out].u8_init = 1U;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef siginject_start(siginject_out_t out, const siginject_wave_t *wave,
+                                  siginject_callback_t callback)
+{
+    uint32_t u32_first;
+    uint32_t u32_primer;
+    uint32_t u32_prescaler;
+    HAL_StatusTypeDef status;
+
+    if ((out >= SIGINJECT_OUTS) || !g_siginject_state[out].u8_init || (wave == NULL) ||
+        (wave->pu16_samples == NULL) || (wave->u16_count < 2U) || (wave->u32_tick_hz == 0U)) {
+        return HAL_ERROR;
+    }
+    const siginject_hw_t *hw = &g_siginject_hw[out];
+    siginject_state_t *state = &g_siginject_state[out];
+
+    siginject_stop(out);
+
+    /* Only exact rates: a rounded divider would stretch every duration */
+    uint32_t u32_clock = tim_alloc_get_clock(hw->tim);
+    if (((u32_clock % wave->u32_tick_hz) != 0U) || ((u32_clock / wave->u32_tick_hz) > 0x10000U)) {
+        return HAL_ERROR;
+    }
+    u32_prescaler = (u32_clock / wave->u32_tick_hz) - 1U;
+
+    if (wave->pu32_reloads != NULL) {
+        for (uint16_t i = 0; i < wave->u16_count; i++) {
+            if ((wave->pu32_reloads[i] < (SIGINJECT_MIN_TICKS - 1U)) || (wave->pu32_reloads[i] > hw->u32_arr_max)) {
+                return HAL_ERROR;
+            }
+        }
+    } else if ((wave->u32_period_ticks < SIGINJECT_MIN_TICKS) || ((wave->u32_period_ticks - 1U) > hw->u32_arr_max)) {
+        return HAL_ERROR;
+    }
+
+    /*
+     * Priming: the first update outputs the holding register with the
+     * duration in the preload, the DMA then brings sample 0 (and its
+     * duration, active from the second update on). Looped this is the
+     * last sample, so every pass has the same timing.
+     */
+    if (wave->pu32_reloads == NULL) {
+        u32_first  = wave->u32_period_ticks - 1U;
+        u32_primer = u32_first;
+    } else if (wave->u8_loop) {
+        u32_first  = wave->pu32_reloads[0];
+        u32_primer = wave->pu32_reloads[wave->u16_count - 1U];
+    } else {
+        u32_first  = wave->pu32_reloads[0];
+        u32_primer = u32_first;
+    }
+
+    uint32_t u32_mode = wave->u8_loop ? DMA_CIRCULAR : DMA_NORMAL;
+    status = siginject_claim_dma(&state->sample_dma, hw->sample_request, DMA_PDATAALIGN_HALFWORD, u32_mode);
+    if ((status == HAL_OK) && (wave->pu32_reloads != NULL)) {
+        status = siginject_claim_dma(&state->reload_dma, hw->reload_request, DMA_PDATAALIGN_WORD, u32_mode);
+    }
+    if (status != HAL_OK) {
+        dma_alloc_release(&state->sample_dma);
+        return status;
+    }
+
+    state->wave     = *wave;
+    state->callback = callback;
+    state->stats    = (siginject_stats_t){ 0 };
+
+    hw->tim->CR1  = 0U;
+    hw->tim->DIER = 0U;
+    hw->tim->CR2  = 0U;
+    hw->tim->PSC  = u32_prescaler;
+    hw->tim->ARR  = u32_first;
+    hw->tim->CNT  = 0U;
+    hw->tim->CR1  = TIM_CR1_ARPE;
+    hw->tim->EGR  = TIM_EGR_UG;         /* Loads PSC and the first period */
+    hw->tim->SR   = 0U;
+    hw->tim->ARR  = u32_primer;
+    hw->tim->CR2  = TIM_TRGO_UPDATE;
+
+    *siginject_dhr(out) = wave->u8_loop ? wave->pu16_samples[wave->u16_count - 1U] : siginject_dor(out);
+    DAC->SR = DAC_SR_DMAUDR1 << hw->u32_channel;
+    DAC->CR |= (DAC_CR_TEN1 | DAC_CR_DMAEN1) << hw->u32_channel;
+
+    state->sample_dma.XferHalfCpltCallback = siginject_dma_half;
+    state->sample_dma.XferCpltCallback     = siginject_dma_complete;
+    (void)HAL_DMA_Start_IT(&state->sample_dma, (uint32_t)(uintptr_t)wave->pu16_samples,
+                           (uint32_t)(uintptr_t)siginject_dhr(out), wave->u16_count);
+    HAL_NVIC_SetPriority(dma_alloc_get_irqn(&state->sample_dma), SIGINJECT_IRQ_PRIORITY, 0U);
+    HAL_NVIC_EnableIRQ(dma_alloc_get_irqn(&state->sample_dma));
+
+    if (wave->pu32_reloads != NULL) {
+        (void)HAL_DMA_Start(&state->reload_dma, (uint32_t)(uintptr_t)wave->pu32_reloads,
+                            (uint32_t)(uintptr_t)&hw->tim->ARR, wave->u16_count);
+        hw->tim->DIER = TIM_DIER_UDE;
+    }
+
+    state->u8_started       = 1U;
+    state->stats.u8_running = 1U;
+    hw->tim->CR1 |= TIM_CR1_CEN;
+
+    return HAL_OK;
+}
+
+void siginject_stop(siginject_out_t out)
+{
+    if ((out >= SIGINJECT_OUTS) || !g_siginject_state[out].u8_started) {
+        return;
+    }
+    const siginject_hw_t *hw = &g_siginject_hw[out];
+    siginject_state_t *state = &g_siginject_state[out];
+
+    hw->tim->CR1  = 0U;
+    hw->tim->DIER = 0U;
+
+    /* The value on the pin stays when the trigger is switched off */
+    *siginject_dhr(out) = siginject_dor(out);
+    DAC->CR &= ~((DAC_CR_TEN1 | DAC_CR_DMAEN1) << hw->u32_channel);
+
+    (void)HAL_DMA_Abort(&state->sample_dma);
+    dma_alloc_release(&state->sample_dma);
+    if (state->wave.pu32_reloads != NULL) {
+        (void)HAL_DMA_Abort(&state->reload_dma);
+        dma_alloc_release(&state->reload_dma);
+    }
+
+    state->u8_started       = 0U;
+    state->stats.u8_running = 0U;
+}
+
+HAL_StatusTypeDef siginject_set_level(siginject_out_t out, uint16_t u16_value)
+{
+    if ((out >= SIGINJECT_OUTS) || !g_siginject_state[out].u8_init) {
+        return HAL_ERROR;
+    }
+
+    siginject_stop(out);
+    *siginject_dhr(out) = (u16_value > SIGINJECT_LEVEL_HIGH) ? SIGINJECT_LEVEL_HIGH : u16_value;
+
+    return HAL_OK;
+}
+
+void siginject_get_stats(siginject_out_t out, siginject_stats_t *stats)
+{
+    if (out >= SIGINJECT_OUTS) {
+        *stats = (siginject_stats_t){ 0 };
+        return;
+    }
+
+    /* After an underrun the DAC makes no more requests, the waveform has stopped */
+    uint32_t u32_flag = DAC_SR_DMAUDR1 << g_siginject_hw[out].u32_channel;
+    if (DAC->SR & u32_flag) {
+        DAC->SR = u32_flag;
+        g_siginject_state[out].stats.u32_underruns++;
+        g_siginject_state[out].stats.u8_running = 0U;
+    }
+
+    *stats = g_siginject_state[out].stats;
+}
+
+void siginject_ramp(uint16_t *pu16_samples, uint16_t u16_count, uint16_t u16_from, uint16_t u16_to)
+{
+    int32_t s32_span = (int32_t)u16_to - (int32_t)u16_from;
+
+    if (u16_count == 1U) {
+        pu16_samples[0] = u16_to;
+        return;
+    }
+    for (uint16_t i = 0; i < u16_count; i++) {
+        pu16_samples[i] = (uint16_t)((int32_t)u16_from + (s32_span * (int32_t)i) / (int32_t)(u16_count - 1U));
+    }
+}
+
+HAL_StatusTypeDef siginject_tacho(uint16_t *pu16_samples, uint32_t *pu32_reloads, uint16_t u16_pulses,
+                                  uint32_t u32_rpm, uint32_t u32_tick_hz)
+{
+    /* Edge j at j * tick_hz * 60 / (rpm * pulses * 2) ticks */
+    uint64_t u64_divisor = (uint64_t)u32_rpm * SIGINJECT_TACHO_PULSES * 2U;
+    uint64_t u64_ticks = (uint64_t)u32_tick_hz * 60U;
+    uint32_t u32_edge = 0U;
+
+    if ((u32_rpm == 0U) || (u16_pulses == 0U)) {
+        return HAL_ERROR;
+    }
+
+    for (uint32_t j = 0; j < 2U * u16_pulses; j++) {
+        uint32_t u32_next = (uint32_t)(((uint64_t)(j + 1U) * u64_ticks) / u64_divisor);
+        uint32_t u32_length = u32_next - u32_edge;
+
+        if (u32_length < SIGINJECT_MIN_TICKS) {
+            return HAL_ERROR;
+        }
+        pu16_samples[j] = (j & 1U) ? SIGINJECT_LEVEL_HIGH : SIGINJECT_LEVEL_LOW;
+        pu32_reloads[j] = u32_length - 1U;
+        u32_edge = u32_next;
+    }
+
+    return HAL_OK;
+}
+
+/* Static functions --------------------------------------------------------- */
+/**
+ * @brief Claims and initialises a memory to peripheral stream.
+ *
+ * @param hdma      Handle
+ * @param request   DMA request
+ * @param u32_align DMA_PDATAALIGN_HALFWORD (samples) or _WORD (reloads),
+ *                  memory side the same
+ * @param u32_mode  DMA_CIRCULAR or DMA_NORMAL
+ * @return HAL_OK, HAL_BUSY if the streams of the request are taken,
+ *         HAL_ERROR
+ */
+static HAL_StatusTypeDef siginject_claim_dma(DMA_HandleTypeDef *hdma, dma_alloc_request_t request,
+                                             uint32_t u32_align, uint32_t u32_mode)
+{
+    /* A late reload would stretch a sample: high stream priority */
+    HAL_StatusTypeDef status = dma_alloc_claim(hdma, request, DMA_ALLOC_LATENCY_SAMPLED, HEALTH_ISR_COUNT);
+
+    if (status != HAL_OK) {
+        return status;
+    }
+
+    hdma->Init.Direction           = DMA_MEMORY_TO_PERIPH;
+    hdma->Init.PeriphInc           = DMA_PINC_DISABLE;
+    hdma->Init.MemInc              = DMA_MINC_ENABLE;
+    hdma->Init.PeriphDataAlignment = u32_align;
+    hdma->Init.MemDataAlignment    = (u32_align == DMA_PDATAALIGN_WORD) ? DMA_MDATAALIGN_WORD : DMA_MDATAALIGN_HALFWORD;
+    hdma->Init.Mode                = u32_mode;
+    hdma->Init.FIFOMode            = DMA_FIFOMODE_DISABLE;
+
+    if (HAL_DMA_Init(hdma) != HAL_OK) {
+        dma_alloc_release(hdma);
+        return HAL_ERROR;
+    }
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Returns the 12 bit right aligned holding register of an output.
+ *
+ * @param out Output
+ * @return Register
+ */
+static volatile uint32_t *siginject_dhr(siginject_out_t out)
+{
+    return (out == SIGINJECT_OUT1) ? &DAC->DHR12R1 : &DAC->DHR12R2;
+}
+
+/**
+ * @brief Returns the value on an output.
+ *
+ * @param out Output
+ * @return 0 .. SIGINJECT_LEVEL_HIGH
+ */
+static uint32_t siginject_dor(siginject_out_t out)
+{
+    return (out == SIGINJECT_OUT1) ? DAC->DOR1 : DAC->DOR2;
+}
+
+/**
+ * @brief Half transfer of the sample stream.
+ *
+ * @param hdma Sample stream
+ * @return None
+ */
+static void siginject_dma_half(DMA_HandleTypeDef *hdma)
+{
+    siginject_out_t out = siginject_find(hdma);
+    siginject_state_t *state = &g_siginject_state[out];
+
+    if (state->callback != NULL) {
+        state->callback(out, (uint16_t)((state->wave.u16_count - 1U) / 2U), timebase_now32());
+    }
+}
+
+/**
+ * @brief Full transfer of the sample stream: counts the pass, ends a
+ *        waveform played once.
+ *
+ * @param hdma Sample stream
+ * @return None
+ */
+static void siginject_dma_complete(DMA_HandleTypeDef *hdma)
+{
+    siginject_out_t out = siginject_find(hdma);
+    siginject_state_t *state = &g_siginject_state[out];
+    uint32_t u32_stamp = timebase_now32();
+
+    state->stats.u32_loops++;
+    if (!state->wave.u8_loop) {
+        /* No more requests: the last sample is output at the next update and stays */
+        DAC->CR &= ~(DAC_CR_DMAEN1 << g_siginject_hw[out].u32_channel);
+        state->stats.u8_running = 0U;
+    }
+    if (state->callback != NULL) {
+        state->callback(out, (uint16_t)(state->wave.u16_count - 1U), u32_stamp);
+    }
+}
+
+/**
+ * @brief Returns the output of a sample stream handle.
+ *
+ * @param hdma Handle
+ * @return Output
+ */
+static siginject_out_t siginject_find(const DMA_HandleTypeDef *hdma)
+{
+    return (hdma == &g_siginject_state[SIGINJECT_OUT2].sample_dma) ? SIGINJECT_OUT2 : SIGINJECT_OUT1;
+}
@@ -0,0 +1,206 @@
+/**
+ ******************************************************************************
+ * @file        siginject.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the DAC signal injection for hardware in
+ *              the loop tests.
+ *
+ * @details
+ * Replays a waveform on a DAC output into an input of the board, so the
+ * real input paths (ADC + potis_dma, tacho + fan) see the same signal in
+ * every run instead of a hand-turned knob:
+ *
+ *      SIGINJECT_OUT1  PA4 (DAC1)  ->  PA6 (POTI_1), wiper disconnected
+ *      SIGINJECT_OUT2  PA5 (DAC2)  ->  PE6 (fan tacho, EXTI mode), fan
+ *                                      tacho disconnected
+ *
+ * With FAN_TACHO_CAPTURE the tacho input is PA5 (TIM2 CH1) itself: the
+ * capture function stays on the pin, the enabled DAC channel drives it
+ * anyway (RM0090, DAC output connection), no wire. The capture stream is
+ * DMA1 stream 5, the one of DAC1: OUT1 waveforms then get HAL_BUSY.
+ * PA4 is LTDC VSYNC and PA6 LTDC G2 on the discovery board, so the
+ * framebuffer backend cannot run at the same time.
+ *
+ * Every output has its own trigger timer (OUT1: TIM5, OUT2: TIM7, both
+ * claimed from tim_alloc). A timer update triggers the DAC, the DAC moves
+ * its holding register to the output and requests the next sample by
+ * DMA. With a duration table a second DMA stream writes the next auto
+ * reload value at the same update, so every sample has its own length:
+ * a tacho pulse train is two entries per pulse instead of thousands of
+ * samples at a fixed rate.
+ *
+ * Pipeline after siginject_start(): the first update comes after
+ * pu32_reloads[0] + 1 ticks (fixed rate: one period) and outputs the
+ * primed value (looped: the last sample, once: the current output) for
+ * one more period, then sample k follows with its duration k. A loop
+ * therefore starts phase shifted by one sample, everything after is
+ * exact to the timer tick. The callback gets the index of the sample the
+ * DMA just loaded: it appears on the output one sample later, at the
+ * next update.
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - Two outputs, 12 bit, output buffer on
+ *  - Fixed rate (u32_period_ticks) or per-sample durations (pu32_reloads),
+ *    tick rate from 1 Hz to the timer clock (exact divider only)
+ *  - Once (the last sample stays) or looped
+ *  - Callbacks at half and full buffer with a timebase stamp, loop and
+ *    underrun counters
+ *  - Waveform helpers: linear ramp, constant speed tacho pulse train
+ *
+ * modules/siginject/siginject_convert.py turns a trace_decode.py CSV
+ * (potis, fan_rpm) into these tables.
+ *
+ ******************************************************************************
+ */
+
+#ifndef SIGINJECT_SIGINJECT_H_
+#define SIGINJECT_SIGINJECT_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief 1 to run the hardware in the loop benchmarks (B0_Benchmarks),
+ *        needs the wiring above.
+ */
+#ifndef SIGINJECT_ENABLE
+#define SIGINJECT_ENABLE            0
+#endif
+
+/**
+ * @brief Full scale and zero of an output.
+ */
+#define SIGINJECT_LEVEL_HIGH        4095U
+#define SIGINJECT_LEVEL_LOW         0U
+
+/**
+ * @brief Tacho pulses per fan revolution (same as the fan module).
+ */
+#define SIGINJECT_TACHO_PULSES      2U
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Outputs.
+ */
+typedef enum {
+    SIGINJECT_OUT1 = 0,             /**< PA4, DAC channel 1, TIM5          */
+    SIGINJECT_OUT2,                 /**< PA5, DAC channel 2, TIM7          */
+    SIGINJECT_OUTS
+} siginject_out_t;
+
+/**
+ * @brief Waveform. The tables are read by DMA while it plays: static or
+ *        kept until siginject_stop().
+ */
+typedef struct {
+    const uint16_t *pu16_samples;   /**< 12 bit output values              */
+    const uint32_t *pu32_reloads;   /**< Per sample: duration in ticks - 1,
+                                         NULL for a fixed rate              */
+    uint16_t        u16_count;      /**< Samples (and reloads), at least 2 */
+    uint32_t        u32_tick_hz;    /**< Timer tick rate                   */
+    uint32_t        u32_period_ticks; /**< Fixed rate: ticks per sample    */
+    uint8_t         u8_loop;        /**< 1: repeat until siginject_stop()  */
+} siginject_wave_t;
+
+/**
+ * @brief Called from the DMA interrupt when the first half or the whole
+ *        buffer has been loaded.
+ *
+ * @param out       Output
+ * @param u16_index Sample just loaded (appears at the next update)
+ * @param u32_stamp timebase_now32() of the interrupt
+ */
+typedef void (*siginject_callback_t)(siginject_out_t out, uint16_t u16_index, uint32_t u32_stamp);
+
+/**
+ * @brief State of an output.
+ */
+typedef struct {
+    uint32_t u32_loops;             /**< Buffers loaded completely         */
+    uint32_t u32_underruns;         /**< DAC DMA underruns (rate too high) */
+    uint8_t  u8_running;            /**< Waveform playing                  */
+} siginject_stats_t;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Claims the trigger timer, sets up the pin and enables the DAC
+ *        channel at SIGINJECT_LEVEL_LOW.
+ *
+ * @param out Output
+ * @return HAL_OK, HAL_BUSY if the timer belongs to another module,
+ *         HAL_ERROR for an invalid output or a DAC error
+ */
+HAL_StatusTypeDef siginject_init(siginject_out_t out);
+
+/**
+ * @brief Starts a waveform (a running one is stopped first).
+ *
+ * @param out      Output, siginject_init() done
+ * @param wave     Waveform, copied (not the tables)
+ * @param callback Half / full buffer callback, NULL for none
+ * @return HAL_OK, HAL_BUSY if a DMA stream is taken, HAL_ERROR for an
+ *         invalid waveform or a tick rate the timer clock cannot be
+ *         divided to exactly
+ */
+HAL_StatusTypeDef siginject_start(siginject_out_t out, const siginject_wave_t *wave,
+                                  siginject_callback_t callback);
+
+/**
+ * @brief Stops the waveform, the output keeps its value.
+ *
+ * @param out Output
+ * @return None
+ */
+void siginject_stop(siginject_out_t out);
+
+/**
+ * @brief Sets the output directly (stops a waveform).
+ *
+ * @param out       Output
+ * @param u16_value 0 .. SIGINJECT_LEVEL_HIGH
+ * @return HAL_OK, HAL_ERROR before siginject_init()
+ */
+HAL_StatusTypeDef siginject_set_level(siginject_out_t out, uint16_t u16_value);
+
+/**
+ * @brief Copies the state of an output.
+ *
+ * @param out   Output
+ * @param stats Destination
+ * @return None
+ */
+void siginject_get_stats(siginject_out_t out, siginject_stats_t *stats);
+
+/**
+ * @brief Fills a linear ramp (a potentiometer sweep).
+ *
+ * @param pu16_samples Destination
+ * @param u16_count    Samples, the first is u16_from, the last u16_to
+ * @param u16_from     Start value
+ * @param u16_to       End value
+ * @return None
+ */
+void siginject_ramp(uint16_t *pu16_samples, uint16_t u16_count, uint16_t u16_from, uint16_t u16_to);
+
+/**
+ * @brief Fills a tacho pulse train of constant speed: low and high half
+ *        of every pulse, SIGINJECT_TACHO_PULSES per revolution.
+ *
+ * Half periods that do not divide into ticks are spread over the train,
+ * the mean speed is exact to the tick.
+ *
+ * @param pu16_samples Destination, 2 * u16_pulses levels
+ * @param pu32_reloads Destination, 2 * u16_pulses reload values
+ * @param u16_pulses   Pulses
+ * @param u32_rpm      Speed, > 0
+ * @param u32_tick_hz  Tick rate of the waveform
+ * @return HAL_OK, HAL_ERROR if a half period is shorter than 2 ticks
+ */
+HAL_StatusTypeDef siginject_tacho(uint16_t *pu16_samples, uint32_t *pu32_reloads, uint16_t u16_pulses,
+                                  uint32_t u32_rpm, uint32_t u32_tick_hz);
+
+#endif /* SIGINJECT_SIGINJECT_H_ */
@@ -0,0 +1,162 @@
+#!/usr/bin/env python3
+"""Converter from trace_decode.py CSV recordings to siginject waveforms.
+
+Reads the CSV of modules/trace/trace_decode.py (time_us, channel, field,
+value) and writes a C file with the tables and the siginject_wave_t of
+one recorded signal, to be replayed by siginject_start():
+
+``--field potis.poti_1`` (or any other channel.field) resamples the
+values at ``--rate`` Hz, held between two records; the values are ADC
+counts and go to the DAC unchanged (same reference, 12 bit). Fixed rate
+waveform, no duration table.
+
+``--tacho`` turns the fan_rpm.rpm records into the tacho pulse train of
+that speed course: two pulses per revolution, high and low half of every
+pulse one entry with its own duration. Halves longer than the 16 bit
+timer of SIGINJECT_OUT2 (or a stopped fan) are split into entries of the
+same level.
+
+Only the standard library is needed.
+
+Usage:
+    siginject_convert.py trace.csv --field potis.poti_1 [--rate 1000] [--name sweep] [-o sweep.c]
+    siginject_convert.py trace.csv --tacho [--tick 1000000] [--name run] [-o run.c]
+"""
+
+import argparse
+import csv
+import sys
+
+# See siginject.h
+LEVEL_HIGH = 4095
+LEVEL_LOW = 0
+TACHO_PULSES = 2
+MIN_TICKS = 2
+MAX_TICKS = 0x10000
+MAX_COUNT = 0xFFFF
+
+
+def read_series(path, channel, field):
+    """Returns the (time_us, value) records of one channel field."""
+    points = []
+    with open(path, newline="") as file:
+        for row in csv.DictReader(file):
+            if row["channel"] == channel and row["field"] == field:
+                points.append((float(row["time_us"]), int(row["value"])))
+    points.sort()
+    return points
+
+
+def resample(points, rate):
+    """Values at a fixed rate, each record held until the next."""
+    samples = []
+    start = points[0][0]
+    end = points[-1][0]
+    index = 0
+    step = 1e6 / rate
+    time = start
+    while time <= end:
+        while index + 1 < len(points) and points[index + 1][0] <= time:
+            index += 1
+        samples.append(max(0, min(LEVEL_HIGH, points[index][1])))
+        time += step
+    return samples
+
+
+def tacho(points, tick):
+    """Levels and reload values of the pulse train of a speed course."""
+    levels = []
+    reloads = []
+    level = LEVEL_LOW
+    half = 0.0          # fraction of the current half pulse done
+    ticks = 0.0         # ticks spent in the current half pulse
+
+    def emit(length):
+        levels.append(level)
+        reloads.append(length - 1)
+
+    for (time, rpm), (next_time, _) in zip(points, points[1:]):
+        rest = (next_time - time) * tick / 1e6
+        rate = rpm * TACHO_PULSES * 2 / 60.0 / tick     # halves per tick
+        while rest > 0:
+            if rate > 0 and (1.0 - half) / rate <= rest:
+                ticks += (1.0 - half) / rate
+                rest -= (1.0 - half) / rate
+                length = max(MIN_TICKS, int(round(ticks)))
+                while length > MAX_TICKS:
+                    emit(MAX_TICKS)
+                    length -= MAX_TICKS
+                emit(max(MIN_TICKS, length))
+                level = LEVEL_HIGH if level == LEVEL_LOW else LEVEL_LOW
+                half = 0.0
+                ticks = 0.0
+            else:
+                half += rate * rest
+                ticks += rest
+                rest = 0
+                while ticks >= MAX_TICKS:
+                    emit(MAX_TICKS)
+                    ticks -= MAX_TICKS
+    return levels, reloads
+
+
+def write_array(out, ctype, name, values):
+    out.write("static const %s %s[%d] = {\n" % (ctype, name, len(values)))
+    for pos in range(0, len(values), 8):
+        out.write("    " + ", ".join("%du" % v for v in values[pos:pos + 8]) + ",\n")
+    out.write("};\n\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("csv", help="CSV of trace_decode.py")
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument("--field", help="channel.field to replay, e.g. potis.poti_1")
+    source.add_argument("--tacho", action="store_true", help="pulse train of fan_rpm.rpm")
+    parser.add_argument("--rate", type=int, default=1000, help="sample rate of --field in Hz")
+    parser.add_argument("--tick", type=int, default=1000000, help="timer tick rate in Hz")
+    parser.add_argument("--loop", action="store_true", help="repeat the waveform")
+    parser.add_argument("--name", default="wave", help="name of the C symbols")
+    parser.add_argument("-o", "--output", help="output file, default stdout")
+    args = parser.parse_args()
+
+    if args.tacho:
+        points = read_series(args.csv, "fan_rpm", "rpm")
+    else:
+        channel, _, field = args.field.partition(".")
+        points = read_series(args.csv, channel, field)
+    if len(points) < 2:
+        sys.exit("less than two records of the signal in %s" % args.csv)
+
+    if args.tacho:
+        samples, reloads = tacho(points, args.tick)
+        period = 0
+    else:
+        if args.tick % args.rate:
+            sys.exit("--tick must be a multiple of --rate")
+        samples = resample(points, args.rate)
+        reloads = None
+        period = args.tick // args.rate
+    if not 2 <= len(samples) <= MAX_COUNT:
+        sys.exit("%d samples, siginject takes 2 .. %d" % (len(samples), MAX_COUNT))
+
+    out = open(args.output, "w") if args.output else sys.stdout
+    out.write("/* Generated by siginject_convert.py from %s, %d samples */\n\n" % (args.csv, len(samples)))
+    out.write('#include "siginject/siginject.h"\n\n')
+    write_array(out, "uint16_t", "%s_samples" % args.name, samples)
+    if reloads is not None:
+        write_array(out, "uint32_t", "%s_reloads" % args.name, reloads)
+    out.write("const siginject_wave_t %s_wave = {\n" % args.name)
+    out.write("    .pu16_samples     = %s_samples,\n" % args.name)
+    out.write("    .pu32_reloads     = %s,\n" % ("%s_reloads" % args.name if reloads is not None else "NULL"))
+    out.write("    .u16_count        = %du,\n" % len(samples))
+    out.write("    .u32_tick_hz      = %du,\n" % args.tick)
+    out.write("    .u32_period_ticks = %du,\n" % period)
+    out.write("    .u8_loop          = %du,\n" % (1 if args.loop else 0))
+    out.write("};\n")
+    if out is not sys.stdout:
+        out.close()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,275 @@
+/**
+ ******************************************************************************
+ * @file        stats.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Streaming statistics
+ *
+ * Functionality:
+ * - Welford mean and variance, min and max
+ * - EWMA with a power-of-two weight, integer ratio smoothing
+ * - Fixed-bin histogram
+ * - P-square quantile estimate
+ *
+ * Resources:
+ * - None (pure computation, also built on the host)
+ ******************************************************************************
+ */
+
+#include "stats.h"
+
+#include <math.h>
+#include <string.h>
+
+/* Static function prototypes ----------------------------------------------- */
+static void stats_p2_adjust(stats_p2_t *p2, uint8_t i);
+
+/* Public functions --------------------------------------------------------- */
+void stats_welford_reset(stats_welford_t *stats)
+{
+    stats->u32_count = 0u;
+    stats->f_mean    = 0.0f;
+    stats->f_m2      = 0.0f;
+    stats->f_min     = 0.0f;
+    stats->f_max     = 0.0f;
+}
+
+void stats_welford_add(stats_welford_t *stats, float f_x)
+{
+    float f_delta = f_x - stats->f_mean;
+
+    stats->u32_count++;
+    stats->f_mean += f_delta / (float)stats->u32_count;
+    /* Deviation from the old and the new mean, no large squares */
+    stats->f_m2 += f_delta * (f_x - stats->f_mean);
+
+    if ((stats->u32_count == 1u) || (f_x < stats->f_min)) {
+        stats->f_min = f_x;
+    }
+    if ((stats->u32_count == 1u) || (f_x > stats->f_max)) {
+        stats->f_max = f_x;
+    }
+}
+
+float stats_welford_get_variance(const stats_welford_t *stats)
+{
+    if (stats->u32_count < 2u) {
+        return 0.0f;
+    }
+
+    return stats->f_m2 / (float)(stats->u32_count - 1u);
+}
+
+float stats_welford_get_stddev(const stats_welford_t *stats)
+{
+    return sqrtf(stats_welford_get_variance(stats));
+}
+
+void stats_ewma_init(stats_ewma_t *ewma, uint8_t u8_shift)
+{
+    ewma->i32_state = 0;
+    ewma->u8_shift  = (u8_shift > STATS_EWMA_MAX_SHIFT) ? (uint8_t)STATS_EWMA_MAX_SHIFT : u8_shift;
+    ewma->u8_primed = 0u;
+}
+
+int32_t stats_ewma_add(stats_ewma_t *ewma, int32_t i32_x)
+{
+    if (!ewma->u8_primed) {
+        ewma->i32_state = i32_x * (1L << ewma->u8_shift);
+        ewma->u8_primed = 1u;
+    } else {
+        /* state / 2^shift moves by (x - mean) / 2^shift */
+        ewma->i32_state += i32_x - (ewma->i32_state >> ewma->u8_shift);
+    }
+
+    return ewma->i32_state >> ewma->u8_shift;
+}
+
+int32_t stats_ewma_get(const stats_ewma_t *ewma)
+{
+    return ewma->i32_state >> ewma->u8_shift;
+}
+
+uint32_t stats_ratio_add(stats_ratio_t *ratio, uint32_t u32_x)
+{
+    ratio->u32_last = (ratio->u16_weight * ratio->u32_last + u32_x) / (ratio->u16_weight + 1u);
+
+    return ratio->u32_last;
+}
+
+HAL_StatusTypeDef stats_hist_init(stats_hist_t *hist, int32_t i32_min, uint32_t u32_width, uint16_t u16_bins)
+{
+    if ((u32_width == 0u) || (u16_bins == 0u) || (u16_bins > STATS_HIST_MAX_BINS)) {
+        return HAL_ERROR;
+    }
+
+    memset(hist, 0, sizeof(*hist));
+    hist->i32_min   = i32_min;
+    hist->u32_width = u32_width;
+    hist->u16_bins  = u16_bins;
+
+    return HAL_OK;
+}
+
+void stats_hist_add(stats_hist_t *hist, int32_t i32_x)
+{
+    uint32_t u32_bin;
+
+    hist->u32_total++;
+    if (i32_x < hist->i32_min) {
+        hist->u32_below++;
+        return;
+    }
+
+    u32_bin = (uint32_t)(i32_x - hist->i32_min) / hist->u32_width;
+    if (u32_bin >= hist->u16_bins) {
+        hist->u32_above++;
+    } else {
+        hist->u32_count[u32_bin]++;
+    }
+}
+
+int32_t stats_hist_get_quantile(const stats_hist_t *hist, uint16_t u16_permille)
+{
+    /* Rank of the quantile sample, 1-based */
+    uint32_t u32_rank = (uint32_t)(((uint64_t)hist->u32_total * u16_permille + 999u) / 1000u);
+    uint32_t u32_sum = hist->u32_below;
+
+    if ((hist->u32_total == 0u) || (u32_rank <= u32_sum)) {
+        return hist->i32_min;
+    }
+
+    for (uint16_t i = 0u; i < hist->u16_bins; i++) {
+        u32_sum += hist->u32_count[i];
+        if (u32_sum >= u32_rank) {
+            return hist->i32_min + (int32_t)((i + 1u) * hist->u32_width);
+        }
+    }
+
+    return INT32_MAX;
+}
+
+void stats_p2_init(stats_p2_t *p2, float f_quantile)
+{
+    memset(p2, 0, sizeof(*p2));
+    p2->f_quantile = f_quantile;
+
+    for (uint8_t i = 0u; i < 5u; i++) {
+        p2->i32_pos[i] = (int32_t)i + 1;
+    }
+    p2->f_desired[0] = 1.0f;
+    p2->f_desired[1] = 1.0f + 2.0f * f_quantile;
+    p2->f_desired[2] = 1.0f + 4.0f * f_quantile;
+    p2->f_desired[3] = 3.0f + 2.0f * f_quantile;
+    p2->f_desired[4] = 5.0f;
+    p2->f_step[0]    = 0.0f;
+    p2->f_step[1]    = f_quantile / 2.0f;
+    p2->f_step[2]    = f_quantile;
+    p2->f_step[3]    = (1.0f + f_quantile) / 2.0f;
+    p2->f_step[4]    = 1.0f;
+}
+
+void stats_p2_add(stats_p2_t *p2, float f_x)
+{
+    uint8_t k;
+
+    /* The first five samples are the initial marker heights, sorted */
+    if (p2->u32_count < 5u) {
+        uint8_t i = (uint8_t)p2->u32_count;
+
+        while ((i > 0u) && (p2->f_height[i - 1u] > f_x)) {
+            p2->f_height[i] = p2->f_height[i - 1u];
+            i--;
+        }
+        p2->f_height[i] = f_x;
+        p2->u32_count++;
+        return;
+    }
+
+    /* Cell of the sample, extremes become the new outer markers */
+    if (f_x < p2->f_height[0]) {
+        p2->f_height[0] = f_x;
+        k = 0u;
+    } else if (f_x >= p2->f_height[4]) {
+        p2->f_height[4] = f_x;
+        k = 3u;
+    } else {
+        k = 0u;
+        while (f_x >= p2->f_height[k + 1u]) {
+            k++;
+        }
+    }
+
+    for (uint8_t i = k + 1u; i < 5u; i++) {
+        p2->i32_pos[i]++;
+    }
+    for (uint8_t i = 0u; i < 5u; i++) {
+        p2->f_desired[i] += p2->f_step[i];
+    }
+    p2->u32_count++;
+
+    for (uint8_t i = 1u; i < 4u; i++) {
+        stats_p2_adjust(p2, i);
+    }
+}
+
+float stats_p2_get(const stats_p2_t *p2)
+{
+    uint32_t u32_index;
+
+    if (p2->u32_count == 0u) {
+        return 0.0f;
+    }
+    if (p2->u32_count >= 5u) {
+        return p2->f_height[2];
+    }
+
+    /* Heights are the sorted samples so far */
+    u32_index = (uint32_t)(p2->f_quantile * (float)(p2->u32_count - 1u) + 0.5f);
+
+    return p2->f_height[u32_index];
+}
+
+/* Static functions --------------------------------------------------------- */
+/**
+ * @brief Moves an inner marker by one position towards its desired
+ *        position, height by the piecewise-parabolic (or linear) formula.
+ *
+ * @param p2 State
+ * @param i  Marker 1 .. 3
+ */
+static void stats_p2_adjust(stats_p2_t *p2, uint8_t i)
+{
+    float f_d = p2->f_desired[i] - (float)p2->i32_pos[i];
+    int32_t i32_sign;
+    float f_q;
+    float f_n_prev;
+    float f_n;
+    float f_n_next;
+
+    if (!(((f_d >= 1.0f) && (p2->i32_pos[i + 1u] - p2->i32_pos[i] > 1)) ||
+          ((f_d <= -1.0f) && (p2->i32_pos[i - 1u] - p2->i32_pos[i] < -1)))) {
+        return;
+    }
+
+    i32_sign = (f_d >= 0.0f) ? 1 : -1;
+    f_n_prev = (float)p2->i32_pos[i - 1u];
+    f_n      = (float)p2->i32_pos[i];
+    f_n_next = (float)p2->i32_pos[i + 1u];
+
+    f_q = p2->f_height[i] + (float)i32_sign / (f_n_next - f_n_prev) *
+          ((f_n - f_n_prev + (float)i32_sign) * (p2->f_height[i + 1u] - p2->f_height[i]) / (f_n_next - f_n) +
+           (f_n_next - f_n - (float)i32_sign) * (p2->f_height[i] - p2->f_height[i - 1u]) / (f_n - f_n_prev));
+
+    if ((f_q <= p2->f_height[i - 1u]) || (f_q >= p2->f_height[i + 1u])) {
+        /* Parabola leaves the neighbours: linear towards the neighbour */
+        uint8_t u8_next = (i32_sign > 0) ? (uint8_t)(i + 1u) : (uint8_t)(i - 1u);
+
+        f_q = p2->f_height[i] + (float)i32_sign * (p2->f_height[u8_next] - p2->f_height[i]) /
+              (float)(p2->i32_pos[u8_next] - p2->i32_pos[i]);
+    }
+
+    p2->f_height[i]  = f_q;
+    p2->i32_pos[i]  += i32_sign;
+}
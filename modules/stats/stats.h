@@ -0,0 +1,252 @@
+/**
+ ******************************************************************************
+ * @file        stats.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the streaming statistics.
+ *
+ * @details
+ * Running statistics of a signal without keeping its samples, every
+ * update is O(1) in time and memory:
+ *
+ *  - stats_welford_t: count, mean, variance (Welford's update, no
+ *    cancellation of a large mean), min and max,
+ *  - stats_ewma_t:    exponentially weighted mean with weight 2^-shift,
+ *                     integer only, for interrupt paths,
+ *  - stats_ratio_t:   (weight * last + x) / (weight + 1), the smoothing
+ *                     of median_get_median() (weight 4),
+ *  - stats_hist_t:    fixed-width bins with under- and overflow count,
+ *  - stats_p2_t:      one quantile by the P-square algorithm (Jain and
+ *                     Chlamtac), five markers instead of a sorted window.
+ *
+ * An instance belongs to one writer. If the writer is an interrupt, the
+ * reader copies the instance under the same protection as other shared
+ * data of that module (e.g. a sync_seqlock_t).
+ *
+ * Example (jitter of a task in us):
+ *
+ *     stats_welford_t jitter;
+ *     stats_p2_t      p99;
+ *
+ *     stats_welford_reset(&jitter);
+ *     stats_p2_init(&p99, 0.99f);
+ *     ...
+ *     stats_welford_add(&jitter, (float)u32_us);
+ *     stats_p2_add(&p99, (float)u32_us);
+ *     ...
+ *     sd = stats_welford_get_stddev(&jitter);
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - Welford mean / variance with min and max
+ *  - Power-of-two EWMA and integer ratio smoothing
+ *  - Fixed-bin histogram with quantile lookup
+ *  - P-square quantile estimate
+ *
+ ******************************************************************************
+ */
+
+#ifndef STATS_STATS_H_
+#define STATS_STATS_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief Maximum number of histogram bins.
+ */
+#define STATS_HIST_MAX_BINS     32U
+
+/**
+ * @brief Largest EWMA shift; the input must stay below 2^(31 - shift).
+ */
+#define STATS_EWMA_MAX_SHIFT    15U
+
+/**
+ * @brief Static initializer of a ratio smoothing with the given weight.
+ */
+#define STATS_RATIO_INIT(weight)    { 0u, (weight) }
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Welford accumulator.
+ */
+typedef struct {
+    uint32_t u32_count;
+    float    f_mean;
+    float    f_m2;          /**< Sum of squared deviations from the mean   */
+    float    f_min;
+    float    f_max;
+} stats_welford_t;
+
+/**
+ * @brief Exponentially weighted mean, state scaled by 2^shift.
+ */
+typedef struct {
+    int32_t i32_state;
+    uint8_t u8_shift;
+    uint8_t u8_primed;      /**< 0 until the first sample                  */
+} stats_ewma_t;
+
+/**
+ * @brief Integer smoothing (weight * last + x) / (weight + 1).
+ */
+typedef struct {
+    uint32_t u32_last;
+    uint16_t u16_weight;    /**< 0: output = input                         */
+} stats_ratio_t;
+
+/**
+ * @brief Histogram of u16_bins bins from i32_min, u32_width wide.
+ */
+typedef struct {
+    int32_t  i32_min;
+    uint32_t u32_width;
+    uint16_t u16_bins;
+    uint32_t u32_below;     /**< Samples below i32_min                     */
+    uint32_t u32_above;     /**< Samples beyond the last bin               */
+    uint32_t u32_total;
+    uint32_t u32_count[STATS_HIST_MAX_BINS];
+} stats_hist_t;
+
+/**
+ * @brief P-square estimator of one quantile.
+ */
+typedef struct {
+    float    f_height[5];   /**< Marker heights q[0..4]                    */
+    int32_t  i32_pos[5];    /**< Actual marker positions, 1-based          */
+    float    f_desired[5];  /**< Desired marker positions                  */
+    float    f_step[5];     /**< Increments of the desired positions       */
+    float    f_quantile;
+    uint32_t u32_count;
+} stats_p2_t;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Clears a Welford accumulator.
+ *
+ * @param stats Accumulator
+ * @return None
+ */
+void stats_welford_reset(stats_welford_t *stats);
+
+/**
+ * @brief Adds one sample.
+ *
+ * @param stats Accumulator
+ * @param f_x   Sample
+ * @return None
+ */
+void stats_welford_add(stats_welford_t *stats, float f_x);
+
+/**
+ * @brief Sample variance (n - 1).
+ *
+ * @param stats Accumulator
+ * @return Variance, 0 for fewer than two samples
+ */
+float stats_welford_get_variance(const stats_welford_t *stats);
+
+/**
+ * @brief Sample standard deviation.
+ *
+ * @param stats Accumulator
+ * @return Standard deviation, 0 for fewer than two samples
+ */
+float stats_welford_get_stddev(const stats_welford_t *stats);
+
+/**
+ * @brief Starts an EWMA with weight 2^-u8_shift per sample.
+ *
+ * @param ewma     State
+ * @param u8_shift 0 .. STATS_EWMA_MAX_SHIFT (larger values are limited)
+ * @return None
+ */
+void stats_ewma_init(stats_ewma_t *ewma, uint8_t u8_shift);
+
+/**
+ * @brief Adds one sample; the first sample sets the mean.
+ *
+ * @param ewma  State
+ * @param i32_x Sample, |x| < 2^(31 - shift)
+ * @return New mean
+ */
+int32_t stats_ewma_add(stats_ewma_t *ewma, int32_t i32_x);
+
+/**
+ * @brief Current mean.
+ *
+ * @param ewma State
+ * @return Mean, 0 before the first sample
+ */
+int32_t stats_ewma_get(const stats_ewma_t *ewma);
+
+/**
+ * @brief Adds one sample to a ratio smoothing (starts from 0, as the
+ *        historic median smoothing).
+ *
+ * @param ratio State
+ * @param u32_x Sample, weight * x must fit 32 bit
+ * @return New smoothed value
+ */
+uint32_t stats_ratio_add(stats_ratio_t *ratio, uint32_t u32_x);
+
+/**
+ * @brief Sets up a histogram and clears its counts.
+ *
+ * @param hist      Histogram
+ * @param i32_min   Lower edge of the first bin
+ * @param u32_width Bin width (> 0)
+ * @param u16_bins  1 .. STATS_HIST_MAX_BINS
+ * @return HAL_OK, HAL_ERROR for width 0 or an invalid number of bins
+ */
+HAL_StatusTypeDef stats_hist_init(stats_hist_t *hist, int32_t i32_min, uint32_t u32_width, uint16_t u16_bins);
+
+/**
+ * @brief Counts one sample.
+ *
+ * @param hist  Histogram
+ * @param i32_x Sample
+ * @return None
+ */
+void stats_hist_add(stats_hist_t *hist, int32_t i32_x);
+
+/**
+ * @brief Upper edge of the bin that holds a quantile.
+ *
+ * @param hist           Histogram
+ * @param u16_permille   Quantile in permille (0 .. 1000)
+ * @return Edge; INT32_MAX if the quantile lies in the overflow, i32_min
+ *         if it lies below the first bin or nothing was counted
+ */
+int32_t stats_hist_get_quantile(const stats_hist_t *hist, uint16_t u16_permille);
+
+/**
+ * @brief Starts a P-square estimator.
+ *
+ * @param p2         State
+ * @param f_quantile Quantile, 0 < p < 1 (e.g. 0.99f)
+ * @return None
+ */
+void stats_p2_init(stats_p2_t *p2, float f_quantile);
+
+/**
+ * @brief Adds one sample.
+ *
+ * @param p2  State
+ * @param f_x Sample
+ * @return None
+ */
+void stats_p2_add(stats_p2_t *p2, float f_x);
+
+/**
+ * @brief Current quantile estimate (exact for fewer than five samples).
+ *
+ * @param p2 State
+ * @return Estimate, 0 before the first sample
+ */
+float stats_p2_get(const stats_p2_t *p2);
+
+#endif /* STATS_STATS_H_ */
@@ -4,35 +4,57 @@
 * @author Mahmoud Mahmoud / Judy Abou Rmeh
 * @version v1.0
 * @date 30.11.25
-* @brief Stopwatch implementation using TIM1 for time base and
+* @brief Stopwatch implementation using TIM5 (32 bit) for time base and
 *        EXTI0 (PA0) as start/lap button with debounce.
 @verbatim
 ==================================================
 				### Resources used ###
 	TIMER:
-  	  - TIM1 as 1 Hz time base (period elapsed = 1 second)
+  	  - TIM5 as 32 bit time base at 1 MHz (period elapsed = overflow,
+  	    every 2^32 us)
 
 	GPIO / EXTI:
   	  - PA0 as external interrupt (EXTI0) for start/lap button
+  	  - Capture mode: PA0 as TIM5 CH1 input (AF2) instead of EXTI0
+
+	DMA:
+  	  - Capture mode: TIM5_CH1 request of dma_alloc (DMA1 stream 2,
+  	    channel 6) into a ring
 
 	NVIC:
-  	  - TIM1_UP_TIM10_IRQn for timer update interrupt
-  	  - EXTI0_IRQn for button interrupt
+  	  - TIM5_IRQn for timer update interrupt
+  	  - EXTI0_IRQn for button interrupt (line 0 handler registered
+  	    with the exti module)
 ==================================================
 					### Behavior ###
 	(#) On first button press:
-    	- TIM1 is started with interrupt enabled
+    	- TIM5 is started with interrupt enabled
     	- Stopwatch begins counting
 
 	(#) On subsequent button presses:
     	- Current time (minutes, seconds, milliseconds) is stored as a lap
     	- Up to STOPWATCH_LAPS laps are stored in circular fashion
-    	- 'bool_stopwatch_timer_status' is set and the lap index recorded
+    	- A lap event (number, slot, split time) is queued for the
+    	  application, see 'stopwatch_get_lap_event()'
+
+	(#) Capture mode ('stopwatch_init_capture()'):
+    	- The button edge latches TIM5 in CCR1, DMA stores it in a ring
+    	- 'stopwatch_process_captures()' debounces on the time stamps and
+    	  records start and laps with the latched times
+
+	(#) Lap store:
+    	- Every lap is kept as one 32 bit delta in us in an arena of
+    	  STOPWATCH_LAP_ARENA laps, the oldest are overwritten
+    	- Best, worst, mean and split are updated with each lap
+    	- 'stopwatch_get_lap_stats()' copies a published snapshot,
+    	  'stopwatch_get_lap()' and 'stopwatch_read_laps()' read the arena
+    	  under a sequence lock (sync module), none of them disables
+    	  interrupts or retries more than once
 
 	(#) Internally:
-    	- Each timer period elapsed interrupt increments the seconds counter
-    	- On 60 seconds, minutes are incremented and seconds reset
-    	- Milliseconds are derived from the TIM1 counter value
+    	- Each timer period elapsed interrupt increments the overflow counter
+    	  (upper 32 bits of the microsecond time stamp)
+    	- Minutes, seconds and milliseconds are derived from one 64 bit read
 ==================================================
 @endverbatim
 **************************************************
@@ -40,11 +62,19 @@
 
 /* Includes */
 #include "stopwatch.h"
+#include "clock/clock.h"
+#include "exti/exti.h"
+#include "sync/sync.h"
+#include "tim_alloc/tim_alloc.h"
+
+#if (STOPWATCH_EVENT_QUEUE & (STOPWATCH_EVENT_QUEUE - 1U)) != 0
+#error "STOPWATCH_EVENT_QUEUE must be a power of two"
+#endif
 
 /* Global variables */
 
 /**
- * @brief TIM1 handle used as the stopwatch time base.
+ * @brief TIM5 handle used as the stopwatch time base.
  */
 TIM_HandleTypeDef stopwatch_timer;
 
@@ -58,10 +88,40 @@ volatile uint16_t u16_stopwatch_laps_in_seconds[STOPWATCH_LAPS];
 volatile uint16_t u16_stopwatch_laps_in_minutes[STOPWATCH_LAPS];
 
 /**
- * @brief Current stopwatch time (seconds and minutes).
+ * @brief Number of TIM5 overflows, upper 32 bits of the time stamp.
+ */
+static volatile uint32_t u32_stopwatch_overflows = 0;
+
+/**
+ * @brief Time base value at the start of the stopwatch (capture mode, 0 with
+ *        EXTI where TIM5 starts at the button press).
+ */
+static uint64_t u64_stopwatch_start_us = 0;
+
+/**
+ * @brief Capture mode: DMA ring, DMA handle and state of the evaluation.
  */
-volatile uint16_t u16_stopwatch_current_in_seconds = 0;
-volatile uint16_t u16_stopwatch_current_in_minutes = 0;
+static uint32_t u32_stopwatch_capture_ring[STOPWATCH_CAPTURE_RING];
+static DMA_HandleTypeDef stopwatch_capture_dma;
+static uint16_t u16_stopwatch_capture_read = 0;
+static uint64_t u64_stopwatch_last_edge_us = 0;
+
+/**
+ * @brief Lap store: arena of lap deltas and incrementally updated statistics.
+ *
+ *        Written only in stopwatch_add_lap() (EXTI interrupt or main loop).
+ *        The arena and the working statistics are updated in place under
+ *        the sequence lock; the readers of the arena must not run in an
+ *        interrupt that can preempt the writer. The statistics are also
+ *        published as snapshot after every lap, readable from anywhere.
+ */
+static uint32_t u32_stopwatch_lap_arena[STOPWATCH_LAP_ARENA];
+static uint64_t u64_stopwatch_lap_sum_us   = 0;   /* Sum of all lap deltas       */
+static uint64_t u64_stopwatch_arena_base_us = 0;  /* Split before the oldest lap */
+static stopwatch_lap_stats_t stopwatch_lap_stats;
+static sync_seqlock_t stopwatch_lap_lock;
+static stopwatch_lap_stats_t stopwatch_lap_snapshot_buffers[2];
+static sync_snapshot_t stopwatch_lap_snapshot = SYNC_SNAPSHOT_INIT(stopwatch_lap_snapshot_buffers);
 
 /**
  * @brief Internal state flags and indices.
@@ -71,33 +131,43 @@ volatile uint8_t  u8_stopwatch_lap_index        = 0;
 volatile uint16_t u16_stopwatch_lap_counter     = 0;
 
 /**
- * @brief Public flags used for lap notification.
+ * @brief Lap events from the interrupt to the application.
  */
-volatile uint8_t u8_stopwatch_lap_added_index  = 0;
-volatile bool    bool_stopwatch_lap_added_flag = false;
+static stopwatch_lap_event_t stopwatch_event_buffer[STOPWATCH_EVENT_QUEUE];
+static sync_queue_t stopwatch_event_queue = SYNC_QUEUE_INIT(stopwatch_event_buffer);
 
 /**
  * @brief Tick count at last valid button press, used for debounce.
  */
 volatile uint32_t u32_stopwatch_last_button_tick = 0;
 
+/* Static function prototypes */
+static void stopwatch_button_handler(void *context);
+static uint64_t stopwatch_timebase_us(void);
+static void stopwatch_add_lap(uint64_t u64_us);
+static void stopwatch_store_lap(uint64_t u64_us);
+
 /* Public function implementations */
 
 void stopwatch_init_timer(void)
 {
-    __HAL_RCC_TIM1_CLK_ENABLE();
+    if (tim_alloc_claim(TIM5, TIM_ALLOC_OWNER_STOPWATCH) != HAL_OK) {
+        return;
+    }
 
-    stopwatch_timer.Instance = TIM1;
-    /* Timer tick: SystemCoreClock / (Prescaler+1) = 10 kHz
-       Period: 10000-1 => 1 second per overflow */
-    stopwatch_timer.Init.Prescaler         = (SystemCoreClock / 10000) - 1;
-    stopwatch_timer.Init.Period           = 10000 - 1;
+    stopwatch_timer.Instance = TIM5;
+    /* Timer tick: APB1 timer clock / (Prescaler+1) = 1 MHz
+       Period: full 32 bit range => one overflow every 2^32 us */
+    stopwatch_timer.Init.Prescaler         = (clock_get_apb1_timer_clock() / STOPWATCH_COUNTER_HZ) - 1;
+    stopwatch_timer.Init.Period           = 0xFFFFFFFFU;
     stopwatch_timer.Init.CounterMode      = TIM_COUNTERMODE_UP;
     stopwatch_timer.Init.ClockDivision    = TIM_CLOCKDIVISION_DIV1;
     stopwatch_timer.Init.AutoReloadPreload= TIM_AUTORELOAD_PRELOAD_DISABLE;
     stopwatch_timer.Init.RepetitionCounter= 0;
 
     HAL_TIM_Base_Init(&stopwatch_timer);
+
+    u32_stopwatch_overflows = 0;
 }
 
 void stopwatch_init_gpio(void)
@@ -114,30 +184,165 @@ void stopwatch_init_gpio(void)
 
 void stopwatch_init_interrupt(void)
 {
-    /* Timer interrupt: highest priority group 0, subpriority 0 */
-    HAL_NVIC_SetPriority(TIM1_UP_TIM10_IRQn, 0, 0);
-    HAL_NVIC_EnableIRQ(TIM1_UP_TIM10_IRQn);
+    /* Timer interrupt: capture class, subpriority 0 */
+    HAL_NVIC_SetPriority(TIM5_IRQn, STOPWATCH_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(TIM5_IRQn);
+
+    /* EXTI interrupt for PA0: capture class, subpriority 1 */
+    exti_register(0, stopwatch_button_handler, NULL);
+    exti_enable_irq(0, STOPWATCH_IRQ_PRIORITY, 1);
+}
+
+HAL_StatusTypeDef stopwatch_init_capture(void)
+{
+    GPIO_InitTypeDef gpio_init_user = {0};
+    TIM_IC_InitTypeDef ic_init = {0};
+
+    /* PA0 -> TIM5 CH1 */
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+    gpio_init_user.Pin       = GPIO_PIN_0;
+    gpio_init_user.Mode      = GPIO_MODE_AF_PP;
+    gpio_init_user.Pull      = GPIO_NOPULL;
+    gpio_init_user.Speed     = GPIO_SPEED_FREQ_LOW;
+    gpio_init_user.Alternate = GPIO_AF2_TIM5;
+    HAL_GPIO_Init(GPIOA, &gpio_init_user);
+
+    /* CCR1 -> ring, one word per edge; the stream is shared with I2C3 RX of env_sensor */
+    if (dma_alloc_claim(&stopwatch_capture_dma, STOPWATCH_CAPTURE_DMA_REQUEST, DMA_ALLOC_LATENCY_SAMPLED,
+                        HEALTH_ISR_COUNT) != HAL_OK) {
+        return HAL_ERROR;
+    }
+    stopwatch_capture_dma.Init.Direction           = DMA_PERIPH_TO_MEMORY;
+    stopwatch_capture_dma.Init.PeriphInc           = DMA_PINC_DISABLE;
+    stopwatch_capture_dma.Init.MemInc              = DMA_MINC_ENABLE;
+    stopwatch_capture_dma.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+    stopwatch_capture_dma.Init.MemDataAlignment    = DMA_MDATAALIGN_WORD;
+    stopwatch_capture_dma.Init.Mode                = DMA_CIRCULAR;
+    stopwatch_capture_dma.Init.FIFOMode            = DMA_FIFOMODE_DISABLE;
+
+    if ((HAL_DMA_Init(&stopwatch_capture_dma) != HAL_OK) ||
+        (HAL_DMA_Start(&stopwatch_capture_dma, (uint32_t)(uintptr_t)&TIM5->CCR1,
+                       (uint32_t)(uintptr_t)u32_stopwatch_capture_ring, STOPWATCH_CAPTURE_RING) != HAL_OK)) {
+        return HAL_ERROR;
+    }
+
+    /* Rising edge, filtered, every edge captured */
+    ic_init.ICPolarity  = TIM_ICPOLARITY_RISING;
+    ic_init.ICSelection = TIM_ICSELECTION_DIRECTTI;
+    ic_init.ICPrescaler = TIM_ICPSC_DIV1;
+    ic_init.ICFilter    = STOPWATCH_CAPTURE_FILTER;
+    HAL_TIM_IC_ConfigChannel(&stopwatch_timer, &ic_init, TIM_CHANNEL_1);
+
+    u16_stopwatch_capture_read  = 0;
+    bool_stopwatch_timer_status = false;
+
+    __HAL_TIM_ENABLE_DMA(&stopwatch_timer, TIM_DMA_CC1);
+    TIM5->CCER |= TIM_CCER_CC1E;
+
+    HAL_NVIC_SetPriority(TIM5_IRQn, STOPWATCH_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(TIM5_IRQn);
+
+    /* Free-running time base, the start is a captured time stamp */
+    HAL_TIM_Base_Start_IT(&stopwatch_timer);
+
+    return HAL_OK;
+}
+
+uint16_t stopwatch_process_captures(void)
+{
+    uint16_t u16_write;
+    uint64_t u64_now;
+    uint16_t u16_laps = 0;
+
+    /* Capture mode never started (e.g. stream taken) */
+    if (stopwatch_capture_dma.Instance == NULL) {
+        return 0;
+    }
+    u16_write = (uint16_t)(STOPWATCH_CAPTURE_RING - __HAL_DMA_GET_COUNTER(&stopwatch_capture_dma));
+    u64_now = stopwatch_timebase_us();
+
+    if (u16_write >= STOPWATCH_CAPTURE_RING) {
+        u16_write = 0;
+    }
+
+    while (u16_stopwatch_capture_read != u16_write) {
+        uint32_t u32_capture = u32_stopwatch_capture_ring[u16_stopwatch_capture_read];
+        uint64_t u64_edge;
+
+        u16_stopwatch_capture_read = (uint16_t)((u16_stopwatch_capture_read + 1U) % STOPWATCH_CAPTURE_RING);
+
+        /* Extend to 64 bit: the edge lies less than one wrap before now */
+        u64_edge = (u64_now & 0xFFFFFFFF00000000ULL) | u32_capture;
+        if (u64_edge > u64_now) {
+            u64_edge -= 0x100000000ULL;
+        }
+
+        /* Debounce on the time stamps */
+        if (bool_stopwatch_timer_status &&
+            ((u64_edge - u64_stopwatch_last_edge_us) < (STOPWATCH_DEBOUNCE_MS * 1000ULL))) {
+            continue;
+        }
+        u64_stopwatch_last_edge_us = u64_edge;
+
+        if (!bool_stopwatch_timer_status) {
+            u64_stopwatch_start_us      = u64_edge;
+            bool_stopwatch_timer_status = true;
+        } else {
+            stopwatch_add_lap(u64_edge - u64_stopwatch_start_us);
+            u16_laps++;
+        }
+    }
+
+    return u16_laps;
+}
+
+uint64_t stopwatch_get_us(void)
+{
+    if (!bool_stopwatch_timer_status) {
+        return 0;
+    }
+
+    return stopwatch_timebase_us() - u64_stopwatch_start_us;
+}
+
+void stopwatch_split_us(uint64_t u64_us, stopwatch_time_t *time)
+{
+    uint64_t u64_ms = u64_us / 1000U;
+    uint32_t u32_s  = (uint32_t)(u64_ms / 1000U);
+
+    time->u16_microseconds = (uint16_t)(u64_us - u64_ms * 1000U);
+    time->u16_milliseconds = (uint16_t)(u64_ms - (uint64_t)u32_s * 1000U);
+    time->u32_minutes      = u32_s / 60U;
+    time->u8_seconds       = (uint8_t)(u32_s - time->u32_minutes * 60U);
+}
 
-    /* EXTI interrupt for PA0: group priority 0, subpriority 1 */
-    HAL_NVIC_SetPriority(EXTI0_IRQn, 0, 1);
-    HAL_NVIC_EnableIRQ(EXTI0_IRQn);
+void stopwatch_get_time(stopwatch_time_t *time)
+{
+    stopwatch_split_us(stopwatch_get_us(), time);
 }
 
 uint16_t stopwatch_get_current_milliseconds(void)
 {
-    /* Timer counter ticks at 10 kHz => 0.1 ms per tick
-       Divide by 10 to obtain milliseconds (0..999) */
-    return (__HAL_TIM_GET_COUNTER(&stopwatch_timer) / 10U);
+    stopwatch_time_t time;
+
+    stopwatch_get_time(&time);
+    return time.u16_milliseconds;
 }
 
 uint16_t stopwatch_get_current_seconds(void)
 {
-    return u16_stopwatch_current_in_seconds;
+    stopwatch_time_t time;
+
+    stopwatch_get_time(&time);
+    return time.u8_seconds;
 }
 
 uint16_t stopwatch_get_current_minutes(void)
 {
-    return u16_stopwatch_current_in_minutes;
+    stopwatch_time_t time;
+
+    stopwatch_get_time(&time);
+    return (uint16_t)time.u32_minutes;
 }
 
 volatile uint16_t* stopwatch_get_lap_milliseconds(void)
@@ -165,12 +370,79 @@ uint8_t stopwatch_get_current_lap_index(void)
     return u8_stopwatch_lap_index;
 }
 
+HAL_StatusTypeDef stopwatch_get_lap_stats(stopwatch_lap_stats_t *stats)
+{
+    return sync_snapshot_read(&stopwatch_lap_snapshot, stats);
+}
+
+HAL_StatusTypeDef stopwatch_get_lap(uint32_t u32_lap, stopwatch_lap_t *lap)
+{
+    for (uint32_t u32_attempt = 0; u32_attempt < SYNC_READ_ATTEMPTS; u32_attempt++) {
+        uint32_t u32_sequence = sync_seqlock_read_begin(&stopwatch_lap_lock);
+        uint32_t u32_first    = stopwatch_lap_stats.u32_first_stored;
+        uint32_t u32_count    = stopwatch_lap_stats.u32_count;
+        uint64_t u64_split    = u64_stopwatch_arena_base_us;
+        uint32_t u32_delta    = 0;
+
+        if ((u32_lap >= u32_first) && (u32_lap < u32_count)) {
+            /* Split = split before the oldest lap + all deltas up to the lap */
+            for (uint32_t i = u32_first; i <= u32_lap; i++) {
+                u64_split += u32_stopwatch_lap_arena[i % STOPWATCH_LAP_ARENA];
+            }
+            u32_delta = u32_stopwatch_lap_arena[u32_lap % STOPWATCH_LAP_ARENA];
+        }
+
+        if (sync_seqlock_read_valid(&stopwatch_lap_lock, u32_sequence)) {
+            if ((u32_lap < u32_first) || (u32_lap >= u32_count)) {
+                return HAL_ERROR;
+            }
+            lap->u32_delta_us = u32_delta;
+            lap->u64_split_us = u64_split;
+            return HAL_OK;
+        }
+    }
+
+    return HAL_BUSY;
+}
+
+uint32_t stopwatch_read_laps(uint32_t u32_first, uint32_t *pu32_deltas, uint32_t u32_max)
+{
+    for (uint32_t u32_attempt = 0; u32_attempt < SYNC_READ_ATTEMPTS; u32_attempt++) {
+        uint32_t u32_sequence = sync_seqlock_read_begin(&stopwatch_lap_lock);
+        uint32_t u32_count    = stopwatch_lap_stats.u32_count;
+        uint32_t u32_copied   = 0;
+
+        if (u32_first >= stopwatch_lap_stats.u32_first_stored) {
+            while ((u32_copied < u32_max) && ((u32_first + u32_copied) < u32_count)) {
+                pu32_deltas[u32_copied] = u32_stopwatch_lap_arena[(u32_first + u32_copied) % STOPWATCH_LAP_ARENA];
+                u32_copied++;
+            }
+        }
+
+        if (sync_seqlock_read_valid(&stopwatch_lap_lock, u32_sequence)) {
+            return u32_copied;
+        }
+    }
+
+    return 0;
+}
+
+uint8_t stopwatch_get_lap_event(stopwatch_lap_event_t *event)
+{
+    return sync_queue_pop(&stopwatch_event_queue, event);
+}
+
+uint32_t stopwatch_get_dropped_events(void)
+{
+    return sync_queue_get_dropped(&stopwatch_event_queue);
+}
+
 /* HAL callback implementations */
 
 /**
  * @brief Timer period elapsed callback (called by HAL on TIM update event).
  *
- *        Increments stopwatch time by one second and handles minute rollover.
+ *        Counts the TIM5 overflows (upper 32 bits of the time stamp).
  *
  * @param htim Pointer to timer handle triggering the callback.
  * @return None
@@ -178,16 +450,12 @@ uint8_t stopwatch_get_current_lap_index(void)
 void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
 {
     if (&stopwatch_timer == htim) {
-        u16_stopwatch_current_in_seconds++;
-        if (u16_stopwatch_current_in_seconds == 60U) {
-            u16_stopwatch_current_in_minutes++;
-            u16_stopwatch_current_in_seconds = 0U;
-        }
+        u32_stopwatch_overflows++;
     }
 }
 
 /**
- * @brief EXTI callback for GPIO external interrupts.
+ * @brief EXTI line 0 handler (called by the exti module).
  *
  *        Handles button press on PA0:
  *        - If timer is stopped: start stopwatch
@@ -195,64 +463,142 @@ void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
  *
  *        Includes debounce based on HAL tick time.
  *
- * @param GPIO_Pin Pin number that triggered the interrupt.
+ * @param context Unused.
  * @return None
  */
-void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+static void stopwatch_button_handler(void *context)
 {
-    if (GPIO_Pin == GPIO_PIN_0) {
+    (void)context;
 
-        uint32_t u32_ticks_now = HAL_GetTick();
+    uint32_t u32_ticks_now = HAL_GetTick();
 
-        /* Debounce: ignore if time since last press < STOPWATCH_DEBOUNCE_MS */
-        if ((u32_ticks_now - u32_stopwatch_last_button_tick) < STOPWATCH_DEBOUNCE_MS) {
-            return;
-        }
+    /* Debounce: ignore if time since last press < STOPWATCH_DEBOUNCE_MS */
+    if ((u32_ticks_now - u32_stopwatch_last_button_tick) < STOPWATCH_DEBOUNCE_MS) {
+        return;
+    }
 
-        u32_stopwatch_last_button_tick = u32_ticks_now;
+    u32_stopwatch_last_button_tick = u32_ticks_now;
 
-        if (!bool_stopwatch_timer_status) {
-            /* First valid button press: start the stopwatch */
-            HAL_TIM_Base_Start_IT(&stopwatch_timer);
-            bool_stopwatch_timer_status = true;
-        } else {
-            /* Subsequent presses: store lap time */
-            uint8_t u8_index = u8_stopwatch_lap_index;
+    if (!bool_stopwatch_timer_status) {
+        /* First valid button press: start the stopwatch */
+        HAL_TIM_Base_Start_IT(&stopwatch_timer);
+        bool_stopwatch_timer_status = true;
+    } else {
+        /* Subsequent presses: store lap time */
+        stopwatch_add_lap(stopwatch_get_us());
+    }
+}
 
-            u16_stopwatch_laps_in_minutes[u8_index]      = stopwatch_get_current_minutes();
-            u16_stopwatch_laps_in_seconds[u8_index]      = stopwatch_get_current_seconds();
-            u16_stopwatch_laps_in_milliseconds[u8_index] = stopwatch_get_current_milliseconds();
+/**
+ * @brief Stores a lap time and notifies the application.
+ *
+ * @param u64_us Lap time in us since the start.
+ * @return None
+ */
+static void stopwatch_add_lap(uint64_t u64_us)
+{
+    uint8_t u8_index = u8_stopwatch_lap_index;
+    stopwatch_lap_event_t event;
 
-            /* Advance circular index */
-            u8_stopwatch_lap_index = (uint8_t)((u8_index + 1U) % STOPWATCH_LAPS);
+    stopwatch_split_us(u64_us, &event.time);
+    u16_stopwatch_laps_in_minutes[u8_index]      = (uint16_t)event.time.u32_minutes;
+    u16_stopwatch_laps_in_seconds[u8_index]      = event.time.u8_seconds;
+    u16_stopwatch_laps_in_milliseconds[u8_index] = event.time.u16_milliseconds;
 
+    /* Advance circular index */
+    u8_stopwatch_lap_index = (uint8_t)((u8_index + 1U) % STOPWATCH_LAPS);
 
-            u16_stopwatch_lap_counter++;
+    u16_stopwatch_lap_counter++;
 
+    event.u32_lap  = stopwatch_lap_stats.u32_count;
+    event.u8_index = u8_index;
+    stopwatch_store_lap(u64_us);
 
-            /* Notify application about new lap */
-            u8_stopwatch_lap_added_index = u8_index;
-            bool_stopwatch_lap_added_flag     = true;
-        }
-    }
+    /* Notify the application, a full queue drops and counts the event */
+    (void)sync_queue_push(&stopwatch_event_queue, &event);
 }
 
-/* IRQ handlers */
-
 /**
- * @brief TIM1 update / TIM10 global interrupt handler.
+ * @brief Adds a lap to the lap store and updates the statistics.
+ *
+ *        The lap time is the difference to the previous split, saturated
+ *        to 32 bit (~71 min). O(1): best / worst / sum are running values,
+ *        a full arena drops its oldest delta into the base split.
+ *
+ * @param u64_us Split time in us since the start.
  * @return None
  */
-void TIM1_UP_TIM10_IRQHandler(void)
+static void stopwatch_store_lap(uint64_t u64_us)
 {
-    HAL_TIM_IRQHandler(&stopwatch_timer);
+    stopwatch_lap_stats_t *stats = &stopwatch_lap_stats;
+    uint64_t u64_delta = u64_us - stats->u64_split_us;
+    uint32_t u32_delta = (u64_delta > 0xFFFFFFFFULL) ? 0xFFFFFFFFU : (uint32_t)u64_delta;
+    uint32_t u32_lap   = stats->u32_count;
+
+    sync_seqlock_write_begin(&stopwatch_lap_lock);
+
+    if (stats->u32_stored == STOPWATCH_LAP_ARENA) {
+        u64_stopwatch_arena_base_us += u32_stopwatch_lap_arena[stats->u32_first_stored % STOPWATCH_LAP_ARENA];
+        stats->u32_first_stored++;
+    } else {
+        stats->u32_stored++;
+    }
+    u32_stopwatch_lap_arena[u32_lap % STOPWATCH_LAP_ARENA] = u32_delta;
+
+    if ((u32_lap == 0U) || (u32_delta < stats->u32_best_us)) {
+        stats->u32_best_us  = u32_delta;
+        stats->u32_best_lap = u32_lap;
+    }
+    if ((u32_lap == 0U) || (u32_delta > stats->u32_worst_us)) {
+        stats->u32_worst_us  = u32_delta;
+        stats->u32_worst_lap = u32_lap;
+    }
+
+    u64_stopwatch_lap_sum_us += u32_delta;
+    stats->u32_count    = u32_lap + 1U;
+    stats->u32_mean_us  = (uint32_t)(u64_stopwatch_lap_sum_us / stats->u32_count);
+    stats->u32_last_us  = u32_delta;
+    stats->u64_split_us = u64_us;
+
+    sync_seqlock_write_end(&stopwatch_lap_lock);
+    sync_snapshot_publish(&stopwatch_lap_snapshot, stats);
+}
+
+/**
+ * @brief Reads the 64 bit time base (overflow count and TIM5 counter).
+ *
+ *        Lock-free, see stopwatch_get_us().
+ *
+ * @return Time base in us.
+ */
+static uint64_t stopwatch_timebase_us(void)
+{
+    uint32_t u32_high;
+    uint32_t u32_low;
+    uint32_t u32_pending;
+
+    do {
+        u32_high    = u32_stopwatch_overflows;
+        u32_low     = TIM5->CNT;
+        u32_pending = TIM5->SR & TIM_SR_UIF;
+    } while (u32_high != u32_stopwatch_overflows);
+
+    /* Overflow not yet counted by the ISR: the counter has wrapped if the
+       value read is in the lower half (read after the wrap) */
+    if (u32_pending && (u32_low < 0x80000000U)) {
+        u32_high++;
+    }
+
+    return ((uint64_t)u32_high << 32) | u32_low;
 }
 
+/* IRQ handlers */
+
 /**
- * @brief EXTI line 0 interrupt handler (for PA0).
+ * @brief TIM5 global interrupt handler.
  * @return None
  */
-void EXTI0_IRQHandler(void)
+void TIM5_IRQHandler(void)
 {
-    HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_0);
+    HAL_TIM_IRQHandler(&stopwatch_timer);
 }
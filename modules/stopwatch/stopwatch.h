@@ -4,7 +4,8 @@
 * @author Mahmoud Mahmoud / Judy Abou Rmeh
 * @version v1.0
 * @date 30.11.25
-* @brief Simple stopwatch module with lap functionality using TIM1 and EXTI0.
+* @brief Simple stopwatch module with lap functionality using TIM5 and EXTI0.
+*        Several inputs with sub-microsecond captures: laptimer module.
 **************************************************
 */
 #ifndef STOPWATCH_STOPWATCH_H_
@@ -12,6 +13,8 @@
 
 /* Includes */
 #include "stm32f4xx.h"
+#include "dma_alloc/dma_alloc.h"
+#include "irq/irq.h"
 #include <stdbool.h>
 
 /* Public preprocessor defines */
@@ -26,28 +29,102 @@
  */
 #define STOPWATCH_DEBOUNCE_MS 50
 
-/* Public global flags and indices */
+/**
+ * @brief Counter clock of the 32 bit time base (TIM5) in Hz: 1 us per tick.
+ */
+#define STOPWATCH_COUNTER_HZ  1000000U
 
 /**
- * @brief Flag that is set to true when a new lap has been added.
- *
- *        This flag is set inside the EXTI interrupt and can be
- *        polled in the main loop to update the UI or LCD.
+ * @brief NVIC preemption priority of the timer and the button (the button
+ *        with subpriority 1 behind the timer).
  */
-extern volatile bool    bool_stopwatch_lap_added_flag;
+#define STOPWATCH_IRQ_PRIORITY IRQ_CLASS_CAPTURE
 
 /**
- * @brief Index of the last added lap.
- *
- *        Valid only when 'stopwatch_lap_added_flag' is true.
+ * @brief Capture mode: entries of the DMA ring of TIM5 CH1 capture values.
+ *        Must hold all edges (including bounces) between two calls of
+ *        stopwatch_process_captures().
+ */
+#define STOPWATCH_CAPTURE_RING   64U
+
+/**
+ * @brief Capture mode: digital input filter of TIM5 CH1 (0..15), rejects
+ *        spikes shorter than a few microseconds before they are captured.
+ */
+#define STOPWATCH_CAPTURE_FILTER 0x0FU
+
+/**
+ * @brief Capture mode: DMA request of TIM5 CH1 (DMA1 stream 2, channel 6).
+ *        The stream is shared with the I2C3 RX DMA of env_sensor, both cannot
+ *        run at the same time; dma_alloc refuses the second claim.
  */
-extern volatile uint8_t u8_stopwatch_lap_added_index;
+#define STOPWATCH_CAPTURE_DMA_REQUEST DMA_ALLOC_REQ_TIM5_CH1
+
+/**
+ * @brief Laps kept in the lap store (one 32 bit delta each, 4 bytes per lap).
+ *        When it is full the oldest lap is overwritten; the statistics
+ *        cover all laps since the start.
+ */
+#define STOPWATCH_LAP_ARENA   2048U
+
+/**
+ * @brief Lap events queued between the interrupt and the application
+ *        (power of two). Laps beyond it are counted as dropped events,
+ *        the lap store keeps them regardless.
+ */
+#define STOPWATCH_EVENT_QUEUE 8U
+
+/* Public type definitions */
+
+/**
+ * @brief Stopwatch time split into its display parts.
+ */
+typedef struct {
+    uint32_t u32_minutes;
+    uint8_t  u8_seconds;        /**< 0..59  */
+    uint16_t u16_milliseconds;  /**< 0..999 */
+    uint16_t u16_microseconds;  /**< 0..999 */
+} stopwatch_time_t;
+
+/**
+ * @brief Consistent snapshot of the lap statistics.
+ */
+typedef struct {
+    uint32_t u32_count;         /**< Laps since the start                  */
+    uint32_t u32_stored;        /**< Laps still in the store               */
+    uint32_t u32_first_stored;  /**< Number of the oldest stored lap (0..) */
+    uint32_t u32_best_us;       /**< Shortest lap                          */
+    uint32_t u32_best_lap;      /**< Number of the shortest lap            */
+    uint32_t u32_worst_us;      /**< Longest lap                           */
+    uint32_t u32_worst_lap;     /**< Number of the longest lap             */
+    uint32_t u32_mean_us;       /**< Mean lap time                         */
+    uint32_t u32_last_us;       /**< Last lap                              */
+    uint64_t u64_split_us;      /**< Split time at the end of the last lap */
+} stopwatch_lap_stats_t;
+
+/**
+ * @brief One lap from the lap store.
+ */
+typedef struct {
+    uint32_t u32_delta_us;      /**< Lap time                              */
+    uint64_t u64_split_us;      /**< Split time at the end of the lap      */
+} stopwatch_lap_t;
+
+/**
+ * @brief Event of one added lap, queued for the application.
+ */
+typedef struct {
+    uint32_t         u32_lap;   /**< Lap number (0 = first lap)            */
+    uint8_t          u8_index;  /**< Slot in the lap arrays (STOPWATCH_LAPS) */
+    stopwatch_time_t time;      /**< Split time of the lap                 */
+} stopwatch_lap_event_t;
 
 /* Public function prototypes */
 
 /**
- * @brief  Initializes TIM1 as the stopwatch timer.
- *         - Configures TIM1 with 1s period
+ * @brief  Initializes TIM5 as the stopwatch time base.
+ *         - 32 bit counter at STOPWATCH_COUNTER_HZ, overflow every ~71.6 min
+ *         - Each overflow increments the upper 32 bits of the time stamp
  *         - Does not start the timer yet.
  * @param  None
  * @return None
@@ -69,10 +146,66 @@ void stopwatch_init_gpio(void);
  */
 void stopwatch_init_interrupt(void);
 
+/**
+ * @brief  Initializes the hardware capture mode instead of
+ *         stopwatch_init_gpio() / stopwatch_init_interrupt().
+ *         - PA0 as TIM5 CH1 (AF2) input, rising edge, input filter
+ *         - Each edge latches the counter in CCR1, DMA copies it into a ring
+ *         - TIM5 runs from now on; the first accepted edge starts the
+ *           stopwatch, every further one is a lap
+ *         Requires stopwatch_init_timer() first. The edges are evaluated
+ *         by stopwatch_process_captures().
+ * @param  None
+ * @return HAL_OK, HAL_ERROR if the DMA does not start
+ */
+HAL_StatusTypeDef stopwatch_init_capture(void);
+
+/**
+ * @brief  Evaluates the captured edges (capture mode).
+ *         Call regularly from the main loop. Every new capture value is
+ *         extended to 64 bit; edges closer than STOPWATCH_DEBOUNCE_MS to
+ *         the last accepted edge are bounces and dropped. Lap times are
+ *         exact to the edge, independent of interrupt or polling latency.
+ * @param  None
+ * @return Number of laps added.
+ */
+uint16_t stopwatch_process_captures(void);
+
+/**
+ * @brief  Returns the stopwatch time in microseconds since the start.
+ *
+ *         0 while the stopwatch has not been started.
+ *         Lock-free and overflow-safe: the overflow count is read before
+ *         and after the counter and the read is repeated if an overflow
+ *         interrupt ran in between. An overflow whose interrupt is still
+ *         pending (caller with higher priority or interrupts disabled) is
+ *         taken from the update flag.
+ *
+ * @param  None
+ * @return Time in us (64 bit, does not wrap in practice).
+ */
+uint64_t stopwatch_get_us(void);
+
+/**
+ * @brief  Splits a time in microseconds into minutes, seconds, ms and us.
+ * @param  u64_us Time in us (e.g. from stopwatch_get_us()).
+ * @param  time   Result.
+ * @return None
+ */
+void stopwatch_split_us(uint64_t u64_us, stopwatch_time_t *time);
+
+/**
+ * @brief  Returns the current stopwatch time, all parts from one read.
+ * @param  time   Result.
+ * @return None
+ */
+void stopwatch_get_time(stopwatch_time_t *time);
+
 /**
  * @brief  Returns the current stopwatch time in milliseconds (0..999).
  *
- *         The value is derived from the TIM1 counter value.
+ *         The value is derived from stopwatch_get_us(); use
+ *         stopwatch_get_time() to read all parts consistently.
  *
  * @param  None
  * @return Current milliseconds part of the stopwatch time.
@@ -136,4 +269,54 @@ uint16_t stopwatch_get_lap_counts(void);
  */
 uint8_t stopwatch_get_current_lap_index(void);
 
+/**
+ * @brief  Returns a consistent snapshot of the lap statistics.
+ *
+ *         The statistics are updated incrementally when a lap is added and
+ *         published as double buffered snapshot (sync module); the copy
+ *         never waits and is repeated at most once.
+ *
+ * @param  stats Result.
+ * @return HAL_OK, HAL_BUSY if laps were added faster than the copy.
+ */
+HAL_StatusTypeDef stopwatch_get_lap_stats(stopwatch_lap_stats_t *stats);
+
+/**
+ * @brief  Takes the oldest queued lap event.
+ *
+ *         Written by the EXTI interrupt (or stopwatch_process_captures()),
+ *         read by one consumer (sync_queue_t); no lap is lost when several
+ *         laps arrive before the consumer runs.
+ *
+ * @param  event Result.
+ * @return 1 if an event was read, 0 if none is queued.
+ */
+uint8_t stopwatch_get_lap_event(stopwatch_lap_event_t *event);
+
+/**
+ * @brief  Returns the number of lap events dropped because the queue was
+ *         full.
+ * @return Dropped events since power-on.
+ */
+uint32_t stopwatch_get_dropped_events(void);
+
+/**
+ * @brief  Reads one lap from the lap store.
+ * @param  u32_lap Lap number (0 = first lap since the start).
+ * @param  lap     Result.
+ * @return HAL_OK, HAL_ERROR if the lap is not (or no longer) stored,
+ *         HAL_BUSY if laps were added during both read attempts.
+ */
+HAL_StatusTypeDef stopwatch_get_lap(uint32_t u32_lap, stopwatch_lap_t *lap);
+
+/**
+ * @brief  Copies consecutive lap times from the lap store.
+ * @param  u32_first   First lap number.
+ * @param  pu32_deltas Destination for the lap times in us.
+ * @param  u32_max     Size of the destination.
+ * @return Number of lap times copied (0 if u32_first is not stored or
+ *         laps were added during both read attempts).
+ */
+uint32_t stopwatch_read_laps(uint32_t u32_first, uint32_t *pu32_deltas, uint32_t u32_max);
+
 #endif /* STOPWATCH_STOPWATCH_H_ */
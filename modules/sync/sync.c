@@ -0,0 +1,154 @@
+/**
+ ******************************************************************************
+ * @file        sync.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Lock-free ISR / main loop sharing
+ *
+ * Functionality:
+ * - Double buffered snapshot, sequence lock, SPSC queue
+ *
+ * Resources:
+ * - None (single core: the barriers order the accesses for the compiler
+ *   and against DMA masters)
+ ******************************************************************************
+ */
+
+#include "sync.h"
+
+#include <string.h>
+
+/* Public functions --------------------------------------------------------- */
+void sync_snapshot_init(sync_snapshot_t *snapshot, void *buffers, uint16_t u16_size)
+{
+    snapshot->pu8_buffers  = (uint8_t *)buffers;
+    snapshot->u16_size     = u16_size;
+    memset(buffers, 0, 2U * (uint32_t)u16_size);
+    snapshot->u32_sequence = 0U;
+}
+
+void sync_snapshot_publish(sync_snapshot_t *snapshot, const void *data)
+{
+    uint32_t u32_next = snapshot->u32_sequence + 1U;
+
+    /* Fill the copy the readers do not use, then switch to it */
+    memcpy(&snapshot->pu8_buffers[(u32_next & 1U) * snapshot->u16_size], data, snapshot->u16_size);
+    __DMB();
+    snapshot->u32_sequence = u32_next;
+}
+
+HAL_StatusTypeDef sync_snapshot_read(const sync_snapshot_t *snapshot, void *data)
+{
+    for (uint32_t i = 0U; i < SYNC_READ_ATTEMPTS; i++) {
+        uint32_t u32_begin = snapshot->u32_sequence;
+
+        __DMB();
+        memcpy(data, &snapshot->pu8_buffers[(u32_begin & 1U) * snapshot->u16_size], snapshot->u16_size);
+        __DMB();
+
+        /* One publication went to the other copy, two overwrote this one */
+        if ((snapshot->u32_sequence - u32_begin) <= 1U) {
+            return HAL_OK;
+        }
+    }
+
+    return HAL_BUSY;
+}
+
+uint32_t sync_snapshot_get_sequence(const sync_snapshot_t *snapshot)
+{
+    return snapshot->u32_sequence;
+}
+
+void sync_seqlock_init(sync_seqlock_t *lock)
+{
+    lock->u32_sequence = 0U;
+}
+
+void sync_seqlock_write_begin(sync_seqlock_t *lock)
+{
+    lock->u32_sequence++;
+    __DMB();
+}
+
+void sync_seqlock_write_end(sync_seqlock_t *lock)
+{
+    __DMB();
+    lock->u32_sequence++;
+}
+
+uint32_t sync_seqlock_read_begin(const sync_seqlock_t *lock)
+{
+    uint32_t u32_sequence = lock->u32_sequence;
+
+    __DMB();
+    return u32_sequence;
+}
+
+uint8_t sync_seqlock_read_valid(const sync_seqlock_t *lock, uint32_t u32_begin)
+{
+    __DMB();
+    return ((u32_begin & 1U) == 0U) && (u32_begin == lock->u32_sequence);
+}
+
+HAL_StatusTypeDef sync_queue_init(sync_queue_t *queue, void *buffer, uint16_t u16_item_size,
+                                  uint16_t u16_capacity)
+{
+    if ((u16_capacity == 0U) || ((u16_capacity & (u16_capacity - 1U)) != 0U)) {
+        return HAL_ERROR;
+    }
+
+    queue->pu8_buffer    = (uint8_t *)buffer;
+    queue->u16_item_size = u16_item_size;
+    queue->u16_mask      = (uint16_t)(u16_capacity - 1U);
+    queue->u32_dropped   = 0U;
+    queue->u32_tail      = 0U;
+    queue->u32_head      = 0U;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef sync_queue_push(sync_queue_t *queue, const void *item)
+{
+    uint32_t u32_head = queue->u32_head;
+
+    if ((u32_head - queue->u32_tail) > queue->u16_mask) {
+        queue->u32_dropped++;
+        return HAL_BUSY;
+    }
+
+    memcpy(&queue->pu8_buffer[(u32_head & queue->u16_mask) * queue->u16_item_size], item,
+           queue->u16_item_size);
+    __DMB();    /* Item before the index */
+    queue->u32_head = u32_head + 1U;
+
+    return HAL_OK;
+}
+
+uint8_t sync_queue_pop(sync_queue_t *queue, void *item)
+{
+    uint32_t u32_tail = queue->u32_tail;
+
+    if (u32_tail == queue->u32_head) {
+        return 0U;
+    }
+
+    __DMB();    /* Item after the index */
+    memcpy(item, &queue->pu8_buffer[(u32_tail & queue->u16_mask) * queue->u16_item_size],
+           queue->u16_item_size);
+    __DMB();    /* Slot free only after the copy */
+    queue->u32_tail = u32_tail + 1U;
+
+    return 1U;
+}
+
+uint32_t sync_queue_count(const sync_queue_t *queue)
+{
+    return queue->u32_head - queue->u32_tail;
+}
+
+uint32_t sync_queue_get_dropped(const sync_queue_t *queue)
+{
+    return queue->u32_dropped;
+}
@@ -0,0 +1,234 @@
+/**
+ ******************************************************************************
+ * @file        sync.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the lock-free ISR / main loop sharing.
+ *
+ * @details
+ * State of more than one word that an interrupt writes and the main loop
+ * reads (or the other way round) is torn if the writer runs between two
+ * loads of the reader. Instead of disabling interrupts around every read
+ * the writer publishes through one of two primitives:
+ *
+ *  - sync_snapshot_t: two copies of a small structure. The writer fills
+ *    the copy that is not current and then advances the sequence, so the
+ *    reader always copies a complete structure. A read is only repeated
+ *    if the writer published twice during the copy, a second failure
+ *    returns HAL_BUSY instead of waiting. Works in both directions (ISR
+ *    writer / main reader and main writer / ISR reader).
+ *  - sync_seqlock_t: sequence counter for large state that is updated in
+ *    place (e.g. an arena). Odd while an update is in progress; the reader
+ *    checks the counter after its copy. The reader must not preempt the
+ *    writer.
+ *  - sync_queue_t: single producer / single consumer ring of fixed size
+ *    items, e.g. events from an interrupt to the main loop. Each index is
+ *    written by its owner only (plain stores, no LDREX/STREX); a full
+ *    queue drops the new item and counts it.
+ *
+ * Only one writer per object, readers never block the writer.
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - Double buffered snapshot with bounded read (SYNC_READ_ATTEMPTS)
+ *  - Sequence lock for in-place updates
+ *  - Wait-free SPSC queue, power of two capacity, free running indices
+ *  - Barriers (__DMB) between payload and sequence accesses
+ *
+ ******************************************************************************
+ */
+
+#ifndef SYNC_SYNC_H_
+#define SYNC_SYNC_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief Copies a reader makes before it gives up (first try + one retry).
+ */
+#define SYNC_READ_ATTEMPTS      2U
+
+/**
+ * @brief Static initializer of a snapshot over an array of two copies
+ *        (same state as sync_snapshot_init()).
+ */
+#define SYNC_SNAPSHOT_INIT(buffers) \
+    { 0U, (uint8_t *)(buffers), (uint16_t)sizeof((buffers)[0]) }
+
+/**
+ * @brief Number of items of a queue array.
+ */
+#define SYNC_QUEUE_LENGTH(buffer) (sizeof(buffer) / sizeof((buffer)[0]))
+
+/**
+ * @brief Static initializer of an empty queue over an item array; the
+ *        length must be a power of two (checked at compile time, as
+ *        sync_queue_init() does at run time).
+ */
+#define SYNC_QUEUE_INIT(buffer) \
+    { 0U, 0U, 0U, (uint8_t *)(buffer), (uint16_t)sizeof((buffer)[0]), \
+      (uint16_t)((SYNC_QUEUE_LENGTH(buffer) - 1U) + \
+                 (0U * sizeof(struct { \
+                     _Static_assert((SYNC_QUEUE_LENGTH(buffer) & (SYNC_QUEUE_LENGTH(buffer) - 1U)) == 0U, \
+                                    "SYNC_QUEUE_INIT: length must be a power of two"); \
+                     int i_dummy; }))) }
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Double buffered snapshot of one structure.
+ */
+typedef struct {
+    volatile uint32_t u32_sequence;     /**< Publications, copy (sequence & 1) is current */
+    uint8_t          *pu8_buffers;      /**< Two copies of u16_size bytes                 */
+    uint16_t          u16_size;         /**< Size of one copy                             */
+} sync_snapshot_t;
+
+/**
+ * @brief Sequence lock of state updated in place.
+ */
+typedef struct {
+    volatile uint32_t u32_sequence;     /**< Odd while an update is in progress */
+} sync_seqlock_t;
+
+/**
+ * @brief Single producer / single consumer queue.
+ */
+typedef struct {
+    volatile uint32_t u32_head;         /**< Items pushed, producer only        */
+    volatile uint32_t u32_tail;         /**< Items popped, consumer only        */
+    volatile uint32_t u32_dropped;      /**< Pushes into a full queue           */
+    uint8_t          *pu8_buffer;       /**< Capacity items of u16_item_size    */
+    uint16_t          u16_item_size;    /**< Size of one item in bytes          */
+    uint16_t          u16_mask;         /**< Capacity - 1                       */
+} sync_queue_t;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Initializes a snapshot; both copies are cleared.
+ *
+ * @param snapshot Snapshot
+ * @param buffers  Storage of two copies (e.g. type buffers[2])
+ * @param u16_size Size of one copy in bytes
+ * @return None
+ */
+void sync_snapshot_init(sync_snapshot_t *snapshot, void *buffers, uint16_t u16_size);
+
+/**
+ * @brief Publishes a new value (writer side, never waits).
+ *
+ * @param snapshot Snapshot
+ * @param data     u16_size bytes
+ * @return None
+ */
+void sync_snapshot_publish(sync_snapshot_t *snapshot, const void *data);
+
+/**
+ * @brief Copies the current value (reader side).
+ *
+ * @param snapshot Snapshot
+ * @param data     Destination of u16_size bytes
+ * @return HAL_OK, HAL_BUSY if the writer published twice during each of
+ *         SYNC_READ_ATTEMPTS copies (data undefined)
+ */
+HAL_StatusTypeDef sync_snapshot_read(const sync_snapshot_t *snapshot, void *data);
+
+/**
+ * @brief Returns the number of publications, e.g. to skip an unchanged
+ *        snapshot without copying it.
+ *
+ * @param snapshot Snapshot
+ * @return Publications since init
+ */
+uint32_t sync_snapshot_get_sequence(const sync_snapshot_t *snapshot);
+
+/**
+ * @brief Initializes a sequence lock.
+ *
+ * @param lock Lock
+ * @return None
+ */
+void sync_seqlock_init(sync_seqlock_t *lock);
+
+/**
+ * @brief Starts an in-place update (writer side).
+ *
+ * @param lock Lock
+ * @return None
+ */
+void sync_seqlock_write_begin(sync_seqlock_t *lock);
+
+/**
+ * @brief Ends an in-place update (writer side).
+ *
+ * @param lock Lock
+ * @return None
+ */
+void sync_seqlock_write_end(sync_seqlock_t *lock);
+
+/**
+ * @brief Starts a read; pass the result to sync_seqlock_read_valid().
+ *
+ * @param lock Lock
+ * @return Sequence at the start of the read
+ */
+uint32_t sync_seqlock_read_begin(const sync_seqlock_t *lock);
+
+/**
+ * @brief Checks a read after the copy.
+ *
+ * @param lock       Lock
+ * @param u32_begin  Result of sync_seqlock_read_begin()
+ * @return 1 if the copy is consistent, 0 if it has to be repeated
+ */
+uint8_t sync_seqlock_read_valid(const sync_seqlock_t *lock, uint32_t u32_begin);
+
+/**
+ * @brief Initializes an empty queue.
+ *
+ * @param queue         Queue
+ * @param buffer        Storage of u16_capacity items
+ * @param u16_item_size Size of one item in bytes
+ * @param u16_capacity  Number of items, power of two
+ * @return HAL_OK, HAL_ERROR if the capacity is no power of two
+ */
+HAL_StatusTypeDef sync_queue_init(sync_queue_t *queue, void *buffer, uint16_t u16_item_size,
+                                  uint16_t u16_capacity);
+
+/**
+ * @brief Appends an item (producer side, never waits).
+ *
+ * @param queue Queue
+ * @param item  u16_item_size bytes
+ * @return HAL_OK, HAL_BUSY if the queue is full (item dropped and counted)
+ */
+HAL_StatusTypeDef sync_queue_push(sync_queue_t *queue, const void *item);
+
+/**
+ * @brief Takes the oldest item (consumer side, never waits).
+ *
+ * @param queue Queue
+ * @param item  Destination of u16_item_size bytes
+ * @return 1 if an item was read, 0 if the queue is empty
+ */
+uint8_t sync_queue_pop(sync_queue_t *queue, void *item);
+
+/**
+ * @brief Returns the number of queued items.
+ *
+ * @param queue Queue
+ * @return Items
+ */
+uint32_t sync_queue_count(const sync_queue_t *queue);
+
+/**
+ * @brief Returns the number of dropped items.
+ *
+ * @param queue Queue
+ * @return Pushes into a full queue since init
+ */
+uint32_t sync_queue_get_dropped(const sync_queue_t *queue);
+
+#endif /* SYNC_SYNC_H_ */
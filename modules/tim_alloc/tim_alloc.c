@@ -0,0 +1,767 @@
+/**
+ ******************************************************************************
+ * @file        tim_alloc.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Timer allocator (capabilities, owners, interrupt dispatch)
+ *              and timer wheel
+ *
+ * Functionality:
+ * - Capability and vector table of TIM1..TIM14, owner per timer
+ * - Dispatch of the vectors no module owns to the handler of each timer
+ * - Hierarchical timer wheel: 4 x 32 doubly linked slot lists, cascade
+ *   of one upper slot every 32 ticks, queue of the deferred expiries
+ *
+ * Resources:
+ * - TIM2_IRQHandler, TIM1_UP_TIM10_IRQHandler, TIM1_BRK_TIM9_IRQHandler,
+ *   TIM1_TRG_COM_TIM11_IRQHandler, TIM1_CC_IRQHandler,
+ *   TIM8_BRK_TIM12_IRQHandler, TIM8_CC_IRQHandler
+ * - The wheel timer (claimed with TIM_ALLOC_CAP_IRQ)
+ ******************************************************************************
+ */
+
+#include "tim_alloc.h"
+#include <clock/clock.h>
+#include <stddef.h>
+
+/* Preprocessor defines ---------------------------------------------------- */
+/**
+ * @brief Dispatched vectors per timer (TIM1 has four).
+ */
+#define TIM_ALLOC_VECTORS       4U
+
+/**
+ * @brief Status flags with an interrupt enable bit (SR and DIER bits 0..7).
+ */
+#define TIM_ALLOC_IRQ_FLAGS     0xFFU
+#define TIM_ALLOC_CC_FLAGS      (TIM_SR_CC1IF | TIM_SR_CC2IF | TIM_SR_CC3IF | TIM_SR_CC4IF)
+
+/**
+ * @brief Marks an unknown timer.
+ */
+#define TIM_ALLOC_NO_TIMER      0xFFU
+
+/**
+ * @brief Software timer states.
+ */
+#define TIM_ALLOC_SOFT_IDLE         0U  /**< Not in the wheel                   */
+#define TIM_ALLOC_SOFT_WAITING      1U  /**< In a slot list                     */
+#define TIM_ALLOC_SOFT_DUE          2U  /**< Taken out by the current tick      */
+#define TIM_ALLOC_SOFT_DUE_STOPPED  3U  /**< Due, stopped meanwhile             */
+#define TIM_ALLOC_SOFT_DUE_RESTART  4U  /**< Due, restarted (u32_expires: delay) */
+
+/**
+ * @brief Deferred queue states of a software timer.
+ */
+#define TIM_ALLOC_SOFT_UNQUEUED     0U  /**< Not in the deferred queue          */
+#define TIM_ALLOC_SOFT_QUEUED       1U  /**< Expired, callback pending          */
+#define TIM_ALLOC_SOFT_DROPPED      2U  /**< Queued, stopped meanwhile          */
+
+#define TIM_ALLOC_WHEEL_MASK        (TIM_ALLOC_WHEEL_SLOTS - 1UL)
+
+/* Module intern type definitions ------------------------------------------ */
+/**
+ * @brief Fixed properties of one timer.
+ */
+typedef struct {
+    TIM_TypeDef *instance;
+    uint8_t      u8_caps;
+    uint8_t      u8_apb2;
+    uint8_t      u8_vectors;
+    IRQn_Type    vectors[TIM_ALLOC_VECTORS];
+} tim_alloc_timer_t;
+
+/**
+ * @brief State of one timer.
+ */
+typedef struct {
+    uint8_t             u8_claimed;
+    tim_alloc_owner_t   owner;
+    tim_alloc_handler_t handler;
+    void               *p_context;
+} tim_alloc_slot_t;
+
+/* Static module variables -------------------------------------------------- */
+/**
+ * @brief TIM1..TIM14 with capabilities and the vectors served here.
+ */
+static const tim_alloc_timer_t g_tim_alloc_timers[TIM_ALLOC_TIMERS] = {
+    { TIM1,  TIM_ALLOC_CAP_ADVANCED | TIM_ALLOC_CAP_CAPTURE | TIM_ALLOC_CAP_4CH | TIM_ALLOC_CAP_IRQ, 1U, 4U,
+      { TIM1_UP_TIM10_IRQn, TIM1_BRK_TIM9_IRQn, TIM1_TRG_COM_TIM11_IRQn, TIM1_CC_IRQn } },
+    { TIM2,  TIM_ALLOC_CAP_32BIT | TIM_ALLOC_CAP_CAPTURE | TIM_ALLOC_CAP_4CH | TIM_ALLOC_CAP_IRQ,    0U, 1U,
+      { TIM2_IRQn } },
+    { TIM3,  TIM_ALLOC_CAP_CAPTURE | TIM_ALLOC_CAP_4CH,                                             0U, 0U, { 0 } },
+    { TIM4,  TIM_ALLOC_CAP_CAPTURE | TIM_ALLOC_CAP_4CH,                                             0U, 0U, { 0 } },
+    { TIM5,  TIM_ALLOC_CAP_32BIT | TIM_ALLOC_CAP_CAPTURE | TIM_ALLOC_CAP_4CH,                       0U, 0U, { 0 } },
+    { TIM6,  0U,                                                                                    0U, 0U, { 0 } },
+    { TIM7,  0U,                                                                                    0U, 0U, { 0 } },
+    { TIM8,  TIM_ALLOC_CAP_ADVANCED | TIM_ALLOC_CAP_CAPTURE | TIM_ALLOC_CAP_4CH,                    1U, 2U,
+      { TIM8_BRK_TIM12_IRQn, TIM8_CC_IRQn } },
+    { TIM9,  TIM_ALLOC_CAP_CAPTURE | TIM_ALLOC_CAP_IRQ,                                             1U, 1U,
+      { TIM1_BRK_TIM9_IRQn } },
+    { TIM10, TIM_ALLOC_CAP_CAPTURE | TIM_ALLOC_CAP_IRQ,                                             1U, 1U,
+      { TIM1_UP_TIM10_IRQn } },
+    { TIM11, TIM_ALLOC_CAP_CAPTURE | TIM_ALLOC_CAP_IRQ,                                             1U, 1U,
+      { TIM1_TRG_COM_TIM11_IRQn } },
+    { TIM12, TIM_ALLOC_CAP_CAPTURE | TIM_ALLOC_CAP_IRQ,                                             0U, 1U,
+      { TIM8_BRK_TIM12_IRQn } },
+    { TIM13, TIM_ALLOC_CAP_CAPTURE,                                                                 0U, 0U, { 0 } },
+    { TIM14, TIM_ALLOC_CAP_CAPTURE,                                                                 0U, 0U, { 0 } },
+};
+
+static tim_alloc_slot_t g_tim_alloc_slots[TIM_ALLOC_TIMERS];
+
+static tim_alloc_stats_t g_tim_alloc_stats = {
+    .last_denied = TIM_ALLOC_OWNER_NONE,
+    .last_holder = TIM_ALLOC_OWNER_NONE
+};
+
+static tim_alloc_soft_t *g_p_tim_alloc_wheel[TIM_ALLOC_WHEEL_LEVELS][TIM_ALLOC_WHEEL_SLOTS];
+static tim_alloc_soft_t *g_p_tim_alloc_queue_head;
+static tim_alloc_soft_t *g_p_tim_alloc_queue_tail;
+static TIM_TypeDef *g_p_tim_alloc_wheel_tim;
+static volatile uint32_t g_u32_tim_alloc_wheel_now;
+
+/* Static function prototypes ---------------------------------------------- */
+static uint8_t tim_alloc_index(const TIM_TypeDef *tim);
+static void tim_alloc_clock_enable(uint8_t u8_index);
+static void tim_alloc_conflict(tim_alloc_owner_t owner, tim_alloc_owner_t holder);
+static uint8_t tim_alloc_vector_in_use(IRQn_Type irqn, uint8_t u8_except);
+static void tim_alloc_dispatch(uint8_t u8_index, uint32_t u32_mask);
+static HAL_StatusTypeDef tim_alloc_soft_arm(tim_alloc_soft_t *soft, uint32_t u32_delay_ticks,
+                                            uint32_t u32_period_ticks, tim_alloc_soft_fn_t fn,
+                                            void *context, uint8_t u8_deferred);
+static void tim_alloc_soft_link(tim_alloc_soft_t *soft);
+static void tim_alloc_soft_insert(tim_alloc_soft_t *soft, uint32_t u32_delay);
+static void tim_alloc_wheel_cascade(void);
+static void tim_alloc_wheel_tick(TIM_TypeDef *tim, uint32_t u32_flags, void *context);
+
+/* Public functions --------------------------------------------------------- */
+HAL_StatusTypeDef tim_alloc_claim(TIM_TypeDef *tim, tim_alloc_owner_t owner)
+{
+    uint8_t u8_index = tim_alloc_index(tim);
+    tim_alloc_slot_t *slot;
+
+    if ((u8_index == TIM_ALLOC_NO_TIMER) || (owner >= TIM_ALLOC_OWNER_COUNT)) {
+        return HAL_ERROR;
+    }
+    slot = &g_tim_alloc_slots[u8_index];
+
+    if (slot->u8_claimed) {
+        if (slot->owner == owner) {
+            return HAL_OK;
+        }
+        tim_alloc_conflict(owner, slot->owner);
+        return HAL_BUSY;
+    }
+
+    slot->u8_claimed = 1U;
+    slot->owner      = owner;
+    slot->handler    = NULL;
+    g_tim_alloc_stats.u8_used++;
+    tim_alloc_clock_enable(u8_index);
+
+    return HAL_OK;
+}
+
+TIM_TypeDef *tim_alloc_claim_caps(uint32_t u32_caps, tim_alloc_owner_t owner)
+{
+    uint8_t u8_best = TIM_ALLOC_NO_TIMER;
+    uint8_t u8_best_extra = 0xFFU;
+
+    if (owner >= TIM_ALLOC_OWNER_COUNT) {
+        return NULL;
+    }
+
+    /* From the top: the fixed wirings of the modules use the low timers */
+    for (uint8_t i = TIM_ALLOC_TIMERS; i-- > 0U;) {
+        uint32_t u32_caps_timer = g_tim_alloc_timers[i].u8_caps;
+        uint8_t u8_extra;
+
+        if (((u32_caps_timer & u32_caps) != u32_caps) || g_tim_alloc_slots[i].u8_claimed) {
+            continue;
+        }
+        u8_extra = (uint8_t)__builtin_popcount(u32_caps_timer & ~u32_caps);
+        if (u8_extra < u8_best_extra) {
+            u8_best       = i;
+            u8_best_extra = u8_extra;
+        }
+    }
+
+    if (u8_best == TIM_ALLOC_NO_TIMER) {
+        tim_alloc_conflict(owner, TIM_ALLOC_OWNER_NONE);
+        return NULL;
+    }
+
+    (void)tim_alloc_claim(g_tim_alloc_timers[u8_best].instance, owner);
+    return g_tim_alloc_timers[u8_best].instance;
+}
+
+void tim_alloc_release(TIM_TypeDef *tim, tim_alloc_owner_t owner)
+{
+    uint8_t u8_index = tim_alloc_index(tim);
+    const tim_alloc_timer_t *timer;
+
+    if ((u8_index == TIM_ALLOC_NO_TIMER) || !g_tim_alloc_slots[u8_index].u8_claimed ||
+        (g_tim_alloc_slots[u8_index].owner != owner)) {
+        return;
+    }
+    timer = &g_tim_alloc_timers[u8_index];
+
+    tim->CR1  = 0U;
+    tim->DIER = 0U;
+    g_tim_alloc_slots[u8_index].handler = NULL;
+    g_tim_alloc_slots[u8_index].u8_claimed = 0U;
+    g_tim_alloc_stats.u8_used--;
+
+    for (uint8_t i = 0U; i < timer->u8_vectors; i++) {
+        if (!tim_alloc_vector_in_use(timer->vectors[i], u8_index)) {
+            HAL_NVIC_DisableIRQ(timer->vectors[i]);
+        }
+    }
+
+    if (tim == g_p_tim_alloc_wheel_tim) {
+        g_p_tim_alloc_wheel_tim = NULL;
+    }
+}
+
+HAL_StatusTypeDef tim_alloc_set_handler(TIM_TypeDef *tim, tim_alloc_handler_t handler,
+                                        void *context, uint32_t u32_priority)
+{
+    uint8_t u8_index = tim_alloc_index(tim);
+    const tim_alloc_timer_t *timer;
+
+    if ((u8_index == TIM_ALLOC_NO_TIMER) || (handler == NULL) ||
+        !g_tim_alloc_slots[u8_index].u8_claimed ||
+        ((g_tim_alloc_timers[u8_index].u8_caps & TIM_ALLOC_CAP_IRQ) == 0U)) {
+        return HAL_ERROR;
+    }
+    timer = &g_tim_alloc_timers[u8_index];
+
+    /* Context first: the vector may already run for the other timer */
+    g_tim_alloc_slots[u8_index].p_context = context;
+    __DMB();
+    g_tim_alloc_slots[u8_index].handler = handler;
+
+    for (uint8_t i = 0U; i < timer->u8_vectors; i++) {
+        IRQn_Type irqn = timer->vectors[i];
+        uint32_t u32_preempt;
+        uint32_t u32_sub;
+
+        if (NVIC_GetEnableIRQ(irqn)) {
+            NVIC_DecodePriority(NVIC_GetPriority(irqn), NVIC_GetPriorityGrouping(), &u32_preempt, &u32_sub);
+            if (u32_preempt < u32_priority) {
+                continue;
+            }
+        }
+        HAL_NVIC_SetPriority(irqn, u32_priority, 0U);
+        HAL_NVIC_EnableIRQ(irqn);
+    }
+
+    return HAL_OK;
+}
+
+tim_alloc_owner_t tim_alloc_get_owner(const TIM_TypeDef *tim)
+{
+    uint8_t u8_index = tim_alloc_index(tim);
+
+    if ((u8_index == TIM_ALLOC_NO_TIMER) || !g_tim_alloc_slots[u8_index].u8_claimed) {
+        return TIM_ALLOC_OWNER_NONE;
+    }
+    return g_tim_alloc_slots[u8_index].owner;
+}
+
+uint32_t tim_alloc_get_clock(const TIM_TypeDef *tim)
+{
+    uint8_t u8_index = tim_alloc_index(tim);
+
+    if ((u8_index != TIM_ALLOC_NO_TIMER) && g_tim_alloc_timers[u8_index].u8_apb2) {
+        return clock_get_apb2_timer_clock();
+    }
+    return clock_get_apb1_timer_clock();
+}
+
+HAL_StatusTypeDef tim_alloc_wheel_start(uint32_t u32_tick_hz, uint32_t u32_priority)
+{
+    TIM_TypeDef *tim = g_p_tim_alloc_wheel_tim;
+    uint32_t u32_ticks;
+    uint32_t u32_prescaler;
+
+    if ((u32_tick_hz == 0U) || (u32_tick_hz > 100000U)) {
+        return HAL_ERROR;
+    }
+
+    if (tim == NULL) {
+        tim = tim_alloc_claim_caps(TIM_ALLOC_CAP_IRQ, TIM_ALLOC_OWNER_WHEEL);
+        if (tim == NULL) {
+            return HAL_BUSY;
+        }
+        g_p_tim_alloc_wheel_tim = tim;
+    }
+
+    /* Timer clock / rate split into prescaler and a 16 bit reload */
+    u32_ticks     = tim_alloc_get_clock(tim) / u32_tick_hz;
+    u32_prescaler = (u32_ticks - 1U) / 65536U;
+
+    tim->CR1  = 0U;
+    tim->PSC  = u32_prescaler;
+    tim->ARR  = (u32_ticks / (u32_prescaler + 1U)) - 1U;
+    tim->CNT  = 0U;
+    tim->EGR  = TIM_EGR_UG;
+    tim->SR   = 0U;
+    tim->DIER = TIM_DIER_UIE;
+
+    (void)tim_alloc_set_handler(tim, tim_alloc_wheel_tick, NULL, u32_priority);
+    tim->CR1 = TIM_CR1_URS | TIM_CR1_CEN;
+
+    return HAL_OK;
+}
+
+uint32_t tim_alloc_wheel_now(void)
+{
+    return g_u32_tim_alloc_wheel_now;
+}
+
+HAL_StatusTypeDef tim_alloc_soft_start(tim_alloc_soft_t *soft, uint32_t u32_delay_ticks,
+                                       uint32_t u32_period_ticks, tim_alloc_soft_fn_t fn, void *context)
+{
+    return tim_alloc_soft_arm(soft, u32_delay_ticks, u32_period_ticks, fn, context, 0U);
+}
+
+HAL_StatusTypeDef tim_alloc_soft_start_deferred(tim_alloc_soft_t *soft, uint32_t u32_delay_ticks,
+                                                uint32_t u32_period_ticks, tim_alloc_soft_fn_t fn,
+                                                void *context)
+{
+    return tim_alloc_soft_arm(soft, u32_delay_ticks, u32_period_ticks, fn, context, 1U);
+}
+
+uint32_t tim_alloc_wheel_poll(void)
+{
+    tim_alloc_soft_t *list;
+    uint32_t u32_primask;
+    uint32_t u32_run = 0U;
+
+    /* Take the queue as it is: expiries during the callbacks wait for the next poll */
+    u32_primask = __get_PRIMASK();
+    __disable_irq();
+    list = g_p_tim_alloc_queue_head;
+    g_p_tim_alloc_queue_head = NULL;
+    g_p_tim_alloc_queue_tail = NULL;
+    __set_PRIMASK(u32_primask);
+
+    while (list != NULL) {
+        tim_alloc_soft_t *soft = list;
+        tim_alloc_soft_fn_t fn;
+        void *p_context;
+        uint8_t u8_run;
+
+        __disable_irq();
+        list = soft->p_queue_next;
+        soft->p_queue_next = NULL;
+        u8_run    = (soft->u8_queued == TIM_ALLOC_SOFT_QUEUED);
+        fn        = soft->fn;
+        p_context = soft->p_context;
+        soft->u8_queued = TIM_ALLOC_SOFT_UNQUEUED;
+        __set_PRIMASK(u32_primask);
+
+        if (u8_run) {
+            fn(p_context);
+            u32_run++;
+        }
+    }
+
+    return u32_run;
+}
+
+void tim_alloc_soft_stop(tim_alloc_soft_t *soft)
+{
+    uint32_t u32_primask;
+
+    if (soft == NULL) {
+        return;
+    }
+
+    u32_primask = __get_PRIMASK();
+    __disable_irq();
+
+    if (soft->u8_state == TIM_ALLOC_SOFT_WAITING) {
+        *soft->pp_prev = soft->p_next;
+        if (soft->p_next != NULL) {
+            soft->p_next->pp_prev = soft->pp_prev;
+        }
+        soft->p_next   = NULL;
+        soft->pp_prev  = NULL;
+        soft->u8_state = TIM_ALLOC_SOFT_IDLE;
+    } else if ((soft->u8_state == TIM_ALLOC_SOFT_DUE) || (soft->u8_state == TIM_ALLOC_SOFT_DUE_RESTART)) {
+        soft->u8_state = TIM_ALLOC_SOFT_DUE_STOPPED;
+    }
+    if (soft->u8_queued == TIM_ALLOC_SOFT_QUEUED) {
+        soft->u8_queued = TIM_ALLOC_SOFT_DROPPED;
+    }
+
+    __set_PRIMASK(u32_primask);
+}
+
+const tim_alloc_stats_t *tim_alloc_get_stats(void)
+{
+    return &g_tim_alloc_stats;
+}
+
+/* Static module functions -------------------------------------------------- */
+/**
+ * @brief Finds the table index of a timer.
+ *
+ * @param tim Timer
+ * @return 0..13, TIM_ALLOC_NO_TIMER for an unknown pointer
+ */
+static uint8_t tim_alloc_index(const TIM_TypeDef *tim)
+{
+    for (uint8_t i = 0U; i < TIM_ALLOC_TIMERS; i++) {
+        if (g_tim_alloc_timers[i].instance == tim) {
+            return i;
+        }
+    }
+
+    return TIM_ALLOC_NO_TIMER;
+}
+
+/**
+ * @brief Enables the bus clock of a timer.
+ *
+ * @param u8_index Table index
+ * @return None
+ */
+static void tim_alloc_clock_enable(uint8_t u8_index)
+{
+    switch (u8_index) {
+    case 0U:  __HAL_RCC_TIM1_CLK_ENABLE();  break;
+    case 1U:  __HAL_RCC_TIM2_CLK_ENABLE();  break;
+    case 2U:  __HAL_RCC_TIM3_CLK_ENABLE();  break;
+    case 3U:  __HAL_RCC_TIM4_CLK_ENABLE();  break;
+    case 4U:  __HAL_RCC_TIM5_CLK_ENABLE();  break;
+    case 5U:  __HAL_RCC_TIM6_CLK_ENABLE();  break;
+    case 6U:  __HAL_RCC_TIM7_CLK_ENABLE();  break;
+    case 7U:  __HAL_RCC_TIM8_CLK_ENABLE();  break;
+    case 8U:  __HAL_RCC_TIM9_CLK_ENABLE();  break;
+    case 9U:  __HAL_RCC_TIM10_CLK_ENABLE(); break;
+    case 10U: __HAL_RCC_TIM11_CLK_ENABLE(); break;
+    case 11U: __HAL_RCC_TIM12_CLK_ENABLE(); break;
+    case 12U: __HAL_RCC_TIM13_CLK_ENABLE(); break;
+    default:  __HAL_RCC_TIM14_CLK_ENABLE(); break;
+    }
+}
+
+/**
+ * @brief Counts a denied claim.
+ *
+ * @param owner  Claiming module
+ * @param holder Holder of the wanted timer, TIM_ALLOC_OWNER_NONE if no
+ *               timer had the capabilities
+ * @return None
+ */
+static void tim_alloc_conflict(tim_alloc_owner_t owner, tim_alloc_owner_t holder)
+{
+    if (g_tim_alloc_stats.u8_conflicts < 0xFFU) {
+        g_tim_alloc_stats.u8_conflicts++;
+    }
+    g_tim_alloc_stats.last_denied = owner;
+    g_tim_alloc_stats.last_holder = holder;
+}
+
+/**
+ * @brief Returns whether another timer with a handler is served by a
+ *        vector.
+ *
+ * @param irqn      Vector
+ * @param u8_except Timer to ignore
+ * @return 1 in use, 0 free
+ */
+static uint8_t tim_alloc_vector_in_use(IRQn_Type irqn, uint8_t u8_except)
+{
+    for (uint8_t i = 0U; i < TIM_ALLOC_TIMERS; i++) {
+        if ((i == u8_except) || (g_tim_alloc_slots[i].handler == NULL)) {
+            continue;
+        }
+        for (uint8_t v = 0U; v < g_tim_alloc_timers[i].u8_vectors; v++) {
+            if (g_tim_alloc_timers[i].vectors[v] == irqn) {
+                return 1U;
+            }
+        }
+    }
+
+    return 0U;
+}
+
+/**
+ * @brief Serves the pending enabled flags of one timer on a vector.
+ *
+ * @param u8_index Table index
+ * @param u32_mask Flags belonging to the calling vector
+ * @return None
+ */
+static void tim_alloc_dispatch(uint8_t u8_index, uint32_t u32_mask)
+{
+    TIM_TypeDef *tim = g_tim_alloc_timers[u8_index].instance;
+    tim_alloc_handler_t handler = g_tim_alloc_slots[u8_index].handler;
+    uint32_t u32_flags = tim->SR & tim->DIER & u32_mask;
+
+    if (u32_flags == 0U) {
+        return;
+    }
+
+    tim->SR = ~u32_flags;
+    if (handler != NULL) {
+        handler(tim, u32_flags, g_tim_alloc_slots[u8_index].p_context);
+    }
+}
+
+/**
+ * @brief Common part of the start functions.
+ *
+ * @param soft             Timer
+ * @param u32_delay_ticks  Ticks to the first expiry
+ * @param u32_period_ticks Period, 0 for one-shot
+ * @param fn               Callback
+ * @param context          Passed to fn
+ * @param u8_deferred      1: callback from tim_alloc_wheel_poll()
+ * @return HAL_OK, HAL_ERROR for invalid arguments
+ */
+static HAL_StatusTypeDef tim_alloc_soft_arm(tim_alloc_soft_t *soft, uint32_t u32_delay_ticks,
+                                            uint32_t u32_period_ticks, tim_alloc_soft_fn_t fn,
+                                            void *context, uint8_t u8_deferred)
+{
+    uint32_t u32_primask;
+
+    if ((soft == NULL) || (fn == NULL) || (u32_delay_ticks == 0U) ||
+        (u32_delay_ticks >= TIM_ALLOC_WHEEL_RANGE) || (u32_period_ticks >= TIM_ALLOC_WHEEL_RANGE)) {
+        return HAL_ERROR;
+    }
+
+    u32_primask = __get_PRIMASK();
+    __disable_irq();
+
+    tim_alloc_soft_stop(soft);
+    soft->fn          = fn;
+    soft->p_context   = context;
+    soft->u32_period  = u32_period_ticks;
+    soft->u8_deferred = u8_deferred;
+
+    if (soft->u8_state == TIM_ALLOC_SOFT_DUE_STOPPED) {
+        /* Still linked in the due list of the running tick: it inserts */
+        soft->u32_expires = u32_delay_ticks;
+        soft->u8_state    = TIM_ALLOC_SOFT_DUE_RESTART;
+    } else {
+        tim_alloc_soft_insert(soft, u32_delay_ticks);
+    }
+
+    __set_PRIMASK(u32_primask);
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Links a software timer into the slot of its expiry: the lowest
+ *        level whose range covers the distance to now.
+ *
+ * @param soft Timer (not linked, u32_expires set, interrupts disabled)
+ * @return None
+ */
+static void tim_alloc_soft_link(tim_alloc_soft_t *soft)
+{
+    uint32_t u32_delta = soft->u32_expires - g_u32_tim_alloc_wheel_now;
+    uint32_t u32_level = 0U;
+    tim_alloc_soft_t **pp_head;
+
+    while ((u32_level < (TIM_ALLOC_WHEEL_LEVELS - 1U)) &&
+           (u32_delta >= (1UL << (TIM_ALLOC_WHEEL_BITS * (u32_level + 1U))))) {
+        u32_level++;
+    }
+    pp_head = &g_p_tim_alloc_wheel[u32_level]
+                                  [(soft->u32_expires >> (TIM_ALLOC_WHEEL_BITS * u32_level)) & TIM_ALLOC_WHEEL_MASK];
+
+    soft->p_next  = *pp_head;
+    soft->pp_prev = pp_head;
+    if (*pp_head != NULL) {
+        (*pp_head)->pp_prev = &soft->p_next;
+    }
+    *pp_head = soft;
+    soft->u8_state = TIM_ALLOC_SOFT_WAITING;
+}
+
+/**
+ * @brief Links a software timer expiring a delay from now.
+ *
+ * @param soft      Timer (not linked, interrupts disabled)
+ * @param u32_delay Ticks from now (1 .. TIM_ALLOC_WHEEL_RANGE - 1)
+ * @return None
+ */
+static void tim_alloc_soft_insert(tim_alloc_soft_t *soft, uint32_t u32_delay)
+{
+    soft->u32_expires = g_u32_tim_alloc_wheel_now + u32_delay;
+    tim_alloc_soft_link(soft);
+}
+
+/**
+ * @brief Redistributes the upper slots that became current with the new
+ *        tick (now a multiple of 32): level 1 every 32 ticks, level 2
+ *        every 1024 ticks, ... Their timers land one or more levels
+ *        lower, those due now in the current level 0 slot.
+ *
+ * @return None
+ */
+static void tim_alloc_wheel_cascade(void)
+{
+    for (uint32_t u32_level = 1U; u32_level < TIM_ALLOC_WHEEL_LEVELS; u32_level++) {
+        uint32_t u32_slot = (g_u32_tim_alloc_wheel_now >> (TIM_ALLOC_WHEEL_BITS * u32_level)) & TIM_ALLOC_WHEEL_MASK;
+        tim_alloc_soft_t *list = g_p_tim_alloc_wheel[u32_level][u32_slot];
+
+        g_p_tim_alloc_wheel[u32_level][u32_slot] = NULL;
+        while (list != NULL) {
+            tim_alloc_soft_t *soft = list;
+
+            list = soft->p_next;
+            tim_alloc_soft_link(soft);
+            g_tim_alloc_stats.u32_wheel_cascaded++;
+        }
+
+        /* The next level only turns when this one wrapped */
+        if (u32_slot != 0U) {
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Wheel tick: cascade, then every timer of the current level 0
+ *        slot is due. The due ones are taken out first and called
+ *        afterwards, so callbacks can start and stop timers freely.
+ *
+ * @param tim       Wheel timer
+ * @param u32_flags Served flags
+ * @param context   Unused
+ * @return None
+ */
+static void tim_alloc_wheel_tick(TIM_TypeDef *tim, uint32_t u32_flags, void *context)
+{
+    tim_alloc_soft_t *list;
+    tim_alloc_soft_t *due = NULL;
+    uint32_t u32_slot;
+    uint32_t u32_primask;
+
+    (void)tim;
+    (void)context;
+    if ((u32_flags & TIM_SR_UIF) == 0U) {
+        return;
+    }
+
+    u32_primask = __get_PRIMASK();
+    __disable_irq();
+
+    u32_slot = ++g_u32_tim_alloc_wheel_now & TIM_ALLOC_WHEEL_MASK;
+    if (u32_slot == 0U) {
+        tim_alloc_wheel_cascade();
+    }
+    list = g_p_tim_alloc_wheel[0][u32_slot];
+    g_p_tim_alloc_wheel[0][u32_slot] = NULL;
+    g_tim_alloc_stats.u32_wheel_ticks++;
+
+    while (list != NULL) {
+        tim_alloc_soft_t *soft = list;
+
+        list = soft->p_next;
+        soft->u8_state = TIM_ALLOC_SOFT_DUE;
+        soft->pp_prev  = NULL;
+        soft->p_next   = due;
+        due = soft;
+    }
+
+    while (due != NULL) {
+        tim_alloc_soft_t *soft = due;
+
+        due = soft->p_next;
+        soft->p_next = NULL;
+
+        if (soft->u8_state == TIM_ALLOC_SOFT_DUE_STOPPED) {
+            soft->u8_state = TIM_ALLOC_SOFT_IDLE;
+            continue;
+        }
+        if (soft->u8_state == TIM_ALLOC_SOFT_DUE_RESTART) {
+            tim_alloc_soft_insert(soft, soft->u32_expires);
+            continue;
+        }
+
+        if (soft->u32_period != 0U) {
+            tim_alloc_soft_insert(soft, soft->u32_period);
+        } else {
+            soft->u8_state = TIM_ALLOC_SOFT_IDLE;
+        }
+        g_tim_alloc_stats.u32_wheel_fired++;
+
+        if (soft->u8_deferred) {
+            if (soft->u8_queued == TIM_ALLOC_SOFT_UNQUEUED) {
+                soft->u8_queued    = TIM_ALLOC_SOFT_QUEUED;
+                soft->p_queue_next = NULL;
+                if (g_p_tim_alloc_queue_tail != NULL) {
+                    g_p_tim_alloc_queue_tail->p_queue_next = soft;
+                } else {
+                    g_p_tim_alloc_queue_head = soft;
+                }
+                g_p_tim_alloc_queue_tail = soft;
+            } else if (soft->u8_queued == TIM_ALLOC_SOFT_DROPPED) {
+                /* Restarted after a stop, still in the queue: pending again */
+                soft->u8_queued = TIM_ALLOC_SOFT_QUEUED;
+            } else {
+                g_tim_alloc_stats.u32_wheel_overruns++;
+            }
+            continue;
+        }
+
+        /* Callback with interrupts on, the due list is private to this tick */
+        __set_PRIMASK(u32_primask);
+        soft->fn(soft->p_context);
+        __disable_irq();
+    }
+
+    __set_PRIMASK(u32_primask);
+}
+
+/* Interrupt / callback section -------------------------------------------- */
+void TIM2_IRQHandler(void)
+{
+    tim_alloc_dispatch(1U, TIM_ALLOC_IRQ_FLAGS);
+}
+
+void TIM1_UP_TIM10_IRQHandler(void)
+{
+    tim_alloc_dispatch(0U, TIM_SR_UIF);
+    tim_alloc_dispatch(9U, TIM_ALLOC_IRQ_FLAGS);
+}
+
+void TIM1_BRK_TIM9_IRQHandler(void)
+{
+    tim_alloc_dispatch(0U, TIM_SR_BIF);
+    tim_alloc_dispatch(8U, TIM_ALLOC_IRQ_FLAGS);
+}
+
+void TIM1_TRG_COM_TIM11_IRQHandler(void)
+{
+    tim_alloc_dispatch(0U, TIM_SR_TIF | TIM_SR_COMIF);
+    tim_alloc_dispatch(10U, TIM_ALLOC_IRQ_FLAGS);
+}
+
+void TIM1_CC_IRQHandler(void)
+{
+    tim_alloc_dispatch(0U, TIM_ALLOC_CC_FLAGS);
+}
+
+void TIM8_BRK_TIM12_IRQHandler(void)
+{
+    tim_alloc_dispatch(7U, TIM_SR_BIF);
+    tim_alloc_dispatch(11U, TIM_ALLOC_IRQ_FLAGS);
+}
+
+void TIM8_CC_IRQHandler(void)
+{
+    tim_alloc_dispatch(7U, TIM_ALLOC_CC_FLAGS);
+}
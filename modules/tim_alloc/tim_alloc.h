@@ -0,0 +1,296 @@
+/**
+ ******************************************************************************
+ * @file        tim_alloc.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the timer allocator and timer wheel.
+ *
+ * @details
+ * The modules claim the timer they drive before touching it, the same
+ * way they claim DMA streams from dma_alloc. Two modules on one timer
+ * (e.g. potis_dma and the ESD DMA refresh both on TIM8, or a fan PWM on
+ * the TIM1 of the dot) no longer reprogram each other silently: the
+ * second claim fails with HAL_BUSY and is counted with the owner holding
+ * the timer. Code that only needs "a timer" asks by capability (32 bit,
+ * advanced PWM, input capture, 4 channels, interrupt dispatch) and gets
+ * the free one with the fewest other capabilities, so the scarce timers
+ * stay available.
+ *
+ * The vectors that no module owns are served here: TIM2, TIM1_CC,
+ * TIM8_CC and the ones TIM1 / TIM8 share with TIM9..TIM12. Every timer
+ * of a vector with pending enabled flags gets its handler called once
+ * with those flags, already cleared. The vectors of TIM3..TIM7, TIM13
+ * and TIM14 stay with their modules.
+ *
+ * The timer wheel runs any number of software timers on one of those
+ * timers. It is hierarchical: 4 levels of 32 slots, level n holds the
+ * timers due in less than 32^(n + 1) ticks, in the slot of bits
+ * 5n..5n+4 of their expiry. Level 0 slots hold only timers due in that
+ * exact tick; every 32 ticks one slot of level 1 is redistributed to
+ * level 0 (every 1024 one of level 2, ...), so a timer moves down at
+ * most three times in its life. Start and stop are O(1) (doubly linked
+ * slot lists), a tick costs the due timers plus the amortised cascades,
+ * independent of the number of waiting timers. Delays and periods are
+ * limited to TIM_ALLOC_WHEEL_RANGE ticks (2^20, 17 min at 1 kHz).
+ *
+ * Callbacks run in the interrupt of the wheel timer, or deferred:
+ * tim_alloc_soft_start_deferred() queues the expiry and the main loop
+ * (or a sched event task) runs the queued callbacks with
+ * tim_alloc_wheel_poll(). The release grid of a periodic deferred timer
+ * stays in the interrupt; an expiry that finds the previous one still
+ * queued is counted as overrun instead of queued twice.
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - Claim by instance (fixed wiring) or by capability, release, owner
+ *    per timer and the last denied claim
+ *  - Interrupt handlers of TIM2, TIM1_UP_TIM10, TIM1_BRK_TIM9,
+ *    TIM1_TRG_COM_TIM11, TIM1_CC, TIM8_BRK_TIM12 and TIM8_CC with
+ *    per-timer dispatch
+ *  - Hierarchical timer wheel: one-shot and periodic software timers,
+ *    O(1) start / stop, callbacks in the interrupt of the wheel timer or
+ *    deferred to tim_alloc_wheel_poll()
+ *
+ ******************************************************************************
+ */
+
+#ifndef TIM_ALLOC_TIM_ALLOC_H_
+#define TIM_ALLOC_TIM_ALLOC_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief Timers TIM1..TIM14, index = number - 1.
+ */
+#define TIM_ALLOC_TIMERS        14U
+
+/**
+ * @brief Capabilities of a timer.
+ */
+#define TIM_ALLOC_CAP_32BIT     0x01U   /**< 32 bit counter (TIM2, TIM5)       */
+#define TIM_ALLOC_CAP_ADVANCED  0x02U   /**< Complementary PWM, dead time, RCR */
+#define TIM_ALLOC_CAP_CAPTURE   0x04U   /**< Capture/compare channels          */
+#define TIM_ALLOC_CAP_4CH       0x08U   /**< Four channels                     */
+#define TIM_ALLOC_CAP_IRQ       0x10U   /**< Vector dispatched by tim_alloc    */
+
+/**
+ * @brief Timer wheel: slot index bits per level, levels, slots per level
+ *        and the longest delay in ticks (exclusive).
+ */
+#define TIM_ALLOC_WHEEL_BITS    5U
+#define TIM_ALLOC_WHEEL_LEVELS  4U
+#define TIM_ALLOC_WHEEL_SLOTS   (1UL << TIM_ALLOC_WHEEL_BITS)
+#define TIM_ALLOC_WHEEL_RANGE   (1UL << (TIM_ALLOC_WHEEL_BITS * TIM_ALLOC_WHEEL_LEVELS))
+
+#if (TIM_ALLOC_WHEEL_BITS * TIM_ALLOC_WHEEL_LEVELS) > 31U
+#error "TIM_ALLOC_WHEEL_BITS * TIM_ALLOC_WHEEL_LEVELS must be at most 31"
+#endif
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Users of the timers.
+ */
+typedef enum {
+    TIM_ALLOC_OWNER_ADC_SCHED = 0,  /**< Regular trigger, round timer (caps)  */
+    TIM_ALLOC_OWNER_DOT,            /**< TIM1 CH2 carrier, fade DMA           */
+    TIM_ALLOC_OWNER_DOT_BLINK,      /**< TIM4 blink gate                      */
+    TIM_ALLOC_OWNER_ESD_REFRESH,    /**< TIM7 refresh interrupt               */
+    TIM_ALLOC_OWNER_ESD_DMA,        /**< TIM8 DMA refresh requests            */
+    TIM_ALLOC_OWNER_ESD_COUNTER,    /**< Counter / mirror steps (by caps)     */
+    TIM_ALLOC_OWNER_FAN_PWM,        /**< TIM9 (TIM1 / TIM8) PWM               */
+    TIM_ALLOC_OWNER_FAN_CONTROL,    /**< TIM6 control task                    */
+    TIM_ALLOC_OWNER_IDLE,           /**< TIM13 tickless wakeup                */
+    TIM_ALLOC_OWNER_JOYSTICK,       /**< TIM3 key sampling                    */
+    TIM_ALLOC_OWNER_LAPTIMER,       /**< TIM5 multi-lane lap captures         */
+    TIM_ALLOC_OWNER_OSAL,           /**< TIM14 HAL tick (RTOS build)          */
+    TIM_ALLOC_OWNER_POTIS_DMA,      /**< TIM8 ADC trigger                     */
+    TIM_ALLOC_OWNER_SIGINJECT,      /**< TIM5 / TIM7 DAC triggers             */
+    TIM_ALLOC_OWNER_STOPWATCH,      /**< TIM5 time base and capture           */
+    TIM_ALLOC_OWNER_TIMEBASE,       /**< TIM2 system timebase (tacho stamps)  */
+    TIM_ALLOC_OWNER_WHEEL,          /**< Timer wheel tick                     */
+    TIM_ALLOC_OWNER_APP,            /**< Application (main.c)                 */
+    TIM_ALLOC_OWNER_COUNT,
+    TIM_ALLOC_OWNER_NONE = TIM_ALLOC_OWNER_COUNT  /**< Free timer         */
+} tim_alloc_owner_t;
+
+/**
+ * @brief Interrupt handler of a timer: status flags that were pending and
+ *        enabled (already cleared in SR).
+ */
+typedef void (*tim_alloc_handler_t)(TIM_TypeDef *tim, uint32_t u32_flags, void *context);
+
+/**
+ * @brief Callback of a software timer (interrupt of the wheel timer).
+ */
+typedef void (*tim_alloc_soft_fn_t)(void *context);
+
+/**
+ * @brief Software timer, owned by the caller and zero initialised
+ *        (static or = {0}); contents are private.
+ */
+typedef struct tim_alloc_soft_s {
+    struct tim_alloc_soft_s  *p_next;
+    struct tim_alloc_soft_s **pp_prev;
+    struct tim_alloc_soft_s  *p_queue_next;
+    tim_alloc_soft_fn_t       fn;
+    void                     *p_context;
+    uint32_t                  u32_expires;
+    uint32_t                  u32_period;
+    uint8_t                   u8_state;
+    uint8_t                   u8_deferred;
+    uint8_t                   u8_queued;
+} tim_alloc_soft_t;
+
+/**
+ * @brief Allocation state.
+ */
+typedef struct {
+    uint8_t           u8_used;          /**< Claimed timers                    */
+    uint8_t           u8_conflicts;     /**< Denied claims                     */
+    tim_alloc_owner_t last_denied;      /**< Owner of the last denied claim    */
+    tim_alloc_owner_t last_holder;      /**< Holder of the timer it wanted     */
+    uint32_t          u32_wheel_ticks;  /**< Ticks of the wheel                */
+    uint32_t          u32_wheel_fired;  /**< Software timer expiries           */
+    uint32_t          u32_wheel_cascaded; /**< Timers moved down a level       */
+    uint32_t          u32_wheel_overruns; /**< Deferred expiries still queued  */
+} tim_alloc_stats_t;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Claims a given timer and enables its clock. A second claim of
+ *        the same owner succeeds (re-init).
+ *
+ * @param tim   TIM1..TIM14
+ * @param owner Claiming module
+ * @return HAL_OK, HAL_BUSY if another owner holds it (counted as
+ *         conflict), HAL_ERROR for invalid arguments
+ */
+HAL_StatusTypeDef tim_alloc_claim(TIM_TypeDef *tim, tim_alloc_owner_t owner);
+
+/**
+ * @brief Claims a free timer with all capabilities of a mask and enables
+ *        its clock; among those the one with the fewest other
+ *        capabilities.
+ *
+ * @param u32_caps TIM_ALLOC_CAP_* mask
+ * @param owner    Claiming module
+ * @return Timer, NULL if none is free (counted as conflict)
+ */
+TIM_TypeDef *tim_alloc_claim_caps(uint32_t u32_caps, tim_alloc_owner_t owner);
+
+/**
+ * @brief Frees a timer: stops it, removes the handler, disables its
+ *        dispatched vectors not used by another timer.
+ *
+ * @param tim   Timer
+ * @param owner Holder (claims of others are not released)
+ * @return None
+ */
+void tim_alloc_release(TIM_TypeDef *tim, tim_alloc_owner_t owner);
+
+/**
+ * @brief Installs the interrupt handler of a claimed timer with a
+ *        dispatched vector (TIM_ALLOC_CAP_IRQ) and enables its vectors.
+ *        A vector shared with another timer keeps the more urgent
+ *        priority. The caller enables the interrupts in DIER.
+ *
+ * @param tim          Timer
+ * @param handler      Handler
+ * @param context      Passed to the handler
+ * @param u32_priority NVIC preemption priority (IRQ_CLASS_*)
+ * @return HAL_OK, HAL_ERROR if the timer is not claimed or its vector is
+ *         owned by a module
+ */
+HAL_StatusTypeDef tim_alloc_set_handler(TIM_TypeDef *tim, tim_alloc_handler_t handler,
+                                        void *context, uint32_t u32_priority);
+
+/**
+ * @brief Returns the owner of a timer.
+ *
+ * @param tim Timer
+ * @return Owner, TIM_ALLOC_OWNER_NONE for a free or unknown timer
+ */
+tim_alloc_owner_t tim_alloc_get_owner(const TIM_TypeDef *tim);
+
+/**
+ * @brief Returns the input clock of a timer (APB1 or APB2 timer clock).
+ *
+ * @param tim Timer
+ * @return Clock in Hz
+ */
+uint32_t tim_alloc_get_clock(const TIM_TypeDef *tim);
+
+/**
+ * @brief Starts the timer wheel on a timer claimed by capability.
+ *
+ * @param u32_tick_hz  Tick rate (1 .. 100000)
+ * @param u32_priority NVIC preemption priority of the ticks (IRQ_CLASS_*)
+ * @return HAL_OK, HAL_BUSY if no timer is free, HAL_ERROR for an invalid
+ *         rate
+ */
+HAL_StatusTypeDef tim_alloc_wheel_start(uint32_t u32_tick_hz, uint32_t u32_priority);
+
+/**
+ * @brief Returns the ticks of the wheel since its start.
+ *
+ * @return Ticks (wrapping at 2^32)
+ */
+uint32_t tim_alloc_wheel_now(void);
+
+/**
+ * @brief Starts (or restarts) a software timer, callback in the
+ *        interrupt of the wheel timer.
+ *
+ * Callable from thread and interrupt context and from the callbacks,
+ * also for a timer due in the same tick (a stopped or restarted one is
+ * not called for that tick).
+ *
+ * @param soft             Timer, kept by the wheel until it expires or
+ *                         is stopped
+ * @param u32_delay_ticks  Ticks to the first expiry
+ *                         (1 .. TIM_ALLOC_WHEEL_RANGE - 1)
+ * @param u32_period_ticks Period afterwards, 0 for one-shot
+ *                         (< TIM_ALLOC_WHEEL_RANGE)
+ * @param fn               Callback
+ * @param context          Passed to fn
+ * @return HAL_OK, HAL_ERROR for invalid arguments
+ */
+HAL_StatusTypeDef tim_alloc_soft_start(tim_alloc_soft_t *soft, uint32_t u32_delay_ticks,
+                                       uint32_t u32_period_ticks, tim_alloc_soft_fn_t fn, void *context);
+
+/**
+ * @brief Same as tim_alloc_soft_start(), the callback runs in
+ *        tim_alloc_wheel_poll(). A queued expiry of a timer stopped
+ *        before the poll is dropped.
+ */
+HAL_StatusTypeDef tim_alloc_soft_start_deferred(tim_alloc_soft_t *soft, uint32_t u32_delay_ticks,
+                                                uint32_t u32_period_ticks, tim_alloc_soft_fn_t fn,
+                                                void *context);
+
+/**
+ * @brief Runs the callbacks of the deferred expiries queued so far (not
+ *        the ones queued meanwhile). Thread context only.
+ *
+ * @return Number of callbacks run
+ */
+uint32_t tim_alloc_wheel_poll(void);
+
+/**
+ * @brief Stops a software timer (no-op if it does not run).
+ *
+ * @param soft Timer
+ * @return None
+ */
+void tim_alloc_soft_stop(tim_alloc_soft_t *soft);
+
+/**
+ * @brief Returns the allocation state.
+ *
+ * @return State
+ */
+const tim_alloc_stats_t *tim_alloc_get_stats(void);
+
+#endif /* TIM_ALLOC_TIM_ALLOC_H_ */
@@ -0,0 +1,143 @@
+/**
+ ******************************************************************************
+ * @file        timebase.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       System timebase: TIM2 at 1 MHz, extended to 64 bits by the
+ *              wrap count of its update interrupt.
+ *
+ * Functionality:
+ * - TIM2 with the full 32 bit period, URS set so only the wrap raises
+ *   the update flag (not the UG of a prescaler change)
+ * - The 64 bit read takes wrap count, counter and pending flag together
+ *   and repeats if the interrupt counted in between; a wrap not served
+ *   yet (masked interrupts) is added when the counter is in its lower
+ *   half
+ *
+ * Resources:
+ * - TIM2 (tim_alloc), its vector through tim_alloc_set_handler()
+ ******************************************************************************
+ */
+
+#include "timebase.h"
+#include "tim_alloc/tim_alloc.h"
+#include "irq/irq.h"
+
+/* Static module variables -------------------------------------------------- */
+/**
+ * @brief TIM2 handle, shared with the input capture users.
+ */
+static TIM_HandleTypeDef g_timebase_handle;
+static uint8_t g_u8_timebase_ready = 0u;
+
+/**
+ * @brief Wraps of the counter, upper word of the time.
+ */
+static volatile uint32_t g_u32_timebase_wraps = 0u;
+
+/* Static function prototypes ----------------------------------------------- */
+static void timebase_wrap(TIM_TypeDef *tim, uint32_t u32_flags, void *context);
+
+/* Public functions --------------------------------------------------------- */
+HAL_StatusTypeDef timebase_init(void)
+{
+    uint32_t u32_prescaler = tim_alloc_get_clock(TIMEBASE_TIM) / TIMEBASE_HZ - 1u;
+    uint32_t u32_primask;
+    uint32_t u32_count;
+
+    if (g_u8_timebase_ready) {
+        /* The new prescaler needs an update event, the count is kept */
+        u32_primask = __get_PRIMASK();
+        __disable_irq();
+        u32_count = TIMEBASE_TIM->CNT;
+        TIMEBASE_TIM->PSC = u32_prescaler;
+        TIMEBASE_TIM->EGR = TIM_EGR_UG;
+        TIMEBASE_TIM->CNT = u32_count;
+        __set_PRIMASK(u32_primask);
+
+        g_timebase_handle.Init.Prescaler = u32_prescaler;
+        return HAL_OK;
+    }
+
+    if (tim_alloc_claim(TIMEBASE_TIM, TIM_ALLOC_OWNER_TIMEBASE) != HAL_OK) {
+        return HAL_BUSY;
+    }
+
+    g_timebase_handle.Instance               = TIMEBASE_TIM;
+    g_timebase_handle.Init.Prescaler         = u32_prescaler;
+    g_timebase_handle.Init.Period            = 0xFFFFFFFFUL;
+    g_timebase_handle.Init.CounterMode       = TIM_COUNTERMODE_UP;
+    g_timebase_handle.Init.ClockDivision     = TIM_CLOCKDIVISION_DIV1;
+    g_timebase_handle.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+    if (HAL_TIM_Base_Init(&g_timebase_handle) != HAL_OK) {
+        tim_alloc_release(TIMEBASE_TIM, TIM_ALLOC_OWNER_TIMEBASE);
+        return HAL_ERROR;
+    }
+
+    /* The UG of the init has set the flag, it is no wrap */
+    TIMEBASE_TIM->CR1 |= TIM_CR1_URS;
+    __HAL_TIM_CLEAR_FLAG(&g_timebase_handle, TIM_FLAG_UPDATE);
+    g_u32_timebase_wraps = 0u;
+
+    (void)tim_alloc_set_handler(TIMEBASE_TIM, timebase_wrap, NULL, IRQ_CLASS_CAPTURE);
+    __HAL_TIM_ENABLE_IT(&g_timebase_handle, TIM_IT_UPDATE);
+    __HAL_TIM_ENABLE(&g_timebase_handle);
+    g_u8_timebase_ready = 1u;
+
+    return HAL_OK;
+}
+
+uint64_t timebase_now(void)
+{
+    uint32_t u32_wraps;
+    uint32_t u32_count;
+    uint32_t u32_pending;
+
+    do {
+        u32_wraps   = g_u32_timebase_wraps;
+        u32_count   = TIMEBASE_TIM->CNT;
+        u32_pending = TIMEBASE_TIM->SR & TIM_SR_UIF;
+    } while (u32_wraps != g_u32_timebase_wraps);
+
+    /* Wrapped, interrupt not served yet (masked or a higher priority) */
+    if ((u32_pending != 0u) && (u32_count < 0x80000000UL)) {
+        u32_wraps++;
+    }
+
+    return ((uint64_t)u32_wraps << 32) | u32_count;
+}
+
+uint64_t timebase_extend(uint32_t u32_stamp)
+{
+    uint64_t u64_now = timebase_now();
+
+    return u64_now - (uint32_t)((uint32_t)u64_now - u32_stamp);
+}
+
+uint32_t timebase_ms(void)
+{
+    return (uint32_t)(timebase_now() / 1000u);
+}
+
+TIM_HandleTypeDef *timebase_get_timer(void)
+{
+    return g_u8_timebase_ready ? &g_timebase_handle : NULL;
+}
+
+/* Static functions --------------------------------------------------------- */
+/**
+ * @brief Update interrupt of TIM2 (flags cleared by tim_alloc): one wrap.
+ *
+ * Runs at IRQ_CLASS_CAPTURE, no reader interrupts it between the clear
+ * of the flag and the count.
+ */
+static void timebase_wrap(TIM_TypeDef *tim, uint32_t u32_flags, void *context)
+{
+    (void)tim;
+    (void)context;
+
+    if ((u32_flags & TIM_SR_UIF) != 0u) {
+        g_u32_timebase_wraps++;
+    }
+}
@@ -0,0 +1,104 @@
+/**
+ ******************************************************************************
+ * @file        timebase.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the system timebase: one microsecond
+ *              clock for all time stamps.
+ *
+ * @details
+ * TIM2 counts microseconds from timebase_init() on, free running over
+ * its full 32 bits; the update interrupt counts the wraps (every 71.6
+ * minutes) into the upper word of a 64 bit time. Samples and events of
+ * all modules are stamped with this one clock, so tacho edges, button
+ * presses, log messages and control steps line up without per module
+ * conversions:
+ *
+ *  - timebase_now32(): one register read, for intervals and for stamps
+ *    in interrupts (wraps, differences stay right up to 71 minutes)
+ *  - timebase_now(): 64 bit microseconds, never wraps
+ *  - timebase_extend(): a 32 bit stamp of the last 35 minutes (e.g. an
+ *    input capture of TIM2 taken by DMA) to the 64 bit time
+ *
+ * Input capture channels of TIM2 (the fan tacho) run on the interface of
+ * timebase_get_timer() and stamp in the same clock; they must not
+ * initialise the time base of TIM2 again.
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - 1 MHz from the APB1 timer clock, set up again by timebase_init()
+ *    after a clock profile change (the count goes on)
+ *  - Wrap count in the update interrupt at IRQ_CLASS_CAPTURE, readers in
+ *    any context (also with masked interrupts) see a pending wrap
+ *  - The counter stops in the STOP mode like the HAL tick, the time of a
+ *    stop is not counted
+ *
+ ******************************************************************************
+ */
+
+#ifndef TIMEBASE_TIMEBASE_H_
+#define TIMEBASE_TIMEBASE_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief Timer of the time base and its rate.
+ */
+#define TIMEBASE_TIM            TIM2
+#define TIMEBASE_HZ             1000000UL
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Claims TIM2 and starts it at 1 MHz; later calls only set the
+ *        prescaler for the current clock.
+ *
+ * @return HAL_OK, HAL_BUSY if another module holds TIM2
+ */
+HAL_StatusTypeDef timebase_init(void);
+
+/**
+ * @brief Returns the low 32 bits of the time (any context).
+ *
+ * @return Microseconds, wrapping
+ */
+static inline uint32_t timebase_now32(void)
+{
+    return TIMEBASE_TIM->CNT;
+}
+
+/**
+ * @brief Returns the 64 bit time (any context).
+ *
+ * @return Microseconds since timebase_init()
+ */
+uint64_t timebase_now(void);
+
+/**
+ * @brief Extends a 32 bit stamp of the last 2^31 microseconds to 64 bits.
+ *
+ * @param u32_stamp timebase_now32() or a TIM2 capture
+ * @return Microseconds since timebase_init()
+ */
+uint64_t timebase_extend(uint32_t u32_stamp);
+
+/**
+ * @brief Returns the 64 bit time in milliseconds, the clock of the
+ *        HAL tick but of the same origin as the microseconds.
+ *
+ * @return Milliseconds since timebase_init(), wrapping at 2^32
+ */
+uint32_t timebase_ms(void);
+
+/**
+ * @brief Returns the HAL handle of TIM2 for input capture channels,
+ *        initialised and running (HAL_TIM_IC_ConfigChannel(),
+ *        HAL_TIM_IC_Start_DMA()).
+ *
+ * @return Handle, NULL before timebase_init()
+ */
+TIM_HandleTypeDef *timebase_get_timer(void);
+
+#endif /* TIMEBASE_TIMEBASE_H_ */
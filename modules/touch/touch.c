@@ -0,0 +1,489 @@
+/**
+ ******************************************************************************
+ * @file        touch.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       STMPE811 touchscreen driver.
+ *
+ * Functionality:
+ * - Controller reset and touchscreen setup
+ * - Interrupt driven read sequence: clear status, FIFO level, burst, state
+ * - Trimmed mean per burst, mapping to screen pixels, event queue
+ *
+ * Resources:
+ * - I2C3 through env_sensor (bus arbitration, DMA1 Stream 2 for bursts)
+ * - PA15 / EXTI15 (through exti)
+ ******************************************************************************
+ */
+
+#include "touch.h"
+#include <env_sensor/env_sensor.h>
+#include <exti/exti.h>
+#include <osal/osal.h>
+#include <sync/sync.h>
+
+#include <stddef.h>
+
+/* Preprocessor Defines ----------------------------------------------------- */
+/**
+ * @brief STMPE811 registers.
+ */
+#define TOUCH_REG_CHIP_ID       0x00U
+#define TOUCH_REG_SYS_CTRL1     0x03U
+#define TOUCH_REG_SYS_CTRL2     0x04U
+#define TOUCH_REG_INT_CTRL      0x09U
+#define TOUCH_REG_INT_EN        0x0AU
+#define TOUCH_REG_INT_STA       0x0BU
+#define TOUCH_REG_GPIO_AF       0x17U
+#define TOUCH_REG_ADC_CTRL1     0x20U
+#define TOUCH_REG_ADC_CTRL2     0x21U
+#define TOUCH_REG_TSC_CTRL      0x40U
+#define TOUCH_REG_TSC_CFG       0x41U
+#define TOUCH_REG_FIFO_TH       0x4AU
+#define TOUCH_REG_FIFO_STA      0x4BU
+#define TOUCH_REG_FIFO_SIZE     0x4CU
+#define TOUCH_REG_TSC_FRACT_XYZ 0x56U
+#define TOUCH_REG_TSC_I_DRIVE   0x58U
+#define TOUCH_REG_TSC_DATA_XYZ  0xD7U   /**< FIFO, no auto increment      */
+
+/**
+ * @brief Register values.
+ */
+#define TOUCH_CHIP_ID           0x0811U
+#define TOUCH_SYS_CTRL1_RESET   0x02U
+#define TOUCH_SYS_CTRL2_ADC_TSC 0x0CU   /**< Clocks of ADC and TSC on      */
+#define TOUCH_INT_CTRL_EDGE_LOW 0x03U   /**< Global enable, falling edge   */
+#define TOUCH_INT_EN_TOUCH_FIFO 0x03U   /**< Touch detect, FIFO threshold  */
+#define TOUCH_TSC_CTRL_STA      0x80U   /**< Touch detected                */
+
+/**
+ * @brief Bytes of one FIFO sample (12 bit X, 12 bit Y, 8 bit Z).
+ */
+#define TOUCH_SAMPLE_BYTES      4U
+
+/**
+ * @brief Timeout of one register access during touch_init().
+ */
+#define TOUCH_TIMEOUT_MS        20U
+
+/* Type Definitions --------------------------------------------------------- */
+/**
+ * @brief Step of the read sequence, i.e. the transfer in flight.
+ */
+typedef enum {
+    TOUCH_STEP_IDLE = 0,
+    TOUCH_STEP_SYNC,        /**< Blocking access of touch_init()          */
+    TOUCH_STEP_CLEAR,       /**< INT_STA written                          */
+    TOUCH_STEP_SIZE,        /**< FIFO_SIZE read                           */
+    TOUCH_STEP_DATA,        /**< Samples read                             */
+    TOUCH_STEP_STATE        /**< TSC_CTRL read                            */
+} touch_step_t;
+
+/**
+ * @brief One register write of the setup.
+ */
+typedef struct {
+    uint8_t u8_reg;
+    uint8_t u8_value;
+    uint8_t u8_delay_ms;    /**< Wait after the write                     */
+} touch_setup_t;
+
+/* Static Module Variables -------------------------------------------------- */
+/**
+ * @brief Touchscreen setup after the reset, interrupt enable excluded:
+ *        12 bit ADC with 80 cycles sample time at 3.25 MHz, averaging of 4,
+ *        500 us settling and detect delay, 50 mA drive, X/Y/Z acquisition.
+ */
+static const touch_setup_t g_touch_setup[] = {
+    { TOUCH_REG_SYS_CTRL2,     TOUCH_SYS_CTRL2_ADC_TSC, 0U },
+    { TOUCH_REG_ADC_CTRL1,     0x49U,                   2U },
+    { TOUCH_REG_ADC_CTRL2,     0x01U,                   0U },
+    { TOUCH_REG_GPIO_AF,       0x00U,                   0U },
+    { TOUCH_REG_TSC_CFG,       0x9AU,                   0U },
+    { TOUCH_REG_FIFO_TH,       TOUCH_FIFO_THRESHOLD,    0U },
+    { TOUCH_REG_FIFO_STA,      0x01U,                   0U },
+    { TOUCH_REG_FIFO_STA,      0x00U,                   0U },
+    { TOUCH_REG_TSC_FRACT_XYZ, 0x01U,                   0U },
+    { TOUCH_REG_TSC_I_DRIVE,   0x01U,                   0U },
+    { TOUCH_REG_TSC_CTRL,      0x01U,                   0U },
+};
+
+static void touch_done(env_sensor_i2c_client_t *client, uint8_t error);
+
+static env_sensor_i2c_client_t g_touch_client = {
+    .i2c      = I2C3,
+    .i2c_addr = TOUCH_I2C_ADDR,
+    .done     = touch_done,
+};
+
+static volatile touch_step_t g_touch_step = TOUCH_STEP_IDLE;
+static volatile uint8_t g_u8_touch_again;       /**< Edge during a sequence   */
+static volatile uint8_t g_u8_touch_sync_error;
+static uint8_t g_u8_touch_pressed;
+static uint8_t g_u8_touch_count;                /**< Samples of the burst     */
+static uint8_t g_u8_touch_tx;
+static uint8_t g_u8_touch_rx[2];
+static uint8_t g_u8_touch_fifo[TOUCH_MAX_SAMPLES * TOUCH_SAMPLE_BYTES];
+static touch_event_t g_touch_last;
+static volatile uint32_t g_u32_touch_errors;
+
+static touch_event_t g_touch_queue_buffer[TOUCH_QUEUE_SIZE];
+static sync_queue_t g_touch_queue = SYNC_QUEUE_INIT(g_touch_queue_buffer);
+
+/* Static function prototypes ----------------------------------------------- */
+static HAL_StatusTypeDef touch_transfer(uint8_t u8_reg, uint8_t *pu8_data, uint16_t u16_len, uint8_t u8_write);
+static void touch_edge(void *context);
+static void touch_step(touch_step_t step, uint8_t u8_reg, uint8_t *pu8_data, uint16_t u16_len, uint8_t u8_write);
+static void touch_finish(void);
+static void touch_reduce(void);
+static void touch_update(uint8_t u8_touched, uint8_t u8_have_point);
+static uint16_t touch_trimmed_mean(uint16_t *pu16_values, uint8_t u8_count);
+static uint16_t touch_map(uint16_t u16_raw, int32_t i32_raw_0, int32_t i32_raw_end, int32_t i32_size);
+
+/* Public functions --------------------------------------------------------- */
+HAL_StatusTypeDef touch_init(void)
+{
+    GPIO_InitTypeDef gpio_init;
+    uint8_t u8_line = exti_pin_to_line(TOUCH_INT_PIN);
+
+    if ((g_touch_client.bus == NULL) && (env_sensor_i2c_attach(&g_touch_client) != HAL_OK)) {
+        return HAL_ERROR;
+    }
+
+    g_touch_step          = TOUCH_STEP_SYNC;
+    g_u8_touch_again      = 0u;
+    g_u8_touch_pressed    = 0u;
+    g_u32_touch_errors    = 0u;
+
+    if ((touch_transfer(TOUCH_REG_CHIP_ID, g_u8_touch_rx, 2u, 0u) != HAL_OK) ||
+        ((((uint16_t)g_u8_touch_rx[0] << 8) | g_u8_touch_rx[1]) != TOUCH_CHIP_ID)) {
+        g_touch_step = TOUCH_STEP_IDLE;
+        return HAL_ERROR;
+    }
+
+    g_u8_touch_tx = TOUCH_SYS_CTRL1_RESET;
+    (void)touch_transfer(TOUCH_REG_SYS_CTRL1, &g_u8_touch_tx, 1u, 1u);
+    osal_delay_ms(10u);
+    g_u8_touch_tx = 0x00u;
+    if (touch_transfer(TOUCH_REG_SYS_CTRL1, &g_u8_touch_tx, 1u, 1u) != HAL_OK) {
+        g_touch_step = TOUCH_STEP_IDLE;
+        return HAL_ERROR;
+    }
+    osal_delay_ms(2u);
+
+    for (uint8_t i = 0u; i < (sizeof(g_touch_setup) / sizeof(g_touch_setup[0])); i++) {
+        g_u8_touch_tx = g_touch_setup[i].u8_value;
+        if (touch_transfer(g_touch_setup[i].u8_reg, &g_u8_touch_tx, 1u, 1u) != HAL_OK) {
+            g_touch_step = TOUCH_STEP_IDLE;
+            return HAL_ERROR;
+        }
+        if (g_touch_setup[i].u8_delay_ms != 0u) {
+            osal_delay_ms(g_touch_setup[i].u8_delay_ms);
+        }
+    }
+
+    /* Handler before the pin, so no edge arrives without it */
+    if (exti_register(u8_line, touch_edge, NULL) != HAL_OK) {
+        g_touch_step = TOUCH_STEP_IDLE;
+        return HAL_BUSY;
+    }
+
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+    gpio_init.Pin   = TOUCH_INT_PIN;
+    gpio_init.Mode  = GPIO_MODE_IT_FALLING;
+    gpio_init.Pull  = GPIO_PULLUP;
+    gpio_init.Speed = GPIO_SPEED_FREQ_LOW;
+    HAL_GPIO_Init(TOUCH_INT_PORT, &gpio_init);
+    exti_enable_irq(u8_line, TOUCH_IRQ_PRIORITY, 0u);
+
+    g_u8_touch_tx = 0xFFu;
+    (void)touch_transfer(TOUCH_REG_INT_STA, &g_u8_touch_tx, 1u, 1u);
+    g_u8_touch_tx = TOUCH_INT_EN_TOUCH_FIFO;
+    (void)touch_transfer(TOUCH_REG_INT_EN, &g_u8_touch_tx, 1u, 1u);
+    g_u8_touch_tx = TOUCH_INT_CTRL_EDGE_LOW;
+    if (touch_transfer(TOUCH_REG_INT_CTRL, &g_u8_touch_tx, 1u, 1u) != HAL_OK) {
+        exti_unregister(u8_line);
+        g_touch_step = TOUCH_STEP_IDLE;
+        return HAL_ERROR;
+    }
+
+    /* Edges of the setup are served now */
+    touch_finish();
+
+    return HAL_OK;
+}
+
+uint8_t touch_get_event(touch_event_t *event)
+{
+    return sync_queue_pop(&g_touch_queue, event);
+}
+
+uint8_t touch_is_pressed(void)
+{
+    return g_u8_touch_pressed;
+}
+
+uint32_t touch_get_errors(void)
+{
+    return g_u32_touch_errors;
+}
+
+/* Static functions --------------------------------------------------------- */
+/**
+ * @brief Register access that waits for its end (touch_init() only).
+ *
+ * @param u8_reg   Register
+ * @param pu8_data Source / destination
+ * @param u16_len  Bytes
+ * @param u8_write 1 write, 0 read
+ * @return HAL_OK, HAL_ERROR on a bus error, HAL_TIMEOUT
+ */
+static HAL_StatusTypeDef touch_transfer(uint8_t u8_reg, uint8_t *pu8_data, uint16_t u16_len, uint8_t u8_write)
+{
+    uint32_t u32_start = HAL_GetTick();
+
+    g_u8_touch_sync_error = 0u;
+    if (env_sensor_i2c_submit(&g_touch_client, u8_reg, pu8_data, u16_len, u8_write) != HAL_OK) {
+        return HAL_ERROR;
+    }
+    while (g_touch_client.busy) {
+        if ((HAL_GetTick() - u32_start) > TOUCH_TIMEOUT_MS) {
+            return HAL_TIMEOUT;
+        }
+    }
+
+    return g_u8_touch_sync_error ? HAL_ERROR : HAL_OK;
+}
+
+/**
+ * @brief EXTI handler of the interrupt line: starts the read sequence, or
+ *        marks it for a restart if one is running.
+ *
+ * @param context Unused
+ * @return None
+ */
+static void touch_edge(void *context)
+{
+    uint32_t u32_primask = __get_PRIMASK();
+
+    (void)context;
+
+    __disable_irq();
+    if (g_touch_step != TOUCH_STEP_IDLE) {
+        g_u8_touch_again = 1u;
+        __set_PRIMASK(u32_primask);
+        return;
+    }
+    g_touch_step = TOUCH_STEP_CLEAR;
+    __set_PRIMASK(u32_primask);
+
+    /* Clear first: an event from now on raises a new edge */
+    g_u8_touch_tx = 0xFFu;
+    touch_step(TOUCH_STEP_CLEAR, TOUCH_REG_INT_STA, &g_u8_touch_tx, 1u, 1u);
+}
+
+/**
+ * @brief Requests the transfer of a step.
+ *
+ * @param step     Step
+ * @param u8_reg   Register
+ * @param pu8_data Source / destination
+ * @param u16_len  Bytes
+ * @param u8_write 1 write, 0 read
+ * @return None
+ */
+static void touch_step(touch_step_t step, uint8_t u8_reg, uint8_t *pu8_data, uint16_t u16_len, uint8_t u8_write)
+{
+    g_touch_step = step;
+    if (env_sensor_i2c_submit(&g_touch_client, u8_reg, pu8_data, u16_len, u8_write) != HAL_OK) {
+        g_u32_touch_errors++;
+        touch_finish();
+    }
+}
+
+/**
+ * @brief Ends a sequence; restarts it if an edge came in meanwhile.
+ *
+ * @return None
+ */
+static void touch_finish(void)
+{
+    uint32_t u32_primask = __get_PRIMASK();
+    uint8_t u8_again;
+
+    __disable_irq();
+    u8_again = g_u8_touch_again;
+    g_u8_touch_again = 0u;
+    g_touch_step = TOUCH_STEP_IDLE;
+    __set_PRIMASK(u32_primask);
+
+    if (u8_again) {
+        touch_edge(NULL);
+    }
+}
+
+/**
+ * @brief End of a transfer (end of transfer interrupt of I2C3): next step.
+ *
+ * @param client Touch client
+ * @param error  1 on a bus error
+ * @return None
+ */
+static void touch_done(env_sensor_i2c_client_t *client, uint8_t error)
+{
+    (void)client;
+
+    if (g_touch_step == TOUCH_STEP_SYNC) {
+        g_u8_touch_sync_error = error;
+        return;
+    }
+
+    if (error) {
+        g_u32_touch_errors++;
+        touch_finish();
+        return;
+    }
+
+    switch (g_touch_step) {
+    case TOUCH_STEP_CLEAR:
+        touch_step(TOUCH_STEP_SIZE, TOUCH_REG_FIFO_SIZE, g_u8_touch_rx, 1u, 0u);
+        break;
+
+    case TOUCH_STEP_SIZE:
+        g_u8_touch_count = g_u8_touch_rx[0];
+        if (g_u8_touch_count > TOUCH_MAX_SAMPLES) {
+            /* The rest follows in a second sequence */
+            g_u8_touch_count = TOUCH_MAX_SAMPLES;
+            g_u8_touch_again = 1u;
+        }
+        if (g_u8_touch_count != 0u) {
+            touch_step(TOUCH_STEP_DATA, TOUCH_REG_TSC_DATA_XYZ, g_u8_touch_fifo,
+                       (uint16_t)(g_u8_touch_count * TOUCH_SAMPLE_BYTES), 0u);
+        } else {
+            touch_step(TOUCH_STEP_STATE, TOUCH_REG_TSC_CTRL, g_u8_touch_rx, 1u, 0u);
+        }
+        break;
+
+    case TOUCH_STEP_DATA:
+        touch_reduce();
+        touch_step(TOUCH_STEP_STATE, TOUCH_REG_TSC_CTRL, g_u8_touch_rx, 1u, 0u);
+        break;
+
+    case TOUCH_STEP_STATE:
+        touch_update((g_u8_touch_rx[0] & TOUCH_TSC_CTRL_STA) != 0u, g_u8_touch_count != 0u);
+        g_u8_touch_count = 0u;
+        touch_finish();
+        break;
+
+    default:
+        touch_finish();
+        break;
+    }
+}
+
+/**
+ * @brief Reduces the samples of a burst to one point in g_touch_last.
+ *
+ * @return None
+ */
+static void touch_reduce(void)
+{
+    uint16_t u16_x[TOUCH_MAX_SAMPLES];
+    uint16_t u16_y[TOUCH_MAX_SAMPLES];
+    uint16_t u16_z[TOUCH_MAX_SAMPLES];
+
+    for (uint8_t i = 0u; i < g_u8_touch_count; i++) {
+        const uint8_t *pu8_sample = &g_u8_touch_fifo[TOUCH_SAMPLE_BYTES * i];
+
+        u16_x[i] = (uint16_t)(((uint16_t)pu8_sample[0] << 4) | (pu8_sample[1] >> 4));
+        u16_y[i] = (uint16_t)((((uint16_t)pu8_sample[1] & 0x0Fu) << 8) | pu8_sample[2]);
+        u16_z[i] = pu8_sample[3];
+    }
+
+    g_touch_last.u16_x       = touch_map(touch_trimmed_mean(u16_x, g_u8_touch_count),
+                                         TOUCH_RAW_X_LEFT, TOUCH_RAW_X_RIGHT, TOUCH_WIDTH);
+    g_touch_last.u16_y       = touch_map(touch_trimmed_mean(u16_y, g_u8_touch_count),
+                                         TOUCH_RAW_Y_TOP, TOUCH_RAW_Y_BOTTOM, TOUCH_HEIGHT);
+    g_touch_last.u8_pressure = (uint8_t)touch_trimmed_mean(u16_z, g_u8_touch_count);
+    g_touch_last.u8_samples  = g_u8_touch_count;
+}
+
+/**
+ * @brief Queues the events of a finished sequence.
+ *
+ * A burst while released (the last samples of a short tap) gives a down
+ * and an up event.
+ *
+ * @param u8_touched    Touch state of the controller
+ * @param u8_have_point 1 if the sequence read samples
+ * @return None
+ */
+static void touch_update(uint8_t u8_touched, uint8_t u8_have_point)
+{
+    if (u8_have_point) {
+        g_touch_last.type = g_u8_touch_pressed ? TOUCH_EVENT_MOVE : TOUCH_EVENT_DOWN;
+        (void)sync_queue_push(&g_touch_queue, &g_touch_last);
+        g_u8_touch_pressed = 1u;
+    }
+
+    if (!u8_touched && g_u8_touch_pressed) {
+        g_touch_last.type = TOUCH_EVENT_UP;
+        (void)sync_queue_push(&g_touch_queue, &g_touch_last);
+        g_u8_touch_pressed = 0u;
+    }
+}
+
+/**
+ * @brief Mean of the middle half of some values (median for up to three).
+ *
+ * @param pu16_values Values, sorted in place
+ * @param u8_count    1 .. TOUCH_MAX_SAMPLES
+ * @return Trimmed mean
+ */
+static uint16_t touch_trimmed_mean(uint16_t *pu16_values, uint8_t u8_count)
+{
+    uint8_t u8_low = (uint8_t)((u8_count + 1u) / 4u);
+    uint8_t u8_high = (uint8_t)(u8_count - u8_low);
+    uint32_t u32_sum = 0u;
+
+    /* Insertion sort, at most 16 values */
+    for (uint8_t i = 1u; i < u8_count; i++) {
+        uint16_t u16_value = pu16_values[i];
+        uint8_t j = i;
+
+        while ((j > 0u) && (pu16_values[j - 1u] > u16_value)) {
+            pu16_values[j] = pu16_values[j - 1u];
+            j--;
+        }
+        pu16_values[j] = u16_value;
+    }
+
+    for (uint8_t i = u8_low; i < u8_high; i++) {
+        u32_sum += pu16_values[i];
+    }
+
+    return (uint16_t)((u32_sum + (uint32_t)(u8_high - u8_low) / 2u) / (uint32_t)(u8_high - u8_low));
+}
+
+/**
+ * @brief Maps a raw reading linearly to a pixel, clamped to the screen.
+ *
+ * @param u16_raw     Reading
+ * @param i32_raw_0   Reading at pixel 0
+ * @param i32_raw_end Reading at pixel i32_size
+ * @param i32_size    Pixels of the axis
+ * @return Pixel 0 .. i32_size - 1
+ */
+static uint16_t touch_map(uint16_t u16_raw, int32_t i32_raw_0, int32_t i32_raw_end, int32_t i32_size)
+{
+    int32_t i32_pixel = (((int32_t)u16_raw - i32_raw_0) * i32_size) / (i32_raw_end - i32_raw_0);
+
+    if (i32_pixel < 0) {
+        i32_pixel = 0;
+    } else if (i32_pixel >= i32_size) {
+        i32_pixel = i32_size - 1;
+    }
+
+    return (uint16_t)i32_pixel;
+}
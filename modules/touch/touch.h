@@ -0,0 +1,147 @@
+/**
+ ******************************************************************************
+ * @file        touch.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the STMPE811 touchscreen driver.
+ *
+ * @details
+ * The resistive touch controller of the Discovery board sits on I2C3
+ * (PA8 SCL, PC9 SDA, address 0x41), its interrupt line on PA15. The
+ * controller samples on its own into its FIFO; the driver configures a
+ * FIFO threshold and the touch detect interrupt and reads only when the
+ * line fires:
+ *
+ *  1. EXTI15 edge: clear the interrupt status of the controller,
+ *  2. read the FIFO fill level,
+ *  3. burst read all queued samples (up to TOUCH_MAX_SAMPLES) by DMA,
+ *  4. read the touch state.
+ *
+ * Every step is started from the end of transfer interrupt of the one
+ * before, through the bus arbitration of env_sensor (which owns I2C3 and
+ * its HAL callbacks, env_sensor_i2c_submit()). An edge during the
+ * sequence restarts it at the end, so nothing is lost and nothing is
+ * polled. The samples of one burst are reduced to one point: per axis
+ * sorted, then the middle half averaged (median for up to three samples),
+ * which drops the spikes of a resistive panel at touch down and release.
+ * The point is mapped to screen pixels and queued as an event for the
+ * main loop (touch_get_event()).
+ *
+ * The I2C3 RX stream (DMA1 Stream 2) is shared with the stopwatch
+ * capture; without a free stream the bursts run by interrupt. PC9 is
+ * also SDIO D1 (sdcard), both cannot be used together.
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - STMPE811 reset and touchscreen setup (4 sample averaging, FIFO)
+ *  - Interrupt driven FIFO bursts, no polling
+ *  - Trimmed mean per burst, linear mapping to the 240x320 screen
+ *  - Down / move / up event queue
+ *
+ ******************************************************************************
+ */
+
+#ifndef TOUCH_TOUCH_H_
+#define TOUCH_TOUCH_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+#include <irq/irq.h>
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief 7 bit I2C address of the controller (ADDR0 low).
+ */
+#define TOUCH_I2C_ADDR          0x41U
+
+/**
+ * @brief Interrupt line of the controller (active low, open drain).
+ */
+#define TOUCH_INT_PORT          GPIOA
+#define TOUCH_INT_PIN           GPIO_PIN_15
+
+/**
+ * @brief Priority of the EXTI interrupt (EXTI15_10, shared with the
+ *        joystick and the LCD TE line).
+ */
+#define TOUCH_IRQ_PRIORITY      IRQ_CLASS_REFRESH
+
+/**
+ * @brief FIFO samples that raise an interrupt while touched, and the
+ *        most samples read per burst (4 bytes each).
+ */
+#define TOUCH_FIFO_THRESHOLD    4U
+#define TOUCH_MAX_SAMPLES       16U
+
+/**
+ * @brief Queued events, power of two.
+ */
+#define TOUCH_QUEUE_SIZE        8U
+
+/**
+ * @brief Screen size and raw readings at its edges (12 bit, the axes of
+ *        the panel run opposite to the LCD on the Discovery board).
+ */
+#define TOUCH_WIDTH             240
+#define TOUCH_HEIGHT            320
+#define TOUCH_RAW_X_LEFT        3870
+#define TOUCH_RAW_X_RIGHT       270
+#define TOUCH_RAW_Y_TOP         360
+#define TOUCH_RAW_Y_BOTTOM      3880
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Kind of a touch event.
+ */
+typedef enum {
+    TOUCH_EVENT_DOWN = 0,   /**< First point of a touch                      */
+    TOUCH_EVENT_MOVE,       /**< Further point while touched                 */
+    TOUCH_EVENT_UP          /**< Released, last point of the touch           */
+} touch_event_type_t;
+
+/**
+ * @brief One event.
+ */
+typedef struct {
+    touch_event_type_t type;
+    uint16_t           u16_x;       /**< Pixel, 0 .. TOUCH_WIDTH - 1        */
+    uint16_t           u16_y;       /**< Pixel, 0 .. TOUCH_HEIGHT - 1       */
+    uint8_t            u8_pressure; /**< Raw Z, larger = firmer             */
+    uint8_t            u8_samples;  /**< FIFO samples behind the point      */
+} touch_event_t;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Resets and configures the controller and enables its interrupt.
+ *
+ * Blocks for about 15 ms (reset and ADC start up), task context.
+ *
+ * @return HAL_OK, HAL_ERROR if the controller does not answer with its ID,
+ *         HAL_BUSY if the EXTI line is taken
+ */
+HAL_StatusTypeDef touch_init(void);
+
+/**
+ * @brief Takes the oldest event.
+ *
+ * @param event Destination
+ * @return 1 if an event was read, 0 if none is queued
+ */
+uint8_t touch_get_event(touch_event_t *event);
+
+/**
+ * @brief Returns whether the panel is touched (state of the last burst).
+ *
+ * @return 1 touched, 0 released
+ */
+uint8_t touch_is_pressed(void);
+
+/**
+ * @brief Returns the failed I2C sequences since touch_init().
+ *
+ * @return Errors
+ */
+uint32_t touch_get_errors(void);
+
+#endif /* TOUCH_TOUCH_H_ */
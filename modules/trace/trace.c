@@ -0,0 +1,178 @@
+/**
+ ******************************************************************************
+ * @file        trace.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       SWO / ITM trace channel
+ *
+ * Functionality:
+ * - TPIU in asynchronous NRZ mode, prescaler from HCLK, formatter off
+ * - ITM with local timestamps (no prescaler, core cycles) and periodic
+ *   synchronisation packets, trace bus ID 1
+ * - Value write: FIFO check and write with interrupts masked, so a
+ *   packet of an interrupt can not fill the FIFO between the two
+ *
+ * Resources:
+ * - PB3 (TRACESWO, AF0), DBGMCU, TPIU, ITM, DWT (sync packets)
+ ******************************************************************************
+ */
+
+#include "trace.h"
+
+/* Private Preprocessor Defines -------------------------------------------- */
+/**
+ * @brief ITM lock access key.
+ */
+#define TRACE_ITM_UNLOCK        0xC5ACCE55UL
+
+/**
+ * @brief TPIU pin protocol: asynchronous NRZ (UART like).
+ */
+#define TRACE_TPI_NRZ           2UL
+
+/**
+ * @brief Largest TPIU prescaler (13 bit).
+ */
+#define TRACE_TPI_MAX_PRESCALER 0x1FFFUL
+
+/* Static module variables -------------------------------------------------- */
+static volatile uint32_t g_u32_trace_dropped = 0u;
+
+/* Static function prototypes ---------------------------------------------- */
+static uint8_t trace_port_enabled(trace_channel_t ch);
+
+/* Public functions --------------------------------------------------------- */
+HAL_StatusTypeDef trace_init(uint32_t u32_baud)
+{
+    GPIO_InitTypeDef gpio_init_struct;
+    uint32_t u32_prescaler;
+
+    if ((u32_baud == 0u) || (u32_baud > HAL_RCC_GetHCLKFreq())) {
+        return HAL_ERROR;
+    }
+    u32_prescaler = (HAL_RCC_GetHCLKFreq() + u32_baud / 2u) / u32_baud - 1u;
+    if (u32_prescaler > TRACE_TPI_MAX_PRESCALER) {
+        return HAL_ERROR;
+    }
+
+    __HAL_RCC_GPIOB_CLK_ENABLE();
+    gpio_init_struct.Pin       = GPIO_PIN_3;
+    gpio_init_struct.Mode      = GPIO_MODE_AF_PP;
+    gpio_init_struct.Pull      = GPIO_NOPULL;
+    gpio_init_struct.Speed     = GPIO_SPEED_FREQ_VERY_HIGH;
+    gpio_init_struct.Alternate = GPIO_AF0_TRACE;
+    HAL_GPIO_Init(GPIOB, &gpio_init_struct);
+
+    /* Trace clock and pin, asynchronous mode */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DBGMCU->CR = (DBGMCU->CR & ~DBGMCU_CR_TRACE_MODE) | DBGMCU_CR_TRACE_IOEN;
+
+    TPI->SPPR = TRACE_TPI_NRZ;
+    TPI->ACPR = u32_prescaler;
+    TPI->FFCR = 0u;
+
+    /* Sync packets are timed by the cycle counter (CYCTAP / SYNCTAP) */
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk | (1UL << DWT_CTRL_SYNCTAP_Pos);
+
+    ITM->LAR = TRACE_ITM_UNLOCK;
+    ITM->TCR = 0u;
+    while (ITM->TCR & ITM_TCR_BUSY_Msk) {
+    }
+    ITM->TPR = 0u;
+    ITM->TCR = (1UL << ITM_TCR_TraceBusID_Pos) | ITM_TCR_SYNCENA_Msk |
+               ITM_TCR_TSENA_Msk | ITM_TCR_ITMENA_Msk;
+    ITM->TER = 0xFFFFFFFFUL;
+
+    g_u32_trace_dropped = 0u;
+
+    return HAL_OK;
+}
+
+void trace_u8(trace_channel_t ch, uint8_t value)
+{
+    uint32_t u32_primask;
+
+    if (!trace_port_enabled(ch)) {
+        return;
+    }
+
+    u32_primask = __get_PRIMASK();
+    __disable_irq();
+    if (ITM->PORT[ch].u32 != 0u) {
+        ITM->PORT[ch].u8 = value;
+    } else {
+        g_u32_trace_dropped++;
+    }
+    __set_PRIMASK(u32_primask);
+}
+
+void trace_u16(trace_channel_t ch, uint16_t value)
+{
+    uint32_t u32_primask;
+
+    if (!trace_port_enabled(ch)) {
+        return;
+    }
+
+    u32_primask = __get_PRIMASK();
+    __disable_irq();
+    if (ITM->PORT[ch].u32 != 0u) {
+        ITM->PORT[ch].u16 = value;
+    } else {
+        g_u32_trace_dropped++;
+    }
+    __set_PRIMASK(u32_primask);
+}
+
+void trace_u32(trace_channel_t ch, uint32_t value)
+{
+    uint32_t u32_primask;
+
+    if (!trace_port_enabled(ch)) {
+        return;
+    }
+
+    u32_primask = __get_PRIMASK();
+    __disable_irq();
+    if (ITM->PORT[ch].u32 != 0u) {
+        ITM->PORT[ch].u32 = value;
+    } else {
+        g_u32_trace_dropped++;
+    }
+    __set_PRIMASK(u32_primask);
+}
+
+int trace_putc(int ch)
+{
+    if (trace_port_enabled(TRACE_CH_TEXT)) {
+        while (ITM->PORT[TRACE_CH_TEXT].u32 == 0u) {
+        }
+        ITM->PORT[TRACE_CH_TEXT].u8 = (uint8_t)ch;
+    }
+
+    return ch;
+}
+
+uint32_t trace_get_dropped(void)
+{
+    return g_u32_trace_dropped;
+}
+
+/* Static module functions -------------------------------------------------- */
+/**
+ * @brief Checks that the ITM and a stimulus port are enabled.
+ *
+ * The debugger may disable ports (or the whole ITM) at any time.
+ *
+ * @param ch Stimulus port
+ * @return 1 if a write would be sent
+ */
+static uint8_t trace_port_enabled(trace_channel_t ch)
+{
+    if ((uint32_t)ch >= TRACE_CH_COUNT) {
+        return 0u;
+    }
+
+    return ((ITM->TCR & ITM_TCR_ITMENA_Msk) && (ITM->TER & (1UL << ch))) ? 1u : 0u;
+}
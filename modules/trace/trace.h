@@ -0,0 +1,130 @@
+/**
+ ******************************************************************************
+ * @file        trace.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the SWO / ITM trace channel.
+ *
+ * @details
+ * Streams runtime values as binary ITM packets over the SWO pin (PB3) to
+ * the ST-LINK of the discovery board. A packet costs one write into an
+ * ITM stimulus port (a few cycles) instead of formatting text and drawing
+ * it, so tracing hardly changes the timing it observes. The ITM adds a
+ * local timestamp (core cycles since the previous packet) to each packet,
+ * no software timestamp is needed.
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - One stimulus port per value (trace_channel_t), port number and
+ *    payload size are part of the ITM packet header
+ *  - Non-blocking value packets: if the ITM FIFO is full the value is
+ *    dropped and counted, the caller is never delayed
+ *  - Blocking text channel on port 0 (trace_putc(), e.g. for
+ *    profile_dump())
+ *  - Preinstrumented: fan PI controller, potis_dma averages, lcd band
+ *    frames, health monitor; compiled out unless TRACE_ENABLE is 1
+ *
+ * Packet payloads:
+ *  - TRACE_CH_FAN_RPM:    u32, target rpm [31:16], measured rpm [15:0]
+ *  - TRACE_CH_FAN_OUTPUT: u16, PWM compare value
+ *  - TRACE_CH_POTIS:      u32, POTI_2 [31:16], POTI_1 [15:0] (12 bit)
+ *  - TRACE_CH_LCD_FRAME:  u32, lcd_band_render() time in microseconds
+ *                         (compose until the last band is queued)
+ *  - TRACE_CH_CPU_LOAD:   u16, CPU load of the health window in 0.1 %
+ *  - TRACE_CH_STACK:      u32, main stack high water mark in bytes
+ *
+ * The SWO baud rate is derived from HCLK; after a clock profile change
+ * trace_init() has to be called again. modules/trace/trace_decode.py
+ * decodes a raw SWO capture into CSV and plots it.
+ *
+ ******************************************************************************
+ */
+
+#ifndef TRACE_TRACE_H_
+#define TRACE_TRACE_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief 1 to compile the trace points in, 0 removes them.
+ */
+#ifndef TRACE_ENABLE
+#define TRACE_ENABLE        0
+#endif
+
+/**
+ * @brief Default SWO baud rate (ST-LINK V2: up to 2 MBd).
+ */
+#define TRACE_SWO_BAUD      2000000UL
+
+#if TRACE_ENABLE
+#define TRACE_U8(ch, value)     trace_u8((ch), (uint8_t)(value))
+#define TRACE_U16(ch, value)    trace_u16((ch), (uint16_t)(value))
+#define TRACE_U32(ch, value)    trace_u32((ch), (uint32_t)(value))
+#else
+#define TRACE_U8(ch, value)     do { } while (0)
+#define TRACE_U16(ch, value)    do { } while (0)
+#define TRACE_U32(ch, value)    do { } while (0)
+#endif
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Stimulus ports.
+ */
+typedef enum {
+    TRACE_CH_TEXT       = 0,    /**< Text, trace_putc()            */
+    TRACE_CH_FAN_RPM    = 1,    /**< Fan target and measured rpm   */
+    TRACE_CH_FAN_OUTPUT = 2,    /**< Fan PWM compare value         */
+    TRACE_CH_POTIS      = 3,    /**< Averaged potentiometer values */
+    TRACE_CH_LCD_FRAME  = 4,    /**< Band renderer frame time      */
+    TRACE_CH_CPU_LOAD   = 5,    /**< health_update() CPU load      */
+    TRACE_CH_STACK      = 6,    /**< health_update() stack mark    */
+    TRACE_CH_USER       = 8,    /**< First port for the application */
+    TRACE_CH_COUNT      = 32
+} trace_channel_t;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Configures PB3 as TRACESWO, the TPIU (NRZ) and the ITM with
+ *        local timestamps and enables all stimulus ports.
+ *
+ * @param u32_baud SWO baud rate, e.g. TRACE_SWO_BAUD
+ * @return HAL_OK, HAL_ERROR if HCLK cannot be divided down to the rate
+ */
+HAL_StatusTypeDef trace_init(uint32_t u32_baud);
+
+/**
+ * @brief Sends an 8 / 16 / 32 bit value if the ITM FIFO has room.
+ *
+ * Interrupt safe, can be called from any context.
+ *
+ * @param ch    Stimulus port
+ * @param value Payload
+ * @return None
+ */
+void trace_u8(trace_channel_t ch, uint8_t value);
+void trace_u16(trace_channel_t ch, uint16_t value);
+void trace_u32(trace_channel_t ch, uint32_t value);
+
+/**
+ * @brief Sends one character on TRACE_CH_TEXT, waits for the FIFO.
+ *
+ * Same signature as __io_putchar(). Returns at once if the ITM or the
+ * port is disabled.
+ *
+ * @param ch Character
+ * @return ch
+ */
+int trace_putc(int ch);
+
+/**
+ * @brief Returns the number of value packets dropped (FIFO full).
+ *
+ * @return Dropped packets since trace_init()
+ */
+uint32_t trace_get_dropped(void);
+
+#endif /* TRACE_TRACE_H_ */
@@ -0,0 +1,161 @@
+#!/usr/bin/env python3
+"""Decoder for the SWO / ITM trace stream of modules/trace.
+
+Reads a raw SWO capture (e.g. the file written by the SWV viewer of the
+ST-LINK tools, ``openocd ... -c "tpiu config internal swo.bin uart off
+180000000 2000000"`` or orbuculum), decodes the ITM packets and writes one
+CSV line per value: time in microseconds, channel name, payload fields.
+
+Only the standard library is needed; ``--plot`` uses matplotlib.
+
+Usage:
+    trace_decode.py capture.bin [--clock 180000000] [--csv out.csv] [--plot]
+"""
+
+import argparse
+import csv
+import sys
+
+# Stimulus ports and payload decoding, see trace.h
+CHANNELS = {
+    0: ("text", None),
+    1: ("fan_rpm", lambda v: {"target": v >> 16, "rpm": v & 0xFFFF}),
+    2: ("fan_output", lambda v: {"compare": v}),
+    3: ("potis", lambda v: {"poti_1": v & 0xFFFF, "poti_2": v >> 16}),
+    4: ("lcd_frame", lambda v: {"us": v}),
+    5: ("cpu_load", lambda v: {"permille": v}),
+    6: ("stack", lambda v: {"bytes": v}),
+}
+
+
+def read_continuation(data, pos, max_bytes):
+    """Reads up to max_bytes bytes of 7 bit groups (bit 7 = more)."""
+    value = 0
+    shift = 0
+    for _ in range(max_bytes):
+        if pos >= len(data):
+            return None, pos
+        byte = data[pos]
+        pos += 1
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            break
+    return value, pos
+
+
+def decode(data):
+    """Yields (cycles, port, value) for every software stimulus packet.
+
+    The local timestamp packet that follows a group of packets carries the
+    cycles since the previous timestamp; it is applied to that group.
+    """
+    cycles = 0
+    pending = []
+    pos = 0
+
+    while pos < len(data):
+        header = data[pos]
+        pos += 1
+
+        if header == 0x00:
+            # Synchronisation: zeros up to 0x80
+            while pos < len(data) and data[pos] == 0x00:
+                pos += 1
+            pos += 1
+            continue
+
+        if header == 0x70:
+            # ITM FIFO overflow, packets were lost on the target
+            print("warning: ITM overflow", file=sys.stderr)
+            continue
+
+        if (header & 0x0F) == 0x00:
+            # Local timestamp, short form 0b0TTT0000 or long form 0b11TT0000
+            if header & 0x80:
+                delta, pos = read_continuation(data, pos, 4)
+                if delta is None:
+                    break
+            else:
+                delta = (header >> 4) & 0x07
+            cycles += delta
+            for port, value in pending:
+                yield cycles, port, value
+            pending = []
+            continue
+
+        if header in (0x94, 0xB4):
+            # Global timestamps are not enabled, skip
+            _, pos = read_continuation(data, pos, 7)
+            continue
+
+        if (header & 0x0F) == 0x08:
+            # Extension packet
+            if header & 0x80:
+                _, pos = read_continuation(data, pos, 4)
+            continue
+
+        size = {1: 1, 2: 2, 3: 4}.get(header & 0x03)
+        if size is None or pos + size > len(data):
+            continue
+        payload = int.from_bytes(data[pos:pos + size], "little")
+        pos += size
+
+        if header & 0x04:
+            # Hardware source (DWT), not used by the firmware
+            continue
+
+        pending.append((header >> 3, payload))
+
+    for port, value in pending:
+        yield cycles, port, value
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("capture", help="raw SWO capture")
+    parser.add_argument("--clock", type=int, default=180000000,
+                        help="core clock in Hz (timestamp unit)")
+    parser.add_argument("--csv", help="output file, default stdout")
+    parser.add_argument("--plot", action="store_true", help="plot the values")
+    args = parser.parse_args()
+
+    with open(args.capture, "rb") as capture:
+        data = capture.read()
+
+    out = open(args.csv, "w", newline="") if args.csv else sys.stdout
+    writer = csv.writer(out)
+    writer.writerow(["time_us", "channel", "field", "value"])
+
+    series = {}
+    text = []
+    for cycles, port, value in decode(data):
+        time_us = cycles * 1e6 / args.clock
+        name, fields = CHANNELS.get(port, ("port_%d" % port, lambda v: {"value": v}))
+
+        if fields is None:
+            text.append(chr(value & 0xFF))
+            continue
+
+        for field, field_value in fields(value).items():
+            writer.writerow(["%.1f" % time_us, name, field, field_value])
+            series.setdefault("%s.%s" % (name, field), []).append((time_us, field_value))
+
+    if out is not sys.stdout:
+        out.close()
+    if text:
+        sys.stderr.write("".join(text))
+
+    if args.plot and series:
+        import matplotlib.pyplot as plt
+
+        fig, axes = plt.subplots(len(series), 1, sharex=True, squeeze=False)
+        for axis, (label, points) in zip(axes[:, 0], sorted(series.items())):
+            axis.step([p[0] / 1000.0 for p in points], [p[1] for p in points], where="post")
+            axis.set_ylabel(label)
+        axes[-1, 0].set_xlabel("time [ms]")
+        plt.show()
+
+
+if __name__ == "__main__":
+    main()
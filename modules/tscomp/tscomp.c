@@ -0,0 +1,284 @@
+/**
+ ******************************************************************************
+ * @file        tscomp.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Time series block compression: delta of delta time stamps,
+ *              delta values, zigzag varints.
+ *
+ * Functionality:
+ * - Per channel slot with the last time, time step and value
+ * - Encoder refuses a record before the block could overflow, the caller
+ *   finishes the block and starts the next one
+ * - Decoder checks every varint against the used bytes of the block
+ *
+ * Resources:
+ * - None, the block memory and the state belong to the caller
+ ******************************************************************************
+ */
+
+#include "tscomp.h"
+#include <string.h>
+
+/* Preprocessor Defines ----------------------------------------------------- */
+/**
+ * @brief Size of the header in the block.
+ */
+#define TSCOMP_HEADER_LEN       8U
+
+/**
+ * @brief Bytes of a 32 bit varint at most.
+ */
+#define TSCOMP_VARINT_MAX       5U
+
+/* Static function prototypes ----------------------------------------------- */
+static tscomp_slot_t *tscomp_slot(tscomp_t *codec, uint8_t u8_channel);
+static void tscomp_put_varint(tscomp_t *enc, uint32_t u32_value);
+static HAL_StatusTypeDef tscomp_get_varint(tscomp_t *dec, uint32_t *pu32_value);
+static uint32_t tscomp_zigzag(int32_t i32_value);
+static int32_t tscomp_unzigzag(uint32_t u32_value);
+static void tscomp_put_u16(uint8_t *pu8_dst, uint16_t u16_value);
+static uint16_t tscomp_get_u16(const uint8_t *pu8_src);
+
+/* Public functions --------------------------------------------------------- */
+HAL_StatusTypeDef tscomp_encoder_init(tscomp_t *enc, void *block, uint16_t u16_size)
+{
+    if ((block == NULL) || (u16_size < TSCOMP_HEADER_LEN + TSCOMP_RECORD_MAX)) {
+        return HAL_ERROR;
+    }
+
+    memset(enc, 0, sizeof(*enc));
+    enc->pu8_block = (uint8_t *)block;
+    enc->u16_size  = u16_size;
+    enc->u16_pos   = TSCOMP_HEADER_LEN;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef tscomp_encode(tscomp_t *enc, uint32_t u32_time, uint16_t u16_channel, int32_t i32_value)
+{
+    tscomp_slot_t *slot;
+    uint32_t u32_delta;
+    uint8_t u8_head;
+
+    if (u16_channel > TSCOMP_MAX_CHANNEL) {
+        return HAL_ERROR;
+    }
+    if ((uint32_t)enc->u16_size - enc->u16_pos < TSCOMP_RECORD_MAX) {
+        return HAL_BUSY;
+    }
+    slot = tscomp_slot(enc, (uint8_t)u16_channel);
+    if (slot == NULL) {
+        return HAL_BUSY;
+    }
+
+    u8_head   = (uint8_t)u16_channel;
+    u32_delta = u32_time - slot->u32_time;
+    if ((enc->u16_records > 0u) && (u32_time == enc->u32_time)) {
+        u8_head |= TSCOMP_FLAG_SAME_TIME;
+    }
+
+    enc->pu8_block[enc->u16_pos++] = u8_head;
+    if ((u8_head & TSCOMP_FLAG_SAME_TIME) == 0u) {
+        tscomp_put_varint(enc, tscomp_zigzag((int32_t)(u32_delta - slot->u32_delta)));
+    }
+    tscomp_put_varint(enc, tscomp_zigzag((int32_t)((uint32_t)i32_value - (uint32_t)slot->i32_value)));
+
+    slot->u32_delta = u32_delta;
+    slot->u32_time  = u32_time;
+    slot->i32_value = i32_value;
+    enc->u32_time   = u32_time;
+    enc->u16_records++;
+
+    return HAL_OK;
+}
+
+uint16_t tscomp_encoder_finish(tscomp_t *enc)
+{
+    tscomp_put_u16(&enc->pu8_block[0], TSCOMP_MAGIC);
+    tscomp_put_u16(&enc->pu8_block[2], enc->u16_records);
+    tscomp_put_u16(&enc->pu8_block[4], enc->u16_pos);
+    tscomp_put_u16(&enc->pu8_block[6], 0u);
+    memset(&enc->pu8_block[enc->u16_pos], 0, (size_t)(enc->u16_size - enc->u16_pos));
+
+    return enc->u16_pos;
+}
+
+HAL_StatusTypeDef tscomp_decoder_init(tscomp_t *dec, const void *block, uint16_t u16_size)
+{
+    const uint8_t *pu8_block = (const uint8_t *)block;
+    uint16_t u16_bytes;
+
+    if ((block == NULL) || (u16_size < TSCOMP_HEADER_LEN) || (tscomp_get_u16(pu8_block) != TSCOMP_MAGIC)) {
+        return HAL_ERROR;
+    }
+    u16_bytes = tscomp_get_u16(&pu8_block[4]);
+    if ((u16_bytes < TSCOMP_HEADER_LEN) || (u16_bytes > u16_size)) {
+        return HAL_ERROR;
+    }
+
+    memset(dec, 0, sizeof(*dec));
+    /* The decoder only reads, the cast keeps one state type for both */
+    dec->pu8_block   = (uint8_t *)(uintptr_t)pu8_block;
+    dec->u16_size    = u16_bytes;
+    dec->u16_pos     = TSCOMP_HEADER_LEN;
+    dec->u16_records = tscomp_get_u16(&pu8_block[2]);
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef tscomp_decode(tscomp_t *dec, uint32_t *pu32_time, uint16_t *pu16_channel, int32_t *pi32_value)
+{
+    tscomp_slot_t *slot;
+    uint32_t u32_time;
+    uint32_t u32_value;
+    uint8_t u8_head;
+
+    if (dec->u16_records == 0u) {
+        return HAL_BUSY;
+    }
+    if (dec->u16_pos >= dec->u16_size) {
+        return HAL_ERROR;
+    }
+
+    u8_head = dec->pu8_block[dec->u16_pos++];
+    slot = tscomp_slot(dec, u8_head & TSCOMP_MAX_CHANNEL);
+    if (slot == NULL) {
+        return HAL_ERROR;
+    }
+
+    if ((u8_head & TSCOMP_FLAG_SAME_TIME) != 0u) {
+        u32_time = dec->u32_time;
+    } else {
+        if (tscomp_get_varint(dec, &u32_time) != HAL_OK) {
+            return HAL_ERROR;
+        }
+        u32_time = slot->u32_time + slot->u32_delta + (uint32_t)tscomp_unzigzag(u32_time);
+    }
+    if (tscomp_get_varint(dec, &u32_value) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    slot->u32_delta = u32_time - slot->u32_time;
+    slot->u32_time  = u32_time;
+    slot->i32_value = (int32_t)((uint32_t)slot->i32_value + (uint32_t)tscomp_unzigzag(u32_value));
+    dec->u32_time   = u32_time;
+    dec->u16_records--;
+
+    *pu32_time    = u32_time;
+    *pu16_channel = slot->u8_channel;
+    *pi32_value   = slot->i32_value;
+
+    return HAL_OK;
+}
+
+/* Static functions --------------------------------------------------------- */
+/**
+ * @brief Slot of a channel, a new one starts at the time of the last
+ *        record of the block with step 0 and value 0.
+ *
+ * @param codec      Encoder or decoder
+ * @param u8_channel Channel
+ * @return Slot, NULL if all slots are taken by other channels
+ */
+static tscomp_slot_t *tscomp_slot(tscomp_t *codec, uint8_t u8_channel)
+{
+    tscomp_slot_t *slot;
+
+    for (uint8_t i = 0u; i < codec->u8_slots; i++) {
+        if (codec->slots[i].u8_channel == u8_channel) {
+            return &codec->slots[i];
+        }
+    }
+    if (codec->u8_slots >= TSCOMP_SLOTS) {
+        return NULL;
+    }
+
+    slot = &codec->slots[codec->u8_slots++];
+    slot->u8_channel = u8_channel;
+    slot->u32_time   = codec->u32_time;
+    slot->u32_delta  = 0u;
+    slot->i32_value  = 0;
+
+    return slot;
+}
+
+/**
+ * @brief Writes 7 bits per byte, low bits first, bit 7 set while more
+ *        follow (the caller has checked the space).
+ *
+ * @param enc       Encoder
+ * @param u32_value Value
+ * @return None
+ */
+static void tscomp_put_varint(tscomp_t *enc, uint32_t u32_value)
+{
+    while (u32_value >= 0x80u) {
+        enc->pu8_block[enc->u16_pos++] = (uint8_t)(u32_value | 0x80u);
+        u32_value >>= 7;
+    }
+    enc->pu8_block[enc->u16_pos++] = (uint8_t)u32_value;
+}
+
+/**
+ * @brief Reads a varint within the used bytes of the block.
+ *
+ * @param dec        Decoder
+ * @param pu32_value Value
+ * @return HAL_OK, HAL_ERROR if it runs past the block or 5 bytes
+ */
+static HAL_StatusTypeDef tscomp_get_varint(tscomp_t *dec, uint32_t *pu32_value)
+{
+    uint32_t u32_value = 0u;
+
+    for (uint32_t i = 0u; i < TSCOMP_VARINT_MAX; i++) {
+        uint8_t u8_byte;
+
+        if (dec->u16_pos >= dec->u16_size) {
+            return HAL_ERROR;
+        }
+        u8_byte = dec->pu8_block[dec->u16_pos++];
+        u32_value |= (uint32_t)(u8_byte & 0x7Fu) << (7u * i);
+        if ((u8_byte & 0x80u) == 0u) {
+            *pu32_value = u32_value;
+            return HAL_OK;
+        }
+    }
+
+    return HAL_ERROR;
+}
+
+/**
+ * @brief Maps 0, -1, 1, -2 .. to 0, 1, 2, 3 .., small magnitudes give
+ *        short varints.
+ *
+ * @param i32_value Signed value
+ * @return Unsigned code
+ */
+static uint32_t tscomp_zigzag(int32_t i32_value)
+{
+    return ((uint32_t)i32_value << 1) ^ (uint32_t)(i32_value >> 31);
+}
+
+/**
+ * @brief Inverse of tscomp_zigzag().
+ *
+ * @param u32_value Unsigned code
+ * @return Signed value
+ */
+static int32_t tscomp_unzigzag(uint32_t u32_value)
+{
+    return (int32_t)((u32_value >> 1) ^ (0u - (u32_value & 1u)));
+}
+
+static void tscomp_put_u16(uint8_t *pu8_dst, uint16_t u16_value)
+{
+    pu8_dst[0] = (uint8_t)u16_value;
+    pu8_dst[1] = (uint8_t)(u16_value >> 8);
+}
+
+static uint16_t tscomp_get_u16(const uint8_t *pu8_src)
+{
+    return (uint16_t)(pu8_src[0] | ((uint16_t)pu8_src[1] << 8));
+}
@@ -0,0 +1,154 @@
+/**
+ ******************************************************************************
+ * @file        tscomp.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the time series block compression.
+ *
+ * @details
+ * Packs (time, channel, value) records of the loggers into fixed size
+ * blocks, e.g. one SD sector. Every block starts from scratch, so any
+ * block decodes on its own (random access by block number); within a
+ * block each channel keeps its own state:
+ *
+ *  - time:  delta of delta to the previous record of the channel,
+ *           zigzag varint: 1 byte for a steady rate, none at all if the
+ *           record has the time of the record before (flag bit),
+ *  - value: delta to the previous value of the channel, zigzag varint:
+ *           1 byte while the value changes by less than +-64.
+ *
+ * The values are integers (0.01 C, Pa, rpm, ADC counts), for them the
+ * delta is what the XOR of the floating point schemes is for floats.
+ * A record of a slowly varying channel takes 2 to 3 bytes instead of
+ * 12, at some ten cycles for the encoding.
+ *
+ * Block: tscomp_header_t, then the records: one byte channel (bit 7:
+ * same time), time varint unless flagged, value varint. The bytes after
+ * u16_bytes are zero. modules/tscomp/tscomp.py decodes on the PC.
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - Streaming encoder into a caller's block, never larger than it
+ *  - Decoder of one block, record by record
+ *  - Channels 0..TSCOMP_MAX_CHANNEL, TSCOMP_SLOTS different per block
+ *
+ ******************************************************************************
+ */
+
+#ifndef TSCOMP_TSCOMP_H_
+#define TSCOMP_TSCOMP_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief First half word of a block ("TZ").
+ */
+#define TSCOMP_MAGIC            0x5A54U
+
+/**
+ * @brief Different channels in one block, highest channel number.
+ */
+#define TSCOMP_SLOTS            16U
+#define TSCOMP_MAX_CHANNEL      0x7FU
+
+/**
+ * @brief Bytes of one record at most (channel, two 5 byte varints).
+ */
+#define TSCOMP_RECORD_MAX       11U
+
+/**
+ * @brief Channel byte flag: the record has the time of the one before.
+ */
+#define TSCOMP_FLAG_SAME_TIME   0x80U
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Start of every block (little endian).
+ */
+typedef struct {
+    uint16_t u16_magic;             /**< TSCOMP_MAGIC                        */
+    uint16_t u16_records;           /**< Records in the block                */
+    uint16_t u16_bytes;             /**< Used bytes including the header     */
+    uint16_t u16_reserved;          /**< 0                                   */
+} tscomp_header_t;
+
+/**
+ * @brief State of one channel within a block.
+ */
+typedef struct {
+    uint32_t u32_time;              /**< Time of the last record             */
+    uint32_t u32_delta;             /**< Time step before it                 */
+    int32_t  i32_value;             /**< Last value                          */
+    uint8_t  u8_channel;
+} tscomp_slot_t;
+
+/**
+ * @brief Encoder or decoder of one block.
+ */
+typedef struct {
+    uint8_t      *pu8_block;        /**< Block (const for the decoder)       */
+    uint16_t      u16_size;         /**< Block size in bytes                 */
+    uint16_t      u16_pos;          /**< Next byte                           */
+    uint16_t      u16_records;      /**< Records encoded / still to decode   */
+    uint8_t       u8_slots;         /**< Channels seen in the block          */
+    uint32_t      u32_time;         /**< Time of the last record             */
+    tscomp_slot_t slots[TSCOMP_SLOTS];
+} tscomp_t;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Starts a new block.
+ *
+ * @param enc      Encoder
+ * @param block    Memory of the block
+ * @param u16_size Block size, at least the header and one record
+ * @return HAL_OK, HAL_ERROR if the block is too small
+ */
+HAL_StatusTypeDef tscomp_encoder_init(tscomp_t *enc, void *block, uint16_t u16_size);
+
+/**
+ * @brief Appends a record.
+ *
+ * @param enc         Encoder
+ * @param u32_time    Time stamp (wraps around freely)
+ * @param u16_channel Channel 0..TSCOMP_MAX_CHANNEL
+ * @param i32_value   Value
+ * @return HAL_OK, HAL_BUSY if the block is full (finish it and add the
+ *         record to the next one), HAL_ERROR for an invalid channel
+ */
+HAL_StatusTypeDef tscomp_encode(tscomp_t *enc, uint32_t u32_time, uint16_t u16_channel, int32_t i32_value);
+
+/**
+ * @brief Writes the header and clears the unused rest of the block.
+ *
+ * @param enc Encoder
+ * @return Used bytes
+ */
+uint16_t tscomp_encoder_finish(tscomp_t *enc);
+
+/**
+ * @brief Starts decoding a block.
+ *
+ * @param dec      Decoder
+ * @param block    Block
+ * @param u16_size Block size
+ * @return HAL_OK, HAL_ERROR without a valid header
+ */
+HAL_StatusTypeDef tscomp_decoder_init(tscomp_t *dec, const void *block, uint16_t u16_size);
+
+/**
+ * @brief Returns the next record of the block.
+ *
+ * @param dec          Decoder
+ * @param pu32_time    Time stamp
+ * @param pu16_channel Channel
+ * @param pi32_value   Value
+ * @return HAL_OK, HAL_BUSY after the last record, HAL_ERROR for a
+ *         damaged block
+ */
+HAL_StatusTypeDef tscomp_decode(tscomp_t *dec, uint32_t *pu32_time, uint16_t *pu16_channel, int32_t *pi32_value);
+
+#endif /* TSCOMP_TSCOMP_H_ */
@@ -0,0 +1,139 @@
+#!/usr/bin/env python3
+"""Decoder of the time series blocks of modules/tscomp.
+
+decode_block() turns one block (e.g. the payload of a compressed sdlog
+sector) into (time, channel, value) tuples, encode_block() builds blocks
+the way the firmware does, for tests and for converting old logs.
+
+Only the standard library is needed.
+
+Usage:
+    tscomp.py block.bin [--offset N] [--size 504]
+"""
+
+import argparse
+import struct
+import sys
+
+MAGIC = 0x5A54
+HEADER = struct.Struct("<HHHH")     # magic, records, bytes, reserved
+SAME_TIME = 0x80
+MAX_CHANNEL = 0x7F
+SLOTS = 16
+RECORD_MAX = 11
+MASK = 0xFFFFFFFF
+
+
+def zigzag(value):
+    return ((value << 1) ^ (value >> 31)) & MASK
+
+
+def unzigzag(code):
+    return (code >> 1) ^ -(code & 1)
+
+
+def signed(value):
+    value &= MASK
+    return value - (1 << 32) if value & 0x80000000 else value
+
+
+def varint(data, pos, end):
+    """Returns (value, next position) of a varint below end."""
+    value = 0
+    for i in range(5):
+        if pos >= end:
+            raise ValueError("varint past the end of the block")
+        byte = data[pos]
+        pos += 1
+        value |= (byte & 0x7F) << (7 * i)
+        if not byte & 0x80:
+            return value, pos
+    raise ValueError("varint longer than 5 bytes")
+
+
+def decode_block(data, offset=0, size=None):
+    """Yields (time, channel, value) of a block, ValueError if damaged."""
+    size = len(data) - offset if size is None else size
+    magic, count, used, _ = HEADER.unpack_from(data, offset)
+    if magic != MAGIC or used < HEADER.size or used > size:
+        raise ValueError("no tscomp block")
+    end = offset + used
+    pos = offset + HEADER.size
+    slots = {}
+    last_time = 0
+    for _ in range(count):
+        if pos >= end:
+            raise ValueError("block ends before its records")
+        head = data[pos]
+        pos += 1
+        channel = head & MAX_CHANNEL
+        if channel not in slots:
+            if len(slots) >= SLOTS:
+                raise ValueError("more than %d channels in a block" % SLOTS)
+            slots[channel] = [last_time, 0, 0]
+        slot = slots[channel]
+        if head & SAME_TIME:
+            time = last_time
+        else:
+            code, pos = varint(data, pos, end)
+            time = (slot[0] + slot[1] + unzigzag(code)) & MASK
+        code, pos = varint(data, pos, end)
+        slot[1] = (time - slot[0]) & MASK
+        slot[0] = time
+        slot[2] = signed(slot[2] + unzigzag(code))
+        last_time = time
+        yield time, channel, slot[2]
+
+
+def encode_block(records, size):
+    """Packs (time, channel, value) records like tscomp_encode().
+
+    Returns (block of size bytes, number of records taken).
+    """
+    out = bytearray(HEADER.size)
+    slots = {}
+    last_time = 0
+    taken = 0
+    for time, channel, value in records:
+        if channel > MAX_CHANNEL:
+            raise ValueError("channel %d above %d" % (channel, MAX_CHANNEL))
+        if size - len(out) < RECORD_MAX or (channel not in slots and len(slots) >= SLOTS):
+            break
+        slot = slots.setdefault(channel, [last_time, 0, 0])
+        delta = (time - slot[0]) & MASK
+        head = channel
+        if taken and time == last_time:
+            head |= SAME_TIME
+        out.append(head)
+        codes = [] if head & SAME_TIME else [zigzag(signed(delta - slot[1]))]
+        codes.append(zigzag(signed(value - slot[2])))
+        for code in codes:
+            while code >= 0x80:
+                out.append((code & 0x7F) | 0x80)
+                code >>= 7
+            out.append(code)
+        slot[:] = [time & MASK, delta, value]
+        last_time = time & MASK
+        taken += 1
+    HEADER.pack_into(out, 0, MAGIC, taken, len(out), 0)
+    return bytes(out) + bytes(size - len(out)), taken
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("source", help="file with the block")
+    parser.add_argument("--offset", type=int, default=0, help="byte offset of the block")
+    parser.add_argument("--size", type=int, help="block size, default: rest of the file")
+    args = parser.parse_args()
+
+    with open(args.source, "rb") as stream:
+        data = stream.read()
+    try:
+        for time, channel, value in decode_block(data, args.offset, args.size):
+            print("%d,%d,%d" % (time, channel, value))
+    except ValueError as error:
+        sys.exit("%s: %s" % (args.source, error))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,262 @@
+/**
+ ******************************************************************************
+ * @file        telemetry_batch.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Batched binary telemetry frames (TLV, CRC-32, COBS)
+ *
+ * Functionality:
+ * - Serialises the records into a word aligned buffer, the CRC unit
+ *   reads it word by word (one write per 4 bytes)
+ * - COBS stuffing is done while the frame is copied into the pool block
+ *   (uart_telemetry_send_cobs()), no second buffer
+ *
+ * Resources:
+ * - CRC unit
+ ******************************************************************************
+ */
+
+#include "telemetry_batch.h"
+#include "uart_telemetry.h"
+#include "telemetry_sync.h"
+#include "pool/pool.h"
+#include "deadline/deadline.h"
+#include "timebase/timebase.h"
+#include <string.h>
+
+/* Private Preprocessor Defines -------------------------------------------- */
+/**
+ * @brief Largest frame before stuffing: header records, sample records,
+ *        CRC and the pad bytes of the last CRC word.
+ */
+#define TELEMETRY_BATCH_HEADER_RECORDS  (4U + 6U + 6U + 10U + 4U)
+#define TELEMETRY_BATCH_MAX_FRAME       (TELEMETRY_BATCH_HEADER_RECORDS + \
+                                         2U + TELEMETRY_BATCH_SAMPLES * 2U + \
+                                         2U + TELEMETRY_BATCH_SAMPLES * 4U + \
+                                         2U + TELEMETRY_BATCH_ENV_SAMPLES * 12U + 4U + 3U)
+
+#if TELEMETRY_BATCH_MAX_FRAME < (6U + 2U + TELEMETRY_BATCH_TEXT_MAX + 4U + 3U)
+#error "Frame buffer too small for a text frame"
+#endif
+
+#if (TELEMETRY_BATCH_MAX_FRAME + TELEMETRY_BATCH_MAX_FRAME / 254U + 2U) > POOL_LARGE_SIZE
+#error "A stuffed frame must fit into a large pool block"
+#endif
+
+/* Static module variables -------------------------------------------------- */
+static CRC_HandleTypeDef g_telemetry_batch_crc;
+
+/**
+ * @brief Encoded frame, word aligned for the CRC unit.
+ */
+static uint32_t g_u32_telemetry_batch_frame[(TELEMETRY_BATCH_MAX_FRAME + 3U) / 4U];
+
+/* Static function prototypes ---------------------------------------------- */
+static uint16_t telemetry_batch_record(uint8_t *pu8_frame, uint16_t u16_pos, uint8_t u8_type,
+                                       const void *value, uint8_t u8_length);
+static HAL_StatusTypeDef telemetry_batch_finish(uint8_t *pu8_frame, uint16_t u16_pos);
+static HAL_StatusTypeDef telemetry_batch_send_single(uint8_t u8_type, const void *data, uint16_t u16_length);
+
+/* Public functions --------------------------------------------------------- */
+void telemetry_batch_init(telemetry_batch_t *batch, uint32_t u32_period_us)
+{
+    memset(batch, 0, sizeof(*batch));
+    batch->u32_period_us = u32_period_us;
+
+    __HAL_RCC_CRC_CLK_ENABLE();
+    g_telemetry_batch_crc.Instance = CRC;
+    HAL_CRC_Init(&g_telemetry_batch_crc);
+}
+
+HAL_StatusTypeDef telemetry_batch_add_sample(telemetry_batch_t *batch, uint16_t u16_rpm,
+                                             uint16_t u16_poti_1, uint16_t u16_poti_2)
+{
+    if (batch->u8_count >= TELEMETRY_BATCH_SAMPLES) {
+        return HAL_BUSY;
+    }
+    if (batch->u8_count == 0u) {
+        batch->u32_tick  = HAL_GetTick();
+        batch->u64_stamp = timebase_now();
+    }
+
+    batch->u16_rpm[batch->u8_count]      = u16_rpm;
+    batch->u16_potis[batch->u8_count][0] = u16_poti_1;
+    batch->u16_potis[batch->u8_count][1] = u16_poti_2;
+    batch->u8_count++;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef telemetry_batch_add_env(telemetry_batch_t *batch, int32_t i32_temp,
+                                          uint32_t u32_press, uint32_t u32_hum)
+{
+    if (batch->u8_env_count >= TELEMETRY_BATCH_ENV_SAMPLES) {
+        return HAL_BUSY;
+    }
+    if ((batch->u8_count == 0u) && (batch->u8_env_count == 0u)) {
+        batch->u32_tick  = HAL_GetTick();
+        batch->u64_stamp = timebase_now();
+    }
+
+    batch->i32_temp[batch->u8_env_count]  = i32_temp;
+    batch->u32_press[batch->u8_env_count] = u32_press;
+    batch->u32_hum[batch->u8_env_count]   = u32_hum;
+    batch->u8_env_count++;
+
+    return HAL_OK;
+}
+
+void telemetry_batch_set_target(telemetry_batch_t *batch, uint16_t u16_target_rpm)
+{
+    batch->u16_target_rpm = u16_target_rpm;
+}
+
+uint8_t telemetry_batch_is_full(const telemetry_batch_t *batch)
+{
+    return (batch->u8_count >= TELEMETRY_BATCH_SAMPLES) ? 1u : 0u;
+}
+
+HAL_StatusTypeDef telemetry_batch_send(telemetry_batch_t *batch)
+{
+    uint8_t *pu8_frame = (uint8_t *)g_u32_telemetry_batch_frame;
+    uint16_t u16_pos = 0u;
+    HAL_StatusTypeDef status;
+
+    u16_pos = telemetry_batch_record(pu8_frame, u16_pos, TELEMETRY_BATCH_TLV_SEQ, &batch->u16_seq, 2u);
+    u16_pos = telemetry_batch_record(pu8_frame, u16_pos, TELEMETRY_BATCH_TLV_TICK, &batch->u32_tick, 4u);
+    u16_pos = telemetry_batch_record(pu8_frame, u16_pos, TELEMETRY_BATCH_TLV_PERIOD,
+                                     &batch->u32_period_us, 4u);
+    if (telemetry_sync_is_locked()) {
+        uint64_t u64_host_us = telemetry_sync_to_host(batch->u64_stamp);
+
+        u16_pos = telemetry_batch_record(pu8_frame, u16_pos, TELEMETRY_BATCH_TLV_HOST_US, &u64_host_us, 8u);
+    }
+    u16_pos = telemetry_batch_record(pu8_frame, u16_pos, TELEMETRY_BATCH_TLV_FAN_TARGET,
+                                     &batch->u16_target_rpm, 2u);
+
+    if (batch->u8_count != 0u) {
+        u16_pos = telemetry_batch_record(pu8_frame, u16_pos, TELEMETRY_BATCH_TLV_FAN_RPM,
+                                         batch->u16_rpm, (uint8_t)(batch->u8_count * 2u));
+        u16_pos = telemetry_batch_record(pu8_frame, u16_pos, TELEMETRY_BATCH_TLV_POTIS,
+                                         batch->u16_potis, (uint8_t)(batch->u8_count * 4u));
+    }
+
+    if (batch->u8_env_count != 0u) {
+        /* Interleaved per sample: temperature, pressure, humidity */
+        pu8_frame[u16_pos++] = TELEMETRY_BATCH_TLV_ENV;
+        pu8_frame[u16_pos++] = (uint8_t)(batch->u8_env_count * 12u);
+        for (uint8_t i = 0u; i < batch->u8_env_count; i++) {
+            memcpy(&pu8_frame[u16_pos], &batch->i32_temp[i], 4u);
+            memcpy(&pu8_frame[u16_pos + 4u], &batch->u32_press[i], 4u);
+            memcpy(&pu8_frame[u16_pos + 8u], &batch->u32_hum[i], 4u);
+            u16_pos += 12u;
+        }
+    }
+
+    status = telemetry_batch_finish(pu8_frame, u16_pos);
+
+    batch->u16_seq++;
+    batch->u8_count     = 0u;
+    batch->u8_env_count = 0u;
+
+    return status;
+}
+
+HAL_StatusTypeDef telemetry_batch_send_text(const char *pch_text, uint16_t u16_length)
+{
+    return telemetry_batch_send_single(TELEMETRY_BATCH_TLV_TEXT, pch_text, u16_length);
+}
+
+HAL_StatusTypeDef telemetry_batch_send_dlog(const void *data, uint16_t u16_length)
+{
+    return telemetry_batch_send_single(TELEMETRY_BATCH_TLV_DLOG, data, u16_length);
+}
+
+HAL_StatusTypeDef telemetry_batch_send_deadline(void)
+{
+    uint32_t u32_values[1u + DEADLINE_MAX_TASKS * 5u];
+    uint32_t u32_count = 0u;
+    deadline_stats_t stats;
+
+    u32_values[u32_count++] = deadline_get_failed_windows();
+    for (uint8_t i = 0u; deadline_get_stats(i, &stats) == HAL_OK; i++) {
+        u32_values[u32_count++] = stats.u32_runs;
+        u32_values[u32_count++] = stats.u32_misses;
+        u32_values[u32_count++] = stats.u32_overruns;
+        u32_values[u32_count++] = stats.u32_response_us;
+        u32_values[u32_count++] = stats.u32_exec_us;
+    }
+
+    return telemetry_batch_send_single(TELEMETRY_BATCH_TLV_DEADLINE, u32_values, (uint16_t)(u32_count * 4u));
+}
+
+HAL_StatusTypeDef telemetry_batch_send_sync(uint16_t u16_seq)
+{
+    return telemetry_batch_send_single(TELEMETRY_BATCH_TLV_SYNC, &u16_seq, 2u);
+}
+
+/* Static module functions -------------------------------------------------- */
+/**
+ * @brief Queues a frame of the tick and one record.
+ *
+ * @param u8_type    Record type
+ * @param data       Value
+ * @param u16_length Length, at most TELEMETRY_BATCH_TEXT_MAX
+ * @return HAL_OK, HAL_BUSY if dropped, HAL_ERROR if too long
+ */
+static HAL_StatusTypeDef telemetry_batch_send_single(uint8_t u8_type, const void *data, uint16_t u16_length)
+{
+    uint8_t *pu8_frame = (uint8_t *)g_u32_telemetry_batch_frame;
+    uint32_t u32_tick = HAL_GetTick();
+    uint16_t u16_pos = 0u;
+
+    if (u16_length > TELEMETRY_BATCH_TEXT_MAX) {
+        return HAL_ERROR;
+    }
+
+    u16_pos = telemetry_batch_record(pu8_frame, u16_pos, TELEMETRY_BATCH_TLV_TICK, &u32_tick, 4u);
+    u16_pos = telemetry_batch_record(pu8_frame, u16_pos, u8_type, data, (uint8_t)u16_length);
+
+    return telemetry_batch_finish(pu8_frame, u16_pos);
+}
+
+/**
+ * @brief Appends one record.
+ *
+ * @param pu8_frame Frame buffer
+ * @param u16_pos   Write position
+ * @param u8_type   Record type
+ * @param value     Value bytes (little endian in memory)
+ * @param u8_length Value length
+ * @return New write position
+ */
+static uint16_t telemetry_batch_record(uint8_t *pu8_frame, uint16_t u16_pos, uint8_t u8_type,
+                                       const void *value, uint8_t u8_length)
+{
+    pu8_frame[u16_pos]      = u8_type;
+    pu8_frame[u16_pos + 1u] = u8_length;
+    memcpy(&pu8_frame[u16_pos + 2u], value, u8_length);
+
+    return (uint16_t)(u16_pos + 2u + u8_length);
+}
+
+/**
+ * @brief Appends the CRC and queues the frame COBS stuffed.
+ *
+ * @param pu8_frame Frame buffer (g_u32_telemetry_batch_frame)
+ * @param u16_pos   Length of the records
+ * @return Status of uart_telemetry_send_cobs()
+ */
+static HAL_StatusTypeDef telemetry_batch_finish(uint8_t *pu8_frame, uint16_t u16_pos)
+{
+    uint32_t u32_crc;
+
+    /* CRC over whole words, the pad bytes are not sent */
+    memset(&pu8_frame[u16_pos], 0, 3u);
+    u32_crc = HAL_CRC_Calculate(&g_telemetry_batch_crc, g_u32_telemetry_batch_frame, (u16_pos + 3u) / 4u);
+    memcpy(&pu8_frame[u16_pos], &u32_crc, 4u);
+    u16_pos += 4u;
+
+    return uart_telemetry_send_cobs(pu8_frame, u16_pos);
+}
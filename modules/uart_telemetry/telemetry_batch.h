@@ -0,0 +1,226 @@
+/**
+ ******************************************************************************
+ * @file        telemetry_batch.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Batched binary telemetry frames (TLV, CRC-32, COBS).
+ *
+ * @details
+ * Collects many samples in RAM and sends them as one frame over the
+ * uart_telemetry channel. Per sample only the raw values are stored, a
+ * fan RPM costs 2 bytes on the wire instead of a text line; the time of
+ * each sample follows from the batch start and the sample period.
+ *
+ * Frame, before stuffing:
+ *   TLV records (type u8, length u8, value), CRC-32 (u32, little endian)
+ * The CRC is computed by the CRC unit (polynomial 0x04C11DB7, initial
+ * value 0xFFFFFFFF, no reflection) over the records read as little
+ * endian 32 bit words, the last word padded with zero bytes. The frame is
+ * COBS stuffed, a zero byte ends it; a receiver resynchronises on the
+ * next zero after a lost byte.
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - Header records: sequence number (lost frames), HAL tick of the first
+ *    sample, sample period in us, fan target RPM; with a locked
+ *    telemetry_sync the host time of the first sample
+ *  - Sample records, one per channel: the values of all samples in a row
+ *  - The CRC unit is used only here, telemetry_batch_send() is called from
+ *    one context
+ *
+ * Records:
+ *  - TELEMETRY_BATCH_TLV_SEQ:        u16
+ *  - TELEMETRY_BATCH_TLV_TICK:       u32 ms
+ *  - TELEMETRY_BATCH_TLV_PERIOD:     u32 us
+ *  - TELEMETRY_BATCH_TLV_HOST_US:    u64 host clock in us of the first
+ *                                    sample (only while telemetry_sync
+ *                                    is locked)
+ *  - TELEMETRY_BATCH_TLV_FAN_TARGET: u16 rpm
+ *  - TELEMETRY_BATCH_TLV_FAN_RPM:    u16 rpm per sample
+ *  - TELEMETRY_BATCH_TLV_POTIS:      u16 POTI_1, u16 POTI_2 per sample
+ *  - TELEMETRY_BATCH_TLV_ENV:        i32 0.01 C, u32 Pa, u32 0.001 % per
+ *                                    sample (own rate, no sample times)
+ *  - TELEMETRY_BATCH_TLV_TEXT:       ASCII, e.g. a shell reply; frames of
+ *                                    telemetry_batch_send_text() carry
+ *                                    only the tick and the text
+ *  - TELEMETRY_BATCH_TLV_DLOG:       whole modules/dlog records, frames of
+ *                                    telemetry_batch_send_dlog() (a
+ *                                    dlog_sink_t) carry the tick and them
+ *  - TELEMETRY_BATCH_TLV_DEADLINE:   u32 failed windows, then per step
+ *                                    u32 runs, misses, overruns, worst
+ *                                    response us, worst execution us;
+ *                                    frames of telemetry_batch_send_deadline()
+ *  - TELEMETRY_BATCH_TLV_SYNC:       u16 ping number of telemetry_sync,
+ *                                    frames of telemetry_batch_send_sync()
+ *                                    (only the tick besides)
+ *
+ * The frames and the single frames of uart_telemetry_send() cannot be
+ * told apart on one port, an application uses one of the two.
+ * uart_telemetry_decode.py --batch decodes the frames.
+ *
+ ******************************************************************************
+ */
+
+#ifndef UART_TELEMETRY_TELEMETRY_BATCH_H_
+#define UART_TELEMETRY_TELEMETRY_BATCH_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief Fast samples per frame, at most 63 (one record holds 255 bytes).
+ */
+#define TELEMETRY_BATCH_SAMPLES         50U
+
+/**
+ * @brief Environment samples per frame.
+ */
+#define TELEMETRY_BATCH_ENV_SAMPLES     4U
+
+/**
+ * @brief Record types.
+ */
+#define TELEMETRY_BATCH_TLV_SEQ         0x01U
+#define TELEMETRY_BATCH_TLV_TICK        0x02U
+#define TELEMETRY_BATCH_TLV_PERIOD      0x03U
+#define TELEMETRY_BATCH_TLV_HOST_US     0x04U
+#define TELEMETRY_BATCH_TLV_FAN_TARGET  0x10U
+#define TELEMETRY_BATCH_TLV_FAN_RPM     0x11U
+#define TELEMETRY_BATCH_TLV_POTIS       0x20U
+#define TELEMETRY_BATCH_TLV_ENV         0x30U
+#define TELEMETRY_BATCH_TLV_TEXT        0x40U
+#define TELEMETRY_BATCH_TLV_DLOG        0x41U
+#define TELEMETRY_BATCH_TLV_DEADLINE    0x50U
+#define TELEMETRY_BATCH_TLV_SYNC        0x60U
+
+/**
+ * @brief Longest text of telemetry_batch_send_text() (one record).
+ */
+#define TELEMETRY_BATCH_TEXT_MAX        255U
+
+#if (TELEMETRY_BATCH_SAMPLES * 4U > 255U) || (TELEMETRY_BATCH_ENV_SAMPLES * 12U > 255U)
+#error "TELEMETRY_BATCH_SAMPLES / TELEMETRY_BATCH_ENV_SAMPLES exceed one record"
+#endif
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Samples of one frame.
+ */
+typedef struct {
+    uint64_t u64_stamp;                              /**< timebase_now() of the first sample */
+    uint32_t u32_period_us;                          /**< Time between two fast samples   */
+    uint32_t u32_tick;                               /**< HAL tick of the first sample    */
+    uint16_t u16_seq;                                /**< Number of the next frame        */
+    uint16_t u16_target_rpm;                         /**< Fan target of the frame         */
+    uint8_t  u8_count;                               /**< Fast samples collected          */
+    uint8_t  u8_env_count;                           /**< Environment samples collected   */
+    uint16_t u16_rpm[TELEMETRY_BATCH_SAMPLES];
+    uint16_t u16_potis[TELEMETRY_BATCH_SAMPLES][2];
+    int32_t  i32_temp[TELEMETRY_BATCH_ENV_SAMPLES];
+    uint32_t u32_press[TELEMETRY_BATCH_ENV_SAMPLES];
+    uint32_t u32_hum[TELEMETRY_BATCH_ENV_SAMPLES];
+} telemetry_batch_t;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Clears a batch and enables the CRC unit.
+ *
+ * @param batch         Batch
+ * @param u32_period_us Period of telemetry_batch_add_sample() calls
+ * @return None
+ */
+void telemetry_batch_init(telemetry_batch_t *batch, uint32_t u32_period_us);
+
+/**
+ * @brief Adds one fast sample.
+ *
+ * @param batch      Batch
+ * @param u16_rpm    Fan RPM (e.g. fan_get_filtered_rpm())
+ * @param u16_poti_1 POTI_1 value
+ * @param u16_poti_2 POTI_2 value
+ * @return HAL_OK, HAL_BUSY if the batch is full (send it first)
+ */
+HAL_StatusTypeDef telemetry_batch_add_sample(telemetry_batch_t *batch, uint16_t u16_rpm,
+                                             uint16_t u16_poti_1, uint16_t u16_poti_2);
+
+/**
+ * @brief Adds one environment sample (fixed point, see env_sensor).
+ *
+ * @return HAL_OK, HAL_BUSY if the environment samples of the batch are full
+ */
+HAL_StatusTypeDef telemetry_batch_add_env(telemetry_batch_t *batch, int32_t i32_temp,
+                                          uint32_t u32_press, uint32_t u32_hum);
+
+/**
+ * @brief Sets the fan target sent with the frame.
+ *
+ * @param batch          Batch
+ * @param u16_target_rpm Target RPM
+ * @return None
+ */
+void telemetry_batch_set_target(telemetry_batch_t *batch, uint16_t u16_target_rpm);
+
+/**
+ * @brief Returns 1 once the fast samples of the batch are full.
+ *
+ * @param batch Batch
+ * @return 1 full, 0 room left
+ */
+uint8_t telemetry_batch_is_full(const telemetry_batch_t *batch);
+
+/**
+ * @brief Encodes the batch into one frame, queues it on the uart_telemetry
+ *        channel and starts the next batch.
+ *
+ * The samples are cleared in both cases, a dropped frame shows up as a
+ * gap in the sequence numbers.
+ *
+ * @param batch Batch
+ * @return HAL_OK, HAL_BUSY if the TX queue or pool had no room (frame dropped)
+ */
+HAL_StatusTypeDef telemetry_batch_send(telemetry_batch_t *batch);
+
+/**
+ * @brief Queues a text frame: tick and one text record. Same context as
+ *        telemetry_batch_send() (CRC unit).
+ *
+ * @param pch_text   Text, no terminator needed
+ * @param u16_length Length, at most TELEMETRY_BATCH_TEXT_MAX
+ * @return HAL_OK, HAL_BUSY if the TX queue or pool had no room (frame
+ *         dropped), HAL_ERROR if the text is too long
+ */
+HAL_StatusTypeDef telemetry_batch_send_text(const char *pch_text, uint16_t u16_length);
+
+/**
+ * @brief Queues a frame of dlog records (tick and one record), the sink
+ *        of dlog_drain(). Same context as telemetry_batch_send().
+ *
+ * @param data       Records
+ * @param u16_length Bytes, at most TELEMETRY_BATCH_TEXT_MAX
+ * @return HAL_OK, HAL_BUSY if the TX queue or pool had no room (the
+ *         records stay in the dlog ring), HAL_ERROR if too long
+ */
+HAL_StatusTypeDef telemetry_batch_send_dlog(const void *data, uint16_t u16_length);
+
+/**
+ * @brief Queues a frame of the deadline supervisor statistics (tick and
+ *        one record of all steps). Same context as telemetry_batch_send().
+ *
+ * @return HAL_OK, HAL_BUSY if the TX queue or pool had no room (frame
+ *         dropped)
+ */
+HAL_StatusTypeDef telemetry_batch_send_deadline(void);
+
+/**
+ * @brief Queues a time sync ping (tick and the ping number). Same
+ *        context as telemetry_batch_send().
+ *
+ * @param u16_seq Ping number, echoed by the host
+ * @return HAL_OK, HAL_BUSY if the TX queue or pool had no room (frame
+ *         dropped)
+ */
+HAL_StatusTypeDef telemetry_batch_send_sync(uint16_t u16_seq);
+
+#endif /* UART_TELEMETRY_TELEMETRY_BATCH_H_ */
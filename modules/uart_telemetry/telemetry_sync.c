@@ -0,0 +1,420 @@
+/**
+ ******************************************************************************
+ * @file        telemetry_sync.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Host clock synchronisation over the telemetry link.
+ *
+ * Functionality:
+ * - One ping outstanding: queued (waiting for the transfer complete stamp
+ *   of its frame), sent (t1 known, waiting for the reply), idle
+ * - Per window the sample with the shortest round trip, its midpoint on
+ *   the board clock and its offset; the model is offset + drift from the
+ *   midpoint of the last estimate on
+ * - RTC: read SSR, TR, DR in this order (locks the shadow registers),
+ *   calendar written in init mode, fractions by RTC_SHIFTR
+ *
+ * Resources:
+ * - uart_telemetry (marked TX frame, RX stamp), telemetry_batch (ping
+ *   frame), timebase, RTC if running (RCC_BDCR_RTCEN)
+ ******************************************************************************
+ */
+
+#include "telemetry_sync.h"
+#include "telemetry_batch.h"
+#include "uart_telemetry.h"
+#include "timebase/timebase.h"
+
+/* Preprocessor Defines ----------------------------------------------------- */
+/**
+ * @brief Ping states.
+ */
+#define TELEMETRY_SYNC_IDLE         0u
+#define TELEMETRY_SYNC_QUEUED       1u
+#define TELEMETRY_SYNC_SENT         2u
+
+/**
+ * @brief Days from 1970-01-01 to 2000-01-01 (start of the RTC years).
+ */
+#define TELEMETRY_SYNC_DAYS_2000    10957
+
+#define TELEMETRY_SYNC_US_PER_DAY   86400000000LL
+
+/* Static module variables -------------------------------------------------- */
+/**
+ * @brief Outstanding ping.
+ */
+static uint8_t  g_u8_telemetry_sync_state = TELEMETRY_SYNC_IDLE;
+static uint16_t g_u16_telemetry_sync_seq = 0u;
+static uint32_t g_u32_telemetry_sync_tick = 0u;     /**< HAL tick of the ping */
+static uint64_t g_u64_telemetry_sync_t1 = 0u;
+
+/**
+ * @brief Best sample of the current window.
+ */
+static uint8_t  g_u8_telemetry_sync_count = 0u;
+static uint32_t g_u32_telemetry_sync_best_delay = UINT32_MAX;
+static uint64_t g_u64_telemetry_sync_best_mid = 0u;
+static int64_t  g_i64_telemetry_sync_best_offset = 0;
+
+/**
+ * @brief Model: host = board + offset + drift * (board - ref).
+ */
+static uint8_t  g_u8_telemetry_sync_have_ref = 0u;
+static uint64_t g_u64_telemetry_sync_ref = 0u;
+static int64_t  g_i64_telemetry_sync_offset = 0;
+static int32_t  g_i32_telemetry_sync_drift = 0;
+static uint8_t  g_u8_telemetry_sync_have_drift = 0u;
+
+static telemetry_sync_stats_t g_telemetry_sync_stats;
+
+/* Static function prototypes ----------------------------------------------- */
+static void telemetry_sync_estimate(uint64_t u64_mid, int64_t i64_offset, uint32_t u32_delay);
+#if TELEMETRY_SYNC_RTC_ENABLE
+static void telemetry_sync_rtc(void);
+static int32_t telemetry_sync_days(int32_t i32_year, uint32_t u32_month, uint32_t u32_day);
+static void telemetry_sync_rtc_set(uint64_t u64_host_us);
+static uint32_t telemetry_sync_bcd(uint32_t u32_value);
+static uint32_t telemetry_sync_bin(uint32_t u32_bcd);
+#endif
+
+/* Public functions --------------------------------------------------------- */
+void telemetry_sync_init(void)
+{
+    g_u8_telemetry_sync_state        = TELEMETRY_SYNC_IDLE;
+    g_u32_telemetry_sync_tick        = HAL_GetTick() - TELEMETRY_SYNC_PERIOD_MS;
+    g_u8_telemetry_sync_count        = 0u;
+    g_u32_telemetry_sync_best_delay  = UINT32_MAX;
+    g_u8_telemetry_sync_have_ref     = 0u;
+    g_u8_telemetry_sync_have_drift   = 0u;
+    g_i64_telemetry_sync_offset      = 0;
+    g_i32_telemetry_sync_drift       = 0;
+    g_telemetry_sync_stats           = (telemetry_sync_stats_t){0};
+}
+
+void telemetry_sync_poll(void)
+{
+    uint32_t u32_now = HAL_GetTick();
+    uint32_t u32_stamp;
+
+    if (g_u8_telemetry_sync_state == TELEMETRY_SYNC_QUEUED) {
+        if (uart_telemetry_get_tx_stamp(&u32_stamp)) {
+            g_u64_telemetry_sync_t1 = timebase_extend(u32_stamp);
+            g_u8_telemetry_sync_state = TELEMETRY_SYNC_SENT;
+        }
+    }
+    if ((g_u8_telemetry_sync_state != TELEMETRY_SYNC_IDLE)
+            && ((u32_now - g_u32_telemetry_sync_tick) > TELEMETRY_SYNC_TIMEOUT_MS)) {
+        g_u8_telemetry_sync_state = TELEMETRY_SYNC_IDLE;
+        g_telemetry_sync_stats.u32_rejected++;
+    }
+
+    if (g_telemetry_sync_stats.u8_locked
+            && ((timebase_now() - g_u64_telemetry_sync_ref) > (uint64_t)TELEMETRY_SYNC_HOLDOVER_MS * 1000u)) {
+        g_telemetry_sync_stats.u8_locked = 0u;
+    }
+
+    if ((g_u8_telemetry_sync_state != TELEMETRY_SYNC_IDLE)
+            || ((u32_now - g_u32_telemetry_sync_tick) < TELEMETRY_SYNC_PERIOD_MS)) {
+        return;
+    }
+
+    /* A stamp of a ping that timed out in the queue must not count for this one */
+    (void)uart_telemetry_get_tx_stamp(&u32_stamp);
+
+    g_u16_telemetry_sync_seq++;
+    g_u32_telemetry_sync_tick = u32_now;
+    uart_telemetry_mark_next(1u);
+    if (telemetry_batch_send_sync(g_u16_telemetry_sync_seq) != HAL_OK) {
+        uart_telemetry_mark_next(0u);
+        return;
+    }
+    g_u8_telemetry_sync_state = TELEMETRY_SYNC_QUEUED;
+    g_telemetry_sync_stats.u32_pings++;
+}
+
+HAL_StatusTypeDef telemetry_sync_reply(uint16_t u16_seq, uint64_t u64_host_us, uint32_t u32_hold_us)
+{
+    uint64_t u64_t4 = timebase_extend(uart_telemetry_get_rx_stamp());
+    uint64_t u64_round;
+    uint64_t u64_delay;
+    int64_t  i64_offset;
+
+    if ((g_u8_telemetry_sync_state != TELEMETRY_SYNC_SENT) || (u16_seq != g_u16_telemetry_sync_seq)) {
+        g_telemetry_sync_stats.u32_rejected++;
+        return HAL_ERROR;
+    }
+    g_u8_telemetry_sync_state = TELEMETRY_SYNC_IDLE;
+
+    u64_round = u64_t4 - g_u64_telemetry_sync_t1;
+    if ((u64_t4 < g_u64_telemetry_sync_t1) || (u64_round < u32_hold_us)) {
+        g_telemetry_sync_stats.u32_rejected++;
+        return HAL_ERROR;
+    }
+    u64_delay = u64_round - u32_hold_us;
+    if (u64_delay > TELEMETRY_SYNC_MAX_DELAY_US) {
+        g_telemetry_sync_stats.u32_rejected++;
+        return HAL_BUSY;
+    }
+
+    /* ((t2 - t1) + (t3 - t4)) / 2 with t3 = t2 + hold */
+    i64_offset = (int64_t)(u64_host_us - g_u64_telemetry_sync_t1)
+               - (int64_t)(u64_round - u32_hold_us) / 2;
+    g_telemetry_sync_stats.u32_replies++;
+
+    if ((uint32_t)u64_delay < g_u32_telemetry_sync_best_delay) {
+        g_u32_telemetry_sync_best_delay  = (uint32_t)u64_delay;
+        g_u64_telemetry_sync_best_mid    = g_u64_telemetry_sync_t1 + u64_round / 2u;
+        g_i64_telemetry_sync_best_offset = i64_offset;
+    }
+    if (++g_u8_telemetry_sync_count >= TELEMETRY_SYNC_WINDOW) {
+        telemetry_sync_estimate(g_u64_telemetry_sync_best_mid, g_i64_telemetry_sync_best_offset,
+                                g_u32_telemetry_sync_best_delay);
+        g_u8_telemetry_sync_count       = 0u;
+        g_u32_telemetry_sync_best_delay = UINT32_MAX;
+    }
+
+    return HAL_OK;
+}
+
+uint64_t telemetry_sync_to_host(uint64_t u64_board_us)
+{
+    int64_t i64_since = (int64_t)(u64_board_us - g_u64_telemetry_sync_ref);
+
+    return u64_board_us + (uint64_t)(g_i64_telemetry_sync_offset
+                                     + i64_since * g_i32_telemetry_sync_drift / 1000000000LL);
+}
+
+uint8_t telemetry_sync_is_locked(void)
+{
+    return g_telemetry_sync_stats.u8_locked;
+}
+
+void telemetry_sync_get_stats(telemetry_sync_stats_t *stats)
+{
+    *stats = g_telemetry_sync_stats;
+}
+
+/* Static functions --------------------------------------------------------- */
+/**
+ * @brief Updates the model with the best sample of a window.
+ *
+ * The offset is taken over, the drift follows the offset change since
+ * the last estimate (the first one directly, then 1:4).
+ *
+ * @param u64_mid    Board time of the sample, middle of the round trip
+ * @param i64_offset Host minus board at u64_mid
+ * @param u32_delay  Round trip of the sample
+ * @return None
+ */
+static void telemetry_sync_estimate(uint64_t u64_mid, int64_t i64_offset, uint32_t u32_delay)
+{
+    g_telemetry_sync_stats.u32_estimates++;
+    g_telemetry_sync_stats.u32_delay_us = u32_delay;
+
+    if (g_u8_telemetry_sync_have_ref && (u64_mid > g_u64_telemetry_sync_ref)) {
+        int64_t i64_since = (int64_t)(u64_mid - g_u64_telemetry_sync_ref);
+        int64_t i64_predicted = g_i64_telemetry_sync_offset
+                              + i64_since * g_i32_telemetry_sync_drift / 1000000000LL;
+        int64_t i64_error = i64_offset - i64_predicted;
+
+        if ((i64_error > TELEMETRY_SYNC_STEP_US) || (i64_error < -TELEMETRY_SYNC_STEP_US)) {
+            /* Host clock set: start over from this sample */
+            g_telemetry_sync_stats.u32_steps++;
+            g_telemetry_sync_stats.u8_locked = 0u;
+            g_u8_telemetry_sync_have_drift   = 0u;
+            g_i32_telemetry_sync_drift       = 0;
+        } else {
+            int32_t i32_drift = (int32_t)((i64_offset - g_i64_telemetry_sync_offset) * 1000000000LL / i64_since);
+
+            if (g_u8_telemetry_sync_have_drift) {
+                g_i32_telemetry_sync_drift += (i32_drift - g_i32_telemetry_sync_drift) / 4;
+            } else {
+                g_i32_telemetry_sync_drift = i32_drift;
+                g_u8_telemetry_sync_have_drift = 1u;
+            }
+            g_telemetry_sync_stats.u8_locked = 1u;
+        }
+    }
+
+    g_u8_telemetry_sync_have_ref  = 1u;
+    g_u64_telemetry_sync_ref      = u64_mid;
+    g_i64_telemetry_sync_offset   = i64_offset;
+
+    g_telemetry_sync_stats.i64_offset_us = i64_offset;
+    g_telemetry_sync_stats.i32_drift_ppb = g_i32_telemetry_sync_drift;
+
+#if TELEMETRY_SYNC_RTC_ENABLE
+    if (g_telemetry_sync_stats.u8_locked) {
+        telemetry_sync_rtc();
+    }
+#endif
+}
+
+#if TELEMETRY_SYNC_RTC_ENABLE
+/**
+ * @brief Compares the RTC with the host clock and corrects it.
+ *
+ * @return None
+ */
+static void telemetry_sync_rtc(void)
+{
+    uint32_t u32_ssr;
+    uint32_t u32_tr;
+    uint32_t u32_dr;
+    uint32_t u32_prediv_s;
+    uint64_t u64_now;
+    int64_t  i64_rtc_us;
+    int64_t  i64_error;
+    int32_t  i32_ticks;
+
+    if ((RCC->BDCR & RCC_BDCR_RTCEN) == 0u) {
+        return;
+    }
+
+    u32_prediv_s = RTC->PRER & RTC_PRER_PREDIV_S;
+    u64_now      = timebase_now();
+    u32_ssr      = RTC->SSR;
+    u32_tr       = RTC->TR;
+    u32_dr       = RTC->DR;
+
+    i64_rtc_us = (int64_t)telemetry_sync_days(2000 + (int32_t)telemetry_sync_bin((u32_dr >> 16) & 0xFFu),
+                                              telemetry_sync_bin((u32_dr >> 8) & 0x1Fu),
+                                              telemetry_sync_bin(u32_dr & 0x3Fu)) * TELEMETRY_SYNC_US_PER_DAY
+               + (int64_t)(telemetry_sync_bin((u32_tr >> 16) & 0x3Fu) * 3600u
+                           + telemetry_sync_bin((u32_tr >> 8) & 0x7Fu) * 60u
+                           + telemetry_sync_bin(u32_tr & 0x7Fu)) * 1000000LL
+               /* SSR counts down, above PREDIV_S after a shift back */
+               + ((int64_t)u32_prediv_s - (int64_t)u32_ssr) * 1000000LL / (int64_t)(u32_prediv_s + 1u);
+
+    i64_error = (int64_t)telemetry_sync_to_host(u64_now) - i64_rtc_us;
+    g_telemetry_sync_stats.i32_rtc_error_us = (i64_error > INT32_MAX) ? INT32_MAX
+                                            : (i64_error < INT32_MIN) ? INT32_MIN : (int32_t)i64_error;
+
+    __HAL_RCC_PWR_CLK_ENABLE();
+    HAL_PWR_EnableBkUpAccess();
+
+    if (((RTC->ISR & RTC_ISR_INITS) == 0u) || (i64_error >= 1000000) || (i64_error <= -1000000)) {
+        telemetry_sync_rtc_set(telemetry_sync_to_host(timebase_now()));
+        return;
+    }
+    if ((i64_error < TELEMETRY_SYNC_RTC_TOLERANCE_US) && (i64_error > -TELEMETRY_SYNC_RTC_TOLERANCE_US)) {
+        return;
+    }
+    if (RTC->ISR & RTC_ISR_SHPF) {
+        return;
+    }
+
+    i32_ticks = (int32_t)((i64_error * (int64_t)(u32_prediv_s + 1u) + ((i64_error >= 0) ? 500000 : -500000))
+                          / 1000000);
+    if (i32_ticks == 0) {
+        return;
+    }
+
+    RTC->WPR = 0xCAu;
+    RTC->WPR = 0x53u;
+    if (i32_ticks > 0) {
+        /* Behind: one second ahead, the rest of it back */
+        RTC->SHIFTR = RTC_SHIFTR_ADD1S | ((u32_prediv_s + 1u) - (uint32_t)i32_ticks);
+    } else {
+        RTC->SHIFTR = (uint32_t)(-i32_ticks);
+    }
+    RTC->WPR = 0xFFu;
+    g_telemetry_sync_stats.u32_rtc_shifts++;
+}
+
+/**
+ * @brief Sets the calendar to a host time (to the second, the fraction
+ *        follows with the next shift).
+ *
+ * @param u64_host_us Microseconds since 1970-01-01 UTC
+ * @return None
+ */
+static void telemetry_sync_rtc_set(uint64_t u64_host_us)
+{
+    int32_t  i32_days = (int32_t)(u64_host_us / (uint64_t)TELEMETRY_SYNC_US_PER_DAY);
+    uint32_t u32_secs = (uint32_t)((u64_host_us / 1000000u) % 86400u);
+    int32_t  i32_z = i32_days + 719468;
+    int32_t  i32_era = i32_z / 146097;
+    uint32_t u32_doe = (uint32_t)(i32_z - i32_era * 146097);
+    uint32_t u32_yoe = (u32_doe - u32_doe / 1460u + u32_doe / 36524u - u32_doe / 146096u) / 365u;
+    uint32_t u32_doy = u32_doe - (365u * u32_yoe + u32_yoe / 4u - u32_yoe / 100u);
+    uint32_t u32_mp = (5u * u32_doy + 2u) / 153u;
+    uint32_t u32_day = u32_doy - (153u * u32_mp + 2u) / 5u + 1u;
+    uint32_t u32_month = (u32_mp < 10u) ? (u32_mp + 3u) : (u32_mp - 9u);
+    int32_t  i32_year = (int32_t)u32_yoe + i32_era * 400 + ((u32_month <= 2u) ? 1 : 0);
+    /* 1970-01-01 was a Thursday, RTC weekdays 1 (Monday) .. 7 */
+    uint32_t u32_weekday = (uint32_t)((i32_days + 3) % 7) + 1u;
+    uint32_t u32_start;
+
+    if ((i32_days < TELEMETRY_SYNC_DAYS_2000) || (i32_year > 2099)) {
+        return;
+    }
+
+    RTC->WPR = 0xCAu;
+    RTC->WPR = 0x53u;
+    RTC->ISR |= RTC_ISR_INIT;
+    u32_start = HAL_GetTick();
+    while ((RTC->ISR & RTC_ISR_INITF) == 0u) {
+        if ((HAL_GetTick() - u32_start) > 10u) {
+            RTC->ISR &= ~RTC_ISR_INIT;
+            RTC->WPR = 0xFFu;
+            return;
+        }
+    }
+
+    RTC->TR = (telemetry_sync_bcd(u32_secs / 3600u) << 16)
+            | (telemetry_sync_bcd((u32_secs / 60u) % 60u) << 8)
+            | telemetry_sync_bcd(u32_secs % 60u);
+    RTC->DR = (telemetry_sync_bcd((uint32_t)(i32_year - 2000)) << 16)
+            | (u32_weekday << 13)
+            | (telemetry_sync_bcd(u32_month) << 8)
+            | telemetry_sync_bcd(u32_day);
+
+    RTC->ISR &= ~RTC_ISR_INIT;
+    RTC->WPR = 0xFFu;
+    g_telemetry_sync_stats.u32_rtc_sets++;
+}
+
+/**
+ * @brief Days since 1970-01-01 of a civil date (proleptic Gregorian).
+ *
+ * @param i32_year  Year
+ * @param u32_month 1 .. 12
+ * @param u32_day   1 .. 31
+ * @return Days, negative before 1970
+ */
+static int32_t telemetry_sync_days(int32_t i32_year, uint32_t u32_month, uint32_t u32_day)
+{
+    int32_t  i32_y = i32_year - ((u32_month <= 2u) ? 1 : 0);
+    int32_t  i32_era = i32_y / 400;
+    uint32_t u32_yoe = (uint32_t)(i32_y - i32_era * 400);
+    uint32_t u32_doy = (153u * ((u32_month > 2u) ? (u32_month - 3u) : (u32_month + 9u)) + 2u) / 5u + u32_day - 1u;
+    uint32_t u32_doe = u32_yoe * 365u + u32_yoe / 4u - u32_yoe / 100u + u32_doy;
+
+    return i32_era * 146097 + (int32_t)u32_doe - 719468;
+}
+
+/**
+ * @brief Binary to BCD (0 .. 99).
+ *
+ * @param u32_value Value
+ * @return BCD digits
+ */
+static uint32_t telemetry_sync_bcd(uint32_t u32_value)
+{
+    return ((u32_value / 10u) << 4) | (u32_value % 10u);
+}
+
+/**
+ * @brief BCD to binary (two digits).
+ *
+ * @param u32_bcd BCD digits
+ * @return Value
+ */
+static uint32_t telemetry_sync_bin(uint32_t u32_bcd)
+{
+    return (u32_bcd >> 4) * 10u + (u32_bcd & 0xFu);
+}
+#endif
@@ -0,0 +1,182 @@
+/**
+ ******************************************************************************
+ * @file        telemetry_sync.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Host clock synchronisation over the telemetry link.
+ *
+ * @details
+ * Maps the 64 bit timebase of the board to the clock of the host, so the
+ * streams of several boards can be merged on the host without stamping
+ * every sample there. Four time stamps per ping, as in NTP:
+ *
+ *   t1  board: the ping frame (telemetry_batch_send_sync()) has left the
+ *       UART (transfer complete of the marked frame)
+ *   t2  host:  ping received
+ *   t3  host:  reply written, sent as t2 and the hold time t3 - t2
+ *   t4  board: end of the reply line (idle line of the RX DMA)
+ *
+ *   offset = ((t2 - t1) + (t3 - t4)) / 2   host minus board
+ *   delay  = (t4 - t1) - (t3 - t2)         round trip on the wire
+ *
+ * The reply is a shell line "tm <ping> <t2 us> <hold us>" (the command
+ * of the application calls telemetry_sync_reply()). The error of one
+ * sample is half the asymmetry of the two directions, on the ST-LINK
+ * virtual COM port mostly the USB frame the bytes wait for; of every
+ * TELEMETRY_SYNC_WINDOW pings only the one with the shortest round trip
+ * is used. Two of these estimates give the drift of the board clock
+ * (ppb, smoothed 1:4), from then on the sync is locked and
+ * telemetry_sync_to_host() converts any board time; batch frames carry
+ * the host time of their first sample (TELEMETRY_BATCH_TLV_HOST_US).
+ * An estimate that misses the prediction by TELEMETRY_SYNC_STEP_US (the
+ * host clock was set) starts over; without replies the lock holds for
+ * TELEMETRY_SYNC_HOLDOVER_MS.
+ *
+ * With TELEMETRY_SYNC_RTC_ENABLE and a running RTC (modules/lowpower)
+ * the calendar follows the host clock, taken as microseconds since
+ * 1970-01-01 UTC: set when it is a second or more off, otherwise moved
+ * by the sub-second shift (RTC_SHIFTR) once the error exceeds
+ * TELEMETRY_SYNC_RTC_TOLERANCE_US. The resolution is one sub-second step
+ * (4 ms with the LSI settings of lowpower).
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - One ping every TELEMETRY_SYNC_PERIOD_MS from telemetry_sync_poll(),
+ *    a reply after TELEMETRY_SYNC_TIMEOUT_MS or for another ping is
+ *    dropped, round trips above TELEMETRY_SYNC_MAX_DELAY_US are rejected
+ *  - Offset in us and drift in ppb, board time to host time
+ *  - RTC calendar and sub-seconds disciplined from the host clock
+ *  - modules/uart_telemetry/uart_telemetry_decode.py --batch --sync
+ *    answers the pings on the serial port
+ *
+ * Same context as telemetry_batch_send() (the single sender of the
+ * telemetry channel); needs timebase_init().
+ *
+ ******************************************************************************
+ */
+
+#ifndef UART_TELEMETRY_TELEMETRY_SYNC_H_
+#define UART_TELEMETRY_TELEMETRY_SYNC_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief 1 to synchronise to the host in the applications (needs the
+ *        shell on the telemetry port).
+ */
+#ifndef TELEMETRY_SYNC_ENABLE
+#define TELEMETRY_SYNC_ENABLE               0
+#endif
+
+/**
+ * @brief 1 to discipline a running RTC calendar from the host clock.
+ */
+#ifndef TELEMETRY_SYNC_RTC_ENABLE
+#define TELEMETRY_SYNC_RTC_ENABLE           1
+#endif
+
+/**
+ * @brief Ping period and reply timeout in ms.
+ */
+#ifndef TELEMETRY_SYNC_PERIOD_MS
+#define TELEMETRY_SYNC_PERIOD_MS            250U
+#endif
+#define TELEMETRY_SYNC_TIMEOUT_MS           200U
+
+/**
+ * @brief Pings per estimate (the shortest round trip is used).
+ */
+#ifndef TELEMETRY_SYNC_WINDOW
+#define TELEMETRY_SYNC_WINDOW               8U
+#endif
+
+/**
+ * @brief Longest round trip used, prediction error that restarts the
+ *        sync, time the lock holds without estimates.
+ */
+#define TELEMETRY_SYNC_MAX_DELAY_US         20000U
+#define TELEMETRY_SYNC_STEP_US              100000
+#define TELEMETRY_SYNC_HOLDOVER_MS          60000U
+
+/**
+ * @brief RTC error left alone.
+ */
+#define TELEMETRY_SYNC_RTC_TOLERANCE_US     2000
+
+#if TELEMETRY_SYNC_TIMEOUT_MS >= TELEMETRY_SYNC_PERIOD_MS
+#error "TELEMETRY_SYNC_PERIOD_MS must be longer than the reply timeout"
+#endif
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief State since telemetry_sync_init().
+ */
+typedef struct {
+    int64_t  i64_offset_us;     /**< Host minus board at the last estimate */
+    int32_t  i32_drift_ppb;     /**< Host clock faster than the board      */
+    uint32_t u32_delay_us;      /**< Round trip of the last estimate       */
+    uint32_t u32_pings;         /**< Pings queued                          */
+    uint32_t u32_replies;       /**< Replies used                          */
+    uint32_t u32_rejected;      /**< Late, unknown or too slow replies     */
+    uint32_t u32_estimates;     /**< Windows evaluated                     */
+    uint32_t u32_steps;         /**< Restarts after a host clock step      */
+    uint32_t u32_rtc_shifts;    /**< Sub-second corrections of the RTC     */
+    uint32_t u32_rtc_sets;      /**< Calendar set                          */
+    int32_t  i32_rtc_error_us;  /**< Host minus RTC at the last check      */
+    uint8_t  u8_locked;         /**< telemetry_sync_to_host() valid        */
+} telemetry_sync_stats_t;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Resets the sync (not locked, no pings outstanding).
+ *
+ * @return None
+ */
+void telemetry_sync_init(void);
+
+/**
+ * @brief Queues the next ping when due and collects the send time of
+ *        the last one. Main loop, every few ms.
+ *
+ * @return None
+ */
+void telemetry_sync_poll(void);
+
+/**
+ * @brief Takes the reply of the host to a ping (shell command context).
+ *
+ * @param u16_seq     Ping number
+ * @param u64_host_us t2, host clock when the ping arrived
+ * @param u32_hold_us t3 - t2, time the host took to reply
+ * @return HAL_OK, HAL_ERROR if it answers no outstanding ping, HAL_BUSY
+ *         if the round trip was too long (not used)
+ */
+HAL_StatusTypeDef telemetry_sync_reply(uint16_t u16_seq, uint64_t u64_host_us, uint32_t u32_hold_us);
+
+/**
+ * @brief Converts a board time to the host clock.
+ *
+ * @param u64_board_us timebase_now() or timebase_extend() value
+ * @return Host clock in us, the board time itself if never synchronised
+ */
+uint64_t telemetry_sync_to_host(uint64_t u64_board_us);
+
+/**
+ * @brief Returns 1 while offset and drift are valid.
+ *
+ * @return 1 locked, 0 not
+ */
+uint8_t telemetry_sync_is_locked(void);
+
+/**
+ * @brief Copies the state.
+ *
+ * @param stats Destination
+ * @return None
+ */
+void telemetry_sync_get_stats(telemetry_sync_stats_t *stats);
+
+#endif /* UART_TELEMETRY_TELEMETRY_SYNC_H_ */
@@ -0,0 +1,528 @@
+/**
+ ******************************************************************************
+ * @file        uart_telemetry.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       UART telemetry channel with DMA TX frame queue and idle line DMA RX
+ *
+ * Functionality:
+ * - Every frame is built in a block of the shared pool, the descriptor
+ *   goes into a single producer / single consumer queue (sync_queue_t)
+ * - Every transfer is started from the USART1 interrupt, a sender only
+ *   sets it pending; one transfer sends one frame straight out of its
+ *   block, the block is freed when the transfer has left the UART
+ * - RX: HAL_UARTEx_ReceiveToIdle_DMA() in circular mode, the receive
+ *   events report the DMA position, the reader follows with its own
+ *   index; bytes overwritten before they were read are counted
+ * - Time stamps (timebase) of the end of a marked TX frame (transfer
+ *   complete) and of the last RX event, the idle line one character
+ *   after the last byte is taken back
+ *
+ * Resources:
+ * - PA9 (USART1_TX, AF7), PA10 (USART1_RX, AF7), USART1
+ * - USART1_TX / USART1_RX requests of dma_alloc (DMA2 Stream7 and Stream2,
+ *   else Stream5, Channel 4)
+ ******************************************************************************
+ */
+
+#include "uart_telemetry.h"
+#include "dma_alloc/dma_alloc.h"
+#include "pool/pool.h"
+#include "sync/sync.h"
+#include "timebase/timebase.h"
+#include "utils/utils.h"
+#include <string.h>
+
+/* Private Preprocessor Defines -------------------------------------------- */
+#if (UART_TELEMETRY_TX_FRAMES & (UART_TELEMETRY_TX_FRAMES - 1U)) != 0
+#error "UART_TELEMETRY_TX_FRAMES must be a power of two"
+#endif
+
+#if (UART_TELEMETRY_RX_SIZE & (UART_TELEMETRY_RX_SIZE - 1U)) != 0
+#error "UART_TELEMETRY_RX_SIZE must be a power of two"
+#endif
+
+/**
+ * @brief Sync, channel, length and tick in front of the payload, checksum
+ *        behind it.
+ */
+#define UART_TELEMETRY_HEADER_SIZE  7U
+#define UART_TELEMETRY_CRC_SIZE     2U
+
+/* Private Type Definitions ------------------------------------------------- */
+/**
+ * @brief One queued frame: pool block and bytes to send.
+ */
+typedef struct {
+    uint8_t  *pu8_data;
+    uint16_t  u16_length;
+    uint8_t   u8_marked;    /**< Stamp the end of the transfer */
+} uart_telemetry_tx_frame_t;
+
+/* Static module variables -------------------------------------------------- */
+static UART_HandleTypeDef g_uart_telemetry_uart;
+static DMA_HandleTypeDef  g_uart_telemetry_tx_dma;
+static DMA_HandleTypeDef  g_uart_telemetry_rx_dma;
+
+/**
+ * @brief TX frames. Queue: sender pushes, USART1 interrupt pops; the
+ *        running frame is written by the interrupts only.
+ */
+static uart_telemetry_tx_frame_t g_uart_telemetry_tx_frames[UART_TELEMETRY_TX_FRAMES];
+static sync_queue_t g_uart_telemetry_tx_queue = SYNC_QUEUE_INIT(g_uart_telemetry_tx_frames);
+static uint8_t * volatile g_pu8_uart_telemetry_tx_running = NULL;
+
+/**
+ * @brief TX stamp: next queued frame marked (sender), running frame
+ *        marked, stamp and count of the marked frames that have left
+ *        (interrupts).
+ */
+static uint8_t g_u8_uart_telemetry_mark_next = 0u;
+static volatile uint8_t g_u8_uart_telemetry_tx_marked = 0u;
+static volatile uint32_t g_u32_uart_telemetry_tx_stamp = 0u;
+static volatile uint32_t g_u32_uart_telemetry_tx_stamped = 0u;
+static uint32_t g_u32_uart_telemetry_tx_seen = 0u;
+
+/**
+ * @brief RX ring. Written, restart and last: interrupts only, read: reader.
+ *        The bytes are not cleared at startup, only read behind the DMA.
+ */
+static uint8_t g_u8_uart_telemetry_rx_ring[UART_TELEMETRY_RX_SIZE] UTILS_NOINIT;
+static volatile uint32_t g_u32_uart_telemetry_rx_written = 0u;
+static volatile uint32_t g_u32_uart_telemetry_rx_restart = 0u; /**< First valid byte after a restart */
+static uint16_t g_u16_uart_telemetry_rx_last = 0u;             /**< DMA position of the last event  */
+static uint32_t g_u32_uart_telemetry_rx_read = 0u;
+static volatile uint32_t g_u32_uart_telemetry_rx_stamp = 0u;  /**< End of the last received bytes */
+static uint32_t g_u32_uart_telemetry_char_us = 0u;            /**< One character (10 bits)        */
+
+static uart_telemetry_rx_callback_t g_uart_telemetry_rx_callback = NULL;
+static uart_telemetry_stats_t g_uart_telemetry_stats;
+
+/* Static function prototypes ---------------------------------------------- */
+static HAL_StatusTypeDef uart_telemetry_tx_queue(uint8_t *pu8_block, uint16_t u16_length);
+static void uart_telemetry_tx_start(void);
+static void uart_telemetry_tx_done(void);
+static HAL_StatusTypeDef uart_telemetry_rx_start(void);
+
+/* Public functions --------------------------------------------------------- */
+HAL_StatusTypeDef uart_telemetry_init(uint32_t u32_baud)
+{
+    GPIO_InitTypeDef gpio_init_struct;
+    uart_telemetry_tx_frame_t frame;
+
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+    __HAL_RCC_USART1_CLK_ENABLE();
+
+    gpio_init_struct.Pin       = GPIO_PIN_9 | GPIO_PIN_10;
+    gpio_init_struct.Mode      = GPIO_MODE_AF_PP;
+    gpio_init_struct.Pull      = GPIO_PULLUP;
+    gpio_init_struct.Speed     = GPIO_SPEED_FREQ_HIGH;
+    gpio_init_struct.Alternate = GPIO_AF7_USART1;
+    HAL_GPIO_Init(GPIOA, &gpio_init_struct);
+
+    /* Frames may wait in the ring, received commands less so */
+    if (dma_alloc_claim(&g_uart_telemetry_tx_dma, DMA_ALLOC_REQ_USART1_TX,
+                        DMA_ALLOC_LATENCY_BULK, HEALTH_ISR_COUNT) != HAL_OK) {
+        return HAL_ERROR;
+    }
+    g_uart_telemetry_tx_dma.Init.Direction           = DMA_MEMORY_TO_PERIPH;
+    g_uart_telemetry_tx_dma.Init.PeriphInc           = DMA_PINC_DISABLE;
+    g_uart_telemetry_tx_dma.Init.MemInc              = DMA_MINC_ENABLE;
+    g_uart_telemetry_tx_dma.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    g_uart_telemetry_tx_dma.Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
+    g_uart_telemetry_tx_dma.Init.Mode                = DMA_NORMAL;
+    g_uart_telemetry_tx_dma.Init.FIFOMode            = DMA_FIFOMODE_DISABLE;
+
+    g_uart_telemetry_rx_dma.Init                     = g_uart_telemetry_tx_dma.Init;
+    g_uart_telemetry_rx_dma.Init.Direction           = DMA_PERIPH_TO_MEMORY;
+    g_uart_telemetry_rx_dma.Init.Mode                = DMA_CIRCULAR;
+    if (dma_alloc_claim(&g_uart_telemetry_rx_dma, DMA_ALLOC_REQ_USART1_RX,
+                        DMA_ALLOC_LATENCY_EVENT, HEALTH_ISR_COUNT) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    g_uart_telemetry_uart.Instance          = USART1;
+    g_uart_telemetry_uart.Init.BaudRate     = u32_baud;
+    g_uart_telemetry_uart.Init.WordLength   = UART_WORDLENGTH_8B;
+    g_uart_telemetry_uart.Init.StopBits     = UART_STOPBITS_1;
+    g_uart_telemetry_uart.Init.Parity       = UART_PARITY_NONE;
+    g_uart_telemetry_uart.Init.Mode         = UART_MODE_TX_RX;
+    g_uart_telemetry_uart.Init.HwFlowCtl    = UART_HWCONTROL_NONE;
+    g_uart_telemetry_uart.Init.OverSampling = UART_OVERSAMPLING_16;
+
+    if ((HAL_DMA_Init(&g_uart_telemetry_tx_dma) != HAL_OK) ||
+        (HAL_DMA_Init(&g_uart_telemetry_rx_dma) != HAL_OK) ||
+        (HAL_UART_Init(&g_uart_telemetry_uart) != HAL_OK)) {
+        return HAL_ERROR;
+    }
+    __HAL_LINKDMA(&g_uart_telemetry_uart, hdmatx, g_uart_telemetry_tx_dma);
+    __HAL_LINKDMA(&g_uart_telemetry_uart, hdmarx, g_uart_telemetry_rx_dma);
+
+    /* Frames of a previous init go back to the pool */
+    while (sync_queue_pop(&g_uart_telemetry_tx_queue, &frame) != 0u) {
+        pool_shared_free(frame.pu8_data);
+    }
+    uart_telemetry_tx_done();
+    g_u32_uart_telemetry_rx_written = 0u;
+    g_u32_uart_telemetry_rx_restart = 0u;
+    g_u32_uart_telemetry_rx_read    = 0u;
+    g_u8_uart_telemetry_mark_next   = 0u;
+    g_u32_uart_telemetry_tx_seen    = g_u32_uart_telemetry_tx_stamped;
+    g_u32_uart_telemetry_char_us    = (10000000UL + u32_baud / 2u) / u32_baud;
+    memset(&g_uart_telemetry_stats, 0, sizeof(g_uart_telemetry_stats));
+
+    /* Same priority for all three, none preempts another inside the HAL */
+    HAL_NVIC_SetPriority(USART1_IRQn, UART_TELEMETRY_IRQ_PRIORITY, 0u);
+    HAL_NVIC_SetPriority(dma_alloc_get_irqn(&g_uart_telemetry_tx_dma), UART_TELEMETRY_IRQ_PRIORITY, 0u);
+    HAL_NVIC_SetPriority(dma_alloc_get_irqn(&g_uart_telemetry_rx_dma), UART_TELEMETRY_IRQ_PRIORITY, 0u);
+    HAL_NVIC_EnableIRQ(dma_alloc_get_irqn(&g_uart_telemetry_tx_dma));
+    HAL_NVIC_EnableIRQ(dma_alloc_get_irqn(&g_uart_telemetry_rx_dma));
+
+    if (uart_telemetry_rx_start() != HAL_OK) {
+        return HAL_ERROR;
+    }
+    HAL_NVIC_EnableIRQ(USART1_IRQn);
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef uart_telemetry_send(uart_telemetry_channel_t ch, const void *payload, uint8_t u8_length)
+{
+    uint8_t  u8_header[UART_TELEMETRY_HEADER_SIZE];
+    const uint8_t *pu8_payload = (const uint8_t *)payload;
+    uint32_t u32_tick = HAL_GetTick();
+    uint32_t u32_size = UART_TELEMETRY_HEADER_SIZE + u8_length + UART_TELEMETRY_CRC_SIZE;
+    uint8_t *pu8_frame;
+    uint16_t u16_sum1 = 0u;
+    uint16_t u16_sum2 = 0u;
+
+    if (u8_length > UART_TELEMETRY_MAX_PAYLOAD) {
+        return HAL_ERROR;
+    }
+    pu8_frame = pool_shared_alloc((uint16_t)u32_size);
+    if (pu8_frame == NULL) {
+        g_uart_telemetry_stats.u32_dropped++;
+        return HAL_BUSY;
+    }
+
+    u8_header[0] = UART_TELEMETRY_SYNC;
+    u8_header[1] = (uint8_t)ch;
+    u8_header[2] = u8_length;
+    u8_header[3] = (uint8_t)u32_tick;
+    u8_header[4] = (uint8_t)(u32_tick >> 8);
+    u8_header[5] = (uint8_t)(u32_tick >> 16);
+    u8_header[6] = (uint8_t)(u32_tick >> 24);
+
+    /* Fletcher-16 from the channel to the end of the payload */
+    for (uint32_t i = 0u; i < UART_TELEMETRY_HEADER_SIZE + u8_length; i++) {
+        uint8_t u8_byte = (i < UART_TELEMETRY_HEADER_SIZE) ? u8_header[i]
+                                                            : pu8_payload[i - UART_TELEMETRY_HEADER_SIZE];
+
+        pu8_frame[i] = u8_byte;
+        if (i > 0u) {
+            u16_sum1 = (uint16_t)((u16_sum1 + u8_byte) % 255u);
+            u16_sum2 = (uint16_t)((u16_sum2 + u16_sum1) % 255u);
+        }
+    }
+    pu8_frame[UART_TELEMETRY_HEADER_SIZE + u8_length]      = (uint8_t)u16_sum1;
+    pu8_frame[UART_TELEMETRY_HEADER_SIZE + u8_length + 1u] = (uint8_t)u16_sum2;
+
+    return uart_telemetry_tx_queue(pu8_frame, (uint16_t)u32_size);
+}
+
+HAL_StatusTypeDef uart_telemetry_send_cobs(const uint8_t *pu8_data, uint16_t u16_length)
+{
+    /* One code byte per 254 data bytes, the first code byte and the delimiter */
+    uint32_t u32_size = (uint32_t)u16_length + u16_length / 254u + 2u;
+    uint8_t *pu8_frame;
+    uint32_t u32_code = 0u;                  /* Position of the code byte of the current block */
+    uint32_t u32_pos  = 1u;
+    uint8_t  u8_code  = 1u;
+
+    if (u32_size > POOL_LARGE_SIZE) {
+        return HAL_ERROR;
+    }
+    pu8_frame = pool_shared_alloc((uint16_t)u32_size);
+    if (pu8_frame == NULL) {
+        g_uart_telemetry_stats.u32_dropped++;
+        return HAL_BUSY;
+    }
+
+    for (uint16_t i = 0u; i < u16_length; i++) {
+        if (pu8_data[i] != 0u) {
+            pu8_frame[u32_pos++] = pu8_data[i];
+            u8_code++;
+        }
+        if ((pu8_data[i] == 0u) || (u8_code == 0xFFu)) {
+            pu8_frame[u32_code] = u8_code;
+            u32_code = u32_pos++;
+            u8_code  = 1u;
+        }
+    }
+    pu8_frame[u32_code]  = u8_code;
+    pu8_frame[u32_pos++] = 0u;
+
+    return uart_telemetry_tx_queue(pu8_frame, (uint16_t)u32_pos);
+}
+
+void uart_telemetry_send_fan(uint16_t u16_target_rpm, uint16_t u16_rpm, uint16_t u16_duty)
+{
+    uint16_t u16_payload[3] = {u16_target_rpm, u16_rpm, u16_duty};
+
+    uart_telemetry_send(UART_TELEMETRY_CH_FAN, u16_payload, sizeof(u16_payload));
+}
+
+void uart_telemetry_send_potis(uint16_t u16_poti_1, uint16_t u16_poti_2)
+{
+    uint16_t u16_payload[2] = {u16_poti_1, u16_poti_2};
+
+    uart_telemetry_send(UART_TELEMETRY_CH_POTIS, u16_payload, sizeof(u16_payload));
+}
+
+void uart_telemetry_send_env(int32_t i32_temp, uint32_t u32_press, uint32_t u32_hum)
+{
+    uint32_t u32_payload[3] = {(uint32_t)i32_temp, u32_press, u32_hum};
+
+    uart_telemetry_send(UART_TELEMETRY_CH_ENV, u32_payload, sizeof(u32_payload));
+}
+
+HAL_StatusTypeDef uart_telemetry_flush(uint32_t u32_timeout_ms)
+{
+    uint32_t u32_start = HAL_GetTick();
+
+    /* A frame is running until its last byte has left the UART */
+    while ((sync_queue_count(&g_uart_telemetry_tx_queue) != 0u) || (g_pu8_uart_telemetry_tx_running != NULL)) {
+        if ((HAL_GetTick() - u32_start) >= u32_timeout_ms) {
+            return HAL_TIMEOUT;
+        }
+    }
+
+    return HAL_OK;
+}
+
+uint16_t uart_telemetry_read(uint8_t *pu8_data, uint16_t u16_size)
+{
+    uint32_t u32_written = g_u32_uart_telemetry_rx_written;
+    uint32_t u32_restart = g_u32_uart_telemetry_rx_restart;
+    uint32_t u32_read    = g_u32_uart_telemetry_rx_read;
+    uint16_t u16_count   = 0u;
+
+    if ((int32_t)(u32_restart - u32_read) > 0) {
+        u32_read = u32_restart;
+    }
+    if (u32_written - u32_read > UART_TELEMETRY_RX_SIZE) {
+        g_uart_telemetry_stats.u32_rx_overruns += u32_written - u32_read - UART_TELEMETRY_RX_SIZE;
+        u32_read = u32_written - UART_TELEMETRY_RX_SIZE;
+    }
+
+    while ((u32_read != u32_written) && (u16_count < u16_size)) {
+        pu8_data[u16_count++] = g_u8_uart_telemetry_rx_ring[u32_read++ & (UART_TELEMETRY_RX_SIZE - 1u)];
+    }
+    g_u32_uart_telemetry_rx_read = u32_read;
+
+    return u16_count;
+}
+
+uint16_t uart_telemetry_rx_available(void)
+{
+    uint32_t u32_pending = g_u32_uart_telemetry_rx_written - g_u32_uart_telemetry_rx_read;
+
+    return (uint16_t)((u32_pending > UART_TELEMETRY_RX_SIZE) ? UART_TELEMETRY_RX_SIZE : u32_pending);
+}
+
+void uart_telemetry_set_rx_callback(uart_telemetry_rx_callback_t callback)
+{
+    g_uart_telemetry_rx_callback = callback;
+}
+
+void uart_telemetry_get_stats(uart_telemetry_stats_t *stats)
+{
+    *stats = g_uart_telemetry_stats;
+}
+
+void uart_telemetry_mark_next(uint8_t u8_mark)
+{
+    g_u8_uart_telemetry_mark_next = u8_mark;
+}
+
+uint8_t uart_telemetry_get_tx_stamp(uint32_t *pu32_stamp)
+{
+    uint32_t u32_stamped = g_u32_uart_telemetry_tx_stamped;
+
+    if (u32_stamped == g_u32_uart_telemetry_tx_seen) {
+        return 0u;
+    }
+    g_u32_uart_telemetry_tx_seen = u32_stamped;
+    *pu32_stamp = g_u32_uart_telemetry_tx_stamp;
+
+    return 1u;
+}
+
+uint32_t uart_telemetry_get_rx_stamp(void)
+{
+    return g_u32_uart_telemetry_rx_stamp;
+}
+
+/* HAL callbacks / interrupt handlers -------------------------------------- */
+/**
+ * @brief Last byte of a transfer has left the UART: frees its block.
+ */
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+    if (huart != &g_uart_telemetry_uart) {
+        return;
+    }
+
+    if (g_u8_uart_telemetry_tx_marked) {
+        g_u32_uart_telemetry_tx_stamp = timebase_now32();
+        g_u32_uart_telemetry_tx_stamped++;
+    }
+    uart_telemetry_tx_done();
+}
+
+/**
+ * @brief Idle line, half or full RX buffer: Size is the DMA position.
+ */
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size)
+{
+    uint16_t u16_new;
+    uint32_t u32_stamp = timebase_now32();
+
+    if (huart != &g_uart_telemetry_uart) {
+        return;
+    }
+
+    u16_new = (uint16_t)(((uint32_t)Size + UART_TELEMETRY_RX_SIZE - g_u16_uart_telemetry_rx_last) %
+                         UART_TELEMETRY_RX_SIZE);
+    g_u16_uart_telemetry_rx_last = (Size >= UART_TELEMETRY_RX_SIZE) ? 0u : Size;
+    if (u16_new == 0u) {
+        return;
+    }
+
+    /* The idle event comes one character after the last stop bit */
+    g_u32_uart_telemetry_rx_stamp = (huart->RxEventType == HAL_UART_RXEVENT_IDLE)
+                                  ? (u32_stamp - g_u32_uart_telemetry_char_us) : u32_stamp;
+    g_u32_uart_telemetry_rx_written += u16_new;
+    g_uart_telemetry_stats.u32_rx_bytes += u16_new;
+
+    if (g_uart_telemetry_rx_callback != NULL) {
+        g_uart_telemetry_rx_callback(uart_telemetry_rx_available());
+    }
+}
+
+/**
+ * @brief UART or DMA error: the HAL has aborted the affected direction.
+ */
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+    if (huart != &g_uart_telemetry_uart) {
+        return;
+    }
+
+    g_uart_telemetry_stats.u32_errors++;
+
+    /* Running frame is lost, the next one follows */
+    if (huart->gState == HAL_UART_STATE_READY) {
+        uart_telemetry_tx_done();
+    }
+
+    /* The DMA starts again at the ring start, the reader skips the rest of the lap */
+    if (huart->RxState == HAL_UART_STATE_READY) {
+        uint32_t u32_lap = (g_u32_uart_telemetry_rx_written + UART_TELEMETRY_RX_SIZE - 1u) &
+                           ~(uint32_t)(UART_TELEMETRY_RX_SIZE - 1u);
+
+        g_u32_uart_telemetry_rx_written = u32_lap;
+        g_u32_uart_telemetry_rx_restart = u32_lap;
+        uart_telemetry_rx_start();
+    }
+}
+
+void USART1_IRQHandler(void)
+{
+    HAL_UART_IRQHandler(&g_uart_telemetry_uart);
+
+    /* Also runs when a sender set it pending */
+    uart_telemetry_tx_start();
+}
+
+/* Static module functions -------------------------------------------------- */
+/**
+ * @brief Hands a complete frame to the USART1 interrupt.
+ *
+ * @param pu8_block  Pool block holding the frame, freed on failure
+ * @param u16_length Bytes of the frame
+ * @return HAL_OK, HAL_BUSY if the queue is full (frame dropped)
+ */
+static HAL_StatusTypeDef uart_telemetry_tx_queue(uint8_t *pu8_block, uint16_t u16_length)
+{
+    uart_telemetry_tx_frame_t frame = {pu8_block, u16_length, g_u8_uart_telemetry_mark_next};
+
+    g_u8_uart_telemetry_mark_next = 0u;
+
+    /* The queue orders the frame bytes before the descriptor */
+    if (sync_queue_push(&g_uart_telemetry_tx_queue, &frame) != HAL_OK) {
+        pool_shared_free(pu8_block);
+        g_uart_telemetry_stats.u32_dropped++;
+        return HAL_BUSY;
+    }
+    g_uart_telemetry_stats.u32_frames++;
+
+    NVIC_SetPendingIRQ(USART1_IRQn);
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Starts the next frame if the UART is idle.
+ *
+ * USART1 interrupt context only, the single consumer of the queue.
+ *
+ * @return None
+ */
+static void uart_telemetry_tx_start(void)
+{
+    uart_telemetry_tx_frame_t frame;
+
+    if ((g_pu8_uart_telemetry_tx_running != NULL) || (g_uart_telemetry_uart.gState != HAL_UART_STATE_READY) ||
+        (sync_queue_pop(&g_uart_telemetry_tx_queue, &frame) == 0u)) {
+        return;
+    }
+
+    if (HAL_UART_Transmit_DMA(&g_uart_telemetry_uart, frame.pu8_data, frame.u16_length) == HAL_OK) {
+        g_u8_uart_telemetry_tx_marked   = frame.u8_marked;
+        g_pu8_uart_telemetry_tx_running = frame.pu8_data;
+        g_uart_telemetry_stats.u32_tx_bytes += frame.u16_length;
+    } else {
+        pool_shared_free(frame.pu8_data);
+        g_uart_telemetry_stats.u32_errors++;
+    }
+}
+
+/**
+ * @brief Frees the block of the running frame.
+ *
+ * @return None
+ */
+static void uart_telemetry_tx_done(void)
+{
+    pool_shared_free(g_pu8_uart_telemetry_tx_running);
+    g_pu8_uart_telemetry_tx_running = NULL;
+    g_u8_uart_telemetry_tx_marked   = 0u;
+}
+
+/**
+ * @brief Starts the circular reception at the ring start.
+ *
+ * The half transfer events stay on: they report bytes of a burst that
+ * is longer than half the ring before the line gets idle.
+ *
+ * @return HAL status
+ */
+static HAL_StatusTypeDef uart_telemetry_rx_start(void)
+{
+    g_u16_uart_telemetry_rx_last = 0u;
+
+    return HAL_UARTEx_ReceiveToIdle_DMA(&g_uart_telemetry_uart, g_u8_uart_telemetry_rx_ring,
+                                        UART_TELEMETRY_RX_SIZE);
+}
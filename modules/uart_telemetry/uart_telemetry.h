@@ -0,0 +1,233 @@
+/**
+ ******************************************************************************
+ * @file        uart_telemetry.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the UART telemetry channel.
+ *
+ * @details
+ * Streams binary frames over USART1, the virtual COM port of the ST-LINK
+ * on the discovery board, and receives bytes from the host. Sending a
+ * frame builds it in a block of the shared pool (modules/pool) and
+ * queues the block; the DMA transmits straight out of it, so a control
+ * loop never waits for the UART. The block returns to the pool once the
+ * frame has left the UART.
+ *
+ * The TX queue is single producer / single consumer without locks
+ * (sync_queue_t): the sender pushes, the USART1 interrupt pops and
+ * starts one DMA transfer per frame. A sender kicks an idle channel by
+ * setting the USART1 interrupt pending.
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - Frames: sync byte, channel, payload length, HAL tick (ms), payload,
+ *    Fletcher-16 checksum; little endian
+ *  - A full queue or an empty pool drops the frame and counts it, the
+ *    caller is never delayed
+ *  - COBS stuffed blocks for the batched frames of telemetry_batch.h
+ *  - RX: circular DMA into a ring, the idle line, half and full transfer
+ *    events advance the write position (uart_telemetry_read())
+ *  - Timebase stamps of the moment a marked frame has left the UART and
+ *    of the end of the last received bytes (time sync, telemetry_sync.h)
+ *  - modules/uart_telemetry/uart_telemetry_decode.py turns a capture or
+ *    the serial port into CSV
+ *
+ * Frame payloads:
+ *  - UART_TELEMETRY_CH_FAN:   u16 target rpm, u16 measured rpm,
+ *                             u16 duty in 0.01 %
+ *  - UART_TELEMETRY_CH_POTIS: u16 POTI_1, u16 POTI_2 (12 bit)
+ *  - UART_TELEMETRY_CH_ENV:   i32 temperature 0.01 C, u32 pressure Pa,
+ *                             u32 humidity 0.001 %
+ *
+ * Only one context may send (e.g. one scheduler task). USART1 is also
+ * used by the blocking report of B0_Benchmarks, not together with this
+ * module. The DMA streams come from dma_alloc; together with the DMA
+ * multiplexing of esd the later init fails with a counted conflict.
+ * The baud rate is derived from PCLK2, after a clock profile change
+ * uart_telemetry_init() has to be called again.
+ *
+ ******************************************************************************
+ */
+
+#ifndef UART_TELEMETRY_UART_TELEMETRY_H_
+#define UART_TELEMETRY_UART_TELEMETRY_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+#include "irq/irq.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief 1 to stream the project values, used by the applications.
+ */
+#ifndef UART_TELEMETRY_ENABLE
+#define UART_TELEMETRY_ENABLE           0
+#endif
+
+/**
+ * @brief Default baud rate (ST-LINK V2-1 virtual COM port).
+ */
+#define UART_TELEMETRY_BAUD             921600UL
+
+/**
+ * @brief Queued TX frames and RX ring size in bytes, powers of two.
+ */
+#define UART_TELEMETRY_TX_FRAMES        16U
+#define UART_TELEMETRY_RX_SIZE          256U
+
+/**
+ * @brief Largest payload of one frame.
+ */
+#define UART_TELEMETRY_MAX_PAYLOAD      32U
+
+/**
+ * @brief First byte of every frame.
+ */
+#define UART_TELEMETRY_SYNC             0xA5U
+
+/**
+ * @brief NVIC priority of USART1 and both DMA streams (no kernel calls).
+ */
+#define UART_TELEMETRY_IRQ_PRIORITY     IRQ_CLASS_TRANSFER
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Frame channels.
+ */
+typedef enum {
+    UART_TELEMETRY_CH_FAN   = 1,    /**< Fan target, rpm and duty      */
+    UART_TELEMETRY_CH_POTIS = 2,    /**< Averaged potentiometer values */
+    UART_TELEMETRY_CH_ENV   = 3,    /**< BME280 sample                 */
+    UART_TELEMETRY_CH_USER  = 16    /**< First channel for the application */
+} uart_telemetry_channel_t;
+
+/**
+ * @brief Called from the interrupt when received bytes are available.
+ *
+ * @param u16_available Bytes waiting for uart_telemetry_read()
+ */
+typedef void (*uart_telemetry_rx_callback_t)(uint16_t u16_available);
+
+/**
+ * @brief Counters since uart_telemetry_init().
+ */
+typedef struct {
+    uint32_t u32_frames;        /**< Frames queued for transmission         */
+    uint32_t u32_dropped;       /**< Frames dropped, TX queue or pool full  */
+    uint32_t u32_tx_bytes;      /**< Bytes handed to the DMA                */
+    uint32_t u32_rx_bytes;      /**< Bytes received                          */
+    uint32_t u32_rx_overruns;   /**< Bytes overwritten before they were read */
+    uint32_t u32_errors;        /**< UART errors (overrun, framing, noise)   */
+} uart_telemetry_stats_t;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Configures PA9 / PA10, USART1 (8N1) and both DMA streams and
+ *        starts the reception.
+ *
+ * @param u32_baud Baud rate, e.g. UART_TELEMETRY_BAUD
+ * @return HAL_OK, HAL_ERROR if the UART or a DMA stream can not be set up
+ */
+HAL_StatusTypeDef uart_telemetry_init(uint32_t u32_baud);
+
+/**
+ * @brief Queues one frame.
+ *
+ * @param ch          Channel
+ * @param payload     Payload bytes
+ * @param u8_length   Payload length, at most UART_TELEMETRY_MAX_PAYLOAD
+ * @return HAL_OK, HAL_BUSY if the queue or the pool is full (frame
+ *         dropped), HAL_ERROR if the payload is too long
+ */
+HAL_StatusTypeDef uart_telemetry_send(uart_telemetry_channel_t ch, const void *payload, uint8_t u8_length);
+
+/**
+ * @brief Queues a COBS stuffed block followed by a zero byte, e.g. the
+ *        frames of telemetry_batch. Stuffing is done while copying into
+ *        the pool block.
+ *
+ * @param pu8_data  Block
+ * @param u16_length Block length
+ * @return HAL_OK, HAL_BUSY if the queue or the pool is full (block
+ *         dropped), HAL_ERROR if the stuffed block exceeds POOL_LARGE_SIZE
+ */
+HAL_StatusTypeDef uart_telemetry_send_cobs(const uint8_t *pu8_data, uint16_t u16_length);
+
+/**
+ * @brief Queues the frames of the project channels (see the payloads above).
+ *
+ * @return None
+ */
+void uart_telemetry_send_fan(uint16_t u16_target_rpm, uint16_t u16_rpm, uint16_t u16_duty);
+void uart_telemetry_send_potis(uint16_t u16_poti_1, uint16_t u16_poti_2);
+void uart_telemetry_send_env(int32_t i32_temp, uint32_t u32_press, uint32_t u32_hum);
+
+/**
+ * @brief Waits until all queued frames have left the UART, e.g. before
+ *        the STOP mode.
+ *
+ * @param u32_timeout_ms Timeout in ms
+ * @return HAL_OK, HAL_TIMEOUT
+ */
+HAL_StatusTypeDef uart_telemetry_flush(uint32_t u32_timeout_ms);
+
+/**
+ * @brief Copies received bytes out of the RX ring.
+ *
+ * @param pu8_data  Destination
+ * @param u16_size  Room in the destination
+ * @return Bytes copied
+ */
+uint16_t uart_telemetry_read(uint8_t *pu8_data, uint16_t u16_size);
+
+/**
+ * @brief Returns the number of received bytes not read yet.
+ *
+ * @return Bytes
+ */
+uint16_t uart_telemetry_rx_available(void);
+
+/**
+ * @brief Installs the notification for received bytes (NULL: none).
+ *
+ * @param callback Function, interrupt context
+ * @return None
+ */
+void uart_telemetry_set_rx_callback(uart_telemetry_rx_callback_t callback);
+
+/**
+ * @brief Copies the counters.
+ *
+ * @param stats Destination
+ * @return None
+ */
+void uart_telemetry_get_stats(uart_telemetry_stats_t *stats);
+
+/**
+ * @brief Marks the next queued frame: the end of its transfer is stamped
+ *        (sender context).
+ *
+ * @param u8_mark 1 to mark, 0 to take a mark back (frame not queued)
+ * @return None
+ */
+void uart_telemetry_mark_next(uint8_t u8_mark);
+
+/**
+ * @brief Returns the stamp of a marked frame that has left the UART
+ *        since the last call.
+ *
+ * @param pu32_stamp timebase_now32() after its last stop bit
+ * @return 1 with a new stamp, 0 if none
+ */
+uint8_t uart_telemetry_get_tx_stamp(uint32_t *pu32_stamp);
+
+/**
+ * @brief Returns the time the last received bytes ended (the end of a
+ *        line after an idle event).
+ *
+ * @return timebase_now32() stamp
+ */
+uint32_t uart_telemetry_get_rx_stamp(void);
+
+#endif /* UART_TELEMETRY_UART_TELEMETRY_H_ */
@@ -0,0 +1,267 @@
+#!/usr/bin/env python3
+"""Decoder for the frames of modules/uart_telemetry.
+
+Reads a capture of the USART1 stream, or the virtual COM port itself
+(e.g. ``stty -F /dev/ttyACM0 921600 raw`` first), checks the Fletcher-16
+sum of every frame and writes one CSV line per field: time in
+milliseconds (HAL tick of the frame), channel name, field, value. Bytes
+in front of a valid frame are skipped and counted, so a capture may start
+in the middle of a frame.
+
+``--batch`` decodes the COBS stuffed frames of telemetry_batch instead:
+zero delimited, CRC-32 of the CRC unit, TLV records; every fast sample
+gets its own time from the batch tick and the sample period. Text
+records (shell replies) are written as field "text" and echoed to stderr,
+modules/dlog messages as channel "dlog" with the strings of ``--elf``,
+the deadline supervisor statistics as channel "deadline" (fields
+"stepN.misses" etc.).
+
+``--sync`` (with ``--batch`` on the serial device) answers the clock
+pings of modules/uart_telemetry/telemetry_sync: the arrival time of the
+read that completed the ping frame (microseconds since 1970, UTC) and the
+time until the reply is written go back as the shell line ``tm``.
+``--host-time`` takes the sample times from the host clock record of the
+synchronised board instead of its HAL tick (milliseconds since 1970), so
+the CSV files of several boards merge on one time axis; frames before the
+sync has locked are dropped.
+
+Only the standard library is needed; ``--plot`` uses matplotlib.
+
+Usage:
+    uart_telemetry_decode.py /dev/ttyACM0|capture.bin [--batch [--elf firmware.elf]] [--csv out.csv] [--plot]
+    uart_telemetry_decode.py /dev/ttyACM0 --batch --sync [--host-time] [--csv out.csv]
+"""
+
+import argparse
+import csv
+import os
+import struct
+import sys
+import time
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "dlog"))
+import dlog_decode  # noqa: E402
+
+SYNC = 0xA5
+HEADER = 7
+MAX_PAYLOAD = 32
+
+# Channels and payload layout, see uart_telemetry.h
+CHANNELS = {
+    1: ("fan", "<HHH", ("target", "rpm", "duty_0.01%")),
+    2: ("potis", "<HH", ("poti_1", "poti_2")),
+    3: ("env", "<iII", ("temp_0.01C", "press_pa", "hum_0.001%")),
+}
+
+
+def fletcher16(data):
+    sum1 = sum2 = 0
+    for byte in data:
+        sum1 = (sum1 + byte) % 255
+        sum2 = (sum2 + sum1) % 255
+    return sum1, sum2
+
+
+def frames(stream, stats):
+    """Yields (tick, channel, payload) for every frame with a valid sum."""
+    data = bytearray()
+    while True:
+        chunk = stream.read(4096)
+        if not chunk:
+            return
+        data += chunk
+
+        pos = 0
+        while len(data) - pos >= HEADER:
+            if data[pos] != SYNC or data[pos + 2] > MAX_PAYLOAD:
+                pos += 1
+                stats["skipped"] += 1
+                continue
+            size = HEADER + data[pos + 2] + 2
+            if len(data) - pos < size:
+                break
+            frame = data[pos:pos + size]
+            if tuple(frame[-2:]) != fletcher16(frame[1:-2]):
+                pos += 1
+                stats["skipped"] += 1
+                continue
+            tick = struct.unpack_from("<I", frame, 3)[0]
+            yield tick, frame[1], bytes(frame[HEADER:-2])
+            stats["frames"] += 1
+            pos += size
+        del data[:pos]
+
+
+def single_frames(stream, stats):
+    """Yields (time_ms, channel, field, value) for every field of every frame."""
+    for tick, channel, payload in frames(stream, stats):
+        name, layout, fields = CHANNELS.get(channel, ("ch_%d" % channel, None, None))
+        if layout is None or len(payload) != struct.calcsize(layout):
+            yield tick, name, "raw", payload.hex()
+            continue
+        for field, value in zip(fields, struct.unpack(layout, payload)):
+            yield tick, name, field, value
+
+
+# Records of the batched frames, see telemetry_batch.h
+TLV_SEQ, TLV_TICK, TLV_PERIOD, TLV_TEXT, TLV_DLOG = 0x01, 0x02, 0x03, 0x40, 0x41
+TLV_HOST_US, TLV_DEADLINE, TLV_SYNC = 0x04, 0x50, 0x60
+DEADLINE_FIELDS = ("runs", "misses", "overruns", "response_us", "exec_us")
+BATCH_SAMPLES = {
+    0x11: ("fan", "<H", ("rpm",)),
+    0x20: ("potis", "<HH", ("poti_1", "poti_2")),
+    0x30: ("env", "<iII", ("temp_0.01C", "press_pa", "hum_0.001%")),
+}
+
+
+def crc32_stm32(data):
+    """CRC unit of the STM32F4: 0x04C11DB7, init 0xFFFFFFFF, little endian words, zero padded."""
+    data = bytes(data) + bytes(-len(data) % 4)
+    crc = 0xFFFFFFFF
+    for (word,) in struct.iter_unpack("<I", data):
+        crc ^= word
+        for _ in range(32):
+            crc = ((crc << 1) ^ 0x04C11DB7) if crc & 0x80000000 else crc << 1
+        crc &= 0xFFFFFFFF
+    return crc
+
+
+def cobs_decode(block):
+    out = bytearray()
+    pos = 0
+    while pos < len(block):
+        code = block[pos]
+        if code == 0 or pos + code > len(block):
+            return None
+        out += block[pos + 1:pos + code]
+        pos += code
+        if code < 0xFF and pos < len(block):
+            out.append(0)
+    return bytes(out)
+
+
+def batches(stream, stats, strings=None, sync=None, host_time=False):
+    """Yields (time_ms, channel, field, value) for every sample of every valid frame.
+
+    sync(ping, arrival_us) is called for every clock ping, host_time takes
+    the sample times from TLV_HOST_US.
+    """
+    data = bytearray()
+    while True:
+        chunk = stream.read(4096)
+        arrival_us = time.time_ns() // 1000
+        if not chunk:
+            return
+        data += chunk
+
+        *blocks, data = data.split(b"\0")
+        for block in blocks:
+            frame = cobs_decode(block)
+            if frame is None or len(frame) < 4 or \
+                    struct.unpack_from("<I", frame, len(frame) - 4)[0] != crc32_stm32(frame[:-4]):
+                stats["skipped"] += len(block) + 1
+                continue
+            stats["frames"] += 1
+
+            records = {}
+            pos = 0
+            while pos + 2 <= len(frame) - 4:
+                records[frame[pos]] = frame[pos + 2:pos + 2 + frame[pos + 1]]
+                pos += 2 + frame[pos + 1]
+
+            if TLV_SYNC in records:
+                if sync is not None:
+                    sync(struct.unpack("<H", records[TLV_SYNC])[0], arrival_us)
+                stats["pings"] += 1
+                continue
+            tick = struct.unpack("<I", records.get(TLV_TICK, bytes(4)))[0]
+            period_us = struct.unpack("<I", records.get(TLV_PERIOD, bytes(4)))[0]
+            if host_time:
+                if TLV_HOST_US not in records:
+                    stats["unsynced"] += 1
+                    continue
+                tick = struct.unpack("<Q", records[TLV_HOST_US])[0] / 1000.0
+            if TLV_TEXT in records:
+                text = records[TLV_TEXT].decode("ascii", "replace")
+                sys.stderr.write(text + "\n")
+                yield tick, "shell", "text", text
+            for dlog_us, ident, values in dlog_decode.records(records.get(TLV_DLOG, b"")):
+                text = strings.format(ident, values) if strings else "id 0x%06x %s" % (ident, values)
+                sys.stderr.write("%d %s\n" % (dlog_us, text))
+                # Messages carry the microseconds of the system timebase
+                yield dlog_us / 1000.0, "dlog", "text", text
+            if TLV_DEADLINE in records:
+                value = records[TLV_DEADLINE]
+                yield tick, "deadline", "failed_windows", struct.unpack_from("<I", value)[0]
+                for step in range((len(value) - 4) // 20):
+                    for field, field_value in zip(DEADLINE_FIELDS, struct.unpack_from("<5I", value, 4 + step * 20)):
+                        yield tick, "deadline", "step%d.%s" % (step, field), field_value
+            if TLV_SEQ in records:
+                yield tick, "batch", "seq", struct.unpack("<H", records[TLV_SEQ])[0]
+            if 0x10 in records:
+                yield tick, "fan", "target", struct.unpack("<H", records[0x10])[0]
+            for tlv, (name, layout, fields) in BATCH_SAMPLES.items():
+                value = records.get(tlv, b"")
+                size = struct.calcsize(layout)
+                for index in range(len(value) // size):
+                    # Environment samples have their own rate, they share the tick
+                    time_ms = tick if tlv == 0x30 else tick + index * period_us / 1000.0
+                    for field, field_value in zip(fields, struct.unpack_from(layout, value, index * size)):
+                        yield time_ms, name, field, field_value
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("source", help="serial device or capture file")
+    parser.add_argument("--batch", action="store_true", help="COBS stuffed batch frames (telemetry_batch)")
+    parser.add_argument("--elf", help="firmware ELF file, strings of the dlog messages")
+    parser.add_argument("--sync", action="store_true", help="answer the clock pings of the board (serial device)")
+    parser.add_argument("--host-time", action="store_true", help="sample times from the host clock of the board")
+    parser.add_argument("--csv", help="CSV file, default: stdout")
+    parser.add_argument("--plot", action="store_true", help="plot the values after the end of the input")
+    args = parser.parse_args()
+
+    out = open(args.csv, "w", newline="") if args.csv else sys.stdout
+    writer = csv.writer(out)
+    writer.writerow(["time_ms", "channel", "field", "value"])
+
+    stats = {"frames": 0, "skipped": 0, "pings": 0, "unsynced": 0}
+    strings = dlog_decode.Strings(args.elf) if args.elf else None
+    series = {}
+    try:
+        with open(args.source, "r+b" if args.sync else "rb", buffering=0) as stream:
+            def sync(ping, arrival_us):
+                # t2 = arrival, t3 = t2 + hold, right before the write
+                hold_us = time.time_ns() // 1000 - arrival_us
+                stream.write(b"tm %d %d %d\n" % (ping, arrival_us, hold_us))
+
+            if args.batch:
+                decoded = batches(stream, stats, strings, sync if args.sync else None, args.host_time)
+            else:
+                decoded = single_frames(stream, stats)
+            for time_ms, name, field, value in decoded:
+                writer.writerow([time_ms, name, field, value])
+                if isinstance(value, int):
+                    series.setdefault("%s.%s" % (name, field), []).append((time_ms, value))
+                out.flush()
+    except KeyboardInterrupt:
+        pass
+
+    if out is not sys.stdout:
+        out.close()
+    sys.stderr.write("%d frames, %d bytes skipped, %d clock pings, %d frames before the sync\n"
+                     % (stats["frames"], stats["skipped"], stats["pings"], stats["unsynced"]))
+
+    if args.plot and series:
+        import matplotlib.pyplot as plt
+
+        fig, axes = plt.subplots(len(series), 1, sharex=True, squeeze=False)
+        for axis, (label, points) in zip(axes[:, 0], sorted(series.items())):
+            axis.step([p[0] for p in points], [p[1] for p in points], where="post")
+            axis.set_ylabel(label)
+        axes[-1, 0].set_xlabel("time [ms]")
+        plt.show()
+
+
+if __name__ == "__main__":
+    main()
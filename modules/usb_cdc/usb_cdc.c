@@ -0,0 +1,817 @@
+/**
+ ******************************************************************************
+ * @file        usb_cdc.c
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       USB CDC-ACM full speed device with double buffered bulk IN
+ *
+ * Functionality:
+ * - Minimal device stack on HAL_PCD: descriptors, endpoint 0 control
+ *   transfers (data stages longer than one packet, zero length packet
+ *   where the host asked for more), CDC-ACM line coding and DTR
+ * - Two transmit buffers: writers fill one with interrupts masked (copy
+ *   only), the USB interrupt sends the other and swaps them when the
+ *   transfer is complete or, with the endpoint idle, on start of frame
+ * - A transfer that ends on a packet boundary is closed by a zero length
+ *   packet, the host returns the data without waiting for more
+ * - Received packets are handed to the callback, the endpoint is armed
+ *   again right after it
+ *
+ * Resources:
+ * - PB14 (OTG_HS_DM, AF12), PB15 (OTG_HS_DP, AF12), OTG_HS core with the
+ *   embedded full speed PHY, VBUS sensing off (PB13 stays free)
+ * - OTG_HS_IRQHandler
+ ******************************************************************************
+ */
+
+#include "usb_cdc.h"
+#include "clock/clock.h"
+#include "utils/utils.h"
+#include <string.h>
+
+/* Private Preprocessor Defines -------------------------------------------- */
+/**
+ * @brief Endpoints: control, bulk data out / in, interrupt notification.
+ */
+#define USB_CDC_EP0_SIZE            64U
+#define USB_CDC_EP_DATA_OUT         0x01U
+#define USB_CDC_EP_DATA_IN          0x81U
+#define USB_CDC_EP_NOTIFY           0x82U
+#define USB_CDC_NOTIFY_SIZE         8U
+
+/**
+ * @brief FIFO RAM of the OTG_HS core in 32 bit words (1024 in total):
+ *        shared receive FIFO, transmit FIFO per IN endpoint. The bulk IN
+ *        FIFO holds 16 packets, enough for a full frame of back to back
+ *        packets without waiting for the interrupt.
+ */
+#define USB_CDC_RX_FIFO_WORDS       0x80U
+#define USB_CDC_TX0_FIFO_WORDS      0x20U
+#define USB_CDC_TX1_FIFO_WORDS      0x100U
+#define USB_CDC_TX2_FIFO_WORDS      0x10U
+
+/**
+ * @brief Standard requests (USB 2.0, chapter 9.4).
+ */
+#define USB_CDC_REQ_GET_STATUS          0x00U
+#define USB_CDC_REQ_CLEAR_FEATURE       0x01U
+#define USB_CDC_REQ_SET_FEATURE         0x03U
+#define USB_CDC_REQ_SET_ADDRESS         0x05U
+#define USB_CDC_REQ_GET_DESCRIPTOR      0x06U
+#define USB_CDC_REQ_GET_CONFIGURATION   0x08U
+#define USB_CDC_REQ_SET_CONFIGURATION   0x09U
+#define USB_CDC_REQ_GET_INTERFACE       0x0AU
+#define USB_CDC_REQ_SET_INTERFACE       0x0BU
+
+/**
+ * @brief CDC-ACM class requests (PSTN 1.2, chapter 6.3).
+ */
+#define USB_CDC_REQ_SET_LINE_CODING         0x20U
+#define USB_CDC_REQ_GET_LINE_CODING         0x21U
+#define USB_CDC_REQ_SET_CONTROL_LINE_STATE  0x22U
+#define USB_CDC_REQ_SEND_BREAK              0x23U
+
+/**
+ * @brief Fields of bmRequestType.
+ */
+#define USB_CDC_REQ_TYPE_MASK           0x60U
+#define USB_CDC_REQ_TYPE_STANDARD       0x00U
+#define USB_CDC_REQ_TYPE_CLASS          0x20U
+#define USB_CDC_REQ_RECIPIENT_MASK      0x1FU
+#define USB_CDC_REQ_RECIPIENT_ENDPOINT  0x02U
+
+/**
+ * @brief Descriptor types, feature selector ENDPOINT_HALT.
+ */
+#define USB_CDC_DESC_DEVICE             0x01U
+#define USB_CDC_DESC_CONFIGURATION      0x02U
+#define USB_CDC_DESC_STRING             0x03U
+#define USB_CDC_FEATURE_ENDPOINT_HALT   0x00U
+
+/**
+ * @brief String descriptor indices, longest string in characters.
+ */
+#define USB_CDC_STRING_MANUFACTURER     1U
+#define USB_CDC_STRING_PRODUCT          2U
+#define USB_CDC_STRING_SERIAL           3U
+#define USB_CDC_STRING_MAX_CHARS        31U
+
+/**
+ * @brief Idle, data stage in either direction, status stage.
+ */
+#define USB_CDC_EP0_IDLE                0U
+#define USB_CDC_EP0_DATA_IN             1U
+#define USB_CDC_EP0_DATA_OUT            2U
+#define USB_CDC_EP0_STATUS              3U
+
+/* Static module variables -------------------------------------------------- */
+static PCD_HandleTypeDef g_usb_cdc_pcd;
+
+/**
+ * @brief Device descriptor: CDC class, ST virtual COM port IDs.
+ */
+static const uint8_t g_u8_usb_cdc_device_desc[18] = {
+    18u, USB_CDC_DESC_DEVICE,
+    0x00u, 0x02u,                       /* bcdUSB 2.00                         */
+    0x02u, 0x00u, 0x00u,                /* Communications device class         */
+    USB_CDC_EP0_SIZE,
+    0x83u, 0x04u,                       /* idVendor 0x0483                     */
+    0x40u, 0x57u,                       /* idProduct 0x5740                    */
+    0x00u, 0x02u,                       /* bcdDevice 2.00                      */
+    USB_CDC_STRING_MANUFACTURER, USB_CDC_STRING_PRODUCT, USB_CDC_STRING_SERIAL,
+    1u                                  /* One configuration                   */
+};
+
+/**
+ * @brief Configuration: communication interface with the notification
+ *        endpoint, data interface with both bulk endpoints.
+ */
+static const uint8_t g_u8_usb_cdc_config_desc[67] = {
+    9u, USB_CDC_DESC_CONFIGURATION, 67u, 0u, 2u, 1u, 0u,
+    0x80u,                              /* Bus powered                         */
+    50u,                                /* 100 mA                              */
+
+    9u, 0x04u, 0u, 0u, 1u, 0x02u, 0x02u, 0x01u, 0u,    /* Interface 0: ACM     */
+    5u, 0x24u, 0x00u, 0x10u, 0x01u,     /* Header, CDC 1.10                    */
+    5u, 0x24u, 0x01u, 0x00u, 1u,        /* Call management, data interface 1   */
+    4u, 0x24u, 0x02u, 0x02u,            /* ACM: line coding and line state     */
+    5u, 0x24u, 0x06u, 0u, 1u,           /* Union: master 0, slave 1            */
+    7u, 0x05u, USB_CDC_EP_NOTIFY, 0x03u, USB_CDC_NOTIFY_SIZE, 0u, 16u,
+
+    9u, 0x04u, 1u, 0u, 2u, 0x0Au, 0x00u, 0x00u, 0u,    /* Interface 1: data    */
+    7u, 0x05u, USB_CDC_EP_DATA_OUT, 0x02u, USB_CDC_PACKET_SIZE, 0u, 0u,
+    7u, 0x05u, USB_CDC_EP_DATA_IN, 0x02u, USB_CDC_PACKET_SIZE, 0u, 0u
+};
+
+/**
+ * @brief Language IDs: English (United States).
+ */
+static const uint8_t g_u8_usb_cdc_language_desc[4] = { 4u, USB_CDC_DESC_STRING, 0x09u, 0x04u };
+
+/**
+ * @brief Endpoint 0: data stage buffer, remaining bytes of an IN data
+ *        stage, zero length packet pending, state. USB interrupt only.
+ */
+static uint8_t g_u8_usb_cdc_ep0_buffer[2u + 2u * USB_CDC_STRING_MAX_CHARS] __ALIGNED(4);
+static const uint8_t *g_pu8_usb_cdc_ep0_data;
+static uint16_t g_u16_usb_cdc_ep0_remaining;
+static uint8_t g_u8_usb_cdc_ep0_zlp;
+static uint8_t g_u8_usb_cdc_ep0_state = USB_CDC_EP0_IDLE;
+
+/**
+ * @brief Line coding as set by the host (not used, the data rate is that
+ *        of the bus), 921600 baud 8N1 until then.
+ */
+static uint8_t g_u8_usb_cdc_line_coding[7] = { 0x00u, 0x10u, 0x0Eu, 0x00u, 0u, 0u, 8u };
+
+/**
+ * @brief Active configuration and DTR state.
+ */
+static uint8_t g_u8_usb_cdc_config = 0u;
+static volatile uint8_t g_u8_usb_cdc_open = 0u;
+
+/**
+ * @brief Transmit buffers. Fill index and length: writers with interrupts
+ *        masked and the swap; IN length (0: endpoint idle) and zero length
+ *        packet flag: USB interrupt only.
+ */
+static uint8_t g_u8_usb_cdc_tx_buffer[2][USB_CDC_TX_BUFFER_SIZE] __ALIGNED(4);
+static uint8_t g_u8_usb_cdc_tx_fill = 0u;
+static uint32_t g_u32_usb_cdc_tx_fill_length = 0u;
+static uint32_t g_u32_usb_cdc_in_length = 0u;
+static uint8_t g_u8_usb_cdc_in_zlp = 0u;
+static uint16_t g_u16_usb_cdc_seq = 0u;
+
+/**
+ * @brief Receive packet.
+ */
+static uint8_t g_u8_usb_cdc_rx_buffer[USB_CDC_PACKET_SIZE] __ALIGNED(4);
+
+static usb_cdc_rx_callback_t g_usb_cdc_rx_callback = NULL;
+static usb_cdc_stats_t g_usb_cdc_stats;
+
+/* Static function prototypes ---------------------------------------------- */
+static HAL_StatusTypeDef usb_cdc_put(const uint8_t *pu8_header, uint16_t u16_header_length,
+                                     const void *data, uint16_t u16_length);
+static void usb_cdc_tx_submit(void);
+static void usb_cdc_set_open(uint8_t u8_open);
+static void usb_cdc_configure(uint8_t u8_config);
+static void usb_cdc_standard_request(const uint8_t *pu8_setup);
+static void usb_cdc_class_request(const uint8_t *pu8_setup);
+static void usb_cdc_get_descriptor(uint16_t u16_value, uint16_t u16_length);
+static uint16_t usb_cdc_string(uint8_t u8_index, uint8_t *pu8_desc);
+static void usb_cdc_ep0_send(const uint8_t *pu8_data, uint16_t u16_size, uint16_t u16_requested);
+static void usb_cdc_ep0_continue(void);
+static void usb_cdc_ep0_status(void);
+static void usb_cdc_ep0_stall(void);
+
+/* Public functions --------------------------------------------------------- */
+HAL_StatusTypeDef usb_cdc_init(void)
+{
+    GPIO_InitTypeDef gpio_init_struct;
+
+    /* 48 MHz from PLLQ = 7 needs the 336 MHz VCO */
+    if (clock_get_profile() != CLOCK_PROFILE_168MHZ) {
+        return HAL_ERROR;
+    }
+
+    __HAL_RCC_GPIOB_CLK_ENABLE();
+    __HAL_RCC_USB_OTG_HS_CLK_ENABLE();
+    /* No ULPI PHY: its clock must not be requested in sleep mode either */
+    __HAL_RCC_USB_OTG_HS_ULPI_CLK_SLEEP_DISABLE();
+
+    gpio_init_struct.Pin       = GPIO_PIN_14 | GPIO_PIN_15;
+    gpio_init_struct.Mode      = GPIO_MODE_AF_PP;
+    gpio_init_struct.Pull      = GPIO_NOPULL;
+    gpio_init_struct.Speed     = GPIO_SPEED_FREQ_VERY_HIGH;
+    gpio_init_struct.Alternate = GPIO_AF12_OTG_HS_FS;
+    HAL_GPIO_Init(GPIOB, &gpio_init_struct);
+
+    memset(&g_usb_cdc_pcd, 0, sizeof(g_usb_cdc_pcd));
+    g_usb_cdc_pcd.Instance                      = USB_OTG_HS;
+    g_usb_cdc_pcd.Init.dev_endpoints            = 6u;
+    g_usb_cdc_pcd.Init.speed                    = PCD_SPEED_FULL;
+    g_usb_cdc_pcd.Init.dma_enable               = 0u;
+    g_usb_cdc_pcd.Init.phy_itface               = USB_OTG_EMBEDDED_PHY;
+    g_usb_cdc_pcd.Init.Sof_enable               = 1u;
+    g_usb_cdc_pcd.Init.low_power_enable         = 0u;
+    g_usb_cdc_pcd.Init.lpm_enable               = 0u;
+    g_usb_cdc_pcd.Init.battery_charging_enable  = 0u;
+    g_usb_cdc_pcd.Init.vbus_sensing_enable      = 0u;
+    g_usb_cdc_pcd.Init.use_dedicated_ep1        = 0u;
+    g_usb_cdc_pcd.Init.use_external_vbus        = 0u;
+
+    if (HAL_PCD_Init(&g_usb_cdc_pcd) != HAL_OK) {
+        return HAL_ERROR;
+    }
+    HAL_PCDEx_SetRxFiFo(&g_usb_cdc_pcd, USB_CDC_RX_FIFO_WORDS);
+    HAL_PCDEx_SetTxFiFo(&g_usb_cdc_pcd, 0u, USB_CDC_TX0_FIFO_WORDS);
+    HAL_PCDEx_SetTxFiFo(&g_usb_cdc_pcd, 1u, USB_CDC_TX1_FIFO_WORDS);
+    HAL_PCDEx_SetTxFiFo(&g_usb_cdc_pcd, 2u, USB_CDC_TX2_FIFO_WORDS);
+
+    g_u8_usb_cdc_config          = 0u;
+    g_u8_usb_cdc_open            = 0u;
+    g_u8_usb_cdc_tx_fill         = 0u;
+    g_u32_usb_cdc_tx_fill_length = 0u;
+    g_u32_usb_cdc_in_length      = 0u;
+    g_u8_usb_cdc_in_zlp          = 0u;
+    memset(&g_usb_cdc_stats, 0, sizeof(g_usb_cdc_stats));
+
+    HAL_NVIC_SetPriority(OTG_HS_IRQn, USB_CDC_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(OTG_HS_IRQn);
+
+    return HAL_PCD_Start(&g_usb_cdc_pcd);
+}
+
+uint8_t usb_cdc_is_open(void)
+{
+    return g_u8_usb_cdc_open;
+}
+
+HAL_StatusTypeDef usb_cdc_write(const void *data, uint16_t u16_length)
+{
+    uint32_t u32_primask = __get_PRIMASK();
+    HAL_StatusTypeDef status;
+
+    __disable_irq();
+    status = usb_cdc_put(NULL, 0u, data, u16_length);
+    __set_PRIMASK(u32_primask);
+
+    return status;
+}
+
+HAL_StatusTypeDef usb_cdc_send_block(usb_cdc_block_t type, const void *data, uint16_t u16_length)
+{
+    uint8_t u8_header[USB_CDC_BLOCK_HEADER_SIZE];
+    uint32_t u32_cycles = utils_now_cycles();
+    uint32_t u32_primask;
+    HAL_StatusTypeDef status;
+
+    u8_header[0] = USB_CDC_BLOCK_SYNC;
+    u8_header[1] = (uint8_t)type;
+    memcpy(&u8_header[4], &u16_length, 2u);
+    memcpy(&u8_header[6], &u32_cycles, 4u);
+
+    u32_primask = __get_PRIMASK();
+    __disable_irq();
+    /* Numbered under the lock, blocks of all writers get distinct numbers */
+    memcpy(&u8_header[2], &g_u16_usb_cdc_seq, 2u);
+    g_u16_usb_cdc_seq++;
+    status = usb_cdc_put(u8_header, USB_CDC_BLOCK_HEADER_SIZE, data, u16_length);
+    __set_PRIMASK(u32_primask);
+
+    return status;
+}
+
+void usb_cdc_set_rx_callback(usb_cdc_rx_callback_t callback)
+{
+    g_usb_cdc_rx_callback = callback;
+}
+
+void usb_cdc_get_stats(usb_cdc_stats_t *stats)
+{
+    uint32_t u32_primask = __get_PRIMASK();
+
+    __disable_irq();
+    *stats = g_usb_cdc_stats;
+    __set_PRIMASK(u32_primask);
+}
+
+/**
+ * @brief Bus reset: endpoint 0 only, unconfigured.
+ *
+ * @param hpcd PCD handle
+ * @return None
+ */
+void HAL_PCD_ResetCallback(PCD_HandleTypeDef *hpcd)
+{
+    HAL_PCD_EP_Open(hpcd, 0x00u, USB_CDC_EP0_SIZE, EP_TYPE_CTRL);
+    HAL_PCD_EP_Open(hpcd, 0x80u, USB_CDC_EP0_SIZE, EP_TYPE_CTRL);
+
+    g_u8_usb_cdc_ep0_state  = USB_CDC_EP0_IDLE;
+    g_u8_usb_cdc_config     = 0u;
+    g_u32_usb_cdc_in_length = 0u;
+    g_u8_usb_cdc_in_zlp     = 0u;
+    usb_cdc_set_open(0u);
+    g_usb_cdc_stats.u32_resets++;
+}
+
+/**
+ * @brief SETUP packet on endpoint 0.
+ *
+ * @param hpcd PCD handle
+ * @return None
+ */
+void HAL_PCD_SetupStageCallback(PCD_HandleTypeDef *hpcd)
+{
+    const uint8_t *pu8_setup = (const uint8_t *)hpcd->Setup;
+
+    g_u8_usb_cdc_ep0_state = USB_CDC_EP0_IDLE;
+
+    switch (pu8_setup[0] & USB_CDC_REQ_TYPE_MASK) {
+        case USB_CDC_REQ_TYPE_STANDARD:
+            usb_cdc_standard_request(pu8_setup);
+            break;
+        case USB_CDC_REQ_TYPE_CLASS:
+            usb_cdc_class_request(pu8_setup);
+            break;
+        default:
+            usb_cdc_ep0_stall();
+            break;
+    }
+}
+
+/**
+ * @brief IN transfer complete: next packet of an endpoint 0 data stage,
+ *        next buffer on the bulk endpoint.
+ *
+ * @param hpcd  PCD handle
+ * @param epnum Endpoint number
+ * @return None
+ */
+void HAL_PCD_DataInStageCallback(PCD_HandleTypeDef *hpcd, uint8_t epnum)
+{
+    if (epnum == 0u) {
+        if (g_u8_usb_cdc_ep0_state != USB_CDC_EP0_DATA_IN) {
+            g_u8_usb_cdc_ep0_state = USB_CDC_EP0_IDLE;
+        } else if (g_u16_usb_cdc_ep0_remaining != 0u) {
+            usb_cdc_ep0_continue();
+        } else if (g_u8_usb_cdc_ep0_zlp) {
+            g_u8_usb_cdc_ep0_zlp = 0u;
+            HAL_PCD_EP_Transmit(hpcd, 0x80u, NULL, 0u);
+        } else {
+            /* Status stage: zero length OUT from the host */
+            HAL_PCD_EP_Receive(hpcd, 0x00u, NULL, 0u);
+            g_u8_usb_cdc_ep0_state = USB_CDC_EP0_STATUS;
+        }
+    } else if (epnum == (USB_CDC_EP_DATA_IN & 0x7Fu)) {
+        if (g_u8_usb_cdc_in_zlp) {
+            g_u8_usb_cdc_in_zlp = 0u;
+            HAL_PCD_EP_Transmit(hpcd, USB_CDC_EP_DATA_IN, NULL, 0u);
+            return;
+        }
+        g_u32_usb_cdc_in_length = 0u;
+        usb_cdc_tx_submit();
+    }
+}
+
+/**
+ * @brief OUT transfer complete: line coding on endpoint 0, data packet on
+ *        the bulk endpoint.
+ *
+ * @param hpcd  PCD handle
+ * @param epnum Endpoint number
+ * @return None
+ */
+void HAL_PCD_DataOutStageCallback(PCD_HandleTypeDef *hpcd, uint8_t epnum)
+{
+    uint16_t u16_length;
+
+    if (epnum == 0u) {
+        if (g_u8_usb_cdc_ep0_state == USB_CDC_EP0_DATA_OUT) {
+            /* SET_LINE_CODING is the only request with an OUT data stage */
+            memcpy(g_u8_usb_cdc_line_coding, g_u8_usb_cdc_ep0_buffer, sizeof(g_u8_usb_cdc_line_coding));
+            usb_cdc_ep0_status();
+        } else {
+            g_u8_usb_cdc_ep0_state = USB_CDC_EP0_IDLE;
+        }
+    } else if (epnum == USB_CDC_EP_DATA_OUT) {
+        u16_length = (uint16_t)HAL_PCD_EP_GetRxCount(hpcd, USB_CDC_EP_DATA_OUT);
+        g_usb_cdc_stats.u32_rx_bytes += u16_length;
+        if ((g_usb_cdc_rx_callback != NULL) && (u16_length != 0u)) {
+            g_usb_cdc_rx_callback(g_u8_usb_cdc_rx_buffer, u16_length);
+        }
+        HAL_PCD_EP_Receive(hpcd, USB_CDC_EP_DATA_OUT, g_u8_usb_cdc_rx_buffer, USB_CDC_PACKET_SIZE);
+    }
+}
+
+/**
+ * @brief Start of frame (1 ms): sends a partly filled buffer if the
+ *        endpoint is idle.
+ *
+ * @param hpcd PCD handle
+ * @return None
+ */
+void HAL_PCD_SOFCallback(PCD_HandleTypeDef *hpcd)
+{
+    (void)hpcd;
+
+    usb_cdc_tx_submit();
+}
+
+/**
+ * @brief USB interrupt (OTG_HS core in full speed mode).
+ *
+ * @return None
+ */
+void OTG_HS_IRQHandler(void)
+{
+    HAL_PCD_IRQHandler(&g_usb_cdc_pcd);
+}
+
+/* Static module functions -------------------------------------------------- */
+/**
+ * @brief Appends header and data to the fill buffer, interrupts masked.
+ *
+ * @param pu8_header        Header, NULL if u16_header_length is 0
+ * @param u16_header_length Header length
+ * @param data              Data
+ * @param u16_length        Data length
+ * @return HAL_OK, HAL_BUSY (no room, counted), HAL_ERROR (closed, too long)
+ */
+static HAL_StatusTypeDef usb_cdc_put(const uint8_t *pu8_header, uint16_t u16_header_length,
+                                     const void *data, uint16_t u16_length)
+{
+    uint32_t u32_total = (uint32_t)u16_header_length + u16_length;
+    uint8_t *pu8_dest;
+
+    if (!g_u8_usb_cdc_open || (u32_total > USB_CDC_TX_BUFFER_SIZE)) {
+        return HAL_ERROR;
+    }
+    if (g_u32_usb_cdc_tx_fill_length + u32_total > USB_CDC_TX_BUFFER_SIZE) {
+        g_usb_cdc_stats.u32_dropped++;
+        return HAL_BUSY;
+    }
+
+    pu8_dest = &g_u8_usb_cdc_tx_buffer[g_u8_usb_cdc_tx_fill][g_u32_usb_cdc_tx_fill_length];
+    if (u16_header_length != 0u) {
+        memcpy(pu8_dest, pu8_header, u16_header_length);
+    }
+    memcpy(pu8_dest + u16_header_length, data, u16_length);
+    g_u32_usb_cdc_tx_fill_length += u32_total;
+    g_usb_cdc_stats.u32_blocks++;
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Sends the fill buffer if the endpoint is idle and swaps the
+ *        buffers (USB interrupt only).
+ *
+ * @return None
+ */
+static void usb_cdc_tx_submit(void)
+{
+    uint32_t u32_primask;
+    uint32_t u32_length;
+    uint8_t *pu8_buffer;
+
+    if ((g_u32_usb_cdc_in_length != 0u) || (g_u8_usb_cdc_config == 0u)) {
+        return;
+    }
+
+    u32_primask = __get_PRIMASK();
+    __disable_irq();
+    u32_length = g_u32_usb_cdc_tx_fill_length;
+    pu8_buffer = g_u8_usb_cdc_tx_buffer[g_u8_usb_cdc_tx_fill];
+    if (u32_length != 0u) {
+        g_u8_usb_cdc_tx_fill ^= 1u;
+        g_u32_usb_cdc_tx_fill_length = 0u;
+    }
+    __set_PRIMASK(u32_primask);
+
+    if (u32_length == 0u) {
+        return;
+    }
+
+    g_u32_usb_cdc_in_length = u32_length;
+    g_u8_usb_cdc_in_zlp     = ((u32_length % USB_CDC_PACKET_SIZE) == 0u) ? 1u : 0u;
+    g_usb_cdc_stats.u32_transfers++;
+    g_usb_cdc_stats.u32_tx_bytes += u32_length;
+    HAL_PCD_EP_Transmit(&g_usb_cdc_pcd, USB_CDC_EP_DATA_IN, pu8_buffer, u32_length);
+}
+
+/**
+ * @brief Sets the DTR state, closing discards the unsent fill buffer.
+ *
+ * @param u8_open 1 open, 0 closed
+ * @return None
+ */
+static void usb_cdc_set_open(uint8_t u8_open)
+{
+    uint32_t u32_primask = __get_PRIMASK();
+
+    __disable_irq();
+    g_u8_usb_cdc_open = u8_open;
+    if (!u8_open) {
+        g_u32_usb_cdc_tx_fill_length = 0u;
+    }
+    __set_PRIMASK(u32_primask);
+}
+
+/**
+ * @brief SET_CONFIGURATION: opens or closes the CDC endpoints.
+ *
+ * @param u8_config 1 configured, 0 address state
+ * @return None
+ */
+static void usb_cdc_configure(uint8_t u8_config)
+{
+    if ((u8_config != 0u) && (g_u8_usb_cdc_config == 0u)) {
+        HAL_PCD_EP_Open(&g_usb_cdc_pcd, USB_CDC_EP_DATA_IN, USB_CDC_PACKET_SIZE, EP_TYPE_BULK);
+        HAL_PCD_EP_Open(&g_usb_cdc_pcd, USB_CDC_EP_DATA_OUT, USB_CDC_PACKET_SIZE, EP_TYPE_BULK);
+        HAL_PCD_EP_Open(&g_usb_cdc_pcd, USB_CDC_EP_NOTIFY, USB_CDC_NOTIFY_SIZE, EP_TYPE_INTR);
+        HAL_PCD_EP_Receive(&g_usb_cdc_pcd, USB_CDC_EP_DATA_OUT, g_u8_usb_cdc_rx_buffer, USB_CDC_PACKET_SIZE);
+        g_u32_usb_cdc_in_length = 0u;
+        g_u8_usb_cdc_in_zlp     = 0u;
+    } else if ((u8_config == 0u) && (g_u8_usb_cdc_config != 0u)) {
+        HAL_PCD_EP_Close(&g_usb_cdc_pcd, USB_CDC_EP_DATA_IN);
+        HAL_PCD_EP_Close(&g_usb_cdc_pcd, USB_CDC_EP_DATA_OUT);
+        HAL_PCD_EP_Close(&g_usb_cdc_pcd, USB_CDC_EP_NOTIFY);
+        usb_cdc_set_open(0u);
+    }
+    g_u8_usb_cdc_config = u8_config;
+}
+
+/**
+ * @brief Standard requests of the device, its interfaces and endpoints.
+ *
+ * @param pu8_setup SETUP packet
+ * @return None
+ */
+static void usb_cdc_standard_request(const uint8_t *pu8_setup)
+{
+    uint16_t u16_value  = (uint16_t)(pu8_setup[2] | (pu8_setup[3] << 8));
+    uint16_t u16_index  = (uint16_t)(pu8_setup[4] | (pu8_setup[5] << 8));
+    uint16_t u16_length = (uint16_t)(pu8_setup[6] | (pu8_setup[7] << 8));
+    uint8_t u8_endpoint_request =
+        ((pu8_setup[0] & USB_CDC_REQ_RECIPIENT_MASK) == USB_CDC_REQ_RECIPIENT_ENDPOINT) ? 1u : 0u;
+
+    switch (pu8_setup[1]) {
+        case USB_CDC_REQ_GET_DESCRIPTOR:
+            usb_cdc_get_descriptor(u16_value, u16_length);
+            break;
+        case USB_CDC_REQ_SET_ADDRESS:
+            /* The core applies the address after the status stage */
+            HAL_PCD_SetAddress(&g_usb_cdc_pcd, (uint8_t)(u16_value & 0x7Fu));
+            usb_cdc_ep0_status();
+            break;
+        case USB_CDC_REQ_GET_CONFIGURATION:
+            g_u8_usb_cdc_ep0_buffer[0] = g_u8_usb_cdc_config;
+            usb_cdc_ep0_send(g_u8_usb_cdc_ep0_buffer, 1u, u16_length);
+            break;
+        case USB_CDC_REQ_SET_CONFIGURATION:
+            if (u16_value > 1u) {
+                usb_cdc_ep0_stall();
+            } else {
+                usb_cdc_configure((uint8_t)u16_value);
+                usb_cdc_ep0_status();
+            }
+            break;
+        case USB_CDC_REQ_GET_STATUS:
+            /* Bus powered, no remote wakeup, endpoints not halted */
+            g_u8_usb_cdc_ep0_buffer[0] = 0u;
+            g_u8_usb_cdc_ep0_buffer[1] = 0u;
+            usb_cdc_ep0_send(g_u8_usb_cdc_ep0_buffer, 2u, u16_length);
+            break;
+        case USB_CDC_REQ_CLEAR_FEATURE:
+        case USB_CDC_REQ_SET_FEATURE:
+            if (u8_endpoint_request && (u16_value == USB_CDC_FEATURE_ENDPOINT_HALT) &&
+                ((u16_index & 0x7Fu) != 0u)) {
+                if (pu8_setup[1] == USB_CDC_REQ_SET_FEATURE) {
+                    HAL_PCD_EP_SetStall(&g_usb_cdc_pcd, (uint8_t)u16_index);
+                } else {
+                    HAL_PCD_EP_ClrStall(&g_usb_cdc_pcd, (uint8_t)u16_index);
+                }
+            }
+            usb_cdc_ep0_status();
+            break;
+        case USB_CDC_REQ_GET_INTERFACE:
+            g_u8_usb_cdc_ep0_buffer[0] = 0u;
+            usb_cdc_ep0_send(g_u8_usb_cdc_ep0_buffer, 1u, u16_length);
+            break;
+        case USB_CDC_REQ_SET_INTERFACE:
+            usb_cdc_ep0_status();
+            break;
+        default:
+            usb_cdc_ep0_stall();
+            break;
+    }
+}
+
+/**
+ * @brief CDC-ACM requests of the communication interface.
+ *
+ * @param pu8_setup SETUP packet
+ * @return None
+ */
+static void usb_cdc_class_request(const uint8_t *pu8_setup)
+{
+    uint16_t u16_value  = (uint16_t)(pu8_setup[2] | (pu8_setup[3] << 8));
+    uint16_t u16_length = (uint16_t)(pu8_setup[6] | (pu8_setup[7] << 8));
+
+    switch (pu8_setup[1]) {
+        case USB_CDC_REQ_SET_LINE_CODING:
+            HAL_PCD_EP_Receive(&g_usb_cdc_pcd, 0x00u, g_u8_usb_cdc_ep0_buffer, sizeof(g_u8_usb_cdc_line_coding));
+            g_u8_usb_cdc_ep0_state = USB_CDC_EP0_DATA_OUT;
+            break;
+        case USB_CDC_REQ_GET_LINE_CODING:
+            usb_cdc_ep0_send(g_u8_usb_cdc_line_coding, sizeof(g_u8_usb_cdc_line_coding), u16_length);
+            break;
+        case USB_CDC_REQ_SET_CONTROL_LINE_STATE:
+            /* Bit 0: DTR, set while a terminal program has the port open */
+            usb_cdc_set_open((uint8_t)(u16_value & 0x01u));
+            usb_cdc_ep0_status();
+            break;
+        case USB_CDC_REQ_SEND_BREAK:
+            usb_cdc_ep0_status();
+            break;
+        default:
+            usb_cdc_ep0_stall();
+            break;
+    }
+}
+
+/**
+ * @brief GET_DESCRIPTOR; a device qualifier is not supported (full speed
+ *        only device) and stalls like every unknown descriptor.
+ *
+ * @param u16_value  Descriptor type (high byte) and index (low byte)
+ * @param u16_length Bytes requested by the host
+ * @return None
+ */
+static void usb_cdc_get_descriptor(uint16_t u16_value, uint16_t u16_length)
+{
+    uint8_t u8_index = (uint8_t)(u16_value & 0xFFu);
+    uint16_t u16_size;
+
+    switch (u16_value >> 8) {
+        case USB_CDC_DESC_DEVICE:
+            usb_cdc_ep0_send(g_u8_usb_cdc_device_desc, sizeof(g_u8_usb_cdc_device_desc), u16_length);
+            break;
+        case USB_CDC_DESC_CONFIGURATION:
+            usb_cdc_ep0_send(g_u8_usb_cdc_config_desc, sizeof(g_u8_usb_cdc_config_desc), u16_length);
+            break;
+        case USB_CDC_DESC_STRING:
+            if (u8_index == 0u) {
+                usb_cdc_ep0_send(g_u8_usb_cdc_language_desc, sizeof(g_u8_usb_cdc_language_desc), u16_length);
+                break;
+            }
+            u16_size = usb_cdc_string(u8_index, g_u8_usb_cdc_ep0_buffer);
+            if (u16_size == 0u) {
+                usb_cdc_ep0_stall();
+            } else {
+                usb_cdc_ep0_send(g_u8_usb_cdc_ep0_buffer, u16_size, u16_length);
+            }
+            break;
+        default:
+            usb_cdc_ep0_stall();
+            break;
+    }
+}
+
+/**
+ * @brief Builds a string descriptor (UTF-16LE); the serial number is the
+ *        96 bit unique ID of the device in hex.
+ *
+ * @param u8_index String index
+ * @param pu8_desc Destination, 2 + 2 * USB_CDC_STRING_MAX_CHARS bytes
+ * @return Descriptor length, 0 for an unknown index
+ */
+static uint16_t usb_cdc_string(uint8_t u8_index, uint8_t *pu8_desc)
+{
+    static const char ch_hex[] = "0123456789ABCDEF";
+    char ch_serial[25];
+    const char *pch_string;
+    uint16_t u16_chars = 0u;
+
+    switch (u8_index) {
+        case USB_CDC_STRING_MANUFACTURER:
+            pch_string = "STMicroelectronics";
+            break;
+        case USB_CDC_STRING_PRODUCT:
+            pch_string = "STM32F429I-DISC1 Raw Stream";
+            break;
+        case USB_CDC_STRING_SERIAL:
+            for (uint32_t i = 0u; i < 12u; i++) {
+                uint8_t u8_byte = ((const uint8_t *)UID_BASE)[i];
+
+                ch_serial[2u * i]      = ch_hex[u8_byte >> 4];
+                ch_serial[2u * i + 1u] = ch_hex[u8_byte & 0x0Fu];
+            }
+            ch_serial[24] = '\0';
+            pch_string = ch_serial;
+            break;
+        default:
+            return 0u;
+    }
+
+    while ((pch_string[u16_chars] != '\0') && (u16_chars < USB_CDC_STRING_MAX_CHARS)) {
+        pu8_desc[2u + 2u * u16_chars]  = (uint8_t)pch_string[u16_chars];
+        pu8_desc[3u + 2u * u16_chars]  = 0u;
+        u16_chars++;
+    }
+    pu8_desc[0] = (uint8_t)(2u + 2u * u16_chars);
+    pu8_desc[1] = USB_CDC_DESC_STRING;
+
+    return pu8_desc[0];
+}
+
+/**
+ * @brief Starts an IN data stage on endpoint 0. The HAL sends one packet
+ *        per call on endpoint 0, the rest follows from the IN interrupt.
+ *
+ * @param pu8_data      Data, valid until the status stage
+ * @param u16_size      Data length
+ * @param u16_requested wLength of the request
+ * @return None
+ */
+static void usb_cdc_ep0_send(const uint8_t *pu8_data, uint16_t u16_size, uint16_t u16_requested)
+{
+    if (u16_size > u16_requested) {
+        u16_size = u16_requested;
+    }
+
+    g_pu8_usb_cdc_ep0_data      = pu8_data;
+    g_u16_usb_cdc_ep0_remaining = u16_size;
+    /* A short answer ending on a packet boundary needs an end marker */
+    g_u8_usb_cdc_ep0_zlp   = ((u16_size < u16_requested) && ((u16_size % USB_CDC_EP0_SIZE) == 0u)) ? 1u : 0u;
+    g_u8_usb_cdc_ep0_state = USB_CDC_EP0_DATA_IN;
+
+    if (u16_size == 0u) {
+        g_u8_usb_cdc_ep0_zlp = 0u;
+        HAL_PCD_EP_Transmit(&g_usb_cdc_pcd, 0x80u, NULL, 0u);
+    } else {
+        usb_cdc_ep0_continue();
+    }
+}
+
+/**
+ * @brief Sends the next packet of the endpoint 0 data stage.
+ *
+ * @return None
+ */
+static void usb_cdc_ep0_continue(void)
+{
+    uint16_t u16_packet = (g_u16_usb_cdc_ep0_remaining > USB_CDC_EP0_SIZE) ?
+                          USB_CDC_EP0_SIZE : g_u16_usb_cdc_ep0_remaining;
+    const uint8_t *pu8_packet = g_pu8_usb_cdc_ep0_data;
+
+    g_pu8_usb_cdc_ep0_data      += u16_packet;
+    g_u16_usb_cdc_ep0_remaining -= u16_packet;
+    HAL_PCD_EP_Transmit(&g_usb_cdc_pcd, 0x80u, (uint8_t *)pu8_packet, u16_packet);
+}
+
+/**
+ * @brief Status stage of a request without IN data: zero length IN.
+ *
+ * @return None
+ */
+static void usb_cdc_ep0_status(void)
+{
+    g_u8_usb_cdc_ep0_state = USB_CDC_EP0_STATUS;
+    HAL_PCD_EP_Transmit(&g_usb_cdc_pcd, 0x80u, NULL, 0u);
+}
+
+/**
+ * @brief Rejects a request, the stall ends with the next SETUP packet.
+ *
+ * @return None
+ */
+static void usb_cdc_ep0_stall(void)
+{
+    g_u8_usb_cdc_ep0_state = USB_CDC_EP0_IDLE;
+    HAL_PCD_EP_SetStall(&g_usb_cdc_pcd, 0x80u);
+    HAL_PCD_EP_SetStall(&g_usb_cdc_pcd, 0x00u);
+}
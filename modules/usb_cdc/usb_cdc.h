@@ -0,0 +1,172 @@
+/**
+ ******************************************************************************
+ * @file        usb_cdc.h
+ * @author      Mahmoud Mahmoud / Judy Abou Rmeh
+ * @date        14.10.2026
+ * @version     V1.0
+ * @brief       Public interface of the USB CDC-ACM streaming device.
+ *
+ * @details
+ * A full speed USB device on the user connector of the discovery board
+ * (CN6, OTG_HS core with its embedded full speed PHY) that enumerates as
+ * a virtual COM port without a driver. It carries raw data blocks, e.g.
+ * the ADC DMA halves and the tacho timestamps, at up to about 1 MB/s,
+ * far beyond the ST-LINK virtual COM port of uart_telemetry.
+ *
+ * Transmission is double buffered: writers append to one buffer while the
+ * bulk IN endpoint sends the other; the buffers swap on every completed
+ * transfer and, if the endpoint is idle, on every start of frame (1 ms).
+ * Writing only copies, the endpoint is only touched from the USB
+ * interrupt.
+ *
+ * ----------------------------------------------------------------------------
+ * 							### Functionality ###
+ *  - Enumeration, standard and CDC-ACM class requests on endpoint 0
+ *  - Bulk IN 0x81 / OUT 0x01 with 64 byte packets, notification 0x82
+ *  - Data is only sent while the host holds DTR (port opened), a closed
+ *    port drops the writes without counting them
+ *  - Writes are atomic and may come from any context; a write that finds
+ *    no room is dropped and counted, the caller is never delayed
+ *  - Blocks: sync, type, sequence number, length, DWT cycle timestamp,
+ *    data; little endian (usb_cdc_send_block())
+ *  - modules/usb_cdc/usb_cdc_decode.py writes the blocks of a capture or
+ *    the port to binary files per type
+ *
+ * The USB core needs a 48 MHz clock from the PLL Q output, which only
+ * CLOCK_PROFILE_168MHZ provides (336 MHz VCO / 7). STOP mode ends the
+ * connection, the sleep of the idle module does not.
+ *
+ ******************************************************************************
+ */
+
+#ifndef USB_CDC_USB_CDC_H_
+#define USB_CDC_USB_CDC_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "stm32f4xx.h"
+#include "irq/irq.h"
+
+/* Public Preprocessor Defines --------------------------------------------- */
+/**
+ * @brief 1 to stream the raw project data, used by the applications.
+ */
+#ifndef USB_CDC_ENABLE
+#define USB_CDC_ENABLE                  0
+#endif
+
+/**
+ * @brief Size of each of the two transmit buffers in bytes.
+ */
+#define USB_CDC_TX_BUFFER_SIZE          4096U
+
+/**
+ * @brief Packet size of the bulk endpoints (full speed maximum).
+ */
+#define USB_CDC_PACKET_SIZE             64U
+
+/**
+ * @brief First byte of every block.
+ */
+#define USB_CDC_BLOCK_SYNC              0x5AU
+
+/**
+ * @brief Bytes in front of the data of a block.
+ */
+#define USB_CDC_BLOCK_HEADER_SIZE       10U
+
+/**
+ * @brief NVIC priority of the USB interrupt (no kernel calls).
+ */
+#define USB_CDC_IRQ_PRIORITY            IRQ_CLASS_TRANSFER
+
+/* Public Type Definitions ------------------------------------------------- */
+/**
+ * @brief Block types.
+ */
+typedef enum {
+    USB_CDC_BLOCK_ADC_U16 = 1,      /**< Raw ADC half buffer, u16 per sample  */
+    USB_CDC_BLOCK_ADC_U32 = 2,      /**< Raw ADC half buffer, u32 per sample  */
+    USB_CDC_BLOCK_TACHO   = 3,      /**< Tacho edges, u32 TIM2 timestamps (us) */
+    USB_CDC_BLOCK_DATALOG = 4,      /**< Chunk of a datalog dump              */
+    USB_CDC_BLOCK_MIRROR  = 5,      /**< Display mirror packet (modules/mirror) */
+    USB_CDC_BLOCK_USER    = 16      /**< First type for the application       */
+} usb_cdc_block_t;
+
+/**
+ * @brief Called from the USB interrupt for every received packet.
+ *
+ * @param pu8_data  Packet, valid during the call only
+ * @param u16_length Packet length
+ */
+typedef void (*usb_cdc_rx_callback_t)(const uint8_t *pu8_data, uint16_t u16_length);
+
+/**
+ * @brief Counters since usb_cdc_init().
+ */
+typedef struct {
+    uint32_t u32_blocks;        /**< Blocks and writes copied into a buffer */
+    uint32_t u32_dropped;       /**< Writes dropped, both buffers busy      */
+    uint32_t u32_transfers;     /**< Bulk IN transfers started              */
+    uint32_t u32_tx_bytes;      /**< Bytes handed to the endpoint           */
+    uint32_t u32_rx_bytes;      /**< Bytes received                         */
+    uint32_t u32_resets;        /**< Bus resets                             */
+} usb_cdc_stats_t;
+
+/* Public Function Prototypes ---------------------------------------------- */
+/**
+ * @brief Configures PB14 / PB15, the OTG_HS core in full speed mode and
+ *        connects to the host.
+ *
+ * @return HAL_OK, HAL_ERROR if the clock profile has no 48 MHz USB clock
+ *         or the core can not be set up
+ */
+HAL_StatusTypeDef usb_cdc_init(void);
+
+/**
+ * @brief Returns 1 while the device is configured and the host holds DTR.
+ *
+ * @return 1 open, 0 closed
+ */
+uint8_t usb_cdc_is_open(void);
+
+/**
+ * @brief Queues bytes as they are.
+ *
+ * @param data       Bytes
+ * @param u16_length Length, at most USB_CDC_TX_BUFFER_SIZE
+ * @return HAL_OK, HAL_BUSY if there is no room (dropped),
+ *         HAL_ERROR if the port is closed or the data too long
+ */
+HAL_StatusTypeDef usb_cdc_write(const void *data, uint16_t u16_length);
+
+/**
+ * @brief Queues one block: header and data in the same transfer.
+ *
+ * The sequence number counts every block, dropped ones included, so a
+ * gap shows a loss.
+ *
+ * @param type       Block type
+ * @param data       Data
+ * @param u16_length Data length, at most
+ *                   USB_CDC_TX_BUFFER_SIZE - USB_CDC_BLOCK_HEADER_SIZE
+ * @return See usb_cdc_write()
+ */
+HAL_StatusTypeDef usb_cdc_send_block(usb_cdc_block_t type, const void *data, uint16_t u16_length);
+
+/**
+ * @brief Installs the notification for received packets (NULL: none).
+ *
+ * @param callback Function, interrupt context
+ * @return None
+ */
+void usb_cdc_set_rx_callback(usb_cdc_rx_callback_t callback);
+
+/**
+ * @brief Copies the counters.
+ *
+ * @param stats Destination
+ * @return None
+ */
+void usb_cdc_get_stats(usb_cdc_stats_t *stats);
+
+#endif /* USB_CDC_USB_CDC_H_ */
@@ -0,0 +1,111 @@
+#!/usr/bin/env python3
+"""Decoder for the raw data blocks of modules/usb_cdc.
+
+Reads a capture of the USB virtual COM port, or the port itself (Linux:
+/dev/ttyACM*, opening it sets DTR and starts the stream), and writes the
+blocks per type into CSV files: the interleaved ADC samples one scan per
+line, the tacho timestamps one edge per line. Every line carries the
+time of its block in seconds (DWT cycles / --clock). Datalog dump chunks
+are joined into PREFIX_datalog.bin for datalog_decode.py. Gaps in the
+sequence numbers are counted as lost blocks.
+
+Only the standard library is needed.
+
+Usage:
+    usb_cdc_decode.py /dev/ttyACM1|capture.bin [--out PREFIX] [--clock 168e6]
+"""
+
+import argparse
+import csv
+import struct
+import sys
+import time
+
+SYNC = 0x5A
+HEADER = struct.Struct("<BBHHI")    # sync, type, sequence, length, cycles
+MAX_LENGTH = 4096 - HEADER.size
+
+# Block types, see usb_cdc.h
+ADC_U16, ADC_U32, TACHO, DATALOG = 1, 2, 3, 4
+
+
+def blocks(stream, stats):
+    """Yields (type, sequence, cycles, data) for every block."""
+    data = bytearray()
+    while True:
+        chunk = stream.read(65536)
+        if not chunk:
+            return
+        data += chunk
+
+        pos = 0
+        while len(data) - pos >= HEADER.size:
+            sync, block_type, seq, length, cycles = HEADER.unpack_from(data, pos)
+            if sync != SYNC or length > MAX_LENGTH:
+                pos += 1
+                stats["skipped"] += 1
+                continue
+            if len(data) - pos < HEADER.size + length:
+                break
+            yield block_type, seq, cycles, bytes(data[pos + HEADER.size:pos + HEADER.size + length])
+            stats["blocks"] += 1
+            stats["bytes"] += HEADER.size + length
+            pos += HEADER.size + length
+        del data[:pos]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("source", help="serial device or capture file")
+    parser.add_argument("--out", default="usb_cdc", help="prefix of the CSV files, default: usb_cdc")
+    parser.add_argument("--clock", type=float, default=168e6, help="core clock in Hz, default: 168e6")
+    args = parser.parse_args()
+
+    adc_file = open(args.out + "_adc.csv", "w", newline="")
+    tacho_file = open(args.out + "_tacho.csv", "w", newline="")
+    datalog_file = open(args.out + "_datalog.bin", "wb")
+    adc = csv.writer(adc_file)
+    tacho = csv.writer(tacho_file)
+    adc.writerow(["time_s", "poti_1", "poti_2"])
+    tacho.writerow(["time_s", "tim2_us"])
+
+    stats = {"blocks": 0, "bytes": 0, "skipped": 0, "lost": 0}
+    last_seq = None
+    cycles_high = 0
+    last_cycles = None
+    start = time.monotonic()
+    try:
+        with open(args.source, "rb", buffering=0) as stream:
+            for block_type, seq, cycles, data in blocks(stream, stats):
+                if last_seq is not None:
+                    stats["lost"] += (seq - last_seq - 1) & 0xFFFF
+                last_seq = seq
+
+                # The cycle counter wraps after 2^32 cycles (25 s at 168 MHz)
+                if last_cycles is not None and cycles < last_cycles:
+                    cycles_high += 1 << 32
+                last_cycles = cycles
+                time_s = round((cycles_high + cycles) / args.clock, 6)
+
+                if block_type in (ADC_U16, ADC_U32):
+                    layout = "<HH" if block_type == ADC_U16 else "<II"
+                    for poti_1, poti_2 in struct.iter_unpack(layout, data[:len(data) - len(data) % struct.calcsize(layout)]):
+                        adc.writerow([time_s, poti_1, poti_2])
+                elif block_type == TACHO:
+                    for (timestamp,) in struct.iter_unpack("<I", data[:len(data) & ~3]):
+                        tacho.writerow([time_s, timestamp])
+                elif block_type == DATALOG:
+                    datalog_file.write(data)
+    except KeyboardInterrupt:
+        pass
+
+    adc_file.close()
+    tacho_file.close()
+    datalog_file.close()
+    seconds = max(time.monotonic() - start, 1e-3)
+    sys.stderr.write("%d blocks, %d lost, %d bytes skipped, %.1f kB/s\n" %
+                     (stats["blocks"], stats["lost"], stats["skipped"], stats["bytes"] / seconds / 1000.0))
+
+
+if __name__ == "__main__":
+    main()
@@ -4,7 +4,7 @@
 * @author Mahmoud Mahmoud / Judy Abou Rmeh
 * @version v1.0
 * @date 15.11.25
-* @brief Implementation of utility functions such as delay and GPIO port write.
+* @brief Implementation of utility functions such as delay and GPIO port updates.
 **************************************************
 */
 
@@ -25,13 +25,118 @@ void utils_delay_ms(uint32_t t)
 }
 
 /**
- * @brief  Writes an entire 16-bit pattern to a GPIO port's ODR register.
- *         This overrides the complete output register of the port.
+ * @brief  Delays code execution for the specified number of microseconds.
+ *         HAL_Delay(n) waits between n and n + 1 ms, so n = ms - 1 never
+ *         overshoots; the rest is counted in core cycles from the start.
+ * @param  u32_us Duration in microseconds.
+ * @return None
+ */
+void utils_delay_us(uint32_t u32_us)
+{
+    uint32_t u32_start;
+    uint32_t u32_cycles_per_us;
+
+    utils_timebase_init();
+
+    u32_start = DWT->CYCCNT;
+    u32_cycles_per_us = SystemCoreClock / 1000000u;
+
+    if (u32_us >= 2000u) {
+        HAL_Delay((u32_us / 1000u) - 1u);
+    }
+
+    while ((DWT->CYCCNT - u32_start) < u32_us * u32_cycles_per_us) {
+    }
+}
+
+/**
+ * @brief  Enables the trace block and the DWT cycle counter.
+ * @return None
+ */
+void utils_timebase_init(void)
+{
+    if ((DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) == 0u) {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0u;
+        DWT->CTRL  |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+}
+
+/**
+ * @brief  Returns the current value of the cycle counter.
+ * @return Core cycles.
+ */
+uint32_t utils_now_cycles(void)
+{
+    utils_timebase_init();
+
+    return DWT->CYCCNT;
+}
+
+/**
+ * @brief  Returns the core cycles elapsed since a timestamp (wrap-safe).
+ * @param  u32_start Timestamp from utils_now_cycles().
+ * @return Cycles since u32_start.
+ */
+uint32_t utils_elapsed_cycles(uint32_t u32_start)
+{
+    return DWT->CYCCNT - u32_start;
+}
+
+/**
+ * @brief  Returns the microseconds elapsed since a timestamp.
+ * @param  u32_start Timestamp from utils_now_cycles().
+ * @return Microseconds since u32_start.
+ */
+uint32_t utils_elapsed_us(uint32_t u32_start)
+{
+    return utils_cycles_to_us(DWT->CYCCNT - u32_start);
+}
+
+/**
+ * @brief  Converts core cycles to microseconds.
+ * @param  u32_cycles Core cycles.
+ * @return Microseconds.
+ */
+uint32_t utils_cycles_to_us(uint32_t u32_cycles)
+{
+    return u32_cycles / (SystemCoreClock / 1000000u);
+}
+
+/**
+ * @brief  Writes an entire 16-bit pattern to a GPIO port.
+ *         All pins of the port are driven, through BSRR instead of ODR
+ *         so an interrupt between read and write cannot be lost.
  * @param  GPIOx Pointer to GPIO port (e.g. GPIOA)
- * @param  bitmask 16-bit value to write to ODR.
+ * @param  bitmask 16-bit output pattern.
  * @return None
  */
 void utils_gpio_port_write(GPIO_TypeDef *GPIOx, uint16_t bitmask)
 {
-    GPIOx->ODR = bitmask;
+    GPIOx->BSRR = UTILS_GPIO_BSRR_WORD(0xFFFFu, bitmask);
+}
+
+/**
+ * @brief  Drives the pins of a mask to a pattern in one BSRR store.
+ * @param  GPIOx Pointer to GPIO port (e.g. GPIOA)
+ * @param  u16_mask Pins to update.
+ * @param  u16_value Levels for the pins of the mask.
+ * @return None
+ */
+void utils_gpio_port_update(GPIO_TypeDef *GPIOx, uint16_t u16_mask, uint16_t u16_value)
+{
+    GPIOx->BSRR = UTILS_GPIO_BSRR_WORD(u16_mask, u16_value);
+}
+
+/**
+ * @brief  Enables the clock of a GPIO port from its address.
+ * @param  GPIOx Pointer to GPIO port (e.g. GPIOA)
+ * @return None
+ */
+void utils_gpio_clock_enable(GPIO_TypeDef *GPIOx)
+{
+    uint32_t u32_bit = ((uint32_t)(uintptr_t)GPIOx - AHB1PERIPH_BASE) / 0x400u;
+
+    RCC->AHB1ENR |= 1UL << u32_bit;
+    (void)RCC->AHB1ENR;
 }
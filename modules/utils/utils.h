@@ -4,7 +4,39 @@
 * @author Mahmoud Mahmoud / Judy Abou Rmeh
 * @version v1.0
 * @date 15.11.25
-* @brief Utility module providing helper functions such as delay and GPIO port write.
+* @brief Utility module providing helper functions such as delay and GPIO port updates.
+@verbatim
+==================================================
+				### Timebase ###
+	The microsecond functions run on the DWT cycle counter (CYCCNT),
+	started on first use. The counter wraps after 2^32 core cycles
+	(23.8 s at 180 MHz); elapsed times are valid below that.
+	utils_delay_us() sleeps with HAL_Delay() for the whole
+	milliseconds of longer delays and busy-waits only on the rest.
+==================================================
+				### Memory placement ###
+	UTILS_CCM (initialised) and UTILS_CCM_BSS (zero initialised)
+	place variables in the 64 KB CCM data RAM: no wait states and no
+	bus sharing with the DMA controllers, which in turn cannot reach
+	it. Use it for state the CPU works on in interrupts, never for
+	DMA buffers. UTILS_RAMFUNC copies a function to SRAM at startup
+	(with .data). From SRAM the code competes with data on the
+	system bus, so it only pays off where flash misses dominate;
+	it is off unless UTILS_RAMFUNC_ENABLE is 1, compare with the
+	B0_Benchmarks project. UTILS_NOINIT places large buffers that
+	are always written before they are read (pools, DMA rings, pixel
+	bands) in .noinit, which the startup code does not clear.
+==================================================
+				### GPIO port updates ###
+	Ports are shared between modules (GPIOD: ESD segments and the
+	LCD's DC line), so no module writes ODR: a read-modify-write of
+	ODR loses the change of an interrupt that hits in between.
+	utils_gpio_port_update() sets and resets the pins of a mask in
+	one BSRR store, the hardware leaves all other pins alone. Single
+	pins can also go through their bit-band alias (UTILS_GPIO_ODR_BIT),
+	one store per pin, usable in a bit loop.
+==================================================
+@endverbatim
 **************************************************
 */
 #ifndef UTILS_UTILS_H_
@@ -13,6 +45,76 @@
 /* Includes */
 #include "stm32f4xx.h"
 
+/* Public Preprocessor defines */
+
+/**
+ * @brief  1 to place the UTILS_CCM / UTILS_CCM_BSS variables in CCM RAM
+ *         (linker script sections .ccmram / .ccmbss), 0 for normal RAM.
+ */
+#ifndef UTILS_CCM_ENABLE
+#define UTILS_CCM_ENABLE 1
+#endif
+
+/**
+ * @brief  1 to run the UTILS_RAMFUNC functions from SRAM.
+ */
+#ifndef UTILS_RAMFUNC_ENABLE
+#define UTILS_RAMFUNC_ENABLE 0
+#endif
+
+#if UTILS_CCM_ENABLE
+#define UTILS_CCM       __attribute__((section(".ccmram")))
+#define UTILS_CCM_BSS   __attribute__((section(".ccmbss")))
+#else
+#define UTILS_CCM
+#define UTILS_CCM_BSS
+#endif
+
+/**
+ * @brief  1 to place the UTILS_NOINIT variables in .noinit (not zeroed at
+ *         startup), 0 for .bss.
+ */
+#ifndef UTILS_NOINIT_ENABLE
+#define UTILS_NOINIT_ENABLE 1
+#endif
+
+#if UTILS_NOINIT_ENABLE
+#define UTILS_NOINIT    __attribute__((section(".noinit")))
+#else
+#define UTILS_NOINIT
+#endif
+
+#if UTILS_RAMFUNC_ENABLE
+#define UTILS_RAMFUNC   __attribute__((section(".RamFunc"), noinline))
+#else
+#define UTILS_RAMFUNC
+#endif
+
+/**
+ * @brief  BSRR word that drives the pins of 'mask' to 'value': the set
+ *         pins in the lower half, the cleared ones in the reset half.
+ *         A constant for constant arguments.
+ */
+#define UTILS_GPIO_BSRR_WORD(mask, value) \
+    (((uint32_t)(value) & (uint32_t)(mask) & 0xFFFFu) | \
+     ((~(uint32_t)(value) & (uint32_t)(mask) & 0xFFFFu) << 16u))
+
+/**
+ * @brief  Bit-band alias of one bit of a peripheral register (0x4000 0000
+ *         .. 0x400F FFFF, all GPIO ports) or of an SRAM word (0x2000 0000
+ *         .. 0x200F FFFF, not CCM). A store of 0 or 1 changes just that
+ *         bit, a load returns it.
+ */
+#define UTILS_BITBAND_PERIPH(reg, bit) \
+    (*(volatile uint32_t *)(PERIPH_BB_BASE + (((uint32_t)(reg) - PERIPH_BASE) * 32u) + ((uint32_t)(bit) * 4u)))
+#define UTILS_BITBAND_SRAM(addr, bit) \
+    (*(volatile uint32_t *)(SRAM_BB_BASE + (((uint32_t)(addr) - SRAM_BASE) * 32u) + ((uint32_t)(bit) * 4u)))
+
+/**
+ * @brief  Output bit of pin number 0..15 of a port (not a GPIO_PIN_x mask).
+ */
+#define UTILS_GPIO_ODR_BIT(GPIOx, pin_number) UTILS_BITBAND_PERIPH(&(GPIOx)->ODR, (pin_number))
+
 /* Public functions (prototypes) */
 
 /**
@@ -23,13 +125,75 @@
  */
 void utils_delay_ms(uint32_t t);
 
+/**
+ * @brief  Delays execution for a specified number of microseconds.
+ *         Accurate to a few core cycles plus interrupt time; delays
+ *         of 2 ms and more sleep for all but the last millisecond.
+ * @param  u32_us Duration in microseconds (< 2^32 / SystemCoreClock s).
+ * @return None
+ */
+void utils_delay_us(uint32_t u32_us);
+
+/**
+ * @brief  Starts the DWT cycle counter (no-op if it already runs).
+ * @return None
+ */
+void utils_timebase_init(void);
+
+/**
+ * @brief  Returns the current value of the cycle counter.
+ * @return Core cycles (wrapping at 2^32).
+ */
+uint32_t utils_now_cycles(void);
+
+/**
+ * @brief  Returns the core cycles elapsed since a timestamp.
+ * @param  u32_start Timestamp from utils_now_cycles().
+ * @return Cycles since u32_start.
+ */
+uint32_t utils_elapsed_cycles(uint32_t u32_start);
+
+/**
+ * @brief  Returns the microseconds elapsed since a timestamp.
+ * @param  u32_start Timestamp from utils_now_cycles().
+ * @return Microseconds since u32_start.
+ */
+uint32_t utils_elapsed_us(uint32_t u32_start);
+
+/**
+ * @brief  Converts core cycles to microseconds (current SystemCoreClock).
+ * @param  u32_cycles Core cycles.
+ * @return Microseconds.
+ */
+uint32_t utils_cycles_to_us(uint32_t u32_cycles);
+
 /**
  * @brief  Writes a complete 16-bit output pattern to a GPIO port.
- *         The value in 'bitmask' is written directly into ODR (Output Data Register).
+ *         All 16 pins are driven in one BSRR store, including pins of
+ *         other modules; prefer utils_gpio_port_update() on shared ports.
  * @param  GPIOx Pointer to the GPIO port (e.g. GPIOA, GPIOB, ...)
- * @param  bitmask 16-bit value to write into ODR.
+ * @param  bitmask 16-bit output pattern.
  * @return None
  */
 void utils_gpio_port_write(GPIO_TypeDef *GPIOx, uint16_t bitmask);
 
+/**
+ * @brief  Drives the pins of a mask to a pattern in one BSRR store; the
+ *         other pins of the port keep their level. Atomic against
+ *         interrupts and DMA transfers to the same BSRR.
+ * @param  GPIOx Pointer to the GPIO port (e.g. GPIOA, GPIOB, ...)
+ * @param  u16_mask Pins to update (GPIO_PIN_x | ...).
+ * @param  u16_value Levels for the pins of the mask (other bits ignored).
+ * @return None
+ */
+void utils_gpio_port_update(GPIO_TypeDef *GPIOx, uint16_t u16_mask, uint16_t u16_value);
+
+/**
+ * @brief  Enables the AHB1 clock of a GPIO port (GPIOA..GPIOK, 0x400
+ *         apart, one enable bit each) and waits for it to take effect.
+ * @param  GPIOx Pointer to the GPIO port (e.g. GPIOA, GPIOB, ...)
+ * @return None
+ */
+void utils_gpio_clock_enable(GPIO_TypeDef *GPIOx);
+
 #endif /* UTILS_UTILS_H_ */